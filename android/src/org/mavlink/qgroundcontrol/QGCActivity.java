@@ -172,6 +172,14 @@ public class QGCActivity extends QtActivity
                 } catch(Exception e) {
                     Log.e(TAG, "Exception nativeUpdateAvailableJoysticks()");
                 }
+
+                if (UsbManager.ACTION_USB_DEVICE_ATTACHED.equals(action) || UsbManager.ACTION_USB_DEVICE_DETACHED.equals(action)) {
+                    try {
+                        nativeSerialPortsChanged();
+                    } catch(Exception e) {
+                        Log.e(TAG, "Exception nativeSerialPortsChanged()");
+                    }
+                }
             }
         };
 
@@ -180,6 +188,7 @@ public class QGCActivity extends QtActivity
     private static native void nativeDeviceException(long userData, String messageA);
     private static native void nativeDeviceNewData(long userData, byte[] dataA);
     private static native void nativeUpdateAvailableJoysticks();
+    private static native void nativeSerialPortsChanged();
 
     // Native C++ functions called to log output
     public static native void qgcLogDebug(String message);
@@ -211,6 +211,22 @@ contains (DEFINES, QGC_DISABLE_UVC) {
     }
 }
 
+# Hot path instrumentation
+contains (DEFINES, QGC_DISABLE_INSTRUMENTATION) {
+    message("Skipping support for instrumentation (manual override from command line)")
+} else:exists(user_config.pri):infile(user_config.pri, DEFINES, QGC_DISABLE_INSTRUMENTATION) {
+    message("Skipping support for instrumentation (manual override from user_config.pri)")
+    DEFINES += QGC_DISABLE_INSTRUMENTATION
+}
+
+# Per message and per sample logging
+contains (DEFINES, QGC_DISABLE_VERBOSE_LOGGING) {
+    message("Skipping verbose logging (manual override from command line)")
+} else:exists(user_config.pri):infile(user_config.pri, DEFINES, QGC_DISABLE_VERBOSE_LOGGING) {
+    message("Skipping verbose logging (manual override from user_config.pri)")
+    DEFINES += QGC_DISABLE_VERBOSE_LOGGING
+}
+
 LinuxBuild {
     CONFIG += link_pkgconfig
 }
@@ -457,14 +473,17 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
     DEFINES += UNITTEST_BUILD
 
     INCLUDEPATH += \
+        src/qgcbenchmark \
         src/qgcunittest
 
     HEADERS += \
         src/Audio/AudioOutputTest.h \
+        src/FactSystem/FactGroupSchedulerTest.h \
         src/FactSystem/FactSystemTestBase.h \
         src/FactSystem/FactSystemTestGeneric.h \
         src/FactSystem/FactSystemTestPX4.h \
         src/FactSystem/ParameterManagerTest.h \
+        src/FactSystem/TelemetryFactTest.h \
         src/MissionManager/CameraCalcTest.h \
         src/MissionManager/CameraSectionTest.h \
         src/MissionManager/CorridorScanComplexItemTest.h \
@@ -488,15 +507,39 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/TransectStyleComplexItemTest.h \
         src/MissionManager/TransectStyleComplexItemTestBase.h \
         src/MissionManager/VisualMissionItemTest.h \
+        src/qgcbenchmark/AllocationCounter.h \
+        src/qgcbenchmark/HotPathBenchmark.h \
+        src/qgcbenchmark/MAVLinkIngestBenchmark.h \
+        src/qgcunittest/ADSBTCPLinkTest.h \
+        src/qgcunittest/ADSBVehicleManagerTest.h \
         src/qgcunittest/GeoTest.h \
+        src/qgcunittest/LinkReceiveBufferTest.h \
+        src/qgcunittest/LinkSendQueueTest.h \
         src/qgcunittest/MavlinkLogTest.h \
+        src/qgcunittest/MockLinkImpairmentTest.h \
+        src/qgcunittest/MockLinkSwarmTest.h \
         src/qgcunittest/MultiSignalSpy.h \
         src/qgcunittest/MultiSignalSpyV2.h \
+        src/qgcunittest/QGCCameraConditionTest.h \
+        src/qgcunittest/QGCCameraDefinitionTest.h \
+        src/qgcunittest/QGCInstrumentationTest.h \
+        src/qgcunittest/QGCNetworkManagerTest.h \
+        src/qgcunittest/QGCSettingsWriteBackTest.h \
+        src/qgcunittest/QGCStartupBenchmarkTest.h \
+        src/qgcunittest/SignalCompressionTest.h \
+        src/qgcunittest/QmlObjectListModelTest.h \
+        src/qgcunittest/TelemetryLogIndexTest.h \
+        src/qgcunittest/UASMessageModelTest.h \
         src/qgcunittest/UnitTest.h \
         src/Vehicle/FTPManagerTest.h \
+        src/Vehicle/CameraTriggerPointsTest.h \
+        src/Vehicle/FactTelemetryLogTest.h \
+        src/Vehicle/GPSRTKFactGroupTest.h \
+        src/Vehicle/MessageIntervalManagerTest.h \
         src/Vehicle/RequestMessageTest.h \
         src/Vehicle/SendMavCommandWithHandlerTest.h \
         src/Vehicle/SendMavCommandWithSignallingTest.h \
+        src/Vehicle/SensorStreamTapTest.h \
         src/Vehicle/VehicleLinkManagerTest.h \
         #src/qgcunittest/RadioConfigTest.h \
         #src/AnalyzeView/LogDownloadTest.h \
@@ -507,10 +550,12 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
 
     SOURCES += \
         src/Audio/AudioOutputTest.cc \
+        src/FactSystem/FactGroupSchedulerTest.cc \
         src/FactSystem/FactSystemTestBase.cc \
         src/FactSystem/FactSystemTestGeneric.cc \
         src/FactSystem/FactSystemTestPX4.cc \
         src/FactSystem/ParameterManagerTest.cc \
+        src/FactSystem/TelemetryFactTest.cc \
         src/MissionManager/CameraCalcTest.cc \
         src/MissionManager/CameraSectionTest.cc \
         src/MissionManager/CorridorScanComplexItemTest.cc \
@@ -534,16 +579,40 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/TransectStyleComplexItemTest.cc \
         src/MissionManager/TransectStyleComplexItemTestBase.cc \
         src/MissionManager/VisualMissionItemTest.cc \
+        src/qgcbenchmark/AllocationCounter.cc \
+        src/qgcbenchmark/HotPathBenchmark.cc \
+        src/qgcbenchmark/MAVLinkIngestBenchmark.cc \
+        src/qgcunittest/ADSBTCPLinkTest.cc \
+        src/qgcunittest/ADSBVehicleManagerTest.cc \
         src/qgcunittest/GeoTest.cc \
+        src/qgcunittest/LinkReceiveBufferTest.cc \
+        src/qgcunittest/LinkSendQueueTest.cc \
         src/qgcunittest/MavlinkLogTest.cc \
+        src/qgcunittest/MockLinkImpairmentTest.cc \
+        src/qgcunittest/MockLinkSwarmTest.cc \
         src/qgcunittest/MultiSignalSpy.cc \
         src/qgcunittest/MultiSignalSpyV2.cc \
+        src/qgcunittest/QGCCameraConditionTest.cc \
+        src/qgcunittest/QGCCameraDefinitionTest.cc \
+        src/qgcunittest/QGCInstrumentationTest.cc \
+        src/qgcunittest/QGCNetworkManagerTest.cc \
+        src/qgcunittest/QGCSettingsWriteBackTest.cc \
+        src/qgcunittest/QGCStartupBenchmarkTest.cc \
+        src/qgcunittest/SignalCompressionTest.cc \
+        src/qgcunittest/QmlObjectListModelTest.cc \
+        src/qgcunittest/TelemetryLogIndexTest.cc \
+        src/qgcunittest/UASMessageModelTest.cc \
         src/qgcunittest/UnitTest.cc \
         src/qgcunittest/UnitTestList.cc \
         src/Vehicle/FTPManagerTest.cc \
+        src/Vehicle/CameraTriggerPointsTest.cc \
+        src/Vehicle/FactTelemetryLogTest.cc \
+        src/Vehicle/GPSRTKFactGroupTest.cc \
+        src/Vehicle/MessageIntervalManagerTest.cc \
         src/Vehicle/RequestMessageTest.cc \
         src/Vehicle/SendMavCommandWithHandlerTest.cc \
         src/Vehicle/SendMavCommandWithSignallingTest.cc \
+        src/Vehicle/SensorStreamTapTest.cc \
         src/Vehicle/VehicleLinkManagerTest.cc \
         #src/qgcunittest/RadioConfigTest.cc \
         #src/AnalyzeView/LogDownloadTest.cc \
@@ -557,14 +626,18 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
 # Main QGC Headers and Source files
 
 HEADERS += \
+    src/ADSB/ADSBTrafficMapItem.h \
     src/ADSB/ADSBVehicle.h \
     src/ADSB/ADSBVehicleManager.h \
     src/AnalyzeView/LogDownloadController.h \
     src/AnalyzeView/PX4LogParser.h \
     src/AnalyzeView/ULogParser.h \
+    src/AnalyzeView/ULogReader.h \
     src/AnalyzeView/MavlinkConsoleController.h \
+    src/AnalyzeView/PerformanceController.h \
     src/Audio/AudioOutput.h \
     src/Camera/QGCCameraControl.h \
+    src/Camera/QGCCameraDefinition.h \
     src/Camera/QGCCameraIO.h \
     src/Camera/QGCCameraManager.h \
     src/CmdLineOptParser.h \
@@ -586,7 +659,7 @@ HEADERS += \
     src/MissionManager/FixedWingLandingComplexItem.h \
     src/MissionManager/GeoFenceController.h \
     src/MissionManager/GeoFenceManager.h \
-    src/MissionManager/KMLPlanDomDocument.h \
+    src/MissionManager/KMLPlanWriter.h \
     src/MissionManager/LandingComplexItem.h \
     src/MissionManager/MissionCommandList.h \
     src/MissionManager/MissionCommandTree.h \
@@ -598,6 +671,7 @@ HEADERS += \
     src/MissionManager/PlanElementController.h \
     src/MissionManager/PlanCreator.h \
     src/MissionManager/PlanManager.h \
+    src/MissionManager/PlanMapLayer.h \
     src/MissionManager/PlanMasterController.h \
     src/MissionManager/QGCFenceCircle.h \
     src/MissionManager/QGCFencePolygon.h \
@@ -618,6 +692,7 @@ HEADERS += \
     src/MissionManager/TransectStyleComplexItem.h \
     src/MissionManager/VisualMissionItem.h \
     src/MissionManager/VTOLLandingComplexItem.h \
+    src/PositionManager/NmeaPositionSource.h \
     src/PositionManager/PositionManager.h \
     src/PositionManager/SimulatedPosition.h \
     src/Geo/QGCGeo.h \
@@ -633,13 +708,18 @@ HEADERS += \
     src/QGCComboBox.h \
     src/QGCConfig.h \
     src/QGCFileDownload.h \
+    src/QGCInstrumentation.h \
+    src/QGCSettingsWriteBack.h \
+    src/QGCStartupBenchmark.h \
     src/QGCLoggingCategory.h \
     src/QGCMapPalette.h \
+    src/QGCNetworkManager.h \
     src/QGCPalette.h \
     src/QGCQGeoCoordinate.h \
     src/QGCTemporaryFile.h \
     src/QGCToolbox.h \
     src/QGCZlib.h \
+    src/QmlControls/AppLogSink.h \
     src/QmlControls/AppMessages.h \
     src/QmlControls/EditPositionDialogController.h \
     src/QmlControls/FlightPathSegment.h \
@@ -647,6 +727,7 @@ HEADERS += \
     src/QmlControls/InstrumentValueData.h \
     src/QmlControls/FactValueGrid.h \
     src/QmlControls/ParameterEditorController.h \
+    src/QmlControls/ObstacleOverlay.h \
     src/QmlControls/QGCFileDialogController.h \
     src/QmlControls/QGCImageProvider.h \
     src/QmlControls/QGroundControlQmlGlobal.h \
@@ -655,6 +736,8 @@ HEADERS += \
     src/QmlControls/RCChannelMonitorController.h \
     src/QmlControls/RCToParamDialogController.h \
     src/QmlControls/ScreenToolsController.h \
+    src/QmlControls/SensorStreamChart.h \
+    src/QmlControls/TerrainCollisionEngine.h \
     src/QmlControls/TerrainProfile.h \
     src/QmlControls/ToolStripAction.h \
     src/QmlControls/ToolStripActionList.h \
@@ -675,27 +758,36 @@ HEADERS += \
     src/Settings/VideoSettings.h \
     src/ShapeFileHelper.h \
     src/SHPFileHelper.h \
+    src/Terrain/TerrainLocalElevation.h \
     src/Terrain/TerrainQuery.h \
     src/TerrainTile.h \
+    src/Vehicle/CameraTriggerMapItem.h \
+    src/Vehicle/CameraTriggerPoints.h \
     src/Vehicle/CompInfo.h \
     src/Vehicle/CompInfoParam.h \
     src/Vehicle/CompInfoVersion.h \
     src/Vehicle/ComponentInformationManager.h \
+    src/Vehicle/FactTelemetryLog.h \
     src/Vehicle/FTPManager.h \
     src/Vehicle/GPSRTKFactGroup.h \
     src/Vehicle/InitialConnectStateMachine.h \
+    src/Vehicle/LinkQualityAdapter.h \
     src/Vehicle/MAVLinkLogManager.h \
+    src/Vehicle/MessageIntervalManager.h \
     src/Vehicle/MultiVehicleManager.h \
+    src/Vehicle/SensorStreamTap.h \
     src/Vehicle/StateMachine.h \
     src/Vehicle/SysStatusSensorInfo.h \
     src/Vehicle/TerrainFactGroup.h \
     src/Vehicle/TerrainProtocolHandler.h \
+    src/Vehicle/TrajectoryMapItem.h \
     src/Vehicle/TrajectoryPoints.h \
     src/Vehicle/Vehicle.h \
     src/Vehicle/VehicleObjectAvoidance.h \
     src/Vehicle/VehicleBatteryFactGroup.h \
     src/Vehicle/VehicleClockFactGroup.h \
     src/Vehicle/VehicleDistanceSensorFactGroup.h \
+    src/Vehicle/VehicleEscStatusListModel.h \
     src/Vehicle/VehicleEstimatorStatusFactGroup.h \
     src/Vehicle/VehicleGPSFactGroup.h \
     src/Vehicle/VehicleLinkManager.h \
@@ -704,12 +796,20 @@ HEADERS += \
     src/Vehicle/VehicleVibrationFactGroup.h \
     src/Vehicle/VehicleWindFactGroup.h \
     src/VehicleSetup/JoystickConfigController.h \
+    src/comm/LatencyHistogram.h \
     src/comm/LinkConfiguration.h \
     src/comm/LinkInterface.h \
     src/comm/LinkManager.h \
+    src/comm/LinkReceiveBuffer.h \
+    src/comm/LinkSendQueue.h \
     src/comm/LogReplayLink.h \
+    src/comm/MAVLinkChannelStats.h \
+    src/comm/MAVLinkForwarder.h \
+    src/comm/MAVLinkLogWriter.h \
+    src/comm/MAVLinkMessageRing.h \
     src/comm/MAVLinkProtocol.h \
     src/comm/QGCMAVLink.h \
+    src/comm/TelemetryLogIndex.h \
     src/comm/TCPLink.h \
     src/comm/UDPLink.h \
     src/comm/UdpIODevice.h \
@@ -733,7 +833,9 @@ DebugBuild {
 HEADERS += \
     src/comm/MockLink.h \
     src/comm/MockLinkFTP.h \
+    src/comm/MockLinkImpairment.h \
     src/comm/MockLinkMissionItemHandler.h \
+    src/comm/MockLinkSwarm.h \
 }
 
 WindowsBuild {
@@ -759,6 +861,8 @@ contains (DEFINES, QGC_ENABLE_PAIRING) {
 HEADERS += \
     src/comm/QGCSerialPortInfo.h \
     src/comm/SerialLink.h \
+    src/comm/SerialPortScanner.h \
+    src/comm/SerialPortWatcher.h \
 }
 
 !MobileBuild {
@@ -777,6 +881,7 @@ HEADERS += \
     src/GPS/vehicle_gps_position.h \
     src/Joystick/JoystickSDL.h \
     src/RunGuard.h \
+    src/comm/LocalSocketLink.h \
 }
 
 iOSBuild {
@@ -790,14 +895,18 @@ AndroidBuild {
 }
 
 SOURCES += \
+    src/ADSB/ADSBTrafficMapItem.cc \
     src/ADSB/ADSBVehicle.cc \
     src/ADSB/ADSBVehicleManager.cc \
     src/AnalyzeView/LogDownloadController.cc \
     src/AnalyzeView/PX4LogParser.cc \
     src/AnalyzeView/ULogParser.cc \
+    src/AnalyzeView/ULogReader.cc \
     src/AnalyzeView/MavlinkConsoleController.cc \
+    src/AnalyzeView/PerformanceController.cc \
     src/Audio/AudioOutput.cc \
     src/Camera/QGCCameraControl.cc \
+    src/Camera/QGCCameraDefinition.cc \
     src/Camera/QGCCameraIO.cc \
     src/Camera/QGCCameraManager.cc \
     src/CmdLineOptParser.cc \
@@ -818,7 +927,7 @@ SOURCES += \
     src/MissionManager/FixedWingLandingComplexItem.cc \
     src/MissionManager/GeoFenceController.cc \
     src/MissionManager/GeoFenceManager.cc \
-    src/MissionManager/KMLPlanDomDocument.cc \
+    src/MissionManager/KMLPlanWriter.cc \
     src/MissionManager/LandingComplexItem.cc \
     src/MissionManager/MissionCommandList.cc \
     src/MissionManager/MissionCommandTree.cc \
@@ -830,6 +939,7 @@ SOURCES += \
     src/MissionManager/PlanElementController.cc \
     src/MissionManager/PlanCreator.cc \
     src/MissionManager/PlanManager.cc \
+    src/MissionManager/PlanMapLayer.cc \
     src/MissionManager/PlanMasterController.cc \
     src/MissionManager/QGCFenceCircle.cc \
     src/MissionManager/QGCFencePolygon.cc \
@@ -849,6 +959,7 @@ SOURCES += \
     src/MissionManager/TransectStyleComplexItem.cc \
     src/MissionManager/VisualMissionItem.cc \
     src/MissionManager/VTOLLandingComplexItem.cc \
+    src/PositionManager/NmeaPositionSource.cc \
     src/PositionManager/PositionManager.cpp \
     src/PositionManager/SimulatedPosition.cc \
     src/Geo/QGCGeo.cc \
@@ -862,13 +973,18 @@ SOURCES += \
     src/QGCApplication.cc \
     src/QGCComboBox.cc \
     src/QGCFileDownload.cc \
+    src/QGCInstrumentation.cc \
+    src/QGCSettingsWriteBack.cc \
+    src/QGCStartupBenchmark.cc \
     src/QGCLoggingCategory.cc \
     src/QGCMapPalette.cc \
+    src/QGCNetworkManager.cc \
     src/QGCPalette.cc \
     src/QGCQGeoCoordinate.cc \
     src/QGCTemporaryFile.cc \
     src/QGCToolbox.cc \
     src/QGCZlib.cc \
+    src/QmlControls/AppLogSink.cc \
     src/QmlControls/AppMessages.cc \
     src/QmlControls/EditPositionDialogController.cc \
     src/QmlControls/FlightPathSegment.cc \
@@ -876,6 +992,7 @@ SOURCES += \
     src/QmlControls/InstrumentValueData.cc \
     src/QmlControls/FactValueGrid.cc \
     src/QmlControls/ParameterEditorController.cc \
+    src/QmlControls/ObstacleOverlay.cc \
     src/QmlControls/QGCFileDialogController.cc \
     src/QmlControls/QGCImageProvider.cc \
     src/QmlControls/QGroundControlQmlGlobal.cc \
@@ -884,6 +1001,8 @@ SOURCES += \
     src/QmlControls/RCChannelMonitorController.cc \
     src/QmlControls/RCToParamDialogController.cc \
     src/QmlControls/ScreenToolsController.cc \
+    src/QmlControls/SensorStreamChart.cc \
+    src/QmlControls/TerrainCollisionEngine.cc \
     src/QmlControls/TerrainProfile.cc \
     src/QmlControls/ToolStripAction.cc \
     src/QmlControls/ToolStripActionList.cc \
@@ -904,27 +1023,36 @@ SOURCES += \
     src/Settings/VideoSettings.cc \
     src/ShapeFileHelper.cc \
     src/SHPFileHelper.cc \
+    src/Terrain/TerrainLocalElevation.cc \
     src/Terrain/TerrainQuery.cc \
     src/TerrainTile.cc\
+    src/Vehicle/CameraTriggerMapItem.cc \
+    src/Vehicle/CameraTriggerPoints.cc \
     src/Vehicle/CompInfo.cc \
     src/Vehicle/CompInfoParam.cc \
     src/Vehicle/CompInfoVersion.cc \
     src/Vehicle/ComponentInformationManager.cc \
+    src/Vehicle/FactTelemetryLog.cc \
     src/Vehicle/FTPManager.cc \
     src/Vehicle/GPSRTKFactGroup.cc \
     src/Vehicle/InitialConnectStateMachine.cc \
+    src/Vehicle/LinkQualityAdapter.cc \
     src/Vehicle/MAVLinkLogManager.cc \
+    src/Vehicle/MessageIntervalManager.cc \
     src/Vehicle/MultiVehicleManager.cc \
+    src/Vehicle/SensorStreamTap.cc \
     src/Vehicle/StateMachine.cc \
     src/Vehicle/SysStatusSensorInfo.cc \
     src/Vehicle/TerrainFactGroup.cc \
     src/Vehicle/TerrainProtocolHandler.cc \
+    src/Vehicle/TrajectoryMapItem.cc \
     src/Vehicle/TrajectoryPoints.cc \
     src/Vehicle/Vehicle.cc \
     src/Vehicle/VehicleObjectAvoidance.cc \
     src/Vehicle/VehicleBatteryFactGroup.cc \
     src/Vehicle/VehicleClockFactGroup.cc \
     src/Vehicle/VehicleDistanceSensorFactGroup.cc \
+    src/Vehicle/VehicleEscStatusListModel.cc \
     src/Vehicle/VehicleEstimatorStatusFactGroup.cc \
     src/Vehicle/VehicleGPSFactGroup.cc \
     src/Vehicle/VehicleLinkManager.cc \
@@ -933,13 +1061,21 @@ SOURCES += \
     src/Vehicle/VehicleVibrationFactGroup.cc \
     src/Vehicle/VehicleWindFactGroup.cc \
     src/VehicleSetup/JoystickConfigController.cc \
+    src/comm/LatencyHistogram.cc \
     src/comm/LinkConfiguration.cc \
     src/comm/LinkInterface.cc \
     src/comm/LinkManager.cc \
+    src/comm/LinkReceiveBuffer.cc \
+    src/comm/LinkSendQueue.cc \
     src/comm/LogReplayLink.cc \
+    src/comm/MAVLinkChannelStats.cc \
+    src/comm/MAVLinkForwarder.cc \
+    src/comm/MAVLinkLogWriter.cc \
+    src/comm/MAVLinkMessageRing.cc \
     src/comm/MAVLinkProtocol.cc \
     src/comm/QGCMAVLink.cc \
     src/comm/TCPLink.cc \
+    src/comm/TelemetryLogIndex.cc \
     src/comm/UDPLink.cc \
     src/comm/UdpIODevice.cc \
     src/main.cc \
@@ -957,13 +1093,17 @@ DebugBuild {
 SOURCES += \
     src/comm/MockLink.cc \
     src/comm/MockLinkFTP.cc \
+    src/comm/MockLinkImpairment.cc \
     src/comm/MockLinkMissionItemHandler.cc \
+    src/comm/MockLinkSwarm.cc \
 }
 
 !NoSerialBuild {
 SOURCES += \
     src/comm/QGCSerialPortInfo.cc \
     src/comm/SerialLink.cc \
+    src/comm/SerialPortScanner.cc \
+    src/comm/SerialPortWatcher.cc \
 }
 
 contains(DEFINES, QGC_ENABLE_BLUETOOTH) {
@@ -990,6 +1130,7 @@ SOURCES += \
     src/GPS/RTCM/RTCMMavlink.cc \
     src/Joystick/JoystickSDL.cc \
     src/RunGuard.cc \
+    src/comm/LocalSocketLink.cc \
 }
 
 #
@@ -1191,21 +1332,25 @@ HEADERS += \
     src/FactSystem/Fact.h \
     src/FactSystem/FactControls/FactPanelController.h \
     src/FactSystem/FactGroup.h \
+    src/FactSystem/FactGroupScheduler.h \
     src/FactSystem/FactMetaData.h \
     src/FactSystem/FactSystem.h \
     src/FactSystem/FactValueSliderListModel.h \
     src/FactSystem/ParameterManager.h \
     src/FactSystem/SettingsFact.h \
+    src/FactSystem/TelemetryFact.h \
 
 SOURCES += \
     src/FactSystem/Fact.cc \
     src/FactSystem/FactControls/FactPanelController.cc \
     src/FactSystem/FactGroup.cc \
+    src/FactSystem/FactGroupScheduler.cc \
     src/FactSystem/FactMetaData.cc \
     src/FactSystem/FactSystem.cc \
     src/FactSystem/FactValueSliderListModel.cc \
     src/FactSystem/ParameterManager.cc \
     src/FactSystem/SettingsFact.cc \
+    src/FactSystem/TelemetryFact.cc \
 
 #-------------------------------------------------------------------------------------
 # MAVLink Inspector
@@ -1241,11 +1386,9 @@ contains (DEFINES, QGC_GST_TAISYNC_DISABLED) {
         iOSBuild | AndroidBuild {
             HEADERS += \
                 src/Taisync/TaisyncTelemetry.h \
-                src/Taisync/TaisyncVideoReceiver.h \
 
             SOURCES += \
                 src/Taisync/TaisyncTelemetry.cc \
-                src/Taisync/TaisyncVideoReceiver.cc \
         }
     }
 }
@@ -1366,10 +1509,12 @@ INCLUDEPATH += \
     src/VideoManager
 
 HEADERS += \
+    src/VideoManager/KLVMetadataWriter.h \
     src/VideoManager/SubtitleWriter.h \
     src/VideoManager/VideoManager.h
 
 SOURCES += \
+    src/VideoManager/KLVMetadataWriter.cc \
     src/VideoManager/SubtitleWriter.cc \
     src/VideoManager/VideoManager.cc
 
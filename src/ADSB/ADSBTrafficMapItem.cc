@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBTrafficMapItem.h"
+#include "ADSBVehicleManager.h"
+#include "QGCApplication.h"
+#include "QGCGeo.h"
+
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+
+#include <algorithm>
+
+// Aircraft outline pointing up, sized 1x1 around the center. Drawn as the triangles tip-left-notch and tip-notch-right.
+static const QPointF kTip       ( 0.0, -0.5);
+static const QPointF kLeft      (-0.4,  0.5);
+static const QPointF kNotch     ( 0.0,  0.25);
+static const QPointF kRight     ( 0.4,  0.5);
+
+static const double kOutlineScale = 1.3;
+
+ADSBTrafficMapItem::ADSBTrafficMapItem(QQuickItem* parent)
+    : QQuickItem            (parent)
+    , _adsbVehicleManager   (qgcApp()->toolbox()->adsbVehicleManager())
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    connect(_adsbVehicleManager,    &ADSBVehicleManager::trafficUpdated,    this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &ADSBTrafficMapItem::centerChanged,     this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &ADSBTrafficMapItem::zoomLevelChanged,  this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &ADSBTrafficMapItem::bearingChanged,    this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &ADSBTrafficMapItem::sizeChanged,       this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &ADSBTrafficMapItem::maxLabelsChanged,  this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &QQuickItem::widthChanged,              this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &QQuickItem::heightChanged,             this, &ADSBTrafficMapItem::_layoutSignal);
+    connect(this,                   &ADSBTrafficMapItem::colorChanged,      this, &QQuickItem::update);
+    connect(this,                   &ADSBTrafficMapItem::alertColorChanged, this, &QQuickItem::update);
+
+    // A pan changes center, zoom and bearing together, this collapses them into a single layout
+    connect(this, &ADSBTrafficMapItem::_layoutSignal, this, &ADSBTrafficMapItem::_layoutTraffic, Qt::QueuedConnection);
+    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&ADSBTrafficMapItem::_layoutSignal));
+}
+
+/// Web Mercator pixel of the coordinate in a world which is worldSize pixels wide
+static QPointF _worldPixel(const QGeoCoordinate& coordinate, double worldSize)
+{
+    QPointF pixel;
+    convertGeoToWebMercator(coordinate.latitude(), coordinate.longitude(), worldSize, pixel.rx(), pixel.ry());
+    return pixel;
+}
+
+void ADSBTrafficMapItem::_layoutTraffic(void)
+{
+    typedef struct {
+        double                                  distanceSquared;    ///< From the center of the viewport
+        QPointF                                 position;
+        const ADSBVehicleManager::Traffic_t*    traffic;
+    } LabelCandidate_t;
+
+    QVector<LabelCandidate_t> labelCandidates;
+
+    _visibleTraffic.clear();
+    _labels.clear();
+
+    if (_center.isValid() && width() > 0 && height() > 0) {
+        // Map zoom levels are relative to 256 pixel tiles
+        const double    worldSize       = 256.0 * qPow(2.0, _zoomLevel);
+        const QPointF   centerPixel     = _worldPixel(_center, worldSize);
+        const QPointF   viewportCenter  (width() / 2.0, height() / 2.0);
+        const double    bearingRadians  = qDegreesToRadians(-_bearing);
+        const double    cosBearing      = qCos(bearingRadians);
+        const double    sinBearing      = qSin(bearingRadians);
+        const double    margin          = _size * kOutlineScale;
+
+        for (const ADSBVehicleManager::Traffic_t& traffic: _adsbVehicleManager->traffic()) {
+            if (!traffic.coordinate.isValid()) {
+                continue;
+            }
+
+            QPointF delta = _worldPixel(traffic.coordinate, worldSize) - centerPixel;
+            // Go the short way around the world so traffic across the antimeridian ends up in the right place
+            if (delta.x() > worldSize / 2.0) {
+                delta.rx() -= worldSize;
+            } else if (delta.x() < -worldSize / 2.0) {
+                delta.rx() += worldSize;
+            }
+            const QPointF position(viewportCenter.x() + (delta.x() * cosBearing) - (delta.y() * sinBearing),
+                                   viewportCenter.y() + (delta.x() * sinBearing) + (delta.y() * cosBearing));
+
+            if (position.x() < -margin || position.y() < -margin || position.x() > width() + margin || position.y() > height() + margin) {
+                continue;
+            }
+
+            _visibleTraffic.append({ position, (qIsNaN(traffic.heading) ? 0 : traffic.heading) - _bearing, traffic.alert });
+
+            if (!qIsNaN(traffic.altitude)) {
+                const QPointF fromCenter = position - viewportCenter;
+                labelCandidates.append({ QPointF::dotProduct(fromCenter, fromCenter), position, &traffic });
+            }
+        }
+
+        const int cLabels = qMin(qMax(_maxLabels, 0), labelCandidates.count());
+        std::partial_sort(labelCandidates.begin(), labelCandidates.begin() + cLabels, labelCandidates.end(),
+                          [](const LabelCandidate_t& a, const LabelCandidate_t& b) { return a.distanceSquared < b.distanceSquared; });
+        for (int i = 0; i < cLabels; i++) {
+            QVariantMap label;
+            label[QStringLiteral("x")]          = labelCandidates[i].position.x();
+            label[QStringLiteral("y")]          = labelCandidates[i].position.y();
+            label[QStringLiteral("callsign")]   = labelCandidates[i].traffic->callsign;
+            label[QStringLiteral("altitude")]   = labelCandidates[i].traffic->altitude;
+            _labels.append(label);
+        }
+    }
+
+    emit labelsChanged();
+    update();
+}
+
+QSGNode* ADSBTrafficMapItem::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+
+        node = new QSGGeometryNode;
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setFlag(QSGNode::OwnsMaterial);
+        node->setGeometry(geometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+    }
+
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate(_visibleTraffic.count() * _cVerticesPerAircraft);
+
+    QSGGeometry::ColoredPoint2D* vertices = geometry->vertexDataAsColoredPoint2D();
+    int vertexIndex = 0;
+
+    for (const VisibleTraffic_t& traffic: _visibleTraffic) {
+        const double radians    = qDegreesToRadians(traffic.rotation);
+        const double cosRot     = qCos(radians);
+        const double sinRot     = qSin(radians);
+        const QColor fillColor  = traffic.alert ? _alertColor : _color;
+
+        // The dark outline goes first so the fill is drawn over it
+        for (int pass = 0; pass < 2; pass++) {
+            const double scale  = pass == 0 ? _size * kOutlineScale : _size;
+            const QColor color  = pass == 0 ? QColor(Qt::black) : fillColor;
+
+            auto addVertex = [&](const QPointF& point) {
+                vertices[vertexIndex++].set(static_cast<float>(traffic.position.x() + (((point.x() * cosRot) - (point.y() * sinRot)) * scale)),
+                                            static_cast<float>(traffic.position.y() + (((point.x() * sinRot) + (point.y() * cosRot)) * scale)),
+                                            static_cast<uchar>(color.red()), static_cast<uchar>(color.green()), static_cast<uchar>(color.blue()), 255);
+            };
+            addVertex(kTip);
+            addVertex(kLeft);
+            addVertex(kNotch);
+            addVertex(kTip);
+            addVertex(kNotch);
+            addVertex(kRight);
+        }
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QQuickItem>
+#include <QColor>
+#include <QGeoCoordinate>
+#include <QPointF>
+#include <QVariantList>
+#include <QVector>
+
+class ADSBVehicleManager;
+
+/// Draws all the ADSB traffic as a single scene graph node on top of a map.
+///
+/// The item covers the map and is given the center, zoom level and bearing of it. The aircraft are projected to the
+/// viewport with Web Mercator in C++, the ones outside of it are culled, and the rest are drawn with one geometry node
+/// so the whole layer is a single draw call no matter the amount of traffic. Labels are only provided for the
+/// aircraft closest to the center of the map.
+class ADSBTrafficMapItem : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    ADSBTrafficMapItem(QQuickItem* parent = nullptr);
+
+    Q_PROPERTY(QGeoCoordinate   center      MEMBER _center      NOTIFY centerChanged)
+    Q_PROPERTY(double           zoomLevel   MEMBER _zoomLevel   NOTIFY zoomLevelChanged)
+    Q_PROPERTY(double           bearing     MEMBER _bearing     NOTIFY bearingChanged)
+    Q_PROPERTY(double           size        MEMBER _size        NOTIFY sizeChanged)         ///< Aircraft size in pixels
+    Q_PROPERTY(QColor           color       MEMBER _color       NOTIFY colorChanged)
+    Q_PROPERTY(QColor           alertColor  MEMBER _alertColor  NOTIFY alertColorChanged)
+    Q_PROPERTY(int              maxLabels   MEMBER _maxLabels   NOTIFY maxLabelsChanged)
+    Q_PROPERTY(QVariantList     labels      READ labels         NOTIFY labelsChanged)       ///< { x, y, callsign, altitude } of labeled aircraft
+    Q_PROPERTY(int              visibleCount READ visibleCount  NOTIFY labelsChanged)
+
+    QVariantList    labels          (void) const { return _labels; }
+    int             visibleCount    (void) const { return _visibleTraffic.count(); }
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) final;
+
+signals:
+    void centerChanged      (void);
+    void zoomLevelChanged   (void);
+    void bearingChanged     (void);
+    void sizeChanged        (void);
+    void colorChanged       (void);
+    void alertColorChanged  (void);
+    void maxLabelsChanged   (void);
+    void labelsChanged      (void);
+    void _layoutSignal      (void);
+
+private slots:
+    void _layoutTraffic(void);
+
+private:
+    typedef struct {
+        QPointF position;       ///< Viewport pixels
+        double  rotation;       ///< Degrees clockwise on screen
+        bool    alert;
+    } VisibleTraffic_t;
+
+    ADSBVehicleManager*         _adsbVehicleManager;
+    QGeoCoordinate              _center;
+    double                      _zoomLevel  = 0;
+    double                      _bearing    = 0;
+    double                      _size       = 24;
+    QColor                      _color      = QColor(240, 232, 0);
+    QColor                      _alertColor = QColor(Qt::red);
+    int                         _maxLabels  = 30;
+    QVector<VisibleTraffic_t>   _visibleTraffic;    ///< Built on the GUI thread, read by updatePaintNode while it is blocked
+    QVariantList                _labels;
+
+    static const int _cVerticesPerAircraft = 12;    ///< Outline and fill, two triangles each
+};
@@ -59,6 +59,9 @@ public:
     /// check if the vehicle is expired and should be removed
     bool expired();
 
+    static constexpr qint64 expirationTimeoutMs = 120000;   ///< timeout with no update in ms after which the vehicle is removed.
+                                                            ///< AirMap sends updates for each vehicle every second.
+
 signals:
     void coordinateChanged  ();
     void callsignChanged    ();
@@ -75,9 +78,6 @@ private:
     bool            _alert;
 
     QElapsedTimer   _lastUpdateTimer;
-
-    static constexpr qint64 expirationTimeoutMs = 120000;   ///< timeout with no update in ms after which the vehicle is removed.
-                                                            ///< AirMap sends updates for each vehicle every second.
 };
 
 Q_DECLARE_METATYPE(ADSBVehicle::VehicleInfo_t)
@@ -14,10 +14,36 @@
 #include "ADSBVehicleManagerSettings.h"
 
 #include <QDebug>
+#include <QtMath>
+
+#include <algorithm>
+#include <cstring>
+
+/// Adds the available values of from to to
+static void _mergeVehicleInfo(ADSBVehicle::VehicleInfo_t& to, const ADSBVehicle::VehicleInfo_t& from)
+{
+    if (from.availableFlags & ADSBVehicle::CallsignAvailable) {
+        to.callsign = from.callsign;
+    }
+    if (from.availableFlags & ADSBVehicle::LocationAvailable) {
+        to.location = from.location;
+    }
+    if (from.availableFlags & ADSBVehicle::AltitudeAvailable) {
+        to.altitude = from.altitude;
+    }
+    if (from.availableFlags & ADSBVehicle::HeadingAvailable) {
+        to.heading = from.heading;
+    }
+    if (from.availableFlags & ADSBVehicle::AlertAvailable) {
+        to.alert = from.alert;
+    }
+    to.availableFlags |= from.availableFlags;
+}
 
 ADSBVehicleManager::ADSBVehicleManager(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
 {
+    _trafficClock.start();
 }
 
 void ADSBVehicleManager::setToolbox(QGCToolbox* toolbox)
@@ -28,10 +54,15 @@ void ADSBVehicleManager::setToolbox(QGCToolbox* toolbox)
     _adsbVehicleCleanupTimer.setSingleShot(false);
     _adsbVehicleCleanupTimer.start(1000);
 
+    // Updates come in per SBS-1 line or ADSB_VEHICLE message, they are applied together at a fixed rate
+    connect(&_batchTimer, &QTimer::timeout, this, &ADSBVehicleManager::_applyPendingUpdates);
+    _batchTimer.setSingleShot(true);
+    _batchTimer.setInterval(_batchIntervalMSecs);
+
     ADSBVehicleManagerSettings* settings = qgcApp()->toolbox()->settingsManager()->adsbVehicleManagerSettings();
     if (settings->adsbServerConnectEnabled()->rawValue().toBool()) {
         _tcpLink = new ADSBTCPLink(settings->adsbServerHostAddress()->rawValue().toString(), settings->adsbServerPort()->rawValue().toInt(), this);
-        connect(_tcpLink, &ADSBTCPLink::adsbVehicleUpdate,  this, &ADSBVehicleManager::adsbVehicleUpdate,   Qt::QueuedConnection);
+        connect(_tcpLink, &ADSBTCPLink::adsbVehicleUpdates, this, &ADSBVehicleManager::adsbVehicleUpdates,  Qt::QueuedConnection);
         connect(_tcpLink, &ADSBTCPLink::error,              this, &ADSBVehicleManager::_tcpError,           Qt::QueuedConnection);
     }
 }
@@ -48,21 +79,198 @@ void ADSBVehicleManager::_cleanupStaleVehicles()
             adsbVehicle->deleteLater();
         }
     }
+
+    const qint64    now     = _trafficClock.elapsed();
+    bool            removed = false;
+    for (auto iter = _traffic.begin(); iter != _traffic.end(); ) {
+        if (now - iter->lastUpdateMSecs > ADSBVehicle::expirationTimeoutMs) {
+            _gridRemove(iter.key(), iter.value());
+            iter = _traffic.erase(iter);
+            removed = true;
+        } else {
+            iter++;
+        }
+    }
+    if (removed) {
+        emit trafficUpdated();
+    }
 }
 
 void ADSBVehicleManager::adsbVehicleUpdate(const ADSBVehicle::VehicleInfo_t vehicleInfo)
 {
-    uint32_t icaoAddress = vehicleInfo.icaoAddress;
-
-    if (_adsbICAOMap.contains(icaoAddress)) {
-        _adsbICAOMap[icaoAddress]->update(vehicleInfo);
+    auto iter = _pendingUpdates.find(vehicleInfo.icaoAddress);
+    if (iter == _pendingUpdates.end()) {
+        _pendingUpdates.insert(vehicleInfo.icaoAddress, vehicleInfo);
     } else {
-        if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
+        _mergeVehicleInfo(iter.value(), vehicleInfo);
+    }
+    if (!_batchTimer.isActive()) {
+        _batchTimer.start();
+    }
+}
+
+void ADSBVehicleManager::adsbVehicleUpdates(const QList<ADSBVehicle::VehicleInfo_t> vehicleInfos)
+{
+    for (const ADSBVehicle::VehicleInfo_t& vehicleInfo: vehicleInfos) {
+        adsbVehicleUpdate(vehicleInfo);
+    }
+}
+
+void ADSBVehicleManager::_updateTraffic(Traffic_t& traffic, const ADSBVehicle::VehicleInfo_t& vehicleInfo)
+{
+    if (vehicleInfo.availableFlags & ADSBVehicle::CallsignAvailable) {
+        traffic.callsign = vehicleInfo.callsign;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable) {
+        traffic.coordinate = vehicleInfo.location;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::AltitudeAvailable) {
+        traffic.altitude = vehicleInfo.altitude;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::HeadingAvailable) {
+        traffic.heading = vehicleInfo.heading;
+    }
+    if (vehicleInfo.availableFlags & ADSBVehicle::AlertAvailable) {
+        traffic.alert = vehicleInfo.alert;
+    }
+    traffic.lastUpdateMSecs = _trafficClock.elapsed();
+}
+
+void ADSBVehicleManager::_applyPendingUpdates(void)
+{
+    for (const ADSBVehicle::VehicleInfo_t& vehicleInfo: _pendingUpdates) {
+        uint32_t icaoAddress = vehicleInfo.icaoAddress;
+
+        auto iter = _traffic.find(icaoAddress);
+        if (iter == _traffic.end()) {
+            // Aircraft are only added once their location is known
+            if (!(vehicleInfo.availableFlags & ADSBVehicle::LocationAvailable)) {
+                continue;
+            }
+            Traffic_t traffic = { icaoAddress, QString(), QGeoCoordinate(), qQNaN(), qQNaN(), false, 0, 0 };
+            iter = _traffic.insert(icaoAddress, traffic);
+            _updateTraffic(iter.value(), vehicleInfo);
+            _gridInsert(icaoAddress, iter.value());
+        } else {
+            _updateTraffic(iter.value(), vehicleInfo);
+            if (_gridCell(_gridRow(iter->coordinate.latitude()), _gridColumn(iter->coordinate.longitude())) != iter->gridCell) {
+                _gridRemove(icaoAddress, iter.value());
+                _gridInsert(icaoAddress, iter.value());
+            }
+        }
+
+        // The object model is still kept up to date for the users of adsbVehicles, with a single update per batch
+        if (_adsbICAOMap.contains(icaoAddress)) {
+            _adsbICAOMap[icaoAddress]->update(vehicleInfo);
+        } else {
             ADSBVehicle* adsbVehicle = new ADSBVehicle(vehicleInfo, this);
             _adsbICAOMap[icaoAddress] = adsbVehicle;
             _adsbVehicles.append(adsbVehicle);
         }
     }
+    _pendingUpdates.clear();
+
+    emit trafficUpdated();
+}
+
+int ADSBVehicleManager::_gridRow(double latitude)
+{
+    return qBound(0, qFloor((latitude + 90.0) * _gridCellsPerDegree), _gridRows - 1);
+}
+
+int ADSBVehicleManager::_gridColumn(double longitude)
+{
+    // Wraps around, so a range of columns may cross the antimeridian
+    const int column = qFloor((longitude + 180.0) * _gridCellsPerDegree) % _gridColumns;
+    return column < 0 ? column + _gridColumns : column;
+}
+
+void ADSBVehicleManager::_gridInsert(uint32_t icaoAddress, Traffic_t& traffic)
+{
+    traffic.gridCell = _gridCell(_gridRow(traffic.coordinate.latitude()), _gridColumn(traffic.coordinate.longitude()));
+    _trafficGrid[traffic.gridCell].append(icaoAddress);
+}
+
+void ADSBVehicleManager::_gridRemove(uint32_t icaoAddress, const Traffic_t& traffic)
+{
+    auto iter = _trafficGrid.find(traffic.gridCell);
+    if (iter != _trafficGrid.end()) {
+        iter->removeOne(icaoAddress);
+        if (iter->isEmpty()) {
+            _trafficGrid.erase(iter);
+        }
+    }
+}
+
+QList<ADSBVehicleManager::TrafficDistance_t> ADSBVehicleManager::trafficInRadius(const QGeoCoordinate& coordinate, double radiusMeters) const
+{
+    // Same sphere as QGeoCoordinate::distanceTo
+    static const double earthRadiusMeters = 6371007.2;
+
+    QList<TrafficDistance_t> result;
+
+    if (!coordinate.isValid() || radiusMeters < 0 || _traffic.isEmpty()) {
+        return result;
+    }
+
+    // Bounding box of the circle, the longitude span is the widest point of it on the sphere
+    const double    angularRadius   = radiusMeters / earthRadiusMeters;
+    const double    latitude        = coordinate.latitude();
+    const double    latitudeSpan    = qRadiansToDegrees(angularRadius);
+    const int       firstRow        = _gridRow(latitude - latitudeSpan);
+    const int       lastRow         = _gridRow(latitude + latitudeSpan);
+    int             firstColumn     = 0;
+    int             cColumns        = _gridColumns;
+    if (qAbs(latitude) + latitudeSpan < 90.0) {
+        const double longitudeSpan = qRadiansToDegrees(qAsin(qMin(1.0, qSin(angularRadius) / qCos(qDegreesToRadians(latitude)))));
+        firstColumn = _gridColumn(coordinate.longitude() - longitudeSpan);
+        cColumns    = _gridColumn(coordinate.longitude() + longitudeSpan) - firstColumn + 1;
+        if (cColumns <= 0) {
+            cColumns += _gridColumns;
+        }
+    }
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int i = 0; i < cColumns; i++) {
+            auto cellIter = _trafficGrid.constFind(_gridCell(row, (firstColumn + i) % _gridColumns));
+            if (cellIter == _trafficGrid.constEnd()) {
+                continue;
+            }
+            for (uint32_t icaoAddress: cellIter.value()) {
+                const double distance = coordinate.distanceTo(_traffic.constFind(icaoAddress)->coordinate);
+                if (distance <= radiusMeters) {
+                    result.append({ icaoAddress, distance });
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const TrafficDistance_t& a, const TrafficDistance_t& b) { return a.distance < b.distance; });
+    return result;
+}
+
+QList<ADSBVehicleManager::TrafficDistance_t> ADSBVehicleManager::nearestTraffic(const QGeoCoordinate& coordinate, int count, double maxRadiusMeters) const
+{
+    QList<TrafficDistance_t> result;
+
+    if (count <= 0) {
+        return result;
+    }
+
+    // Grow the search until it holds enough traffic, everything closer than the radius is in the result at that point
+    double radiusMeters = qMin(maxRadiusMeters, static_cast<double>(_nearestStartRadiusMeters));
+    while (true) {
+        result = trafficInRadius(coordinate, radiusMeters);
+        if (result.count() >= count || radiusMeters >= maxRadiusMeters || result.count() == _traffic.count()) {
+            break;
+        }
+        radiusMeters = qMin(maxRadiusMeters, radiusMeters * 2);
+    }
+
+    if (result.count() > count) {
+        result.erase(result.begin() + count, result.end());
+    }
+    return result;
 }
 
 void ADSBVehicleManager::_tcpError(const QString errorMsg)
@@ -120,73 +328,234 @@ void ADSBTCPLink::_hardwareConnect()
 
 void ADSBTCPLink::_readBytes(void)
 {
-    if (_socket) {
-        QByteArray bytes = _socket->readLine();
-        _parseLine(QString::fromLocal8Bit(bytes));
+    if (!_socket) {
+        return;
     }
-}
 
-void ADSBTCPLink::_parseLine(const QString& line)
-{
-    if (line.startsWith(QStringLiteral("MSG"))) {
-        qCDebug(ADSBVehicleManagerLog) << "ADSB SBS-1" << line;
+    _readBuffer.append(_socket->readAll());
 
-        QStringList values = line.split(QStringLiteral(","));
+    // An aircraft sends several messages per second, only the combination of them from this read goes out
+    QHash<uint32_t, ADSBVehicle::VehicleInfo_t> vehicleInfos;
+    const char* data        = _readBuffer.constData();
+    int         lineStart   = 0;
+    while (true) {
+        const char* newline = static_cast<const char*>(memchr(data + lineStart, '\n', static_cast<size_t>(_readBuffer.size() - lineStart)));
+        if (!newline) {
+            break;
+        }
+        const int lineEnd = static_cast<int>(newline - data);
+
+        ADSBVehicle::VehicleInfo_t adsbInfo;
+        if (parseLine(data + lineStart, lineEnd - lineStart, adsbInfo)) {
+            auto iter = vehicleInfos.find(adsbInfo.icaoAddress);
+            if (iter == vehicleInfos.end()) {
+                vehicleInfos.insert(adsbInfo.icaoAddress, adsbInfo);
+            } else {
+                _mergeVehicleInfo(iter.value(), adsbInfo);
+            }
+        }
+        lineStart = lineEnd + 1;
+    }
+    _readBuffer.remove(0, lineStart);
+    if (_readBuffer.size() > _maxLineLength) {
+        qCDebug(ADSBVehicleManagerLog) << "ADSB SBS-1 discarding line without end" << _readBuffer.size();
+        _readBuffer.clear();
+    }
 
-        if (values[1] == QStringLiteral("3")) {
-            bool icaoOk, altOk, latOk, lonOk;
+    if (!vehicleInfos.isEmpty()) {
+        emit adsbVehicleUpdates(vehicleInfos.values());
+    }
+}
 
-            uint32_t    icaoAddress =   values[4].toUInt(&icaoOk, 16);
-            int         modeCAltitude = values[11].toInt(&altOk);
-            double      lat =           values[14].toDouble(&latOk);
-            double      lon =           values[15].toDouble(&lonOk);
-            QString     callsign =      values[10];
+/// Parses an unsigned hex field such as an ICAO address
+static bool _parseHexField(const char* field, int length, uint32_t& value)
+{
+    if (length < 1 || length > 8) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < length; i++) {
+        const char c = field[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    return true;
+}
 
-            if (!icaoOk || !altOk || !latOk || !lonOk) {
-                return;
+/// Parses a decimal field with an optional sign and fraction. The mantissa is collected as an integer and divided
+/// by an exact power of ten, which gives the correctly rounded value for the up to 18 digits allowed here.
+static bool _parseDecimalField(const char* field, int length, double& value)
+{
+    static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+    static const int    maxDigits = 18;
+
+    int     index           = 0;
+    bool    negative        = false;
+    bool    fraction        = false;
+    int     cDigits         = 0;
+    int     cFractionDigits = 0;
+    qint64  mantissa        = 0;
+
+    if (index < length && (field[index] == '-' || field[index] == '+')) {
+        negative = field[index] == '-';
+        index++;
+    }
+    for (; index < length; index++) {
+        const char c = field[index];
+        if (c >= '0' && c <= '9') {
+            if (++cDigits > maxDigits) {
+                return false;
             }
-            if (lat == 0 && lon == 0) {
-                return;
+            mantissa = (mantissa * 10) + (c - '0');
+            if (fraction) {
+                cFractionDigits++;
             }
+        } else if (c == '.' && !fraction) {
+            fraction = true;
+        } else {
+            return false;
+        }
+    }
+    if (cDigits == 0) {
+        return false;
+    }
 
-            double altitude = modeCAltitude / 3.048;
-            QGeoCoordinate location(lat, lon);
+    value = static_cast<double>(mantissa) / powersOfTen[cFractionDigits];
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
 
-            ADSBVehicle::VehicleInfo_t adsbInfo;
-            adsbInfo.icaoAddress = icaoAddress;
-            adsbInfo.callsign = callsign;
-            adsbInfo.location = location;
-            adsbInfo.altitude = altitude;
-            adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable | ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable;
-            emit adsbVehicleUpdate(adsbInfo);
-        } else if (values[1] == QStringLiteral("4")) {
-            bool icaoOk, headingOk;
+/// Parses a whole number field with an optional sign
+static bool _parseIntField(const char* field, int length, int& value)
+{
+    // Nine digits always fit in an int
+    static const int maxDigits = 9;
 
-            uint32_t    icaoAddress =   values[4].toUInt(&icaoOk, 16);
-            double      heading =       values[13].toDouble(&headingOk);
+    int     index       = 0;
+    bool    negative    = false;
 
-            if (!icaoOk || !headingOk) {
-                return;
-            }
+    if (index < length && (field[index] == '-' || field[index] == '+')) {
+        negative = field[index] == '-';
+        index++;
+    }
+    if (index == length || length - index > maxDigits) {
+        return false;
+    }
+    value = 0;
+    for (; index < length; index++) {
+        const char c = field[index];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = (value * 10) + (c - '0');
+    }
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
 
-            ADSBVehicle::VehicleInfo_t adsbInfo;
-            adsbInfo.icaoAddress = icaoAddress;
-            adsbInfo.heading = heading;
-            adsbInfo.availableFlags = ADSBVehicle::HeadingAvailable;
-            emit adsbVehicleUpdate(adsbInfo);
-        } else if (values[1] == QStringLiteral("1")) {
-            bool icaoOk;
-
-            uint32_t icaoAddress = values[4].toUInt(&icaoOk, 16);
-            if (!icaoOk) {
-                return;
-            }
+bool ADSBTCPLink::parseLine(const char* line, int length, ADSBVehicle::VehicleInfo_t& adsbInfo)
+{
+    // Fields of the SBS-1 line which are used, the lines have 22 of them
+    enum {
+        FieldTransmissionType   = 1,
+        FieldIcao               = 4,
+        FieldCallsign           = 10,
+        FieldAltitude           = 11,
+        FieldHeading            = 13,
+        FieldLatitude           = 14,
+        FieldLongitude          = 15,
+        FieldCount
+    };
+
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        length--;
+    }
+    if (length < 3 || memcmp(line, "MSG", 3) != 0) {
+        return false;
+    }
+
+    qCDebug(ADSBVehicleManagerLog) << "ADSB SBS-1" << QByteArray::fromRawData(line, length);
+
+    // Only the start and length of each field is noted, nothing is copied
+    const char* fields[FieldCount];
+    int         fieldLengths[FieldCount];
+    const char* lineEnd = line + length;
+    const char* start   = line;
+    int         cFields = 0;
+    while (cFields < FieldCount) {
+        const char* comma = static_cast<const char*>(memchr(start, ',', static_cast<size_t>(lineEnd - start)));
+        fields[cFields]         = start;
+        fieldLengths[cFields]   = static_cast<int>((comma ? comma : lineEnd) - start);
+        cFields++;
+        if (!comma) {
+            break;
+        }
+        start = comma + 1;
+    }
+    if (cFields < FieldCount || fieldLengths[FieldTransmissionType] != 1) {
+        return false;
+    }
+
+    uint32_t icaoAddress;
+    if (!_parseHexField(fields[FieldIcao], fieldLengths[FieldIcao], icaoAddress)) {
+        return false;
+    }
 
-            ADSBVehicle::VehicleInfo_t adsbInfo;
-            adsbInfo.icaoAddress = icaoAddress;
-            adsbInfo.callsign = values[10];
-            adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable;
-            emit adsbVehicleUpdate(adsbInfo);
+    switch (fields[FieldTransmissionType][0]) {
+    case '3':
+    {
+        int     modeCAltitude;
+        double  lat;
+        double  lon;
+
+        if (!_parseIntField(fields[FieldAltitude], fieldLengths[FieldAltitude], modeCAltitude) ||
+                !_parseDecimalField(fields[FieldLatitude], fieldLengths[FieldLatitude], lat) ||
+                !_parseDecimalField(fields[FieldLongitude], fieldLengths[FieldLongitude], lon)) {
+            return false;
         }
+        if (lat == 0 && lon == 0) {
+            return false;
+        }
+
+        adsbInfo.icaoAddress = icaoAddress;
+        adsbInfo.callsign = QString::fromLatin1(fields[FieldCallsign], fieldLengths[FieldCallsign]);
+        adsbInfo.location = QGeoCoordinate(lat, lon);
+        adsbInfo.altitude = modeCAltitude / 3.048;
+        adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable | ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable;
+        return true;
+    }
+    case '4':
+    {
+        double heading;
+
+        if (!_parseDecimalField(fields[FieldHeading], fieldLengths[FieldHeading], heading)) {
+            return false;
+        }
+
+        adsbInfo.icaoAddress = icaoAddress;
+        adsbInfo.heading = heading;
+        adsbInfo.availableFlags = ADSBVehicle::HeadingAvailable;
+        return true;
+    }
+    case '1':
+        adsbInfo.icaoAddress = icaoAddress;
+        adsbInfo.callsign = QString::fromLatin1(fields[FieldCallsign], fieldLengths[FieldCallsign]);
+        adsbInfo.availableFlags = ADSBVehicle::CallsignAvailable;
+        return true;
+    default:
+        return false;
     }
 }
@@ -16,7 +16,11 @@
 #include <QThread>
 #include <QTcpSocket>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QGeoCoordinate>
+#include <QHash>
+#include <QList>
+#include <QVector>
 
 class ADSBVehicleManagerSettings;
 
@@ -28,8 +32,15 @@ public:
     ADSBTCPLink(const QString& hostAddress, int port, QObject* parent);
     ~ADSBTCPLink();
 
+    /// Parses an SBS-1 line in place
+    ///     @param line Line contents, the line ending is optional
+    ///     @param[out] adsbInfo Values from the line
+    /// @return false: Not a line with an update, or it is malformed
+    static bool parseLine(const char* line, int length, ADSBVehicle::VehicleInfo_t& adsbInfo);
+
 signals:
-    void adsbVehicleUpdate(const ADSBVehicle::VehicleInfo_t vehicleInfo);
+    /// All the updates parsed from one read of the socket
+    void adsbVehicleUpdates(const QList<ADSBVehicle::VehicleInfo_t> vehicleInfos);    ///< At most one per aircraft
     void error(const QString errorMsg);
 
 protected:
@@ -40,11 +51,13 @@ private slots:
 
 private:
     void _hardwareConnect(void);
-    void _parseLine(const QString& line);
 
     QString         _hostAddress;
     int             _port;
     QTcpSocket*     _socket =   nullptr;
+    QByteArray      _readBuffer;            ///< Partial line left over from the last read
+
+    static const int _maxLineLength = 1024; ///< SBS-1 lines are way shorter, anything longer is garbage
 };
 
 class ADSBVehicleManager : public QGCTool {
@@ -53,23 +66,74 @@ class ADSBVehicleManager : public QGCTool {
 public:
     ADSBVehicleManager(QGCApplication* app, QGCToolbox* toolbox);
 
+    /// Aircraft in the traffic store. Plain values, so displaying a lot of traffic doesn't need an object per aircraft.
+    typedef struct {
+        uint32_t        icaoAddress;
+        QString         callsign;
+        QGeoCoordinate  coordinate;
+        double          altitude;           ///< NaN for not available
+        double          heading;            ///< NaN for not available
+        bool            alert;
+        qint64          lastUpdateMSecs;    ///< Time of the last update on trafficClock()
+        quint64         gridCell;           ///< Cell of the spatial index the aircraft is in
+    } Traffic_t;
+
+    typedef struct {
+        uint32_t        icaoAddress;
+        double          distance;           ///< Meters
+    } TrafficDistance_t;
+
     Q_PROPERTY(QmlObjectListModel* adsbVehicles READ adsbVehicles CONSTANT)
 
     QmlObjectListModel* adsbVehicles(void) { return &_adsbVehicles; }
 
+    /// Traffic store, keyed by ICAO address. Updates are applied to it in batches, trafficUpdated is signalled after each.
+    const QHash<uint32_t, Traffic_t>&   traffic         (void) const { return _traffic; }
+    const QElapsedTimer&                trafficClock    (void) const { return _trafficClock; }
+
+    /// @return Traffic within radiusMeters of the coordinate, closest first
+    QList<TrafficDistance_t> trafficInRadius(const QGeoCoordinate& coordinate, double radiusMeters) const;
+    /// @return Up to count aircraft closest to the coordinate, closest first. Traffic further away than maxRadiusMeters isn't considered.
+    QList<TrafficDistance_t> nearestTraffic(const QGeoCoordinate& coordinate, int count, double maxRadiusMeters = 500000) const;
+
     // QGCTool overrides
     void setToolbox(QGCToolbox* toolbox) final;
 
+signals:
+    void trafficUpdated(void);
+
 public slots:
+    /// Queues the update, it is applied with the next batch
     void adsbVehicleUpdate  (const ADSBVehicle::VehicleInfo_t vehicleInfo);
+    void adsbVehicleUpdates (const QList<ADSBVehicle::VehicleInfo_t> vehicleInfos);
     void _tcpError          (const QString errorMsg);
 
 private slots:
-    void _cleanupStaleVehicles(void);
+    void _cleanupStaleVehicles  (void);
+    void _applyPendingUpdates   (void);
 
 private:
-    QmlObjectListModel              _adsbVehicles;
-    QMap<uint32_t, ADSBVehicle*>    _adsbICAOMap;
-    QTimer                          _adsbVehicleCleanupTimer;
-    ADSBTCPLink*                    _tcpLink = nullptr;
+    void _updateTraffic(Traffic_t& traffic, const ADSBVehicle::VehicleInfo_t& vehicleInfo);
+    void _gridInsert    (uint32_t icaoAddress, Traffic_t& traffic);
+    void _gridRemove    (uint32_t icaoAddress, const Traffic_t& traffic);
+
+    static int      _gridRow    (double latitude);
+    static int      _gridColumn (double longitude);
+    static quint64  _gridCell   (int row, int column) { return (static_cast<quint64>(row) << 32) | static_cast<quint32>(column); }
+
+    QmlObjectListModel                              _adsbVehicles;
+    QMap<uint32_t, ADSBVehicle*>                    _adsbICAOMap;
+    QTimer                                          _adsbVehicleCleanupTimer;
+    ADSBTCPLink*                                    _tcpLink = nullptr;
+    QHash<uint32_t, Traffic_t>                      _traffic;
+    QElapsedTimer                                   _trafficClock;
+    QHash<uint32_t, ADSBVehicle::VehicleInfo_t>     _pendingUpdates;        ///< Merged updates by ICAO address waiting for the next batch
+    QTimer                                          _batchTimer;
+    QHash<quint64, QVector<uint32_t>>               _trafficGrid;           ///< Spatial index of _traffic, ICAO addresses by cell
+
+    static const int _batchIntervalMSecs        = 250;
+    static const int _gridCellsPerDegree        = 4;                        ///< Cells are a quarter degree on each side
+    static const int _gridRows                  = 180 * _gridCellsPerDegree;
+    static const int _gridColumns               = 360 * _gridCellsPerDegree;
+    static const int _nearestStartRadiusMeters  = 25000;
 };
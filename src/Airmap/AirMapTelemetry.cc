@@ -17,10 +17,124 @@
 
 using namespace airmap;
 
+//-----------------------------------------------------------------------------
+void
+AirMapTelemetrySample::setGlobalPosition(const mavlink_global_position_int_t& globalPosition)
+{
+    QMutexLocker locker(&_mutex);
+    _globalPosition = globalPosition;
+    _fresh          = true;
+}
+
+//-----------------------------------------------------------------------------
+void
+AirMapTelemetrySample::setHdop(float hdop)
+{
+    QMutexLocker locker(&_mutex);
+    _hdop = hdop;
+}
+
+//-----------------------------------------------------------------------------
+bool
+AirMapTelemetrySample::take(mavlink_global_position_int_t& globalPosition, float& hdop)
+{
+    QMutexLocker locker(&_mutex);
+    if (!_fresh) {
+        return false;
+    }
+    globalPosition  = _globalPosition;
+    hdop            = _hdop;
+    _fresh          = false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+AirMapTelemetrySender::AirMapTelemetrySender(AirMapTelemetrySample& sample)
+    : _sample(sample)
+{
+}
+
+//-----------------------------------------------------------------------------
+void
+AirMapTelemetrySender::start(airmap::qt::Client* client, QString flightID, QByteArray key)
+{
+    if (!_sendTimer) {
+        _sendTimer = new QTimer(this);
+        _sendTimer->setInterval(_sendIntervalMSecs);
+        connect(_sendTimer, &QTimer::timeout, this, &AirMapTelemetrySender::_send);
+    }
+    _client     = client;
+    _flightID   = flightID.toStdString();
+    _key        = key.toStdString();
+    // Drop whatever came in before the stream was up
+    mavlink_global_position_int_t globalPosition;
+    float hdop;
+    _sample.take(globalPosition, hdop);
+    _sendTimer->start();
+}
+
+//-----------------------------------------------------------------------------
+void
+AirMapTelemetrySender::stop(void)
+{
+    if (_sendTimer) {
+        _sendTimer->stop();
+    }
+    _client = nullptr;
+    _key.clear();
+}
+
+//-----------------------------------------------------------------------------
+void
+AirMapTelemetrySender::_send(void)
+{
+    mavlink_global_position_int_t   globalPosition;
+    float                           hdop;
+    if (!_client || !_sample.take(globalPosition, hdop)) {
+        return;
+    }
+
+    Telemetry::Position position{
+        milliseconds_since_epoch(Clock::universal_time()),
+        static_cast<double>(globalPosition.lat / 1e7),
+        static_cast<double>(globalPosition.lon / 1e7),
+        static_cast<double>(globalPosition.alt) / 1000.0,
+        static_cast<double>(globalPosition.relative_alt) / 1000.0,
+        static_cast<double>(hdop)
+    };
+    Telemetry::Speed speed{
+        milliseconds_since_epoch(Clock::universal_time()),
+        globalPosition.vx / 100.f,
+        globalPosition.vy / 100.f,
+        globalPosition.vz / 100.f
+    };
+
+    //qCDebug(AirMapManagerLog) << "Telemetry:" << globalPosition.lat / 1e7 << globalPosition.lon / 1e7;
+    // The client hands the updates to the SDK's own context, which encrypts and sends them. That is safe from any thread.
+    Flight flight;
+    flight.id = _flightID;
+    _client->telemetry().submit_updates(flight, _key,
+        {Telemetry::Update{position}, Telemetry::Update{speed}});
+}
+
 //-----------------------------------------------------------------------------
 AirMapTelemetry::AirMapTelemetry(AirMapSharedState& shared)
     : _shared(shared)
+    , _sender(new AirMapTelemetrySender(_sample))
+{
+    qRegisterMetaType<airmap::qt::Client*>("airmap::qt::Client*");
+    _senderThread.setObjectName(QStringLiteral("AirMapTelemetry"));
+    _sender->moveToThread(&_senderThread);
+    connect(&_senderThread, &QThread::finished, _sender, &QObject::deleteLater);
+    _senderThread.start();
+}
+
+//-----------------------------------------------------------------------------
+AirMapTelemetry::~AirMapTelemetry()
 {
+    QMetaObject::invokeMethod(_sender, "stop", Qt::BlockingQueuedConnection);
+    _senderThread.quit();
+    _senderThread.wait();
 }
 
 //-----------------------------------------------------------------------------
@@ -54,9 +168,9 @@ AirMapTelemetry::_handleGPSRawInt(const mavlink_message_t& message)
     mavlink_gps_raw_int_t gps_raw;
     mavlink_msg_gps_raw_int_decode(&message, &gps_raw);
     if (gps_raw.eph == UINT16_MAX) {
-        _lastHdop = 1.f;
+        _sample.setHdop(1.f);
     } else {
-        _lastHdop = gps_raw.eph / 100.f;
+        _sample.setHdop(gps_raw.eph / 100.f);
     }
 }
 
@@ -67,34 +181,10 @@ AirMapTelemetry::_handleGlobalPositionInt(const mavlink_message_t& message)
     if (!isTelemetryStreaming()) {
         return;
     }
-    // rate-limit updates to 5 Hz
-    if (!_timerLastSent.hasExpired(200)) {
-        return;
-    }
-    _timerLastSent.restart();
-
+    // The sender picks up the latest position at its own rate
     mavlink_global_position_int_t globalPosition;
     mavlink_msg_global_position_int_decode(&message, &globalPosition);
-    Telemetry::Position position{
-        milliseconds_since_epoch(Clock::universal_time()),
-        static_cast<double>(globalPosition.lat / 1e7),
-        static_cast<double>(globalPosition.lon / 1e7),
-        static_cast<double>(globalPosition.alt) / 1000.0,
-        static_cast<double>(globalPosition.relative_alt) / 1000.0,
-        static_cast<double>(_lastHdop)
-    };
-    Telemetry::Speed speed{
-        milliseconds_since_epoch(Clock::universal_time()),
-        globalPosition.vx / 100.f,
-        globalPosition.vy / 100.f,
-        globalPosition.vz / 100.f
-    };
-
-    //qCDebug(AirMapManagerLog) << "Telemetry:" << globalPosition.lat / 1e7 << globalPosition.lon / 1e7;
-    Flight flight;
-    flight.id = _flightID.toStdString();
-    _shared.client()->telemetry().submit_updates(flight, _key,
-        {Telemetry::Update{position}, Telemetry::Update{speed}});
+    _sample.setGlobalPosition(globalPosition);
 }
 
 //-----------------------------------------------------------------------------
@@ -120,8 +210,11 @@ AirMapTelemetry::startTelemetryStream(const QString& flightID)
         if (!isAlive.lock()) return;
         if (_state != State::StartCommunication) return;
         if (result) {
-            _key = result.value().key;
             _state = State::Streaming;
+            QMetaObject::invokeMethod(_sender, "start", Qt::QueuedConnection,
+                                      Q_ARG(airmap::qt::Client*, _shared.client()),
+                                      Q_ARG(QString, _flightID),
+                                      Q_ARG(QByteArray, QByteArray::fromStdString(result.value().key)));
         } else {
             _state = State::Idle;
             QString description = QString::fromStdString(result.error().description() ? result.error().description().get() : "");
@@ -129,7 +222,6 @@ AirMapTelemetry::startTelemetryStream(const QString& flightID)
                     QString::fromStdString(result.error().message()), description);
         }
     });
-    _timerLastSent.start();
 }
 
 //-----------------------------------------------------------------------------
@@ -141,6 +233,7 @@ AirMapTelemetry::stopTelemetryStream()
     }
     qCInfo(AirMapManagerLog) << "Stopping Telemetry stream with flightID" << _flightID;
     _state = State::EndCommunication;
+    QMetaObject::invokeMethod(_sender, "stop", Qt::QueuedConnection);
     Flights::EndFlightCommunications::Parameters params;
     params.authorization = _shared.loginToken().toStdString();
     params.id = _flightID.toStdString();
@@ -149,7 +242,6 @@ AirMapTelemetry::stopTelemetryStream()
         Q_UNUSED(result);
         if (!isAlive.lock()) return;
         if (_state != State::EndCommunication) return;
-        _key = "";
         _state = State::Idle;
     });
 }
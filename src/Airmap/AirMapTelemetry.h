@@ -15,15 +15,61 @@
 #include <QGCMAVLink.h>
 
 #include <QObject>
-#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+
+/// Latest vehicle position for AirMapTelemetrySender, written on the GUI thread
+class AirMapTelemetrySample
+{
+public:
+    void setGlobalPosition  (const mavlink_global_position_int_t& globalPosition);
+    void setHdop            (float hdop);
+
+    /// @return false: No new position since the last take
+    bool take(mavlink_global_position_int_t& globalPosition, float& hdop);
+
+private:
+    QMutex                          _mutex;
+    mavlink_global_position_int_t   _globalPosition;
+    float                           _hdop   = 1.f;
+    bool                            _fresh  = false;
+};
+
+/// Packs, encrypts and submits the telemetry of a flight on the telemetry thread, at no more than the rate AirMap asks for
+class AirMapTelemetrySender : public QObject
+{
+    Q_OBJECT
+public:
+    AirMapTelemetrySender(AirMapTelemetrySample& sample);
+
+public slots:
+    void start  (airmap::qt::Client* client, QString flightID, QByteArray key);
+    void stop   (void);
+
+private slots:
+    void _send  (void);
+
+private:
+    AirMapTelemetrySample&  _sample;
+    airmap::qt::Client*     _client     = nullptr;
+    std::string             _flightID;
+    std::string             _key;                   ///< key for AES encryption (16 bytes)
+    QTimer*                 _sendTimer  = nullptr;  ///< Created on the telemetry thread
+
+    static const int _sendIntervalMSecs = 200;      ///< AirMap asks for telemetry at no more than 5 Hz
+};
 
 /// Class to send telemetry data to AirMap
+///
+/// Vehicle messages only update AirMapTelemetrySample on the GUI thread. Building the updates and handing them to the
+/// SDK happens on a thread of its own.
 class AirMapTelemetry : public QObject, public LifetimeChecker
 {
     Q_OBJECT
 public:
     AirMapTelemetry                 (AirMapSharedState& shared);
-    virtual ~AirMapTelemetry        () = default;
+    virtual ~AirMapTelemetry        ();
 
     void startTelemetryStream       (const QString& flightID);
     void stopTelemetryStream        ();
@@ -49,9 +95,8 @@ private:
 
     State                   _state = State::Idle;
     AirMapSharedState&      _shared;
-    std::string             _key; ///< key for AES encryption (16 bytes)
     QString                 _flightID;
-    float                   _lastHdop = 1.f;
-    QElapsedTimer           _timerLastSent;
+    AirMapTelemetrySample   _sample;
+    QThread                 _senderThread;
+    AirMapTelemetrySender*  _sender;
 };
-
@@ -16,6 +16,7 @@ using namespace airmap;
 AirMapTrafficMonitor::AirMapTrafficMonitor(AirMapSharedState& shared)
     : _shared(shared)
 {
+    qRegisterMetaType<QList<AirspaceVehicleManager::Traffic_t>>("QList<AirspaceVehicleManager::Traffic_t>");
 }
 
 //-----------------------------------------------------------------------------
@@ -58,11 +59,19 @@ AirMapTrafficMonitor::_update(Traffic::Update::Type type, const std::vector<Traf
     qCDebug(AirMapManagerLog) << "Traffic update with" << update.size() << "elements";
     if (type != Traffic::Update::Type::situational_awareness)
         return; // currently we're only interested in situational awareness
+    QList<AirspaceVehicleManager::Traffic_t> batch;
+    batch.reserve(static_cast<int>(update.size()));
     for (const auto& traffic : update) {
-        QString traffic_id = QString::fromStdString(traffic.id);
-        QString vehicle_id = QString::fromStdString(traffic.aircraft_id);
-        emit trafficUpdate(type == Traffic::Update::Type::alert, traffic_id, vehicle_id,
-            QGeoCoordinate(traffic.latitude, traffic.longitude, traffic.altitude), static_cast<float>(traffic.heading));
+        AirspaceVehicleManager::Traffic_t aircraft;
+        aircraft.alert      = type == Traffic::Update::Type::alert;
+        aircraft.trafficId  = QString::fromStdString(traffic.id);
+        aircraft.vehicleId  = QString::fromStdString(traffic.aircraft_id);
+        aircraft.location   = QGeoCoordinate(traffic.latitude, traffic.longitude, traffic.altitude);
+        aircraft.heading    = static_cast<float>(traffic.heading);
+        batch.append(aircraft);
+    }
+    if (!batch.isEmpty()) {
+        emit trafficUpdate(batch);
     }
 }
 
@@ -11,6 +11,7 @@
 
 #include "LifetimeChecker.h"
 #include "AirMapSharedState.h"
+#include "AirspaceVehicleManager.h"
 
 #include <QObject>
 #include <QGeoCoordinate>
@@ -37,7 +38,8 @@ public:
 
 signals:
     void error                      (const QString& what, const QString& airmapdMessage, const QString& airmapdDetails);
-    void trafficUpdate              (bool alert, QString traffic_id, QString vehicle_id, QGeoCoordinate location, float heading);
+    /// Signalled once per update from the SDK with all the aircraft in it, which may be on an SDK thread
+    void trafficUpdate              (const QList<AirspaceVehicleManager::Traffic_t> traffic);
 
 private:
     void _update                    (airmap::Traffic::Update::Type type, const std::vector<airmap::Traffic::Update>& update);
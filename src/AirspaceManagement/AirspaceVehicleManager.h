@@ -30,6 +30,14 @@ public:
     AirspaceVehicleManager           (const Vehicle& vehicle);
     virtual ~AirspaceVehicleManager  () = default;
 
+    typedef struct {
+        bool            alert;
+        QString         trafficId;
+        QString         vehicleId;
+        QGeoCoordinate  location;
+        float           heading;
+    } Traffic_t;
+
     /**
      * Setup the connection and start sending telemetry
      */
@@ -41,7 +49,8 @@ public slots:
     virtual void endFlight              () = 0;
 
 signals:
-    void trafficUpdate                  (bool alert, QString traffic_id, QString vehicle_id, QGeoCoordinate location, float heading);
+    /// All the aircraft of one traffic update from the provider
+    void trafficUpdate                  (const QList<AirspaceVehicleManager::Traffic_t> traffic);
     void flightPermitStatusChanged      ();
 
 protected slots:
@@ -56,3 +65,5 @@ private slots:
 private:
     bool _vehicleWasInMissionMode = false; ///< true if the vehicle was in mission mode when arming
 };
+
+Q_DECLARE_METATYPE(AirspaceVehicleManager::Traffic_t)
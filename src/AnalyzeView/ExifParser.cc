@@ -56,9 +56,23 @@ double ExifParser::readTime(QByteArray& buf)
     return tagTime.toMSecsSinceEpoch()/1000.0;
 }
 
+int ExifParser::headerLength(const QByteArray& buf)
+{
+    int app1HeaderInd = buf.indexOf(QByteArray("\xff\xe1", 2));
+    if (app1HeaderInd == -1 || app1HeaderInd + 4 > buf.count()) {
+        return -1;
+    }
+    // The segment length counts itself but not the marker
+    int length = app1HeaderInd + 2 + qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(buf.constData()) + app1HeaderInd + 2);
+    return length <= buf.count() ? length : -1;
+}
+
 bool ExifParser::write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geotag)
 {
     QByteArray app1Header("\xff\xe1", 2);
+    if (buf.indexOf(app1Header) == -1 || buf.indexOf(QByteArray("\x49\x49\x2A", 3)) == -1) {
+        return false;
+    }
     uint32_t app1HeaderInd = buf.indexOf(app1Header);
     uint16_t *conversionPointer = reinterpret_cast<uint16_t *>(buf.mid(app1HeaderInd + 2, 2).data());
     uint16_t app1Size = *conversionPointer;
@@ -122,6 +136,11 @@ bool ExifParser::write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geot
     char2uint32_u gpsIFDInd;
     gpsIFDInd.i = nextIfdOffset;
 
+    // Everything is written inside the EXIF data, which may be all there is of the image in buf
+    if (nextIfdOffsetInd + 16 > static_cast<uint32_t>(buf.count()) || gpsIFDInd.i + tiffHeaderInd > static_cast<uint32_t>(buf.count())) {
+        return false;
+    }
+
     // this will stay constant
     QByteArray gpsInfo("\x25\x88\x04\x00\x01\x00\x00\x00", 8);
     gpsInfo.append(gpsIFDInd.c[0]);
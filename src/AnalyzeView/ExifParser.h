@@ -13,6 +13,13 @@ public:
     ~ExifParser();
     double readTime(QByteArray& buf);
     bool write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geotag);
+
+    /// @return Length of buf up to the end of the EXIF APP1 segment, -1 if the segment is not all in buf
+    int headerLength(const QByteArray& buf);
+
+    /// Bytes to read from the start of an image for the EXIF data to be in them. The APP1 segment is at most 64KB,
+    /// the rest leaves room for the segments which come before it.
+    static const int maxHeaderSize = 0x10000 + 0x400;
 };
 
 #endif // EXIFPARSER_H
@@ -15,12 +15,17 @@
 #include <cfloat>
 #include <QDir>
 #include <QUrl>
+#include <QtConcurrent>
+#include <functional>
 
 #include "ExifParser.h"
 #include "ULogParser.h"
+#include "ULogReader.h"
 #include "PX4LogParser.h"
+#include "CameraTriggerPoints.h"
 
 static const char* kTagged = "/TAGGED";
+static const double kImageOpenFailed = -2.0;    // readTime returns -1 for images without a time
 
 GeoTagController::GeoTagController()
     : _progress(0)
@@ -42,10 +47,41 @@ void GeoTagController::setLogFile(QString filename)
     filename = QUrl(filename).toLocalFile();
     if (!filename.isEmpty()) {
         _worker.setLogFile(filename);
+        _worker.setTriggerList(QList<GeoTagWorker::cameraFeedbackPacket>());
         emit logFileChanged(filename);
+        emit vehicleTriggerCountChanged();
     }
 }
 
+void GeoTagController::useVehicleTriggers(CameraTriggerPoints* cameraTriggerPoints)
+{
+    if (!cameraTriggerPoints || _worker.isRunning()) {
+        return;
+    }
+
+    // The packed triggers go straight to the worker, no log has to be parsed for them
+    QList<GeoTagWorker::cameraFeedbackPacket> triggerList;
+    triggerList.reserve(cameraTriggerPoints->count());
+    for (const CameraTriggerPoints::Trigger_t& trigger: cameraTriggerPoints->triggers()) {
+        GeoTagWorker::cameraFeedbackPacket feedback;
+        memset(&feedback, 0, sizeof(feedback));
+        feedback.timestamp              = trigger.timeUTCUSecs / 1.0e6;
+        feedback.timestampUTC           = trigger.timeUTCUSecs / 1.0e6;
+        feedback.imageSequence          = trigger.imageIndex;
+        feedback.latitude               = trigger.latitude;
+        feedback.longitude              = trigger.longitude;
+        feedback.altitude               = trigger.altitude;
+        feedback.attitudeQuaternion[0]  = 1;
+        feedback.captureResult          = 1;
+        triggerList.append(feedback);
+    }
+
+    _worker.setLogFile(QString());
+    _worker.setTriggerList(triggerList);
+    emit logFileChanged(QString());
+    emit vehicleTriggerCountChanged();
+}
+
 void GeoTagController::setImageDirectory(QString dir)
 {
     dir = QUrl(dir).toLocalFile();
@@ -160,50 +196,52 @@ void GeoTagWorker::run()
     }
     emit progressChanged((100/nSteps));
 
-    // Parse EXIF
-    ExifParser exifParser;
+    // Parse EXIF, only the header of each image is read
     _imageTime.clear();
-    for (int i = 0; i < _imageList.size(); ++i) {
-        QFile file(_imageList.at(i).absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
-        }
-        QByteArray imageBuffer = file.readAll();
-        file.close();
-
-        _imageTime.append(exifParser.readTime(imageBuffer));
-
-        emit progressChanged((100/nSteps) + ((100/nSteps) / _imageList.size())*i);
-
-        if (_cancel) {
-            qCDebug(GeotaggingLog) << "Tagging cancelled";
-            emit error(tr("Tagging cancelled"));
-            return;
-        }
+    QFuture<double> timeFuture = QtConcurrent::mapped(_imageList, &GeoTagWorker::_readImageTime);
+    if (!_waitForFuture(timeFuture, 100/nSteps, 100/nSteps)) {
+        qCDebug(GeotaggingLog) << "Tagging cancelled";
+        emit error(tr("Tagging cancelled"));
+        return;
     }
-
-    // Load log
-    bool isULog = _logFile.endsWith(".ulg", Qt::CaseSensitive);
-    QFile file(_logFile);
-    if (!file.open(QIODevice::ReadOnly)) {
-        emit error(tr("Geotagging failed. Couldn't open log file."));
+    _imageTime = timeFuture.results();
+    if (_imageTime.contains(kImageOpenFailed)) {
+        emit error(tr("Geotagging failed. Couldn't open an image."));
         return;
     }
-    QByteArray log = file.readAll();
-    file.close();
 
-    // Instantiate appropriate parser
+    // Load log and instantiate appropriate parser, unless the triggers came from the vehicle
+    bool isULog = _logFile.endsWith(".ulg", Qt::CaseSensitive);
     _triggerList.clear();
     bool parseComplete = false;
     QString errorString;
-    if (isULog) {
-        ULogParser parser;
-        parseComplete = parser.getTagsFromLog(log, _triggerList, errorString);
+    if (!_presetTriggerList.isEmpty()) {
+        _triggerList = _presetTriggerList;
+        parseComplete = true;
+    } else if (isULog) {
+        // ULogs are mapped rather than read, only the camera_capture messages are ever looked at
+        ULogReader reader;
+        if (reader.open(_logFile, errorString, { QStringLiteral("camera_capture") })) {
+            ULogParser parser;
+            parseComplete = parser.getTagsFromLog(reader, _triggerList, errorString);
+        }
 
     } else {
+        QFile file(_logFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            emit error(tr("Geotagging failed. Couldn't open log file."));
+            return;
+        }
+        // Mapped rather than read, the parser skips most of the log by message length
+        const uchar* log = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+        if (!log) {
+            emit error(tr("Geotagging failed. Couldn't open log file."));
+            return;
+        }
+
         PX4LogParser parser;
-        parseComplete = parser.getTagsFromLog(log, _triggerList);
+        parseComplete = parser.getTagsFromLog(log, file.size(), _triggerList);
+        file.close();
 
     }
 
@@ -246,42 +284,25 @@ void GeoTagWorker::run()
     // Tag images
     int maxIndex = std::min(_imageIndices.count(), _triggerIndices.count());
     maxIndex = std::min(maxIndex, _imageList.count());
+    QList<int> tagIndices;
     for(int i = 0; i < maxIndex; i++) {
         int imageIndex = _imageIndices[i];
         if (imageIndex >= _imageList.count()) {
             emit error(tr("Geotagging failed. Requesting image #%1, but only %2 images present.").arg(imageIndex).arg(_imageList.count()));
             return;
         }
-        QFile fileRead(_imageList.at(_imageIndices[i]).absoluteFilePath());
-        if (!fileRead.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
-        }
-        QByteArray imageBuffer = fileRead.readAll();
-        fileRead.close();
-
-        if (!exifParser.write(imageBuffer, _triggerList[_triggerIndices[i]])) {
-            emit error(tr("Geotagging failed. Couldn't write to image."));
-            return;
-        } else {
-            QFile fileWrite;
-            if(_saveDirectory == "") {
-                fileWrite.setFileName(_imageDirectory + "/TAGGED/" + _imageList.at(_imageIndices[i]).fileName());
-            } else {
-                fileWrite.setFileName(_saveDirectory + "/" + _imageList.at(_imageIndices[i]).fileName());
-            }
-            if (!fileWrite.open(QFile::WriteOnly)) {
-                emit error(tr("Geotagging failed. Couldn't write to an image."));
-                return;
-            }
-            fileWrite.write(imageBuffer);
-            fileWrite.close();
-        }
-        emit progressChanged(4*(100/nSteps) + ((100/nSteps) / maxIndex)*i);
-
-        if (_cancel) {
-            qCDebug(GeotaggingLog) << "Tagging cancelled";
-            emit error(tr("Tagging cancelled"));
+        tagIndices.append(i);
+    }
+    std::function<QString(int)> tagImage = [this](int i) { return _tagImage(i); };
+    QFuture<QString> tagFuture = QtConcurrent::mapped(tagIndices, tagImage);
+    if (!_waitForFuture(tagFuture, 4*(100/nSteps), 100/nSteps)) {
+        qCDebug(GeotaggingLog) << "Tagging cancelled";
+        emit error(tr("Tagging cancelled"));
+        return;
+    }
+    for (const QString& tagError: tagFuture.results()) {
+        if (!tagError.isEmpty()) {
+            emit error(tagError);
             return;
         }
     }
@@ -295,6 +316,77 @@ void GeoTagWorker::run()
     emit progressChanged(100);
 }
 
+bool GeoTagWorker::_waitForFuture(QFuture<void> future, double progressStart, double progressRange)
+{
+    // Progress is polled since the worker thread has no event loop for a watcher
+    while (!future.isFinished()) {
+        if (_cancel) {
+            future.cancel();
+            future.waitForFinished();
+            return false;
+        }
+        if (future.progressMaximum() > 0) {
+            emit progressChanged(progressStart + (progressRange * future.progressValue()) / future.progressMaximum());
+        }
+        QThread::msleep(_progressIntervalMSecs);
+    }
+    return !_cancel;
+}
+
+double GeoTagWorker::_readImageTime(const QFileInfo& imageInfo)
+{
+    QFile file(imageInfo.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return kImageOpenFailed;
+    }
+    QByteArray imageHeader = file.read(ExifParser::maxHeaderSize);
+    ExifParser exifParser;
+    return exifParser.readTime(imageHeader);
+}
+
+QString GeoTagWorker::_tagImage(int i)
+{
+    const QFileInfo& imageInfo = _imageList.at(_imageIndices[i]);
+
+    QFile fileRead(imageInfo.absoluteFilePath());
+    if (!fileRead.open(QIODevice::ReadOnly)) {
+        return tr("Geotagging failed. Couldn't open an image.");
+    }
+
+    // Only the EXIF header is patched, the image data after it is copied straight from the mapped file
+    ExifParser  exifParser;
+    QByteArray  imageHeader     = fileRead.read(ExifParser::maxHeaderSize);
+    int         headerLength    = exifParser.headerLength(imageHeader);
+    if (headerLength == -1) {
+        return tr("Geotagging failed. Couldn't write to image.");
+    }
+    imageHeader.truncate(headerLength);
+    cameraFeedbackPacket geotag = _triggerList.at(_triggerIndices[i]);
+    if (!exifParser.write(imageHeader, geotag)) {
+        return tr("Geotagging failed. Couldn't write to image.");
+    }
+
+    qint64  dataSize    = fileRead.size() - headerLength;
+    uchar*  imageData   = dataSize > 0 ? fileRead.map(headerLength, dataSize) : nullptr;
+    if (dataSize > 0 && !imageData) {
+        return tr("Geotagging failed. Couldn't open an image.");
+    }
+
+    QFile fileWrite;
+    if(_saveDirectory == "") {
+        fileWrite.setFileName(_imageDirectory + "/TAGGED/" + imageInfo.fileName());
+    } else {
+        fileWrite.setFileName(_saveDirectory + "/" + imageInfo.fileName());
+    }
+    if (!fileWrite.open(QFile::WriteOnly) ||
+            fileWrite.write(imageHeader) != imageHeader.count() ||
+            (imageData && fileWrite.write(reinterpret_cast<const char*>(imageData), dataSize) != dataSize)) {
+        return tr("Geotagging failed. Couldn't write to an image.");
+    }
+    fileWrite.close();
+    return QString();
+}
+
 bool GeoTagWorker::triggerFiltering()
 {
     _imageIndices.clear();
@@ -17,10 +17,13 @@
 #include <QString>
 #include <QThread>
 #include <QFileInfoList>
+#include <QFuture>
 #include <QElapsedTimer>
 #include <QDebug>
 #include <QGeoCoordinate>
 
+class CameraTriggerPoints;
+
 class GeoTagWorker : public QThread
 {
     Q_OBJECT
@@ -50,6 +53,10 @@ public:
         uint8_t captureResult;
     };
 
+    /// Triggers to tag with instead of the ones in the log file, empty to use the log file
+    void setTriggerList             (const QList<cameraFeedbackPacket>& triggerList) { _presetTriggerList = triggerList; }
+    int  presetTriggerCount         () const { return _presetTriggerList.count(); }
+
 protected:
     void run() final;
 
@@ -61,6 +68,15 @@ signals:
 private:
     bool triggerFiltering();
 
+    /// Waits for the images being worked on in the global thread pool, reporting progress along the way
+    /// @return false: tagging was cancelled
+    bool    _waitForFuture  (QFuture<void> future, double progressStart, double progressRange);
+    QString _tagImage       (int i);    ///< @return Error message, empty on success
+
+    static double _readImageTime(const QFileInfo& imageInfo);
+
+    static const int _progressIntervalMSecs = 100;
+
     bool                    _cancel;
     QString                 _logFile;
     QString                 _imageDirectory;
@@ -68,6 +84,7 @@ private:
     QFileInfoList           _imageList;
     QList<double>           _imageTime;
     QList<cameraFeedbackPacket> _triggerList;
+    QList<cameraFeedbackPacket> _presetTriggerList;
     QList<int>              _imageIndices;
     QList<int>              _triggerIndices;
 
@@ -85,6 +102,9 @@ public:
     Q_PROPERTY(QString  imageDirectory  READ imageDirectory WRITE setImageDirectory NOTIFY imageDirectoryChanged)
     Q_PROPERTY(QString  saveDirectory   READ saveDirectory  WRITE setSaveDirectory  NOTIFY saveDirectoryChanged)
 
+    /// Number of camera triggers taken from a vehicle instead of a log file, see useVehicleTriggers
+    Q_PROPERTY(int      vehicleTriggerCount READ vehicleTriggerCount NOTIFY vehicleTriggerCountChanged)
+
     /// Set to an error message is geotagging fails
     Q_PROPERTY(QString  errorMessage    READ errorMessage   NOTIFY errorMessageChanged)
 
@@ -97,12 +117,16 @@ public:
     Q_INVOKABLE void startTagging();
     Q_INVOKABLE void cancelTagging() { _worker.cancelTagging(); }
 
+    /// Tags with the camera triggers the vehicle reported during the flight, rather than the ones in a log file
+    Q_INVOKABLE void useVehicleTriggers(CameraTriggerPoints* cameraTriggerPoints);
+
     QString logFile             () const { return _worker.logFile(); }
     QString imageDirectory      () const { return _worker.imageDirectory(); }
     QString saveDirectory       () const { return _worker.saveDirectory(); }
     double  progress            () const { return _progress; }
     bool    inProgress          () const { return _worker.isRunning(); }
     QString errorMessage        () const { return _errorMessage; }
+    int     vehicleTriggerCount () const { return _worker.presetTriggerCount(); }
 
     void    setLogFile          (QString file);
     void    setImageDirectory   (QString dir);
@@ -115,6 +139,7 @@ signals:
     void progressChanged        (double progress);
     void inProgressChanged      ();
     void errorMessageChanged    (QString errorMessage);
+    void vehicleTriggerCountChanged();
 
 private slots:
     void _workerProgressChanged (double progress);
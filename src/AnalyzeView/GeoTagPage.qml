@@ -85,12 +85,31 @@ AnalyzePage {
                 }
             }
             QGCLabel {
-                text:               geoController.logFile
+                text:               geoController.vehicleTriggerCount > 0 ? qsTr("%1 camera triggers from the vehicle").arg(geoController.vehicleTriggerCount) : geoController.logFile
                 elide:              Text.ElideLeft
                 Layout.fillWidth:   true
                 Layout.alignment:   Qt.AlignVCenter
             }
             //-----------------------------------------------------------------
+            //-- Camera triggers of the active vehicle
+            QGCButton {
+                text:               qsTr("Use vehicle camera triggers")
+                enabled:            _activeVehicle && _activeVehicle.cameraTriggerPoints.count > 0 && !geoController.inProgress
+                onClicked:          geoController.useVehicleTriggers(_activeVehicle.cameraTriggerPoints)
+                Layout.minimumWidth:_minWidth
+                Layout.maximumWidth:_maxWidth
+                Layout.fillWidth:   true
+                Layout.alignment:   Qt.AlignVCenter
+
+                property var _activeVehicle: QGroundControl.multiVehicleManager.activeVehicle
+            }
+            QGCLabel {
+                text:               qsTr("Images are tagged with the triggers reported during the flight, no log file is needed")
+                wrapMode:           Text.WordWrap
+                Layout.fillWidth:   true
+                Layout.alignment:   Qt.AlignVCenter
+            }
+            //-----------------------------------------------------------------
             //-- Image Directory
             QGCButton {
                 text:               qsTr("Select image directory")
@@ -149,7 +168,7 @@ AnalyzePage {
             QGCButton {
                 text:               geoController.inProgress ? qsTr("Cancel Tagging") : qsTr("Start Tagging")
                 width:              ScreenTools.defaultFontPixelWidth * 30
-                enabled:            (geoController.imageDirectory !== "" && geoController.logFile !== "") || geoController.inProgress
+                enabled:            (geoController.imageDirectory !== "" && (geoController.logFile !== "" || geoController.vehicleTriggerCount > 0)) || geoController.inProgress
                 Layout.alignment:   Qt.AlignHCenter
                 Layout.columnSpan:  2
                 onClicked: {
@@ -18,25 +18,32 @@
 #include "ParameterManager.h"
 #include "Vehicle.h"
 #include "SettingsManager.h"
+#include "FTPManager.h"
 
 #include <QDebug>
 #include <QSettings>
 #include <QUrl>
 #include <QBitArray>
+#include <QFileInfo>
 #include <QtCore/qmath.h>
 
+#include <algorithm>
+
 #define kTimeOutMilliseconds 500
 #define kGUIRateMilliseconds 17
 #define kTableBins           512
 #define kChunkSize           (kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)
+#define kWindowChunks        8
 
 QGC_LOGGING_CATEGORY(LogDownloadLog, "LogDownloadLog")
 
 //-----------------------------------------------------------------------------
 struct LogDownloadData {
     LogDownloadData(QGCLogEntry* entry);
-    QBitArray     chunk_table;
-    uint32_t      current_chunk;
+    QList<QBitArray>  chunk_tables;     // Received bins of each chunk in the window, the first one is current_chunk
+    QList<QByteArray> chunk_buffers;    // Data of each chunk in the window, written to the file once it is complete
+    uint32_t      current_chunk;        // Start of the window, every chunk before it has been written
+    uint32_t      request_end;          // End offset of the outstanding data request
     QFile         file;
     QString       filename;
     uint          ID;
@@ -46,36 +53,89 @@ struct LogDownloadData {
     qreal         rate_avg;
     QElapsedTimer elapsed;
 
-    void advanceChunk()
+    // Adds chunks to the end of the window up to kWindowChunks
+    void fillWindow()
     {
-           current_chunk++;
-           chunk_table = QBitArray(chunkBins(), false);
+        while (chunk_tables.count() < kWindowChunks && current_chunk + chunk_tables.count() < numChunks()) {
+            const uint32_t chunk = current_chunk + chunk_tables.count();
+            chunk_tables.append(QBitArray(chunkBins(chunk), false));
+            chunk_buffers.append(QByteArray(static_cast<int>(qMin(entry->size() - chunk*kChunkSize, static_cast<uint>(kChunkSize))), 0));
+        }
     }
 
-    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the current chunk
-    uint32_t chunkBins() const
+    // Writes out the chunk at the start of the window in one go and slides the window past it
+    bool writeChunk()
     {
-        return qMin(qCeil((entry->size() - current_chunk*kChunkSize)/static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)),
+        const qint64 pos = static_cast<qint64>(current_chunk) * kChunkSize;
+        if ((file.pos() != pos && !file.seek(pos)) || file.write(chunk_buffers.first()) != chunk_buffers.first().size()) {
+            return false;
+        }
+        chunk_tables.removeFirst();
+        chunk_buffers.removeFirst();
+        current_chunk++;
+        fillWindow();
+        return true;
+    }
+
+    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the chunk
+    uint32_t chunkBins(uint32_t chunk) const
+    {
+        return qMin(qCeil((entry->size() - chunk*kChunkSize)/static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)),
                     kTableBins);
     }
 
+    // Offset past the last byte of the window
+    uint32_t windowEnd() const
+    {
+        return qMin(static_cast<uint32_t>(entry->size()), (current_chunk + chunk_tables.count())*kChunkSize);
+    }
+
+    // True if the bin at the offset has been received, everything before the window has been
+    bool received(uint32_t ofs) const
+    {
+        if (ofs < current_chunk*kChunkSize) {
+            return true;
+        }
+        const uint32_t slot = ofs / kChunkSize - current_chunk;
+        const uint32_t bin  = (ofs % kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+        return slot < static_cast<uint32_t>(chunk_tables.count()) && bin < static_cast<uint32_t>(chunk_tables[slot].size()) && chunk_tables[slot].testBit(bin);
+    }
+
+    // Finds the first run of missing bins in the window at or after the offset
+    bool findGap(uint32_t ofs, uint32_t& start, uint32_t& end) const
+    {
+        const uint32_t last = windowEnd();
+        uint32_t pos = qMax(ofs, current_chunk*kChunkSize);
+        pos -= pos % MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+        for (; pos < last && received(pos); pos += MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) { }
+        if (pos >= last) {
+            return false;
+        }
+        start = pos;
+        for (; pos < last && !received(pos); pos += MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) { }
+        end = qMin(pos, last);
+        return true;
+    }
+
     // The number of kChunkSize chunks in the file
     uint32_t numChunks() const
     {
         return qCeil(entry->size() / static_cast<qreal>(kChunkSize));
     }
 
-    // True if all bins in the chunk have been set to val
-    bool chunkEquals(const bool val) const
+    // True if all bins in the chunk at the window slot have been received
+    bool chunkComplete(int slot) const
     {
-        return chunk_table == QBitArray(chunk_table.size(), val);
+        return chunk_tables[slot].count(true) == chunk_tables[slot].size();
     }
 
 };
 
 //----------------------------------------------------------------------------------------
 LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
-    : ID(entry_->id())
+    : current_chunk(0)
+    , request_end(0)
+    , ID(entry_->id())
     , entry(entry_)
     , written(0)
     , rate_bytes(0)
@@ -111,6 +171,8 @@ LogDownloadController::LogDownloadController(void)
     , _downloadingLogs(false)
     , _retries(0)
     , _apmOneBased(0)
+    , _useFtp(false)
+    , _ftpListed(false)
 {
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &LogDownloadController::_setActiveVehicle);
@@ -139,11 +201,36 @@ LogDownloadController::_setActiveVehicle(Vehicle* vehicle)
         disconnect(_uas, &UASInterface::logData,  this, &LogDownloadController::_logData);
         _uas = nullptr;
     }
+    if(_vehicle) {
+        _disconnectFtp();
+        disconnect(_vehicle, &Vehicle::capabilityBitsChanged, this, &LogDownloadController::ftpAvailableChanged);
+    }
+    _ftpListed = false;
+    _ftpLogs.clear();
     _vehicle = vehicle;
     if(_vehicle) {
         _uas = vehicle->uas();
         connect(_uas, &UASInterface::logEntry, this, &LogDownloadController::_logEntry);
         connect(_uas, &UASInterface::logData,  this, &LogDownloadController::_logData);
+        connect(_vehicle, &Vehicle::capabilityBitsChanged, this, &LogDownloadController::ftpAvailableChanged);
+    }
+    emit ftpAvailableChanged();
+}
+
+//----------------------------------------------------------------------------------------
+bool
+LogDownloadController::ftpAvailable() const
+{
+    return _vehicle && (_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_FTP) && (_vehicle->px4Firmware() || _vehicle->apmFirmware());
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::setUseFtp(bool useFtp)
+{
+    if (_useFtp != useFtp) {
+        _useFtp = useFtp;
+        emit useFtpChanged();
     }
 }
 
@@ -333,30 +420,41 @@ LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, ui
     bool result = false;
     uint32_t timeout_time = kTimeOutMilliseconds;
     if(ofs <= _downloadData->entry->size()) {
+        //-- Packets for any chunk in the window are kept, they come out of order while gaps are being filled
         const uint32_t chunk = ofs / kChunkSize;
-        if (chunk != _downloadData->current_chunk) {
-            qWarning() << "Ignored packet for out of order chunk actual:expected" << chunk << _downloadData->current_chunk;
+        const uint32_t slot  = chunk - _downloadData->current_chunk;
+        if (chunk < _downloadData->current_chunk || slot >= static_cast<uint32_t>(_downloadData->chunk_tables.count())) {
+            qCDebug(LogDownloadLog) << "Ignored packet outside of the download window chunk:window" << chunk << _downloadData->current_chunk;
             return;
         }
-        const uint16_t bin = (ofs - chunk*kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-        if (bin >= _downloadData->chunk_table.size()) {
+        QBitArray&      table   = _downloadData->chunk_tables[static_cast<int>(slot)];
+        const uint16_t  bin     = (ofs - chunk*kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+        if (bin >= table.size()) {
             qWarning() << "Out of range bin received";
-        } else
-            _downloadData->chunk_table.setBit(bin);
-        if (_downloadData->file.pos() != ofs) {
-            // Seek to correct position
-            if (!_downloadData->file.seek(ofs)) {
-                qWarning() << "Error while seeking log file offset";
-                return;
+        } else if (!table.testBit(bin)) {
+            //-- Buffered until the whole chunk is in
+            QByteArray& buffer          = _downloadData->chunk_buffers[static_cast<int>(slot)];
+            const int   bufferOffset    = bin * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+            const int   length          = qMin(static_cast<int>(count), buffer.size() - bufferOffset);
+            table.setBit(bin);
+            memcpy(buffer.data() + bufferOffset, data, static_cast<size_t>(qMax(0, length)));
+            _downloadData->written += length;
+            _downloadData->rate_bytes += length;
+        }
+
+        result = true;
+        bool windowMoved = false;
+        while (!_downloadData->chunk_tables.isEmpty() && _downloadData->chunkComplete(0)) {
+            if (!_downloadData->writeChunk()) {
+                qWarning() << "Error while writing log file chunk";
+                result = false;
+                break;
             }
+            windowMoved = true;
         }
 
-        //-- Write chunk to file
-        if(_downloadData->file.write((const char*)data, count)) {
-            _downloadData->written += count;
-            _downloadData->rate_bytes += count;
+        if (result) {
             _updateDataRate();
-            result = true;
             //-- reset retries
             _retries = 0;
             //-- Reset timer
@@ -366,17 +464,13 @@ LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, ui
                 _downloadData->entry->setStatus(tr("Downloaded"));
                 //-- Check for more
                 _receivedAllData();
-            } else if (_chunkComplete()) {
-                _downloadData->advanceChunk();
-                _requestLogData(_downloadData->ID,
-                                _downloadData->current_chunk*kChunkSize,
-                                _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            } else if (bin < _downloadData->chunk_table.size() - 1 && _downloadData->chunk_table.at(bin+1)) {
+            } else if (_downloadData->received(ofs + count)) {
                 // Likely to be grabbing fragments and got to the end of a gap
-                _findMissingData();
+                _requestMissingData(_downloadData->current_chunk*kChunkSize);
+            } else if (windowMoved || ofs + count >= _downloadData->request_end) {
+                // Keep the vehicle streaming into the window ahead of this packet
+                _requestMissingData(ofs + count);
             }
-        } else {
-            qWarning() << "Error while writing log file chunk";
         }
     } else {
         qWarning() << "Received log offset greater than expected";
@@ -387,18 +481,11 @@ LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, ui
 }
 
 
-//----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_chunkComplete() const
-{
-    return _downloadData->chunkEquals(true);
-}
-
 //----------------------------------------------------------------------------------------
 bool
 LogDownloadController::_logComplete() const
 {
-    return _chunkComplete() && (_downloadData->current_chunk+1) == _downloadData->numChunks();
+    return _downloadData->current_chunk >= _downloadData->numChunks();
 }
 
 //----------------------------------------------------------------------------------------
@@ -408,15 +495,199 @@ LogDownloadController::_receivedAllData()
     _timer.stop();
     //-- Anything queued up for download?
     if(_prepareLogDownload()) {
-        //-- Request Log
-        _requestLogData(_downloadData->ID, 0, _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-        _timer.start(kTimeOutMilliseconds);
+        if (_useFtp && ftpAvailable()) {
+            _downloadLogFtp();
+        } else {
+            _downloadLogMavlink();
+        }
     } else {
         _resetSelection();
         _setDownloading(false);
     }
 }
 
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_downloadLogMavlink()
+{
+    //-- Request Log
+    _requestMissingData(0);
+    _timer.start(kTimeOutMilliseconds);
+}
+
+//----------------------------------------------------------------------------------------
+QString
+LogDownloadController::_ftpLogRoot() const
+{
+    return _vehicle->px4Firmware() ? QStringLiteral("/fs/microsd/log") : QStringLiteral("/APM/LOGS");
+}
+
+//----------------------------------------------------------------------------------------
+/// Downloads the current log through MAVLink FTP burst reads. The log entries don't carry a path, so the log id is
+/// matched up with the log files on the vehicle by their order. A log with no matching file, or one of a different size,
+/// falls back to LOG_REQUEST_DATA.
+void
+LogDownloadController::_downloadLogFtp()
+{
+    if (!_ftpListed) {
+        _listFtpLogs();
+        return;
+    }
+
+    const uint id = _downloadData->ID;
+    if (id >= static_cast<uint>(_ftpLogs.count()) || _ftpLogs[id].size != _downloadData->entry->size()) {
+        qCDebug(LogDownloadLog) << "No FTP file matches log" << id << "falling back to LOG_REQUEST_DATA";
+        _downloadLogMavlink();
+        return;
+    }
+
+    const FtpLog_t& ftpLog      = _ftpLogs[id];
+    FTPManager*     ftpManager  = _vehicle->ftpManager();
+    const QString   uri         = ftpLog.directory + QStringLiteral("/") + ftpLog.name;
+    connect(ftpManager, &FTPManager::downloadComplete, this, &LogDownloadController::_ftpDownloadComplete);
+    connect(ftpManager, &FTPManager::commandProgress,  this, &LogDownloadController::_ftpDownloadProgress);
+    // Resume picks up where an interrupted download of the same file left off
+    if (!ftpManager->download(uri, _downloadPath, true /* resume */)) {
+        qCDebug(LogDownloadLog) << "FTP download failed to start, falling back to LOG_REQUEST_DATA";
+        _disconnectFtp();
+        _downloadLogMavlink();
+        return;
+    }
+    qCDebug(LogDownloadLog) << "FTP download of log" << id << uri;
+    _ftpDownloadURI = uri;
+
+    //-- The FTP manager writes its own file, which is renamed once it is complete
+    _downloadData->file.close();
+    _downloadData->file.remove();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_listFtpLogs()
+{
+    _ftpLogs.clear();
+    _ftpDirectories = QStringList(_ftpLogRoot());
+    connect(_vehicle->ftpManager(), &FTPManager::listDirectoryComplete, this, &LogDownloadController::_ftpListDirectoryComplete);
+    _listNextFtpDirectory();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_listNextFtpDirectory()
+{
+    _ftpDirectory = _ftpDirectories.takeFirst();
+    if (!_vehicle->ftpManager()->listDirectory(_ftpDirectory)) {
+        _ftpListDirectoryComplete(QStringList(), tr("FTP busy"));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpListDirectoryComplete(const QStringList& dirList, const QString& errorMsg)
+{
+    if (!errorMsg.isEmpty()) {
+        qCDebug(LogDownloadLog) << "FTP listing of" << _ftpDirectory << "failed:" << errorMsg;
+        _ftpLogs.clear();
+        _ftpDirectories.clear();
+    } else {
+        //-- PX4 keeps its logs in one directory per day or session, ArduPilot keeps them all in the root
+        const bool root = _ftpDirectory == _ftpLogRoot();
+        for (const QString& entry: dirList) {
+            if (entry.startsWith('D') && root) {
+                const QString name = entry.mid(1);
+                if (name != QStringLiteral(".") && name != QStringLiteral("..")) {
+                    _ftpDirectories.append(_ftpDirectory + QStringLiteral("/") + name);
+                }
+            } else if (entry.startsWith('F')) {
+                const QStringList nameSize = entry.mid(1).split('\t');
+                const QString     suffix   = QFileInfo(nameSize[0]).suffix();
+                if (suffix.compare(QStringLiteral("ulg"), Qt::CaseInsensitive) == 0 || suffix.compare(QStringLiteral("bin"), Qt::CaseInsensitive) == 0) {
+                    _ftpLogs.append({ _ftpDirectory, nameSize[0], nameSize.value(1).toUInt() });
+                }
+            }
+        }
+        if (!_ftpDirectories.isEmpty()) {
+            _listNextFtpDirectory();
+            return;
+        }
+    }
+
+    disconnect(_vehicle->ftpManager(), &FTPManager::listDirectoryComplete, this, &LogDownloadController::_ftpListDirectoryComplete);
+
+    //-- Log ids go up with the directory and then the file name, ArduPilot names are numbers
+    std::sort(_ftpLogs.begin(), _ftpLogs.end(), [](const FtpLog_t& a, const FtpLog_t& b) {
+        if (a.directory != b.directory) {
+            return a.directory < b.directory;
+        }
+        bool aNumeric, bNumeric;
+        const uint aNumber = QFileInfo(a.name).completeBaseName().toUInt(&aNumeric);
+        const uint bNumber = QFileInfo(b.name).completeBaseName().toUInt(&bNumeric);
+        return aNumeric && bNumeric ? aNumber < bNumber : a.name < b.name;
+    });
+    qCDebug(LogDownloadLog) << "FTP listing found" << _ftpLogs.count() << "logs";
+    _ftpListed = true;
+
+    if (_downloadData) {
+        _downloadLogFtp();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpDownloadComplete(const QString& file, const QString& errorMsg)
+{
+    //-- Other transfers share the FTP manager
+    if (QFileInfo(file).fileName() != _ftpDownloadURI.section('/', -1)) {
+        return;
+    }
+    _ftpDownloadURI.clear();
+    _disconnectFtp();
+    if (!_downloadData) {
+        return;
+    }
+    if (errorMsg.isEmpty()) {
+        if (!QFile::rename(file, _downloadData->file.fileName())) {
+            qWarning() << "Failed to rename downloaded log" << file << "to" << _downloadData->file.fileName();
+        }
+        _downloadData->entry->setStatus(tr("Downloaded"));
+    } else {
+        //-- What was received is kept so this log resumes next time
+        qWarning() << "FTP log download failed:" << errorMsg;
+        _downloadData->entry->setStatus(tr("Error"));
+    }
+    //-- Next log
+    _receivedAllData();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_ftpDownloadProgress(int value)
+{
+    if (!_downloadData) {
+        return;
+    }
+    const uint written = static_cast<uint>(static_cast<quint64>(_downloadData->entry->size()) * static_cast<uint>(value) / 100);
+    if (written > _downloadData->written) {
+        _downloadData->rate_bytes += written - _downloadData->written;
+        _downloadData->written = written;
+    }
+    _updateDataRate();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_disconnectFtp()
+{
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    disconnect(ftpManager, &FTPManager::listDirectoryComplete,  this, &LogDownloadController::_ftpListDirectoryComplete);
+    disconnect(ftpManager, &FTPManager::downloadComplete,       this, &LogDownloadController::_ftpDownloadComplete);
+    disconnect(ftpManager, &FTPManager::commandProgress,        this, &LogDownloadController::_ftpDownloadProgress);
+    if (!_ftpDownloadURI.isEmpty()) {
+        ftpManager->cancelDownload(_ftpDownloadURI);
+        _ftpDownloadURI.clear();
+    }
+}
+
 //----------------------------------------------------------------------------------------
 void
 LogDownloadController::_findMissingData()
@@ -424,8 +695,6 @@ LogDownloadController::_findMissingData()
     if (_logComplete()) {
          _receivedAllData();
          return;
-    } else if (_chunkComplete()) {
-        _downloadData->advanceChunk();
     }
 
     _retries++;
@@ -443,23 +712,21 @@ LogDownloadController::_findMissingData()
 
     _updateDataRate();
 
-    uint16_t start = 0, end = 0;
-    const int size = _downloadData->chunk_table.size();
-    for (; start < size; start++) {
-        if (!_downloadData->chunk_table.testBit(start)) {
-            break;
-        }
-    }
+    _requestMissingData(_downloadData->current_chunk*kChunkSize);
+}
 
-    for (end = start; end < size; end++) {
-        if (_downloadData->chunk_table.testBit(end)) {
-            break;
-        }
+//----------------------------------------------------------------------------------------
+/// Requests the first gap in the window at or after the offset, or the first gap in the window if there is none after
+/// it. A new request replaces the one outstanding on the vehicle, so there is only ever one.
+void
+LogDownloadController::_requestMissingData(uint32_t offset)
+{
+    uint32_t start = 0, end = 0;
+    if (!_downloadData->findGap(offset, start, end) && !_downloadData->findGap(0, start, end)) {
+        return;
     }
-
-    const uint32_t pos = _downloadData->current_chunk*kChunkSize + start*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
-                   len = (end - start)*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-    _requestLogData(_downloadData->ID, pos, len, _retries);
+    _downloadData->request_end = end;
+    _requestLogData(_downloadData->ID, start, end - start, _retries);
 }
 
 //----------------------------------------------------------------------------------------
@@ -492,6 +759,7 @@ void
 LogDownloadController::refresh(void)
 {
     _logEntriesModel.clear();
+    _ftpListed = false;
     //-- Get first 50 entries
     _requestLogList(0, 49);
 }
@@ -634,7 +902,7 @@ LogDownloadController::_prepareLogDownload()
             qWarning() << "Failed to allocate space for log file:" <<  _downloadData->filename;
         } else {
             _downloadData->current_chunk = 0;
-            _downloadData->chunk_table = QBitArray(_downloadData->chunkBins(), false);
+            _downloadData->fillWindow();
             _downloadData->elapsed.start();
             result = true;
         }
@@ -701,6 +969,9 @@ LogDownloadController::cancel(void)
     if(_uas){
         _receivedAllEntries();
     }
+    if(_vehicle) {
+        _disconnectFtp();
+    }
     if(_downloadData) {
         _downloadData->entry->setStatus(tr("Canceled"));
         if (_downloadData->file.exists()) {
@@ -119,10 +119,16 @@ public:
     Q_PROPERTY(QGCLogModel* model           READ model              NOTIFY modelChanged)
     Q_PROPERTY(bool         requestingList  READ requestingList     NOTIFY requestingListChanged)
     Q_PROPERTY(bool         downloadingLogs READ downloadingLogs    NOTIFY downloadingLogsChanged)
+    Q_PROPERTY(bool         ftpAvailable    READ ftpAvailable       NOTIFY ftpAvailableChanged)
+    Q_PROPERTY(bool         useFtp          READ useFtp             WRITE setUseFtp     NOTIFY useFtpChanged)
 
     QGCLogModel*    model                   () { return &_logEntriesModel; }
     bool            requestingList          () { return _requestingLogEntries; }
     bool            downloadingLogs         () { return _downloadingLogs; }
+    bool            ftpAvailable            () const;
+    bool            useFtp                  () const { return _useFtp; }
+
+    void            setUseFtp               (bool useFtp);
 
     Q_INVOKABLE void refresh                ();
     Q_INVOKABLE void download               (QString path = QString());
@@ -136,16 +142,20 @@ signals:
     void downloadingLogsChanged ();
     void modelChanged           ();
     void selectionChanged       ();
+    void ftpAvailableChanged    ();
+    void useFtpChanged          ();
 
 private slots:
     void _setActiveVehicle  (Vehicle* vehicle);
     void _logEntry          (UASInterface *uas, uint32_t time_utc, uint32_t size, uint16_t id, uint16_t num_logs, uint16_t last_log_num);
     void _logData           (UASInterface *uas, uint32_t ofs, uint16_t id, uint8_t count, const uint8_t *data);
     void _processDownload   ();
+    void _ftpListDirectoryComplete  (const QStringList& dirList, const QString& errorMsg);
+    void _ftpDownloadComplete       (const QString& file, const QString& errorMsg);
+    void _ftpDownloadProgress       (int value);
 
 private:
     bool _entriesComplete   ();
-    bool _chunkComplete     () const;
     bool _logComplete       () const;
     void _findMissingEntries();
     void _receivedAllEntries();
@@ -154,10 +164,17 @@ private:
     void _findMissingData   ();
     void _requestLogList    (uint32_t start, uint32_t end);
     void _requestLogData    (uint16_t id, uint32_t offset, uint32_t count, int retryCount = 0);
+    void _requestMissingData(uint32_t offset);
     bool _prepareLogDownload();
     void _setDownloading    (bool active);
     void _setListing        (bool active);
     void _updateDataRate    ();
+    void _downloadLogMavlink();
+    void _downloadLogFtp    ();
+    void _listFtpLogs       ();
+    void _listNextFtpDirectory();
+    void _disconnectFtp     ();
+    QString _ftpLogRoot     () const;
 
     QGCLogEntry* _getNextSelected();
 
@@ -171,6 +188,19 @@ private:
     int                 _retries;
     int                 _apmOneBased;
     QString             _downloadPath;
+
+    typedef struct {
+        QString     directory;
+        QString     name;
+        uint        size;
+    } FtpLog_t;
+
+    bool                _useFtp;
+    QString             _ftpDownloadURI;    ///< File on the vehicle the FTP manager is downloading for the current log, empty if none
+    bool                _ftpListed;         ///< _ftpLogs is up to date with the log entries
+    QList<FtpLog_t>     _ftpLogs;           ///< Logs on the vehicle file system, in log id order
+    QStringList         _ftpDirectories;    ///< Directories still to be listed
+    QString             _ftpDirectory;      ///< Directory being listed
 };
 
 #endif
@@ -192,6 +192,13 @@ AnalyzePage {
                     enabled:    logController.requestingList || logController.downloadingLogs
                     onClicked:  logController.cancel()
                 }
+                QGCCheckBox {
+                    text:       qsTr("Use MAVLink FTP")
+                    visible:    logController.ftpAvailable
+                    enabled:    !logController.downloadingLogs
+                    checked:    logController.useFtp
+                    onClicked:  logController.useFtp = checked
+                }
             }
         }
     }
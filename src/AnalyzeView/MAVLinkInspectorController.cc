@@ -10,8 +10,11 @@
 #include "MAVLinkInspectorController.h"
 #include "QGCApplication.h"
 #include "MultiVehicleManager.h"
+#include "MessageIntervalManager.h"
 #include <QtCharts/QLineSeries>
 
+#include <cstddef>
+
 QGC_LOGGING_CATEGORY(MAVLinkInspectorLog, "MAVLinkInspectorLog")
 
 QT_CHARTS_USE_NAMESPACE
@@ -19,6 +22,7 @@ QT_CHARTS_USE_NAMESPACE
 Q_DECLARE_METATYPE(QAbstractSeries*)
 
 #define UPDATE_FREQUENCY (1000 / 15)    // 15Hz
+#define MAX_SAMPLES      (50 * 60)      // Arbitrary limit of 1 minute of data at 50Hz for now
 
 //-----------------------------------------------------------------------------
 QGCMAVLinkMessageField::QGCMAVLinkMessageField(QGCMAVLinkMessage *parent, QString name, QString type)
@@ -38,7 +42,9 @@ QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries
         _chart = chart;
         _pSeries = series;
         emit seriesChanged();
+        _values.resize(MAX_SAMPLES);
         _dataIndex = 0;
+        _sampleCount = 0;
         _msg->updateFieldSelection();
     }
 }
@@ -49,8 +55,10 @@ QGCMAVLinkMessageField::delSeries()
 {
     if(_pSeries) {
         _values.clear();
+        _values.squeeze();
+        _sampleCount = 0;
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(_values);
+        lineSeries->replace(QVector<QPointF>());
         _pSeries = nullptr;
         _chart   = nullptr;
         emit seriesChanged();
@@ -87,65 +95,82 @@ QGCMAVLinkMessageField::chartIndex()
 
 //-----------------------------------------------------------------------------
 void
-QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
+QGCMAVLinkMessageField::updateValue(const QString& newValue)
 {
     if(_value != newValue) {
         _value = newValue;
         emit valueChanged();
     }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::addSample(qreal v)
+{
     if(_pSeries && _chart) {
-        int count = _values.count();
-        //-- Arbitrary limit of 1 minute of data at 50Hz for now
-        if(count < (50 * 60)) {
-            QPointF p(QGC::bootTimeMilliseconds(), v);
-            _values.append(p);
-        } else {
-            if(_dataIndex >= count) _dataIndex = 0;
-            _values[_dataIndex].setX(QGC::bootTimeMilliseconds());
-            _values[_dataIndex].setY(v);
-            _dataIndex++;
-        }
-        //-- Auto Range
-        if(_chart->rangeYIndex() == 0) {
-            qreal vmin  = std::numeric_limits<qreal>::max();
-            qreal vmax  = std::numeric_limits<qreal>::min();
-            for(int i = 0; i < _values.count(); i++) {
-                qreal v = _values[i].y();
-                if(vmax < v) vmax = v;
-                if(vmin > v) vmin = v;
-            }
-            bool changed = false;
-            if(std::abs(_rangeMin - vmin) > 0.000001) {
-                _rangeMin = vmin;
-                changed = true;
-            }
-            if(std::abs(_rangeMax - vmax) > 0.000001) {
-                _rangeMax = vmax;
-                changed = true;
-            }
-            if(changed) {
-                _chart->updateYRange();
-            }
-        }
+        //-- Fixed size ring, the oldest sample is overwritten once it is full
+        _values[_dataIndex] = QPointF(QGC::bootTimeMilliseconds(), v);
+        if(++_dataIndex >= _values.count()) _dataIndex = 0;
+        if(_sampleCount < _values.count()) _sampleCount++;
     }
 }
 
 //-----------------------------------------------------------------------------
+/// Replaces the series with the samples in the x range, reduced to the first, minimum, maximum and last sample of
+/// each bucket so there are never more points than about four per pixel
 void
-QGCMAVLinkMessageField::updateSeries()
+QGCMAVLinkMessageField::updateSeries(qreal xMin, qreal xMax, int buckets)
 {
-    int count = _values.count();
-    if (count > 1) {
-        QList<QPointF> s;
-        s.reserve(count);
-        int idx = _dataIndex;
-        for(int i = 0; i < count; i++, idx++) {
-            if(idx >= count) idx = 0;
-            QPointF p(_values[idx]);
-            s.append(p);
+    if(!_pSeries || _sampleCount < 2) {
+        return;
+    }
+    const int   capacity    = _values.count();
+    const int   oldest      = _sampleCount < capacity ? 0 : _dataIndex;
+    const qreal bucketWidth = (xMax - xMin) / qMax(1, buckets);
+    QVector<QPointF> s;
+    s.reserve(qMin(_sampleCount, (buckets + 1) * 4));
+    int     bucket      = -1;
+    int     first       = -1;
+    int     last        = -1;
+    int     minIdx      = -1;
+    int     maxIdx      = -1;
+    qreal   vmin        = std::numeric_limits<qreal>::max();
+    qreal   vmax        = std::numeric_limits<qreal>::lowest();
+    auto flush = [&]() {
+        if(first < 0) return;
+        //-- Keep the time order of the bucket points
+        int idx[4] = { first, minIdx, maxIdx, last };
+        std::sort(idx, idx + 4, [&](int a, int b) { return _values[a].x() < _values[b].x(); });
+        for(int i = 0; i < 4; i++) {
+            if(i == 0 || idx[i] != idx[i - 1]) s.append(_values[idx[i]]);
         }
-        QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(s);
+    };
+    for(int i = 0, idx = oldest; i < _sampleCount; i++, idx++) {
+        if(idx >= capacity) idx = 0;
+        const QPointF& p = _values[idx];
+        if(p.x() < xMin) {
+            continue;
+        }
+        if(p.y() < vmin) vmin = p.y();
+        if(p.y() > vmax) vmax = p.y();
+        int b = bucketWidth > 0 ? static_cast<int>((p.x() - xMin) / bucketWidth) : 0;
+        if(b != bucket) {
+            flush();
+            bucket = b;
+            first = last = minIdx = maxIdx = idx;
+        } else {
+            last = idx;
+            if(p.y() < _values[minIdx].y()) minIdx = idx;
+            if(p.y() > _values[maxIdx].y()) maxIdx = idx;
+        }
+    }
+    flush();
+    QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
+    lineSeries->replace(s);
+    //-- Range of what is showing, used for the auto range
+    if(!s.isEmpty()) {
+        _rangeMin = vmin;
+        _rangeMax = vmax;
     }
 }
 
@@ -153,8 +178,10 @@ QGCMAVLinkMessageField::updateSeries()
 QGCMAVLinkMessage::QGCMAVLinkMessage(QObject *parent, mavlink_message_t* message)
     : QObject(parent)
 {
-    _message = *message;
+    memset(&_message, 0, sizeof(_message));
+    _copyMessage(message);
     const mavlink_message_info_t* msgInfo = mavlink_get_message_info(message);
+    _msgInfo = msgInfo;
     if (!msgInfo) {
         qCWarning(MAVLinkInspectorLog) << QStringLiteral("QGCMAVLinkMessage NULL msgInfo msgid(%1)").arg(message->msgid);
         return;
@@ -191,16 +218,14 @@ QGCMAVLinkMessage::~QGCMAVLinkMessage()
 void
 QGCMAVLinkMessage::updateFieldSelection()
 {
-    bool sel = false;
+    _chartedFields.clear();
     for (int i = 0; i < _fields.count(); ++i) {
         QGCMAVLinkMessageField* f = qobject_cast<QGCMAVLinkMessageField*>(_fields.get(i));
-        if(f) {
-            if(f->selected()) {
-                sel = true;
-                break;
-            }
+        if(f && f->selected()) {
+            _chartedFields.append(i);
         }
     }
+    bool sel = !_chartedFields.isEmpty();
     if(sel != _fieldSelected) {
         _fieldSelected = sel;
         emit fieldSelectedChanged();
@@ -231,18 +256,91 @@ void
 QGCMAVLinkMessage::update(mavlink_message_t* message)
 {
     _count++;
-    _message = *message;
+    _copyMessage(message);
 
     if (_selected) {
-        // Don't update field info unless selected to reduce perf hit of message processing
+        // Field text is only formatted at the UI refresh rate
+        _fieldsDirty = true;
+    }
+    if (_fieldSelected) {
+        _sampleFields();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessage::refresh()
+{
+    if (_count != _refreshCount) {
+        _refreshCount = _count;
+        emit countChanged();
+    }
+    if (_selected && _fieldsDirty) {
         _updateFields();
     }
-    emit countChanged();
+}
+
+//-----------------------------------------------------------------------------
+/// Copies the header and the payload which was sent. Payload bytes past it must be zero and already are from the
+/// previous copy, except for what a longer previous message left behind.
+void
+QGCMAVLinkMessage::_copyMessage(const mavlink_message_t* message)
+{
+    const uint8_t len = message->len;
+    memcpy(&_message, message, offsetof(mavlink_message_t, payload64) + len);
+    if (_payloadLength > len) {
+        memset(reinterpret_cast<uint8_t*>(&_message.payload64[0]) + len, 0, _payloadLength - len);
+    }
+    _payloadLength = len;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+static qreal
+_rawValue(const uint8_t* p)
+{
+    T v;
+    memcpy(&v, p, sizeof(T));
+    return static_cast<qreal>(v);
+}
+
+//-----------------------------------------------------------------------------
+/// Adds the current value of the charted fields to their samples, the first element of arrays
+void
+QGCMAVLinkMessage::_sampleFields(void)
+{
+    if (!_msgInfo) {
+        return;
+    }
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(&_message.payload64[0]);
+    for (int i : _chartedFields) {
+        if (i >= static_cast<int>(_msgInfo->num_fields)) {
+            continue;
+        }
+        const mavlink_field_info_t& fieldInfo = _msgInfo->fields[i];
+        const uint8_t* p = m + fieldInfo.wire_offset;
+        qreal v = 0;
+        switch (fieldInfo.type) {
+        case MAVLINK_TYPE_CHAR:                                     break;
+        case MAVLINK_TYPE_UINT8_T:  v = _rawValue<uint8_t>(p);     break;
+        case MAVLINK_TYPE_INT8_T:   v = _rawValue<int8_t>(p);      break;
+        case MAVLINK_TYPE_UINT16_T: v = _rawValue<uint16_t>(p);    break;
+        case MAVLINK_TYPE_INT16_T:  v = _rawValue<int16_t>(p);     break;
+        case MAVLINK_TYPE_UINT32_T: v = _rawValue<uint32_t>(p);    break;
+        case MAVLINK_TYPE_INT32_T:  v = _rawValue<int32_t>(p);     break;
+        case MAVLINK_TYPE_FLOAT:    v = _rawValue<float>(p);       break;
+        case MAVLINK_TYPE_DOUBLE:   v = _rawValue<double>(p);      break;
+        case MAVLINK_TYPE_UINT64_T: v = _rawValue<uint64_t>(p);    break;
+        case MAVLINK_TYPE_INT64_T:  v = _rawValue<int64_t>(p);     break;
+        }
+        static_cast<QGCMAVLinkMessageField*>(_fields.get(i))->addSample(v);
+    }
 }
 
 void QGCMAVLinkMessage::_updateFields(void)
 {
-    const mavlink_message_info_t* msgInfo = mavlink_get_message_info(&_message);
+    _fieldsDirty = false;
+    const mavlink_message_info_t* msgInfo = _msgInfo;
     if (!msgInfo) {
         qWarning() << QStringLiteral("QGCMAVLinkMessage::update NULL msgInfo msgid(%1)").arg(_message.msgid);
         return;
@@ -266,12 +364,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                     // Enforce null termination
                     str[array_length - 1] = '\0';
                     QString v(str);
-                    f->updateValue(v, 0);
+                    f->updateValue(v);
                 } else {
                     // Single char
                     char b = *(reinterpret_cast<char*>(m + offset));
                     QString v(b);
-                    f->updateValue(v, 0);
+                    f->updateValue(v);
                 }
                 break;
             case MAVLINK_TYPE_UINT8_T:
@@ -283,11 +381,11 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint8_t u = *(m + offset);
-                    f->updateValue(QString::number(u), static_cast<qreal>(u));
+                    f->updateValue(QString::number(u));
                 }
                 break;
             case MAVLINK_TYPE_INT8_T:
@@ -299,11 +397,11 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int8_t n = *(reinterpret_cast<int8_t*>(m + offset));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_UINT16_T:
@@ -316,12 +414,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint16_t n;
                     memcpy(&n, m + offset, sizeof(uint16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_INT16_T:
@@ -334,12 +432,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int16_t n;
                     memcpy(&n, m + offset, sizeof(int16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_UINT32_T:
@@ -352,7 +450,7 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint32_t n;
@@ -360,9 +458,9 @@ void QGCMAVLinkMessage::_updateFields(void)
                     //-- Special case
                     if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                         QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n),Qt::UTC,0);
-                        f->updateValue(d.toString("HH:mm:ss"), static_cast<qreal>(n));
+                        f->updateValue(d.toString("HH:mm:ss"));
                     } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
+                        f->updateValue(QString::number(n));
                     }
                 }
                 break;
@@ -376,12 +474,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int32_t n;
                     memcpy(&n, m + offset, sizeof(int32_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_FLOAT:
@@ -394,12 +492,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                        string += tmp.arg(static_cast<double>(nums[j]));
                     }
                     string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     float fv;
                     memcpy(&fv, m + offset, sizeof(float));
-                    f->updateValue(QString::number(static_cast<double>(fv)), static_cast<qreal>(fv));
+                    f->updateValue(QString::number(static_cast<double>(fv)));
                 }
                 break;
             case MAVLINK_TYPE_DOUBLE:
@@ -412,12 +510,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     double d;
                     memcpy(&d, m + offset, sizeof(double));
-                    f->updateValue(QString::number(d), static_cast<qreal>(d));
+                    f->updateValue(QString::number(d));
                 }
                 break;
             case MAVLINK_TYPE_UINT64_T:
@@ -430,7 +528,7 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint64_t n;
@@ -438,9 +536,9 @@ void QGCMAVLinkMessage::_updateFields(void)
                     //-- Special case
                     if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                         QDateTime d = QDateTime::fromMSecsSinceEpoch(n/1000,Qt::UTC,0);
-                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"), static_cast<qreal>(n));
+                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"));
                     } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
+                        f->updateValue(QString::number(n));
                     }
                 }
                 break;
@@ -454,12 +552,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int64_t n;
                     memcpy(&n, m + offset, sizeof(int64_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             }
@@ -604,6 +702,34 @@ MAVLinkChartController::MAVLinkChartController(MAVLinkInspectorController *paren
     updateXRange();
 }
 
+//-----------------------------------------------------------------------------
+MAVLinkChartController::~MAVLinkChartController()
+{
+    for(int i = 0; i < _chartFields.count(); i++) {
+        QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(qvariant_cast<QObject*>(_chartFields.at(i)));
+        if(pField) {
+            _subscribeMessage(pField->message(), false);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Asks the vehicle to send a charted message at the chart refresh rate while the chart is showing it
+void
+MAVLinkChartController::_subscribeMessage(QGCMAVLinkMessage* message, bool subscribe)
+{
+    Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->getVehicleById(message->sysid());
+    // Rates can only be changed on messages coming from the autopilot
+    if(!vehicle || message->cid() != vehicle->defaultComponentId()) {
+        return;
+    }
+    if(subscribe) {
+        vehicle->messageIntervalManager()->subscribe(this, message->id(), 1000.0 / UPDATE_FREQUENCY);
+    } else {
+        vehicle->messageIntervalManager()->unsubscribe(this, message->id());
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkChartController::setRangeYIndex(quint32 r)
@@ -675,13 +801,41 @@ void
 MAVLinkChartController::_refreshSeries()
 {
     updateXRange();
+    const qreal xMin = static_cast<qreal>(_rangeXMin.toMSecsSinceEpoch());
+    const qreal xMax = static_cast<qreal>(_rangeXMax.toMSecsSinceEpoch());
     for(int i = 0; i < _chartFields.count(); i++) {
         QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
         QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
         if(pField) {
-            pField->updateSeries();
+            pField->updateSeries(xMin, xMax, _chartWidth);
         }
     }
+    //-- Auto Range
+    if(_rangeYIndex == 0) {
+        updateYRange();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkChartController::setPaused(bool paused)
+{
+    if(paused) {
+        _updateSeriesTimer.stop();
+    } else if(_chartFields.count()) {
+        _updateSeriesTimer.start(UPDATE_FREQUENCY);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkChartController::setChartWidth(int width)
+{
+    width = qMax(1, width);
+    if(_chartWidth != width) {
+        _chartWidth = width;
+        emit chartWidthChanged();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -697,6 +851,7 @@ MAVLinkChartController::addSeries(QGCMAVLinkMessageField* field, QAbstractSeries
         }
         _chartFields.append(f);
         field->addSeries(this, series);
+        _subscribeMessage(field->message(), true);
         emit chartFieldsChanged();
         _updateSeriesTimer.start(UPDATE_FREQUENCY);
     }
@@ -713,6 +868,16 @@ MAVLinkChartController::delSeries(QGCMAVLinkMessageField* field)
             if(_chartFields.at(i) == f) {
                 _chartFields.removeAt(i);
                 emit chartFieldsChanged();
+                bool messageCharted = false;
+                for(int j = 0; j < _chartFields.count(); j++) {
+                    QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(qvariant_cast<QObject*>(_chartFields.at(j)));
+                    if(pField && pField->message() == field->message()) {
+                        messageCharted = true;
+                    }
+                }
+                if(!messageCharted) {
+                    _subscribeMessage(field->message(), false);
+                }
                 if(_chartFields.count() == 0) {
                     updateXRange();
                     _updateSeriesTimer.stop();
@@ -733,8 +898,14 @@ MAVLinkInspectorController::MAVLinkInspectorController()
     connect(mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &MAVLinkInspectorController::_receiveMessage);
     connect(&_updateFrequencyTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshFrequency);
     _updateFrequencyTimer.start(1000);
+    connect(&_refreshFieldsTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshFields);
+    _refreshFieldsTimer.start(UPDATE_FREQUENCY);
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &MAVLinkInspectorController::_setActiveVehicle);
+    connect(qgcApp(), &QGCApplication::lowPowerModeChanged, this, &MAVLinkInspectorController::_lowPowerModeChanged);
+    if(qgcApp()->lowPowerMode()) {
+        _lowPowerModeChanged(true);
+    }
     _timeScaleSt.append(new TimeScale_st(this, tr("5 Sec"),   5 * 1000));
     _timeScaleSt.append(new TimeScale_st(this, tr("10 Sec"), 10 * 1000));
     _timeScaleSt.append(new TimeScale_st(this, tr("30 Sec"), 30 * 1000));
@@ -833,6 +1004,24 @@ MAVLinkInspectorController::_refreshFrequency()
     }
 }
 
+//-----------------------------------------------------------------------------
+/// Message counts and the field text of the selected message are only updated here, not on each message
+void
+MAVLinkInspectorController::_refreshFields()
+{
+    for(int i = 0; i < _systems.count(); i++) {
+        QGCMAVLinkSystem* v = qobject_cast<QGCMAVLinkSystem*>(_systems.get(i));
+        if(v) {
+            for(int j = 0; j < v->messages()->count(); j++) {
+                QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(v->messages()->get(j));
+                if(m) {
+                    m->refresh();
+                }
+            }
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkInspectorController::_vehicleAdded(Vehicle* vehicle)
@@ -862,6 +1051,29 @@ MAVLinkInspectorController::_vehicleRemoved(Vehicle* vehicle)
     }
 }
 
+//-----------------------------------------------------------------------------
+/// Nothing is on screen while in low power mode, so messages are not sampled at all until the window is back
+void
+MAVLinkInspectorController::_lowPowerModeChanged(bool lowPowerMode)
+{
+    MAVLinkProtocol* mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+    if(lowPowerMode) {
+        disconnect(mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &MAVLinkInspectorController::_receiveMessage);
+        _updateFrequencyTimer.stop();
+        _refreshFieldsTimer.stop();
+    } else {
+        connect(mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &MAVLinkInspectorController::_receiveMessage, Qt::UniqueConnection);
+        _updateFrequencyTimer.start(1000);
+        _refreshFieldsTimer.start(UPDATE_FREQUENCY);
+    }
+    for(int i = 0; i < _charts.count(); i++) {
+        MAVLinkChartController* chart = qobject_cast<MAVLinkChartController*>(_charts.get(i));
+        if(chart) {
+            chart->setPaused(lowPowerMode);
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkInspectorController::_receiveMessage(LinkInterface*, mavlink_message_t message)
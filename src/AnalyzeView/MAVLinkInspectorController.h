@@ -20,6 +20,7 @@
 #include <QString>
 #include <QDebug>
 #include <QVariantList>
+#include <QVector>
 #include <QtCharts/QAbstractSeries>
 
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkInspectorLog)
@@ -53,17 +54,18 @@ public:
     bool            selectable      () { return _selectable; }
     bool            selected        () { return _pSeries != nullptr; }
     QAbstractSeries*series          () { return _pSeries; }
-    QList<QPointF>* values          () { return &_values;}
     qreal           rangeMin        () { return _rangeMin; }
     qreal           rangeMax        () { return _rangeMax; }
     int             chartIndex      ();
+    QGCMAVLinkMessage* message      () { return _msg; }
 
     void            setSelectable   (bool sel);
-    void            updateValue     (QString newValue, qreal v);
+    void            updateValue     (const QString& newValue);
+    void            addSample       (qreal v);
 
     void            addSeries       (MAVLinkChartController* chart, QAbstractSeries* series);
     void            delSeries       ();
-    void            updateSeries    ();
+    void            updateSeries    (qreal xMin, qreal xMax, int buckets);
 
 signals:
     void            seriesChanged       ();
@@ -75,14 +77,15 @@ private:
     QString     _name;
     QString     _value;
     bool        _selectable = true;
-    int         _dataIndex  = 0;
+    int         _dataIndex  = 0;                ///< Next sample to write in _values
+    int         _sampleCount= 0;
     qreal       _rangeMin   = 0;
     qreal       _rangeMax   = 0;
 
     QAbstractSeries*    _pSeries = nullptr;
     QGCMAVLinkMessage*  _msg     = nullptr;
     MAVLinkChartController*      _chart   = nullptr;
-    QList<QPointF>      _values;
+    QVector<QPointF>    _values;                ///< Ring of samples, only allocated while charted
 };
 
 //-----------------------------------------------------------------------------
@@ -104,6 +107,7 @@ public:
 
     quint32             id              () { return _message.msgid;  }
     quint8              cid             () { return _message.compid; }
+    quint8              sysid           () { return _message.sysid; }
     QString             name            () { return _name;  }
     qreal               messageHz       () { return _messageHz; }
     quint64             count           () { return _count; }
@@ -114,6 +118,7 @@ public:
 
     void                updateFieldSelection();
     void                update          (mavlink_message_t* message);
+    void                refresh         ();
     void                updateFreq      ();
     void                setSelected     (bool sel);
 
@@ -125,15 +130,22 @@ signals:
 
 private:
     void _updateFields(void);
+    void _sampleFields(void);
+    void _copyMessage(const mavlink_message_t* message);
 
     QmlObjectListModel  _fields;
     QString             _name;
     qreal               _messageHz      = 0.0;
     uint64_t            _count          = 1;
     uint64_t            _lastCount      = 0;
+    uint64_t            _refreshCount   = 1;        ///< Count last signalled
     mavlink_message_t   _message;
+    uint8_t             _payloadLength  = 0;        ///< Length of the payload in _message, the rest is zero
+    const mavlink_message_info_t* _msgInfo = nullptr;
+    QList<int>          _chartedFields;             ///< Indexes of the fields with a series
     bool                _fieldSelected  = false;
     bool                _selected       = false;
+    bool                _fieldsDirty    = false;    ///< Field text is out of date
 };
 
 //-----------------------------------------------------------------------------
@@ -183,6 +195,7 @@ class MAVLinkChartController : public QObject {
     Q_OBJECT
 public:
     MAVLinkChartController(MAVLinkInspectorController* parent, int index);
+    ~MAVLinkChartController();
 
     Q_PROPERTY(QVariantList chartFields         READ chartFields            NOTIFY chartFieldsChanged)
     Q_PROPERTY(QDateTime    rangeXMin           READ rangeXMin              NOTIFY rangeXMinChanged)
@@ -190,6 +203,7 @@ public:
     Q_PROPERTY(qreal        rangeYMin           READ rangeYMin              NOTIFY rangeYMinChanged)
     Q_PROPERTY(qreal        rangeYMax           READ rangeYMax              NOTIFY rangeYMaxChanged)
     Q_PROPERTY(int          chartIndex          READ chartIndex             CONSTANT)
+    Q_PROPERTY(int          chartWidth          READ chartWidth             WRITE setChartWidth     NOTIFY chartWidthChanged)  ///< Pixels, every series is reduced to about this many buckets
 
     Q_PROPERTY(quint32      rangeYIndex         READ rangeYIndex            WRITE setRangeYIndex    NOTIFY rangeYIndexChanged)
     Q_PROPERTY(quint32      rangeXIndex         READ rangeXIndex            WRITE setRangeXIndex    NOTIFY rangeXIndexChanged)
@@ -207,11 +221,14 @@ public:
     quint32                 rangeXIndex         () { return _rangeXIndex; }
     quint32                 rangeYIndex         () { return _rangeYIndex; }
     int                     chartIndex          () { return _index; }
+    int                     chartWidth          () { return _chartWidth; }
 
     void                    setRangeXIndex      (quint32 t);
+    void                    setChartWidth       (int width);
     void                    setRangeYIndex      (quint32 r);
     void                    updateXRange        ();
     void                    updateYRange        ();
+    void                    setPaused           (bool paused);  ///< Stops redrawing the series, used in low power mode
 
 signals:
     void chartFieldsChanged ();
@@ -221,11 +238,14 @@ signals:
     void rangeYMaxChanged   ();
     void rangeYIndexChanged ();
     void rangeXIndexChanged ();
+    void chartWidthChanged  ();
 
 private slots:
     void _refreshSeries     ();
 
 private:
+    void _subscribeMessage  (QGCMAVLinkMessage* message, bool subscribe);
+
     QTimer              _updateSeriesTimer;
     QDateTime           _rangeXMin;
     QDateTime           _rangeXMax;
@@ -234,6 +254,7 @@ private:
     qreal               _rangeYMax           = 1;
     quint32             _rangeXIndex         = 0;                    ///< 5 Seconds
     quint32             _rangeYIndex         = 0;                    ///< Auto Range
+    int                 _chartWidth          = 500;
     QVariantList        _chartFields;
     MAVLinkInspectorController* _controller  = nullptr;
 };
@@ -295,6 +316,8 @@ private slots:
     void _vehicleRemoved    (Vehicle* vehicle);
     void _setActiveVehicle  (Vehicle* vehicle);
     void _refreshFrequency  ();
+    void _refreshFields     ();
+    void _lowPowerModeChanged(bool lowPowerMode);
 
 private:
     QGCMAVLinkSystem* _findVehicle (uint8_t id);
@@ -307,6 +330,7 @@ private:
     QStringList         _rangeList;
     QGCMAVLinkSystem*   _activeSystem           = nullptr;
     QTimer              _updateFrequencyTimer;
+    QTimer              _refreshFieldsTimer;
     QStringList         _systemNames;
     QmlObjectListModel  _systems;                           ///< List of QGCMAVLinkSystem
     QmlObjectListModel  _charts;                            ///< List of MAVLinkCharts
@@ -14,8 +14,18 @@
 #include <QClipboard>
 
 MavlinkConsoleController::MavlinkConsoleController()
-    : QStringListModel()
+    : QAbstractListModel()
 {
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(_flushMSecs);
+    connect(&_flushTimer, &QTimer::timeout, this, &MavlinkConsoleController::_flush);
+    connect(&_palette, &QGCPalette::paletteChanged, this, &MavlinkConsoleController::_paletteChanged);
+    _sendTimer.setSingleShot(true);
+    _sendTimer.setInterval(_sendCoalesceMSecs);
+    connect(&_sendTimer, &QTimer::timeout, this, &MavlinkConsoleController::_sendOutgoing);
+    _pollTimer.setSingleShot(true);
+    connect(&_pollTimer, &QTimer::timeout, this, &MavlinkConsoleController::_pollShell);
+
     auto *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &MavlinkConsoleController::_setActiveVehicle);
     _setActiveVehicle(manager->activeVehicle());
@@ -40,10 +50,60 @@ MavlinkConsoleController::sendCommand(QString command)
         }
     }
     command.append("\n");
-    _sendSerialData(qPrintable(command));
+    _outgoing_buffer.append(qPrintable(command));
+    if (!_sendTimer.isActive()) {
+        _sendTimer.start();
+    }
     _cursor_home_pos = -1;
 }
 
+void
+MavlinkConsoleController::_sendOutgoing(void)
+{
+    if (_outgoing_buffer.isEmpty() || !_vehicle) {
+        return;
+    }
+    _sendSerialData(_outgoing_buffer);
+    _outgoing_buffer.clear();
+
+    // A reply is on its way, poll quickly for the rest of it
+    _pollMSecs = _pollFastMSecs;
+    _pollTimer.start(_pollMSecs);
+}
+
+void
+MavlinkConsoleController::_pollShell(void)
+{
+    int polls;
+    if (_dataSincePoll) {
+        // Output is flowing, keep the pipe full
+        _pollMSecs  = _pollFastMSecs;
+        polls       = _maxPollsOutstanding - _pollsOutstanding;
+    } else {
+        // Requests which went unanswered for a whole tick are not coming back
+        _pollMSecs          = qMin(_pollMSecs * 2, _pollSlowMSecs);
+        _pollsOutstanding   = 0;
+        polls               = 1;
+    }
+    _dataSincePoll = false;
+
+    for (int i = 0; i < polls; i++) {
+        _sendSerialControl(QByteArray(), SERIAL_CONTROL_FLAG_EXCLUSIVE | SERIAL_CONTROL_FLAG_RESPOND | SERIAL_CONTROL_FLAG_MULTI);
+    }
+    _pollTimer.start(_pollMSecs);
+}
+
+void
+MavlinkConsoleController::_resetPolling(void)
+{
+    _sendTimer.stop();
+    _pollTimer.stop();
+    _outgoing_buffer.clear();
+    _pollMSecs          = _pollFastMSecs;
+    _pollsOutstanding   = 0;
+    _dataSincePoll      = false;
+}
+
 QString
 MavlinkConsoleController::historyUp(const QString& current)
 {
@@ -69,19 +129,44 @@ MavlinkConsoleController::handleClipboard(const QString& command_pre)
     return clipboardData;
 }
 
+void
+MavlinkConsoleController::copyToClipboard() const
+{
+    QStringList lines;
+    for (const ConsoleLine_t& line: _lines) {
+        lines.append(line.text);
+    }
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
+
+int
+MavlinkConsoleController::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : _modelRowCount;
+}
+
+QVariant
+MavlinkConsoleController::data(const QModelIndex& index, int role) const
+{
+    if (role != Qt::DisplayRole || index.row() < 0 || index.row() >= _modelRowCount) {
+        return QVariant();
+    }
+    return _lines[index.row()].richText;
+}
+
 void
 MavlinkConsoleController::_setActiveVehicle(Vehicle* vehicle)
 {
     for (auto &con : _uas_connections)
         disconnect(con);
     _uas_connections.clear();
+    _resetPolling();
 
     _vehicle = vehicle;
 
     if (_vehicle) {
         _incoming_buffer.clear();
-        // Reset the model
-        setStringList(QStringList());
+        _clear();
         _cursorY = 0;
         _cursorX = 0;
         _cursor_home_pos = -1;
@@ -95,36 +180,48 @@ MavlinkConsoleController::_receiveData(uint8_t device, uint8_t, uint16_t, uint32
     if (device != SERIAL_CONTROL_DEV_SHELL)
         return;
 
-    // Append incoming data and parse for ANSI codes
+    _pollsOutstanding = qMax(_pollsOutstanding - 1, 0);
+    if (data.isEmpty()) {
+        return;
+    }
+    if (_pollTimer.isActive() && _pollMSecs > _pollFastMSecs) {
+        // Output showed up while we were idling, speed back up right away
+        _pollMSecs = _pollFastMSecs;
+        _pollTimer.start(_pollMSecs);
+    }
+    _dataSincePoll = true;
+
+    // Anything left in _incoming_buffer from last time is the start of a fragmented ANSI code, only that and the new
+    // bytes are looked at
     _incoming_buffer.append(data);
-    while(!_incoming_buffer.isEmpty()) {
-        bool newline = false;
-        int idx = _incoming_buffer.indexOf('\n');
-        if (idx == -1) {
-            // Read the whole incoming buffer
-            idx = _incoming_buffer.size();
-        } else {
-            newline = true;
+
+    int textStart = 0;
+    int i = 0;
+    while (i < _incoming_buffer.size()) {
+        char c = _incoming_buffer.at(i);
+        if (c != '\n' && c != '\x1B') {
+            i++;
+            continue;
         }
 
-        QByteArray fragment = _incoming_buffer.mid(0, idx);
-        if (_processANSItext(fragment)) {
-            writeLine(_cursorY, fragment);
-            if (newline) {
-                _cursorY++;
-                _cursorX = 0;
-                // ensure line exists
-                int rc = rowCount();
-                if (_cursorY >= rc) {
-                    insertRows(rc, 1 + _cursorY - rc);
-                }
-            }
-            _incoming_buffer.remove(0, idx + (newline ? 1 : 0));
+        // Text before the newline or ANSI code has to land first since both act on the cursor position
+        _writeText(_incoming_buffer.mid(textStart, i - textStart));
+        if (c == '\n') {
+            _newLine();
+            i++;
         } else {
-            // ANSI processing failed, need more data
-            return;
+            int codeLength = _processANSIcode(i);
+            if (codeLength == 0) {
+                // Fragmented code, wait for the rest of it
+                _incoming_buffer.remove(0, i);
+                return;
+            }
+            i += codeLength;
         }
+        textStart = i;
     }
+    _writeText(_incoming_buffer.mid(textStart));
+    _incoming_buffer.clear();
 }
 
 void
@@ -135,97 +232,103 @@ MavlinkConsoleController::_sendSerialData(QByteArray data, bool close)
         return;
     }
 
+    // Send maximum sized chunks until the complete buffer is transmitted. Closing always sends one, even if empty.
+    uint8_t flags = close ? 0 : SERIAL_CONTROL_FLAG_EXCLUSIVE | SERIAL_CONTROL_FLAG_RESPOND | SERIAL_CONTROL_FLAG_MULTI;
+    do {
+        QByteArray chunk{data.left(MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN)};
+        _sendSerialControl(chunk, flags);
+        data.remove(0, chunk.size());
+    } while (data.size());
+}
+
+void
+MavlinkConsoleController::_sendSerialControl(const QByteArray& chunk, uint8_t flags)
+{
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (!sharedLink) {
         return;
     }
 
-    // Send maximum sized chunks until the complete buffer is transmitted
-    while(data.size()) {
-        QByteArray chunk{data.left(MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN)};
-        uint8_t flags = SERIAL_CONTROL_FLAG_EXCLUSIVE |  SERIAL_CONTROL_FLAG_RESPOND | SERIAL_CONTROL_FLAG_MULTI;
-        if (close) flags = 0;
-        auto protocol = qgcApp()->toolbox()->mavlinkProtocol();
-        auto link = _vehicle->vehicleLinkManager()->primaryLink();
-        mavlink_message_t msg;
-        mavlink_msg_serial_control_pack_chan(
-                    protocol->getSystemId(),
-                    protocol->getComponentId(),
-                    sharedLink->mavlinkChannel(),
-                    &msg,
-                    SERIAL_CONTROL_DEV_SHELL,
-                    flags,
-                    0,
-                    0,
-                    chunk.size(),
-                    reinterpret_cast<uint8_t*>(chunk.data()));
-        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
-        data.remove(0, chunk.size());
+    auto protocol = qgcApp()->toolbox()->mavlinkProtocol();
+    uint8_t buffer[MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN] = {};
+    memcpy(buffer, chunk.constData(), static_cast<size_t>(chunk.size()));
+    mavlink_message_t msg;
+    mavlink_msg_serial_control_pack_chan(
+                protocol->getSystemId(),
+                protocol->getComponentId(),
+                sharedLink->mavlinkChannel(),
+                &msg,
+                SERIAL_CONTROL_DEV_SHELL,
+                flags,
+                0,
+                0,
+                static_cast<uint8_t>(chunk.size()),
+                buffer);
+    _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+
+    if (flags & SERIAL_CONTROL_FLAG_RESPOND) {
+        _pollsOutstanding++;
     }
 }
 
-bool
-MavlinkConsoleController::_processANSItext(QByteArray &line)
+/// Handles the ANSI code starting at escapeIndex in _incoming_buffer
+///     @return Number of bytes used up by the code, 0 if the code is not complete yet
+int
+MavlinkConsoleController::_processANSIcode(int escapeIndex)
 {
-    // Iterate over the incoming buffer to parse off known ANSI control codes
-    for (int i = 0; i < line.size(); i++) {
-        if (line.at(i) == '\x1B') {
-            // For ANSI codes we expect at least 3 incoming chars
-            if (i < line.size() - 2 && line.at(i+1) == '[') {
-                // Parse ANSI code
-                switch(line.at(i+2)) {
-                    default:
-                        continue;
-                    case 'H':
-                        if (_cursor_home_pos == -1) {
-                            // Assign new home position if home is unset
-                            _cursor_home_pos = _cursorY;
-                        } else {
-                            // Rewind write cursor position to home
-                            _cursorY = _cursor_home_pos;
-                            _cursorX = 0;
-                        }
-                        break;
-                    case 'K':
-                        // Erase the current line to the end
-                        if (_cursorY < rowCount()) {
-                            auto idx = index(_cursorY);
-                            QString updated = data(idx, Qt::DisplayRole).toString();
-                            int eraseIdx = _cursorX + i;
-                            if (eraseIdx < updated.length()) {
-                                setData(idx, updated.remove(eraseIdx, updated.length()));
-                            }
-                        }
-                        break;
-                    case '2':
-                        // Check for sufficient buffer size
-                        if ( i >= line.size() - 3)
-                            return false;
-
-                        if (line.at(i+3) == 'J' && _cursor_home_pos != -1) {
-                            // Erase everything and rewind to home
-                            bool blocked = blockSignals(true);
-                            for (int j = _cursor_home_pos; j < rowCount(); j++)
-                                setData(index(j), "");
-                            blockSignals(blocked);
-                            QVector<int> roles({Qt::DisplayRole, Qt::EditRole});
-                            emit dataChanged(index(_cursorY), index(rowCount()), roles);
-                        }
-                        // Even if we didn't understand this ANSI code, remove the 4th char
-                        line.remove(i+3,1);
-                        break;
+    if (escapeIndex + 1 >= _incoming_buffer.size()) {
+        return 0;
+    }
+    if (_incoming_buffer.at(escapeIndex + 1) != '[') {
+        // Not a control sequence we know about, drop the escape
+        return 1;
+    }
+
+    // Control sequence: parameter and intermediate bytes followed by a final byte
+    int finalIndex = escapeIndex + 2;
+    while (finalIndex < _incoming_buffer.size() && _incoming_buffer.at(finalIndex) >= 0x20 && _incoming_buffer.at(finalIndex) <= 0x3F) {
+        finalIndex++;
+    }
+    if (finalIndex >= _incoming_buffer.size()) {
+        return 0;
+    }
+    QByteArray parameters = _incoming_buffer.mid(escapeIndex + 2, finalIndex - escapeIndex - 2);
+
+    switch (_incoming_buffer.at(finalIndex)) {
+    case 'H':
+        if (_cursor_home_pos == -1) {
+            // Assign new home position if home is unset
+            _cursor_home_pos = _cursorY;
+        } else {
+            // Rewind write cursor position to home
+            _cursorY = _cursor_home_pos;
+            _cursorX = 0;
+        }
+        break;
+    case 'K':
+        // Erase the current line to the end
+        if (_cursorY < _lines.count() && _cursorX < _lines[_cursorY].text.length()) {
+            _lines[_cursorY].text.truncate(_cursorX);
+            _lineChanged(_cursorY);
+        }
+        break;
+    case 'J':
+        if (parameters == "2" && _cursor_home_pos != -1) {
+            // Erase everything from home on
+            for (int j = _cursor_home_pos; j < _lines.count(); j++) {
+                if (!_lines[j].text.isEmpty()) {
+                    _lines[j].text.clear();
+                    _lineChanged(j);
                 }
-                // Remove the parsed ANSI code and decrement the bufferpos
-                line.remove(i, 3);
-                i--;
-            } else {
-                // We can reasonably expect a control code was fragemented
-                // Stop parsing here and wait for it to come in
-                return false;
             }
         }
+        break;
+    default:
+        // Colors and the like are not supported, they are left out of the text
+        break;
     }
-    return true;
+
+    return finalIndex - escapeIndex + 1;
 }
 
 QString
@@ -242,41 +345,128 @@ MavlinkConsoleController::transformLineForRichText(const QString& line) const
     return ret;
 }
 
-QString
-MavlinkConsoleController::getText() const
+/// Writes text at the cursor, overwriting what is there
+void
+MavlinkConsoleController::_writeText(const QByteArray& text)
 {
-    QString ret;
-    if (rowCount() > 0) {
-        ret = transformLineForRichText(data(index(0), Qt::DisplayRole).toString());
+    if (text.isEmpty()) {
+        return;
     }
-    for (int i = 1; i < rowCount(); ++i) {
-        ret += "<br>" + transformLineForRichText(data(index(i), Qt::DisplayRole).toString());
+
+    _ensureLine(_cursorY);
+    QString  updated    = QString::fromUtf8(text);
+    QString& lineText   = _lines[_cursorY].text;
+    if (_cursorX > lineText.length()) {
+        lineText.append(QString(_cursorX - lineText.length(), ' '));
     }
+    lineText.replace(_cursorX, updated.length(), updated);
+    _cursorX += updated.length();
+    _lineChanged(_cursorY);
+}
 
-    return ret;
+void
+MavlinkConsoleController::_newLine(void)
+{
+    _cursorY++;
+    _cursorX = 0;
+    _ensureLine(_cursorY);
+}
+
+void
+MavlinkConsoleController::_ensureLine(int line)
+{
+    if (line >= _lines.count()) {
+        // New lines are picked up by _flush from _modelRowCount, no need to mark them
+        _lines.resize(line + 1);
+        if (!_flushTimer.isActive()) {
+            _flushTimer.start();
+        }
+    }
 }
 
 void
-MavlinkConsoleController::writeLine(int line, const QByteArray &text)
+MavlinkConsoleController::_lineChanged(int line)
 {
-    auto rc = rowCount();
-    if (line >= rc) {
-        insertRows(rc, 1 + line - rc);
-    }
-    if (rowCount() > _max_num_lines) {
-        int count = rowCount() - _max_num_lines;
-        removeRows(0, count);
-        line -= count;
-        _cursorY -= count;
+    if (line >= _modelRowCount) {
+        // Not in the view yet, goes out as part of the row insert
+    } else if (_firstChanged == -1) {
+        _firstChanged = _lastChanged = line;
+    } else {
+        _firstChanged   = qMin(_firstChanged, line);
+        _lastChanged    = qMax(_lastChanged, line);
+    }
+    if (!_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+}
+
+/// Sends everything that changed since the last flush to the view
+void
+MavlinkConsoleController::_flush(void)
+{
+    if (_lines.count() > _max_num_lines) {
+        int count       = _lines.count() - _max_num_lines;
+        int modelCount  = qMin(count, _modelRowCount);
+        if (modelCount > 0) {
+            beginRemoveRows(QModelIndex(), 0, modelCount - 1);
+        }
+        _lines.remove(0, count);
+        _modelRowCount -= modelCount;
+        if (modelCount > 0) {
+            endRemoveRows();
+        }
+
+        _cursorY = qMax(_cursorY - count, 0);
         _cursor_home_pos -= count;
         if (_cursor_home_pos < 0)
             _cursor_home_pos = -1;
+        if (_firstChanged != -1) {
+            _firstChanged   = qMax(_firstChanged - count, 0);
+            _lastChanged    -= count;
+            if (_lastChanged < 0) {
+                _firstChanged = _lastChanged = -1;
+            }
+        }
+    }
+
+    if (_firstChanged != -1) {
+        for (int i = _firstChanged; i <= _lastChanged; i++) {
+            _lines[i].richText = transformLineForRichText(_lines[i].text);
+        }
+        emit dataChanged(index(_firstChanged), index(_lastChanged), { Qt::DisplayRole });
+        _firstChanged = _lastChanged = -1;
     }
-    auto idx = index(line);
-    QString updated = data(idx, Qt::DisplayRole).toString();
-    updated.replace(_cursorX, text.size(), text);
-    setData(idx, updated);
-    _cursorX += text.size();
+
+    if (_lines.count() > _modelRowCount) {
+        beginInsertRows(QModelIndex(), _modelRowCount, _lines.count() - 1);
+        for (int i = _modelRowCount; i < _lines.count(); i++) {
+            _lines[i].richText = transformLineForRichText(_lines[i].text);
+        }
+        _modelRowCount = _lines.count();
+        endInsertRows();
+    }
+}
+
+void
+MavlinkConsoleController::_paletteChanged(void)
+{
+    // Cached rows have the old colors baked in
+    if (_modelRowCount > 0) {
+        _firstChanged   = 0;
+        _lastChanged    = _modelRowCount - 1;
+        _flush();
+    }
+}
+
+void
+MavlinkConsoleController::_clear(void)
+{
+    _flushTimer.stop();
+    beginResetModel();
+    _lines.clear();
+    _modelRowCount = 0;
+    _firstChanged = _lastChanged = -1;
+    endResetModel();
 }
 
 void MavlinkConsoleController::CommandHistory::append(const QString& command)
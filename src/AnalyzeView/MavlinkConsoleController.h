@@ -16,13 +16,24 @@
 #include <QObject>
 #include <QString>
 #include <QMetaObject>
-#include <QStringListModel>
+#include <QAbstractListModel>
+#include <QTimer>
+#include <QVector>
 
 // Fordward decls
 class Vehicle;
 
 /// Controller for MavlinkConsole.qml.
-class MavlinkConsoleController : public QStringListModel
+///
+/// The model has one row per console line and its display role is the line already escaped for StyledText. Raw text
+/// is kept alongside so incoming output only touches the lines it writes to. Changes are collected and sent to the
+/// view at most once per _flushMSecs, only the changed rows are escaped again.
+///
+/// Outgoing input is coalesced for _sendCoalesceMSecs before it goes out in SERIAL_CONTROL chunks. Once the shell is
+/// open it is polled for output, some firmware (ArduPilot) only sends shell output in reply to a request. While output
+/// is flowing up to _maxPollsOutstanding requests are kept in flight at _pollFastMSecs, backing off towards
+/// _pollSlowMSecs with a single request when the shell goes quiet.
+class MavlinkConsoleController : public QAbstractListModel
 {
     Q_OBJECT
 
@@ -42,21 +53,39 @@ public:
      */
     Q_INVOKABLE QString handleClipboard(const QString& command_pre);
 
-    Q_PROPERTY(QString text                     READ getText                    CONSTANT)
+    /// Copies the plain text of the whole console to the clipboard
+    Q_INVOKABLE void copyToClipboard() const;
+
+    // Overrides from QAbstractListModel
+    int         rowCount    (const QModelIndex& parent = QModelIndex()) const override;
+    QVariant    data        (const QModelIndex& index, int role = Qt::DisplayRole) const override;
 
 private slots:
     void _setActiveVehicle  (Vehicle* vehicle);
     void _receiveData(uint8_t device, uint8_t flags, uint16_t timeout, uint32_t baudrate, QByteArray data);
+    void _flush             (void);
+    void _paletteChanged    (void);
+    void _sendOutgoing      (void);
+    void _pollShell         (void);
 
 private:
-    bool _processANSItext(QByteArray &line);
+    typedef struct {
+        QString text;       ///< Raw line as written by the shell
+        QString richText;   ///< Escaped text the view shows, brought up to date by _flush
+    } ConsoleLine_t;
+
+    int  _processANSIcode(int escapeIndex);
     void _sendSerialData(QByteArray, bool close = false);
-    void writeLine(int line, const QByteArray &text);
+    void _sendSerialControl(const QByteArray& chunk, uint8_t flags);
+    void _resetPolling(void);
+    void _writeText(const QByteArray& text);
+    void _newLine(void);
+    void _ensureLine(int line);
+    void _lineChanged(int line);
+    void _clear(void);
 
     QString transformLineForRichText(const QString& line) const;
 
-    QString getText() const;
-
     class CommandHistory
     {
     public:
@@ -69,8 +98,24 @@ private:
         int _index = 0;
     };
 
-    static constexpr int _max_num_lines = 500; ///< history size (affects CPU load)
-
+    static constexpr int _max_num_lines = 500; ///< history size
+    static constexpr int _flushMSecs    = 30;  ///< max rate at which changes go out to the view
+    static constexpr int _sendCoalesceMSecs     = 20;   ///< input collected for this long goes out together
+    static constexpr int _pollFastMSecs         = 50;
+    static constexpr int _pollSlowMSecs         = 1000;
+    static constexpr int _maxPollsOutstanding   = 4;
+
+    QVector<ConsoleLine_t> _lines;          ///< Can run ahead of the view until the next _flush
+    int           _modelRowCount{0};        ///< Rows the view knows about
+    int           _firstChanged{-1};        ///< Range of existing lines changed since last _flush, -1: none
+    int           _lastChanged{-1};
+    QTimer        _flushTimer;
+    QByteArray    _outgoing_buffer;         ///< Input waiting for _sendTimer
+    QTimer        _sendTimer;
+    QTimer        _pollTimer;               ///< Only runs once the shell has been opened
+    int           _pollMSecs{_pollFastMSecs};
+    int           _pollsOutstanding{0};     ///< Requests sent which have not seen a reply yet
+    bool          _dataSincePoll{false};    ///< Shell output came in since the last poll tick
     int           _cursor_home_pos{-1};
     int           _cursorY{0};
     int           _cursorX{0};
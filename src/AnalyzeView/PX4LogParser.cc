@@ -1,5 +1,6 @@
 #include "PX4LogParser.h"
 #include <math.h>
+#include <string.h>
 #include <QtEndian>
 #include <QDateTime>
 
@@ -13,87 +14,94 @@ PX4LogParser::~PX4LogParser()
 
 }
 
-bool PX4LogParser::getTagsFromLog(QByteArray& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback)
+qint64 PX4LogParser::_nextHeader(const uchar* log, qint64 size, qint64 index)
 {
-
-     // general message header
-    char header[] = {(char)0xA3, (char)0x95, (char)0x00};
-    // header for GPOS message header
-    char gposHeaderHeader[] = {(char)0xA3, (char)0x95, (char)0x80, (char)0x10, (char)0x00};
-    int gposHeaderOffset;
-    // header for GPOS message
-    char gposHeader[] = {(char)0xA3, (char)0x95, (char)0x10, (char)0x00};
-    int gposOffsets[3] = {3, 7, 11};
-    int gposLengths[3] = {4, 4, 4};
-    // header for trigger message header
-    char triggerHeaderHeader[] = {(char)0xA3, (char)0x95, (char)0x80, (char)0x37, (char)0x00};
-    int triggerHeaderOffset;
-    // header for trigger message
-    char triggerHeader[] = {(char)0xA3, (char)0x95, (char)0x37, (char)0x00};
-    int triggerOffsets[2] = {3, 11};
-    int triggerLengths[2] = {8, 4};
-
-    // extract header information: message lengths
-    uint8_t* iptr = reinterpret_cast<uint8_t*>(log.mid(log.indexOf(gposHeaderHeader) + 4, 1).data());
-    gposHeaderOffset = static_cast<int>(qFromLittleEndian(*iptr));
-    iptr = reinterpret_cast<uint8_t*>(log.mid(log.indexOf(triggerHeaderHeader) + 4, 1).data());
-    triggerHeaderOffset = static_cast<int>(qFromLittleEndian(*iptr));
-
-    // extract trigger data
-    int index = 1;
-    int sequence = -1;
-    while(index < log.count() - 1) {
-
-        // first extract trigger
-        index = log.indexOf(triggerHeader, index + 1);
-        // check for whether last entry has been passed
-        if (index < 0) {
+    // memchr is vectorized by the C library, which makes skipping over garbage cheap
+    while (index + 1 < size) {
+        const uchar* sync = static_cast<const uchar*>(memchr(log + index, _sync1, static_cast<size_t>(size - index - 1)));
+        if (!sync) {
             break;
         }
+        index = sync - log;
+        if (log[index + 1] == _sync2) {
+            return index;
+        }
+        index++;
+    }
+    return -1;
+}
 
-        if (log.indexOf(header, index + 1) != index + triggerHeaderOffset) {
+bool PX4LogParser::getTagsFromLog(const uchar* log, qint64 size, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback)
+{
+    // Message lengths by type, including the header, 0 until the format for the type has been seen
+    int                                         lengths[256]    = { };
+    QList<GeoTagWorker::cameraFeedbackPacket>   pendingTriggers;                ///< Triggers waiting for the next position
+    int                                         sequence        = -1;
+    qint64                                      index           = _nextHeader(log, size, 0);
+
+    lengths[_msgTypeFormat] = _formatLength;
+
+    while (index >= 0 && index + _headerLength <= size) {
+        const uchar*    msg     = log + index;
+        int             length  = lengths[msg[2]];
+
+        // The next message must start right after this one, otherwise this is not a real header
+        if (length == 0 || index + length > size ||
+                (index + length + 1 < size && (msg[length] != _sync1 || msg[length + 1] != _sync2))) {
+            index = _nextHeader(log, size, index + 1);
             continue;
         }
 
-        GeoTagWorker::cameraFeedbackPacket feedback;
-        memset(&feedback, 0, sizeof(feedback));
+        switch (msg[2]) {
+        case _msgTypeFormat:
+            if (msg[4] >= _headerLength) {
+                lengths[msg[3]] = msg[4];
+            }
+            break;
 
-        uint64_t* time = reinterpret_cast<uint64_t*>(log.mid(index + triggerOffsets[0], triggerLengths[0]).data());
-        double timeDouble = static_cast<double>(qFromLittleEndian(*time)) / 1.0e6;
-        uint32_t* seq = reinterpret_cast<uint32_t*>(log.mid(index + triggerOffsets[1], triggerLengths[1]).data());
-        int seqInt = static_cast<int>(qFromLittleEndian(*seq));
-        if (sequence >= seqInt || sequence + 20 < seqInt) { // assume that logging has not skipped more than 20 triggers. this prevents wrong header detection
-            continue;
-        }
-        feedback.timestamp = timeDouble;
-        feedback.imageSequence = seqInt;
-        sequence = seqInt;
-
-        // second extract position
-        bool lookForGpos = true;
-        while (lookForGpos) {
-
-            int gposIndex = log.indexOf(gposHeader, index + 1);
-            if (gposIndex < 0) {
-                cameraFeedback.append(feedback);
-                break;
+        case _msgTypeTrigger:
+            if (length >= 15) {
+                GeoTagWorker::cameraFeedbackPacket feedback;
+                memset(&feedback, 0, sizeof(feedback));
+
+                int seqInt = static_cast<int>(qFromLittleEndian<quint32>(msg + 11));
+                if (sequence >= seqInt || sequence + 20 < seqInt) { // assume that logging has not skipped more than 20 triggers. this prevents wrong header detection
+                    break;
+                }
+                feedback.timestamp      = static_cast<double>(qFromLittleEndian<quint64>(msg + 3)) / 1.0e6;
+                feedback.imageSequence  = static_cast<uint32_t>(seqInt);
+                sequence = seqInt;
+                pendingTriggers.append(feedback);
             }
-            index = gposIndex;
-
-            // verify that at an offset of gposHeaderOffset the next log message starts
-            if (gposIndex + gposHeaderOffset == log.indexOf(header, gposIndex + 1)) {
-                int32_t* lat = reinterpret_cast<int32_t*>(log.mid(gposIndex + gposOffsets[0], gposLengths[0]).data());
-                feedback.latitude = static_cast<double>(qFromLittleEndian(*lat))/1.0e7;
-                int32_t* lon = reinterpret_cast<int32_t*>(log.mid(gposIndex + gposOffsets[1], gposLengths[1]).data());
-                feedback.longitude = static_cast<double>(qFromLittleEndian(*lon))/1.0e7;
-                feedback.longitude = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
-                float* alt = reinterpret_cast<float*>(log.mid(gposIndex + gposOffsets[2], gposLengths[2]).data());
-                feedback.altitude = qFromLittleEndian(*alt);
-                cameraFeedback.append(feedback);
-                break;
+            break;
+
+        case _msgTypeGpos:
+            if (length >= 15 && !pendingTriggers.isEmpty()) {
+                // The first position after a trigger is the one it gets
+                double  latitude    = static_cast<double>(qFromLittleEndian<qint32>(msg + 3)) / 1.0e7;
+                double  longitude   = static_cast<double>(qFromLittleEndian<qint32>(msg + 7)) / 1.0e7;
+                quint32 altBits     = qFromLittleEndian<quint32>(msg + 11);
+                float   altitude;
+                memcpy(&altitude, &altBits, sizeof(altitude));
+                for (GeoTagWorker::cameraFeedbackPacket& feedback: pendingTriggers) {
+                    feedback.latitude   = latitude;
+                    feedback.longitude  = fmod(180.0 + longitude, 360.0) - 180.0;
+                    feedback.altitude   = altitude;
+                    cameraFeedback.append(feedback);
+                }
+                pendingTriggers.clear();
             }
+            break;
+
+        default:
+            break;
         }
+
+        index += length;
     }
 
+    // Triggers after the last position still count, just without one
+    cameraFeedback.append(pendingTriggers);
+
     return true;
 }
@@ -11,10 +11,22 @@ class PX4LogParser
 public:
     PX4LogParser();
     ~PX4LogParser();
-    bool getTagsFromLog(QByteArray& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback);
+
+    /// Walks the messages of the log by the lengths from its format definitions, resynchronizing on the next message
+    /// header whenever the data doesn't line up
+    ///     @param log Usually the mapped log file
+    bool getTagsFromLog(const uchar* log, qint64 size, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback);
 
 private:
+    qint64 _nextHeader(const uchar* log, qint64 size, qint64 index);
 
+    static const uchar  _sync1          = 0xA3;
+    static const uchar  _sync2          = 0x95;
+    static const uchar  _msgTypeFormat  = 0x80;
+    static const uchar  _msgTypeGpos    = 0x10;
+    static const uchar  _msgTypeTrigger = 0x37;
+    static const int    _headerLength   = 3;
+    static const int    _formatLength   = 89;   ///< Header, type, length, name[4], format[16], labels[64]
 };
 
 #endif // PX4LOGPARSER_H
@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "PerformanceController.h"
+#include "QGCInstrumentation.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+
+#include <QDateTime>
+#include <QDir>
+
+PerformanceController::PerformanceController(void)
+{
+    connect(QGCInstrumentRegister::instance(), &QGCInstrumentRegister::dumpingChanged, this, &PerformanceController::dumpingChanged);
+    connect(&_refreshTimer, &QTimer::timeout, this, &PerformanceController::_refresh);
+    _refreshTimer.start(_refreshIntervalMSecs);
+    _refresh();
+}
+
+PerformanceController::~PerformanceController()
+{
+
+}
+
+bool PerformanceController::enabled(void) const
+{
+    return QGCInstrumentRegister::enabled();
+}
+
+bool PerformanceController::dumping(void) const
+{
+    return QGCInstrumentRegister::instance()->dumping();
+}
+
+QString PerformanceController::dumpPath(void) const
+{
+    return QGCInstrumentRegister::instance()->dumpPath();
+}
+
+void PerformanceController::reset(void)
+{
+    QGCInstrumentRegister::instance()->resetAll();
+    _previousCounterValues.clear();
+    _refresh();
+}
+
+void PerformanceController::startDump(void)
+{
+    QString dir = qgcApp()->toolbox()->settingsManager()->appSettings()->logSavePath();
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+
+    QString path = QDir(dir).absoluteFilePath(QStringLiteral("Performance-%1.csv").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss")));
+    if (!QGCInstrumentRegister::instance()->startDump(path)) {
+        qgcApp()->showAppMessage(tr("Unable to write performance file: %1").arg(path));
+    }
+}
+
+void PerformanceController::stopDump(void)
+{
+    QGCInstrumentRegister::instance()->stopDump();
+}
+
+void PerformanceController::_refresh(void)
+{
+    qint64  nowMSecs        = QDateTime::currentMSecsSinceEpoch();
+    double  elapsedSecs     = _previousRefreshMSecs ? (nowMSecs - _previousRefreshMSecs) / 1000.0 : 0;
+
+    _instruments = QGCInstrumentRegister::instance()->snapshot();
+    for (QVariant& var: _instruments) {
+        QVariantMap map = var.toMap();
+        if (map["kind"].toString() == QStringLiteral("counter")) {
+            QString name    = map["name"].toString();
+            quint64 value   = map["value"].toULongLong();
+            quint64 prev    = _previousCounterValues.value(name, value);
+            map["rate"] = elapsedSecs > 0 && value >= prev ? (value - prev) / elapsedSecs : 0.0;
+            _previousCounterValues[name] = value;
+            var = map;
+        }
+    }
+    _previousRefreshMSecs = nowMSecs;
+
+    emit instrumentsChanged();
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QVariantList>
+
+/// Controller for PerformancePage.qml. Exposes the hot path instruments registered with QGCInstrumentRegister.
+class PerformanceController : public QObject
+{
+    Q_OBJECT
+
+public:
+    PerformanceController(void);
+    ~PerformanceController();
+
+    Q_PROPERTY(bool         enabled     READ enabled        CONSTANT)                       ///< false: instrumentation is compiled out
+    Q_PROPERTY(QVariantList instruments READ instruments    NOTIFY instrumentsChanged)      ///< Snapshot of all instruments, counters also include a per second "rate"
+    Q_PROPERTY(bool         dumping     READ dumping        NOTIFY dumpingChanged)
+    Q_PROPERTY(QString      dumpPath    READ dumpPath       NOTIFY dumpingChanged)
+
+    /// Resets all instruments back to zero
+    Q_INVOKABLE void reset(void);
+
+    /// Starts writing instruments to a time stamped CSV file in the log save directory
+    Q_INVOKABLE void startDump(void);
+    Q_INVOKABLE void stopDump (void);
+
+    bool            enabled     (void) const;
+    QVariantList    instruments (void) const { return _instruments; }
+    bool            dumping     (void) const;
+    QString         dumpPath    (void) const;
+
+signals:
+    void instrumentsChanged (void);
+    void dumpingChanged     (void);
+
+private slots:
+    void _refresh(void);
+
+private:
+    QTimer                  _refreshTimer;
+    QVariantList            _instruments;
+    QHash<QString, quint64> _previousCounterValues;
+    qint64                  _previousRefreshMSecs = 0;
+
+    static const int _refreshIntervalMSecs = 1000;
+};
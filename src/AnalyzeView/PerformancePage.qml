@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+import QtQuick                      2.11
+import QtQuick.Controls             2.4
+import QtQuick.Layouts              1.11
+
+import QGroundControl               1.0
+import QGroundControl.Palette       1.0
+import QGroundControl.Controls      1.0
+import QGroundControl.ScreenTools   1.0
+import QGroundControl.Controllers   1.0
+
+AnalyzePage {
+    id:                 performancePage
+    pageComponent:      pageComponent
+    pageName:           qsTr("Performance")
+    pageDescription:    qsTr("Time spent in the main processing stages. Durations are in milliseconds, rates are per second.")
+
+    readonly property real _columnSpacing: ScreenTools.defaultFontPixelWidth * 2
+
+    PerformanceController {
+        id: controller
+    }
+
+    function _msecs(usecs) {
+        return usecs === undefined ? "" : (usecs / 1000).toFixed(2)
+    }
+
+    function _videoRow(name, stats) {
+        return [
+            name,
+            (stats.inputBitrate / 1000000).toFixed(2),
+            stats.decodeFps.toFixed(1),
+            stats.renderFps.toFixed(1),
+            stats.droppedFrames,
+            stats.lateFrames,
+            stats.decodeLatency.toFixed(1),
+            stats.jitterBufferLatency,
+            stats.jitter.toFixed(1),
+            stats.lostPackets
+        ]
+    }
+
+    Component {
+        id: pageComponent
+
+        ColumnLayout {
+            width:      availableWidth
+            spacing:    ScreenTools.defaultFontPixelHeight / 2
+
+            QGCLabel {
+                text:       qsTr("Instrumentation is not included in this build.")
+                visible:    !controller.enabled
+            }
+
+            RowLayout {
+                spacing:    ScreenTools.defaultFontPixelWidth
+                visible:    controller.enabled
+
+                QGCButton {
+                    text:       qsTr("Reset")
+                    onClicked:  controller.reset()
+                }
+                QGCButton {
+                    text:       controller.dumping ? qsTr("Stop Recording") : qsTr("Record to File")
+                    onClicked:  controller.dumping ? controller.stopDump() : controller.startDump()
+                }
+                QGCLabel {
+                    text:       controller.dumpPath
+                    visible:    controller.dumping
+                }
+            }
+
+            // Video pipeline statistics are gathered by the video receiver, so they show whether or not the instruments are compiled in
+            GridLayout {
+                id:             videoGrid
+                columns:        10
+                columnSpacing:  _columnSpacing
+                visible:        _videoStats.inputBitrate !== undefined || _thermalStats.inputBitrate !== undefined
+
+                property var _videoStats:   QGroundControl.videoManager.videoStatistics
+                property var _thermalStats: QGroundControl.videoManager.thermalVideoStatistics
+
+                QGCLabel { text: qsTr("Video") }
+                QGCLabel { text: qsTr("Mbit/s") }
+                QGCLabel { text: qsTr("Decode fps") }
+                QGCLabel { text: qsTr("Render fps") }
+                QGCLabel { text: qsTr("Dropped") }
+                QGCLabel { text: qsTr("Late") }
+                QGCLabel { text: qsTr("Decode ms") }
+                QGCLabel { text: qsTr("Jitter buffer ms") }
+                QGCLabel { text: qsTr("Jitter ms") }
+                QGCLabel { text: qsTr("Lost packets") }
+
+                Repeater {
+                    model: videoGrid._videoStats.inputBitrate !== undefined ? _videoRow(qsTr("Main"), videoGrid._videoStats) : []
+
+                    QGCLabel {
+                        text:               modelData
+                        Layout.alignment:   index === 0 ? Qt.AlignLeft : Qt.AlignRight
+                    }
+                }
+
+                Repeater {
+                    model: videoGrid._thermalStats.inputBitrate !== undefined ? _videoRow(qsTr("Thermal"), videoGrid._thermalStats) : []
+
+                    QGCLabel {
+                        text:               modelData
+                        Layout.alignment:   index === 0 ? Qt.AlignLeft : Qt.AlignRight
+                    }
+                }
+            }
+
+            QGCFlickable {
+                Layout.fillWidth:       true
+                Layout.preferredHeight: availableHeight - y
+                contentWidth:           grid.width
+                contentHeight:          grid.height
+                clip:                   true
+                visible:                controller.enabled
+
+                GridLayout {
+                    id:             grid
+                    columns:        8
+                    columnSpacing:  _columnSpacing
+
+                    QGCLabel { text: qsTr("Stage") }
+                    QGCLabel { text: qsTr("Value") }
+                    QGCLabel { text: qsTr("Rate") }
+                    QGCLabel { text: qsTr("Mean") }
+                    QGCLabel { text: qsTr("50%") }
+                    QGCLabel { text: qsTr("95%") }
+                    QGCLabel { text: qsTr("99%") }
+                    QGCLabel { text: qsTr("Max") }
+
+                    Repeater {
+                        model: controller.instruments
+
+                        // One row per instrument, which is eight cells of the grid
+                        Repeater {
+                            model: [
+                                modelData.name,
+                                modelData.kind === "histogram" ? modelData.count : modelData.value,
+                                modelData.kind === "counter" ? modelData.rate.toFixed(1) : "",
+                                _msecs(modelData.meanUSecs),
+                                _msecs(modelData.p50USecs),
+                                _msecs(modelData.p95USecs),
+                                _msecs(modelData.p99USecs),
+                                _msecs(modelData.maxUSecs)
+                            ]
+
+                            QGCLabel {
+                                text:               modelData
+                                Layout.alignment:   index === 0 ? Qt.AlignLeft : Qt.AlignRight
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
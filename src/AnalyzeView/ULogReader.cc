@@ -0,0 +1,311 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ULogReader.h"
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(ULogReaderLog, "ULogReaderLog")
+
+static const char kULogMagic[7] = { 'U', 'L', 'o', 'g', 0x01, 0x12, 0x35 };
+
+const ULogReader::Field_t* ULogReader::Format::field(const QString& name) const
+{
+    for (const Field_t& field: fields) {
+        if (field.name == name) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+ULogReader::ULogReader(void)
+{
+
+}
+
+ULogReader::~ULogReader()
+{
+    close();
+}
+
+int ULogReader::typeSize(FieldType type)
+{
+    switch (type) {
+    case TypeInt8:
+    case TypeUInt8:
+    case TypeBool:
+    case TypeChar:
+        return 1;
+    case TypeInt16:
+    case TypeUInt16:
+        return 2;
+    case TypeInt32:
+    case TypeUInt32:
+    case TypeFloat:
+        return 4;
+    case TypeInt64:
+    case TypeUInt64:
+    case TypeDouble:
+        return 8;
+    }
+    return 0;
+}
+
+bool ULogReader::_basicType(const QString& typeName, FieldType& type)
+{
+    static const QHash<QString, FieldType> types = {
+        { QStringLiteral("int8_t"),     TypeInt8 },
+        { QStringLiteral("uint8_t"),    TypeUInt8 },
+        { QStringLiteral("int16_t"),    TypeInt16 },
+        { QStringLiteral("uint16_t"),   TypeUInt16 },
+        { QStringLiteral("int32_t"),    TypeInt32 },
+        { QStringLiteral("uint32_t"),   TypeUInt32 },
+        { QStringLiteral("int64_t"),    TypeInt64 },
+        { QStringLiteral("uint64_t"),   TypeUInt64 },
+        { QStringLiteral("float"),      TypeFloat },
+        { QStringLiteral("double"),     TypeDouble },
+        { QStringLiteral("bool"),       TypeBool },
+        { QStringLiteral("char"),       TypeChar },
+    };
+
+    auto iter = types.constFind(typeName);
+    if (iter == types.constEnd()) {
+        return false;
+    }
+    type = iter.value();
+    return true;
+}
+
+bool ULogReader::open(const QString& path, QString& errorMessage, const QStringList& messageNames)
+{
+    close();
+    errorMessage.clear();
+
+    _file = new QFile(path);
+    if (!_file->open(QIODevice::ReadOnly)) {
+        errorMessage = tr("Couldn't open log file: %1").arg(_file->errorString());
+        close();
+        return false;
+    }
+    _size = _file->size();
+    if (_size < _fileHeaderLen) {
+        errorMessage = tr("Could not detect ULog file header magic");
+        close();
+        return false;
+    }
+    _data = _file->map(0, _size);
+    if (!_data) {
+        errorMessage = tr("Couldn't map log file: %1").arg(_file->errorString());
+        close();
+        return false;
+    }
+    if (memcmp(_data, kULogMagic, sizeof(kULogMagic)) != 0) {
+        errorMessage = tr("Could not detect ULog file header magic");
+        close();
+        return false;
+    }
+
+    if (!_scan(messageNames, errorMessage)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ULogReader::close(void)
+{
+    // Deleting the file also unmaps it
+    delete _file;
+    _file   = nullptr;
+    _data   = nullptr;
+    _size   = 0;
+    _definitions.clear();
+    _formats.clear();
+    _subscriptions.clear();
+}
+
+bool ULogReader::_scan(const QStringList& messageNames, QString& errorMessage)
+{
+    QHash<uint16_t, bool>   indexed;        ///< Whether the data messages of a subscription are indexed
+    qint64                  index           = _fileHeaderLen;
+    qint64                  cDataMessages   = 0;
+
+    while (index + _messageHeaderLen <= _size) {
+        const uchar*    header  = _data + index;
+        quint16         msgSize = qFromLittleEndian<quint16>(header);
+        uchar           msgType = header[2];
+        const uchar*    payload = header + _messageHeaderLen;
+
+        if (index + _messageHeaderLen + msgSize > _size) {
+            // The log is cut short when logging stops abruptly, everything up to here is still good
+            qCDebug(ULogReaderLog) << "Truncated message at" << index;
+            break;
+        }
+
+        switch (msgType) {
+        case MessageFormat:
+        {
+            QString format      = QString::fromLatin1(reinterpret_cast<const char*>(payload), msgSize);
+            int     separator   = format.indexOf(':');
+            if (separator > 0) {
+                _definitions.insert(format.left(separator), format.mid(separator + 1));
+            }
+            break;
+        }
+        case MessageAddLogged:
+            if (msgSize > 3) {
+                Subscription_t subscription;
+                subscription.multiID    = payload[0];
+                subscription.msgID      = qFromLittleEndian<quint16>(payload + 1);
+                subscription.name       = QString::fromLatin1(reinterpret_cast<const char*>(payload + 3), msgSize - 3);
+                subscription.format     = nullptr;
+                _subscriptions.insert(subscription.msgID, subscription);
+                indexed.insert(subscription.msgID, messageNames.isEmpty() || messageNames.contains(subscription.name));
+            }
+            break;
+        case MessageRemoveLogged:
+            // The msg_id may be used again by a later subscription, which then replaces this one
+            break;
+        case MessageData:
+            if (msgSize >= 2) {
+                quint16 msgID = qFromLittleEndian<quint16>(payload);
+                if (indexed.value(msgID, false)) {
+                    _subscriptions[msgID].offsets.append(index);
+                    cDataMessages++;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+
+        index += _messageHeaderLen + msgSize;
+    }
+
+    // Formats may refer to formats which come after them, so they are only laid out once all of them are known
+    for (auto iter = _definitions.constBegin(); iter != _definitions.constEnd(); iter++) {
+        if (!_resolveFormat(iter.key(), 0)) {
+            qCWarning(ULogReaderLog) << "Unable to resolve format" << iter.key();
+        }
+    }
+    _definitions.clear();
+    for (Subscription_t& subscription: _subscriptions) {
+        auto iter = _formats.constFind(subscription.name);
+        subscription.format = iter != _formats.constEnd() ? &iter.value() : nullptr;
+    }
+
+    if (_formats.isEmpty()) {
+        errorMessage = tr("ULog file does not contain any message formats");
+        return false;
+    }
+
+    qCDebug(ULogReaderLog) << "Indexed formats:subscriptions:messages" << _formats.count() << _subscriptions.count() << cDataMessages;
+    return true;
+}
+
+bool ULogReader::_resolveFormat(const QString& name, int depth)
+{
+    if (_formats.contains(name)) {
+        return true;
+    }
+    auto definitionIter = _definitions.constFind(name);
+    if (definitionIter == _definitions.constEnd() || depth > _maxNesting) {
+        return false;
+    }
+
+    Format          format;
+    int             offset      = 0;
+    const QStringList fields    = definitionIter.value().split(';', QString::SkipEmptyParts);
+
+    format.name = name;
+    for (const QString& fieldDefinition: fields) {
+        // type[array] name
+        int spacePos = fieldDefinition.indexOf(' ');
+        if (spacePos == -1) {
+            continue;
+        }
+        QString typeName    = fieldDefinition.left(spacePos);
+        QString fieldName   = fieldDefinition.mid(spacePos + 1);
+        int     arraySize   = 1;
+        int     startPos    = typeName.indexOf('[');
+        int     endPos      = typeName.indexOf(']');
+        if (startPos != -1 && endPos > startPos) {
+            arraySize   = typeName.midRef(startPos + 1, endPos - startPos - 1).toInt();
+            typeName    = typeName.left(startPos);
+        }
+
+        FieldType type;
+        if (_basicType(typeName, type)) {
+            // Padding takes up space but isn't a field. It is not logged at the end of a message, which is fine
+            // since fields are only ever read up to the size of the message.
+            if (!fieldName.startsWith(QLatin1String("_padding"))) {
+                format.fields.append({ fieldName, type, offset, arraySize });
+            }
+            offset += typeSize(type) * arraySize;
+        } else {
+            if (!_resolveFormat(typeName, depth + 1)) {
+                qCWarning(ULogReaderLog) << "Unknown type" << typeName << "in format" << name;
+                return false;
+            }
+            const Format nested = _formats.value(typeName);
+            for (int i = 0; i < arraySize; i++) {
+                QString prefix = arraySize > 1 ? QStringLiteral("%1[%2].").arg(fieldName).arg(i) : fieldName + QLatin1Char('.');
+                for (const Field_t& nestedField: nested.fields) {
+                    format.fields.append({ prefix + nestedField.name, nestedField.type, offset + nestedField.offset, nestedField.arraySize });
+                }
+                offset += nested.size;
+            }
+        }
+    }
+
+    format.size = offset;
+    _formats.insert(name, format);
+    return true;
+}
+
+const ULogReader::Format* ULogReader::format(const QString& name) const
+{
+    auto iter = _formats.constFind(name);
+    return iter != _formats.constEnd() ? &iter.value() : nullptr;
+}
+
+QList<const ULogReader::Subscription_t*> ULogReader::subscriptions(const QString& name) const
+{
+    QList<const Subscription_t*> subscriptions;
+    for (const Subscription_t& subscription: _subscriptions) {
+        if (subscription.name == name) {
+            subscriptions.append(&subscription);
+        }
+    }
+    std::sort(subscriptions.begin(), subscriptions.end(), [](const Subscription_t* a, const Subscription_t* b) { return a->multiID < b->multiID; });
+    return subscriptions;
+}
+
+const ULogReader::Subscription_t* ULogReader::subscription(const QString& name, uint8_t multiID) const
+{
+    for (const Subscription_t& subscription: _subscriptions) {
+        if (subscription.name == name && subscription.multiID == multiID) {
+            return &subscription;
+        }
+    }
+    return nullptr;
+}
+
+ULogReader::Message ULogReader::message(const Subscription_t* subscription, int index) const
+{
+    if (!_data || !subscription || index < 0 || index >= subscription->offsets.count()) {
+        return Message();
+    }
+
+    // The offset points at the message header, the payload comes after the msg_id
+    const uchar*    header  = _data + subscription->offsets[index];
+    quint16         msgSize = qFromLittleEndian<quint16>(header);
+    return Message(header + _messageHeaderLen + 2, msgSize - 2);
+}
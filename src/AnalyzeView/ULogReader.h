@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ULogReaderLog)
+
+/// Reads ULog files without loading them into memory.
+///
+/// The file is memory mapped and scanned once when it is opened. The scan only looks at the message headers: it parses
+/// the formats and subscriptions and records the file offset of each data message by subscription. Messages are then
+/// read in place through Message views, so only the pages of the messages which are looked at are ever read from disk.
+class ULogReader
+{
+    Q_DECLARE_TR_FUNCTIONS(ULogReader)
+
+public:
+    ULogReader(void);
+    ~ULogReader();
+
+    enum FieldType {
+        TypeInt8,
+        TypeUInt8,
+        TypeInt16,
+        TypeUInt16,
+        TypeInt32,
+        TypeUInt32,
+        TypeInt64,
+        TypeUInt64,
+        TypeFloat,
+        TypeDouble,
+        TypeBool,
+        TypeChar,
+    };
+
+    typedef struct {
+        QString     name;           ///< Fields of nested types are named parent.child, or parent[i].child for arrays
+        FieldType   type;
+        int         offset;         ///< From the start of the message payload, after the msg_id
+        int         arraySize;      ///< 1 for fields which are not arrays
+    } Field_t;
+
+    class Format {
+    public:
+        /// @return Field with the given name, nullptr if there is none
+        const Field_t* field(const QString& name) const;
+
+        QString             name;
+        int                 size = 0;   ///< Payload size including padding
+        QVector<Field_t>    fields;     ///< Padding is left out
+    };
+
+    typedef struct {
+        QString         name;
+        uint8_t         multiID;
+        uint16_t        msgID;
+        const Format*   format;         ///< nullptr if the format is missing from the log
+        QVector<qint64> offsets;        ///< File offsets of the data messages in log order, empty if not indexed
+    } Subscription_t;
+
+    /// View of the payload of a data message in the mapped file, only valid while the reader is open
+    class Message {
+    public:
+        Message(const uchar* data = nullptr, int size = 0) : _data(data), _size(size) { }
+
+        bool            isValid (void) const { return _data != nullptr; }
+        const uchar*    payload (void) const { return _data; }
+        int             size    (void) const { return _size; }
+
+        /// Converts the stored value of the field to T
+        ///     @param index Array element
+        /// @return T() if field is nullptr or the value is past the end of the message
+        template<typename T>
+        T value(const Field_t* field, int index = 0) const;
+
+    private:
+        template<typename R>
+        R _raw(int offset) const { R r; memcpy(&r, _data + offset, sizeof(R)); return qFromLittleEndian(r); }
+
+        const uchar*    _data;
+        int             _size;
+    };
+
+    /// Maps and indexes the log
+    ///     @param messageNames Only the data messages of these topics are indexed, all of them if empty
+    /// @return true: success, false: failed, errorMessage set
+    bool open(const QString& path, QString& errorMessage, const QStringList& messageNames = QStringList());
+    void close(void);
+
+    bool isOpen(void) const { return _data != nullptr; }
+
+    /// @return Format with the given name, nullptr if there is none
+    const Format* format(const QString& name) const;
+
+    /// @return One subscription per multi instance of the topic
+    QList<const Subscription_t*> subscriptions(const QString& name) const;
+
+    /// @return Subscription to the multi instance of the topic, nullptr if there is none
+    const Subscription_t* subscription(const QString& name, uint8_t multiID = 0) const;
+
+    /// @return Data message of the subscription, an invalid Message if index is out of range
+    Message message(const Subscription_t* subscription, int index) const;
+
+    static int typeSize(FieldType type);
+
+private:
+    enum MessageType {
+        MessageFormat           = 'F',
+        MessageData             = 'D',
+        MessageInfo             = 'I',
+        MessageParameter        = 'P',
+        MessageAddLogged        = 'A',
+        MessageRemoveLogged     = 'R',
+        MessageSync             = 'S',
+        MessageDropout          = 'O',
+        MessageLogging          = 'L',
+    };
+
+    bool _scan          (const QStringList& messageNames, QString& errorMessage);
+    bool _resolveFormat (const QString& name, int depth);
+
+    static bool _basicType(const QString& typeName, FieldType& type);
+
+    QFile*                              _file           = nullptr;
+    const uchar*                        _data           = nullptr;
+    qint64                              _size           = 0;
+    QHash<QString, QString>             _definitions;              ///< Fields of each format as logged, until they are resolved
+    QHash<QString, Format>              _formats;
+    QHash<uint16_t, Subscription_t>     _subscriptions;            ///< Keyed by msg_id
+
+    static const int _fileHeaderLen     = 16;
+    static const int _messageHeaderLen  = 3;
+    static const int _maxNesting        = 8;
+};
+
+template<typename T>
+T ULogReader::Message::value(const Field_t* field, int index) const
+{
+    if (!field || index < 0 || index >= field->arraySize) {
+        return T();
+    }
+    const int size      = typeSize(field->type);
+    const int offset    = field->offset + (index * size);
+    if (!_data || offset + size > _size) {
+        return T();
+    }
+
+    switch (field->type) {
+    case TypeInt8:      return static_cast<T>(static_cast<qint8>(_data[offset]));
+    case TypeUInt8:
+    case TypeBool:
+    case TypeChar:      return static_cast<T>(_data[offset]);
+    case TypeInt16:     return static_cast<T>(_raw<qint16>(offset));
+    case TypeUInt16:    return static_cast<T>(_raw<quint16>(offset));
+    case TypeInt32:     return static_cast<T>(_raw<qint32>(offset));
+    case TypeUInt32:    return static_cast<T>(_raw<quint32>(offset));
+    case TypeInt64:     return static_cast<T>(_raw<qint64>(offset));
+    case TypeUInt64:    return static_cast<T>(_raw<quint64>(offset));
+    case TypeFloat:
+    {
+        quint32 bits = _raw<quint32>(offset);
+        float   f;
+        memcpy(&f, &bits, sizeof(f));
+        return static_cast<T>(f);
+    }
+    case TypeDouble:
+    {
+        quint64 bits = _raw<quint64>(offset);
+        double  d;
+        memcpy(&d, &bits, sizeof(d));
+        return static_cast<T>(d);
+    }
+    }
+    return T();
+}
@@ -36,7 +36,7 @@ AudioOutput::AudioOutput(QGCApplication* app, QGCToolbox* toolbox)
     connect(_tts, &QTextToSpeech::stateChanged, this, &AudioOutput::_stateChanged);
 }
 
-void AudioOutput::say(const QString& inText)
+void AudioOutput::say(const QString& inText, AudioOutput::Priority priority)
 {
     if (!_tts) {
         qDebug() << "say" << inText;
@@ -45,29 +45,93 @@ void AudioOutput::say(const QString& inText)
 
     bool muted = qgcApp()->toolbox()->settingsManager()->appSettings()->audioMuted()->rawValue().toBool();
     muted |= qgcApp()->runningUnitTests();
-    if (!muted && !qgcApp()->runningUnitTests()) {
-        QString text = fixTextMessageForAudio(inText);
-        if(_tts->state() == QTextToSpeech::Speaking) {
-            if(!_texts.contains(text)) {
-                //-- Some arbitrary limit
-                if(_texts.size() > 20) {
-                    _texts.removeFirst();
-                }
-                _texts.append(text);
-            }
+    if (muted) {
+        return;
+    }
+
+    if (_tts->state() == QTextToSpeech::Speaking) {
+        if (priority == PriorityCritical && _speakingPriority < PriorityCritical) {
+            // Cut off the chatter, _stateChanged picks this up next once the engine is ready again
+            _enqueue(inText, priority);
+            _tts->stop();
         } else {
-            _tts->say(text);
+            _enqueue(inText, priority);
+        }
+    } else {
+        _speakingPriority = priority;
+        _tts->say(fixTextMessageForAudio(inText));
+    }
+}
+
+int AudioOutput::_maxQueueAgeMSecs(Priority priority)
+{
+    switch (priority) {
+    case PriorityLow:
+        return 5000;
+    case PriorityNormal:
+        return 10000;
+    case PriorityHigh:
+        return 20000;
+    case PriorityCritical:
+        break;
+    }
+    return 60000;
+}
+
+void AudioOutput::_enqueue(const QString& text, Priority priority)
+{
+    for (int i=0; i<_queue.count(); i++) {
+        if (_queue[i].text == text) {
+            if (_queue[i].priority >= priority) {
+                return;
+            }
+            // Same phrase asked for with a higher priority, move it up
+            _queue.removeAt(i);
+            break;
         }
     }
+
+    QueuedText_t queuedText;
+    queuedText.text     = text;
+    queuedText.priority = priority;
+    queuedText.queued.start();
+
+    // After everything of the same or higher priority
+    int index = 0;
+    while (index < _queue.count() && _queue[index].priority >= priority) {
+        index++;
+    }
+    _queue.insert(index, queuedText);
+
+    //-- Some arbitrary limit, the newest of the lowest priority goes
+    if (_queue.count() > _maxQueueLength) {
+        _queue.removeLast();
+    }
+}
+
+bool AudioOutput::_dequeue(QString& text, Priority& priority)
+{
+    while (!_queue.isEmpty()) {
+        QueuedText_t queuedText = _queue.takeFirst();
+        if (queuedText.queued.elapsed() > _maxQueueAgeMSecs(queuedText.priority)) {
+            qDebug() << "AudioOutput dropping stale" << queuedText.text;
+            continue;
+        }
+        text        = queuedText.text;
+        priority    = queuedText.priority;
+        return true;
+    }
+    return false;
 }
 
 void AudioOutput::_stateChanged(QTextToSpeech::State state)
 {
     if(state == QTextToSpeech::Ready) {
-        if(_texts.size()) {
-            QString text = _texts.first();
-            _texts.removeFirst();
-            _tts->say(text);
+        QString     text;
+        Priority    priority;
+        if (_dequeue(text, priority)) {
+            _speakingPriority = priority;
+            _tts->say(fixTextMessageForAudio(text));
         }
     }
 }
@@ -146,37 +210,39 @@ QString AudioOutput::fixTextMessageForAudio(const QString& string) {
         result.replace("PITOT", "pee toe", Qt::CaseInsensitive);
     }
 
+    // Patterns are compiled once, not for every message
+    static const QRegularExpression negativeRe  (QStringLiteral("(-)[0-9]*\\.?[0-9]"));
+    static const QRegularExpression decimalRe   (QStringLiteral("([0-9]+)(\\.)([0-9]+)"));
+    static const QRegularExpression meterRe     (QStringLiteral("[0-9]*\\.?[0-9]\\s?(m)([^A-Za-z]|$)"));
+
     // Convert negative numbers
-    QRegularExpression re(QStringLiteral("(-)[0-9]*\\.?[0-9]"));
-    QRegularExpressionMatch reMatch = re.match(result);
+    QRegularExpressionMatch reMatch = negativeRe.match(result);
     while (reMatch.hasMatch()) {
         if (!reMatch.captured(1).isNull()) {
             // There is a negative prefix
             result.replace(reMatch.capturedStart(1), reMatch.capturedEnd(1) - reMatch.capturedStart(1), tr(" negative "));
         }
-        reMatch = re.match(result);
+        reMatch = negativeRe.match(result, reMatch.capturedStart(1));
     }
 
     // Convert real number with decimal point
-    re.setPattern(QStringLiteral("([0-9]+)(\\.)([0-9]+)"));
-    reMatch = re.match(result);
+    reMatch = decimalRe.match(result);
     while (reMatch.hasMatch()) {
         if (!reMatch.captured(2).isNull()) {
             // There is a decimal point
             result.replace(reMatch.capturedStart(2), reMatch.capturedEnd(2) - reMatch.capturedStart(2), tr(" point "));
         }
-        reMatch = re.match(result);
+        reMatch = decimalRe.match(result, reMatch.capturedStart(2));
     }
 
     // Convert meter postfix after real number
-    re.setPattern(QStringLiteral("[0-9]*\\.?[0-9]\\s?(m)([^A-Za-z]|$)"));
-    reMatch = re.match(result);
+    reMatch = meterRe.match(result);
     while (reMatch.hasMatch()) {
         if (!reMatch.captured(1).isNull()) {
             // There is a meter postfix
             result.replace(reMatch.capturedStart(1), reMatch.capturedEnd(1) - reMatch.capturedStart(1), tr(" meters"));
         }
-        reMatch = re.match(result);
+        reMatch = meterRe.match(result, reMatch.capturedStart(1));
     }
 
     int number;
@@ -14,30 +14,60 @@
 #include <QThread>
 #include <QStringList>
 #include <QTextToSpeech>
+#include <QElapsedTimer>
+#include <QList>
 
 #include "QGCToolbox.h"
 
 class QGCApplication;
+class AudioOutputTest;
 
 /// Text to Speech Interface
+///
+/// Text waiting to be spoken is queued by priority, oldest first within a priority. A phrase which is already waiting
+/// isn't queued again, and anything which waited longer than its priority allows is dropped rather than spoken late.
+/// A critical phrase cuts off whatever lower priority phrase is being spoken.
 class AudioOutput : public QGCTool
 {
     Q_OBJECT
 public:
     AudioOutput(QGCApplication* app, QGCToolbox* toolbox);
 
+    enum Priority {
+        PriorityLow,        ///< Informational chatter
+        PriorityNormal,
+        PriorityHigh,       ///< Warnings
+        PriorityCritical,   ///< Failsafes and the like, interrupts anything else
+    };
+    Q_ENUM(Priority)
+
     static bool     getMillisecondString    (const QString& string, QString& match, int& number);
     static QString  fixTextMessageForAudio  (const QString& string);
 
 public slots:
     /// Convert string to speech output and say it
-    void            say                     (const QString& text);
+    void            say                     (const QString& text, AudioOutput::Priority priority = PriorityNormal);
 
 private slots:
     void            _stateChanged           (QTextToSpeech::State state);
 
 protected:
-    QTextToSpeech*  _tts;
-    QStringList     _texts;
+    typedef struct {
+        QString         text;               ///< As given to say, converted for speech only when it is spoken
+        Priority        priority;
+        QElapsedTimer   queued;
+    } QueuedText_t;
+
+    void            _enqueue                (const QString& text, Priority priority);
+    bool            _dequeue                (QString& text, Priority& priority);
+    static int      _maxQueueAgeMSecs       (Priority priority);
+
+    QTextToSpeech*      _tts;
+    QList<QueuedText_t> _queue;                             ///< Highest priority first
+    Priority            _speakingPriority   = PriorityLow;
+
+    static const int _maxQueueLength = 20;
+
+    friend class AudioOutputTest;
 };
 
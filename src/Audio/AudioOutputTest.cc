@@ -9,6 +9,7 @@
 
 #include "AudioOutputTest.h"
 #include "AudioOutput.h"
+#include "QGCApplication.h"
 
 AudioOutputTest::AudioOutputTest(void)
 {
@@ -30,3 +31,37 @@ void AudioOutputTest::_testSpokenReplacements(void)
     result = AudioOutput::fixTextMessageForAudio(QStringLiteral("10moo"));
     QCOMPARE(result, QStringLiteral("10moo"));
 }
+
+void AudioOutputTest::_testQueuePriority(void)
+{
+    AudioOutput* audioOutput = qgcApp()->toolbox()->audioOutput();
+    audioOutput->_queue.clear();
+
+    audioOutput->_enqueue(QStringLiteral("low"),        AudioOutput::PriorityLow);
+    audioOutput->_enqueue(QStringLiteral("normal"),     AudioOutput::PriorityNormal);
+    audioOutput->_enqueue(QStringLiteral("normal"),     AudioOutput::PriorityNormal);   // Already waiting
+    audioOutput->_enqueue(QStringLiteral("critical"),   AudioOutput::PriorityCritical);
+    audioOutput->_enqueue(QStringLiteral("low"),        AudioOutput::PriorityHigh);     // Moves up
+    QCOMPARE(audioOutput->_queue.count(), 3);
+
+    QString                 text;
+    AudioOutput::Priority   priority;
+    QVERIFY(audioOutput->_dequeue(text, priority));
+    QCOMPARE(text, QStringLiteral("critical"));
+    QCOMPARE(priority, AudioOutput::PriorityCritical);
+    QVERIFY(audioOutput->_dequeue(text, priority));
+    QCOMPARE(text, QStringLiteral("low"));
+    QCOMPARE(priority, AudioOutput::PriorityHigh);
+    QVERIFY(audioOutput->_dequeue(text, priority));
+    QCOMPARE(text, QStringLiteral("normal"));
+    QVERIFY(!audioOutput->_dequeue(text, priority));
+
+    // Queue is bounded, the lowest priority goes first
+    for (int i=0; i<AudioOutput::_maxQueueLength; i++) {
+        audioOutput->_enqueue(QStringLiteral("chatter %1").arg(i), AudioOutput::PriorityLow);
+    }
+    audioOutput->_enqueue(QStringLiteral("failsafe"), AudioOutput::PriorityCritical);
+    QCOMPARE(audioOutput->_queue.count(), AudioOutput::_maxQueueLength);
+    QCOMPARE(audioOutput->_queue.first().text, QStringLiteral("failsafe"));
+    audioOutput->_queue.clear();
+}
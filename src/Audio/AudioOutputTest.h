@@ -20,4 +20,5 @@ public:
 
 private slots:
     void _testSpokenReplacements(void);
+    void _testQueuePriority(void);
 };
@@ -12,6 +12,8 @@
 #include "AutoPilotPlugin.h"
 #include "ParameterManager.h"
 
+#include <QtMath>
+
 QGC_LOGGING_CATEGORY(APMCompassCalLog, "APMCompassCalLog")
 
 const float CalWorkerThread::mag_sphere_radius = 0.2f;
@@ -19,6 +21,97 @@ const unsigned int CalWorkerThread::calibration_sides = 6;
 const unsigned int CalWorkerThread::calibration_total_points = 240;
 const unsigned int CalWorkerThread::calibraton_duration_seconds = CalWorkerThread::calibration_sides * 10;
 
+void SphereFitAccumulator::reset(void)
+{
+    for (int row=0; row<_n; row++) {
+        for (int col=0; col<_n; col++) {
+            _ata[row][col] = 0;
+        }
+        _atb[row] = 0;
+    }
+    _count = 0;
+}
+
+void SphereFitAccumulator::addSample(float x, float y, float z)
+{
+    const double row[_n] = { x, y, z, 1.0 };
+    const double b = row[0] * row[0] + row[1] * row[1] + row[2] * row[2];
+
+    // Only the upper triangle is accumulated, solve mirrors it
+    for (int i=0; i<_n; i++) {
+        for (int j=i; j<_n; j++) {
+            _ata[i][j] += row[i] * row[j];
+        }
+        _atb[i] += row[i] * b;
+    }
+    _count++;
+}
+
+bool SphereFitAccumulator::solve(float* sphere_x, float* sphere_y, float* sphere_z, float* sphere_radius) const
+{
+    if (_count < _n) {
+        return false;
+    }
+
+    double m[_n][_n + 1];
+    for (int i=0; i<_n; i++) {
+        for (int j=0; j<_n; j++) {
+            m[i][j] = j >= i ? _ata[i][j] : _ata[j][i];
+        }
+        m[i][_n] = _atb[i];
+    }
+
+    // Gaussian elimination with partial pivoting. A pivot which is tiny compared to the diagonal it came from means
+    // the samples are degenerate in that direction.
+    for (int col=0; col<_n; col++) {
+        int pivot = col;
+        for (int row=col+1; row<_n; row++) {
+            if (qAbs(m[row][col]) > qAbs(m[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (qAbs(m[pivot][col]) <= 1e-9 * qMax(qAbs(_ata[col][col]), 1.0)) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int j=col; j<=_n; j++) {
+                qSwap(m[col][j], m[pivot][j]);
+            }
+        }
+        for (int row=col+1; row<_n; row++) {
+            const double factor = m[row][col] / m[col][col];
+            for (int j=col; j<=_n; j++) {
+                m[row][j] -= factor * m[col][j];
+            }
+        }
+    }
+
+    double u[_n];
+    for (int row=_n-1; row>=0; row--) {
+        double sum = m[row][_n];
+        for (int j=row+1; j<_n; j++) {
+            sum -= m[row][j] * u[j];
+        }
+        u[row] = sum / m[row][row];
+    }
+
+    // u = [ 2*cx, 2*cy, 2*cz, r^2 - |c|^2 ]
+    const double cx = u[0] / 2.0;
+    const double cy = u[1] / 2.0;
+    const double cz = u[2] / 2.0;
+    const double rsq = u[3] + cx * cx + cy * cy + cz * cz;
+    if (rsq <= 0) {
+        return false;
+    }
+
+    *sphere_x       = static_cast<float>(cx);
+    *sphere_y       = static_cast<float>(cy);
+    *sphere_z       = static_cast<float>(cz);
+    *sphere_radius  = static_cast<float>(qSqrt(rsq));
+
+    return true;
+}
+
 const char* CalWorkerThread::rgCompassParams[3][4] = {
     { "COMPASS_OFS_X", "COMPASS_OFS_Y", "COMPASS_OFS_Z", "COMPASS_DEV_ID" },
     { "COMPASS_OFS2_X", "COMPASS_OFS2_Y", "COMPASS_OFS2_Z", "COMPASS_DEV_ID2" },
@@ -72,32 +165,12 @@ CalWorkerThread::calibrate_return CalWorkerThread::calibrate(void)
     worker_data.side_data_collected[DETECT_ORIENTATION_RIGHT] =         false;
 
     for (size_t cur_mag=0; cur_mag<max_mags; cur_mag++) {
-        // Initialize to no memory allocated
-        worker_data.x[cur_mag] = nullptr;
-        worker_data.y[cur_mag] = nullptr;
-        worker_data.z[cur_mag] = nullptr;
         worker_data.calibration_counter_total[cur_mag] = 0;
     }
 
-    const unsigned int calibration_points_maxcount = calibration_sides * worker_data.calibration_points_perside;
-
-    for (size_t cur_mag=0; cur_mag<max_mags; cur_mag++) {
-        if (rgCompassAvailable[cur_mag]) {
-            worker_data.x[cur_mag] = reinterpret_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
-            worker_data.y[cur_mag] = reinterpret_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
-            worker_data.z[cur_mag] = reinterpret_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
-            if (worker_data.x[cur_mag] == nullptr || worker_data.y[cur_mag] == nullptr || worker_data.z[cur_mag] == nullptr) {
-                _emitVehicleTextMessage(QStringLiteral("[cal] ERROR: out of memory"));
-                result = calibrate_return_error;
-            }
-        }
-    }
-
-    if (result == calibrate_return_ok) {
-        result = calibrate_from_orientation(
-                    worker_data.side_data_collected,    // Sides to calibrate
-                    &worker_data);                      // Opaque data for calibration worked
-    }
+    result = calibrate_from_orientation(
+                worker_data.side_data_collected,    // Sides to calibrate
+                &worker_data);                      // Opaque data for calibration worked
 
     // Calculate calibration values for each mag
 
@@ -110,27 +183,14 @@ CalWorkerThread::calibrate_return CalWorkerThread::calibrate(void)
     if (result == calibrate_return_ok) {
         for (unsigned cur_mag=0; cur_mag<max_mags; cur_mag++) {
             if (rgCompassAvailable[cur_mag]) {
-                sphere_fit_least_squares(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
-                                         worker_data.calibration_counter_total[cur_mag],
-                                         100, 0.0f,
-                                         &sphere_x[cur_mag], &sphere_y[cur_mag], &sphere_z[cur_mag],
-                                         &sphere_radius[cur_mag]);
-
-                if (qIsNaN(sphere_x[cur_mag]) || qIsNaN(sphere_y[cur_mag]) || qIsNaN(sphere_z[cur_mag])) {
-                    _emitVehicleTextMessage(QStringLiteral("[cal] ERROR: NaN in sphere fit for mag %1").arg(cur_mag));
+                if (!worker_data.fit[cur_mag].solve(&sphere_x[cur_mag], &sphere_y[cur_mag], &sphere_z[cur_mag], &sphere_radius[cur_mag])) {
+                    _emitVehicleTextMessage(QStringLiteral("[cal] ERROR: sphere fit failed for mag %1").arg(cur_mag));
                     result = calibrate_return_error;
                 }
             }
         }
     }
 
-    // Data points are no longer needed
-    for (size_t cur_mag=0; cur_mag<max_mags; cur_mag++) {
-        free(worker_data.x[cur_mag]);
-        free(worker_data.y[cur_mag]);
-        free(worker_data.z[cur_mag]);
-    }
-
     if (result == calibrate_return_ok) {
         for (unsigned cur_mag=0; cur_mag<max_mags; cur_mag++) {
             if (rgCompassAvailable[cur_mag]) {
@@ -189,9 +249,7 @@ CalWorkerThread::calibrate_return CalWorkerThread::mag_calibration_worker(detect
             mavlink_scaled_imu_t copyLastScaledImu = rgLastScaledImu[cur_mag];
             lastScaledImuMutex.unlock();
 
-            worker_data->x[cur_mag][worker_data->calibration_counter_total[cur_mag]] = copyLastScaledImu.xmag;
-            worker_data->y[cur_mag][worker_data->calibration_counter_total[cur_mag]] = copyLastScaledImu.ymag;
-            worker_data->z[cur_mag][worker_data->calibration_counter_total[cur_mag]] = copyLastScaledImu.zmag;
+            worker_data->fit[cur_mag].addSample(copyLastScaledImu.xmag, copyLastScaledImu.ymag, copyLastScaledImu.zmag);
             worker_data->calibration_counter_total[cur_mag]++;
         }
 
@@ -209,6 +267,14 @@ CalWorkerThread::calibrate_return CalWorkerThread::mag_calibration_worker(detect
 
         worker_data->done_count++;
         _emitVehicleTextMessage(QStringLiteral("[cal] progress <%1>").arg(progress_percentage(worker_data)));
+
+        // The fit is cheap to solve at any point, so show how the offsets are settling as sides come in
+        for (unsigned cur_mag=0; cur_mag<max_mags; cur_mag++) {
+            float sphere_x, sphere_y, sphere_z, sphere_radius;
+            if (rgCompassAvailable[cur_mag] && worker_data->fit[cur_mag].solve(&sphere_x, &sphere_y, &sphere_z, &sphere_radius)) {
+                _emitVehicleTextMessage(QStringLiteral("[cal] mag #%1 current fit off: x:%2 y:%3 z:%4 radius:%5").arg(cur_mag).arg(-sphere_x).arg(-sphere_y).arg(-sphere_z).arg(sphere_radius));
+            }
+        }
     }
 
     return result;
@@ -382,184 +448,6 @@ const char* CalWorkerThread::detect_orientation_str(enum detect_orientation_retu
     return rgOrientationStrs[orientation];
 }
 
-int CalWorkerThread::sphere_fit_least_squares(const float x[], const float y[], const float z[],
-                                              unsigned int size, unsigned int max_iterations, float delta, float *sphere_x, float *sphere_y, float *sphere_z,
-                                              float *sphere_radius)
-{
-
-    float x_sumplain = 0.0f;
-    float x_sumsq = 0.0f;
-    float x_sumcube = 0.0f;
-
-    float y_sumplain = 0.0f;
-    float y_sumsq = 0.0f;
-    float y_sumcube = 0.0f;
-
-    float z_sumplain = 0.0f;
-    float z_sumsq = 0.0f;
-    float z_sumcube = 0.0f;
-
-    float xy_sum = 0.0f;
-    float xz_sum = 0.0f;
-    float yz_sum = 0.0f;
-
-    float x2y_sum = 0.0f;
-    float x2z_sum = 0.0f;
-    float y2x_sum = 0.0f;
-    float y2z_sum = 0.0f;
-    float z2x_sum = 0.0f;
-    float z2y_sum = 0.0f;
-
-    for (unsigned int i = 0; i < size; i++) {
-
-        float x2 = x[i] * x[i];
-        float y2 = y[i] * y[i];
-        float z2 = z[i] * z[i];
-
-        x_sumplain += x[i];
-        x_sumsq += x2;
-        x_sumcube += x2 * x[i];
-
-        y_sumplain += y[i];
-        y_sumsq += y2;
-        y_sumcube += y2 * y[i];
-
-        z_sumplain += z[i];
-        z_sumsq += z2;
-        z_sumcube += z2 * z[i];
-
-        xy_sum += x[i] * y[i];
-        xz_sum += x[i] * z[i];
-        yz_sum += y[i] * z[i];
-
-        x2y_sum += x2 * y[i];
-        x2z_sum += x2 * z[i];
-
-        y2x_sum += y2 * x[i];
-        y2z_sum += y2 * z[i];
-
-        z2x_sum += z2 * x[i];
-        z2y_sum += z2 * y[i];
-    }
-
-    //
-    //Least Squares Fit a sphere A,B,C with radius squared Rsq to 3D data
-    //
-    //    P is a structure that has been computed with the data earlier.
-    //    P.npoints is the number of elements; the length of X,Y,Z are identical.
-    //    P's members are logically named.
-    //
-    //    X[n] is the x component of point n
-    //    Y[n] is the y component of point n
-    //    Z[n] is the z component of point n
-    //
-    //    A is the x coordiante of the sphere
-    //    B is the y coordiante of the sphere
-    //    C is the z coordiante of the sphere
-    //    Rsq is the radius squared of the sphere.
-    //
-    //This method should converge; maybe 5-100 iterations or more.
-    //
-    float x_sum = x_sumplain / size;        //sum( X[n] )
-    float x_sum2 = x_sumsq / size;    //sum( X[n]^2 )
-    float x_sum3 = x_sumcube / size;    //sum( X[n]^3 )
-    float y_sum = y_sumplain / size;        //sum( Y[n] )
-    float y_sum2 = y_sumsq / size;    //sum( Y[n]^2 )
-    float y_sum3 = y_sumcube / size;    //sum( Y[n]^3 )
-    float z_sum = z_sumplain / size;        //sum( Z[n] )
-    float z_sum2 = z_sumsq / size;    //sum( Z[n]^2 )
-    float z_sum3 = z_sumcube / size;    //sum( Z[n]^3 )
-
-    float XY = xy_sum / size;        //sum( X[n] * Y[n] )
-    float XZ = xz_sum / size;        //sum( X[n] * Z[n] )
-    float YZ = yz_sum / size;        //sum( Y[n] * Z[n] )
-    float X2Y = x2y_sum / size;    //sum( X[n]^2 * Y[n] )
-    float X2Z = x2z_sum / size;    //sum( X[n]^2 * Z[n] )
-    float Y2X = y2x_sum / size;    //sum( Y[n]^2 * X[n] )
-    float Y2Z = y2z_sum / size;    //sum( Y[n]^2 * Z[n] )
-    float Z2X = z2x_sum / size;    //sum( Z[n]^2 * X[n] )
-    float Z2Y = z2y_sum / size;    //sum( Z[n]^2 * Y[n] )
-
-    //Reduction of multiplications
-    float F0 = x_sum2 + y_sum2 + z_sum2;
-    float F1 =  0.5f * F0;
-    float F2 = -8.0f * (x_sum3 + Y2X + Z2X);
-    float F3 = -8.0f * (X2Y + y_sum3 + Z2Y);
-    float F4 = -8.0f * (X2Z + Y2Z + z_sum3);
-
-    //Set initial conditions:
-    float A = x_sum;
-    float B = y_sum;
-    float C = z_sum;
-
-    //First iteration computation:
-    float A2 = A * A;
-    float B2 = B * B;
-    float C2 = C * C;
-    float QS = A2 + B2 + C2;
-    float QB = -2.0f * (A * x_sum + B * y_sum + C * z_sum);
-
-    //Set initial conditions:
-    float Rsq = F0 + QB + QS;
-
-    //First iteration computation:
-    float Q0 = 0.5f * (QS - Rsq);
-    float Q1 = F1 + Q0;
-    float Q2 = 8.0f * (QS - Rsq + QB + F0);
-    float aA, aB, aC, nA, nB, nC, dA, dB, dC;
-
-    //Iterate N times, ignore stop condition.
-    unsigned int n = 0;
-
-#undef  FLT_EPSILON
-#define FLT_EPSILON 1.1920929e-07F  /* 1E-5 */
-
-    while (n < max_iterations) {
-        n++;
-
-        //Compute denominator:
-        aA = Q2 + 16.0f * (A2 - 2.0f * A * x_sum + x_sum2);
-        aB = Q2 + 16.0f * (B2 - 2.0f * B * y_sum + y_sum2);
-        aC = Q2 + 16.0f * (C2 - 2.0f * C * z_sum + z_sum2);
-        aA = (fabsf(aA) < FLT_EPSILON) ? 1.0f : aA;
-        aB = (fabsf(aB) < FLT_EPSILON) ? 1.0f : aB;
-        aC = (fabsf(aC) < FLT_EPSILON) ? 1.0f : aC;
-
-        //Compute next iteration
-        nA = A - ((F2 + 16.0f * (B * XY + C * XZ + x_sum * (-A2 - Q0) + A * (x_sum2 + Q1 - C * z_sum - B * y_sum))) / aA);
-        nB = B - ((F3 + 16.0f * (A * XY + C * YZ + y_sum * (-B2 - Q0) + B * (y_sum2 + Q1 - A * x_sum - C * z_sum))) / aB);
-        nC = C - ((F4 + 16.0f * (A * XZ + B * YZ + z_sum * (-C2 - Q0) + C * (z_sum2 + Q1 - A * x_sum - B * y_sum))) / aC);
-
-        //Check for stop condition
-        dA = (nA - A);
-        dB = (nB - B);
-        dC = (nC - C);
-
-        if ((dA * dA + dB * dB + dC * dC) <= delta) { break; }
-
-        //Compute next iteration's values
-        A = nA;
-        B = nB;
-        C = nC;
-        A2 = A * A;
-        B2 = B * B;
-        C2 = C * C;
-        QS = A2 + B2 + C2;
-        QB = -2.0f * (A * x_sum + B * y_sum + C * z_sum);
-        Rsq = F0 + QB + QS;
-        Q0 = 0.5f * (QS - Rsq);
-        Q1 = F1 + Q0;
-        Q2 = 8.0f * (QS - Rsq + QB + F0);
-    }
-
-    *sphere_x = A;
-    *sphere_y = B;
-    *sphere_z = C;
-    *sphere_radius = sqrtf(Rsq);
-
-    return 0;
-}
-
 APMCompassCal::APMCompassCal(void)
     : _vehicle(nullptr)
     , _calWorkerThread(nullptr)
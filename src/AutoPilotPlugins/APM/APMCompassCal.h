@@ -21,6 +21,33 @@
 
 Q_DECLARE_LOGGING_CATEGORY(APMCompassCalLog)
 
+/// Linear least-squares sphere fit which is updated one sample at a time.
+///
+/// A point on the sphere satisfies x^2+y^2+z^2 = 2*cx*x + 2*cy*y + 2*cz*z + (r^2 - |c|^2), which is linear in the
+/// unknowns. Each sample adds to the 4x4 normal equations of that system, so adding a sample and solving both take
+/// constant time and no samples have to be kept around.
+class SphereFitAccumulator
+{
+public:
+    SphereFitAccumulator(void) { reset(); }
+
+    void reset(void);
+    void addSample(float x, float y, float z);
+
+    unsigned count(void) const { return _count; }
+
+    /// Solves the normal equations for the samples so far
+    ///     @return false: not enough samples or the samples don't span a sphere yet (for example all in one plane)
+    bool solve(float* sphere_x, float* sphere_y, float* sphere_z, float* sphere_radius) const;
+
+private:
+    static const int _n = 4;
+
+    double      _ata[_n][_n];   ///< Sum of row * row^T, row = [ x y z 1 ]
+    double      _atb[_n];       ///< Sum of row * (x^2 + y^2 + z^2)
+    unsigned    _count;
+};
+
 class CalWorkerThread : public QThread
 {
     Q_OBJECT
@@ -77,9 +104,7 @@ private:
         uint64_t        calibration_interval_perside_useconds;
         unsigned int	calibration_counter_total[max_mags];
         bool            side_data_collected[detect_orientation_side_count];
-        float*          x[max_mags];
-        float*          y[max_mags];
-        float*          z[max_mags];
+        SphereFitAccumulator fit[max_mags];
     } mag_worker_data_t;
 
     enum calibrate_return {
@@ -88,28 +113,6 @@ private:
         calibrate_return_cancelled
     };
 
-    /**
-     * Least-squares fit of a sphere to a set of points.
-     *
-     * Fits a sphere to a set of points on the sphere surface.
-     *
-     * @param x point coordinates on the X axis
-     * @param y point coordinates on the Y axis
-     * @param z point coordinates on the Z axis
-     * @param size number of points
-     * @param max_iterations abort if maximum number of iterations have been reached. If unsure, set to 100.
-     * @param delta abort if error is below delta. If unsure, set to 0 to run max_iterations times.
-     * @param sphere_x coordinate of the sphere center on the X axis
-     * @param sphere_y coordinate of the sphere center on the Y axis
-     * @param sphere_z coordinate of the sphere center on the Z axis
-     * @param sphere_radius sphere radius
-     *
-     * @return 0 on success, 1 on failure
-     */
-    int sphere_fit_least_squares(const float x[], const float y[], const float z[],
-                     unsigned int size, unsigned int max_iterations, float delta, float *sphere_x, float *sphere_y, float *sphere_z,
-                     float *sphere_radius);
-
     /// Wait for vehicle to become still and detect it's orientation
     ///	@return Returns detect_orientation_return according to orientation of still vehicle
     enum detect_orientation_return detect_orientation(void);
@@ -25,6 +25,8 @@ APMRadioComponent::APMRadioComponent(Vehicle* vehicle, AutoPilotPlugin* autopilo
     }
 
     _connectSetupTriggers();
+
+    connect(_vehicle->parameterManager(), &ParameterManager::parameterUpdateComplete, this, &APMRadioComponent::_parameterUpdateComplete);
 }
 
 QString APMRadioComponent::name(void) const
@@ -122,8 +124,22 @@ void APMRadioComponent::_connectSetupTriggers(void)
     }
 }
 
+void APMRadioComponent::_parameterUpdateComplete(void)
+{
+    if (_triggerChangePending) {
+        _triggerChangePending = false;
+        _triggerChanged();
+    }
+}
+
 void APMRadioComponent::_triggerChanged(void)
 {
+    if (_vehicle->parameterManager()->parameterUpdateInProgress()) {
+        // Reconnecting the triggers for every parameter of a refresh isn't needed, once at the end does it
+        _triggerChangePending = true;
+        return;
+    }
+
     emit setupCompleteChanged(setupComplete());
 
     // Control mapping may have changed so we need to reset triggers
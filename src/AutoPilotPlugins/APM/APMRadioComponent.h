@@ -34,7 +34,8 @@ public:
     QUrl summaryQmlSource(void) const final;
 
 private slots:
-    void _triggerChanged(void);
+    void _triggerChanged            (void);
+    void _parameterUpdateComplete   (void);
     
 private:
     void _connectSetupTriggers(void);
@@ -42,6 +43,7 @@ private:
     const QString   _name;
     QStringList     _mapParams;
     QList<Fact*>    _triggerFacts;
+    bool            _triggerChangePending = false;  ///< true: a trigger changed during a parameter update batch
 };
 
 #endif
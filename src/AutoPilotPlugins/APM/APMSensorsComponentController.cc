@@ -521,7 +521,7 @@ void APMSensorsComponentController::_handleMagCalProgress(mavlink_message_t& mes
         mavlink_mag_cal_progress_t magCalProgress;
         mavlink_msg_mag_cal_progress_decode(&message, &magCalProgress);
 
-        qCDebug(APMSensorsComponentControllerVerboseLog) << "_handleMagCalProgress id:mask:pct"
+        qCVerbose(APMSensorsComponentControllerVerboseLog) << "_handleMagCalProgress id:mask:pct"
                                                          << magCalProgress.compass_id << magCalProgress.cal_mask << magCalProgress.completion_pct;
 
         // How many compasses are we calibrating?
@@ -549,7 +549,7 @@ void APMSensorsComponentController::_handleMagCalReport(mavlink_message_t& messa
         mavlink_mag_cal_report_t magCalReport;
         mavlink_msg_mag_cal_report_decode(&message, &magCalReport);
 
-        qCDebug(APMSensorsComponentControllerVerboseLog) << "_handleMagCalReport id:mask:status:fitness"
+        qCVerbose(APMSensorsComponentControllerVerboseLog) << "_handleMagCalReport id:mask:status:fitness"
                                                          << magCalReport.compass_id << magCalReport.cal_mask << magCalReport.cal_status << magCalReport.fitness;
 
         bool additionalCompassCompleted = false;
@@ -95,7 +95,11 @@ RadioComponentController::RadioComponentController(void)
         _revParamIsBool = false;    // paeram value if -1 indicates reversed
     }
 
+    // The calibration needs every RC_CHANNELS message, the displays only need to keep up with the screen
     connect(_vehicle, &Vehicle::rcChannelsChanged, this, &RadioComponentController::_rcChannelsChanged);
+    _displayUpdateTimer.setInterval(_displayUpdateMSecs);
+    connect(&_displayUpdateTimer, &QTimer::timeout, this, &RadioComponentController::_updateChannelDisplays);
+    _displayUpdateTimer.start();
     _loadSettings();
 
     _resetInternalCalibrationValues();
@@ -229,31 +233,9 @@ void RadioComponentController::_rcChannelsChanged(int channelCount, int pwmValue
         int channelValue = pwmValues[channel];
 
         if (channelValue != -1) {
-            qCDebug(RadioComponentControllerVerboseLog) << "Raw value" << channel << channelValue;
+            qCVerbose(RadioComponentControllerVerboseLog) << "Raw value" << channel << channelValue;
 
             _rcRawValue[channel] = channelValue;
-            emit channelRCValueChanged(channel, channelValue);
-
-            // Signal attitude rc values to Qml if mapped
-            if (_rgChannelInfo[channel].function != rcCalFunctionMax) {
-                switch (_rgChannelInfo[channel].function) {
-                case rcCalFunctionRoll:
-                    emit rollChannelRCValueChanged(channelValue);
-                    break;
-                case rcCalFunctionPitch:
-                    emit pitchChannelRCValueChanged(channelValue);
-                    break;
-                case rcCalFunctionYaw:
-                    emit yawChannelRCValueChanged(channelValue);
-                    break;
-                case rcCalFunctionThrottle:
-                    emit throttleChannelRCValueChanged(channelValue);
-                    break;
-                default:
-                    break;
-
-                }
-            }
 
             if (_currentStep == -1) {
                 if (_chanCount != channelCount) {
@@ -274,6 +256,47 @@ void RadioComponentController::_rcChannelsChanged(int channelCount, int pwmValue
     }
 }
 
+/// Signals the channel values which changed since the last update to Qml
+void RadioComponentController::_updateChannelDisplays(void)
+{
+    const Vehicle::RcChannels_t& rcChannels = _vehicle->rcChannels();
+
+    if (rcChannels.sequence == _rcChannelsSequence) {
+        return;
+    }
+
+    quint32 changedMask = _vehicle->rcChannelsChangedMask(_rcChannelsSequence);
+    _rcChannelsSequence = rcChannels.sequence;
+
+    for (int channel=0; channel<qMin(rcChannels.channelCount, _chanMax); channel++) {
+        int channelValue = rcChannels.pwmValues[channel];
+
+        if (!(changedMask & (1 << channel)) || channelValue == -1) {
+            continue;
+        }
+
+        emit channelRCValueChanged(channel, channelValue);
+
+        // Signal attitude rc values to Qml if mapped
+        switch (_rgChannelInfo[channel].function) {
+        case rcCalFunctionRoll:
+            emit rollChannelRCValueChanged(channelValue);
+            break;
+        case rcCalFunctionPitch:
+            emit pitchChannelRCValueChanged(channelValue);
+            break;
+        case rcCalFunctionYaw:
+            emit yawChannelRCValueChanged(channelValue);
+            break;
+        case rcCalFunctionThrottle:
+            emit throttleChannelRCValueChanged(channelValue);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 void RadioComponentController::nextButtonClicked(void)
 {
     if (_currentStep == -1) {
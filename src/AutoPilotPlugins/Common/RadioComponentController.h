@@ -140,7 +140,8 @@ signals:
     void throttleReversedCalFailure(void);
 
 private slots:
-    void _rcChannelsChanged(int channelCount, int pwmValues[Vehicle::cMaxRcChannels]);
+    void _rcChannelsChanged     (int channelCount, int pwmValues[Vehicle::cMaxRcChannels]);
+    void _updateChannelDisplays (void);
 
 private:
     /// @brief These identify the various controls functions. They are also used as indices into the _rgFunctioInfo
@@ -300,6 +301,11 @@ private:
 
     int _rcRawValue[_chanMax];         ///< Current set of raw channel values
 
+    quint32 _rcChannelsSequence = 0;    ///< Vehicle::RcChannels_t::sequence last shown by the channel displays
+    QTimer  _displayUpdateTimer;
+
+    static const int _displayUpdateMSecs = 33;
+
     int     _stickDetectChannel;
     int     _stickDetectInitialValue;
     int     _stickDetectValue;
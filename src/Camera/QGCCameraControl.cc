@@ -11,50 +11,18 @@
 #include "VideoManager.h"
 #include "QGCMapEngine.h"
 #include "QGCCameraManager.h"
+#include "QGCNetworkManager.h"
 
 #include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
 #include <QStandardPaths>
-#include <QDomDocument>
-#include <QDomNodeList>
+#include <QtConcurrent>
 
 QGC_LOGGING_CATEGORY(CameraControlLog, "CameraControlLog")
 QGC_LOGGING_CATEGORY(CameraControlVerboseLog, "CameraControlVerboseLog")
 
-static const char* kCondition       = "condition";
-static const char* kControl         = "control";
-static const char* kDefault         = "default";
-static const char* kDefnition       = "definition";
-static const char* kDescription     = "description";
-static const char* kExclusion       = "exclude";
-static const char* kExclusions      = "exclusions";
-static const char* kLocale          = "locale";
-static const char* kLocalization    = "localization";
-static const char* kMax             = "max";
-static const char* kMin             = "min";
-static const char* kModel           = "model";
-static const char* kName            = "name";
-static const char* kOption          = "option";
-static const char* kOptions         = "options";
-static const char* kOriginal        = "original";
-static const char* kParameter       = "parameter";
-static const char* kParameterrange  = "parameterrange";
-static const char* kParameterranges = "parameterranges";
-static const char* kParameters      = "parameters";
-static const char* kReadOnly        = "readonly";
-static const char* kWriteOnly       = "writeonly";
-static const char* kRoption         = "roption";
-static const char* kStep            = "step";
-static const char* kDecimalPlaces   = "decimalPlaces";
-static const char* kStrings         = "strings";
-static const char* kTranslated      = "translated";
-static const char* kType            = "type";
-static const char* kUnit            = "unit";
-static const char* kUpdate          = "update";
-static const char* kUpdates         = "updates";
-static const char* kValue           = "value";
-static const char* kVendor          = "vendor";
-static const char* kVersion         = "version";
-
 static const char* kPhotoMode       = "PhotoMode";
 static const char* kPhotoLapse      = "PhotoLapse";
 static const char* kPhotoLapseCount = "PhotoLapseCount";
@@ -93,63 +61,118 @@ QGCCameraOptionRange::QGCCameraOptionRange(QObject* parent, QString param_, QStr
 }
 
 //-----------------------------------------------------------------------------
-static bool
-read_attribute(QDomNode& node, const char* tagName, bool& target)
+void
+QGCCameraCondition::compile(const QString& condition, FactGroup* facts)
 {
-    QDomNamedNodeMap attrs = node.attributes();
-    if(!attrs.count()) {
-        return false;
-    }
-    QDomNode subNode = attrs.namedItem(tagName);
-    if(subNode.isNull()) {
-        return false;
+    _nodes.clear();
+    _root = -1;
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+    QStringList scond = condition.split(" ", QString::SkipEmptyParts);
+#else
+    QStringList scond = condition.split(" ", Qt::SkipEmptyParts);
+#endif
+    bool andOp = true;
+    while(scond.size()) {
+        int test = _compileTest(scond.takeFirst(), facts);
+        if(_root < 0) {
+            _root = test;
+        } else {
+            _nodes.append({ andOp ? OpAnd : OpOr, nullptr, QString(), _root, test });
+            _root = _nodes.count() - 1;
+        }
+        if(!scond.size()) {
+            break;
+        }
+        andOp = scond.takeFirst().toUpper() == "AND";
     }
-    target = subNode.nodeValue() != "0";
-    return true;
 }
 
 //-----------------------------------------------------------------------------
-static bool
-read_attribute(QDomNode& node, const char* tagName, int& target)
+int
+QGCCameraCondition::_compileTest(const QString& conditionTest, FactGroup* facts)
 {
-    QDomNamedNodeMap attrs = node.attributes();
-    if(!attrs.count()) {
-        return false;
+    Node_t      node = { OpInvalid, nullptr, QString(), -1, -1 };
+    Op_t        op   = OpInvalid;
+    QStringList test;
+
+    auto split = [&conditionTest](const QString& sep ) {
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+        return conditionTest.split(sep, QString::SkipEmptyParts);
+#else
+        return conditionTest.split(sep, Qt::SkipEmptyParts);
+#endif
+    };
+
+    if(conditionTest.contains("!=")) {
+        test = split("!=");
+        op = OpNotEqual;
+    } else if(conditionTest.contains("=")) {
+        test = split("=");
+        op = OpEqual;
+    } else if(conditionTest.contains(">")) {
+        test = split(">");
+        op = OpGreater;
+    } else if(conditionTest.contains("<")) {
+        test = split("<");
+        op = OpSmaller;
     }
-    QDomNode subNode = attrs.namedItem(tagName);
-    if(subNode.isNull()) {
-        return false;
+    if(test.size() == 2) {
+        if(facts->factExists(test[0])) {
+            node.op    = op;
+            node.fact  = facts->getFact(test[0]);
+            node.value = test[1];
+        } else {
+            qWarning() << "Invalid condition parameter:" << test[0] << "in" << conditionTest;
+        }
+    } else {
+        qWarning() << "Invalid condition" << conditionTest;
     }
-    target = subNode.nodeValue().toInt();
-    return true;
+    _nodes.append(node);
+    return _nodes.count() - 1;
 }
 
 //-----------------------------------------------------------------------------
-static bool
-read_attribute(QDomNode& node, const char* tagName, QString& target)
+bool
+QGCCameraCondition::evaluate() const
 {
-    QDomNamedNodeMap attrs = node.attributes();
-    if(!attrs.count()) {
-        return false;
-    }
-    QDomNode subNode = attrs.namedItem(tagName);
-    if(subNode.isNull()) {
-        return false;
+    return _root < 0 || _evaluate(_root);
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraCondition::_evaluate(int node) const
+{
+    const Node_t& n = _nodes[node];
+    switch(n.op) {
+    case OpEqual:
+        return n.fact->rawValueString() == n.value;
+    case OpNotEqual:
+        return n.fact->rawValueString() != n.value;
+    case OpGreater:
+        return n.fact->rawValueString() > n.value;
+    case OpSmaller:
+        return n.fact->rawValueString() < n.value;
+    case OpAnd:
+        return _evaluate(n.left) && _evaluate(n.right);
+    case OpOr:
+        return _evaluate(n.left) || _evaluate(n.right);
+    case OpInvalid:
+        break;
     }
-    target = subNode.nodeValue();
-    return true;
+    return false;
 }
 
 //-----------------------------------------------------------------------------
-static bool
-read_value(QDomNode& element, const char* tagName, QString& target)
+QList<Fact*>
+QGCCameraCondition::facts() const
 {
-    QDomElement de = element.firstChildElement(tagName);
-    if(de.isNull()) {
-        return false;
+    QList<Fact*> testedFacts;
+    for(const Node_t& node: _nodes) {
+        if(node.fact && !testedFacts.contains(node.fact)) {
+            testedFacts.append(node.fact);
+        }
     }
-    target = de.text();
-    return true;
+    return testedFacts;
 }
 
 //-----------------------------------------------------------------------------
@@ -160,7 +183,9 @@ QGCCameraControl::QGCCameraControl(const mavlink_camera_information_t *info, Veh
 {
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
     memcpy(&_info, info, sizeof(mavlink_camera_information_t));
+    _paramRequester = new QGCCameraParamRequester(this, vehicle);
     connect(this, &QGCCameraControl::dataReady, this, &QGCCameraControl::_dataReady);
+    connect(&_definitionWatcher, &QFutureWatcherBase::finished, this, &QGCCameraControl::_definitionLoaded);
     _vendor = QString(reinterpret_cast<const char*>(info->vendor_name));
     _modelName = QString(reinterpret_cast<const char*>(info->model_name));
     int ver = static_cast<int>(_info.cam_definition_version);
@@ -169,6 +194,8 @@ QGCCameraControl::QGCCameraControl(const mavlink_camera_information_t *info, Veh
         _vendor.toStdString().c_str(),
         _modelName.toStdString().c_str(),
         ver);
+    _compiledCacheFile = _cacheFile;
+    _compiledCacheFile.replace(_compiledCacheFile.length() - 4, 4, ".qgccam");
     if(info->cam_definition_uri[0] != 0) {
         //-- Process camera definition file
         _handleDefinitionFile(info->cam_definition_uri);
@@ -189,8 +216,6 @@ QGCCameraControl::QGCCameraControl(const mavlink_camera_information_t *info, Veh
 //-----------------------------------------------------------------------------
 QGCCameraControl::~QGCCameraControl()
 {
-    delete _netManager;
-    _netManager = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -216,9 +241,6 @@ QGCCameraControl::_initWhenReady()
     QTimer::singleShot(2500, this, &QGCCameraControl::_requestStorageInfo);
     _captureStatusTimer.start(2750);
     emit infoChanged();
-
-    delete _netManager;
-    _netManager = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -672,7 +694,7 @@ QGCCameraControl::_requestCaptureStatus()
 void
 QGCCameraControl::factChanged(Fact* pFact)
 {
-    _updateActiveList();
+    _updateActiveList(pFact);
     _updateRanges(pFact);
 }
 
@@ -796,184 +818,81 @@ QGCCameraControl::_setPhotoStatus(PhotoStatus status)
 
 //-----------------------------------------------------------------------------
 bool
-QGCCameraControl::_loadCameraDefinitionFile(QByteArray& bytes)
-{
-    QByteArray originalData(bytes);
-    //-- Handle localization
-    if(!_handleLocalization(bytes)) {
-        return false;
-    }
-    int errorLine;
-    QString errorMsg;
-    QDomDocument doc;
-    if(!doc.setContent(bytes, false, &errorMsg, &errorLine)) {
-        qCritical() << "Unable to parse camera definition file on line:" << errorLine;
-        qCritical() << errorMsg;
-        return false;
-    }
-    //-- Load camera constants
-    QDomNodeList defElements = doc.elementsByTagName(kDefnition);
-    if(!defElements.size() || !_loadConstants(defElements)) {
-        qWarning() <<  "Unable to load camera constants from camera definition";
-        return false;
-    }
-    //-- Load camera parameters
-    QDomNodeList paramElements = doc.elementsByTagName(kParameters);
-    if(!paramElements.size() || !_loadSettings(paramElements)) {
-        qWarning() <<  "Unable to load camera parameters from camera definition";
-        return false;
-    }
-    //-- If this is new, cache it
-    if(!_cached) {
-        qCDebug(CameraControlLog) << "Saving camera definition file" << _cacheFile;
-        QFile file(_cacheFile);
-        if (!file.open(QIODevice::WriteOnly)) {
-            qWarning() << QString("Could not save cache file %1. Error: %2").arg(_cacheFile).arg(file.errorString());
-        } else {
-            file.write(originalData);
-        }
-    }
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_loadConstants(const QDomNodeList nodeList)
+QGCCameraControl::_loadSettings(const QGCCameraDefinition& definition)
 {
-    QDomNode node = nodeList.item(0);
-    if(!read_attribute(node, kVersion, _version)) {
-        return false;
-    }
-    if(!read_value(node, kModel, _modelName)) {
-        return false;
-    }
-    if(!read_value(node, kVendor, _vendor)) {
-        return false;
-    }
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_loadSettings(const QDomNodeList nodeList)
-{
-    QDomNode node = nodeList.item(0);
-    QDomElement elem = node.toElement();
-    QDomNodeList parameters = elem.elementsByTagName(kParameter);
+    //-- Camera constants
+    _version    = definition.version;
+    _modelName  = definition.model;
+    _vendor     = definition.vendor;
     //-- Pre-process settings (maintain order and skip non-controls)
-    for(int i = 0; i < parameters.size(); i++) {
-        QDomNode parameterNode = parameters.item(i);
-        QString name;
-        if(read_attribute(parameterNode, kName, name)) {
-            bool control = true;
-            read_attribute(parameterNode, kControl, control);
-            if(control) {
-                _settings << name;
-            }
-        } else {
-            qCritical() << "Parameter entry missing parameter name";
-            return false;
+    for(const QGCCameraDefinition::Parameter_t& parameter: definition.parameters) {
+        if(parameter.control) {
+            _settings << parameter.name;
         }
     }
     //-- Load parameters
-    for(int i = 0; i < parameters.size(); i++) {
-        QDomNode parameterNode = parameters.item(i);
-        QString factName;
-        read_attribute(parameterNode, kName, factName);
-        QString type;
-        if(!read_attribute(parameterNode, kType, type)) {
-            qCritical() << QString("Parameter %1 missing parameter type").arg(factName);
-            return false;
-        }
+    for(const QGCCameraDefinition::Parameter_t& parameter: definition.parameters) {
+        const QString& factName = parameter.name;
+        FactMetaData::ValueType_t factType = parameter.type;
         //-- Does it have a control?
-        bool control = true;
-        read_attribute(parameterNode, kControl, control);
-        //-- Is it read only?
-        bool readOnly = false;
-        read_attribute(parameterNode, kReadOnly, readOnly);
-        //-- Is it write only?
-        bool writeOnly = false;
-        read_attribute(parameterNode, kWriteOnly, writeOnly);
+        bool control = parameter.control;
         //-- It can't be both
-        if(readOnly && writeOnly) {
+        if(parameter.readOnly && parameter.writeOnly) {
             qCritical() << QString("Parameter %1 cannot be both read only and write only").arg(factName);
         }
-        //-- Param type
-        bool unknownType;
-        FactMetaData::ValueType_t factType = FactMetaData::stringToType(type, unknownType);
-        if (unknownType) {
-            qCritical() << QString("Unknown type for parameter %1").arg(factName);
-            return false;
-        }
         //-- By definition, custom types do not have control
         if(factType == FactMetaData::valueTypeCustom) {
             control = false;
         }
-        //-- Description
-        QString description;
-        if(!read_value(parameterNode, kDescription, description)) {
-            qCritical() << QString("Parameter %1 missing parameter description").arg(factName);
-            return false;
-        }
         //-- Check for updates
-        QStringList updates = _loadUpdates(parameterNode);
-        if(updates.size()) {
-            qCDebug(CameraControlVerboseLog) << "Parameter" << factName << "requires updates for:" << updates;
-            _requestUpdates[factName] = updates;
+        if(parameter.updates.size()) {
+            qCVerbose(CameraControlVerboseLog) << "Parameter" << factName << "requires updates for:" << parameter.updates;
+            _requestUpdates[factName] = parameter.updates;
         }
         //-- Build metadata
         FactMetaData* metaData = new FactMetaData(factType, factName, this);
         QQmlEngine::setObjectOwnership(metaData, QQmlEngine::CppOwnership);
-        metaData->setShortDescription(description);
-        metaData->setLongDescription(description);
+        metaData->setShortDescription(parameter.description);
+        metaData->setLongDescription(parameter.description);
         metaData->setHasControl(control);
-        metaData->setReadOnly(readOnly);
-        metaData->setWriteOnly(writeOnly);
+        metaData->setReadOnly(parameter.readOnly);
+        metaData->setWriteOnly(parameter.writeOnly);
         //-- Options (enums)
-        QDomElement optionElem = parameterNode.toElement();
-        QDomNodeList optionsRoot = optionElem.elementsByTagName(kOptions);
-        if(optionsRoot.size()) {
-            //-- Iterate options
-            QDomNode node = optionsRoot.item(0);
-            QDomElement elem = node.toElement();
-            QDomNodeList options = elem.elementsByTagName(kOption);
-            for(int i = 0; i < options.size(); i++) {
-                QDomNode option = options.item(i);
-                QString optName;
-                QString optValue;
-                QVariant optVariant;
-                if(!_loadNameValue(option, factName, metaData, optName, optValue, optVariant)) {
-                    delete metaData;
-                    return false;
-                }
-                metaData->addEnumInfo(optName, optVariant);
-                _originalOptNames[factName]  << optName;
-                _originalOptValues[factName] << optVariant;
-                //-- Check for exclusions
-                QStringList exclusions = _loadExclusions(option);
-                if(exclusions.size()) {
-                    qCDebug(CameraControlVerboseLog) << "New exclusions:" << factName << optValue << exclusions;
-                    QGCCameraOptionExclusion* pExc = new QGCCameraOptionExclusion(this, factName, optValue, exclusions);
-                    QQmlEngine::setObjectOwnership(pExc, QQmlEngine::CppOwnership);
-                    _valueExclusions.append(pExc);
-                }
-                //-- Check for range rules
-                if(!_loadRanges(option, factName, optValue)) {
-                    delete metaData;
-                    return false;
-                }
+        for(const QGCCameraDefinition::Option_t& option: parameter.options) {
+            QVariant optVariant;
+            QString  errorString;
+            if (!metaData->convertAndValidateRaw(option.value, false, optVariant, errorString)) {
+                qWarning() << "Invalid option value, name:" << factName
+                           << " type:"  << metaData->type()
+                           << " value:" << option.value
+                           << " error:" << errorString;
+            }
+            metaData->addEnumInfo(option.name, optVariant);
+            _originalOptNames[factName]  << option.name;
+            _originalOptValues[factName] << optVariant;
+            //-- Check for exclusions
+            if(option.exclusions.size()) {
+                qCVerbose(CameraControlVerboseLog) << "New exclusions:" << factName << option.value << option.exclusions;
+                QGCCameraOptionExclusion* pExc = new QGCCameraOptionExclusion(this, factName, option.value, option.exclusions);
+                QQmlEngine::setObjectOwnership(pExc, QQmlEngine::CppOwnership);
+                _valueExclusions.append(pExc);
+            }
+            //-- Check for range rules
+            for(const QGCCameraDefinition::Range_t& range: option.ranges) {
+                QGCCameraOptionRange* pRange = new QGCCameraOptionRange(this, factName, option.value, range.targetParam, range.condition, range.optNames, range.optValues);
+                _optionRanges.append(pRange);
+                qCVerbose(CameraControlVerboseLog) << "New range limit:" << factName << option.value << range.targetParam << range.condition << range.optNames << range.optValues;
             }
         }
-        QString defaultValue;
-        if(read_attribute(parameterNode, kDefault, defaultValue)) {
+        if(!parameter.defaultValue.isEmpty()) {
             QVariant defaultVariant;
             QString  errorString;
-            if (metaData->convertAndValidateRaw(defaultValue, false, defaultVariant, errorString)) {
+            if (metaData->convertAndValidateRaw(parameter.defaultValue, false, defaultVariant, errorString)) {
                 metaData->setRawDefaultValue(defaultVariant);
             } else {
                 qWarning() << "Invalid default value for" << factName
                            << " type:"  << metaData->type()
-                           << " value:" << defaultValue
+                           << " value:" << parameter.defaultValue
                            << " error:" << errorString;
             }
         }
@@ -982,78 +901,63 @@ QGCCameraControl::_loadSettings(const QDomNodeList nodeList)
             qWarning() << QStringLiteral("Duplicate fact name:") << factName;
             delete metaData;
         } else {
-            {
-                //-- Check for Min Value
-                QString attr;
-                if(read_attribute(parameterNode, kMin, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setRawMin(typedValue);
-                    } else {
-                        qWarning() << "Invalid min value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
+            //-- Check for Min Value
+            if(!parameter.min.isEmpty()) {
+                QVariant typedValue;
+                QString  errorString;
+                if (metaData->convertAndValidateRaw(parameter.min, true /* convertOnly */, typedValue, errorString)) {
+                    metaData->setRawMin(typedValue);
+                } else {
+                    qWarning() << "Invalid min value for" << factName
+                               << " type:"  << metaData->type()
+                               << " value:" << parameter.min
+                               << " error:" << errorString;
                 }
             }
-            {
-                //-- Check for Max Value
-                QString attr;
-                if(read_attribute(parameterNode, kMax, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setRawMax(typedValue);
-                    } else {
-                        qWarning() << "Invalid max value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
+            //-- Check for Max Value
+            if(!parameter.max.isEmpty()) {
+                QVariant typedValue;
+                QString  errorString;
+                if (metaData->convertAndValidateRaw(parameter.max, true /* convertOnly */, typedValue, errorString)) {
+                    metaData->setRawMax(typedValue);
+                } else {
+                    qWarning() << "Invalid max value for" << factName
+                               << " type:"  << metaData->type()
+                               << " value:" << parameter.max
+                               << " error:" << errorString;
                 }
             }
-            {
-                //-- Check for Step Value
-                QString attr;
-                if(read_attribute(parameterNode, kStep, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setRawIncrement(typedValue.toDouble());
-                    } else {
-                        qWarning() << "Invalid step value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
+            //-- Check for Step Value
+            if(!parameter.step.isEmpty()) {
+                QVariant typedValue;
+                QString  errorString;
+                if (metaData->convertAndValidateRaw(parameter.step, true /* convertOnly */, typedValue, errorString)) {
+                    metaData->setRawIncrement(typedValue.toDouble());
+                } else {
+                    qWarning() << "Invalid step value for" << factName
+                               << " type:"  << metaData->type()
+                               << " value:" << parameter.step
+                               << " error:" << errorString;
                 }
             }
-            {
-                //-- Check for Decimal Places
-                QString attr;
-                if(read_attribute(parameterNode, kDecimalPlaces, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setDecimalPlaces(typedValue.toInt());
-                    } else {
-                        qWarning() << "Invalid decimal places value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
+            //-- Check for Decimal Places
+            if(!parameter.decimalPlaces.isEmpty()) {
+                QVariant typedValue;
+                QString  errorString;
+                if (metaData->convertAndValidateRaw(parameter.decimalPlaces, true /* convertOnly */, typedValue, errorString)) {
+                    metaData->setDecimalPlaces(typedValue.toInt());
+                } else {
+                    qWarning() << "Invalid decimal places value for" << factName
+                               << " type:"  << metaData->type()
+                               << " value:" << parameter.decimalPlaces
+                               << " error:" << errorString;
                 }
             }
-            {
-                //-- Check for Units
-                QString attr;
-                if(read_attribute(parameterNode, kUnit, attr)) {
-                    metaData->setRawUnits(attr);
-                }
+            //-- Check for Units
+            if(!parameter.unit.isEmpty()) {
+                metaData->setRawUnits(parameter.unit);
             }
-            qCDebug(CameraControlLog) << "New parameter:" << factName << (readOnly ? "ReadOnly" : "Writable") << (writeOnly ? "WriteOnly" : "Readable");
+            qCDebug(CameraControlLog) << "New parameter:" << factName << (parameter.readOnly ? "ReadOnly" : "Writable") << (parameter.writeOnly ? "WriteOnly" : "Readable");
             _nameToFactMetaDataMap[factName] = metaData;
             Fact* pFact = new Fact(_compID, factName, factType, this);
             QQmlEngine::setObjectOwnership(pFact, QQmlEngine::CppOwnership);
@@ -1068,6 +972,7 @@ QGCCameraControl::_loadSettings(const QDomNodeList nodeList)
     if(_nameToFactMetaDataMap.size() > 0) {
         _addFactGroup(this, "camera");
         _processRanges();
+        _processExclusions();
         _activeSettings = _settings;
         emit activeSettingsChanged();
         return true;
@@ -1075,119 +980,25 @@ QGCCameraControl::_loadSettings(const QDomNodeList nodeList)
     return false;
 }
 
-//-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_handleLocalization(QByteArray& bytes)
-{
-    QString errorMsg;
-    int errorLine;
-    QDomDocument doc;
-    if(!doc.setContent(bytes, false, &errorMsg, &errorLine)) {
-        qCritical() << "Unable to parse camera definition file on line:" << errorLine;
-        qCritical() << errorMsg;
-        return false;
-    }
-    //-- Find out where we are
-    QLocale locale = QLocale::system();
-#if defined (Q_OS_MAC)
-    locale = QLocale(locale.name());
-#endif
-    QString localeName = locale.name().toLower().replace("-", "_");
-    qCDebug(CameraControlLog) << "Current locale:" << localeName;
-    if(localeName == "en_us") {
-        // Nothing to do
-        return true;
-    }
-    QDomNodeList locRoot = doc.elementsByTagName(kLocalization);
-    if(!locRoot.size()) {
-        // Nothing to do
-        return true;
-    }
-    //-- Iterate locales
-    QDomNode node = locRoot.item(0);
-    QDomElement elem = node.toElement();
-    QDomNodeList locales = elem.elementsByTagName(kLocale);
-    for(int i = 0; i < locales.size(); i++) {
-        QDomNode locale = locales.item(i);
-        QString name;
-        if(!read_attribute(locale, kName, name)) {
-            qWarning() << "Localization entry is missing its name attribute";
-            continue;
-        }
-        // If we found a direct match, deal with it now
-        if(localeName == name.toLower().replace("-", "_")) {
-            return _replaceLocaleStrings(locale, bytes);
-        }
-    }
-    //-- No direct match. Pick first matching language (if any)
-    localeName = localeName.left(3);
-    for(int i = 0; i < locales.size(); i++) {
-        QDomNode locale = locales.item(i);
-        QString name;
-        read_attribute(locale, kName, name);
-        if(name.toLower().startsWith(localeName)) {
-            return _replaceLocaleStrings(locale, bytes);
-        }
-    }
-    //-- Could not find a language to use
-    qWarning() <<  "No match for" << QLocale::system().name() << "in camera definition file";
-    //-- Just use default, en_US
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_replaceLocaleStrings(const QDomNode node, QByteArray& bytes)
-{
-    QDomElement stringElem = node.toElement();
-    QDomNodeList strings = stringElem.elementsByTagName(kStrings);
-    for(int i = 0; i < strings.size(); i++) {
-        QDomNode stringNode = strings.item(i);
-        QString original;
-        QString translated;
-        if(read_attribute(stringNode, kOriginal, original)) {
-            if(read_attribute(stringNode, kTranslated, translated)) {
-                QString o; o = "\"" + original + "\"";
-                QString t; t = "\"" + translated + "\"";
-                bytes.replace(o.toUtf8(), t.toUtf8());
-                o = ">" + original + "<";
-                t = ">" + translated + "<";
-                bytes.replace(o.toUtf8(), t.toUtf8());
-            }
-        }
-    }
-    return true;
-}
-
 //-----------------------------------------------------------------------------
 void
 QGCCameraControl::_requestAllParameters()
 {
     //-- Reset receive list
+    QList<QGCCameraParamIO*> params;
     for(const QString& paramName: _paramIO.keys()) {
         if(_paramIO[paramName]) {
             _paramIO[paramName]->setParamRequest();
+            if(!_paramIO[paramName]->fact()->writeOnly()) {
+                params.append(_paramIO[paramName]);
+            }
         } else {
             qCritical() << "QGCParamIO is NULL" << paramName;
         }
     }
-    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
-    if (!weakLink.expired()) {
-        SharedLinkInterfacePtr sharedLink = weakLink.lock();
-
-        MAVLinkProtocol* mavlink = qgcApp()->toolbox()->mavlinkProtocol();
-        mavlink_message_t msg;
-        mavlink_msg_param_ext_request_list_pack_chan(
-                    static_cast<uint8_t>(mavlink->getSystemId()),
-                    static_cast<uint8_t>(mavlink->getComponentId()),
-                    sharedLink->mavlinkChannel(),
-                    &msg,
-                    static_cast<uint8_t>(_vehicle->id()),
-                    static_cast<uint8_t>(compID()),
-                    0);                                                 // trimmed messages = false
-        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
-    }
-    qCDebug(CameraControlVerboseLog) << "Request all parameters";
+    //-- One list request, then whatever is missing in small batches
+    _paramRequester->requestAll(params);
+    qCVerbose(CameraControlVerboseLog) << "Request all parameters";
 }
 
 //-----------------------------------------------------------------------------
@@ -1226,6 +1037,7 @@ QGCCameraControl::handleParamValue(const mavlink_param_ext_value_t& value)
     }
     if(_paramIO[paramName]) {
         _paramIO[paramName]->handleParamValue(value);
+        _paramRequester->received(_paramIO[paramName]);
     } else {
         qCritical() << "QGCParamIO is NULL" << paramName;
     }
@@ -1233,27 +1045,39 @@ QGCCameraControl::handleParamValue(const mavlink_param_ext_value_t& value)
 
 //-----------------------------------------------------------------------------
 void
-QGCCameraControl::_updateActiveList()
-{
-    //-- Clear out excluded parameters based on exclusion rules
-    QStringList exclusionList;
-    for(QGCCameraOptionExclusion* param: _valueExclusions) {
-        Fact* pFact = getFact(param->param);
-        if(pFact) {
-            QString option = pFact->rawValueString();
-            if(param->value == option) {
-                exclusionList << param->exclusions;
+QGCCameraControl::_updateActiveList(Fact* pFact)
+{
+    //-- Re-evaluate the exclusion rules of the facts which changed, excluded parameters are counted by the rules in effect
+    bool changed = !_activeListValid;
+    _staleExclusionFacts.insert(pFact);
+    for(Fact* pStaleFact: _staleExclusionFacts) {
+        for(QGCCameraOptionExclusion* pExc: _exclusionsByFact.value(pStaleFact)) {
+            bool active = pExc->value == pStaleFact->rawValueString();
+            if(active != pExc->active) {
+                pExc->active = active;
+                for(const QString& param: pExc->exclusions) {
+                    _exclusionCounts[param] += active ? 1 : -1;
+                }
+                changed = true;
             }
         }
     }
+    _staleExclusionFacts.clear();
+    if(!changed) {
+        return;
+    }
+    _activeListValid = true;
     QStringList active;
-    for(QString key: _settings) {
-        if(!exclusionList.contains(key)) {
+    QStringList excluded;
+    for(const QString& key: _settings) {
+        if(_exclusionCounts.value(key) > 0) {
+            excluded.append(key);
+        } else {
             active.append(key);
         }
     }
     if(active != _activeSettings) {
-        qCDebug(CameraControlVerboseLog) << "Excluding" << exclusionList;
+        qCVerbose(CameraControlVerboseLog) << "Excluding" << excluded;
         _activeSettings = active;
         emit activeSettingsChanged();
         //-- Force validity of "Facts" based on active set
@@ -1263,137 +1087,47 @@ QGCCameraControl::_updateActiveList()
     }
 }
 
-//-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_processConditionTest(const QString conditionTest)
-{
-    enum {
-        TEST_NONE,
-        TEST_EQUAL,
-        TEST_NOT_EQUAL,
-        TEST_GREATER,
-        TEST_SMALLER
-    };
-    qCDebug(CameraControlVerboseLog) << "_processConditionTest(" << conditionTest << ")";
-    int op = TEST_NONE;
-    QStringList test;
-
-    auto split = [&conditionTest](const QString& sep ) {
-#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-        return conditionTest.split(sep, QString::SkipEmptyParts);
-#else
-        return conditionTest.split(sep, Qt::SkipEmptyParts);
-#endif
-    };
-
-    if(conditionTest.contains("!=")) {
-        test = split("!=");
-        op = TEST_NOT_EQUAL;
-    } else if(conditionTest.contains("=")) {
-        test = split("=");
-        op = TEST_EQUAL;
-    } else if(conditionTest.contains(">")) {
-        test = split(">");
-        op = TEST_GREATER;
-    } else if(conditionTest.contains("<")) {
-        test = split("<");
-        op = TEST_SMALLER;
-    }
-    if(test.size() == 2) {
-        Fact* pFact = getFact(test[0]);
-        if(pFact) {
-            switch(op) {
-            case TEST_EQUAL:
-                return pFact->rawValueString() == test[1];
-            case TEST_NOT_EQUAL:
-                return pFact->rawValueString() != test[1];
-            case TEST_GREATER:
-                return pFact->rawValueString() > test[1];
-            case TEST_SMALLER:
-                return pFact->rawValueString() < test[1];
-            case TEST_NONE:
-                break;
-            }
-        } else {
-            qWarning() << "Invalid condition parameter:" << test[0] << "in" << conditionTest;
-            return false;
-        }
-    }
-    qWarning() << "Invalid condition" << conditionTest;
-    return false;
-}
-
-//-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_processCondition(const QString condition)
-{
-    qCDebug(CameraControlVerboseLog) << "_processCondition(" << condition << ")";
-    bool result = true;
-    bool andOp  = true;
-    if(!condition.isEmpty()) {
-#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-        QStringList scond = condition.split(" ", QString::SkipEmptyParts);
-#else
-        QStringList scond = condition.split(" ", Qt::SkipEmptyParts);
-#endif
-        while(scond.size()) {
-            QString test = scond.first();
-            scond.removeFirst();
-            if(andOp) {
-                result = result && _processConditionTest(test);
-            } else {
-                result = result || _processConditionTest(test);
-            }
-            if(!scond.size()) {
-                return result;
-            }
-            andOp = scond.first().toUpper() == "AND";
-            scond.removeFirst();
-        }
-    }
-    return result;
-}
-
 //-----------------------------------------------------------------------------
 void
 QGCCameraControl::_updateRanges(Fact* pFact)
 {
     QMap<Fact*, QGCCameraOptionRange*> rangesSet;
     QMap<Fact*, QString> rangesReset;
-    QStringList changedList;
-    QStringList resetList;
+    QSet<QString> changedList;
+    QSet<QString> resetList;
     QStringList updates;
+    //-- Only the range sets this fact is part of, as their parameter or in their condition
+    const QList<QGCCameraOptionRange*> ranges = _rangesByFact.value(pFact);
     //-- Iterate range sets looking for limited ranges
-    for(QGCCameraOptionRange* pRange: _optionRanges) {
-        //-- If this fact or one of its conditions is part of this range set
-        if(!changedList.contains(pRange->targetParam) && (pRange->param == pFact->name() || pRange->condition.contains(pFact->name()))) {
-            Fact* pRFact = getFact(pRange->param);          //-- This parameter
-            Fact* pTFact = getFact(pRange->targetParam);    //-- The target parameter (the one its range is to change)
-            if(pRFact && pTFact) {
-                //qCDebug(CameraControlVerboseLog) << "Check new set of options for" << pTFact->name();
+    for(QGCCameraOptionRange* pRange: ranges) {
+        if(!changedList.contains(pRange->targetParam)) {
+            Fact* pRFact = pRange->paramFact;               //-- This parameter
+            Fact* pTFact = pRange->targetFact;              //-- The target parameter (the one its range is to change)
+            if(pRFact) {
+                //qCVerbose(CameraControlVerboseLog) << "Check new set of options for" << pTFact->name();
                 QString option = pRFact->rawValueString();  //-- This parameter value
                 //-- If this value (and condition) triggers a change in the target range
-                //qCDebug(CameraControlVerboseLog) << "Range value:" << pRange->value << "Current value:" << option << "Condition:" << pRange->condition;
-                if(pRange->value == option && _processCondition(pRange->condition)) {
+                //qCVerbose(CameraControlVerboseLog) << "Range value:" << pRange->value << "Current value:" << option << "Condition:" << pRange->condition;
+                if(pRange->value == option && pRange->compiledCondition.evaluate()) {
                     if(pTFact->enumStrings() != pRange->optNames) {
                         //-- Set limited range set
                         rangesSet[pTFact] = pRange;
                     }
-                    changedList << pRange->targetParam;
+                    changedList.insert(pRange->targetParam);
                 }
             }
         }
     }
     //-- Iterate range sets again looking for resets
-    for(QGCCameraOptionRange* pRange: _optionRanges) {
-        if(!changedList.contains(pRange->targetParam) && (pRange->param == pFact->name() || pRange->condition.contains(pFact->name()))) {
-            Fact* pTFact = getFact(pRange->targetParam);    //-- The target parameter (the one its range is to change)
+    for(QGCCameraOptionRange* pRange: ranges) {
+        if(!changedList.contains(pRange->targetParam)) {
+            Fact* pTFact = pRange->targetFact;              //-- The target parameter (the one its range is to change)
             if(!resetList.contains(pRange->targetParam)) {
                 if(pTFact->enumStrings() != _originalOptNames[pRange->targetParam]) {
                     //-- Restore full option set
                     rangesReset[pTFact] = pRange->targetParam;
                 }
-                resetList << pRange->targetParam;
+                resetList.insert(pRange->targetParam);
             }
         }
     }
@@ -1404,7 +1138,7 @@ QGCCameraControl::_updateRanges(Fact* pFact)
             _paramIO[f->name()]->optNames = rangesSet[f]->optNames;
             _paramIO[f->name()]->optVariants = rangesSet[f]->optVariants;
             emit f->enumsChanged();
-            qCDebug(CameraControlVerboseLog) << "Limited set of options for:" << f->name() << rangesSet[f]->optNames;;
+            qCVerbose(CameraControlVerboseLog) << "Limited set of options for:" << f->name() << rangesSet[f]->optNames;;
             updates << f->name();
         }
     }
@@ -1415,7 +1149,7 @@ QGCCameraControl::_updateRanges(Fact* pFact)
             _paramIO[f->name()]->optNames = _originalOptNames[rangesReset[f]];
             _paramIO[f->name()]->optVariants = _originalOptValues[rangesReset[f]];
             emit f->enumsChanged();
-            qCDebug(CameraControlVerboseLog) << "Restore full set of options for:" << f->name() << _originalOptNames[f->name()];
+            qCVerbose(CameraControlVerboseLog) << "Restore full set of options for:" << f->name() << _originalOptNames[f->name()];
             updates << f->name();
         }
     }
@@ -1813,173 +1547,73 @@ QGCCameraControl::_streamStatusTimeout()
     }
 }
 
-//-----------------------------------------------------------------------------
-QStringList
-QGCCameraControl::_loadExclusions(QDomNode option)
-{
-    QStringList exclusionList;
-    QDomElement optionElem = option.toElement();
-    QDomNodeList excRoot = optionElem.elementsByTagName(kExclusions);
-    if(excRoot.size()) {
-        //-- Iterate exclusions
-        QDomNode node = excRoot.item(0);
-        QDomElement elem = node.toElement();
-        QDomNodeList exclusions = elem.elementsByTagName(kExclusion);
-        for(int i = 0; i < exclusions.size(); i++) {
-            QString exclude = exclusions.item(i).toElement().text();
-            if(!exclude.isEmpty()) {
-                exclusionList << exclude;
-            }
-        }
-    }
-    return exclusionList;
-}
-
-//-----------------------------------------------------------------------------
-QStringList
-QGCCameraControl::_loadUpdates(QDomNode option)
-{
-    QStringList updateList;
-    QDomElement optionElem = option.toElement();
-    QDomNodeList updateRoot = optionElem.elementsByTagName(kUpdates);
-    if(updateRoot.size()) {
-        //-- Iterate updates
-        QDomNode node = updateRoot.item(0);
-        QDomElement elem = node.toElement();
-        QDomNodeList updates = elem.elementsByTagName(kUpdate);
-        for(int i = 0; i < updates.size(); i++) {
-            QString update = updates.item(i).toElement().text();
-            if(!update.isEmpty()) {
-                updateList << update;
-            }
-        }
-    }
-    return updateList;
-}
-
-//-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_loadRanges(QDomNode option, const QString factName, QString paramValue)
-{
-    QDomElement optionElem = option.toElement();
-    QDomNodeList rangeRoot = optionElem.elementsByTagName(kParameterranges);
-    if(rangeRoot.size()) {
-        QDomNode node = rangeRoot.item(0);
-        QDomElement elem = node.toElement();
-        QDomNodeList parameterRanges = elem.elementsByTagName(kParameterrange);
-        //-- Iterate parameter ranges
-        for(int i = 0; i < parameterRanges.size(); i++) {
-            QString param;
-            QString condition;
-            QDomNode paramRange = parameterRanges.item(i);
-            if(!read_attribute(paramRange, kParameter, param)) {
-                qCritical() << QString("Malformed option range for parameter %1").arg(factName);
-                return false;
-            }
-            read_attribute(paramRange, kCondition, condition);
-            QDomElement pelem = paramRange.toElement();
-            QDomNodeList rangeOptions = pelem.elementsByTagName(kRoption);
-            QStringList  optNames;
-            QStringList  optValues;
-            //-- Iterate options
-            for(int i = 0; i < rangeOptions.size(); i++) {
-                QString optName;
-                QString optValue;
-                QDomNode roption = rangeOptions.item(i);
-                if(!read_attribute(roption, kName, optName)) {
-                    qCritical() << QString("Malformed roption for parameter %1").arg(factName);
-                    return false;
-                }
-                if(!read_attribute(roption, kValue, optValue)) {
-                    qCritical() << QString("Malformed rvalue for parameter %1").arg(factName);
-                    return false;
-                }
-                optNames  << optName;
-                optValues << optValue;
-            }
-            if(optNames.size()) {
-                QGCCameraOptionRange* pRange = new QGCCameraOptionRange(this, factName, paramValue, param, condition, optNames, optValues);
-                _optionRanges.append(pRange);
-                qCDebug(CameraControlVerboseLog) << "New range limit:" << factName << paramValue << param << condition << optNames << optValues;
-            }
-        }
-    }
-    return true;
-}
-
 //-----------------------------------------------------------------------------
 void
 QGCCameraControl::_processRanges()
 {
     //-- After all parameter are loaded, process parameter ranges
     for(QGCCameraOptionRange* pRange: _optionRanges) {
+        if(!factExists(pRange->targetParam)) {
+            continue;
+        }
         Fact* pRFact = getFact(pRange->targetParam);
-        if(pRFact) {
-            for(int i = 0; i < pRange->optNames.size(); i++) {
-                QVariant optVariant;
-                QString  errorString;
-                if (!pRFact->metaData()->convertAndValidateRaw(pRange->optValues[i], false, optVariant, errorString)) {
-                    qWarning() << "Invalid roption value, name:" << pRange->targetParam
-                               << " type:"  << pRFact->metaData()->type()
-                               << " value:" << pRange->optValues[i]
-                               << " error:" << errorString;
-                } else {
-                    pRange->optVariants << optVariant;
-                }
+        for(int i = 0; i < pRange->optNames.size(); i++) {
+            QVariant optVariant;
+            QString  errorString;
+            if (!pRFact->metaData()->convertAndValidateRaw(pRange->optValues[i], false, optVariant, errorString)) {
+                qWarning() << "Invalid roption value, name:" << pRange->targetParam
+                           << " type:"  << pRFact->metaData()->type()
+                           << " value:" << pRange->optValues[i]
+                           << " error:" << errorString;
+            } else {
+                pRange->optVariants << optVariant;
             }
         }
+        pRange->targetFact = pRFact;
+        pRange->paramFact  = factExists(pRange->param) ? getFact(pRange->param) : nullptr;
+        pRange->compiledCondition.compile(pRange->condition, this);
+        //-- Index it by the facts which can change its outcome
+        QList<Fact*> dependencies = pRange->compiledCondition.facts();
+        if(pRange->paramFact && !dependencies.contains(pRange->paramFact)) {
+            dependencies.prepend(pRange->paramFact);
+        }
+        for(Fact* pFact: dependencies) {
+            _rangesByFact[pFact].append(pRange);
+        }
     }
 }
 
 //-----------------------------------------------------------------------------
-bool
-QGCCameraControl::_loadNameValue(QDomNode option, const QString factName, FactMetaData* metaData, QString& optName, QString& optValue, QVariant& optVariant)
+void
+QGCCameraControl::_processExclusions()
 {
-    if(!read_attribute(option, kName, optName)) {
-        qCritical() << QString("Malformed option for parameter %1").arg(factName);
-        return false;
-    }
-    if(!read_attribute(option, kValue, optValue)) {
-        qCritical() << QString("Malformed value for parameter %1").arg(factName);
-        return false;
-    }
-    QString  errorString;
-    if (!metaData->convertAndValidateRaw(optValue, false, optVariant, errorString)) {
-        qWarning() << "Invalid option value, name:" << factName
-                   << " type:"  << metaData->type()
-                   << " value:" << optValue
-                   << " error:" << errorString;
+    //-- Index exclusions by the fact they test and count the ones in effect for the default values
+    for(QGCCameraOptionExclusion* pExc: _valueExclusions) {
+        if(!factExists(pExc->param)) {
+            continue;
+        }
+        Fact* pFact = getFact(pExc->param);
+        if(!_exclusionsByFact.contains(pFact)) {
+            //-- Values also come in from the camera without a call to factChanged
+            connect(pFact, &Fact::rawValueChanged, this, [this, pFact]() { _staleExclusionFacts.insert(pFact); });
+        }
+        _exclusionsByFact[pFact].append(pExc);
+        pExc->active = pExc->value == pFact->rawValueString();
+        if(pExc->active) {
+            for(const QString& param: pExc->exclusions) {
+                _exclusionCounts[param]++;
+            }
+        }
     }
-    return true;
 }
 
 //-----------------------------------------------------------------------------
 void
 QGCCameraControl::_handleDefinitionFile(const QString &url)
 {
-    //-- First check and see if we have it cached
-    QFile xmlFile(_cacheFile);
-    if (!xmlFile.exists()) {
-        qCDebug(CameraControlLog) << "No camera definition file cached";
-        _httpRequest(url);
-        return;
-    }
-    if (!xmlFile.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not read cached camera definition file:" << _cacheFile;
-        _httpRequest(url);
-        return;
-    }
-    QByteArray bytes = xmlFile.readAll();
-    QDomDocument doc;
-    if(!doc.setContent(bytes, false)) {
-        qWarning() << "Could not parse cached camera definition file:" << _cacheFile;
-        _httpRequest(url);
-        return;
-    }
-    //-- We have it
-    qCDebug(CameraControlLog) << "Using cached camera definition file:" << _cacheFile;
-    _cached = true;
-    emit dataReady(bytes);
+    //-- Look for it in the caches first, the worker thread tells us if it has to be downloaded
+    _definitionUri = url;
+    _loadDefinition(QByteArray());
 }
 
 //-----------------------------------------------------------------------------
@@ -1987,21 +1621,14 @@ void
 QGCCameraControl::_httpRequest(const QString &url)
 {
     qCDebug(CameraControlLog) << "Request camera definition:" << url;
-    if(!_netManager) {
-        _netManager = new QNetworkAccessManager(this);
-    }
-    QNetworkProxy savedProxy = _netManager->proxy();
-    QNetworkProxy tempProxy;
-    tempProxy.setType(QNetworkProxy::DefaultProxy);
-    _netManager->setProxy(tempProxy);
     QNetworkRequest request(url);
     request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
     QSslConfiguration conf = request.sslConfiguration();
     conf.setPeerVerifyMode(QSslSocket::VerifyNone);
     request.setSslConfiguration(conf);
-    QNetworkReply* reply = _netManager->get(request);
-    connect(reply, &QNetworkReply::finished,  this, &QGCCameraControl::_downloadFinished);
-    _netManager->setProxy(savedProxy);
+    QGCNetworkManager::instance()->queueGet(request, QGCNetworkManager::PriorityNormal, this, [this](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished,  this, &QGCCameraControl::_downloadFinished);
+    });
 }
 
 //-----------------------------------------------------------------------------
@@ -2022,7 +1649,7 @@ QGCCameraControl::_downloadFinished()
         qWarning() << QString("Camera Definition download error: %1 status: %2").arg(reply->errorString(), reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toString());
     }
     emit dataReady(data);
-    //reply->deleteLater();
+    reply->deleteLater();
 }
 
 //-----------------------------------------------------------------------------
@@ -2031,9 +1658,83 @@ QGCCameraControl::_dataReady(QByteArray data)
 {
     if(data.size()) {
         qCDebug(CameraControlLog) << "Parsing camera definition";
-        _loadCameraDefinitionFile(data);
+        _loadDefinition(data);
     } else {
         qCDebug(CameraControlLog) << "No camera definition";
+        _initWhenReady();
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Loads the camera definition on a worker thread. With no bytes it comes from the compiled cache, or failing that
+/// from the cached definition file. Downloaded bytes are parsed and both caches are updated.
+void
+QGCCameraControl::_loadDefinition(const QByteArray& bytes)
+{
+    const QString uri               = _definitionUri;
+    const int     uriVersion        = static_cast<int>(_info.cam_definition_version);
+    const QString localeName        = QGCCameraDefinition::systemLocaleName();
+    const QString cacheFile         = _cacheFile;
+    const QString compiledCacheFile = _compiledCacheFile;
+    _definitionWatcher.setFuture(QtConcurrent::run([bytes, uri, uriVersion, localeName, cacheFile, compiledCacheFile]() {
+        DefinitionResult_t result;
+        result.valid    = false;
+        result.cached   = bytes.isEmpty();
+        result.download = false;
+        QByteArray definitionBytes(bytes);
+        if(result.cached) {
+            if(result.definition.load(compiledCacheFile, uri, uriVersion, localeName)) {
+                result.valid = true;
+                return result;
+            }
+            QFile xmlFile(cacheFile);
+            if(!xmlFile.open(QIODevice::ReadOnly)) {
+                result.download = true;
+                return result;
+            }
+            definitionBytes = xmlFile.readAll();
+        }
+        if(!result.definition.parse(definitionBytes, localeName, result.errorString)) {
+            //-- A bad cached file is replaced by a fresh download
+            result.download = result.cached;
+            return result;
+        }
+        result.valid = true;
+        if(!result.cached) {
+            QSaveFile xmlFile(cacheFile);
+            if(!xmlFile.open(QIODevice::WriteOnly) || xmlFile.write(definitionBytes) != definitionBytes.size() || !xmlFile.commit()) {
+                qWarning() << QString("Could not save cache file %1. Error: %2").arg(cacheFile).arg(xmlFile.errorString());
+            }
+        }
+        if(!result.definition.save(compiledCacheFile, uri, uriVersion, localeName)) {
+            qWarning() << "Could not save compiled camera definition" << compiledCacheFile;
+        }
+        return result;
+    }));
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraControl::_definitionLoaded()
+{
+    const DefinitionResult_t result = _definitionWatcher.result();
+    if(result.download) {
+        if(!result.errorString.isEmpty()) {
+            qWarning() << "Could not parse cached camera definition file:" << _cacheFile << result.errorString;
+        } else {
+            qCDebug(CameraControlLog) << "No camera definition file cached";
+        }
+        _httpRequest(_definitionUri);
+        return;
+    }
+    if(result.valid) {
+        qCDebug(CameraControlLog) << (result.cached ? "Using cached camera definition:" : "Saved camera definition:") << _cacheFile;
+        _cached = result.cached;
+        if(!_loadSettings(result.definition)) {
+            qWarning() <<  "Unable to load camera parameters from camera definition";
+        }
+    } else {
+        qCritical() << result.errorString;
     }
     _initWhenReady();
 }
@@ -12,11 +12,13 @@
 #pragma once
 
 #include "QGCApplication.h"
+#include "QGCCameraDefinition.h"
 #include <QLoggingCategory>
+#include <QFutureWatcher>
+#include <QSet>
 
-class QDomNode;
-class QDomNodeList;
 class QGCCameraParamIO;
+class QGCCameraParamRequester;
 
 Q_DECLARE_LOGGING_CATEGORY(CameraControlLog)
 Q_DECLARE_LOGGING_CATEGORY(CameraControlVerboseLog)
@@ -64,6 +66,45 @@ public:
     QString param;
     QString value;
     QStringList exclusions;
+    bool        active = false;     ///< param is currently set to value
+};
+
+//-----------------------------------------------------------------------------
+/// Camera option range condition such as "CAM_EXPMODE=1 AND CAM_ISO!=100", compiled once into an expression tree.
+/// Tests are combined left to right, there is no precedence between AND and OR.
+class QGCCameraCondition
+{
+public:
+    /// Compiles the condition against facts, which must already hold the facts it tests. An empty condition is true.
+    void            compile     (const QString& condition, FactGroup* facts);
+    bool            evaluate    () const;
+    /// @return Facts tested by the condition
+    QList<Fact*>    facts       () const;
+
+private:
+    typedef enum {
+        OpInvalid,
+        OpEqual,
+        OpNotEqual,
+        OpGreater,
+        OpSmaller,
+        OpAnd,
+        OpOr
+    } Op_t;
+
+    typedef struct {
+        Op_t    op;
+        Fact*   fact;           ///< Tests only
+        QString value;
+        int     left;           ///< Node indices, AND and OR only
+        int     right;
+    } Node_t;
+
+    int             _compileTest    (const QString& conditionTest, FactGroup* facts);
+    bool            _evaluate       (int node) const;
+
+    QVector<Node_t> _nodes;
+    int             _root = -1;
 };
 
 //-----------------------------------------------------------------------------
@@ -79,6 +120,9 @@ public:
     QStringList  optNames;
     QStringList  optValues;
     QVariantList optVariants;
+    Fact*               paramFact   = nullptr;  ///< Resolved by _processRanges
+    Fact*               targetFact  = nullptr;
+    QGCCameraCondition  compiledCondition;
 };
 
 //-----------------------------------------------------------------------------
@@ -357,26 +401,31 @@ protected slots:
     virtual void    _recTimerHandler        ();
     virtual void    _checkForVideoStreams   ();
 
+private slots:
+    void    _definitionLoaded               ();
+
 private:
-    bool    _handleLocalization             (QByteArray& bytes);
-    bool    _replaceLocaleStrings           (const QDomNode node, QByteArray& bytes);
-    bool    _loadCameraDefinitionFile       (QByteArray& bytes);
-    bool    _loadConstants                  (const QDomNodeList nodeList);
-    bool    _loadSettings                   (const QDomNodeList nodeList);
+    typedef struct {
+        QGCCameraDefinition definition;
+        bool                valid;          ///< definition was loaded
+        bool                cached;         ///< From the caches rather than a download
+        bool                download;       ///< Not in the caches, or the cached file is bad
+        QString             errorString;
+    } DefinitionResult_t;
+
+    bool    _loadSettings                   (const QGCCameraDefinition& definition);
+    void    _loadDefinition                 (const QByteArray& bytes);
     void    _processRanges                  ();
-    bool    _processCondition               (const QString condition);
-    bool    _processConditionTest           (const QString conditionTest);
-    bool    _loadNameValue                  (QDomNode option, const QString factName, FactMetaData* metaData, QString& optName, QString& optValue, QVariant& optVariant);
-    bool    _loadRanges                     (QDomNode option, const QString factName, QString paramValue);
-    void    _updateActiveList               ();
+    void    _processExclusions              ();
+    void    _updateActiveList               (Fact* pFact);
     void    _updateRanges                   (Fact* pFact);
     void    _httpRequest                    (const QString& url);
     void    _handleDefinitionFile           (const QString& url);
 
-    QStringList     _loadExclusions         (QDomNode option);
-    QStringList     _loadUpdates            (QDomNode option);
     QString         _getParamName           (const char* param_id);
 
+    QFutureWatcher<DefinitionResult_t>  _definitionWatcher;
+
 protected:
     Vehicle*                            _vehicle            = nullptr;
     int                                 _compID             = 0;
@@ -389,10 +438,11 @@ protected:
     uint32_t                            _storageFree        = 0;
     uint32_t                            _storageTotal       = 0;
     int                                 _batteryRemaining   = -1;
-    QNetworkAccessManager*              _netManager         = nullptr;
     QString                             _modelName;
     QString                             _vendor;
     QString                             _cacheFile;
+    QString                             _compiledCacheFile;     ///< Parsed definition, see QGCCameraDefinition
+    QString                             _definitionUri;
     CameraMode                          _cameraMode         = CAM_MODE_UNDEFINED;
     StorageStatus                       _storageStatus      = STORAGE_NOT_SUPPORTED;
     PhotoMode                           _photoMode          = PHOTO_CAPTURE_SINGLE;
@@ -405,9 +455,16 @@ protected:
     QTimer                              _captureStatusTimer;
     QList<QGCCameraOptionExclusion*>    _valueExclusions;
     QList<QGCCameraOptionRange*>        _optionRanges;
+    //-- Exclusions and ranges indexed by the facts they depend on, so a change only looks at those it affects
+    QHash<Fact*, QList<QGCCameraOptionExclusion*>> _exclusionsByFact;
+    QHash<Fact*, QList<QGCCameraOptionRange*>>     _rangesByFact;
+    QHash<QString, int>                 _exclusionCounts;           ///< Active exclusions of each parameter
+    QSet<Fact*>                         _staleExclusionFacts;       ///< Changed since their exclusions were last evaluated
+    bool                                _activeListValid    = false;
     QMap<QString, QStringList>          _originalOptNames;
     QMap<QString, QVariantList>         _originalOptValues;
     QMap<QString, QGCCameraParamIO*>    _paramIO;
+    QGCCameraParamRequester*            _paramRequester     = nullptr;
     int                                 _storageInfoRetries = 0;
     int                                 _captureInfoRetries = 0;
     bool                                _resetting          = false;
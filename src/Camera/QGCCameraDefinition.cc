@@ -0,0 +1,469 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCCameraDefinition.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QLocale>
+#include <QPair>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+
+#include <QtDebug>
+
+static const char* kCondition       = "condition";
+static const char* kControl         = "control";
+static const char* kDefault         = "default";
+static const char* kDefnition       = "definition";
+static const char* kDescription     = "description";
+static const char* kExclusion       = "exclude";
+static const char* kExclusions      = "exclusions";
+static const char* kLocale          = "locale";
+static const char* kMax             = "max";
+static const char* kMin             = "min";
+static const char* kModel           = "model";
+static const char* kName            = "name";
+static const char* kOption          = "option";
+static const char* kOptions         = "options";
+static const char* kOriginal        = "original";
+static const char* kParameter       = "parameter";
+static const char* kParameterrange  = "parameterrange";
+static const char* kParameterranges = "parameterranges";
+static const char* kParameters      = "parameters";
+static const char* kReadOnly        = "readonly";
+static const char* kWriteOnly       = "writeonly";
+static const char* kRoption         = "roption";
+static const char* kStep            = "step";
+static const char* kDecimalPlaces   = "decimalPlaces";
+static const char* kStrings         = "strings";
+static const char* kTranslated      = "translated";
+static const char* kType            = "type";
+static const char* kUnit            = "unit";
+static const char* kUpdate          = "update";
+static const char* kUpdates         = "updates";
+static const char* kValue           = "value";
+static const char* kVendor          = "vendor";
+static const char* kVersion         = "version";
+
+//-----------------------------------------------------------------------------
+static bool
+isElement(const QXmlStreamReader& xml, const char* tagName)
+{
+    return xml.name() == QLatin1String(tagName);
+}
+
+//-----------------------------------------------------------------------------
+static bool
+read_attribute(const QXmlStreamAttributes& attributes, const char* name, QString& target)
+{
+    if(!attributes.hasAttribute(QLatin1String(name))) {
+        return false;
+    }
+    target = attributes.value(QLatin1String(name)).toString();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool
+read_bool_attribute(const QXmlStreamAttributes& attributes, const char* name, bool defaultValue)
+{
+    QString value;
+    if(!read_attribute(attributes, name, value)) {
+        return defaultValue;
+    }
+    return value != "0";
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraDefinition::parse(const QByteArray& definitionBytes, const QString& localeName, QString& errorString)
+{
+    QByteArray bytes(definitionBytes);
+    if(localeName != "en_us" && !_translate(bytes, localeName, errorString)) {
+        return false;
+    }
+    version = 0;
+    model.clear();
+    vendor.clear();
+    parameters.clear();
+    bool haveConstants  = false;
+    bool haveParameters = false;
+    QXmlStreamReader xml(bytes);
+    //-- Root element, then the sections we care about
+    if(xml.readNextStartElement()) {
+        while(xml.readNextStartElement()) {
+            if(!haveConstants && isElement(xml, kDefnition)) {
+                _parseConstants(xml);
+                haveConstants = true;
+            } else if(!haveParameters && isElement(xml, kParameters)) {
+                while(xml.readNextStartElement()) {
+                    if(isElement(xml, kParameter)) {
+                        Parameter_t parameter;
+                        _parseParameter(xml, parameter);
+                        parameters.append(parameter);
+                    } else {
+                        xml.skipCurrentElement();
+                    }
+                }
+                haveParameters = true;
+            } else {
+                xml.skipCurrentElement();
+            }
+        }
+    }
+    if(xml.hasError()) {
+        errorString = QString("Unable to parse camera definition file on line %1: %2").arg(xml.lineNumber()).arg(xml.errorString());
+        return false;
+    }
+    if(!haveConstants) {
+        errorString = QStringLiteral("Unable to load camera constants from camera definition");
+        return false;
+    }
+    if(parameters.isEmpty()) {
+        errorString = QStringLiteral("Unable to load camera parameters from camera definition");
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/// Replaces the original strings of the matching locale with their translations. A locale of the same language is
+/// used if there is no direct match.
+bool
+QGCCameraDefinition::_translate(QByteArray& bytes, const QString& localeName, QString& errorString)
+{
+    typedef QList<QPair<QString, QString>> Strings_t;
+    QList<QPair<QString, Strings_t>> locales;
+    bool inLocale = false;
+    QXmlStreamReader xml(bytes);
+    while(!xml.atEnd()) {
+        xml.readNext();
+        if(xml.isStartElement()) {
+            QString name;
+            if(isElement(xml, kLocale)) {
+                if(read_attribute(xml.attributes(), kName, name)) {
+                    locales.append(qMakePair(name.toLower().replace("-", "_"), Strings_t()));
+                    inLocale = true;
+                } else {
+                    qWarning() << "Localization entry is missing its name attribute";
+                }
+            } else if(inLocale && isElement(xml, kStrings)) {
+                QString original;
+                QString translated;
+                if(read_attribute(xml.attributes(), kOriginal, original) && read_attribute(xml.attributes(), kTranslated, translated)) {
+                    locales.last().second.append(qMakePair(original, translated));
+                }
+            }
+        } else if(xml.isEndElement() && isElement(xml, kLocale)) {
+            inLocale = false;
+        }
+    }
+    if(xml.hasError()) {
+        errorString = QString("Unable to parse camera definition file on line %1: %2").arg(xml.lineNumber()).arg(xml.errorString());
+        return false;
+    }
+    if(locales.isEmpty()) {
+        // Nothing to do
+        return true;
+    }
+    const Strings_t* strings = nullptr;
+    for(const auto& locale: locales) {
+        if(locale.first == localeName) {
+            strings = &locale.second;
+            break;
+        }
+    }
+    if(!strings) {
+        //-- No direct match. Pick first matching language (if any)
+        const QString language = localeName.left(3);
+        for(const auto& locale: locales) {
+            if(locale.first.startsWith(language)) {
+                strings = &locale.second;
+                break;
+            }
+        }
+    }
+    if(!strings) {
+        //-- Just use default, en_US
+        qWarning() << "No match for" << localeName << "in camera definition file";
+        return true;
+    }
+    for(const auto& string: *strings) {
+        QString o; o = "\"" + string.first + "\"";
+        QString t; t = "\"" + string.second + "\"";
+        bytes.replace(o.toUtf8(), t.toUtf8());
+        o = ">" + string.first + "<";
+        t = ">" + string.second + "<";
+        bytes.replace(o.toUtf8(), t.toUtf8());
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraDefinition::_parseConstants(QXmlStreamReader& xml)
+{
+    QString versionString;
+    const bool haveVersion = read_attribute(xml.attributes(), kVersion, versionString);
+    bool haveModel  = false;
+    bool haveVendor = false;
+    version = versionString.toInt();
+    while(xml.readNextStartElement()) {
+        if(isElement(xml, kModel)) {
+            model = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+            haveModel = true;
+        } else if(isElement(xml, kVendor)) {
+            vendor = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+            haveVendor = true;
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+    if(!xml.hasError() && !(haveVersion && haveModel && haveVendor)) {
+        xml.raiseError(QStringLiteral("Unable to load camera constants from camera definition"));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraDefinition::_parseParameter(QXmlStreamReader& xml, Parameter_t& parameter)
+{
+    const QXmlStreamAttributes attributes = xml.attributes();
+    if(!read_attribute(attributes, kName, parameter.name)) {
+        xml.raiseError(QStringLiteral("Parameter entry missing parameter name"));
+        return;
+    }
+    QString type;
+    if(!read_attribute(attributes, kType, type)) {
+        xml.raiseError(QString("Parameter %1 missing parameter type").arg(parameter.name));
+        return;
+    }
+    bool unknownType;
+    parameter.type = FactMetaData::stringToType(type, unknownType);
+    if(unknownType) {
+        xml.raiseError(QString("Unknown type for parameter %1").arg(parameter.name));
+        return;
+    }
+    parameter.control   = read_bool_attribute(attributes, kControl,   true);
+    parameter.readOnly  = read_bool_attribute(attributes, kReadOnly,  false);
+    parameter.writeOnly = read_bool_attribute(attributes, kWriteOnly, false);
+    read_attribute(attributes, kDefault,        parameter.defaultValue);
+    read_attribute(attributes, kMin,            parameter.min);
+    read_attribute(attributes, kMax,            parameter.max);
+    read_attribute(attributes, kStep,           parameter.step);
+    read_attribute(attributes, kDecimalPlaces,  parameter.decimalPlaces);
+    read_attribute(attributes, kUnit,           parameter.unit);
+    bool haveDescription = false;
+    while(xml.readNextStartElement()) {
+        if(isElement(xml, kDescription)) {
+            parameter.description = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+            haveDescription = true;
+        } else if(isElement(xml, kUpdates)) {
+            parameter.updates = _parseList(xml, kUpdate);
+        } else if(isElement(xml, kOptions)) {
+            while(xml.readNextStartElement()) {
+                if(isElement(xml, kOption)) {
+                    Option_t option;
+                    _parseOption(xml, parameter.name, option);
+                    parameter.options.append(option);
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+    if(!xml.hasError() && !haveDescription) {
+        xml.raiseError(QString("Parameter %1 missing parameter description").arg(parameter.name));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraDefinition::_parseOption(QXmlStreamReader& xml, const QString& factName, Option_t& option)
+{
+    const QXmlStreamAttributes attributes = xml.attributes();
+    if(!read_attribute(attributes, kName, option.name)) {
+        xml.raiseError(QString("Malformed option for parameter %1").arg(factName));
+        return;
+    }
+    if(!read_attribute(attributes, kValue, option.value)) {
+        xml.raiseError(QString("Malformed value for parameter %1").arg(factName));
+        return;
+    }
+    while(xml.readNextStartElement()) {
+        if(isElement(xml, kExclusions)) {
+            option.exclusions = _parseList(xml, kExclusion);
+        } else if(isElement(xml, kParameterranges)) {
+            while(xml.readNextStartElement()) {
+                if(isElement(xml, kParameterrange)) {
+                    _parseRange(xml, factName, option);
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraDefinition::_parseRange(QXmlStreamReader& xml, const QString& factName, Option_t& option)
+{
+    Range_t range;
+    if(!read_attribute(xml.attributes(), kParameter, range.targetParam)) {
+        xml.raiseError(QString("Malformed option range for parameter %1").arg(factName));
+        return;
+    }
+    read_attribute(xml.attributes(), kCondition, range.condition);
+    while(xml.readNextStartElement()) {
+        if(isElement(xml, kRoption)) {
+            QString optName;
+            QString optValue;
+            if(!read_attribute(xml.attributes(), kName, optName)) {
+                xml.raiseError(QString("Malformed roption for parameter %1").arg(factName));
+                return;
+            }
+            if(!read_attribute(xml.attributes(), kValue, optValue)) {
+                xml.raiseError(QString("Malformed rvalue for parameter %1").arg(factName));
+                return;
+            }
+            range.optNames  << optName;
+            range.optValues << optValue;
+        }
+        xml.skipCurrentElement();
+    }
+    if(range.optNames.size()) {
+        option.ranges.append(range);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// @return Non empty text of the itemTagName children of the current element
+QStringList
+QGCCameraDefinition::_parseList(QXmlStreamReader& xml, const char* itemTagName)
+{
+    QStringList list;
+    while(xml.readNextStartElement()) {
+        if(isElement(xml, itemTagName)) {
+            QString item = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+            if(!item.isEmpty()) {
+                list << item;
+            }
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+    return list;
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraDefinition::save(const QString& filename, const QString& uri, int uriVersion, const QString& localeName) const
+{
+    QSaveFile file(filename);
+    if(!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_11);
+    stream << _magic << _version << uri << static_cast<qint32>(uriVersion) << localeName;
+    stream << static_cast<qint32>(version) << model << vendor << static_cast<quint32>(parameters.count());
+    for(const Parameter_t& parameter: parameters) {
+        stream << parameter.name << static_cast<qint32>(parameter.type)
+               << parameter.control << parameter.readOnly << parameter.writeOnly
+               << parameter.description << parameter.updates
+               << parameter.defaultValue << parameter.min << parameter.max << parameter.step
+               << parameter.decimalPlaces << parameter.unit
+               << static_cast<quint32>(parameter.options.count());
+        for(const Option_t& option: parameter.options) {
+            stream << option.name << option.value << option.exclusions << static_cast<quint32>(option.ranges.count());
+            for(const Range_t& range: option.ranges) {
+                stream << range.targetParam << range.condition << range.optNames << range.optValues;
+            }
+        }
+    }
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraDefinition::load(const QString& filename, const QString& uri, int uriVersion, const QString& localeName)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_11);
+    quint32 magic;
+    quint32 formatVersion;
+    QString fileUri;
+    qint32  fileUriVersion;
+    QString fileLocaleName;
+    stream >> magic >> formatVersion >> fileUri >> fileUriVersion >> fileLocaleName;
+    if(stream.status() != QDataStream::Ok || magic != _magic || formatVersion != _version ||
+            fileUri != uri || fileUriVersion != uriVersion || fileLocaleName != localeName) {
+        return false;
+    }
+    qint32              fileVersion;
+    QString             fileModel;
+    QString             fileVendor;
+    quint32             cParameters;
+    QList<Parameter_t>  fileParameters;
+    stream >> fileVersion >> fileModel >> fileVendor >> cParameters;
+    for(quint32 i = 0; i < cParameters && stream.status() == QDataStream::Ok; i++) {
+        Parameter_t parameter;
+        qint32      type;
+        quint32     cOptions;
+        stream >> parameter.name >> type
+               >> parameter.control >> parameter.readOnly >> parameter.writeOnly
+               >> parameter.description >> parameter.updates
+               >> parameter.defaultValue >> parameter.min >> parameter.max >> parameter.step
+               >> parameter.decimalPlaces >> parameter.unit
+               >> cOptions;
+        parameter.type = static_cast<FactMetaData::ValueType_t>(type);
+        for(quint32 j = 0; j < cOptions && stream.status() == QDataStream::Ok; j++) {
+            Option_t    option;
+            quint32     cRanges;
+            stream >> option.name >> option.value >> option.exclusions >> cRanges;
+            for(quint32 k = 0; k < cRanges && stream.status() == QDataStream::Ok; k++) {
+                Range_t range;
+                stream >> range.targetParam >> range.condition >> range.optNames >> range.optValues;
+                option.ranges.append(range);
+            }
+            parameter.options.append(option);
+        }
+        fileParameters.append(parameter);
+    }
+    if(stream.status() != QDataStream::Ok || fileParameters.isEmpty()) {
+        qWarning() << "Corrupt compiled camera definition" << filename;
+        return false;
+    }
+    version     = fileVersion;
+    model       = fileModel;
+    vendor      = fileVendor;
+    parameters  = fileParameters;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCCameraDefinition::systemLocaleName(void)
+{
+    QLocale locale = QLocale::system();
+#if defined (Q_OS_MAC)
+    locale = QLocale(locale.name());
+#endif
+    return locale.name().toLower().replace("-", "_");
+}
@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "FactMetaData.h"
+
+class QXmlStreamReader;
+
+/// MAVLink camera definition file, parsed into plain data.
+///
+/// Nothing in here touches QObjects, so the definition can be parsed on a worker thread and the Facts built from it on
+/// the GUI thread. A parsed definition can be saved in a compiled form which is keyed by the definition uri, the
+/// cam_definition_version reported by the camera and the locale it was translated for, so a known camera does not
+/// have to be parsed again.
+class QGCCameraDefinition
+{
+public:
+    typedef struct {
+        QString     targetParam;
+        QString     condition;
+        QStringList optNames;
+        QStringList optValues;
+    } Range_t;
+
+    typedef struct {
+        QString         name;
+        QString         value;
+        QStringList     exclusions;
+        QList<Range_t>  ranges;
+    } Option_t;
+
+    /// Optional attributes are empty when they are not in the definition
+    typedef struct {
+        QString                     name;
+        FactMetaData::ValueType_t   type;
+        bool                        control;
+        bool                        readOnly;
+        bool                        writeOnly;
+        QString                     description;
+        QStringList                 updates;
+        QList<Option_t>             options;
+        QString                     defaultValue;
+        QString                     min;
+        QString                     max;
+        QString                     step;
+        QString                     decimalPlaces;
+        QString                     unit;
+    } Parameter_t;
+
+    /// Parses the definition and applies the translations for localeName to it
+    ///     @param localeName Lower case with an underscore, e.g. pt_br
+    /// @return false: errorString says why
+    bool parse(const QByteArray& bytes, const QString& localeName, QString& errorString);
+
+    /// Saves the compiled definition, see load
+    bool save(const QString& filename, const QString& uri, int uriVersion, const QString& localeName) const;
+
+    /// Loads a compiled definition
+    /// @return false: There is no compiled definition in filename for this uri, version and locale
+    bool load(const QString& filename, const QString& uri, int uriVersion, const QString& localeName);
+
+    /// @return Name of the system locale in the form parse expects
+    static QString systemLocaleName(void);
+
+    int                 version = 0;
+    QString             model;
+    QString             vendor;
+    QList<Parameter_t>  parameters;
+
+private:
+    bool _translate         (QByteArray& bytes, const QString& localeName, QString& errorString);
+    void _parseConstants    (QXmlStreamReader& xml);
+    void _parseParameter    (QXmlStreamReader& xml, Parameter_t& parameter);
+    void _parseOption       (QXmlStreamReader& xml, const QString& factName, Option_t& option);
+    void _parseRange        (QXmlStreamReader& xml, const QString& factName, Option_t& option);
+
+    static QStringList _parseList(QXmlStreamReader& xml, const char* itemTagName);
+
+    static const quint32 _magic     = 0x51474344;   ///< QGCD
+    static const quint32 _version   = 1;            ///< Bump with any change to the parser or the format
+};
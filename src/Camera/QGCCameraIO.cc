@@ -18,7 +18,7 @@ QGCCameraParamIO::QGCCameraParamIO(QGCCameraControl *control, Fact* fact, Vehicl
     , _fact(fact)
     , _vehicle(vehicle)
     , _sentRetries(0)
-    , _requestRetries(0)
+    , _paramRequestReceived(false)
     , _done(false)
     , _updateOnSet(false)
     , _forceUIUpdate(false)
@@ -26,13 +26,9 @@ QGCCameraParamIO::QGCCameraParamIO(QGCCameraControl *control, Fact* fact, Vehicl
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
     _paramWriteTimer.setSingleShot(true);
     _paramWriteTimer.setInterval(3000);
-    _paramRequestTimer.setSingleShot(true);
-    _paramRequestTimer.setInterval(3500);
     if(_fact->writeOnly()) {
         //-- Write mode is always "done" as it won't ever read
         _done = true;
-    } else {
-        connect(&_paramRequestTimer, &QTimer::timeout, this, &QGCCameraParamIO::_paramRequestTimeout);
     }
     connect(&_paramWriteTimer,   &QTimer::timeout, this, &QGCCameraParamIO::_paramWriteTimeout);
     connect(_fact, &Fact::rawValueChanged, this, &QGCCameraParamIO::_factChanged);
@@ -89,8 +85,6 @@ QGCCameraParamIO::setParamRequest()
 {
     if(!_fact->writeOnly()) {
         _paramRequestReceived = false;
-        _requestRetries = 0;
-        _paramRequestTimer.start();
     }
 }
 
@@ -258,7 +252,6 @@ QGCCameraParamIO::handleParamAck(const mavlink_param_ext_ack_t& ack)
 void
 QGCCameraParamIO::handleParamValue(const mavlink_param_ext_value_t& value)
 {
-    _paramRequestTimer.stop();
     QVariant newValue = _valueFromMessage(value.param_value, value.param_type);
     if(_control->incomingParameter(_fact, newValue)) {
         _fact->_containerSetRawValue(newValue);
@@ -323,19 +316,12 @@ QGCCameraParamIO::_valueFromMessage(const char* value, uint8_t param_type)
 
 //-----------------------------------------------------------------------------
 void
-QGCCameraParamIO::_paramRequestTimeout()
+QGCCameraParamIO::paramRequestTimedOut()
 {
-    if(++_requestRetries > 3) {
-        qCWarning(CameraIOLog) << "No response for param request:" << _fact->name();
-        if(!_done) {
-            _done = true;
-            _control->_paramDone();
-        }
-    } else {
-        //-- Request it again
-        qCDebug(CameraIOLog) << "Param request retry:" << _fact->name();
-        paramRequest(false);
-        _paramRequestTimer.start();
+    qCWarning(CameraIOLog) << "No response for param request:" << _fact->name();
+    if(!_done) {
+        _done = true;
+        _control->_paramDone();
     }
 }
 
@@ -352,9 +338,15 @@ QGCCameraParamIO::paramRequest(bool reset)
         return;
     }
     if(reset) {
-        _requestRetries = 0;
         _forceUIUpdate  = true;
     }
+    _control->_paramRequester->request(this);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamIO::sendParamRequest()
+{
     qCDebug(CameraIOLog) << "Request parameter:" << _fact->name();
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -376,5 +368,180 @@ QGCCameraParamIO::paramRequest(bool reset)
                     0);                                                 // trimmed messages = false
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
     }
-    _paramRequestTimer.start();
+}
+
+//-----------------------------------------------------------------------------
+QGCCameraParamRequester::QGCCameraParamRequester(QGCCameraControl* control, Vehicle* vehicle)
+    : QObject(control)
+    , _control(control)
+    , _vehicle(vehicle)
+    , _wheel(_wheelSlots)
+{
+    static_assert(readTimeoutMSecs / _tickMSecs < _wheelSlots, "Read timeout does not fit on the timer wheel");
+    _tickTimer.setInterval(_tickMSecs);
+    connect(&_tickTimer, &QTimer::timeout, this, &QGCCameraParamRequester::_tick);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::requestAll(const QList<QGCCameraParamIO*>& params)
+{
+    for(QGCCameraParamIO* paramIO: params) {
+        auto iter = _requests.find(paramIO);
+        if(iter == _requests.end()) {
+            _requests.insert(paramIO, { 0, false, 0 });
+            _queue.append(paramIO);
+        } else {
+            iter->retries = 0;
+        }
+    }
+    if(_listSupport != ListUnsupported) {
+        _sendRequestList();
+        _listValues     = 0;
+        _listDeadline   = _currentTick + _ticks(listTimeoutMSecs);
+    }
+    _startTicking();
+    _fillWindow();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::request(QGCCameraParamIO* paramIO)
+{
+    auto iter = _requests.find(paramIO);
+    if(iter == _requests.end()) {
+        _requests.insert(paramIO, { 0, false, 0 });
+    } else {
+        iter->retries = 0;
+    }
+    _queue.prepend(paramIO);
+    _startTicking();
+    _fillWindow();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::received(QGCCameraParamIO* paramIO)
+{
+    if(_listDeadline) {
+        //-- The list is still streaming in
+        _listValues++;
+        _listDeadline = _currentTick + _ticks(listTimeoutMSecs);
+    }
+    auto iter = _requests.find(paramIO);
+    if(iter != _requests.end()) {
+        if(iter->inFlight) {
+            _inFlight--;
+        }
+        _requests.erase(iter);
+        _fillWindow();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::_sendRequestList()
+{
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+    if (!weakLink.expired()) {
+        SharedLinkInterfacePtr sharedLink = weakLink.lock();
+
+        MAVLinkProtocol* mavlink = qgcApp()->toolbox()->mavlinkProtocol();
+        mavlink_message_t msg;
+        mavlink_msg_param_ext_request_list_pack_chan(
+                    static_cast<uint8_t>(mavlink->getSystemId()),
+                    static_cast<uint8_t>(mavlink->getComponentId()),
+                    sharedLink->mavlinkChannel(),
+                    &msg,
+                    static_cast<uint8_t>(_vehicle->id()),
+                    static_cast<uint8_t>(_control->compID()),
+                    0);                                                 // trimmed messages = false
+        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    }
+    qCDebug(CameraIOLog) << "Request all parameters";
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::_listDone()
+{
+    _listDeadline = 0;
+    if(_listSupport == ListSupportUnknown) {
+        _listSupport = _listValues ? ListSupported : ListUnsupported;
+        if(_listSupport == ListUnsupported) {
+            qCDebug(CameraIOLog) << "No response to PARAM_EXT_REQUEST_LIST, reading parameters one by one";
+        }
+    }
+    qCDebug(CameraIOLog) << "Parameter list done," << _requests.count() << "missing";
+}
+
+//-----------------------------------------------------------------------------
+/// Reads the missing parameters, keeping at most windowSize reads outstanding
+void
+QGCCameraParamRequester::_fillWindow()
+{
+    if(_listDeadline) {
+        return;
+    }
+    while(_inFlight < windowSize && !_queue.isEmpty()) {
+        QGCCameraParamIO* paramIO = _queue.takeFirst();
+        auto iter = _requests.find(paramIO);
+        if(iter == _requests.end() || iter->inFlight) {
+            //-- Received since it was queued, or a duplicate
+            continue;
+        }
+        iter->inFlight = true;
+        iter->deadline = _currentTick + _ticks(readTimeoutMSecs);
+        _wheel[static_cast<int>(iter->deadline % _wheelSlots)].append(paramIO);
+        _inFlight++;
+        paramIO->sendParamRequest();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::_readTimeout(QGCCameraParamIO* paramIO, Request_t& request)
+{
+    request.inFlight = false;
+    _inFlight--;
+    if(++request.retries > maxRetries) {
+        _requests.remove(paramIO);
+        paramIO->paramRequestTimedOut();
+    } else {
+        //-- Request it again once the others had their turn
+        qCDebug(CameraIOLog) << "Param request retry:" << paramIO->fact()->name();
+        _queue.append(paramIO);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::_startTicking()
+{
+    if(!_tickTimer.isActive()) {
+        _tickTimer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraParamRequester::_tick()
+{
+    _currentTick++;
+    if(_listDeadline && _currentTick >= _listDeadline) {
+        _listDone();
+    }
+    QList<QGCCameraParamIO*> expired;
+    expired.swap(_wheel[static_cast<int>(_currentTick % _wheelSlots)]);
+    for(QGCCameraParamIO* paramIO: expired) {
+        auto iter = _requests.find(paramIO);
+        //-- Skip the ones which were received or are on a later read
+        if(iter != _requests.end() && iter->inFlight && iter->deadline == _currentTick) {
+            _readTimeout(paramIO, *iter);
+        }
+    }
+    _fillWindow();
+    if(_requests.isEmpty() && !_listDeadline) {
+        _tickTimer.stop();
+    }
 }
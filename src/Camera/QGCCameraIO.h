@@ -12,7 +12,11 @@
 #pragma once
 
 #include "QGCApplication.h"
+#include <QHash>
+#include <QList>
 #include <QLoggingCategory>
+#include <QTimer>
+#include <QVector>
 
 class QGCCameraControl;
 
@@ -48,15 +52,19 @@ public:
     void        handleParamValue            (const mavlink_param_ext_value_t& value);
     void        setParamRequest             ();
     bool        paramDone                   () { return _done; }
+    Fact*       fact                        () { return _fact; }
     void        paramRequest                (bool reset = true);
     void        sendParameter               (bool updateUI = false);
+    /// Sends PARAM_EXT_REQUEST_READ, called by QGCCameraParamRequester
+    void        sendParamRequest            ();
+    /// Called by QGCCameraParamRequester once it gives up on the parameter
+    void        paramRequestTimedOut        ();
 
     QStringList  optNames;
     QVariantList optVariants;
 
 private slots:
     void        _paramWriteTimeout          ();
-    void        _paramRequestTimeout        ();
     void        _factChanged                (QVariant value);
     void        _containerRawValueChanged   (const QVariant value);
 
@@ -69,10 +77,8 @@ private:
     Fact*               _fact;
     Vehicle*            _vehicle;
     int                 _sentRetries;
-    int                 _requestRetries;
     bool                _paramRequestReceived;
     QTimer              _paramWriteTimer;
-    QTimer              _paramRequestTimer;
     bool                _done;
     bool                _updateOnSet;
     MAV_PARAM_EXT_TYPE  _mavParamType;
@@ -80,3 +86,66 @@ private:
     bool                _forceUIUpdate;
 };
 
+//-----------------------------------------------------------------------------
+/// Requests the camera parameters for QGCCameraControl.
+///
+/// A full request goes out as a single PARAM_EXT_REQUEST_LIST, the camera streams the values back and the list is
+/// considered done once they stop coming. The parameters which did not make it are then read one by one with
+/// PARAM_EXT_REQUEST_READ, at most windowSize at a time so the link shared with the gimbal is not flooded. Cameras
+/// which do not answer the list request are only read one by one from then on. All the timeouts run off a single
+/// timer wheel rather than a timer per parameter.
+class QGCCameraParamRequester : public QObject
+{
+public:
+    QGCCameraParamRequester(QGCCameraControl* control, Vehicle* vehicle);
+
+    /// Requests all of params, which must not be write only
+    void        requestAll                  (const QList<QGCCameraParamIO*>& params);
+    /// Requests a single parameter ahead of the others which are waiting
+    void        request                     (QGCCameraParamIO* paramIO);
+    /// Must be called for every PARAM_EXT_VALUE of a known parameter
+    void        received                    (QGCCameraParamIO* paramIO);
+
+    static const int windowSize         = 4;
+    static const int maxRetries         = 3;
+    static const int listTimeoutMSecs   = 3500;     ///< Since the last value streamed back for the list request
+    static const int readTimeoutMSecs   = 2000;
+
+private slots:
+    void        _tick                       ();
+
+private:
+    typedef enum {
+        ListSupportUnknown,
+        ListSupported,
+        ListUnsupported
+    } ListSupport_t;
+
+    typedef struct {
+        int     retries;
+        bool    inFlight;
+        quint64 deadline;                   ///< Tick of the read timeout
+    } Request_t;
+
+    void        _sendRequestList            ();
+    void        _listDone                   ();
+    void        _fillWindow                 ();
+    void        _readTimeout                (QGCCameraParamIO* paramIO, Request_t& request);
+    void        _startTicking               ();
+    static quint64 _ticks                   (int msecs) { return static_cast<quint64>(qMax(1, msecs / _tickMSecs)); }
+
+    QGCCameraControl*                       _control;
+    Vehicle*                                _vehicle;
+    QTimer                                  _tickTimer;
+    quint64                                 _currentTick    = 0;
+    QVector<QList<QGCCameraParamIO*>>       _wheel;                     ///< Read timeouts by tick, modulo _wheelSlots
+    QHash<QGCCameraParamIO*, Request_t>     _requests;                  ///< Not received yet
+    QList<QGCCameraParamIO*>                _queue;                     ///< Waiting for a read, may hold entries which were received since
+    int                                     _inFlight       = 0;
+    quint64                                 _listDeadline   = 0;        ///< 0: No list request outstanding
+    int                                     _listValues     = 0;        ///< Received for the outstanding list request
+    ListSupport_t                           _listSupport    = ListSupportUnknown;
+
+    static const int _tickMSecs     = 100;
+    static const int _wheelSlots    = 64;   ///< Has to cover readTimeoutMSecs
+};
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "Fact.h"
+#include "FactGroup.h"
 #include "FactValueSliderListModel.h"
 #include "QGCMAVLink.h"
 #include "QGCApplication.h"
@@ -85,6 +86,11 @@ void Fact::_init(void)
     connect(this, &Fact::_containerRawValueChanged, this, &Fact::_checkForRebootMessaging);
 }
 
+Fact::~Fact()
+{
+    _setDeferredValueChangeSignal(false);
+}
+
 const Fact& Fact::operator=(const Fact& other)
 {
     _name                       = other._name;
@@ -92,7 +98,7 @@ const Fact& Fact::operator=(const Fact& other)
     _rawValue                   = other._rawValue;
     _type                       = other._type;
     _sendValueChangedSignals    = other._sendValueChangedSignals;
-    _deferredValueChangeSignal  = other._deferredValueChangeSignal;
+    _setDeferredValueChangeSignal(other._deferredValueChangeSignal);
     _valueSliderModel           = nullptr;
     _ignoreQGCRebootRequired    = other._ignoreQGCRebootRequired;
     if (_metaData && other._metaData) {
@@ -100,6 +106,7 @@ const Fact& Fact::operator=(const Fact& other)
     } else {
         _metaData = nullptr;
     }
+    _clearValueStringCache();
     
     return *this;
 }
@@ -112,6 +119,7 @@ void Fact::forceSetRawValue(const QVariant& value)
         
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
             _rawValue.setValue(typedValue);
+            _clearValueStringCache();
             _sendValueChangedSignal(cookedValue());
             //-- Must be in this order
             emit _containerRawValueChanged(rawValue());
@@ -131,6 +139,7 @@ void Fact::setRawValue(const QVariant& value)
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
             if (typedValue != _rawValue) {
                 _rawValue.setValue(typedValue);
+                _clearValueStringCache();
                 _sendValueChangedSignal(cookedValue());
                 //-- Must be in this order
                 emit _containerRawValueChanged(rawValue());
@@ -181,6 +190,7 @@ void Fact::_containerSetRawValue(const QVariant& value)
 {
     if(_rawValue != value) {
         _rawValue = value;
+        _clearValueStringCache();
         _sendValueChangedSignal(cookedValue());
         emit rawValueChanged(_rawValue);
     }
@@ -189,6 +199,32 @@ void Fact::_containerSetRawValue(const QVariant& value)
     emit vehicleUpdated(_rawValue);
 }
 
+bool Fact::_containerSetRawValueBatched(const QVariant& value)
+{
+    bool added = false;
+
+    if (_rawValue != value) {
+        _rawValue = value;
+        _clearValueStringCache();
+        added = !_batchedValueChange;
+        _batchedValueChange = true;
+    }
+
+    // Writes waiting on the vehicle don't wait for the batch
+    emit vehicleUpdated(_rawValue);
+
+    return added;
+}
+
+void Fact::_sendBatchedValueChangedSignals(void)
+{
+    if (_batchedValueChange) {
+        _batchedValueChange = false;
+        _sendValueChangedSignal(cookedValue());
+        emit rawValueChanged(_rawValue);
+    }
+}
+
 QString Fact::name(void) const
 {
     return _name;
@@ -364,7 +400,13 @@ QString Fact::rawValueString(void) const
 
 QString Fact::cookedValueString(void) const
 {
-    return _variantToString(cookedValue(), decimalPlaces());
+    uint formatGeneration = FactMetaData::formatGeneration();
+    if (!_cookedValueStringValid || _cookedValueStringGeneration != formatGeneration) {
+        _cookedValueString              = _variantToString(cookedValue(), decimalPlaces());
+        _cookedValueStringValid         = true;
+        _cookedValueStringGeneration    = formatGeneration;
+    }
+    return _cookedValueString;
 }
 
 QVariant Fact::rawDefaultValue(void) const
@@ -546,6 +588,7 @@ QString Fact::group(void) const
 void Fact::setMetaData(FactMetaData* metaData, bool setDefaultFromMetaData)
 {
     _metaData = metaData;
+    _clearValueStringCache();
     if (setDefaultFromMetaData && metaData->defaultValueAvailable()) {
         setRawValue(rawDefaultValue());
     }
@@ -641,20 +684,51 @@ void Fact::_sendValueChangedSignal(QVariant value)
 {
     if (_sendValueChangedSignals) {
         emit valueChanged(value);
-        _deferredValueChangeSignal = false;
+        _setDeferredValueChangeSignal(false);
     } else {
-        _deferredValueChangeSignal = true;
+        _setDeferredValueChangeSignal(true);
     }
 }
 
 void Fact::sendDeferredValueChangedSignal(void)
 {
+    if (_deferredValueChangeSignal) {
+        _setDeferredValueChangeSignal(false);
+        emit valueChanged(cookedValue());
+    }
+}
+
+void Fact::_flushDeferredValueChangedSignal(void)
+{
+    // Called by the owning group while it flushes, it has already taken the fact off its list
     if (_deferredValueChangeSignal) {
         _deferredValueChangeSignal = false;
         emit valueChanged(cookedValue());
     }
 }
 
+void Fact::_setDeferredOwner(FactGroup* owner)
+{
+    bool deferred = _deferredValueChangeSignal;
+
+    _setDeferredValueChangeSignal(false);
+    _deferredOwner = owner;
+    _setDeferredValueChangeSignal(deferred);
+}
+
+/// Keeps the owning group's list of deferred facts in sync with the deferred flag
+void Fact::_setDeferredValueChangeSignal(bool deferred)
+{
+    if (_deferredOwner && deferred != _deferredValueChangeSignal) {
+        if (deferred) {
+            _deferredOwner->_factValueDeferred(this);
+        } else {
+            _deferredOwner->_removeDeferredFact(this);
+        }
+    }
+    _deferredValueChangeSignal = deferred;
+}
+
 QString Fact::enumOrValueString(void)
 {
     if (_metaData) {
@@ -18,11 +18,14 @@
 #include <QAbstractListModel>
 
 class FactValueSliderListModel;
+class FactGroup;
 
 /// @brief A Fact is used to hold a single value within the system.
 class Fact : public QObject
 {
     Q_OBJECT
+
+    friend class FactGroup;
     
 public:
     Fact(QObject* parent = nullptr);
@@ -33,6 +36,8 @@ public:
     /// custom builds to override the metadata.
     Fact(const QString& settingsGroup, FactMetaData* metaData, QObject* parent = nullptr);
 
+    ~Fact();
+
     const Fact& operator=(const Fact& other);
 
     Q_PROPERTY(int          componentId             READ componentId                                        CONSTANT)
@@ -146,7 +151,7 @@ public:
     void setSendValueChangedSignals (bool sendValueChangedSignals);
     bool sendValueChangedSignals (void) const { return _sendValueChangedSignals; }
     bool deferredValueChangeSignal(void) const { return _deferredValueChangeSignal; }
-    void clearDeferredValueChangeSignal(void) { _deferredValueChangeSignal = false; }
+    void clearDeferredValueChangeSignal(void) { _setDeferredValueChangeSignal(false); }
     void sendDeferredValueChangedSignal(void);
 
     // C++ methods
@@ -163,6 +168,12 @@ public:
 
     //-- Value coming from Vehicle. This does NOT send a _containerRawValueChanged signal.
     void _containerSetRawValue(const QVariant& value);
+
+    /// Value coming from the vehicle during a ParameterManager update batch. valueChanged and rawValueChanged are held
+    /// until _sendBatchedValueChangedSignals.
+    ///     @return true: the Fact wasn't already holding a change for the batch
+    bool _containerSetRawValueBatched(const QVariant& value);
+    void _sendBatchedValueChangedSignals(void);
     
     /// Generally you should not change the name of a fact. But if you know what you are doing, you can.
     void _setName(const QString& name) { _name = name; }
@@ -195,10 +206,14 @@ private slots:
 
 private:
     void _init(void);
+    void _setDeferredOwner              (FactGroup* owner);
+    void _flushDeferredValueChangedSignal(void);
     
 protected:
     QString _variantToString(const QVariant& variant, int decimalPlaces) const;
+    void _clearValueStringCache(void) { _cookedValueStringValid = false; }  ///< Must be called when _rawValue is changed directly
     void _sendValueChangedSignal(QVariant value);
+    void _setDeferredValueChangeSignal(bool deferred);
 
     QString                     _name;
     int                         _componentId;
@@ -209,4 +224,12 @@ protected:
     bool                        _deferredValueChangeSignal;
     FactValueSliderListModel*   _valueSliderModel;
     bool                        _ignoreQGCRebootRequired;
+    FactGroup*                  _deferredOwner = nullptr;   ///< Group which is told about deferred value changes so it only flushes changed facts
+    bool                        _batchedValueChange = false;///< true: value changed during a parameter update batch, signals not sent yet
+
+    // cookedValueString is read by every binding to valueString, so the formatted string is held until the value or
+    // its formatting changes
+    mutable QString             _cookedValueString;
+    mutable bool                _cookedValueStringValid         = false;
+    mutable uint                _cookedValueStringGeneration    = 0;    ///< FactMetaData::formatGeneration the string was built for
 };
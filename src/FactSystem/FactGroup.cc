@@ -9,6 +9,7 @@
 
 
 #include "FactGroup.h"
+#include "FactGroupScheduler.h"
 #include "JsonHelper.h"
 
 #include <QJsonDocument>
@@ -37,6 +38,23 @@ FactGroup::FactGroup(int updateRateMsecs, QObject* parent, bool ignoreCamelCase)
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
 }
 
+FactGroup::~FactGroup()
+{
+    if (_updateRateMSecs > 0) {
+        FactGroupScheduler::instance()->removeGroup(this);
+    }
+
+    // Facts which outlive us must not report back in
+    for (Fact* fact: _deferredFacts) {
+        fact->_deferredOwner = nullptr;
+    }
+    for (Fact* fact: _flushingFacts) {
+        if (fact) {
+            fact->_deferredOwner = nullptr;
+        }
+    }
+}
+
 void FactGroup::_loadFromJsonArray(const QJsonArray jsonArray)
 {
     QMap<QString, QString> defineMap;
@@ -46,10 +64,7 @@ void FactGroup::_loadFromJsonArray(const QJsonArray jsonArray)
 void FactGroup::_setupTimer()
 {
     if (_updateRateMSecs > 0) {
-        connect(&_updateTimer, &QTimer::timeout, this, &FactGroup::_updateAllValues);
-        _updateTimer.setSingleShot(false);
-        _updateTimer.setInterval(_updateRateMSecs);
-        _updateTimer.start();
+        FactGroupScheduler::instance()->addGroup(this);
     }
 }
 
@@ -130,6 +145,7 @@ void FactGroup::_addFact(Fact* fact, const QString& name)
     }
 
     fact->setSendValueChangedSignals(_updateRateMSecs == 0);
+    fact->_setDeferredOwner(this);
     if (_nameToFactMetaDataMap.contains(name)) {
         fact->setMetaData(_nameToFactMetaDataMap[name], true /* setDefaultFromMetaData */);
     }
@@ -153,25 +169,86 @@ void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
 
 void FactGroup::_updateAllValues(void)
 {
-    for(Fact* fact: _nameToFactMap) {
-        fact->sendDeferredValueChangedSignal();
+    _flushDeferredFacts();
+}
+
+void FactGroup::_flushDeferredFacts(void)
+{
+    if (_deferredFacts.isEmpty()) {
+        return;
+    }
+
+    // Only the facts which changed since the last update are in the list. Changes made from within valueChanged
+    // handlers land in the now empty _deferredFacts and go out with the next update.
+    _flushingFacts.swap(_deferredFacts);
+    for (int i=0; i<_flushingFacts.count(); i++) {
+        Fact* fact = _flushingFacts[i];
+        if (fact) {
+            fact->_flushDeferredValueChangedSignal();
+        }
     }
+    _flushingFacts.clear();
 }
 
-void FactGroup::setLiveUpdates(bool liveUpdates)
+void FactGroup::_factValueDeferred(Fact* fact)
 {
-    if (_updateTimer.interval() == 0) {
+    _deferredFacts.append(fact);
+}
+
+void FactGroup::_removeDeferredFact(Fact* fact)
+{
+    _deferredFacts.removeOne(fact);
+    int index = _flushingFacts.indexOf(fact);
+    if (index != -1) {
+        _flushingFacts[index] = nullptr;
+    }
+}
+
+void FactGroup::setUpdateRateMSecs(int updateRateMSecs)
+{
+    updateRateMSecs = qMax(0, updateRateMSecs);
+    if (updateRateMSecs == _updateRateMSecs) {
         return;
     }
 
-    if (liveUpdates) {
-        _updateTimer.stop();
+    bool wasDeferred = _updateRateMSecs > 0;
+    _updateRateMSecs = updateRateMSecs;
+
+    if (wasDeferred && _updateRateMSecs == 0) {
+        FactGroupScheduler::instance()->removeGroup(this);
+        for (Fact* fact: _nameToFactMap) {
+            fact->setSendValueChangedSignals(true);
+        }
+        _flushDeferredFacts();
+    } else if (!wasDeferred) {
+        FactGroupScheduler::instance()->addGroup(this);
+        for (Fact* fact: _nameToFactMap) {
+            fact->setSendValueChangedSignals(_liveUpdates);
+        }
     } else {
-        _updateTimer.start();
+        FactGroupScheduler::instance()->updateGroup(this);
     }
+
+    emit updateRateMSecsChanged(_updateRateMSecs);
+}
+
+void FactGroup::setLiveUpdates(bool liveUpdates)
+{
+    if (_updateRateMSecs == 0) {
+        return;
+    }
+
     for(Fact* fact: _nameToFactMap) {
         fact->setSendValueChangedSignals(liveUpdates);
     }
+    if (liveUpdates) {
+        // Don't leave the last changes from before live updates stuck until live updates are turned off again
+        _flushDeferredFacts();
+    }
+    if (liveUpdates != _liveUpdates) {
+        _liveUpdates = liveUpdates;
+        emit liveUpdatesChanged(liveUpdates);
+    }
 }
 
 
@@ -180,6 +257,12 @@ QString FactGroup::_camelCase(const QString& text)
     return text[0].toLower() + text.right(text.length() - 1);
 }
 
+void FactGroup::_setHandledMessageIds(const QList<uint32_t>& messageIds)
+{
+    _handlesAllMessages = false;
+    _handledMessageIds  = messageIds;
+}
+
 void FactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& /* message */)
 {
     // Default implementation does nothing
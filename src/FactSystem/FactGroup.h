@@ -16,6 +16,7 @@
 #include <QStringList>
 #include <QMap>
 #include <QTimer>
+#include <QVector>
 
 class Vehicle;
 
@@ -23,14 +24,19 @@ class Vehicle;
 class FactGroup : public QObject
 {
     Q_OBJECT
+
+    friend class Fact;                  // Allow Fact to report deferred value changes
+    friend class FactGroupScheduler;    // Allow FactGroupScheduler to call _updateAllValues
     
 public:
     FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent = nullptr, bool ignoreCamelCase = false);
     FactGroup(int updateRateMsecs, QObject* parent = nullptr, bool ignoreCamelCase = false);
+    ~FactGroup();
 
     Q_PROPERTY(QStringList  factNames           READ factNames          NOTIFY factNamesChanged)
     Q_PROPERTY(QStringList  factGroupNames      READ factGroupNames     NOTIFY factGroupNamesChanged)
     Q_PROPERTY(bool         telemetryAvailable  READ telemetryAvailable NOTIFY telemetryAvailableChanged)   ///< false: No telemetry for these values has been received
+    Q_PROPERTY(int          updateRateMSecs     READ updateRateMSecs    WRITE setUpdateRateMSecs NOTIFY updateRateMSecsChanged)
 
     /// @ return true: if the fact exists in the group
     Q_INVOKABLE bool factExists(const QString& name);
@@ -46,6 +52,16 @@ public:
     /// Turning on live updates will allow value changes to flow through as they are received.
     Q_INVOKABLE void setLiveUpdates(bool liveUpdates);
 
+    bool liveUpdates(void) const { return _liveUpdates; }
+
+    /// @return Rate at which deferred value changes are sent out, 0: immediate update
+    int updateRateMSecs(void) const { return _updateRateMSecs; }
+
+    /// Changes the rate at which valueChanged goes out. Only valueChanged is paced, rawValueChanged is still sent for
+    /// every new value so logging and other internal consumers see all samples.
+    ///     @param updateRateMSecs 0: immediate update
+    void setUpdateRateMSecs(int updateRateMSecs);
+
     QStringList factNames           (void) const { return _factNames; }
     QStringList factGroupNames      (void) const { return _nameToFactGroupMap.keys(); }
     bool        telemetryAvailable  (void) const { return _telemetryAvailable; }
@@ -54,10 +70,16 @@ public:
     /// Allows a FactGroup to parse incoming messages and fill in values
     virtual void handleMessage(Vehicle* vehicle, mavlink_message_t& message);
 
+    /// @return true: handleMessage is called for every message, false: only for the ids in handledMessageIds
+    bool                    handlesAllMessages  (void) const { return _handlesAllMessages; }
+    const QList<uint32_t>&  handledMessageIds   (void) const { return _handledMessageIds; }
+
 signals:
     void factNamesChanged           (void);
     void factGroupNamesChanged      (void);
     void telemetryAvailableChanged  (bool telemetryAvailable);
+    void liveUpdatesChanged         (bool liveUpdates);
+    void updateRateMSecsChanged     (int updateRateMSecs);
 
 protected slots:
     virtual void _updateAllValues(void);
@@ -68,6 +90,10 @@ protected:
     void _loadFromJsonArray     (const QJsonArray jsonArray);
     void _setTelemetryAvailable (bool telemetryAvailable);
 
+    /// Restricts handleMessage to the specified message ids. This allows Vehicle to dispatch directly to
+    /// the groups which care about a message instead of passing every message to every group.
+    void _setHandledMessageIds  (const QList<uint32_t>& messageIds);
+
     int  _updateRateMSecs;   ///< Update rate for Fact::valueChanged signals, 0: immediate update
 
     QMap<QString, Fact*>            _nameToFactMap;
@@ -76,10 +102,19 @@ protected:
     QStringList                     _factNames;
 
 private:
-    void    _setupTimer (void);
-    QString _camelCase  (const QString& text);
+    void    _setupTimer         (void);
+    QString _camelCase          (const QString& text);
+    void    _factValueDeferred  (Fact* fact);
+    void    _removeDeferredFact (Fact* fact);
+    void    _flushDeferredFacts (void);
 
     bool    _ignoreCamelCase    = false;
-    QTimer  _updateTimer;
     bool    _telemetryAvailable = false;
+    bool    _liveUpdates        = false;
+
+    bool            _handlesAllMessages = true;
+    QList<uint32_t> _handledMessageIds;
+
+    QVector<Fact*>  _deferredFacts;     ///< Facts with value changes since the last update
+    QVector<Fact*>  _flushingFacts;     ///< Facts being sent out by the current update, swapped with _deferredFacts
 };
@@ -0,0 +1,143 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactGroupScheduler.h"
+#include "FactGroup.h"
+#include "QGCInstrumentation.h"
+
+QGC_INSTRUMENT_HISTOGRAM(_instrumentFrame, "FactGroup.Frame")
+
+static FactGroupScheduler* _factGroupSchedulerInstance = nullptr;
+
+FactGroupScheduler* FactGroupScheduler::instance(void)
+{
+    if (!_factGroupSchedulerInstance) {
+        _factGroupSchedulerInstance = new FactGroupScheduler();
+        Q_CHECK_PTR(_factGroupSchedulerInstance);
+    }
+
+    return _factGroupSchedulerInstance;
+}
+
+FactGroupScheduler::FactGroupScheduler(void)
+{
+    _frameTimer.setSingleShot(false);
+    _frameTimer.setInterval(defaultFrameMSecs);
+    connect(&_frameTimer, &QTimer::timeout, this, &FactGroupScheduler::_frame);
+    _clock.start();
+}
+
+void FactGroupScheduler::setFrameMSecs(int frameMSecs)
+{
+    _frameTimer.setInterval(qMax(1, frameMSecs));
+}
+
+void FactGroupScheduler::setMinUpdateMSecs(int minUpdateMSecs)
+{
+    minUpdateMSecs = qMax(0, minUpdateMSecs);
+    if (minUpdateMSecs == _minUpdateMSecs) {
+        return;
+    }
+    _minUpdateMSecs = minUpdateMSecs;
+
+    // Realign everyone, so on the way back to normal rates the held back changes go out right away
+    qint64 nowMSecs = _clock.elapsed();
+    for (Group_t& group: _groups) {
+        if (group.factGroup) {
+            group.nextUpdateMSecs = _alignedMSecs(nowMSecs, _groupRateMSecs(group.factGroup));
+        }
+    }
+}
+
+void FactGroupScheduler::addGroup(FactGroup* factGroup)
+{
+    _groups.append({ factGroup, _alignedMSecs(_clock.elapsed(), _groupRateMSecs(factGroup)) });
+    if (!_frameTimer.isActive()) {
+        _frameTimer.start();
+    }
+}
+
+void FactGroupScheduler::removeGroup(FactGroup* factGroup)
+{
+    for (int i=0; i<_groups.count(); i++) {
+        if (_groups[i].factGroup == factGroup) {
+            if (_inFrame) {
+                // Can't shift entries out from under _frame, the slot is compacted at the end of the frame
+                _groups[i].factGroup = nullptr;
+                _groupsRemoved = true;
+            } else {
+                _groups.remove(i);
+            }
+            break;
+        }
+    }
+    if (_groups.isEmpty()) {
+        _frameTimer.stop();
+    }
+}
+
+void FactGroupScheduler::updateGroup(FactGroup* factGroup)
+{
+    for (int i=0; i<_groups.count(); i++) {
+        if (_groups[i].factGroup == factGroup) {
+            // Anything pending goes out on the first frame aligned to the new rate
+            _groups[i].nextUpdateMSecs = _alignedMSecs(_clock.elapsed(), _groupRateMSecs(factGroup));
+            break;
+        }
+    }
+}
+
+/// Next multiple of the update rate after nowMSecs. Keeps all groups with the same rate flushing in the same frame.
+qint64 FactGroupScheduler::_alignedMSecs(qint64 nowMSecs, int updateRateMSecs)
+{
+    return ((nowMSecs / updateRateMSecs) + 1) * updateRateMSecs;
+}
+
+/// Group update rate, held back to the minimum interval if one is set
+int FactGroupScheduler::_groupRateMSecs(FactGroup* factGroup) const
+{
+    return qMax(factGroup->updateRateMSecs(), _minUpdateMSecs);
+}
+
+void FactGroupScheduler::_frame(void)
+{
+    QGC_INSTRUMENT_SCOPE(_instrumentFrame);
+
+    qint64 nowMSecs = _clock.elapsed();
+
+    _inFrame = true;
+    // Groups added during the frame are picked up on the next one
+    int groupCount = _groups.count();
+    for (int i=0; i<groupCount; i++) {
+        FactGroup* factGroup = _groups[i].factGroup;
+        if (!factGroup || nowMSecs < _groups[i].nextUpdateMSecs) {
+            continue;
+        }
+
+        int updateRateMSecs = _groupRateMSecs(factGroup);
+        _groups[i].nextUpdateMSecs += updateRateMSecs;
+        if (_groups[i].nextUpdateMSecs <= nowMSecs) {
+            // Fell behind, don't try to catch up with a burst of updates
+            _groups[i].nextUpdateMSecs = _alignedMSecs(nowMSecs, updateRateMSecs);
+        }
+        if (!factGroup->liveUpdates()) {
+            factGroup->_updateAllValues();
+        }
+    }
+    _inFrame = false;
+
+    if (_groupsRemoved) {
+        _groupsRemoved = false;
+        for (int i=_groups.count() - 1; i>=0; i--) {
+            if (!_groups[i].factGroup) {
+                _groups.remove(i);
+            }
+        }
+    }
+}
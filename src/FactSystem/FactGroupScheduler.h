@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+
+class FactGroup;
+
+/// Single frame clock which drives the rate limited updates of all FactGroups.
+///
+/// Instead of each FactGroup running its own timer, groups register here and are flushed from one timer. On each
+/// frame every group whose update rate has elapsed sends out the value changes which were deferred since its last
+/// update. Groups with the same update rate are flushed in the same frame, so QML sees one burst of changes per frame
+/// instead of a steady trickle from many unsynchronized timers.
+class FactGroupScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static FactGroupScheduler* instance(void);
+
+    void addGroup   (FactGroup* factGroup);
+    void removeGroup(FactGroup* factGroup);
+    void updateGroup(FactGroup* factGroup);     ///< Call when the group's update rate changed
+
+    /// Frame interval, group update rates are rounded up to a multiple of this
+    int  frameMSecs     (void) const { return _frameTimer.interval(); }
+    void setFrameMSecs  (int frameMSecs);
+
+    /// Shortest interval between updates for all groups, used to throttle the UI in low power mode. 0: groups run at their own rate
+    int  minUpdateMSecs     (void) const { return _minUpdateMSecs; }
+    void setMinUpdateMSecs  (int minUpdateMSecs);
+
+    int  groupCount     (void) const { return _groups.count(); }   ///< Number of registered groups, may include removed slots during a frame
+
+    static const int defaultFrameMSecs = 50;
+
+private slots:
+    void _frame(void);
+
+private:
+    FactGroupScheduler(void);
+
+    static qint64 _alignedMSecs(qint64 nowMSecs, int updateRateMSecs);
+    int           _groupRateMSecs(FactGroup* factGroup) const;
+
+    typedef struct {
+        FactGroup*  factGroup;
+        qint64      nextUpdateMSecs;
+    } Group_t;
+
+    QVector<Group_t>    _groups;
+    QTimer              _frameTimer;
+    QElapsedTimer       _clock;
+    int                 _minUpdateMSecs = 0;
+    bool                _inFrame        = false;
+    bool                _groupsRemoved  = false;    ///< Groups were removed during a frame and need to be compacted
+};
@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactGroupSchedulerTest.h"
+#include "FactGroupScheduler.h"
+#include "FactGroup.h"
+
+#include <QSignalSpy>
+
+namespace {
+
+class TestFactGroup : public FactGroup
+{
+public:
+    TestFactGroup(int updateRateMSecs)
+        : FactGroup (updateRateMSecs)
+        , fact1     (0, "fact1", FactMetaData::valueTypeDouble)
+        , fact2     (0, "fact2", FactMetaData::valueTypeDouble)
+    {
+        _addFact(&fact1, "fact1");
+        _addFact(&fact2, "fact2");
+    }
+
+    void addDynamicFact(Fact* fact) { _addFact(fact, fact->name()); }
+
+    Fact fact1;
+    Fact fact2;
+};
+
+}
+
+void FactGroupSchedulerTest::_changedOnly_test(void)
+{
+    TestFactGroup factGroup(100);
+    QSignalSpy spy1(&factGroup.fact1, &Fact::valueChanged);
+    QSignalSpy spy2(&factGroup.fact2, &Fact::valueChanged);
+
+    // Several changes between frames go out as a single signal with the last value
+    factGroup.fact1.setRawValue(1.0);
+    factGroup.fact1.setRawValue(2.0);
+    QCOMPARE(spy1.count(), 0);
+
+    QVERIFY(spy1.wait(1000));
+    QCOMPARE(spy1.count(), 1);
+    QCOMPARE(spy1.at(0).at(0).toDouble(), 2.0);
+
+    // Unchanged facts stay quiet
+    QTest::qWait(300);
+    QCOMPARE(spy1.count(), 1);
+    QCOMPARE(spy2.count(), 0);
+}
+
+void FactGroupSchedulerTest::_liveUpdates_test(void)
+{
+    TestFactGroup factGroup(1000);
+    QSignalSpy spy(&factGroup.fact1, &Fact::valueChanged);
+
+    // A pending change is flushed as soon as live updates are turned on
+    factGroup.fact1.setRawValue(1.0);
+    factGroup.setLiveUpdates(true);
+    QCOMPARE(spy.count(), 1);
+
+    factGroup.fact1.setRawValue(2.0);
+    QCOMPARE(spy.count(), 2);
+
+    factGroup.setLiveUpdates(false);
+    factGroup.fact1.setRawValue(3.0);
+    QCOMPARE(spy.count(), 2);
+}
+
+void FactGroupSchedulerTest::_factDestroyed_test(void)
+{
+    TestFactGroup   factGroup(100);
+    Fact*           fact = new Fact(0, "dynamic", FactMetaData::valueTypeDouble);
+    QSignalSpy      spy(&factGroup.fact1, &Fact::valueChanged);
+
+    factGroup.addDynamicFact(fact);
+    fact->setRawValue(1.0);
+    factGroup.fact1.setRawValue(1.0);
+    delete fact;
+
+    // The deleted fact must have been taken out of the pending list
+    QVERIFY(spy.wait(1000));
+    QCOMPARE(spy.count(), 1);
+}
+
+void FactGroupSchedulerTest::_groupRegister_test(void)
+{
+    FactGroupScheduler* scheduler   = FactGroupScheduler::instance();
+    int                 groupCount  = scheduler->groupCount();
+
+    {
+        TestFactGroup rateLimitedGroup(100);
+        TestFactGroup immediateGroup(0);
+        QCOMPARE(scheduler->groupCount(), groupCount + 1);
+    }
+    QCOMPARE(scheduler->groupCount(), groupCount);
+}
+
+void FactGroupSchedulerTest::_updateRateChange_test(void)
+{
+    FactGroupScheduler* scheduler   = FactGroupScheduler::instance();
+    int                 groupCount  = scheduler->groupCount();
+    TestFactGroup       factGroup(100);
+    QSignalSpy          valueSpy(&factGroup.fact1, &Fact::valueChanged);
+    QSignalSpy          rawValueSpy(&factGroup.fact1, &Fact::rawValueChanged);
+
+    // Slower rate holds back the display update but every raw value still goes out
+    factGroup.setUpdateRateMSecs(1000);
+    factGroup.fact1.setRawValue(1.0);
+    factGroup.fact1.setRawValue(2.0);
+    QCOMPARE(rawValueSpy.count(), 2);
+    QTest::qWait(300);
+    QCOMPARE(valueSpy.count(), 0);
+    QVERIFY(valueSpy.wait(1500));
+    QCOMPARE(valueSpy.count(), 1);
+
+    // Going to immediate updates sends what is pending and takes the group off the scheduler
+    factGroup.fact1.setRawValue(3.0);
+    factGroup.setUpdateRateMSecs(0);
+    QCOMPARE(valueSpy.count(), 2);
+    QCOMPARE(scheduler->groupCount(), groupCount);
+    factGroup.fact1.setRawValue(4.0);
+    QCOMPARE(valueSpy.count(), 3);
+
+    // And back to rate limited
+    factGroup.setUpdateRateMSecs(100);
+    QCOMPARE(scheduler->groupCount(), groupCount + 1);
+    factGroup.fact1.setRawValue(5.0);
+    QCOMPARE(valueSpy.count(), 3);
+    QVERIFY(valueSpy.wait(1000));
+    QCOMPARE(valueSpy.count(), 4);
+}
+
+void FactGroupSchedulerTest::_minUpdateRate_test(void)
+{
+    FactGroupScheduler* scheduler = FactGroupScheduler::instance();
+    TestFactGroup       factGroup(100);
+    QSignalSpy          valueSpy(&factGroup.fact1, &Fact::valueChanged);
+    QSignalSpy          rawValueSpy(&factGroup.fact1, &Fact::rawValueChanged);
+
+    // A minimum rate holds back groups which are faster than it, raw values are unaffected
+    scheduler->setMinUpdateMSecs(2000);
+    factGroup.fact1.setRawValue(1.0);
+    QCOMPARE(rawValueSpy.count(), 1);
+    QTest::qWait(500);
+    QCOMPARE(valueSpy.count(), 0);
+
+    // Clearing it sends the held back change out at the group's own rate
+    scheduler->setMinUpdateMSecs(0);
+    QVERIFY(valueSpy.wait(1000));
+    QCOMPARE(valueSpy.count(), 1);
+    QCOMPARE(valueSpy.at(0).at(0).toDouble(), 1.0);
+}
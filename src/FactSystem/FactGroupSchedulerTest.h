@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for FactGroupScheduler and FactGroup deferred updates
+class FactGroupSchedulerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _changedOnly_test      (void);
+    void _liveUpdates_test      (void);
+    void _factDestroyed_test    (void);
+    void _groupRegister_test    (void);
+    void _updateRateChange_test (void);
+    void _minUpdateRate_test    (void);
+};
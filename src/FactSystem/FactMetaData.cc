@@ -16,6 +16,8 @@
 #include <QtMath>
 #include <QJsonParseError>
 #include <QJsonArray>
+#include <QHash>
+#include <QMutex>
 
 #include <limits>
 #include <cmath>
@@ -145,6 +147,8 @@ const char* FactMetaData::_categoryJsonKey =            "category";
 const char* FactMetaData::_groupJsonKey =               "group";
 const char* FactMetaData::_volatileJsonKey =            "volatile";
 
+uint FactMetaData::_formatGeneration = 0;
+
 FactMetaData::FactMetaData(QObject* parent)
     : QObject               (parent)
     , _type                 (valueTypeInt32)
@@ -254,6 +258,7 @@ const FactMetaData& FactMetaData::operator=(const FactMetaData& other)
     _readOnly               = other._readOnly;
     _writeOnly              = other._writeOnly;
     _volatile               = other._volatile;
+    _formatGeneration++;
     return *this;
 }
 
@@ -726,6 +731,7 @@ void FactMetaData::setTranslators(Translator rawTranslator, Translator cookedTra
 {
     _rawTranslator = rawTranslator;
     _cookedTranslator = cookedTranslator;
+    _formatGeneration++;
 }
 
 void FactMetaData::setBuiltInTranslator(void)
@@ -1450,6 +1456,36 @@ void FactMetaData::_loadJsonDefines(const QJsonObject& jsonDefinesObject, QMap<Q
 }
 
 QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonFile(const QString& jsonFilename, QObject* metaDataParent)
+{
+    // Each FactGroup and SettingsGroup instance loads its file again, the json is only read and parsed the first time.
+    // Callers own and may modify what they get back, so they are given copies of the parsed meta data.
+    static QMutex                                               cacheMutex;
+    static QHash<QString, QMap<QString, FactMetaData*>>         cachedMetaDataMaps;
+
+    QMap<QString, FactMetaData*> cachedMetaDataMap;
+    {
+        QMutexLocker lock(&cacheMutex);
+
+        auto iter = cachedMetaDataMaps.find(jsonFilename);
+        if (iter == cachedMetaDataMaps.end()) {
+            iter = cachedMetaDataMaps.insert(jsonFilename, _loadMapFromJsonFile(jsonFilename));
+        }
+        cachedMetaDataMap = iter.value();
+    }
+
+    QMap<QString, FactMetaData*> metaDataMap;
+    for (auto iter = cachedMetaDataMap.constBegin(); iter != cachedMetaDataMap.constEnd(); iter++) {
+        FactMetaData* metaData = new FactMetaData(*iter.value(), metaDataParent);
+        if (!metaData->rawUnits().isEmpty()) {
+            // Picks up the current units settings, which may have changed since the file was parsed
+            metaData->setRawUnits(metaData->rawUnits());
+        }
+        metaDataMap[iter.key()] = metaData;
+    }
+    return metaDataMap;
+}
+
+QMap<QString, FactMetaData*> FactMetaData::_loadMapFromJsonFile(const QString& jsonFilename)
 {
     QMap<QString, FactMetaData*> metaDataMap;
 
@@ -1476,7 +1512,7 @@ QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonFile(const QString&
     _loadJsonDefines(jsonObject[FactMetaData::_jsonMetaDataDefinesName].toObject(), defineMap);
     factArray = jsonObject[FactMetaData::_jsonMetaDataFactsName].toArray();
 
-    return createMapFromJsonArray(factArray, defineMap, metaDataParent);
+    return createMapFromJsonArray(factArray, defineMap, nullptr /* metaDataParent */);
 }
 
 QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonArray(const QJsonArray jsonArray, QMap<QString, QString>& defineMap, QObject* metaDataParent)
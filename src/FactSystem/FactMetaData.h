@@ -151,7 +151,7 @@ public:
     /// Used to remove values from the enum lists after the meta data has been loaded
     void removeEnumInfo(const QVariant& value);
 
-    void setDecimalPlaces           (int decimalPlaces)                 { _decimalPlaces = decimalPlaces; }
+    void setDecimalPlaces           (int decimalPlaces)                 { _decimalPlaces = decimalPlaces; _formatGeneration++; }
     void setRawDefaultValue         (const QVariant& rawDefaultValue);
     void setBitmaskInfo             (const QStringList& strings, const QVariantList& values);
     void setEnumInfo                (const QStringList& strings, const QVariantList& values);
@@ -165,7 +165,7 @@ public:
     void setRawUnits                (const QString& rawUnits);
     void setVehicleRebootRequired   (bool rebootRequired)               { _vehicleRebootRequired = rebootRequired; }
     void setQGCRebootRequired       (bool rebootRequired)               { _qgcRebootRequired = rebootRequired; }
-    void setRawIncrement            (double increment)                  { _rawIncrement = increment; }
+    void setRawIncrement            (double increment)                  { _rawIncrement = increment; _formatGeneration++; }
     void setHasControl              (bool bValue)                       { _hasControl = bValue; }
     void setReadOnly                (bool bValue)                       { _readOnly = bValue; }
     void setWriteOnly               (bool bValue)                       { _writeOnly = bValue; }
@@ -202,6 +202,10 @@ public:
     static const char* kDefaultCategory;
     static const char* kDefaultGroup;
 
+    /// Changes each time meta data is modified in a way which can change how a value is formatted: decimal places,
+    /// increment or translators (which is also how units settings are applied). Used by Fact to drop cached value strings.
+    static uint formatGeneration(void) { return _formatGeneration; }
+
     static ValueType_t stringToType(const QString& typeString, bool& unknownType);
     static QString typeToString(ValueType_t type);
     static size_t typeToSize(ValueType_t type);
@@ -236,6 +240,10 @@ private:
     bool isInRawMinLimit(const QVariant& variantValue) const;
     bool isInRawMaxLimit(const QVariant& variantValue) const;
 
+    static QMap<QString, FactMetaData*> _loadMapFromJsonFile(const QString& jsonFilename);
+
+    static uint _formatGeneration;
+
     static bool _parseEnum          (const QJsonObject& jsonObject, DefineMap_t defineMap, QStringList& rgDescriptions, QStringList& rgValues, QString& errorString);
     static bool _parseValuesArray   (const QJsonObject& jsonObject, QStringList& rgDescriptions, QList<double>& rgValues, QString& errorString);
     static bool _parseBitmaskArray  (const QJsonObject& jsonObject, QStringList& rgDescriptions, QList<double>& rgValues, QString& errorString);
@@ -17,17 +17,27 @@
 #include "JsonHelper.h"
 #include "ComponentInformationManager.h"
 #include "CompInfoParam.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+#include "QGCInstrumentation.h"
 
 #include <QEasingCurve>
 #include <QFile>
 #include <QDebug>
 #include <QVariantAnimation>
 #include <QJsonArray>
+#include <QtEndian>
+#include <QtConcurrent>
+#include <QSaveFile>
 
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose1Log,           "ParameterManagerVerbose1Log")
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose2Log,           "ParameterManagerVerbose2Log")
 QGC_LOGGING_CATEGORY(ParameterManagerDebugCacheFailureLog,  "ParameterManagerDebugCacheFailureLog") // Turn on to debug parameter cache crc misses
 
+QGC_INSTRUMENT_COUNTER(ParameterWrites,             "Parameters.Writes")
+QGC_INSTRUMENT_COUNTER(ParameterWriteRetries,       "Parameters.WriteRetries")
+QGC_INSTRUMENT_COUNTER(ParameterWritesCoalesced,    "Parameters.WritesCoalesced")
+
 const QHash<int, QString> _mavlinkCompIdHash {
     { MAV_COMP_ID_CAMERA,   "Camera1" },
     { MAV_COMP_ID_CAMERA2,  "Camera2" },
@@ -109,6 +119,11 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     QFileInfo(QSettings().fileName()).dir().mkdir("ParamCache");
 }
 
+ParameterManager::~ParameterManager()
+{
+    delete _ftpTempDir;
+}
+
 void ParameterManager::_updateProgressBar(void)
 {
     int waitingReadParamIndexCount = 0;
@@ -139,6 +154,9 @@ void ParameterManager::_updateProgressBar(void)
 
     if (waitingWriteParamCount == 0) {
         if (_writeParamProgressActive) {
+            qint64 elapsedMSecs = qMax(_paramWriteBatchTimer.elapsed(), static_cast<qint64>(1));
+            qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Parameter writes complete count:msecs:params/sec"
+                                         << _waitingWriteParamBatchCount << elapsedMSecs << (_waitingWriteParamBatchCount * 1000.0) / elapsedMSecs;
             _writeParamProgressActive = false;
             _waitingWriteParamBatchCount = 0;
             _setLoadProgress(0.0);
@@ -229,7 +247,8 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 
     // ArduPilot has this strange behavior of streaming parameters that we didn't ask for. This even happens before it responds to the
     // PARAM_REQUEST_LIST. We disregard any of this until the initial request is responded to.
-    if (parameterIndex == 65535 && parameterName != "_HASH_CHECK" && _initialRequestTimeoutTimer.isActive()) {
+    // The same goes for the parameter file download.
+    if (parameterIndex == 65535 && parameterName != "_HASH_CHECK" && (_initialRequestTimeoutTimer.isActive() || (_ftpTempDir && !_initialLoadComplete))) {
         qCDebug(ParameterManagerVerbose1Log) << "Disregarding unrequested param prior to initial list response" << parameterName;
         return;
     }
@@ -310,13 +329,19 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
     }
 
     // Remove this parameter from the waiting lists
-    if (_waitingReadParamIndexMap[componentId].contains(parameterIndex)) {
-        _waitingReadParamIndexMap[componentId].remove(parameterIndex);
-        _indexBatchQueue.removeOne(parameterIndex);
+    if (_waitingReadParamIndexMap[componentId].remove(parameterIndex)) {
+        if (_indexBatchQueue[componentId].remove(parameterIndex)) {
+            _growIndexBatchWindow();
+        }
         _fillIndexBatchQueue(false /* waitingParamTimeout */);
     }
     _waitingReadParamNameMap[componentId].remove(parameterName);
-    _waitingWriteParamNameMap[componentId].remove(parameterName);
+    if (!_queuedParamWriteMap[componentId].contains(parameterName)) {
+        // A write which has not gone out yet is still pending
+        _waitingWriteParamNameMap[componentId].remove(parameterName);
+    }
+    _removeInFlightParamWrite(componentId, parameterName);
+    _sendQueuedParamWrites();
     if (_waitingReadParamIndexMap[componentId].count()) {
         qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap:" << _waitingReadParamIndexMap[componentId];
     }
@@ -372,10 +397,8 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 \
     _updateProgressBar();
 
-    Fact* fact = nullptr;
-    if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(parameterName)) {
-        fact = _mapCompId2FactMap[componentId][parameterName];
-    } else {
+    Fact* fact = _findFact(componentId, parameterName);
+    if (!fact) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << parameterName;
 
         fact = new Fact(componentId, parameterName, mavTypeToFactType(mavParamType), this);
@@ -390,7 +413,13 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
         emit factAdded(componentId, fact);
     }
 
-    fact->_containerSetRawValue(parameterValue);
+    if (_parameterUpdateDepth) {
+        if (fact->_containerSetRawValueBatched(parameterValue)) {
+            _parameterUpdateFacts.append(fact);
+        }
+    } else {
+        fact->_containerSetRawValue(parameterValue);
+    }
 
     // Update param cache. The param cache is only used on PX4 Firmware since ArduPilot and Solo have volatile params
     // which invalidate the cache. The Solo also streams param updates in flight for things like gimbal values
@@ -408,6 +437,10 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 
     _checkInitialLoadComplete();
 
+    if (readWaitingParamCount == 0) {
+        _endRefreshParameterUpdate();
+    }
+
     qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_parameterUpdate complete";
 }
 
@@ -418,6 +451,9 @@ void ParameterManager::_factRawValueUpdateWorker(int componentId, const QString&
         if (_waitingWriteParamNameMap[componentId].contains(name)) {
             _waitingWriteParamNameMap[componentId].remove(name);
         } else {
+            if (_waitingWriteParamBatchCount == 0) {
+                _paramWriteBatchTimer.start();
+            }
             _waitingWriteParamBatchCount++;
         }
         _waitingWriteParamNameMap[componentId][name] = 0; // Add new entry and set retry count
@@ -428,8 +464,47 @@ void ParameterManager::_factRawValueUpdateWorker(int componentId, const QString&
         qWarning() << "Internal error ParameterManager::_factValueUpdateWorker: component id not found" << componentId;
     }
 
-    _sendParamSetToVehicle(componentId, name, valueType, rawValue);
-    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Update parameter (_waitingParamTimeoutTimer started) - compId:name:rawValue" << componentId << name << rawValue;
+    ParamWrite_t paramWrite = { valueType, rawValue };
+    if (_inFlightParamWriteMap[componentId].contains(name)) {
+        // Still waiting on a previous value, the new one goes out right away in the same slot
+        _inFlightParamWriteMap[componentId][name] = paramWrite;
+        _sendParamSetToVehicle(componentId, name, valueType, rawValue);
+        QGC_INSTRUMENT_ADD(ParameterWrites, 1);
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Update parameter (_waitingParamTimeoutTimer started) - compId:name:rawValue" << componentId << name << rawValue;
+    } else if (_queuedParamWriteMap[componentId].contains(name)) {
+        _queuedParamWriteMap[componentId][name] = paramWrite;
+        QGC_INSTRUMENT_ADD(ParameterWritesCoalesced, 1);
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Update parameter replaces queued value - compId:name:rawValue" << componentId << name << rawValue;
+    } else {
+        _queuedParamWriteMap[componentId][name] = paramWrite;
+        _queuedParamWriteList.append(qMakePair(componentId, name));
+    }
+    _sendQueuedParamWrites();
+}
+
+/// Sends queued writes until _maxParamWritesInFlight are waiting on a response
+void ParameterManager::_sendQueuedParamWrites(void)
+{
+    while (_inFlightParamWriteCount < _maxParamWritesInFlight && !_queuedParamWriteList.isEmpty()) {
+        QPair<int, QString> queuedWrite = _queuedParamWriteList.takeFirst();
+        int                 componentId = queuedWrite.first;
+        const QString&      name        = queuedWrite.second;
+        ParamWrite_t        paramWrite  = _queuedParamWriteMap[componentId].take(name);
+
+        _inFlightParamWriteMap[componentId][name] = paramWrite;
+        _inFlightParamWriteCount++;
+        _sendParamSetToVehicle(componentId, name, paramWrite.valueType, paramWrite.rawValue);
+        QGC_INSTRUMENT_ADD(ParameterWrites, 1);
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Update parameter (_waitingParamTimeoutTimer started) - compId:name:rawValue" << componentId << name << paramWrite.rawValue;
+    }
+}
+
+void ParameterManager::_removeInFlightParamWrite(int componentId, const QString& paramName)
+{
+    auto iter = _inFlightParamWriteMap.find(componentId);
+    if (iter != _inFlightParamWriteMap.end() && iter->remove(paramName)) {
+        _inFlightParamWriteCount--;
+    }
 }
 
 void ParameterManager::_factRawValueUpdated(const QVariant& rawValue)
@@ -459,10 +534,10 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
         _waitingForDefaultComponent = false;
         emit parametersReadyChanged(_parametersReady);
         emit missingParametersChanged(_missingParameters);
-    }
-
-    if (!_initialLoadComplete) {
-        _initialRequestTimeoutTimer.start();
+    } else if (_initialLoadComplete && !_refreshParameterUpdate) {
+        // Setup pages watching these parameters recompute once the refresh is done instead of once per parameter
+        _refreshParameterUpdate = true;
+        beginParameterUpdate();
     }
 
     // Reset index wait lists
@@ -476,6 +551,18 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
         }
     }
 
+    if (componentId == MAV_COMP_ID_ALL && _useFTP() && _startFTPDownload()) {
+        // Indices which are not in the file, or belong to other components, are picked up by the index based re-requests
+        return;
+    }
+
+    if (!_initialLoadComplete) {
+        _initialRequestTimeoutTimer.start();
+    } else if (_refreshParameterUpdate) {
+        // The retries give up on what doesn't come back, which also closes the batch
+        _waitingParamTimeoutTimer.start();
+    }
+
     MAVLinkProtocol*        mavlink = qgcApp()->toolbox()->mavlinkProtocol();
     mavlink_message_t       msg;
     SharedLinkInterfacePtr  sharedLink = weakLink.lock();
@@ -492,6 +579,208 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
     qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Request to refresh all parameters for component ID:" << what;
 }
 
+bool ParameterManager::_useFTP(void)
+{
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+
+    return !_ftpFailed && !_logReplay &&
+            !weakLink.expired() && !weakLink.lock()->linkConfiguration()->isHighLatency() &&
+            (_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_FTP) &&
+            !_vehicle->firmwarePlugin()->parameterFTPPath().isEmpty() &&
+            qgcApp()->toolbox()->settingsManager()->appSettings()->useParamFTP()->rawValue().toBool();
+}
+
+/// Starts the download of the parameter file from the vehicle.
+/// @return false: download could not be started, the parameter protocol should be used instead
+bool ParameterManager::_startFTPDownload(void)
+{
+    FTPManager* ftpManager = _vehicle->ftpManager();
+
+    delete _ftpTempDir;
+    _ftpTempDir = new QTemporaryDir();
+    if (!_ftpTempDir->isValid()) {
+        qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "_startFTPDownload unable to create temporary directory";
+        _finishFTPTransfer();
+        return false;
+    }
+
+    connect(ftpManager, &FTPManager::downloadComplete,  this, &ParameterManager::_ftpDownloadComplete);
+    connect(ftpManager, &FTPManager::commandProgress,   this, &ParameterManager::_ftpProgress);
+    if (!ftpManager->download(_vehicle->firmwarePlugin()->parameterFTPPath(), _ftpTempDir->path())) {
+        // FTP is busy with something else
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "_startFTPDownload download failed to start";
+        _finishFTPTransfer();
+        return false;
+    }
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "_startFTPDownload started";
+    return true;
+}
+
+void ParameterManager::_finishFTPTransfer(void)
+{
+    FTPManager* ftpManager = _vehicle->ftpManager();
+
+    disconnect(ftpManager, &FTPManager::downloadComplete,   this, &ParameterManager::_ftpDownloadComplete);
+    disconnect(ftpManager, &FTPManager::commandProgress,    this, &ParameterManager::_ftpProgress);
+
+    delete _ftpTempDir;
+    _ftpTempDir = nullptr;
+}
+
+void ParameterManager::_ftpProgress(int value)
+{
+    _setLoadProgress(value / 100.0);
+}
+
+void ParameterManager::_ftpDownloadComplete(const QString& file, const QString& errorMsg)
+{
+    bool success = errorMsg.isEmpty() && _ftpFileToParams(file);
+
+    _finishFTPTransfer();
+    _setLoadProgress(0.0);
+
+    if (success) {
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpDownloadComplete";
+        return;
+    }
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpDownloadComplete failed, using parameter protocol from now on:" << errorMsg;
+    _ftpFailed = true;
+    refreshAllParameters();
+}
+
+/// Parameter files start with a header followed by the packed parameters:
+///     uint16 magic, uint16 parameter count in file, uint16 total parameter count
+/// Each parameter is:
+///     uint8 type (low nibble) and flags (high nibble), uint8 common prefix length (low nibble) and name suffix length - 1
+///     (high nibble), name suffix, value, default value if flagged
+/// The common prefix is shared with the name of the previous parameter. Zero bytes in place of a type are padding.
+/// Parameters are in index order and are passed through _handleParamValue as if they came from PARAM_VALUE.
+bool ParameterManager::_ftpFileToParams(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpFileToParams unable to open" << fileName << file.errorString();
+        return false;
+    }
+    QByteArray      bytes   = file.readAll();
+    const uchar*    data    = reinterpret_cast<const uchar*>(bytes.constData());
+    int             cBytes  = bytes.size();
+
+    if (cBytes < _ftpFileHeaderSize) {
+        qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpFileToParams file too short" << cBytes;
+        return false;
+    }
+    uint16_t magic          = qFromLittleEndian<quint16>(data);
+    uint16_t cParams        = qFromLittleEndian<quint16>(data + 2);
+    uint16_t cTotalParams   = qFromLittleEndian<quint16>(data + 4);
+    if ((magic != _ftpFileMagic && magic != _ftpFileMagicDefaults) || cParams != cTotalParams) {
+        // The whole set is needed for the file order to match the parameter indices
+        qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpFileToParams invalid file magic:count:total" << magic << cParams << cTotalParams;
+        return false;
+    }
+
+    typedef struct {
+        QString         name;
+        MAV_PARAM_TYPE  mavType;
+        QVariant        value;
+    } FileParam_t;
+
+    // Parse everything first so a damaged file doesn't leave a partial set behind
+    QList<FileParam_t>  params;
+    QByteArray          name;
+    int                 offset = _ftpFileHeaderSize;
+
+    params.reserve(cParams);
+    while (offset < cBytes) {
+        if (data[offset] == 0) {
+            offset++;
+            continue;
+        }
+        if (offset + 2 > cBytes) {
+            break;
+        }
+
+        int type        = data[offset] & 0x0F;
+        int flags       = data[offset] >> 4;
+        int commonLen   = data[offset + 1] & 0x0F;
+        int suffixLen   = (data[offset + 1] >> 4) + 1;
+        int valueLen;
+
+        FileParam_t param;
+        switch (type) {
+        case 1:
+            param.mavType   = MAV_PARAM_TYPE_INT8;
+            valueLen        = 1;
+            break;
+        case 2:
+            param.mavType   = MAV_PARAM_TYPE_INT16;
+            valueLen        = 2;
+            break;
+        case 3:
+            param.mavType   = MAV_PARAM_TYPE_INT32;
+            valueLen        = 4;
+            break;
+        case 4:
+            param.mavType   = MAV_PARAM_TYPE_REAL32;
+            valueLen        = 4;
+            break;
+        default:
+            qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpFileToParams unsupported type:offset" << type << offset;
+            return false;
+        }
+        offset += 2;
+
+        int cParamBytes = suffixLen + (valueLen * ((flags & 1) ? 2 : 1));
+        if (commonLen > name.length() || offset + cParamBytes > cBytes) {
+            qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpFileToParams truncated parameter:offset" << offset;
+            return false;
+        }
+
+        name.truncate(commonLen);
+        name.append(reinterpret_cast<const char*>(data + offset), suffixLen);
+        offset += suffixLen;
+
+        param.name = QString::fromLatin1(name);
+        switch (param.mavType) {
+        case MAV_PARAM_TYPE_INT8:
+            param.value = QVariant(static_cast<qint8>(data[offset]));
+            break;
+        case MAV_PARAM_TYPE_INT16:
+            param.value = QVariant(qFromLittleEndian<qint16>(data + offset));
+            break;
+        case MAV_PARAM_TYPE_INT32:
+            param.value = QVariant(qFromLittleEndian<qint32>(data + offset));
+            break;
+        default:
+        {
+            quint32 raw = qFromLittleEndian<quint32>(data + offset);
+            float   value;
+            memcpy(&value, &raw, sizeof(value));
+            param.value = QVariant(value);
+            break;
+        }
+        }
+        offset += cParamBytes - suffixLen;
+
+        params.append(param);
+    }
+
+    if (params.count() != cParams) {
+        qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpFileToParams unexpected parameter count:expected" << params.count() << cParams;
+        return false;
+    }
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "_ftpFileToParams count" << cParams;
+    int componentId = _vehicle->defaultComponentId();
+    for (int i=0; i<params.count(); i++) {
+        _handleParamValue(componentId, params[i].name, cParams, i, params[i].mavType, params[i].value);
+    }
+
+    return true;
+}
+
 /// Translates FactSystem::defaultComponentId to real component id if needed
 int ParameterManager::_actualComponentId(int componentId)
 {
@@ -541,16 +830,19 @@ void ParameterManager::refreshParametersPrefix(int componentId, const QString& n
     }
 }
 
-bool ParameterManager::parameterExists(int componentId, const QString& paramName)
+/// @return nullptr: parameter does not exist
+Fact* ParameterManager::_findFact(int componentId, const QString& paramName) const
 {
-    bool ret = false;
-
-    componentId = _actualComponentId(componentId);
-    if (_mapCompId2FactMap.contains(componentId)) {
-        ret = _mapCompId2FactMap[componentId].contains(_remapParamNameToVersion(paramName));
+    auto compIter = _mapCompId2FactMap.constFind(componentId);
+    if (compIter == _mapCompId2FactMap.constEnd()) {
+        return nullptr;
     }
+    return compIter->value(paramName, nullptr);
+}
 
-    return ret;
+bool ParameterManager::parameterExists(int componentId, const QString& paramName)
+{
+    return _findFact(_actualComponentId(componentId), _remapParamNameToVersion(paramName)) != nullptr;
 }
 
 Fact* ParameterManager::getParameter(int componentId, const QString& paramName)
@@ -558,22 +850,20 @@ Fact* ParameterManager::getParameter(int componentId, const QString& paramName)
     componentId = _actualComponentId(componentId);
 
     QString mappedParamName = _remapParamNameToVersion(paramName);
-    if (!_mapCompId2FactMap.contains(componentId) || !_mapCompId2FactMap[componentId].contains(mappedParamName)) {
+    Fact*   fact            = _findFact(componentId, mappedParamName);
+    if (!fact) {
         qgcApp()->reportMissingParameter(componentId, mappedParamName);
         return &_defaultFact;
     }
 
-    return _mapCompId2FactMap[componentId][mappedParamName];
+    return fact;
 }
 
 QStringList ParameterManager::parameterNames(int componentId)
 {
-    QStringList names;
-
-    for(const QString &paramName: _mapCompId2FactMap[_actualComponentId(componentId)].keys()) {
-        names << paramName;
-    }
+    QStringList names = _mapCompId2FactMap.value(_actualComponentId(componentId)).keys();
 
+    names.sort();
     return names;
 }
 
@@ -586,48 +876,81 @@ bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
         return false;
     }
 
-    const int maxBatchSize = 10;
+    int cQueued = 0;
+    for (const QSet<int>& queuedIndices: _indexBatchQueue) {
+        cQueued += queuedIndices.count();
+    }
 
     if (waitingParamTimeout) {
-        // We timed out, clear the queue and try again
-        qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to timeout";
+        if (cQueued) {
+            // Everything outstanding is considered lost, try again with a smaller window
+            _indexBatchThreshold = _indexBatchWindow / 2;
+            if (_indexBatchThreshold < _indexBatchWindowMin) {
+                _indexBatchThreshold = _indexBatchWindowMin;
+            }
+            _indexBatchWindow       = _indexBatchThreshold;
+            _indexBatchAnswerCount  = 0;
+        }
+        qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to timeout - window:" << _indexBatchWindow;
         _indexBatchQueue.clear();
+        cQueued = 0;
     } else {
-        qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to received parameter";
+        qCDebug(ParameterManagerVerbose1Log) << "Refilling index based batch queue due to received parameter - window:" << _indexBatchWindow;
     }
 
-    for(int componentId: _waitingReadParamIndexMap.keys()) {
-        if (_waitingReadParamIndexMap[componentId].count()) {
-            qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << _waitingReadParamIndexMap[componentId].count();
-            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << _waitingReadParamIndexMap[componentId];
+    for (auto compIter = _waitingReadParamIndexMap.begin(); compIter != _waitingReadParamIndexMap.end(); compIter++) {
+        int             componentId     = compIter.key();
+        QMap<int, int>& waitingIndices  = compIter.value();
+        QSet<int>&      queuedIndices   = _indexBatchQueue[componentId];
+
+        if (waitingIndices.count()) {
+            qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << waitingIndices.count();
+            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << waitingIndices;
         }
 
-        for(int paramIndex: _waitingReadParamIndexMap[componentId].keys()) {
-            if (_indexBatchQueue.contains(paramIndex)) {
+        auto indexIter = waitingIndices.begin();
+        while (indexIter != waitingIndices.end() && cQueued < _indexBatchWindow) {
+            int paramIndex = indexIter.key();
+
+            if (queuedIndices.contains(paramIndex)) {
                 // Don't add more than once
+                indexIter++;
                 continue;
             }
 
-            if (_indexBatchQueue.count() > maxBatchSize) {
-                break;
-            }
-
-            _waitingReadParamIndexMap[componentId][paramIndex]++;   // Bump retry count
-            if (_disableAllRetries || _waitingReadParamIndexMap[componentId][paramIndex] > _maxInitialLoadRetrySingleParam) {
+            int retryCount = ++indexIter.value();   // Bump retry count
+            if (_disableAllRetries || retryCount > _maxInitialLoadRetrySingleParam) {
                 // Give up on this index
                 _failedReadParamIndexMap[componentId] << paramIndex;
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
-                _waitingReadParamIndexMap[componentId].remove(paramIndex);
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
+                indexIter = waitingIndices.erase(indexIter);
             } else {
                 // Retry again
-                _indexBatchQueue.append(paramIndex);
+                queuedIndices.insert(paramIndex);
+                cQueued++;
                 _readParameterRaw(componentId, "", paramIndex);
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
+                indexIter++;
             }
         }
     }
 
-    return _indexBatchQueue.count() != 0;
+    return cQueued != 0;
+}
+
+/// Called when a re-requested index arrives. Like TCP congestion control the window doubles each round trip until it
+/// reaches the threshold set by the last timeout and then grows by one each round trip.
+void ParameterManager::_growIndexBatchWindow(void)
+{
+    if (_indexBatchWindow >= _indexBatchWindowMax) {
+        return;
+    }
+    if (_indexBatchWindow < _indexBatchThreshold) {
+        _indexBatchWindow++;
+    } else if (++_indexBatchAnswerCount >= _indexBatchWindow) {
+        _indexBatchWindow++;
+        _indexBatchAnswerCount = 0;
+    }
 }
 
 void ParameterManager::_waitingParamTimeout(void)
@@ -661,13 +984,15 @@ void ParameterManager::_waitingParamTimeout(void)
     _checkInitialLoadComplete();
 
     if (!paramsRequested) {
-        for(int componentId: _waitingWriteParamNameMap.keys()) {
-            for(const QString &paramName: _waitingWriteParamNameMap[componentId].keys()) {
+        // Only writes which went out are resent, queued writes are still waiting for room in the window
+        for(int componentId: _inFlightParamWriteMap.keys()) {
+            for(const QString &paramName: _inFlightParamWriteMap[componentId].keys()) {
                 paramsRequested = true;
                 _waitingWriteParamNameMap[componentId][paramName]++;   // Bump retry count
                 if (_waitingWriteParamNameMap[componentId][paramName] <= _maxReadWriteRetry) {
-                    Fact* fact = getParameter(componentId, paramName);
-                    _sendParamSetToVehicle(componentId, paramName, fact->type(), fact->rawValue());
+                    const ParamWrite_t& paramWrite = _inFlightParamWriteMap[componentId][paramName];
+                    _sendParamSetToVehicle(componentId, paramName, paramWrite.valueType, paramWrite.rawValue);
+                    QGC_INSTRUMENT_ADD(ParameterWriteRetries, 1);
                     qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Write resend for (paramName:" << paramName << "retryCount:" << _waitingWriteParamNameMap[componentId][paramName] << ")";
                     if (++batchCount > maxBatchSize) {
                         goto Out;
@@ -675,12 +1000,14 @@ void ParameterManager::_waitingParamTimeout(void)
                 } else {
                     // Exceeded max retry count, notify user
                     _waitingWriteParamNameMap[componentId].remove(paramName);
+                    _removeInFlightParamWrite(componentId, paramName);
                     QString errorMsg = tr("Parameter write failed: veh:%1 comp:%2 param:%3").arg(_vehicle->id()).arg(componentId).arg(paramName);
                     qCDebug(ParameterManagerLog) << errorMsg;
                     qgcApp()->showAppMessage(errorMsg);
                 }
             }
         }
+        _sendQueuedParamWrites();
     }
 
     if (!paramsRequested) {
@@ -709,6 +1036,44 @@ Out:
     if (paramsRequested) {
         qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer - re-request";
         _waitingParamTimeoutTimer.start();
+    } else {
+        _endRefreshParameterUpdate();
+    }
+}
+
+void ParameterManager::beginParameterUpdate(void)
+{
+    _parameterUpdateDepth++;
+}
+
+void ParameterManager::endParameterUpdate(void)
+{
+    if (_parameterUpdateDepth == 0) {
+        qWarning() << "ParameterManager::endParameterUpdate without beginParameterUpdate";
+        return;
+    }
+    if (_parameterUpdateDepth > 1) {
+        _parameterUpdateDepth--;
+        return;
+    }
+
+    // Still in progress while the held signals go out, so anyone listening knows to wait for parameterUpdateComplete
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Parameter update batch complete, changed facts:" << _parameterUpdateFacts.count();
+    const QList<Fact*> facts = _parameterUpdateFacts;
+    _parameterUpdateFacts.clear();
+    for (Fact* fact: facts) {
+        fact->_sendBatchedValueChangedSignals();
+    }
+    _parameterUpdateDepth = 0;
+
+    emit parameterUpdateComplete();
+}
+
+void ParameterManager::_endRefreshParameterUpdate(void)
+{
+    if (_refreshParameterUpdate) {
+        _refreshParameterUpdate = false;
+        endParameterUpdate();
     }
 }
 
@@ -797,20 +1162,154 @@ void ParameterManager::_sendParamSetToVehicle(int componentId, const QString& pa
     }
 }
 
+/// Cache files are a header followed by the parameters in name order:
+///     uint32 magic, uint32 CRC of the non-volatile parameters as _HASH_CHECK computes it, uint32 parameter count
+/// Each parameter is a uint8 FactMetaData::ValueType_t, a uint8 name length, the name and the little endian value.
+/// Storing the CRC means a cache which doesn't match the vehicle is rejected without reading any further.
 void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
 {
-    CacheMapName2ParamTypeVal cacheMap;
+    const QHash<QString, Fact*>& factMap = _mapCompId2FactMap[componentId];
+
+    // The CRC is over the parameters in name order
+    QStringList paramNames = factMap.keys();
+    paramNames.sort();
+
+    QByteArray  bytes;
+    uint32_t    crc32_value = 0;
+
+    bytes.reserve(_cacheFileHeaderSize + (factMap.count() * 24));
+    bytes.resize(_cacheFileHeaderSize);
+    for (const QString& paramName: paramNames) {
+        const Fact*     fact        = factMap.value(paramName);
+        QByteArray      name        = paramName.toLocal8Bit();
+        int             valueSize   = static_cast<int>(FactMetaData::typeToSize(fact->type()));
+        QVariant        rawValue    = fact->rawValue();
+        QByteArray      value;
+
+        if (valueSize == 0 || name.length() > 255) {
+            qCWarning(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Parameter can't be cached, not writing cache" << paramName;
+            return;
+        }
+        if (fact->type() == FactMetaData::valueTypeCustom) {
+            value = rawValue.toByteArray();
+            value.resize(valueSize);
+        } else {
+            value = QByteArray(static_cast<const char*>(rawValue.constData()), valueSize);
+        }
+
+        if (!fact->volatileValue()) {
+            crc32_value = QGC::crc32(reinterpret_cast<const uint8_t*>(name.constData()), name.length(), crc32_value);
+            crc32_value = QGC::crc32(reinterpret_cast<const uint8_t*>(value.constData()), valueSize, crc32_value);
+        }
 
-    for (const QString& paramName: _mapCompId2FactMap[componentId].keys()) {
-        const Fact *fact = _mapCompId2FactMap[componentId][paramName];
-        cacheMap[paramName] = ParamTypeVal(fact->type(), fact->rawValue());
+        bytes.append(static_cast<char>(fact->type()));
+        bytes.append(static_cast<char>(name.length()));
+        bytes.append(name);
+        bytes.append(value);
     }
 
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    uchar* header = reinterpret_cast<uchar*>(bytes.data());
+    qToLittleEndian<quint32>(_cacheFileMagic,                           header);
+    qToLittleEndian<quint32>(crc32_value,                               header + 4);
+    qToLittleEndian<quint32>(static_cast<quint32>(factMap.count()),     header + 8);
+
+    // The file is written away from the GUI thread. QSaveFile makes sure a reader never sees a partial file.
+    QString fileName = parameterCacheFile(vehicleId, componentId);
+    QtConcurrent::run([fileName, bytes] {
+        QSaveFile cacheFile(fileName);
+        if (!cacheFile.open(QIODevice::WriteOnly) || cacheFile.write(bytes) != bytes.size() || !cacheFile.commit()) {
+            qCWarning(ParameterManagerLog) << "Parameter cache write failed" << fileName << cacheFile.errorString();
+        }
+    });
+}
+
+/// Reads the parameters from a cache file which was mapped into memory
+///     @param crc32_value  The stored CRC is compared against this before the parameters are read
+///     @param checkCRC     false: read the parameters whatever the stored CRC is
+/// @return false: The file is not a valid cache or the CRC does not match
+bool ParameterManager::_readLocalParamCache(const uchar* data, qint64 cBytes, uint32_t crc32_value, bool checkCRC, QList<QPair<QString, ParamTypeVal>>& params)
+{
+    if (cBytes < _cacheFileHeaderSize || qFromLittleEndian<quint32>(data) != _cacheFileMagic) {
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Invalid parameter cache file";
+        return false;
+    }
+    if (checkCRC && qFromLittleEndian<quint32>(data + 4) != crc32_value) {
+        return false;
+    }
+
+    quint32 cParams = qFromLittleEndian<quint32>(data + 8);
+    qint64  offset  = _cacheFileHeaderSize;
+
+    params.reserve(static_cast<int>(cParams));
+    for (quint32 i = 0; i < cParams; i++) {
+        if (offset + 2 > cBytes) {
+            qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "Truncated parameter cache file";
+            return false;
+        }
+
+        FactMetaData::ValueType_t   type        = static_cast<FactMetaData::ValueType_t>(data[offset]);
+        int                         nameLength  = data[offset + 1];
+        size_t                      valueSize   = FactMetaData::typeToSize(type);
+        offset += 2;
+
+        if (valueSize == 0 || offset + nameLength + static_cast<qint64>(valueSize) > cBytes) {
+            qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "Truncated parameter cache file";
+            return false;
+        }
+
+        QString         name    = QString::fromLocal8Bit(reinterpret_cast<const char*>(data + offset), nameLength);
+        const uchar*    value   = data + offset + nameLength;
+        QVariant        rawValue;
+        offset += nameLength + static_cast<qint64>(valueSize);
+
+        switch (type) {
+        case FactMetaData::valueTypeUint8:
+            rawValue = QVariant(static_cast<uint>(*value));
+            break;
+        case FactMetaData::valueTypeInt8:
+            rawValue = QVariant(static_cast<int>(static_cast<qint8>(*value)));
+            break;
+        case FactMetaData::valueTypeUint16:
+            rawValue = QVariant(static_cast<uint>(qFromLittleEndian<quint16>(value)));
+            break;
+        case FactMetaData::valueTypeInt16:
+            rawValue = QVariant(static_cast<int>(qFromLittleEndian<qint16>(value)));
+            break;
+        case FactMetaData::valueTypeUint32:
+            rawValue = QVariant(qFromLittleEndian<quint32>(value));
+            break;
+        case FactMetaData::valueTypeInt32:
+            rawValue = QVariant(qFromLittleEndian<qint32>(value));
+            break;
+        case FactMetaData::valueTypeUint64:
+            rawValue = QVariant(qFromLittleEndian<quint64>(value));
+            break;
+        case FactMetaData::valueTypeInt64:
+            rawValue = QVariant(qFromLittleEndian<qint64>(value));
+            break;
+        case FactMetaData::valueTypeFloat:
+        {
+            float floatValue;
+            memcpy(&floatValue, value, sizeof(floatValue));
+            rawValue = QVariant(floatValue);
+            break;
+        }
+        case FactMetaData::valueTypeDouble:
+        {
+            double doubleValue;
+            memcpy(&doubleValue, value, sizeof(doubleValue));
+            rawValue = QVariant(doubleValue);
+            break;
+        }
+        default:
+            rawValue = QVariant(QByteArray(reinterpret_cast<const char*>(value), static_cast<int>(valueSize)));
+            break;
+        }
+
+        params.append(QPair<QString, ParamTypeVal>(name, ParamTypeVal(type, rawValue)));
+    }
 
-    QDataStream ds(&cacheFile);
-    ds << cacheMap;
+    return true;
 }
 
 QDir ParameterManager::parameterCacheDir()
@@ -821,55 +1320,49 @@ QDir ParameterManager::parameterCacheDir()
 
 QString ParameterManager::parameterCacheFile(int vehicleId, int componentId)
 {
-    return parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId));
+    return parameterCacheDir().filePath(QString("%1_%2.v3").arg(vehicleId).arg(componentId));
 }
 
 void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVariant hash_value)
 {
     qCInfo(ParameterManagerLog) << "Attemping load from cache";
 
-    uint32_t crc32_value = 0;
-    /* The datastructure of the cache table */
-    CacheMapName2ParamTypeVal cacheMap;
+    uint32_t crc32_value = hash_value.toUInt();
     QFile cacheFile(parameterCacheFile(vehicleId, componentId));
     if (!cacheFile.exists()) {
         /* no local cache, just wait for them to come in*/
         return;
     }
-    cacheFile.open(QIODevice::ReadOnly);
 
-    /* Deserialize the parameter cache table */
-    QDataStream ds(&cacheFile);
-    ds >> cacheMap;
-
-    /* compute the crc of the local cache to check against the remote */
-
-    for (const QString& name: cacheMap.keys()) {
-        const ParamTypeVal&             paramTypeVal    = cacheMap[name];
-        const FactMetaData::ValueType_t fact_type       = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-
-        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(name, fact_type)->volatileValue()) {
-            // Does not take part in CRC
-            qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
-        } else {
-            const void *vdat = paramTypeVal.second.constData();
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            crc32_value = QGC::crc32((const uint8_t *)qPrintable(name), name.length(),  crc32_value);
-            crc32_value = QGC::crc32((const uint8_t *)vdat, FactMetaData::typeToSize(fact_type), crc32_value);
+    /* The stored CRC is checked against the vehicle hash before anything else is read */
+    QList<QPair<QString, ParamTypeVal>> cacheParams;
+    bool                                cacheMatch  = false;
+    uchar*                              data        = nullptr;
+    if (cacheFile.open(QIODevice::ReadOnly)) {
+        data = cacheFile.map(0, cacheFile.size());
+    }
+    if (data) {
+        cacheMatch = _readLocalParamCache(data, cacheFile.size(), crc32_value, true /* checkCRC */, cacheParams);
+        if (!cacheMatch && ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
+            // Read the whole cache anyway to report which parameters differ
+            cacheParams.clear();
+            _readLocalParamCache(data, cacheFile.size(), crc32_value, false /* checkCRC */, cacheParams);
         }
+        cacheFile.unmap(data);
+    } else {
+        qCWarning(ParameterManagerLog) << "Unable to map parameter cache" << cacheFile.fileName() << cacheFile.errorString();
     }
 
     /* if the two param set hashes match, just load from the disk */
-    if (crc32_value == hash_value.toUInt()) {
+    if (cacheMatch) {
         qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
 
-        int count = cacheMap.count();
+        int count = cacheParams.count();
         int index = 0;
-        for (const QString& name: cacheMap.keys()) {
-            const ParamTypeVal& paramTypeVal = cacheMap[name];
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
+        for (const QPair<QString, ParamTypeVal>& cacheParam: cacheParams) {
+            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(cacheParam.second.first);
             const MAV_PARAM_TYPE mavParamType = factTypeToMavType(fact_type);
-            _handleParamValue(componentId, name, count, index++, mavParamType, paramTypeVal.second);
+            _handleParamValue(componentId, cacheParam.first, count, index++, mavParamType, cacheParam.second.second);
         }
 
         WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
@@ -919,9 +1412,9 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVarian
         qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
         if (ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
             _debugCacheCRC[componentId] = true;
-            _debugCacheMap[componentId] = cacheMap;
-            for (const QString& name: cacheMap.keys()) {
-                _debugCacheParamSeen[componentId][name] = false;
+            for (const QPair<QString, ParamTypeVal>& cacheParam: cacheParams) {
+                _debugCacheMap[componentId][cacheParam.first] = cacheParam.second;
+                _debugCacheParamSeen[componentId][cacheParam.first] = false;
             }
             qgcApp()->showAppMessage(tr("Parameter cache CRC match failed"));
         }
@@ -1002,7 +1495,7 @@ void ParameterManager::writeParametersToStream(QTextStream& stream)
     stream << "# Vehicle-Id Component-Id Name Value Type\n";
 
     for (int componentId: _mapCompId2FactMap.keys()) {
-        for (const QString &paramName: _mapCompId2FactMap[componentId].keys()) {
+        for (const QString &paramName: parameterNames(componentId)) {
             Fact* fact = _mapCompId2FactMap[componentId][paramName];
             if (fact) {
                 stream << _vehicle->id() << "\t" << componentId << "\t" << paramName << "\t" << fact->rawValueStringFullPrecision() << "\t" << QString("%1").arg(factTypeToMavType(fact->type())) << "\n";
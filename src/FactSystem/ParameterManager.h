@@ -11,11 +11,15 @@
 
 #include <QObject>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QXmlStreamReader>
 #include <QLoggingCategory>
 #include <QMutex>
 #include <QDir>
 #include <QJsonObject>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
 
 #include "FactSystem.h"
 #include "MAVLinkProtocol.h"
@@ -34,10 +38,13 @@ class ParameterManager : public QObject
     Q_OBJECT
 
     friend class ParameterEditorController;
+    friend class HotPathBenchmark;
+    friend class ParameterManagerTest;
 
 public:
     /// @param uas Uas which this set of facts is associated with
     ParameterManager(Vehicle* vehicle);
+    ~ParameterManager();
 
     Q_PROPERTY(bool     parametersReady     READ parametersReady    NOTIFY parametersReadyChanged)      ///< true: Parameters are ready for use
     Q_PROPERTY(bool     missingParameters   READ missingParameters  NOTIFY missingParametersChanged)    ///< true: Parameters are missing from firmware response, false: all parameters received from firmware
@@ -58,9 +65,20 @@ public:
 
     QList<int> componentIds(void);
 
-    /// Re-request the full set of parameters from the autopilot
+    /// Re-request the full set of parameters from the autopilot. Once the initial load is done the refresh runs as a
+    /// parameter update batch, see beginParameterUpdate.
     void refreshAllParameters(uint8_t componentID = MAV_COMP_ID_ALL);
 
+    /// Parameter Facts updated by the vehicle between beginParameterUpdate and the matching endParameterUpdate hold
+    /// their valueChanged and rawValueChanged signals. When the outermost batch ends each changed Fact signals once,
+    /// followed by parameterUpdateComplete. Batches nest.
+    void beginParameterUpdate   (void);
+    void endParameterUpdate     (void);
+
+    /// @return true: A batch is open or its held signals are going out. Code which recomputes from several parameters
+    ///                 can wait for parameterUpdateComplete and recompute once.
+    bool parameterUpdateInProgress(void) const { return _parameterUpdateDepth > 0; }
+
     /// Request a refresh on the specific parameter
     void refreshParameter(int componentId, const QString& paramName);
 
@@ -75,11 +93,12 @@ public:
     ///     @param name: Parameter name
     bool parameterExists(int componentId, const QString& paramName);
 
-    /// Returns all parameter names
+    /// Returns all parameter names, sorted
     QStringList parameterNames(int componentId);
 
     /// Returns the specified Parameter. Returns a default empty fact is parameter does not exists. Also will pop
-    /// a missing parameter error to user if parameter does not exist.
+    /// a missing parameter error to user if parameter does not exist. Parameter facts are never deleted, so callers
+    /// which use a parameter often can hold on to the returned fact instead of looking it up each time.
     ///     @param componentId: Component id or FactSystem::defaultComponentId
     ///     @param name: Parameter name
     Fact* getParameter(int componentId, const QString& paramName);
@@ -102,9 +121,12 @@ signals:
     void loadProgressChanged        (float value);
     void pendingWritesChanged       (bool pendingWrites);
     void factAdded                  (int componentId, Fact* fact);
+    void parameterUpdateComplete    (void);
 
 private slots:
     void    _factRawValueUpdated                (const QVariant& rawValue);
+    void    _ftpDownloadComplete                (const QString& file, const QString& errorMsg);
+    void    _ftpProgress                        (int value);
 
 private:
     void    _handleParamValue                   (int componentId, QString parameterName, int parameterCount, int parameterIndex, MAV_PARAM_TYPE mavParamType, QVariant parameterValue);
@@ -124,15 +146,24 @@ private:
     QString _logVehiclePrefix                   (int componentId);
     void    _setLoadProgress                    (double loadProgress);
     bool    _fillIndexBatchQueue                (bool waitingParamTimeout);
+    void    _growIndexBatchWindow               (void);
+    void    _sendQueuedParamWrites              (void);
+    void    _removeInFlightParamWrite           (int componentId, const QString& paramName);
     void    _updateProgressBar                  (void);
     void    _checkInitialLoadComplete           (void);
+    Fact*   _findFact                           (int componentId, const QString& paramName) const;
+    bool    _useFTP                             (void);
+    bool    _startFTPDownload                   (void);
+    void    _finishFTPTransfer                  (void);
+    bool    _ftpFileToParams                    (const QString& fileName);
+    void    _endRefreshParameterUpdate          (void);
 
     static QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool failOk = false);
 
     Vehicle*            _vehicle;
     MAVLinkProtocol*    _mavlink;
 
-    QMap<int /* comp id */, QMap<QString /* parameter name */, Fact*>> _mapCompId2FactMap;
+    QMap<int /* comp id */, QHash<QString /* parameter name */, Fact*>> _mapCompId2FactMap;
 
     double      _loadProgress;                  ///< Parameter load progess, [0.0,1.0]
     bool        _parametersReady;               ///< true: parameter load complete
@@ -146,6 +177,8 @@ private:
     typedef QPair<int /* FactMetaData::ValueType_t */, QVariant /* Fact::rawValue */> ParamTypeVal;
     typedef QMap<QString /* parameter name */, ParamTypeVal> CacheMapName2ParamTypeVal;
 
+    bool _readLocalParamCache(const uchar* data, qint64 cBytes, uint32_t crc32_value, bool checkCRC, QList<QPair<QString, ParamTypeVal>>& params);
+
     QMap<int /* component id */, bool>                                              _debugCacheCRC; ///< true: debug cache crc failure
     QMap<int /* component id */, CacheMapName2ParamTypeVal>                         _debugCacheMap;
     QMap<int /* component id */, QMap<QString /* param name */, bool /* seen */>>   _debugCacheParamSeen;
@@ -165,8 +198,15 @@ private:
     static const int    _maxReadWriteRetry = 5;                 ///< Maximum retries read/write
     bool                _disableAllRetries;                     ///< true: Don't retry any requests (used for testing)
 
-    bool        _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
-    QList<int>  _indexBatchQueue;       ///< The current queue of index re-requests
+    bool                    _indexBatchQueueActive;                         ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
+    QMap<int, QSet<int>>    _indexBatchQueue;                               ///< Key: Component id, Value: indices re-requested and not yet answered
+    int                     _indexBatchWindow =         _indexBatchWindowInitial;   ///< Maximum number of index re-requests outstanding
+    int                     _indexBatchThreshold =      _indexBatchWindowMax;       ///< Window size where growth switches from doubling to additive
+    int                     _indexBatchAnswerCount =    0;                          ///< Answers received since the window last grew in the additive phase
+
+    static const int _indexBatchWindowInitial   = 10;
+    static const int _indexBatchWindowMin       = 2;
+    static const int _indexBatchWindowMax       = 64;
 
     QMap<int, int>                  _paramCountMap;             ///< Key: Component id, Value: count of parameters in this component
     QMap<int, QMap<int, int> >      _waitingReadParamIndexMap;  ///< Key: Component id, Value: Map { Key: parameter index still waiting for, Value: retry count }
@@ -174,6 +214,21 @@ private:
     QMap<int, QMap<QString, int> >  _waitingWriteParamNameMap;  ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
     QMap<int, QList<int> >          _failedReadParamIndexMap;   ///< Key: Component id, Value: failed parameter index
 
+    typedef struct {
+        FactMetaData::ValueType_t   valueType;
+        QVariant                    rawValue;
+    } ParamWrite_t;
+
+    // Writes go through a queue so only _maxParamWritesInFlight PARAM_SETs are outstanding at a time. Writes which are still
+    // queued pick up the newest value when the same parameter is written again.
+    QList<QPair<int, QString>>              _queuedParamWriteList;      ///< Component id and name of queued writes in the order they are sent
+    QMap<int, QMap<QString, ParamWrite_t>>  _queuedParamWriteMap;       ///< Key: Component id, Value: Map { Key: parameter name, Value: newest value to send }
+    QMap<int, QMap<QString, ParamWrite_t>>  _inFlightParamWriteMap;     ///< Key: Component id, Value: Map { Key: parameter name, Value: value sent }
+    int                                     _inFlightParamWriteCount = 0;
+    QElapsedTimer                           _paramWriteBatchTimer;      ///< Started when a batch of writes begins, used to report throughput
+
+    static const int _maxParamWritesInFlight = 10;    ///< Matches the number of writes resent after a timeout
+
     int _totalParamCount;                       ///< Number of parameters across all components
     int _waitingWriteParamBatchCount = 0;       ///< Number of parameters which are batched up waiting on write responses
     int _waitingReadParamNameBatchCount = 0;    ///< Number of parameters which are batched up waiting on read responses
@@ -181,10 +236,24 @@ private:
     QTimer _initialRequestTimeoutTimer;
     QTimer _waitingParamTimeoutTimer;
 
+    int             _parameterUpdateDepth   = 0;
+    QList<Fact*>    _parameterUpdateFacts;              ///< Facts holding signals for the open batch, in the order they changed
+    bool            _refreshParameterUpdate = false;    ///< true: refreshAllParameters has a batch open until the reads are done
+
+    bool            _ftpFailed =    false;      ///< Loading the parameter file failed with this vehicle, only use the parameter protocol from now on
+    QTemporaryDir*  _ftpTempDir =   nullptr;    ///< Holds the parameter file while an FTP download is in progress
+
     Fact _defaultFact;   ///< Used to return default fact, when parameter not found
 
     static const char* _jsonParametersKey;
     static const char* _jsonCompIdKey;
     static const char* _jsonParamNameKey;
     static const char* _jsonParamValueKey;
+
+    static const int        _ftpFileHeaderSize      = 6;
+    static const quint16    _ftpFileMagic           = 0x671b;   ///< Matches AP_Filesystem_Param
+    static const quint16    _ftpFileMagicDefaults   = 0x671c;   ///< Default values follow the values of changed parameters
+
+    static const int        _cacheFileHeaderSize    = 12;
+    static const quint32    _cacheFileMagic         = 0x43504751;   ///< "QGPC"
 };
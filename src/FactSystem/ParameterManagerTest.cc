@@ -13,6 +13,8 @@
 #include "QGCApplication.h"
 #include "ParameterManager.h"
 
+#include <QSignalSpy>
+
 /// Test failure modes which should still lead to param load success
 void ParameterManagerTest::_noFailureWorker(MockConfiguration::FailureMode_t failureMode)
 {
@@ -138,3 +140,50 @@ void ParameterManagerTest::_requestListMissingParamFail(void)
     // User should have been notified
     checkExpectedMessageBox();
 }
+
+void ParameterManagerTest::_parameterUpdateBatch(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+    QVERIFY(_vehicle);
+
+    ParameterManager*   parameterManager    = _vehicle->parameterManager();
+    const int           componentId         = _vehicle->defaultComponentId();
+    Fact*               cellsFact           = parameterManager->getParameter(componentId, QStringLiteral("BAT_N_CELLS"));
+    Fact*               velocityFact        = parameterManager->getParameter(componentId, QStringLiteral("MPC_XY_VEL_MAX"));
+
+    QSignalSpy cellsValueSpy    (cellsFact,         &Fact::valueChanged);
+    QSignalSpy cellsUpdatedSpy  (cellsFact,         &Fact::vehicleUpdated);
+    QSignalSpy velocityRawSpy   (velocityFact,      &Fact::rawValueChanged);
+    QSignalSpy completeSpy      (parameterManager,  &ParameterManager::parameterUpdateComplete);
+
+    // Index 65535 is an unrequested update, it doesn't touch the wait lists
+    parameterManager->beginParameterUpdate();
+    parameterManager->beginParameterUpdate();
+    QVERIFY(parameterManager->parameterUpdateInProgress());
+    parameterManager->_handleParamValue(componentId, QStringLiteral("BAT_N_CELLS"), 0, 65535, MAV_PARAM_TYPE_INT32, QVariant(4));
+    parameterManager->_handleParamValue(componentId, QStringLiteral("BAT_N_CELLS"), 0, 65535, MAV_PARAM_TYPE_INT32, QVariant(5));
+    parameterManager->_handleParamValue(componentId, QStringLiteral("MPC_XY_VEL_MAX"), 0, 65535, MAV_PARAM_TYPE_REAL32, QVariant(10.0f));
+
+    // The values are there right away, the signals wait for the batch
+    QCOMPARE(cellsFact->rawValue().toInt(), 5);
+    QCOMPARE(cellsUpdatedSpy.count(), 2);
+    QCOMPARE(cellsValueSpy.count(), 0);
+    QCOMPARE(velocityRawSpy.count(), 0);
+
+    parameterManager->endParameterUpdate();
+    QCOMPARE(cellsValueSpy.count(), 0);
+    QCOMPARE(completeSpy.count(), 0);
+
+    // One signal per changed Fact, however often it changed
+    parameterManager->endParameterUpdate();
+    QVERIFY(!parameterManager->parameterUpdateInProgress());
+    QCOMPARE(cellsValueSpy.count(), 1);
+    QCOMPARE(cellsValueSpy[0][0].toInt(), 5);
+    QCOMPARE(velocityRawSpy.count(), 1);
+    QCOMPARE(completeSpy.count(), 1);
+
+    // Outside of a batch updates signal as they come in
+    parameterManager->_handleParamValue(componentId, QStringLiteral("BAT_N_CELLS"), 0, 65535, MAV_PARAM_TYPE_INT32, QVariant(6));
+    QCOMPARE(cellsValueSpy.count(), 2);
+    QCOMPARE(completeSpy.count(), 1);
+}
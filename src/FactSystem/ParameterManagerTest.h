@@ -25,6 +25,7 @@ private slots:
     void _requestListNoResponse(void);
     void _requestListMissingParamSuccess(void);
     void _requestListMissingParamFail(void);
+    void _parameterUpdateBatch(void);
 
 private:
     void _noFailureWorker(MockConfiguration::FailureMode_t failureMode);
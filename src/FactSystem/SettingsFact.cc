@@ -11,6 +11,7 @@
 #include "SettingsFact.h"
 #include "QGCCorePlugin.h"
 #include "QGCApplication.h"
+#include "QGCSettingsWriteBack.h"
 
 #include <QSettings>
 
@@ -52,6 +53,7 @@ SettingsFact::SettingsFact(QString settingsGroup, FactMetaData* metaData, QObjec
                 _rawValue = rawDefaultValue;
             }
         }
+        _clearValueStringCache();
     }
 
     connect(this, &Fact::rawValueChanged, this, &SettingsFact::_rawValueChanged);
@@ -74,11 +76,6 @@ const SettingsFact& SettingsFact::operator=(const SettingsFact& other)
 
 void SettingsFact::_rawValueChanged(QVariant value)
 {
-    QSettings settings;
-
-    if (!_settingsGroup.isEmpty()) {
-        settings.beginGroup(_settingsGroup);
-    }
-
-    settings.setValue(_name, value);
+    // Batched, a slider bound to the setting would otherwise write the settings file on each step
+    QGCSettingsWriteBack::instance()->setValue(_settingsGroup, _name, value);
 }
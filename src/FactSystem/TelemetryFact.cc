@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryFact.h"
+
+#include <QtMath>
+
+TelemetryFact::TelemetryFact(int componentId, QString name, FactMetaData::ValueType_t type, QObject* parent)
+    : Fact(componentId, name, type, parent)
+{
+    Q_ASSERT(type == FactMetaData::valueTypeDouble || type == FactMetaData::valueTypeFloat || type == FactMetaData::valueTypeInt32);
+}
+
+/// Stores value in place if the raw value already holds a T
+///     @return true: value changed
+template<typename T>
+bool TelemetryFact::_setNativeValue(T value)
+{
+    if (_rawValue.userType() == qMetaTypeId<T>()) {
+        T currentValue = *static_cast<const T*>(_rawValue.constData());
+        if (currentValue == value || (qIsNaN(static_cast<double>(currentValue)) && qIsNaN(static_cast<double>(value)))) {
+            return false;
+        }
+    }
+
+    // QVariant::setValue reuses the existing storage when the type matches
+    _rawValue.setValue(value);
+    _clearValueStringCache();
+    return true;
+}
+
+void TelemetryFact::setTelemetryValue(double value)
+{
+    bool changed;
+
+    switch (_type) {
+    case FactMetaData::valueTypeFloat:
+        changed = _setNativeValue(static_cast<float>(value));
+        break;
+    case FactMetaData::valueTypeInt32:
+        changed = _setNativeValue(qIsNaN(value) ? 0 : static_cast<int32_t>(value));
+        break;
+    default:
+        changed = _setNativeValue(value);
+        break;
+    }
+
+    if (changed) {
+        if (_sendValueChangedSignals) {
+            emit valueChanged(cookedValue());
+            _setDeferredValueChangeSignal(false);
+        } else {
+            _setDeferredValueChangeSignal(true);
+        }
+        emit rawValueChanged(_rawValue);
+    }
+}
+
+double TelemetryFact::telemetryValue(void) const
+{
+    switch (_rawValue.userType()) {
+    case QMetaType::Double:
+        return *static_cast<const double*>(_rawValue.constData());
+    case QMetaType::Float:
+        return static_cast<double>(*static_cast<const float*>(_rawValue.constData()));
+    case QMetaType::Int:
+        return static_cast<double>(*static_cast<const int*>(_rawValue.constData()));
+    default:
+        return _rawValue.toDouble();
+    }
+}
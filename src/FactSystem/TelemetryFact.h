@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "Fact.h"
+
+/// @brief A TelemetryFact is a Fact for high rate numeric values coming from the vehicle.
+///
+/// setTelemetryValue writes the native value straight into the raw value storage and compares it in place, without
+/// going through QVariant conversion, validation or comparison. NaN compares equal to NaN so a value which is not
+/// available does not signal a change on every message. While the owning FactGroup is rate limiting updates nothing
+/// else happens per update; the cooked value and its string are only produced when the deferred signal goes out and
+/// QML reads them. Supports valueTypeDouble, valueTypeFloat and valueTypeInt32.
+class TelemetryFact : public Fact
+{
+    Q_OBJECT
+
+public:
+    TelemetryFact(int componentId, QString name, FactMetaData::ValueType_t type, QObject* parent = nullptr);
+
+    /// Fast path replacement for setRawValue for values coming from the vehicle
+    void setTelemetryValue(double value);
+
+    /// @return Current raw value as a double
+    double telemetryValue(void) const;
+
+private:
+    template<typename T> bool _setNativeValue(T value);
+};
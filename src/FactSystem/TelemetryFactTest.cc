@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryFactTest.h"
+#include "TelemetryFact.h"
+#include "FactGroup.h"
+
+#include <QSignalSpy>
+
+void TelemetryFactTest::_changeSignal_test(void)
+{
+    TelemetryFact   fact(0, "fact", FactMetaData::valueTypeDouble);
+    QSignalSpy      valueSpy(&fact, &Fact::valueChanged);
+    QSignalSpy      rawValueSpy(&fact, &Fact::rawValueChanged);
+
+    fact.setTelemetryValue(1.5);
+    QCOMPARE(valueSpy.count(), 1);
+    QCOMPARE(rawValueSpy.count(), 1);
+    QCOMPARE(fact.rawValue().toDouble(), 1.5);
+    QCOMPARE(fact.telemetryValue(), 1.5);
+
+    // Same value does not signal
+    fact.setTelemetryValue(1.5);
+    QCOMPARE(valueSpy.count(), 1);
+
+    // Regular setRawValue and the fast path see the same storage
+    fact.setRawValue(2.5);
+    QCOMPARE(fact.telemetryValue(), 2.5);
+    fact.setTelemetryValue(2.5);
+    QCOMPARE(valueSpy.count(), 2);
+}
+
+void TelemetryFactTest::_nan_test(void)
+{
+    TelemetryFact   fact(0, "fact", FactMetaData::valueTypeDouble);
+    QSignalSpy      spy(&fact, &Fact::valueChanged);
+
+    fact.setTelemetryValue(qQNaN());
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(qIsNaN(fact.telemetryValue()));
+
+    // Not available stays not available without a signal per message
+    fact.setTelemetryValue(qQNaN());
+    QCOMPARE(spy.count(), 1);
+
+    fact.setTelemetryValue(1.0);
+    QCOMPARE(spy.count(), 2);
+}
+
+void TelemetryFactTest::_types_test(void)
+{
+    TelemetryFact floatFact(0, "float", FactMetaData::valueTypeFloat);
+    TelemetryFact int32Fact(0, "int32", FactMetaData::valueTypeInt32);
+
+    floatFact.setTelemetryValue(1.25);
+    QCOMPARE(static_cast<int>(floatFact.rawValue().userType()), static_cast<int>(QMetaType::Float));
+    QCOMPARE(floatFact.telemetryValue(), 1.25);
+
+    int32Fact.setTelemetryValue(42.7);
+    QCOMPARE(static_cast<int>(int32Fact.rawValue().userType()), static_cast<int>(QMetaType::Int));
+    QCOMPARE(int32Fact.rawValue().toInt(), 42);
+    QCOMPARE(int32Fact.rawValueString(), QStringLiteral("42"));
+}
+
+void TelemetryFactTest::_deferred_test(void)
+{
+    class TestFactGroup : public FactGroup
+    {
+    public:
+        TestFactGroup(void)
+            : FactGroup (100)
+            , fact      (0, "fact", FactMetaData::valueTypeDouble)
+        {
+            _addFact(&fact, "fact");
+        }
+
+        TelemetryFact fact;
+    };
+
+    TestFactGroup   factGroup;
+    QSignalSpy      spy(&factGroup.fact, &Fact::valueChanged);
+
+    // Rate limited group only hears about the last value
+    for (int i=1; i<=10; i++) {
+        factGroup.fact.setTelemetryValue(i);
+    }
+    QCOMPARE(spy.count(), 0);
+    QVERIFY(spy.wait(1000));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toDouble(), 10.0);
+}
+
+void TelemetryFactTest::_valueString_test(void)
+{
+    TelemetryFact fact(0, "fact", FactMetaData::valueTypeDouble);
+    fact.metaData()->setDecimalPlaces(2);
+
+    fact.setTelemetryValue(1.5);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("1.50"));
+
+    // Every way of changing the value drops the cached string
+    fact.setTelemetryValue(2.5);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("2.50"));
+    fact.setRawValue(3.5);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("3.50"));
+    fact._containerSetRawValue(4.5);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("4.50"));
+
+    // As do formatting changes to the meta data
+    fact.metaData()->setDecimalPlaces(1);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("4.5"));
+    fact.metaData()->setTranslators([](const QVariant& cooked) { return QVariant(cooked.toDouble() / 2); },
+                                    [](const QVariant& raw) { return QVariant(raw.toDouble() * 2); });
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("9.0"));
+}
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for TelemetryFact
+class TelemetryFactTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _changeSignal_test (void);
+    void _nan_test          (void);
+    void _types_test        (void);
+    void _deferred_test     (void);
+    void _valueString_test  (void);
+};
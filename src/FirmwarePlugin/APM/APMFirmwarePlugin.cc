@@ -466,6 +466,39 @@ bool APMFirmwarePlugin::sendHomePositionToVehicle(void)
     return true;
 }
 
+int APMFirmwarePlugin::missionReadWindowSize(void)
+{
+    // ArduPilot answers requests for any item in range independently of each other
+    return 10;
+}
+
+bool APMFirmwarePlugin::concurrentPlanReads(void)
+{
+    // Each plan type is served by its own mission item protocol handler
+    return true;
+}
+
+QString APMFirmwarePlugin::missionFTPPath(MAV_MISSION_TYPE planType)
+{
+    // Virtual files served by AP_Filesystem_Mission
+    switch (planType) {
+    case MAV_MISSION_TYPE_MISSION:
+        return QStringLiteral("@MISSION/mission.dat");
+    case MAV_MISSION_TYPE_FENCE:
+        return QStringLiteral("@MISSION/fence.dat");
+    case MAV_MISSION_TYPE_RALLY:
+        return QStringLiteral("@MISSION/rally.dat");
+    default:
+        return QString();
+    }
+}
+
+QString APMFirmwarePlugin::parameterFTPPath(void)
+{
+    // Virtual file served by AP_Filesystem_Param
+    return QStringLiteral("@PARAM/param.pck");
+}
+
 FactMetaData* APMFirmwarePlugin::_getMetaDataForFact(QObject* parameterMetaData, const QString& name, FactMetaData::ValueType_t type, MAV_TYPE vehicleType)
 {
     APMParameterMetaData* apmMetaData = qobject_cast<APMParameterMetaData*>(parameterMetaData);
@@ -74,6 +74,10 @@ public:
     virtual void        initializeStreamRates           (Vehicle* vehicle);
     void                initializeVehicle               (Vehicle* vehicle) override;
     bool                sendHomePositionToVehicle       (void) override;
+    int                 missionReadWindowSize           (void) override;
+    bool                concurrentPlanReads             (void) override;
+    QString             missionFTPPath                  (MAV_MISSION_TYPE planType) override;
+    QString             parameterFTPPath                (void) override;
     QString             missionCommandOverrides         (QGCMAVLink::VehicleClass_t vehicleClass) const override;
     QString             _internalParameterMetaDataFile  (Vehicle* vehicle) override;
     FactMetaData*       _getMetaDataForFact             (QObject* parameterMetaData, const QString& name, FactMetaData::ValueType_t type, MAV_TYPE vehicleType) override;
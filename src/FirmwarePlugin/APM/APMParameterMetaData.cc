@@ -213,7 +213,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                         // so not setting currentCategory
                         xmlState.push(XmlStateFoundParameters);
                     } else {
-                        qCDebug(APMParameterMetaDataVerboseLog) << "not interested in this block of parameters, skipping:" << nameValue;
+                        qCVerbose(APMParameterMetaDataVerboseLog) << "not interested in this block of parameters, skipping:" << nameValue;
                         if (skipXMLBlock(xml, "parameters")) {
                             qCWarning(APMParameterMetaDataLog) << "something wrong with the xml, skip of the xml failed";
                             return;
@@ -246,7 +246,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 QString shortDescription = xml.attributes().value("humanName").toString();
                 QString longDescription = xml.attributes().value("documentation").toString();
 
-                qCDebug(APMParameterMetaDataVerboseLog) << "Found parameter name:" << name
+                qCVerbose(APMParameterMetaDataVerboseLog) << "Found parameter name:" << name
                           << "short Desc:" << shortDescription
                           << "longDescription:" << longDescription
                           << "category: " << category
@@ -261,7 +261,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                     _vehicleTypeToParametersMap[currentCategory][name] = rawMetaData;
                     groupMembers[group] << name;
                 }
-                qCDebug(APMParameterMetaDataVerboseLog) << "inserting metadata for field" << name;
+                qCVerbose(APMParameterMetaDataVerboseLog) << "inserting metadata for field" << name;
                 rawMetaData->name = name;
                 if (!category.isEmpty()) {
                     rawMetaData->category = category;
@@ -289,17 +289,17 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             if (elementName == "param" && xmlState.top() == XmlStateFoundParameter) {
                 // Done loading this parameter
                 // Reset for next parameter
-                qCDebug(APMParameterMetaDataVerboseLog) << "done loading parameter";
+                qCVerbose(APMParameterMetaDataVerboseLog) << "done loading parameter";
                 rawMetaData = nullptr;
                 badMetaData = false;
                 xmlState.pop();
             } else if (elementName == "parameters") {
-                qCDebug(APMParameterMetaDataVerboseLog) << "end of parameters for category: " << currentCategory;
+                qCVerbose(APMParameterMetaDataVerboseLog) << "end of parameters for category: " << currentCategory;
                 correctGroupMemberships(_vehicleTypeToParametersMap[currentCategory], groupMembers);
                 groupMembers.clear();
                 xmlState.pop();
             } else if (elementName == "vehicles") {
-                qCDebug(APMParameterMetaDataVerboseLog) << "vehicles end here, libraries will follow";
+                qCVerbose(APMParameterMetaDataVerboseLog) << "vehicles end here, libraries will follow";
                 xmlState.pop();
             }
         }
@@ -344,10 +344,10 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
                 QString range = xml.readElementText().trimmed();
                 QStringList rangeList = range.split(' ');
                 if (rangeList.count() != 2) {
-                    qCDebug(APMParameterMetaDataVerboseLog) << "space seperator didn't work',trying 'to' separator";
+                    qCVerbose(APMParameterMetaDataVerboseLog) << "space seperator didn't work',trying 'to' separator";
                     rangeList = range.split("to");
                     if (rangeList.count() != 2) {
-                        qCDebug(APMParameterMetaDataVerboseLog) << " 'to' seperaator didn't work', trying '-' as seperator";
+                        qCVerbose(APMParameterMetaDataVerboseLog) << " 'to' seperaator didn't work', trying '-' as seperator";
                         rangeList = range.split('-');
                         if (rangeList.count() != 2) {
                             qCDebug(APMParameterMetaDataLog) << "something wrong with range, all three separators have failed" << range;
@@ -367,22 +367,22 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
                     if(rawMetaData->max.contains(' ')) {
                         rawMetaData->max = rawMetaData->max.split(' ').first();
                     }
-                    qCDebug(APMParameterMetaDataVerboseLog) << "read field parameter " << "min: " << rawMetaData->min
+                    qCVerbose(APMParameterMetaDataVerboseLog) << "read field parameter " << "min: " << rawMetaData->min
                                                      << "max: " << rawMetaData->max;
                 }
             } else if (attributeName == "Increment") {
                 QString increment = xml.readElementText();
-                qCDebug(APMParameterMetaDataVerboseLog) << "read Increment: " << increment;
+                qCVerbose(APMParameterMetaDataVerboseLog) << "read Increment: " << increment;
                 rawMetaData->incrementSize = increment;
             } else if (attributeName == "Units") {
                 QString units = xml.readElementText();
-                qCDebug(APMParameterMetaDataVerboseLog) << "read Units: " << units;
+                qCVerbose(APMParameterMetaDataVerboseLog) << "read Units: " << units;
                 rawMetaData->units = units;
             } else if (attributeName == "Bitmask") {
                 bool    parseError = false;
 
                 QString bitmaskString = xml.readElementText();
-                qCDebug(APMParameterMetaDataVerboseLog) << "read Bitmask: " << bitmaskString;
+                qCVerbose(APMParameterMetaDataVerboseLog) << "read Bitmask: " << bitmaskString;
                 QStringList bitmaskList = bitmaskString.split(",");
                 if (bitmaskList.count() > 0) {
                     foreach (const QString& bitmask, bitmaskList) {
@@ -411,7 +411,7 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
         } else if (elementName == "value") {
             QString valueValue = xml.attributes().value("code").toString();
             QString valueName = xml.readElementText();
-            qCDebug(APMParameterMetaDataVerboseLog) << "read value parameter " << "value desc: "
+            qCVerbose(APMParameterMetaDataVerboseLog) << "read value parameter " << "value desc: "
                                              << valueName << "code: " << valueValue;
             values << QPair<QString,QString>(valueValue, valueName);
             rawMetaData->values = values;
@@ -425,6 +425,22 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
 }
 
 FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type)
+{
+    // The meta data can be shared between vehicles, so each fact only gets built once per vehicle type
+    QHash<QString, FactMetaData*>&  factMetaDataMap = _vehicleTypeToFactMetaDataMap[static_cast<int>(vehicleType)];
+    FactMetaData*                   metaData        = factMetaDataMap.value(name, nullptr);
+
+    if (metaData && metaData->type() == type) {
+        return metaData;
+    }
+    metaData = _createMetaDataForFact(name, vehicleType, type);
+    if (!factMetaDataMap.contains(name)) {
+        factMetaDataMap[name] = metaData;
+    }
+    return metaData;
+}
+
+FactMetaData* APMParameterMetaData::_createMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type)
 {
     const QString mavTypeString = mavTypeToString(vehicleType);
     APMFactMetaDataRaw* rawMetaData = nullptr;
@@ -13,6 +13,7 @@
 
 #include <QObject>
 #include <QMap>
+#include <QHash>
 #include <QPointer>
 #include <QXmlStreamReader>
 #include <QLoggingCategory>
@@ -82,10 +83,12 @@ private:
     void correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap, QMap<QString,QStringList>& groupMembers);
     QString mavTypeToString(MAV_TYPE vehicleTypeEnum);
     QString _groupFromParameterName(const QString& name);
+    FactMetaData* _createMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type);
 
     bool                                            _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
     // FIXME: metadata is vehicle type specific now
     QMap<QString, ParameterNametoFactMetaDataMap>   _vehicleTypeToParametersMap;                ///< Maps from a vehicle type to paramametertoFactMeta map>
+    QHash<int, QHash<QString, FactMetaData*>>       _vehicleTypeToFactMetaDataMap;              ///< FactMetaData already built, keyed by MAV_TYPE then parameter name
 };
 
 #endif
@@ -174,6 +174,30 @@ bool FirmwarePlugin::sendHomePositionToVehicle(void)
     return false;
 }
 
+int FirmwarePlugin::missionReadWindowSize(void)
+{
+    // Requesting one item at a time works with any stack
+    return 1;
+}
+
+bool FirmwarePlugin::concurrentPlanReads(void)
+{
+    // Some stacks only run a single plan transfer at a time across all plan types
+    return false;
+}
+
+QString FirmwarePlugin::missionFTPPath(MAV_MISSION_TYPE /* planType */)
+{
+    // There is no standard location for plan files
+    return QString();
+}
+
+QString FirmwarePlugin::parameterFTPPath(void)
+{
+    // There is no standard location for a parameter file
+    return QString();
+}
+
 QList<MAV_CMD> FirmwarePlugin::supportedMissionCommands(QGCMAVLink::VehicleClass_t /* vehicleClass */)
 {
     // Generic supports all commands
@@ -1044,6 +1068,10 @@ void FirmwarePlugin::sendGCSMotionReport(Vehicle* vehicle, FollowMe::GCSMotionRe
         follow_target.lon =                 motionReport.lon_int;
         follow_target.vel[0] =              static_cast<float>(motionReport.vxMetersPerSec);
         follow_target.vel[1] =              static_cast<float>(motionReport.vyMetersPerSec);
+        follow_target.vel[2] =              static_cast<float>(motionReport.vzMetersPerSec);
+        follow_target.acc[0] =              static_cast<float>(motionReport.axMetersPerSec2);
+        follow_target.acc[1] =              static_cast<float>(motionReport.ayMetersPerSec2);
+        follow_target.acc[2] =              static_cast<float>(motionReport.azMetersPerSec2);
 
         mavlink_message_t message;
         mavlink_msg_follow_target_encode_chan(static_cast<uint8_t>(mavlinkProtocol->getSystemId()),
@@ -209,6 +209,23 @@ public:
     ///     false: Do not send first item to vehicle, sequence numbers must be adjusted
     virtual bool sendHomePositionToVehicle(void);
 
+    /// @return Number of MISSION_REQUEST messages which can be outstanding at the same time when reading a plan from the
+    ///         vehicle. 1 is the strict one item at a time sequence needed by stacks which only answer the request they are
+    ///         expecting next.
+    virtual int missionReadWindowSize(void);
+
+    /// @return true: Mission, geofence and rally point plans can be read from the vehicle at the same time. The stack must
+    ///         keep the transfers of each plan type apart from each other.
+    virtual bool concurrentPlanReads(void);
+
+    /// @return Path on the vehicle of the file which holds the plan of the specified type for transfers over MAVLink FTP.
+    ///         The file is laid out as ArduPilot's mission files are. Empty if plans can't be transferred as a file.
+    virtual QString missionFTPPath(MAV_MISSION_TYPE planType);
+
+    /// @return Path on the vehicle of the packed file which holds all autopilot parameters for loading over MAVLink FTP.
+    ///         The file is laid out as ArduPilot's param.pck is. Empty if parameters can't be loaded as a file.
+    virtual QString parameterFTPPath(void);
+
     /// Returns the parameter set version info pulled from inside the meta data file. -1 if not found.
     /// Note: The implementation for this must not vary by vehicle type.
     /// Important: Only CompInfoParam code should use this method
@@ -219,12 +236,12 @@ public:
     virtual QString _internalParameterMetaDataFile(Vehicle* /*vehicle*/) { return QString(); }
 
     /// Loads the specified parameter meta data file.
-    /// @return Opaque parameter meta data information which must be stored with Vehicle. Vehicle is responsible to
-    ///         call deleteParameterMetaData when no longer needed.
+    /// @return Opaque parameter meta data information. CompInfoParam shares it between all vehicles which load the same
+    ///         file and deletes it once the last of them goes away, so it must not hold any vehicle specific state.
     /// Important: Only CompInfoParam code should use this method
     virtual QObject* _loadParameterMetaData(const QString& /*metaDataFile*/) { return nullptr; }
 
-    /// Returns the FactMetaData associated with the parameter name
+    /// Returns the FactMetaData associated with the parameter name. The returned meta data may be handed to more than one vehicle.
     ///     @param opaqueParameterMetaData Opaque pointer returned from loadParameterMetaData
     /// Important: Only CompInfoParam code should use this method
     virtual FactMetaData* _getMetaDataForFact(QObject* /*parameterMetaData*/, const QString& /*name*/, FactMetaData::ValueType_t /* type */, MAV_TYPE /*vehicleType*/) { return nullptr; }
@@ -102,18 +102,19 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         return;
     }
     
-    QXmlStreamReader xml(xmlFile.readAll());
+    _xmlText = QString::fromUtf8(xmlFile.readAll());
     xmlFile.close();
+
+    QXmlStreamReader xml(_xmlText);
     if (xml.hasError()) {
         qWarning() << "Badly formed XML" << xml.errorString();
         return;
     }
     
-    QString         factGroup;
-    QString         errorString;
-    FactMetaData*   metaData = nullptr;
-    int             xmlState = XmlStateNone;
-    bool            badMetaData = true;
+    // Only the location of each parameter element is recorded here. The element is parsed into FactMetaData the first
+    // time the parameter is asked for, so parameters the vehicle doesn't have cost nothing beyond this scan.
+    QString factGroup;
+    int     xmlState = XmlStateNone;
     
     while (!xml.atEnd()) {
         if (xml.isStartElement()) {
@@ -171,13 +172,74 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                     qWarning() << "Badly formed XML";
                     return;
                 }
-                xmlState = XmlStateFoundParameter;
                 
                 if (!xml.attributes().hasAttribute("name") || !xml.attributes().hasAttribute("type")) {
                     qWarning() << "Badly formed XML";
                     return;
                 }
                 
+                QString             name = xml.attributes().value("name").toString();
+                ParameterElement_t  element;
+
+                // The reader is past the start tag at this point. Anything the reader has read ahead beyond the end tag
+                // is harmless since parsing of the element stops at the end tag.
+                element.group       = factGroup;
+                element.offset      = _xmlText.lastIndexOf(QLatin1String("<parameter"), static_cast<int>(xml.characterOffset()) - 1);
+                element.duplicate   = false;
+
+                xml.skipCurrentElement();
+                element.length = xml.characterOffset() - element.offset;
+
+                if (element.offset < 0) {
+                    qWarning() << "Badly formed XML";
+                    return;
+                }
+                if (_parameterElements.contains(name)) {
+                    // We can't trust the meta data since we have dups
+                    qCWarning(PX4ParameterMetaDataLog) << "Duplicate parameter found:" << name;
+                    _parameterElements[name].duplicate = true;
+                } else {
+                    _parameterElements[name] = element;
+                }
+
+            } else {
+                qWarning() << "Badly formed XML";
+                return;
+            }
+        } else if (xml.isEndElement()) {
+            QString elementName = xml.name().toString();
+
+            if (elementName == "group") {
+                xmlState = XmlStateFoundVersion;
+            } else if (elementName == "parameters") {
+                xmlState = XmlStateFoundParameters;
+            }
+        }
+        xml.readNext();
+    }
+
+    qCDebug(PX4ParameterMetaDataLog) << "Found parameter count:" << _parameterElements.count();
+
+#ifdef GENERATE_PARAMETER_JSON
+    _generateParameterJson();
+#endif
+}
+
+/// Parses the XML for a single parameter element found by loadParameterFactMetaDataFile
+/// @return nullptr: the element could not be used
+FactMetaData* PX4ParameterMetaData::_parseParameterElement(const ParameterElement_t& element)
+{
+    QXmlStreamReader    xml(_xmlText.mid(static_cast<int>(element.offset), static_cast<int>(element.length)));
+    QString             errorString;
+    FactMetaData*       metaData = nullptr;
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+
+        if (xml.isStartElement()) {
+            QString elementName = xml.name().toString();
+
+            if (elementName == "parameter") {
                 QString name = xml.attributes().value("name").toString();
                 QString type = xml.attributes().value("type").toString();
                 QString strDefault =    xml.attributes().value("default").toString();
@@ -208,202 +270,168 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 FactMetaData::ValueType_t foundType = FactMetaData::stringToType(type, unknownType);
                 if (unknownType) {
                     qWarning() << "Parameter meta data with bad type:" << type << " name:" << name;
-                    return;
+                    return nullptr;
                 }
                 
-                // Now that we know type we can create meta data object and add it to the system
+                // Now that we know type we can create meta data object
                 metaData = new FactMetaData(foundType, this);
-                if (_mapParameterName2FactMetaData.contains(name)) {
-                    // We can't trust the meta data since we have dups
-                    qCWarning(PX4ParameterMetaDataLog) << "Duplicate parameter found:" << name;
-                    badMetaData = true;
-                    // Reset to default meta data
-                    _mapParameterName2FactMetaData[name] = metaData;
-                } else {
-                    _mapParameterName2FactMetaData[name] = metaData;
-                    metaData->setName(name);
-                    metaData->setCategory(category);
-                    metaData->setGroup(factGroup);
-                    metaData->setReadOnly(readOnly);
-                    metaData->setVolatileValue(volatileValue);
+                metaData->setName(name);
+                metaData->setCategory(category);
+                metaData->setGroup(element.group);
+                metaData->setReadOnly(readOnly);
+                metaData->setVolatileValue(volatileValue);
                     
-                    if (xml.attributes().hasAttribute("default") && !strDefault.isEmpty()) {
-                        QVariant varDefault;
+                if (xml.attributes().hasAttribute("default") && !strDefault.isEmpty()) {
+                    QVariant varDefault;
                         
-                        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
-                            metaData->setRawDefaultValue(varDefault);
-                        } else {
-                            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
-                        }
+                    if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
+                        metaData->setRawDefaultValue(varDefault);
+                    } else {
+                        qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
                     }
                 }
-                
-            } else {
-                // We should be getting meta data now
-                if (xmlState != XmlStateFoundParameter) {
-                    qWarning() << "Badly formed XML";
-                    return;
+
+            } else if (!metaData) {
+                qWarning() << "Badly formed XML";
+                return nullptr;
+
+            } else if (elementName == "short_desc") {
+                QString text = xml.readElementText();
+                text = text.replace("\n", " ");
+                qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
+                metaData->setShortDescription(text);
+
+            } else if (elementName == "long_desc") {
+                QString text = xml.readElementText();
+                text = text.replace("\n", " ");
+                qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
+                metaData->setLongDescription(text);
+
+            } else if (elementName == "min") {
+                QString text = xml.readElementText();
+                qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
+
+                QVariant varMin;
+                if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
+                    metaData->setRawMin(varMin);
+                } else {
+                    qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
+                }
+
+            } else if (elementName == "max") {
+                QString text = xml.readElementText();
+                qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
+
+                QVariant varMax;
+                if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
+                    metaData->setRawMax(varMax);
+                } else {
+                    qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
+                }
+
+            } else if (elementName == "unit") {
+                QString text = xml.readElementText();
+                qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
+                metaData->setRawUnits(text);
+
+            } else if (elementName == "decimal") {
+                QString text = xml.readElementText();
+                qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
+
+                bool convertOk;
+                QVariant varDecimals = QVariant(text).toUInt(&convertOk);
+                if (convertOk) {
+                    metaData->setDecimalPlaces(varDecimals.toInt());
+                } else {
+                    qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
+                }
+
+            } else if (elementName == "reboot_required") {
+                QString text = xml.readElementText();
+                qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
+                if (text.compare("true", Qt::CaseInsensitive) == 0) {
+                    metaData->setVehicleRebootRequired(true);
                 }
 
-                if (!badMetaData) {
-                    if (metaData) {
-                        if (elementName == "short_desc") {
-                            QString text = xml.readElementText();
-                            text = text.replace("\n", " ");
-                            qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
-                            metaData->setShortDescription(text);
-
-                        } else if (elementName == "long_desc") {
-                            QString text = xml.readElementText();
-                            text = text.replace("\n", " ");
-                            qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
-                            metaData->setLongDescription(text);
-
-                        } else if (elementName == "min") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
-
-                            QVariant varMin;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
-                                metaData->setRawMin(varMin);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
-                            }
-
-                        } else if (elementName == "max") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
-
-                            QVariant varMax;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
-                                metaData->setRawMax(varMax);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
-                            }
-
-                        } else if (elementName == "unit") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
-                            metaData->setRawUnits(text);
-
-                        } else if (elementName == "decimal") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
-
-                            bool convertOk;
-                            QVariant varDecimals = QVariant(text).toUInt(&convertOk);
-                            if (convertOk) {
-                                metaData->setDecimalPlaces(varDecimals.toInt());
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
-                            }
-
-                        } else if (elementName == "reboot_required") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
-                            if (text.compare("true", Qt::CaseInsensitive) == 0) {
-                                metaData->setVehicleRebootRequired(true);
-                            }
-
-                        } else if (elementName == "values") {
-                            // doing nothing individual value will follow anyway. May be used for sanity checking.
-
-                        } else if (elementName == "value") {
-                            QString enumValueStr = xml.attributes().value("code").toString();
-                            QString enumString = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                             << "value desc:" << enumString << "code:" << enumValueStr;
-
-                            QVariant    enumValue;
-                            QString     errorString;
-                            if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
-                                metaData->addEnumInfo(enumString, enumValue);
-                            } else {
-                                qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
-                                                                 << " type:" << metaData->type() << " value:" << enumValueStr
-                                                                 << " error:" << errorString;
-                            }
-                        } else if (elementName == "increment") {
-                            double  increment;
-                            bool    ok;
-                            QString text = xml.readElementText();
-                            increment = text.toDouble(&ok);
-                            if (ok) {
-                                metaData->setRawIncrement(increment);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
-                            }
-
-                        } else if (elementName == "boolean") {
-                            QVariant    enumValue;
-                            metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Enabled"), enumValue);
-                            metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Disabled"), enumValue);
-
-                        } else if (elementName == "bitmask") {
-                            // doing nothing individual bits will follow anyway. May be used for sanity checking.
-
-                        } else if (elementName == "bit") {
-                            bool ok = false;
-                            unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
-                            if (ok) {
-                                QString bitDescription = xml.readElementText();
-                                qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                                 << "index:" << bit << "description:" << bitDescription;
-
-                                if (bit < 31) {
-                                    QVariant bitmaskRawValue = 1 << bit;
-                                    QVariant bitmaskValue;
-                                    QString errorString;
-                                    if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
-                                        metaData->addBitmaskInfo(bitDescription, bitmaskValue);
-                                    } else {
-                                        qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
-                                                                         << " type:" << metaData->type() << " value:" << bitmaskValue
-                                                                         << " error:" << errorString;
-                                    }
-                                } else {
-                                    qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
-                                }
-                            }
+            } else if (elementName == "values") {
+                // doing nothing individual value will follow anyway. May be used for sanity checking.
+
+            } else if (elementName == "value") {
+                QString enumValueStr = xml.attributes().value("code").toString();
+                QString enumString = xml.readElementText();
+                qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
+                                                 << "value desc:" << enumString << "code:" << enumValueStr;
+
+                QVariant    enumValue;
+                QString     errorString;
+                if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
+                    metaData->addEnumInfo(enumString, enumValue);
+                } else {
+                    qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
+                                                     << " type:" << metaData->type() << " value:" << enumValueStr
+                                                     << " error:" << errorString;
+                }
+            } else if (elementName == "increment") {
+                double  increment;
+                bool    ok;
+                QString text = xml.readElementText();
+                increment = text.toDouble(&ok);
+                if (ok) {
+                    metaData->setRawIncrement(increment);
+                } else {
+                    qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
+                }
+
+            } else if (elementName == "boolean") {
+                QVariant    enumValue;
+                metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
+                metaData->addEnumInfo(tr("Enabled"), enumValue);
+                metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
+                metaData->addEnumInfo(tr("Disabled"), enumValue);
+
+            } else if (elementName == "bitmask") {
+                // doing nothing individual bits will follow anyway. May be used for sanity checking.
+
+            } else if (elementName == "bit") {
+                bool ok = false;
+                unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
+                if (ok) {
+                    QString bitDescription = xml.readElementText();
+                    qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
+                                                     << "index:" << bit << "description:" << bitDescription;
+
+                    if (bit < 31) {
+                        QVariant bitmaskRawValue = 1 << bit;
+                        QVariant bitmaskValue;
+                        QString errorString;
+                        if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
+                            metaData->addBitmaskInfo(bitDescription, bitmaskValue);
                         } else {
-                            qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
+                            qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
+                                                             << " type:" << metaData->type() << " value:" << bitmaskValue
+                                                             << " error:" << errorString;
                         }
                     } else {
-                        qWarning() << "Internal error";
+                        qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
                     }
                 }
+            } else {
+                qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
             }
-        } else if (xml.isEndElement()) {
-            QString elementName = xml.name().toString();
-
-            if (elementName == "parameter") {
-                // Done loading this parameter, validate default value
-                if (metaData->defaultValueAvailable()) {
-                    QVariant var;
+        } else if (xml.isEndElement() && metaData && xml.name() == QLatin1String("parameter")) {
+            // Done loading this parameter, validate default value
+            if (metaData->defaultValueAvailable()) {
+                QVariant var;
 
-                    if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
-                        qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
-                    }
+                if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
+                    qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
                 }
-
-                // Reset for next parameter
-                metaData = nullptr;
-                badMetaData = false;
-                xmlState = XmlStateFoundGroup;
-            } else if (elementName == "group") {
-                xmlState = XmlStateFoundVersion;
-            } else if (elementName == "parameters") {
-                xmlState = XmlStateFoundParameters;
             }
+            break;
         }
-        xml.readNext();
     }
 
-#ifdef GENERATE_PARAMETER_JSON
-    _generateParameterJson();
-#endif
+    return metaData;
 }
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -430,6 +458,11 @@ void PX4ParameterMetaData::_generateParameterJson()
     _jsonWriteLine(jsonFile, indentLevel, "\"scope\": \"Firmware\",");
     _jsonWriteLine(jsonFile, indentLevel++, "\"parameters\": [");
 
+    // Meta data is only built on request, so build all of it first
+    for (const QString& paramName: _parameterElements.keys()) {
+        getMetaDataForFact(paramName, MAV_TYPE_GENERIC, FactMetaData::valueTypeFloat);
+    }
+
     int keyIndex = 0;
     for (const QString& paramName: _mapParameterName2FactMetaData.keys()) {
         const FactMetaData* metaData = _mapParameterName2FactMetaData[paramName];
@@ -494,13 +527,22 @@ FactMetaData* PX4ParameterMetaData::getMetaDataForFact(const QString& name, MAV_
 {
     Q_UNUSED(vehicleType)
 
-    if (!_mapParameterName2FactMetaData.contains(name)) {
+    FactMetaData* metaData = _mapParameterName2FactMetaData.value(name, nullptr);
+    if (metaData) {
+        return metaData;
+    }
+
+    auto elementIter = _parameterElements.constFind(name);
+    if (elementIter != _parameterElements.constEnd() && !elementIter->duplicate) {
+        metaData = _parseParameterElement(*elementIter);
+    }
+    if (!metaData) {
         qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
-        FactMetaData* metaData = new FactMetaData(type, this);
-        _mapParameterName2FactMetaData[name] = metaData;
+        metaData = new FactMetaData(type, this);
     }
+    _mapParameterName2FactMetaData[name] = metaData;
 
-    return _mapParameterName2FactMetaData[name];
+    return metaData;
 }
 
 void PX4ParameterMetaData::getParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion)
@@ -11,6 +11,7 @@
 
 #include <QObject>
 #include <QMap>
+#include <QHash>
 #include <QXmlStreamReader>
 #include <QLoggingCategory>
 
@@ -48,7 +49,16 @@ private:
         XmlStateDone
     };    
 
-    QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
+    /// Location of a parameter element in the meta data file
+    typedef struct {
+        QString group;
+        qint64  offset;
+        qint64  length;
+        bool    duplicate;      ///< true: parameter is in the file more than once, its meta data can't be trusted
+    } ParameterElement_t;
+
+    QVariant        _stringToTypedVariant   (const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
+    FactMetaData*   _parseParameterElement  (const ParameterElement_t& element);
     static void _outputFileWarning(const QString& metaDataFile, const QString& error1, const QString& error2);
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -56,5 +66,7 @@ private:
 #endif
 
     bool                                _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData
+    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData, built on request
+    QString                             _xmlText;                                   ///< Contents of the meta data file
+    QHash<QString, ParameterElement_t>  _parameterElements;                         ///< Maps from a parameter name to its element in _xmlText
 };
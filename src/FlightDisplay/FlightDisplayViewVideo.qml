@@ -38,6 +38,10 @@ Item {
 
     property double _thermalHeightFactor: 0.85 //-- TODO
 
+    // Decoding is paused while the video is off screen, for example when the pip is collapsed
+    onVisibleChanged:       QGroundControl.videoManager.setVideoVisible(0, visible)
+    Component.onCompleted:  QGroundControl.videoManager.setVideoVisible(0, visible)
+
     Rectangle {
         id:             noVideo
         anchors.fill:   parent
@@ -131,6 +135,17 @@ Item {
             property bool videoDisabled: QGroundControl.settingsManager.videoSettings.videoSource.rawValue === QGroundControl.settingsManager.videoSettings.disabledVideoSource
         }
 
+        //-- Video latency, shown while tuning for low latency
+        QGCLabel {
+            anchors.right:      parent.right
+            anchors.bottom:     parent.bottom
+            anchors.margins:    ScreenTools.defaultFontPixelWidth
+            text:               qsTr("%1 ms").arg(QGroundControl.videoManager.videoLatency)
+            color:              "white"
+            font.pointSize:     ScreenTools.smallFontPointSize
+            visible:            QGroundControl.settingsManager.videoSettings.lowLatencyMode.rawValue && QGroundControl.videoManager.videoLatency > 0
+        }
+
         //-- Thermal Image
         Item {
             id:                 thermalItem
@@ -161,7 +176,9 @@ Item {
             }
             onVisibleChanged: {
                 thermalItem.pipOrNot()
+                QGroundControl.videoManager.setVideoVisible(1, visible)
             }
+            Component.onCompleted: QGroundControl.videoManager.setVideoVisible(1, visible)
             QGCVideoBackground {
                 id:             thermalVideo
                 objectName:     "thermalVideo"
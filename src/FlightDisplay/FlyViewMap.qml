@@ -224,24 +224,16 @@ FlightMap {
     }
 
     // Add trajectory lines to the map
-    MapPolyline {
-        id:         trajectoryPolyline
-        line.width: 3
-        line.color: "red"
-        z:          QGroundControl.zOrderTrajectoryLines
-        visible:    !pipMode
-
-        Connections {
-            target:                 QGroundControl.multiVehicleManager
-            onActiveVehicleChanged: trajectoryPolyline.path = _activeVehicle ? _activeVehicle.trajectoryPoints.list() : []
-        }
-
-        Connections {
-            target:                 _activeVehicle ? _activeVehicle.trajectoryPoints : null
-            onPointAdded:           trajectoryPolyline.addCoordinate(coordinate)
-            onUpdateLastPoint:      trajectoryPolyline.replaceCoordinate(trajectoryPolyline.pathLength() - 1, coordinate)
-            onPointsCleared:        trajectoryPolyline.path = []
-        }
+    TrajectoryMapItem {
+        anchors.fill:       parent
+        trajectoryPoints:   _activeVehicle ? _activeVehicle.trajectoryPoints : null
+        center:             _root.center
+        zoomLevel:          _root.zoomLevel
+        bearing:            _root.bearing
+        lineWidth:          3
+        color:              "red"
+        z:                  QGroundControl.zOrderTrajectoryLines
+        visible:            !pipMode
     }
 
     // Add the vehicles to the map
@@ -265,17 +257,29 @@ FlightMap {
             z:              QGroundControl.zOrderVehicles
         }
     }
-    // Add ADSB vehicles to the map
-    MapItemView {
-        model: QGroundControl.adsbVehicleManager.adsbVehicles
-        delegate: VehicleMapItem {
-            coordinate:     object.coordinate
-            altitude:       object.altitude
-            callsign:       object.callsign
-            heading:        object.heading
-            alert:          object.alert
+    // Add ADSB vehicles to the map. All of the traffic is drawn by a single item, only the labels are separate items.
+    ADSBTrafficMapItem {
+        id:             adsbTrafficLayer
+        anchors.fill:   parent
+        center:         _root.center
+        zoomLevel:      _root.zoomLevel
+        bearing:        _root.bearing
+        size:           ScreenTools.defaultFontPixelHeight * 2.5
+        color:          Qt.rgba(0.94, 0.91, 0, 1)
+        z:              QGroundControl.zOrderVehicles
+    }
+    Repeater {
+        model: adsbTrafficLayer.labels.length
+
+        QGCMapLabel {
+            x:              _label ? _label.x - (width / 2) : 0
+            y:              _label ? _label.y + (adsbTrafficLayer.size / 2) : 0
             map:            _root
+            text:           _label ? QGroundControl.unitsConversion.metersToAppSettingsHorizontalDistanceUnits(_label.altitude).toFixed(0) + " " + QGroundControl.unitsConversion.appSettingsHorizontalDistanceUnitsString : ""
+            font.pointSize: ScreenTools.defaultFontPointSize
             z:              QGroundControl.zOrderVehicles
+
+            property var _label: adsbTrafficLayer.labels[index]
         }
     }
 
@@ -341,14 +345,17 @@ FlightMap {
         }
     }
 
-    // Camera trigger points
-    MapItemView {
-        model: _activeVehicle ? _activeVehicle.cameraTriggerPoints : 0
-
-        delegate: CameraTriggerIndicator {
-            coordinate:     object.coordinate
-            z:              QGroundControl.zOrderTopMost
-        }
+    // Camera trigger points, all drawn by a single item
+    CameraTriggerMapItem {
+        anchors.fill:           parent
+        cameraTriggerPoints:    _activeVehicle ? _activeVehicle.cameraTriggerPoints : null
+        center:                 _root.center
+        zoomLevel:              _root.zoomLevel
+        bearing:                _root.bearing
+        radius:                 ScreenTools.defaultFontPixelHeight * 0.6
+        color:                  Qt.rgba(0, 0, 0, 0.4)
+        centerColor:            "white"
+        z:                      QGroundControl.zOrderTopMost
     }
 
     // GoTo Location visuals
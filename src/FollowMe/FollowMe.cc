@@ -18,13 +18,22 @@
 #include "PositionManager.h"
 #include "SettingsManager.h"
 #include "AppSettings.h"
+#include "QGCGeo.h"
 
 QGC_LOGGING_CATEGORY(FollowMeLog, "FollowMeLog")
 
+// Filter gains for position, velocity and acceleration. Tuned for 1-10Hz GCS fixes from a moving ground vehicle.
+static const double kAlpha              = 0.6;
+static const double kBeta               = 0.3;
+static const double kGamma              = 0.05;
+static const double kVelocityGain       = 0.5;      ///< How much a reported ground speed pulls the velocity estimate
+static const double kMaxFixGapSecs      = 2.0;      ///< Longer than this between fixes starts the filter over
+static const double kMaxOriginMeters    = 5000.0;   ///< Move the filter origin before the flat earth error shows
+
 FollowMe::FollowMe(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
 {
-    _gcsMotionReportTimer.setSingleShot(false);
+    _gcsMotionReportTimer.setSingleShot(true);
 }
 
 void FollowMe::setToolbox(QGCToolbox* toolbox)
@@ -33,6 +42,7 @@ void FollowMe::setToolbox(QGCToolbox* toolbox)
 
     connect(&_gcsMotionReportTimer,                                     &QTimer::timeout,       this, &FollowMe::_sendGCSMotionReport);
     connect(toolbox->settingsManager()->appSettings()->followTarget(),  &Fact::rawValueChanged, this, &FollowMe::_settingsChanged);
+    // Reports are driven by the position updates themselves, the timer only holds back one which is over the max rate
 
     _settingsChanged();
 }
@@ -62,28 +72,125 @@ void FollowMe::_settingsChanged()
 
 void FollowMe::_enableFollowSend()
 {
-    if (!_gcsMotionReportTimer.isActive()) {
-        _gcsMotionReportTimer.setInterval(qMin(_toolbox->qgcPositionManager()->updateInterval(), 250));
-        _gcsMotionReportTimer.start();
+    if (!_followSendEnabled) {
+        _followSendEnabled  = true;
+        _estimateFixCount   = 0;
+        _lastReportTime.invalidate();
+        connect(_toolbox->qgcPositionManager(), &QGCPositionManager::positionInfoUpdated, this, &FollowMe::_positionInfoUpdated);
     }
 }
 
 void FollowMe::_disableFollowSend()
 {
-    if (_gcsMotionReportTimer.isActive()) {
+    if (_followSendEnabled) {
+        _followSendEnabled = false;
+        disconnect(_toolbox->qgcPositionManager(), &QGCPositionManager::positionInfoUpdated, this, &FollowMe::_positionInfoUpdated);
         _gcsMotionReportTimer.stop();
     }
 }
 
-void FollowMe::_sendGCSMotionReport()
+int FollowMe::_minReportIntervalMSecs(void)
 {
-    QGeoPositionInfo    geoPositionInfo =   _toolbox->qgcPositionManager()->geoPositionInfo();
-    QGeoCoordinate      gcsCoordinate =     geoPositionInfo.coordinate();
+    double maxRateHz = _toolbox->settingsManager()->appSettings()->followTargetMaxRate()->rawValue().toDouble();
+    return maxRateHz > 0 ? qRound(1000.0 / maxRateHz) : 0;
+}
 
+void FollowMe::_positionInfoUpdated(QGeoPositionInfo geoPositionInfo)
+{
     if (!geoPositionInfo.isValid()) {
         return;
     }
 
+    _updateMotionEstimate(geoPositionInfo);
+
+    // Send each fix as it comes in. One which comes in too soon after the last report is held back until the max rate
+    // allows it, by then it may have been replaced by a newer fix.
+    const int minIntervalMSecs = _minReportIntervalMSecs();
+    if (_lastReportTime.isValid() && _lastReportTime.elapsed() < minIntervalMSecs) {
+        if (!_gcsMotionReportTimer.isActive()) {
+            _gcsMotionReportTimer.start(static_cast<int>(minIntervalMSecs - _lastReportTime.elapsed()));
+        }
+        return;
+    }
+    _gcsMotionReportTimer.stop();
+    _sendGCSMotionReport();
+}
+
+void FollowMe::_updateMotionEstimate(const QGeoPositionInfo& geoPositionInfo)
+{
+    QGeoCoordinate  coord   = geoPositionInfo.coordinate();
+    const double    dt      = _lastFixTime.isValid() ? _lastFixTime.elapsed() / 1000.0 : 0;
+    _lastFixTime.start();
+    _lastPositionInfo = geoPositionInfo;
+
+    // Velocity straight from the fix, if it has one
+    bool    haveMeasuredVel = false;
+    double  measuredVel[3]  = {};
+    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::Direction) && geoPositionInfo.hasAttribute(QGeoPositionInfo::GroundSpeed)) {
+        const double direction  = _degreesToRadian(geoPositionInfo.attribute(QGeoPositionInfo::Direction));
+        const double speed      = geoPositionInfo.attribute(QGeoPositionInfo::GroundSpeed);
+        measuredVel[0]  = cos(direction) * speed;
+        measuredVel[1]  = sin(direction) * speed;
+        haveMeasuredVel = true;
+    }
+    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::VerticalSpeed)) {
+        // Positive up, NED is positive down
+        measuredVel[2] = -geoPositionInfo.attribute(QGeoPositionInfo::VerticalSpeed);
+    }
+
+    if (qIsNaN(coord.altitude())) {
+        // 2D fix, hold the altitude we have
+        coord.setAltitude(_estimateFixCount > 0 ? _estimateOrigin.altitude() - _estimatePos[2] : 0);
+    }
+
+    if (_estimateFixCount == 0 || dt <= 0 || dt > kMaxFixGapSecs) {
+        // Start over from this fix
+        _estimateOrigin = coord;
+        for (int i=0; i<3; i++) {
+            _estimatePos[i] = 0;
+            _estimateVel[i] = haveMeasuredVel ? measuredVel[i] : 0;
+            _estimateAcc[i] = 0;
+        }
+        _estimateFixCount = 1;
+        return;
+    }
+
+    double measuredPos[3];
+    convertGeoToNed(coord, _estimateOrigin, &measuredPos[0], &measuredPos[1], &measuredPos[2]);
+
+    for (int i=0; i<3; i++) {
+        // Predict
+        _estimatePos[i] += (_estimateVel[i] * dt) + (0.5 * _estimateAcc[i] * dt * dt);
+        _estimateVel[i] += _estimateAcc[i] * dt;
+
+        // Correct
+        const double residual = measuredPos[i] - _estimatePos[i];
+        _estimatePos[i] += kAlpha * residual;
+        _estimateVel[i] += (kBeta / dt) * residual;
+        _estimateAcc[i] += (2.0 * kGamma / (dt * dt)) * residual;
+        if (haveMeasuredVel && (i < 2 || geoPositionInfo.hasAttribute(QGeoPositionInfo::VerticalSpeed))) {
+            _estimateVel[i] += kVelocityGain * (measuredVel[i] - _estimateVel[i]);
+        }
+    }
+    _estimateFixCount++;
+
+    if (qAbs(_estimatePos[0]) > kMaxOriginMeters || qAbs(_estimatePos[1]) > kMaxOriginMeters) {
+        // Re-center on this fix, the rest of the state is relative so it carries over
+        for (int i=0; i<3; i++) {
+            _estimatePos[i] -= measuredPos[i];
+        }
+        _estimateOrigin = coord;
+    }
+}
+
+void FollowMe::_sendGCSMotionReport()
+{
+    QGeoPositionInfo    geoPositionInfo =   _lastPositionInfo;
+
+    if (!geoPositionInfo.isValid() || _estimateFixCount == 0) {
+        return;
+    }
+
     // First check to see if any vehicles need follow me updates
     bool needFollowMe = false;
     if (_currentMode == MODE_ALWAYS) {
@@ -104,7 +211,14 @@ void FollowMe::_sendGCSMotionReport()
     GCSMotionReport motionReport = {};
     uint8_t         estimatation_capabilities = 0;
 
-    // get the current location coordinates
+    // Filtered position, carried forward to now so the vehicle doesn't see the age of the fix
+    const double    dt = _lastFixTime.elapsed() / 1000.0;
+    double          pos[3];
+    for (int i=0; i<3; i++) {
+        pos[i] = _estimatePos[i] + (_estimateVel[i] * dt) + (0.5 * _estimateAcc[i] * dt * dt);
+    }
+    QGeoCoordinate gcsCoordinate;
+    convertNedToGeo(pos[0], pos[1], pos[2], _estimateOrigin, &gcsCoordinate);
 
     motionReport.lat_int =          static_cast<int>(gcsCoordinate.latitude()  * 1e7);
     motionReport.lon_int =          static_cast<int>(gcsCoordinate.longitude() * 1e7);
@@ -126,25 +240,20 @@ void FollowMe::_sendGCSMotionReport()
         motionReport.pos_std_dev[2] = geoPositionInfo.attribute(QGeoPositionInfo::VerticalAccuracy);
     }
 
-    // calculate z velocity if it's available
-
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::VerticalSpeed)) {
-        motionReport.vzMetersPerSec = geoPositionInfo.attribute(QGeoPositionInfo::VerticalSpeed);
-    }
-
-    // calculate x,y velocity if it's available
+    // Velocity needs two fixes or a fix with a ground speed, acceleration needs three fixes
 
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::Direction) && geoPositionInfo.hasAttribute(QGeoPositionInfo::GroundSpeed) == true) {
+    bool haveVelocity = _estimateFixCount > 1 || (geoPositionInfo.hasAttribute(QGeoPositionInfo::Direction) && geoPositionInfo.hasAttribute(QGeoPositionInfo::GroundSpeed));
+    if (haveVelocity) {
         estimatation_capabilities |= (1 << VEL);
-
-        qreal direction = _degreesToRadian(geoPositionInfo.attribute(QGeoPositionInfo::Direction));
-        qreal velocity  = geoPositionInfo.attribute(QGeoPositionInfo::GroundSpeed);
-
-        motionReport.vxMetersPerSec = cos(direction)*velocity;
-        motionReport.vyMetersPerSec = sin(direction)*velocity;
-    } else {
-        motionReport.vxMetersPerSec = 0;
-        motionReport.vyMetersPerSec = 0;
+        motionReport.vxMetersPerSec = _estimateVel[0] + (_estimateAcc[0] * dt);
+        motionReport.vyMetersPerSec = _estimateVel[1] + (_estimateAcc[1] * dt);
+        motionReport.vzMetersPerSec = _estimateVel[2] + (_estimateAcc[2] * dt);
+    }
+    if (_estimateFixCount > 2) {
+        estimatation_capabilities |= (1 << ACCEL);
+        motionReport.axMetersPerSec2 = _estimateAcc[0];
+        motionReport.ayMetersPerSec2 = _estimateAcc[1];
+        motionReport.azMetersPerSec2 = _estimateAcc[2];
     }
 
     QmlObjectListModel* vehicles = _toolbox->multiVehicleManager()->vehicles();
@@ -156,6 +265,7 @@ void FollowMe::_sendGCSMotionReport()
             vehicle->firmwarePlugin()->sendGCSMotionReport(vehicle, motionReport, estimatation_capabilities);
         }
     }
+    _lastReportTime.start();
 }
 
 double FollowMe::_degreesToRadian(double deg)
@@ -15,6 +15,7 @@
 #include <QThread>
 #include <QGeoPositionInfo>
 #include <QGeoPositionInfoSource>
+#include <QGeoCoordinate>
 #include <QElapsedTimer>
 
 #include "QGCToolbox.h"
@@ -39,6 +40,9 @@ public:
         double  vxMetersPerSec;     //	X velocity in NED frame in meter / s
         double  vyMetersPerSec;     //	Y velocity in NED frame in meter / s
         double  vzMetersPerSec;     //	Z velocity in NED frame in meter / s
+        double  axMetersPerSec2;    // X acceleration in NED frame in meter / s^2
+        double  ayMetersPerSec2;    // Y acceleration in NED frame in meter / s^2
+        double  azMetersPerSec2;    // Z acceleration in NED frame in meter / s^2
         double  pos_std_dev[3];     // -1 for unknown
     };
 
@@ -55,6 +59,7 @@ public:
 
 private slots:
     void _sendGCSMotionReport       (void);
+    void _positionInfoUpdated       (QGeoPositionInfo geoPositionInfo);
     void _settingsChanged           (void);
     void _vehicleAdded              (Vehicle* vehicle);
     void _vehicleRemoved            (Vehicle* vehicle);
@@ -67,11 +72,24 @@ private:
         MODE_FOLLOWME
     };
 
-    void    _disableFollowSend  (void);
-    void    _enableFollowSend   (void);
-    double  _degreesToRadian    (double deg);
-    bool    _isFollowFlightMode (Vehicle* vehicle, const QString& flightMode);
+    void    _disableFollowSend      (void);
+    void    _enableFollowSend       (void);
+    double  _degreesToRadian        (double deg);
+    bool    _isFollowFlightMode     (Vehicle* vehicle, const QString& flightMode);
+    void    _updateMotionEstimate   (const QGeoPositionInfo& geoPositionInfo);
+    int     _minReportIntervalMSecs (void);
 
-    QTimer      _gcsMotionReportTimer;
-    uint32_t    _currentMode;
+    QTimer          _gcsMotionReportTimer;      ///< Holds back a report which came in faster than the max rate
+    QElapsedTimer   _lastReportTime;
+    bool            _followSendEnabled  = false;
+    uint32_t        _currentMode;
+
+    // Alpha-beta-gamma filter over the GCS fixes, NED meters relative to _estimateOrigin
+    QGeoPositionInfo    _lastPositionInfo;
+    QGeoCoordinate      _estimateOrigin;
+    QElapsedTimer       _lastFixTime;
+    int                 _estimateFixCount   = 0;    ///< Fixes since the filter was reset
+    double              _estimatePos[3]     = {};
+    double              _estimateVel[3]     = {};
+    double              _estimateAcc[3]     = {};
 };
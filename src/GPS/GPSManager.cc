@@ -19,6 +19,7 @@ GPSManager::GPSManager(QGCApplication* app, QGCToolbox* toolbox)
 {
     qRegisterMetaType<GPSPositionMessage>();
     qRegisterMetaType<GPSSatelliteMessage>();
+    qRegisterMetaType<GPSSurveyInStatusMessage>();
 }
 
 GPSManager::~GPSManager()
@@ -60,7 +61,8 @@ void GPSManager::connectGPS(const QString& device, const QString& gps_type)
     //create RTCM device
     _rtcmMavlink = new RTCMMavlink(*_toolbox);
 
-    connect(_gpsProvider, &GPSProvider::RTCMDataUpdate, _rtcmMavlink, &RTCMMavlink::RTCMDataUpdate);
+    // Corrections go straight from the GPS thread to the links
+    connect(_gpsProvider, &GPSProvider::RTCMDataUpdate, _rtcmMavlink, &RTCMMavlink::RTCMDataUpdate, Qt::DirectConnection);
 
     //test: connect to position update
     connect(_gpsProvider, &GPSProvider::positionUpdate,         this, &GPSManager::GPSPositionUpdate);
@@ -74,6 +76,9 @@ void GPSManager::connectGPS(const QString& device, const QString& gps_type)
 void GPSManager::disconnectGPS(void)
 {
     if (_gpsProvider) {
+        if (_rtcmMavlink) {
+            disconnect(_gpsProvider, &GPSProvider::RTCMDataUpdate, _rtcmMavlink, &RTCMMavlink::RTCMDataUpdate);
+        }
         _requestGpsStop = true;
         //Note that we need a relatively high timeout to be sure the GPS thread finished.
         if (!_gpsProvider->wait(2000)) {
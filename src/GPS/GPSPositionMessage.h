@@ -31,3 +31,20 @@ struct GPSSatelliteMessage
     satellite_info_s satellite_data;
 };
 Q_DECLARE_METATYPE(GPSSatelliteMessage);
+
+
+/**
+ ** struct GPSSurveyInStatusMessage
+ * complete survey-in status, sent as a single value so it is applied in one go
+ */
+struct GPSSurveyInStatusMessage
+{
+    float   duration    = 0;    ///< [s]
+    float   accuracyMM  = 0;    ///< mean accuracy [mm]
+    double  latitude    = 0;
+    double  longitude   = 0;
+    float   altitude    = 0;
+    bool    valid       = false;
+    bool    active      = false;
+};
+Q_DECLARE_METATYPE(GPSSurveyInStatusMessage);
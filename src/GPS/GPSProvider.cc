@@ -16,6 +16,7 @@
 #define GPS_RECEIVE_TIMEOUT 1200
 
 #include <QDebug>
+#include <QElapsedTimer>
 
 #include "Drivers/src/ubx.h"
 #include "Drivers/src/sbf.h"
@@ -180,7 +181,9 @@ void GPSProvider::publishGPSSatellite()
 void GPSProvider::gotRTCMData(uint8_t* data, size_t len)
 {
     QByteArray message((char*)data, static_cast<int>(len));
-    emit RTCMDataUpdate(message);
+    QElapsedTimer received;
+    received.start();
+    emit RTCMDataUpdate(message, received.msecsSinceReference());
 }
 
 int GPSProvider::callbackEntry(GPSCallbackType type, void *data1, int data2, void *user)
@@ -189,17 +192,47 @@ int GPSProvider::callbackEntry(GPSCallbackType type, void *data1, int data2, voi
     return gps->callback(type, data1, data2);
 }
 
-int GPSProvider::callback(GPSCallbackType type, void *data1, int data2)
+/// Hands buffered serial data to the driver. The serial port is read in large blocks, and after the first bytes of a
+/// burst come in the read waits briefly for more so the driver is not woken for every few bytes.
+///     @return Number of bytes copied to data, 0 on timeout, -1 on error
+int GPSProvider::_readDeviceData(uint8_t* data, int maxLength, int timeoutMSecs)
 {
-    switch (type) {
-        case GPSCallbackType::readDeviceData: {
-            if (_serial->bytesAvailable() == 0) {
-                int timeout = *((int *) data1);
-                if (!_serial->waitForReadyRead(timeout))
-                    return 0; //timeout
+    if (_readBufferOffset >= _readBuffer.size()) {
+        if (_serial->bytesAvailable() == 0 && !_serial->waitForReadyRead(timeoutMSecs)) {
+            return 0; //timeout
+        }
+
+        QElapsedTimer coalesceTimer;
+        coalesceTimer.start();
+        while (_serial->bytesAvailable() < maxLength && coalesceTimer.elapsed() < _readCoalesceMSecs) {
+            if (!_serial->waitForReadyRead(_readCoalesceMSecs - static_cast<int>(coalesceTimer.elapsed()))) {
+                break;
             }
-            return (int)_serial->read((char*) data1, data2);
         }
+
+        qint64 available = _serial->bytesAvailable();
+        _readBuffer.resize(static_cast<int>(available));
+        qint64 count = _serial->read(_readBuffer.data(), available);
+        if (count < 0) {
+            _readBuffer.clear();
+            _readBufferOffset = 0;
+            return -1;
+        }
+        _readBuffer.resize(static_cast<int>(count));
+        _readBufferOffset = 0;
+    }
+
+    int count = qMin(maxLength, _readBuffer.size() - _readBufferOffset);
+    memcpy(data, _readBuffer.constData() + _readBufferOffset, static_cast<size_t>(count));
+    _readBufferOffset += count;
+    return count;
+}
+
+int GPSProvider::callback(GPSCallbackType type, void *data1, int data2)
+{
+    switch (type) {
+        case GPSCallbackType::readDeviceData:
+            return _readDeviceData((uint8_t*) data1, data2, *((int *) data1));
         case GPSCallbackType::writeDeviceData:
             if (_serial->write((char*) data1, data2) >= 0) {
                 if (_serial->waitForBytesWritten(-1))
@@ -208,6 +241,9 @@ int GPSProvider::callback(GPSCallbackType type, void *data1, int data2)
             return -1;
 
         case GPSCallbackType::setBaudrate:
+            // Anything buffered was received at the old baud rate
+            _readBuffer.clear();
+            _readBufferOffset = 0;
             return _serial->setBaudRate(data2) ? 0 : -1;
 
         case GPSCallbackType::gotRTCMMessage:
@@ -217,10 +253,24 @@ int GPSProvider::callback(GPSCallbackType type, void *data1, int data2)
         case GPSCallbackType::surveyInStatus:
         {
             SurveyInStatus* status = (SurveyInStatus*)data1;
-            qCDebug(RTKGPSLog) << "Position: " << status->latitude << status->longitude << status->altitude;
 
-            qCDebug(RTKGPSLog) << QString("Survey-in status: %1s cur accuracy: %2mm valid: %3 active: %4").arg(status->duration).arg(status->mean_accuracy).arg((int)(status->flags & 1)).arg((int)((status->flags>>1) & 1));
-            emit surveyInStatus(status->duration, status->mean_accuracy, status->latitude, status->longitude, status->altitude, (int)(status->flags & 1), (int)((status->flags>>1) & 1));
+            // Valid/active changes go out right away, progress updates at most once per interval
+            if (static_cast<int>(status->flags) != _lastSurveyInFlags || !_surveyInStatusTimer.isValid() || _surveyInStatusTimer.elapsed() >= _surveyInStatusIntervalMSecs) {
+                _lastSurveyInFlags = static_cast<int>(status->flags);
+                _surveyInStatusTimer.start();
+
+                qCDebug(RTKGPSLog) << "Position: " << status->latitude << status->longitude << status->altitude;
+                qCDebug(RTKGPSLog) << QString("Survey-in status: %1s cur accuracy: %2mm valid: %3 active: %4").arg(status->duration).arg(status->mean_accuracy).arg((int)(status->flags & 1)).arg((int)((status->flags>>1) & 1));
+                GPSSurveyInStatusMessage message;
+                message.duration    = status->duration;
+                message.accuracyMM  = status->mean_accuracy;
+                message.latitude    = status->latitude;
+                message.longitude   = status->longitude;
+                message.altitude    = status->altitude;
+                message.valid       = status->flags & 1;
+                message.active      = (status->flags >> 1) & 1;
+                emit surveyInStatus(message);
+            }
         }
             break;
 
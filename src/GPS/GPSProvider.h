@@ -14,6 +14,7 @@
 #include <QThread>
 #include <QByteArray>
 #include <QSerialPort>
+#include <QElapsedTimer>
 
 #include <atomic>
 
@@ -57,8 +58,8 @@ public:
 signals:
     void positionUpdate(GPSPositionMessage message);
     void satelliteInfoUpdate(GPSSatelliteMessage message);
-    void RTCMDataUpdate(QByteArray message);
-    void surveyInStatus(float duration, float accuracyMM, double latitude, double longitude, float altitude, bool valid, bool active);
+    void RTCMDataUpdate(QByteArray message, qint64 receivedMSecs);   ///< receivedMSecs: QElapsedTimer::msecsSinceReference when the message came in
+    void surveyInStatus(GPSSurveyInStatusMessage status);
 
 protected:
     void run();
@@ -74,6 +75,8 @@ private:
 
 	int callback(GPSCallbackType type, void *data1, int data2);
 
+    int _readDeviceData(uint8_t* data, int maxLength, int timeoutMSecs);
+
     QString _device;
     GPSType _type;
     const std::atomic_bool& _requestStop;
@@ -89,4 +92,12 @@ private:
 	struct satellite_info_s    *_pReportSatInfo = nullptr;
 
 	QSerialPort *_serial = nullptr;
+
+    QByteArray      _readBuffer;                        ///< Serial data not yet handed to the driver
+    int             _readBufferOffset       = 0;
+    QElapsedTimer   _surveyInStatusTimer;
+    int             _lastSurveyInFlags      = -1;
+
+    static const int _readCoalesceMSecs             = 2;    ///< Time to let a burst build up in the serial buffer before waking the driver
+    static const int _surveyInStatusIntervalMSecs   = 1000;
 };
@@ -13,25 +13,152 @@
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 
-#include <cstdio>
+QGC_LOGGING_CATEGORY(RTCMMavlinkLog, "RTCMMavlinkLog")
 
 RTCMMavlink::RTCMMavlink(QGCToolbox& toolbox)
     : _toolbox(toolbox)
 {
     _bandwidthTimer.start();
+
+    MultiVehicleManager* multiVehicleManager = _toolbox.multiVehicleManager();
+    connect(multiVehicleManager, &MultiVehicleManager::vehicleAdded,     this, &RTCMMavlink::_vehicleAdded);
+    connect(multiVehicleManager, &MultiVehicleManager::vehicleRemoved,   this, &RTCMMavlink::_vehicleRemoved);
+    QmlObjectListModel& vehicles = *multiVehicleManager->vehicles();
+    for (int i = 0; i < vehicles.count(); i++) {
+        _vehicleAdded(qobject_cast<Vehicle*>(vehicles[i]));
+    }
+}
+
+void RTCMMavlink::_vehicleAdded(Vehicle* vehicle)
+{
+    connect(vehicle->vehicleLinkManager(), &VehicleLinkManager::primaryLinkChanged, this, &RTCMMavlink::_updateVehicleLinks);
+    _updateVehicleLinks();
+}
+
+void RTCMMavlink::_vehicleRemoved(Vehicle* vehicle)
+{
+    disconnect(vehicle->vehicleLinkManager(), &VehicleLinkManager::primaryLinkChanged, this, &RTCMMavlink::_updateVehicleLinks);
+    _removedVehicle = vehicle;
+    _updateVehicleLinks();
+    _removedVehicle = nullptr;
+}
+
+/// Rebuilds the vehicle link snapshot used by the GPS thread. Runs on the GUI thread.
+void RTCMMavlink::_updateVehicleLinks(void)
+{
+    QList<VehicleLink_t>    vehicleLinks;
+    QmlObjectListModel&     vehicles        = *_toolbox.multiVehicleManager()->vehicles();
+
+    for (int i = 0; i < vehicles.count(); i++) {
+        Vehicle* vehicle = qobject_cast<Vehicle*>(vehicles[i]);
+        if (vehicle != _removedVehicle) {
+            vehicleLinks.append({ vehicle->id(), vehicle->vehicleLinkManager()->primaryLink() });
+        }
+    }
+
+    QMutexLocker lock(&_vehicleLinksMutex);
+    _vehicleLinks = vehicleLinks;
 }
 
-void RTCMMavlink::RTCMDataUpdate(QByteArray message)
+int RTCMMavlink::messageNumber(const QByteArray& message)
+{
+    // RTCM3 frame: 0xD3 preamble, 6 reserved bits and a 10 bit length, then the payload which starts with the 12 bit message number
+    if (message.size() < 5 || static_cast<uint8_t>(message[0]) != 0xD3) {
+        return 0;
+    }
+    return (static_cast<uint8_t>(message[3]) << 4) | (static_cast<uint8_t>(message[4]) >> 4);
+}
+
+bool RTCMMavlink::isEphemeris(int messageNumber)
+{
+    switch (messageNumber) {
+    case 1019:  // GPS
+    case 1020:  // GLONASS
+    case 1042:  // BeiDou
+    case 1044:  // QZSS
+    case 1045:  // Galileo F/NAV
+    case 1046:  // Galileo I/NAV
+        return true;
+    default:
+        return false;
+    }
+}
+
+qint64 RTCMMavlink::_nowMSecs(void)
+{
+    QElapsedTimer now;
+    now.start();
+    return now.msecsSinceReference();
+}
+
+void RTCMMavlink::RTCMDataUpdate(QByteArray message, qint64 receivedMSecs)
 {
-    /* statistics */
     _bandwidthByteCounter += message.size();
-    qint64 elapsed = _bandwidthTimer.elapsed();
-    if (elapsed > 1000) {
-        printf("RTCM bandwidth: %.2f kB/s\n", (float) _bandwidthByteCounter / elapsed * 1000.f / 1024.f);
-        _bandwidthTimer.restart();
-        _bandwidthByteCounter = 0;
+
+    QList<VehicleLink_t> vehicleLinks;
+    {
+        QMutexLocker lock(&_vehicleLinksMutex);
+        vehicleLinks = _vehicleLinks;
     }
 
+    // Find the links in use, a link with several vehicles on it only gets the message once
+    QList<LinkInterface*> links;
+    for (const VehicleLink_t& vehicleLink: vehicleLinks) {
+        SharedLinkInterfacePtr sharedLink = vehicleLink.link.lock();
+
+        if (sharedLink && sharedLink->isConnected()) {
+            LinkState_t& linkState = _linkStates[sharedLink.get()];
+            if (linkState.link.lock() != sharedLink) {
+                // New link, or a new one which was allocated where a removed one used to be
+                linkState = LinkState_t();
+                linkState.link = sharedLink;
+            }
+            if (!links.contains(sharedLink.get())) {
+                links.append(sharedLink.get());
+            }
+        }
+    }
+
+    const bool                          ephemeris = isEphemeris(messageNumber(message));
+    QVector<mavlink_gps_rtcm_data_t>    fragments;
+
+    for (LinkInterface* link: links) {
+        LinkState_t& linkState = _linkStates[link];
+
+        if (ephemeris && (_linkBackedUp(link) || !linkState.deferred.isEmpty())) {
+            linkState.deferred.append({ message, receivedMSecs });
+            _deferredCount++;
+            if (linkState.deferred.count() > _maxDeferredMessages) {
+                linkState.deferred.removeFirst();
+                _droppedCount++;
+            }
+        } else {
+            if (fragments.isEmpty()) {
+                _fragment(message, fragments);
+            }
+            _sendOnLink(link, vehicleLinks, fragments, receivedMSecs);
+        }
+        _flushDeferred(linkState, vehicleLinks);
+    }
+
+    // Forget the links which went away
+    for (auto iter = _linkStates.begin(); iter != _linkStates.end(); ) {
+        if (iter.value().link.expired()) {
+            _droppedCount += iter.value().deferred.count();
+            iter = _linkStates.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    if (_bandwidthTimer.elapsed() > 1000) {
+        _logStatistics();
+    }
+}
+
+/// Splits the message into GPS_RTCM_DATA payloads, which are shared by all the links it is sent on
+void RTCMMavlink::_fragment(const QByteArray& message, QVector<mavlink_gps_rtcm_data_t>& fragments)
+{
     const int maxMessageLength = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
     mavlink_gps_rtcm_data_t mavlinkRtcmData;
     memset(&mavlinkRtcmData, 0, sizeof(mavlink_gps_rtcm_data_t));
@@ -40,7 +167,7 @@ void RTCMMavlink::RTCMDataUpdate(QByteArray message)
         mavlinkRtcmData.len = message.size();
         mavlinkRtcmData.flags = (_sequenceId & 0x1F) << 3;
         memcpy(&mavlinkRtcmData.data, message.data(), message.size());
-        sendMessageToVehicle(mavlinkRtcmData);
+        fragments.append(mavlinkRtcmData);
     } else {
         // We need to fragment
 
@@ -53,31 +180,80 @@ void RTCMMavlink::RTCMDataUpdate(QByteArray message)
             mavlinkRtcmData.flags |= (_sequenceId & 0x1F) << 3;     // Next 5 bits are sequence id
             mavlinkRtcmData.len = length;
             memcpy(&mavlinkRtcmData.data, message.data() + start, length);
-            sendMessageToVehicle(mavlinkRtcmData);
+            fragments.append(mavlinkRtcmData);
             start += length;
         }
     }
     ++_sequenceId;
 }
 
-void RTCMMavlink::sendMessageToVehicle(const mavlink_gps_rtcm_data_t& msg)
+/// Encodes the fragments for the link and queues them as a single write
+void RTCMMavlink::_sendOnLink(LinkInterface* link, const QList<VehicleLink_t>& vehicleLinks, const QVector<mavlink_gps_rtcm_data_t>& fragments, qint64 receivedMSecs)
 {
-    QmlObjectListModel& vehicles = *_toolbox.multiVehicleManager()->vehicles();
-    MAVLinkProtocol* mavlinkProtocol = _toolbox.mavlinkProtocol();
-    for (int i = 0; i < vehicles.count(); i++) {
-        Vehicle*                vehicle     = qobject_cast<Vehicle*>(vehicles[i]);
-        WeakLinkInterfacePtr    weakLink    = vehicle->vehicleLinkManager()->primaryLink();
-
-        if (!weakLink.expired()) {
-            mavlink_message_t       message;
-            SharedLinkInterfacePtr  sharedLink = weakLink.lock();
-
-            mavlink_msg_gps_rtcm_data_encode_chan(mavlinkProtocol->getSystemId(),
-                                                  mavlinkProtocol->getComponentId(),
-                                                  sharedLink->mavlinkChannel(),
-                                                  &message,
-                                                  &msg);
-            vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+    MAVLinkProtocol*    mavlinkProtocol = _toolbox.mavlinkProtocol();
+    uint8_t             buffer[MAVLINK_MAX_PACKET_LEN];
+    QByteArray          bytes;
+
+    // The sequence number and checksum are specific to the channel, so each link needs its own encoding
+    bytes.reserve(fragments.count() * MAVLINK_MAX_PACKET_LEN);
+    for (const mavlink_gps_rtcm_data_t& fragment: fragments) {
+        mavlink_message_t message;
+
+        mavlink_msg_gps_rtcm_data_encode_chan(static_cast<uint8_t>(mavlinkProtocol->getSystemId()),
+                                              static_cast<uint8_t>(mavlinkProtocol->getComponentId()),
+                                              link->mavlinkChannel(),
+                                              &message,
+                                              &fragment);
+        int len = mavlink_msg_to_send_buffer(buffer, &message);
+        bytes.append(reinterpret_cast<const char*>(buffer), len);
+    }
+    link->writeBytesThreadSafe(bytes.constData(), bytes.size());
+
+    const uint64_t latencyUSecs = static_cast<uint64_t>(qMax(static_cast<qint64>(0), _nowMSecs() - receivedMSecs)) * 1000;
+    for (const VehicleLink_t& vehicleLink: vehicleLinks) {
+        if (vehicleLink.link.lock().get() == link) {
+            _vehicleLatency[vehicleLink.vehicleId].add(latencyUSecs);
         }
     }
 }
+
+/// Sends the held back ephemerides for as long as the link keeps up
+void RTCMMavlink::_flushDeferred(LinkState_t& linkState, const QList<VehicleLink_t>& vehicleLinks)
+{
+    SharedLinkInterfacePtr sharedLink = linkState.link.lock();
+    if (!sharedLink) {
+        return;
+    }
+
+    while (!linkState.deferred.isEmpty() && !_linkBackedUp(sharedLink.get())) {
+        PendingMessage_t                    pending = linkState.deferred.takeFirst();
+        QVector<mavlink_gps_rtcm_data_t>    fragments;
+
+        _fragment(pending.message, fragments);
+        _sendOnLink(sharedLink.get(), vehicleLinks, fragments, pending.receivedMSecs);
+    }
+}
+
+void RTCMMavlink::_logStatistics(void)
+{
+    qint64 elapsed = _bandwidthTimer.elapsed();
+
+    qCDebug(RTCMMavlinkLog) << QStringLiteral("RTCM bandwidth: %1 kB/s ephemerides deferred: %2 dropped: %3")
+                               .arg(static_cast<double>(_bandwidthByteCounter) / elapsed * 1000.0 / 1024.0, 0, 'f', 2)
+                               .arg(_deferredCount)
+                               .arg(_droppedCount);
+    for (auto iter = _vehicleLatency.constBegin(); iter != _vehicleLatency.constEnd(); ++iter) {
+        const LatencyHistogram& latency = iter.value();
+        qCDebug(RTCMMavlinkLog) << QStringLiteral("RTCM injection vehicle %1: messages: %2 latency median: %3 ms max: %4 ms")
+                                   .arg(iter.key())
+                                   .arg(latency.count())
+                                   .arg(latency.percentileUSecs(50) / 1000.0, 0, 'f', 1)
+                                   .arg(latency.maxUSecs() / 1000.0, 0, 'f', 1);
+    }
+
+    _bandwidthTimer.restart();
+    _bandwidthByteCounter   = 0;
+    _deferredCount          = 0;
+    _droppedCount           = 0;
+    _vehicleLatency.clear();
+}
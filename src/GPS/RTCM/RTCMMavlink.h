@@ -12,13 +12,30 @@
 
 #include <QObject>
 #include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QVector>
 
 #include "QGCToolbox.h"
+#include "QGCLoggingCategory.h"
 #include "MAVLinkProtocol.h"
+#include "LatencyHistogram.h"
+
+Q_DECLARE_LOGGING_CATEGORY(RTCMMavlinkLog)
+
+class Vehicle;
 
 /**
  ** class RTCMMavlink
  * Receives RTCM updates and sends them via MAVLINK to the device
+ *
+ * GPS_RTCM_DATA is a broadcast, so each RTCM message is fragmented once and sent once per link no matter how many
+ * vehicles are on it. When the bulk send queue of a link is backed up, ephemerides are held back for that link so the
+ * MSM observations, which go stale quickly, get through first. Statistics go to RTCMMavlinkLog.
+ *
+ * RTCMDataUpdate is called directly on the GPS thread. It works from a snapshot of the vehicle links which is kept up
+ * to date on the GUI thread, so the corrections never wait on the GUI event loop.
  */
 class RTCMMavlink : public QObject
 {
@@ -27,14 +44,58 @@ public:
     RTCMMavlink(QGCToolbox& toolbox);
     //TODO: API to select device(s)?
 
+    /// @return RTCM3 message number, 0 if the message is not an RTCM3 frame
+    static int  messageNumber   (const QByteArray& message);
+    static bool isEphemeris     (int messageNumber);
+
 public slots:
-    void RTCMDataUpdate(QByteArray message);
+    /// Thread safe, called on the GPS thread
+    ///     @param receivedMSecs QElapsedTimer::msecsSinceReference when the message came in from the GPS
+    void RTCMDataUpdate(QByteArray message, qint64 receivedMSecs);
+
+private slots:
+    void _vehicleAdded      (Vehicle* vehicle);
+    void _vehicleRemoved    (Vehicle* vehicle);
+    void _updateVehicleLinks(void);
 
 private:
-    void sendMessageToVehicle(const mavlink_gps_rtcm_data_t& msg);
+    typedef struct {
+        int                     vehicleId;
+        WeakLinkInterfacePtr    link;
+    } VehicleLink_t;
+
+    typedef struct {
+        QByteArray  message;
+        qint64      receivedMSecs;
+    } PendingMessage_t;
+
+    typedef struct {
+        WeakLinkInterfacePtr        link;
+        QList<PendingMessage_t>     deferred;       ///< Ephemerides held back while the link is backed up, oldest first
+    } LinkState_t;
+
+    void _fragment      (const QByteArray& message, QVector<mavlink_gps_rtcm_data_t>& fragments);
+    void _sendOnLink    (LinkInterface* link, const QList<VehicleLink_t>& vehicleLinks, const QVector<mavlink_gps_rtcm_data_t>& fragments, qint64 receivedMSecs);
+    void _flushDeferred (LinkState_t& linkState, const QList<VehicleLink_t>& vehicleLinks);
+    void _logStatistics (void);
+
+    static bool     _linkBackedUp   (LinkInterface* link) { return link->pendingSendCount() > _backedUpFrameCount; }
+    static qint64   _nowMSecs       (void);
+
+    QGCToolbox&                         _toolbox;
+    Vehicle*                            _removedVehicle         = nullptr;  ///< Still in the vehicle list while vehicleRemoved is signalled
+    QMutex                              _vehicleLinksMutex;
+    QList<VehicleLink_t>                _vehicleLinks;                  ///< Primary link of each vehicle, protected by _vehicleLinksMutex
+
+    // Only used on the GPS thread
+    QElapsedTimer                       _bandwidthTimer;
+    int                                 _bandwidthByteCounter   = 0;
+    uint8_t                             _sequenceId             = 0;
+    QHash<LinkInterface*, LinkState_t>  _linkStates;
+    QHash<int, LatencyHistogram>        _vehicleLatency;                ///< Receipt to link latency by vehicle id, reset with each log
+    int                                 _deferredCount          = 0;    ///< Since the last log
+    int                                 _droppedCount           = 0;
 
-    QGCToolbox& _toolbox;
-    QElapsedTimer _bandwidthTimer;
-    int _bandwidthByteCounter = 0;
-    uint8_t _sequenceId = 0;
+    static const int _backedUpFrameCount    = 32;   ///< More frames than this waiting on a link holds back ephemerides
+    static const int _maxDeferredMessages   = 16;   ///< Per link, the oldest are dropped past this. The base sends them again.
 };
@@ -12,10 +12,12 @@
 
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #include "QGCGeo.h"
 #include "UTMUPS.hpp"
 #include "MGRS.hpp"
+#include "TransverseMercator.hpp"
 
 // These defines are private
 #define M_DEG_TO_RAD (M_PI / 180.0)
@@ -85,6 +87,85 @@ void convertNedToGeo(double x, double y, double z, QGeoCoordinate origin, QGeoCo
     coord->setAltitude(-z + origin.altitude());
 }
 
+void convertGeoToNed(const QGeoCoordinate* coords, int count, const QGeoCoordinate& origin, double* x, double* y, double* z)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    const double ref_lat_rad = origin.latitude() * M_DEG_TO_RAD;
+    const double ref_lon_rad = origin.longitude() * M_DEG_TO_RAD;
+    const double ref_sin_lat = sin(ref_lat_rad);
+    const double ref_cos_lat = cos(ref_lat_rad);
+    const double ref_alt     = origin.altitude();
+
+    // The coordinates are unpacked first so the loop below only works on plain arrays and has no branches, which
+    // leaves the compiler free to vectorize it
+    std::vector<double> lat_rad(static_cast<size_t>(count));
+    std::vector<double> d_lon_rad(static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) {
+        lat_rad[i]   = coords[i].latitude() * M_DEG_TO_RAD;
+        d_lon_rad[i] = (coords[i].longitude() * M_DEG_TO_RAD) - ref_lon_rad;
+    }
+    if (z) {
+        for (int i = 0; i < count; i++) {
+            z[i] = -(coords[i].altitude() - ref_alt);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        const double sin_lat   = sin(lat_rad[i]);
+        const double cos_lat   = cos(lat_rad[i]);
+        const double cos_d_lon = cos(d_lon_rad[i]);
+
+        // Clamped since rounding takes coordinates at the origin slightly out of range, which would make acos a NaN
+        const double cos_c = fmin(1.0, fmax(-1.0, ref_sin_lat * sin_lat + ref_cos_lat * cos_lat * cos_d_lon));
+        const double c     = acos(cos_c);
+        const double k     = (c < epsilon) ? 1.0 : (c / sin(c));
+
+        x[i] = k * (ref_cos_lat * sin_lat - ref_sin_lat * cos_lat * cos_d_lon) * CONSTANTS_RADIUS_OF_EARTH;
+        y[i] = k * cos_lat * sin(d_lon_rad[i]) * CONSTANTS_RADIUS_OF_EARTH;
+    }
+}
+
+void convertNedToGeo(const double* x, const double* y, const double* z, int count, const QGeoCoordinate& origin, QGeoCoordinate* coords)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    const double ref_lat_rad = origin.latitude() * M_DEG_TO_RAD;
+    const double ref_lon_rad = origin.longitude() * M_DEG_TO_RAD;
+    const double ref_sin_lat = sin(ref_lat_rad);
+    const double ref_cos_lat = cos(ref_lat_rad);
+    const double ref_alt     = origin.altitude();
+
+    std::vector<double> lat_rad(static_cast<size_t>(count));
+    std::vector<double> lon_rad(static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) {
+        const double x_rad = x[i] / CONSTANTS_RADIUS_OF_EARTH;
+        const double y_rad = y[i] / CONSTANTS_RADIUS_OF_EARTH;
+        const double c     = sqrt(x_rad * x_rad + y_rad * y_rad);
+        const double sin_c = sin(c);
+        const double cos_c = cos(c);
+
+        // Points at the origin divide by 1 instead of 0 and then take the origin, both sides are evaluated either way
+        const bool   at_origin = c <= epsilon;
+        const double c_div     = at_origin ? 1.0 : c;
+        const double lat       = asin(cos_c * ref_sin_lat + (x_rad * sin_c * ref_cos_lat) / c_div);
+        const double lon       = ref_lon_rad + atan2(y_rad * sin_c, c_div * ref_cos_lat * cos_c - x_rad * ref_sin_lat * sin_c);
+
+        lat_rad[i] = at_origin ? ref_lat_rad : lat;
+        lon_rad[i] = at_origin ? ref_lon_rad : lon;
+    }
+
+    for (int i = 0; i < count; i++) {
+        coords[i].setLatitude(lat_rad[i] * M_RAD_TO_DEG);
+        coords[i].setLongitude(lon_rad[i] * M_RAD_TO_DEG);
+        coords[i].setAltitude((z ? -z[i] : 0) + ref_alt);
+    }
+}
+
 int convertGeoToUTM(const QGeoCoordinate& coord, double& easting, double& northing)
 {
     try {
@@ -111,6 +192,66 @@ bool convertUTMToGeo(double easting, double northing, int zone, bool southhemi,
     return true;
 }
 
+/// UTM false easting in meters
+static const double utmFalseEasting = 500000;
+
+/// Longitude of the central meridian of the UTM zone
+static double _utmCentralMeridian(int zone)
+{
+    return (6.0 * zone) - 183.0;
+}
+
+int convertGeoToUTM(const QGeoCoordinate* coords, int count, double* easting, double* northing)
+{
+    if (count <= 0) {
+        return 0;
+    }
+
+    try {
+        const double    firstLatitude   = coords[0].latitude();
+        const int       zone            = GeographicLib::UTMUPS::StandardZone(firstLatitude, coords[0].longitude());
+        if (zone < GeographicLib::UTMUPS::MINUTMZONE || zone > GeographicLib::UTMUPS::MAXUTMZONE) {
+            return 0;
+        }
+
+        // The zone lookup and its constants are done once, each coordinate then only goes through the projection
+        const GeographicLib::TransverseMercator&    utm             = GeographicLib::TransverseMercator::UTM();
+        const double                                centralMeridian = _utmCentralMeridian(zone);
+        const double                                falseNorthing   = firstLatitude >= 0 ? 0 : GeographicLib::UTMUPS::UTMShift();
+        for (int i = 0; i < count; i++) {
+            utm.Forward(centralMeridian, coords[i].latitude(), coords[i].longitude(), easting[i], northing[i]);
+            easting[i]  += utmFalseEasting;
+            northing[i] += falseNorthing;
+        }
+        return zone;
+    } catch(...) {
+        return 0;
+    }
+}
+
+bool convertUTMToGeo(const double* easting, const double* northing, int count, int zone, bool southhemi, QGeoCoordinate* coords)
+{
+    if (zone < GeographicLib::UTMUPS::MINUTMZONE || zone > GeographicLib::UTMUPS::MAXUTMZONE) {
+        return false;
+    }
+
+    try {
+        const GeographicLib::TransverseMercator&    utm             = GeographicLib::TransverseMercator::UTM();
+        const double                                centralMeridian = _utmCentralMeridian(zone);
+        const double                                falseNorthing   = southhemi ? GeographicLib::UTMUPS::UTMShift() : 0;
+        for (int i = 0; i < count; i++) {
+            double lat, lon;
+            utm.Reverse(centralMeridian, easting[i] - utmFalseEasting, northing[i] - falseNorthing, lat, lon);
+            coords[i].setLatitude(lat);
+            coords[i].setLongitude(lon);
+        }
+    } catch(...) {
+        return false;
+    }
+
+    return true;
+}
+
 QString convertGeoToMGRS(const QGeoCoordinate& coord)
 {
     int zone;
@@ -154,3 +295,19 @@ bool convertMGRSToGeo(QString mgrs, QGeoCoordinate& coord)
 
     return true;
 }
+
+void convertGeoToWebMercator(double latitude, double longitude, double worldSize, double& x, double& y)
+{
+    static const double maxLatitude = 85.05112878;
+
+    double sin_lat = sin(fmax(-maxLatitude, fmin(maxLatitude, latitude)) * M_DEG_TO_RAD);
+
+    x = ((longitude + 180.0) / 360.0) * worldSize;
+    y = (0.5 - (log((1.0 + sin_lat) / (1.0 - sin_lat)) / (4.0 * M_PI))) * worldSize;
+}
+
+void convertWebMercatorToGeo(double x, double y, double worldSize, double& latitude, double& longitude)
+{
+    longitude   = ((x / worldSize) * 360.0) - 180.0;
+    latitude    = atan(sinh(M_PI * (1.0 - (2.0 * y / worldSize)))) * M_RAD_TO_DEG;
+}
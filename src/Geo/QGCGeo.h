@@ -41,6 +41,29 @@ void convertGeoToNed(QGeoCoordinate coord, QGeoCoordinate origin, double* x, dou
  */
 void convertNedToGeo(double x, double y, double z, QGeoCoordinate origin, QGeoCoordinate *coord);
 
+/**
+ * @brief Batch version of convertGeoToNed for many coordinates around the same origin. The constants of the origin
+ * are worked out once and the math runs over contiguous arrays, which is much faster than converting one at a time.
+ * @param[in] coords Geodetic coordinates to project onto LTP.
+ * @param[in] count Number of coordinates, the output arrays have to hold as many.
+ * @param[in] origin Geoedetic origin for LTP projection.
+ * @param[out] x North components of coordinates in local plane.
+ * @param[out] y East components of coordinates in local plane.
+ * @param[out] z Down components of coordinates in local plane, may be nullptr.
+ */
+void convertGeoToNed(const QGeoCoordinate* coords, int count, const QGeoCoordinate& origin, double* x, double* y, double* z);
+
+/**
+ * @brief Batch version of convertNedToGeo for many local coordinates around the same origin.
+ * @param[in] x North components of local coordinates in meters.
+ * @param[in] y East components of local coordinates in meters.
+ * @param[in] z Down components of local coordinates in meters, nullptr for all at the altitude of the origin.
+ * @param[in] count Number of coordinates, the arrays have to hold as many.
+ * @param[in] origin Geoedetic origin for LTP.
+ * @param[out] coords Geodetic coordinates to hold results.
+ */
+void convertNedToGeo(const double* x, const double* y, const double* z, int count, const QGeoCoordinate& origin, QGeoCoordinate* coords);
+
 // LatLonToUTMXY
 // Converts a latitude/longitude pair to x and y coordinates in the
 // Universal Transverse Mercator projection.
@@ -82,6 +105,22 @@ int convertGeoToUTM(const QGeoCoordinate& coord, double& easting, double& northi
 // The function returns true if conversion succeeded.
 bool convertUTMToGeo(double easting, double northing, int zone, bool southhemi, QGeoCoordinate& coord);
 
+// Batch version of convertGeoToUTM. All of the coordinates are projected in the
+// zone and hemisphere of the first one so they share a single grid, they are
+// not range checked against that zone one by one.
+//
+// Returns:
+//   The UTM zone used for all of the coordinates, 0 if it is not a UTM zone or
+//   the conversion failed
+int convertGeoToUTM(const QGeoCoordinate* coords, int count, double* easting, double* northing);
+
+// Batch version of convertUTMToGeo for coordinates in the same zone and
+// hemisphere.
+//
+// Returns:
+//   The function returns true if conversion succeeded.
+bool convertUTMToGeo(const double* easting, const double* northing, int count, int zone, bool southhemi, QGeoCoordinate* coords);
+
 // Converts a latitude/longitude pair to MGRS string
 //
 // Inputs:
@@ -105,4 +144,24 @@ QString convertGeoToMGRS(const QGeoCoordinate& coord);
 // The function returns true if conversion succeeded.
 bool convertMGRSToGeo(QString mgrs, QGeoCoordinate& coord);
 
+/**
+ * @brief Project a geodetic coordinate with Web Mercator, which is the projection of the map tiles.
+ * @param[in] latitude Latitude in degrees, limited to the range the map covers.
+ * @param[in] longitude Longitude in degrees.
+ * @param[in] worldSize Width of the whole world, 256 * 2^zoom pixels at a map zoom level.
+ * @param[out] x Pixels east of the antimeridian.
+ * @param[out] y Pixels south of the top edge of the map.
+ */
+void convertGeoToWebMercator(double latitude, double longitude, double worldSize, double& x, double& y);
+
+/**
+ * @brief Inverse of convertGeoToWebMercator.
+ * @param[in] x Pixels east of the antimeridian.
+ * @param[in] y Pixels south of the top edge of the map.
+ * @param[in] worldSize Width of the whole world, 256 * 2^zoom pixels at a map zoom level.
+ * @param[out] latitude Latitude in degrees.
+ * @param[out] longitude Longitude in degrees, not wrapped into -180 to 180.
+ */
+void convertWebMercatorToGeo(double x, double y, double worldSize, double& latitude, double& longitude);
+
 #endif // QGCGEO_H
@@ -16,6 +16,7 @@
 #include "VideoManager.h"
 #include "QGCCameraManager.h"
 #include "QGCCameraControl.h"
+#include "QGCSettingsWriteBack.h"
 
 #include <QSettings>
 
@@ -106,10 +107,12 @@ Joystick::Joystick(const QString& name, int axisCount, int buttonCount, int hatC
     , _multiVehicleManager(multiVehicleManager)
 {
     _rgAxisValues   = new int[static_cast<size_t>(_axisCount)];
+    _rgSentAxisValues = new int[static_cast<size_t>(_axisCount)];
     _rgCalibration  = new Calibration_t[static_cast<size_t>(_axisCount)];
     _rgButtonValues = new uint8_t[static_cast<size_t>(_totalButtonCount)];
     for (int i = 0; i < _axisCount; i++) {
         _rgAxisValues[i] = 0;
+        _rgSentAxisValues[i] = 0;
     }
     for (int i = 0; i < _totalButtonCount; i++) {
         _rgButtonValues[i] = BUTTON_UP;
@@ -124,8 +127,10 @@ Joystick::Joystick(const QString& name, int axisCount, int buttonCount, int hatC
 Joystick::~Joystick()
 {
     _exitThread = true;
+    _inputAvailable();
     wait();
     delete[] _rgAxisValues;
+    delete[] _rgSentAxisValues;
     delete[] _rgCalibration;
     delete[] _rgButtonValues;
     _assignableButtonActions.clearAndDeleteContents();
@@ -304,7 +309,7 @@ void Joystick::_loadSettings()
 
 void Joystick::_saveButtonSettings()
 {
-    QSettings settings;
+    QSettings& settings = QGCSettingsWriteBack::instance()->settings();
     settings.beginGroup(_settingsGroup);
     settings.beginGroup(_name);
     for (int button = 0; button < _totalButtonCount; button++) {
@@ -314,11 +319,15 @@ void Joystick::_saveButtonSettings()
             qCDebug(JoystickLog) << "_saveButtonSettings button:action" << button <<  _buttonActionArray[button]->action << _buttonActionArray[button]->repeat;
         }
     }
+    settings.endGroup();
+    settings.endGroup();
+    QGCSettingsWriteBack::instance()->scheduleFlush();
 }
 
 void Joystick::_saveSettings()
 {
-    QSettings settings;
+    // Calibration saves every value on each change, batch them rather than writing the settings file each time
+    QSettings& settings = QGCSettingsWriteBack::instance()->settings();
     settings.beginGroup(_settingsGroup);
 
     // Transmitter mode is static
@@ -369,6 +378,8 @@ void Joystick::_saveSettings()
         settings.setValue(_rgFunctionSettingsKey[function], temp[function]);
         qCDebug(JoystickLog) << "_saveSettings name:function:axis" << _name << function << _rgFunctionSettingsKey[function];
     }
+    settings.endGroup();
+    settings.endGroup();
     _saveButtonSettings();
 }
 
@@ -464,21 +475,92 @@ void Joystick::run()
     //-- Joystick thread
     _open();
     //-- Reset timers
-    _axisTime.start();
     for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
         if(_buttonActionArray[buttonIndex]) {
             _buttonActionArray[buttonIndex]->buttonTime.start();
         }
     }
+
+    // Axis values are sent on a fixed schedule at the configured frequency. The thread sleeps until the next send is
+    // due, or until input has to be checked again, instead of polling with a fixed sleep.
+    QElapsedTimer   sendClock;
+    qint64          nextSendNSecs = 0;
+    qint64          lastSendNSecs = -_minSendIntervalNSecs;
+    sendClock.start();
+
     while (!_exitThread) {
+        // Started when the input is sampled, the link measures the latency to the wire from it
+        QElapsedTimer inputTimer;
+        inputTimer.start();
+
         _update();
         _handleButtons();
-        _handleAxis();
-        QGC::SLEEP::msleep(qMin(static_cast<int>(1000.0f / _maxAxisFrequencyHz), static_cast<int>(1000.0f / _maxButtonFrequencyHz)) / 2);
+        const bool      significantChange   = _readAxes();
+        const qint64    sendIntervalNSecs   = static_cast<qint64>(1e9 / _axisFrequencyHz);
+        const qint64    nowNSecs            = sendClock.nsecsElapsed();
+
+        // A large stick movement is sent right away instead of waiting for its slot, which cuts the latency to the vehicle
+        if (nowNSecs >= nextSendNSecs || (significantChange && nowNSecs - lastSendNSecs >= _minSendIntervalNSecs)) {
+            _handleAxis(inputTimer);
+            lastSendNSecs = nowNSecs;
+            if (significantChange || nowNSecs - nextSendNSecs >= sendIntervalNSecs) {
+                // Restart the schedule from this send
+                nextSendNSecs = nowNSecs + sendIntervalNSecs;
+            } else {
+                // Stay on the schedule so the rate does not drift with the time spent in the loop
+                nextSendNSecs += sendIntervalNSecs;
+            }
+        }
+
+        qint64 waitNSecs = nextSendNSecs - sendClock.nsecsElapsed();
+        if (_requiresInputPolling()) {
+            waitNSecs = qMin(waitNSecs, _inputPollIntervalNSecs);
+        }
+        if (_anyButtonDown()) {
+            // Held buttons repeat even when no new input comes in
+            waitNSecs = qMin(waitNSecs, static_cast<qint64>(1e9 / _buttonFrequencyHz));
+        }
+        _waitForInput(waitNSecs);
     }
     _close();
 }
 
+void Joystick::_inputAvailable(void)
+{
+    QMutexLocker lock(&_inputMutex);
+    _inputPending = true;
+    _inputCondition.wakeAll();
+}
+
+/// Waits for the timeout or until _inputAvailable is called, whichever comes first
+void Joystick::_waitForInput(qint64 timeoutNSecs)
+{
+    static const qint64 nsecsPerMSec = 1000000;
+
+    QMutexLocker lock(&_inputMutex);
+    if (!_inputPending && !_exitThread && timeoutNSecs > 0) {
+        if (timeoutNSecs >= nsecsPerMSec) {
+            // Waits are in whole milliseconds, the remainder is slept off on the next pass
+            _inputCondition.wait(&_inputMutex, static_cast<unsigned long>(timeoutNSecs / nsecsPerMSec));
+        } else {
+            lock.unlock();
+            QThread::usleep(static_cast<unsigned long>(timeoutNSecs / 1000));
+            lock.relock();
+        }
+    }
+    _inputPending = false;
+}
+
+bool Joystick::_anyButtonDown(void) const
+{
+    for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
+        if (_rgButtonValues[buttonIndex] != BUTTON_UP) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Joystick::_handleButtons()
 {
     int lastBbuttonValues[256];
@@ -575,97 +657,104 @@ void Joystick::_handleButtons()
     }
 }
 
-void Joystick::_handleAxis()
+/// Reads the axes into _rgAxisValues
+/// @return true: An axis moved by more than _significantAxisChange since the last send
+bool Joystick::_readAxes()
 {
-    //-- Get frequency
-    int axisDelay = static_cast<int>(1000.0f / _axisFrequencyHz);
-    //-- Check elapsed time since last run
-    if(_axisTime.elapsed() > axisDelay) {
-        _axisTime.start();
-        //-- Update axis
-        for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
-            int newAxisValue = _getAxis(axisIndex);
-            // Calibration code requires signal to be emitted even if value hasn't changed
-            _rgAxisValues[axisIndex] = newAxisValue;
-            emit rawAxisValueChanged(axisIndex, newAxisValue);
+    bool significantChange = false;
+    for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
+        _rgAxisValues[axisIndex] = _getAxis(axisIndex);
+        if (qAbs(_rgAxisValues[axisIndex] - _rgSentAxisValues[axisIndex]) > _significantAxisChange) {
+            significantChange = true;
         }
-        if (_activeVehicle->joystickEnabled() && !_calibrationMode && _calibrated) {
-            int     axis = _rgFunctionAxis[rollFunction];
-            float   roll = _adjustRange(_rgAxisValues[axis],    _rgCalibration[axis], _deadband);
+    }
+    return significantChange;
+}
 
-                    axis = _rgFunctionAxis[pitchFunction];
-            float   pitch = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis], _deadband);
+/// Sends the axis values read by _readAxes
+void Joystick::_handleAxis(const QElapsedTimer& inputTimer)
+{
+    for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
+        // Calibration code requires signal to be emitted even if value hasn't changed
+        _rgSentAxisValues[axisIndex] = _rgAxisValues[axisIndex];
+        emit rawAxisValueChanged(axisIndex, _rgAxisValues[axisIndex]);
+    }
+    if (_activeVehicle->joystickEnabled() && !_calibrationMode && _calibrated) {
+        int     axis = _rgFunctionAxis[rollFunction];
+        float   roll = _adjustRange(_rgAxisValues[axis],    _rgCalibration[axis], _deadband);
 
-                    axis = _rgFunctionAxis[yawFunction];
-            float   yaw = _adjustRange(_rgAxisValues[axis],     _rgCalibration[axis],_deadband);
+                axis = _rgFunctionAxis[pitchFunction];
+        float   pitch = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis], _deadband);
 
-                    axis = _rgFunctionAxis[throttleFunction];
-            float   throttle = _adjustRange(_rgAxisValues[axis],_rgCalibration[axis], _throttleMode==ThrottleModeDownZero?false:_deadband);
+                axis = _rgFunctionAxis[yawFunction];
+        float   yaw = _adjustRange(_rgAxisValues[axis],     _rgCalibration[axis],_deadband);
 
-            float   gimbalPitch = 0.0f;
-            float   gimbalYaw   = 0.0f;
+                axis = _rgFunctionAxis[throttleFunction];
+        float   throttle = _adjustRange(_rgAxisValues[axis],_rgCalibration[axis], _throttleMode==ThrottleModeDownZero?false:_deadband);
 
-            if(_axisCount > 4) {
-                axis = _rgFunctionAxis[gimbalPitchFunction];
-                gimbalPitch = _adjustRange(_rgAxisValues[axis], _rgCalibration[axis],_deadband);
-            }
+        float   gimbalPitch = 0.0f;
+        float   gimbalYaw   = 0.0f;
 
-            if(_axisCount > 5) {
-                axis = _rgFunctionAxis[gimbalYawFunction];
-                gimbalYaw = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis],_deadband);
-            }
+        if(_axisCount > 4) {
+            axis = _rgFunctionAxis[gimbalPitchFunction];
+            gimbalPitch = _adjustRange(_rgAxisValues[axis], _rgCalibration[axis],_deadband);
+        }
 
-            if (_accumulator) {
-                static float throttle_accu = 0.f;
-                throttle_accu += throttle * (40 / 1000.f); //for throttle to change from min to max it will take 1000ms (40ms is a loop time)
-                throttle_accu = std::max(static_cast<float>(-1.f), std::min(throttle_accu, static_cast<float>(1.f)));
-                throttle = throttle_accu;
-            }
+        if(_axisCount > 5) {
+            axis = _rgFunctionAxis[gimbalYawFunction];
+            gimbalYaw = _adjustRange(_rgAxisValues[axis],   _rgCalibration[axis],_deadband);
+        }
 
-            if (_circleCorrection) {
-                float roll_limited      = std::max(static_cast<float>(-M_PI_4), std::min(roll,      static_cast<float>(M_PI_4)));
-                float pitch_limited     = std::max(static_cast<float>(-M_PI_4), std::min(pitch,     static_cast<float>(M_PI_4)));
-                float yaw_limited       = std::max(static_cast<float>(-M_PI_4), std::min(yaw,       static_cast<float>(M_PI_4)));
-                float throttle_limited  = std::max(static_cast<float>(-M_PI_4), std::min(throttle,  static_cast<float>(M_PI_4)));
-
-                // Map from unit circle to linear range and limit
-                roll =      std::max(-1.0f, std::min(tanf(asinf(roll_limited)),     1.0f));
-                pitch =     std::max(-1.0f, std::min(tanf(asinf(pitch_limited)),    1.0f));
-                yaw =       std::max(-1.0f, std::min(tanf(asinf(yaw_limited)),      1.0f));
-                throttle =  std::max(-1.0f, std::min(tanf(asinf(throttle_limited)), 1.0f));
-            }
+        if (_accumulator) {
+            static float throttle_accu = 0.f;
+            throttle_accu += throttle * (40 / 1000.f); //for throttle to change from min to max it will take 1000ms (40ms is a loop time)
+            throttle_accu = std::max(static_cast<float>(-1.f), std::min(throttle_accu, static_cast<float>(1.f)));
+            throttle = throttle_accu;
+        }
 
-            if ( _exponential < -0.01f) {
-                // Exponential (0% to -50% range like most RC radios)
-                // _exponential is set by a slider in joystickConfigAdvanced.qml
-                // Calculate new RPY with exponential applied
-                roll =  -_exponential*powf(roll, 3) + (1+_exponential)*roll;
-                pitch = -_exponential*powf(pitch,3) + (1+_exponential)*pitch;
-                yaw =   -_exponential*powf(yaw,  3) + (1+_exponential)*yaw;
-            }
+        if (_circleCorrection) {
+            float roll_limited      = std::max(static_cast<float>(-M_PI_4), std::min(roll,      static_cast<float>(M_PI_4)));
+            float pitch_limited     = std::max(static_cast<float>(-M_PI_4), std::min(pitch,     static_cast<float>(M_PI_4)));
+            float yaw_limited       = std::max(static_cast<float>(-M_PI_4), std::min(yaw,       static_cast<float>(M_PI_4)));
+            float throttle_limited  = std::max(static_cast<float>(-M_PI_4), std::min(throttle,  static_cast<float>(M_PI_4)));
+
+            // Map from unit circle to linear range and limit
+            roll =      std::max(-1.0f, std::min(tanf(asinf(roll_limited)),     1.0f));
+            pitch =     std::max(-1.0f, std::min(tanf(asinf(pitch_limited)),    1.0f));
+            yaw =       std::max(-1.0f, std::min(tanf(asinf(yaw_limited)),      1.0f));
+            throttle =  std::max(-1.0f, std::min(tanf(asinf(throttle_limited)), 1.0f));
+        }
 
-            // Adjust throttle to 0:1 range
-            if (_throttleMode == ThrottleModeCenterZero && _activeVehicle->supportsThrottleModeCenterZero()) {
-                if (!_activeVehicle->supportsNegativeThrust() || !_negativeThrust) {
-                    throttle = std::max(0.0f, throttle);
-                }
-            } else {
-                throttle = (throttle + 1.0f) / 2.0f;
+        if ( _exponential < -0.01f) {
+            // Exponential (0% to -50% range like most RC radios)
+            // _exponential is set by a slider in joystickConfigAdvanced.qml
+            // Calculate new RPY with exponential applied
+            roll =  -_exponential*powf(roll, 3) + (1+_exponential)*roll;
+            pitch = -_exponential*powf(pitch,3) + (1+_exponential)*pitch;
+            yaw =   -_exponential*powf(yaw,  3) + (1+_exponential)*yaw;
+        }
+
+        // Adjust throttle to 0:1 range
+        if (_throttleMode == ThrottleModeCenterZero && _activeVehicle->supportsThrottleModeCenterZero()) {
+            if (!_activeVehicle->supportsNegativeThrust() || !_negativeThrust) {
+                throttle = std::max(0.0f, throttle);
             }
-            qCDebug(JoystickValuesLog) << "name:roll:pitch:yaw:throttle:gimbalPitch:gimbalYaw" << name() << roll << -pitch << yaw << throttle << gimbalPitch << gimbalYaw;
-            // NOTE: The buttonPressedBits going to MANUAL_CONTROL are currently used by ArduSub (and it only handles 16 bits)
-            // Set up button bitmap
-            quint64 buttonPressedBits = 0;  // Buttons pressed for manualControl signal
-            for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
-                quint64 buttonBit = static_cast<quint64>(1LL << buttonIndex);
-                if (_rgButtonValues[buttonIndex] != BUTTON_UP) {
-                    // Mark the button as pressed as long as its pressed
-                    buttonPressedBits |= buttonBit;
-                }
+        } else {
+            throttle = (throttle + 1.0f) / 2.0f;
+        }
+        qCDebug(JoystickValuesLog) << "name:roll:pitch:yaw:throttle:gimbalPitch:gimbalYaw" << name() << roll << -pitch << yaw << throttle << gimbalPitch << gimbalYaw;
+        // NOTE: The buttonPressedBits going to MANUAL_CONTROL are currently used by ArduSub (and it only handles 16 bits)
+        // Set up button bitmap
+        quint64 buttonPressedBits = 0;  // Buttons pressed for manualControl signal
+        for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
+            quint64 buttonBit = static_cast<quint64>(1LL << buttonIndex);
+            if (_rgButtonValues[buttonIndex] != BUTTON_UP) {
+                // Mark the button as pressed as long as its pressed
+                buttonPressedBits |= buttonBit;
             }
-            uint16_t shortButtons = static_cast<uint16_t>(buttonPressedBits & 0xFFFF);
-            _activeVehicle->sendJoystickDataThreadSafe(roll, pitch, yaw, throttle, shortButtons);
         }
+        uint16_t shortButtons = static_cast<uint16_t>(buttonPressedBits & 0xFFFF);
+        _activeVehicle->sendJoystickDataThreadSafe(roll, pitch, yaw, throttle, shortButtons, inputTimer);
     }
 }
 
@@ -929,8 +1018,8 @@ void Joystick::setCircleCorrection(bool circleCorrection)
 void Joystick::setAxisFrequency(float val)
 {
     //-- Arbitrary limits
-    val = qMin(_minAxisFrequencyHz, val);
-    val = qMax(_maxAxisFrequencyHz, val);
+    val = qMax(_minAxisFrequencyHz, val);
+    val = qMin(_maxAxisFrequencyHz, val);
     _axisFrequencyHz = val;
     _saveSettings();
     emit axisFrequencyHzChanged();
@@ -939,8 +1028,8 @@ void Joystick::setAxisFrequency(float val)
 void Joystick::setButtonFrequency(float val)
 {
     //-- Arbitrary limits
-    val = qMin(_minButtonFrequencyHz, val);
-    val = qMax(_maxButtonFrequencyHz, val);
+    val = qMax(_minButtonFrequencyHz, val);
+    val = qMin(_maxButtonFrequencyHz, val);
     _buttonFrequencyHz = val;
     _saveSettings();
     emit buttonFrequencyHzChanged();
@@ -14,6 +14,8 @@
 
 #include <QObject>
 #include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
 
 #include "QGCLoggingCategory.h"
 #include "Vehicle.h"
@@ -225,7 +227,8 @@ protected:
     int     _findAssignableButtonAction(const QString& action);
     bool    _validAxis              (int axis);
     bool    _validButton            (int button);
-    void    _handleAxis             ();
+    bool    _readAxes               ();
+    void    _handleAxis             (const QElapsedTimer& inputTimer);
     void    _handleButtons          ();
     void    _buildActionList        (Vehicle* activeVehicle);
 
@@ -243,6 +246,13 @@ private:
     virtual int  _getAxis   (int i)      = 0;
     virtual bool _getHat    (int hat,int i) = 0;
 
+    /// true: Input has to be polled, the thread then checks it every _inputPollIntervalNSecs in between sends. false:
+    /// The implementation calls _inputAvailable whenever input changes.
+    virtual bool _requiresInputPolling(void) { return true; }
+
+    void _waitForInput(qint64 timeoutNSecs);
+    bool _anyButtonDown(void) const;
+
     void _updateTXModeSettingsKey(Vehicle* activeVehicle);
     int _mapFunctionMode(int mode, int function);
     void _remapAxes(int currentMode, int newMode, int (&newMapping)[maxFunction]);
@@ -251,6 +261,8 @@ private:
     virtual void run();
 
 protected:
+    /// Wakes up the joystick thread to handle new input, for implementations which have input pushed to them
+    void _inputAvailable(void);
 
     enum {
         BUTTON_UP,
@@ -266,6 +278,7 @@ protected:
     bool    _exitThread             = false;    ///< true: signal thread to exit
     bool    _calibrationMode        = false;
     int*    _rgAxisValues           = nullptr;
+    int*    _rgSentAxisValues       = nullptr;  ///< Axis values at the time of the last send
     Calibration_t* _rgCalibration   = nullptr;
     ThrottleMode_t _throttleMode    = ThrottleModeDownZero;
     bool    _negativeThrust         = false;
@@ -289,7 +302,9 @@ protected:
 
     static int          _transmitterMode;
     int                 _rgFunctionAxis[maxFunction] = {};
-    QElapsedTimer       _axisTime;
+    QMutex              _inputMutex;
+    QWaitCondition      _inputCondition;
+    bool                _inputPending = false;  ///< _inputAvailable was called while the thread was not waiting
 
     QmlObjectListModel              _assignableButtonActions;
     QList<AssignedButtonAction*>    _buttonActionArray;
@@ -301,6 +316,10 @@ protected:
     static const float  _minButtonFrequencyHz;
     static const float  _maxButtonFrequencyHz;
 
+    static const qint64 _inputPollIntervalNSecs     = 5000000;  ///< Polled input is checked at the maximum axis frequency
+    static const qint64 _minSendIntervalNSecs       = 5000000;  ///< Sends brought forward by a stick movement are at least this far apart
+    static const int    _significantAxisChange      = 1000;     ///< Raw axis movement since the last send which is sent right away, about 3% of the range
+
 private:
     static const char*  _rgFunctionSettingsKey[maxFunction];
 
@@ -161,6 +161,7 @@ bool JoystickAndroid::handleKeyEvent(jobject event) {
         if (btnCode[i] == keyCode) {
             if (action == ACTION_DOWN) btnValue[i] = true;
             if (action == ACTION_UP)   btnValue[i] = false;
+            _inputAvailable();
             return true;
         }
     }
@@ -177,6 +178,7 @@ bool JoystickAndroid::handleGenericMotionEvent(jobject event) {
         const float v = ev.callMethod<jfloat>("getAxisValue", "(I)F",axisCode[i]);
         axisValue[i] = static_cast<int>((v*32767.f));
     }
+    _inputAvailable();
     return true;
 }
 
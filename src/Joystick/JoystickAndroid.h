@@ -37,6 +37,9 @@ private:
     virtual int  _getAxis       (int i);
     virtual bool _getHat        (int hat,int i);
 
+    // Input is pushed by the Android event listeners
+    virtual bool _requiresInputPolling() { return false; }
+
     int *btnCode;
     int *axisCode;
     bool *btnValue;
@@ -444,24 +444,40 @@ void JsonHelper::saveGeoCoordinateArray(const QList<QGeoCoordinate>&    rgPoints
 
 bool JsonHelper::validateKeys(const QJsonObject& jsonObject, const QList<JsonHelper::KeyValidateInfo>& keyInfo, QString& errorString)
 {
-    QStringList             keyList;
-    QList<QJsonValue::Type> typeList;
+    // This is called for every item of every plan loaded, so each key is only looked up once. Errors are the same as
+    // validateRequiredKeys followed by validateKeyTypes: all missing keys first, then the first key of the wrong type.
+    QString missingKeys;
+    QString typeError;
+
+    for (const KeyValidateInfo& info: keyInfo) {
+        QJsonObject::const_iterator iter = jsonObject.constFind(QLatin1String(info.key));
+        if (iter == jsonObject.constEnd()) {
+            if (info.required) {
+                if (!missingKeys.isEmpty()) {
+                    missingKeys += QStringLiteral(", ");
+                }
+                missingKeys += info.key;
+            }
+            continue;
+        }
 
-    for (int i=0; i<keyInfo.count(); i++) {
-        if (keyInfo[i].required) {
-            keyList.append(keyInfo[i].key);
+        QJsonValue::Type valueType = iter.value().type();
+        if (typeError.isEmpty() && valueType != info.type && !(valueType == QJsonValue::Null && info.type == QJsonValue::Double)) {
+            // Null type signals a NaN on a double value
+            typeError = QObject::tr("Incorrect value type - key:type:expected %1:%2:%3").arg(info.key).arg(_jsonValueTypeToString(valueType)).arg(_jsonValueTypeToString(info.type));
         }
     }
-    if (!validateRequiredKeys(jsonObject, keyList, errorString)) {
+
+    if (!missingKeys.isEmpty()) {
+        errorString = QObject::tr("The following required keys are missing: %1").arg(missingKeys);
+        return false;
+    }
+    if (!typeError.isEmpty()) {
+        errorString = typeError;
         return false;
     }
 
-    keyList.clear();
-    for (int i=0; i<keyInfo.count(); i++) {
-        keyList.append(keyInfo[i].key);
-        typeList.append(keyInfo[i].type);
-    }
-    return validateKeyTypes(jsonObject, keyList, typeList, errorString);
+    return true;
 }
 
 QString JsonHelper::_jsonValueTypeToString(QJsonValue::Type type)
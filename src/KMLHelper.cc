@@ -11,50 +11,56 @@
 
 #include <QFile>
 #include <QVariant>
+#include <QXmlStreamReader>
+
+#include <algorithm>
 
 const char* KMLHelper::_errorPrefix = QT_TR_NOOP("KML file load failed. %1");
 
-QDomDocument KMLHelper::_loadFile(const QString& kmlFile, QString& errorString)
+bool KMLHelper::_openFile(const QString& kmlFile, QFile& file, QString& errorString)
 {
-    QFile file(kmlFile);
-
     errorString.clear();
 
+    file.setFileName(kmlFile);
     if (!file.exists()) {
         errorString = QString(_errorPrefix).arg(tr("File not found: %1").arg(kmlFile));
-        return QDomDocument();
+        return false;
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
         errorString = QString(_errorPrefix).arg(tr("Unable to open file: %1 error: $%2").arg(kmlFile).arg(file.errorString()));
-        return QDomDocument();
-    }
-
-    QDomDocument doc;
-    QString errorMessage;
-    int errorLine;
-    if (!doc.setContent(&file, &errorMessage, &errorLine)) {
-        errorString = QString(_errorPrefix).arg(tr("Unable to parse KML file: %1 error: %2 line: %3").arg(kmlFile).arg(errorMessage).arg(errorLine));
-        return QDomDocument();
+        return false;
     }
 
-    return doc;
+    return true;
 }
 
 ShapeFileHelper::ShapeType KMLHelper::determineShapeType(const QString& kmlFile, QString& errorString)
 {
-    QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
+    QFile file;
+    if (!_openFile(kmlFile, file, errorString)) {
         return ShapeFileHelper::Error;
     }
 
-    QDomNodeList rgNodes = domDocument.elementsByTagName("Polygon");
-    if (rgNodes.count()) {
-        return ShapeFileHelper::Polygon;
+    // A polygon anywhere in the file wins over a polyline, so only a polygon ends the scan early
+    bool                lineStringFound = false;
+    QXmlStreamReader    xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement) {
+            if (xml.name() == QLatin1String("Polygon")) {
+                return ShapeFileHelper::Polygon;
+            } else if (xml.name() == QLatin1String("LineString")) {
+                lineStringFound = true;
+            }
+        }
+    }
+
+    if (xml.hasError()) {
+        errorString = QString(_errorPrefix).arg(tr("Unable to parse KML file: %1 error: %2 line: %3").arg(kmlFile).arg(xml.errorString()).arg(xml.lineNumber()));
+        return ShapeFileHelper::Error;
     }
 
-    rgNodes = domDocument.elementsByTagName("LineString");
-    if (rgNodes.count()) {
+    if (lineStringFound) {
         return ShapeFileHelper::Polyline;
     }
 
@@ -62,60 +68,161 @@ ShapeFileHelper::ShapeType KMLHelper::determineShapeType(const QString& kmlFile,
     return ShapeFileHelper::Error;
 }
 
-bool KMLHelper::loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate>& vertices, QString& errorString)
+int KMLHelper::parseCoordinates(const QStringRef& text, bool final, QList<QGeoCoordinate>& coords)
 {
-    errorString.clear();
-    vertices.clear();
+    const int   cChars      = text.length();
+    int         consumed    = 0;
+    int         i           = 0;
 
-    QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
-        return false;
+    while (true) {
+        while (i < cChars && text.at(i).isSpace()) {
+            i++;
+        }
+        consumed = i;
+        if (i == cChars) {
+            return consumed;
+        }
+
+        const int tupleStart = i;
+        while (i < cChars && !text.at(i).isSpace()) {
+            i++;
+        }
+        if (i == cChars && !final) {
+            // The tuple may continue in the next piece of text
+            return consumed;
+        }
+
+        const QStringRef    tuple   = text.mid(tupleStart, i - tupleStart);
+        const int           comma1  = tuple.indexOf(QLatin1Char(','));
+        if (comma1 < 0) {
+            return -1;
+        }
+        const int           comma2  = tuple.indexOf(QLatin1Char(','), comma1 + 1);
+
+        bool lonOk = false;
+        bool latOk = false;
+        const double longitude  = tuple.left(comma1).toDouble(&lonOk);
+        const double latitude   = tuple.mid(comma1 + 1, comma2 < 0 ? -1 : comma2 - comma1 - 1).toDouble(&latOk);
+        if (!lonOk || !latOk) {
+            return -1;
+        }
+        coords.append(QGeoCoordinate(latitude, longitude));
     }
+}
 
-    QDomNodeList rgNodes = domDocument.elementsByTagName("Polygon");
-    if (rgNodes.count() == 0) {
-        errorString = QString(_errorPrefix).arg(tr("Unable to find Polygon node in KML"));
+/// Reads the first coordinates element at coordinatesPath below the first shapeElement of the file
+/// @return false: The file could not be read, errorString set. coords is left empty if the shape or its coordinates
+///                were not found.
+bool KMLHelper::_loadCoordinates(const QString& kmlFile, const QString& shapeElement, const QStringList& coordinatesPath, QList<QGeoCoordinate>& coords, QString& errorString, const ShapeFileHelper::ProgressCallback& progress)
+{
+    QFile file;
+    if (!_openFile(kmlFile, file, errorString)) {
         return false;
     }
 
-    QDomNode coordinatesNode = rgNodes.item(0).namedItem("outerBoundaryIs").namedItem("LinearRing").namedItem("coordinates");
-    if (coordinatesNode.isNull()) {
-        errorString = QString(_errorPrefix).arg(tr("Internal error: Unable to find coordinates node in KML"));
+    const double        fileSize        = qMax(file.size(), static_cast<qint64>(1));
+    QXmlStreamReader    xml(&file);
+    QStringList         shapePath;              ///< Elements opened below the shape element
+    bool                inShape         = false;
+    bool                shapeDone       = false;
+    bool                inCoordinates   = false;
+    QString             pending;                ///< Coordinates text which does not end in a complete tuple yet
+    int                 cTokens         = 0;
+
+    // The whole file is still read after the coordinates are found, so a malformed file fails like it would with a DOM
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (inShape) {
+                shapePath.append(xml.name().toString());
+                inCoordinates = shapePath == coordinatesPath;
+            } else if (!shapeDone && xml.name() == shapeElement) {
+                inShape = true;
+            }
+            break;
+        case QXmlStreamReader::EndElement:
+            if (inCoordinates) {
+                inCoordinates = false;
+                if (parseCoordinates(QStringRef(&pending), true /* final */, coords) < 0) {
+                    errorString = QString(_errorPrefix).arg(tr("Unable to parse coordinates in KML file: %1 line: %2").arg(kmlFile).arg(xml.lineNumber()));
+                    coords.clear();
+                    return false;
+                }
+                pending.clear();
+                shapeDone = true;
+                inShape = false;
+            } else if (inShape) {
+                if (shapePath.isEmpty()) {
+                    inShape     = false;
+                    shapeDone   = true;
+                } else {
+                    shapePath.removeLast();
+                }
+            }
+            break;
+        case QXmlStreamReader::Characters:
+            if (inCoordinates) {
+                pending.append(xml.text());
+                const int consumed = parseCoordinates(QStringRef(&pending), false /* final */, coords);
+                if (consumed < 0) {
+                    errorString = QString(_errorPrefix).arg(tr("Unable to parse coordinates in KML file: %1 line: %2").arg(kmlFile).arg(xml.lineNumber()));
+                    coords.clear();
+                    return false;
+                }
+                pending.remove(0, consumed);
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (progress && (++cTokens % _progressTokenInterval) == 0 && !progress(file.pos() / fileSize)) {
+            errorString = QString(_errorPrefix).arg(tr("Load cancelled."));
+            coords.clear();
+            return false;
+        }
+    }
+
+    if (xml.hasError()) {
+        errorString = QString(_errorPrefix).arg(tr("Unable to parse KML file: %1 error: %2 line: %3").arg(kmlFile).arg(xml.errorString()).arg(xml.lineNumber()));
+        coords.clear();
         return false;
     }
 
-    QString coordinatesString = coordinatesNode.toElement().text().simplified();
-    QStringList rgCoordinateStrings = coordinatesString.split(" ");
+    return true;
+}
 
-    QList<QGeoCoordinate> rgCoords;
-    for (int i=0; i<rgCoordinateStrings.count()-1; i++) {
-        QString coordinateString = rgCoordinateStrings[i];
+bool KMLHelper::loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate>& vertices, QString& errorString, const ShapeFileHelper::ProgressCallback& progress)
+{
+    errorString.clear();
+    vertices.clear();
 
-        QStringList rgValueStrings = coordinateString.split(",");
+    QList<QGeoCoordinate> rgCoords;
+    static const QStringList coordinatesPath({ QStringLiteral("outerBoundaryIs"), QStringLiteral("LinearRing"), QStringLiteral("coordinates") });
+    if (!_loadCoordinates(kmlFile, QStringLiteral("Polygon"), coordinatesPath, rgCoords, errorString, progress)) {
+        return false;
+    }
 
-        QGeoCoordinate coord;
-        coord.setLongitude(rgValueStrings[0].toDouble());
-        coord.setLatitude(rgValueStrings[1].toDouble());
+    if (rgCoords.isEmpty()) {
+        errorString = QString(_errorPrefix).arg(tr("Unable to find Polygon coordinates in KML"));
+        return false;
+    }
 
-        rgCoords.append(coord);
+    // KML rings repeat the first vertex at the end
+    if (rgCoords.count() > 1 && rgCoords.last() == rgCoords.first()) {
+        rgCoords.removeLast();
     }
 
     // Determine winding, reverse if needed. QGC wants clockwise winding
     double sum = 0;
     for (int i=0; i<rgCoords.count(); i++) {
-        QGeoCoordinate coord1 = rgCoords[i];
-        QGeoCoordinate coord2 = (i == rgCoords.count() - 1) ? rgCoords[0] : rgCoords[i+1];
+        const QGeoCoordinate& coord1 = rgCoords[i];
+        const QGeoCoordinate& coord2 = (i == rgCoords.count() - 1) ? rgCoords[0] : rgCoords[i+1];
 
         sum += (coord2.longitude() - coord1.longitude()) * (coord2.latitude() + coord1.latitude());
     }
-    bool reverse = sum < 0.0;
-    if (reverse) {
-        QList<QGeoCoordinate> rgReversed;
-
-        for (int i=0; i<rgCoords.count(); i++) {
-            rgReversed.prepend(rgCoords[i]);
-        }
-        rgCoords = rgReversed;
+    if (sum < 0.0) {
+        std::reverse(rgCoords.begin(), rgCoords.end());
     }
 
     vertices = rgCoords;
@@ -123,44 +230,22 @@ bool KMLHelper::loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate
     return true;
 }
 
-bool KMLHelper::loadPolylineFromFile(const QString& kmlFile, QList<QGeoCoordinate>& coords, QString& errorString)
+bool KMLHelper::loadPolylineFromFile(const QString& kmlFile, QList<QGeoCoordinate>& coords, QString& errorString, const ShapeFileHelper::ProgressCallback& progress)
 {
     errorString.clear();
     coords.clear();
 
-    QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
-        return false;
-    }
-
-    QDomNodeList rgNodes = domDocument.elementsByTagName("LineString");
-    if (rgNodes.count() == 0) {
-        errorString = QString(_errorPrefix).arg(tr("Unable to find LineString node in KML"));
+    QList<QGeoCoordinate> rgCoords;
+    static const QStringList coordinatesPath({ QStringLiteral("coordinates") });
+    if (!_loadCoordinates(kmlFile, QStringLiteral("LineString"), coordinatesPath, rgCoords, errorString, progress)) {
         return false;
     }
 
-    QDomNode coordinatesNode = rgNodes.item(0).namedItem("coordinates");
-    if (coordinatesNode.isNull()) {
-        errorString = QString(_errorPrefix).arg(tr("Internal error: Unable to find coordinates node in KML"));
+    if (rgCoords.isEmpty()) {
+        errorString = QString(_errorPrefix).arg(tr("Unable to find LineString coordinates in KML"));
         return false;
     }
 
-    QString coordinatesString = coordinatesNode.toElement().text().simplified();
-    QStringList rgCoordinateStrings = coordinatesString.split(" ");
-
-    QList<QGeoCoordinate> rgCoords;
-    for (int i=0; i<rgCoordinateStrings.count()-1; i++) {
-        QString coordinateString = rgCoordinateStrings[i];
-
-        QStringList rgValueStrings = coordinateString.split(",");
-
-        QGeoCoordinate coord;
-        coord.setLongitude(rgValueStrings[0].toDouble());
-        coord.setLatitude(rgValueStrings[1].toDouble());
-
-        rgCoords.append(coord);
-    }
-
     coords = rgCoords;
 
     return true;
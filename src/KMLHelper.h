@@ -10,23 +10,35 @@
 #pragma once
 
 #include <QObject>
-#include <QDomDocument>
 #include <QList>
 #include <QGeoCoordinate>
+#include <QStringList>
 
 #include "ShapeFileHelper.h"
 
+class QFile;
+
+/// KML files are read with a stream reader so large files are never held in memory as a whole and the coordinates are
+/// parsed as they are read.
 class KMLHelper : public QObject
 {
     Q_OBJECT
 
 public:
     static ShapeFileHelper::ShapeType determineShapeType(const QString& kmlFile, QString& errorString);
-    static bool loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate>& vertices, QString& errorString);
-    static bool loadPolylineFromFile(const QString& kmlFile, QList<QGeoCoordinate>& coords, QString& errorString);
+    static bool loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate>& vertices, QString& errorString, const ShapeFileHelper::ProgressCallback& progress = ShapeFileHelper::ProgressCallback());
+    static bool loadPolylineFromFile(const QString& kmlFile, QList<QGeoCoordinate>& coords, QString& errorString, const ShapeFileHelper::ProgressCallback& progress = ShapeFileHelper::ProgressCallback());
+
+    /// Parses whitespace separated lon,lat[,alt] tuples of a KML coordinates element in place
+    ///     @param text Text to parse, a trailing partial tuple is left unparsed
+    ///     @param final true: text ends the element, a trailing tuple is parsed as well
+    /// @return Number of characters consumed, -1 if a tuple could not be parsed
+    static int parseCoordinates(const QStringRef& text, bool final, QList<QGeoCoordinate>& coords);
 
 private:
-    static QDomDocument _loadFile(const QString& kmlFile, QString& errorString);
+    static bool _openFile       (const QString& kmlFile, QFile& file, QString& errorString);
+    static bool _loadCoordinates(const QString& kmlFile, const QString& shapeElement, const QStringList& coordinatesPath, QList<QGeoCoordinate>& coords, QString& errorString, const ShapeFileHelper::ProgressCallback& progress);
 
-    static const char* _errorPrefix;
+    static const char*  _errorPrefix;
+    static const int    _progressTokenInterval = 256;   ///< Xml tokens read between progress reports
 };
@@ -25,8 +25,14 @@
 #include <QStringList>
 #include <QFileInfo>
 #include <QList>
+#include <QHash>
+#include <QMap>
 #include <QDebug>
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
 /**
  * Initializes all the variables necessary for a compression run. This won't actually happen
  * until startCompression(...) is called.
@@ -36,22 +42,84 @@ LogCompressor::LogCompressor(QString logFileName, QString outFileName, QString d
 	outFileName(outFileName),
 	running(true),
 	currentDataLine(0),
+	totalLines(0),
     delimiter(delimiter),
     holeFillingEnabled(true)
 {
     connect(this, &LogCompressor::logProcessingCriticalError, qgcApp(), &QGCApplication::criticalMessageBoxOnMainThread);
 }
 
-void LogCompressor::run()
+const char* LogCompressor::_lineEnd(const char* line, const char* end)
+{
+    const char* lineEnd = static_cast<const char*>(memchr(line, '\n', static_cast<size_t>(end - line)));
+    return lineEnd ? lineEnd : end;
+}
+
+quint64 LogCompressor::_parseTimestamp(const Field_t& field)
+{
+    // Same as QString::toULongLong: surrounding white space is fine, anything else makes it 0
+    const char* pos = field.data;
+    const char* end = field.data + field.size;
+    while (pos < end && isspace(static_cast<unsigned char>(*pos))) {
+        pos++;
+    }
+    while (end > pos && isspace(static_cast<unsigned char>(end[-1]))) {
+        end--;
+    }
+    if (pos == end) {
+        return 0;
+    }
+    quint64 timestamp = 0;
+    for (; pos < end; pos++) {
+        if (*pos < '0' || *pos > '9') {
+            return 0;
+        }
+        timestamp = (timestamp * 10) + static_cast<quint64>(*pos - '0');
+    }
+    return timestamp;
+}
+
+/**
+ * Splits the first _cFields fields off a line without copying them.
+ * @return false if the line has less than _cFields fields
+ */
+bool LogCompressor::_splitLine(const char* line, const char* lineEnd, const QByteArray& delim, Field_t* fields)
+{
+    if (lineEnd > line && lineEnd[-1] == '\r') {
+        lineEnd--;
+    }
+    const char* pos = line;
+    for (int i = 0; i < _cFields; i++) {
+        const char* fieldEnd = std::search(pos, lineEnd, delim.constData(), delim.constData() + delim.size());
+        fields[i].data = pos;
+        fields[i].size = static_cast<int>(fieldEnd - pos);
+        if (fieldEnd == lineEnd) {
+            return i == _cFields - 1;
+        }
+        pos = fieldEnd + delim.size();
+    }
+    return true;
+}
+
+bool LogCompressor::_flushOutput(QFile& outFile, QByteArray& output)
 {
-	// Verify that the input file is useable
-	QFile infile(logFileName);
-	if (!infile.exists() || !infile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-		_signalCriticalError(tr("Log Compressor: Cannot start/compress log file, since input file %1 is not readable").arg(QFileInfo(infile.fileName()).absoluteFilePath()));
-		return;
-	}
+    if (!output.isEmpty() && outFile.write(output) != output.size()) {
+        _signalCriticalError(tr("Log Compressor: Unable to write to output file %1: %2").arg(QFileInfo(outFile.fileName()).absoluteFilePath(), outFile.errorString()));
+        return false;
+    }
+    // Keeps the reserved capacity
+    output.resize(0);
+    return true;
+}
 
-//    outFileName = logFileName;
+void LogCompressor::run()
+{
+    // Verify that the input file is useable
+    QFile infile(logFileName);
+    if (!infile.exists() || !infile.open(QIODevice::ReadOnly)) {
+        _signalCriticalError(tr("Log Compressor: Cannot start/compress log file, since input file %1 is not readable").arg(QFileInfo(infile.fileName()).absoluteFilePath()));
+        return;
+    }
 
     QString outFileName;
 
@@ -65,130 +133,174 @@ void LogCompressor::run()
     parts.replace(parts.size()-1, "txt");
     outFileName = parts.join(".");
 
-	// Verify that the output file is useable
+    // Verify that the output file is useable
     QFile outTmpFile(outFileName);
     if (!outTmpFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-		_signalCriticalError(tr("Log Compressor: Cannot start/compress log file, since output file %1 is not writable").arg(QFileInfo(outTmpFile.fileName()).absoluteFilePath()));
-		return;
-	}
-
-
-	// First we search the input file through keySearchLimit number of lines
-	// looking for variables. This is necessary before CSV files require
-	// the same number of fields for every line.
-	const unsigned int keySearchLimit = 15000;
-	unsigned int keyCounter = 0;
-	QTextStream in(&infile);
-	QMap<QString, int> messageMap;
-
-	while (!in.atEnd() && keyCounter < keySearchLimit) {
-		QString messageName = in.readLine().split(delimiter).at(2);
-		messageMap.insert(messageName, 0);
-		++keyCounter;
-	}
-
-	// Now update each key with its index in the output string. These are
-	// all offset by one to account for the first field: timestamp_ms.
-    QMap<QString, int>::iterator i = messageMap.begin();
-	int j;
-	for (i = messageMap.begin(), j = 1; i != messageMap.end(); ++i, ++j) {
-		i.value() = j;
-	}
-
-	// Open the output file and write the header line to it
-	QStringList headerList(messageMap.keys());
-
-	QString headerLine = "timestamp_ms" + delimiter + headerList.join(delimiter) + "\n";
+        _signalCriticalError(tr("Log Compressor: Cannot start/compress log file, since output file %1 is not writable").arg(QFileInfo(outTmpFile.fileName()).absoluteFilePath()));
+        return;
+    }
+
+    // The lines are only ever looked at in place, through the mapping
+    const qint64    size    = infile.size();
+    const char*     data    = size > 0 ? reinterpret_cast<const char*>(infile.map(0, size)) : nullptr;
+    if (size > 0 && !data) {
+        _signalCriticalError(tr("Log Compressor: Cannot map input file %1: %2").arg(QFileInfo(infile.fileName()).absoluteFilePath(), infile.errorString()));
+        return;
+    }
+    const char*         end     = data + size;
+    const QByteArray    delim   = delimiter.isEmpty() ? QByteArray("\t") : delimiter.toLocal8Bit();
+    Field_t             fields[_cFields];
+
+    // First pass: every variable becomes a column, since CSV files require the same number of fields for every
+    // line. Also checks whether the lines are in time order, which they nearly always are.
+    QMap<QByteArray, int>   messageMap;
+    bool                    ordered         = true;
+    quint64                 lastTimestamp   = 0;
+    int                     lineCount       = 0;
+
+    for (const char* line = data; line < end; ) {
+        const char* lineEnd = _lineEnd(line, end);
+        if (_splitLine(line, lineEnd, delim, fields)) {
+            const QByteArray name = QByteArray::fromRawData(fields[2].data, fields[2].size);
+            if (!messageMap.contains(name)) {
+                messageMap.insert(QByteArray(fields[2].data, fields[2].size), 0);
+            }
+            quint64 timestamp = _parseTimestamp(fields[0]);
+            if (timestamp < lastTimestamp) {
+                ordered = false;
+            }
+            lastTimestamp = timestamp;
+        }
+        line = lineEnd < end ? lineEnd + 1 : end;
+        currentDataLine.storeRelease(++lineCount);
+    }
+    totalLines.storeRelease(lineCount);
+
+    // Now update each key with its index in the output string. These are
+    // all offset by one to account for the first field: timestamp_ms.
+    QHash<QByteArray, int>  columns;
+    QStringList             headerList;
+    int                     column = 1;
+    for (auto iter = messageMap.begin(); iter != messageMap.end(); ++iter, ++column) {
+        columns.insert(iter.key(), column);
+        headerList.append(QString::fromLocal8Bit(iter.key()));
+    }
+    messageMap.clear();
+
+    QString headerLine = "timestamp_ms" + delimiter + headerList.join(delimiter) + "\n";
     // Clean header names from symbols Matlab considers as Latex syntax
     headerLine = headerLine.replace("timestamp", "TIMESTAMP");
     headerLine = headerLine.replace(":", "");
     headerLine = headerLine.replace("_", "");
     headerLine = headerLine.replace(".", "");
-	outTmpFile.write(headerLine.toLocal8Bit());
-
-    _signalCriticalError(tr("Log compressor: Dataset contains dimensions: ") + headerLine);
-
-    // Template list stores a list for populating with data as it's parsed from messages.
-    QStringList templateList;
-    for (int i = 0; i < headerList.size() + 1; ++i) {
-        templateList << (holeFillingEnabled?"NaN":"");
-    }
-
 
-//	// Reset our position in the input file before we start the main processing loop.
-//    in.seek(0);
+    QByteArray output;
+    output.reserve(_outputBufferSize + 4096);
+    output.append(headerLine.toLocal8Bit());
 
-//    // Search through all lines and build a list of unique timestamps
-//    QMap<quint64, QStringList> timestampMap;
-//    while (!in.atEnd()) {
-//        quint64 timestamp = in.readLine().split(delimiter).at(0).toULongLong();
-//        timestampMap.insert(timestamp, templateList);
-//    }
-
-    // Jump back to start of file
-    in.seek(0);
-
-    // Map of final output lines, key is time
-    QMap<quint64, QStringList> timestampMap;
-
-    // Run through the whole file and fill map of timestamps
-    while (!in.atEnd()) {
-        QStringList newLine = in.readLine().split(delimiter);
-        quint64 timestamp = newLine.at(0).toULongLong();
+    _signalCriticalError(tr("Log compressor: Dataset contains dimensions: ") + headerLine);
 
-        // Check if timestamp does exist - if not, add it
-        if (!timestampMap.contains(timestamp)) {
-            timestampMap.insert(timestamp, templateList);
+    // Out of order logs are written through an index of the lines sorted by timestamp. Lines with the same
+    // timestamp stay in file order, so the last value of a variable still wins.
+    QVector<LineRef_t> lineIndex;
+    if (!ordered) {
+        lineIndex.reserve(lineCount);
+        for (const char* line = data; line < end; ) {
+            const char* lineEnd = _lineEnd(line, end);
+            if (_splitLine(line, lineEnd, delim, fields)) {
+                lineIndex.append({ _parseTimestamp(fields[0]), static_cast<qint64>(line - data) });
+            }
+            line = lineEnd < end ? lineEnd + 1 : end;
         }
-
-        QStringList list = timestampMap.value(timestamp);
-
-        QString currentDataName = newLine.at(2);
-        QString currentDataValue = newLine.at(3);
-        list.replace(messageMap.value(currentDataName), currentDataValue);
-        timestampMap.insert(timestamp, list);
+        std::stable_sort(lineIndex.begin(), lineIndex.end(), [](const LineRef_t& a, const LineRef_t& b) { return a.timestamp < b.timestamp; });
     }
 
-    int lineCounter = 0;
-
-    QStringList lastList = timestampMap.values().at(1);
-
-    foreach (QStringList list, timestampMap.values()) {
-        // Write this current time set out to the file
-        // only do so from the 2nd line on, since the first
-        // line could be incomplete
-        if (lineCounter > 1) {
-            // Set the timestamp
-            list.replace(0,QString("%1").arg(timestampMap.keys().at(lineCounter)));
-
+    // Second pass: all the lines of a timestamp make up one output row. The rows only hold pointers into the mapping.
+    static const char   kNaN[]          = "NaN";
+    const Field_t       templateValue   = { kNaN, holeFillingEnabled ? 3 : 0 };
+    QVector<Field_t>    row             (columns.count() + 1, templateValue);
+    QVector<Field_t>    lastRow;
+    quint64             rowTimestamp    = 0;
+    int                 rowIndex        = -1;
+    bool                writeError      = false;
+
+    auto finishRow = [&]() {
+        // Only write from the 3rd row on, since the first ones could be incomplete
+        if (rowIndex == 1) {
+            lastRow = row;
+        } else if (rowIndex > 1) {
             // Fill holes if necessary
             if (holeFillingEnabled) {
-                int index = 0;
-                foreach (const QString& str, list) {
-                    if (str == "" || str == "NaN") {
-                        list.replace(index, lastList.at(index));
+                for (int i = 1; i < row.count(); i++) {
+                    const Field_t& value = row[i];
+                    if (value.size == 0 || (value.size == 3 && memcmp(value.data, kNaN, 3) == 0)) {
+                        row[i] = lastRow[i];
                     }
-                    index++;
                 }
             }
+            lastRow = row;
 
-            // Set last list
-            lastList = list;
+            output.append(QByteArray::number(rowTimestamp));
+            for (int i = 1; i < row.count(); i++) {
+                output.append(delim);
+                output.append(row[i].data, row[i].size);
+            }
+            output.append('\n');
+            if (output.size() >= _outputBufferSize && !_flushOutput(outTmpFile, output)) {
+                writeError = true;
+            }
+        }
+        row.fill(templateValue);
+    };
 
-            // Write data columns
-            QString output = list.join(delimiter) + "\n";
-            outTmpFile.write(output.toLocal8Bit());
+    auto processLine = [&](const char* line, const char* lineEnd) {
+        if (!_splitLine(line, lineEnd, delim, fields)) {
+            return;
+        }
+        quint64 timestamp = _parseTimestamp(fields[0]);
+        if (rowIndex == -1 || timestamp != rowTimestamp) {
+            if (rowIndex != -1) {
+                finishRow();
+            }
+            rowTimestamp = timestamp;
+            rowIndex++;
+        }
+        row[columns.value(QByteArray::fromRawData(fields[2].data, fields[2].size))] = fields[3];
+    };
+
+    lineCount = 0;
+    if (ordered) {
+        for (const char* line = data; line < end && !writeError; ) {
+            const char* lineEnd = _lineEnd(line, end);
+            processLine(line, lineEnd);
+            line = lineEnd < end ? lineEnd + 1 : end;
+            currentDataLine.storeRelease(++lineCount);
         }
-        lineCounter++;
+    } else {
+        for (const LineRef_t& lineRef: lineIndex) {
+            if (writeError) {
+                break;
+            }
+            const char* line = data + lineRef.offset;
+            processLine(line, _lineEnd(line, end));
+            currentDataLine.storeRelease(++lineCount);
+        }
+    }
+    if (rowIndex != -1 && !writeError) {
+        finishRow();
+    }
+    if (writeError || !_flushOutput(outTmpFile, output)) {
+        return;
     }
 
-	// We're now done with the source file
-	infile.close();
+    // We're now done with the source file, closing it also unmaps it
+    infile.close();
+    outTmpFile.close();
 
-	// Clean up and update the status before we return.
-	currentDataLine = 0;
-	emit finishedFile(outFileName);
-	running = false;
+    // Clean up and update the status before we return.
+    currentDataLine.storeRelease(0);
+    emit finishedFile(outFileName);
+    running = false;
 }
 
 /**
@@ -208,7 +320,12 @@ bool LogCompressor::isFinished()
 
 int LogCompressor::getCurrentLine()
 {
-	return currentDataLine;
+    return currentDataLine.loadAcquire();
+}
+
+int LogCompressor::getTotalLines()
+{
+    return totalLines.loadAcquire();
 }
 
 
@@ -10,11 +10,18 @@
 #pragma once
 
 #include <QThread>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QVector>
+
+class QFile;
 
 /**
  * @file
  *   @brief Declaration of class LogCompressor.
  *          This class reads in a file containing messages and translates it into a tab-delimited CSV file.
+ *          The input is memory mapped and streamed through twice, once to find the columns and once to write the
+ *          rows, so memory use does not grow with the length of the log.
  *   @author Lorenz Meier <mavteam@student.ethz.ch>
  */
 
@@ -28,13 +35,15 @@ public:
     void startCompression(bool holeFilling=false);
     bool isFinished();
     int getCurrentLine();
+    int getTotalLines();            ///< Number of lines in the input, known once the first pass is done
 
 protected:
     void run();                     ///< This function actually performs the compression. It's an overloaded function from QThread
     QString logFileName;            ///< The input file name.
     QString outFileName;            ///< The output file name. If blank defaults to logFileName
     bool running;                   ///< True when the startCompression() function is operating.
-    int currentDataLine;            ///< The current line of data that is being processed. Only relevant when running==true
+    QAtomicInt currentDataLine;     ///< The current line of data that is being processed. Only relevant when running==true
+    QAtomicInt totalLines;          ///< Number of lines in the input, 0 until the first pass is done
     QString delimiter;              ///< Delimiter between fields in the output file. Defaults to tab ('\t')
     bool holeFillingEnabled;        ///< Enables the filling of holes in the dataset with the previous value (or NaN if none exists)
 
@@ -49,6 +58,26 @@ signals:
     void logProcessingCriticalError(const QString& title, const QString& msg);
     
 private:
-    void _signalCriticalError(const QString& msg);
-    
+    /// Field of a line, points into the mapped input
+    typedef struct {
+        const char* data;
+        int         size;
+    } Field_t;
+
+    /// Input line, used to sort the lines by timestamp when the log is out of order
+    typedef struct {
+        quint64     timestamp;
+        qint64      offset;
+    } LineRef_t;
+
+    void    _signalCriticalError    (const QString& msg);
+    bool    _splitLine              (const char* line, const char* lineEnd, const QByteArray& delim, Field_t* fields);
+    bool    _flushOutput            (QFile& outFile, QByteArray& output);
+
+    static const char*  _lineEnd        (const char* line, const char* end);
+    static quint64      _parseTimestamp (const Field_t& field);
+
+    static const int _cFields           = 4;            ///< timestamp, component, name, value
+    static const int _outputBufferSize  = 1024 * 1024;
+
 };
@@ -18,6 +18,9 @@ QGC_LOGGING_CATEGORY(MicrohardLog,     "MicrohardLog")
 MicrohardHandler::MicrohardHandler(QObject* parent)
     : QObject (parent)
 {
+    _connectTimer.setSingleShot(true);
+    _connectTimer.setInterval(_connectTimeoutMSecs);
+    connect(&_connectTimer, &QTimer::timeout, this, &MicrohardHandler::_testConnection);
 }
 
 //-----------------------------------------------------------------------------
@@ -31,8 +34,11 @@ bool
 MicrohardHandler::close()
 {
     bool res = false;
+    _connectTimer.stop();
     if(_tcpSocket) {
         qCDebug(MicrohardLog) << "Close Microhard TCP socket on port" << _tcpSocket->localPort();
+        // Closing on purpose is not a lost connection
+        QObject::disconnect(_tcpSocket, nullptr, this, nullptr);
         _tcpSocket->close();
         _tcpSocket->deleteLater();
         _tcpSocket = nullptr;
@@ -47,10 +53,13 @@ MicrohardHandler::_start(uint16_t port, QHostAddress addr)
 {
     close();
     _tcpSocket = new QTcpSocket();
-    QObject::connect(_tcpSocket, &QIODevice::readyRead, this, &MicrohardHandler::_readBytes);
+    _tcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    QObject::connect(_tcpSocket, &QIODevice::readyRead,            this, &MicrohardHandler::_readBytes);
+    QObject::connect(_tcpSocket, &QAbstractSocket::connected,      this, &MicrohardHandler::_socketConnected);
+    QObject::connect(_tcpSocket, &QAbstractSocket::disconnected,   this, &MicrohardHandler::_socketDisconnected);
     qCDebug(MicrohardLog) << "Connecting to" << addr;
     _tcpSocket->connectToHost(addr, port);
-    QTimer::singleShot(1000, this, &MicrohardHandler::_testConnection);
+    _connectTimer.start();
 }
 
 //-----------------------------------------------------------------------------
@@ -66,3 +75,20 @@ MicrohardHandler::_testConnection()
         close();
     }
 }
+
+//-----------------------------------------------------------------------------
+void
+MicrohardHandler::_socketConnected()
+{
+    _connectTimer.stop();
+    qCDebug(MicrohardLog) << "Connected";
+}
+
+//-----------------------------------------------------------------------------
+void
+MicrohardHandler::_socketDisconnected()
+{
+    qCDebug(MicrohardLog) << "Microhard TCP connection closed by radio";
+    close();
+    emit connected(0);
+}
@@ -13,11 +13,14 @@
 
 #include <QHostAddress>
 #include <QTcpSocket>
+#include <QTimer>
 
 #define MICROHARD_SETTINGS_PORT   23
 
 Q_DECLARE_LOGGING_CATEGORY(MicrohardLog)
 
+/// Telnet style session with a Microhard radio. The socket stays open for as long as the radio answers, connection
+/// state is reported from the socket signals as it changes.
 class MicrohardHandler : public QObject
 {
     Q_OBJECT
@@ -34,6 +37,8 @@ protected:
 protected slots:
     virtual void    _readBytes          () = 0;
     virtual void    _testConnection     ();
+    virtual void    _socketConnected    ();
+    virtual void    _socketDisconnected ();
 
 signals:
     void connected                      (int status);
@@ -41,4 +46,7 @@ signals:
 
 protected:
     QTcpSocket*     _tcpSocket  = nullptr;
+    QTimer          _connectTimer;                  ///< Gives up on a radio which doesn't answer the connect
+
+    static const int _connectTimeoutMSecs = 2000;
 };
@@ -25,6 +25,9 @@ static const char *kNET_MASK            = "NetMask";
 static const char *kCFG_USERNAME        = "ConfigUserName";
 static const char *kCFG_PASSWORD        = "ConfigPassword";
 static const char *kENC_KEY             = "EncryptionKey";
+static const char *kSTATUS_INTERVAL     = "StatusInterval";
+
+static const int kMinStatusInterval     = 100;
 
 //-----------------------------------------------------------------------------
 MicrohardManager::MicrohardManager(QGCApplication* app, QGCToolbox* toolbox)
@@ -42,6 +45,7 @@ MicrohardManager::MicrohardManager(QGCApplication* app, QGCToolbox* toolbox)
     _configUserName = settings.value(kCFG_USERNAME,   QString("admin")).toString();
     _configPassword = settings.value(kCFG_PASSWORD,   QString("admin")).toString();
     _encryptionKey  = settings.value(kENC_KEY,        QString("1234567890")).toString();
+    _statusInterval = qMax(settings.value(kSTATUS_INTERVAL, _statusInterval).toInt(), kMinStatusInterval);
     settings.endGroup();
 }
 
@@ -177,6 +181,57 @@ MicrohardManager::setIPSettings(QString localIP_, QString remoteIP_, QString net
     return false;
 }
 
+//-----------------------------------------------------------------------------
+void
+MicrohardManager::setStatusInterval(int msecs)
+{
+    msecs = qMax(msecs, kMinStatusInterval);
+    if (msecs != _statusInterval) {
+        _statusInterval = msecs;
+        QSettings settings;
+        settings.beginGroup(kMICROHARD_GROUP);
+        settings.setValue(kSTATUS_INTERVAL, _statusInterval);
+        settings.endGroup();
+        if (_mhSettingsLoc) {
+            _mhSettingsLoc->setStatusInterval(_statusInterval);
+        }
+        if (_mhSettingsRem) {
+            _mhSettingsRem->setStatusInterval(_statusInterval);
+        }
+        emit statusIntervalChanged();
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// A radio is considered gone after missing a few status replies in a row
+int
+MicrohardManager::_statusTimeout() const
+{
+    return qMax(LONG_TIMEOUT, 3 * _statusInterval);
+}
+
+//-----------------------------------------------------------------------------
+QVariantList
+MicrohardManager::statusHistory(bool air, int maxCount)
+{
+    QVariantList list;
+    const MicrohardSettings* radio = air ? _mhSettingsRem : _mhSettingsLoc;
+    if (radio) {
+        const int count = qMin(maxCount, radio->historyCount());
+        const int first = radio->historyCount() - count;
+        list.reserve(count);
+        for (int i = first; i < radio->historyCount(); i++) {
+            const MicrohardSettings::Status_t& status = radio->historyAt(i);
+            QVariantMap map;
+            map[QStringLiteral("time")] = status.msecs;
+            map[QStringLiteral("rssi")] = status.rssi;
+            map[QStringLiteral("snr")]  = status.snr;
+            list.append(map);
+        }
+    }
+    return list;
+}
+
 //-----------------------------------------------------------------------------
 void
 MicrohardManager::_setEnabled()
@@ -185,13 +240,15 @@ MicrohardManager::_setEnabled()
     if(enable) {
         if(!_mhSettingsLoc) {
             _mhSettingsLoc = new MicrohardSettings(localIPAddr(), this, true);
+            _mhSettingsLoc->setStatusInterval(_statusInterval);
             connect(_mhSettingsLoc, &MicrohardSettings::connected,      this, &MicrohardManager::_connectedLoc);
-            connect(_mhSettingsLoc, &MicrohardSettings::rssiUpdated,    this, &MicrohardManager::_rssiUpdatedLoc);
+            connect(_mhSettingsLoc, &MicrohardSettings::statusUpdated,  this, &MicrohardManager::_statusUpdatedLoc);
         }
         if(!_mhSettingsRem) {
             _mhSettingsRem = new MicrohardSettings(remoteIPAddr(), this);
+            _mhSettingsRem->setStatusInterval(_statusInterval);
             connect(_mhSettingsRem, &MicrohardSettings::connected,      this, &MicrohardManager::_connectedRem);
-            connect(_mhSettingsRem, &MicrohardSettings::rssiUpdated,    this, &MicrohardManager::_rssiUpdatedRem);
+            connect(_mhSettingsRem, &MicrohardSettings::statusUpdated,  this, &MicrohardManager::_statusUpdatedRem);
         }
         _workTimer.start(SHORT_TIMEOUT);
     } else {
@@ -213,7 +270,7 @@ MicrohardManager::_connectedLoc(int status)
     else
         qCDebug(MicrohardLog) << msg << "Not Connected";
     _connectedStatus = status;
-    _locTimer.start(LONG_TIMEOUT);
+    _locTimer.start(_statusTimeout());
     emit connectedChanged();
 }
 
@@ -229,30 +286,28 @@ MicrohardManager::_connectedRem(int status)
     else
         qCDebug(MicrohardLog) << msg << "Not Connected";
     _linkConnectedStatus = status;
-    _remTimer.start(LONG_TIMEOUT);
+    _remTimer.start(_statusTimeout());
     emit linkConnectedChanged();
 }
 
 //-----------------------------------------------------------------------------
 void
-MicrohardManager::_rssiUpdatedLoc(int rssi)
+MicrohardManager::_statusUpdatedLoc(int rssi, int snr)
 {
     _downlinkRSSI = rssi;
-    _locTimer.stop();
-    _locTimer.start(LONG_TIMEOUT);
-    emit connectedChanged();
+    _locTimer.start(_statusTimeout());
     emit linkChanged();
+    emit statusUpdated(false, rssi, snr);
 }
 
 //-----------------------------------------------------------------------------
 void
-MicrohardManager::_rssiUpdatedRem(int rssi)
+MicrohardManager::_statusUpdatedRem(int rssi, int snr)
 {
     _uplinkRSSI = rssi;
-    _remTimer.stop();
-    _remTimer.start(LONG_TIMEOUT);
-    emit linkConnectedChanged();
+    _remTimer.start(_statusTimeout());
     emit linkChanged();
+    emit statusUpdated(true, rssi, snr);
 }
 
 //-----------------------------------------------------------------------------
@@ -293,15 +348,12 @@ MicrohardManager::_checkMicrohard()
             return;
         }
 
+        //-- Connected radios keep their session open and poll status themselves
         if(_connectedStatus <= 0) {
             _mhSettingsLoc->start();
-        } else {
-            _mhSettingsLoc->getStatus();
         }
         if(_linkConnectedStatus <= 0) {
             _mhSettingsRem->start();
-        } else {
-            _mhSettingsRem->getStatus();
         }
     }
     _workTimer.start(_connectedStatus > 0 ? SHORT_TIMEOUT : LONG_TIMEOUT);
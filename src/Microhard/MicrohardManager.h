@@ -36,9 +36,13 @@ public:
     Q_PROPERTY(QString      configUserName      READ configUserName                             NOTIFY configUserNameChanged)
     Q_PROPERTY(QString      configPassword      READ configPassword                             NOTIFY configPasswordChanged)
     Q_PROPERTY(QString      encryptionKey       READ encryptionKey                              NOTIFY encryptionKeyChanged)
+    Q_PROPERTY(int          statusInterval      READ statusInterval   WRITE setStatusInterval   NOTIFY statusIntervalChanged)   ///< msecs between status queries to each radio
 
     Q_INVOKABLE bool setIPSettings              (QString localIP, QString remoteIP, QString netMask, QString cfgUserName, QString cfgPassword, QString encyrptionKey);
 
+    /// Status history of the ground (air = false) or air radio, oldest first, as { time, rssi, snr } maps
+    Q_INVOKABLE QVariantList statusHistory      (bool air, int maxCount = MicrohardSettings::historySize);
+
     explicit MicrohardManager                   (QGCApplication* app, QGCToolbox* toolbox);
     ~MicrohardManager                           () override;
 
@@ -54,12 +58,18 @@ public:
     QString     configUserName                  () { return _configUserName; }
     QString     configPassword                  () { return _configPassword; }
     QString     encryptionKey                   () { return _encryptionKey; }
+    int         statusInterval                  () { return _statusInterval; }
+
+    /// nullptr while the radio isn't connected
+    const MicrohardSettings* groundRadio        () const { return _mhSettingsLoc; }
+    const MicrohardSettings* airRadio           () const { return _mhSettingsRem; }
 
     void        setLocalIPAddr                  (QString val) { _localIPAddr = val; emit localIPAddrChanged(); }
     void        setRemoteIPAddr                 (QString val) { _remoteIPAddr = val; emit remoteIPAddrChanged(); }
     void        setConfigUserName               (QString val) { _configUserName = val; emit configUserNameChanged(); }
     void        setConfigPassword               (QString val) { _configPassword = val; emit configPasswordChanged(); }
     void        setEncryptionKey                (QString val) { _encryptionKey = val; emit encryptionKeyChanged(); }
+    void        setStatusInterval               (int msecs);
     void        updateSettings                  ();
     void        setEncryptionKey                ();
     void        switchToPairingEncryptionKey    ();
@@ -75,12 +85,14 @@ signals:
     void    configUserNameChanged           ();
     void    configPasswordChanged           ();
     void    encryptionKeyChanged            ();
+    void    statusIntervalChanged           ();
+    void    statusUpdated                   (bool air, int rssi, int snr);
 
 private slots:
     void    _connectedLoc                   (int status);
-    void    _rssiUpdatedLoc                 (int rssi);
+    void    _statusUpdatedLoc               (int rssi, int snr);
     void    _connectedRem                   (int status);
-    void    _rssiUpdatedRem                 (int rssi);
+    void    _statusUpdatedRem               (int rssi, int snr);
     void    _checkMicrohard                 ();
     void    _setEnabled                     ();
     void    _locTimeout                     ();
@@ -90,6 +102,7 @@ private:
     void    _close                          ();
     void    _reset                          ();
     FactMetaData *_createMetadata           (const char *name, QStringList enums);
+    int     _statusTimeout                  () const;
 
 private:
     int                _connectedStatus = 0;
@@ -111,5 +124,6 @@ private:
     QString            _encryptionKey;
     bool               _useCommunicationEncryptionKey = false;
     QString            _communicationEncryptionKey;
+    int                _statusInterval = 1000;
     QTime              _timeoutTimer;
 };
@@ -13,12 +13,17 @@
 #include "QGCApplication.h"
 #include "VideoManager.h"
 
+#include <QDateTime>
+
 //-----------------------------------------------------------------------------
 MicrohardSettings::MicrohardSettings(QString address_, QObject* parent, bool setEncryptionKey)
     : MicrohardHandler(parent)
 {
     _address = address_;
     _setEncryptionKey = setEncryptionKey;
+    _history.resize(historySize);
+    _statusTimer.setInterval(1000);
+    connect(&_statusTimer, &QTimer::timeout, this, &MicrohardSettings::getStatus);
 }
 
 //-----------------------------------------------------------------------------
@@ -27,16 +32,36 @@ MicrohardSettings::start()
 {
     qCDebug(MicrohardLog) << "Start Microhard Settings";
     _loggedIn = false;
+    _pendingQueries = 0;
+    _readBuffer.clear();
     _start(MICROHARD_SETTINGS_PORT, QHostAddress(_address));
     return true;
 }
 
+//-----------------------------------------------------------------------------
+bool
+MicrohardSettings::close()
+{
+    _statusTimer.stop();
+    _loggedIn = false;
+    return MicrohardHandler::close();
+}
+
+//-----------------------------------------------------------------------------
+void
+MicrohardSettings::setStatusInterval(int msecs)
+{
+    _statusTimer.setInterval(msecs);
+}
+
 //-----------------------------------------------------------------------------
 void
 MicrohardSettings::getStatus()
 {
-    if (_loggedIn && _tcpSocket) {
+    // Queries go out at the set rate without waiting for the previous reply, unless the radio falls behind
+    if (_loggedIn && _tcpSocket && _pendingQueries < _maxPendingQueries) {
         _tcpSocket->write("AT+MWSTATUS\n");
+        _pendingQueries++;
     }
 }
 
@@ -55,6 +80,68 @@ MicrohardSettings::setEncryptionKey(QString key)
     qCDebug(MicrohardLog) << "Set encryption key: " << key;
 }
 
+//-----------------------------------------------------------------------------
+const MicrohardSettings::Status_t&
+MicrohardSettings::historyAt(int index) const
+{
+    return _history[(_historyHead - _historyCount + index + historySize) % historySize];
+}
+
+//-----------------------------------------------------------------------------
+void
+MicrohardSettings::_appendHistory()
+{
+    Status_t& status = _history[_historyHead];
+    status.msecs = QDateTime::currentMSecsSinceEpoch();
+    status.rssi  = _rssiVal;
+    status.snr   = _snrVal;
+    _historyHead = (_historyHead + 1) % historySize;
+    _historyCount = qMin(_historyCount + 1, static_cast<int>(historySize));
+}
+
+//-----------------------------------------------------------------------------
+/// Parses "<key> : <value> ..." as the radio prints it in the status reply
+bool
+MicrohardSettings::_statusValue(const QByteArray& line, const char* key, int& value)
+{
+    int i1 = line.indexOf(key);
+    if (i1 < 0) {
+        return false;
+    }
+    int i2 = line.indexOf(": ", i1);
+    if (i2 < 0) {
+        return false;
+    }
+    i2 += 2;
+    int i3 = line.indexOf(" ", i2);
+    bool ok;
+    int val = line.mid(i2, i3 < 0 ? -1 : i3 - i2).toInt(&ok);
+    if (ok) {
+        value = val;
+    }
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+void
+MicrohardSettings::_parseStatusLine(const QByteArray& line)
+{
+    int val;
+    if (_statusValue(line, "RSSI (dBm)", val)) {
+        if (val < 0) {
+            _rssiVal = val;
+        }
+    } else if (_statusValue(line, "SNR (dB)", val)) {
+        _snrVal = val;
+    } else if (line == "OK" && _pendingQueries > 0) {
+        // End of a status reply
+        _pendingQueries--;
+        _appendHistory();
+        emit statusUpdated(_rssiVal, _snrVal);
+        emit rssiUpdated(_rssiVal);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MicrohardSettings::_readBytes()
@@ -62,39 +149,46 @@ MicrohardSettings::_readBytes()
     if (!_tcpSocket) {
         return;
     }
-    QByteArray bytesIn = _tcpSocket->read(_tcpSocket->bytesAvailable());
+    _readBuffer.append(_tcpSocket->readAll());
 
-    //qCDebug(MicrohardLog) << "Read bytes: " << bytesIn;
+    //qCDebug(MicrohardLog) << "Read bytes: " << _readBuffer;
 
     if (_loggedIn) {
-        int i1 = bytesIn.indexOf("RSSI (dBm)");
-        if (i1 > 0) {
-            int i2 = bytesIn.indexOf(": ", i1);
-            if (i2 > 0) {
-                i2 += 2;
-                int i3 = bytesIn.indexOf(" ", i2);
-                int val = bytesIn.mid(i2, i3 - i2).toInt();
-                if (val < 0) {
-                    _rssiVal = val;
-                }
-            }
+        int start = 0;
+        int end;
+        while ((end = _readBuffer.indexOf('\n', start)) >= 0) {
+            _parseStatusLine(_readBuffer.mid(start, end - start).trimmed());
+            start = end + 1;
+        }
+        _readBuffer.remove(0, start);
+        if (_readBuffer.length() > _maxLineLength) {
+            _readBuffer.clear();
         }
-    } else if (bytesIn.contains("login:")) {
+        return;
+    }
+
+    // Login prompts don't end in a newline, so they are looked for in whatever has come in so far
+    if (_readBuffer.contains("login:")) {
         std::string userName = qgcApp()->toolbox()->microhardManager()->configUserName().toStdString() + "\n";
         _tcpSocket->write(userName.c_str());
-    } else if (bytesIn.contains("Password:")) {
+        _readBuffer.clear();
+    } else if (_readBuffer.contains("Password:")) {
         std::string pwd = qgcApp()->toolbox()->microhardManager()->configPassword().toStdString() + "\n";
         _tcpSocket->write(pwd.c_str());
-    } else if (bytesIn.contains("Login incorrect")) {
+        _readBuffer.clear();
+    } else if (_readBuffer.contains("Login incorrect")) {
+        _readBuffer.clear();
         emit connected(-1);
-    } else if (bytesIn.contains("Entering")) {
-        if (!loggedIn() && _setEncryptionKey) {
+    } else if (_readBuffer.contains("Entering")) {
+        _readBuffer.clear();
+        if (_setEncryptionKey) {
             qgcApp()->toolbox()->microhardManager()->setEncryptionKey();
         }
         _loggedIn = true;
+        _statusTimer.start();
         emit connected(1);
+        getStatus();
+    } else if (_readBuffer.length() > _maxLineLength) {
+        _readBuffer.clear();
     }
-
-    emit rssiUpdated(_rssiVal);
 }
-
@@ -11,25 +11,60 @@
 
 #include "MicrohardHandler.h"
 
+#include <QVector>
+
 class MicrohardSettings : public MicrohardHandler
 {
     Q_OBJECT
 public:
+    typedef struct {
+        qint64  msecs;                              ///< QDateTime::currentMSecsSinceEpoch when the status came in
+        int     rssi;                               ///< dBm
+        int     snr;                                ///< dB, 0 if the radio didn't report it
+    } Status_t;
+
     explicit MicrohardSettings          (QString address, QObject* parent = nullptr, bool setEncryptionKey = false);
     bool    start                       () override;
+    bool    close                       () override;
     void    getStatus                   ();
     void    setEncryptionKey            (QString key);
     bool    loggedIn                    () { return _loggedIn; }
 
+    /// Status is queried every statusInterval msecs for as long as the session is logged in
+    int     statusInterval              () const { return _statusTimer.interval(); }
+    void    setStatusInterval           (int msecs);
+
+    /// Status history, oldest first. Holds the last historySize replies.
+    int             historyCount        () const { return _historyCount; }
+    const Status_t& historyAt           (int index) const;
+
+    static const int historySize = 600;
+
 protected slots:
     void    _readBytes                  () override;
 
 signals:
     void    updateRSSI                  (int rssi);
+    void    statusUpdated               (int rssi, int snr);
 
 private:
-    bool    _loggedIn;
-    int     _rssiVal;
-    QString _address;
-    bool    _setEncryptionKey;
+    void    _parseStatusLine            (const QByteArray& line);
+    void    _appendHistory              ();
+
+    static bool _statusValue            (const QByteArray& line, const char* key, int& value);
+
+    bool                _loggedIn           = false;
+    int                 _rssiVal            = 0;
+    int                 _snrVal             = 0;
+    QString             _address;
+    bool                _setEncryptionKey;
+    QByteArray          _readBuffer;                    ///< Partial line left over from the previous read
+    QTimer              _statusTimer;
+    int                 _pendingQueries     = 0;        ///< Status queries sent whose OK hasn't come back yet
+    QVector<Status_t>   _history;                       ///< Ring buffer
+    int                 _historyHead        = 0;        ///< Where the next status goes
+    int                 _historyCount       = 0;
+
+    static const int _maxPendingQueries = 2;            ///< A slow radio gets at most this many queries queued up
+    static const int _maxLineLength     = 4096;
 };
@@ -111,28 +111,41 @@ QJsonObject ComplexMissionItem::_loadPresetJson(const QString& name)
     return QCborValue(settings.value(name).toByteArray()).toMap().toJsonObject();
 }
 
-void ComplexMissionItem::addKMLVisuals(KMLPlanDomDocument& /* domDocument */)
+void ComplexMissionItem::addKMLVisuals(KMLPlanWriter& /* planKML */)
 {
     // Default implementation has no visuals
 }
 
 void ComplexMissionItem::_appendFlightPathSegment(const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt)
+{
+    _flightPathSegments.append(_createFlightPathSegment(coord1, coord1AMSLAlt, coord2, coord2AMSLAlt));
+}
+
+/// Creates a segment which is hooked up for terrain collision but isn't in _flightPathSegments yet
+FlightPathSegment* ComplexMissionItem::_createFlightPathSegment(const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt)
 {
     FlightPathSegment* segment = new FlightPathSegment(coord1, coord1AMSLAlt, coord2, coord2AMSLAlt, true /* queryTerrainData */, this /* parent */);
 
-    connect(segment, &FlightPathSegment::terrainCollisionChanged,       this,               &ComplexMissionItem::_segmentTerrainCollisionChanged);
-    connect(segment, &FlightPathSegment::terrainCollisionChanged,       _missionController, &MissionController::recalcTerrainProfile, Qt::QueuedConnection);
-    connect(segment, &FlightPathSegment::amslTerrainHeightsChanged,     _missionController, &MissionController::recalcTerrainProfile, Qt::QueuedConnection);
+    // Terrain profile updates reach the mission controller as a batch through TerrainCollisionEngine
+    connect(segment, &FlightPathSegment::terrainCollisionChanged, this, &ComplexMissionItem::_segmentTerrainCollisionChanged);
 
-    // Signals may have been emitted in contructor so we need to deal with that now since they were missed
+    return segment;
+}
 
-    _flightPathSegments.append(segment);
-    if (segment->terrainCollision()) {
-        emit _segmentTerrainCollisionChanged(true);
+/// Removes and deletes a range of segments, keeping _cTerrainCollisionSegments in step. It is up to the caller to signal
+/// terrainCollisionChanged once it is done changing segments.
+void ComplexMissionItem::_removeFlightPathSegments(int first, int count)
+{
+    if (count < 1) {
+        return;
     }
-
-    if (segment->amslTerrainHeights().count()) {
-        _missionController->recalcTerrainProfile();
+    for (QObject* object: _flightPathSegments.removeRange(first, count)) {
+        FlightPathSegment* segment = qobject_cast<FlightPathSegment*>(object);
+        disconnect(segment, &FlightPathSegment::terrainCollisionChanged, this, &ComplexMissionItem::_segmentTerrainCollisionChanged);
+        if (segment->terrainCollision()) {
+            _cTerrainCollisionSegments--;
+        }
+        segment->deleteLater();
     }
 }
 
@@ -13,13 +13,14 @@
 #include "QGCGeo.h"
 #include "QGCToolbox.h"
 #include "SettingsManager.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanWriter.h"
 #include "QmlObjectListModel.h"
 
 #include <QSettings>
 
 class PlanMasterController;
 class MissionController;
+class FlightPathSegment;
 
 class ComplexMissionItem : public VisualMissionItem
 {
@@ -93,7 +94,7 @@ public:
     ///     Empty string signals no support for presets.
     virtual QString presetsSettingsGroup(void) { return QString(); }
 
-    virtual void addKMLVisuals(KMLPlanDomDocument& domDocument);
+    virtual void addKMLVisuals(KMLPlanWriter& planKML);
 
     bool presetsSupported   (void) { return !presetsSettingsGroup().isEmpty(); }
     bool isIncomplete       (void) const { return _isIncomplete; }
@@ -118,6 +119,8 @@ protected:
     void        _savePresetJson         (const QString& name, QJsonObject& presetObject);
     QJsonObject _loadPresetJson         (const QString& name);
     void        _appendFlightPathSegment(const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt);
+    FlightPathSegment* _createFlightPathSegment(const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt);
+    void        _removeFlightPathSegments(int first, int count);
 
     bool                _isIncomplete =                 true;
     int                 _cTerrainCollisionSegments =    0;
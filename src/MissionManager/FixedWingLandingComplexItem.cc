@@ -138,9 +138,17 @@ void FixedWingLandingComplexItem::moveLandingPosition(const QGeoCoordinate& coor
     double savedHeading = landingHeading()->rawValue().toDouble();
     double savedDistance = landingDistance()->rawValue().toDouble();
 
+    // Called on every mouse move while dragging. Moving the landing point and then putting heading and distance back
+    // would recalculate the pattern three times, just recalculate it once from the saved heading and distance.
+    bool landingCoordSet = _landingCoordSet;
+    _ignoreRecalcSignals = true;
     setLandingCoordinate(coordinate);
     landingHeading()->setRawValue(savedHeading);
     landingDistance()->setRawValue(savedDistance);
+    _ignoreRecalcSignals = false;
+    if (landingCoordSet) {
+        _recalcFromHeadingAndDistanceChange();
+    }
 }
 
 bool FixedWingLandingComplexItem::_isValidLandItem(const MissionItem& missionItem)
@@ -490,6 +490,52 @@ void GeoFenceController::clearAllInteractive(void)
     }
 }
 
+bool GeoFenceController::coordinateInsideFence(const QGeoCoordinate& coordinate)
+{
+    return coordinatesInsideFence({ coordinate }).first();
+}
+
+QList<bool> GeoFenceController::coordinatesInsideFence(const QList<QGeoCoordinate>& coordinates)
+{
+    const int       cCoordinates    = coordinates.count();
+    bool            hasInclusion    = false;
+    QVector<bool>   inInclusion     (cCoordinates, false);
+    QVector<bool>   inExclusion     (cCoordinates, false);
+
+    // Each polygon tests the whole list against its own cached index
+    for (int i=0; i<_polygons.count(); i++) {
+        QGCFencePolygon*    polygon     = _polygons.value<QGCFencePolygon*>(i);
+        const QList<bool>   contains    = polygon->containsCoordinates(coordinates);
+        QVector<bool>&      inFence     = polygon->inclusion() ? inInclusion : inExclusion;
+
+        hasInclusion |= polygon->inclusion();
+        for (int j=0; j<cCoordinates; j++) {
+            inFence[j] = inFence[j] || contains[j];
+        }
+    }
+
+    for (int i=0; i<_circles.count(); i++) {
+        QGCFenceCircle*     circle      = _circles.value<QGCFenceCircle*>(i);
+        const QGeoCoordinate center     = circle->center();
+        const double        radius      = circle->radius()->rawValue().toDouble();
+        QVector<bool>&      inFence     = circle->inclusion() ? inInclusion : inExclusion;
+
+        hasInclusion |= circle->inclusion();
+        for (int j=0; j<cCoordinates; j++) {
+            if (!inFence[j] && center.distanceTo(coordinates[j]) <= radius) {
+                inFence[j] = true;
+            }
+        }
+    }
+
+    QList<bool> inside;
+    inside.reserve(cCoordinates);
+    for (int j=0; j<cCoordinates; j++) {
+        inside.append((!hasInclusion || inInclusion[j]) && !inExclusion[j]);
+    }
+    return inside;
+}
+
 bool GeoFenceController::supported(void) const
 {
     return (_managerVehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_MISSION_FENCE) && (_managerVehicle->maxProtoVersion() >= 200);
@@ -59,6 +59,14 @@ public:
     /// Clears the interactive bit from all fence items
     Q_INVOKABLE void clearAllInteractive(void);
 
+    /// Checks the coordinate against the fence the way the vehicle does. It has to be inside of one of the inclusion
+    /// polygons or circles, if there are any, and outside of all of the exclusion ones.
+    Q_INVOKABLE bool coordinateInsideFence(const QGeoCoordinate& coordinate);
+
+    /// Checks a whole list of coordinates, for example a flight path, against the fence
+    /// @return Whether each coordinate is inside the fence
+    QList<bool> coordinatesInsideFence(const QList<QGeoCoordinate>& coordinates);
+
     double  paramCircularFence  (void);
     Fact*   breachReturnAltitude(void) { return &_breachReturnAltitudeFact; }
 
@@ -0,0 +1,303 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "KMLPlanWriter.h"
+#include "QGCPalette.h"
+#include "QGCApplication.h"
+#include "MissionCommandTree.h"
+#include "MissionCommandUIInfo.h"
+#include "FactMetaData.h"
+#include "ComplexMissionItem.h"
+#include "QmlObjectListModel.h"
+
+#include <QXmlStreamWriter>
+
+const char* KMLPlanWriter::_balloonStyleName =          "BalloonStyle";
+const char* KMLPlanWriter::_missionLineStyleName =      "MissionLineStyle";
+const char* KMLPlanWriter::_surveyPolygonStyleName =    "SurveyPolygonStyle";
+
+KMLPlanWriter::KMLPlanWriter(void)
+    : _name(QStringLiteral("%1 Plan KML").arg(qgcApp()->applicationName()))
+{
+    QGCPalette palette;
+
+    _missionLineColor   = _kmlColorString(palette.mapMissionTrajectory());
+    _surveyPolygonColor = _kmlColorString(palette.surveyPolygonInterior(), 0.5 /* opacity */);
+}
+
+void KMLPlanWriter::addMission(Vehicle* vehicle, QmlObjectListModel* visualItems, QList<MissionItem*> rgMissionItems)
+{
+    _addFlightPath(vehicle, rgMissionItems);
+    _addComplexItems(visualItems);
+}
+
+void KMLPlanWriter::addPolygon(const QString& name, const QList<QGeoCoordinate>& polygon)
+{
+    if (!polygon.isEmpty()) {
+        _polygons.append({ name, polygon });
+    }
+}
+
+void KMLPlanWriter::_addFlightPath(Vehicle* vehicle, QList<MissionItem*> rgMissionItems)
+{
+    if (rgMissionItems.count() == 0) {
+        return;
+    }
+
+    _hasFlightPath  = true;
+    _lookAtCoord    = rgMissionItems[0]->coordinate();
+
+    QString altUnits    = FactMetaData::appSettingsHorizontalDistanceUnitsString();
+    QGeoCoordinate homeCoord = rgMissionItems[0]->coordinate();
+    for (const MissionItem* item : rgMissionItems) {
+        const MissionCommandUIInfo* uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(vehicle, QGCMAVLink::VehicleClassGeneric, item->command());
+        if (uiInfo) {
+            double altAdjustment = item->frame() == MAV_FRAME_GLOBAL ? 0 : homeCoord.altitude(); // Used to convert to amsl
+            if (uiInfo->isTakeoffCommand() && !vehicle->fixedWing()) {
+                // These takeoff items go straight up from home position to specified altitude
+                QGeoCoordinate coord = homeCoord;
+                coord.setAltitude(item->param7() + altAdjustment);
+                _flightPath += coord;
+            }
+            if (uiInfo->specifiesCoordinate()) {
+                QGeoCoordinate coord = item->coordinate();
+                coord.setAltitude(coord.altitude() + altAdjustment); // convert to amsl
+
+                if (!uiInfo->isStandaloneCoordinate()) {
+                    // Flight path goes through this item
+                    _flightPath += coord;
+                }
+
+                // Add a place mark for each WP
+                Waypoint_t waypoint;
+                waypoint.name   = QStringLiteral("%1 %2").arg(QString::number(item->sequenceNumber())).arg(item->command() == MAV_CMD_NAV_WAYPOINT ? "" : uiInfo->friendlyName());
+                waypoint.coord  = coord;
+
+                // Unit conversion needs the settings, so this is put together here rather than in write
+                QString& htmlString = waypoint.description;
+                htmlString += QStringLiteral("Index: %1\n").arg(item->sequenceNumber());
+                htmlString += uiInfo->friendlyName() + "\n";
+                htmlString += QStringLiteral("Alt AMSL: %1 %2\n").arg(_fixedString(FactMetaData::metersToAppSettingsHorizontalDistanceUnits(coord.altitude()).toDouble(), 2)).arg(altUnits);
+                htmlString += QStringLiteral("Alt Rel: %1 %2\n").arg(_fixedString(FactMetaData::metersToAppSettingsHorizontalDistanceUnits(coord.altitude() - homeCoord.altitude()).toDouble(), 2)).arg(altUnits);
+                htmlString += QStringLiteral("Lat: %1\n").arg(_fixedString(coord.latitude(), 7));
+                htmlString += QStringLiteral("Lon: %1\n").arg(_fixedString(coord.longitude(), 7));
+
+                _waypoints.append(waypoint);
+            }
+        }
+    }
+}
+
+void KMLPlanWriter::_addComplexItems(QmlObjectListModel* visualItems)
+{
+    for (int i=0; i<visualItems->count(); i++) {
+        ComplexMissionItem* complexItem = visualItems->value<ComplexMissionItem*>(i);
+        if (complexItem) {
+            complexItem->addKMLVisuals(*this);
+        }
+    }
+}
+
+bool KMLPlanWriter::write(QIODevice& device) const
+{
+    QXmlStreamWriter xml(&device);
+    xml.setAutoFormatting(true);
+
+    xml.writeStartDocument();
+    xml.writeStartElement(QStringLiteral("kml"));
+    xml.writeDefaultNamespace(QStringLiteral("http://www.opengis.net/kml/2.2"));
+    xml.writeStartElement(QStringLiteral("Document"));
+    xml.writeTextElement(QStringLiteral("name"), _name);
+    xml.writeTextElement(QStringLiteral("open"), QStringLiteral("1"));
+
+    _writeStyles(xml);
+    _writeFlightPath(xml);
+    _writePolygons(xml);
+
+    xml.writeEndElement(); // Document
+    xml.writeEndElement(); // kml
+    xml.writeEndDocument();
+
+    return !xml.hasError();
+}
+
+void KMLPlanWriter::_writeStyles(QXmlStreamWriter& xml) const
+{
+    xml.writeStartElement(QStringLiteral("Style"));
+    xml.writeAttribute(QStringLiteral("id"), _balloonStyleName);
+    xml.writeStartElement(QStringLiteral("BalloonStyle"));
+    xml.writeTextElement(QStringLiteral("text"), QStringLiteral("$[description]"));
+    xml.writeEndElement();
+    xml.writeEndElement();
+
+    xml.writeStartElement(QStringLiteral("Style"));
+    xml.writeAttribute(QStringLiteral("id"), _missionLineStyleName);
+    xml.writeStartElement(QStringLiteral("LineStyle"));
+    xml.writeTextElement(QStringLiteral("color"), _missionLineColor);
+    xml.writeTextElement(QStringLiteral("width"), QStringLiteral("4"));
+    xml.writeEndElement();
+    xml.writeEndElement();
+
+    xml.writeStartElement(QStringLiteral("Style"));
+    xml.writeAttribute(QStringLiteral("id"), _surveyPolygonStyleName);
+    xml.writeStartElement(QStringLiteral("PolyStyle"));
+    xml.writeTextElement(QStringLiteral("color"), _surveyPolygonColor);
+    xml.writeEndElement();
+    xml.writeStartElement(QStringLiteral("LineStyle"));
+    xml.writeTextElement(QStringLiteral("color"), _surveyPolygonColor);
+    xml.writeEndElement();
+    xml.writeEndElement();
+}
+
+void KMLPlanWriter::_writeFlightPath(QXmlStreamWriter& xml) const
+{
+    if (!_hasFlightPath) {
+        return;
+    }
+
+    QString coordString;
+
+    xml.writeStartElement(QStringLiteral("Folder"));
+    xml.writeTextElement(QStringLiteral("name"), QStringLiteral("Items"));
+    for (const Waypoint_t& waypoint : _waypoints) {
+        xml.writeStartElement(QStringLiteral("Placemark"));
+        xml.writeTextElement(QStringLiteral("name"),        waypoint.name);
+        xml.writeTextElement(QStringLiteral("styleUrl"),    QStringLiteral("#%1").arg(_balloonStyleName));
+        xml.writeStartElement(QStringLiteral("description"));
+        xml.writeCDATA(waypoint.description);
+        xml.writeEndElement();
+        xml.writeStartElement(QStringLiteral("Point"));
+        xml.writeTextElement(QStringLiteral("altitudeMode"), QStringLiteral("absolute"));
+        coordString.clear();
+        _appendCoord(coordString, waypoint.coord);
+        xml.writeTextElement(QStringLiteral("coordinates"), coordString);
+        xml.writeTextElement(QStringLiteral("extrude"),     QStringLiteral("1"));
+        xml.writeEndElement(); // Point
+        xml.writeEndElement(); // Placemark
+    }
+    xml.writeEndElement(); // Folder
+
+    xml.writeStartElement(QStringLiteral("Placemark"));
+    xml.writeTextElement(QStringLiteral("styleUrl"),    QStringLiteral("#%1").arg(_missionLineStyleName));
+    xml.writeTextElement(QStringLiteral("name"),        QStringLiteral("Flight Path"));
+    xml.writeTextElement(QStringLiteral("visibility"),  QStringLiteral("1"));
+
+    xml.writeStartElement(QStringLiteral("LookAt"));
+    xml.writeTextElement(QStringLiteral("latitude"),    _fixedString(_lookAtCoord.latitude(), 7));
+    xml.writeTextElement(QStringLiteral("longitude"),   _fixedString(_lookAtCoord.longitude(), 7));
+    xml.writeTextElement(QStringLiteral("altitude"),    _fixedString(qIsNaN(_lookAtCoord.altitude()) ? 0 : _lookAtCoord.altitude(), 2));
+    xml.writeTextElement(QStringLiteral("heading"),     QStringLiteral("-100"));
+    xml.writeTextElement(QStringLiteral("tilt"),        QStringLiteral("45"));
+    xml.writeTextElement(QStringLiteral("range"),       QStringLiteral("2500"));
+    xml.writeEndElement();
+
+    xml.writeStartElement(QStringLiteral("LineString"));
+    xml.writeTextElement(QStringLiteral("extruder"),        QStringLiteral("1"));
+    xml.writeTextElement(QStringLiteral("tessellate"),      QStringLiteral("1"));
+    xml.writeTextElement(QStringLiteral("altitudeMode"),    QStringLiteral("absolute"));
+    coordString.clear();
+    coordString.reserve(_flightPath.count() * 36);
+    for (const QGeoCoordinate& coord : _flightPath) {
+        _appendCoord(coordString, coord);
+        coordString += QLatin1Char('\n');
+    }
+    xml.writeTextElement(QStringLiteral("coordinates"), coordString);
+    xml.writeEndElement(); // LineString
+    xml.writeEndElement(); // Placemark
+}
+
+void KMLPlanWriter::_writePolygons(QXmlStreamWriter& xml) const
+{
+    QString coordString;
+
+    for (const Polygon_t& polygon : _polygons) {
+        xml.writeStartElement(QStringLiteral("Placemark"));
+        xml.writeTextElement(QStringLiteral("name"),        polygon.name);
+        xml.writeTextElement(QStringLiteral("visibility"),  QStringLiteral("1"));
+
+        xml.writeStartElement(QStringLiteral("Polygon"));
+        xml.writeTextElement(QStringLiteral("altitudeMode"), QStringLiteral("clampToGround"));
+        xml.writeStartElement(QStringLiteral("outerBoundaryIs"));
+        xml.writeStartElement(QStringLiteral("LinearRing"));
+        coordString.clear();
+        for (const QGeoCoordinate& coord : polygon.path) {
+            _appendCoord(coordString, coord);
+            coordString += QLatin1Char('\n');
+        }
+        // KML rings are closed by repeating the first point
+        _appendCoord(coordString, polygon.path.first());
+        coordString += QLatin1Char('\n');
+        xml.writeTextElement(QStringLiteral("coordinates"), coordString);
+        xml.writeEndElement(); // LinearRing
+        xml.writeEndElement(); // outerBoundaryIs
+        xml.writeEndElement(); // Polygon
+
+        xml.writeTextElement(QStringLiteral("styleUrl"), QStringLiteral("#%1").arg(_surveyPolygonStyleName));
+        xml.writeEndElement(); // Placemark
+    }
+}
+
+/// Appends a KML lon,lat,alt coordinate
+void KMLPlanWriter::_appendCoord(QString& coordString, const QGeoCoordinate& coord)
+{
+    double altitude = qIsNaN(coord.altitude()) ? 0 : coord.altitude();
+
+    _appendFixed(coordString, coord.longitude(), 7);
+    coordString += QLatin1Char(',');
+    _appendFixed(coordString, coord.latitude(), 7);
+    coordString += QLatin1Char(',');
+    _appendFixed(coordString, altitude, 2);
+}
+
+/// Appends a value with a fixed number of decimals. Same output as QString::number(value, 'f', decimals) without
+/// going through the general purpose double to string conversion and the temporary string it needs.
+void KMLPlanWriter::_appendFixed(QString& string, double value, int decimals)
+{
+    static const qint64 rgScale[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+
+    if (qIsNaN(value) || qAbs(value) >= 1e11 || decimals < 0 || decimals > 7) {
+        // Out of range for the integer path, let Qt deal with it
+        string += QString::number(value, 'f', decimals);
+        return;
+    }
+
+    qint64  scaled      = qRound64(qAbs(value) * rgScale[decimals]);
+    bool    negative    = value < 0 && scaled != 0;
+    char    buffer[32];
+    int     index = sizeof(buffer);
+
+    for (int i=0; i<decimals; i++) {
+        buffer[--index] = static_cast<char>('0' + scaled % 10);
+        scaled /= 10;
+    }
+    if (decimals > 0) {
+        buffer[--index] = '.';
+    }
+    do {
+        buffer[--index] = static_cast<char>('0' + scaled % 10);
+        scaled /= 10;
+    } while (scaled != 0);
+    if (negative) {
+        buffer[--index] = '-';
+    }
+
+    string += QLatin1String(buffer + index, static_cast<int>(sizeof(buffer)) - index);
+}
+
+QString KMLPlanWriter::_fixedString(double value, int decimals)
+{
+    QString string;
+    _appendFixed(string, value, decimals);
+    return string;
+}
+
+QString KMLPlanWriter::_kmlColorString(const QColor& color, double opacity)
+{
+    return QStringLiteral("%1%2%3%4").arg(static_cast<int>(255.0 * opacity), 2, 16, QChar('0')).arg(color.blue(), 2, 16, QChar('0')).arg(color.green(), 2, 16, QChar('0')).arg(color.red(), 2, 16, QChar('0'));
+}
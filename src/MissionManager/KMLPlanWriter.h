@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoCoordinate>
+#include <QList>
+#include <QString>
+
+class MissionItem;
+class Vehicle;
+class QmlObjectListModel;
+class QIODevice;
+class QColor;
+class QXmlStreamWriter;
+
+/// Used to convert a Plan to a KML document
+///
+/// The plan is captured as plain values on the thread which owns it, after which write can be run from any thread.
+/// Output is streamed element by element, the document is never built up in memory.
+class KMLPlanWriter
+{
+public:
+    KMLPlanWriter(void);
+
+    void addMission(Vehicle* vehicle, QmlObjectListModel* visualItems, QList<MissionItem*> rgMissionItems);
+
+    /// Adds a polygon placemark drawn with the survey polygon style
+    void addPolygon(const QString& name, const QList<QGeoCoordinate>& polygon);
+
+    /// Writes the KML document
+    ///     @return false: write to the device failed
+    bool write(QIODevice& device) const;
+
+private:
+    typedef struct {
+        QString         name;
+        QString         description;
+        QGeoCoordinate  coord;
+    } Waypoint_t;
+
+    typedef struct {
+        QString                 name;
+        QList<QGeoCoordinate>   path;
+    } Polygon_t;
+
+    void _addFlightPath     (Vehicle* vehicle, QList<MissionItem*> rgMissionItems);
+    void _addComplexItems   (QmlObjectListModel* visualItems);
+    void _writeStyles       (QXmlStreamWriter& xml) const;
+    void _writeFlightPath   (QXmlStreamWriter& xml) const;
+    void _writePolygons     (QXmlStreamWriter& xml) const;
+
+    static void     _appendCoord        (QString& coordString, const QGeoCoordinate& coord);
+    static void     _appendFixed        (QString& string, double value, int decimals);
+    static QString  _fixedString        (double value, int decimals);
+    static QString  _kmlColorString     (const QColor& color, double opacity = 1);
+
+    QString             _name;
+    bool                _hasFlightPath = false;
+    QGeoCoordinate      _lookAtCoord;
+    QString             _missionLineColor;
+    QString             _surveyPolygonColor;
+    QList<Waypoint_t>   _waypoints;
+    QList<QGeoCoordinate> _flightPath;
+    QList<Polygon_t>    _polygons;
+
+    static const char* _balloonStyleName;
+    static const char* _missionLineStyleName;
+    static const char* _surveyPolygonStyleName;
+};
@@ -108,19 +108,18 @@ void LandingComplexItem::_init(void)
     connect(this,                       &LandingComplexItem::landingCoordSetChanged,        this, &LandingComplexItem::readyForSaveStateChanged);
     connect(this,                       &LandingComplexItem::wizardModeChanged,             this, &LandingComplexItem::readyForSaveStateChanged);
 
-    connect(this,                       &LandingComplexItem::finalApproachCoordinateChanged,this, &LandingComplexItem::complexDistanceChanged);
-    connect(this,                       &LandingComplexItem::loiterTangentCoordinateChanged,this, &LandingComplexItem::complexDistanceChanged);
-    connect(this,                       &LandingComplexItem::landingCoordinateChanged,      this, &LandingComplexItem::complexDistanceChanged);
-
-    connect(this,                       &LandingComplexItem::loiterTangentCoordinateChanged,this, &LandingComplexItem::_updateFlightPathSegmentsSignal);
-    connect(this,                       &LandingComplexItem::finalApproachCoordinateChanged,this, &LandingComplexItem::_updateFlightPathSegmentsSignal);
-    connect(this,                       &LandingComplexItem::landingCoordinateChanged,      this, &LandingComplexItem::_updateFlightPathSegmentsSignal);
+    // A recalc changes several coordinates at once and reports them with a single _signalGeometryChanged when done
+    connect(this,                       &LandingComplexItem::finalApproachCoordinateChanged,this, &LandingComplexItem::_coordinateChangedOutsideRecalc);
+    connect(this,                       &LandingComplexItem::loiterTangentCoordinateChanged,this, &LandingComplexItem::_coordinateChangedOutsideRecalc);
+    connect(this,                       &LandingComplexItem::landingCoordinateChanged,      this, &LandingComplexItem::_coordinateChangedOutsideRecalc);
     connect(finalApproachAltitude(),    &Fact::valueChanged,                                this, &LandingComplexItem::_updateFlightPathSegmentsSignal);
     connect(landingAltitude(),          &Fact::valueChanged,                                this, &LandingComplexItem::_updateFlightPathSegmentsSignal);
     connect(this,                       &LandingComplexItem::altitudesAreRelativeChanged,   this, &LandingComplexItem::_updateFlightPathSegmentsSignal);
     connect(_missionController,         &MissionController::plannedHomePositionChanged,     this, &LandingComplexItem::_updateFlightPathSegmentsSignal);
 
     connect(finalApproachAltitude(),    &Fact::valueChanged,                                this, &LandingComplexItem::_updateFinalApproachCoodinateAltitudeFromFact);
+
+    connect(&_flightPathSegments,       &QmlObjectListModel::modelReset,                    this, &LandingComplexItem::_flightPathSegmentsReset);
     connect(landingAltitude(),          &Fact::valueChanged,                                this, &LandingComplexItem::_updateLandingCoodinateAltitudeFromFact);
 }
 
@@ -208,6 +207,7 @@ void LandingComplexItem::_recalcFromHeadingAndDistanceChange(void)
         emit coordinateChanged(_finalApproachCoordinate);
         _calcGlideSlope();
         _ignoreRecalcSignals = false;
+        _signalGeometryChanged();
     }
 }
 
@@ -239,6 +239,7 @@ void LandingComplexItem::_recalcFromRadiusChange(void)
             landingHeading()->setRawValue(heading);
             emit loiterTangentCoordinateChanged(_loiterTangentCoordinate);
             _ignoreRecalcSignals = false;
+            _signalGeometryChanged();
         } else {
             double landToLoiterDistance = qSqrt(qPow(radius, 2) + qPow(landToTangentDistance, 2));
             double angleLoiterToTangent = qRadiansToDegrees(qAsin(radius/landToLoiterDistance)) * (_loiterClockwise()->rawValue().toBool() ? -1 : 1);
@@ -250,6 +251,7 @@ void LandingComplexItem::_recalcFromRadiusChange(void)
             emit finalApproachCoordinateChanged(_finalApproachCoordinate);
             emit coordinateChanged(_finalApproachCoordinate);
             _ignoreRecalcSignals = false;
+            _signalGeometryChanged();
         }
     }
 }
@@ -293,6 +295,7 @@ void LandingComplexItem::_recalcFromCoordinateChange(void)
         emit loiterTangentCoordinateChanged(_loiterTangentCoordinate);
         _calcGlideSlope();
         _ignoreRecalcSignals = false;
+        _signalGeometryChanged();
     }
 }
 
@@ -560,17 +563,38 @@ void LandingComplexItem::_signalLastSequenceNumberChanged(void)
     emit lastSequenceNumberChanged(lastSequenceNumber());
 }
 
+// Altitude only changes don't move anything horizontally, so the pattern is not recalculated. The altitude facts
+// themselves kick off the flight path update.
 void LandingComplexItem::_updateFinalApproachCoodinateAltitudeFromFact(void)
 {
     _finalApproachCoordinate.setAltitude(finalApproachAltitude()->rawValue().toDouble());
+    _ignoreRecalcSignals = true;
     emit finalApproachCoordinateChanged(_finalApproachCoordinate);
     emit coordinateChanged(_finalApproachCoordinate);
+    _ignoreRecalcSignals = false;
 }
 
 void LandingComplexItem::_updateLandingCoodinateAltitudeFromFact(void)
 {
     _landingCoordinate.setAltitude(landingAltitude()->rawValue().toDouble());
+    _ignoreRecalcSignals = true;
     emit landingCoordinateChanged(_landingCoordinate);
+    _ignoreRecalcSignals = false;
+}
+
+void LandingComplexItem::_coordinateChangedOutsideRecalc(void)
+{
+    if (!_ignoreRecalcSignals) {
+        _signalGeometryChanged();
+    }
+}
+
+/// Tells MissionController and the flight path about a change to the pattern. The flight path update is queued and
+/// compressed so it runs once per event loop turn however many changes come in.
+void LandingComplexItem::_signalGeometryChanged(void)
+{
+    emit complexDistanceChanged();
+    emit _updateFlightPathSegmentsSignal();
 }
 
 double LandingComplexItem::greatestDistanceTo(const QGeoCoordinate &other) const
@@ -712,3 +736,44 @@ void LandingComplexItem::setAltitudesAreRelative(bool altitudesAreRelative)
         emit altitudesAreRelativeChanged(_altitudesAreRelative);
     }
 }
+
+void LandingComplexItem::_flightPathSegmentsReset(void)
+{
+    // Segment terrain profiles come from TerrainCollisionEngine, which only queries terrain for geometry it has not
+    // seen before. Clearance is worked out again from those profiles whenever they or the segment altitudes change.
+    for (int i=0; i<_flightPathSegments.count(); i++) {
+        FlightPathSegment* segment = _flightPathSegments.value<FlightPathSegment*>(i);
+        connect(segment, &FlightPathSegment::amslTerrainHeightsChanged, this, &LandingComplexItem::_updateApproachTerrainClearance);
+        connect(segment, &FlightPathSegment::coord1AMSLAltChanged,      this, &LandingComplexItem::_updateApproachTerrainClearance);
+        connect(segment, &FlightPathSegment::coord2AMSLAltChanged,      this, &LandingComplexItem::_updateApproachTerrainClearance);
+    }
+    _updateApproachTerrainClearance();
+}
+
+/// Works out the lowest height above terrain along the approach. Touchdown is left out since the path meets the
+/// ground there by design. Vertical segments have no terrain profile and are skipped.
+void LandingComplexItem::_updateApproachTerrainClearance(void)
+{
+    double clearance = qQNaN();
+    for (int i=0; i<_flightPathSegments.count(); i++) {
+        FlightPathSegment* segment = _flightPathSegments.value<FlightPathSegment*>(i);
+        if (qFuzzyIsNull(segment->totalDistance())) {
+            continue;
+        }
+        bool    touchdown           = segment->coordinate2() == _landingCoordinate && QGC::fuzzyCompare(segment->coord2AMSLAlt(), amslExitAlt());
+        double  segmentClearance    = segment->minTerrainClearance(!touchdown);
+        if (qIsNaN(segmentClearance)) {
+            // Profile not available yet, a partial answer would be misleading
+            clearance = qQNaN();
+            break;
+        }
+        if (qIsNaN(clearance) || segmentClearance < clearance) {
+            clearance = segmentClearance;
+        }
+    }
+
+    if (!QGC::fuzzyCompare(clearance, _approachTerrainClearance)) {
+        _approachTerrainClearance = clearance;
+        emit approachTerrainClearanceChanged(_approachTerrainClearance);
+    }
+}
@@ -41,6 +41,7 @@ public:
     Q_PROPERTY(QGeoCoordinate   landingCoordinate       READ    landingCoordinate           WRITE setLandingCoordinate          NOTIFY landingCoordinateChanged)
     Q_PROPERTY(bool             altitudesAreRelative    READ    altitudesAreRelative        WRITE setAltitudesAreRelative       NOTIFY altitudesAreRelativeChanged)
     Q_PROPERTY(bool             landingCoordSet         READ    landingCoordSet                                                 NOTIFY landingCoordSetChanged)
+    Q_PROPERTY(double           approachTerrainClearance READ   approachTerrainClearance                                        NOTIFY approachTerrainClearanceChanged)   ///< NaN: terrain not known yet
 
     Q_INVOKABLE void setLandingHeadingToTakeoffHeading();
 
@@ -69,6 +70,7 @@ public:
     QGeoCoordinate  landingCoordinate       (void) const { return _landingCoordinate; }
     QGeoCoordinate  finalApproachCoordinate (void) const { return _finalApproachCoordinate; }
     QGeoCoordinate  loiterTangentCoordinate (void) const { return _loiterTangentCoordinate; }
+    double          approachTerrainClearance(void) const { return _approachTerrainClearance; }
 
     void setLandingCoordinate       (const QGeoCoordinate& coordinate);
     void setFinalApproachCoordinate (const QGeoCoordinate& coordinate);
@@ -126,6 +128,7 @@ signals:
     void useLoiterToAltChanged          (bool useLoiterToAlt);
     void altitudesAreRelativeChanged    (bool altitudesAreRelative);
     void _updateFlightPathSegmentsSignal(void);
+    void approachTerrainClearanceChanged(double approachTerrainClearance);
 
 protected slots:
     virtual void _updateFlightPathSegmentsDontCallDirectly(void) = 0;
@@ -167,6 +170,7 @@ protected:
     bool            _landingCoordSet            = false;
     bool            _ignoreRecalcSignals        = false;
     bool            _altitudesAreRelative       = true;
+    double          _approachTerrainClearance   = qQNaN();
 
     static const char* _jsonFinalApproachCoordinateKey;
     static const char* _jsonLoiterRadiusKey;
@@ -187,6 +191,12 @@ private slots:
     void    _signalLastSequenceNumberChanged                (void);
     void    _updateFinalApproachCoodinateAltitudeFromFact   (void);
     void    _updateLandingCoodinateAltitudeFromFact     (void);
+    void    _coordinateChangedOutsideRecalc                 (void);
+    void    _flightPathSegmentsReset                        (void);
+    void    _updateApproachTerrainClearance                 (void);
+
+private:
+    void    _signalGeometryChanged                          (void);
 
     friend class LandingComplexItemTest;
 };
@@ -88,9 +88,5 @@ void MissionCommandList::_loadMavCmdInfoJson(const QString& jsonFilename, bool b
 
 MissionCommandUIInfo* MissionCommandList::getUIInfo(MAV_CMD command) const
 {
-    if (!_infoMap.contains(command)) {
-        return nullptr;
-    }
-
-    return _infoMap[command];
+    return _infoMap.value(command, nullptr);
 }
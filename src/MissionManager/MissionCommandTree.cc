@@ -26,6 +26,11 @@ MissionCommandTree::MissionCommandTree(QGCApplication* app, QGCToolbox* toolbox,
 {
 }
 
+MissionCommandTree::~MissionCommandTree()
+{
+    qDeleteAll(_allCommands);
+}
+
 void MissionCommandTree::setToolbox(QGCToolbox* toolbox)
 {
     QGCTool::setToolbox(toolbox);
@@ -34,23 +39,23 @@ void MissionCommandTree::setToolbox(QGCToolbox* toolbox)
 
 #ifdef UNITTEST_BUILD
     if (_unitTest) {
-        // Load unit testing tree
-        _staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassGeneric]      = new MissionCommandList(":/unittest/UT-MavCmdInfoCommon.json", true, this);
-        _staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassFixedWing]    = new MissionCommandList(":/unittest/UT-MavCmdInfoFixedWing.json", false, this);
-        _staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassMultiRotor]   = new MissionCommandList(":/unittest/UT-MavCmdInfoMultiRotor.json", false, this);
-        _staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassVTOL]         = new MissionCommandList(":/unittest/UT-MavCmdInfoVTOL.json", false, this);
-        _staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassSub]          = new MissionCommandList(":/unittest/UT-MavCmdInfoSub.json", false, this);
-        _staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassRoverBoat]    = new MissionCommandList(":/unittest/UT-MavCmdInfoRover.json", false, this);
+        // Unit testing tree
+        _commandListFiles[_treeKey(MAV_AUTOPILOT_GENERIC, QGCMAVLink::VehicleClassGeneric)]     = ":/unittest/UT-MavCmdInfoCommon.json";
+        _commandListFiles[_treeKey(MAV_AUTOPILOT_GENERIC, QGCMAVLink::VehicleClassFixedWing)]   = ":/unittest/UT-MavCmdInfoFixedWing.json";
+        _commandListFiles[_treeKey(MAV_AUTOPILOT_GENERIC, QGCMAVLink::VehicleClassMultiRotor)]  = ":/unittest/UT-MavCmdInfoMultiRotor.json";
+        _commandListFiles[_treeKey(MAV_AUTOPILOT_GENERIC, QGCMAVLink::VehicleClassVTOL)]        = ":/unittest/UT-MavCmdInfoVTOL.json";
+        _commandListFiles[_treeKey(MAV_AUTOPILOT_GENERIC, QGCMAVLink::VehicleClassSub)]         = ":/unittest/UT-MavCmdInfoSub.json";
+        _commandListFiles[_treeKey(MAV_AUTOPILOT_GENERIC, QGCMAVLink::VehicleClassRoverBoat)]   = ":/unittest/UT-MavCmdInfoRover.json";
     } else {
 #endif
-        // Load all levels of hierarchy
+        // Find the files for all levels of hierarchy, they are loaded as vehicles need them
         for (const QGCMAVLink::FirmwareClass_t firmwareClass: _toolbox->firmwarePluginManager()->supportedFirmwareClasses()) {
             FirmwarePlugin* plugin = _toolbox->firmwarePluginManager()->firmwarePluginForAutopilot(QGCMAVLink::firmwareClassToAutopilot(firmwareClass), MAV_TYPE_QUADROTOR);
 
             for (const QGCMAVLink::VehicleClass_t vehicleClass: QGCMAVLink::allVehicleClasses()) {
                 QString overrideFile = plugin->missionCommandOverrides(vehicleClass);
                 if (!overrideFile.isEmpty()) {
-                    _staticCommandTree[firmwareClass][vehicleClass] = new MissionCommandList(overrideFile, firmwareClass == QGCMAVLink::FirmwareClassGeneric && vehicleClass == QGCMAVLink::VehicleClassGeneric /* baseCommandList */, this);
+                    _commandListFiles[_treeKey(firmwareClass, vehicleClass)] = overrideFile;
                 }
             }
         }
@@ -59,11 +64,42 @@ void MissionCommandTree::setToolbox(QGCToolbox* toolbox)
 #endif
 }
 
+/// Returns the specified level of the static hierarchy, loading it on first use
+///     @return nullptr: There are no overrides at this level
+MissionCommandList* MissionCommandTree::_commandList(QGCMAVLink::FirmwareClass_t firmwareClass, QGCMAVLink::VehicleClass_t vehicleClass)
+{
+    const int key = _treeKey(firmwareClass, vehicleClass);
+
+    auto iter = _staticCommandTree.constFind(key);
+    if (iter != _staticCommandTree.constEnd()) {
+        return iter.value();
+    }
+
+    MissionCommandList* commandList = nullptr;
+    const QString jsonFilename = _commandListFiles.value(key);
+    if (!jsonFilename.isEmpty()) {
+        commandList = new MissionCommandList(jsonFilename, firmwareClass == QGCMAVLink::FirmwareClassGeneric && vehicleClass == QGCMAVLink::VehicleClassGeneric /* baseCommandList */, this);
+    }
+    _staticCommandTree[key] = commandList;
+    return commandList;
+}
+
+int MissionCommandTree::_commandSlot(MAV_CMD command) const
+{
+    const int index = static_cast<int>(command);
+    return index >= 0 && index < _commandSlots.count() ? _commandSlots[index] : -1;
+}
+
+MissionCommandUIInfo* MissionCommandTree::_lookup(const CollapsedTree_t& collapsedTree, MAV_CMD command) const
+{
+    const int slot = _commandSlot(command);
+    return slot >= 0 && slot < collapsedTree.uiInfo.count() ? collapsedTree.uiInfo[slot] : nullptr;
+}
+
 /// Add the next level of the hierarchy to a collapsed tree.
 ///     @param cmdList          List of mission commands to collapse into ui info
 ///     @param collapsedTree    Tree we are collapsing into
-void MissionCommandTree::_collapseHierarchy(const MissionCommandList*               cmdList,
-                                            QMap<MAV_CMD, MissionCommandUIInfo*>&   collapsedTree)
+void MissionCommandTree::_collapseHierarchy(const MissionCommandList* cmdList, CollapsedTree_t& collapsedTree)
 {
     if (!cmdList) {
         return;
@@ -71,76 +107,110 @@ void MissionCommandTree::_collapseHierarchy(const MissionCommandList*
 
     for (MAV_CMD command: cmdList->commandIds()) {
         MissionCommandUIInfo* uiInfo = cmdList->getUIInfo(command);
-        if (uiInfo) {
-            if (collapsedTree.contains(command)) {
-                collapsedTree[command]->_overrideInfo(uiInfo);
-            } else {
-                collapsedTree[command] = new MissionCommandUIInfo(*uiInfo);
+        if (!uiInfo) {
+            continue;
+        }
+
+        int slot = _commandSlot(command);
+        if (slot < 0) {
+            const int index = static_cast<int>(command);
+            if (index < 0 || index > UINT16_MAX) {
+                qWarning() << "MissionCommandTree: command id out of range" << index;
+                continue;
+            }
+            if (index >= _commandSlots.count()) {
+                _commandSlots.insert(_commandSlots.end(), index + 1 - _commandSlots.count(), -1);
             }
+            slot = _commandSlotCount++;
+            _commandSlots[index] = static_cast<qint16>(slot);
+        }
+        if (slot >= collapsedTree.uiInfo.count()) {
+            collapsedTree.uiInfo.resize(_commandSlotCount);
+        }
+
+        MissionCommandUIInfo*& collapsedInfo = collapsedTree.uiInfo[slot];
+        if (collapsedInfo) {
+            collapsedInfo->_overrideInfo(uiInfo);
+        } else {
+            collapsedInfo = new MissionCommandUIInfo(*uiInfo, this);
+            collapsedTree.commandIds.append(command);
         }
     }
 }
 
-void MissionCommandTree::_buildAllCommands(Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode)
+/// Returns the collapsed tree for the specified firmware/vehicle class, building it on first use
+MissionCommandTree::CollapsedTree_t& MissionCommandTree::_collapsedTree(QGCMAVLink::FirmwareClass_t firmwareClass, QGCMAVLink::VehicleClass_t vehicleClass)
 {
-    QGCMAVLink::FirmwareClass_t firmwareClass;
-    QGCMAVLink::VehicleClass_t  vehicleClass;
-
-    _firmwareAndVehicleClassInfo(vehicle, vtolMode, firmwareClass, vehicleClass);
+    const int key = _treeKey(firmwareClass, vehicleClass);
 
-    if (_allCommands.contains(firmwareClass) && _allCommands[firmwareClass].contains(vehicleClass)) {
-        // Already built
-        return;
+    // Plan view asks for the same vehicle over and over
+    if (key == _lastTreeKey) {
+        return *_lastTree;
     }
 
-    QMap<MAV_CMD, MissionCommandUIInfo*>& collapsedTree = _allCommands[firmwareClass][vehicleClass];
+    CollapsedTree_t* collapsedTree = _allCommands.value(key, nullptr);
+    if (!collapsedTree) {
+        collapsedTree = new CollapsedTree_t;
+        _allCommands[key] = collapsedTree;
 
-    // Base of the tree is all commands
-    _collapseHierarchy(_staticCommandTree[MAV_AUTOPILOT_GENERIC][QGCMAVLink::VehicleClassGeneric], collapsedTree);
+        // Base of the tree is all commands
+        _collapseHierarchy(_commandList(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric), *collapsedTree);
 
-    // Add the overrides for specific vehicle types
-    if (vehicleClass != QGCMAVLink::VehicleClassGeneric) {
-        _collapseHierarchy(_staticCommandTree[QGCMAVLink::FirmwareClassGeneric][vehicleClass], collapsedTree);
-    }
+        // Add the overrides for specific vehicle types
+        if (vehicleClass != QGCMAVLink::VehicleClassGeneric) {
+            _collapseHierarchy(_commandList(QGCMAVLink::FirmwareClassGeneric, vehicleClass), *collapsedTree);
+        }
 
-    // Add the overrides for specific firmware class, all vehicles
-    if (firmwareClass != QGCMAVLink::FirmwareClassGeneric) {
-        _collapseHierarchy(_staticCommandTree[firmwareClass][QGCMAVLink::VehicleClassGeneric], collapsedTree);
+        // Add the overrides for specific firmware class, all vehicles
+        if (firmwareClass != QGCMAVLink::FirmwareClassGeneric) {
+            _collapseHierarchy(_commandList(firmwareClass, QGCMAVLink::VehicleClassGeneric), *collapsedTree);
 
-        // Add overrides for specific vehicle class
-        if (vehicleClass != QGCMAVLink::VehicleClassGeneric) {
-            _collapseHierarchy(_staticCommandTree[firmwareClass][vehicleClass], collapsedTree);
+            // Add overrides for specific vehicle class
+            if (vehicleClass != QGCMAVLink::VehicleClassGeneric) {
+                _collapseHierarchy(_commandList(firmwareClass, vehicleClass), *collapsedTree);
+            }
         }
-    }
 
-    // Build category list from supported commands
-    QList<MAV_CMD> supportedCommands = vehicle->firmwarePlugin()->supportedMissionCommands(vehicleClass);
-    for (MAV_CMD cmd: collapsedTree.keys()) {
-        if (supportedCommands.contains(cmd)) {
-            QString newCategory = collapsedTree[cmd]->category();
-            if (!_supportedCategories[firmwareClass][vehicleClass].contains(newCategory)) {
-                _supportedCategories[firmwareClass][vehicleClass].append(newCategory);
+        std::sort(collapsedTree->commandIds.begin(), collapsedTree->commandIds.end());
+
+        // Build category list from supported commands
+        FirmwarePlugin* firmwarePlugin = qgcApp()->toolbox()->firmwarePluginManager()->firmwarePluginForAutopilot(QGCMAVLink::firmwareClassToAutopilot(firmwareClass), QGCMAVLink::vehicleClassToMavType(vehicleClass));
+        QList<MAV_CMD>  supportedCommands = firmwarePlugin->supportedMissionCommands(vehicleClass);
+        for (MAV_CMD cmd: collapsedTree->commandIds) {
+            if (supportedCommands.contains(cmd)) {
+                QString newCategory = _lookup(*collapsedTree, cmd)->category();
+                if (!collapsedTree->categories.contains(newCategory)) {
+                    collapsedTree->categories.append(newCategory);
+                }
             }
         }
+        collapsedTree->categories.append(_allCommandsCategory);
+
+        qCDebug(MissionCommandsLog) << "Collapsed command tree" << QGCMAVLink::firmwareClassToString(firmwareClass) << QGCMAVLink::vehicleClassToString(vehicleClass) << collapsedTree->commandIds.count();
     }
-    _supportedCategories[firmwareClass][vehicleClass].append(_allCommandsCategory);
+
+    _lastTreeKey    = key;
+    _lastTree       = collapsedTree;
+    return *collapsedTree;
 }
 
-QStringList MissionCommandTree::_availableCategoriesForVehicle(Vehicle* vehicle)
+MissionCommandTree::CollapsedTree_t& MissionCommandTree::_buildAllCommands(Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode)
 {
     QGCMAVLink::FirmwareClass_t firmwareClass;
     QGCMAVLink::VehicleClass_t  vehicleClass;
 
-    _firmwareAndVehicleClassInfo(vehicle, QGCMAVLink::VehicleClassGeneric, firmwareClass, vehicleClass);
-    _buildAllCommands(vehicle, QGCMAVLink::VehicleClassGeneric);
+    _firmwareAndVehicleClassInfo(vehicle, vtolMode, firmwareClass, vehicleClass);
+    return _collapsedTree(firmwareClass, vehicleClass);
+}
 
-    return _supportedCategories[firmwareClass][vehicleClass];
+QStringList MissionCommandTree::_availableCategoriesForVehicle(Vehicle* vehicle)
+{
+    return _buildAllCommands(vehicle, QGCMAVLink::VehicleClassGeneric).categories;
 }
 
 QString MissionCommandTree::friendlyName(MAV_CMD command)
 {
-    MissionCommandList *    commandList =   _staticCommandTree[QGCMAVLink::FirmwareClassGeneric][QGCMAVLink::VehicleClassGeneric];
-    MissionCommandUIInfo*   uiInfo =        commandList->getUIInfo(command);
+    MissionCommandUIInfo* uiInfo = _lookup(_collapsedTree(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric), command);
 
     if (uiInfo) {
         return uiInfo->friendlyName();
@@ -151,8 +221,7 @@ QString MissionCommandTree::friendlyName(MAV_CMD command)
 
 QString MissionCommandTree::rawName(MAV_CMD command)
 {
-    MissionCommandList *    commandList =   _staticCommandTree[QGCMAVLink::FirmwareClassGeneric][QGCMAVLink::VehicleClassGeneric];
-    MissionCommandUIInfo*   uiInfo =        commandList->getUIInfo(command);
+    MissionCommandUIInfo* uiInfo = _lookup(_collapsedTree(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric), command);
 
     if (uiInfo) {
         return uiInfo->rawName();
@@ -163,39 +232,26 @@ QString MissionCommandTree::rawName(MAV_CMD command)
 
 bool MissionCommandTree::isLandCommand(MAV_CMD command)
 {
-    MissionCommandList *    commandList =   _staticCommandTree[QGCMAVLink::FirmwareClassGeneric][QGCMAVLink::VehicleClassGeneric];
-    MissionCommandUIInfo*   uiInfo =        commandList->getUIInfo(command);
+    MissionCommandUIInfo* uiInfo = _lookup(_collapsedTree(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric), command);
 
     return uiInfo ? uiInfo->isLandCommand() : false;
 }
 
 bool MissionCommandTree::isTakeoffCommand(MAV_CMD command)
 {
-    MissionCommandList *    commandList =   _staticCommandTree[QGCMAVLink::FirmwareClassGeneric][QGCMAVLink::VehicleClassGeneric];
-    MissionCommandUIInfo*   uiInfo =        commandList->getUIInfo(command);
+    MissionCommandUIInfo* uiInfo = _lookup(_collapsedTree(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric), command);
 
     return uiInfo ? uiInfo->isTakeoffCommand() : false;
 }
 
-const QList<MAV_CMD>& MissionCommandTree::allCommandIds(void) const
+const QList<MAV_CMD>& MissionCommandTree::allCommandIds(void)
 {
-    return _staticCommandTree[QGCMAVLink::FirmwareClassGeneric][QGCMAVLink::VehicleClassGeneric]->commandIds();
+    return _collapsedTree(QGCMAVLink::FirmwareClassGeneric, QGCMAVLink::VehicleClassGeneric).commandIds;
 }
 
 const MissionCommandUIInfo* MissionCommandTree::getUIInfo(Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode,  MAV_CMD command)
 {
-    QGCMAVLink::FirmwareClass_t firmwareClass;
-    QGCMAVLink::VehicleClass_t  vehicleClass;
-
-    _firmwareAndVehicleClassInfo(vehicle, vtolMode, firmwareClass, vehicleClass);
-    _buildAllCommands(vehicle, vtolMode);
-
-    const QMap<MAV_CMD, MissionCommandUIInfo*>& infoMap = _allCommands[firmwareClass][vehicleClass];
-    if (infoMap.contains(command)) {
-        return infoMap[command];
-    } else {
-        return nullptr;
-    }
+    return _lookup(_buildAllCommands(vehicle, vtolMode), command);
 }
 
 QVariantList MissionCommandTree::getCommandsForCategory(Vehicle* vehicle, const QString& category, bool showFlyThroughCommands)
@@ -204,7 +260,7 @@ QVariantList MissionCommandTree::getCommandsForCategory(Vehicle* vehicle, const
     QGCMAVLink::VehicleClass_t  vehicleClass;
 
     _firmwareAndVehicleClassInfo(vehicle, QGCMAVLink::VehicleClassGeneric, firmwareClass, vehicleClass);
-    _buildAllCommands(vehicle, QGCMAVLink::VehicleClassGeneric);
+    const CollapsedTree_t& collapsedTree = _collapsedTree(firmwareClass, vehicleClass);
 
     // vehicle can be null in which case _firmwareAndVehicleClassInfo will tell of the firmware/vehicle type for the offline editing vehicle.
     // We then use that to get a firmware plugin so we can get the list of supported commands.
@@ -212,10 +268,9 @@ QVariantList MissionCommandTree::getCommandsForCategory(Vehicle* vehicle, const
     QList<MAV_CMD>  supportedCommands = firmwarePlugin->supportedMissionCommands(vehicleClass);
 
     QVariantList list;
-    QMap<MAV_CMD, MissionCommandUIInfo*> commandMap = _allCommands[firmwareClass][vehicleClass];
-    for (MAV_CMD command: commandMap.keys()) {
+    for (MAV_CMD command: collapsedTree.commandIds) {
         if (supportedCommands.isEmpty() || supportedCommands.contains(command)) {
-            MissionCommandUIInfo* uiInfo = commandMap[command];
+            MissionCommandUIInfo* uiInfo = _lookup(collapsedTree, command);
             if ((uiInfo->category() == category || category == _allCommandsCategory) && (showFlyThroughCommands || !uiInfo->specifiesCoordinate() || uiInfo->isStandaloneCoordinate())) {
                 list.append(QVariant::fromValue(uiInfo));
             }
@@ -14,7 +14,8 @@
 #include "Vehicle.h"
 
 #include <QVariantList>
-#include <QMap>
+#include <QHash>
+#include <QVector>
 
 class MissionCommandUIInfo;
 class MissionCommandList;
@@ -39,8 +40,10 @@ class MissionCommandTreeTest;
 ///             Known Firmware, Sub
 /// For known firmwares, the override files are requested from the FirmwarePlugin.
 ///
-/// When ui info is requested for a specific vehicle the static hierarchy in _staticCommandTree is collapsed into the set of available commands in
-/// _allCommands taking into account the appropriate set of overrides for the MAV_AUTOPILOT/MAV_TYPE combination associated with the vehicle.
+/// The json for a level of the static hierarchy is only loaded once a vehicle needs it. When ui info is requested for a specific
+/// vehicle the levels are collapsed into the set of available commands taking into account the appropriate set of overrides for the
+/// MAV_AUTOPILOT/MAV_TYPE combination associated with the vehicle. The collapsed tree is built once per combination and kept as a flat
+/// array, so getUIInfo/friendlyName are a couple of array indexes regardless of how many commands there are.
 ///
 class MissionCommandTree : public QGCTool
 {
@@ -48,6 +51,7 @@ class MissionCommandTree : public QGCTool
     
 public:
     MissionCommandTree(QGCApplication* app, QGCToolbox* toolbox, bool unitTest = false);
+    ~MissionCommandTree();
 
     /// Returns the friendly name for the specified command
     QString friendlyName(MAV_CMD command);
@@ -58,7 +62,7 @@ public:
     bool isLandCommand(MAV_CMD command);
     bool isTakeoffCommand(MAV_CMD command);
 
-    const QList<MAV_CMD>& allCommandIds(void) const;
+    const QList<MAV_CMD>& allCommandIds(void);
 
     Q_INVOKABLE QStringList categoriesForVehicle(Vehicle* vehicle) { return _availableCategoriesForVehicle(vehicle); }
 
@@ -71,26 +75,42 @@ public:
     virtual void setToolbox(QGCToolbox* toolbox);
 
 private:
-    void                        _collapseHierarchy              (const MissionCommandList* cmdList, QMap<MAV_CMD, MissionCommandUIInfo*>& collapsedTree);
-    void                        _buildAllCommands               (Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode);
+    typedef struct {
+        QVector<MissionCommandUIInfo*>  uiInfo;         ///< Indexed by command slot, nullptr: command not in this tree
+        QList<MAV_CMD>                  commandIds;     ///< Commands in this tree, ascending
+        QStringList                     categories;     ///< Categories for the commands the firmware supports
+    } CollapsedTree_t;
+
+    MissionCommandList*         _commandList                    (QGCMAVLink::FirmwareClass_t firmwareClass, QGCMAVLink::VehicleClass_t vehicleClass);
+    int                         _commandSlot                    (MAV_CMD command) const;
+    MissionCommandUIInfo*       _lookup                         (const CollapsedTree_t& collapsedTree, MAV_CMD command) const;
+    void                        _collapseHierarchy              (const MissionCommandList* cmdList, CollapsedTree_t& collapsedTree);
+    CollapsedTree_t&            _collapsedTree                  (QGCMAVLink::FirmwareClass_t firmwareClass, QGCMAVLink::VehicleClass_t vehicleClass);
+    CollapsedTree_t&            _buildAllCommands               (Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode);
     QStringList                 _availableCategoriesForVehicle  (Vehicle* vehicle);
     void                        _firmwareAndVehicleClassInfo    (Vehicle* vehicle, QGCMAVLink::VehicleClass_t vtolMode, QGCMAVLink::FirmwareClass_t& firmwareClass, QGCMAVLink::VehicleClass_t& vehicleClass) const;
 
+    static int _treeKey(QGCMAVLink::FirmwareClass_t firmwareClass, QGCMAVLink::VehicleClass_t vehicleClass) { return (firmwareClass << 8) | vehicleClass; }
+
 private:
     QString             _allCommandsCategory;   ///< Category which contains all available commands
-    QList<int>          _allCommandIds;         ///< List of all known command ids (not vehicle specific)
     SettingsManager*    _settingsManager;
     bool                _unitTest;              ///< true: running in unit test mode
 
-    /// Full hierarchy
-    QMap<QGCMAVLink::FirmwareClass_t, QMap<QGCMAVLink::VehicleClass_t, MissionCommandList*>>                    _staticCommandTree;
+    /// Json file for each level of the full hierarchy, key: _treeKey
+    QHash<int, QString>                 _commandListFiles;
 
-    /// Collapsed hierarchy for specific vehicle type
-    QMap<QGCMAVLink::FirmwareClass_t, QMap<QGCMAVLink::VehicleClass_t, QMap<MAV_CMD, MissionCommandUIInfo*>>>   _allCommands;
+    /// Levels of the full hierarchy loaded so far, key: _treeKey
+    QHash<int, MissionCommandList*>     _staticCommandTree;
 
-    /// Collapsed hierarchy for specific vehicle type
-    QMap<QGCMAVLink::FirmwareClass_t, QMap<QGCMAVLink::VehicleClass_t, QStringList /* category */>>             _supportedCategories;
+    /// Collapsed hierarchy for each firmware/vehicle class combination used so far, key: _treeKey
+    QHash<int, CollapsedTree_t*>        _allCommands;
+    int                                 _lastTreeKey        = -1;
+    CollapsedTree_t*                    _lastTree           = nullptr;
 
+    /// Index into CollapsedTree_t::uiInfo for each command id, -1 for unknown commands. Shared by all collapsed trees.
+    QVector<qint16>                     _commandSlots;
+    int                                 _commandSlotCount   = 0;
 
 #ifdef UNITTEST_BUILD
     friend class MissionCommandTreeTest;
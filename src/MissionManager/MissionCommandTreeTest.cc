@@ -142,7 +142,7 @@ void MissionCommandTreeTest::testJsonLoad(void)
     bool showUI;
 
     // Test loading from the bad command list
-    MissionCommandList* commandList = _commandTree->_staticCommandTree[MAV_AUTOPILOT_GENERIC][MAV_TYPE_GENERIC];
+    MissionCommandList* commandList = _commandTree->_commandList(MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
     QVERIFY(commandList != nullptr);
 
     // Command 1 should have all values defaulted, no params
@@ -12,6 +12,7 @@
 #include "MultiVehicleManager.h"
 #include "MissionManager.h"
 #include "FlightPathSegment.h"
+#include "TerrainCollisionEngine.h"
 #include "FirmwarePlugin.h"
 #include "QGCApplication.h"
 #include "SimpleMissionItem.h"
@@ -28,10 +29,11 @@
 #include "MissionSettingsItem.h"
 #include "QGCQGeoCoordinate.h"
 #include "PlanMasterController.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanWriter.h"
 #include "QGCCorePlugin.h"
 #include "TakeoffMissionItem.h"
 #include "PlanViewSettings.h"
+#include "QGC.h"
 
 #define UPDATE_TIMEOUT 5000 ///< How often we check for bounding box changes
 
@@ -77,6 +79,9 @@ MissionController::MissionController(PlanMasterController* masterController, QOb
     qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::_recalcMissionFlightStatusSignal));
     qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::_recalcFlightPathSegmentsSignal));
     qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::recalcTerrainProfile));
+
+    // Terrain profiles for all segments, including those inside complex items, come through as a single update
+    connect(TerrainCollisionEngine::instance(), &TerrainCollisionEngine::terrainProfilesUpdated, this, &MissionController::recalcTerrainProfile, Qt::QueuedConnection);
 }
 
 MissionController::~MissionController()
@@ -276,7 +281,7 @@ bool MissionController::_convertToMissionItems(QmlObjectListModel* visualMission
     return endActionSet;
 }
 
-void MissionController::addMissionToKML(KMLPlanDomDocument& planKML)
+void MissionController::addMissionToKML(KMLPlanWriter& planKML)
 {
     QObject*            deleteParent = new QObject();
     QList<MissionItem*> rgMissionItems;
@@ -1111,19 +1116,19 @@ void MissionController::save(QJsonObject& json)
         visualItem->save(rgJsonMissionItems);
     }
 
-    // Mission settings has a special case for end mission action
+    // Mission settings has a special case for end mission action. Only the end action is needed here, so the rest of the
+    // mission is not converted to mission items just to be thrown away.
     if (settingsItem) {
         QList<MissionItem*> rgMissionItems;
+        VisualMissionItem*  lastItem = qobject_cast<VisualMissionItem*>(_visualItems->get(_visualItems->count() - 1));
 
-        if (_convertToMissionItems(_visualItems, rgMissionItems, this /* missionItemParent */)) {
+        if (settingsItem->addMissionEndAction(rgMissionItems, lastItem->lastSequenceNumber() + 1, this /* missionItemParent */)) {
             QJsonObject saveObject;
             MissionItem* missionItem = rgMissionItems[rgMissionItems.count() - 1];
             missionItem->save(saveObject);
             rgJsonMissionItems.append(saveObject);
         }
-        for (int i=0; i<rgMissionItems.count(); i++) {
-            rgMissionItems[i]->deleteLater();
-        }
+        qDeleteAll(rgMissionItems);
     }
 
     json[_jsonItemsKey] = rgJsonMissionItems;
@@ -1174,13 +1179,11 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     connect(pair.second, &VisualMissionItem::coordinateChanged,     segment,    &FlightPathSegment::setCoordinate2);
     connect(pair.second, &VisualMissionItem::amslEntryAltChanged,   segment,    &FlightPathSegment::setCoord2AMSLAlt);
 
-    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_itemFlightStatusChanged);
 
     connect(segment,    &FlightPathSegment::totalDistanceChanged,       this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::amslTerrainHeightsChanged,  this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
+    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_itemFlightStatusChanged);
+    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_itemFlightStatusChanged);
 
     return segment;
 }
@@ -1197,11 +1200,53 @@ FlightPathSegment* MissionController::_addFlightPathSegment(FlightPathSegmentHas
         _flightPathSegmentHashTable[pair] = segment;
     }
 
-    _simpleFlightPathSegments.append(segment);
-
     return segment;
 }
 
+void MissionController::_updateSegmentModel(QmlObjectListModel& model, const QObjectList& segments)
+{
+    // Segments which stay keep their relative order, so the model can be brought up to date with just the removals and
+    // insertions. That way the map only creates and destroys the lines which actually changed.
+    QSet<QObject*> newSegments;
+    for (QObject* segment: segments) {
+        newSegments.insert(segment);
+    }
+    for (int i=model.count()-1; i>=0; i--) {
+        if (!newSegments.contains(model[i])) {
+            model.removeAt(i);
+        }
+    }
+
+    QSet<QObject*> keptSegments;
+    for (int i=0; i<model.count(); i++) {
+        keptSegments.insert(model[i]);
+    }
+
+    int index = 0;
+    while (index < segments.count()) {
+        if (index < model.count() && model[index] == segments[index]) {
+            index++;
+            continue;
+        }
+        if (keptSegments.contains(segments[index])) {
+            // Kept segment out of order, not worth trying to be clever
+            model.swapObjectList(segments);
+            return;
+        }
+
+        QObjectList insertSegments;
+        while (index + insertSegments.count() < segments.count() && !keptSegments.contains(segments[index + insertSegments.count()])) {
+            insertSegments.append(segments[index + insertSegments.count()]);
+        }
+        model.insert(index, insertSegments);
+        index += insertSegments.count();
+    }
+
+    if (model.count() != segments.count()) {
+        model.swapObjectList(segments);
+    }
+}
+
 void MissionController::_recalcROISpecialVisuals(void)
 {
     return;
@@ -1250,7 +1295,9 @@ void MissionController::_recalcFlightPathSegments(void)
 
     qCDebug(MissionControllerLog) << "_recalcFlightPathSegments homePositionValid" << homePositionValid;
 
-    FlightPathSegmentHashTable oldSegmentTable = _flightPathSegmentHashTable;
+    FlightPathSegmentHashTable  oldSegmentTable = _flightPathSegmentHashTable;
+    QObjectList                 simpleFlightPathSegments;
+    QObjectList                 directionArrows;
 
     _missionContainsVTOLTakeoff = false;
     _flightPathSegmentHashTable.clear();
@@ -1260,13 +1307,11 @@ void MissionController::_recalcFlightPathSegments(void)
     // This is due to the initial implementation being buggy and incomplete with respect to correctly generating the line set.
     // So for now we leave the code for displaying them in, but none are ever added until we have time to implement the correct support.
 
-    _simpleFlightPathSegments.beginReset();
-    _directionArrows.beginReset();
-    _incompleteComplexItemLines.beginReset();
-
-    _simpleFlightPathSegments.clear();
-    _directionArrows.clear();
-    _incompleteComplexItemLines.clearAndDeleteContents();
+    if (_incompleteComplexItemLines.count()) {
+        _incompleteComplexItemLines.beginReset();
+        _incompleteComplexItemLines.clearAndDeleteContents();
+        _incompleteComplexItemLines.endReset();
+    }
 
     // Mission Settings item needs to start with no segment
     lastFlyThroughVI->clearSimpleFlighPathSegment();
@@ -1350,8 +1395,9 @@ void MissionController::_recalcFlightPathSegments(void)
                     if (!_flyView || addDirectionArrow) {
                         FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair);
                         segment->setSpecialVisual(roiActive);
+                        simpleFlightPathSegments.append(segment);
                         if (addDirectionArrow) {
-                            _directionArrows.append(segment);
+                            directionArrows.append(segment);
                         }
                         lastFlyThroughVI->setSimpleFlighPathSegment(segment);
                     }
@@ -1374,6 +1420,7 @@ void MissionController::_recalcFlightPathSegments(void)
         }
         FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair);
         segment->setSpecialVisual(roiActive);
+        simpleFlightPathSegments.append(segment);
         lastFlyThroughVI->setSimpleFlighPathSegment(segment);
     }
 
@@ -1401,17 +1448,16 @@ void MissionController::_recalcFlightPathSegments(void)
             _flightPathSegmentHashTable[lastSegmentVisualItemPair] = coordVector;
         }
 
-        _directionArrows.append(coordVector);
+        directionArrows.append(coordVector);
     }
 
-    _simpleFlightPathSegments.endReset();
-    _directionArrows.endReset();
-    _incompleteComplexItemLines.endReset();
+    _updateSegmentModel(_simpleFlightPathSegments, simpleFlightPathSegments);
+    _updateSegmentModel(_directionArrows, directionArrows);
 
     // Anything left in the old table is an obsolete line object that can go
     qDeleteAll(oldSegmentTable);
 
-    emit _recalcMissionFlightStatusSignal();
+    _setFlightStatusDirty(0);
 
     if (_waypointPath.count() == 0) {
         // MapPolyLine has a bug where if you change from a path which has elements to an empty path the line drawn
@@ -1485,42 +1531,110 @@ void MissionController::_addTimeDistance(bool vtolInHover, double hoverTime, dou
     }
 }
 
+void MissionController::_setFlightStatusDirty(int visualItemIndex)
+{
+    _flightStatusDirtyIndex = qMin(_flightStatusDirtyIndex, qMax(visualItemIndex, 0));
+    emit _recalcMissionFlightStatusSignal();
+}
+
+void MissionController::_itemFlightStatusChanged(void)
+{
+    // Changes to an item only affect the flight status from that item forward. For segments the walk restarts from
+    // the first item of the pair since altitude changes there come from its exit altitude.
+    VisualMissionItem* visualItem = qobject_cast<VisualMissionItem*>(sender());
+    FlightPathSegment* segment = qobject_cast<FlightPathSegment*>(sender());
+    if (segment) {
+        visualItem = _flightPathSegmentHashTable.key(segment).first;
+    }
+
+    _setFlightStatusDirty(visualItem ? _visualItems->indexOf(visualItem) : 0);
+}
+
+void MissionController::_vehicleFlightStatusChanged(void)
+{
+    // Default speeds are used from the start of the mission
+    _setFlightStatusDirty(0);
+}
+
+int MissionController::_flightStatusRestartIndex(void)
+{
+    int restartIndex = _flightStatusDirtyIndex;
+
+    if (restartIndex >= _visualItems->count() || restartIndex >= _flightStatusWalkStates.count()) {
+        // Nothing specific is known to have changed, so don't trust any of the saved state
+        return 0;
+    }
+
+    // The state saved ahead of an item is only good if none of the items before it have been replaced or moved
+    for (int i=0; i<restartIndex; i++) {
+        if (_flightStatusWalkStates[i].visualItem != _visualItems->get(i)) {
+            return i;
+        }
+    }
+
+    return restartIndex;
+}
+
 void MissionController::_recalcMissionFlightStatus()
 {
     if (!_visualItems->count()) {
         return;
     }
 
-    bool                firstCoordinateItem =           true;
-    VisualMissionItem*  lastFlyThroughVI =   qobject_cast<VisualMissionItem*>(_visualItems->get(0));
+    int                 restartIndex =          _flightStatusRestartIndex();
+    double              prevMinAMSLAltitude =   _minAMSLAltitude;
+    double              prevMaxAMSLAltitude =   _maxAMSLAltitude;
+    bool                firstCoordinateItem =   true;
+    VisualMissionItem*  lastFlyThroughVI =      qobject_cast<VisualMissionItem*>(_visualItems->get(0));
+    bool                linkStartToHome =       false;
+    bool                foundRTL =              false;
+    double              totalHorizontalDistance = 0;
 
     bool homePositionValid = _settingsItem->coordinate().isValid();
 
-    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus";
+    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus restartIndex" << restartIndex << _visualItems->count();
+
+    // Anything signalled while walking the items below will trigger a new recalc from that item
+    _flightStatusDirtyIndex = _visualItems->count();
 
     // If home position is valid we can calculate distances between all waypoints.
     // If home position is not valid we can only calculate distances between waypoints which are
     // both relative altitude.
 
-    // No values for first item
-    lastFlyThroughVI->setAltDifference(0);
-    lastFlyThroughVI->setAzimuth(0);
-    lastFlyThroughVI->setDistance(0);
-    lastFlyThroughVI->setDistanceFromStart(0);
+    if (restartIndex == 0) {
+        // No values for first item
+        lastFlyThroughVI->setAltDifference(0);
+        lastFlyThroughVI->setAzimuth(0);
+        lastFlyThroughVI->setDistance(0);
+        lastFlyThroughVI->setDistanceFromStart(0);
 
-    _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
+        _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
-    _resetMissionFlightStatus();
+        _resetMissionFlightStatus();
+    } else {
+        // Pick up from where the last walk was when it got to the first changed item
+        const FlightStatusWalkState_t& walkState = _flightStatusWalkStates[restartIndex];
 
-    bool   linkStartToHome =            false;
-    bool   foundRTL =                   false;
-    double totalHorizontalDistance =    0;
+        _missionFlightStatus =      walkState.missionFlightStatus;
+        lastFlyThroughVI =          walkState.lastFlyThroughVI;
+        firstCoordinateItem =       walkState.firstCoordinateItem;
+        linkStartToHome =           walkState.linkStartToHome;
+        foundRTL =                  walkState.foundRTL;
+        totalHorizontalDistance =   walkState.totalHorizontalDistance;
+        _minAMSLAltitude =          walkState.minAMSLAltitude;
+        _maxAMSLAltitude =          walkState.maxAMSLAltitude;
+    }
 
-    for (int i=0; i<_visualItems->count(); i++) {
+    _flightStatusWalkStates.resize(restartIndex);
+    _flightStatusWalkStates.reserve(_visualItems->count());
+
+    for (int i=restartIndex; i<_visualItems->count(); i++) {
         VisualMissionItem*  item =          qobject_cast<VisualMissionItem*>(_visualItems->get(i));
         SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(item);
         ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(item);
 
+        _flightStatusWalkStates.append({ item, _missionFlightStatus, lastFlyThroughVI, firstCoordinateItem, linkStartToHome, foundRTL, totalHorizontalDistance, _minAMSLAltitude, _maxAMSLAltitude });
+
         if (simpleItem && simpleItem->mavCommand() == MAV_CMD_NAV_RETURN_TO_LAUNCH) {
             foundRTL = true;
         }
@@ -1729,9 +1843,10 @@ void MissionController::_recalcMissionFlightStatus()
     emit minAMSLAltitudeChanged         (_minAMSLAltitude);
     emit maxAMSLAltitudeChanged         (_maxAMSLAltitude);
 
-    // Walk the list again calculating altitude percentages
-    double altRange = _maxAMSLAltitude - _minAMSLAltitude;
-    for (int i=0; i<_visualItems->count(); i++) {
+    // Walk the list again calculating altitude percentages. Items ahead of the restart only need updating if the range moved.
+    bool altRangeChanged =  !QGC::fuzzyCompare(prevMinAMSLAltitude, _minAMSLAltitude) || !QGC::fuzzyCompare(prevMaxAMSLAltitude, _maxAMSLAltitude);
+    double altRange =       _maxAMSLAltitude - _minAMSLAltitude;
+    for (int i=altRangeChanged ? 0 : restartIndex; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
 
         if (item->specifiesCoordinate()) {
@@ -1915,13 +2030,13 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     setDirty(false);
 
     connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_itemFlightStatusChanged);
     connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
 
     if (visualItem->isSimpleItem()) {
@@ -1935,10 +2050,10 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     } else {
         ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(visualItem);
         if (complexItem) {
-            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_itemFlightStatusChanged);
             connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
         } else {
             qWarning() << "ComplexMissionItem not found";
@@ -1983,8 +2098,8 @@ void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
     connect(_missionManager, &MissionManager::lastCurrentIndexChanged,  this, &MissionController::resumeMissionIndexChanged);
     connect(_missionManager, &MissionManager::resumeMissionReady,       this, &MissionController::resumeMissionReady);
     connect(_missionManager, &MissionManager::resumeMissionUploadFail,  this, &MissionController::resumeMissionUploadFail);
-    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_vehicleFlightStatusChanged);
+    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_vehicleFlightStatusChanged);
     connect(_managerVehicle, &Vehicle::vehicleTypeChanged,              this, &MissionController::complexMissionItemNamesChanged);
 
     emit complexMissionItemNamesChanged();
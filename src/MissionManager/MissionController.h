@@ -13,11 +13,12 @@
 #include "QmlObjectListModel.h"
 #include "Vehicle.h"
 #include "QGCLoggingCategory.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanWriter.h"
 #include "QGCGeoBoundingCube.h"
 #include "QGroundControlQmlGlobal.h"
 
 #include <QHash>
+#include <QVector>
 
 class FlightPathSegment;
 class VisualMissionItem;
@@ -214,7 +215,7 @@ public:
     bool showPlanFromManagerVehicle (void) final;
 
     // Create KML file
-    void addMissionToKML(KMLPlanDomDocument& planKML);
+    void addMissionToKML(KMLPlanWriter& planKML);
 
     // Property accessors
 
@@ -316,8 +317,24 @@ private slots:
     void _recalcAll                             (void);
     void _managerVehicleChanged                 (Vehicle* managerVehicle);
     void _takeoffItemNotRequiredChanged         (void);
+    void _itemFlightStatusChanged               (void);
+    void _vehicleFlightStatusChanged            (void);
 
 private:
+    /// State of the flight status walk ahead of processing a visual item. Saved for each item so the walk can restart
+    /// from the first changed item instead of from the start of the mission.
+    typedef struct {
+        VisualMissionItem*      visualItem;             ///< Item at this index when the state was saved
+        MissionFlightStatus_t   missionFlightStatus;
+        VisualMissionItem*      lastFlyThroughVI;
+        bool                    firstCoordinateItem;
+        bool                    linkStartToHome;
+        bool                    foundRTL;
+        double                  totalHorizontalDistance;
+        double                  minAMSLAltitude;
+        double                  maxAMSLAltitude;
+    } FlightStatusWalkState_t;
+
     void                    _init                               (void);
     void                    _recalcSequence                     (void);
     void                    _recalcChildItems                   (void);
@@ -343,9 +360,12 @@ private:
     void                    _addHoverTime                       (double hoverTime, double hoverDistance, int waypointIndex);
     void                    _addCruiseTime                      (double cruiseTime, double cruiseDistance, int wayPointIndex);
     void                    _updateBatteryInfo                  (int waypointIndex);
+    void                    _setFlightStatusDirty               (int visualItemIndex);
+    int                     _flightStatusRestartIndex           (void);
     bool                    _loadItemsFromJson                  (const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString);
     void                    _initLoadedVisualItems              (QmlObjectListModel* loadedVisualItems);
     FlightPathSegment*      _addFlightPathSegment               (FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair);
+    void                    _updateSegmentModel                 (QmlObjectListModel& model, const QObjectList& segments);
     void                    _addTimeDistance                    (bool vtolInHover, double hoverTime, double cruiseTime, double extraTime, double distance, int seqNum);
     VisualMissionItem*      _insertSimpleMissionItemWorker      (QGeoCoordinate coordinate, MAV_CMD command, int visualItemIndex, bool makeCurrentItem);
     void                    _insertComplexMissionItemWorker     (const QGeoCoordinate& mapCenterCoordinate, ComplexMissionItem* complexItem, int visualItemIndex, bool makeCurrentItem);
@@ -377,6 +397,8 @@ private:
     bool                        _itemsRequested =               false;
     bool                        _inRecalcSequence =             false;
     MissionFlightStatus_t       _missionFlightStatus;
+    int                         _flightStatusDirtyIndex =       0;                  ///< First visual item index which needs its flight status recalculated
+    QVector<FlightStatusWalkState_t> _flightStatusWalkStates;                       ///< Indexed by visual item index
     AppSettings*                _appSettings =                  nullptr;
     double                      _progressPct =                  0;
     int                         _currentPlanViewSeqNum =        -1;
@@ -269,6 +269,9 @@ bool MissionItem::load(const QJsonObject& json, int sequenceNumber, QString& err
         return false;
     }
 
+    // Read through a const reference, using operator[] on the non-const object would detach it from the document
+    const QJsonObject& v3Json = convertedJson;
+
     QList<JsonHelper::KeyValidateInfo> keyInfoList = {
         { VisualMissionItem::jsonTypeKey,   QJsonValue::String, true },
         { _jsonFrameKey,                    QJsonValue::Double, true },
@@ -277,16 +280,16 @@ bool MissionItem::load(const QJsonObject& json, int sequenceNumber, QString& err
         { _jsonAutoContinueKey,             QJsonValue::Bool,   true },
         { _jsonDoJumpIdKey,                 QJsonValue::Double, false },
     };
-    if (!JsonHelper::validateKeys(convertedJson, keyInfoList, errorString)) {
+    if (!JsonHelper::validateKeys(v3Json, keyInfoList, errorString)) {
         return false;
     }
 
-    if (convertedJson[VisualMissionItem::jsonTypeKey] != VisualMissionItem::jsonTypeSimpleItemValue) {
-        errorString = tr("Type found: %1 must be: %2").arg(convertedJson[VisualMissionItem::jsonTypeKey].toString()).arg(VisualMissionItem::jsonTypeSimpleItemValue);
+    if (v3Json[VisualMissionItem::jsonTypeKey] != VisualMissionItem::jsonTypeSimpleItemValue) {
+        errorString = tr("Type found: %1 must be: %2").arg(v3Json[VisualMissionItem::jsonTypeKey].toString()).arg(VisualMissionItem::jsonTypeSimpleItemValue);
         return false;
     }
 
-    QJsonArray rgParams = convertedJson[_jsonParamsKey].toArray();
+    const QJsonArray rgParams = v3Json[_jsonParamsKey].toArray();
     if (rgParams.count() != 7) {
         errorString = tr("%1 key must contains 7 values").arg(_jsonParamsKey);
         return false;
@@ -300,16 +303,16 @@ bool MissionItem::load(const QJsonObject& json, int sequenceNumber, QString& err
     }
 
     // Make sure to set these first since they can signal other changes
-    setCommand((MAV_CMD)convertedJson[_jsonCommandKey].toInt());
-    setFrame((MAV_FRAME)convertedJson[_jsonFrameKey].toInt());
+    setCommand((MAV_CMD)v3Json[_jsonCommandKey].toInt());
+    setFrame((MAV_FRAME)v3Json[_jsonFrameKey].toInt());
 
     _doJumpId = -1;
-    if (convertedJson.contains(_jsonDoJumpIdKey)) {
-        _doJumpId = convertedJson[_jsonDoJumpIdKey].toInt();
+    if (v3Json.contains(_jsonDoJumpIdKey)) {
+        _doJumpId = v3Json[_jsonDoJumpIdKey].toInt();
     }
     setIsCurrentItem(false);
     setSequenceNumber(sequenceNumber);
-    setAutoContinue(convertedJson[_jsonAutoContinueKey].toBool());
+    setAutoContinue(v3Json[_jsonAutoContinueKey].toBool());
 
     setParam1(JsonHelper::possibleNaNJsonValue(rgParams[0]));
     setParam2(JsonHelper::possibleNaNJsonValue(rgParams[1]));
@@ -101,8 +101,9 @@ void MissionSettingsItem::save(QJsonArray&  missionItems)
         QJsonObject saveObject;
         item->save(saveObject);
         missionItems.append(saveObject);
-        item->deleteLater();
     }
+
+    qDeleteAll(items);
 }
 
 void MissionSettingsItem::setSequenceNumber(int sequenceNumber)
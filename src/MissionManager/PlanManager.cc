@@ -14,6 +14,16 @@
 #include "QGCApplication.h"
 #include "MissionCommandTree.h"
 #include "MissionCommandUIInfo.h"
+#include "FTPManager.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QtEndian>
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
@@ -38,7 +48,7 @@ PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
 
 PlanManager::~PlanManager()
 {
-
+    delete _ftpTempDir;
 }
 
 void PlanManager::_writeMissionItemsWorker(void)
@@ -57,6 +67,9 @@ void PlanManager::_writeMissionItemsWorker(void)
 
     _retryCount = 0;
     _setTransactionInProgress(TransactionWrite);
+    if (_useFTP() && _startFTPUpload()) {
+        return;
+    }
     _connectToMavlink();
     _writeMissionCount();
 }
@@ -134,8 +147,15 @@ void PlanManager::loadFromVehicle(void)
         return;
     }
 
+    // Over high latency links keeping several requests in flight makes the read time depend on bandwidth rather than
+    // round trip time. Stacks which can't handle that, or where it didn't work before, get one request at a time.
+    _readWindowSize = _readWindowFailed ? 1 : qMax(1, _vehicle->firmwarePlugin()->missionReadWindowSize());
+
     _retryCount = 0;
     _setTransactionInProgress(TransactionRead);
+    if (_useFTP() && _startFTPDownload()) {
+        return;
+    }
     _connectToMavlink();
     _requestList();
 }
@@ -145,7 +165,6 @@ void PlanManager::_requestList(void)
 {
     qCDebug(PlanManagerLog) << QStringLiteral("_requestList %1 _planType:_retryCount").arg(_planTypeString()) << _planType << _retryCount;
 
-    _itemIndicesToRead.clear();
     _clearMissionItems();
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
@@ -196,6 +215,8 @@ void PlanManager::_ackTimeout(void)
         } else {
             _retryCount++;
             qCDebug(PlanManagerLog) << tr("Retrying %1 MISSION_REQUEST retry Count").arg(_planTypeString()) << _retryCount;
+            // Only the items which are still missing are requested again
+            _itemIndicesRequested.clear();
             _requestNextMissionItem();
         }
         break;
@@ -215,11 +236,18 @@ void PlanManager::_ackTimeout(void)
                 qCDebug(PlanManagerLog) << QStringLiteral("Retrying %1 MISSION_COUNT retry Count").arg(_planTypeString()) << _retryCount;
                 _writeMissionCount();
             }
-        } else {
+        } else if (_retryCount > _maxRetryCount) {
             // Vehicle did not request all items from ground station
             _sendError(ProtocolError, tr("Vehicle did not request all items from ground station: %1").arg(_ackTypeToString(_expectedAck)));
             _expectedAck = AckNone;
             _finishTransaction(false);
+        } else {
+            // Either our last item or the request for the next one was lost. Sending the last item again either
+            // delivers it or prompts the vehicle to repeat its request, so the upload carries on from where it stopped
+            // instead of failing the whole transfer.
+            _retryCount++;
+            qCDebug(PlanManagerLog) << QStringLiteral("Retrying %1 MISSION_ITEM sequence:retry Count").arg(_planTypeString()) << _lastMissionRequest << _retryCount;
+            _sendMissionItem(_lastMissionRequest, _lastRequestItemInt);
         }
         break;
     case AckMissionClearAll:
@@ -351,7 +379,25 @@ void PlanManager::_requestNextMissionItem(void)
         return;
     }
 
-    qCDebug(PlanManagerLog) << QStringLiteral("_requestNextMissionItem %1 sequenceNumber:retry").arg(_planTypeString()) << _itemIndicesToRead[0] << _retryCount;
+    if (_readWindowSize > 1) {
+        // Keep the window full. Items still to read are in sequence order and are requested from the front, so the
+        // outstanding requests are always at the front of the list.
+        for (int i=0; i<_itemIndicesToRead.count() && _itemIndicesRequested.count() < _readWindowSize; i++) {
+            int sequenceNumber = _itemIndicesToRead[i];
+            if (!_itemIndicesRequested.contains(sequenceNumber)) {
+                _itemIndicesRequested.append(sequenceNumber);
+                _sendMissionRequest(sequenceNumber);
+            }
+        }
+    } else {
+        _sendMissionRequest(_itemIndicesToRead[0]);
+    }
+    _startAckTimeout(AckMissionItem);
+}
+
+void PlanManager::_sendMissionRequest(int sequenceNumber)
+{
+    qCDebug(PlanManagerLog) << QStringLiteral("_sendMissionRequest %1 sequenceNumber:retry").arg(_planTypeString()) << sequenceNumber << _retryCount;
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -365,7 +411,7 @@ void PlanManager::_requestNextMissionItem(void)
                                                       &message,
                                                       _vehicle->id(),
                                                       MAV_COMP_ID_AUTOPILOT1,
-                                                      _itemIndicesToRead[0],
+                                                      sequenceNumber,
                     _planType);
         } else {
             mavlink_msg_mission_request_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
@@ -374,13 +420,12 @@ void PlanManager::_requestNextMissionItem(void)
                                                   &message,
                                                   _vehicle->id(),
                                                   MAV_COMP_ID_AUTOPILOT1,
-                                                  _itemIndicesToRead[0],
+                                                  sequenceNumber,
                     _planType);
         }
 
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
-    _startAckTimeout(AckMissionItem);
 }
 
 void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool missionItemInt)
@@ -397,6 +442,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
     bool        autoContinue;
     bool        isCurrentItem;
     int         seq;
+    int         missionType;
 
     if (missionItemInt) {
         mavlink_mission_item_int_t missionItem;
@@ -414,6 +460,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
         autoContinue =  missionItem.autocontinue;
         isCurrentItem = missionItem.current;
         seq =           missionItem.seq;
+        missionType =   missionItem.mission_type;
     } else {
         mavlink_mission_item_t missionItem;
         mavlink_msg_mission_item_decode(&message, &missionItem);
@@ -430,6 +477,13 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
         autoContinue =  missionItem.autocontinue;
         isCurrentItem = missionItem.current;
         seq =           missionItem.seq;
+        missionType =   missionItem.mission_type;
+    }
+
+    if (missionType != _planType) {
+        // Items for another plan type which is being transferred at the same time
+        qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 Incorrect mission_type received expected:actual").arg(_planTypeString()) << _planType << missionType;
+        return;
     }
 
     // We don't support editing ALT_INT frames so change on the way in.
@@ -459,6 +513,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
     
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
+        _itemIndicesRequested.removeOne(seq);
 
         MissionItem* item = new MissionItem(seq,
                                             command,
@@ -487,10 +542,14 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
         return;
     }
 
-    emit progressPct((double)seq / (double)_missionItemCountToRead);
+    // Items can come back out of order during a windowed read
+    emit progressPct((double)(_missionItemCountToRead - _itemIndicesToRead.count()) / (double)_missionItemCountToRead);
     
     _retryCount = 0;
     if (_itemIndicesToRead.count() == 0) {
+        if (_readWindowSize > 1) {
+            std::sort(_missionItems.begin(), _missionItems.end(), [](const MissionItem* item1, const MissionItem* item2) { return item1->sequenceNumber() < item2->sequenceNumber(); });
+        }
         _readTransactionComplete();
     } else {
         _requestNextMissionItem();
@@ -500,6 +559,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
 void PlanManager::_clearMissionItems(void)
 {
     _itemIndicesToRead.clear();
+    _itemIndicesRequested.clear();
     _clearAndDeleteMissionItems();
 }
 
@@ -542,14 +602,25 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message, bool m
     emit progressPct((double)missionRequestSeq / (double)_writeMissionItems.count());
 
     _lastMissionRequest = missionRequestSeq;
+    _lastRequestItemInt = missionItemInt;
     if (!_itemIndicesToWrite.contains(missionRequestSeq)) {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequence number requested which has already been sent, sending again:").arg(_planTypeString()) << missionRequestSeq;
     } else {
         _itemIndicesToWrite.removeOne(missionRequestSeq);
+        // Retries are counted per item
+        _retryCount = 0;
     }
-    
-    MissionItem* item = _writeMissionItems[missionRequestSeq];
-    qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item->command();
+
+    _sendMissionItem(missionRequestSeq, missionItemInt);
+}
+
+/// Sends the specified item of the plan being written. Requests are answered as soon as they come in, so vehicles
+/// which keep several requests outstanding get them back to back.
+void PlanManager::_sendMissionItem(int sequenceNumber, bool missionItemInt)
+{
+    uint16_t        missionRequestSeq   = static_cast<uint16_t>(sequenceNumber);
+    MissionItem*    item                = _writeMissionItems[sequenceNumber];
+    qCDebug(PlanManagerLog) << QStringLiteral("_sendMissionItem %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item->command();
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -867,6 +938,7 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
     _disconnectFromMavlink();
 
     _itemIndicesToRead.clear();
+    _itemIndicesRequested.clear();
     _itemIndicesToWrite.clear();
 
     // First thing we do is clear the transaction. This way inProgesss is off when we signal transaction complete.
@@ -878,6 +950,10 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
         if (!success) {
             // Read from vehicle failed, clear partial list
             _clearAndDeleteMissionItems();
+            if (_readWindowSize > 1) {
+                qCDebug(PlanManagerLog) << QStringLiteral("_finishTransaction %1 windowed read failed, using strict reads from now on").arg(_planTypeString());
+                _readWindowFailed = true;
+            }
         }
         emit newMissionItemsAvailable(false);
         break;
@@ -1018,6 +1094,245 @@ QString PlanManager::_planTypeString(void)
     }
 }
 
+/// @return true: Plans of this type should be transferred as a single file over MAVLink FTP
+bool PlanManager::_useFTP(void)
+{
+    return !_ftpFailed &&
+            (_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_FTP) &&
+            !_vehicle->firmwarePlugin()->missionFTPPath(_planType).isEmpty() &&
+            qgcApp()->toolbox()->settingsManager()->appSettings()->useMissionFTP()->rawValue().toBool();
+}
+
+/// Starts the download of the plan file from the vehicle.
+/// @return false: download could not be started, the mission protocol should be used instead
+bool PlanManager::_startFTPDownload(void)
+{
+    FTPManager* ftpManager = _vehicle->ftpManager();
+
+    delete _ftpTempDir;
+    _ftpTempDir = new QTemporaryDir();
+    if (!_ftpTempDir->isValid()) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_startFTPDownload %1 unable to create temporary directory").arg(_planTypeString());
+        _finishFTPTransfer();
+        return false;
+    }
+
+    connect(ftpManager, &FTPManager::downloadComplete,  this, &PlanManager::_ftpDownloadComplete);
+    connect(ftpManager, &FTPManager::commandProgress,   this, &PlanManager::_ftpProgress);
+    if (!ftpManager->download(_vehicle->firmwarePlugin()->missionFTPPath(_planType), _ftpTempDir->path())) {
+        // Invalid FTP path from the firmware plugin
+        qCDebug(PlanManagerLog) << QStringLiteral("_startFTPDownload %1 download failed to start").arg(_planTypeString());
+        _finishFTPTransfer();
+        return false;
+    }
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_startFTPDownload %1 started").arg(_planTypeString());
+    return true;
+}
+
+/// Starts the upload of _writeMissionItems to the vehicle as a plan file.
+/// @return false: upload could not be started, the mission protocol should be used instead
+bool PlanManager::_startFTPUpload(void)
+{
+    FTPManager* ftpManager = _vehicle->ftpManager();
+
+    delete _ftpTempDir;
+    _ftpTempDir = new QTemporaryDir();
+    QString file = _ftpTempDir->filePath(QStringLiteral("plan.dat"));
+    if (!_ftpTempDir->isValid() || !_writeMissionItemsToFTPFile(file)) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_startFTPUpload %1 unable to create plan file").arg(_planTypeString());
+        _finishFTPTransfer();
+        return false;
+    }
+
+    connect(ftpManager, &FTPManager::uploadComplete,    this, &PlanManager::_ftpUploadComplete);
+    connect(ftpManager, &FTPManager::commandProgress,   this, &PlanManager::_ftpProgress);
+    if (!ftpManager->upload(file, _vehicle->firmwarePlugin()->missionFTPPath(_planType))) {
+        // Invalid FTP path from the firmware plugin
+        qCDebug(PlanManagerLog) << QStringLiteral("_startFTPUpload %1 upload failed to start").arg(_planTypeString());
+        _finishFTPTransfer();
+        return false;
+    }
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_startFTPUpload %1 started count").arg(_planTypeString()) << _writeMissionItems.count();
+    return true;
+}
+
+void PlanManager::_finishFTPTransfer(void)
+{
+    FTPManager* ftpManager = _vehicle->ftpManager();
+
+    disconnect(ftpManager, &FTPManager::downloadComplete,   this, &PlanManager::_ftpDownloadComplete);
+    disconnect(ftpManager, &FTPManager::uploadComplete,     this, &PlanManager::_ftpUploadComplete);
+    disconnect(ftpManager, &FTPManager::commandProgress,    this, &PlanManager::_ftpProgress);
+
+    delete _ftpTempDir;
+    _ftpTempDir = nullptr;
+}
+
+/// The FTP manager is shared with the other plan types and the rest of the vehicle, transfers of this plan manager are
+/// the ones in its temporary directory.
+bool PlanManager::_isOwnFTPFile(const QString& file) const
+{
+    return _ftpTempDir && QFileInfo(file).absolutePath() == QDir(_ftpTempDir->path()).absolutePath();
+}
+
+void PlanManager::_ftpProgress(int value)
+{
+    emit progressPct(value / 100.0);
+}
+
+void PlanManager::_ftpDownloadComplete(const QString& file, const QString& errorMsg)
+{
+    if (!_isOwnFTPFile(file)) {
+        return;
+    }
+
+    bool success = errorMsg.isEmpty() && _ftpFileToMissionItems(file);
+
+    _finishFTPTransfer();
+
+    if (success) {
+        qCDebug(PlanManagerLog) << QStringLiteral("_ftpDownloadComplete %1 count").arg(_planTypeString()) << _missionItems.count();
+        _finishTransaction(true);
+        return;
+    }
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_ftpDownloadComplete %1 failed, using mission protocol from now on:").arg(_planTypeString()) << errorMsg;
+    _ftpFailed = true;
+    _connectToMavlink();
+    _requestList();
+}
+
+void PlanManager::_ftpUploadComplete(const QString& file, const QString& errorMsg)
+{
+    if (!_isOwnFTPFile(file)) {
+        return;
+    }
+
+    _finishFTPTransfer();
+
+    if (errorMsg.isEmpty()) {
+        qCDebug(PlanManagerLog) << QStringLiteral("_ftpUploadComplete %1").arg(_planTypeString());
+        _finishTransaction(true);
+        return;
+    }
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_ftpUploadComplete %1 failed, using mission protocol from now on:").arg(_planTypeString()) << errorMsg;
+    _ftpFailed = true;
+    _connectToMavlink();
+    _writeMissionCount();
+}
+
+/// Plan files start with a header followed by the items stored as packed MISSION_ITEM_INT structures:
+///     uint16 magic, uint16 MAV_MISSION_TYPE, uint16 options, uint16 first sequence number, uint16 item count
+/// Loads _missionItems from the specified plan file.
+bool PlanManager::_ftpFileToMissionItems(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_ftpFileToMissionItems %1 unable to open").arg(_planTypeString()) << fileName << file.errorString();
+        return false;
+    }
+    QByteArray      bytes = file.readAll();
+    const uchar*    data  = reinterpret_cast<const uchar*>(bytes.constData());
+
+    if (bytes.size() < _ftpFileHeaderSize) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_ftpFileToMissionItems %1 file too short").arg(_planTypeString()) << bytes.size();
+        return false;
+    }
+    uint16_t magic      = qFromLittleEndian<quint16>(data);
+    uint16_t planType   = qFromLittleEndian<quint16>(data + 2);
+    uint16_t start      = qFromLittleEndian<quint16>(data + 6);
+    uint16_t cItems     = qFromLittleEndian<quint16>(data + 8);
+    if (magic != _ftpFileMagic || planType != _planType || bytes.size() < _ftpFileHeaderSize + (cItems * static_cast<int>(sizeof(mavlink_mission_item_int_t)))) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_ftpFileToMissionItems %1 invalid file magic:planType:count:size").arg(_planTypeString()) << magic << planType << cItems << bytes.size();
+        return false;
+    }
+
+    _clearAndDeleteMissionItems();
+    for (int i=0; i<cItems; i++) {
+        mavlink_mission_item_int_t missionItem;
+        memcpy(&missionItem, data + _ftpFileHeaderSize + (i * sizeof(mavlink_mission_item_int_t)), sizeof(mavlink_mission_item_int_t));
+
+        // We don't support editing ALT_INT frames so change on the way in.
+        MAV_FRAME frame = static_cast<MAV_FRAME>(missionItem.frame);
+        if (frame == MAV_FRAME_GLOBAL_INT) {
+            frame = MAV_FRAME_GLOBAL;
+        } else if (frame == MAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
+            frame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
+        }
+
+        MissionItem* item = new MissionItem(start + i,
+                                            static_cast<MAV_CMD>(missionItem.command),
+                                            frame,
+                                            missionItem.param1,
+                                            missionItem.param2,
+                                            missionItem.param3,
+                                            missionItem.param4,
+                                            missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.x : (double)missionItem.x * 1e-7,
+                                            missionItem.frame == MAV_FRAME_MISSION ? (double)missionItem.y : (double)missionItem.y * 1e-7,
+                                            missionItem.z,
+                                            missionItem.autocontinue,
+                                            missionItem.current,
+                                            this);
+
+        if (item->command() == MAV_CMD_DO_JUMP && !_vehicle->firmwarePlugin()->sendHomePositionToVehicle()) {
+            // Home is in position 0
+            item->setParam1((int)item->param1() + 1);
+        }
+
+        _missionItems.append(item);
+    }
+
+    return true;
+}
+
+/// Writes _writeMissionItems to the specified file in the same layout _ftpFileToMissionItems reads
+bool PlanManager::_writeMissionItemsToFTPFile(const QString& fileName)
+{
+    QByteArray bytes(_ftpFileHeaderSize, 0);
+    uchar*     header = reinterpret_cast<uchar*>(bytes.data());
+
+    qToLittleEndian<quint16>(_ftpFileMagic,                                 header);
+    qToLittleEndian<quint16>(static_cast<quint16>(_planType),               header + 2);
+    qToLittleEndian<quint16>(0,                                             header + 4);
+    qToLittleEndian<quint16>(0,                                             header + 6);
+    qToLittleEndian<quint16>(static_cast<quint16>(_writeMissionItems.count()), header + 8);
+
+    bytes.reserve(_ftpFileHeaderSize + (_writeMissionItems.count() * static_cast<int>(sizeof(mavlink_mission_item_int_t))));
+    for (int i=0; i<_writeMissionItems.count(); i++) {
+        const MissionItem*          item        = _writeMissionItems[i];
+        mavlink_mission_item_int_t  missionItem = {};
+
+        missionItem.param1              = item->param1();
+        missionItem.param2              = item->param2();
+        missionItem.param3              = item->param3();
+        missionItem.param4              = item->param4();
+        missionItem.x                   = item->frame() == MAV_FRAME_MISSION ? item->param5() : item->param5() * 1e7;
+        missionItem.y                   = item->frame() == MAV_FRAME_MISSION ? item->param6() : item->param6() * 1e7;
+        missionItem.z                   = item->param7();
+        missionItem.seq                 = i;
+        missionItem.command             = item->command();
+        missionItem.target_system       = _vehicle->id();
+        missionItem.target_component    = MAV_COMP_ID_AUTOPILOT1;
+        missionItem.frame               = item->frame();
+        missionItem.current             = i == 0;
+        missionItem.autocontinue        = item->autoContinue();
+        missionItem.mission_type        = _planType;
+
+        bytes.append(reinterpret_cast<const char*>(&missionItem), sizeof(missionItem));
+    }
+
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(bytes) != bytes.size()) {
+        qCWarning(PlanManagerLog) << QStringLiteral("_writeMissionItemsToFTPFile %1 write failed").arg(_planTypeString()) << fileName << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
 void PlanManager::_setTransactionInProgress(TransactionType_t type)
 {
     if (_transactionInProgress  != type) {
@@ -12,6 +12,7 @@
 #include <QObject>
 #include <QLoggingCategory>
 #include <QTimer>
+#include <QTemporaryDir>
 
 #include "MissionItem.h"
 #include "QGCMAVLink.h"
@@ -91,6 +92,9 @@ signals:
 private slots:
     void _mavlinkMessageReceived(const mavlink_message_t& message);
     void _ackTimeout(void);
+    void _ftpDownloadComplete(const QString& file, const QString& errorMsg);
+    void _ftpUploadComplete(const QString& file, const QString& errorMsg);
+    void _ftpProgress(int value);
 
 protected:
     typedef enum {
@@ -115,8 +119,10 @@ protected:
     void _handleMissionCount(const mavlink_message_t& message);
     void _handleMissionItem(const mavlink_message_t& message, bool missionItemInt);
     void _handleMissionRequest(const mavlink_message_t& message, bool missionItemInt);
+    void _sendMissionItem(int sequenceNumber, bool missionItemInt);
     void _handleMissionAck(const mavlink_message_t& message);
     void _requestNextMissionItem(void);
+    void _sendMissionRequest(int sequenceNumber);
     void _clearMissionItems(void);
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
     QString _ackTypeToString(AckType_t ackType);
@@ -132,6 +138,13 @@ protected:
     void _connectToMavlink(void);
     void _disconnectFromMavlink(void);
     QString _planTypeString(void);
+    bool _useFTP(void);
+    bool _startFTPDownload(void);
+    bool _startFTPUpload(void);
+    void _finishFTPTransfer(void);
+    bool _isOwnFTPFile(const QString& file) const;
+    bool _ftpFileToMissionItems(const QString& fileName);
+    bool _writeMissionItemsToFTPFile(const QString& fileName);
 
 protected:
     Vehicle*            _vehicle =              nullptr;
@@ -147,7 +160,13 @@ protected:
     QList<int>          _itemIndicesToWrite;    ///< List of mission items which still need to be written to vehicle
     QList<int>          _itemIndicesToRead;     ///< List of mission items which still need to be requested from vehicle
     int                 _lastMissionRequest;    ///< Index of item last requested by MISSION_REQUEST
+    bool                _lastRequestItemInt =   false;  ///< Last MISSION_REQUEST was a MISSION_REQUEST_INT
     int                 _missionItemCountToRead;///< Count of all mission items to read
+    QList<int>          _itemIndicesRequested;  ///< Items requested which have not come back yet, windowed reads only
+    int                 _readWindowSize =       1;      ///< Requests kept outstanding during a read, 1 is strict one at a time
+    bool                _readWindowFailed =     false;  ///< A windowed read failed with this vehicle, only use strict reads from now on
+    bool                _ftpFailed =            false;  ///< A transfer over FTP failed with this vehicle, only use the mission protocol from now on
+    QTemporaryDir*      _ftpTempDir =           nullptr;///< Holds the plan file while an FTP transfer is in progress
 
     QList<MissionItem*> _missionItems;          ///< Set of mission items on vehicle
     QList<MissionItem*> _writeMissionItems;     ///< Set of mission items currently being written to vehicle
@@ -156,4 +175,7 @@ protected:
 
 private:
     void _setTransactionInProgress(TransactionType_t type);
+
+    static const int        _ftpFileHeaderSize  = 10;
+    static const quint16    _ftpFileMagic       = 0x763d;   ///< Matches AP_Filesystem_Mission
 };
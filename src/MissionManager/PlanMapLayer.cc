@@ -0,0 +1,424 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "PlanMapLayer.h"
+#include "MissionController.h"
+#include "VisualMissionItem.h"
+#include "FlightPathSegment.h"
+#include "QGCMapPolygon.h"
+#include "QmlObjectListModel.h"
+#include "QGCApplication.h"
+#include "QGCGeo.h"
+
+#include <QMouseEvent>
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+
+QGC_LOGGING_CATEGORY(PlanMapLayerLog, "PlanMapLayerLog")
+
+static const char* kSimpleItemMapVisual = "SimpleItemMapVisual.qml";
+
+PlanMapLayer::PlanMapLayer(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+    _updateMouseButtons();
+
+    connect(this, &PlanMapLayer::centerChanged,         this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::zoomLevelChanged,      this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::bearingChanged,        this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::showMarkersChanged,    this, &PlanMapLayer::_itemsChangedSignal);
+    connect(this, &PlanMapLayer::showLinesChanged,      this, &PlanMapLayer::_itemsChangedSignal);
+    connect(this, &PlanMapLayer::markerRadiusChanged,   this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::lineWidthChanged,      this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::vertexRadiusChanged,   this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::maxLabelsChanged,      this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::maxHandlesChanged,     this, &PlanMapLayer::_layoutSignal);
+    connect(this, &QQuickItem::widthChanged,            this, &PlanMapLayer::_layoutSignal);
+    connect(this, &QQuickItem::heightChanged,           this, &PlanMapLayer::_layoutSignal);
+    connect(this, &PlanMapLayer::colorsChanged,         this, &QQuickItem::update);
+    connect(this, &PlanMapLayer::showMarkersChanged,    this, &PlanMapLayer::_updateMouseButtons);
+    connect(this, &PlanMapLayer::interactiveChanged,    this, &PlanMapLayer::_updateMouseButtons);
+
+    // Only the items themselves are tracked for changes, the connections are redone when they are added or removed
+    connect(this, &PlanMapLayer::_itemsChangedSignal,   this, [this]() { _itemsChanged = true; emit _rebuildSignal(); });
+
+    // Dragging an item or panning the map changes many values at once, these collapse them into a single rebuild or layout
+    connect(this, &PlanMapLayer::_rebuildSignal,    this, &PlanMapLayer::_rebuild,  Qt::QueuedConnection);
+    connect(this, &PlanMapLayer::_layoutSignal,     this, &PlanMapLayer::_layout,   Qt::QueuedConnection);
+    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&PlanMapLayer::_rebuildSignal));
+    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&PlanMapLayer::_layoutSignal));
+}
+
+void PlanMapLayer::setMissionController(MissionController* missionController)
+{
+    if (missionController == _missionController) {
+        return;
+    }
+    if (_missionController) {
+        disconnect(_missionController, nullptr, this, nullptr);
+    }
+    _missionController = missionController;
+    if (_missionController) {
+        connect(_missionController, &MissionController::visualItemsChanged,             this, &PlanMapLayer::_itemsChangedSignal);
+        connect(_missionController, &MissionController::currentPlanViewSeqNumChanged,   this, &PlanMapLayer::_rebuildSignal);
+    }
+    _itemsChanged = true;
+    emit _rebuildSignal();
+    emit missionControllerChanged();
+}
+
+void PlanMapLayer::setMapPolygon(QGCMapPolygon* mapPolygon)
+{
+    if (mapPolygon == _mapPolygon) {
+        return;
+    }
+    if (_mapPolygon) {
+        disconnect(_mapPolygon, nullptr, this, nullptr);
+    }
+    _mapPolygon = mapPolygon;
+    if (_mapPolygon) {
+        connect(_mapPolygon, &QGCMapPolygon::pathChanged, this, &PlanMapLayer::_rebuildSignal);
+    }
+    emit _rebuildSignal();
+    emit mapPolygonChanged();
+}
+
+QString PlanMapLayer::markerText(const QString& abbreviation, int sequenceNumber)
+{
+    const QChar first = abbreviation.isEmpty() ? QChar() : abbreviation.at(0);
+    if ((first > QLatin1Char('A') && first < QLatin1Char('z')) || sequenceNumber == 0) {
+        return QString(first);
+    }
+    return QString::number(sequenceNumber);
+}
+
+void PlanMapLayer::_connectModel(QmlObjectListModel* model)
+{
+    _modelConnections.append(connect(model, &QAbstractItemModel::rowsInserted,  this, &PlanMapLayer::_itemsChangedSignal));
+    _modelConnections.append(connect(model, &QAbstractItemModel::rowsRemoved,   this, &PlanMapLayer::_itemsChangedSignal));
+    _modelConnections.append(connect(model, &QAbstractItemModel::rowsMoved,     this, &PlanMapLayer::_itemsChangedSignal));
+    _modelConnections.append(connect(model, &QAbstractItemModel::modelReset,    this, &PlanMapLayer::_itemsChangedSignal));
+}
+
+void PlanMapLayer::_connectItems(void)
+{
+    for (const QMetaObject::Connection& connection: _modelConnections) {
+        disconnect(connection);
+    }
+    for (const QMetaObject::Connection& connection: _itemConnections) {
+        disconnect(connection);
+    }
+    _modelConnections.clear();
+    _itemConnections.clear();
+
+    if (!_missionController) {
+        return;
+    }
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QmlObjectListModel* segments    = _missionController->simpleFlightPathSegments();
+
+    if (visualItems && _showMarkers) {
+        _connectModel(visualItems);
+        for (int i = 0; i < visualItems->count(); i++) {
+            VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+            if (item->mapVisualQML() != QLatin1String(kSimpleItemMapVisual)) {
+                continue;
+            }
+            _itemConnections.append(connect(item, &VisualMissionItem::coordinateChanged,            this, &PlanMapLayer::_rebuildSignal));
+            _itemConnections.append(connect(item, &VisualMissionItem::sequenceNumberChanged,        this, &PlanMapLayer::_rebuildSignal));
+            _itemConnections.append(connect(item, &VisualMissionItem::abbreviationChanged,          this, &PlanMapLayer::_rebuildSignal));
+            _itemConnections.append(connect(item, &VisualMissionItem::specifiesCoordinateChanged,   this, &PlanMapLayer::_rebuildSignal));
+        }
+    }
+
+    if (segments && _showLines) {
+        _connectModel(segments);
+        for (int i = 0; i < segments->count(); i++) {
+            FlightPathSegment* segment = segments->value<FlightPathSegment*>(i);
+            _itemConnections.append(connect(segment, &FlightPathSegment::coordinate1Changed,        this, &PlanMapLayer::_rebuildSignal));
+            _itemConnections.append(connect(segment, &FlightPathSegment::coordinate2Changed,        this, &PlanMapLayer::_rebuildSignal));
+            _itemConnections.append(connect(segment, &FlightPathSegment::terrainCollisionChanged,   this, &PlanMapLayer::_rebuildSignal));
+        }
+    }
+}
+
+void PlanMapLayer::_rebuild(void)
+{
+    if (_itemsChanged) {
+        _connectItems();
+        _itemsChanged = false;
+    }
+
+    _markers.clear();
+    _segments.clear();
+    _vertices.clear();
+
+    if (_missionController) {
+        QmlObjectListModel* visualItems = _missionController->visualItems();
+        QmlObjectListModel* segments    = _missionController->simpleFlightPathSegments();
+
+        if (visualItems && _showMarkers) {
+            for (int i = 0; i < visualItems->count(); i++) {
+                VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+                // The current item keeps its own QML indicator so it can show everything about itself and be dragged
+                if (item->isCurrentItem() || !item->specifiesCoordinate() || !item->coordinate().isValid() || item->mapVisualQML() != QLatin1String(kSimpleItemMapVisual)) {
+                    continue;
+                }
+                _markers.append({ item->coordinate(), item->sequenceNumber(), markerText(item->abbreviation(), item->sequenceNumber()) });
+            }
+        }
+
+        if (segments && _showLines) {
+            for (int i = 0; i < segments->count(); i++) {
+                FlightPathSegment* segment = segments->value<FlightPathSegment*>(i);
+                if (segment->coordinate1().isValid() && segment->coordinate2().isValid()) {
+                    _segments.append({ segment->coordinate1(), segment->coordinate2(), segment->terrainCollision() });
+                }
+            }
+        }
+    }
+
+    if (_mapPolygon) {
+        const QList<QGeoCoordinate> vertices = _mapPolygon->coordinateList();
+        _vertices = vertices.toVector();
+    }
+
+    qCDebug(PlanMapLayerLog) << "Rebuilt markers:segments:vertices" << _markers.count() << _segments.count() << _vertices.count();
+    _layout();
+}
+
+void PlanMapLayer::_layout(void)
+{
+    QVariantList handleVertices;
+
+    _visibleMarkers.clear();
+    _visibleSegments.clear();
+    _visibleVertices.clear();
+    _labels.clear();
+
+    if (_center.isValid() && width() > 0 && height() > 0) {
+        // Map zoom levels are relative to 256 pixel tiles
+        const double    worldSize       = 256.0 * qPow(2.0, _zoomLevel);
+        const QPointF   viewportCenter  (width() / 2.0, height() / 2.0);
+        const double    bearingRadians  = qDegreesToRadians(-_bearing);
+        const double    cosBearing      = qCos(bearingRadians);
+        const double    sinBearing      = qSin(bearingRadians);
+        QPointF         centerPixel;
+
+        convertGeoToWebMercator(_center.latitude(), _center.longitude(), worldSize, centerPixel.rx(), centerPixel.ry());
+
+        auto toViewport = [&](const QGeoCoordinate& coordinate) {
+            QPointF delta;
+            convertGeoToWebMercator(coordinate.latitude(), coordinate.longitude(), worldSize, delta.rx(), delta.ry());
+            delta -= centerPixel;
+            // Go the short way around the world so plans across the antimeridian end up in the right place
+            if (delta.x() > worldSize / 2.0) {
+                delta.rx() -= worldSize;
+            } else if (delta.x() < -worldSize / 2.0) {
+                delta.rx() += worldSize;
+            }
+            return QPointF(viewportCenter.x() + (delta.x() * cosBearing) - (delta.y() * sinBearing),
+                           viewportCenter.y() + (delta.x() * sinBearing) + (delta.y() * cosBearing));
+        };
+        auto inViewport = [&](const QPointF& position, double margin) {
+            return position.x() >= -margin && position.y() >= -margin && position.x() <= width() + margin && position.y() <= height() + margin;
+        };
+
+        if (_showLines) {
+            const double margin = _lineWidth;
+            for (const Segment_t& segment: _segments) {
+                const QPointF position1 = toViewport(segment.coordinate1);
+                const QPointF position2 = toViewport(segment.coordinate2);
+                // Bounding box test, a line can cross the viewport with both ends outside of it
+                if (qMax(position1.x(), position2.x()) < -margin || qMin(position1.x(), position2.x()) > width() + margin ||
+                        qMax(position1.y(), position2.y()) < -margin || qMin(position1.y(), position2.y()) > height() + margin) {
+                    continue;
+                }
+                _visibleSegments.append({ position1, position2, segment.terrainCollision });
+            }
+        }
+
+        if (_showMarkers) {
+            for (const Marker_t& marker: _markers) {
+                const QPointF position = toViewport(marker.coordinate);
+                if (!inViewport(position, _markerRadius)) {
+                    continue;
+                }
+                _visibleMarkers.append({ position, marker.sequenceNumber });
+                if (_labels.count() < _maxLabels) {
+                    QVariantMap label;
+                    label[QStringLiteral("x")]      = position.x();
+                    label[QStringLiteral("y")]      = position.y();
+                    label[QStringLiteral("text")]   = marker.text;
+                    _labels.append(label);
+                }
+            }
+        }
+
+        for (int i = 0; i < _vertices.count(); i++) {
+            const QPointF position = toViewport(_vertices[i]);
+            if (inViewport(position, _vertexRadius)) {
+                _visibleVertices.append(position);
+                handleVertices.append(i);
+            }
+        }
+        if (handleVertices.count() > _maxHandles) {
+            handleVertices.clear();
+        }
+    }
+
+    emit labelsChanged();
+
+    // Handles are recreated whenever the list changes, so it is only changed when it has to be. A vertex count change
+    // renumbers the vertices even if the list itself happens to stay the same.
+    if (handleVertices != _handleVertices || _vertices.count() != _handleVertexCount) {
+        _handleVertices     = handleVertices;
+        _handleVertexCount  = _vertices.count();
+        emit handleVerticesChanged();
+    }
+
+    update();
+}
+
+int PlanMapLayer::_markerAt(const QPointF& position) const
+{
+    // Markers laid out later are drawn on top, so they take precedence
+    const double hitRadiusSquared = _markerRadius * _markerRadius;
+    for (int i = _visibleMarkers.count() - 1; i >= 0; i--) {
+        const QPointF delta = _visibleMarkers[i].position - position;
+        if (QPointF::dotProduct(delta, delta) <= hitRadiusSquared) {
+            return _visibleMarkers[i].sequenceNumber;
+        }
+    }
+    return -1;
+}
+
+void PlanMapLayer::_updateMouseButtons(void)
+{
+    setAcceptedMouseButtons(_showMarkers && _interactive ? Qt::LeftButton : Qt::NoButton);
+}
+
+void PlanMapLayer::mousePressEvent(QMouseEvent* event)
+{
+    // Presses which miss the markers are ignored so they go through to the map
+    _pressedSequenceNumber = _markerAt(event->localPos());
+    if (_pressedSequenceNumber == -1) {
+        event->ignore();
+        return;
+    }
+    event->accept();
+}
+
+void PlanMapLayer::mouseReleaseEvent(QMouseEvent* event)
+{
+    const int sequenceNumber = _pressedSequenceNumber;
+    _pressedSequenceNumber = -1;
+    if (sequenceNumber != -1 && _markerAt(event->localPos()) == sequenceNumber) {
+        emit clicked(sequenceNumber);
+    }
+}
+
+void PlanMapLayer::mouseUngrabEvent(void)
+{
+    _pressedSequenceNumber = -1;
+}
+
+/// Vertex colors are premultiplied by alpha
+static void _setVertex(QSGGeometry::ColoredPoint2D& vertex, const QPointF& position, const QColor& color)
+{
+    const int alpha = color.alpha();
+    vertex.set(static_cast<float>(position.x()), static_cast<float>(position.y()),
+               static_cast<uchar>(color.red() * alpha / 255), static_cast<uchar>(color.green() * alpha / 255), static_cast<uchar>(color.blue() * alpha / 255),
+               static_cast<uchar>(alpha));
+}
+
+static QSGGeometryNode* _createGeometryNode(void)
+{
+    QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+    geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+
+    QSGGeometryNode* node = new QSGGeometryNode;
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setFlag(QSGNode::OwnsMaterial);
+    node->setGeometry(geometry);
+    node->setMaterial(new QSGVertexColorMaterial);
+    return node;
+}
+
+QSGNode* PlanMapLayer::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    // Lines, then polygon vertices, then markers on top
+    QSGNode* node = oldNode;
+    if (!node) {
+        node = new QSGNode;
+        node->appendChildNode(_createGeometryNode());
+        node->appendChildNode(_createGeometryNode());
+        node->appendChildNode(_createGeometryNode());
+    }
+
+    QSGGeometryNode* linesNode      = static_cast<QSGGeometryNode*>(node->childAtIndex(0));
+    QSGGeometryNode* verticesNode   = static_cast<QSGGeometryNode*>(node->childAtIndex(1));
+    QSGGeometryNode* markersNode    = static_cast<QSGGeometryNode*>(node->childAtIndex(2));
+
+    // Each line is a quad of two triangles
+    QSGGeometry* geometry = linesNode->geometry();
+    geometry->allocate(_visibleSegments.count() * 6);
+    QSGGeometry::ColoredPoint2D* vertices = geometry->vertexDataAsColoredPoint2D();
+    int vertexIndex = 0;
+    for (const VisibleSegment_t& segment: _visibleSegments) {
+        const QPointF   direction   = segment.position2 - segment.position1;
+        const double    length      = qSqrt(QPointF::dotProduct(direction, direction));
+        const QPointF   normal      = length > 0 ? QPointF(-direction.y(), direction.x()) * (_lineWidth / 2.0 / length) : QPointF();
+        const QColor&   color       = segment.terrainCollision ? _collisionColor : _lineColor;
+
+        _setVertex(vertices[vertexIndex++], segment.position1 + normal, color);
+        _setVertex(vertices[vertexIndex++], segment.position1 - normal, color);
+        _setVertex(vertices[vertexIndex++], segment.position2 + normal, color);
+        _setVertex(vertices[vertexIndex++], segment.position2 + normal, color);
+        _setVertex(vertices[vertexIndex++], segment.position1 - normal, color);
+        _setVertex(vertices[vertexIndex++], segment.position2 - normal, color);
+    }
+    linesNode->markDirty(QSGNode::DirtyGeometry);
+
+    // Circles are a fan of triangles around the center
+    auto addCircle = [](QSGGeometry::ColoredPoint2D* vertices, int& vertexIndex, const QPointF& center, double radius, const QColor& color) {
+        for (int i = 0; i < _cCircleSegments; i++) {
+            const double angle1 = (2.0 * M_PI * i) / _cCircleSegments;
+            const double angle2 = (2.0 * M_PI * (i + 1)) / _cCircleSegments;
+            _setVertex(vertices[vertexIndex++], center, color);
+            _setVertex(vertices[vertexIndex++], center + QPointF(qCos(angle1), qSin(angle1)) * radius, color);
+            _setVertex(vertices[vertexIndex++], center + QPointF(qCos(angle2), qSin(angle2)) * radius, color);
+        }
+    };
+
+    // Vertices have a faint dark border like the QML drag handles
+    geometry = verticesNode->geometry();
+    geometry->allocate(_visibleVertices.count() * _cCircleSegments * 3 * 2);
+    vertices = geometry->vertexDataAsColoredPoint2D();
+    vertexIndex = 0;
+    for (const QPointF& position: _visibleVertices) {
+        addCircle(vertices, vertexIndex, position, _vertexRadius, QColor(0, 0, 0, 64));
+        addCircle(vertices, vertexIndex, position, _vertexRadius - 1, _vertexColor);
+    }
+    verticesNode->markDirty(QSGNode::DirtyGeometry);
+
+    geometry = markersNode->geometry();
+    geometry->allocate(_visibleMarkers.count() * _cCircleSegments * 3);
+    vertices = geometry->vertexDataAsColoredPoint2D();
+    vertexIndex = 0;
+    for (const VisibleMarker_t& marker: _visibleMarkers) {
+        addCircle(vertices, vertexIndex, marker.position, _markerRadius, _markerColor);
+    }
+    markersNode->markDirty(QSGNode::DirtyGeometry);
+
+    return node;
+}
@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QQuickItem>
+#include <QColor>
+#include <QGeoCoordinate>
+#include <QList>
+#include <QPointF>
+#include <QVariantList>
+#include <QVector>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(PlanMapLayerLog)
+
+class MissionController;
+class QGCMapPolygon;
+class QmlObjectListModel;
+
+/// Draws the Plan view mission item markers, the lines between them and the vertices of a polygon as a single scene
+/// graph layer over the map.
+///
+/// The item covers the map and is given the center, zoom level and bearing of it. Everything is projected to the
+/// viewport in C++ and culled to it, what is left is drawn with one geometry node per kind. The current mission item is
+/// skipped since it keeps its full QML indicator and drag area. Labels are provided for up to maxLabels markers, and
+/// polygon vertex indices in handleVertices for up to maxHandles vertices in view, so QML only creates interactive
+/// handles for what can actually be seen.
+class PlanMapLayer : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    PlanMapLayer(QQuickItem* parent = nullptr);
+
+    Q_PROPERTY(MissionController*   missionController   READ missionController  WRITE setMissionController  NOTIFY missionControllerChanged)
+    Q_PROPERTY(QGCMapPolygon*       mapPolygon          READ mapPolygon         WRITE setMapPolygon         NOTIFY mapPolygonChanged)
+    Q_PROPERTY(QGeoCoordinate       center              MEMBER _center          NOTIFY centerChanged)
+    Q_PROPERTY(double               zoomLevel           MEMBER _zoomLevel       NOTIFY zoomLevelChanged)
+    Q_PROPERTY(double               bearing             MEMBER _bearing         NOTIFY bearingChanged)
+    Q_PROPERTY(bool                 showMarkers         MEMBER _showMarkers     NOTIFY showMarkersChanged)
+    Q_PROPERTY(bool                 showLines           MEMBER _showLines       NOTIFY showLinesChanged)
+    Q_PROPERTY(bool                 interactive         MEMBER _interactive     NOTIFY interactiveChanged)  ///< false: Markers can't be clicked
+    Q_PROPERTY(double               markerRadius        MEMBER _markerRadius    NOTIFY markerRadiusChanged) ///< Pixels
+    Q_PROPERTY(QColor               markerColor         MEMBER _markerColor     NOTIFY colorsChanged)
+    Q_PROPERTY(double               lineWidth           MEMBER _lineWidth       NOTIFY lineWidthChanged)    ///< Pixels
+    Q_PROPERTY(QColor               lineColor           MEMBER _lineColor       NOTIFY colorsChanged)
+    Q_PROPERTY(QColor               collisionColor      MEMBER _collisionColor  NOTIFY colorsChanged)       ///< Lines which collide with terrain
+    Q_PROPERTY(double               vertexRadius        MEMBER _vertexRadius    NOTIFY vertexRadiusChanged) ///< Pixels
+    Q_PROPERTY(QColor               vertexColor         MEMBER _vertexColor     NOTIFY colorsChanged)
+    Q_PROPERTY(int                  maxLabels           MEMBER _maxLabels       NOTIFY maxLabelsChanged)
+    Q_PROPERTY(int                  maxHandles          MEMBER _maxHandles      NOTIFY maxHandlesChanged)
+    Q_PROPERTY(QVariantList         labels              READ labels             NOTIFY labelsChanged)           ///< { x, y, text } of labeled markers
+    Q_PROPERTY(QVariantList         handleVertices      READ handleVertices     NOTIFY handleVerticesChanged)   ///< Polygon vertex indices which should get handles, empty if there are more than maxHandles in view
+
+    MissionController*  missionController   (void) { return _missionController; }
+    QGCMapPolygon*      mapPolygon          (void) { return _mapPolygon; }
+    QVariantList        labels              (void) const { return _labels; }
+    QVariantList        handleVertices      (void) const { return _handleVertices; }
+
+    void setMissionController   (MissionController* missionController);
+    void setMapPolygon          (QGCMapPolygon* mapPolygon);
+
+    /// @return Text shown in the marker of the mission item, which matches MissionItemIndicator
+    static QString markerText(const QString& abbreviation, int sequenceNumber);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) final;
+
+signals:
+    void missionControllerChanged   (void);
+    void mapPolygonChanged          (void);
+    void centerChanged              (void);
+    void zoomLevelChanged           (void);
+    void bearingChanged             (void);
+    void showMarkersChanged         (void);
+    void showLinesChanged           (void);
+    void interactiveChanged         (void);
+    void markerRadiusChanged        (void);
+    void lineWidthChanged           (void);
+    void vertexRadiusChanged        (void);
+    void colorsChanged              (void);
+    void maxLabelsChanged           (void);
+    void maxHandlesChanged          (void);
+    void labelsChanged              (void);
+    void handleVerticesChanged      (void);
+    void clicked                    (int sequenceNumber);
+    void _itemsChangedSignal        (void);
+    void _rebuildSignal             (void);
+    void _layoutSignal              (void);
+
+protected:
+    void mousePressEvent    (QMouseEvent* event) final;
+    void mouseReleaseEvent  (QMouseEvent* event) final;
+    void mouseUngrabEvent   (void) final;
+
+private slots:
+    void _rebuild           (void);
+    void _layout            (void);
+    void _updateMouseButtons(void);
+
+private:
+    typedef struct {
+        QGeoCoordinate  coordinate;
+        int             sequenceNumber;
+        QString         text;
+    } Marker_t;
+
+    typedef struct {
+        QGeoCoordinate  coordinate1;
+        QGeoCoordinate  coordinate2;
+        bool            terrainCollision;
+    } Segment_t;
+
+    typedef struct {
+        QPointF position;       ///< Viewport pixels
+        int     sequenceNumber;
+    } VisibleMarker_t;
+
+    typedef struct {
+        QPointF position1;      ///< Viewport pixels
+        QPointF position2;
+        bool    terrainCollision;
+    } VisibleSegment_t;
+
+    void    _connectModel       (QmlObjectListModel* model);
+    void    _connectItems       (void);
+    int     _markerAt           (const QPointF& position) const;
+
+    MissionController*              _missionController      = nullptr;
+    QGCMapPolygon*                  _mapPolygon             = nullptr;
+    QGeoCoordinate                  _center;
+    double                          _zoomLevel              = 0;
+    double                          _bearing                = 0;
+    bool                            _showMarkers            = true;
+    bool                            _showLines              = true;
+    bool                            _interactive            = true;
+    double                          _markerRadius           = 10;
+    QColor                          _markerColor            = QColor(Qt::black);
+    double                          _lineWidth              = 3;
+    QColor                          _lineColor              = QColor(Qt::white);
+    QColor                          _collisionColor         = QColor(Qt::red);
+    double                          _vertexRadius           = 12;
+    QColor                          _vertexColor            = QColor(255, 255, 255, 204);
+    int                             _maxLabels              = 100;
+    int                             _maxHandles             = 100;
+    int                             _pressedSequenceNumber  = -1;
+    bool                            _itemsChanged           = true; ///< Items were added or removed, their connections have to be redone
+    QList<QMetaObject::Connection>  _modelConnections;
+    QList<QMetaObject::Connection>  _itemConnections;
+    QVector<Marker_t>               _markers;
+    QVector<Segment_t>              _segments;
+    QVector<QGeoCoordinate>         _vertices;
+    QVector<VisibleMarker_t>        _visibleMarkers;                ///< Built on the GUI thread, read by updatePaintNode while it is blocked
+    QVector<VisibleSegment_t>       _visibleSegments;
+    QVector<QPointF>                _visibleVertices;
+    QVariantList                    _labels;
+    QVariantList                    _handleVertices;
+    int                             _handleVertexCount      = 0;    ///< Polygon vertex count when handleVertices was last changed
+
+    static const int _cCircleSegments = 16;
+};
@@ -15,7 +15,7 @@
 #include "AppSettings.h"
 #include "JsonHelper.h"
 #include "MissionManager.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanWriter.h"
 #include "SurveyPlanCreator.h"
 #include "StructureScanPlanCreator.h"
 #include "CorridorScanPlanCreator.h"
@@ -27,6 +27,9 @@
 #include <QDomDocument>
 #include <QJsonDocument>
 #include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSaveFile>
+#include <QtConcurrent>
 
 QGC_LOGGING_CATEGORY(PlanMasterControllerLog, "PlanMasterControllerLog")
 
@@ -507,17 +510,28 @@ void PlanMasterController::saveToKml(const QString& filename)
         kmlFilename += QString(".%1").arg(kmlFileExtension());
     }
 
-    QFile file(kmlFilename);
+    // The plan is captured here, writing the file is left to a worker thread so large plans don't stall the ui
+    KMLPlanWriter planKML;
+    _missionController.addMissionToKML(planKML);
 
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qgcApp()->showAppMessage(tr("KML save error %1 : %2").arg(filename).arg(file.errorString()));
-    } else {
-        KMLPlanDomDocument planKML;
-        _missionController.addMissionToKML(planKML);
-        QTextStream stream(&file);
-        stream << planKML.toString();
-        file.close();
-    }
+    QFutureWatcher<QString>* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [watcher, filename]() {
+        QString errorString = watcher->result();
+        if (!errorString.isEmpty()) {
+            qgcApp()->showAppMessage(tr("KML save error %1 : %2").arg(filename).arg(errorString));
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run([planKML, kmlFilename]() {
+        QSaveFile file(kmlFilename);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return file.errorString();
+        }
+        if (!planKML.write(file) || !file.commit()) {
+            return file.errorString();
+        }
+        return QString();
+    }));
 }
 
 void PlanMasterController::removeAll(void)
@@ -16,6 +16,10 @@
 #include "SettingsManager.h"
 #include "AppSettings.h"
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
 PlanMasterControllerTest::PlanMasterControllerTest(void)
     : _masterController(nullptr)
 {
@@ -51,3 +55,48 @@ void PlanMasterControllerTest::_testMissionPlannerFileLoad(void)
     _masterController->loadFromFile(":/unittest/MissionPlanner.waypoints");
     QCOMPARE(_masterController->missionController()->visualItems()->count(), 6);
 }
+
+void PlanMasterControllerTest::_testLargePlanBenchmark(void)
+{
+    const int cItems = 2000;
+
+    // Start from the empty plan so all the header and section keys are there
+    QJsonObject planJson    = _masterController->saveToJson().object();
+    QJsonObject missionJson = planJson[PlanMasterController::kJsonMissionObjectKey].toObject();
+    QJsonArray  rgItems;
+    for (int i=0; i<cItems; i++) {
+        QJsonObject itemJson;
+        itemJson[VisualMissionItem::jsonTypeKey] = VisualMissionItem::jsonTypeSimpleItemValue;
+        itemJson["frame"]           = MAV_FRAME_GLOBAL_RELATIVE_ALT;
+        itemJson["command"]         = MAV_CMD_NAV_WAYPOINT;
+        itemJson["autoContinue"]    = true;
+        itemJson["doJumpId"]        = i + 1;
+        itemJson["params"]          = QJsonArray({ 0, 0, 0, QJsonValue(), 47.6 + (i * 0.0001), 8.5 + ((i % 100) * 0.0001), 50 });
+        rgItems.append(itemJson);
+    }
+    missionJson["items"] = rgItems;
+    planJson[PlanMasterController::kJsonMissionObjectKey] = missionJson;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QString loadFile = tempDir.filePath("large.plan");
+    QString saveFile = tempDir.filePath("saved.plan");
+    {
+        QFile file(loadFile);
+        QVERIFY(file.open(QFile::WriteOnly));
+        file.write(QJsonDocument(planJson).toJson());
+    }
+
+    QBENCHMARK {
+        _masterController->loadFromFile(loadFile);
+    }
+    QCOMPARE(_masterController->missionController()->visualItems()->count(), cItems + 1);
+
+    QBENCHMARK {
+        _masterController->saveToFile(saveFile);
+    }
+
+    // What was saved must load back to the same plan
+    _masterController->loadFromFile(saveFile);
+    QCOMPARE(_masterController->missionController()->visualItems()->count(), cItems + 1);
+}
@@ -33,6 +33,7 @@ private slots:
 
     void _testMissionFileLoad(void);
     void _testMissionPlannerFileLoad(void);
+    void _testLargePlanBenchmark(void);
 
 private:
     PlanMasterController*   _masterController;
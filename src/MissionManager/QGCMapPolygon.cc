@@ -14,6 +14,8 @@
 #include "QGCApplication.h"
 #include "ShapeFileHelper.h"
 #include "QGCLoggingCategory.h"
+#include "SettingsManager.h"
+#include "PlanViewSettings.h"
 
 #include <QGeoRectangle>
 #include <QDebug>
@@ -21,6 +23,7 @@
 #include <QLineF>
 #include <QFile>
 #include <QDomDocument>
+#include <QtConcurrent>
 
 const char* QGCMapPolygon::jsonPolygonKey = "polygon";
 
@@ -48,14 +51,25 @@ QGCMapPolygon::QGCMapPolygon(const QGCMapPolygon& other, QObject* parent)
     _init();
 }
 
+QGCMapPolygon::~QGCMapPolygon()
+{
+    // A load which is still running has no use for its results any more
+    cancelLoad();
+}
+
 void QGCMapPolygon::_init(void)
 {
     connect(&_polygonModel, &QmlObjectListModel::dirtyChanged, this, &QGCMapPolygon::_polygonModelDirtyChanged);
     connect(&_polygonModel, &QmlObjectListModel::countChanged, this, &QGCMapPolygon::_polygonModelCountChanged);
 
+    connect(this, &QGCMapPolygon::pathChanged,  this, &QGCMapPolygon::_invalidateContainment);
     connect(this, &QGCMapPolygon::pathChanged,  this, &QGCMapPolygon::_updateCenter);
     connect(this, &QGCMapPolygon::countChanged, this, &QGCMapPolygon::isValidChanged);
     connect(this, &QGCMapPolygon::countChanged, this, &QGCMapPolygon::isEmptyChanged);
+
+    connect(&_loadWatcher,          &QFutureWatcherBase::finished,  this, &QGCMapPolygon::_loadWatcherFinished);
+    connect(&_loadProgressTimer,    &QTimer::timeout,               this, &QGCMapPolygon::_updateLoadProgress);
+    _loadProgressTimer.setInterval(_loadProgressIntervalMSecs);
 }
 
 const QGCMapPolygon& QGCMapPolygon::operator=(const QGCMapPolygon& other)
@@ -87,6 +101,7 @@ void QGCMapPolygon::clear(void)
     // we work around it by using the code above to remove all but the last point which in turn
     // will cause the polygon to go away.
     _polygonPath.clear();
+    _invalidateContainment();
 
     _polygonModel.clearAndDeleteContents();
 
@@ -99,6 +114,8 @@ void QGCMapPolygon::adjustVertex(int vertexIndex, const QGeoCoordinate coordinat
 {
     _polygonPath[vertexIndex] = QVariant::fromValue(coordinate);
     _polygonModel.value<QGCQGeoCoordinate*>(vertexIndex)->setCoordinate(coordinate);
+    // pathChanged is held back while dragging the center, the cached polygon is out of date either way
+    _invalidateContainment();
     if (!_centerDrag) {
         // When dragging center we don't signal path changed until all vertices are updated
         emit pathChanged();
@@ -147,31 +164,116 @@ QPolygonF QGCMapPolygon::_toPolygonF(void) const
     QPolygonF polygon;
 
     if (_polygonPath.count() > 2) {
-        for (int i=0; i<_polygonPath.count(); i++) {
-            polygon.append(_pointFFromCoord(_polygonPath[i].value<QGeoCoordinate>()));
+        const QVector<QGeoCoordinate>   coords = coordinateList().toVector();
+        QVector<double>                 north(coords.count());
+        QVector<double>                 east(coords.count());
+
+        convertGeoToNed(coords.constData(), coords.count(), coords[0], north.data(), east.data(), nullptr);
+        polygon.reserve(coords.count());
+        for (int i=0; i<coords.count(); i++) {
+            polygon.append(QPointF(east[i], -north[i]));
         }
     }
 
     return polygon;
 }
 
+void QGCMapPolygon::_buildContainment(void) const
+{
+    _containmentPolygon = _toPolygonF();
+    _containmentBounds  = _containmentPolygon.boundingRect();
+    _containmentSlabs.clear();
+
+    const int cVertices = _containmentPolygon.count();
+    if (cVertices > 2) {
+        // About one edge per slab on average keeps the slabs short without making long edges expensive to bucket
+        const int cSlabs = qBound(1, cVertices, static_cast<int>(_maxContainmentSlabs));
+        _containmentSlabHeight = qMax(_containmentBounds.height() / cSlabs, 1e-9);
+        _containmentSlabs.resize(cSlabs);
+
+        for (int i=0; i<cVertices; i++) {
+            const QPointF&  point1      = _containmentPolygon[i];
+            const QPointF&  point2      = _containmentPolygon[(i + 1) % cVertices];
+            const int       firstSlab   = qBound(0, static_cast<int>((qMin(point1.y(), point2.y()) - _containmentBounds.top()) / _containmentSlabHeight), cSlabs - 1);
+            const int       lastSlab    = qBound(0, static_cast<int>((qMax(point1.y(), point2.y()) - _containmentBounds.top()) / _containmentSlabHeight), cSlabs - 1);
+            for (int slab=firstSlab; slab<=lastSlab; slab++) {
+                _containmentSlabs[slab].append(i);
+            }
+        }
+    }
+
+    _containmentValid = true;
+}
+
+bool QGCMapPolygon::_containsPointF(const QPointF& point) const
+{
+    if (point.x() < _containmentBounds.left() || point.x() > _containmentBounds.right() ||
+            point.y() < _containmentBounds.top() || point.y() > _containmentBounds.bottom()) {
+        return false;
+    }
+
+    const int   cVertices   = _containmentPolygon.count();
+    const int   slab        = qBound(0, static_cast<int>((point.y() - _containmentBounds.top()) / _containmentSlabHeight), _containmentSlabs.count() - 1);
+    bool        inside      = false;
+
+    // Odd-even rule, a ray going right from the point crosses the polygon an odd number of times when it is inside
+    for (int edge: _containmentSlabs[slab]) {
+        const QPointF& point1 = _containmentPolygon[edge];
+        const QPointF& point2 = _containmentPolygon[(edge + 1) % cVertices];
+        if ((point1.y() > point.y()) != (point2.y() > point.y())) {
+            const double crossingX = point1.x() + ((point.y() - point1.y()) * (point2.x() - point1.x()) / (point2.y() - point1.y()));
+            if (point.x() < crossingX) {
+                inside = !inside;
+            }
+        }
+    }
+
+    return inside;
+}
+
 bool QGCMapPolygon::containsCoordinate(const QGeoCoordinate& coordinate) const
 {
     if (_polygonPath.count() > 2) {
-        return _toPolygonF().containsPoint(_pointFFromCoord(coordinate), Qt::OddEvenFill);
+        if (!_containmentValid) {
+            _buildContainment();
+        }
+        return _containsPointF(_pointFFromCoord(coordinate));
     } else {
         return false;
     }
 }
 
+QList<bool> QGCMapPolygon::containsCoordinates(const QList<QGeoCoordinate>& coordinates) const
+{
+    QList<bool> contains;
+
+    contains.reserve(coordinates.count());
+    if (_polygonPath.count() > 2) {
+        if (!_containmentValid) {
+            _buildContainment();
+        }
+        for (const QGeoCoordinate& coordinate: coordinates) {
+            contains.append(_containsPointF(_pointFFromCoord(coordinate)));
+        }
+    } else {
+        for (int i=0; i<coordinates.count(); i++) {
+            contains.append(false);
+        }
+    }
+
+    return contains;
+}
+
 void QGCMapPolygon::setPath(const QList<QGeoCoordinate>& path)
 {
     _polygonPath.clear();
     _polygonModel.clearAndDeleteContents();
-    for(const QGeoCoordinate& coord: path) {
+    QList<QObject*> objects;
+    for (const QGeoCoordinate& coord: path) {
         _polygonPath.append(QVariant::fromValue(coord));
-        _polygonModel.append(new QGCQGeoCoordinate(coord, this));
+        objects.append(new QGCQGeoCoordinate(coord, this));
     }
+    _polygonModel.append(objects);
 
     setDirty(true);
     emit pathChanged();
@@ -182,9 +284,11 @@ void QGCMapPolygon::setPath(const QVariantList& path)
     _polygonPath = path;
 
     _polygonModel.clearAndDeleteContents();
+    QList<QObject*> objects;
     for (int i=0; i<_polygonPath.count(); i++) {
-        _polygonModel.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
+        objects.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
     }
+    _polygonModel.append(objects);
 
     setDirty(true);
     emit pathChanged();
@@ -216,9 +320,11 @@ bool QGCMapPolygon::loadFromJson(const QJsonObject& json, bool required, QString
         return false;
     }
 
+    QList<QObject*> objects;
     for (int i=0; i<_polygonPath.count(); i++) {
-        _polygonModel.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
+        objects.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
     }
+    _polygonModel.append(objects);
 
     setDirty(false);
     emit pathChanged();
@@ -405,18 +511,17 @@ QList<QPointF> QGCMapPolygon::nedPolygon(void) const
     QList<QPointF>  nedPolygon;
 
     if (count() > 0) {
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
+        QVector<QGeoCoordinate> coords(_polygonModel.count());
+        QVector<double>         north(coords.count());
+        QVector<double>         east(coords.count());
 
-        for (int i=0; i<_polygonModel.count(); i++) {
-            double y, x, down;
-            QGeoCoordinate vertex = vertexCoordinate(i);
-            if (i == 0) {
-                // This avoids a nan calculation that comes out of convertGeoToNed
-                x = y = 0;
-            } else {
-                convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
-            }
-            nedPolygon += QPointF(x, y);
+        for (int i=0; i<coords.count(); i++) {
+            coords[i] = vertexCoordinate(i);
+        }
+        convertGeoToNed(coords.constData(), coords.count(), coords[0], north.data(), east.data(), nullptr);
+        nedPolygon.reserve(coords.count());
+        for (int i=0; i<coords.count(); i++) {
+            nedPolygon += QPointF(east[i], north[i]);
         }
     }
 
@@ -499,6 +604,87 @@ bool QGCMapPolygon::loadKMLOrSHPFile(const QString& file)
     return true;
 }
 
+void QGCMapPolygon::loadKMLOrSHPFileInBackground(const QString& file)
+{
+    const double                tolerance   = qgcApp()->toolbox()->settingsManager()->planViewSettings()->shapeImportSimplifyTolerance()->rawValue().toDouble();
+    QSharedPointer<QAtomicInt>  loadState   (new QAtomicInt(0));
+
+    // A load which is still running is superseded, the watcher drops it when given the new one
+    if (_loadState) {
+        _loadState->storeRelease(_loadCancelled);
+    }
+    _loadState = loadState;
+
+    _loadWatcher.setFuture(QtConcurrent::run([file, tolerance, loadState]() {
+        LoadResult_t result;
+        result.success = ShapeFileHelper::loadPolygonFromFile(file, result.coords, result.errorString, tolerance, [loadState](double progress) {
+            // Only the GUI thread changes the state besides this, so a failed swap means the load was cancelled
+            const int current = loadState->loadAcquire();
+            return current != _loadCancelled && loadState->testAndSetOrdered(current, static_cast<int>(progress * _loadProgressScale));
+        });
+        return result;
+    }));
+
+    _loadProgress = 0;
+    _loadProgressTimer.start();
+    emit loadProgressChanged();
+    emit loadingChanged();
+}
+
+void QGCMapPolygon::cancelLoad(void)
+{
+    if (!_loadState) {
+        return;
+    }
+
+    _loadState->storeRelease(_loadCancelled);
+    _loadState.clear();
+    _loadProgressTimer.stop();
+    if (loading()) {
+        _loadWatcher.setFuture(QFuture<LoadResult_t>());
+        emit loadingChanged();
+    }
+}
+
+void QGCMapPolygon::_updateLoadProgress(void)
+{
+    if (_loadState) {
+        const int state = _loadState->loadAcquire();
+        if (state != _loadCancelled) {
+            _loadProgress = static_cast<double>(state) / _loadProgressScale;
+            emit loadProgressChanged();
+        }
+    }
+}
+
+void QGCMapPolygon::_loadWatcherFinished(void)
+{
+    if (!_loadState || _loadWatcher.isCanceled()) {
+        // Finish of the empty future a cancel leaves the watcher with
+        return;
+    }
+
+    _loadState.clear();
+    _loadProgressTimer.stop();
+    _loadProgress = 1;
+    emit loadProgressChanged();
+    emit loadingChanged();
+
+    const LoadResult_t result = _loadWatcher.result();
+    if (!result.success) {
+        qgcApp()->showAppMessage(result.errorString);
+        emit loadFinished(false);
+        return;
+    }
+
+    _beginResetIfNotActive();
+    clear();
+    appendVertices(result.coords);
+    _endResetIfNotActive();
+
+    emit loadFinished(true);
+}
+
 double QGCMapPolygon::area(void) const
 {
     // https://www.mathopenref.com/coordpolygonarea2.html
@@ -14,6 +14,12 @@
 #include <QGeoCoordinate>
 #include <QVariantList>
 #include <QPolygon>
+#include <QRectF>
+#include <QVector>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QTimer>
 
 #include "QmlObjectListModel.h"
 #include "KMLDomDocument.h"
@@ -27,6 +33,7 @@ class QGCMapPolygon : public QObject
 public:
     QGCMapPolygon(QObject* parent = nullptr);
     QGCMapPolygon(const QGCMapPolygon& other, QObject* parent = nullptr);
+    ~QGCMapPolygon();
 
     const QGCMapPolygon& operator=(const QGCMapPolygon& other);
 
@@ -43,6 +50,8 @@ public:
     Q_PROPERTY(bool                 traceMode       READ traceMode      WRITE setTraceMode      NOTIFY traceModeChanged)
     Q_PROPERTY(bool                 showAltColor    READ showAltColor   WRITE setShowAltColor   NOTIFY showAltColorChanged)
     Q_PROPERTY(int                  selectedVertex  READ selectedVertex WRITE selectVertex      NOTIFY selectedVertexChanged)
+    Q_PROPERTY(bool                 loading         READ loading                                NOTIFY loadingChanged)      ///< A background file load is running
+    Q_PROPERTY(double               loadProgress    READ loadProgress                           NOTIFY loadProgressChanged) ///< 0 to 1
 
     Q_INVOKABLE void clear(void);
     Q_INVOKABLE void appendVertex(const QGeoCoordinate& coordinate);
@@ -62,6 +71,10 @@ public:
     /// Returns true if the specified coordinate is within the polygon
     Q_INVOKABLE bool containsCoordinate(const QGeoCoordinate& coordinate) const;
 
+    /// Checks a whole list of coordinates, for example a flight path, against the polygon
+    /// @return Whether each coordinate is within the polygon
+    QList<bool> containsCoordinates(const QList<QGeoCoordinate>& coordinates) const;
+
     /// Offsets the current polygon edges by the specified distance in meters
     Q_INVOKABLE void offset(double distance);
 
@@ -69,6 +82,13 @@ public:
     /// @return true: success
     Q_INVOKABLE bool loadKMLOrSHPFile(const QString& file);
 
+    /// Loads a polygon from a KML/SHP file on a worker thread, simplified to the import tolerance of the Plan view
+    /// settings. The polygon is only replaced once the load succeeds, loadFinished is signalled either way.
+    Q_INVOKABLE void loadKMLOrSHPFileInBackground(const QString& file);
+
+    /// Cancels a running background load, loadFinished is not signalled for it
+    Q_INVOKABLE void cancelLoad(void);
+
     /// Returns the path in a list of QGeoCoordinate's format
     QList<QGeoCoordinate> coordinateList(void) const;
 
@@ -113,6 +133,8 @@ public:
     bool            traceMode   (void) const { return _traceMode; }
     bool            showAltColor(void) const { return _showAltColor; }
     int             selectedVertex()   const { return _selectedVertexIndex; }
+    bool            loading     (void) const { return _loadWatcher.isRunning(); }
+    double          loadProgress(void) const { return _loadProgress; }
 
     QVariantList        path        (void) const { return _polygonPath; }
     QmlObjectListModel* qmlPathModel(void) { return &_polygonModel; }
@@ -142,11 +164,16 @@ signals:
     void traceModeChanged   (bool traceMode);
     void showAltColorChanged(bool showAltColor);
     void selectedVertexChanged(int index);
+    void loadingChanged     (void);
+    void loadProgressChanged(void);
+    void loadFinished       (bool success);
 
 private slots:
     void _polygonModelCountChanged(int count);
     void _polygonModelDirtyChanged(bool dirty);
     void _updateCenter(void);
+    void _loadWatcherFinished(void);
+    void _updateLoadProgress(void);
 
 private:
     void            _init                   (void);
@@ -155,6 +182,15 @@ private:
     QPointF         _pointFFromCoord        (const QGeoCoordinate& coordinate) const;
     void            _beginResetIfNotActive  (void);
     void            _endResetIfNotActive    (void);
+    void            _invalidateContainment  (void) { _containmentValid = false; }
+    void            _buildContainment       (void) const;
+    bool            _containsPointF         (const QPointF& point) const;
+
+    typedef struct {
+        bool                    success;
+        QList<QGeoCoordinate>   coords;
+        QString                 errorString;
+    } LoadResult_t;
 
     QVariantList        _polygonPath;
     QmlObjectListModel  _polygonModel;
@@ -167,6 +203,26 @@ private:
     bool                _traceMode =            false;
     bool                _showAltColor =         false;
     int                 _selectedVertexIndex =  -1;
+
+    // Containment is tested against a cached copy of the projected polygon. Its edges are bucketed into horizontal
+    // slabs so a test only has to look at the few edges which cross the slab of the point.
+    mutable bool                    _containmentValid = false;
+    mutable QPolygonF               _containmentPolygon;
+    mutable QRectF                  _containmentBounds;
+    mutable double                  _containmentSlabHeight = 0;
+    mutable QVector<QVector<int>>   _containmentSlabs;      ///< Indices of the edges which cross each slab, edge i goes from vertex i to i + 1
+
+    // The worker thread reports the progress of a background load through _loadState in units of _loadProgressScale,
+    // the GUI thread sets it to _loadCancelled to stop it
+    QFutureWatcher<LoadResult_t>    _loadWatcher;
+    QSharedPointer<QAtomicInt>      _loadState;
+    QTimer                          _loadProgressTimer;
+    double                          _loadProgress = 0;
+
+    static const int _maxContainmentSlabs       = 1024;
+    static const int _loadProgressScale         = 1000;
+    static const int _loadCancelled             = -1;
+    static const int _loadProgressIntervalMSecs = 100;
 };
 
 #endif
@@ -10,6 +10,10 @@
 #include "QGCMapPolygonTest.h"
 #include "QGCApplication.h"
 #include "QGCQGeoCoordinate.h"
+#include "KMLHelper.h"
+#include "ShapeFileHelper.h"
+
+#include <QSignalSpy>
 
 QGCMapPolygonTest::QGCMapPolygonTest(void)
 {
@@ -254,3 +258,82 @@ void QGCMapPolygonTest::_testSelectVertex(void)
     _mapPolygon->removeVertex(0);
     QVERIFY(_mapPolygon->selectedVertex() == _mapPolygon->count() - 1);
 }
+
+void QGCMapPolygonTest::_testContainment(void)
+{
+    // Star shaped polygon with enough vertices to spread its edges over many slabs
+    const QGeoCoordinate    center      (47.633, -122.089);
+    const int               cVertices   = 2000;
+    for (int i=0; i<cVertices; i++) {
+        _mapPolygon->appendVertex(center.atDistanceAndAzimuth(i % 2 ? 500 : 1000, (360.0 * i) / cVertices));
+    }
+
+    QList<QGeoCoordinate> coordinates;
+    coordinates << center <<
+                   center.atDistanceAndAzimuth(400, 33) <<
+                   center.atDistanceAndAzimuth(1100, 33) <<
+                   center.atDistanceAndAzimuth(5000, 200);
+    QList<bool> contains = _mapPolygon->containsCoordinates(coordinates);
+    QCOMPARE(contains.count(), coordinates.count());
+    QCOMPARE(contains[0], true);
+    QCOMPARE(contains[1], true);
+    QCOMPARE(contains[2], false);
+    QCOMPARE(contains[3], false);
+    for (int i=0; i<coordinates.count(); i++) {
+        QCOMPARE(_mapPolygon->containsCoordinate(coordinates[i]), contains[i]);
+    }
+
+    // Moving a vertex has to invalidate the cached index
+    const QGeoCoordinate outside = center.atDistanceAndAzimuth(1500, 0);
+    QCOMPARE(_mapPolygon->containsCoordinate(outside), false);
+    _mapPolygon->adjustVertex(0, center.atDistanceAndAzimuth(2000, 0));
+    QCOMPARE(_mapPolygon->containsCoordinate(outside), true);
+
+    _mapPolygon->clear();
+    QCOMPARE(_mapPolygon->containsCoordinate(center), false);
+    QCOMPARE(_mapPolygon->containsCoordinates(coordinates), QList<bool>({ false, false, false, false }));
+}
+
+void QGCMapPolygonTest::_testShapeImport(void)
+{
+    // Coordinates arrive in pieces, a tuple cut off at the end of one is left for the next
+    QList<QGeoCoordinate>   coords;
+    QString                 text(QStringLiteral("  -122.1,47.6,0 -122.2,47.7"));
+    int consumed = KMLHelper::parseCoordinates(QStringRef(&text), false /* final */, coords);
+    QCOMPARE(coords.count(), 1);
+    QCOMPARE(text.mid(consumed), QStringLiteral("-122.2,47.7"));
+    text = text.mid(consumed) + QStringLiteral(",0\n");
+    consumed = KMLHelper::parseCoordinates(QStringRef(&text), true /* final */, coords);
+    QCOMPARE(consumed, text.length());
+    QCOMPARE(coords.count(), 2);
+    QCOMPARE(coords[1], QGeoCoordinate(47.7, -122.2));
+    text = QStringLiteral("-122.1;47.6");
+    QCOMPARE(KMLHelper::parseCoordinates(QStringRef(&text), true /* final */, coords), -1);
+
+    // A dense circle simplifies to far fewer vertices which are all taken from the original
+    const QGeoCoordinate    center(47.633, -122.089);
+    QList<QGeoCoordinate>   circle;
+    for (int i=0; i<3600; i++) {
+        circle.append(center.atDistanceAndAzimuth(1000, i / 10.0));
+    }
+    QList<QGeoCoordinate> simplified = circle;
+    ShapeFileHelper::simplify(simplified, 10, true /* closed */);
+    QVERIFY(simplified.count() >= 3);
+    QVERIFY(simplified.count() < 100);
+    for (const QGeoCoordinate& coord: simplified) {
+        QVERIFY(circle.contains(coord));
+    }
+    simplified = circle;
+    ShapeFileHelper::simplify(simplified, 0, true /* closed */);
+    QCOMPARE(simplified.count(), circle.count());
+
+    // Background load replaces the polygon once it is done
+    QSignalSpy loadFinishedSpy(_mapPolygon, &QGCMapPolygon::loadFinished);
+    _mapPolygon->loadKMLOrSHPFileInBackground(QStringLiteral(":/unittest/PolygonGood.kml"));
+    QVERIFY(_mapPolygon->loading());
+    QVERIFY(loadFinishedSpy.wait(5000));
+    QCOMPARE(loadFinishedSpy[0][0].toBool(), true);
+    QVERIFY(!_mapPolygon->loading());
+    QCOMPARE(_mapPolygon->count(), 4);
+}
+
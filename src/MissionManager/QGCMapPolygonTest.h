@@ -30,6 +30,8 @@ private slots:
     void _testVertexManipulation(void);
     void _testKMLLoad(void);
     void _testSelectVertex(void);
+    void _testContainment(void);
+    void _testShapeImport(void);
 
 private:
     enum {
@@ -62,7 +62,7 @@ Item {
 
     function addEditingVisuals() {
         if (_objMgrEditingVisuals.empty) {
-            _objMgrEditingVisuals.createObjects([ dragHandlesComponent, splitHandlesComponent, centerDragHandleComponent ], mapControl, false /* addToMap */)
+            _objMgrEditingVisuals.createObjects([ dragHandlesComponent, centerDragHandleComponent ], mapControl, false /* addToMap */)
         }
     }
 
@@ -221,12 +221,21 @@ Item {
         selectExisting: true
 
         onAcceptedForLoad: {
-            mapPolygon.loadKMLOrSHPFile(file)
-            mapFitFunctions.fitMapViewportToMissionItems()
+            mapPolygon.loadKMLOrSHPFileInBackground(file)
             close()
         }
     }
 
+    Connections {
+        target: mapPolygon
+
+        onLoadFinished: {
+            if (success) {
+                mapFitFunctions.fitMapViewportToMissionItems()
+            }
+        }
+    }
+
     QGCMenu {
         id: menu
 
@@ -306,42 +315,6 @@ Item {
         }
     }
 
-    Component {
-        id: splitHandlesComponent
-
-        Repeater {
-            model: mapPolygon.path
-
-            delegate: Item {
-                property var _splitHandle
-                property var _vertices:     mapPolygon.path
-
-                function _setHandlePosition() {
-                    var nextIndex = index + 1
-                    if (nextIndex > _vertices.length - 1) {
-                        nextIndex = 0
-                    }
-                    var distance = _vertices[index].distanceTo(_vertices[nextIndex])
-                    var azimuth = _vertices[index].azimuthTo(_vertices[nextIndex])
-                    _splitHandle.coordinate = _vertices[index].atDistanceAndAzimuth(distance / 2, azimuth)
-                }
-
-                Component.onCompleted: {
-                    _splitHandle = splitHandleComponent.createObject(mapControl)
-                    _splitHandle.vertexIndex = index
-                    _setHandlePosition()
-                    mapControl.addMapItem(_splitHandle)
-                }
-
-                Component.onDestruction: {
-                    if (_splitHandle) {
-                        _splitHandle.destroy()
-                    }
-                }
-            }
-        }
-    }
-
     // Control which is used to drag polygon vertices
     Component {
         id: dragAreaComponent
@@ -423,32 +396,85 @@ Item {
         }
     }
 
-    // Add all polygon vertex drag handles to the map
+    // All the polygon vertices are drawn by a single layer. Drag and split handles are only added to the map for the
+    // vertices in view, and only once there are few enough of them to be worth dragging.
     Component {
         id: dragHandlesComponent
 
-        Repeater {
-            model: mapPolygon.pathModel
-
-            delegate: Item {
-                property var _visuals: [ ]
-
-                Component.onCompleted: {
-                    var dragHandle = dragHandleComponent.createObject(mapControl)
-                    dragHandle.coordinate = Qt.binding(function() { return object.coordinate })
-                    dragHandle.polygonVertex = Qt.binding(function() { return index })
-                    mapControl.addMapItem(dragHandle)
-                    var dragArea = dragAreaComponent.createObject(mapControl, { "itemIndicator": dragHandle, "itemCoordinate": object.coordinate })
-                    dragArea.polygonVertex = Qt.binding(function() { return index })
-                    _visuals.push(dragHandle)
-                    _visuals.push(dragArea)
+        PlanMapLayer {
+            id:             vertexLayer
+            anchors.fill:   parent
+            mapPolygon:     _root.mapPolygon
+            center:         mapControl.center
+            zoomLevel:      mapControl.zoomLevel
+            bearing:        mapControl.bearing
+            showMarkers:    false
+            showLines:      false
+            vertexRadius:   ScreenTools.defaultFontPixelHeight * 0.75
+            visible:        !_circleMode
+            z:              _zorderSplitHandle
+
+            Repeater {
+                model: vertexLayer.handleVertices
+
+                delegate: Item {
+                    property var _visuals: [ ]
+
+                    Component.onCompleted: {
+                        var vertexObject = mapPolygon.pathModel.get(modelData)
+                        var dragHandle = dragHandleComponent.createObject(mapControl)
+                        dragHandle.coordinate = Qt.binding(function() { return vertexObject.coordinate })
+                        dragHandle.polygonVertex = modelData
+                        mapControl.addMapItem(dragHandle)
+                        var dragArea = dragAreaComponent.createObject(mapControl, { "itemIndicator": dragHandle, "itemCoordinate": vertexObject.coordinate })
+                        dragArea.polygonVertex = modelData
+                        _visuals.push(dragHandle)
+                        _visuals.push(dragArea)
+                    }
+
+                    Component.onDestruction: {
+                        for (var i=0; i<_visuals.length; i++) {
+                            _visuals[i].destroy()
+                        }
+                        _visuals = [ ]
+                    }
                 }
+            }
+
+            Repeater {
+                model: vertexLayer.handleVertices
 
-                Component.onDestruction: {
-                    for (var i=0; i<_visuals.length; i++) {
-                        _visuals[i].destroy()
+                delegate: Item {
+                    property var _splitHandle
+                    property var _vertices:     mapPolygon.path
+
+                    on_VerticesChanged: _setHandlePosition()
+
+                    function _setHandlePosition() {
+                        if (!_splitHandle || modelData >= _vertices.length) {
+                            return
+                        }
+                        var nextIndex = modelData + 1
+                        if (nextIndex > _vertices.length - 1) {
+                            nextIndex = 0
+                        }
+                        var distance = _vertices[modelData].distanceTo(_vertices[nextIndex])
+                        var azimuth = _vertices[modelData].azimuthTo(_vertices[nextIndex])
+                        _splitHandle.coordinate = _vertices[modelData].atDistanceAndAzimuth(distance / 2, azimuth)
+                    }
+
+                    Component.onCompleted: {
+                        _splitHandle = splitHandleComponent.createObject(mapControl)
+                        _splitHandle.vertexIndex = modelData
+                        _setHandlePosition()
+                        mapControl.addMapItem(_splitHandle)
+                    }
+
+                    Component.onDestruction: {
+                        if (_splitHandle) {
+                            _splitHandle.destroy()
+                        }
                     }
-                    _visuals = [ ]
                 }
             }
         }
@@ -557,8 +583,8 @@ Item {
 
             QGCButton {
                 _horizontalPadding: 0
-                text:               qsTr("Load KML/SHP...")
-                onClicked:          kmlOrSHPLoadDialog.openForLoad()
+                text:               mapPolygon.loading ? qsTr("Cancel Load (%1%)").arg(Math.round(mapPolygon.loadProgress * 100)) : qsTr("Load KML/SHP...")
+                onClicked:          mapPolygon.loading ? mapPolygon.cancelLoad() : kmlOrSHPLoadDialog.openForLoad()
                 visible:            !mapPolygon.traceMode
             }
         }
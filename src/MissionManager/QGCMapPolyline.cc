@@ -18,11 +18,19 @@
 #include <QDebug>
 #include <QJsonArray>
 #include <QLineF>
+#include <QVector>
 #include <QFile>
 #include <QDomDocument>
+#include <QtMath>
 
 const char* QGCMapPolyline::jsonPolylineKey = "polyline";
 
+const double    QGCMapPolyline::_offsetMiterLimit =         2.0;
+const double    QGCMapPolyline::_offsetRoundJoinStep =      M_PI / 8.0;
+const int       QGCMapPolyline::_offsetMaxLoopSegments =    256;
+
+static const double _metersPerDegree = 6371000.0 * M_PI / 180.0;
+
 QGCMapPolyline::QGCMapPolyline(QObject* parent)
     : QObject               (parent)
     , _dirty                (false)
@@ -127,10 +135,12 @@ void QGCMapPolyline::setPath(const QList<QGeoCoordinate>& path)
 
     _polylinePath.clear();
     _polylineModel.clearAndDeleteContents();
+    QList<QObject*> objects;
     for (const QGeoCoordinate& coord: path) {
         _polylinePath.append(QVariant::fromValue(coord));
-        _polylineModel.append(new QGCQGeoCoordinate(coord, this));
+        objects.append(new QGCQGeoCoordinate(coord, this));
     }
+    _polylineModel.append(objects);
 
     setDirty(true);
 
@@ -143,9 +153,11 @@ void QGCMapPolyline::setPath(const QVariantList& path)
 
     _polylinePath = path;
     _polylineModel.clearAndDeleteContents();
+    QList<QObject*> objects;
     for (int i=0; i<_polylinePath.count(); i++) {
-        _polylineModel.append(new QGCQGeoCoordinate(_polylinePath[i].value<QGeoCoordinate>(), this));
+        objects.append(new QGCQGeoCoordinate(_polylinePath[i].value<QGeoCoordinate>(), this));
     }
+    _polylineModel.append(objects);
     setDirty(true);
 
     _endResetIfNotActive();
@@ -178,9 +190,11 @@ bool QGCMapPolyline::loadFromJson(const QJsonObject& json, bool required, QStrin
         return false;
     }
 
+    QList<QObject*> objects;
     for (int i=0; i<_polylinePath.count(); i++) {
-        _polylineModel.append(new QGCQGeoCoordinate(_polylinePath[i].value<QGeoCoordinate>(), this));
+        objects.append(new QGCQGeoCoordinate(_polylinePath[i].value<QGeoCoordinate>(), this));
     }
+    _polylineModel.append(objects);
 
     setDirty(false);
     emit pathChanged();
@@ -276,18 +290,17 @@ QList<QPointF> QGCMapPolyline::nedPolyline(void)
     QList<QPointF>  nedPolyline;
 
     if (count() > 0) {
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
-
-        for (int i=0; i<_polylinePath.count(); i++) {
-            double y, x, down;
-            QGeoCoordinate vertex = vertexCoordinate(i);
-            if (i == 0) {
-                // This avoids a nan calculation that comes out of convertGeoToNed
-                x = y = 0;
-            } else {
-                convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
-            }
-            nedPolyline += QPointF(x, y);
+        QVector<QGeoCoordinate> coords(_polylinePath.count());
+        QVector<double>         north(coords.count());
+        QVector<double>         east(coords.count());
+
+        for (int i=0; i<coords.count(); i++) {
+            coords[i] = vertexCoordinate(i);
+        }
+        convertGeoToNed(coords.constData(), coords.count(), coords[0], north.data(), east.data(), nullptr);
+        nedPolyline.reserve(coords.count());
+        for (int i=0; i<coords.count(); i++) {
+            nedPolyline += QPointF(east[i], north[i]);
         }
     }
 
@@ -299,61 +312,211 @@ QList<QGeoCoordinate> QGCMapPolyline::offsetPolyline(double distance)
 {
     QList<QGeoCoordinate> rgNewPolyline;
 
-    // I'm sure there is some beautiful famous algorithm to do this, but here is a brute force method
-
     if (count() > 1) {
-        // Convert the polygon to NED
-        QList<QPointF> rgNedVertices = nedPolyline();
-
-        // Walk the edges, offsetting by the specified distance
-        QList<QLineF> rgOffsetEdges;
-        for (int i=0; i<rgNedVertices.count() - 1; i++) {
-            QLineF  offsetEdge;
-            QLineF  originalEdge(rgNedVertices[i], rgNedVertices[i + 1]);
-
-            QLineF workerLine = originalEdge;
-            workerLine.setLength(distance);
-            workerLine.setAngle(workerLine.angle() - 90.0);
-            offsetEdge.setP1(workerLine.p2());
-
-            workerLine.setPoints(originalEdge.p2(), originalEdge.p1());
-            workerLine.setLength(distance);
-            workerLine.setAngle(workerLine.angle() + 90.0);
-            offsetEdge.setP2(workerLine.p2());
-
-            rgOffsetEdges.append(offsetEdge);
+        _updateOffsetJoins(coordinateList());
+
+        const double absDistance = qAbs(distance);
+        for (const OffsetJoin_t& join: _offsetJoins) {
+            for (const QPointF& offset: distance >= 0 ? join.left : join.right) {
+                double longitude = join.vertex.longitude() + (offset.x() * absDistance * join.lonPerMeter);
+                if (longitude > 180.0) {
+                    longitude -= 360.0;
+                } else if (longitude < -180.0) {
+                    longitude += 360.0;
+                }
+                rgNewPolyline.append(QGeoCoordinate(join.vertex.latitude() + (offset.y() * absDistance * join.latPerMeter), longitude, join.vertex.altitude()));
+            }
+        }
+
+        _removeOffsetLoops(rgNewPolyline, absDistance);
+    }
+
+    return rgNewPolyline;
+}
+
+/// Brings _offsetJoins up to date with the specified vertices. A join depends on its vertex and the ones either side of
+/// it, so moving a vertex only recalculates three joins.
+void QGCMapPolyline::_updateOffsetJoins(const QList<QGeoCoordinate>& vertices)
+{
+    if (vertices.count() != _offsetJoinVertices.count()) {
+        _offsetJoins.resize(vertices.count());
+        for (int i=0; i<vertices.count(); i++) {
+            _offsetJoins[i] = _offsetJoin(vertices, i);
+        }
+    } else {
+        int lastUpdated = -1;
+        for (int i=0; i<vertices.count(); i++) {
+            if (vertices[i] != _offsetJoinVertices[i]) {
+                for (int j=qMax(i - 1, lastUpdated + 1); j<=qMin(i + 1, vertices.count() - 1); j++) {
+                    _offsetJoins[j] = _offsetJoin(vertices, j);
+                    lastUpdated = j;
+                }
+            }
         }
+    }
+
+    _offsetJoinVertices = vertices;
+}
 
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
+QGCMapPolyline::OffsetJoin_t QGCMapPolyline::_offsetJoin(const QList<QGeoCoordinate>& vertices, int index) const
+{
+    OffsetJoin_t join;
 
-        // Add first vertex
-        QGeoCoordinate coord;
-        convertNedToGeo(rgOffsetEdges[0].p1().y(), rgOffsetEdges[0].p1().x(), 0, tangentOrigin, &coord);
-        rgNewPolyline.append(coord);
+    join.vertex         = vertices[index];
+    join.latPerMeter    = 1.0 / _metersPerDegree;
+    join.lonPerMeter    = join.latPerMeter / qMax(qCos(qDegreesToRadians(join.vertex.latitude())), 1e-6);
 
-        // Intersect the offset edges to generate new central vertices
-        QPointF  newVertex;
-        for (int i=1; i<rgOffsetEdges.count(); i++) {
+    // Unit direction from one vertex to another in the local east/north frame of this vertex. Repeated vertices are
+    // skipped so they don't leave the join without a direction.
+    auto direction = [&join](const QGeoCoordinate& from, const QGeoCoordinate& to, QPointF& unit) {
+        double deltaLon = to.longitude() - from.longitude();
+        if (deltaLon > 180.0) {
+            deltaLon -= 360.0;
+        } else if (deltaLon < -180.0) {
+            deltaLon += 360.0;
+        }
+        const QPointF   delta(deltaLon / join.lonPerMeter, (to.latitude() - from.latitude()) / join.latPerMeter);
+        const double    length = qSqrt(QPointF::dotProduct(delta, delta));
+        if (length < 1e-3) {
+            return false;
+        }
+        unit = delta / length;
+        return true;
+    };
+
+    QPointF dirIn;
+    QPointF dirOut;
+    bool    haveIn  = false;
+    bool    haveOut = false;
+    for (int i=index - 1; i>=0 && !haveIn; i--) {
+        haveIn = direction(vertices[i], join.vertex, dirIn);
+    }
+    for (int i=index + 1; i<vertices.count() && !haveOut; i++) {
+        haveOut = direction(join.vertex, vertices[i], dirOut);
+    }
+
+    // Rotate 90 degrees counter-clockwise to get the left side normal
+    auto leftNormal = [](const QPointF& dir) { return QPointF(-dir.y(), dir.x()); };
+
+    if (!haveIn || !haveOut) {
+        // Ends of the line are offset square to the first/last edge
+        if (haveIn || haveOut) {
+            const QPointF normal = leftNormal(haveIn ? dirIn : dirOut);
+            join.left.append(normal);
+            join.right.append(-normal);
+        } else {
+            join.left.append(QPointF());
+            join.right.append(QPointF());
+        }
+        return join;
+    }
+
+    const QPointF   normalIn    = leftNormal(dirIn);
+    const QPointF   normalOut   = leftNormal(dirOut);
+    const double    cross       = (dirIn.x() * dirOut.y()) - (dirIn.y() * dirOut.x());
+    const double    dot         = QPointF::dotProduct(dirIn, dirOut);
+    const QPointF   sum         = normalIn + normalOut;
+    const double    sumLength   = qSqrt(QPointF::dotProduct(sum, sum));
+
+    if (sumLength < 1e-6) {
+        // Line doubles back on itself, both sides go round the tip
+        join.left.append(normalIn);
+        _appendRoundJoin(join.left, normalIn, -M_PI);
+        join.right.append(-normalIn);
+        _appendRoundJoin(join.right, -normalIn, M_PI);
+        return join;
+    }
+
+    // Miter is along the bisector of the two normals, long enough to meet both offset edges
+    const QPointF   bisector    = sum / sumLength;
+    const double    cosHalf     = QPointF::dotProduct(bisector, normalIn);
+    const QPointF   miter       = bisector / cosHalf;
+    const bool      useMiter    = (1.0 / cosHalf) <= _offsetMiterLimit;
+    const double    sweep       = qAtan2(cross, dot);   // Turn angle, positive turning left
+
+    // Left turn: left side is the inside of the turn, right side the outside. The other way round for a right turn.
+    QVector<QPointF>&   inside      = cross > 0 ? join.left : join.right;
+    QVector<QPointF>&   outside     = cross > 0 ? join.right : join.left;
+    const double        sideSign    = cross > 0 ? 1.0 : -1.0;
+
+    if (useMiter) {
+        inside.append(miter * sideSign);
+        outside.append(-miter * sideSign);
+    } else {
+        // The offset edges cross before they reach the miter, _removeOffsetLoops cuts them at the crossing
+        inside.append(normalIn * sideSign);
+        inside.append(normalOut * sideSign);
+
+        outside.append(-normalIn * sideSign);
+        _appendRoundJoin(outside, -normalIn * sideSign, sweep);
+    }
+
+    return join;
+}
+
+/// Appends the points of an arc which starts at from (which is already in the join) and turns through sweep radians
+void QGCMapPolyline::_appendRoundJoin(QVector<QPointF>& join, const QPointF& from, double sweep)
+{
+    const int steps = qMax(qCeil(qAbs(sweep) / _offsetRoundJoinStep), 1);
+    for (int i=1; i<=steps; i++) {
+        const double angle = (sweep * i) / steps;
+        join.append(QPointF((from.x() * qCos(angle)) - (from.y() * qSin(angle)), (from.x() * qSin(angle)) + (from.y() * qCos(angle))));
+    }
+}
+
+/// Cuts out the loops which form on the inside of turns which are tight compared to the offset distance. An edge which
+/// crosses a later edge has everything in between replaced by the crossing point.
+void QGCMapPolyline::_removeOffsetLoops(QList<QGeoCoordinate>& polyline, double distance)
+{
+    if (polyline.count() < 4 || distance <= 0) {
+        return;
+    }
+
+    // Intersections are done in degrees with longitude scaled for the first vertex. That is just an affine transform, so
+    // it finds exactly the same crossings as the geographic edges without projecting every vertex.
+    const double    lonScale        = qCos(qDegreesToRadians(polyline[0].latitude()));
+    const double    maxLoopLength   = (4.0 * M_PI * distance) / _metersPerDegree;
+
+    QList<QPointF> points;
+    points.reserve(polyline.count());
+    for (const QGeoCoordinate& coord: polyline) {
+        points.append(QPointF(coord.longitude() * lonScale, coord.latitude()));
+    }
+
+    int i = 0;
+    while (i < points.count() - 3) {
+        const QLineF    edge(points[i], points[i + 1]);
+        double          loopLength  = 0;
+        bool            cut         = false;
+
+        for (int j=i + 2; j<points.count() - 1 && j - i <= _offsetMaxLoopSegments; j++) {
+            loopLength += QLineF(points[j - 1], points[j]).length();
+            if (loopLength > maxLoopLength) {
+                break;
+            }
+
+            QPointF crossing;
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-            auto intersect = rgOffsetEdges[i - 1].intersect(rgOffsetEdges[i], &newVertex);
+            auto intersect = edge.intersect(QLineF(points[j], points[j + 1]), &crossing);
 #else
-            auto intersect = rgOffsetEdges[i - 1].intersects(rgOffsetEdges[i], &newVertex);
+            auto intersect = edge.intersects(QLineF(points[j], points[j + 1]), &crossing);
 #endif
-            if (intersect == QLineF::NoIntersection) {
-                // Two lines are colinear
-                newVertex = rgOffsetEdges[i].p2();
+            if (intersect == QLineF::BoundedIntersection) {
+                QGeoCoordinate crossingCoord(crossing.y(), crossing.x() / lonScale, polyline[i].altitude());
+                points.erase(points.begin() + i + 1, points.begin() + j + 1);
+                polyline.erase(polyline.begin() + i + 1, polyline.begin() + j + 1);
+                points.insert(i + 1, crossing);
+                polyline.insert(i + 1, crossingCoord);
+                cut = true;
+                break;
             }
-            convertNedToGeo(newVertex.y(), newVertex.x(), 0, tangentOrigin, &coord);
-            rgNewPolyline.append(coord);
         }
 
-        // Add last vertex
-        int lastIndex = rgOffsetEdges.count() - 1;
-        convertNedToGeo(rgOffsetEdges[lastIndex].p2().y(), rgOffsetEdges[lastIndex].p2().x(), 0, tangentOrigin, &coord);
-        rgNewPolyline.append(coord);
+        // After a cut the shortened edge is checked again since it may cross a later loop as well
+        if (!cut) {
+            i++;
+        }
     }
-
-    return rgNewPolyline;
 }
 
 bool QGCMapPolyline::loadKMLFile(const QString& kmlFile)
@@ -12,6 +12,8 @@
 #include <QObject>
 #include <QGeoCoordinate>
 #include <QVariantList>
+#include <QPointF>
+#include <QVector>
 
 #include "QmlObjectListModel.h"
 
@@ -48,7 +50,13 @@ public:
     /// Splits the line segment comprised of vertexIndex -> vertexIndex + 1
     Q_INVOKABLE void splitSegment(int vertexIndex);
 
-    /// Offsets the current polyline edges by the specified distance in meters
+    /// Offsets the current polyline edges by the specified distance in meters, positive distance is to the left of the
+    /// direction of travel.
+    ///
+    /// Each vertex is offset in its own local east/north frame, so long lines don't distort away from the first vertex.
+    /// Joins are mitered, with round joins on the outside of turns sharper than the miter limit allows. Loops which the
+    /// inside of a sharp turn would produce are cut out. The join geometry only depends on a vertex and its neighbours,
+    /// so it is kept per vertex and only recalculated around the vertices which moved since the last call.
     /// @return Offset set of vertices
     QList<QGeoCoordinate> offsetPolyline(double distance);
 
@@ -120,6 +128,20 @@ private slots:
     void _polylineModelDirtyChanged(bool dirty);
 
 private:
+    /// Join geometry for one vertex, independent of the offset distance
+    typedef struct {
+        QGeoCoordinate      vertex;
+        double              latPerMeter;
+        double              lonPerMeter;
+        QVector<QPointF>    left;           ///< East/north join points to the left, per meter of offset
+        QVector<QPointF>    right;          ///< East/north join points to the right, per meter of offset
+    } OffsetJoin_t;
+
+    void            _updateOffsetJoins      (const QList<QGeoCoordinate>& vertices);
+    OffsetJoin_t    _offsetJoin             (const QList<QGeoCoordinate>& vertices, int index) const;
+    static void     _removeOffsetLoops      (QList<QGeoCoordinate>& polyline, double distance);
+    static void     _appendRoundJoin        (QVector<QPointF>& join, const QPointF& from, double sweep);
+
     void            _init                   (void);
     QGeoCoordinate  _coordFromPointF        (const QPointF& point) const;
     QPointF         _pointFFromCoord        (const QGeoCoordinate& coordinate) const;
@@ -133,4 +155,11 @@ private:
     bool                _resetActive;
     bool                _traceMode = false;
     int                 _selectedVertexIndex = -1;
+
+    QList<QGeoCoordinate>   _offsetJoinVertices;    ///< Vertices _offsetJoins was built from
+    QVector<OffsetJoin_t>   _offsetJoins;
+
+    static const double _offsetMiterLimit;          ///< Longest miter, as a multiple of the offset, before a join is rounded
+    static const double _offsetRoundJoinStep;       ///< Largest angle between points of a round join, radians
+    static const int    _offsetMaxLoopSegments;     ///< Furthest ahead to look for a loop to cut out
 };
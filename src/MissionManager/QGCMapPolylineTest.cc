@@ -11,6 +11,8 @@
 #include "QGCApplication.h"
 #include "QGCQGeoCoordinate.h"
 
+#include <QtMath>
+
 QGCMapPolylineTest::QGCMapPolylineTest(void)
 {
     _linePoints << QGeoCoordinate(47.635638361473475, -122.09269407980834 ) <<
@@ -235,3 +237,53 @@ void QGCMapPolylineTest::_testSelectVertex(void)
     _mapPolyline->removeVertex(0);
     QVERIFY(_mapPolyline->selectedVertex() == _mapPolyline->count() - 1);
 }
+
+void QGCMapPolylineTest::_testOffset(void)
+{
+    const double offset = 50;
+
+    // Straight line, offset is square to the line and positive is to the left
+    QGeoCoordinate start(47.635638361473475, -122.09269407980834);
+    QGeoCoordinate end = start.atDistanceAndAzimuth(1000, 90);
+    _mapPolyline->appendVertex(start);
+    _mapPolyline->appendVertex(end);
+
+    QList<QGeoCoordinate> offsetLine = _mapPolyline->offsetPolyline(offset);
+    QCOMPARE(offsetLine.count(), 2);
+    QVERIFY(qAbs(start.distanceTo(offsetLine[0]) - offset) < 0.1);
+    QVERIFY(qAbs(end.distanceTo(offsetLine[1]) - offset) < 0.1);
+    QVERIFY(qAbs(start.azimuthTo(offsetLine[0])) < 0.5);
+
+    offsetLine = _mapPolyline->offsetPolyline(-offset);
+    QCOMPARE(offsetLine.count(), 2);
+    QVERIFY(qAbs(start.azimuthTo(offsetLine[0]) - 180.0) < 0.5);
+
+    // 150 degree left turn. Inside the turn the edges cross well before the vertex and the loop is cut out at the crossing.
+    QGeoCoordinate turn = end.atDistanceAndAzimuth(1000, 300);
+    _mapPolyline->appendVertex(turn);
+
+    offsetLine = _mapPolyline->offsetPolyline(offset);
+    QCOMPARE(offsetLine.count(), 3);
+    QVERIFY(qAbs(end.distanceTo(offsetLine[1]) - (offset / qCos(qDegreesToRadians(75.0)))) < 1.0);
+
+    // Outside the turn is rounded at the offset distance
+    offsetLine = _mapPolyline->offsetPolyline(-offset);
+    QVERIFY(offsetLine.count() > 4);
+    for (int i=1; i<offsetLine.count() - 1; i++) {
+        QVERIFY(qAbs(end.distanceTo(offsetLine[i]) - offset) < 0.5);
+    }
+
+    // Moving a vertex gives the same result as offsetting from scratch
+    QGeoCoordinate newTurn = end.atDistanceAndAzimuth(800, 10);
+    _mapPolyline->adjustVertex(2, newTurn);
+    QGCMapPolyline freshPolyline;
+    freshPolyline.appendVertices({ start, end, newTurn });
+    for (double distance: { offset, -offset }) {
+        QList<QGeoCoordinate> updated   = _mapPolyline->offsetPolyline(distance);
+        QList<QGeoCoordinate> expected  = freshPolyline.offsetPolyline(distance);
+        QCOMPARE(updated.count(), expected.count());
+        for (int i=0; i<updated.count(); i++) {
+            QVERIFY(updated[i].distanceTo(expected[i]) < 0.001);
+        }
+    }
+}
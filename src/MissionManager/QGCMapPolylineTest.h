@@ -30,6 +30,7 @@ private slots:
     void _testVertexManipulation(void);
 //    void _testKMLLoad(void);
     void _testSelectVertex(void);
+    void _testOffset(void);
 
 private:
     enum {
@@ -282,8 +282,10 @@ void SimpleMissionItem::save(QJsonArray&  missionItems)
             }
         }
         missionItems.append(saveObject);
-        item->deleteLater();
     }
+
+    // Deleted right away, with deleteLater every item of a large plan would be held until the save is done
+    qDeleteAll(items);
 }
 
 bool SimpleMissionItem::load(QTextStream &loadStream)
@@ -568,11 +570,25 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
 
 void SimpleMissionItem::_rebuildFacts(void)
 {
+    if (!_editorFactsBuilt) {
+        // Building the lists means command ui info lookups and metadata changes for each param. On large plans most
+        // items are never shown in the editor, so that work waits until _buildEditorFacts.
+        return;
+    }
+
     _rebuildTextFieldFacts();
     _rebuildNaNFacts();
     _rebuildComboBoxFacts();
 }
 
+void SimpleMissionItem::_buildEditorFacts(void)
+{
+    if (!_editorFactsBuilt) {
+        _editorFactsBuilt = true;
+        _rebuildFacts();
+    }
+}
+
 bool SimpleMissionItem::friendlyEditAllowed(void) const
 {
     const MissionCommandUIInfo* uiInfo = _commandTree->getUIInfo(_controllerVehicle, _previousVTOLMode, static_cast<MAV_CMD>(command()));
@@ -74,9 +74,9 @@ public:
     CameraSection*  cameraSection       (void) { return _cameraSection; }
     SpeedSection*   speedSection        (void) { return _speedSection; }
 
-    QmlObjectListModel* textFieldFacts  (void) { return &_textFieldFacts; }
-    QmlObjectListModel* nanFacts        (void) { return &_nanFacts; }
-    QmlObjectListModel* comboboxFacts   (void) { return &_comboboxFacts; }
+    QmlObjectListModel* textFieldFacts  (void) { _buildEditorFacts(); return &_textFieldFacts; }
+    QmlObjectListModel* nanFacts        (void) { _buildEditorFacts(); return &_nanFacts; }
+    QmlObjectListModel* comboboxFacts   (void) { _buildEditorFacts(); return &_comboboxFacts; }
 
     void setRawEdit(bool rawEdit);
     void setAltitudeMode(QGroundControlQmlGlobal::AltitudeMode altitudeMode);
@@ -161,11 +161,13 @@ private:
     void _updateOptionalSections(void);
     void _rebuildNaNFacts       (void);
     void _rebuildComboBoxFacts  (void);
+    void _buildEditorFacts      (void);
 
     MissionItem     _missionItem;
     bool            _rawEdit =                  false;
     bool            _dirty =                    false;
     bool            _ignoreDirtyChangeSignals = false;
+    bool            _editorFactsBuilt =         false;  ///< Editor fact lists are only built once the editor asks for them
     QGeoCoordinate  _mapCenterHint;
     SpeedSection*   _speedSection =             nullptr;
     CameraSection*  _cameraSection =             nullptr;
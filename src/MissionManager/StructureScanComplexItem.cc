@@ -80,6 +80,8 @@ StructureScanComplexItem::StructureScanComplexItem(PlanMasterController* masterC
     connect(&_structurePolygon, &QGCMapPolygon::countChanged,   this, &StructureScanComplexItem::_updateLastSequenceNumber);
     connect(&_layersFact,       &Fact::valueChanged,            this, &StructureScanComplexItem::_updateLastSequenceNumber);
 
+    // Must be first, everything else works from the cached vertices
+    connect(&_flightPolygon,    &QGCMapPolygon::pathChanged,    this, &StructureScanComplexItem::_updateFlightVertices);
     connect(&_flightPolygon,    &QGCMapPolygon::pathChanged,    this, &StructureScanComplexItem::_flightPathChanged);
 
     connect(_cameraCalc.distanceToSurface(),    &Fact::valueChanged,                this, &StructureScanComplexItem::_rebuildFlightPolygon);
@@ -117,9 +119,12 @@ StructureScanComplexItem::StructureScanComplexItem(PlanMasterController* masterC
     connect(&_layersFact,                           &Fact::valueChanged,                            this, &StructureScanComplexItem::_updateFlightPathSegmentsSignal);
     connect(_missionController,                     &MissionController::plannedHomePositionChanged, this, &StructureScanComplexItem::_updateFlightPathSegmentsSignal);
 
-    // The follow is used to compress multiple recalc calls in a row to into a single call.
-    connect(this, &StructureScanComplexItem::_updateFlightPathSegmentsSignal, this, &StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly,   Qt::QueuedConnection);
-    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&StructureScanComplexItem::_updateFlightPathSegmentsSignal));
+    // Each rebuild queries terrain for every new segment. Dragging a vertex changes the path on every mouse move, so all the
+    // changes in a row are collapsed into a single rebuild once they stop.
+    _segmentsTimer.setSingleShot(true);
+    _segmentsTimer.setInterval(_segmentsDebounceMSecs);
+    connect(this,               &StructureScanComplexItem::_updateFlightPathSegmentsSignal, &_segmentsTimer, static_cast<void (QTimer::*)(void)>(&QTimer::start));
+    connect(&_segmentsTimer,    &QTimer::timeout,                                           this, &StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly);
 
     _recalcLayerInfo();
 
@@ -276,9 +281,7 @@ void StructureScanComplexItem::_flightPathChanged(void)
     double west  = 360.0;
     double bottom = 100000.;
     double top = 0.;
-    QList<QGeoCoordinate> vertices = _flightPolygon.coordinateList();
-    for (int i = 0; i < vertices.count(); i++) {
-        QGeoCoordinate vertex = vertices[i];
+    for (const QGeoCoordinate& vertex: _flightVertices) {
         double lat = vertex.latitude()  + 90.0;
         double lon = vertex.longitude() + 180.0;
         north   = fmax(north, lat);
@@ -306,10 +309,8 @@ void StructureScanComplexItem::_flightPathChanged(void)
 double StructureScanComplexItem::greatestDistanceTo(const QGeoCoordinate &other) const
 {
     double greatestDistance = 0.0;
-    QList<QGeoCoordinate> vertices = _flightPolygon.coordinateList();
 
-    for (int i=0; i<vertices.count(); i++) {
-        QGeoCoordinate vertex = vertices[i];
+    for (const QGeoCoordinate& vertex: _flightVertices) {
         double distance = vertex.distanceTo(other);
         if (distance > greatestDistance) {
             greatestDistance = distance;
@@ -366,14 +367,16 @@ void StructureScanComplexItem::appendMissionItems(QList<MissionItem*>& items, QO
         layerAltitude += halfLayerHeight;
     }
 
-    for (int layer=0; layer<_layersFact.rawValue().toInt(); layer++) {
+    const double    triggerDistance = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    const int       layers          = _layersFact.rawValue().toInt();
+    for (int layer=0; layer<layers; layer++) {
         bool addTriggerStart = true;
 
         bool done = false;
         int currentVertex = _entryVertex;
         int processedVertices = 0;
         do {
-            QGeoCoordinate vertexCoord = _flightPolygon.vertexCoordinate(currentVertex);
+            const QGeoCoordinate& vertexCoord = _flightVertices[currentVertex];
 
             item = new MissionItem(seqNum++,
                                    MAV_CMD_NAV_WAYPOINT,
@@ -396,7 +399,7 @@ void StructureScanComplexItem::appendMissionItems(QList<MissionItem*>& items, QO
                 item = new MissionItem(seqNum++,
                                        MAV_CMD_DO_SET_CAM_TRIGG_DIST,
                                        MAV_FRAME_MISSION,
-                                       _cameraCalc.adjustedFootprintSide()->rawValue().toDouble(),  // trigger distance
+                                       triggerDistance,                                             // trigger distance
                                        0,                                                           // shutter integration (ignore)
                                        1,                                                           // trigger immediately when starting
                                        0, 0, 0, 0,                                                  // param 4-7 unused
@@ -408,13 +411,13 @@ void StructureScanComplexItem::appendMissionItems(QList<MissionItem*>& items, QO
 
             // Move to next vertext
             currentVertex++;
-            if (currentVertex >= _flightPolygon.count()) {
+            if (currentVertex >= _flightVertices.count()) {
                 currentVertex = 0;
             }
 
             // Have we processed all the vertices
             processedVertices++;
-            done = processedVertices == _flightPolygon.count() + 1;
+            done = processedVertices == _flightVertices.count() + 1;
         } while (!done);
 
         // Stop camera triggering after last waypoint in layer
@@ -526,6 +529,17 @@ void StructureScanComplexItem::rotateEntryPoint(void)
     }
     emit coordinateChanged(coordinate());
     emit exitCoordinateChanged(exitCoordinate());
+    emit _updateFlightPathSegmentsSignal();
+}
+
+void StructureScanComplexItem::_updateFlightVertices(void)
+{
+    _flightVertices = _flightPolygon.coordinateList();
+
+    _flightPerimeter = 0;
+    for (int i=0; i<_flightVertices.count(); i++) {
+        _flightPerimeter += _flightVertices[i].distanceTo(_flightVertices[i + 1 == _flightVertices.count() ? 0 : i + 1]);
+    }
 }
 
 void StructureScanComplexItem::_rebuildFlightPolygon(void)
@@ -556,24 +570,12 @@ void StructureScanComplexItem::_recalcCameraShots(void)
         return;
     }
 
-    if (_flightPolygon.count() < 3) {
-        _setCameraShots(0);
-        return;
-    }
-
-    // Determine the distance for each polygon traverse
-    double distance = 0;
-    for (int i=0; i<_flightPolygon.count(); i++) {
-        QGeoCoordinate coord1 = _flightPolygon.vertexCoordinate(i);
-        QGeoCoordinate coord2 = _flightPolygon.vertexCoordinate(i + 1 == _flightPolygon.count() ? 0 : i + 1);
-        distance += coord1.distanceTo(coord2);
-    }
-    if (distance == 0.0) {
+    if (_flightVertices.count() < 3 || _flightPerimeter == 0.0) {
         _setCameraShots(0);
         return;
     }
 
-    int cameraShots = static_cast<int>(distance / triggerDistance);
+    int cameraShots = static_cast<int>(_flightPerimeter / triggerDistance);
     _setCameraShots(cameraShots * _layersFact.rawValue().toInt());
 }
 
@@ -628,14 +630,8 @@ void StructureScanComplexItem::_recalcScanDistance()
 {
     double scanDistance = 0;
 
-    if (_flightPolygon.count() > 2) {
-        QList<QGeoCoordinate> vertices = _flightPolygon.coordinateList();
-        for (int i=0; i<vertices.count() - 1; i++) {
-            scanDistance += vertices[i].distanceTo(vertices[i+1]);
-        }
-        scanDistance += vertices.last().distanceTo(vertices.first());
-
-        scanDistance *= _layersFact.rawValue().toInt();
+    if (_flightVertices.count() > 2) {
+        scanDistance = _flightPerimeter * _layersFact.rawValue().toInt();
 
         double surfaceHeight = qMax(_structureHeightFact.rawValue().toDouble() - _scanBottomAltFact.rawValue().toDouble(), 0.0);
         scanDistance += surfaceHeight;
@@ -674,6 +670,7 @@ void StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly(void)
 {
     // Generation of flight segments depends on the following values:
     //  _flightPolygon,
+    //  _entryVertex
     //  _startFromTopFact
     //  _structureHeightFact,
     //  _scanBottomAltFact
@@ -683,75 +680,106 @@ void StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly(void)
     //  _layersFact
     // Any changes to these values must rebuild the segments
 
-    if (_cTerrainCollisionSegments != 0) {
-        _cTerrainCollisionSegments = 0;
-        emit terrainCollisionChanged(false);
-        _structurePolygon.setShowAltColor(false);
-    }
+    bool    startFromTop    = _startFromTopFact.rawValue().toBool();
+    double  homeAlt         = _missionController->plannedHomePosition().altitude();
+    double  layerHeight     = _cameraCalc.adjustedFootprintFrontal()->rawValue().toDouble();
 
-    _flightPathSegments.beginReset();
-    _flightPathSegments.clearAndDeleteContents();
+    SegmentsInfo_t info;
+    info.vertices           = _flightVertices;
+    info.entryVertex        = _entryVertex;
+    info.layers             = _flightVertices.count() > 2 ? qMax(_layersFact.rawValue().toInt(), 0) : 0;
+    info.layerStep          = startFromTop ? -layerHeight : layerHeight;
+    info.firstLayerAMSLAlt  = (startFromTop ? _structureHeightFact.rawValue().toDouble() : _scanBottomAltFact.rawValue().toDouble()) + (info.layerStep / 2.0) + homeAlt;
+    info.entranceAMSLAlt    = _entranceAltFact.rawValue().toDouble() + homeAlt;
 
-    if (_flightPolygon.count() > 2) {
+    // Layers are the bulk of the segments. If the footprint and layer spacing are the same only the layers which were
+    // added or removed and the entrance/exit segments are touched.
+    bool incremental = info.layers > 0 && _segmentsInfo.layers > 0 &&
+            info.entryVertex        == _segmentsInfo.entryVertex &&
+            info.firstLayerAMSLAlt  == _segmentsInfo.firstLayerAMSLAlt &&
+            info.layerStep          == _segmentsInfo.layerStep &&
+            info.vertices           == _segmentsInfo.vertices;
 
-        bool    startFromTop =  _startFromTopFact.rawValue().toBool();
-        double  startAltitude = (startFromTop ? _structureHeightFact.rawValue().toDouble() : _scanBottomAltFact.rawValue().toDouble());
+    bool hadTerrainCollision = _cTerrainCollisionSegments != 0;
 
-        // Set up for the first layer
-        double  prevLayerAltitude = 0;
-        double  layerAltitude = startAltitude;
-        double  halfLayerHeight = _cameraCalc.adjustedFootprintFrontal()->rawValue().toDouble() / 2.0;
-        if (startFromTop) {
-            layerAltitude -= halfLayerHeight;
+    if (incremental) {
+        const int layerSegmentCount = info.vertices.count() + 1;   // Edges plus the move up or down from the previous layer
+
+        // Exit always goes, it starts from the last layer
+        _removeFlightPathSegments(_flightPathSegments.count() - 1, 1);
+
+        if (info.layers < _segmentsInfo.layers) {
+            _removeFlightPathSegments(info.layers * layerSegmentCount, (_segmentsInfo.layers - info.layers) * layerSegmentCount);
         } else {
-            layerAltitude += halfLayerHeight;
+            for (int layerIndex=_segmentsInfo.layers; layerIndex<info.layers; layerIndex++) {
+                _appendLayerSegments(info, layerIndex);
+            }
         }
-        layerAltitude += _missionController->plannedHomePosition().altitude();
 
-        QGeoCoordinate layerEntranceCoord = _flightPolygon.vertexCoordinate(_entryVertex);
+        if (info.entranceAMSLAlt != _segmentsInfo.entranceAMSLAlt) {
+            const QGeoCoordinate& layerEntranceCoord = info.vertices[info.entryVertex];
+            _removeFlightPathSegments(0, 1);
+            _flightPathSegments.insert(0, _createFlightPathSegment(layerEntranceCoord, info.entranceAMSLAlt, layerEntranceCoord, info.firstLayerAMSLAlt));
+        }
 
-        // Entrance to first layer entrance
-        double entranceAlt = _entranceAltFact.rawValue().toDouble() + _missionController->plannedHomePosition().altitude();
-        _appendFlightPathSegment(layerEntranceCoord, entranceAlt, layerEntranceCoord, layerAltitude);
+        _appendExitSegment(info);
+    } else {
+        _cTerrainCollisionSegments = 0;
 
-        // Segments for each layer
-        for (int layerIndex=0; layerIndex<_layersFact.rawValue().toInt(); layerIndex++) {
-            // Move from one layer to the next
-            if (layerIndex != 0) {
-                _appendFlightPathSegment(layerEntranceCoord, prevLayerAltitude, layerEntranceCoord, layerAltitude);
-            }
+        _flightPathSegments.beginReset();
+        _flightPathSegments.clearAndDeleteContents();
 
-            QGeoCoordinate prevCoord = QGeoCoordinate();
-            for (const QGeoCoordinate& coord: _flightPolygon.coordinateList()) {
-                if (prevCoord.isValid()) {
-                    _appendFlightPathSegment(prevCoord, layerAltitude, coord, layerAltitude);
-                }
-                prevCoord = coord;
-            }
-            _appendFlightPathSegment(_flightPolygon.coordinateList().last(), layerAltitude, _flightPolygon.coordinateList().first(), layerAltitude);
-
-            // Move to next layer altitude
-            prevLayerAltitude = layerAltitude;
-            if (startFromTop) {
-                layerAltitude -= halfLayerHeight * 2;
-            } else {
-                layerAltitude += halfLayerHeight * 2;
+        if (info.layers > 0) {
+            // Entrance to first layer entrance
+            const QGeoCoordinate& layerEntranceCoord = info.vertices[info.entryVertex];
+            _appendFlightPathSegment(layerEntranceCoord, info.entranceAMSLAlt, layerEntranceCoord, info.firstLayerAMSLAlt);
+
+            for (int layerIndex=0; layerIndex<info.layers; layerIndex++) {
+                _appendLayerSegments(info, layerIndex);
             }
+
+            _appendExitSegment(info);
         }
 
-        // Last layer exit back to entrance
-        _appendFlightPathSegment(layerEntranceCoord, prevLayerAltitude, layerEntranceCoord, entranceAlt);
+        _flightPathSegments.endReset();
     }
 
-    _flightPathSegments.endReset();
+    _segmentsInfo = info;
 
-    if (_cTerrainCollisionSegments != 0) {
-        emit terrainCollisionChanged(true);
+    bool terrainCollision = _cTerrainCollisionSegments != 0;
+    if (terrainCollision != hadTerrainCollision) {
+        emit terrainCollisionChanged(terrainCollision);
+        _structurePolygon.setShowAltColor(terrainCollision);
     }
 
     _masterController->missionController()->recalcTerrainProfile();
 }
 
+void StructureScanComplexItem::_appendLayerSegments(const SegmentsInfo_t& info, int layerIndex)
+{
+    const double            layerAltitude       = info.firstLayerAMSLAlt + (layerIndex * info.layerStep);
+    const QGeoCoordinate&   layerEntranceCoord  = info.vertices[info.entryVertex];
+
+    // Move from one layer to the next
+    if (layerIndex != 0) {
+        _appendFlightPathSegment(layerEntranceCoord, layerAltitude - info.layerStep, layerEntranceCoord, layerAltitude);
+    }
+
+    for (int i=1; i<info.vertices.count(); i++) {
+        _appendFlightPathSegment(info.vertices[i - 1], layerAltitude, info.vertices[i], layerAltitude);
+    }
+    _appendFlightPathSegment(info.vertices.last(), layerAltitude, info.vertices.first(), layerAltitude);
+}
+
+/// Last layer exit back to entrance
+void StructureScanComplexItem::_appendExitSegment(const SegmentsInfo_t& info)
+{
+    const double            lastLayerAltitude   = info.firstLayerAMSLAlt + ((info.layers - 1) * info.layerStep);
+    const QGeoCoordinate&   layerEntranceCoord  = info.vertices[info.entryVertex];
+
+    _appendFlightPathSegment(layerEntranceCoord, lastLayerAltitude, layerEntranceCoord, info.entranceAMSLAlt);
+}
+
 double StructureScanComplexItem::minAMSLAltitude(void) const
 {
     double minAlt = qMin(bottomFlightAlt(), _entranceAltFact.rawValue().toDouble());
@@ -18,6 +18,8 @@
 #include "QGCMapPolygon.h"
 #include "CameraCalc.h"
 
+#include <QTimer>
+
 Q_DECLARE_LOGGING_CATEGORY(StructureScanComplexItemLog)
 
 class PlanMasterController;
@@ -134,10 +136,23 @@ private slots:
     void _recalcScanDistance                        (void);
     void _updateWizardMode                          (void);
     void _updateFlightPathSegmentsDontCallDirectly  (void);
+    void _updateFlightVertices                      (void);
 
 private:
+    /// What _flightPathSegments was last built from
+    typedef struct {
+        QList<QGeoCoordinate>   vertices;
+        int                     entryVertex;
+        int                     layers;             ///< 0: No segments
+        double                  firstLayerAMSLAlt;
+        double                  layerStep;          ///< Signed altitude change from one layer to the next
+        double                  entranceAMSLAlt;
+    } SegmentsInfo_t;
+
     void    _setCameraShots                 (int cameraShots);
     double  _triggerDistance                (void) const;
+    void    _appendLayerSegments            (const SegmentsInfo_t& info, int layerIndex);
+    void    _appendExitSegment              (const SegmentsInfo_t& info);
 
     QMap<QString, FactMetaData*> _metaDataMap;
 
@@ -152,6 +167,12 @@ private:
     double          _vehicleSpeed;
     CameraCalc      _cameraCalc;
 
+    QList<QGeoCoordinate>   _flightVertices;                ///< _flightPolygon vertices, updated when its path changes
+    double                  _flightPerimeter    = 0;        ///< Distance for one traverse of _flightPolygon
+    SegmentsInfo_t          _segmentsInfo       = { {}, 0, 0, 0, 0, 0 };
+    QTimer                  _segmentsTimer;
+
+    static const int        _segmentsDebounceMSecs = 100;
 
     SettingsFact    _scanBottomAltFact;
     SettingsFact    _structureHeightFact;
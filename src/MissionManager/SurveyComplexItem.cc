@@ -19,6 +19,11 @@
 #include "QGCApplication.h"
 
 #include <QPolygonF>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
 
 QGC_LOGGING_CATEGORY(SurveyComplexItemLog, "SurveyComplexItemLog")
 
@@ -71,6 +76,7 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     , _flyAlternateTransectsFact(settingsGroup, _metaDataMap[flyAlternateTransectsName])
     , _splitConcavePolygonsFact (settingsGroup, _metaDataMap[splitConcavePolygonsName])
     , _entryPoint               (EntryLocationTopLeft)
+    , _latestTransectsRequest   (new QAtomicInt(0))
 {
     _editorQml = "qrc:/qml/SurveyItemEditor.qml";
 
@@ -101,6 +107,8 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     connect(&_splitConcavePolygonsFact, &Fact::valueChanged,                        this, &SurveyComplexItem::_rebuildTransects);
     connect(this,                       &SurveyComplexItem::refly90DegreesChanged,  this, &SurveyComplexItem::_rebuildTransects);
 
+    connect(&_transectsWatcher,         &QFutureWatcherBase::finished,              this, &SurveyComplexItem::_transectsBuildFinished);
+
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::isValidChanged,             this, &SurveyComplexItem::_updateWizardMode);
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::traceModeChanged,           this, &SurveyComplexItem::_updateWizardMode);
 
@@ -111,6 +119,12 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     setDirty(false);
 }
 
+SurveyComplexItem::~SurveyComplexItem()
+{
+    // A build which is still running has no use for its results any more
+    _latestTransectsRequest->storeRelease(-1);
+}
+
 void SurveyComplexItem::save(QJsonArray&  planItems)
 {
     QJsonObject saveObject;
@@ -469,7 +483,7 @@ bool SurveyComplexItem::_gridAngleIsNorthSouthTransects()
     return gridAngle < 45.0 || (gridAngle > 360.0 - 45.0) || (gridAngle > 90.0 + 45.0 && gridAngle < 270.0 - 45.0);
 }
 
-void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects)
+void SurveyComplexItem::_adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects)
 {
     if (transects.count() == 0) {
         return;
@@ -478,10 +492,10 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
     bool reversePoints = false;
     bool reverseTransects = false;
 
-    if (_entryPoint == EntryLocationBottomLeft || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationBottomLeft || entryPoint == EntryLocationBottomRight) {
         reversePoints = true;
     }
-    if (_entryPoint == EntryLocationTopRight || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationTopRight || entryPoint == EntryLocationBottomRight) {
         reverseTransects = true;
     }
 
@@ -494,7 +508,7 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
         _reverseTransectOrder(transects);
     }
 
-    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << _entryPoint;
+    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << entryPoint;
 }
 
 QPointF SurveyComplexItem::_rotatePoint(const QPointF& point, const QPointF& origin, double angle)
@@ -577,14 +591,86 @@ void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList
 {
     resultLines.clear();
 
-    for (int i=0; i<lineList.count(); i++) {
-        const QLineF& line = lineList[i];
-        QList<QPointF> intersections;
+    int cLines = lineList.count();
+    int cEdges = polygon.count() - 1;
+    if (cLines == 0 || cEdges < 1) {
+        return;
+    }
 
-        // Intersect the line with all the polygon edges
-        for (int j=0; j<polygon.count()-1; j++) {
+    // Grid lines are all parallel, so an edge can only cross the lines whose offset along the line normal falls within the
+    // span of the edge. Lines and edges are swept in offset order so each line is only tested against the edges which can
+    // reach it instead of against every edge of the polygon.
+    QPointF direction   = lineList[0].p2() - lineList[0].p1();
+    double  length      = lineList[0].length();
+    bool    parallel    = length > 0;
+    for (int i=1; parallel && i<cLines; i++) {
+        QPointF lineDirection = lineList[i].p2() - lineList[i].p1();
+        double  cross = (direction.x() * lineDirection.y()) - (direction.y() * lineDirection.x());
+        parallel = qAbs(cross) <= 1e-9 * length * lineList[i].length();
+    }
+    QPointF normal = parallel ? QPointF(-direction.y() / length, direction.x() / length) : QPointF();
+
+    std::vector<double> lineOffsets(static_cast<size_t>(cLines));
+    std::vector<double> edgeMin(static_cast<size_t>(cEdges));
+    std::vector<double> edgeMax(static_cast<size_t>(cEdges));
+    double              maxOffset = 0;
+    for (int i=0; i<cLines; i++) {
+        lineOffsets[i] = QPointF::dotProduct(normal, lineList[i].p1());
+        maxOffset = qMax(maxOffset, qAbs(lineOffsets[i]));
+    }
+    for (int i=0; i<cEdges; i++) {
+        double offset1 = QPointF::dotProduct(normal, polygon[i]);
+        double offset2 = QPointF::dotProduct(normal, polygon[i+1]);
+        edgeMin[i] = qMin(offset1, offset2);
+        edgeMax[i] = qMax(offset1, offset2);
+        maxOffset = qMax(maxOffset, qMax(qAbs(offset1), qAbs(offset2)));
+    }
+    if (parallel) {
+        // Widen the spans a little so an edge which only touches a line is still tested. The intersection test itself is
+        // unchanged so the extra edges make no difference to the result.
+        double tolerance = 1e-6 * (1.0 + maxOffset);
+        for (int i=0; i<cEdges; i++) {
+            edgeMin[i] -= tolerance;
+            edgeMax[i] += tolerance;
+        }
+    } else {
+        // No common normal, every line needs to be tested against every edge
+        std::fill(edgeMin.begin(), edgeMin.end(), -std::numeric_limits<double>::infinity());
+        std::fill(edgeMax.begin(), edgeMax.end(), std::numeric_limits<double>::infinity());
+    }
+
+    std::vector<int> lineOrder(static_cast<size_t>(cLines));
+    std::vector<int> edgeOrder(static_cast<size_t>(cEdges));
+    std::iota(lineOrder.begin(), lineOrder.end(), 0);
+    std::iota(edgeOrder.begin(), edgeOrder.end(), 0);
+    std::sort(lineOrder.begin(), lineOrder.end(), [&lineOffsets](int a, int b) { return lineOffsets[a] < lineOffsets[b]; });
+    std::sort(edgeOrder.begin(), edgeOrder.end(), [&edgeMin](int a, int b) { return edgeMin[a] < edgeMin[b]; });
+
+    std::vector<int>        activeEdges;
+    std::vector<int>        candidateEdges;
+    std::vector<QPointF>    intersections;
+    std::vector<QLineF>     lineResults(static_cast<size_t>(cLines));
+    std::vector<bool>       lineHasResult(static_cast<size_t>(cLines), false);
+    size_t                  nextEdge = 0;
+
+    for (int lineIndex: lineOrder) {
+        const QLineF&   line    = lineList[lineIndex];
+        double          offset  = lineOffsets[lineIndex];
+
+        while (nextEdge < edgeOrder.size() && edgeMin[edgeOrder[nextEdge]] <= offset) {
+            activeEdges.push_back(edgeOrder[nextEdge++]);
+        }
+        activeEdges.erase(std::remove_if(activeEdges.begin(), activeEdges.end(), [&edgeMax, offset](int edgeIndex) { return edgeMax[edgeIndex] < offset; }), activeEdges.end());
+
+        // Going through the edges in polygon order keeps the same choice between equally distant points as testing every edge
+        candidateEdges = activeEdges;
+        std::sort(candidateEdges.begin(), candidateEdges.end());
+
+        // Intersect the line with the polygon edges which can reach it
+        intersections.clear();
+        for (int edgeIndex: candidateEdges) {
             QPointF intersectPoint;
-            QLineF polygonLine = QLineF(polygon[j], polygon[j+1]);
+            QLineF polygonLine = QLineF(polygon[edgeIndex], polygon[edgeIndex+1]);
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
             auto intersect = line.intersect(polygonLine, &intersectPoint);
@@ -592,23 +678,23 @@ void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList
             auto intersect = line.intersects(polygonLine, &intersectPoint);
 #endif
             if (intersect == QLineF::BoundedIntersection) {
-                if (!intersections.contains(intersectPoint)) {
-                    intersections.append(intersectPoint);
+                if (std::find(intersections.begin(), intersections.end(), intersectPoint) == intersections.end()) {
+                    intersections.push_back(intersectPoint);
                 }
             }
         }
 
         // We now have one or more intersection points all along the same line. Find the two
         // which are furthest away from each other to form the transect.
-        if (intersections.count() > 1) {
+        if (intersections.size() > 1) {
             QPointF firstPoint;
             QPointF secondPoint;
             double currentMaxDistance = 0;
 
-            for (int i=0; i<intersections.count(); i++) {
-                for (int j=0; j<intersections.count(); j++) {
+            for (size_t i=0; i<intersections.size(); i++) {
+                for (size_t j=0; j<intersections.size(); j++) {
                     QLineF lineTest(intersections[i], intersections[j]);
-                    \
+
                     double newMaxDistance = lineTest.length();
                     if (newMaxDistance > currentMaxDistance) {
                         firstPoint = intersections[i];
@@ -618,7 +704,14 @@ void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList
                 }
             }
 
-            resultLines += QLineF(firstPoint, secondPoint);
+            lineResults[lineIndex]      = QLineF(firstPoint, secondPoint);
+            lineHasResult[lineIndex]    = true;
+        }
+    }
+
+    for (int i=0; i<cLines; i++) {
+        if (lineHasResult[i]) {
+            resultLines += lineResults[i];
         }
     }
 }
@@ -678,62 +771,149 @@ double SurveyComplexItem::_turnaroundDistance(void) const
     return _turnAroundDistanceFact.rawValue().toDouble();
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1(void)
+SurveyComplexItem::TransectParams_t SurveyComplexItem::_transectParams(void) const
 {
-    bool split = splitConcavePolygons()->rawValue().toBool();
-	if (split) {
-		_rebuildTransectsPhase1WorkerSplitPolygons(false /* refly */);
-	} else {
-		_rebuildTransectsPhase1WorkerSinglePolygon(false /* refly */);
-	}
-    if (_refly90DegreesFact.rawValue().toBool()) {
-    	if (split) {
-    		_rebuildTransectsPhase1WorkerSplitPolygons(true /* refly */);
-    	} else {
-    		_rebuildTransectsPhase1WorkerSinglePolygon(true /* refly */);
-    	}
-    }
+    TransectParams_t params;
+
+    params.polygon                  = _surveyAreaPolygon.coordinateList();
+    params.gridAngle                = _gridAngleFact.rawValue().toDouble();
+    params.gridSpacing              = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    params.refly90Degrees           = _refly90DegreesFact.rawValue().toBool();
+    params.splitConcavePolygons     = _splitConcavePolygonsFact.rawValue().toBool();
+    params.flyAlternateTransects    = _flyAlternateTransectsFact.rawValue().toBool();
+    params.entryPoint               = _entryPoint;
+    params.hoverAndCapture          = triggerCamera() && hoverAndCaptureEnabled();
+    params.triggerDistance          = triggerDistance();
+    params.turnaroundDistance       = _turnAroundDistanceFact.rawValue().toDouble();
+
+    return params;
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
+void SurveyComplexItem::_clearLoadedMissionItems(void)
 {
-    if (_ignoreRecalc) {
-        return;
-    }
-
     // If the transects are getting rebuilt then any previously loaded mission items are now invalid
     if (_loadedMissionItemsParent) {
         _loadedMissionItems.clear();
         _loadedMissionItemsParent->deleteLater();
         _loadedMissionItemsParent = nullptr;
     }
+}
+
+void SurveyComplexItem::_rebuildTransectsPhase1(void)
+{
+    _clearLoadedMissionItems();
+    _transects = _buildTransects(_transectParams(), nullptr, 0);
+}
+
+bool SurveyComplexItem::_rebuildTransectsPhase1InBackground(void)
+{
+    if (qgcApp()->runningUnitTests() || _transects.isEmpty()) {
+        // Nothing is showing yet which could stand in while waiting, and unit tests expect the transects right away
+        return false;
+    }
+
+    _clearLoadedMissionItems();
+
+    // Any build still running for older settings gives up at its next check
+    _transectsRequest++;
+    _latestTransectsRequest->storeRelease(_transectsRequest);
+
+    if (_transectsWatcher.isRunning()) {
+        // Settings changes while a build is running, such as from a slider drag, are coalesced into a single build once it is done
+        _transectsRequestPending = true;
+    } else {
+        _startTransectsBuild();
+    }
+
+    return true;
+}
+
+void SurveyComplexItem::_startTransectsBuild(void)
+{
+    TransectParams_t            params          = _transectParams();
+    int                         request         = _transectsRequest;
+    QSharedPointer<QAtomicInt>  latestRequest   = _latestTransectsRequest;
+
+    qCDebug(SurveyComplexItemLog) << "_startTransectsBuild request" << request;
+
+    _transectsRequestPending    = false;
+    _runningTransectsRequest    = request;
+    _transectsWatcher.setFuture(QtConcurrent::run([params, latestRequest, request]() {
+        return _buildTransects(params, latestRequest.data(), request);
+    }));
+}
+
+void SurveyComplexItem::_transectsBuildFinished(void)
+{
+    if (_runningTransectsRequest != _transectsRequest) {
+        // Superseded while running
+        qCDebug(SurveyComplexItemLog) << "_transectsBuildFinished discarding request" << _runningTransectsRequest;
+        if (_transectsRequestPending) {
+            _startTransectsBuild();
+        }
+        return;
+    }
 
-    if (_surveyAreaPolygon.count() < 3) {
+    if (_ignoreRecalc) {
+        // A load is in progress which will rebuild the transects itself once done
         return;
     }
 
-    // Convert polygon to NED
+    // Swap the new transects in as a whole, the flight path and visuals are then built from them
+    _transects = _transectsWatcher.result();
+    _rebuildTransectsPhase2();
+}
 
-    QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
-        double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
-        if (i == 0) {
-            // This avoids a nan calculation that comes out of convertGeoToNed
-            x = y = 0;
+bool SurveyComplexItem::_transectsBuildCancelled(const QAtomicInt* latestRequest, int request)
+{
+    return latestRequest && latestRequest->loadAcquire() != request;
+}
+
+QList<QList<TransectStyleComplexItem::CoordInfo_t>> SurveyComplexItem::_buildTransects(const TransectParams_t& params, const QAtomicInt* latestRequest, int request)
+{
+    QList<QList<TransectStyleComplexItem::CoordInfo_t>> coordInfoTransects;
+
+    if (params.polygon.count() < 3) {
+        return coordInfoTransects;
+    }
+
+    int cPasses = params.refly90Degrees ? 2 : 1;
+    for (int pass=0; pass<cPasses; pass++) {
+        if (_transectsBuildCancelled(latestRequest, request)) {
+            return QList<QList<TransectStyleComplexItem::CoordInfo_t>>();
+        }
+
+        bool refly = pass == 1;
+        if (params.splitConcavePolygons) {
+            _buildTransectsSplitPolygons(params, refly, latestRequest, request, coordInfoTransects);
         } else {
-            convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
+            _buildTransectsSinglePolygon(params, refly, coordInfoTransects);
         }
-        polygonPoints += QPointF(x, y);
-        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertex << polygonPoints.last().x() << polygonPoints.last().y();
+    }
+
+    return coordInfoTransects;
+}
+
+void SurveyComplexItem::_buildTransectsSinglePolygon(const TransectParams_t& params, bool refly, QList<QList<TransectStyleComplexItem::CoordInfo_t>>& coordInfoTransects)
+{
+    // Convert polygon to NED
+
+    QList<QPointF> polygonPoints;
+    QGeoCoordinate tangentOrigin = params.polygon[0];
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << params.polygon.count() << tangentOrigin;
+    const QVector<QGeoCoordinate>   vertices = params.polygon.toVector();
+    QVector<double>                 north(vertices.count());
+    QVector<double>                 east(vertices.count());
+    convertGeoToNed(vertices.constData(), vertices.count(), tangentOrigin, north.data(), east.data(), nullptr);
+    for (int i=0; i<vertices.count(); i++) {
+        polygonPoints += QPointF(east[i], north[i]);
+        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertices[i] << polygonPoints.last().x() << polygonPoints.last().y();
     }
 
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
     if (gridSpacing < 0.5) {
         // We can't let gridSpacing get too small otherwise we will end up with too many transects.
         // So we limit to 0.5 meter spacing as min and set to huge value which will cause a single
@@ -793,7 +973,6 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -823,13 +1002,13 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transects);
 
     if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+        _optimizeTransectsForShortestDistance(coordInfoTransects.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (params.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -862,7 +1041,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to coordInfoTransects
     for (const QList<QGeoCoordinate>& transect : transects) {
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
@@ -874,14 +1053,14 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (params.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(params.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -889,9 +1068,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnaroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = params.turnaroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -906,44 +1085,25 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        coordInfoTransects.append(coordInfoTransect);
     }
 }
 
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
+void SurveyComplexItem::_buildTransectsSplitPolygons(const TransectParams_t& params, bool refly, const QAtomicInt* latestRequest, int request, QList<QList<TransectStyleComplexItem::CoordInfo_t>>& coordInfoTransects)
 {
-    if (_ignoreRecalc) {
-        return;
-    }
-
-    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
-    if (_loadedMissionItemsParent) {
-        _loadedMissionItems.clear();
-        _loadedMissionItemsParent->deleteLater();
-        _loadedMissionItemsParent = nullptr;
-    }
-
-    if (_surveyAreaPolygon.count() < 3) {
-        return;
-    }
-
     // Convert polygon to NED
 
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
-        double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
-        if (i == 0) {
-            // This avoids a nan calculation that comes out of convertGeoToNed
-            x = y = 0;
-        } else {
-            convertGeoToNed(vertex, tangentOrigin, &y, &x, &down);
-        }
-        polygonPoints += QPointF(x, y);
-        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertex << polygonPoints.last().x() << polygonPoints.last().y();
+    QGeoCoordinate tangentOrigin = params.polygon[0];
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << params.polygon.count() << tangentOrigin;
+    const QVector<QGeoCoordinate>   vertices = params.polygon.toVector();
+    QVector<double>                 north(vertices.count());
+    QVector<double>                 east(vertices.count());
+    convertGeoToNed(vertices.constData(), vertices.count(), tangentOrigin, north.data(), east.data(), nullptr);
+    for (int i=0; i<vertices.count(); i++) {
+        polygonPoints += QPointF(east[i], north[i]);
+        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertices[i] << polygonPoints.last().x() << polygonPoints.last().y();
     }
 
     // convert into QPolygonF
@@ -959,6 +1119,10 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
 
     // iterate over polygons
     for (auto p = polygons.begin(); p != polygons.end(); ++p) {
+        if (_transectsBuildCancelled(latestRequest, request)) {
+            return;
+        }
+
         QPointF* vMatch = nullptr;
         // find matching vertex in previous polygon
         if (p != polygons.begin()) {
@@ -982,84 +1146,103 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
         // TODO figure out tangent origin
         // TODO improve selection of entry points
 //        qCDebug(SurveyComplexItemLog) << "Transects from polynom p " << p;
-        _rebuildTransectsFromPolygon(refly, *p, tangentOrigin, vMatch);
+        _buildTransectsFromPolygon(params, refly, *p, tangentOrigin, vMatch, coordInfoTransects);
     }
 }
 
 void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons)
+{
+    // Sub polygons are worked on as indices into a single copy of the points, so nothing is copied while searching for
+    // the best split. The same sub polygon is reached through many different splits so each one is only decomposed once.
+    std::vector<QPointF>    points(polygon.begin(), polygon.end());
+    QVector<int>            indices(polygon.count());
+    DecomposeCache_t        cache;
+
+    std::iota(indices.begin(), indices.end(), 0);
+    for (const QVector<int>& subPolygonIndices: _decomposeConvexIndices(points, indices, cache)) {
+        QPolygonF subPolygon;
+        subPolygon.reserve(subPolygonIndices.count());
+        for (int index: subPolygonIndices) {
+            subPolygon << points[static_cast<size_t>(index)];
+        }
+        decomposedPolygons << subPolygon;
+    }
+}
+
+QList<QVector<int>> SurveyComplexItem::_decomposeConvexIndices(const std::vector<QPointF>& points, const QVector<int>& polygon, DecomposeCache_t& cache)
 {
 	// this follows "Mark Keil's Algorithm" https://mpen.ca/406/keil
-    int decompSize = std::numeric_limits<int>::max();
-    if (polygon.size() < 3) return;
-    if (polygon.size() == 3) {
-        decomposedPolygons << polygon;
-        return;
+    int cVertices = polygon.count();
+    if (cVertices < 3) {
+        return QList<QVector<int>>();
+    }
+    if (cVertices == 3) {
+        return QList<QVector<int>>({ polygon });
     }
 
-    QList<QPolygonF> decomposedPolygonsMin{};
+    auto cacheIter = cache.constFind(polygon);
+    if (cacheIter != cache.constEnd()) {
+        return cacheIter.value();
+    }
 
-    for (auto vertex = polygon.begin(); vertex != polygon.end(); ++vertex)
-    {
-        // is vertex reflex?
-        bool vertexIsReflex = _VertexIsReflex(polygon, vertex);
+    // Whether a vertex is reflex only depends on its neighbours in this polygon, so work it out once up front
+    std::vector<bool> reflex(static_cast<size_t>(cVertices));
+    for (int i=0; i<cVertices; i++) {
+        reflex[i] = _VertexIsReflex(points, polygon, i);
+    }
 
-        if (!vertexIsReflex) continue;
+    int                 decompSize = std::numeric_limits<int>::max();
+    QList<QVector<int>> decomposedPolygonsMin;
 
-        for (auto vertexOther = polygon.begin(); vertexOther != polygon.end(); ++vertexOther)
-        {
-            auto vertexBefore = vertex == polygon.begin() ? polygon.end() - 1 : vertex - 1;
-            auto vertexAfter = vertex == polygon.end() - 1 ? polygon.begin() : vertex + 1;
-            if (vertexOther == vertex) continue;
-            if (vertexAfter == vertexOther) continue;
-            if (vertexBefore == vertexOther) continue;
-            bool canSee = _VertexCanSeeOther(polygon, vertex, vertexOther);
-            if (!canSee) continue;
+    for (int vertex=0; vertex<cVertices; vertex++) {
+        if (!reflex[vertex]) {
+            continue;
+        }
 
-            QPolygonF polyLeft;
-            auto v = vertex;
-            auto polyLeftContainsReflex = false;
-            while ( v != vertexOther) {
-                if (v != vertex && _VertexIsReflex(polygon, v)) {
+        int vertexBefore    = vertex == 0 ? cVertices - 1 : vertex - 1;
+        int vertexAfter     = vertex == cVertices - 1 ? 0 : vertex + 1;
+
+        for (int vertexOther=0; vertexOther<cVertices; vertexOther++) {
+            if (vertexOther == vertex || vertexOther == vertexAfter || vertexOther == vertexBefore) {
+                continue;
+            }
+            if (!_VertexCanSeeOther(points, polygon, vertex, vertexOther)) {
+                continue;
+            }
+
+            QVector<int>    polyLeft;
+            bool            polyLeftContainsReflex = false;
+            for (int v=vertex; v!=vertexOther; v=(v + 1) % cVertices) {
+                if (v != vertex && reflex[v]) {
                     polyLeftContainsReflex = true;
                 }
-                polyLeft << *v;
-                ++v;
-                if (v == polygon.end()) v = polygon.begin();
+                polyLeft.append(polygon[v]);
             }
-            polyLeft << *vertexOther;
-            auto polyLeftValid = !(polyLeftContainsReflex && polyLeft.size() == 3);
-
-            QPolygonF polyRight;
-            v = vertexOther;
-            auto polyRightContainsReflex = false;
-            while ( v != vertex) {
-                if (v != vertex && _VertexIsReflex(polygon, v)) {
+            polyLeft.append(polygon[vertexOther]);
+            bool polyLeftValid = !(polyLeftContainsReflex && polyLeft.count() == 3);
+
+            QVector<int>    polyRight;
+            bool            polyRightContainsReflex = false;
+            for (int v=vertexOther; v!=vertex; v=(v + 1) % cVertices) {
+                if (reflex[v]) {
                     polyRightContainsReflex = true;
                 }
-                polyRight << *v;
-                ++v;
-                if (v == polygon.end()) v = polygon.begin();
+                polyRight.append(polygon[v]);
             }
-            polyRight << *vertex;
-            auto polyRightValid = !(polyRightContainsReflex && polyRight.size() == 3);
+            polyRight.append(polygon[vertex]);
+            bool polyRightValid = !(polyRightContainsReflex && polyRight.count() == 3);
 
-            if (!polyLeftValid || ! polyRightValid) {
-//                decompSize = std::numeric_limits<int>::max();
+            if (!polyLeftValid || !polyRightValid) {
                 continue;
             }
 
             // recursion
-            QList<QPolygonF> polyLeftDecomposed{};
-            _PolygonDecomposeConvex(polyLeft, polyLeftDecomposed);
-
-            QList<QPolygonF> polyRightDecomposed{};
-            _PolygonDecomposeConvex(polyRight, polyRightDecomposed);
+            QList<QVector<int>> polyLeftDecomposed  = _decomposeConvexIndices(points, polyLeft, cache);
+            QList<QVector<int>> polyRightDecomposed = _decomposeConvexIndices(points, polyRight, cache);
 
             // compositon
-            auto subSize = polyLeftDecomposed.size() + polyRightDecomposed.size();
-            if ((polyLeftContainsReflex && polyLeftDecomposed.size() == 1)
-                    || (polyRightContainsReflex && polyRightDecomposed.size() == 1))
-            {
+            int subSize = polyLeftDecomposed.count() + polyRightDecomposed.count();
+            if ((polyLeftContainsReflex && polyLeftDecomposed.count() == 1) || (polyRightContainsReflex && polyRightDecomposed.count() == 1)) {
                 // don't accept polygons that contian reflex vertices and were not split
                 subSize = std::numeric_limits<int>::max();
             }
@@ -1068,41 +1251,38 @@ void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<
                 decomposedPolygonsMin = polyLeftDecomposed + polyRightDecomposed;
             }
         }
-
     }
 
     // assemble output
-    if (decomposedPolygonsMin.size() > 0) {
-        decomposedPolygons << decomposedPolygonsMin;
-    } else {
-        decomposedPolygons << polygon;
+    if (decomposedPolygonsMin.isEmpty()) {
+        decomposedPolygonsMin.append(polygon);
     }
+    cache.insert(polygon, decomposedPolygonsMin);
 
-    return;
+    return decomposedPolygonsMin;
 }
 
-bool SurveyComplexItem::_VertexCanSeeOther(const QPolygonF& polygon, const QPointF* vertexA, const QPointF* vertexB) {
+bool SurveyComplexItem::_VertexCanSeeOther(const std::vector<QPointF>& points, const QVector<int>& polygon, int vertexA, int vertexB)
+{
+    int cVertices = polygon.count();
+
     if (vertexA == vertexB) return false;
-    auto vertexAAfter = vertexA + 1 == polygon.end() ? polygon.begin() : vertexA + 1;
-    auto vertexABefore = vertexA == polygon.begin() ? polygon.end() - 1 : vertexA - 1;
+    int vertexAAfter = vertexA + 1 == cVertices ? 0 : vertexA + 1;
+    int vertexABefore = vertexA == 0 ? cVertices - 1 : vertexA - 1;
     if (vertexAAfter == vertexB) return false;
     if (vertexABefore == vertexB) return false;
-//    qCDebug(SurveyComplexItemLog) << "_VertexCanSeeOther false after first checks ";
 
-    bool visible = true;
-//    auto diff = *vertexA - *vertexB;
-    QLineF lineAB{*vertexA, *vertexB};
-    auto distanceAB = lineAB.length();//sqrtf(diff.x() * diff.x() + diff.y()*diff.y());
+    const QPointF&  pointA      = points[static_cast<size_t>(polygon[vertexA])];
+    QLineF          lineAB      { pointA, points[static_cast<size_t>(polygon[vertexB])] };
+    double          distanceAB  = lineAB.length();
 
-//    qCDebug(SurveyComplexItemLog) << "_VertexCanSeeOther distanceAB " << distanceAB;
-    for (auto vertexC = polygon.begin(); vertexC != polygon.end(); ++vertexC)
-    {
+    for (int vertexC=0; vertexC<cVertices; vertexC++) {
         if (vertexC == vertexA) continue;
         if (vertexC == vertexB) continue;
-        auto vertexD = vertexC + 1 == polygon.end() ? polygon.begin() : vertexC + 1;
+        int vertexD = vertexC + 1 == cVertices ? 0 : vertexC + 1;
         if (vertexD == vertexA) continue;
         if (vertexD == vertexB) continue;
-        QLineF lineCD(*vertexC, *vertexD);
+        QLineF lineCD(points[static_cast<size_t>(polygon[vertexC])], points[static_cast<size_t>(polygon[vertexD])]);
         QPointF intersection{};
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
@@ -1111,39 +1291,33 @@ bool SurveyComplexItem::_VertexCanSeeOther(const QPolygonF& polygon, const QPoin
         auto intersects = lineAB.intersects(lineCD, &intersection);
 #endif
         if (intersects == QLineF::IntersectType::BoundedIntersection) {
-//            auto diffIntersection = *vertexA - intersection;
-//            auto distanceIntersection = sqrtf(diffIntersection.x() * diffIntersection.x() + diffIntersection.y()*diffIntersection.y());
-//            qCDebug(SurveyComplexItemLog) << "*vertexA " << *vertexA << "*vertexB " << *vertexB  << " intersection " << intersection;
-
-            QLineF lineIntersection{*vertexA, intersection};
-            auto distanceIntersection = lineIntersection.length();//sqrtf(diff.x() * diff.x() + diff.y()*diff.y());
-            qCDebug(SurveyComplexItemLog) << "_VertexCanSeeOther distanceIntersection " << distanceIntersection;
-            if (distanceIntersection < distanceAB) {
-                visible = false;
-                break;
+            QLineF lineIntersection{pointA, intersection};
+            if (lineIntersection.length() < distanceAB) {
+                return false;
             }
         }
-
     }
 
-    return visible;
+    return true;
 }
 
-bool SurveyComplexItem::_VertexIsReflex(const QPolygonF& polygon, const QPointF* vertex) {
-    auto vertexBefore = vertex == polygon.begin() ? polygon.end() - 1 : vertex - 1;
-    auto vertexAfter = vertex == polygon.end() - 1 ? polygon.begin() : vertex + 1;
-    auto area = (((vertex->x() - vertexBefore->x())*(vertexAfter->y() - vertexBefore->y()))-((vertexAfter->x() - vertexBefore->x())*(vertex->y() - vertexBefore->y())));
+bool SurveyComplexItem::_VertexIsReflex(const std::vector<QPointF>& points, const QVector<int>& polygon, int vertex)
+{
+    int             cVertices       = polygon.count();
+    const QPointF&  point           = points[static_cast<size_t>(polygon[vertex])];
+    const QPointF&  pointBefore     = points[static_cast<size_t>(polygon[vertex == 0 ? cVertices - 1 : vertex - 1])];
+    const QPointF&  pointAfter      = points[static_cast<size_t>(polygon[vertex == cVertices - 1 ? 0 : vertex + 1])];
+    auto area = (((point.x() - pointBefore.x())*(pointAfter.y() - pointBefore.y()))-((pointAfter.x() - pointBefore.x())*(point.y() - pointBefore.y())));
     return area > 0;
-
 }
 
 
-void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint)
+void SurveyComplexItem::_buildTransectsFromPolygon(const TransectParams_t& params, bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint, QList<QList<TransectStyleComplexItem::CoordInfo_t>>& coordInfoTransects)
 {
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
 
     gridAngle = _clampGridAngle90(gridAngle);
     gridAngle += refly ? 90 : 0;
@@ -1191,7 +1365,6 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -1231,13 +1404,13 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transects);
 
     if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+        _optimizeTransectsForShortestDistance(coordInfoTransects.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (params.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -1270,7 +1443,7 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to coordInfoTransects
     for (const QList<QGeoCoordinate>& transect: transects) {
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
@@ -1282,14 +1455,14 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (params.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(params.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -1297,9 +1470,9 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnaroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = params.turnaroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -1314,9 +1487,9 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        coordInfoTransects.append(coordInfoTransect);
     }
-    qCDebug(SurveyComplexItemLog) << "_transects.size() " << _transects.size();
+    qCDebug(SurveyComplexItemLog) << "coordInfoTransects.size() " << coordInfoTransects.size();
 }
 
 void SurveyComplexItem::_recalcCameraShots(void)
@@ -1366,16 +1539,9 @@ void SurveyComplexItem::_recalcCameraShots(void)
                 }
             } else {
                 // We have transects available, calc from those
-                for (const QList<TransectStyleComplexItem::CoordInfo_t>& transect: _transects) {
-                    QGeoCoordinate firstCameraCoord, lastCameraCoord;
-                    if (_hasTurnaround() && !hoverAndCaptureEnabled()) {
-                        firstCameraCoord = transect[1].coord;
-                        lastCameraCoord = transect[transect.count() - 2].coord;
-                    } else {
-                        firstCameraCoord = transect.first().coord;
-                        lastCameraCoord = transect.last().coord;
-                    }
-                    _cameraShots += qCeil(firstCameraCoord.distanceTo(lastCameraCoord) / triggerDistance);
+                bool skipTurnarounds = _hasTurnaround() && !hoverAndCaptureEnabled();
+                for (const TransectStats_t& stats: _transectStats) {
+                    _cameraShots += qCeil((skipTurnarounds ? stats.innerEntryExitDistance : stats.entryExitDistance) / triggerDistance);
                 }
             }
         }
@@ -14,6 +14,14 @@
 #include "SettingsFact.h"
 #include "QGCLoggingCategory.h"
 
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QHash>
+#include <QVector>
+
+#include <vector>
+
 Q_DECLARE_LOGGING_CATEGORY(SurveyComplexItemLog)
 
 class PlanMasterController;
@@ -26,6 +34,7 @@ public:
     /// @param flyView true: Created for use in the Fly View, false: Created for use in the Plan View
     /// @param kmlOrShpFile Polygon comes from this file, empty for default polygon
     SurveyComplexItem(PlanMasterController* masterController, bool flyView, const QString& kmlOrShpFile, QObject* parent);
+    ~SurveyComplexItem();
 
     Q_PROPERTY(Fact* gridAngle              READ gridAngle              CONSTANT)
     Q_PROPERTY(Fact* flyAlternateTransects  READ flyAlternateTransects  CONSTANT)
@@ -88,7 +97,11 @@ private slots:
     void _rebuildTransectsPhase1        (void) final;
     void _recalcCameraShots             (void) final;
 
+    void _transectsBuildFinished        (void);
+
 private:
+    friend class HotPathBenchmark;
+
     enum CameraTriggerCode {
         CameraTriggerNone,
         CameraTriggerOn,
@@ -96,21 +109,35 @@ private:
         CameraTriggerHoverAndCapture
     };
 
-    QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
-    void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
-    void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
-    void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
+    /// Everything transect generation needs, copied from the item so the transects can be built on a worker thread
+    typedef struct {
+        QList<QGeoCoordinate>   polygon;
+        double                  gridAngle;
+        double                  gridSpacing;
+        bool                    refly90Degrees;
+        bool                    splitConcavePolygons;
+        bool                    flyAlternateTransects;
+        int                     entryPoint;
+        bool                    hoverAndCapture;        ///< Camera triggering with hover and capture enabled
+        double                  triggerDistance;
+        double                  turnaroundDistance;
+    } TransectParams_t;
+
+    static QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
+    static void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
+    static void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
+    static void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
     bool _nextTransectCoord(const QList<QGeoCoordinate>& transectPoints, int pointIndex, QGeoCoordinate& coord);
     bool _appendMissionItemsWorker(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, bool hasRefly, bool buildRefly);
-    void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
-    qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
-    qreal _dp(QPointF pt1, QPointF pt2);
+    static void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
+    static qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
+    static qreal _dp(QPointF pt1, QPointF pt2);
     void _swapPoints(QList<QPointF>& points, int index1, int index2);
-    void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
-    void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
-    void _adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
+    static void _adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects);
     bool _gridAngleIsNorthSouthTransects();
-    double _clampGridAngle90(double gridAngle);
+    static double _clampGridAngle90(double gridAngle);
     bool _imagesEverywhere(void) const;
     bool _triggerCamera(void) const;
     bool _hasTurnaround(void) const;
@@ -119,16 +146,26 @@ private:
     bool _loadV3(const QJsonObject& complexObject, int sequenceNumber, QString& errorString);
     bool _loadV4V5(const QJsonObject& complexObject, int sequenceNumber, QString& errorString, int version, bool forPresets);
     void _saveWorker(QJsonObject& complexObject);
-    void _rebuildTransectsPhase1Worker(bool refly);
-    void _rebuildTransectsPhase1WorkerSinglePolygon(bool refly);
-    void _rebuildTransectsPhase1WorkerSplitPolygons(bool refly);
-    /// Adds to the _transects array from one polygon
-    void _rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint);
+    bool _rebuildTransectsPhase1InBackground(void) final;
+    TransectParams_t _transectParams(void) const;
+    void _clearLoadedMissionItems(void);
+    void _startTransectsBuild(void);
+    static bool _transectsBuildCancelled(const QAtomicInt* latestRequest, int request);
+    /// Builds the transects from the parameters alone so it can run on a worker thread
+    ///     @param latestRequest Build gives up when this no longer matches request, nullptr to never give up
+    static QList<QList<CoordInfo_t>> _buildTransects(const TransectParams_t& params, const QAtomicInt* latestRequest, int request);
+    static void _buildTransectsSinglePolygon(const TransectParams_t& params, bool refly, QList<QList<CoordInfo_t>>& coordInfoTransects);
+    static void _buildTransectsSplitPolygons(const TransectParams_t& params, bool refly, const QAtomicInt* latestRequest, int request, QList<QList<CoordInfo_t>>& coordInfoTransects);
+    /// Adds to the coordInfoTransects array from one polygon
+    static void _buildTransectsFromPolygon(const TransectParams_t& params, bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint, QList<QList<CoordInfo_t>>& coordInfoTransects);
     // Decompose polygon into list of convex sub polygons
-    void _PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons);
-    // return true if vertex a can see vertex b
-    bool _VertexCanSeeOther(const QPolygonF& polygon, const QPointF* vertexA, const QPointF* vertexB);
-    bool _VertexIsReflex(const QPolygonF& polygon, const QPointF* vertex);
+    static void _PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons);
+    /// Sub polygons already decomposed, keyed by their indices into the original points
+    typedef QHash<QVector<int>, QList<QVector<int>>> DecomposeCache_t;
+    static QList<QVector<int>> _decomposeConvexIndices(const std::vector<QPointF>& points, const QVector<int>& polygon, DecomposeCache_t& cache);
+    // return true if vertex a can see vertex b, vertices are positions within polygon which holds indices into points
+    static bool _VertexCanSeeOther(const std::vector<QPointF>& points, const QVector<int>& polygon, int vertexA, int vertexB);
+    static bool _VertexIsReflex(const std::vector<QPointF>& points, const QVector<int>& polygon, int vertex);
 
     QMap<QString, FactMetaData*> _metaDataMap;
 
@@ -137,6 +174,12 @@ private:
     SettingsFact    _splitConcavePolygonsFact;
     int             _entryPoint;
 
+    QFutureWatcher<QList<QList<CoordInfo_t>>>   _transectsWatcher;
+    QSharedPointer<QAtomicInt>                  _latestTransectsRequest;                ///< Shared with running builds so they can tell they have been superseded
+    int                                         _transectsRequest =             0;
+    int                                         _runningTransectsRequest =      0;
+    bool                                        _transectsRequestPending =      false;  ///< Settings changed while a build was running
+
     static const char* _jsonGridAngleKey;
     static const char* _jsonEntryPointKey;
     static const char* _jsonFlyAlternateTransectsKey;
@@ -11,6 +11,10 @@
 #include "QGCApplication.h"
 #include "JsonHelper.h"
 
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtMath>
+
 SurveyComplexItemTest::SurveyComplexItemTest(void)
 {
     // We use a 100m by 100m square test polygon
@@ -351,3 +355,75 @@ void SurveyComplexItemTest::_testHoverCaptureItemGeneration(void)
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, true /* useConditionGate */, expectedCommands);
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, false /* useConditionGate */, expectedCommands);
 }
+
+/// Writes a KML polygon with cLobes bulges around a circle, which makes every vertex between the lobes reflex
+void SurveyComplexItemTest::_writePolygonKML(const QString& kmlFile, int cVertices, int cLobes)
+{
+    QFile file(kmlFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+
+    QGeoCoordinate  center(47.633550640000003, -122.08982199);
+    QTextStream     stream(&file);
+    QString         firstCoordinate;
+
+    stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+              "<kml xmlns=\"http://www.opengis.net/kml/2.2\"><Document><Placemark><Polygon><outerBoundaryIs><LinearRing><coordinates>\n";
+    for (int i=0; i<cVertices; i++) {
+        double          azimuth     = (360.0 * i) / cVertices;
+        double          distance    = 500.0 + (150.0 * qSin(qDegreesToRadians(azimuth * cLobes)));
+        QGeoCoordinate  vertex      = center.atDistanceAndAzimuth(distance, azimuth);
+        QString         coordinate  = QStringLiteral("%1,%2,0 ").arg(vertex.longitude(), 0, 'f', 10).arg(vertex.latitude(), 0, 'f', 10);
+        if (i == 0) {
+            firstCoordinate = coordinate;
+        }
+        stream << coordinate;
+    }
+    // KML repeats the first vertex to close the ring
+    stream << firstCoordinate << "\n</coordinates></LinearRing></outerBoundaryIs></Polygon></Placemark></Document></kml>\n";
+}
+
+void SurveyComplexItemTest::_testLargePolygonBenchmark(void)
+{
+    typedef struct {
+        int     cVertices;
+        bool    splitConcavePolygons;
+    } TestCase_t;
+
+    // Large imported boundaries go through the line clipping, convex decomposition is only practical on smaller polygons
+    static const TestCase_t rgTestCases[] = {
+        { 600,  false },
+        { 20,   true },
+    };
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    for (const TestCase_t& testCase: rgTestCases) {
+        QString kmlFile = tempDir.filePath(QStringLiteral("Polygon%1.kml").arg(testCase.cVertices));
+        _writePolygonKML(kmlFile, testCase.cVertices, 5);
+
+        SurveyComplexItem* surveyItem = new SurveyComplexItem(_masterController, false /* flyView */, kmlFile, this /* parent */);
+        QCOMPARE(surveyItem->surveyAreaPolygon()->count(), testCase.cVertices);
+
+        surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(20);
+        surveyItem->splitConcavePolygons()->setRawValue(testCase.splitConcavePolygons);
+
+        double gridAngle = 0;
+        QBENCHMARK {
+            gridAngle += 17;
+            surveyItem->gridAngle()->setRawValue(gridAngle);
+        }
+        qDebug() << "vertices:splitConcave:transects" << testCase.cVertices << testCase.splitConcavePolygons << surveyItem->_transectCount();
+        QVERIFY(surveyItem->_transectCount() > 0);
+
+        // All transects must stay within the outer reach of the lobes
+        QGeoCoordinate center(47.633550640000003, -122.08982199);
+        for (const QVariant& point: surveyItem->visualTransectPoints()) {
+            QVERIFY(center.distanceTo(point.value<QGeoCoordinate>()) < 651.0);
+        }
+
+        // Split setting is persisted, don't leave it changed for the other tests
+        surveyItem->splitConcavePolygons()->setRawValue(false);
+        delete surveyItem;
+    }
+}
@@ -37,6 +37,7 @@ private slots:
     void _testItemGeneration(void);
     void _testItemCount(void);
     void _testHoverCaptureItemGeneration(void);
+    void _testLargePolygonBenchmark(void);
 #else
     // Handy mechanism to to a single test
 private slots:
@@ -47,12 +48,14 @@ private:
     void _testEntryLocation(void);
     void _testItemGeneration(void);
     void _testHoverCaptureItemGeneration(void);
+    void _testLargePolygonBenchmark(void);
 #endif
 
 private:
     double          _clampGridAngle180(double gridAngle);
     QList<MAV_CMD>  _createExpectedCommands(bool hasTurnaround, bool useConditionGate);
     void            _testItemGenerationWorker(bool imagesInTurnaround, bool hasTurnaround, bool useConditionGate, const QList<MAV_CMD>& expectedCommands);
+    void            _writePolygonKML(const QString& kmlFile, int cVertices, int cLobes);
 
     // SurveyComplexItem signals
 
@@ -22,6 +22,9 @@
 #include "MissionCommandUIInfo.h"
 
 #include <QPolygonF>
+#include <QtConcurrent>
+
+#include <vector>
 
 QGC_LOGGING_CATEGORY(TransectStyleComplexItemLog, "TransectStyleComplexItemLog")
 
@@ -66,14 +69,14 @@ TransectStyleComplexItem::TransectStyleComplexItem(PlanMasterController* masterC
     connect(&_hoverAndCaptureFact,                      &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
     connect(&_refly90DegreesFact,                       &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
     connect(this,                      &TransectStyleComplexItem::followTerrainChanged, this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_terrainAdjustMaxClimbRateFact,            &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_terrainAdjustMaxDescentRateFact,          &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_terrainAdjustToleranceFact,               &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
+    connect(&_terrainAdjustMaxClimbRateFact,            &Fact::valueChanged,            this, &TransectStyleComplexItem::_terrainAdjustmentChanged);
+    connect(&_terrainAdjustMaxDescentRateFact,          &Fact::valueChanged,            this, &TransectStyleComplexItem::_terrainAdjustmentChanged);
+    connect(&_terrainAdjustToleranceFact,               &Fact::valueChanged,            this, &TransectStyleComplexItem::_terrainAdjustmentChanged);
     connect(&_surveyAreaPolygon,                        &QGCMapPolygon::pathChanged,    this, &TransectStyleComplexItem::_rebuildTransects);
     connect(&_cameraTriggerInTurnAroundFact,            &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
     connect(_cameraCalc.adjustedFootprintSide(),        &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
     connect(_cameraCalc.adjustedFootprintFrontal(),     &Fact::valueChanged,            this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(_cameraCalc.distanceToSurface(),            &Fact::rawValueChanged,         this, &TransectStyleComplexItem::_rebuildTransects);
+    connect(_cameraCalc.distanceToSurface(),            &Fact::rawValueChanged,         this, &TransectStyleComplexItem::_terrainAdjustmentChanged);
 
     connect(&_turnAroundDistanceFact,                   &Fact::valueChanged,            this, &TransectStyleComplexItem::complexDistanceChanged);
     connect(&_hoverAndCaptureFact,                      &Fact::valueChanged,            this, &TransectStyleComplexItem::complexDistanceChanged);
@@ -394,12 +397,21 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         return;
     }
 
+    if (_rebuildTransectsPhase1InBackground()) {
+        // The current transects stay in place until the new ones are handed to _rebuildTransectsPhase2
+        return;
+    }
+
     _transects.clear();
+    _rebuildTransectsPhase1();
+    _rebuildTransectsPhase2();
+}
+
+void TransectStyleComplexItem::_rebuildTransectsPhase2(void)
+{
     _rgPathHeightInfo.clear();
     _rgFlightPathCoordInfo.clear();
 
-    _rebuildTransectsPhase1();
-
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
     if (_followTerrain) {
@@ -410,32 +422,61 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         _buildRawFlightPath();
     }
 
-    // Calc bounding cube
+    // Per transect work only depends on the transect itself, so large surveys spread it over the thread pool
+    if (_transects.count() >= _minParallelTransects) {
+        _transectStats = QtConcurrent::blockingMapped<QVector<TransectStats_t>>(_transects, &TransectStyleComplexItem::_calcTransectStats);
+    } else {
+        _transectStats.clear();
+        _transectStats.reserve(_transects.count());
+        for (const QList<CoordInfo_t>& transect: _transects) {
+            _transectStats.append(_calcTransectStats(transect));
+        }
+    }
+
+    // Calc bounding cube and distance from the transect stats
     double north = 0.0;
     double south = 180.0;
     double east  = 0.0;
     double west  = 360.0;
     double bottom = 100000.;
     double top = 0.;
+    int     cVisualPoints = 0;
+    double  complexDistance = 0;
+    const QGeoCoordinate* prevExitCoord = nullptr;
+    for (int i=0; i<_transects.count(); i++) {
+        const QList<CoordInfo_t>&   transect    = _transects[i];
+        const TransectStats_t&      stats       = _transectStats[i];
+        if (transect.isEmpty()) {
+            continue;
+        }
+        north   = fmax(north, stats.north);
+        south   = fmin(south, stats.south);
+        east    = fmax(east,  stats.east);
+        west    = fmin(west,  stats.west);
+        bottom  = fmin(bottom, stats.bottom);
+        top     = fmax(top, stats.top);
+
+        // Turn from the previous transect
+        if (prevExitCoord) {
+            complexDistance += prevExitCoord->distanceTo(transect.first().coord);
+        }
+        complexDistance += stats.distance;
+        prevExitCoord = &transect.last().coord;
+        cVisualPoints += transect.count();
+    }
+    //-- Update bounding cube for airspace management control
+    _setBoundingCube(QGCGeoBoundingCube(
+                         QGeoCoordinate(north - 90.0, west - 180.0, bottom),
+                         QGeoCoordinate(south - 90.0, east - 180.0, top)));
+
     // Generate the visuals transect representation
     _visualTransectPoints.clear();
+    _visualTransectPoints.reserve(cVisualPoints);
     for (const QList<CoordInfo_t>& transect: _transects) {
         for (const CoordInfo_t& coordInfo: transect) {
             _visualTransectPoints.append(QVariant::fromValue(coordInfo.coord));
-            double lat = coordInfo.coord.latitude()  + 90.0;
-            double lon = coordInfo.coord.longitude() + 180.0;
-            north   = fmax(north, lat);
-            south   = fmin(south, lat);
-            east    = fmax(east,  lon);
-            west    = fmin(west,  lon);
-            bottom  = fmin(bottom, coordInfo.coord.altitude());
-            top     = fmax(top, coordInfo.coord.altitude());
         }
     }
-    //-- Update bounding cube for airspace management control
-    _setBoundingCube(QGCGeoBoundingCube(
-                         QGeoCoordinate(north - 90.0, west - 180.0, bottom),
-                         QGeoCoordinate(south - 90.0, east - 180.0, top)));
     emit visualTransectPointsChanged();
 
     _coordinate = _visualTransectPoints.count() ? _visualTransectPoints.first().value<QGeoCoordinate>() : QGeoCoordinate();
@@ -448,7 +489,9 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         emit isIncompleteChanged();
     }
 
-    _recalcComplexDistance();
+    // Same as _recalcComplexDistance without going back through the visual points
+    _complexDistance = complexDistance;
+    emit complexDistanceChanged();
     _recalcCameraShots();
 
     emit lastSequenceNumberChanged(lastSequenceNumber());
@@ -540,33 +583,56 @@ void TransectStyleComplexItem::_queryTransectsPathHeightInfo(void)
     emit readyForSaveStateChanged();
 
     if (_transects.count()) {
+        if (!_queriedPathHeightInfo.isEmpty() && _transectPathCoords() == _queriedPathCoords) {
+            // Same path as the last terrain query, for example only the altitude changed. The heights from
+            // that query still apply so there is no need to go back to the terrain system.
+            _terrainQueryTimer.stop();
+            _cancelTerrainQuery();
+            _rgPathHeightInfo = _queriedPathHeightInfo;
+            _adjustTransectsForTerrain();
+            emit readyForSaveStateChanged();
+            return;
+        }
+
         // We don't actually send the query until this timer times out. This way we only send
         // the latest request if we get a bunch in a row.
         _terrainQueryTimer.start();
     }
 }
 
-void TransectStyleComplexItem::_reallyQueryTransectsPathHeightInfo(void)
+QList<QGeoCoordinate> TransectStyleComplexItem::_transectPathCoords(void) const
 {
-    // Clear any previous query
-    if (_currentTerrainFollowQuery) {
-        // We are already waiting on another query. We don't care about those results any more.
-        disconnect(_currentTerrainFollowQuery, &TerrainPolyPathQuery::terrainDataReceived, this, &TransectStyleComplexItem::_polyPathTerrainData);
-        _currentTerrainFollowQuery = nullptr;
-    }
-
-    // Append all transects into a single PolyPath query
+    // Append all transects into a single path
     QList<QGeoCoordinate> transectPoints;
     for (const QList<CoordInfo_t>& transect: _transects) {
         for (const CoordInfo_t& coordInfo: transect) {
             transectPoints.append(coordInfo.coord);
         }
     }
+    return transectPoints;
+}
+
+void TransectStyleComplexItem::_cancelTerrainQuery(void)
+{
+    if (_currentTerrainFollowQuery) {
+        // We are already waiting on another query. We don't care about those results any more.
+        disconnect(_currentTerrainFollowQuery, &TerrainPolyPathQuery::terrainDataReceived, this, &TransectStyleComplexItem::_polyPathTerrainData);
+        _currentTerrainFollowQuery = nullptr;
+    }
+}
 
-    if (transectPoints.count() > 1) {
+void TransectStyleComplexItem::_reallyQueryTransectsPathHeightInfo(void)
+{
+    // Clear any previous query
+    _cancelTerrainQuery();
+
+    // All transects go into a single PolyPath query
+    _pendingQueryPathCoords = _transectPathCoords();
+
+    if (_pendingQueryPathCoords.count() > 1) {
         _currentTerrainFollowQuery = new TerrainPolyPathQuery(true /* autoDelete */);
         connect(_currentTerrainFollowQuery, &TerrainPolyPathQuery::terrainDataReceived, this, &TransectStyleComplexItem::_polyPathTerrainData);
-        _currentTerrainFollowQuery->requestData(transectPoints);
+        _currentTerrainFollowQuery->requestData(_pendingQueryPathCoords);
     }
 }
 
@@ -577,7 +643,9 @@ void TransectStyleComplexItem::_polyPathTerrainData(bool success, const QList<Te
 
     if (success) {
         // Now that we have terrain data we can adjust
-        _rgPathHeightInfo = rgPathHeightInfo;
+        _rgPathHeightInfo       = rgPathHeightInfo;
+        _queriedPathHeightInfo  = rgPathHeightInfo;
+        _queriedPathCoords      = _pendingQueryPathCoords;
         _adjustTransectsForTerrain();
         emit readyForSaveStateChanged();
     }
@@ -621,8 +689,7 @@ void TransectStyleComplexItem::_adjustTransectsForTerrain(void)
         }
 
         _buildRawFlightPath();
-        _adjustForMaxRates();
-        _adjustForTolerance();
+        _adjustFlightPathAltitudes();
 
         emit lastSequenceNumberChanged(lastSequenceNumber());
         emit _updateFlightPathSegmentsSignal();
@@ -630,17 +697,26 @@ void TransectStyleComplexItem::_adjustTransectsForTerrain(void)
         _amslEntryAltChanged();
         _amslExitAltChanged();
 
-        _minAMSLAltitude = qQNaN();
-        _maxAMSLAltitude = qQNaN();
-        for (const CoordInfo_t& coordInfo: _rgFlightPathCoordInfo) {
-            _minAMSLAltitude = std::fmin(_minAMSLAltitude, coordInfo.coord.altitude());
-            _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, coordInfo.coord.altitude());
-        }
         emit minAMSLAltitudeChanged();
         emit maxAMSLAltitudeChanged();
     }
 }
 
+void TransectStyleComplexItem::_terrainAdjustmentChanged(void)
+{
+    if (_ignoreRecalc) {
+        return;
+    }
+
+    if (_followTerrain && _rgPathHeightInfo.count() && _loadedMissionItems.isEmpty()) {
+        // The transects don't depend on altitude or the terrain adjustment settings, so the terrain heights we already
+        // have still apply. Only the flight path needs to be rebuilt from them.
+        _adjustTransectsForTerrain();
+    } else {
+        _rebuildTransects();
+    }
+}
+
 /// Returns the altitude in between the two points on a line.
 ///     @param precentTowardsTo Example: .25 = twenty five percent along the distance of from to to
 double TransectStyleComplexItem::_altitudeBetweenCoords(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double percentTowardsTo)
@@ -680,94 +756,75 @@ int TransectStyleComplexItem::_maxPathHeight(const TerrainPathQuery::PathHeightI
     return maxIndex;
 }
 
-void TransectStyleComplexItem::_adjustForMaxRates(void)
+/// Applies the max climb/descent rates to the raw flight path and then drops the terrain added points which are within
+/// tolerance of the previous point. Works on a single array of altitudes, the coordinates are only copied once at the end.
+void TransectStyleComplexItem::_adjustFlightPathAltitudes(void)
 {
-    double maxClimbRate     = _terrainAdjustMaxClimbRateFact.rawValue().toDouble();
-    double maxDescentRate   = _terrainAdjustMaxDescentRateFact.rawValue().toDouble();
-    double flightSpeed      = _vehicleSpeed;
+    _minAMSLAltitude = qQNaN();
+    _maxAMSLAltitude = qQNaN();
 
-    if (qIsNaN(flightSpeed) || (maxClimbRate == 0 && maxDescentRate == 0)) {
-        if (qIsNaN(flightSpeed)) {
-            qWarning() << "TransectStyleComplexItem::_adjustForMaxRates called with flightSpeed = NaN";
-        }
-        return;
-    }
-    if (maxClimbRate <= 0 && maxDescentRate <= 0) {
+    int cCoords = _rgFlightPathCoordInfo.count();
+    if (cCoords == 0) {
         return;
     }
 
-    if (maxClimbRate > 0) {
-        bool climbRateAdjusted;
-        do {
-            //qDebug() << "climb rate pass";
-            climbRateAdjusted = false;
-            for (int i=0; i<_rgFlightPathCoordInfo.count() - 1; i++) {
-                QGeoCoordinate& fromCoord   = _rgFlightPathCoordInfo[i].coord;
-                QGeoCoordinate& toCoord     = _rgFlightPathCoordInfo[i+1].coord;
+    std::vector<double> altitudes(static_cast<size_t>(cCoords));
+    for (int i=0; i<cCoords; i++) {
+        altitudes[i] = _rgFlightPathCoordInfo[i].coord.altitude();
+    }
 
-                double altDifference    = toCoord.altitude() - fromCoord.altitude();
-                double distance         = fromCoord.distanceTo(toCoord);
-                double seconds          = distance / flightSpeed;
-                double climbRate        = altDifference / seconds;
+    double maxClimbRate     = _terrainAdjustMaxClimbRateFact.rawValue().toDouble();
+    double maxDescentRate   = _terrainAdjustMaxDescentRateFact.rawValue().toDouble();
+    double flightSpeed      = _vehicleSpeed;
 
-                //qDebug() << QString("Index:%1 altDifference:%2 distance:%3 seconds:%4 climbRate:%5").arg(i).arg(altDifference).arg(distance).arg(seconds).arg(climbRate);
+    if (qIsNaN(flightSpeed)) {
+        qWarning() << "TransectStyleComplexItem::_adjustFlightPathAltitudes called with flightSpeed = NaN";
+    } else if ((maxClimbRate > 0 || maxDescentRate > 0) && cCoords > 1) {
+        // Horizontal positions don't move, so the time to fly each segment only needs to be worked out once
+        std::vector<double> seconds(static_cast<size_t>(cCoords - 1));
+        for (int i=0; i<cCoords - 1; i++) {
+            seconds[i] = _rgFlightPathCoordInfo[i].coord.distanceTo(_rgFlightPathCoordInfo[i+1].coord) / flightSpeed;
+        }
 
+        if (maxClimbRate > 0) {
+            // Raising a point can only break the climb rate into it, so walking backwards each point is compared
+            // against one which is already final.
+            for (int i=cCoords - 2; i>=0; i--) {
+                double climbRate = (altitudes[i+1] - altitudes[i]) / seconds[i];
                 if (climbRate > 0 && climbRate - maxClimbRate > 0.1) {
-                    double maxAltitudeDelta = maxClimbRate * seconds;
-                    fromCoord.setAltitude(toCoord.altitude() - maxAltitudeDelta);
-                    //qDebug() << "Adjusting";
-                    climbRateAdjusted = true;
+                    altitudes[i] = altitudes[i+1] - (maxClimbRate * seconds[i]);
                 }
             }
-        } while (climbRateAdjusted);
-    }
+        }
 
-    if (maxDescentRate > 0) {
-        bool descentRateAdjusted;
-        maxDescentRate = -maxDescentRate;
-        do {
-            //qDebug() << "descent rate pass";
-            descentRateAdjusted = false;
-            for (int i=0; i<_rgFlightPathCoordInfo.count() - 1; i++) {
-                QGeoCoordinate& fromCoord   = _rgFlightPathCoordInfo[i-1].coord;
-                QGeoCoordinate& toCoord     = _rgFlightPathCoordInfo[i].coord;
-
-                double altDifference    = toCoord.altitude() - fromCoord.altitude();
-                double distance         = fromCoord.distanceTo(toCoord);
-                double seconds          = distance / flightSpeed;
-                double descentRate      = altDifference / seconds;
-
-                //qDebug() << QString("Index:%1 altDifference:%2 distance:%3 seconds:%4 descentRate:%5").arg(i).arg(altDifference).arg(distance).arg(seconds).arg(descentRate);
-
-                if (descentRate < 0 && descentRate - maxDescentRate < -0.1) {
-                    double maxAltitudeDelta = maxDescentRate * seconds;
-                    toCoord.setAltitude(fromCoord.altitude() + maxAltitudeDelta);
-                    //qDebug() << "Adjusting";
-                    descentRateAdjusted = true;
+        if (maxDescentRate > 0) {
+            // Lowering a point can only break the descent rate out of it, so walk forwards
+            for (int i=1; i<cCoords; i++) {
+                double descentRate = (altitudes[i] - altitudes[i-1]) / seconds[i-1];
+                if (descentRate < 0 && descentRate + maxDescentRate < -0.1) {
+                    altitudes[i] = altitudes[i-1] - (maxDescentRate * seconds[i-1]);
                 }
             }
-        } while (descentRateAdjusted);
+        }
     }
-}
 
-void TransectStyleComplexItem::_adjustForTolerance(void)
-{
+    // Walk forward until we fall out of tolerence. When we fall out of tolerance add that point.
+    // We always add non-interstitial points no matter what.
     QList<CoordInfo_t>  adjustedFlightPath;
     double              tolerance           = _terrainAdjustToleranceFact.rawValue().toDouble();
-    CoordInfo_t&        lastCoordInfo       = _rgFlightPathCoordInfo.first();
-
-    adjustedFlightPath.append(lastCoordInfo);
-
-    int coordIndex = 1;
-    while (coordIndex < _rgFlightPathCoordInfo.count()) {
-        // Walk forward until we fall out of tolerence. When we fall out of tolerance add that point.
-        // We always add non-interstitial points no matter what.
-        const CoordInfo_t& nextCoordInfo = _rgFlightPathCoordInfo[coordIndex];
-        if (nextCoordInfo.coordType != CoordTypeInteriorTerrainAdded || qAbs(lastCoordInfo.coord.altitude() - nextCoordInfo.coord.altitude()) > tolerance) {
-            adjustedFlightPath.append(nextCoordInfo);
-            lastCoordInfo = nextCoordInfo;
+    double              lastAltitude        = altitudes[0];
+
+    adjustedFlightPath.reserve(cCoords);
+    for (int i=0; i<cCoords; i++) {
+        const CoordInfo_t& coordInfo = _rgFlightPathCoordInfo[i];
+        if (i == 0 || coordInfo.coordType != CoordTypeInteriorTerrainAdded || qAbs(lastAltitude - altitudes[i]) > tolerance) {
+            adjustedFlightPath.append(coordInfo);
+            adjustedFlightPath.last().coord.setAltitude(altitudes[i]);
+            lastAltitude = altitudes[i];
+
+            _minAMSLAltitude = std::fmin(_minAMSLAltitude, lastAltitude);
+            _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, lastAltitude);
         }
-        coordIndex++;
     }
 
     _rgFlightPathCoordInfo = adjustedFlightPath;
@@ -784,6 +841,13 @@ bool TransectStyleComplexItem::_buildRawFlightPath(void)
     double distanceToSurface = _cameraCalc.distanceToSurface()->rawValue().toDouble();
 
     _rgFlightPathCoordInfo.clear();
+    if (!_followTerrain) {
+        int cCoords = 0;
+        for (const QList<CoordInfo_t>& transect: _transects) {
+            cCoords += transect.count();
+        }
+        _rgFlightPathCoordInfo.reserve(cCoords);
+    }
     int pathHeightIndex = 0;
     for (int transectIndex=0; transectIndex<_transects.count(); transectIndex++) {
         const QList<CoordInfo_t>& transect = _transects[transectIndex];
@@ -1134,16 +1198,47 @@ void TransectStyleComplexItem::_appendLoadedMissionItems(QList<MissionItem*>& it
     }
 }
 
-void TransectStyleComplexItem::addKMLVisuals(KMLPlanDomDocument& domDocument)
+void TransectStyleComplexItem::addKMLVisuals(KMLPlanWriter& planKML)
 {
     // We add the survey area polygon as a Placemark
+    planKML.addPolygon(QStringLiteral("Survey Area"), _surveyAreaPolygon.coordinateList());
+}
 
-    QDomElement placemarkElement = domDocument.addPlacemark(QStringLiteral("Survey Area"), true);
-    QDomElement polygonElement = _surveyAreaPolygon.kmlPolygonElement(domDocument);
+TransectStyleComplexItem::TransectStats_t TransectStyleComplexItem::_calcTransectStats(const QList<CoordInfo_t>& transect)
+{
+    TransectStats_t stats;
+
+    stats.distance                  = 0;
+    stats.entryExitDistance         = 0;
+    stats.innerEntryExitDistance    = 0;
+    stats.north                     = 0.0;
+    stats.south                     = 180.0;
+    stats.east                      = 0.0;
+    stats.west                      = 360.0;
+    stats.bottom                    = 100000.;
+    stats.top                       = 0.;
+
+    for (int i=0; i<transect.count(); i++) {
+        const QGeoCoordinate& coord = transect[i].coord;
+        double lat = coord.latitude()  + 90.0;
+        double lon = coord.longitude() + 180.0;
+        stats.north     = fmax(stats.north, lat);
+        stats.south     = fmin(stats.south, lat);
+        stats.east      = fmax(stats.east,  lon);
+        stats.west      = fmin(stats.west,  lon);
+        stats.bottom    = fmin(stats.bottom, coord.altitude());
+        stats.top       = fmax(stats.top, coord.altitude());
+        if (i != 0) {
+            stats.distance += transect[i-1].coord.distanceTo(coord);
+        }
+    }
+
+    if (transect.count() > 1) {
+        stats.entryExitDistance         = transect.first().coord.distanceTo(transect.last().coord);
+        stats.innerEntryExitDistance    = transect[1].coord.distanceTo(transect[transect.count() - 2].coord);
+    }
 
-    placemarkElement.appendChild(polygonElement);
-    domDocument.addTextElement(placemarkElement, "styleUrl", QStringLiteral("#%1").arg(domDocument.surveyPolygonStyleName));
-    domDocument.appendChildToRoot(placemarkElement);
+    return stats;
 }
 
 void TransectStyleComplexItem::_recalcComplexDistance(void)
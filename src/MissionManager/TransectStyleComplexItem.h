@@ -18,6 +18,8 @@
 #include "CameraCalc.h"
 #include "TerrainQuery.h"
 
+#include <QVector>
+
 Q_DECLARE_LOGGING_CATEGORY(TransectStyleComplexItemLog)
 
 class PlanMasterController;
@@ -81,7 +83,7 @@ public:
     int     lastSequenceNumber  (void) const final;
     QString mapVisualQML        (void) const override = 0;
     bool    load                (const QJsonObject& complexObject, int sequenceNumber, QString& errorString) override = 0;
-    void    addKMLVisuals       (KMLPlanDomDocument& domDocument) final;
+    void    addKMLVisuals       (KMLPlanWriter& planKML) final;
     double  complexDistance     (void) const final { return _complexDistance; }
     double  greatestDistanceTo  (const QGeoCoordinate &other) const final;
 
@@ -140,6 +142,10 @@ protected slots:
 
 protected:
     virtual void _rebuildTransectsPhase1    (void) = 0; ///< Rebuilds the _transects array
+    /// Allows a derived class to build the transects away from the GUI thread
+    ///     @return true: Transects are being built in the background, derived class sets _transects and calls _rebuildTransectsPhase2 once done
+    virtual bool _rebuildTransectsPhase1InBackground(void) { return false; }
+    void _rebuildTransectsPhase2            (void); ///< Builds the flight path and visuals from the _transects array
     virtual void _recalcCameraShots         (void) = 0;
 
     void    _save                           (QJsonObject& saveObject);
@@ -177,8 +183,22 @@ protected:
         CoordType       coordType;
     } CoordInfo_t;
 
+    /// Values worked out from a single transect, see _calcTransectStats
+    typedef struct {
+        double distance;                ///< Distance along all points of the transect
+        double entryExitDistance;       ///< Distance from first to last point
+        double innerEntryExitDistance;  ///< Distance from second to second to last point, skips turnarounds
+        double north;                   ///< Bounds are offset by +90 latitude/+180 longitude
+        double south;
+        double east;
+        double west;
+        double bottom;
+        double top;
+    } TransectStats_t;
+
     QVariantList                                _visualTransectPoints;  ///< Used to draw the flight path visuals on the screen
     QList<QList<CoordInfo_t>>                   _transects;
+    QVector<TransectStats_t>                    _transectStats;         ///< Stats for each of _transects, updated by _rebuildTransectsPhase2
     QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;      ///< Path height for each segment includes turn segments
     QList<CoordInfo_t>                          _rgFlightPathCoordInfo; ///< Fully calculated flight path (including terrain if needed)
 
@@ -222,6 +242,7 @@ private slots:
     void _handleHoverAndCaptureEnabled              (QVariant enabled);
     void _updateFlightPathSegmentsDontCallDirectly  (void);
     void _segmentTerrainCollisionChanged            (bool terrainCollision) final;
+    void _terrainAdjustmentChanged                  (void);
 
 private:
     typedef struct {
@@ -234,12 +255,20 @@ private:
     void    _queryTransectsPathHeightInfo   (void);
     void    _adjustTransectsForTerrain      (void);
     bool    _buildRawFlightPath             (void);
-    void    _adjustForMaxRates              (void);
-    void    _adjustForTolerance             (void);
+    void    _adjustFlightPathAltitudes      (void);
+    void    _cancelTerrainQuery             (void);
+    QList<QGeoCoordinate> _transectPathCoords(void) const;
     double  _altitudeBetweenCoords          (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double percentTowardsTo);
     int     _maxPathHeight                  (const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo, int fromIndex, int toIndex, double& maxHeight);
     BuildMissionItemsState_t _buildMissionItemsState(void) const;
 
+    static TransectStats_t _calcTransectStats(const QList<CoordInfo_t>& transect);
+
     TerrainPolyPathQuery*       _currentTerrainFollowQuery =            nullptr;
     QTimer                      _terrainQueryTimer;
+    QList<QGeoCoordinate>       _pendingQueryPathCoords;                        ///< Path sent to _currentTerrainFollowQuery
+    QList<QGeoCoordinate>       _queriedPathCoords;                             ///< Path of the last successful terrain query
+    QList<TerrainPathQuery::PathHeightInfo_t> _queriedPathHeightInfo;           ///< Heights from the last successful terrain query
+
+    static const int _minParallelTransects = 64;    ///< Below this the thread pool costs more than it saves
 };
@@ -246,6 +246,30 @@ void TransectStyleComplexItemTest::_testFollowTerrain(void)
     }
 }
 
+void TransectStyleComplexItemTest::_testFollowTerrainReuseHeights(void)
+{
+    _transectStyleItem->cameraCalc()->distanceToSurface()->setRawValue(50);
+    _transectStyleItem->cameraCalc()->adjustedFootprintFrontal()->setRawValue(0);
+    _transectStyleItem->setFollowTerrain(true);
+
+    QVERIFY(QTest::qWaitFor([&]() { return _transectStyleItem->readyForSaveState() == TransectStyleComplexItem::ReadyForSave; }, 2000));
+
+    // Altitude changes don't move the transects, the heights already in hand should be used without a new terrain query
+    _transectStyleItem->rebuildTransectsPhase1Called = false;
+    _transectStyleItem->cameraCalc()->distanceToSurface()->setRawValue(60);
+    QVERIFY(!_transectStyleItem->rebuildTransectsPhase1Called);
+    QCOMPARE(_transectStyleItem->readyForSaveState(), TransectStyleComplexItem::ReadyForSave);
+
+    QList<MissionItem*> rgItems;
+    _transectStyleItem->appendMissionItems(rgItems, this);
+
+    QList<double> expectedTerrainValues {507, 519, 522, 522 };
+    for (const MissionItem* missionItem : rgItems) {
+        QCOMPARE(missionItem->param7(), expectedTerrainValues.front());
+        expectedTerrainValues.pop_front();
+    }
+}
+
 TestTransectStyleItem::TestTransectStyleItem(PlanMasterController* masterController, QObject* parent)
     : TransectStyleComplexItem      (masterController, false /* flyView */, QStringLiteral("UnitTestTransect"), parent)
     , rebuildTransectsPhase1Called  (false)
@@ -36,6 +36,7 @@ private slots:
     //void _testAltMode           (void);
     void _testAltitudes         (void);
     //void _testFollowTerrain     (void);
+    //void _testFollowTerrainReuseHeights(void);
 
 private:
     void _testDirty             (void);
@@ -44,6 +45,7 @@ private:
     void _testAltMode           (void);
     //void _testAltitudes         (void);
     void _testFollowTerrain     (void);
+    void _testFollowTerrainReuseHeights(void);
     MultiSignalSpyV2*       _multiSpy =             nullptr;
     TestTransectStyleItem*  _transectStyleItem =    nullptr;
 };
@@ -486,11 +486,57 @@ Item {
                 }
             }
 
+            // Simple mission items other than the current one are drawn as markers by a single layer instead of one
+            // indicator each, presses which miss them go through to the map
+            PlanMapLayer {
+                id:                 missionItemMarkers
+                anchors.fill:       parent
+                missionController:  _missionController
+                center:             editorMap.center
+                zoomLevel:          editorMap.zoomLevel
+                bearing:            editorMap.bearing
+                showLines:          false
+                markerRadius:       Math.ceil((ScreenTools.defaultFontPixelHeight * ScreenTools.smallFontPointRatio) / 2) + 1
+                markerColor:        qgcPal.mapIndicator
+                interactive:        _editingLayer == _layerMission
+                opacity:            _editingLayer == _layerMission ? 1 : editorMap._nonInteractiveOpacity
+                z:                  QGroundControl.zOrderMapItems
+                onClicked:          _missionController.setCurrentPlanViewSeqNum(sequenceNumber, false)
+            }
+            Repeater {
+                model: missionItemMarkers.labels.length
+
+                QGCLabel {
+                    x:                      _label ? _label.x - (width / 2) : 0
+                    y:                      _label ? _label.y - (height / 2) : 0
+                    width:                  missionItemMarkers.markerRadius * 2
+                    height:                 width
+                    horizontalAlignment:    Text.AlignHCenter
+                    verticalAlignment:      Text.AlignVCenter
+                    fontSizeMode:           Text.Fit
+                    minimumPointSize:       ScreenTools.smallFontPointSize / 2
+                    font.pointSize:         ScreenTools.smallFontPointSize
+                    color:                  "white"
+                    text:                   _label ? _label.text : ""
+                    opacity:                missionItemMarkers.opacity
+                    z:                      QGroundControl.zOrderMapItems
+
+                    property var _label: missionItemMarkers.labels[index]
+                }
+            }
+
             // Add lines between waypoints
-            MissionLineView {
-                showSpecialVisual:  _missionController.isROIBeginCurrentItem
-                model:              _missionController.simpleFlightPathSegments
+            PlanMapLayer {
+                anchors.fill:       parent
+                missionController:  _missionController
+                center:             editorMap.center
+                zoomLevel:          editorMap.zoomLevel
+                bearing:            editorMap.bearing
+                showMarkers:        false
+                lineWidth:          3
+                lineColor:          QGroundControl.globalPalette.mapMissionTrajectory
                 opacity:            _editingLayer == _layerMission ? 1 : editorMap._nonInteractiveOpacity
+                z:                  QGroundControl.zOrderWaypointLines
             }
 
             // Direction arrows in waypoint lines
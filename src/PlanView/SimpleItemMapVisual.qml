@@ -63,8 +63,17 @@ Item {
         }
     }
 
+    // In Plan view the items other than the current one are drawn by a PlanMapLayer
+    function updateItemVisuals() {
+        if (!map.planView || _missionItem.isCurrentItem) {
+            showItemVisuals()
+        } else {
+            hideItemVisuals()
+        }
+    }
+
     Component.onCompleted: {
-        showItemVisuals()
+        updateItemVisuals()
         if (_missionItem.isCurrentItem && map.planView) {
             showDragArea()
         }
@@ -81,9 +90,11 @@ Item {
 
         onIsCurrentItemChanged: {
             if (_missionItem.isCurrentItem && map.planView) {
+                updateItemVisuals()
                 showDragArea()
             } else {
                 hideDragArea()
+                updateItemVisuals()
             }
         }
     }
@@ -409,7 +409,7 @@ Rectangle {
         selectExisting: true
 
         onAcceptedForLoad: {
-            _missionItem.surveyAreaPolygon.loadKMLOrSHPFile(file)
+            _missionItem.surveyAreaPolygon.loadKMLOrSHPFileInBackground(file)
             _missionItem.resetState = false
             //editorMap.mapFitFunctions.fitMapViewportTo_missionItems()
             close()
@@ -154,6 +154,16 @@ Rectangle {
                     Layout.fillWidth:   true
                 }
 
+                QGCLabel { text: qsTr("Terrain Clearance") }
+
+                QGCLabel {
+                    Layout.fillWidth:   true
+                    color:              missionItem.terrainCollision ? qgcPal.warningText : qgcPal.text
+                    text:               isNaN(missionItem.approachTerrainClearance) ?
+                                            "--" :
+                                            QGroundControl.unitsConversion.metersToAppSettingsVerticalDistanceUnits(missionItem.approachTerrainClearance).toFixed(0) + " " + QGroundControl.unitsConversion.appSettingsVerticalDistanceUnitsString
+                }
+
                 QGCButton {
                     text:               _setToVehicleLocationStr
                     visible:            globals.activeVehicle
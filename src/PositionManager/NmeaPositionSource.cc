@@ -0,0 +1,308 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "NmeaPositionSource.h"
+
+#include <QtMath>
+
+QGC_LOGGING_CATEGORY(NmeaPositionSourceLog, "NmeaPositionSourceLog")
+
+NmeaPositionSource::NmeaPositionSource(QObject* parent)
+    : QGeoPositionInfoSource(parent)
+{
+
+}
+
+void NmeaPositionSource::setDevice(QIODevice* device)
+{
+    if (_device) {
+        disconnect(_device, &QIODevice::readyRead, this, &NmeaPositionSource::_readyRead);
+    }
+    _device = device;
+    if (_running) {
+        startUpdates();
+    }
+}
+
+QGeoPositionInfo NmeaPositionSource::lastKnownPosition(bool /*fromSatellitePositioningMethodsOnly*/) const
+{
+    return _lastPosition;
+}
+
+void NmeaPositionSource::startUpdates(void)
+{
+    _running = true;
+    if (!_device) {
+        return;
+    }
+    if (!_device->isOpen() && !_device->open(QIODevice::ReadOnly)) {
+        qCWarning(NmeaPositionSourceLog) << "Unable to open NMEA device" << _device->errorString();
+        _error = AccessError;
+        emit QGeoPositionInfoSource::error(_error);
+        return;
+    }
+    _error = NoError;
+    connect(_device, &QIODevice::readyRead, this, &NmeaPositionSource::_readyRead, Qt::UniqueConnection);
+}
+
+void NmeaPositionSource::stopUpdates(void)
+{
+    _running = false;
+    if (_device) {
+        disconnect(_device, &QIODevice::readyRead, this, &NmeaPositionSource::_readyRead);
+    }
+}
+
+void NmeaPositionSource::requestUpdate(int /*timeout*/)
+{
+    if (_lastPosition.isValid()) {
+        emit positionUpdated(_lastPosition);
+    } else if (!_running) {
+        emit updateTimeout();
+    }
+}
+
+void NmeaPositionSource::_readyRead(void)
+{
+    char line[256];
+
+    while (_device && _device->canReadLine()) {
+        const qint64 length = _device->readLine(line, sizeof(line));
+        if (length <= 0) {
+            break;
+        }
+        // Points into the stack buffer, nothing is copied until a value is converted
+        parseSentence(QByteArray::fromRawData(line, static_cast<int>(length)));
+    }
+}
+
+bool NmeaPositionSource::_checksumValid(const QByteArray& sentence)
+{
+    const int star = sentence.lastIndexOf('*');
+    if (star < 1 || star + 2 >= sentence.length()) {
+        // Checksum is optional for NMEA 0183
+        return star < 0;
+    }
+
+    uint8_t checksum = 0;
+    for (int i = 1; i < star; i++) {
+        checksum ^= static_cast<uint8_t>(sentence[i]);
+    }
+    bool ok;
+    const uint expected = QByteArray::fromRawData(sentence.constData() + star + 1, 2).toUInt(&ok, 16);
+    return ok && expected == checksum;
+}
+
+double NmeaPositionSource::_parseLatLon(const QByteArray& value, const QByteArray& hemisphere)
+{
+    // ddmm.mmmm or dddmm.mmmm
+    bool ok;
+    const double raw = value.toDouble(&ok);
+    if (!ok || value.isEmpty() || hemisphere.isEmpty()) {
+        return qQNaN();
+    }
+    const double degrees = qFloor(raw / 100.0);
+    const double result  = degrees + ((raw - (degrees * 100.0)) / 60.0);
+    return (hemisphere[0] == 'S' || hemisphere[0] == 'W') ? -result : result;
+}
+
+void NmeaPositionSource::parseSentence(const QByteArray& rawSentence)
+{
+    int length = rawSentence.length();
+    while (length > 0 && (rawSentence[length - 1] == '\r' || rawSentence[length - 1] == '\n')) {
+        length--;
+    }
+    const QByteArray sentence = QByteArray::fromRawData(rawSentence.constData(), length);
+    if (sentence.length() < 7 || sentence[0] != '$' || !_checksumValid(sentence)) {
+        return;
+    }
+
+    // Split on commas without copying, the checksum is dropped from the last field
+    const int           end = sentence.lastIndexOf('*') > 0 ? sentence.lastIndexOf('*') : sentence.length();
+    QList<QByteArray>   fields;
+    int                 start = 1;
+    while (start <= end) {
+        int comma = sentence.indexOf(',', start);
+        if (comma < 0 || comma > end) {
+            comma = end;
+        }
+        fields.append(QByteArray::fromRawData(sentence.constData() + start, comma - start));
+        start = comma + 1;
+    }
+
+    // Any talker: GP, GN, GL, GA, ...
+    const QByteArray& type = fields[0];
+    if (type.length() != 5) {
+        return;
+    }
+    if (type.endsWith("GGA")) {
+        _parseGGA(fields);
+    } else if (type.endsWith("RMC")) {
+        _parseRMC(fields);
+    } else if (type.endsWith("VTG")) {
+        _parseVTG(fields);
+    } else if (type.endsWith("GST")) {
+        _parseGST(fields);
+    }
+}
+
+/// Moves on to a new epoch if the time given is a different one, sending the previous one if it never went out
+///     @return false: time field is empty so the sentence can't be placed in an epoch
+bool NmeaPositionSource::_startEpoch(const QByteArray& timeField)
+{
+    if (timeField.length() < 6) {
+        return false;
+    }
+    const int   hours   = timeField.left(2).toInt();
+    const int   minutes = timeField.mid(2, 2).toInt();
+    const double seconds = timeField.mid(4).toDouble();
+    QTime       time(hours, minutes, static_cast<int>(seconds), qRound((seconds - qFloor(seconds)) * 1000) % 1000);
+
+    if (time == _epochTime && _epochArrival.isValid()) {
+        return true;
+    }
+
+    if (!_epochSent && _epochHasPosition) {
+        // The receiver didn't send everything it did last time, send what we have
+        _finishEpoch();
+    }
+    _expectedSentences  = _epochSentences ? _epochSentences : _expectedSentences;
+    _epochTime          = time;
+    _epochArrival       = QDateTime::currentDateTimeUtc();
+    _epochInfo          = QGeoPositionInfo();
+    _epochHasPosition   = false;
+    _epochSent          = false;
+    _epochSentences     = 0;
+    return true;
+}
+
+void NmeaPositionSource::_finishEpoch(void)
+{
+    _epochSent = true;
+    _epochInfo.setTimestamp(_epochArrival);
+    _lastPosition = _epochInfo;
+    qCDebug(NmeaPositionSourceLog) << "Epoch" << _epochTime << _epochInfo.coordinate() << "sentences" << _epochSentences;
+    emit positionUpdated(_epochInfo);
+}
+
+void NmeaPositionSource::_parseGGA(const QList<QByteArray>& fields)
+{
+    // $xxGGA,time,lat,N,lon,E,quality,numSV,HDOP,alt,M,sep,M,diffAge,diffStation
+    if (fields.count() < 10 || !_startEpoch(fields[1])) {
+        return;
+    }
+    _epochSentences |= SentenceGGA;
+
+    if (fields[6].toInt() == 0) {
+        // No fix
+        return;
+    }
+    const double latitude  = _parseLatLon(fields[2], fields[3]);
+    const double longitude = _parseLatLon(fields[4], fields[5]);
+    if (qIsNaN(latitude) || qIsNaN(longitude)) {
+        return;
+    }
+
+    QGeoCoordinate coordinate(latitude, longitude);
+    bool ok;
+    const double altitude = fields[9].toDouble(&ok);
+    if (ok) {
+        coordinate.setAltitude(altitude);
+    }
+    _epochInfo.setCoordinate(coordinate);
+    _epochHasPosition = true;
+
+    if ((_epochSentences & _expectedSentences) == _expectedSentences && !_epochSent) {
+        _finishEpoch();
+    }
+}
+
+void NmeaPositionSource::_parseRMC(const QList<QByteArray>& fields)
+{
+    // $xxRMC,time,status,lat,N,lon,E,spd,cog,date,mv,mvEW,posMode
+    if (fields.count() < 10 || !_startEpoch(fields[1])) {
+        return;
+    }
+    _epochSentences |= SentenceRMC;
+
+    if (fields[2] != "A") {
+        return;
+    }
+
+    bool ok;
+    const double speed = fields[7].toDouble(&ok);
+    if (ok && !_epochInfo.hasAttribute(QGeoPositionInfo::GroundSpeed)) {
+        _epochInfo.setAttribute(QGeoPositionInfo::GroundSpeed, speed * _knotsToMetersPerSec);
+    }
+    const double course = fields[8].toDouble(&ok);
+    if (ok && !_epochInfo.hasAttribute(QGeoPositionInfo::Direction)) {
+        _epochInfo.setAttribute(QGeoPositionInfo::Direction, course);
+    }
+    if (!_epochHasPosition) {
+        // Receivers which don't send GGA
+        const double latitude  = _parseLatLon(fields[3], fields[4]);
+        const double longitude = _parseLatLon(fields[5], fields[6]);
+        if (!qIsNaN(latitude) && !qIsNaN(longitude)) {
+            _epochInfo.setCoordinate(QGeoCoordinate(latitude, longitude));
+            _epochHasPosition = true;
+        }
+    }
+
+    if (_epochHasPosition && (_epochSentences & _expectedSentences) == _expectedSentences && !_epochSent) {
+        _finishEpoch();
+    }
+}
+
+void NmeaPositionSource::_parseVTG(const QList<QByteArray>& fields)
+{
+    // $xxVTG,cogt,T,cogm,M,knots,N,kph,K,posMode
+    // VTG has no time, it belongs to the epoch in progress
+    if (fields.count() < 9 || !_epochArrival.isValid()) {
+        return;
+    }
+    _epochSentences |= SentenceVTG;
+
+    bool ok;
+    const double course = fields[1].toDouble(&ok);
+    if (ok) {
+        _epochInfo.setAttribute(QGeoPositionInfo::Direction, course);
+    }
+    const double speed = fields[7].toDouble(&ok);
+    if (ok) {
+        _epochInfo.setAttribute(QGeoPositionInfo::GroundSpeed, speed * _kmhToMetersPerSec);
+    }
+
+    if (_epochHasPosition && (_epochSentences & _expectedSentences) == _expectedSentences && !_epochSent) {
+        _finishEpoch();
+    }
+}
+
+void NmeaPositionSource::_parseGST(const QList<QByteArray>& fields)
+{
+    // $xxGST,time,rangeRms,stdMajor,stdMinor,orient,stdLat,stdLong,stdAlt
+    if (fields.count() < 9 || !_startEpoch(fields[1])) {
+        return;
+    }
+    _epochSentences |= SentenceGST;
+
+    bool latOk, lonOk, altOk;
+    const double stdLat  = fields[6].toDouble(&latOk);
+    const double stdLon  = fields[7].toDouble(&lonOk);
+    const double stdAlt  = fields[8].toDouble(&altOk);
+    if (latOk && lonOk) {
+        _epochInfo.setAttribute(QGeoPositionInfo::HorizontalAccuracy, qSqrt((stdLat * stdLat) + (stdLon * stdLon)));
+    }
+    if (altOk) {
+        _epochInfo.setAttribute(QGeoPositionInfo::VerticalAccuracy, stdAlt);
+    }
+
+    if (_epochHasPosition && (_epochSentences & _expectedSentences) == _expectedSentences && !_epochSent) {
+        _finishEpoch();
+    }
+}
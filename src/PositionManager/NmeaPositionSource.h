@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtPositioning/qgeopositioninfosource.h>
+#include <QDateTime>
+#include <QPointer>
+#include <QIODevice>
+#include <QTime>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(NmeaPositionSourceLog)
+
+/// Position source for an NMEA GNSS receiver on a serial port or UDP socket, used in place of QNmeaPositionInfoSource.
+///
+/// GGA, RMC, VTG and GST are parsed in place as each line arrives. Sentences which carry the same UTC time belong to
+/// one epoch and are merged into a single update. The update goes out as soon as the epoch has every sentence type the
+/// previous full epoch had, so a 10-20Hz RTK receiver costs one positionUpdated per fix with no added delay. The
+/// timestamp is the arrival time of the first sentence of the epoch, not the receiver time, so consumers can tell how
+/// old a fix is.
+class NmeaPositionSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+
+public:
+    NmeaPositionSource(QObject* parent = nullptr);
+
+    void setDevice(QIODevice* device);
+
+    QGeoPositionInfo lastKnownPosition(bool fromSatellitePositioningMethodsOnly = false) const override;
+
+    PositioningMethods  supportedPositioningMethods (void) const override { return SatellitePositioningMethods; }
+    int                 minimumUpdateInterval       (void) const override { return 0; }
+    Error               error                       (void) const override { return _error; }
+
+    /// Parses a single sentence, with or without the line ending. Exposed for the device-less use in unit tests.
+    void parseSentence(const QByteArray& sentence);
+
+public slots:
+    void startUpdates   (void) override;
+    void stopUpdates    (void) override;
+    void requestUpdate  (int timeout = 5000) override;
+
+private slots:
+    void _readyRead(void);
+
+private:
+    enum {
+        SentenceGGA = 1 << 0,
+        SentenceRMC = 1 << 1,
+        SentenceVTG = 1 << 2,
+        SentenceGST = 1 << 3,
+    };
+
+    bool    _startEpoch     (const QByteArray& timeField);
+    void    _finishEpoch    (void);
+    void    _parseGGA       (const QList<QByteArray>& fields);
+    void    _parseRMC       (const QList<QByteArray>& fields);
+    void    _parseVTG       (const QList<QByteArray>& fields);
+    void    _parseGST       (const QList<QByteArray>& fields);
+
+    static bool     _checksumValid  (const QByteArray& sentence);
+    static double   _parseLatLon    (const QByteArray& value, const QByteArray& hemisphere);
+
+    QPointer<QIODevice> _device;
+    bool                _running            = false;
+    Error               _error              = NoError;
+    QGeoPositionInfo    _lastPosition;
+
+    QTime               _epochTime;                         ///< Receiver UTC time of the epoch being collected
+    QDateTime           _epochArrival;                      ///< When its first sentence came in
+    QGeoPositionInfo    _epochInfo;
+    bool                _epochHasPosition   = false;
+    bool                _epochSent          = false;
+    int                 _epochSentences     = 0;            ///< Sentence types seen in this epoch
+    int                 _expectedSentences  = 0;            ///< Sentence types the previous complete epoch had
+
+    static constexpr double _knotsToMetersPerSec    = 0.514444;
+    static constexpr double _kmhToMetersPerSec      = 1.0 / 3.6;
+};
@@ -66,7 +66,7 @@ void QGCPositionManager::setNmeaSourceDevice(QIODevice* device)
         _nmeaSource = nullptr;
 
     }
-    _nmeaSource = new QNmeaPositionInfoSource(QNmeaPositionInfoSource::RealTimeMode, this);
+    _nmeaSource = new NmeaPositionSource(this);
     _nmeaSource->setDevice(device);
     setPositionSource(QGCPositionManager::NmeaGPS);
 }
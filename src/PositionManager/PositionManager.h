@@ -10,12 +10,12 @@
 #pragma once
 
 #include <QGeoPositionInfoSource>
-#include <QNmeaPositionInfoSource>
 
 #include <QVariant>
 
 #include "QGCToolbox.h"
 #include "SimulatedPosition.h"
+#include "NmeaPositionSource.h"
 
 class QGCPositionManager : public QGCTool {
     Q_OBJECT
@@ -63,7 +63,7 @@ private:
 
     QGeoPositionInfoSource*     _currentSource =        nullptr;
     QGeoPositionInfoSource*     _defaultSource =        nullptr;
-    QNmeaPositionInfoSource*    _nmeaSource =           nullptr;
+    NmeaPositionSource*         _nmeaSource =           nullptr;
     QGeoPositionInfoSource*     _simulatedSource =      nullptr;
     bool                        _usingPluginSource =    false;
 };
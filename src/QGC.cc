@@ -14,6 +14,7 @@
 #include <float.h>
 
 #include <QtGlobal>
+#include <QtEndian>
 
 namespace QGC
 {
@@ -132,8 +133,43 @@ static const quint32 crctab[] =
     0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
+namespace {
+
+/// Tables for the slice-by-8 CRC. Table 0 is crctab, each following table advances the CRC of its entry by one more
+/// zero byte.
+struct CRC32SliceTables {
+    CRC32SliceTables(void)
+    {
+        for (int i = 0; i < 256; i++) {
+            tables[0][i] = crctab[i];
+        }
+        for (int slice = 1; slice < 8; slice++) {
+            for (int i = 0; i < 256; i++) {
+                quint32 prev = tables[slice - 1][i];
+                tables[slice][i] = crctab[prev & 0xff] ^ (prev >> 8);
+            }
+        }
+    }
+
+    quint32 tables[8][256];
+};
+
+}
+
 quint32 crc32(const quint8 *src, unsigned len, unsigned state)
 {
+    static const CRC32SliceTables sliceTables;
+    const quint32 (&t)[8][256] = sliceTables.tables;
+
+    // Eight bytes per step, then the tail a byte at a time
+    while (len >= 8) {
+        quint32 one = state ^ qFromLittleEndian<quint32>(src);
+        quint32 two = qFromLittleEndian<quint32>(src + 4);
+        state = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^ t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+                t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^ t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+        src += 8;
+        len -= 8;
+    }
     for (unsigned i = 0; i < len; i++) {
         state = crctab[(state ^ src[i]) & 0xff] ^ (state >> 8);
     }
@@ -42,6 +42,8 @@
 
 #include "QGC.h"
 #include "QGCApplication.h"
+#include "QGCStartupBenchmark.h"
+#include "QGCSettingsWriteBack.h"
 #include "CmdLineOptParser.h"
 #include "UDPLink.h"
 #include "LinkManager.h"
@@ -50,6 +52,8 @@
 #include "QGCPalette.h"
 #include "QGCMapPalette.h"
 #include "QGCLoggingCategory.h"
+#include "QGCInstrumentation.h"
+#include "FactGroupScheduler.h"
 #include "ParameterEditorController.h"
 #include "ESP8266ComponentController.h"
 #include "ScreenToolsController.h"
@@ -76,6 +80,7 @@
 #if defined(QGC_ENABLE_MAVLINK_INSPECTOR)
 #include "MAVLinkInspectorController.h"
 #endif
+#include "PerformanceController.h"
 #include "HorizontalFactValueGrid.h"
 #include "InstrumentValueData.h"
 #include "AppMessages.h"
@@ -85,6 +90,7 @@
 #include "MissionCommandTree.h"
 #include "QGCMapPolygon.h"
 #include "QGCMapCircle.h"
+#include "ADSBTrafficMapItem.h"
 #include "ParameterManager.h"
 #include "SettingsManager.h"
 #include "QGCCorePlugin.h"
@@ -101,9 +107,15 @@
 #include "LogReplayLink.h"
 #include "VehicleObjectAvoidance.h"
 #include "TrajectoryPoints.h"
+#include "TrajectoryMapItem.h"
+#include "CameraTriggerPoints.h"
+#include "CameraTriggerMapItem.h"
+#include "PlanMapLayer.h"
 #include "RCToParamDialogController.h"
 #include "QGCImageProvider.h"
 #include "TerrainProfile.h"
+#include "SensorStreamChart.h"
+#include "ObstacleOverlay.h"
 #include "ToolStripAction.h"
 #include "ToolStripActionList.h"
 #include "QGCMAVLink.h"
@@ -138,6 +150,8 @@
 
 #include "QGCMapEngine.h"
 
+QGC_LOGGING_CATEGORY(LowPowerModeLog, "LowPowerModeLog")
+
 class FinishVideoInitialization : public QRunnable
 {
 public:
@@ -243,6 +257,12 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     bool fClearCache = false;           // Clear parameter/airframe caches
     bool logging = false;               // Turn on logging
     QString loggingOptions;
+    bool perfDump = false;              // Periodically write instruments to a file
+    QString perfDumpFile;
+    bool telemetryFrame = false;        // Override the FactGroup update frame interval
+    QString telemetryFrameMSecs;
+    bool startupBenchmark = false;      // Time startup against a MockLink vehicle, write the results and quit
+    QString startupBenchmarkFile;
 
     CmdLineOpt_t rgCmdLineOptions[] = {
         { "--clear-settings",   &fClearSettingsOptions, nullptr },
@@ -250,11 +270,18 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
         { "--logging",          &logging,               &loggingOptions },
         { "--fake-mobile",      &_fakeMobile,           nullptr },
         { "--log-output",       &_logOutput,            nullptr },
+        { "--perf-dump",        &perfDump,              &perfDumpFile },
+        { "--telemetry-frame",  &telemetryFrame,        &telemetryFrameMSecs },
+        { "--startup-benchmark",&startupBenchmark,      &startupBenchmarkFile },
         // Add additional command line option flags here
     };
 
     ParseCmdLineOptions(argc, argv, rgCmdLineOptions, sizeof(rgCmdLineOptions)/sizeof(rgCmdLineOptions[0]), false);
 
+    if (startupBenchmark && !startupBenchmarkFile.isEmpty() && !_runningUnitTests) {
+        _startupBenchmark = new QGCStartupBenchmark(startupBenchmarkFile, this);
+    }
+
     // Set up timer for delayed missing fact display
     _missingParamsDelayedDisplayTimer.setSingleShot(true);
     _missingParamsDelayedDisplayTimer.setInterval(_missingParamsDelayedDisplayTimerTimeout);
@@ -331,6 +358,13 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     // Set up our logging filters
     QGCLoggingCategoryRegister::instance()->setFilterRulesFromSettings(loggingOptions);
 
+    if (perfDump && !perfDumpFile.isEmpty()) {
+        QGCInstrumentRegister::instance()->startDump(perfDumpFile);
+    }
+    if (telemetryFrame && telemetryFrameMSecs.toInt() > 0) {
+        FactGroupScheduler::instance()->setFrameMSecs(telemetryFrameMSecs.toInt());
+    }
+
     // Initialize Bluetooth
 #ifdef QGC_ENABLE_BLUETOOTH
     QBluetoothLocalDevice localDevice;
@@ -356,8 +390,10 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     // We need to set language as early as possible prior to loading on JSON files.
     setLanguage();
 
+    qCDebug(StartupLog) << "Toolbox start" << _msecsElapsedTime.elapsed() << "ms";
     _toolbox = new QGCToolbox(this);
     _toolbox->setChildToolboxes();
+    _startupMilestone(QGCStartupBenchmark::toolboxReadyMilestone);
 
 #ifndef __mobile__
     _gpsRtkFactGroup = new GPSRTKFactGroup(this);
@@ -494,10 +530,23 @@ void QGCApplication::setLanguage()
 
 void QGCApplication::_shutdown()
 {
+    // Flush the last interval of instrument data before the links and vehicles it describes go away
+    QGCInstrumentRegister::instance()->stopDump();
+
+    // Window state changes on the way down must not reach into the tools
+    disconnect(this, &QGuiApplication::applicationStateChanged, this, &QGCApplication::_updateLowPowerMode);
+    QQuickWindow* rootWindow = qobject_cast<QQuickWindow*>(_rootQmlObject());
+    if (rootWindow) {
+        disconnect(rootWindow, &QWindow::visibilityChanged, this, &QGCApplication::_updateLowPowerMode);
+    }
+
     // Close out all Qml before we delete toolbox. This way we don't get all sorts of null reference complaints from Qml.
     delete _qmlAppEngine;
     delete _toolbox;
     delete _gpsRtkFactGroup;
+
+    // Tools may have saved settings on the way down
+    QGCSettingsWriteBack::instance()->flush();
 }
 
 QGCApplication::~QGCApplication()
@@ -514,7 +563,10 @@ void QGCApplication::_initCommon()
     static const char* kQGCVehicle      = "QGroundControl.Vehicle";
     static const char* kQGCTemplates    = "QGroundControl.Templates";
 
-    QSettings settings;
+    QSettings       settings;
+    QElapsedTimer   timer;
+
+    timer.start();
 
     // Register our Qml objects
 
@@ -561,11 +613,16 @@ void QGCApplication::_initCommon()
     qmlRegisterUncreatableType<QGCMapPolygon>       ("QGroundControl.FlightMap",            1, 0, "QGCMapPolygon",              kRefOnly);
     qmlRegisterUncreatableType<QGCGeoBoundingCube>  ("QGroundControl.FlightMap",            1, 0, "QGCGeoBoundingCube",         kRefOnly);
     qmlRegisterUncreatableType<TrajectoryPoints>    ("QGroundControl.FlightMap",            1, 0, "TrajectoryPoints",           kRefOnly);
+    qmlRegisterUncreatableType<CameraTriggerPoints> ("QGroundControl.FlightMap",            1, 0, "CameraTriggerPoints",        kRefOnly);
 
     qmlRegisterUncreatableType<FactValueGrid>       (kQGCTemplates,                         1, 0, "FactValueGrid",              kRefOnly);
     qmlRegisterType<HorizontalFactValueGrid>        (kQGCTemplates,                         1, 0, "HorizontalFactValueGrid");
 
     qmlRegisterType<QGCMapCircle>                   ("QGroundControl.FlightMap",            1, 0, "QGCMapCircle");
+    qmlRegisterType<ADSBTrafficMapItem>             ("QGroundControl.FlightMap",            1, 0, "ADSBTrafficMapItem");
+    qmlRegisterType<TrajectoryMapItem>              ("QGroundControl.FlightMap",            1, 0, "TrajectoryMapItem");
+    qmlRegisterType<CameraTriggerMapItem>           ("QGroundControl.FlightMap",            1, 0, "CameraTriggerMapItem");
+    qmlRegisterType<PlanMapLayer>                   ("QGroundControl.FlightMap",            1, 0, "PlanMapLayer");
 
     qmlRegisterType<ParameterEditorController>      (kQGCControllers,                       1, 0, "ParameterEditorController");
     qmlRegisterType<ESP8266ComponentController>     (kQGCControllers,                       1, 0, "ESP8266ComponentController");
@@ -580,6 +637,8 @@ void QGCApplication::_initCommon()
     qmlRegisterType<RCToParamDialogController>      (kQGCControllers,                       1, 0, "RCToParamDialogController");
 
     qmlRegisterType<TerrainProfile>                 ("QGroundControl.Controls",             1, 0, "TerrainProfile");
+    qmlRegisterType<SensorStreamChart>              ("QGroundControl.Controls",             1, 0, "SensorStreamChart");
+    qmlRegisterType<ObstacleOverlay>                ("QGroundControl.Controls",             1, 0, "ObstacleOverlay");
     qmlRegisterType<ToolStripAction>                ("QGroundControl.Controls",             1, 0, "ToolStripAction");
     qmlRegisterType<ToolStripActionList>            ("QGroundControl.Controls",             1, 0, "ToolStripActionList");
 
@@ -593,6 +652,7 @@ void QGCApplication::_initCommon()
 #if defined(QGC_ENABLE_MAVLINK_INSPECTOR)
     qmlRegisterType<MAVLinkInspectorController>     (kQGCControllers,                       1, 0, "MAVLinkInspectorController");
 #endif
+    qmlRegisterType<PerformanceController>          (kQGCControllers,                       1, 0, "PerformanceController");
 
     // Register Qml Singletons
     qmlRegisterSingletonType<QGroundControlQmlGlobal>   ("QGroundControl",                          1, 0, "QGroundControl",         qgroundcontrolQmlGlobalSingletonFactory);
@@ -600,6 +660,9 @@ void QGCApplication::_initCommon()
     qmlRegisterSingletonType<ShapeFileHelper>           ("QGroundControl.ShapeFileHelper",          1, 0, "ShapeFileHelper",        shapeFileHelperSingletonFactory);
     qmlRegisterSingletonType<ShapeFileHelper>           ("MAVLink",                                 1, 0, "MAVLink",                mavlinkSingletonFactory);
 
+    qCDebug(StartupLog) << "Qml type registration" << timer.elapsed() << "ms";
+    _startupMilestone(QGCStartupBenchmark::qmlTypesRegisteredMilestone);
+
     // Although this should really be in _initForNormalAppBoot putting it here allowws us to create unit tests which pop up more easily
     if(QFontDatabase::addApplicationFont(":/fonts/opensans") < 0) {
         qWarning() << "Could not load /fonts/opensans font";
@@ -615,6 +678,7 @@ bool QGCApplication::_initForNormalAppBoot()
 
     _qmlAppEngine = toolbox()->corePlugin()->createQmlApplicationEngine(this);
     toolbox()->corePlugin()->createRootWindow(_qmlAppEngine);
+    _startupMilestone(QGCStartupBenchmark::qmlEngineLoadedMilestone);
 
     // Image provider for PX4 Flow
     QQuickImageProvider* pImgProvider = dynamic_cast<QQuickImageProvider*>(qgcApp()->toolbox()->imageProvider());
@@ -625,8 +689,18 @@ bool QGCApplication::_initForNormalAppBoot()
     if (rootWindow) {
         rootWindow->scheduleRenderJob (new FinishVideoInitialization (toolbox()->videoManager()),
                 QQuickWindow::BeforeSynchronizingStage);
+        // Tools the fly view doesn't need are held back until the first frame is on screen
+        connect(rootWindow, &QQuickWindow::frameSwapped, this, &QGCApplication::_firstFrameSwapped, Qt::QueuedConnection);
+        // Low power mode follows the main window and application state
+        connect(rootWindow, &QWindow::visibilityChanged, this, &QGCApplication::_updateLowPowerMode);
+        rootWindow->installEventFilter(this);
+    } else {
+        QTimer::singleShot(0, this, &QGCApplication::_firstFrameSwapped);
     }
 
+    connect(this, &QGuiApplication::applicationStateChanged, this, &QGCApplication::_updateLowPowerMode);
+    connect(toolbox()->settingsManager()->appSettings()->lowPowerWhenHidden(), &Fact::rawValueChanged, this, &QGCApplication::_updateLowPowerMode);
+
     // Safe to show popup error messages now that main window is created
     UASMessageHandler* msgHandler = qgcApp()->toolbox()->uasMessageHandler();
     if (msgHandler) {
@@ -660,6 +734,60 @@ bool QGCApplication::_initForNormalAppBoot()
     return true;
 }
 
+void QGCApplication::_firstFrameSwapped(void)
+{
+    QQuickWindow* rootWindow = qobject_cast<QQuickWindow*>(_rootQmlObject());
+    if (rootWindow) {
+        disconnect(rootWindow, &QQuickWindow::frameSwapped, this, &QGCApplication::_firstFrameSwapped);
+    }
+    // Further frames may have been queued before the disconnect, createDeferredTools only runs once
+    _startupMilestone(QGCStartupBenchmark::firstFrameMilestone);
+    _toolbox->createDeferredTools();
+    if (_startupBenchmark) {
+        _startupBenchmark->start();
+    }
+}
+
+void QGCApplication::_updateLowPowerMode(void)
+{
+    QQuickWindow*   rootWindow  = qobject_cast<QQuickWindow*>(_rootQmlObject());
+    bool            hidden      = applicationState() == Qt::ApplicationHidden || applicationState() == Qt::ApplicationSuspended;
+    if (rootWindow && (rootWindow->visibility() == QWindow::Minimized || rootWindow->visibility() == QWindow::Hidden)) {
+        hidden = true;
+    }
+    bool lowPowerMode = hidden && _toolbox->settingsManager()->appSettings()->lowPowerWhenHidden()->rawValue().toBool();
+    if (lowPowerMode == _lowPowerMode) {
+        return;
+    }
+
+    qCDebug(LowPowerModeLog) << "Low power mode" << lowPowerMode << "application state" << applicationState();
+    _lowPowerMode = lowPowerMode;
+    // Only the display side is slowed down, rawValueChanged still goes out for every value
+    FactGroupScheduler::instance()->setMinUpdateMSecs(_lowPowerMode ? _lowPowerFactGroupMSecs : 0);
+    if (!_lowPowerMode && rootWindow) {
+        // Frames asked for while paused were dropped
+        rootWindow->update();
+    }
+    emit lowPowerModeChanged(_lowPowerMode);
+}
+
+bool QGCApplication::eventFilter(QObject* watched, QEvent* event)
+{
+    // Dropping the frame requests of the main window stops its render loop, along with the animations it drives
+    if (_lowPowerMode && event->type() == QEvent::UpdateRequest) {
+        return true;
+    }
+    return QApplication::eventFilter(watched, event);
+}
+
+void QGCApplication::_startupMilestone(const char* milestone)
+{
+    qCDebug(StartupLog) << milestone << _msecsElapsedTime.elapsed() << "ms";
+    if (_startupBenchmark) {
+        _startupBenchmark->mark(milestone);
+    }
+}
+
 bool QGCApplication::_initForUnitTests()
 {
     return true;
@@ -938,17 +1066,12 @@ void QGCApplication::_onGPSConnect()
 void QGCApplication::_onGPSDisconnect()
 {
     _gpsRtkFactGroup->connected()->setRawValue(false);
+    _gpsRtkFactGroup->clearAccuracyHistory();
 }
 
-void QGCApplication::_gpsSurveyInStatus(float duration, float accuracyMM,  double latitude, double longitude, float altitude, bool valid, bool active)
+void QGCApplication::_gpsSurveyInStatus(GPSSurveyInStatusMessage status)
 {
-    _gpsRtkFactGroup->currentDuration()->setRawValue(duration);
-    _gpsRtkFactGroup->currentAccuracy()->setRawValue(static_cast<double>(accuracyMM) / 1000.0);
-    _gpsRtkFactGroup->currentLatitude()->setRawValue(latitude);
-    _gpsRtkFactGroup->currentLongitude()->setRawValue(longitude);
-    _gpsRtkFactGroup->currentAltitude()->setRawValue(altitude);
-    _gpsRtkFactGroup->valid()->setRawValue(valid);
-    _gpsRtkFactGroup->active()->setRawValue(active);
+    _gpsRtkFactGroup->setSurveyInStatus(status);
 }
 
 void QGCApplication::_gpsNumSatellites(int numSatellites)
@@ -994,8 +1117,9 @@ void QGCApplication::CompressedSignalList::add(const QMetaMethod & method)
     const QMetaObject*  metaObject  = method.enclosingMetaObject();
     int                 signalIndex = _signalIndex(method);
 
-    if (signalIndex != -1 && !contains(metaObject, signalIndex)) {
-        _signalMap[method.enclosingMetaObject()].insert(signalIndex);
+    if (signalIndex != -1) {
+        QMutexLocker lock(&_mutex);
+        _signalMap[metaObject].insert(signalIndex);
     }
 }
 
@@ -1004,6 +1128,7 @@ void QGCApplication::CompressedSignalList::remove(const QMetaMethod & method)
     int                 signalIndex = _signalIndex(method);
     const QMetaObject*  metaObject  = method.enclosingMetaObject();
 
+    QMutexLocker lock(&_mutex);
     if (signalIndex != -1 && _signalMap.contains(metaObject) && _signalMap[metaObject].contains(signalIndex)) {
         _signalMap[metaObject].remove(signalIndex);
         if (_signalMap[metaObject].count() == 0) {
@@ -1014,7 +1139,79 @@ void QGCApplication::CompressedSignalList::remove(const QMetaMethod & method)
 
 bool QGCApplication::CompressedSignalList::contains(const QMetaObject* metaObject, int signalIndex)
 {
-    return _signalMap.contains(metaObject) && _signalMap[metaObject].contains(signalIndex);
+    QMutexLocker lock(&_mutex);
+
+    // Signal indices are absolute, so an inherited signal has the same index in the subclass
+    for (; metaObject; metaObject = metaObject->superClass()) {
+        auto iter = _signalMap.constFind(metaObject);
+        if (iter != _signalMap.constEnd() && iter->contains(signalIndex)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void QGCApplication::CompressedCallTable::posted(QMetaCallEvent* event, QObject* receiver)
+{
+    Key_t           key = _key(event, receiver);
+    QMutexLocker    lock(&_mutex);
+
+    auto iter = _newest.find(key);
+    if (iter != _newest.end() && iter->receiver) {
+        _superseded.insert(iter->event, { key, iter->receiver });
+    }
+    // A null receiver means the entry is left over from an object which was deleted where this receiver now lives
+    _newest.insert(key, { event, receiver });
+
+    if (_newest.count() + _superseded.count() > _purgeCount) {
+        _purgeDeadReceivers();
+    }
+    _updateCount();
+}
+
+bool QGCApplication::CompressedCallTable::delivering(QMetaCallEvent* event, QObject* receiver)
+{
+    Key_t           key = _key(event, receiver);
+    QMutexLocker    lock(&_mutex);
+    bool            drop = false;
+
+    auto supersededIter = _superseded.find(event);
+    if (supersededIter != _superseded.end()) {
+        // Key and receiver make sure this isn't a new event which was allocated where a deleted one used to be
+        drop = supersededIter->key == key && supersededIter->receiver.data() == receiver;
+        _superseded.erase(supersededIter);
+    }
+    if (!drop) {
+        auto newestIter = _newest.find(key);
+        if (newestIter != _newest.end() && newestIter->event == event) {
+            _newest.erase(newestIter);
+        }
+    }
+
+    _updateCount();
+    return drop;
+}
+
+/// Queued events are deleted along with their receiver, which leaves their entries behind
+void QGCApplication::CompressedCallTable::_purgeDeadReceivers(void)
+{
+    for (auto iter = _superseded.begin(); iter != _superseded.end(); ) {
+        if (iter->receiver) {
+            ++iter;
+        } else {
+            iter = _superseded.erase(iter);
+        }
+    }
+    for (auto iter = _newest.begin(); iter != _newest.end(); ) {
+        if (iter->receiver) {
+            ++iter;
+        } else {
+            iter = _newest.erase(iter);
+        }
+    }
+
+    // Doubling keeps the cost of the walk constant per posted call when most entries are live
+    _purgeCount = qMax(static_cast<int>(_purgeThreshold), (_newest.count() + _superseded.count()) * 2);
 }
 
 void QGCApplication::addCompressedSignal(const QMetaMethod & method)
@@ -1038,30 +1235,17 @@ bool QGCApplication::compressEvent(QEvent*event, QObject* receiver, QPostEventLi
         return QApplication::compressEvent(event, receiver, postedEvents);
     }
 
-    for (QPostEventList::iterator it = postedEvents->begin(); it != postedEvents->end(); ++it) {
-        QPostEvent &cur = *it;
-        if (cur.receiver != receiver || cur.event == 0 || cur.event->type() != event->type()) {
-            continue;
-        }
-        QMetaCallEvent *cur_mce = static_cast<QMetaCallEvent*>(cur.event);
-        if (cur_mce->sender() != mce->sender() || cur_mce->signalId() != mce->signalId() || cur_mce->id() != mce->id()) {
-            continue;
+    // The new call is queued as usual. Older calls for the same slot are dropped when they come up for delivery.
+    _compressedCalls.posted(mce, receiver);
+    return false;
+}
+
+bool QGCApplication::notify(QObject* receiver, QEvent* event)
+{
+    if (event->type() == QEvent::MetaCall && !_compressedCalls.empty()) {
+        if (_compressedCalls.delivering(static_cast<QMetaCallEvent*>(event), receiver)) {
+            return true;
         }
-        /* Keep The Newest Call */
-        // We can't merely qSwap the existing posted event with the new one, since QEvent
-        // keeps track of whether it has been posted. Deletion of a formerly posted event
-        // takes the posted event list mutex and does a useless search of the posted event
-        // list upon deletion. We thus clear the QEvent::posted flag before deletion.
-        struct EventHelper : private QEvent {
-            static void clearPostedFlag(QEvent * ev) {
-                (&static_cast<EventHelper*>(ev)->t)[1] &= ~0x8001; // Hack to clear QEvent::posted
-            }
-        };
-        EventHelper::clearPostedFlag(cur.event);
-        delete cur.event;
-        cur.event = event;
-        return true;
     }
-
-    return false;
+    return QApplication::notify(receiver, event);
 }
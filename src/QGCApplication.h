@@ -14,6 +14,10 @@
 #include <QElapsedTimer>
 #include <QMap>
 #include <QSet>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QAtomicInt>
 #include <QMetaMethod>
 #include <QMetaObject>
 
@@ -39,6 +43,7 @@
 // Work around circular header includes
 class QQmlApplicationEngine;
 class QGCSingleton;
+class QGCStartupBenchmark;
 class QGCToolbox;
 
 /**
@@ -102,8 +107,26 @@ public:
     QQuickItem*     mainRootWindow();
     uint64_t        msecsSinceBoot(void) { return _msecsElapsedTime.elapsed(); }
 
-    /// Registers the signal such that only the last duplicate signal added is left in the queue.
+    /// Low power mode is on while the main window is minimized or hidden, or the application is hidden or suspended.
+    /// Rendering is paused and display updates are slowed down. Vehicle links, alerts and logging are not affected.
+    bool            lowPowerMode(void) const { return _lowPowerMode; }
+
+    /// Signal compression
+    ///
+    /// For a compressed signal, a queued connection only delivers the newest of the calls still waiting in the event
+    /// queue of the receiver. The older calls are dropped when their turn comes. Use it for signals where the receiver
+    /// only needs the latest state, such as a recalc request fired on each change or telemetry crossing over from a
+    /// link thread. Registration covers the signal on the class which declares it and on all its subclasses. Direct
+    /// connections are not affected.
+    ///
+    /// Qt doesn't offer the first call posted to a receiver with an empty queue for compression. So after an idle
+    /// period, the first call can be delivered as well as the newest one.
+    ///
+    /// Posting and delivery are O(1). Pending calls are tracked in a side table keyed by receiver, sender, signal and
+    /// slot. It is the posted event list which isn't searched.
     void addCompressedSignal(const QMetaMethod & method);
+    template<typename Func>
+    void addCompressedSignal(Func signal) { addCompressedSignal(QMetaMethod::fromSignal(signal)); }
 
     void removeCompressedSignal(const QMetaMethod & method);
 
@@ -139,6 +162,7 @@ signals:
     void checkForLostLogFiles   ();
 
     void languageChanged        (const QLocale locale);
+    void lowPowerModeChanged    (bool lowPowerMode);
 
 public:
     // Although public, these methods are internal and should only be called by UnitTest code
@@ -173,17 +197,22 @@ private slots:
     bool _parseVersionText                          (const QString& versionString, int& majorVersion, int& minorVersion, int& buildVersion);
     void _onGPSConnect                              (void);
     void _onGPSDisconnect                           (void);
-    void _gpsSurveyInStatus                         (float duration, float accuracyMM,  double latitude, double longitude, float altitude, bool valid, bool active);
+    void _gpsSurveyInStatus                         (GPSSurveyInStatusMessage status);
     void _gpsNumSatellites                          (int numSatellites);
     void _showDelayedAppMessages                    (void);
+    void _firstFrameSwapped                         (void);
+    void _updateLowPowerMode                        (void);
 
 private:
     QObject*    _rootQmlObject          ();
     void        _checkForNewVersion     ();
+    void        _startupMilestone       (const char* milestone);
     void        _exitWithError          (QString errorMessage);
 
     // Overrides from QApplication
     bool compressEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents) override;
+    bool notify       (QObject* receiver, QEvent* event) override;
+    bool eventFilter  (QObject* watched, QEvent* event) override;
 
     bool                        _runningUnitTests;                                  ///< true: running unit tests, false: normal app
     static const int            _missingParamsDelayedDisplayTimerTimeout = 1000;    ///< Timeout to wait for next missing fact to come in before display
@@ -207,6 +236,10 @@ private:
     QLocale             _locale;
     bool                _error                  = false;
     QElapsedTimer       _msecsElapsedTime;
+    QGCStartupBenchmark* _startupBenchmark      = nullptr;  ///< Only set with --startup-benchmark
+    bool                _lowPowerMode           = false;
+
+    static const int    _lowPowerFactGroupMSecs = 1000;     ///< Shortest interval between display updates in low power mode
 
     QList<QPair<QString /* title */, QString /* message */>> _delayedAppMessages;
 
@@ -218,15 +251,73 @@ private:
 
         void add        (const QMetaMethod & method);
         void remove     (const QMetaMethod & method);
-        bool contains   (const QMetaObject * metaObject, int signalIndex);
+        bool contains   (const QMetaObject * metaObject, int signalIndex);  ///< Also true for a signal registered on a superclass
 
     private:
         static int _signalIndex(const QMetaMethod & method);
 
-        QMap<const QMetaObject*, QSet<int> > _signalMap;
+        QMutex                                  _mutex;     ///< compressEvent is called from the thread posting the event
+        QHash<const QMetaObject*, QSet<int> >   _signalMap;
+    };
+
+    /// Side table of the compressed calls which are waiting in an event queue
+    class CompressedCallTable {
+        Q_DISABLE_COPY(CompressedCallTable)
+
+    public:
+        CompressedCallTable() {}
+
+        /// Called from compressEvent with the posted event list of the receiver thread locked
+        void posted(QMetaCallEvent* event, QObject* receiver);
+
+        /// Called when the event is about to be delivered
+        ///     @return true: a newer call replaced this one, drop it
+        bool delivering(QMetaCallEvent* event, QObject* receiver);
+
+        bool empty(void) const { return _count.load() == 0; }
+
+    private:
+        typedef struct Key_t {
+            QObject*        receiver;
+            const QObject*  sender;
+            int             signalId;
+            int             slotId;
+
+            bool operator==(const Key_t& other) const {
+                return receiver == other.receiver && sender == other.sender && signalId == other.signalId && slotId == other.slotId;
+            }
+        } Key_t;
+
+        typedef struct {
+            QEvent*             event;
+            QPointer<QObject>   receiver;   ///< Goes null with a receiver which was deleted along with its queued events
+        } Newest_t;
+
+        typedef struct {
+            Key_t               key;
+            QPointer<QObject>   receiver;
+        } Superseded_t;
+
+        friend uint qHash(const Key_t& key, uint seed) {
+            return ::qHash(key.receiver, seed) ^ ::qHash(key.sender, seed) ^ ::qHash((key.signalId << 16) ^ key.slotId, seed);
+        }
+
+        static Key_t _key(QMetaCallEvent* event, QObject* receiver) { return { receiver, event->sender(), event->signalId(), event->id() }; }
+
+        void _purgeDeadReceivers(void);
+        void _updateCount       (void) { _count.store(_newest.count() + _superseded.count()); }
+
+        QMutex                              _mutex;
+        QHash<Key_t, Newest_t>              _newest;        ///< Newest queued call for each key
+        QHash<QEvent*, Superseded_t>        _superseded;    ///< Queued calls which a newer one replaced
+        QAtomicInt                          _count;         ///< Entries in both, lets notify skip the lock when nothing is compressed
+        int                                 _purgeCount     = _purgeThreshold;  ///< Entry count at which dead receivers are looked for
+
+        static const int _purgeThreshold = 1000;
     };
 
-    CompressedSignalList _compressedSignals;
+    CompressedSignalList    _compressedSignals;
+    CompressedCallTable     _compressedCalls;
 
     static const char* _settingsVersionKey;             ///< Settings key which hold settings version
     static const char* _deleteAllSettingsKey;           ///< If this settings key is set on boot, all settings will be deleted
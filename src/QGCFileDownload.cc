@@ -9,21 +9,36 @@
 
 
 #include "QGCFileDownload.h"
+#include "QGCNetworkManager.h"
+#include "QGCZlib.h"
 
 #include <QFileInfo>
 #include <QStandardPaths>
-#include <QNetworkProxy>
 
 QGCFileDownload::QGCFileDownload(QObject* parent)
-    : QNetworkAccessManager(parent)
+    : QObject(parent)
 {
 
 }
 
+QGCFileDownload::~QGCFileDownload()
+{
+    // The reply belongs to the shared network manager, so it would outlive us otherwise
+    if (_reply) {
+        _reply->disconnect(this);
+        _reply->abort();
+        _reply->deleteLater();
+    }
+    delete _inflater;
+}
+
 bool QGCFileDownload::download(const QString& remoteFile, bool redirect)
 {
     if (!redirect) {
         _originalRemoteFile = remoteFile;
+        _notModified = false;
+        _eTag.clear();
+        _lastModified.clear();
     }
 
     if (remoteFile.isEmpty()) {
@@ -44,27 +59,66 @@ bool QGCFileDownload::download(const QString& remoteFile, bool redirect)
     }
     
     QNetworkRequest networkRequest(remoteUrl);
-
-    QNetworkProxy tProxy;
-    tProxy.setType(QNetworkProxy::DefaultProxy);
-    setProxy(tProxy);
-    
-    QNetworkReply* networkReply = get(networkRequest);
-    if (!networkReply) {
-        qWarning() << "QNetworkAccessManager::get failed";
-        return false;
+    // Downloads are written to files and conditional downloads are handled here, so the shared cache stays out of it
+    networkRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    networkRequest.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+    if (remoteUrl.scheme().startsWith("http")) {
+        if (!_ifNoneMatch.isEmpty()) {
+            networkRequest.setRawHeader("If-None-Match", _ifNoneMatch);
+        }
+        if (!_ifModifiedSince.isEmpty()) {
+            networkRequest.setRawHeader("If-Modified-Since", _ifModifiedSince);
+        }
     }
 
-    connect(networkReply, &QNetworkReply::downloadProgress, this, &QGCFileDownload::downloadProgress);
-    connect(networkReply, &QNetworkReply::finished, this, &QGCFileDownload::_downloadFinished);
+    QGCNetworkManager::instance()->queueGet(networkRequest, QGCNetworkManager::PriorityNormal, this, [this](QNetworkReply* networkReply) {
+        _reply = networkReply;
+        if (_inMemory) {
+            _data.clear();
+            delete _inflater;
+            _inflater = _inflateGzip ? new QGCZlibInflater() : nullptr;
+            connect(networkReply, &QNetworkReply::readyRead, this, &QGCFileDownload::_readyRead);
+        }
+        connect(networkReply, &QNetworkReply::downloadProgress, this, &QGCFileDownload::downloadProgress);
+        connect(networkReply, &QNetworkReply::finished, this, &QGCFileDownload::_downloadFinished);
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-    connect(networkReply, static_cast<void (QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &QGCFileDownload::_downloadError);
+        connect(networkReply, static_cast<void (QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &QGCFileDownload::_downloadError);
 #else
-    connect(networkReply, &QNetworkReply::errorOccurred, this, &QGCFileDownload::_downloadError);
+        connect(networkReply, &QNetworkReply::errorOccurred, this, &QGCFileDownload::_downloadError);
 #endif
+    });
     return true;
 }
 
+void QGCFileDownload::setConditional(const QByteArray& eTag, const QByteArray& lastModified)
+{
+    _ifNoneMatch        = eTag;
+    _ifModifiedSince    = lastModified;
+}
+
+void QGCFileDownload::setInMemory(bool inflateGzip)
+{
+    _inMemory       = true;
+    _inflateGzip    = inflateGzip;
+}
+
+/// Takes in memory downloads as they come in, so inflating happens alongside the download instead of after it
+void QGCFileDownload::_readyRead(void)
+{
+    QNetworkReply* reply = _reply;
+    if (!reply || !reply->attribute(QNetworkRequest::RedirectionTargetAttribute).isNull() || reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        // Nothing here belongs to the download
+        return;
+    }
+
+    QByteArray bytes = reply->readAll();
+    if (_inflater) {
+        _inflater->inflate(bytes, _data);
+    } else {
+        _data.append(bytes);
+    }
+}
+
 void QGCFileDownload::_downloadFinished(void)
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
@@ -85,6 +139,35 @@ void QGCFileDownload::_downloadFinished(void)
         return;
     }
 
+    _eTag           = reply->rawHeader("ETag");
+    _lastModified   = reply->rawHeader("Last-Modified");
+
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        // A 304 doesn't have to repeat the validators, the ones we asked with still hold
+        if (_eTag.isEmpty()) {
+            _eTag = _ifNoneMatch;
+        }
+        if (_lastModified.isEmpty()) {
+            _lastModified = _ifModifiedSince;
+        }
+        _notModified = true;
+        emit downloadComplete(_originalRemoteFile, QString(), QString());
+        reply->deleteLater();
+        return;
+    }
+
+    if (_inMemory) {
+        _readyRead();
+        if (_inflater && (_inflater->failed() || !_inflater->finished())) {
+            _data.clear();
+            emit downloadComplete(_originalRemoteFile, QString(), tr("Unable to decompress download"));
+        } else {
+            emit downloadComplete(_originalRemoteFile, QString(), QString());
+        }
+        reply->deleteLater();
+        return;
+    }
+
     // Split out filename from path
     QString remoteFileName = QFileInfo(reply->url().toString()).fileName();
     if (remoteFileName.isEmpty()) {
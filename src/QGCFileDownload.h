@@ -10,13 +10,18 @@
 #pragma once
 
 #include <QNetworkReply>
+#include <QPointer>
 
-class QGCFileDownload : public QNetworkAccessManager
+class QGCZlibInflater;
+
+/// Downloads a file through QGCNetworkManager. Deleting the QGCFileDownload cancels the download.
+class QGCFileDownload : public QObject
 {
     Q_OBJECT
     
 public:
     QGCFileDownload(QObject* parent = nullptr);
+    ~QGCFileDownload();
     
     /// Download the specified remote file.
     ///     @param remoteFile   File to download. Can be http address or file system path.
@@ -24,6 +29,23 @@ public:
     /// @return true: Asynchronous download has started, false: Download initialization failed
     bool download(const QString& remoteFile, bool redirect = false);
 
+    /// Makes the next http download conditional on the remote file having changed since an earlier download. If it
+    /// didn't, downloadComplete is signalled with an empty localFile and no error, and notModified is true.
+    ///     @param eTag         ETag of the earlier download, empty for none
+    ///     @param lastModified Last-Modified of the earlier download, empty for none
+    void setConditional(const QByteArray& eTag, const QByteArray& lastModified);
+
+    /// Keeps downloads in memory instead of writing them to a file. downloadComplete then has an empty localFile and
+    /// the contents are in data().
+    ///     @param inflateGzip  true: download is gzip compressed and is inflated as it comes in
+    void setInMemory(bool inflateGzip);
+
+    const QByteArray& data(void) const { return _data; }    ///< Download contents when setInMemory is used
+
+    bool        notModified (void) const { return _notModified; }
+    QByteArray  eTag        (void) const { return _eTag; }          ///< Of the completed download, used for setConditional
+    QByteArray  lastModified(void) const { return _lastModified; }  ///< Of the completed download, used for setConditional
+
 signals:
     void downloadProgress(qint64 curr, qint64 total);
     void downloadComplete(QString remoteFile, QString localFile, QString errorMsg);
@@ -31,6 +53,17 @@ signals:
 private:
     void _downloadFinished(void);
     void _downloadError(QNetworkReply::NetworkError code);
+    void _readyRead    (void);
 
-    QString _originalRemoteFile;
+    QString                 _originalRemoteFile;
+    QPointer<QNetworkReply> _reply;
+    QByteArray  _ifNoneMatch;
+    QByteArray  _ifModifiedSince;
+    QByteArray  _eTag;
+    QByteArray  _lastModified;
+    bool        _notModified = false;
+    bool        _inMemory = false;
+    bool        _inflateGzip = false;
+    QByteArray          _data;
+    QGCZlibInflater*    _inflater = nullptr;
 };
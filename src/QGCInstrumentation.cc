@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCInstrumentation.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+
+static const quint64 kBucketUpperUSecs[QGCInstrumentHistogram::bucketCount] = {
+    10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 0
+};
+
+static const char* kCSVHeader = "timestamp,name,kind,value,count,meanUSecs,p50USecs,p95USecs,p99USecs,maxUSecs\n";
+
+QGCInstrument::QGCInstrument(const char* name, Kind_t kind)
+    : _name(name)
+    , _kind(kind)
+{
+    QGCInstrumentRegister::instance()->registerInstrument(this);
+}
+
+QGCInstrument::~QGCInstrument()
+{
+    QGCInstrumentRegister::instance()->unregisterInstrument(this);
+}
+
+QGCInstrumentHistogram::QGCInstrumentHistogram(const char* name)
+    : QGCInstrument(name, KindHistogram)
+{
+    for (int bucket=0; bucket<bucketCount; bucket++) {
+        _buckets[bucket].store(0, std::memory_order_relaxed);
+    }
+}
+
+quint64 QGCInstrumentHistogram::bucketUpperUSecs(int bucket)
+{
+    return kBucketUpperUSecs[bucket];
+}
+
+void QGCInstrumentHistogram::add(quint64 usecs)
+{
+    int bucket = 0;
+    while (bucket < bucketCount - 1 && usecs > kBucketUpperUSecs[bucket]) {
+        bucket++;
+    }
+
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _totalUSecs.fetch_add(usecs, std::memory_order_relaxed);
+
+    quint64 maxUSecs = _maxUSecs.load(std::memory_order_relaxed);
+    while (usecs > maxUSecs && !_maxUSecs.compare_exchange_weak(maxUSecs, usecs, std::memory_order_relaxed)) { }
+}
+
+quint64 QGCInstrumentHistogram::meanUSecs(void) const
+{
+    quint64 samples = count();
+    return samples ? totalUSecs() / samples : 0;
+}
+
+quint64 QGCInstrumentHistogram::percentileUSecs(int percent) const
+{
+    // Samples can be added while we are reading, so the total is taken from the buckets themselves to stay consistent
+    quint64 buckets[bucketCount];
+    quint64 total = 0;
+    for (int bucket=0; bucket<bucketCount; bucket++) {
+        buckets[bucket] = bucketSamples(bucket);
+        total += buckets[bucket];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the sample we are looking for, rounded up so that 100% is the last sample
+    quint64 rank    = (total * static_cast<quint64>(std::min(std::max(percent, 0), 100)) + 99) / 100;
+    quint64 samples = 0;
+
+    rank = std::max<quint64>(rank, 1);
+    for (int bucket=0; bucket<bucketCount - 1; bucket++) {
+        samples += buckets[bucket];
+        if (samples >= rank) {
+            return std::min(kBucketUpperUSecs[bucket], maxUSecs());
+        }
+    }
+
+    return maxUSecs();
+}
+
+void QGCInstrumentHistogram::reset(void)
+{
+    for (int bucket=0; bucket<bucketCount; bucket++) {
+        _buckets[bucket].store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _totalUSecs.store(0, std::memory_order_relaxed);
+    _maxUSecs.store(0, std::memory_order_relaxed);
+}
+
+static QGCInstrumentRegister* _instrumentRegisterInstance = nullptr;
+
+QGCInstrumentRegister* QGCInstrumentRegister::instance(void)
+{
+    if (!_instrumentRegisterInstance) {
+        _instrumentRegisterInstance = new QGCInstrumentRegister();
+        Q_CHECK_PTR(_instrumentRegisterInstance);
+    }
+
+    return _instrumentRegisterInstance;
+}
+
+bool QGCInstrumentRegister::enabled(void)
+{
+#ifdef QGC_DISABLE_INSTRUMENTATION
+    return false;
+#else
+    return true;
+#endif
+}
+
+const QList<QGCInstrument*>& QGCInstrumentRegister::instruments(void)
+{
+    if (!_sorted) {
+        std::sort(_instruments.begin(), _instruments.end(), [](const QGCInstrument* a, const QGCInstrument* b) { return qstrcmp(a->name(), b->name()) < 0; });
+        _sorted = true;
+    }
+    return _instruments;
+}
+
+QGCInstrument* QGCInstrumentRegister::instrument(const QString& name)
+{
+    for (QGCInstrument* instrument: _instruments) {
+        if (name == QLatin1String(instrument->name())) {
+            return instrument;
+        }
+    }
+    return nullptr;
+}
+
+void QGCInstrumentRegister::resetAll(void)
+{
+    for (QGCInstrument* instrument: _instruments) {
+        instrument->reset();
+    }
+}
+
+QVariantList QGCInstrumentRegister::snapshot(void)
+{
+    QVariantList list;
+
+    for (const QGCInstrument* instrument: instruments()) {
+        QVariantMap map;
+
+        map["name"] = QString(instrument->name());
+        switch (instrument->kind()) {
+        case QGCInstrument::KindCounter:
+            map["kind"]     = QStringLiteral("counter");
+            map["value"]    = static_cast<const QGCInstrumentCounter*>(instrument)->value();
+            break;
+        case QGCInstrument::KindGauge:
+            map["kind"]     = QStringLiteral("gauge");
+            map["value"]    = static_cast<const QGCInstrumentGauge*>(instrument)->value();
+            break;
+        case QGCInstrument::KindHistogram:
+        {
+            auto histogram = static_cast<const QGCInstrumentHistogram*>(instrument);
+            map["kind"]         = QStringLiteral("histogram");
+            map["count"]        = histogram->count();
+            map["meanUSecs"]    = histogram->meanUSecs();
+            map["p50USecs"]     = histogram->percentileUSecs(50);
+            map["p95USecs"]     = histogram->percentileUSecs(95);
+            map["p99USecs"]     = histogram->percentileUSecs(99);
+            map["maxUSecs"]     = histogram->maxUSecs();
+            break;
+        }
+        }
+        list.append(map);
+    }
+
+    return list;
+}
+
+bool QGCInstrumentRegister::startDump(const QString& path, int intervalMSecs)
+{
+    stopDump();
+
+    bool asJson = QFileInfo(path).suffix().compare(QStringLiteral("json"), Qt::CaseInsensitive) == 0;
+    if (!asJson) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            qWarning() << "Unable to open instrument dump file" << path << file.errorString();
+            return false;
+        }
+        file.write(kCSVHeader);
+    }
+
+    _dumpPath   = path;
+    _dumpAsJson = asJson;
+    if (!_dumpTimer) {
+        // Created on first use since the register itself is constructed during static initialization
+        _dumpTimer = new QTimer(this);
+        connect(_dumpTimer, &QTimer::timeout, this, &QGCInstrumentRegister::dump);
+    }
+    _dumpTimer->start(intervalMSecs);
+    emit dumpingChanged(true);
+
+    return true;
+}
+
+void QGCInstrumentRegister::stopDump(void)
+{
+    if (dumping()) {
+        // Make sure the tail end of the session makes it into the file
+        dump();
+        _dumpTimer->stop();
+        _dumpPath.clear();
+        emit dumpingChanged(false);
+    }
+}
+
+void QGCInstrumentRegister::dump(void)
+{
+    if (!dumping()) {
+        return;
+    }
+    if (_dumpAsJson) {
+        _dumpJson();
+    } else {
+        _dumpCSV();
+    }
+}
+
+void QGCInstrumentRegister::_dumpCSV(void)
+{
+    QFile file(_dumpPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Unable to write instrument dump file" << _dumpPath << file.errorString();
+        return;
+    }
+
+    QTextStream stream(&file);
+    QString     timestamp = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    for (const QVariant& var: snapshot()) {
+        QVariantMap map = var.toMap();
+        stream << timestamp << ','
+               << map["name"].toString() << ','
+               << map["kind"].toString() << ','
+               << map["value"].toString() << ','
+               << map["count"].toString() << ','
+               << map["meanUSecs"].toString() << ','
+               << map["p50USecs"].toString() << ','
+               << map["p95USecs"].toString() << ','
+               << map["p99USecs"].toString() << ','
+               << map["maxUSecs"].toString() << '\n';
+    }
+}
+
+void QGCInstrumentRegister::_dumpJson(void)
+{
+    QJsonObject root;
+    root["timestamp"]   = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    root["instruments"] = QJsonArray::fromVariantList(snapshot());
+
+    // Written through a save file so a reader never sees a partially written document
+    QSaveFile file(_dumpPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Unable to write instrument dump file" << _dumpPath << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(root).toJson());
+    file.commit();
+}
@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QVariantList>
+
+#include <atomic>
+
+class QTimer;
+
+// Add Global instruments (not class specific) here. Instruments used by a single file are declared at file scope
+// in that file with the QGC_INSTRUMENT_* macros below.
+
+/// @def QGC_INSTRUMENT_COUNTER
+/// Declares a file scope counter and registers its name into the global instrument list, in the same way
+/// QGC_LOGGING_CATEGORY does for logging categories. Updating any instrument is a relaxed atomic operation
+/// without locks or allocation, so probes can be placed on link, tile cache and GStreamer threads.
+/// Defining QGC_DISABLE_INSTRUMENTATION compiles all of the QGC_INSTRUMENT_* macros to nothing.
+#ifdef QGC_DISABLE_INSTRUMENTATION
+#define QGC_INSTRUMENT_COUNTER(var, name)
+#define QGC_INSTRUMENT_GAUGE(var, name)
+#define QGC_INSTRUMENT_HISTOGRAM(var, name)
+#define QGC_INSTRUMENT_ADD(var, count)      do {} while (false)
+#define QGC_INSTRUMENT_SET(var, value)      do {} while (false)
+#define QGC_INSTRUMENT_SAMPLE(var, usecs)   do {} while (false)
+#define QGC_INSTRUMENT_SCOPE(var)           do {} while (false)
+#else
+#define QGC_INSTRUMENT_COUNTER(var, name)   static QGCInstrumentCounter var(name);
+#define QGC_INSTRUMENT_GAUGE(var, name)     static QGCInstrumentGauge var(name);
+#define QGC_INSTRUMENT_HISTOGRAM(var, name) static QGCInstrumentHistogram var(name);
+#define QGC_INSTRUMENT_ADD(var, count)      var.add(count)
+#define QGC_INSTRUMENT_SET(var, value)      var.set(value)
+#define QGC_INSTRUMENT_SAMPLE(var, usecs)   var.add(usecs)
+/// Adds the time until the end of the enclosing scope to the histogram
+#define QGC_INSTRUMENT_SCOPE(var)           QGCInstrumentScope qgcInstrumentScope ## var(var)
+#endif
+
+/// Base class for all named instruments
+class QGCInstrument
+{
+public:
+    typedef enum {
+        KindCounter,
+        KindGauge,
+        KindHistogram,
+    } Kind_t;
+
+    QGCInstrument(const char* name, Kind_t kind);
+    virtual ~QGCInstrument();
+
+    const char* name    (void) const { return _name; }
+    Kind_t      kind    (void) const { return _kind; }
+
+    virtual void reset  (void) = 0;
+
+private:
+    const char* _name;
+    Kind_t      _kind;
+};
+
+/// Monotonically increasing count, such as bytes or messages processed
+class QGCInstrumentCounter : public QGCInstrument
+{
+public:
+    QGCInstrumentCounter(const char* name) : QGCInstrument(name, KindCounter) { }
+
+    void    add     (quint64 count = 1) { _value.fetch_add(count, std::memory_order_relaxed); }
+    quint64 value   (void) const        { return _value.load(std::memory_order_relaxed); }
+
+    void    reset   (void) override     { _value.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> _value { 0 };
+};
+
+/// Most recent value of a level, such as a queue depth
+class QGCInstrumentGauge : public QGCInstrument
+{
+public:
+    QGCInstrumentGauge(const char* name) : QGCInstrument(name, KindGauge) { }
+
+    void    set     (qint64 value)  { _value.store(value, std::memory_order_relaxed); }
+    qint64  value   (void) const    { return _value.load(std::memory_order_relaxed); }
+
+    void    reset   (void) override { _value.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> _value { 0 };
+};
+
+/// Duration histogram using fixed 1-2-5 microsecond bucket boundaries from 10us to 1s. Percentiles are reported
+/// as the upper boundary of the bucket they fall in, clamped to the largest sample seen.
+class QGCInstrumentHistogram : public QGCInstrument
+{
+public:
+    QGCInstrumentHistogram(const char* name);
+
+    void    add             (quint64 usecs);
+
+    quint64 count           (void) const { return _count.load(std::memory_order_relaxed); }
+    quint64 totalUSecs      (void) const { return _totalUSecs.load(std::memory_order_relaxed); }
+    quint64 maxUSecs        (void) const { return _maxUSecs.load(std::memory_order_relaxed); }
+    quint64 meanUSecs       (void) const;
+
+    /// @param percent 0-100
+    quint64 percentileUSecs (int percent) const;
+
+    /// Number of samples in the specified bucket
+    quint64 bucketSamples   (int bucket) const { return _buckets[bucket].load(std::memory_order_relaxed); }
+
+    void    reset           (void) override;
+
+    /// Upper boundary of the specified bucket in microseconds, 0 for the final unbounded bucket
+    static quint64 bucketUpperUSecs(int bucket);
+
+    static const int bucketCount = 17;
+
+private:
+    std::atomic<quint64> _buckets[bucketCount];
+    std::atomic<quint64> _count         { 0 };
+    std::atomic<quint64> _totalUSecs    { 0 };
+    std::atomic<quint64> _maxUSecs      { 0 };
+};
+
+/// Adds the lifetime of the object to a histogram. Used through QGC_INSTRUMENT_SCOPE.
+class QGCInstrumentScope
+{
+public:
+    QGCInstrumentScope(QGCInstrumentHistogram& histogram) : _histogram(histogram) { _timer.start(); }
+    ~QGCInstrumentScope() { _histogram.add(static_cast<quint64>(_timer.nsecsElapsed() / 1000)); }
+
+private:
+    QGCInstrumentHistogram& _histogram;
+    QElapsedTimer           _timer;
+};
+
+class QGCInstrumentRegister : public QObject
+{
+    Q_OBJECT
+
+public:
+    static QGCInstrumentRegister* instance(void);
+
+    /// @return true: instrumentation is compiled in
+    static bool enabled(void);
+
+    /// Registers the specified instrument to the system
+    void registerInstrument(QGCInstrument* instrument) { _instruments.append(instrument); _sorted = false; }
+    void unregisterInstrument(QGCInstrument* instrument) { _instruments.removeOne(instrument); }
+
+    /// Returns the list of registered instruments sorted by name
+    const QList<QGCInstrument*>& instruments(void);
+
+    /// @return Named instrument, nullptr if not found
+    QGCInstrument* instrument(const QString& name);
+
+    /// Resets all instruments back to zero
+    void resetAll(void);
+
+    /// Returns the current state of all instruments, one QVariantMap per instrument. Counters and gauges fill in
+    /// "value", histograms fill in "count", "meanUSecs", "p50USecs", "p95USecs", "p99USecs" and "maxUSecs".
+    QVariantList snapshot(void);
+
+    /// Starts periodically writing all instruments to the specified file. A file with a .json suffix is rewritten
+    /// with the latest snapshot on each interval. Anything else is treated as CSV which gets one row per instrument
+    /// appended on each interval.
+    ///     @return false: file could not be opened
+    bool startDump(const QString& path, int intervalMSecs = defaultDumpIntervalMSecs);
+    void stopDump (void);
+
+    bool    dumping (void) const { return !_dumpPath.isEmpty(); }
+    QString dumpPath(void) const { return _dumpPath; }
+
+    /// Writes the current state of all instruments to the dump file
+    void dump(void);
+
+    static const int defaultDumpIntervalMSecs = 5000;
+
+signals:
+    void dumpingChanged(bool dumping);
+
+private:
+    QGCInstrumentRegister(void) { }
+
+    void _dumpCSV (void);
+    void _dumpJson(void);
+
+    QList<QGCInstrument*>   _instruments;
+    bool                    _sorted     = true;
+    QTimer*                 _dumpTimer  = nullptr;
+    QString                 _dumpPath;
+    bool                    _dumpAsJson = false;
+};
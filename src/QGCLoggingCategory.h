@@ -23,8 +23,18 @@ Q_DECLARE_LOGGING_CATEGORY(RTKGPSLog)
 Q_DECLARE_LOGGING_CATEGORY(GuidedActionsControllerLog)
 Q_DECLARE_LOGGING_CATEGORY(ADSBVehicleManagerLog)
 Q_DECLARE_LOGGING_CATEGORY(LocalizationLog)
+Q_DECLARE_LOGGING_CATEGORY(StartupLog)
 Q_DECLARE_LOGGING_CATEGORY(VideoAllLog) // turns on all individual QGC video logs
 
+/// @def qCVerbose
+/// qCDebug for output which runs per message, per sample or per coordinate, and for the *VerboseLog categories.
+/// Defining QGC_DISABLE_VERBOSE_LOGGING compiles it out entirely, along with its arguments.
+#ifdef QGC_DISABLE_VERBOSE_LOGGING
+#define qCVerbose(category) while (false) QMessageLogger().noDebug()
+#else
+#define qCVerbose(category) qCDebug(category)
+#endif
+
 /// @def QGC_LOGGING_CATEGORY
 /// This is a QGC specific replacement for Q_LOGGING_CATEGORY. It will register the category name into a
 /// global list. It's usage is the same as Q_LOGGING_CATEOGRY.
@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCNetworkManager.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QNetworkDiskCache>
+#include <QNetworkProxy>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+
+QGC_LOGGING_CATEGORY(QGCNetworkManagerLog, "QGCNetworkManagerLog")
+
+static QGCNetworkManager* _instance = nullptr;
+
+QGCNetworkManager* QGCNetworkManager::instance(void)
+{
+    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+    if (!_instance) {
+        _instance = new QGCNetworkManager(QCoreApplication::instance());
+    }
+    return _instance;
+}
+
+QGCNetworkManager::QGCNetworkManager(QObject* parent)
+    : QNetworkAccessManager(parent)
+{
+    QNetworkProxy proxy;
+    proxy.setType(QNetworkProxy::DefaultProxy);
+    setProxy(proxy);
+
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDir.isEmpty()) {
+        QNetworkDiskCache* diskCache = new QNetworkDiskCache(this);
+        diskCache->setCacheDirectory(QDir(cacheDir).filePath(QStringLiteral("NetworkCache")));
+        diskCache->setMaximumCacheSize(maxDiskCacheBytes);
+        setCache(diskCache);
+    }
+}
+
+void QGCNetworkManager::setPriority(QNetworkRequest& request, Priority_t priority)
+{
+    switch (priority) {
+    case PriorityInteractive:
+        request.setPriority(QNetworkRequest::HighPriority);
+        break;
+    case PriorityNormal:
+        request.setPriority(QNetworkRequest::NormalPriority);
+        break;
+    case PriorityBackground:
+        request.setPriority(QNetworkRequest::LowPriority);
+        break;
+    }
+}
+
+void QGCNetworkManager::queueGet(const QNetworkRequest& request, Priority_t priority, QObject* context, std::function<void(QNetworkReply*)> started)
+{
+    QueuedRequest_t queuedRequest;
+    queuedRequest.request   = request;
+    queuedRequest.context   = context;
+    queuedRequest.started   = started;
+    setPriority(queuedRequest.request, priority);
+
+    switch (priority) {
+    case PriorityInteractive:
+        started(get(queuedRequest.request));
+        return;
+    case PriorityNormal:
+        _normalQueue.append(queuedRequest);
+        break;
+    case PriorityBackground:
+        _backgroundQueue.append(queuedRequest);
+        break;
+    }
+
+    // Started from the event loop so the caller is done setting itself up before started is called
+    QTimer::singleShot(0, this, &QGCNetworkManager::_startQueued);
+}
+
+int QGCNetworkManager::queuedCount(void) const
+{
+    return _normalQueue.count() + _backgroundQueue.count();
+}
+
+bool QGCNetworkManager::_slotFree(Priority_t priority) const
+{
+    if (_activeReplies.count() >= maxActiveRequests) {
+        return false;
+    }
+    return priority != PriorityBackground || _backgroundReplies.count() < maxBackgroundRequests;
+}
+
+void QGCNetworkManager::_startQueued(void)
+{
+    while (!_normalQueue.isEmpty() && _slotFree(PriorityNormal)) {
+        QueuedRequest_t queuedRequest = _normalQueue.takeFirst();
+        if (queuedRequest.context) {
+            queuedRequest.started(get(queuedRequest.request));
+        }
+    }
+    // Background requests don't get a slot while normal ones are waiting
+    while (_normalQueue.isEmpty() && !_backgroundQueue.isEmpty() && _slotFree(PriorityBackground)) {
+        QueuedRequest_t queuedRequest = _backgroundQueue.takeFirst();
+        if (queuedRequest.context) {
+            queuedRequest.started(get(queuedRequest.request));
+        }
+    }
+}
+
+QNetworkReply* QGCNetworkManager::createRequest(Operation op, const QNetworkRequest& request, QIODevice* outgoingData)
+{
+    QNetworkRequest http2Request(request);
+    if (!http2Request.attribute(QNetworkRequest::Http2AllowedAttribute).isValid()) {
+        http2Request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    }
+
+    QNetworkReply* reply = QNetworkAccessManager::createRequest(op, http2Request, outgoingData);
+    if (reply) {
+        _activeReplies.insert(reply);
+        if (request.priority() == QNetworkRequest::LowPriority) {
+            _backgroundReplies.insert(reply);
+        }
+        // Either one frees the slot: a reply deleted while still running doesn't signal finished
+        connect(reply, &QNetworkReply::finished, this, [this, reply]() { _replyDone(reply); });
+        connect(reply, &QObject::destroyed, this, &QGCNetworkManager::_replyDone);
+        qCDebug(QGCNetworkManagerLog) << "Request" << request.url().host() << "active" << _activeReplies.count() << "queued" << queuedCount();
+    }
+    return reply;
+}
+
+void QGCNetworkManager::_replyDone(QObject* reply)
+{
+    if (_activeReplies.remove(reply)) {
+        _backgroundReplies.remove(reply);
+        _startQueued();
+    }
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+
+#include <functional>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(QGCNetworkManagerLog)
+
+/// Network access shared by map tiles, terrain, file downloads and camera definitions.
+///
+/// Each QNetworkAccessManager has its own connection pool, so going through the one instance keeps the connections and
+/// TLS sessions to a host around for everybody instead of each subsystem doing its own handshakes. HTTP/2 is allowed
+/// on every request, which multiplexes all requests to a host over a single connection where the server supports it.
+/// Responses go through a shared disk cache unless a request opts out, which the tile requests do since they have a
+/// cache of their own.
+///
+/// Requests started with get run right away. Requests started with queueGet wait for a free slot, so a burst of
+/// downloads doesn't starve the requests someone is waiting on over a weak link: no more than maxActiveRequests are
+/// in flight and no more than maxBackgroundRequests of them are background ones.
+///
+/// Must only be used from the GUI thread.
+class QGCNetworkManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+
+public:
+    typedef enum {
+        PriorityInteractive,    ///< Someone is waiting on it, e.g. map tiles in view. Never queued.
+        PriorityNormal,
+        PriorityBackground,     ///< Nobody is waiting on it, e.g. tile prefetch
+    } Priority_t;
+
+    static QGCNetworkManager* instance(void);
+
+    /// Sets the QNetworkRequest priority matching priority. Qt also uses it to order the requests to a single host.
+    static void setPriority(QNetworkRequest& request, Priority_t priority);
+
+    /// Starts a get once there's a slot free for priority.
+    ///     @param context  The request is dropped if context is destroyed before it starts
+    ///     @param started  Called with the reply once the request started
+    void queueGet(const QNetworkRequest& request, Priority_t priority, QObject* context, std::function<void(QNetworkReply*)> started);
+
+    int activeCount     (void) const { return _activeReplies.count(); }
+    int backgroundCount (void) const { return _backgroundReplies.count(); }
+    int queuedCount     (void) const;
+
+    static const int maxActiveRequests      = 8;
+    static const int maxBackgroundRequests  = 2;
+    static const int maxDiskCacheBytes      = 32 * 1024 * 1024;
+
+protected:
+    // Overrides from QNetworkAccessManager
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest& request, QIODevice* outgoingData = nullptr) override;
+
+private slots:
+    void _replyDone     (QObject* reply);
+    void _startQueued   (void);
+
+private:
+    QGCNetworkManager(QObject* parent);
+
+    typedef struct {
+        QNetworkRequest                     request;
+        QPointer<QObject>                   context;
+        std::function<void(QNetworkReply*)> started;
+    } QueuedRequest_t;
+
+    bool _slotFree(Priority_t priority) const;
+
+    QList<QueuedRequest_t>  _normalQueue;
+    QList<QueuedRequest_t>  _backgroundQueue;
+    QSet<QObject*>          _activeReplies;
+    QSet<QObject*>          _backgroundReplies;     ///< Subset of _activeReplies
+};
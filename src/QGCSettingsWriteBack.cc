@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCSettingsWriteBack.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QThread>
+#include <QtConcurrent>
+
+QGC_LOGGING_CATEGORY(QGCSettingsWriteBackLog, "QGCSettingsWriteBackLog")
+
+static QGCSettingsWriteBack* _instance = nullptr;
+
+namespace {
+
+/// QSettings which leaves syncing to QGCSettingsWriteBack instead of writing the file on the next event loop pass
+class WriteBackSettings : public QSettings
+{
+public:
+    WriteBackSettings(QGCSettingsWriteBack* writeBack)
+        : _writeBack(writeBack)
+    {
+    }
+
+protected:
+    bool event(QEvent* event) override
+    {
+        if (event->type() == QEvent::UpdateRequest) {
+            _writeBack->scheduleFlush();
+            return true;
+        }
+        return QSettings::event(event);
+    }
+
+private:
+    QGCSettingsWriteBack* _writeBack;
+};
+
+}
+
+QGCSettingsWriteBack* QGCSettingsWriteBack::instance(void)
+{
+    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+    if (!_instance) {
+        _instance = new QGCSettingsWriteBack(QCoreApplication::instance());
+    }
+    return _instance;
+}
+
+QGCSettingsWriteBack::QGCSettingsWriteBack(QObject* parent)
+    : QObject   (parent)
+    , _settings (new WriteBackSettings(this))
+{
+    _debounceTimer.setSingleShot(true);
+    _debounceTimer.setInterval(debounceMSecs);
+    connect(&_debounceTimer, &QTimer::timeout, this, &QGCSettingsWriteBack::_flushAsync);
+}
+
+QGCSettingsWriteBack::~QGCSettingsWriteBack()
+{
+    flush();
+    delete _settings;
+    _instance = nullptr;
+}
+
+void QGCSettingsWriteBack::setValue(const QString& group, const QString& key, const QVariant& value)
+{
+    if (group.isEmpty()) {
+        _settings->setValue(key, value);
+    } else {
+        _settings->setValue(group + QStringLiteral("/") + key, value);
+    }
+    scheduleFlush();
+}
+
+void QGCSettingsWriteBack::scheduleFlush(void)
+{
+    _debounceTimer.start();
+}
+
+void QGCSettingsWriteBack::_flushAsync(void)
+{
+    if (_flushFuture.isRunning()) {
+        // Still writing the previous batch, pick the new keys up on the next pass
+        _debounceTimer.start();
+        return;
+    }
+
+    // Syncing any QSettings on the same file writes all the dirty keys of the shared cache
+    _flushFuture = QtConcurrent::run([]() {
+        QElapsedTimer timer;
+        timer.start();
+        QSettings settings;
+        settings.sync();
+        qCDebug(QGCSettingsWriteBackLog) << "Settings written in" << timer.elapsed() << "ms";
+    });
+}
+
+void QGCSettingsWriteBack::flush(void)
+{
+    _debounceTimer.stop();
+    _flushFuture.waitForFinished();
+    _settings->sync();
+}
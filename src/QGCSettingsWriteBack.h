@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QFuture>
+#include <QSettings>
+#include <QTimer>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(QGCSettingsWriteBackLog)
+
+/// Batches writes to the settings file.
+///
+/// A QSettings which goes out of scope after a setValue writes the whole settings file. That means every slider step
+/// which is bound to a setting is a file write on the GUI thread. Values written through here go into the QSettings cache
+/// which is shared by the whole process, so any QSettings reads them right away. The dirty keys are collected there and
+/// written in one go on a worker thread, debounceMSecs after the last change. flush writes them synchronously, which
+/// QGCApplication does on shutdown.
+///
+/// Must only be used from the GUI thread.
+class QGCSettingsWriteBack : public QObject
+{
+    Q_OBJECT
+
+public:
+    static QGCSettingsWriteBack* instance(void);
+
+    /// Writes the value to the key within the group and schedules a flush
+    void setValue(const QString& group, const QString& key, const QVariant& value);
+
+    /// Long lived settings to write a batch of values through without causing a file write on each one. Leave the group
+    /// stack the way you found it and call scheduleFlush when done.
+    QSettings& settings(void) { return *_settings; }
+
+    /// Writes the dirty keys debounceMSecs from now
+    void scheduleFlush(void);
+
+    /// Writes the dirty keys now, waiting for a background write still in progress
+    void flush(void);
+
+    static const int debounceMSecs = 1000;
+
+private slots:
+    void _flushAsync(void);
+
+private:
+    QGCSettingsWriteBack(QObject* parent);
+    ~QGCSettingsWriteBack();
+
+    QSettings*      _settings = nullptr;
+    QTimer          _debounceTimer;
+    QFuture<void>   _flushFuture;
+};
@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCStartupBenchmark.h"
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
+#include "ParameterManager.h"
+#include "Vehicle.h"
+#ifdef QT_DEBUG
+#include "MockLink.h"
+#endif
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSysInfo>
+
+const char* QGCStartupBenchmark::toolboxReadyMilestone              = "toolboxReady";
+const char* QGCStartupBenchmark::qmlTypesRegisteredMilestone        = "qmlTypesRegistered";
+const char* QGCStartupBenchmark::qmlEngineLoadedMilestone           = "qmlEngineLoaded";
+const char* QGCStartupBenchmark::firstFrameMilestone                = "firstFrame";
+const char* QGCStartupBenchmark::firstHeartbeatMilestone            = "firstHeartbeat";
+const char* QGCStartupBenchmark::parametersCompleteMilestone        = "parametersComplete";
+const char* QGCStartupBenchmark::initialConnectCompleteMilestone    = "initialConnectComplete";
+
+QGCStartupBenchmark::QGCStartupBenchmark(const QString& resultsPath, QObject* parent)
+    : QObject       (parent)
+    , _resultsPath  (resultsPath)
+{
+    _timeoutTimer.setSingleShot(true);
+    _timeoutTimer.setInterval(timeoutMSecs);
+    connect(&_timeoutTimer, &QTimer::timeout, this, &QGCStartupBenchmark::_timeout);
+}
+
+void QGCStartupBenchmark::mark(const QString& milestone)
+{
+    if (milestoneMSecs(milestone) == -1) {
+        _milestones.append(qMakePair(milestone, static_cast<qint64>(qgcApp()->msecsSinceBoot())));
+    }
+}
+
+qint64 QGCStartupBenchmark::milestoneMSecs(const QString& milestone) const
+{
+    for (const QPair<QString, qint64>& pair: _milestones) {
+        if (pair.first == milestone) {
+            return pair.second;
+        }
+    }
+    return -1;
+}
+
+void QGCStartupBenchmark::start(void)
+{
+    if (_started) {
+        return;
+    }
+    _started = true;
+
+#ifdef QT_DEBUG
+    connect(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::vehicleAdded, this, &QGCStartupBenchmark::_vehicleAdded);
+    _timeoutTimer.start();
+    MockLink::startPX4MockLink(false);
+#else
+    qWarning() << "Startup benchmark: MockLink is only available in debug builds, vehicle milestones are skipped";
+    _finish(false);
+#endif
+}
+
+void QGCStartupBenchmark::_vehicleAdded(Vehicle* vehicle)
+{
+    // The vehicle is created on the first heartbeat
+    mark(firstHeartbeatMilestone);
+
+    disconnect(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::vehicleAdded, this, &QGCStartupBenchmark::_vehicleAdded);
+    connect(vehicle->parameterManager(),    &ParameterManager::parametersReadyChanged,  this, &QGCStartupBenchmark::_parametersReadyChanged);
+    connect(vehicle,                        &Vehicle::initialConnectComplete,           this, &QGCStartupBenchmark::_initialConnectComplete);
+}
+
+void QGCStartupBenchmark::_parametersReadyChanged(bool parametersReady)
+{
+    if (parametersReady) {
+        mark(parametersCompleteMilestone);
+        _checkComplete();
+    }
+}
+
+void QGCStartupBenchmark::_initialConnectComplete(void)
+{
+    mark(initialConnectCompleteMilestone);
+    _checkComplete();
+}
+
+void QGCStartupBenchmark::_checkComplete(void)
+{
+    if (milestoneMSecs(parametersCompleteMilestone) != -1 && milestoneMSecs(initialConnectCompleteMilestone) != -1) {
+        _finish(false);
+    }
+}
+
+void QGCStartupBenchmark::_timeout(void)
+{
+    qWarning() << "Startup benchmark: timed out waiting for the vehicle";
+    _finish(true);
+}
+
+void QGCStartupBenchmark::_finish(bool timedOut)
+{
+    if (_finished) {
+        return;
+    }
+    _finished = true;
+    _timeoutTimer.stop();
+
+    bool written = writeResults(timedOut);
+    qgcApp()->exit(timedOut || !written ? 1 : 0);
+}
+
+bool QGCStartupBenchmark::writeResults(bool timedOut)
+{
+    QJsonArray  milestones;
+    QJsonObject milestoneMSecs;
+
+    for (const QPair<QString, qint64>& pair: _milestones) {
+        milestones.append(pair.first);
+        milestoneMSecs[pair.first] = pair.second;
+    }
+
+    QJsonObject results;
+    results[QStringLiteral("version")]          = qgcApp()->applicationVersion();
+    results[QStringLiteral("platform")]         = QSysInfo::prettyProductName();
+    results[QStringLiteral("timestamp")]        = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    results[QStringLiteral("timedOut")]         = timedOut;
+    results[QStringLiteral("milestones")]       = milestones;
+    results[QStringLiteral("milestoneMSecs")]   = milestoneMSecs;
+
+    // QSaveFile so a CI job reading the file never sees a partial write
+    QSaveFile file(_resultsPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Startup benchmark: unable to open results file" << _resultsPath << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(results).toJson());
+    if (!file.commit()) {
+        qWarning() << "Startup benchmark: unable to write results file" << _resultsPath << file.errorString();
+        return false;
+    }
+    qDebug() << "Startup benchmark results written to" << _resultsPath;
+    return true;
+}
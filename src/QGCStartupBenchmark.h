@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QTimer>
+
+class Vehicle;
+
+/// Measures startup from boot to a MockLink vehicle completing its initial connect.
+///
+/// It is enabled with the --startup-benchmark:<file> command line option. Milestones are recorded as milliseconds since
+/// boot. Once the vehicle is ready, or timeoutMSecs passes, they are written to the file as json and the application
+/// quits. The exit code is non-zero on a timeout. Use -platform offscreen to run it headless on CI.
+///
+/// MockLink is only available in debug builds. Release builds write the results once the first frame is up.
+class QGCStartupBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    QGCStartupBenchmark(const QString& resultsPath, QObject* parent = nullptr);
+
+    /// Records the milestone at the current time since boot. Only the first time a milestone is reached is kept.
+    void mark(const QString& milestone);
+
+    /// @return Milliseconds since boot at which the milestone was reached, -1 if it wasn't
+    qint64 milestoneMSecs(const QString& milestone) const;
+
+    /// Connects the MockLink and waits for its vehicle. Called once the main window is up.
+    void start(void);
+
+    /// Writes the milestones reached so far to the results file
+    ///     @return false: file could not be written
+    bool writeResults(bool timedOut);
+
+    QString resultsPath(void) const { return _resultsPath; }
+
+    static const char*  toolboxReadyMilestone;
+    static const char*  qmlTypesRegisteredMilestone;
+    static const char*  qmlEngineLoadedMilestone;
+    static const char*  firstFrameMilestone;
+    static const char*  firstHeartbeatMilestone;
+    static const char*  parametersCompleteMilestone;
+    static const char*  initialConnectCompleteMilestone;
+
+    static const int    timeoutMSecs = 120000;
+
+private slots:
+    void _vehicleAdded              (Vehicle* vehicle);
+    void _parametersReadyChanged    (bool parametersReady);
+    void _initialConnectComplete    (void);
+    void _timeout                   (void);
+
+private:
+    void _checkComplete (void);
+    void _finish        (bool timedOut);
+
+    QString                         _resultsPath;
+    QList<QPair<QString, qint64>>   _milestones;        ///< In the order they were reached
+    QTimer                          _timeoutTimer;
+    bool                            _started    = false;
+    bool                            _finished   = false;
+};
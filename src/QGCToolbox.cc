@@ -50,85 +50,168 @@
 #include CUSTOMHEADER
 #endif
 
+#include <QElapsedTimer>
+
 QGCToolbox::QGCToolbox(QGCApplication* app)
+    : _app(app)
 {
     // SettingsManager must be first so settings are available to any subsequent tools
-    _settingsManager        = new SettingsManager           (app, this);
+    _settingsManager        = _createTool<SettingsManager>();
     //-- Scan and load plugins
     _scanAndLoadPlugins(app);
-    _audioOutput            = new AudioOutput               (app, this);
-    _factSystem             = new FactSystem                (app, this);
-    _firmwarePluginManager  = new FirmwarePluginManager     (app, this);
+    _audioOutput            = _createTool<AudioOutput>();
+    _factSystem             = _createTool<FactSystem>();
+    _firmwarePluginManager  = _createTool<FirmwarePluginManager>();
 #ifndef __mobile__
-    _gpsManager             = new GPSManager                (app, this);
-#endif
-    _imageProvider          = new QGCImageProvider          (app, this);
-    _joystickManager        = new JoystickManager           (app, this);
-    _linkManager            = new LinkManager               (app, this);
-    _mavlinkProtocol        = new MAVLinkProtocol           (app, this);
-    _missionCommandTree     = new MissionCommandTree        (app, this);
-    _multiVehicleManager    = new MultiVehicleManager       (app, this);
-    _mapEngineManager       = new QGCMapEngineManager       (app, this);
-    _uasMessageHandler      = new UASMessageHandler         (app, this);
-    _qgcPositionManager     = new QGCPositionManager        (app, this);
-    _followMe               = new FollowMe                  (app, this);
-    _videoManager           = new VideoManager              (app, this);
-    _mavlinkLogManager      = new MAVLinkLogManager         (app, this);
-    _adsbVehicleManager     = new ADSBVehicleManager        (app, this);
-#if defined(QGC_ENABLE_PAIRING)
-    _pairingManager         = new PairingManager            (app, this);
-#endif
+    _gpsManager             = _createTool<GPSManager>();
+#endif
+    _imageProvider          = _createTool<QGCImageProvider>();
+    _joystickManager        = _createTool<JoystickManager>();
+    _linkManager            = _createTool<LinkManager>();
+    _mavlinkProtocol        = _createTool<MAVLinkProtocol>();
+    _missionCommandTree     = _createTool<MissionCommandTree>();
+    _multiVehicleManager    = _createTool<MultiVehicleManager>();
+    _uasMessageHandler      = _createTool<UASMessageHandler>();
+    _qgcPositionManager     = _createTool<QGCPositionManager>();
+    _followMe               = _createTool<FollowMe>();
+    _videoManager           = _createTool<VideoManager>();
+    _adsbVehicleManager     = _createTool<ADSBVehicleManager>();
     //-- Airmap Manager
     //-- This should be "pluggable" so an arbitrary AirSpace manager can be used
     //-- For now, we instantiate the one and only AirMap provider
 #if defined(QGC_AIRMAP_ENABLED)
-    _airspaceManager        = new AirMapManager             (app, this);
+    _airspaceManager        = _createTool<AirMapManager>();
 #else
-    _airspaceManager        = new AirspaceManager           (app, this);
-#endif
-#if defined(QGC_GST_TAISYNC_ENABLED)
-    _taisyncManager         = new TaisyncManager            (app, this);
-#endif
-#if defined(QGC_GST_MICROHARD_ENABLED)
-    _microhardManager       = new MicrohardManager          (app, this);
+    _airspaceManager        = _createTool<AirspaceManager>();
 #endif
+    // The map engine manager, log manager, pairing, Taisync and Microhard are deferred, see createDeferredTools
 }
 
 void QGCToolbox::setChildToolboxes(void)
 {
     // SettingsManager must be first so settings are available to any subsequent tools
-    _settingsManager->setToolbox(this);
+    _setToolbox(_settingsManager);
 
-    _corePlugin->setToolbox(this);
-    _audioOutput->setToolbox(this);
-    _factSystem->setToolbox(this);
-    _firmwarePluginManager->setToolbox(this);
+    _setToolbox(_corePlugin);
+    _setToolbox(_audioOutput);
+    _setToolbox(_factSystem);
+    _setToolbox(_firmwarePluginManager);
 #ifndef __mobile__
-    _gpsManager->setToolbox(this);
-#endif
-    _imageProvider->setToolbox(this);
-    _joystickManager->setToolbox(this);
-    _linkManager->setToolbox(this);
-    _mavlinkProtocol->setToolbox(this);
-    _missionCommandTree->setToolbox(this);
-    _multiVehicleManager->setToolbox(this);
-    _mapEngineManager->setToolbox(this);
-    _uasMessageHandler->setToolbox(this);
-    _followMe->setToolbox(this);
-    _qgcPositionManager->setToolbox(this);
-    _videoManager->setToolbox(this);
-    _mavlinkLogManager->setToolbox(this);
-    _airspaceManager->setToolbox(this);
-    _adsbVehicleManager->setToolbox(this);
+    _setToolbox(_gpsManager);
+#endif
+    _setToolbox(_imageProvider);
+    _setToolbox(_joystickManager);
+    _setToolbox(_linkManager);
+    _setToolbox(_mavlinkProtocol);
+    _setToolbox(_missionCommandTree);
+    _setToolbox(_multiVehicleManager);
+    _setToolbox(_uasMessageHandler);
+    _setToolbox(_followMe);
+    _setToolbox(_qgcPositionManager);
+    _setToolbox(_videoManager);
+    _setToolbox(_airspaceManager);
+    _setToolbox(_adsbVehicleManager);
+}
+
+void QGCToolbox::createDeferredTools(void)
+{
+    if (_deferredToolsCreated) {
+        return;
+    }
+    _deferredToolsCreated = true;
+    qCDebug(StartupLog) << "Creating deferred tools" << _app->msecsSinceBoot() << "ms since boot";
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // The accessors create the tools which were not used yet
+    mapEngineManager();
+    mavlinkLogManager();
 #if defined(QGC_GST_TAISYNC_ENABLED)
-    _taisyncManager->setToolbox(this);
+    taisyncManager();
 #endif
 #if defined(QGC_GST_MICROHARD_ENABLED)
-    _microhardManager->setToolbox(this);
+    microhardManager();
 #endif
 #if defined(QGC_ENABLE_PAIRING)
-    _pairingManager->setToolbox(this);
+    pairingManager();
 #endif
+
+    qCDebug(StartupLog) << "Deferred tools created" << timer.elapsed() << "ms";
+}
+
+QGCMapEngineManager* QGCToolbox::mapEngineManager(void)
+{
+    if (!_mapEngineManager) {
+        // Assigned before setToolbox so tools which reference each other from setToolbox don't create a second instance
+        _mapEngineManager = _createTool<QGCMapEngineManager>();
+        _setToolbox(_mapEngineManager);
+    }
+    return _mapEngineManager;
+}
+
+MAVLinkLogManager* QGCToolbox::mavlinkLogManager(void)
+{
+    if (!_mavlinkLogManager) {
+        _mavlinkLogManager = _createTool<MAVLinkLogManager>();
+        _setToolbox(_mavlinkLogManager);
+    }
+    return _mavlinkLogManager;
+}
+
+#if defined(QGC_ENABLE_PAIRING)
+PairingManager* QGCToolbox::pairingManager(void)
+{
+    if (!_pairingManager) {
+        _pairingManager = _createTool<PairingManager>();
+        _setToolbox(_pairingManager);
+    }
+    return _pairingManager;
+}
+#endif
+
+#if defined(QGC_GST_TAISYNC_ENABLED)
+TaisyncManager* QGCToolbox::taisyncManager(void)
+{
+    if (!_taisyncManager) {
+        _taisyncManager = _createTool<TaisyncManager>();
+        _setToolbox(_taisyncManager);
+    }
+    return _taisyncManager;
+}
+#endif
+
+#if defined(QGC_GST_MICROHARD_ENABLED)
+MicrohardManager* QGCToolbox::microhardManager(void)
+{
+    if (!_microhardManager) {
+        _microhardManager = _createTool<MicrohardManager>();
+        _setToolbox(_microhardManager);
+    }
+    return _microhardManager;
+}
+#endif
+
+template<class T>
+T* QGCToolbox::_createTool(void)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    T* tool = new T(_app, this);
+
+    qCDebug(StartupLog) << "Construct" << T::staticMetaObject.className() << timer.nsecsElapsed() / 1000 << "us";
+    return tool;
+}
+
+void QGCToolbox::_setToolbox(QGCTool* tool)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    tool->setToolbox(this);
+
+    qCDebug(StartupLog) << "setToolbox" << tool->metaObject()->className() << timer.nsecsElapsed() / 1000 << "us";
 }
 
 void QGCToolbox::_scanAndLoadPlugins(QGCApplication* app)
@@ -13,7 +13,10 @@
 
 #include <QObject>
 
+#include "QGCLoggingCategory.h"
+
 class FactSystem;
+class QGCTool;
 class FirmwarePluginManager;
 class AudioOutput;
 class GPSManager;
@@ -45,6 +48,10 @@ class MicrohardManager;
 #endif
 
 /// This is used to manage all of our top level services/tools
+///
+/// Tools which the initial fly view does not need are created on first use through their accessor, or by
+/// createDeferredTools once the first frame is up, whichever comes first. They must only be accessed from the GUI
+/// thread. Construction and setToolbox cost of each tool goes to StartupLog.
 class QGCToolbox : public QObject {
     Q_OBJECT
 
@@ -58,34 +65,43 @@ public:
     MAVLinkProtocol*            mavlinkProtocol         () { return _mavlinkProtocol; }
     MissionCommandTree*         missionCommandTree      () { return _missionCommandTree; }
     MultiVehicleManager*        multiVehicleManager     () { return _multiVehicleManager; }
-    QGCMapEngineManager*        mapEngineManager        () { return _mapEngineManager; }
+    QGCMapEngineManager*        mapEngineManager        ();
     QGCImageProvider*           imageProvider           () { return _imageProvider; }
     UASMessageHandler*          uasMessageHandler       () { return _uasMessageHandler; }
     FollowMe*                   followMe                () { return _followMe; }
     QGCPositionManager*         qgcPositionManager      () { return _qgcPositionManager; }
     VideoManager*               videoManager            () { return _videoManager; }
-    MAVLinkLogManager*          mavlinkLogManager       () { return _mavlinkLogManager; }
+    MAVLinkLogManager*          mavlinkLogManager       ();
     QGCCorePlugin*              corePlugin              () { return _corePlugin; }
     SettingsManager*            settingsManager         () { return _settingsManager; }
     AirspaceManager*            airspaceManager         () { return _airspaceManager; }
     ADSBVehicleManager*         adsbVehicleManager      () { return _adsbVehicleManager; }
 #if defined(QGC_ENABLE_PAIRING)
-    PairingManager*             pairingManager          () { return _pairingManager; }
+    PairingManager*             pairingManager          ();
 #endif
 #ifndef __mobile__
     GPSManager*                 gpsManager              () { return _gpsManager; }
 #endif
 #if defined(QGC_GST_TAISYNC_ENABLED)
-    TaisyncManager*             taisyncManager          () { return _taisyncManager; }
+    TaisyncManager*             taisyncManager          ();
 #endif
 #if defined(QGC_GST_MICROHARD_ENABLED)
-    MicrohardManager*           microhardManager        () { return _microhardManager; }
+    MicrohardManager*           microhardManager        ();
 #endif
 
+    /// Creates the deferred tools which have not been used yet
+    void createDeferredTools(void);
+
 private:
     void setChildToolboxes(void);
     void _scanAndLoadPlugins(QGCApplication *app);
+    void _setToolbox        (QGCTool* tool);
+
+    template<class T>
+    T* _createTool(void);
 
+    QGCApplication*             _app                    = nullptr;
+    bool                        _deferredToolsCreated   = false;
 
     AudioOutput*                _audioOutput            = nullptr;
     FactSystem*                 _factSystem             = nullptr;
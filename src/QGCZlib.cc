@@ -15,15 +15,75 @@
 
 #include "zlib.h"
 
-bool QGCZlib::inflateGzipFile(const QString& gzippedFileName, const QString& decompressedFilename)
+QGCZlibInflater::QGCZlibInflater(void)
+    : _strm(new z_stream)
+{
+    _strm->zalloc   = nullptr;
+    _strm->zfree    = nullptr;
+    _strm->opaque   = nullptr;
+    _strm->avail_in = 0;
+    _strm->next_in  = nullptr;
+
+    int ret = inflateInit2(_strm, 16+MAX_WBITS);
+    if (ret == Z_OK) {
+        _initialized = true;
+    } else {
+        qWarning() << "QGCZlibInflater: inflateInit2 failed:" << ret;
+        _failed = true;
+    }
+}
+
+QGCZlibInflater::~QGCZlibInflater()
 {
-    bool            success                 = true;
-    int             ret;
-    const int       cBuffer                 = 1024 * 5;
-    unsigned char   inputBuffer[cBuffer];
-    unsigned char   outputBuffer[cBuffer];
-    z_stream        strm;
+    if (_initialized) {
+        inflateEnd(_strm);
+    }
+    delete _strm;
+}
+
+bool QGCZlibInflater::inflate(const QByteArray& gzippedData, QByteArray& decompressedData)
+{
+    if (_failed) {
+        return false;
+    }
+    if (_finished) {
+        return true;
+    }
+
+    _strm->avail_in = static_cast<unsigned>(gzippedData.size());
+    _strm->next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(gzippedData.constData()));
+
+    // Keep going until zlib has taken all of the input and has no more output pending
+    do {
+        int cBytesBefore = decompressedData.size();
+        decompressedData.resize(cBytesBefore + _cOutputChunk);
+
+        _strm->avail_out    = _cOutputChunk;
+        _strm->next_out     = reinterpret_cast<Bytef*>(decompressedData.data() + cBytesBefore);
+
+        int ret = ::inflate(_strm, Z_NO_FLUSH);
+        decompressedData.resize(cBytesBefore + _cOutputChunk - static_cast<int>(_strm->avail_out));
+        if (ret == Z_STREAM_END) {
+            _finished = true;
+            break;
+        }
+        if (ret == Z_BUF_ERROR) {
+            // No progress possible until more input shows up
+            break;
+        }
+        if (ret != Z_OK) {
+            qWarning() << "QGCZlibInflater: inflate failed:" << ret;
+            _failed = true;
+            return false;
+        }
+    } while (_strm->avail_in != 0 || _strm->avail_out == 0);
+
+    _strm->next_in = nullptr;
+    return true;
+}
 
+bool QGCZlib::inflateGzipFile(const QString& gzippedFileName, const QString& decompressedFilename)
+{
     QFile inputFile(gzippedFileName);
     if (!inputFile.open(QIODevice::ReadOnly)) {
         qWarning() << "QGCZlib::inflateGzipFile: open input file failed" << gzippedFileName << inputFile.errorString();
@@ -36,50 +96,48 @@ bool QGCZlib::inflateGzipFile(const QString& gzippedFileName, const QString& dec
         return false;
     }
 
-    strm.zalloc     = nullptr;
-    strm.zfree      = nullptr;
-    strm.opaque     = nullptr;
-    strm.avail_in   = 0;
-    strm.next_in    = nullptr;
+    return inflateGzipDevice(inputFile, outputFile);
+}
+
+bool QGCZlib::inflateGzipData(const QByteArray& gzippedData, QByteArray& decompressedData)
+{
+    QGCZlibInflater inflater;
 
-    ret = inflateInit2(&strm, 16+MAX_WBITS);
-    if (ret != Z_OK) {
-        qWarning() << "QGCZlib::inflateGzipFile: inflateInit2 failed:" << ret;
-        goto Error;
+    decompressedData.clear();
+    // Json compresses well, so start with room for a few times the input
+    decompressedData.reserve(gzippedData.size() * 4);
+
+    if (!inflater.inflate(gzippedData, decompressedData) || !inflater.finished()) {
+        if (!inflater.failed()) {
+            qWarning() << "QGCZlib::inflateGzipData: truncated data";
+        }
+        decompressedData.clear();
+        return false;
     }
+    return true;
+}
 
-    do {
-        strm.avail_in = static_cast<unsigned>(inputFile.read((char*)inputBuffer, cBuffer));
-        if (strm.avail_in == 0) {
-            break;
+bool QGCZlib::inflateGzipDevice(QIODevice& input, QIODevice& output)
+{
+    const qint64    cInputChunk = 1024 * 16;
+    QGCZlibInflater inflater;
+    QByteArray      decompressedData;
+
+    while (!inflater.finished()) {
+        QByteArray gzippedData = input.read(cInputChunk);
+        if (gzippedData.isEmpty()) {
+            qWarning() << "QGCZlib::inflateGzipDevice: truncated data";
+            return false;
+        }
+
+        decompressedData.clear();
+        if (!inflater.inflate(gzippedData, decompressedData)) {
+            return false;
         }
-        strm.next_in = inputBuffer;
-
-        do {
-            strm.avail_out  = cBuffer;
-            strm.next_out   = outputBuffer;
-
-            ret = inflate(&strm, Z_NO_FLUSH);
-            if (ret != Z_OK && ret != Z_STREAM_END) {
-                qWarning() << "QGCZlib::inflateGzipFile: inflate failed:" << ret;
-                goto Error;
-            }
-
-            unsigned cBytesInflated = cBuffer - strm.avail_out;
-            qint64 cBytesWritten = outputFile.write((char*)outputBuffer, static_cast<int>(cBytesInflated));
-            if (cBytesWritten != cBytesInflated) {
-                qWarning() << "QGCZlib::inflateGzipFile: output file write failed:" << outputFile.fileName() << outputFile.errorString();
-                goto Error;
-
-            }
-        } while (strm.avail_out == 0);
-    } while (ret != Z_STREAM_END);
-
-Out:
-    inflateEnd(&strm);
-    return success;
-
-Error:
-    success = false;
-    goto Out;
+        if (output.write(decompressedData) != decompressedData.size()) {
+            qWarning() << "QGCZlib::inflateGzipDevice: output write failed:" << output.errorString();
+            return false;
+        }
+    }
+    return true;
 }
@@ -10,6 +10,35 @@
 #pragma once
 
 #include <QString>
+#include <QByteArray>
+
+class QIODevice;
+struct z_stream_s;
+
+/// Inflates a gzip stream handed over a piece at a time, for example as it comes in over the network
+class QGCZlibInflater
+{
+public:
+    QGCZlibInflater(void);
+    ~QGCZlibInflater();
+
+    /// Inflates the next piece of the gzip stream
+    ///     @param gzippedData          Next bytes of the stream, anything after the end of the stream is ignored
+    ///     @param[out] decompressedData Inflated bytes are appended to this
+    /// @return false: data is corrupt, the inflater can't be used any further
+    bool inflate(const QByteArray& gzippedData, QByteArray& decompressedData);
+
+    bool finished   (void) const { return _finished; }  ///< true: end of the gzip stream has been seen
+    bool failed     (void) const { return _failed; }
+
+private:
+    z_stream_s* _strm;
+    bool        _initialized = false;
+    bool        _finished = false;
+    bool        _failed = false;
+
+    static const int _cOutputChunk = 1024 * 16;
+};
 
 class QGCZlib
 {
@@ -18,4 +47,14 @@ public:
     ///     @param gzipFilename         Fully qualified path to gzip file
     ///     @param decompressedFilename Fully qualified path to for file to decompress to
     static bool inflateGzipFile(const QString& gzippedFileName, const QString& decompressedFilename);
+
+    /// Decompresses gzip data held in memory
+    ///     @param gzippedData          Contents of a gzip file
+    ///     @param[out] decompressedData Decompressed contents, only valid on success
+    static bool inflateGzipData(const QByteArray& gzippedData, QByteArray& decompressedData);
+
+    /// Decompresses gzip data a chunk at a time from one open device to another
+    ///     @param input    Open for reading, read until the end of the gzip stream
+    ///     @param output   Open for writing
+    static bool inflateGzipDevice(QIODevice& input, QIODevice& output);
 };
@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "AppLogSink.h"
+
+#include <QGlobalStatic>
+#include <QMutexLocker>
+
+Q_GLOBAL_STATIC(AppLogSink, log_sink)
+
+void AppLogSinkWriter::open(const QString& fileName)
+{
+    _file.close();
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        _sink->_open.store(false, std::memory_order_relaxed);
+        emit openFailed(fileName, _file.errorString());
+    }
+}
+
+void AppLogSinkWriter::flush(void)
+{
+    const QStringList lines = _sink->_takePending();
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    for (const QString& line: lines) {
+        _file.write(line.toUtf8());
+        _file.write("\n", 1);
+        if (_file.size() >= AppLogSink::maxFileBytes) {
+            _rotate();
+        }
+    }
+    _file.flush();
+}
+
+void AppLogSinkWriter::close(void)
+{
+    flush();
+    _file.close();
+}
+
+void AppLogSinkWriter::_rotate(void)
+{
+    const QString fileName  = _file.fileName();
+    const QString oldName   = fileName + QStringLiteral(".1");
+
+    _file.close();
+    QFile::remove(oldName);
+    QFile::rename(fileName, oldName);
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        _sink->_open.store(false, std::memory_order_relaxed);
+        emit openFailed(fileName, _file.errorString());
+    }
+}
+
+AppLogSink::AppLogSink(void)
+{
+    _rateTimer.start();
+
+    _writer = new AppLogSinkWriter(this);
+    _writer->moveToThread(&_writerThread);
+    connect(&_writerThread, &QThread::finished,         _writer,    &QObject::deleteLater);
+    connect(_writer,        &AppLogSinkWriter::openFailed, this,    &AppLogSink::openFailed);
+    _writerThread.setObjectName(QStringLiteral("AppLogSink"));
+    _writerThread.start(QThread::LowPriority);
+}
+
+AppLogSink::~AppLogSink()
+{
+    if (_writerThread.isRunning()) {
+        QMetaObject::invokeMethod(_writer, "close", Qt::BlockingQueuedConnection);
+        _writerThread.quit();
+        _writerThread.wait();
+    }
+}
+
+AppLogSink* AppLogSink::instance(void)
+{
+    return log_sink;
+}
+
+bool AppLogSink::rateLimit(QtMsgType type, const char* category, int& droppedCount)
+{
+    droppedCount = 0;
+    if (type != QtDebugMsg && type != QtInfoMsg) {
+        return true;
+    }
+    if (!category) {
+        category = "default";
+    }
+
+    const qint64    nowMsecs = _rateTimer.elapsed();
+    QMutexLocker    locker(&_rateMutex);
+
+    auto bucketIter = _buckets.find(QByteArray::fromRawData(category, static_cast<int>(qstrlen(category))));
+    if (bucketIter == _buckets.end()) {
+        // Only this insert makes a deep copy of the name
+        bucketIter = _buckets.insert(QByteArray(category), { nowMsecs, 0, 0 });
+    }
+
+    Bucket_t& bucket = bucketIter.value();
+    if (nowMsecs - bucket.windowStartMsecs >= 1000) {
+        bucket.windowStartMsecs = nowMsecs;
+        bucket.count            = 0;
+    }
+    if (bucket.count >= maxLinesPerSecond) {
+        bucket.droppedCount++;
+        return false;
+    }
+
+    bucket.count++;
+    droppedCount        = bucket.droppedCount;
+    bucket.droppedCount = 0;
+    return true;
+}
+
+void AppLogSink::write(const QString& line)
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    QMutexLocker locker(&_pendingMutex);
+    _pending.append(line);
+    if (!_flushPosted) {
+        // Everything logged until the writer gets to it goes out in the same batch
+        _flushPosted = true;
+        QMetaObject::invokeMethod(_writer, "flush", Qt::QueuedConnection);
+    }
+}
+
+void AppLogSink::open(const QString& fileName)
+{
+    _open.store(true, std::memory_order_relaxed);
+    QMetaObject::invokeMethod(_writer, "open", Qt::QueuedConnection, Q_ARG(QString, fileName));
+}
+
+QStringList AppLogSink::_takePending(void)
+{
+    QMutexLocker locker(&_pendingMutex);
+
+    QStringList lines;
+    lines.swap(_pending);
+    _flushPosted = false;
+    return lines;
+}
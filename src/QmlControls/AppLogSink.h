@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+
+#include <atomic>
+
+// Nothing in here may log through qDebug and friends, it runs inside the message handler
+
+class AppLogSink;
+
+/// Writes the console log file, lives on the AppLogSink writer thread
+class AppLogSinkWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    AppLogSinkWriter(AppLogSink* sink) : _sink(sink) { }
+
+public slots:
+    void open   (const QString& fileName);
+    void flush  (void);
+    void close  (void);
+
+signals:
+    void openFailed(const QString& fileName, const QString& errorString);
+
+private:
+    void _rotate(void);
+
+    AppLogSink* _sink;
+    QFile       _file;
+};
+
+/// Keeps console output from changing the timing of the code which logs it.
+///
+/// Lines are handed to a writer thread in batches, so the thread which logged only pays for a string append under a
+/// lock. The log file is a two file ring: once it reaches maxFileBytes it moves to <name>.1 and a new one is started,
+/// so a long session with diagnostics turned on can't fill the disk. Debug and info output is also rate limited per
+/// category, a category logging per sample gets its first maxLinesPerSecond lines each second and a count of the
+/// rest. Warnings and worse always get through.
+class AppLogSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    AppLogSink(void);
+    ~AppLogSink();
+
+    static AppLogSink* instance(void);
+
+    /// Called for each message before it goes anywhere
+    ///     @param[out] droppedCount Lines of the category dropped since the last one let through
+    /// @return false: category is over its rate, drop the message
+    bool rateLimit(QtMsgType type, const char* category, int& droppedCount);
+
+    /// Queues a line for the log file, safe to call from any thread. Lines are dropped while no file is open.
+    void write(const QString& line);
+
+    void open   (const QString& fileName);
+    bool isOpen (void) const { return _open.load(std::memory_order_relaxed); }
+
+    static const int    maxLinesPerSecond   = 100;
+    static const qint64 maxFileBytes        = 16 * 1024 * 1024;
+
+signals:
+    void openFailed(const QString& fileName, const QString& errorString);
+
+private:
+    typedef struct {
+        qint64  windowStartMsecs;
+        int     count;          ///< Lines let through in the current window
+        int     droppedCount;   ///< Lines dropped since the last one let through
+    } Bucket_t;
+
+    QStringList _takePending(void);
+
+    QMutex                      _rateMutex;
+    QHash<QByteArray, Bucket_t> _buckets;
+    QElapsedTimer               _rateTimer;
+
+    QMutex                      _pendingMutex;
+    QStringList                 _pending;
+    bool                        _flushPosted    = false;
+    std::atomic<bool>           _open           { false };
+
+    QThread                     _writerThread;
+    AppLogSinkWriter*           _writer         = nullptr;
+
+    friend class AppLogSinkWriter;
+};
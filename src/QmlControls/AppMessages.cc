@@ -13,6 +13,7 @@
 #define _LOG_CTOR_ACCESS_ public
 
 #include "AppMessages.h"
+#include "AppLogSink.h"
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "AppSettings.h"
@@ -27,12 +28,25 @@ static QtMessageHandler old_handler;
 
 static void msgHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
+    // A category logging per sample would otherwise flood the console view and the log file
+    AppLogSink* logSink         = AppLogSink::instance();
+    int         droppedCount    = 0;
+    if (!logSink->rateLimit(type, context.category, droppedCount)) {
+        return;
+    }
+
     const char symbols[] = { 'D', 'E', '!', 'X', 'I' };
     QString output = QString("[%1] at %2:%3 - \"%4\"").arg(symbols[type]).arg(context.file).arg(context.line).arg(msg);
 
     // Avoid recursion
     if (!QString(context.category).startsWith("qt.quick")) {
+        if (droppedCount) {
+            const QString dropped = QString("[I] %1 lines of %2 dropped, over %3 a second").arg(droppedCount).arg(context.category).arg(AppLogSink::maxLinesPerSecond);
+            debug_model->log(dropped);
+            logSink->write(dropped);
+        }
         debug_model->log(output);
+        logSink->write(output);
     }
 
     if (old_handler != nullptr) {
@@ -62,6 +76,9 @@ AppLogModel::AppLogModel() : QStringListModel()
     Qt::ConnectionType contype = Qt::AutoConnection;
 #endif
     connect(this, &AppLogModel::emitLog, this, &AppLogModel::threadsafeLog, contype);
+    connect(AppLogSink::instance(), &AppLogSink::openFailed, this, [](const QString& fileName, const QString& errorString) {
+        qgcApp()->showAppMessage(tr("Open console log output file failed %1 : %2").arg(fileName).arg(errorString));
+    });
 }
 
 void AppLogModel::writeMessages(const QString dest_file)
@@ -94,25 +111,16 @@ void AppLogModel::threadsafeLog(const QString message)
     insertRows(line, 1);
     setData(index(line), message, Qt::DisplayRole);
 
-    if (qgcApp() && qgcApp()->logOutput() && _logFile.fileName().isEmpty()) {
-        qDebug() << _logFile.fileName().isEmpty() << qgcApp()->logOutput();
+    // The file itself is written by AppLogSink, which starts taking lines once it is open
+    if (qgcApp() && qgcApp()->logOutput() && !_logFileOpened) {
         QGCToolbox* toolbox = qgcApp()->toolbox();
         // Be careful of toolbox not being open yet
         if (toolbox) {
             QString saveDirPath = qgcApp()->toolbox()->settingsManager()->appSettings()->crashSavePath();
             QDir saveDir(saveDirPath);
-            QString saveFilePath = saveDir.absoluteFilePath(QStringLiteral("QGCConsole.log"));
 
-            _logFile.setFileName(saveFilePath);
-            if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                qgcApp()->showAppMessage(tr("Open console log output file failed %1 : %2").arg(_logFile.fileName()).arg(_logFile.errorString()));
-            }
+            AppLogSink::instance()->open(saveDir.absoluteFilePath(QStringLiteral("QGCConsole.log")));
+            _logFileOpened = true;
         }
     }
-
-    if (_logFile.isOpen()) {
-        QTextStream out(&_logFile);
-        out << message << "\n";
-        _logFile.flush();
-    }
 }
@@ -36,7 +36,7 @@ private slots:
     void threadsafeLog(const QString message);
 
 private:
-    QFile _logFile;
+    bool _logFileOpened = false;
 
 _LOG_CTOR_ACCESS_:
     AppLogModel();
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "FlightPathSegment.h"
+#include "TerrainCollisionEngine.h"
 #include "QGC.h"
 
 QGC_LOGGING_CATEGORY(FlightPathSegmentLog, "FlightPathSegmentLog")
@@ -20,14 +21,20 @@ FlightPathSegment::FlightPathSegment(const QGeoCoordinate& coord1, double amslCo
     , _coord2AMSLAlt     (amslCoord2Alt)
     , _queryTerrainData (queryTerrainData)
 {
-    _delayedTerrainPathQueryTimer.setSingleShot(true);
-    _delayedTerrainPathQueryTimer.setInterval(200);
-    _delayedTerrainPathQueryTimer.callOnTimeout(this, &FlightPathSegment::_sendTerrainPathQuery);
     _updateTotalDistance();
 
     qCDebug(FlightPathSegmentLog) << this << "new" << coord1 << coord2 << amslCoord1Alt << amslCoord2Alt << _totalDistance;
 
-    _sendTerrainPathQuery();
+    if (_queryTerrainData) {
+        TerrainCollisionEngine::instance()->segmentChanged(this);
+    }
+}
+
+FlightPathSegment::~FlightPathSegment()
+{
+    if (_queryTerrainData) {
+        TerrainCollisionEngine::instance()->removeSegment(this);
+    }
 }
 
 void FlightPathSegment::setCoordinate1(const QGeoCoordinate &coordinate)
@@ -35,8 +42,10 @@ void FlightPathSegment::setCoordinate1(const QGeoCoordinate &coordinate)
     if (_coord1 != coordinate) {
         _coord1 = coordinate;
         emit coordinate1Changed(_coord1);
-        _delayedTerrainPathQueryTimer.start();
         _updateTotalDistance();
+        if (_queryTerrainData) {
+            TerrainCollisionEngine::instance()->segmentChanged(this);
+        }
     }
 }
 
@@ -45,8 +54,10 @@ void FlightPathSegment::setCoordinate2(const QGeoCoordinate &coordinate)
     if (_coord2 != coordinate) {
         _coord2 = coordinate;
         emit coordinate2Changed(_coord2);
-        _delayedTerrainPathQueryTimer.start();
         _updateTotalDistance();
+        if (_queryTerrainData) {
+            TerrainCollisionEngine::instance()->segmentChanged(this);
+        }
     }
 }
 
@@ -76,54 +87,24 @@ void FlightPathSegment::setSpecialVisual(bool specialVisual)
     }
 }
 
-void FlightPathSegment::_sendTerrainPathQuery(void)
+void FlightPathSegment::_setTerrainProfile(double distanceBetween, double finalDistanceBetween, const QVariantList& amslTerrainHeights)
 {
-    if (_queryTerrainData && _coord1.isValid() && _coord2.isValid()) {
-        qCDebug(FlightPathSegmentLog) << this << "_sendTerrainPathQuery";
-        // Clear any previous query
-        if (_currentTerrainPathQuery) {
-            // We are already waiting on another query. We don't care about those results any more.
-            disconnect(_currentTerrainPathQuery, &TerrainPathQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
-            _currentTerrainPathQuery = nullptr;
-        }
+    qCDebug(FlightPathSegmentLog) << this << "_setTerrainProfile" << amslTerrainHeights.count();
 
-        // Clear old terrain data
-        _amslTerrainHeights.clear();
-        _distanceBetween = 0;
-        _finalDistanceBetween = 0;
-        emit distanceBetweenChanged(0);
-        emit finalDistanceBetweenChanged(0);
-        emit amslTerrainHeightsChanged();
-
-        _currentTerrainPathQuery = new TerrainPathQuery(true /* autoDelete */);
-        connect(_currentTerrainPathQuery, &TerrainPathQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
-        _currentTerrainPathQuery->requestData(_coord1, _coord2);
+    if (!QGC::fuzzyCompare(distanceBetween, _distanceBetween)) {
+        _distanceBetween = distanceBetween;
+        emit distanceBetweenChanged(_distanceBetween);
+    }
+    if (!QGC::fuzzyCompare(finalDistanceBetween, _finalDistanceBetween)) {
+        _finalDistanceBetween = finalDistanceBetween;
+        emit finalDistanceBetweenChanged(_finalDistanceBetween);
     }
-}
-
-void FlightPathSegment::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
-{
-    qCDebug(FlightPathSegmentLog) << this << "_terrainDataReceived" << success << pathHeightInfo.heights.count();
-    if (success) {
-        if (!QGC::fuzzyCompare(pathHeightInfo.distanceBetween, _distanceBetween)) {
-            _distanceBetween = pathHeightInfo.distanceBetween;
-            emit distanceBetweenChanged(_distanceBetween);
-        }
-        if (!QGC::fuzzyCompare(pathHeightInfo.finalDistanceBetween, _finalDistanceBetween)) {
-            _finalDistanceBetween = pathHeightInfo.finalDistanceBetween;
-            emit finalDistanceBetweenChanged(_finalDistanceBetween);
-        }
 
-        _amslTerrainHeights.clear();
-        for (const double& amslTerrainHeight: pathHeightInfo.heights) {
-            _amslTerrainHeights.append(amslTerrainHeight);
-        }
+    if (!amslTerrainHeights.isEmpty() || !_amslTerrainHeights.isEmpty()) {
+        _amslTerrainHeights = amslTerrainHeights;
         emit amslTerrainHeightsChanged();
     }
 
-    _currentTerrainPathQuery->deleteLater();
-    _currentTerrainPathQuery = nullptr;
-
     _updateTerrainCollision();
 }
 
@@ -167,3 +148,27 @@ void FlightPathSegment::_updateTerrainCollision(void)
         emit terrainCollisionChanged(_terrainCollision);
     }
 }
+
+double FlightPathSegment::minTerrainClearance(bool includeCoord2) const
+{
+    if (_amslTerrainHeights.isEmpty() || qFuzzyIsNull(_totalDistance)) {
+        return qQNaN();
+    }
+
+    double  slope           = (_coord2AMSLAlt - _coord1AMSLAlt) / _totalDistance;
+    int     sampleCount     = _amslTerrainHeights.count() - (includeCoord2 ? 0 : 1);
+    double  minClearance    = qQNaN();
+    double  x               = 0;
+    for (int i=0; i<sampleCount; i++) {
+        double clearance = (slope * x) + _coord1AMSLAlt - _amslTerrainHeights[i].value<double>();
+        if (qIsNaN(minClearance) || clearance < minClearance) {
+            minClearance = clearance;
+        }
+        if (i == _amslTerrainHeights.count() - 2) {
+            x += _finalDistanceBetween;
+        } else {
+            x += _distanceBetween;
+        }
+    }
+    return minClearance;
+}
@@ -11,9 +11,8 @@
 
 #include <QObject>
 #include <QGeoCoordinate>
-#include <QTimer>
+#include <QVariantList>
 
-#include "TerrainQuery.h"
 #include "QGCLoggingCategory.h"
 
 Q_DECLARE_LOGGING_CATEGORY(FlightPathSegmentLog)
@@ -22,9 +21,12 @@ Q_DECLARE_LOGGING_CATEGORY(FlightPathSegmentLog)
 class FlightPathSegment : public QObject
 {
     Q_OBJECT
-    
+
+    friend class TerrainCollisionEngine;
+
 public:
     FlightPathSegment(const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt, bool queryTerrainData, QObject* parent);
+    ~FlightPathSegment();
 
     Q_PROPERTY(QGeoCoordinate   coordinate1             MEMBER _coord1                                          NOTIFY coordinate1Changed)
     Q_PROPERTY(QGeoCoordinate   coordinate2             MEMBER _coord2                                          NOTIFY coordinate2Changed)
@@ -50,6 +52,11 @@ public:
 
     void setSpecialVisual(bool specialVisual);
 
+    /// Lowest height of the segment above the terrain profile, worked out from the profile already in hand
+    ///     @param includeCoord2 false: leave out the terrain sample at coordinate2, for example a touchdown point
+    ///     @return NaN if there is no terrain profile yet
+    double minTerrainClearance(bool includeCoord2) const;
+
 public slots:
     void setCoordinate1     (const QGeoCoordinate& coordinate);
     void setCoordinate2     (const QGeoCoordinate& coordinate);
@@ -69,12 +76,13 @@ signals:
     void terrainCollisionChanged    (bool terrainCollision);
 
 private slots:
-    void _sendTerrainPathQuery      (void);
-    void _terrainDataReceived       (bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo);
     void _updateTotalDistance       (void);
     void _updateTerrainCollision    (void);
 
 private:
+    /// Called by TerrainCollisionEngine with the terrain profile for the current coordinates
+    void _setTerrainProfile(double distanceBetween, double finalDistanceBetween, const QVariantList& amslTerrainHeights);
+
     QGeoCoordinate      _coord1;
     QGeoCoordinate      _coord2;
     double              _coord1AMSLAlt =                qQNaN();
@@ -82,8 +90,6 @@ private:
     bool                _queryTerrainData;
     bool                _terrainCollision =             false;
     bool                _specialVisual =                false;
-    QTimer              _delayedTerrainPathQueryTimer;
-    TerrainPathQuery*   _currentTerrainPathQuery =      nullptr;
     QVariantList        _amslTerrainHeights;
     double              _distanceBetween =              0;
     double              _finalDistanceBetween =         0;
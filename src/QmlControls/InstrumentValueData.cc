@@ -33,6 +33,7 @@ InstrumentValueData::InstrumentValueData(FactValueGrid* factValueGrid, QObject*
     _activeVehicleChanged(multiVehicleManager->activeVehicle());
 
     connect(this, &InstrumentValueData::rangeTypeChanged,       this, &InstrumentValueData::_resetRangeInfo);
+    connect(this, &InstrumentValueData::rangeTypeChanged,       this, &InstrumentValueData::_updateFactConnection);
     connect(this, &InstrumentValueData::rangeTypeChanged,       this, &InstrumentValueData::_updateRanges);
     connect(this, &InstrumentValueData::rangeValuesChanged,     this, &InstrumentValueData::_updateRanges);
     connect(this, &InstrumentValueData::rangeColorsChanged,     this, &InstrumentValueData::_updateRanges);
@@ -42,18 +43,22 @@ InstrumentValueData::InstrumentValueData(FactValueGrid* factValueGrid, QObject*
 
 void InstrumentValueData::_activeVehicleChanged(Vehicle* activeVehicle)
 {
-    if (_activeVehicle) {
-        disconnect(_activeVehicle, &Vehicle::factGroupNamesChanged, this, &InstrumentValueData::_lookForMissingFact);
-    }
-
     if (!activeVehicle) {
         activeVehicle = qgcApp()->toolbox()->multiVehicleManager()->offlineEditingVehicle();
     }
+    if (activeVehicle == _activeVehicle) {
+        return;
+    }
+
+    if (_activeVehicle) {
+        disconnect(_activeVehicle, &Vehicle::factGroupNamesChanged, this, &InstrumentValueData::_lookForMissingFact);
+    }
 
     _activeVehicle = activeVehicle;
     connect(_activeVehicle, &Vehicle::factGroupNamesChanged, this, &InstrumentValueData::_lookForMissingFact);
 
     emit factGroupNamesChanged();
+    emit factValueNamesChanged();
 
     if (!_factGroupName.isEmpty() && !_factName.isEmpty()) {
         _setFactWorker();
@@ -71,62 +76,101 @@ void InstrumentValueData::_lookForMissingFact(void)
 
 void InstrumentValueData::clearFact(void)
 {
-    _fact = nullptr;
-    _factName.clear();
-    _text.clear();
-    _icon.clear();
-    _showUnits = true;
-
-    emit factValueNamesChanged  ();
-    emit factChanged            (_fact);
-    emit factNameChanged        (_factName);
-    emit factGroupNameChanged   (_factGroupName);
-    emit textChanged            (_text);
-    emit iconChanged            (_icon);
-    emit showUnitsChanged       (_showUnits);
+    _factCache.clear();
+    _setFactPointer(nullptr);
+    _setFactName(QString());
+    setText(QString());
+    setIcon(QString());
+    setShowUnits(true);
+
+    emit factValueNamesChanged();
 }
 
 void InstrumentValueData::_setFactWorker(void)
 {
-    if (_fact) {
-        disconnect(_fact, &Fact::rawValueChanged, this, &InstrumentValueData::_updateRanges);
-        _fact = nullptr;
-    }
-
-    FactGroup* factGroup = nullptr;
-    if (_factGroupName == vehicleFactGroupName) {
-        factGroup = _activeVehicle;
-    } else {
-        factGroup = _activeVehicle->getFactGroup(_factGroupName);
-    }
-
-    QString nonEmptyFactName;
-    if (factGroup) {
-        if (_factName.isEmpty()) {
-            nonEmptyFactName = factValueNames()[0];
+    // Switching back and forth between vehicles reuses what was found before, the fact group and fact name lookups
+    // only happen the first time a vehicle is seen
+    Fact* fact = _factCache.value(_activeVehicle);
+
+    if (!fact) {
+        FactGroup* factGroup = nullptr;
+        if (_factGroupName == vehicleFactGroupName) {
+            factGroup = _activeVehicle;
         } else {
-            nonEmptyFactName = _factName;
+            factGroup = _activeVehicle->getFactGroup(_factGroupName);
+        }
+
+        if (factGroup) {
+            QString nonEmptyFactName = _factName;
+            if (nonEmptyFactName.isEmpty()) {
+                QStringList valueNames = factValueNames();
+                if (!valueNames.isEmpty()) {
+                    nonEmptyFactName = valueNames[0];
+                }
+            }
+            fact = factGroup->getFact(nonEmptyFactName);
+            if (fact) {
+                _setFactName(nonEmptyFactName);
+                _factCache[_activeVehicle] = fact;
+            }
         }
-        _fact = factGroup->getFact(nonEmptyFactName);
     }
 
+    _setFactPointer(fact);
+}
+
+void InstrumentValueData::_setFactPointer(Fact* fact)
+{
+    if (fact == _fact) {
+        return;
+    }
     if (_fact) {
-        _factName = nonEmptyFactName;
-        connect(_fact, &Fact::rawValueChanged, this, &InstrumentValueData::_updateRanges);
+        disconnect(_fact, &Fact::valueChanged, this, &InstrumentValueData::_factValueChanged);
     }
+    _fact = fact;
+    _updateFactConnection();
+    emit factChanged(_fact);
+    _updateRanges();
+}
 
-    emit factValueNamesChanged  ();
-    emit factChanged            (_fact);
-    emit factNameChanged        (_factName);
-    emit factGroupNameChanged   (_factGroupName);
+void InstrumentValueData::_setFactName(const QString& factName)
+{
+    if (factName != _factName) {
+        _factName = factName;
+        emit factNameChanged(_factName);
+    }
+}
 
-    _updateRanges();
+/// Only follows value changes while there are ranges to evaluate. valueChanged is used instead of rawValueChanged so
+/// ranges are evaluated at the display rate of the fact group, not the telemetry rate.
+void InstrumentValueData::_updateFactConnection(void)
+{
+    if (!_fact) {
+        return;
+    }
+    if (_rangeType == NoRangeInfo) {
+        disconnect(_fact, &Fact::valueChanged, this, &InstrumentValueData::_factValueChanged);
+    } else {
+        connect(_fact, &Fact::valueChanged, this, &InstrumentValueData::_factValueChanged, Qt::UniqueConnection);
+    }
 }
+
 void InstrumentValueData::setFact(const QString& factGroupName, const QString& factName)
 {
-    _factGroupName  = factGroupName;
-    _factName       = factName;
+    if (factGroupName == _factGroupName && factName == _factName && _fact) {
+        return;
+    }
+
+    _factCache.clear();
+    if (factGroupName != _factGroupName) {
+        _factGroupName = factGroupName;
+        emit factGroupNameChanged(_factGroupName);
+        emit factValueNamesChanged();
+    }
+    _setFactName(factName);
 
+    // The name changed so the fact we had is no longer the right one
+    _setFactPointer(nullptr);
     _setFactWorker();
 }
 
@@ -272,19 +316,40 @@ void InstrumentValueData::removeRangeValue(int index)
 
 void InstrumentValueData::_updateRanges(void)
 {
+    // Range setup changed, so the current range has to be found again
+    _rangeIndex = -1;
+    if (_rangeType != NoRangeInfo && _fact) {
+        _rangeIndex = _currentRangeIndex(_fact->rawValue());
+        _rangeLow   = _rangeIndex == 0                      ? -qInf() : _rangeValues[_rangeIndex - 1].toDouble();
+        _rangeHigh  = _rangeIndex == _rangeValues.count()   ? qInf()  : _rangeValues[_rangeIndex].toDouble();
+    }
+
     _updateColor();
     _updateIcon();
     _updateOpacity();
 }
 
+void InstrumentValueData::_factValueChanged(void)
+{
+    // Most value changes stay within the same range and there is nothing to do
+    double value = _fact->rawValue().toDouble();
+    if (_rangeIndex != -1 && value > _rangeLow && value <= _rangeHigh) {
+        return;
+    }
+    if (_rangeIndex == 0 && qIsNaN(value)) {
+        return;
+    }
+    _updateRanges();
+}
+
 void InstrumentValueData::_updateColor(void)
 {
     QColor newColor;
 
     int rangeIndex = -1;
 
-    if (_rangeType == ColorRange && _fact) {
-        rangeIndex =_currentRangeIndex(_fact->rawValue().toDouble());
+    if (_rangeType == ColorRange && _rangeIndex < _rangeColors.count()) {
+        rangeIndex = _rangeIndex;
     }
     if (rangeIndex != -1) {
         newColor = _rangeColors[rangeIndex].value<QColor>();
@@ -302,8 +367,8 @@ void InstrumentValueData::_updateOpacity(void)
 
     int rangeIndex = -1;
 
-    if (_rangeType == OpacityRange && _fact) {
-        rangeIndex =_currentRangeIndex(_fact->rawValue().toDouble());
+    if (_rangeType == OpacityRange && _rangeIndex < _rangeOpacities.count()) {
+        rangeIndex = _rangeIndex;
     }
     if (rangeIndex != -1) {
         newOpacity = _rangeOpacities[rangeIndex].toDouble();
@@ -321,8 +386,8 @@ void InstrumentValueData::_updateIcon(void)
 
     int rangeIndex = -1;
 
-    if (_rangeType == IconSelectRange && _fact) {
-        rangeIndex =_currentRangeIndex(_fact->rawValue().toDouble());
+    if (_rangeType == IconSelectRange && _rangeIndex < _rangeIcons.count()) {
+        rangeIndex = _rangeIndex;
     }
     if (rangeIndex != -1) {
         newIcon = _rangeIcons[rangeIndex].toString();
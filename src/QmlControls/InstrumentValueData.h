@@ -14,6 +14,8 @@
 #include "QGCApplication.h"
 
 #include <QObject>
+#include <QHash>
+#include <QPointer>
 
 class FactValueGrid;
 
@@ -104,6 +106,7 @@ signals:
 private slots:
     void _resetRangeInfo        (void);
     void _updateRanges          (void);
+    void _factValueChanged      (void);
     void _activeVehicleChanged  (Vehicle* activeVehicle);
     void _lookForMissingFact    (void);
 
@@ -113,11 +116,15 @@ private:
     void _updateIcon            (void);
     void _updateOpacity         (void);
     void _setFactWorker         (void);
+    void _setFactPointer        (Fact* fact);
+    void _setFactName           (const QString& factName);
+    void _updateFactConnection  (void);
 
     FactValueGrid*          _factValueGrid =        nullptr;
     Vehicle*                _activeVehicle =        nullptr;
     QmlObjectListModel*     _rowModel =             nullptr;
     Fact*                   _fact =                 nullptr;
+    QHash<Vehicle*, QPointer<Fact>> _factCache;                 ///< Fact resolved for each vehicle, cleared when the fact name changes
     QString                 _factName;
     QString                 _factGroupName;
     QString                 _text;
@@ -140,6 +147,9 @@ private:
     QVariantList        _rangeColors;                       ///< QColor
     QVariantList        _rangeIcons;                        ///< QString resource name
     QVariantList        _rangeOpacities;                    /// double opacity value
+    int                 _rangeIndex =       -1;             ///< Range the fact value is in, -1: none
+    double              _rangeLow =         0;              ///< Value is in the current range while > _rangeLow and <= _rangeHigh
+    double              _rangeHigh =        0;
 
     // These are user facing string for the various enums.
     static const QStringList _rangeTypeNames;
@@ -48,6 +48,14 @@ ChartView {
         }
     }
 
+    //-- Series are reduced to about one bucket per pixel of the plot
+    Binding {
+        target:                     chartController
+        property:                   "chartWidth"
+        value:                      Math.round(chartView.plotArea.width)
+        when:                       chartController !== null
+    }
+
     DateTimeAxis {
         id:                         axisX
         min:                        chartController ? chartController.rangeXMin : new Date()
@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ObstacleOverlay.h"
+
+#include <QSGVertexColorMaterial>
+#include <QSGGeometryNode>
+
+ObstacleOverlay::ObstacleOverlay(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    connect(this, &ObstacleOverlay::colorChanged,   this, &QQuickItem::update);
+    connect(this, &ObstacleOverlay::dotSizeChanged, this, &QQuickItem::update);
+    connect(this, &QQuickItem::widthChanged,        this, &QQuickItem::update);
+    connect(this, &QQuickItem::heightChanged,       this, &QQuickItem::update);
+}
+
+void ObstacleOverlay::setObjectAvoidance(VehicleObjectAvoidance* objectAvoidance)
+{
+    if (objectAvoidance == _objectAvoidance) {
+        return;
+    }
+
+    disconnect(_gridConnection);
+    _objectAvoidance = objectAvoidance;
+    if (_objectAvoidance) {
+        _gridConnection = connect(_objectAvoidance, &VehicleObjectAvoidance::gridChanged, this, &QQuickItem::update);
+    }
+    emit objectAvoidanceChanged();
+    update();
+}
+
+QSGNode* ObstacleOverlay::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+
+        node = new QSGGeometryNode;
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setFlag(QSGNode::OwnsMaterial);
+        node->setGeometry(geometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+    }
+
+    static const QVector<float> empty;
+    const QVector<float>&   packed  = _objectAvoidance ? _objectAvoidance->packedGrid() : empty;
+    const int               stride  = VehicleObjectAvoidance::packedStride;
+
+    int objectCount = 0;
+    for (int i = 0; i < packed.count(); i += stride) {
+        if (packed[i + 2] >= 0) {
+            objectCount++;
+        }
+    }
+
+    // Two triangles per object
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate(objectCount * 6);
+    QSGGeometry::ColoredPoint2D* vertices = geometry->vertexDataAsColoredPoint2D();
+
+    const float cx      = static_cast<float>(width() / 2);
+    const float cy      = static_cast<float>(height() / 2);
+    const float radius  = static_cast<float>(qMin(width(), height()) / 2);
+    const float half    = static_cast<float>(_dotSize / 2);
+    for (int i = 0; i < packed.count(); i += stride) {
+        if (packed[i + 2] < 0) {
+            continue;
+        }
+        const float x = cx + (packed[i] * radius);
+        const float y = cy + (packed[i + 1] * radius);
+        // Older readings fade out, the material wants premultiplied alpha
+        const float     alpha   = static_cast<float>(_color.alphaF()) * qBound(0.0f, packed[i + 3], 1.0f);
+        const uchar     a       = static_cast<uchar>(alpha * 255);
+        const uchar     r       = static_cast<uchar>(_color.red() * alpha);
+        const uchar     g       = static_cast<uchar>(_color.green() * alpha);
+        const uchar     b       = static_cast<uchar>(_color.blue() * alpha);
+        vertices[0].set(x - half, y - half, r, g, b, a);
+        vertices[1].set(x + half, y - half, r, g, b, a);
+        vertices[2].set(x - half, y + half, r, g, b, a);
+        vertices[3].set(x + half, y - half, r, g, b, a);
+        vertices[4].set(x + half, y + half, r, g, b, a);
+        vertices[5].set(x - half, y + half, r, g, b, a);
+        vertices += 6;
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+
+    return node;
+}
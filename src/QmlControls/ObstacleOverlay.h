@@ -0,0 +1,49 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QQuickItem>
+#include <QColor>
+#include <QPointer>
+
+#include "VehicleObjectAvoidance.h"
+
+/// Draws the obstacles reported by VehicleObjectAvoidance as one scene graph node, a square per bin which has an
+/// object in it, faded by how old the reading is. The vehicle is at the center and maxDistance is at the edge of the
+/// item. Only the vertex buffer is rewritten when the histogram changes so a 20Hz proximity sensor doesn't repaint a
+/// Canvas.
+class ObstacleOverlay : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    ObstacleOverlay(QQuickItem* parent = nullptr);
+
+    Q_PROPERTY(VehicleObjectAvoidance*  objectAvoidance READ objectAvoidance    WRITE setObjectAvoidance    NOTIFY objectAvoidanceChanged)
+    Q_PROPERTY(QColor                   color           MEMBER _color                                       NOTIFY colorChanged)
+    Q_PROPERTY(double                   dotSize         MEMBER _dotSize                                     NOTIFY dotSizeChanged)  ///< Pixels
+
+    VehicleObjectAvoidance* objectAvoidance     (void) { return _objectAvoidance; }
+    void                    setObjectAvoidance  (VehicleObjectAvoidance* objectAvoidance);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) final;
+
+signals:
+    void objectAvoidanceChanged (void);
+    void colorChanged           (void);
+    void dotSizeChanged         (void);
+
+private:
+    QPointer<VehicleObjectAvoidance>    _objectAvoidance;
+    QMetaObject::Connection             _gridConnection;
+    QColor                              _color      = QColor(Qt::red);
+    double                              _dotSize    = 6;
+};
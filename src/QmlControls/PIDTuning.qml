@@ -9,13 +9,13 @@
 
 import QtQuick          2.3
 import QtQuick.Controls 1.2
-import QtCharts         2.2
 import QtQuick.Layouts  1.2
 
 import QGroundControl               1.0
 import QGroundControl.Controls      1.0
 import QGroundControl.FactSystem    1.0
 import QGroundControl.FactControls  1.0
+import QGroundControl.Palette       1.0
 import QGroundControl.ScreenTools   1.0
 
 RowLayout {
@@ -27,70 +27,30 @@ RowLayout {
     property real   _chartHeight:       ScreenTools.defaultFontPixelHeight * 20
     property real   _margins:           ScreenTools.defaultFontPixelHeight / 2
     property string _currentTuneType:   tuneList[0]
-    property real   _rollRate:          globals.activeVehicle.rollRate.value
-    property real   _rollRateSetpoint:  globals.activeVehicle.setpoint.rollRate.value
-    property real   _pitchRate:         globals.activeVehicle.pitchRate.value
-    property real   _pitchRateSetpoint: globals.activeVehicle.setpoint.pitchRate.value
-    property real   _yawRate:           globals.activeVehicle.yawRate.value
-    property real   _yawRateSetpoint:   globals.activeVehicle.setpoint.yawRate.value
-    property var    _valueRateXAxis:    valueRateXAxis
-    property var    _valueRateYAxis:    valueRateYAxis
-    property int    _msecs:             0
-    property double _last_t:            0
+    property int    _currentTuneIndex:  tuneList.indexOf(_currentTuneType)
     property var    _savedTuningParamValues:    [ ]
     property bool   _showCharts: !ScreenTools.isMobile // TODO: test and enable on mobile
+    property bool   _chartsRunning:     true
 
-    // The following are set when getValues is called
-    property real   _valueRate
-    property real   _valueRateSetpoint
+    // Charts are fed straight from the messages, so they keep up with the full rate the vehicle sends them at
+    property var    _rateFields:        [ "rollspeed", "pitchspeed", "yawspeed" ]                   // ATTITUDE_QUATERNION
+    property var    _setpointFields:    [ "body_roll_rate", "body_pitch_rate", "body_yaw_rate" ]    // ATTITUDE_TARGET
+    property real   _yMin:              Math.min(-_tickSeparation, Math.floor(Math.min(_finite(rateChart.dataMin), _finite(setpointChart.dataMin)) / _tickSeparation) * _tickSeparation)
+    property real   _yMax:              Math.max(_tickSeparation, Math.ceil(Math.max(_finite(rateChart.dataMax), _finite(setpointChart.dataMax)) / _tickSeparation) * _tickSeparation)
 
     readonly property int _tickSeparation:      5
-    readonly property int _maxTickSections:     10
     readonly property int _tuneListRollIndex:   0
     readonly property int _tuneListPitchIndex:  1
     readonly property int _tuneListYawIndex:    2
     readonly property int _chartDisplaySec:     3 // number of seconds to display
 
-    function adjustYAxisMin(yAxis, newValue) {
-        var newMin = Math.min(yAxis.min, newValue)
-        if (newMin % 5 != 0) {
-            newMin -= 5
-            newMin = Math.floor(newMin / _tickSeparation) * _tickSeparation
-        }
-        yAxis.min = newMin
-    }
-
-    function adjustYAxisMax(yAxis, newValue) {
-        var newMax = Math.max(yAxis.max, newValue)
-        if (newMax % 5 != 0) {
-            newMax += 5
-            newMax = Math.floor(newMax / _tickSeparation) * _tickSeparation
-        }
-        yAxis.max = newMax
-    }
-
-    function getValues() {
-        if (_currentTuneType === tuneList[_tuneListRollIndex]) {
-            _valueRate = _rollRate
-            _valueRateSetpoint = _rollRateSetpoint
-        } else if (_currentTuneType === tuneList[_tuneListPitchIndex]) {
-            _valueRate = _pitchRate
-            _valueRateSetpoint = _pitchRateSetpoint
-        } else if (_currentTuneType === tuneList[_tuneListYawIndex]) {
-            _valueRate = _yawRate
-            _valueRateSetpoint = _yawRateSetpoint
-        }
+    function _finite(value) {
+        return isNaN(value) ? 0 : value
     }
 
     function resetGraphs() {
-        valueRateSeries.removePoints(0, valueRateSeries.count)
-        valueRateSetpointSeries.removePoints(0, valueRateSetpointSeries.count)
-        _valueRateXAxis.min = 0
-        _valueRateXAxis.max = 0
-        _valueRateYAxis.min = 0
-        _valueRateYAxis.max = 10
-        _msecs = 0
-        _last_t = 0
+        rateChart.clear()
+        setpointChart.clear()
     }
 
     function currentTuneTypeIndex() {
@@ -138,55 +98,7 @@ RowLayout {
         resetGraphs()
     }
 
-    ValueAxis {
-        id:             valueRateXAxis
-        min:            0
-        max:            0
-        labelFormat:    "%.2f"
-        titleText:      "sec"
-        tickCount:      11
-    }
-
-    ValueAxis {
-        id:         valueRateYAxis
-        min:        0
-        max:        10
-        titleText:  "deg/s"
-        tickCount:  Math.min(((max - min) / _tickSeparation), _maxTickSections) + 1
-    }
-
-    Timer {
-        id:         dataTimer
-        interval:   10
-        running:    true
-        repeat:     true
-
-        onTriggered: {
-            _valueRateXAxis.max = _msecs / 1000
-            _valueRateXAxis.min = _msecs / 1000 - _chartDisplaySec
-
-            getValues()
-
-            if (!isNaN(_valueRate)) {
-                valueRateSeries.append(_msecs/1000, _valueRate)
-                adjustYAxisMin(_valueRateYAxis, _valueRate)
-                adjustYAxisMax(_valueRateYAxis, _valueRate)
-            }
-
-            if (!isNaN(_valueRateSetpoint)) {
-                valueRateSetpointSeries.append(_msecs/1000, _valueRateSetpoint)
-                adjustYAxisMin(_valueRateYAxis, _valueRateSetpoint)
-                adjustYAxisMax(_valueRateYAxis, _valueRateSetpoint)
-            }
-
-            var t = new Date().getTime() // in ms
-            if (_last_t > 0)
-                _msecs += t-_last_t
-            _last_t = t
-        }
-
-        property int _maxPointCount:    10000 / interval
-    }
+    QGCPalette { id: qgcPal; colorGroupEnabled: enabled }
 
     Column {
         spacing:            _margins
@@ -275,58 +187,83 @@ RowLayout {
         Layout.alignment:   Qt.AlignTop
         visible:            _showCharts
 
-        ChartView {
-            id:                 ratesChart
+        spacing:            _margins
+
+        QGCLabel {
+            anchors.horizontalCenter:   parent.horizontalCenter
+            text:                       _currentTuneType + qsTr(" Rate (deg/s, last %1 sec)").arg(_chartDisplaySec)
+        }
+
+        Rectangle {
+            id:                 chartFrame
             anchors.left:       parent.left
             anchors.right:      parent.right
             height:             availableHeight * 0.75
-            title:              _currentTuneType + qsTr(" Rate")
-            antialiasing:       true
-            legend.alignment:   Qt.AlignBottom
-
-            LineSeries {
-                id:         valueRateSeries
-                name:       "Response"
-                axisY:      valueRateYAxis
-                axisX:      valueRateXAxis
+            color:              qgcPal.windowShade
+            border.color:       qgcPal.text
+            clip:               true
+
+            // Zero line
+            Rectangle {
+                width:      parent.width
+                height:     1
+                y:          parent.height * _yMax / (_yMax - _yMin)
+                color:      qgcPal.text
+                opacity:    0.5
             }
 
-            LineSeries {
-                id:         valueRateSetpointSeries
-                name:       "Setpoint"
-                axisY:      valueRateYAxis
-                axisX:      valueRateXAxis
+            SensorStreamChart {
+                id:             setpointChart
+                anchors.fill:   parent
+                vehicle:        globals.activeVehicle
+                messageName:    "ATTITUDE_TARGET"
+                fieldName:      _setpointFields[_currentTuneIndex]
+                scale:          180 / Math.PI
+                timeSpan:       _chartDisplaySec
+                yMin:           _yMin
+                yMax:           _yMax
+                color:          qgcPal.colorGreen
+                running:        _chartsRunning
             }
 
-            // enable mouse dragging
-            MouseArea {
-                property var _startPoint: undefined
-                property double _scaling: 0
-                anchors.fill: parent
-                onPressed: {
-                    _startPoint = Qt.point(mouse.x, mouse.y)
-                    var start = ratesChart.mapToValue(_startPoint)
-                    var next = ratesChart.mapToValue(Qt.point(mouse.x+1, mouse.y+1))
-                    _scaling = next.x - start.x
-                }
-                onPositionChanged: {
-                    if(_startPoint != undefined) {
-                        dataTimer.running = false
-                        var cp = Qt.point(mouse.x, mouse.y)
-                        var dx = (cp.x - _startPoint.x) * _scaling
-                        _startPoint = cp
-                        _valueRateXAxis.max -= dx
-                        _valueRateXAxis.min -= dx
-                    }
-                }
+            SensorStreamChart {
+                id:             rateChart
+                anchors.fill:   parent
+                vehicle:        globals.activeVehicle
+                messageName:    "ATTITUDE_QUATERNION"
+                fieldName:      _rateFields[_currentTuneIndex]
+                scale:          180 / Math.PI
+                timeSpan:       _chartDisplaySec
+                yMin:           _yMin
+                yMax:           _yMax
+                color:          qgcPal.colorOrange
+                running:        _chartsRunning
+            }
 
-                onReleased: {
-                    _startPoint = undefined
-                }
+            QGCLabel {
+                anchors.margins:    _margins / 2
+                anchors.top:        parent.top
+                anchors.left:       parent.left
+                text:               _yMax
+            }
+
+            QGCLabel {
+                anchors.margins:    _margins / 2
+                anchors.bottom:     parent.bottom
+                anchors.left:       parent.left
+                text:               _yMin
             }
         }
 
-        Item { width: 1; height: 1 }
+        Row {
+            anchors.horizontalCenter:   parent.horizontalCenter
+            spacing:                    _margins
+
+            Rectangle { anchors.verticalCenter: parent.verticalCenter; width: _margins * 2; height: 2; color: rateChart.color }
+            QGCLabel { text: qsTr("Response") }
+            Rectangle { anchors.verticalCenter: parent.verticalCenter; width: _margins * 2; height: 2; color: setpointChart.color }
+            QGCLabel { text: qsTr("Setpoint") }
+        }
 
         RowLayout {
             spacing: _margins
@@ -337,12 +274,11 @@ RowLayout {
             }
 
             QGCButton {
-                text:       dataTimer.running ? qsTr("Stop") : qsTr("Start")
+                text:       _chartsRunning ? qsTr("Stop") : qsTr("Start")
                 onClicked: {
-                    dataTimer.running = !dataTimer.running
-                    _last_t = 0
+                    _chartsRunning = !_chartsRunning
                     if (autoModeChange.checked) {
-                        globals.activeVehicle.flightMode = dataTimer.running ? "Stabilized" : globals.activeVehicle.pauseFlightMode
+                        globals.activeVehicle.flightMode = _chartsRunning ? "Stabilized" : globals.activeVehicle.pauseFlightMode
                     }
                 }
             }
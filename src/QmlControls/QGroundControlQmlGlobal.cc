@@ -9,8 +9,11 @@
 
 #include "QGroundControlQmlGlobal.h"
 #include "LinkManager.h"
+#include "FactTelemetryLog.h"
 
+#include <QFileInfo>
 #include <QSettings>
+#include <QtConcurrent>
 #include <QLineF>
 #include <QPointF>
 
@@ -47,11 +50,9 @@ void QGroundControlQmlGlobal::setToolbox(QGCToolbox* toolbox)
 
     _linkManager            = toolbox->linkManager();
     _multiVehicleManager    = toolbox->multiVehicleManager();
-    _mapEngineManager       = toolbox->mapEngineManager();
     _qgcPositionManager     = toolbox->qgcPositionManager();
     _missionCommandTree     = toolbox->missionCommandTree();
     _videoManager           = toolbox->videoManager();
-    _mavlinkLogManager      = toolbox->mavlinkLogManager();
     _corePlugin             = toolbox->corePlugin();
     _firmwarePluginManager  = toolbox->firmwarePluginManager();
     _settingsManager        = toolbox->settingsManager();
@@ -59,15 +60,6 @@ void QGroundControlQmlGlobal::setToolbox(QGCToolbox* toolbox)
     _airspaceManager        = toolbox->airspaceManager();
     _adsbVehicleManager     = toolbox->adsbVehicleManager();
     _globalPalette          = new QGCPalette(this);
-#if defined(QGC_ENABLE_PAIRING)
-    _pairingManager         = toolbox->pairingManager();
-#endif
-#if defined(QGC_GST_TAISYNC_ENABLED)
-    _taisyncManager         = toolbox->taisyncManager();
-#endif
-#if defined(QGC_GST_MICROHARD_ENABLED)
-    _microhardManager       = toolbox->microhardManager();
-#endif
 }
 
 void QGroundControlQmlGlobal::saveGlobalSetting (const QString& key, const QString& value)
@@ -152,6 +144,31 @@ void QGroundControlQmlGlobal::startAPMArduRoverMockLink(bool sendStatusText)
 #endif
 }
 
+void QGroundControlQmlGlobal::startSwarmMockLink(int vehicleCount, int telemetryRateHz)
+{
+#ifdef QT_DEBUG
+    MockLink::startSwarmMockLink(vehicleCount, telemetryRateHz);
+#else
+    Q_UNUSED(vehicleCount);
+    Q_UNUSED(telemetryRateHz);
+#endif
+}
+
+void QGroundControlQmlGlobal::exportTelemetryLogToCsv(const QString& logFile)
+{
+    QFileInfo   logFileInfo(logFile);
+    QString     csvFile = logFileInfo.dir().absoluteFilePath(logFileInfo.completeBaseName() + QStringLiteral(".csv"));
+
+    QtConcurrent::run([logFile, csvFile]() {
+        QString errorString;
+        bool    success     = FactTelemetryLog::exportToCsv(logFile, csvFile, errorString);
+        QGCApplication* app = qgcApp();
+        QMetaObject::invokeMethod(app, [app, success, csvFile, errorString]() {
+            app->showAppMessage(success ? tr("Telemetry exported to %1").arg(csvFile) : errorString, tr("Export CSV"));
+        }, Qt::QueuedConnection);
+    });
+}
+
 void QGroundControlQmlGlobal::stopOneMockLink(void)
 {
 #ifdef QT_DEBUG
@@ -14,6 +14,7 @@
 #include "QmlObjectListModel.h"
 
 #include <QDebug>
+#include <QMetaMethod>
 #include <QQmlEngine>
 
 const int QmlObjectListModel::ObjectRole = Qt::UserRole;
@@ -69,10 +70,10 @@ QVariant QmlObjectListModel::data(const QModelIndex &index, int role) const
 
 QHash<int, QByteArray> QmlObjectListModel::roleNames(void) const
 {
-    QHash<int, QByteArray> hash;
-    
-    hash[ObjectRole] = "object";
-    hash[TextRole] = "text";
+    static const QHash<int, QByteArray> hash = {
+        { ObjectRole,   "object" },
+        { TextRole,     "text" },
+    };
     
     return hash;
 }
@@ -115,9 +116,7 @@ bool QmlObjectListModel::removeRows(int position, int rows, const QModelIndex& p
     }
     
     beginRemoveRows(QModelIndex(), position, position + rows - 1);
-    for (int row=0; row<rows; row++) {
-        _objectList.removeAt(position);
-    }
+    _objectList.erase(_objectList.begin() + position, _objectList.begin() + position + rows);
     endRemoveRows();
     
     emit countChanged(count());
@@ -141,6 +140,50 @@ void QmlObjectListModel::move(int from, int to)
     }
 }
 
+void QmlObjectListModel::moveRange(int from, int count, int to)
+{
+    if (count == 1) {
+        move(from, to);
+        return;
+    }
+    if (count < 1 || from < 0 || from + count > _objectList.count() || to < 0 || to + count > _objectList.count() || from == to) {
+        return;
+    }
+
+    // The destination row of beginMoveRows is counted before the move
+    beginMoveRows(QModelIndex(), from, from + count - 1, QModelIndex(), to > from ? to + count : to);
+    const QObjectList moved = _objectList.mid(from, count);
+    _objectList.erase(_objectList.begin() + from, _objectList.begin() + from + count);
+    for (int i = 0; i < count; i++) {
+        _objectList.insert(to + i, moved[i]);
+    }
+    endMoveRows();
+}
+
+void QmlObjectListModel::_connectDirty(QObject* object, int index, bool connect)
+{
+    if (!object || (_skipDirtyFirstItem && index == 0)) {
+        return;
+    }
+
+    // Looking up the signal by name is slow, so it is only done once per type
+    const QMetaObject* metaObject = object->metaObject();
+    auto iter = _dirtySignalIndices.constFind(metaObject);
+    if (iter == _dirtySignalIndices.constEnd()) {
+        iter = _dirtySignalIndices.insert(metaObject, metaObject->indexOfSignal("dirtyChanged(bool)"));
+    }
+    if (iter.value() == -1) {
+        return;
+    }
+
+    static const QMetaMethod childDirtyChangedSlot = staticMetaObject.method(staticMetaObject.indexOfSlot("_childDirtyChanged(bool)"));
+    if (connect) {
+        QObject::connect(object, metaObject->method(iter.value()), this, childDirtyChangedSlot);
+    } else {
+        QObject::disconnect(object, metaObject->method(iter.value()), this, childDirtyChangedSlot);
+    }
+}
+
 QObject* QmlObjectListModel::operator[](int index)
 {
     if (index < 0 || index >= _objectList.count()) {
@@ -172,19 +215,28 @@ void QmlObjectListModel::clear()
 QObject* QmlObjectListModel::removeAt(int i)
 {
     QObject* removedObject = _objectList[i];
-    if(removedObject) {
-        // Look for a dirtyChanged signal on the object
-        if (_objectList[i]->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)")) != -1) {
-            if (!_skipDirtyFirstItem || i != 0) {
-                QObject::disconnect(_objectList[i], SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
-            }
-        }
-    }
+    _connectDirty(removedObject, i, false);
     removeRows(i, 1);
     setDirty(true);
     return removedObject;
 }
 
+QObjectList QmlObjectListModel::removeRange(int first, int count)
+{
+    if (first < 0 || count < 1 || first + count > _objectList.count()) {
+        qWarning() << "Invalid range first:count:list count" << first << count << _objectList.count();
+        return QObjectList();
+    }
+
+    const QObjectList removedObjects = _objectList.mid(first, count);
+    for (int i = 0; i < count; i++) {
+        _connectDirty(removedObjects[i], first + i, false);
+    }
+    removeRows(first, count);
+    setDirty(true);
+    return removedObjects;
+}
+
 void QmlObjectListModel::insert(int i, QObject* object)
 {
     if (i < 0 || i > _objectList.count()) {
@@ -192,12 +244,7 @@ void QmlObjectListModel::insert(int i, QObject* object)
     }
     if(object) {
         QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
-        // Look for a dirtyChanged signal on the object
-        if (object->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)")) != -1) {
-            if (!_skipDirtyFirstItem || i != 0) {
-                QObject::connect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
-            }
-        }
+        _connectDirty(object, i, true);
     }
     _objectList.insert(i, object);
     insertRows(i, 1);
@@ -208,23 +255,22 @@ void QmlObjectListModel::insert(int i, QList<QObject*> objects)
 {
     if (i < 0 || i > _objectList.count()) {
         qWarning() << "Invalid index index:count" << i << _objectList.count();
+        return;
+    }
+    if (objects.isEmpty()) {
+        return;
     }
 
-    int j = i;
-    for (QObject* object: objects) {
-        QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
-
-        // Look for a dirtyChanged signal on the object
-        if (object->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)")) != -1) {
-            if (!_skipDirtyFirstItem || j != 0) {
-                QObject::connect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
-            }
-        }
-        j++;
-
-        _objectList.insert(j, object);
+    for (int j = 0; j < objects.count(); j++) {
+        QQmlEngine::setObjectOwnership(objects[j], QQmlEngine::CppOwnership);
+        _connectDirty(objects[j], i + j, true);
     }
 
+    if (i == _objectList.count()) {
+        _objectList.append(objects);
+    } else {
+        _objectList = _objectList.mid(0, i) + objects + _objectList.mid(i);
+    }
     insertRows(i, objects.count());
 
     setDirty(true);
@@ -41,14 +41,18 @@ public:
     void        clear               ();
     QObject*    removeAt            (int i);
     QObject*    removeOne           (QObject* object) { return removeAt(indexOf(object)); }
+    QObjectList removeRange         (int first, int count);     ///< Removes count items starting at first as a single row removal
     void        insert              (int i, QObject* object);
-    void        insert              (int i, QList<QObject*> objects);
+    void        insert              (int i, QList<QObject*> objects);   ///< Inserts all objects before index i as a single row insertion
     bool        contains            (QObject* object) { return _objectList.indexOf(object) != -1; }
     int         indexOf             (QObject* object) { return _objectList.indexOf(object); }
 
     /// Moves an item to a new position
     void move(int from, int to);
 
+    /// Moves count items starting at from such that the first of them ends up at index to
+    void moveRange(int from, int count, int to);
+
     QObject*    operator[]          (int i);
     const QObject* operator[]       (int i) const;
     template<class T> T value       (int index) { return qobject_cast<T>(_objectList[index]); }
@@ -71,6 +75,8 @@ private slots:
     void _childDirtyChanged         (bool dirty);
     
 private:
+    void _connectDirty              (QObject* object, int index, bool connect);
+
     // Overrides from QAbstractListModel
     int         rowCount    (const QModelIndex & parent = QModelIndex()) const override;
     QVariant    data        (const QModelIndex & index, int role = Qt::DisplayRole) const override;
@@ -81,6 +87,7 @@ private:
 
 private:
     QList<QObject*> _objectList;
+    QHash<const QMetaObject*, int> _dirtySignalIndices;     ///< Index of the dirtyChanged signal by object type, -1 for none
     
     bool _dirty;
     bool _skipDirtyFirstItem;
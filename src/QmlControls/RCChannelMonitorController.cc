@@ -12,21 +12,36 @@
 
 RCChannelMonitorController::RCChannelMonitorController(void)
     : _chanCount(0)
+    , _rcChannelsSequence(0)
 {
-    connect(_vehicle, &Vehicle::rcChannelsChanged, this, &RCChannelMonitorController::_rcChannelsChanged);
+    // The display only needs to keep up with the screen, not with the RC_CHANNELS rate
+    _updateTimer.setInterval(_updateMSecs);
+    connect(&_updateTimer, &QTimer::timeout, this, &RCChannelMonitorController::_updateChannels);
+    _updateTimer.start();
 }
 
-void RCChannelMonitorController::_rcChannelsChanged(int channelCount, int pwmValues[Vehicle::cMaxRcChannels])
+void RCChannelMonitorController::_updateChannels(void)
 {
-    for (int channel=0; channel<channelCount; channel++) {
-        int channelValue = pwmValues[channel];
+    const Vehicle::RcChannels_t& rcChannels = _vehicle->rcChannels();
 
-        if (_chanCount != channelCount) {
-            _chanCount = channelCount;
-            emit channelCountChanged(_chanCount);
-        }
+    if (rcChannels.sequence == _rcChannelsSequence) {
+        return;
+    }
+
+    quint32 changedMask = _vehicle->rcChannelsChangedMask(_rcChannelsSequence);
+    _rcChannelsSequence = rcChannels.sequence;
+
+    if (_chanCount != rcChannels.channelCount) {
+        _chanCount = rcChannels.channelCount;
+        emit channelCountChanged(_chanCount);
+        // The channel displays are new, so they all need a value
+        changedMask = UINT32_MAX;
+    }
+
+    for (int channel=0; channel<rcChannels.channelCount; channel++) {
+        int channelValue = rcChannels.pwmValues[channel];
 
-        if (channelValue != -1) {
+        if ((changedMask & (1 << channel)) && channelValue != -1) {
             emit channelRCValueChanged(channel, channelValue);
         }
     }
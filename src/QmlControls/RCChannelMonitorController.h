@@ -34,10 +34,14 @@ signals:
     void channelRCValueChanged(int channel, int rcValue);
 
 private slots:
-    void _rcChannelsChanged(int channelCount, int pwmValues[Vehicle::cMaxRcChannels]);
+    void _updateChannels(void);
 
 private:
-    int _chanCount;
+    int     _chanCount;
+    quint32 _rcChannelsSequence;    ///< Vehicle::RcChannels_t::sequence last shown
+    QTimer  _updateTimer;
+
+    static const int _updateMSecs = 33;
 };
 
 #endif // RCChannelMonitorController_H
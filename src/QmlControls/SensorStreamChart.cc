@@ -0,0 +1,235 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SensorStreamChart.h"
+#include "MessageIntervalManager.h"
+#include "Vehicle.h"
+
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QtMath>
+
+SensorStreamChart::SensorStreamChart(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    _pollTimer.setInterval(_pollMSecs);
+    connect(&_pollTimer, &QTimer::timeout, this, &SensorStreamChart::_poll);
+
+    connect(this, &SensorStreamChart::vehicleChanged,   this, &SensorStreamChart::_subscribe);
+    connect(this, &SensorStreamChart::streamChanged,    this, &SensorStreamChart::_subscribe);
+    connect(this, &SensorStreamChart::scaleChanged,     this, &SensorStreamChart::_updateDataRange);
+    connect(this, &SensorStreamChart::timeSpanChanged,  this, &QQuickItem::update);
+    connect(this, &SensorStreamChart::yRangeChanged,    this, &QQuickItem::update);
+    connect(this, &SensorStreamChart::colorChanged,     this, &QQuickItem::update);
+    connect(this, &QQuickItem::widthChanged,            this, &QQuickItem::update);
+    connect(this, &QQuickItem::heightChanged,           this, &QQuickItem::update);
+    connect(this, &SensorStreamChart::runningChanged,   this, [this]() {
+        if (_running && _buffer) {
+            _pollTimer.start();
+        } else {
+            _pollTimer.stop();
+        }
+    });
+}
+
+SensorStreamChart::~SensorStreamChart()
+{
+    _unsubscribe();
+}
+
+void SensorStreamChart::setVehicle(Vehicle* vehicle)
+{
+    if (vehicle == _vehicle) {
+        return;
+    }
+
+    _unsubscribe();
+    _vehicle = vehicle;
+    emit vehicleChanged();
+}
+
+void SensorStreamChart::_unsubscribe(void)
+{
+    if (_vehicle) {
+        _vehicle->messageIntervalManager()->unsubscribeAll(this);
+    }
+    _buffer.clear();
+    _pollTimer.stop();
+}
+
+void SensorStreamChart::_subscribe(void)
+{
+    _unsubscribe();
+    clear();
+
+    if (!_vehicle || _messageName.isEmpty() || _fieldName.isEmpty()) {
+        return;
+    }
+
+    _buffer = _vehicle->sensorStreamTap()->subscribe(_messageName, _fieldName, _arrayIndex);
+    if (!_buffer) {
+        return;
+    }
+    _readCount = _buffer->writeCount();
+
+    if (_rateHz > 0) {
+        const mavlink_message_info_t* msgInfo = mavlink_get_message_info_by_name(_messageName.toLatin1().constData());
+        _vehicle->messageIntervalManager()->subscribe(this, msgInfo->msgid, _rateHz);
+    }
+
+    if (_running) {
+        _pollTimer.start();
+    }
+}
+
+void SensorStreamChart::clear(void)
+{
+    _samples.clear();
+    _readCount = _buffer ? _buffer->writeCount() : 0;
+    _updateDataRange();
+    update();
+}
+
+void SensorStreamChart::_poll(void)
+{
+    if (!_buffer) {
+        return;
+    }
+
+    const int previousCount = _samples.count();
+    _readCount = _buffer->read(_readCount, _samples);
+    if (_samples.count() == previousCount) {
+        return;
+    }
+
+    // Keep the time span before the newest sample. Time going backwards is a vehicle reboot, so the samples from
+    // before it go as well.
+    const qint64    cutoffUsecs = _samples.last().usecs - static_cast<qint64>(_timeSpan * 1e6);
+    int             first       = _samples.count() - 1;
+    while (first > 0 && _samples[first - 1].usecs >= cutoffUsecs && _samples[first - 1].usecs <= _samples[first].usecs) {
+        first--;
+    }
+    _samples.remove(0, first);
+
+    _updateDataRange();
+    update();
+}
+
+void SensorStreamChart::_updateDataRange(void)
+{
+    double dataMin = qQNaN();
+    double dataMax = qQNaN();
+
+    if (!_samples.isEmpty()) {
+        float minValue = _samples.first().value;
+        float maxValue = minValue;
+        for (const SensorStreamBuffer::Sample_t& sample: _samples) {
+            minValue = qMin(minValue, sample.value);
+            maxValue = qMax(maxValue, sample.value);
+        }
+        dataMin = qMin(minValue * _scale, maxValue * _scale);
+        dataMax = qMax(minValue * _scale, maxValue * _scale);
+    }
+
+    // Always signal, latestValue changes with every poll
+    _dataMin = dataMin;
+    _dataMax = dataMax;
+    emit dataRangeChanged();
+}
+
+QSGNode* SensorStreamChart::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        geometry->setLineWidth(2);
+
+        node = new QSGGeometryNode;
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setFlag(QSGNode::OwnsMaterial);
+        node->setGeometry(geometry);
+        node->setMaterial(new QSGFlatColorMaterial);
+    }
+
+    QSGFlatColorMaterial* material = static_cast<QSGFlatColorMaterial*>(node->material());
+    if (material->color() != _color) {
+        material->setColor(_color);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    double yMin = _yMin;
+    double yMax = _yMax;
+    if (!(yMax > yMin)) {
+        yMin = qIsNaN(_dataMin) ? 0 : _dataMin;
+        yMax = qIsNaN(_dataMax) ? 0 : _dataMax;
+        if (yMax - yMin < 1e-6) {
+            yMin -= 1;
+            yMax += 1;
+        }
+    }
+
+    // One or two vertices per pixel column: the min and max of the samples which land on it, in the order they came
+    QVector<QPointF> points;
+    if (!_samples.isEmpty() && width() > 0 && height() > 0 && _timeSpan > 0) {
+        const int       columns     = qMax(qCeil(width()), 1);
+        const qint64    startUsecs  = _samples.last().usecs - static_cast<qint64>(_timeSpan * 1e6);
+        const double    xScale      = width() / (_timeSpan * 1e6);
+        const double    yScale      = height() / (yMax - yMin);
+
+        auto toY = [&](float value) {
+            return qBound(0.0, height() - (((value * _scale) - yMin) * yScale), height());
+        };
+
+        points.reserve(columns * 2);
+
+        int     column      = -1;
+        int     minIndex    = 0;
+        int     maxIndex    = 0;
+        auto flushColumn = [&]() {
+            if (column < 0) {
+                return;
+            }
+            const int firstIndex    = qMin(minIndex, maxIndex);
+            const int secondIndex   = qMax(minIndex, maxIndex);
+            points.append(QPointF(column, toY(_samples[firstIndex].value)));
+            if (secondIndex != firstIndex) {
+                points.append(QPointF(column, toY(_samples[secondIndex].value)));
+            }
+        };
+
+        for (int i = 0; i < _samples.count(); i++) {
+            const int sampleColumn = qBound(0, static_cast<int>((_samples[i].usecs - startUsecs) * xScale), columns - 1);
+            if (sampleColumn != column) {
+                flushColumn();
+                column      = sampleColumn;
+                minIndex    = i;
+                maxIndex    = i;
+            } else if (_samples[i].value < _samples[minIndex].value) {
+                minIndex = i;
+            } else if (_samples[i].value > _samples[maxIndex].value) {
+                maxIndex = i;
+            }
+        }
+        flushColumn();
+    }
+
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate(points.count());
+    QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+    for (int i = 0; i < points.count(); i++) {
+        vertices[i].set(static_cast<float>(points[i].x()), static_cast<float>(points[i].y()));
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+
+    return node;
+}
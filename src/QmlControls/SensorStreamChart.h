@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QQuickItem>
+#include <QColor>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QVector>
+
+#include "SensorStreamTap.h"
+
+class Vehicle;
+
+/// Draws the last timeSpan seconds of one message field as a line, straight from the vehicle's SensorStreamTap.
+///
+/// The tap is polled once a frame. The samples which land on the same pixel column are reduced to their min and max
+/// so a 250Hz stream costs at most two vertices per column, and the whole line is a single scene graph node. Set yMin
+/// and yMax to share a scale between charts, otherwise the line is scaled to dataMin and dataMax.
+class SensorStreamChart : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    SensorStreamChart(QQuickItem* parent = nullptr);
+    ~SensorStreamChart();
+
+    Q_PROPERTY(Vehicle*     vehicle     READ vehicle    WRITE setVehicle    NOTIFY vehicleChanged)
+    Q_PROPERTY(QString      messageName MEMBER _messageName                 NOTIFY streamChanged)   ///< For example ATTITUDE_QUATERNION
+    Q_PROPERTY(QString      fieldName   MEMBER _fieldName                   NOTIFY streamChanged)
+    Q_PROPERTY(int          arrayIndex  MEMBER _arrayIndex                  NOTIFY streamChanged)
+    Q_PROPERTY(double       rateHz      MEMBER _rateHz                      NOTIFY streamChanged)   ///< Message rate to ask the vehicle for, 0 to leave it alone
+    Q_PROPERTY(double       scale       MEMBER _scale                       NOTIFY scaleChanged)    ///< Applied to each value, for example radians to degrees
+    Q_PROPERTY(double       timeSpan    MEMBER _timeSpan                    NOTIFY timeSpanChanged) ///< Seconds
+    Q_PROPERTY(double       yMin        MEMBER _yMin                        NOTIFY yRangeChanged)
+    Q_PROPERTY(double       yMax        MEMBER _yMax                        NOTIFY yRangeChanged)
+    Q_PROPERTY(QColor       color       MEMBER _color                       NOTIFY colorChanged)
+    Q_PROPERTY(bool         running     MEMBER _running                     NOTIFY runningChanged)  ///< false: the chart is frozen
+    Q_PROPERTY(double       dataMin     READ dataMin                        NOTIFY dataRangeChanged)
+    Q_PROPERTY(double       dataMax     READ dataMax                        NOTIFY dataRangeChanged)
+    Q_PROPERTY(double       latestValue READ latestValue                    NOTIFY dataRangeChanged)
+
+    Q_INVOKABLE void clear(void);
+
+    Vehicle*    vehicle     (void) { return _vehicle; }
+    double      dataMin     (void) const { return _dataMin; }
+    double      dataMax     (void) const { return _dataMax; }
+    double      latestValue (void) const { return _samples.isEmpty() ? qQNaN() : _samples.last().value * _scale; }
+    void        setVehicle  (Vehicle* vehicle);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) final;
+
+signals:
+    void vehicleChanged     (void);
+    void streamChanged      (void);
+    void scaleChanged       (void);
+    void timeSpanChanged    (void);
+    void yRangeChanged      (void);
+    void colorChanged       (void);
+    void runningChanged     (void);
+    void dataRangeChanged   (void);
+
+private slots:
+    void _subscribe (void);
+    void _poll      (void);
+    void _updateDataRange(void);
+
+private:
+    void _unsubscribe(void);
+
+    QPointer<Vehicle>                           _vehicle;
+    QString                                     _messageName;
+    QString                                     _fieldName;
+    int                                         _arrayIndex     = 0;
+    double                                      _rateHz         = 0;
+    double                                      _scale          = 1;
+    double                                      _timeSpan       = 3;
+    double                                      _yMin           = 0;
+    double                                      _yMax           = 0;
+    QColor                                      _color          = QColor(Qt::green);
+    bool                                        _running        = true;
+    double                                      _dataMin        = qQNaN();
+    double                                      _dataMax        = qQNaN();
+    QSharedPointer<SensorStreamBuffer>          _buffer;
+    quint64                                     _readCount      = 0;
+    QVector<SensorStreamBuffer::Sample_t>       _samples;                       ///< Last timeSpan of the buffer, read by updatePaintNode while the GUI thread is blocked
+    QTimer                                      _pollTimer;
+
+    static const int _pollMSecs = 16;
+};
@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainCollisionEngine.h"
+#include "FlightPathSegment.h"
+#include "TerrainQuery.h"
+#include "TerrainTile.h"
+#include "QGCInstrumentation.h"
+
+QGC_LOGGING_CATEGORY(TerrainCollisionEngineLog, "TerrainCollisionEngineLog")
+
+QGC_INSTRUMENT_COUNTER  (TerrainCollisionProfileHits,   "TerrainCollision.ProfileHits")
+QGC_INSTRUMENT_COUNTER  (TerrainCollisionProfileMisses, "TerrainCollision.ProfileMisses")
+QGC_INSTRUMENT_HISTOGRAM(TerrainCollisionBatchTime,     "TerrainCollision.Batch")
+
+Q_GLOBAL_STATIC(TerrainCollisionEngine, _terrainCollisionEngine)
+
+bool operator==(const TerrainCollisionEngine::ProfileKey_t& key1, const TerrainCollisionEngine::ProfileKey_t& key2)
+{
+    return key1.lat1 == key2.lat1 && key1.lon1 == key2.lon1 && key1.lat2 == key2.lat2 && key1.lon2 == key2.lon2 && key1.resolution == key2.resolution;
+}
+
+uint qHash(const TerrainCollisionEngine::ProfileKey_t& key, uint seed)
+{
+    uint hash = seed;
+    hash = hash * 31 + qHash(key.lat1);
+    hash = hash * 31 + qHash(key.lon1);
+    hash = hash * 31 + qHash(key.lat2);
+    hash = hash * 31 + qHash(key.lon2);
+    hash = hash * 31 + qHash(key.resolution);
+    return hash;
+}
+
+TerrainCollisionEngine::TerrainCollisionEngine(void)
+    : _profiles(_maxCachedHeights)
+{
+    _updateTimer.setSingleShot(true);
+    _updateTimer.setInterval(_updateDelayMSecs);
+    _updateTimer.callOnTimeout(this, &TerrainCollisionEngine::_update);
+}
+
+TerrainCollisionEngine* TerrainCollisionEngine::instance(void)
+{
+    return _terrainCollisionEngine;
+}
+
+TerrainCollisionEngine::ProfileKey_t TerrainCollisionEngine::_profileKey(const FlightPathSegment* segment)
+{
+    ProfileKey_t key;
+
+    key.lat1        = segment->coordinate1().latitude();
+    key.lon1        = segment->coordinate1().longitude();
+    key.lat2        = segment->coordinate2().latitude();
+    key.lon2        = segment->coordinate2().longitude();
+    key.resolution  = TerrainTile::tileValueSpacingMeters;
+
+    return key;
+}
+
+void TerrainCollisionEngine::segmentChanged(FlightPathSegment* segment)
+{
+    _dirtySegments.insert(segment);
+    if (!_updateTimer.isActive()) {
+        // Not restarted on each change so a continuous drag still gets updates along the way
+        _updateTimer.start();
+    }
+}
+
+void TerrainCollisionEngine::removeSegment(FlightPathSegment* segment)
+{
+    _dirtySegments.remove(segment);
+    for (QList<FlightPathSegment*>& segments: _waitingSegments) {
+        segments.removeAll(segment);
+    }
+}
+
+void TerrainCollisionEngine::_update(void)
+{
+    QGC_INSTRUMENT_SCOPE(TerrainCollisionBatchTime);
+
+    bool                    profilesApplied = false;
+    QList<QGeoCoordinate>   coordinates;
+    SentBatch_t             batch;
+
+    for (FlightPathSegment* segment: _dirtySegments) {
+        if (!segment->coordinate1().isValid() || !segment->coordinate2().isValid()) {
+            continue;
+        }
+
+        ProfileKey_t key = _profileKey(segment);
+
+        const Profile_t* profile = _profiles.object(key);
+        if (profile) {
+            QGC_INSTRUMENT_ADD(TerrainCollisionProfileHits, 1);
+            segment->_setTerrainProfile(profile->distanceBetween, profile->finalDistanceBetween, profile->heights);
+            profilesApplied = true;
+            continue;
+        }
+
+        // Don't leave the profile for the previous position showing while the new one is being fetched
+        segment->_setTerrainProfile(0, 0, QVariantList());
+
+        auto waitingIter = _waitingSegments.find(key);
+        if (waitingIter != _waitingSegments.end()) {
+            // Already requested by an earlier batch
+            if (!waitingIter->contains(segment)) {
+                waitingIter->append(segment);
+            }
+            continue;
+        }
+
+        QGC_INSTRUMENT_ADD(TerrainCollisionProfileMisses, 1);
+        _waitingSegments[key].append(segment);
+
+        double distanceBetween;
+        double finalDistanceBetween;
+        batch.keys.append(key);
+        batch.offsets.push_back(coordinates.count());
+        coordinates.append(TerrainTileManager::pathQueryToCoords(segment->coordinate1(), segment->coordinate2(), distanceBetween, finalDistanceBetween));
+        batch.distanceBetween.push_back(distanceBetween);
+        batch.finalDistanceBetween.push_back(finalDistanceBetween);
+    }
+    _dirtySegments.clear();
+
+    if (!batch.keys.isEmpty()) {
+        batch.offsets.push_back(coordinates.count());
+        qCDebug(TerrainCollisionEngineLog) << "_update requesting profiles:coordinates" << batch.keys.count() << coordinates.count();
+
+        // The batch must be recorded before the request since results can be signalled before it returns
+        TerrainOfflineAirMapQuery* terrainQuery = new TerrainOfflineAirMapQuery(this);
+        connect(terrainQuery, &TerrainQueryInterface::coordinateHeightsReceived, this, &TerrainCollisionEngine::_coordinateHeights);
+        _sentBatches[terrainQuery] = batch;
+        terrainQuery->requestCoordinateHeights(coordinates);
+    }
+
+    if (profilesApplied) {
+        emit terrainProfilesUpdated();
+    }
+}
+
+void TerrainCollisionEngine::_coordinateHeights(bool success, QList<double> heights)
+{
+    TerrainOfflineAirMapQuery*  terrainQuery    = qobject_cast<TerrainOfflineAirMapQuery*>(sender());
+    auto                        batchIter       = _sentBatches.find(terrainQuery);
+
+    if (batchIter == _sentBatches.end()) {
+        qCWarning(TerrainCollisionEngineLog) << "_coordinateHeights signalled from unknown query";
+        return;
+    }
+
+    SentBatch_t batch = batchIter.value();
+    _sentBatches.erase(batchIter);
+    terrainQuery->deleteLater();
+
+    if (success && heights.count() != batch.offsets.back()) {
+        qCWarning(TerrainCollisionEngineLog) << "_coordinateHeights unexpected height count" << heights.count() << batch.offsets.back();
+        success = false;
+    }
+    qCDebug(TerrainCollisionEngineLog) << "_coordinateHeights success:profiles" << success << batch.keys.count();
+
+    for (int i = 0; i < batch.keys.count(); i++) {
+        const ProfileKey_t&         key         = batch.keys[i];
+        QList<FlightPathSegment*>   segments    = _waitingSegments.take(key);
+
+        if (!success) {
+            // Segments stay without a profile, which is also what a failed path query left behind
+            continue;
+        }
+
+        size_t      index       = static_cast<size_t>(i);
+        int         firstHeight = batch.offsets[index];
+        int         cHeights    = batch.offsets[index + 1] - firstHeight;
+        Profile_t*  profile     = new Profile_t;
+
+        profile->distanceBetween        = batch.distanceBetween[index];
+        profile->finalDistanceBetween   = batch.finalDistanceBetween[index];
+        profile->heights.reserve(cHeights);
+        for (int j = firstHeight; j < firstHeight + cHeights; j++) {
+            profile->heights.append(heights[j]);
+        }
+
+        for (FlightPathSegment* segment: segments) {
+            // The segment may have moved on since the request went out, in which case it is already dirty again
+            if (_profileKey(segment) == key) {
+                segment->_setTerrainProfile(profile->distanceBetween, profile->finalDistanceBetween, profile->heights);
+            }
+        }
+
+        // Applied first since the cache takes ownership and may delete the profile right away
+        _profiles.insert(key, profile, qMax(1, cHeights));
+    }
+
+    if (success) {
+        emit terrainProfilesUpdated();
+    }
+}
@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QGeoCoordinate>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QVariantList>
+
+#include <vector>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainCollisionEngineLog)
+
+class FlightPathSegment;
+class TerrainOfflineAirMapQuery;
+
+/// Supplies the terrain profiles FlightPathSegments use to check for terrain collisions.
+///
+/// Segments mark themselves dirty when an endpoint moves. Dirty segments are collected for a short while and then
+/// looked up in a cache of profiles keyed by endpoint coordinates and sample resolution, so segments which are
+/// rebuilt or moved back onto a previous position do not go back to the terrain system. Profiles which are not cached
+/// are requested together in a single coordinate query. Once profiles have been applied to their segments
+/// terrainProfilesUpdated is signalled a single time for the whole set.
+class TerrainCollisionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    TerrainCollisionEngine(void);
+
+    static TerrainCollisionEngine* instance(void);
+
+    /// Queues the segment for a terrain profile update based on its current endpoints
+    void segmentChanged(FlightPathSegment* segment);
+
+    /// Must be called before a segment which was passed to segmentChanged is deleted
+    void removeSegment(FlightPathSegment* segment);
+
+signals:
+    /// Signalled once after a set of segments has been given new terrain profiles
+    void terrainProfilesUpdated(void);
+
+private slots:
+    void _update            (void);
+    void _coordinateHeights (bool success, QList<double> heights);
+
+private:
+    typedef struct {
+        double lat1;
+        double lon1;
+        double lat2;
+        double lon2;
+        double resolution;
+    } ProfileKey_t;
+
+    typedef struct {
+        double          distanceBetween;
+        double          finalDistanceBetween;
+        QVariantList    heights;
+    } Profile_t;
+
+    typedef struct {
+        QList<ProfileKey_t>     keys;
+        std::vector<int>        offsets;                ///< Index of the first height of each key followed by the total count
+        std::vector<double>     distanceBetween;
+        std::vector<double>     finalDistanceBetween;
+    } SentBatch_t;
+
+    friend bool operator==(const ProfileKey_t& key1, const ProfileKey_t& key2);
+    friend uint qHash(const ProfileKey_t& key, uint seed);
+
+    static ProfileKey_t _profileKey(const FlightPathSegment* segment);
+
+    QTimer                                              _updateTimer;
+    QSet<FlightPathSegment*>                            _dirtySegments;
+    QCache<ProfileKey_t, Profile_t>                     _profiles;              ///< Cost is the number of heights in the profile
+    QHash<ProfileKey_t, QList<FlightPathSegment*>>      _waitingSegments;       ///< Segments waiting on a profile which has been requested
+    QHash<TerrainOfflineAirMapQuery*, SentBatch_t>      _sentBatches;
+
+    static const int _updateDelayMSecs  = 200;
+    static const int _maxCachedHeights  = 256 * 1024;
+};
@@ -16,6 +16,8 @@
 
 #include <QSGSimpleRectNode>
 
+#include <vector>
+
 QGC_LOGGING_CATEGORY(TerrainProfileLog, "TerrainProfileLog")
 
 TerrainProfile::TerrainProfile(QQuickItem* parent)
@@ -74,49 +76,145 @@ void TerrainProfile::_createGeometry(QSGGeometryNode*& geometryNode, QSGGeometry
     geometryNode->setGeometry(geometry);
 }
 
-void TerrainProfile::_updateSegmentCounts(FlightPathSegment* segment, int& cFlightProfileSegments, int& cTerrainProfilePoints, int& cMissingTerrainSegments, int& cTerrainCollisionSegments, double& minTerrainHeight, double& maxTerrainHeight)
+void TerrainProfile::_updateSegmentCounts(FlightPathSegment* segment, int& cFlightProfileSegments, int& cMissingTerrainSegments, int& cTerrainCollisionSegments)
 {
     if (_shouldAddFlightProfileSegment(segment)) {
         cFlightProfileSegments++;
     }
-
     if (_shouldAddMissingTerrainSegment(segment)) {
         cMissingTerrainSegments += 1;
-    } else {
-        cTerrainProfilePoints += segment->amslTerrainHeights().count();
-        for (int i=0; i<segment->amslTerrainHeights().count(); i++) {
-            minTerrainHeight = std::fmin(minTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
-            maxTerrainHeight = std::fmax(maxTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
-        }
     }
     if (segment->terrainCollision()) {
         cTerrainCollisionSegments++;
     }
 }
 
-void TerrainProfile::_addTerrainProfileSegment(FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainVertices, int& terrainProfileVertexIndex)
+int TerrainProfile::_terrainLODStep(double distanceBetween, int cHeights) const
 {
-    double terrainDistance = 0;
-    for (int heightIndex=0; heightIndex<segment->amslTerrainHeights().count(); heightIndex++) {
-        // Move along the x axis which is distance
-        if (heightIndex == 0) {
-            // The first point in the segment is at the position of the last point. So nothing to do here.
-        } else if (heightIndex == segment->amslTerrainHeights().count() - 2) {
-            // The distance between the last two heights differs with each terrain query
-            terrainDistance += segment->finalDistanceBetween();
-        } else {
-            // The distance between all terrain heights except for the last is the same
-            terrainDistance += segment->distanceBetween();
-        }
+    // Terrain heights closer together than a pixel are reduced to their min/max. Steps are powers of two so small zoom
+    // changes don't cause geometry rebuilds.
+    double  pixelsBetween   = distanceBetween * _pixelsPerMeter;
+    int     lodStep         = 1;
+    while (lodStep * pixelsBetween < 1.0 && lodStep < cHeights) {
+        lodStep *= 2;
+    }
+    return lodStep;
+}
 
-        // Move along the y axis which is a view or terrain height as a percentage between the min/max AMSL altitude for all segments
-        double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex].value<double>();
-        double terrainHeightPercent = (amslTerrainHeight - _minAMSLAlt) / amslAltRange;
+void TerrainProfile::_updateTerrainProfileSegment(FlightPathSegment* segment, double currentDistance, QSGNode* terrainProfileNode, double& minTerrainHeight, double& maxTerrainHeight)
+{
+    if (_shouldAddMissingTerrainSegment(segment)) {
+        return;
+    }
 
-        float x = (currentDistance + terrainDistance) * _pixelsPerMeter;
-        float y = height() - (terrainHeightPercent * height());
-        terrainVertices[terrainProfileVertexIndex++].set(x, y);
+    auto iter = _terrainSegmentNodes.find(segment);
+    if (iter == _terrainSegmentNodes.end()) {
+        QSGGeometryNode*    geometryNode    = nullptr;
+        QSGGeometry*        geometry        = nullptr;
+        _createGeometry(geometryNode, geometry, QSGGeometry::DrawLineStrip, "green");
+
+        TerrainSegmentNode_t segmentNode;
+        segmentNode.node                    = new QSGTransformNode;
+        segmentNode.distanceBetween         = 0;
+        segmentNode.finalDistanceBetween    = 0;
+        segmentNode.currentDistance         = qQNaN();
+        segmentNode.lodStep                 = 0;
+        segmentNode.minTerrainHeight        = qQNaN();
+        segmentNode.maxTerrainHeight        = qQNaN();
+        segmentNode.node->setFlag(QSGNode::OwnedByParent);
+        segmentNode.node->appendChildNode(geometryNode);
+        terrainProfileNode->appendChildNode(segmentNode.node);
+
+        iter = _terrainSegmentNodes.insert(segment, segmentNode);
     }
+
+    TerrainSegmentNode_t& segmentNode = iter.value();
+    segmentNode.updateCount = _updateCount;
+
+    // Comparing the height lists is cheap when unchanged since they share data with the segment
+    int lodStep = _terrainLODStep(segment->distanceBetween(), segment->amslTerrainHeights().count());
+    if (segmentNode.amslTerrainHeights != segment->amslTerrainHeights() ||
+            segmentNode.distanceBetween != segment->distanceBetween() ||
+            segmentNode.finalDistanceBetween != segment->finalDistanceBetween() ||
+            segmentNode.lodStep != lodStep) {
+        segmentNode.amslTerrainHeights      = segment->amslTerrainHeights();
+        segmentNode.distanceBetween         = segment->distanceBetween();
+        segmentNode.finalDistanceBetween    = segment->finalDistanceBetween();
+        segmentNode.lodStep                 = lodStep;
+        _buildTerrainProfileGeometry(segmentNode);
+    }
+
+    if (segmentNode.currentDistance != currentDistance) {
+        QMatrix4x4 matrix;
+        matrix.translate(static_cast<float>(currentDistance), 0);
+        segmentNode.node->setMatrix(matrix);
+        segmentNode.currentDistance = currentDistance;
+    }
+
+    minTerrainHeight = std::fmin(minTerrainHeight, segmentNode.minTerrainHeight);
+    maxTerrainHeight = std::fmax(maxTerrainHeight, segmentNode.maxTerrainHeight);
+}
+
+void TerrainProfile::_buildTerrainProfileGeometry(TerrainSegmentNode_t& segmentNode)
+{
+    const QVariantList& heights     = segmentNode.amslTerrainHeights;
+    int                 cHeights    = heights.count();
+    int                 lodStep     = segmentNode.lodStep;
+
+    std::vector<float> rgHeights(static_cast<size_t>(cHeights));
+    segmentNode.minTerrainHeight = qQNaN();
+    segmentNode.maxTerrainHeight = qQNaN();
+    for (int i=0; i<cHeights; i++) {
+        double amslTerrainHeight = heights[i].value<double>();
+        rgHeights[static_cast<size_t>(i)] = static_cast<float>(amslTerrainHeight);
+        segmentNode.minTerrainHeight = std::fmin(segmentNode.minTerrainHeight, amslTerrainHeight);
+        segmentNode.maxTerrainHeight = std::fmax(segmentNode.maxTerrainHeight, amslTerrainHeight);
+    }
+
+    // The distance between all terrain heights except for the last two is the same
+    auto terrainDistance = [&](int heightIndex) {
+        return heightIndex < cHeights - 1 ?
+                    heightIndex * segmentNode.distanceBetween :
+                    ((cHeights - 2) * segmentNode.distanceBetween) + segmentNode.finalDistanceBetween;
+    };
+
+    // The end points are always kept, the heights between them are reduced to a min/max pair for each lodStep heights
+    int cInnerHeights   = qMax(cHeights - 2, 0);
+    int cVertices       = lodStep == 1 ? cHeights : 2 + (((cInnerHeights + lodStep - 1) / lodStep) * 2);
+
+    QSGGeometryNode*        geometryNode    = static_cast<QSGGeometryNode*>(segmentNode.node->firstChild());
+    QSGGeometry*            geometry        = geometryNode->geometry();
+    geometry->allocate(cVertices);
+    QSGGeometry::Point2D*   vertices        = geometry->vertexDataAsPoint2D();
+    int                     vertexIndex     = 0;
+
+    if (lodStep == 1) {
+        for (int i=0; i<cHeights; i++) {
+            vertices[vertexIndex++].set(static_cast<float>(terrainDistance(i)), rgHeights[static_cast<size_t>(i)]);
+        }
+    } else {
+        vertices[vertexIndex++].set(0, rgHeights[0]);
+        for (int bucketStart=1; bucketStart<cHeights-1; bucketStart+=lodStep) {
+            int bucketEnd   = qMin(bucketStart + lodStep, cHeights - 1);
+            int minIndex    = bucketStart;
+            int maxIndex    = bucketStart;
+            for (int i=bucketStart+1; i<bucketEnd; i++) {
+                if (rgHeights[static_cast<size_t>(i)] < rgHeights[static_cast<size_t>(minIndex)]) {
+                    minIndex = i;
+                }
+                if (rgHeights[static_cast<size_t>(i)] > rgHeights[static_cast<size_t>(maxIndex)]) {
+                    maxIndex = i;
+                }
+            }
+            int firstIndex  = qMin(minIndex, maxIndex);
+            int secondIndex = qMax(minIndex, maxIndex);
+            vertices[vertexIndex++].set(static_cast<float>(terrainDistance(firstIndex)),  rgHeights[static_cast<size_t>(firstIndex)]);
+            vertices[vertexIndex++].set(static_cast<float>(terrainDistance(secondIndex)), rgHeights[static_cast<size_t>(secondIndex)]);
+        }
+        vertices[vertexIndex++].set(static_cast<float>(terrainDistance(cHeights - 1)), rgHeights[static_cast<size_t>(cHeights - 1)]);
+    }
+
+    geometryNode->markDirty(QSGNode::DirtyGeometry);
 }
 
 void TerrainProfile::_addMissingTerrainSegment(FlightPathSegment* segment, double currentDistance, QSGGeometry::Point2D* missingTerrainVertices, int& missingterrainProfileVertexIndex)
@@ -174,38 +272,84 @@ void TerrainProfile::_addFlightProfileSegment(FlightPathSegment* segment, double
 QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
 {
     QSGNode*        rootNode =                  static_cast<QSGNode *>(oldNode);
-    QSGGeometry*    terrainProfileGeometry =    nullptr;
     QSGGeometry*    missingTerrainGeometry =    nullptr;
     QSGGeometry*    flightProfileGeometry =     nullptr;
     QSGGeometry*    terrainCollisionGeometry =  nullptr;
-    int             cTerrainProfilePoints =     0;
     int             cMissingTerrainSegments =   0;
     int             cFlightProfileSegments =    0;
     int             cTerrainCollisionSegments = 0;
     double          minTerrainHeight =          qQNaN();
     double          maxTerrainHeight =          qQNaN();
+    double          currentDistance =           0;
+
+    _pixelsPerMeter = _visibleWidth / _missionController->missionDistance();
+
+    // Instantiate nodes
+    if (!rootNode) {
+        // Any previous nodes went away with the scene graph
+        _terrainSegmentNodes.clear();
+
+        rootNode = new QSGNode;
+
+        QSGTransformNode* terrainProfileNode =  new QSGTransformNode;
+        QSGGeometryNode* missingTerrainNode =   nullptr;
+        QSGGeometryNode* flightProfileNode =    nullptr;
+        QSGGeometryNode* terrainCollisionNode = nullptr;
+
+        terrainProfileNode->setFlag(QSGNode::OwnedByParent);
+        _createGeometry(missingTerrainNode,     missingTerrainGeometry,     QSGGeometry::DrawLines,     "yellow");
+        _createGeometry(flightProfileNode,      flightProfileGeometry,      QSGGeometry::DrawLines,     "orange");
+        _createGeometry(terrainCollisionNode,   terrainCollisionGeometry,   QSGGeometry::DrawLines,     "red");
+
+        rootNode->appendChildNode(terrainProfileNode);
+        rootNode->appendChildNode(missingTerrainNode);
+        rootNode->appendChildNode(flightProfileNode);
+        rootNode->appendChildNode(terrainCollisionNode);
+    }
+
+    QSGTransformNode* terrainProfileNode = static_cast<QSGTransformNode*>(rootNode->childAtIndex(0));
 
     // First we need to determine:
-    //  - how many terrain profile vertices we need
     //  - how many missing terrain segments there are
     //  - how many flight profile segments we need
     //  - how many terrain collision segments there are
-    //  - what is the total distance so we can calculate pixels per meter
+    //  - the min/max terrain height
+    // Along the way the terrain profile nodes of segments which changed are rebuilt
 
+    _updateCount++;
     for (int viIndex=0; viIndex<_visualItems->count(); viIndex++) {
         VisualMissionItem*  visualItem =    _visualItems->value<VisualMissionItem*>(viIndex);
         ComplexMissionItem* complexItem =   _visualItems->value<ComplexMissionItem*>(viIndex);
 
+        if (complexItem) {
+            if (complexItem->flightPathSegments()->count() == 0) {
+                currentDistance += complexItem->complexDistance();
+            } else {
+                for (int segmentIndex=0; segmentIndex<complexItem->flightPathSegments()->count(); segmentIndex++) {
+                    FlightPathSegment* segment = complexItem->flightPathSegments()->value<FlightPathSegment*>(segmentIndex);
+                    _updateSegmentCounts(segment, cFlightProfileSegments, cMissingTerrainSegments, cTerrainCollisionSegments);
+                    _updateTerrainProfileSegment(segment, currentDistance, terrainProfileNode, minTerrainHeight, maxTerrainHeight);
+                    currentDistance += segment->totalDistance();
+                }
+            }
+        }
+
         if (visualItem->simpleFlightPathSegment()) {
             FlightPathSegment* segment = visualItem->simpleFlightPathSegment();
-            _updateSegmentCounts(segment, cFlightProfileSegments, cTerrainProfilePoints, cMissingTerrainSegments, cTerrainCollisionSegments, minTerrainHeight, maxTerrainHeight);
+            _updateSegmentCounts(segment, cFlightProfileSegments, cMissingTerrainSegments, cTerrainCollisionSegments);
+            _updateTerrainProfileSegment(segment, currentDistance, terrainProfileNode, minTerrainHeight, maxTerrainHeight);
+            currentDistance += segment->totalDistance();
         }
+    }
 
-        if (complexItem) {
-            for (int segmentIndex=0; segmentIndex<complexItem->flightPathSegments()->count(); segmentIndex++) {
-                FlightPathSegment* segment = complexItem->flightPathSegments()->value<FlightPathSegment*>(segmentIndex);
-                _updateSegmentCounts(segment, cFlightProfileSegments, cTerrainProfilePoints, cMissingTerrainSegments, cTerrainCollisionSegments, minTerrainHeight, maxTerrainHeight);
-            }
+    // Drop the nodes of segments which are no longer part of the profile
+    for (auto iter = _terrainSegmentNodes.begin(); iter != _terrainSegmentNodes.end(); ) {
+        if (iter->updateCount != _updateCount) {
+            terrainProfileNode->removeChildNode(iter->node);
+            delete iter->node;
+            iter = _terrainSegmentNodes.erase(iter);
+        } else {
+            iter++;
         }
     }
 
@@ -225,39 +369,18 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
 
     static int counter = 0;
     qCDebug(TerrainProfileLog) << "missionController min/max" << _missionController->minAMSLAltitude() << _missionController->maxAMSLAltitude();
-    qCDebug(TerrainProfileLog) << QStringLiteral("updatePaintNode counter:%1 cFlightProfileSegments:%2 cTerrainProfilePoints:%3 cMissingTerrainSegments:%4 cTerrainCollisionSegments:%5 _minAMSLAlt:%6 _maxAMSLAlt:%7 maxTerrainHeight:%8")
-                               .arg(counter++).arg(cFlightProfileSegments).arg(cTerrainProfilePoints).arg(cMissingTerrainSegments).arg(cTerrainCollisionSegments).arg(_minAMSLAlt).arg(_maxAMSLAlt).arg(maxTerrainHeight);
-
-    _pixelsPerMeter = _visibleWidth / _missionController->missionDistance();
-
-    // Instantiate nodes
-    if (!rootNode) {
-        rootNode = new QSGNode;
-
-        QSGGeometryNode* terrainProfileNode =   nullptr;
-        QSGGeometryNode* missingTerrainNode =   nullptr;
-        QSGGeometryNode* flightProfileNode =    nullptr;
-        QSGGeometryNode* terrainCollisionNode = nullptr;
+    qCDebug(TerrainProfileLog) << QStringLiteral("updatePaintNode counter:%1 cFlightProfileSegments:%2 cTerrainProfileSegments:%3 cMissingTerrainSegments:%4 cTerrainCollisionSegments:%5 _minAMSLAlt:%6 _maxAMSLAlt:%7 maxTerrainHeight:%8")
+                               .arg(counter++).arg(cFlightProfileSegments).arg(_terrainSegmentNodes.count()).arg(cMissingTerrainSegments).arg(cTerrainCollisionSegments).arg(_minAMSLAlt).arg(_maxAMSLAlt).arg(maxTerrainHeight);
 
-        _createGeometry(terrainProfileNode,     terrainProfileGeometry,     QSGGeometry::DrawLineStrip, "green");
-        _createGeometry(missingTerrainNode,     missingTerrainGeometry,     QSGGeometry::DrawLines,     "yellow");
-        _createGeometry(flightProfileNode,      flightProfileGeometry,      QSGGeometry::DrawLines,     "orange");
-        _createGeometry(terrainCollisionNode,   terrainCollisionGeometry,   QSGGeometry::DrawLines,     "red");
-
-        rootNode->appendChildNode(terrainProfileNode);
-        rootNode->appendChildNode(missingTerrainNode);
-        rootNode->appendChildNode(flightProfileNode);
-        rootNode->appendChildNode(terrainCollisionNode);
-    }
+    // Map meters along the mission and AMSL meters to pixels, with the y axis going up from the bottom of the view
+    QMatrix4x4 terrainProfileMatrix;
+    terrainProfileMatrix.translate(0, static_cast<float>(height() + (_minAMSLAlt * height() / amslAltRange)));
+    terrainProfileMatrix.scale(static_cast<float>(_pixelsPerMeter), static_cast<float>(-height() / amslAltRange));
+    terrainProfileNode->setMatrix(terrainProfileMatrix);
 
     // Allocate space for the vertices
 
-    QSGNode* node = rootNode->childAtIndex(0);
-    terrainProfileGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
-    terrainProfileGeometry->allocate(cTerrainProfilePoints);
-    node->markDirty(QSGNode::DirtyGeometry);
-
-    node = rootNode->childAtIndex(1);
+    QSGNode* node = rootNode->childAtIndex(1);
     missingTerrainGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
     missingTerrainGeometry->allocate(cMissingTerrainSegments * 2);
     node->markDirty(QSGNode::DirtyGeometry);
@@ -273,16 +396,14 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
     node->markDirty(QSGNode::DirtyGeometry);
 
     int                     flightProfileVertexIndex =          0;
-    int                     terrainProfileVertexIndex =         0;
     int                     missingterrainProfileVertexIndex =  0;
     int                     terrainCollisionVertexIndex =       0;
-    double                  currentDistance =                   0;
     QSGGeometry::Point2D*   flightProfileVertices =             flightProfileGeometry->vertexDataAsPoint2D();
-    QSGGeometry::Point2D*   terrainProfileVertices =            terrainProfileGeometry->vertexDataAsPoint2D();
     QSGGeometry::Point2D*   missingTerrainVertices =            missingTerrainGeometry->vertexDataAsPoint2D();
     QSGGeometry::Point2D*   terrainCollisionVertices =          terrainCollisionGeometry->vertexDataAsPoint2D();
 
     // This step places the vertices for display into the nodes
+    currentDistance = 0;
     for (int viIndex=0; viIndex<_visualItems->count(); viIndex++) {
         VisualMissionItem*  visualItem =    _visualItems->value<VisualMissionItem*>(viIndex);
         ComplexMissionItem* complexItem =   _visualItems->value<ComplexMissionItem*>(viIndex);
@@ -295,7 +416,6 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
                     FlightPathSegment* segment = complexItem->flightPathSegments()->value<FlightPathSegment*>(segmentIndex);
 
                     _addFlightProfileSegment    (segment, currentDistance, amslAltRange,    flightProfileVertices,      flightProfileVertexIndex);
-                    _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileVertices,     terrainProfileVertexIndex);
                     _addMissingTerrainSegment   (segment, currentDistance,                  missingTerrainVertices,     missingterrainProfileVertexIndex);
                     _addTerrainCollisionSegment (segment, currentDistance, amslAltRange,    terrainCollisionVertices,   terrainCollisionVertexIndex);
 
@@ -308,7 +428,6 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
             FlightPathSegment* segment = visualItem->simpleFlightPathSegment();
 
             _addFlightProfileSegment    (segment, currentDistance, amslAltRange,    flightProfileVertices,      flightProfileVertexIndex);
-            _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileVertices,     terrainProfileVertexIndex);
             _addMissingTerrainSegment   (segment, currentDistance,                  missingTerrainVertices,     missingterrainProfileVertexIndex);
             _addTerrainCollisionSegment (segment, currentDistance, amslAltRange,    terrainCollisionVertices,   terrainCollisionVertexIndex);
 
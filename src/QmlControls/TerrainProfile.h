@@ -13,6 +13,9 @@
 #include <QTimer>
 #include <QSGGeometryNode>
 #include <QSGGeometry>
+#include <QSGTransformNode>
+#include <QHash>
+#include <QVariantList>
 
 #include "QGCLoggingCategory.h"
 
@@ -57,9 +60,26 @@ private slots:
     void _newVisualItems            (void);
 
 private:
+    /// Terrain profile line for a single segment. The vertices are in meters along the segment and AMSL meters, the
+    /// node places them along the mission and the parent transform maps them to pixels. So the geometry only needs
+    /// rebuilding when the terrain heights of the segment itself change or the level of detail changes.
+    typedef struct {
+        QSGTransformNode*   node;
+        QVariantList        amslTerrainHeights;     ///< Heights the geometry was built from
+        double              distanceBetween;
+        double              finalDistanceBetween;
+        double              currentDistance;        ///< Distance along the mission the node is placed at
+        int                 lodStep;                ///< Number of terrain heights reduced to a min/max pair
+        double              minTerrainHeight;
+        double              maxTerrainHeight;
+        int                 updateCount;            ///< Value of _updateCount when the segment was last part of the profile
+    } TerrainSegmentNode_t;
+
     void    _createGeometry                 (QSGGeometryNode*& geometryNode, QSGGeometry*& geometry, QSGGeometry::DrawingMode drawingMode, const QColor& color);
-    void    _updateSegmentCounts            (FlightPathSegment* segment, int& cFlightProfileSegments, int& cTerrainPoints, int& cMissingTerrainSegments, int& cTerrainCollisionSegments, double& minTerrainHeight, double& maxTerrainHeight);
-    void    _addTerrainProfileSegment       (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainProfileVertices, int& terrainVertexIndex);
+    void    _updateSegmentCounts            (FlightPathSegment* segment, int& cFlightProfileSegments, int& cMissingTerrainSegments, int& cTerrainCollisionSegments);
+    void    _updateTerrainProfileSegment    (FlightPathSegment* segment, double currentDistance, QSGNode* terrainProfileNode, double& minTerrainHeight, double& maxTerrainHeight);
+    void    _buildTerrainProfileGeometry    (TerrainSegmentNode_t& segmentNode);
+    int     _terrainLODStep                 (double distanceBetween, int cHeights) const;
     void    _addMissingTerrainSegment       (FlightPathSegment* segment, double currentDistance, QSGGeometry::Point2D* missingTerrainVertices, int& missingTerrainVertexIndex);
     void    _addTerrainCollisionSegment     (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainCollisionVertices, int& terrainCollisionVertexIndex);
     void    _addFlightProfileSegment        (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* flightProfileVertices, int& flightProfileVertexIndex);
@@ -72,6 +92,9 @@ private:
     double              _pixelsPerMeter =       0;
     double              _minAMSLAlt =           0;
     double              _maxAMSLAlt =           0;
+    int                 _updateCount =          0;
+
+    QHash<FlightPathSegment*, TerrainSegmentNode_t> _terrainSegmentNodes;   ///< Only accessed from updatePaintNode
 
     static const int _lineWidth =       7;
 
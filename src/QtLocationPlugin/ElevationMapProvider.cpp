@@ -49,3 +49,13 @@ QGCTileSet AirmapElevationProvider::getTileCount(const int zoom, const double to
 
     return set;
 }
+
+QVector<QGCTileSet> AirmapElevationProvider::getTileRanges(const int minZoom, const int maxZoom, const double topleftLon,
+                                                           const double topleftLat, const double bottomRightLon,
+                                                           const double bottomRightLat) const {
+    QVector<QGCTileSet> ranges;
+    if (maxZoom >= minZoom) {
+        ranges.fill(getTileCount(maxZoom, topleftLon, topleftLat, bottomRightLon, bottomRightLat), maxZoom - minZoom + 1);
+    }
+    return ranges;
+}
@@ -39,6 +39,11 @@ class AirmapElevationProvider : public ElevationProvider {
                             const double topleftLat, const double bottomRightLon,
                             const double bottomRightLat) const override;
 
+    // Elevation tiles are fixed size in degrees, every zoom level covers the same tiles
+    QVector<QGCTileSet> getTileRanges(const int minZoom, const int maxZoom, const double topleftLon,
+                                      const double topleftLat, const double bottomRightLon,
+                                      const double bottomRightLat) const override;
+
   protected:
     QString _getURL(const int x, const int y, const int zoom, QNetworkAccessManager* networkManager) override;
 };
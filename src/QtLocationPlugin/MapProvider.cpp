@@ -37,6 +37,9 @@ QNetworkRequest MapProvider::getTileURL(const int x, const int y, const int zoom
     request.setRawHeader(QByteArrayLiteral("Accept"), QByteArrayLiteral("*/*"));
     request.setRawHeader(QByteArrayLiteral("Referrer"), _referrer.toUtf8());
     request.setRawHeader(QByteArrayLiteral("User-Agent"), _userAgent);
+    //-- Tiles have a cache of their own, keep them out of the shared network cache
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
     return request;
 }
 
@@ -56,6 +59,40 @@ QString MapProvider::getImageFormat(const QByteArray& image) const {
     return format;
 }
 
+int MapProvider::takeDownloadToken() {
+    const double rate = maxDownloadRate();
+    if (rate <= 0) {
+        return 0;
+    }
+    if (!_downloadTokenTimer.isValid()) {
+        _downloadTokenTimer.start();
+        _downloadTokens = rate;
+    }
+    const qint64 now = _downloadTokenTimer.elapsed();
+    if (now < _downloadHoldUntil) {
+        return static_cast<int>(_downloadHoldUntil - now);
+    }
+    //-- Refill for the time since the last call, capped at one second worth
+    _downloadTokens = qMin(rate, _downloadTokens + (now - _downloadTokenRefill) * rate / 1000.0);
+    _downloadTokenRefill = now;
+    if (_downloadTokens < 1.0) {
+        return qMax(1, static_cast<int>(std::ceil((1.0 - _downloadTokens) * 1000.0 / rate)));
+    }
+    _downloadTokens -= 1.0;
+    return 0;
+}
+
+void MapProvider::backoffDownloads(int msecs) {
+    if (!_downloadTokenTimer.isValid()) {
+        _downloadTokenTimer.start();
+        _downloadTokens = maxDownloadRate();
+    }
+    _downloadHoldUntil = qMax(_downloadHoldUntil, _downloadTokenTimer.elapsed() + msecs);
+    //-- Start again from an empty bucket so we don't burst straight back into the server
+    _downloadTokens      = 0;
+    _downloadTokenRefill = _downloadHoldUntil;
+}
+
 QString MapProvider::_tileXYToQuadKey(const int tileX, const int tileY, const int levelOfDetail) const {
     QString quadKey;
     for (int i = levelOfDetail; i > 0; i--) {
@@ -106,3 +143,26 @@ QGCTileSet MapProvider::getTileCount(const int zoom, const double topleftLon,
     set.tileSize = getAverageSize() * set.tileCount;
     return set;
 }
+
+QVector<QGCTileSet> MapProvider::getTileRanges(const int minZoom, const int maxZoom, const double topleftLon,
+                                               const double topleftLat, const double bottomRightLon,
+                                               const double bottomRightLat) const {
+    QVector<QGCTileSet> ranges;
+    if (maxZoom < minZoom) {
+        return ranges;
+    }
+    QGCTileSet top = getTileCount(maxZoom, topleftLon, topleftLat, bottomRightLon, bottomRightLat);
+    ranges.resize(maxZoom - minZoom + 1);
+    for (int z = minZoom; z <= maxZoom; z++) {
+        const int   shift   = maxZoom - z;
+        QGCTileSet& set     = ranges[z - minZoom];
+        set.tileX0      = top.tileX0 >> shift;
+        set.tileY0      = top.tileY0 >> shift;
+        set.tileX1      = top.tileX1 >> shift;
+        set.tileY1      = top.tileY1 >> shift;
+        set.tileCount   = (static_cast<quint64>(set.tileX1) - static_cast<quint64>(set.tileX0) + 1) *
+                          (static_cast<quint64>(set.tileY1) - static_cast<quint64>(set.tileY0) + 1);
+        set.tileSize    = getAverageSize() * set.tileCount;
+    }
+    return ranges;
+}
@@ -11,6 +11,8 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QElapsedTimer>
+#include <QVector>
 
 #include <cmath>
 
@@ -52,6 +54,23 @@ public:
                                      const double topleftLat, const double bottomRightLon,
                                      const double bottomRightLat) const;
 
+    // Tile ranges for every zoom level from minZoom to maxZoom, indexed by zoom - minZoom. Tile coordinates are only
+    // worked out at maxZoom. Each level below holds the same tiles shifted down, since floor(v * 2^z) is exactly
+    // floor(v * 2^maxZoom) >> (maxZoom - z), which keeps the ranges identical to getTileCount for each zoom.
+    virtual QVector<QGCTileSet> getTileRanges(const int minZoom, const int maxZoom, const double topleftLon,
+                                              const double topleftLat, const double bottomRightLon,
+                                              const double bottomRightLat) const;
+
+    // Offline downloads are paced with a token bucket per provider, which is shared by all tile sets downloading from it
+    // Tiles per second allowed for offline downloads, the bucket holds up to one second worth of requests
+    virtual double maxDownloadRate() const { return 50.0; }
+
+    // Returns 0 if a download request may go out now, otherwise the msecs until a token is available
+    int takeDownloadToken();
+
+    // Holds back all downloads from this provider, used when the server asks us to slow down
+    void backoffDownloads(int msecs);
+
 protected:
     QString _tileXYToQuadKey(const int tileX, const int tileY, const int levelOfDetail) const;
     int _getServerNum(const int x, const int y, const int max) const;
@@ -66,4 +85,10 @@ protected:
     QString     _language;
     QGeoMapType::MapStyle _mapType;
 
+private:
+    double          _downloadTokens         = 0;
+    QElapsedTimer   _downloadTokenTimer;
+    qint64          _downloadTokenRefill    = 0;    // msecs on _downloadTokenTimer when tokens were last added
+    qint64          _downloadHoldUntil      = 0;    // msecs on _downloadTokenTimer
+
 };
@@ -18,19 +18,24 @@
 #include "QGCApplication.h"
 #include "AppSettings.h"
 #include "SettingsManager.h"
+#include "OfflineMapsSettings.h"
 
 #include <math.h>
 #include <QSettings>
 #include <QStandardPaths>
 #include <QDir>
+#include <QImageReader>
+#include <QImageWriter>
 #include <stdio.h>
 
 #include "QGCMapEngine.h"
 #include "QGCMapTileSet.h"
+#include "QGCInstrumentation.h"
 
 Q_DECLARE_METATYPE(QGCMapTask::TaskType)
 Q_DECLARE_METATYPE(QGCTile)
 Q_DECLARE_METATYPE(QList<QGCTile*>)
+Q_DECLARE_METATYPE(QList<QGCTile>)
 
 static const char* kDbFileName = "qgcMapCache.db";
 static QLocale kLocale;
@@ -44,6 +49,12 @@ struct stQGeoTileCacheQGCMapTypes {
 
 static const char* kMaxDiskCacheKey = "MaxDiskCache";
 static const char* kMaxMemCacheKey  = "MaxMemoryCache";
+static const char* kMountedArchivesKey = "MountedTileArchives";
+static const int   kTileCacheFormatWebP = 1;    ///< OfflineMapsSettings::tileCacheFormat
+
+QGC_INSTRUMENT_COUNTER  (TileMemoryCacheHits,   "TileCache.MemoryHits")
+QGC_INSTRUMENT_COUNTER  (TileMemoryCacheMisses, "TileCache.MemoryMisses")
+QGC_INSTRUMENT_GAUGE    (TileMemoryCacheBytes,  "TileCache.MemoryBytes")
 
 //-----------------------------------------------------------------------------
 // Singleton
@@ -94,6 +105,8 @@ QGCMapEngine::QGCMapEngine()
     qRegisterMetaType<QGCMapTask::TaskType>();
     qRegisterMetaType<QGCTile>();
     qRegisterMetaType<QList<QGCTile*>>();
+    qRegisterMetaType<QList<QGCTile>>();
+    qRegisterMetaType<QVector<QGCTileRangeStats>>();
     connect(&_worker, &QGCCacheWorker::updateTotals,   this, &QGCMapEngine::_updateTotals);
     connect(&_worker, &QGCCacheWorker::internetStatus, this, &QGCMapEngine::_internetStatus);
 }
@@ -165,8 +178,17 @@ QGCMapEngine::init()
     } else {
         qCritical() << "Could not find suitable map cache directory.";
     }
+    //-- Value saved in MB
+    _memoryCacheMutex.lock();
+    _memoryCache.setMaxCost(static_cast<int>(getMaxMemCache()) * 1024 * 1024);
+    _memoryCacheMutex.unlock();
     QGCMapTask* task = new QGCMapTask(QGCMapTask::taskInit);
     _worker.enqueueTask(task);
+    //-- Bring back archives mounted in previous sessions
+    QSettings settings;
+    for(const QString& path : settings.value(kMountedArchivesKey).toStringList()) {
+        mountArchive(path);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -213,7 +235,13 @@ QGCMapEngine::cacheTile(QString type, const QString& hash, const QByteArray& ima
     AppSettings* appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
     //-- If we are allowed to persist data, save tile to cache
     if(!appSettings->disableAllPersistence()->rawValue().toBool()) {
-        QGCSaveTileTask* task = new QGCSaveTileTask(new QGCCacheTile(hash, image, format, type, set));
+        //-- Re-encoding is left to the worker thread. Without the image plugin to read them back the tiles stay as they are.
+        static const bool webpSupported = QImageReader::supportedImageFormats().contains("webp") && QImageWriter::supportedImageFormats().contains("webp");
+        QString transcodeFormat;
+        if(webpSupported && qgcApp()->toolbox()->settingsManager()->offlineMapsSettings()->tileCacheFormat()->rawValue().toInt() == kTileCacheFormatWebP) {
+            transcodeFormat = QStringLiteral("webp");
+        }
+        QGCSaveTileTask* task = new QGCSaveTileTask(new QGCCacheTile(hash, image, format, type, set), transcodeFormat);
         _worker.enqueueTask(task);
     }
 }
@@ -242,6 +270,45 @@ QGCMapEngine::createFetchTileTask(QString type, int x, int y, int z)
 	return task;
 }
 
+//-----------------------------------------------------------------------------
+bool
+QGCMapEngine::getMemoryCachedTile(const QString& hash, QByteArray& image, QString& format)
+{
+    QMutexLocker lock(&_memoryCacheMutex);
+    //-- Looking a tile up also makes it the most recently used one
+    MemoryTile_t* tile = _memoryCache.object(hash);
+    if(!tile) {
+        QGC_INSTRUMENT_ADD(TileMemoryCacheMisses, 1);
+        return false;
+    }
+    QGC_INSTRUMENT_ADD(TileMemoryCacheHits, 1);
+    image  = tile->image;
+    format = tile->format;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngine::memoryCacheTile(const QString& hash, const QByteArray& image, const QString& format)
+{
+    if(image.isEmpty()) {
+        return;
+    }
+    QMutexLocker lock(&_memoryCacheMutex);
+    //-- QCache takes ownership and evicts the least recently used tiles to stay within budget
+    _memoryCache.insert(hash, new MemoryTile_t{image, format}, image.size());
+    QGC_INSTRUMENT_SET(TileMemoryCacheBytes, _memoryCache.totalCost());
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngine::clearMemoryCache()
+{
+    QMutexLocker lock(&_memoryCacheMutex);
+    _memoryCache.clear();
+    QGC_INSTRUMENT_SET(TileMemoryCacheBytes, 0);
+}
+
 //-----------------------------------------------------------------------------
 	QGCTileSet
 QGCMapEngine::getTileCount(int zoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, QString mapType)
@@ -252,6 +319,17 @@ QGCMapEngine::getTileCount(int zoom, double topleftLon, double topleftLat, doubl
     return getQGCMapEngine()->urlFactory()->getTileCount(zoom, topleftLon, topleftLat, bottomRightLon, bottomRightLat, mapType);
 }
 
+//-----------------------------------------------------------------------------
+//-- Ranges for a whole zoom range in one go, indexed by zoom - minZoom (after clamping)
+QVector<QGCTileSet>
+QGCMapEngine::getTileRanges(int minZoom, int maxZoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, QString mapType)
+{
+    if(minZoom <  1) minZoom = 1;
+    if(maxZoom > MAX_MAP_ZOOM) maxZoom = MAX_MAP_ZOOM;
+
+    return getQGCMapEngine()->urlFactory()->getTileRanges(minZoom, maxZoom, topleftLon, topleftLat, bottomRightLon, bottomRightLat, mapType);
+}
+
 
 //-----------------------------------------------------------------------------
 QStringList
@@ -308,6 +386,9 @@ QGCMapEngine::setMaxMemCache(quint32 size)
     QSettings settings;
     settings.setValue(kMaxMemCacheKey, size);
     _maxMemCache = size;
+    QMutexLocker lock(&_memoryCacheMutex);
+    _memoryCache.setMaxCost(static_cast<int>(size) * 1024 * 1024);
+    QGC_INSTRUMENT_SET(TileMemoryCacheBytes, _memoryCache.totalCost());
 }
 
 //-----------------------------------------------------------------------------
@@ -366,6 +447,35 @@ QGCMapEngine::_pruned()
     _prunning = false;
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCMapEngine::mountArchive(const QString& path, bool mount)
+{
+    QGCMountArchiveTask* task = new QGCMountArchiveTask(path, mount);
+    connect(task, &QGCMountArchiveTask::mountCompleted, this, &QGCMapEngine::_archiveMounted);
+    connect(task, &QGCMapTask::error, this, &QGCMapEngine::archiveError);
+    _worker.enqueueTask(task);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngine::_archiveMounted(QString path, bool mount, bool success)
+{
+    _mountedArchives.removeAll(path);
+    if(!mount) {
+        //-- Tiles from the archive may still be held in memory
+        clearMemoryCache();
+    } else if(success) {
+        _mountedArchives.append(path);
+    }
+    //-- A failed remount at startup is left in the settings in case the archive comes back (removable media)
+    if(success) {
+        QSettings settings;
+        settings.setValue(kMountedArchivesKey, _mountedArchives);
+    }
+    emit mountedArchivesChanged();
+}
+
 //-----------------------------------------------------------------------------
 int
 QGCMapEngine::concurrentDownloads(QString type)
@@ -20,6 +20,8 @@
 #define QGC_MAP_ENGINE_H
 
 #include <QString>
+#include <QCache>
+#include <QMutex>
 
 #include "QGCMapUrlEngine.h"
 #include "QGCMapEngineData.h"
@@ -39,6 +41,11 @@ public:
     void                        cacheTile           (QString type, int x, int y, int z, const QByteArray& image, const QString& format, qulonglong set = UINT64_MAX);
     void                        cacheTile           (QString type, const QString& hash, const QByteArray& image, const QString& format, qulonglong set = UINT64_MAX);
     QGCFetchTileTask*           createFetchTileTask (QString type, int x, int y, int z);
+    bool                        getMemoryCachedTile (const QString& hash, QByteArray& image, QString& format);
+    void                        memoryCacheTile     (const QString& hash, const QByteArray& image, const QString& format);
+    void                        clearMemoryCache    ();
+    void                        mountArchive        (const QString& path, bool mount = true);
+    QStringList                 mountedArchives     () { return _mountedArchives; }
     QStringList                 getMapNameList      ();
     const QString               userAgent           () { return _userAgent; }
     void                        setUserAgent        (const QString& ua) { _userAgent = ua; }
@@ -57,6 +64,7 @@ public:
 
     //-- Tile Math
     static QGCTileSet           getTileCount        (int zoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, QString mapType);
+    static QVector<QGCTileSet>  getTileRanges       (int minZoom, int maxZoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, QString mapType);
     static QString              getTileHash         (QString type, int x, int y, int z);
     static QString              getTypeFromName     (const QString &name);
     static QString              bigSizeToString     (quint64 size);
@@ -68,10 +76,13 @@ private slots:
     void _updateTotals          (quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
     void _pruned                ();
     void _internetStatus        (bool active);
+    void _archiveMounted        (QString path, bool mount, bool success);
 
 signals:
     void updateTotals           (quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
     void internetUpdated        ();
+    void mountedArchivesChanged ();
+    void archiveError           (QGCMapTask::TaskType type, QString error);
 
 private:
     void _wipeOldCaches         ();
@@ -79,6 +90,12 @@ private:
     bool _wipeDirectory         (const QString& dirPath);
 
 private:
+    //-- Recently used tile bytes kept in front of the SQLite cache
+    typedef struct {
+        QByteArray  image;
+        QString     format;
+    } MemoryTile_t;
+
     QGCCacheWorker          _worker;
     QString                 _cachePath;
     QString                 _cacheFile;
@@ -89,6 +106,9 @@ private:
     bool                    _prunning;
     bool                    _cacheWasReset;
     bool                    _isInternetActive;
+    QCache<QString, MemoryTile_t> _memoryCache;     ///< Cost is the tile size in bytes
+    QMutex                  _memoryCacheMutex;
+    QStringList             _mountedArchives;       ///< Read only MBTiles archives searched on a cache miss
 };
 
 extern QGCMapEngine*    getQGCMapEngine();
@@ -21,6 +21,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QHash>
 #include <QDateTime>
 
@@ -122,7 +123,11 @@ public:
         taskPruneCache,
         taskReset,
         taskExport,
-        taskImport
+        taskImport,
+        taskMountArchive,
+        taskCheckTiles,
+        taskExportManifest,
+        taskTileRangeStats
     };
 
     QGCMapTask(TaskType type)
@@ -236,9 +241,11 @@ class QGCSaveTileTask : public QGCMapTask
 {
     Q_OBJECT
 public:
-    QGCSaveTileTask(QGCCacheTile* tile)
+    //-- transcodeFormat: image format the worker re-encodes the tile to before saving it, empty to save it as is
+    QGCSaveTileTask(QGCCacheTile* tile, const QString& transcodeFormat = QString())
         : QGCMapTask(QGCMapTask::taskCacheTile)
         , _tile(tile)
+        , _transcodeFormat(transcodeFormat)
     {}
 
     ~QGCSaveTileTask()
@@ -247,10 +254,12 @@ public:
         _tile = nullptr;
     }
 
-    QGCCacheTile*   tile() { return _tile; }
+    QGCCacheTile*   tile            () { return _tile; }
+    QString         transcodeFormat () { return _transcodeFormat; }
 
 private:
     QGCCacheTile*   _tile;
+    QString         _transcodeFormat;
 };
 
 //-----------------------------------------------------------------------------
@@ -292,7 +301,16 @@ public:
         , _hash(hash)
     {}
 
+    //-- Updates a batch of tiles at once
+    QGCUpdateTileDownloadStateTask(qulonglong setID, QGCTile::TyleState state, const QStringList& hashes)
+        : QGCMapTask(QGCMapTask::taskUpdateTileDownloadState)
+        , _setID(setID)
+        , _state(state)
+        , _hashes(hashes)
+    {}
+
     QString             hash    () { return _hash; }
+    QStringList         hashes  () { return _hashes; }
     qulonglong          setID   () { return _setID; }
     QGCTile::TyleState  state   () { return _state; }
 
@@ -300,6 +318,7 @@ private:
     qulonglong          _setID;
     QGCTile::TyleState  _state;
     QString             _hash;
+    QStringList         _hashes;
 };
 
 //-----------------------------------------------------------------------------
@@ -392,18 +411,21 @@ class QGCExportTileTask : public QGCMapTask
 {
     Q_OBJECT
 public:
-    QGCExportTileTask(QVector<QGCCachedTileSet*> sets, QString path)
+    //-- Given a manifest from the target cache, only the tiles it lacks or holds a different image for are exported
+    QGCExportTileTask(QVector<QGCCachedTileSet*> sets, QString path, QString manifestPath = QString())
         : QGCMapTask(QGCMapTask::taskExport)
         , _sets(sets)
         , _path(path)
+        , _manifestPath(manifestPath)
     {}
 
     ~QGCExportTileTask()
     {
     }
 
-    QVector<QGCCachedTileSet*> sets() { return _sets; }
-    QString                    path() { return _path; }
+    QVector<QGCCachedTileSet*> sets        () { return _sets; }
+    QString                    path        () { return _path; }
+    QString                    manifestPath() { return _manifestPath; }
 
     void setExportCompleted()
     {
@@ -418,6 +440,43 @@ public:
 private:
     QVector<QGCCachedTileSet*>  _sets;
     QString                     _path;
+    QString                     _manifestPath;
+
+signals:
+    void actionCompleted        ();
+    void actionProgress         (int percentage);
+
+};
+
+//-----------------------------------------------------------------------------
+//-- Writes the hash and image CRC of every tile in the cache, for a delta export from another cache
+class QGCExportManifestTask : public QGCMapTask
+{
+    Q_OBJECT
+public:
+    QGCExportManifestTask(QString path)
+        : QGCMapTask(QGCMapTask::taskExportManifest)
+        , _path(path)
+    {}
+
+    ~QGCExportManifestTask()
+    {
+    }
+
+    QString                    path() { return _path; }
+
+    void setExportCompleted()
+    {
+        emit actionCompleted();
+    }
+
+    void setProgress(int percentage)
+    {
+        emit actionProgress(percentage);
+    }
+
+private:
+    QString                     _path;
 
 signals:
     void actionCompleted        ();
@@ -463,4 +522,103 @@ signals:
 
 };
 
+//-----------------------------------------------------------------------------
+class QGCMountArchiveTask : public QGCMapTask
+{
+    Q_OBJECT
+public:
+    QGCMountArchiveTask(QString path, bool mount)
+        : QGCMapTask(QGCMapTask::taskMountArchive)
+        , _path(path)
+        , _mount(mount)
+    {}
+
+    ~QGCMountArchiveTask()
+    {
+    }
+
+    QString                    path     () { return _path; }
+    bool                       mount    () { return _mount; }
+
+    void setMountCompleted(bool success)
+    {
+        emit mountCompleted(_path, _mount, success);
+    }
+
+private:
+    QString                     _path;
+    bool                        _mount;
+
+signals:
+    void mountCompleted         (QString path, bool mount, bool success);
+
+};
+
+//-----------------------------------------------------------------------------
+//-- Finds which of a list of tiles are not in the cache. Runs in the worker's background queue.
+class QGCCheckTilesTask : public QGCMapTask
+{
+    Q_OBJECT
+public:
+    QGCCheckTilesTask(const QList<QGCTile>& tiles)
+        : QGCMapTask(QGCMapTask::taskCheckTiles)
+        , _tiles(tiles)
+    {}
+
+    const QList<QGCTile>& tiles() { return _tiles; }
+
+    void setTilesChecked(QList<QGCTile> missing)
+    {
+        emit tilesChecked(missing);
+    }
+
+signals:
+    void            tilesChecked    (QList<QGCTile> missing);
+
+private:
+    QList<QGCTile>  _tiles;
+};
+
+//-----------------------------------------------------------------------------
+//-- Cache figures for one zoom level of a download area
+struct QGCTileRangeStats
+{
+    quint64 cachedCount     = 0;    ///< Tiles in the area already in the cache
+    quint64 cachedSize      = 0;
+    quint64 observedCount   = 0;    ///< Tiles of this type and zoom ever saved to the cache, for the average tile size
+    quint64 observedSize    = 0;
+};
+Q_DECLARE_METATYPE(QGCTileRangeStats)
+
+//-----------------------------------------------------------------------------
+//-- Looks up how much of a download area is cached already, zoom level by zoom level
+class QGCTileRangeStatsTask : public QGCMapTask
+{
+    Q_OBJECT
+public:
+    QGCTileRangeStatsTask(const QString& mapType, int minZoom, const QVector<QGCTileSet>& ranges)
+        : QGCMapTask(QGCMapTask::taskTileRangeStats)
+        , _mapType(mapType)
+        , _minZoom(minZoom)
+        , _ranges(ranges)
+    {}
+
+    const QString&              mapType () { return _mapType; }
+    int                         minZoom () { return _minZoom; }
+    const QVector<QGCTileSet>&  ranges  () { return _ranges; }   ///< Indexed by zoom - minZoom
+
+    void setRangeStats(QVector<QGCTileRangeStats> stats)
+    {
+        emit rangeStatsFetched(stats);
+    }
+
+signals:
+    void                rangeStatsFetched   (QVector<QGCTileRangeStats> stats);
+
+private:
+    QString             _mapType;
+    int                 _minZoom;
+    QVector<QGCTileSet> _ranges;
+};
+
 #endif // QGC_MAP_ENGINE_DATA_H
@@ -20,6 +20,7 @@
 #include "QGCMapTileSet.h"
 #include "QGCMapEngineManager.h"
 #include "TerrainTile.h"
+#include "QGCNetworkManager.h"
 
 #include <QSettings>
 #include <math.h>
@@ -28,6 +29,14 @@ QGC_LOGGING_CATEGORY(QGCCachedTileSetLog, "QGCCachedTileSetLog")
 
 #define TILE_BATCH_SIZE      256
 
+//-- Completed tiles are marked in the database in batches of this size, or after STATE_FLUSH_MSECS if the batch is not full
+#define TILE_STATE_BATCH     64
+#define STATE_FLUSH_MSECS    1000
+
+//-- Transient failures are retried with an exponential backoff starting at RETRY_BACKOFF_MSECS
+#define MAX_TILE_RETRIES     3
+#define RETRY_BACKOFF_MSECS  1000
+
 //-----------------------------------------------------------------------------
 QGCCachedTileSet::QGCCachedTileSet(const QString& name)
     : _name(name)
@@ -50,19 +59,29 @@ QGCCachedTileSet::QGCCachedTileSet(const QString& name)
     , _type("Invalid")
     , _networkManager(nullptr)
     , _errorCount(0)
+    , _retriesPending(0)
     , _noMoreTiles(false)
     , _batchRequested(false)
     , _manager(nullptr)
     , _selected(false)
 {
-
+    _rateLimitTimer.setSingleShot(true);
+    connect(&_rateLimitTimer, &QTimer::timeout, this, &QGCCachedTileSet::_prepareDownload);
+    _stateFlushTimer.setSingleShot(true);
+    _stateFlushTimer.setInterval(STATE_FLUSH_MSECS);
+    connect(&_stateFlushTimer, &QTimer::timeout, this, &QGCCachedTileSet::_flushDownloadState);
 }
 
 //-----------------------------------------------------------------------------
 QGCCachedTileSet::~QGCCachedTileSet()
 {
-    delete _networkManager;
-    _networkManager = nullptr;
+    //-- The replies belong to the shared network manager
+    for(QNetworkReply* reply : _replies) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+    qDeleteAll(_activeTiles);
 }
 
 //-----------------------------------------------------------------------------
@@ -166,6 +185,8 @@ QGCCachedTileSet::cancelDownloadTask()
 {
     if(_downloading) {
         _downloading = false;
+        _rateLimitTimer.stop();
+        _flushDownloadState();
         emit downloadingChanged();
     }
 }
@@ -185,7 +206,7 @@ QGCCachedTileSet::_tileListFetched(QList<QGCTile *> tiles)
     }
     //-- If this is the first time, create Network Manager
     if (!_networkManager) {
-        _networkManager = new QNetworkAccessManager(this);
+        _networkManager = QGCNetworkManager::instance();
     }
     //-- Add tiles to the list
     _tilesToDownload += tiles;
@@ -196,6 +217,7 @@ QGCCachedTileSet::_tileListFetched(QList<QGCTile *> tiles)
 //-----------------------------------------------------------------------------
 void QGCCachedTileSet::_doneWithDownload()
 {
+    _flushDownloadState();
     if(!_errorCount) {
         _totalTileCount = _savedTileCount;
         _totalTileSize  = _savedTileSize;
@@ -224,10 +246,15 @@ void QGCCachedTileSet::_doneWithDownload()
 //-----------------------------------------------------------------------------
 void QGCCachedTileSet::_prepareDownload()
 {
+    if(!_downloading) {
+        return;
+    }
     if(!_tilesToDownload.count()) {
-        //-- Are we done?
+        //-- Are we done? Wait for requests in flight and retries to settle first.
         if(_noMoreTiles) {
-            _doneWithDownload();
+            if(_replies.isEmpty() && !_retriesPending) {
+                _doneWithDownload();
+            }
         } else {
             if(!_batchRequested)
                 createDownloadTask();
@@ -235,40 +262,85 @@ void QGCCachedTileSet::_prepareDownload()
         return;
     }
     //-- Prepare queue (QNetworkAccessManager has a limit for concurrent downloads)
-    for(int i = _replies.count(); i < QGCMapEngine::concurrentDownloads(_type); i++) {
-        if(_tilesToDownload.count()) {
-            QGCTile* tile = _tilesToDownload.first();
-            _tilesToDownload.removeFirst();
-            QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(tile->type(), tile->x(), tile->y(), tile->z(), _networkManager);
-            request.setAttribute(QNetworkRequest::User, tile->hash());
-#if !defined(__mobile__)
-            QNetworkProxy proxy = _networkManager->proxy();
-            QNetworkProxy tProxy;
-            tProxy.setType(QNetworkProxy::DefaultProxy);
-            _networkManager->setProxy(tProxy);
-#endif
-            QNetworkReply* reply = _networkManager->get(request);
-            reply->setParent(0);
-            connect(reply, &QNetworkReply::finished, this, &QGCCachedTileSet::_networkReplyFinished);
+    while(_replies.count() < QGCMapEngine::concurrentDownloads(_type) && _tilesToDownload.count()) {
+        QGCTile* tile = _tilesToDownload.first();
+        MapProvider* provider = getQGCMapEngine()->urlFactory()->getProviderTable().value(tile->type());
+        int waitMSecs = provider ? provider->takeDownloadToken() : 0;
+        if(waitMSecs) {
+            //-- Provider rate limit reached, pick up again once the next request is allowed
+            if(!_rateLimitTimer.isActive()) {
+                _rateLimitTimer.start(waitMSecs);
+            }
+            break;
+        }
+        _tilesToDownload.removeFirst();
+        QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(tile->type(), tile->x(), tile->y(), tile->z(), _networkManager);
+        request.setAttribute(QNetworkRequest::User, tile->hash());
+        //-- Offline sets limit their own concurrency. Low priority keeps them out of the way of the tiles in view.
+        QGCNetworkManager::setPriority(request, QGCNetworkManager::PriorityBackground);
+        QNetworkReply* reply = _networkManager->get(request);
+        reply->setParent(0);
+        connect(reply, &QNetworkReply::finished, this, &QGCCachedTileSet::_networkReplyFinished);
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-            connect(reply, static_cast<void (QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &QGCCachedTileSet::_networkReplyError);
+        connect(reply, static_cast<void (QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &QGCCachedTileSet::_networkReplyError);
 #else
-            connect(reply, &QNetworkReply::errorOccurred, this, &QGCCachedTileSet::_networkReplyError);
+        connect(reply, &QNetworkReply::errorOccurred, this, &QGCCachedTileSet::_networkReplyError);
 #endif
-            _replies.insert(tile->hash(), reply);
-#if !defined(__mobile__)
-            _networkManager->setProxy(proxy);
-#endif
-            delete tile;
-            //-- Refill queue if running low
-            if(!_batchRequested && !_noMoreTiles && _tilesToDownload.count() < (QGCMapEngine::concurrentDownloads(_type) * 10)) {
-                //-- Request new batch of tiles
-                createDownloadTask();
-            }
+        _replies.insert(tile->hash(), reply);
+        _activeTiles.insert(tile->hash(), tile);
+        //-- Refill queue if running low
+        if(!_batchRequested && !_noMoreTiles && _tilesToDownload.count() < (QGCMapEngine::concurrentDownloads(_type) * 10)) {
+            //-- Request new batch of tiles
+            createDownloadTask();
         }
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCachedTileSet::_tileDownloadComplete(const QString& hash)
+{
+    _completedHashes.append(hash);
+    if(_completedHashes.count() >= TILE_STATE_BATCH) {
+        _flushDownloadState();
+    } else if(!_stateFlushTimer.isActive()) {
+        _stateFlushTimer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCachedTileSet::_flushDownloadState()
+{
+    _stateFlushTimer.stop();
+    if(_completedHashes.count()) {
+        QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, _completedHashes);
+        getQGCMapEngine()->addTask(task);
+        _completedHashes.clear();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCachedTileSet::_isTransientError(QNetworkReply* reply, QNetworkReply::NetworkError error)
+{
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if(status == 429 || status >= 500) {
+        return true;
+    }
+    switch(error) {
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCachedTileSet::_networkReplyFinished()
@@ -288,6 +360,8 @@ QGCCachedTileSet::_networkReplyFinished()
             } else {
                 qWarning() << "QGCMapEngineManager::networkReplyFinished() Reply not in list: " << hash;
             }
+            delete _activeTiles.take(hash);
+            _retryCounts.remove(hash);
             qCDebug(QGCCachedTileSetLog) << "Tile fetched" << hash;
             QByteArray image = reply->readAll();
             QString type = getQGCMapEngine()->hashToType(hash);
@@ -298,8 +372,7 @@ QGCCachedTileSet::_networkReplyFinished()
             if(!format.isEmpty()) {
                 //-- Cache tile
                 getQGCMapEngine()->cacheTile(type, hash, image, format, _id);
-                QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, hash);
-                getQGCMapEngine()->addTask(task);
+                _tileDownloadComplete(hash);
                 //-- Updated cached (downloaded) data
                 _savedTileSize += image.size();
                 _savedTileCount++;
@@ -332,9 +405,6 @@ QGCCachedTileSet::_networkReplyError(QNetworkReply::NetworkError error)
     if (!reply) {
         return;
     }
-    //-- Update error count
-    _errorCount++;
-    emit errorCountChanged();
     //-- Get tile hash
     QString hash = reply->request().attribute(QNetworkRequest::User).toString();
     qCDebug(QGCCachedTileSetLog) << "Error fetching tile" << reply->errorString();
@@ -344,12 +414,47 @@ QGCCachedTileSet::_networkReplyError(QNetworkReply::NetworkError error)
         } else {
             qWarning() << "QGCMapEngineManager::networkReplyError() Reply not in list: " << hash;
         }
-        if (error != QNetworkReply::OperationCanceledError) {
-            qWarning() << "QGCMapEngineManager::networkReplyError() Error:" << reply->errorString();
+        QGCTile* tile = _activeTiles.take(hash);
+        if(tile && _downloading && _retryCounts.value(hash) < MAX_TILE_RETRIES && _isTransientError(reply, error)) {
+            int retry = ++_retryCounts[hash];
+            int backoffMSecs = RETRY_BACKOFF_MSECS << (retry - 1);
+            //-- Respect the server if it tells us when to come back
+            bool ok = false;
+            int retryAfterSecs = reply->rawHeader("Retry-After").toInt(&ok);
+            if(ok && retryAfterSecs > 0) {
+                backoffMSecs = qMax(backoffMSecs, retryAfterSecs * 1000);
+            }
+            int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            if(status == 429 || status == 503) {
+                //-- Server is asking us to slow down, hold back everything going to it
+                MapProvider* provider = getQGCMapEngine()->urlFactory()->getProviderTable().value(tile->type());
+                if(provider) {
+                    provider->backoffDownloads(backoffMSecs);
+                }
+            }
+            qCDebug(QGCCachedTileSetLog) << "Retrying tile" << hash << "in" << backoffMSecs << "msecs";
+            _retriesPending++;
+            QTimer::singleShot(backoffMSecs, this, [this, tile]() {
+                _retriesPending--;
+                _tilesToDownload.prepend(tile);
+                _prepareDownload();
+            });
+        } else {
+            delete tile;
+            _retryCounts.remove(hash);
+            //-- Update error count
+            _errorCount++;
+            emit errorCountChanged();
+            if (error != QNetworkReply::OperationCanceledError) {
+                qWarning() << "QGCMapEngineManager::networkReplyError() Error:" << reply->errorString();
+            }
+            QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateError, hash);
+            getQGCMapEngine()->addTask(task);
         }
-        QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateError, hash);
-        getQGCMapEngine()->addTask(task);
     } else {
+        //-- Update error count
+        _errorCount++;
+        emit errorCountChanged();
         qWarning() << "QGCMapEngineManager::networkReplyError() Empty Hash";
     }
     //-- Setup a new download
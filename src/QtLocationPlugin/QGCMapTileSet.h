@@ -24,6 +24,7 @@
 #include <QHash>
 #include <QDateTime>
 #include <QImage>
+#include <QTimer>
 
 #include "QGCLoggingCategory.h"
 #include "QGCMapEngineData.h"
@@ -153,10 +154,13 @@ private slots:
     void _tileListFetched               (QList<QGCTile*> tiles);
     void _networkReplyFinished          ();
     void _networkReplyError             (QNetworkReply::NetworkError error);
+    void _prepareDownload               ();
+    void _flushDownloadState            ();
 
 private:
-    void        _prepareDownload        ();
     void        _doneWithDownload       ();
+    void        _tileDownloadComplete   (const QString& hash);
+    bool        _isTransientError       (QNetworkReply* reply, QNetworkReply::NetworkError error);
 
 private:
     QString     _name;
@@ -184,6 +188,12 @@ private:
     quint32     _errorCount;
     //-- Tile download
     QList<QGCTile *> _tilesToDownload;
+    QHash<QString, QGCTile*> _activeTiles;      ///< Tiles with a request in flight, kept around for retries
+    QHash<QString, int> _retryCounts;
+    int         _retriesPending;
+    QStringList _completedHashes;               ///< Downloaded tiles not yet marked complete in the database
+    QTimer      _rateLimitTimer;
+    QTimer      _stateFlushTimer;
     bool        _noMoreTiles;
     bool        _batchRequested;
     QGCMapEngineManager* _manager;
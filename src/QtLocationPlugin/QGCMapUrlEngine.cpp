@@ -200,6 +200,12 @@ UrlFactory::getTileCount(int zoom, double topleftLon, double topleftLat, double
 	return _providersTable[mapType]->getTileCount(zoom, topleftLon, topleftLat, bottomRightLon, bottomRightLat);
 }
 
+QVector<QGCTileSet>
+UrlFactory::getTileRanges(int minZoom, int maxZoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, QString mapType)
+{
+	return _providersTable[mapType]->getTileRanges(minZoom, maxZoom, topleftLon, topleftLat, bottomRightLon, bottomRightLat);
+}
+
 bool UrlFactory::isElevation(int mapId){
     return _providersTable[getTypeFromId(mapId)]->_isElevationProvider();
 }
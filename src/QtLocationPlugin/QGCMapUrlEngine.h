@@ -53,6 +53,9 @@ public:
     QGCTileSet getTileCount(int zoom, double topleftLon, double topleftLat,
                             double bottomRightLon, double bottomRightLat,
                             QString mapType);
+    QVector<QGCTileSet> getTileRanges(int minZoom, int maxZoom, double topleftLon, double topleftLat,
+                                      double bottomRightLon, double bottomRightLat,
+                                      QString mapType);
 
     bool isElevation(int mapId);
 
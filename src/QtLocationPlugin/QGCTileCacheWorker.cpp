@@ -18,32 +18,122 @@
 
 #include "QGCMapEngine.h"
 #include "QGCMapTileSet.h"
+#include "QGCInstrumentation.h"
+#include "QGC.h"
 
 #include <QVariant>
 #include <QtSql/QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
 #include <QDebug>
 #include <QDateTime>
 #include <QApplication>
 #include <QFile>
+#include <QFileInfo>
 #include <QSettings>
+#include <QBuffer>
+#include <QImage>
+#include <QImageWriter>
 
 #include "time.h"
 
 static const char*      kDefaultSet     = "Default Tile Set";
 static const QString    kSession        = QStringLiteral("QGeoTileWorkerSession");
 static const QString    kExportSession  = QStringLiteral("QGeoTileExportSession");
+static const QString    kArchiveSession = QStringLiteral("QGeoTileArchiveSession");
+static const QString    kManifestSession= QStringLiteral("QGeoTileManifestSession");
+static const char*      kMBTilesMapType = "qgc_map_type";
+//-- Zoom levels wider than this many tile columns are counted with one pass over the type instead of a lookup per column
+static const int        kMaxRangeStatsColumns = 256;
 
 QGC_LOGGING_CATEGORY(QGCTileCacheLog, "QGCTileCacheLog")
 
+QGC_INSTRUMENT_HISTOGRAM(TileCacheTaskTime,     "TileCache.Task")
+QGC_INSTRUMENT_HISTOGRAM(TileCacheFetchTime,    "TileCache.FetchTile")
+QGC_INSTRUMENT_HISTOGRAM(TileCacheSaveTime,     "TileCache.SaveTile")
+QGC_INSTRUMENT_GAUGE    (TileCacheQueueDepth,   "TileCache.QueueDepth")
+
 //-- Update intervals
 
 #define LONG_TIMEOUT        5
 #define SHORT_TIMEOUT       2
 
+//-- Most tiles written in a single transaction, so interactive fetches queued behind a large batch are not held up for long
+#define MAX_SAVE_BATCH      256
+
+//-- Free pages released per incremental vacuum step, checking for queued work in between
+#define VACUUM_STEP_PAGES   256
+
+//-- Tiles copied per transaction when streaming MBTiles archives in or out
+#define MBTILES_BATCH       1000
+//-- Bytes of an MBTiles archive SQLite is allowed to memory map while reading it
+#define MBTILES_MMAP_SIZE   268435456
+
+//-----------------------------------------------------------------------------
+//-- Together with the tile hash, which is the tile's position, this tells whether two caches hold the same image
+static quint32
+_imageCRC(const QByteArray& img)
+{
+    return QGC::crc32(reinterpret_cast<const quint8*>(img.constData()), static_cast<unsigned>(img.size()), 0);
+}
+
+//-----------------------------------------------------------------------------
+//-- Re-encodes a downloaded PNG or JPEG tile. PNG tiles are mostly line work and text, so they are kept lossless.
+//   The original is kept when it is already the smaller of the two, which it often is for empty tiles.
+static bool
+_transcodeTile(QByteArray& img, QString& format, const QString& toFormat)
+{
+    const QString from = format.toLower();
+    if(from == toFormat || (from != "png" && from != "jpg" && from != "jpeg")) {
+        return false;
+    }
+    QImage image;
+    if(!image.loadFromData(img, from.toLatin1().constData())) {
+        return false;
+    }
+    QByteArray out;
+    QBuffer buffer(&out);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, toFormat.toLatin1());
+    writer.setQuality(from == "png" ? 100 : 80);
+    if(!writer.write(image) || out.size() >= img.size()) {
+        return false;
+    }
+    qCDebug(QGCTileCacheLog) << "_transcodeTile()" << from << img.size() << "->" << toFormat << out.size();
+    img    = out;
+    format = toFormat;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool
+_readManifest(const QString& path, QHash<QString, quint32>& manifest)
+{
+    bool res = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kManifestSession);
+        db.setDatabaseName(path);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        if(db.open()) {
+            QSqlQuery query(db);
+            query.setForwardOnly(true);
+            if(query.exec("SELECT hash, crc FROM ManifestTiles")) {
+                while(query.next()) {
+                    manifest[query.value(0).toString()] = query.value(1).toUInt();
+                }
+                res = true;
+            }
+        }
+    }
+    QSqlDatabase::removeDatabase(kManifestSession);
+    qCDebug(QGCTileCacheLog) << "_readManifest()" << path << manifest.count() << "tiles";
+    return res;
+}
+
 //-----------------------------------------------------------------------------
 QGCCacheWorker::QGCCacheWorker()
-    : _db(nullptr)
+    : _stopping(false)
+    , _db(nullptr)
     , _valid(false)
     , _failed(false)
     , _defaultSet(UINT64_MAX)
@@ -54,6 +144,8 @@ QGCCacheWorker::QGCCacheWorker()
     , _lastUpdate(0)
     , _updateTimeout(SHORT_TIMEOUT)
     , _hostLookupID(0)
+    , _vacuumPending(true)
+    , _archiveSessionID(0)
 {
 }
 
@@ -77,32 +169,51 @@ QGCCacheWorker::quit()
         QHostInfo::abortHostLookup(_hostLookupID);
     }
     _mutex.lock();
+    _stopping = true;
+    while(_fetchQueue.count()) {
+        QGCMapTask* task = _fetchQueue.dequeue();
+        delete task;
+    }
     while(_taskQueue.count()) {
         QGCMapTask* task = _taskQueue.dequeue();
         delete task;
     }
-    _mutex.unlock();
-    if(this->isRunning()) {
-        _waitc.wakeAll();
+    while(_backgroundQueue.count()) {
+        QGCMapTask* task = _backgroundQueue.dequeue();
+        delete task;
     }
+    _waitc.wakeAll();
+    _mutex.unlock();
 }
 
 //-----------------------------------------------------------------------------
 bool
 QGCCacheWorker::enqueueTask(QGCMapTask* task)
 {
-    //-- If not initialized, the only allowed task is Init
-    if(!_valid && task->type() != QGCMapTask::taskInit) {
+    //-- If not initialized, the only allowed tasks are Init and mounting archives, which do not use the cache database
+    if(!_valid && task->type() != QGCMapTask::taskInit && task->type() != QGCMapTask::taskMountArchive) {
         task->setError("Database Not Initialized");
         task->deleteLater();
         return false;
     }
     _mutex.lock();
-    _taskQueue.enqueue(task);
-    _mutex.unlock();
-    if(this->isRunning()) {
-        _waitc.wakeAll();
+    if(_stopping) {
+        _mutex.unlock();
+        task->deleteLater();
+        return false;
+    }
+    //-- Tiles the map is waiting on to draw go ahead of bulk work such as offline downloads
+    if(task->type() == QGCMapTask::taskFetchTile) {
+        _fetchQueue.enqueue(task);
+    } else if(task->type() == QGCMapTask::taskCheckTiles) {
+        _backgroundQueue.enqueue(task);
     } else {
+        _taskQueue.enqueue(task);
+    }
+    _waitc.wakeOne();
+    _mutex.unlock();
+    //-- Once started the thread stays up, with the database open, until quit()
+    if(!this->isRunning()) {
         this->start(QThread::HighPriority);
     }
     return true;
@@ -123,81 +234,50 @@ QGCCacheWorker::run()
     }
     _deleteBingNoTileTiles();
     while(true) {
+        _mutex.lock();
+        while(!_stopping && _fetchQueue.isEmpty() && _taskQueue.isEmpty() && _backgroundQueue.isEmpty()) {
+            _waitc.wait(&_mutex);
+        }
+        if(_stopping) {
+            _mutex.unlock();
+            break;
+        }
         QGCMapTask* task;
-        if(_taskQueue.count()) {
-            _mutex.lock();
+        if(!_fetchQueue.isEmpty()) {
+            task = _fetchQueue.dequeue();
+        } else if(!_taskQueue.isEmpty()) {
             task = _taskQueue.dequeue();
-            _mutex.unlock();
-            switch(task->type()) {
-                case QGCMapTask::taskInit:
-                    break;
-                case QGCMapTask::taskCacheTile:
-                    _saveTile(task);
-                    break;
-                case QGCMapTask::taskFetchTile:
-                    _getTile(task);
-                    break;
-                case QGCMapTask::taskFetchTileSets:
-                    _getTileSets(task);
-                    break;
-                case QGCMapTask::taskCreateTileSet:
-                    _createTileSet(task);
-                    break;
-                case QGCMapTask::taskGetTileDownloadList:
-                    _getTileDownloadList(task);
-                    break;
-                case QGCMapTask::taskUpdateTileDownloadState:
-                    _updateTileDownloadState(task);
-                    break;
-                case QGCMapTask::taskDeleteTileSet:
-                    _deleteTileSet(task);
-                    break;
-                case QGCMapTask::taskRenameTileSet:
-                    _renameTileSet(task);
-                    break;
-                case QGCMapTask::taskPruneCache:
-                    _pruneCache(task);
-                    break;
-                case QGCMapTask::taskReset:
-                    _resetCacheDatabase(task);
-                    break;
-                case QGCMapTask::taskExport:
-                    _exportSets(task);
-                    break;
-                case QGCMapTask::taskImport:
-                    _importSets(task);
-                    break;
-                case QGCMapTask::taskTestInternet:
-                    _testInternet();
-                    break;
-            }
-            task->deleteLater();
-            //-- Check for update timeout
-            size_t count = static_cast<size_t>(_taskQueue.count());
-            if(count > 100) {
-                _updateTimeout = LONG_TIMEOUT;
-            } else if(count < 25) {
-                _updateTimeout = SHORT_TIMEOUT;
-            }
-            if(!count || (time(nullptr) - _lastUpdate > _updateTimeout)) {
-                if(_valid) {
-                    _updateTotals();
-                }
-            }
         } else {
-            //-- Wait a bit before shutting things down
-            _waitmutex.lock();
-            unsigned long timeout = 5000;
-            _waitc.wait(&_waitmutex, timeout);
-            _waitmutex.unlock();
-            _mutex.lock();
-            //-- If nothing to do, close db and leave thread
-            if(!_taskQueue.count()) {
-                _mutex.unlock();
-                break;
+            task = _backgroundQueue.dequeue();
+        }
+        _mutex.unlock();
+        _runTask(task);
+        task->deleteLater();
+        //-- Check for update timeout
+        _mutex.lock();
+        size_t count = static_cast<size_t>(_fetchQueue.count() + _taskQueue.count() + _backgroundQueue.count());
+        QGC_INSTRUMENT_SET(TileCacheQueueDepth, static_cast<qint64>(count));
+        _mutex.unlock();
+        if(count > 100) {
+            _updateTimeout = LONG_TIMEOUT;
+        } else if(count < 25) {
+            _updateTimeout = SHORT_TIMEOUT;
+        }
+        if(!count || (time(nullptr) - _lastUpdate > _updateTimeout)) {
+            if(_valid) {
+                _flushTileAccess();
+                _updateTotals();
             }
-            _mutex.unlock();
         }
+        if(!count && _valid && _vacuumPending) {
+            _incrementalVacuum();
+        }
+    }
+    if(_valid) {
+        _flushTileAccess();
+    }
+    while(!_archives.isEmpty()) {
+        _unmountArchive(_archives.first().path);
     }
     if(_db) {
         delete _db;
@@ -206,6 +286,74 @@ QGCCacheWorker::run()
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_runTask(QGCMapTask* task)
+{
+    QGC_INSTRUMENT_SCOPE(TileCacheTaskTime);
+    switch(task->type()) {
+        case QGCMapTask::taskInit:
+            break;
+        case QGCMapTask::taskCacheTile:
+        {
+            QGC_INSTRUMENT_SCOPE(TileCacheSaveTime);
+            _saveTiles(task);
+            break;
+        }
+        case QGCMapTask::taskFetchTile:
+        {
+            QGC_INSTRUMENT_SCOPE(TileCacheFetchTime);
+            _getTile(task);
+            break;
+        }
+        case QGCMapTask::taskFetchTileSets:
+            _getTileSets(task);
+            break;
+        case QGCMapTask::taskCreateTileSet:
+            _createTileSet(task);
+            break;
+        case QGCMapTask::taskGetTileDownloadList:
+            _getTileDownloadList(task);
+            break;
+        case QGCMapTask::taskUpdateTileDownloadState:
+            _updateTileDownloadState(task);
+            break;
+        case QGCMapTask::taskDeleteTileSet:
+            _deleteTileSet(task);
+            break;
+        case QGCMapTask::taskRenameTileSet:
+            _renameTileSet(task);
+            break;
+        case QGCMapTask::taskPruneCache:
+            _pruneCache(task);
+            break;
+        case QGCMapTask::taskReset:
+            _resetCacheDatabase(task);
+            break;
+        case QGCMapTask::taskExport:
+            _exportSets(task);
+            break;
+        case QGCMapTask::taskImport:
+            _importSets(task);
+            break;
+        case QGCMapTask::taskExportManifest:
+            _exportManifest(task);
+            break;
+        case QGCMapTask::taskTileRangeStats:
+            _getTileRangeStats(task);
+            break;
+        case QGCMapTask::taskMountArchive:
+            _mountArchive(task);
+            break;
+        case QGCMapTask::taskCheckTiles:
+            _checkTiles(task);
+            break;
+        case QGCMapTask::taskTestInternet:
+            _testInternet();
+            break;
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_deleteBingNoTileTiles()
@@ -263,6 +411,24 @@ QGCCacheWorker::_findTileSetID(const QString name, quint64& setID)
     return false;
 }
 
+//-----------------------------------------------------------------------------
+QString
+QGCCacheWorker::_uniqueTileSetName(const QString& name)
+{
+    quint64 setID;
+    if(!_findTileSetID(name, setID)) {
+        return name;
+    }
+    //-- Set with this name already exists. Make name unique.
+    int testCount = 0;
+    while (true) {
+        auto testName = QString::asprintf("%s %02d", name.toLatin1().data(), ++testCount);
+        if(!_findTileSetID(testName, setID) || testCount > 99) {
+            return testName;
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 quint64
 QGCCacheWorker::_getDefaultTileSet()
@@ -280,36 +446,81 @@ QGCCacheWorker::_getDefaultTileSet()
     return 1L;
 }
 
+//-----------------------------------------------------------------------------
+QList<QGCMapTask*>
+QGCCacheWorker::_takeSaveTasks(QGCMapTask* first)
+{
+    QList<QGCMapTask*> tasks;
+    tasks.append(first);
+    QMutexLocker lock(&_mutex);
+    //-- Pull later saves forward past download state updates, which only get better off for it. Anything else which
+    //   touches tiles or sets has to see the saves in the order they were queued, so stop there. Fetches are in their
+    //   own queue.
+    for(int i = 0; i < _taskQueue.count() && tasks.count() < MAX_SAVE_BATCH; ) {
+        QGCMapTask::TaskType type = _taskQueue[i]->type();
+        if(type == QGCMapTask::taskCacheTile) {
+            tasks.append(_taskQueue.takeAt(i));
+        } else if(type == QGCMapTask::taskUpdateTileDownloadState) {
+            i++;
+        } else {
+            break;
+        }
+    }
+    return tasks;
+}
+
 //-----------------------------------------------------------------------------
 void
-QGCCacheWorker::_saveTile(QGCMapTask *mtask)
+QGCCacheWorker::_saveTiles(QGCMapTask* mtask)
 {
+    QList<QGCMapTask*> tasks = _takeSaveTasks(mtask);
     if(_valid) {
-        QGCSaveTileTask* task = static_cast<QGCSaveTileTask*>(mtask);
-        QSqlQuery query(*_db);
-        query.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-        query.addBindValue(task->tile()->hash());
-        query.addBindValue(task->tile()->format());
-        query.addBindValue(task->tile()->img());
-        query.addBindValue(task->tile()->img().size());
-        query.addBindValue(task->tile()->type());
-        query.addBindValue(QDateTime::currentDateTime().toTime_t());
-        if(query.exec()) {
-            quint64 tileID = query.lastInsertId().toULongLong();
-            quint64 setID = task->tile()->set() == UINT64_MAX ? _getDefaultTileSet() : task->tile()->set();
-            QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-            query.prepare(s);
-            if(!query.exec()) {
-                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+        //-- A single transaction for the whole batch so SQLite syncs the journal once instead of once per tile
+        _db->transaction();
+        QSqlQuery insertTile(*_db);
+        QSqlQuery insertSetTile(*_db);
+        insertTile.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date, crc) VALUES(?, ?, ?, ?, ?, ?, ?)");
+        insertSetTile.prepare("INSERT INTO SetTiles(tileID, setID) VALUES(?, ?)");
+        const uint now = QDateTime::currentDateTime().toTime_t();
+        for(QGCMapTask* t : tasks) {
+            QGCSaveTileTask* task = static_cast<QGCSaveTileTask*>(t);
+            QByteArray img    = task->tile()->img();
+            QString    format = task->tile()->format();
+            if(!task->transcodeFormat().isEmpty()) {
+                _transcodeTile(img, format, task->transcodeFormat());
             }
-            qCDebug(QGCTileCacheLog) << "_saveTile() HASH:" << task->tile()->hash();
-        } else {
-            //-- Tile was already there.
-            //   QtLocation some times requests the same tile twice in a row. The first is saved, the second is already there.
+            insertTile.bindValue(0, task->tile()->hash());
+            insertTile.bindValue(1, format);
+            insertTile.bindValue(2, img);
+            insertTile.bindValue(3, img.size());
+            insertTile.bindValue(4, task->tile()->type());
+            insertTile.bindValue(5, now);
+            insertTile.bindValue(6, _imageCRC(img));
+            if(insertTile.exec()) {
+                quint64 tileID = insertTile.lastInsertId().toULongLong();
+                quint64 setID = task->tile()->set() == UINT64_MAX ? _getDefaultTileSet() : task->tile()->set();
+                insertSetTile.bindValue(0, tileID);
+                insertSetTile.bindValue(1, setID);
+                if(!insertSetTile.exec()) {
+                    qWarning() << "Map Cache SQL error (add tile into SetTiles):" << insertSetTile.lastError().text();
+                }
+                qCDebug(QGCTileCacheLog) << "_saveTiles() HASH:" << task->tile()->hash();
+            } else {
+                //-- Tile was already there.
+                //   QtLocation some times requests the same tile twice in a row. The first is saved, the second is already there.
+            }
+        }
+        if(!_db->commit()) {
+            qWarning() << "Map Cache SQL error (saveTiles() commit):" << _db->lastError();
+            _db->rollback();
         }
     } else {
         qWarning() << "Map Cache SQL error (saveTile() open db):" << _db->lastError();
     }
+    //-- The first task is deleted by the run loop along with all the others
+    for(int i = 1; i < tasks.count(); i++) {
+        tasks[i]->deleteLater();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -322,9 +533,11 @@ QGCCacheWorker::_getTile(QGCMapTask* mtask)
     bool found = false;
     QGCFetchTileTask* task = static_cast<QGCFetchTileTask*>(mtask);
     QSqlQuery query(*_db);
-    QString s = QString("SELECT tile, format, type FROM Tiles WHERE hash = \"%1\"").arg(task->hash());
+    QString s = QString("SELECT tile, format, type, tileID FROM Tiles WHERE hash = \"%1\"").arg(task->hash());
     if(query.exec(s)) {
         if(query.next()) {
+            //-- Access time is written out in batches by _flushTileAccess
+            _accessedTiles.insert(query.value(3).toULongLong());
             QByteArray ar   = query.value(0).toByteArray();
             QString format  = query.value(1).toString();
             QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(query.value(2).toInt());
@@ -334,12 +547,104 @@ QGCCacheWorker::_getTile(QGCMapTask* mtask)
             found = true;
         }
     }
+    if(!found) {
+        found = _getArchiveTile(task);
+    }
     if(!found) {
         qCDebug(QGCTileCacheLog) << "_getTile() (NOT in DB) HASH:" << task->hash();
         task->setError("Tile not in cache database");
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_checkTiles(QGCMapTask* mtask)
+{
+    if(!_testTask(mtask)) {
+        return;
+    }
+    QGCCheckTilesTask* task = static_cast<QGCCheckTilesTask*>(mtask);
+    QList<QGCTile> missing;
+    QSqlQuery query(*_db);
+    query.prepare("SELECT tileID FROM Tiles WHERE hash = ?");
+    for(const QGCTile& tile : task->tiles()) {
+        query.addBindValue(tile.hash());
+        if(!query.exec() || !query.next()) {
+            missing.append(tile);
+        }
+    }
+    qCDebug(QGCTileCacheLog) << "_checkTiles() Checked:" << task->tiles().count() << "Missing:" << missing.count();
+    task->setTilesChecked(missing);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_getTileRangeStats(QGCMapTask* mtask)
+{
+    if(!_testTask(mtask)) {
+        return;
+    }
+    QGCTileRangeStatsTask* task = static_cast<QGCTileRangeStatsTask*>(mtask);
+    int typeId = getQGCMapEngine()->urlFactory()->getIdFromType(task->mapType());
+    QVector<QGCTileRangeStats> stats(task->ranges().count());
+    QSqlQuery query(*_db);
+    //-- Average tile size seen so far for each zoom level of this type
+    query.prepare("SELECT z, count, size FROM TileSizeStats WHERE type = ?");
+    query.addBindValue(typeId);
+    if(query.exec()) {
+        while(query.next()) {
+            int index = query.value(0).toInt() - task->minZoom();
+            if(index >= 0 && index < stats.count()) {
+                stats[index].observedCount = query.value(1).toULongLong();
+                stats[index].observedSize  = query.value(2).toULongLong();
+            }
+        }
+    } else {
+        qWarning() << "Map Cache SQL error (get tile size stats):" << query.lastError().text();
+    }
+    //-- Hashes sort by type, x, y and then z, so the tiles of one column of a range are a single span of the hash index
+    QSqlQuery columnQuery(*_db);
+    columnQuery.prepare("SELECT COUNT(*), COALESCE(SUM(size), 0) FROM Tiles WHERE hash >= ? AND hash <= ? AND substr(hash, 27, 3) = ?");
+    QSqlQuery scanQuery(*_db);
+    scanQuery.prepare("SELECT COUNT(*), COALESCE(SUM(size), 0) FROM Tiles WHERE hash >= ? AND hash < ? AND substr(hash, 27, 3) = ? "
+                      "AND CAST(substr(hash, 11, 8) AS INTEGER) BETWEEN ? AND ? AND CAST(substr(hash, 19, 8) AS INTEGER) BETWEEN ? AND ?");
+    for(int i = 0; i < task->ranges().count(); i++) {
+        const QGCTileSet& range = task->ranges()[i];
+        if(!range.tileCount) {
+            continue;
+        }
+        QString zoom = QString::asprintf("%03d", task->minZoom() + i);
+        int x0 = qMax(range.tileX0, 0);
+        int y0 = qMax(range.tileY0, 0);
+        int y1 = qMax(range.tileY1, 0);
+        if(range.tileX1 - x0 + 1 > kMaxRangeStatsColumns) {
+            scanQuery.bindValue(0, QString::asprintf("%010d", typeId));
+            scanQuery.bindValue(1, QString::asprintf("%010d", typeId + 1));
+            scanQuery.bindValue(2, zoom);
+            scanQuery.bindValue(3, x0);
+            scanQuery.bindValue(4, range.tileX1);
+            scanQuery.bindValue(5, y0);
+            scanQuery.bindValue(6, y1);
+            if(scanQuery.exec() && scanQuery.next()) {
+                stats[i].cachedCount = scanQuery.value(0).toULongLong();
+                stats[i].cachedSize  = scanQuery.value(1).toULongLong();
+            }
+            continue;
+        }
+        for(int x = x0; x <= range.tileX1; x++) {
+            columnQuery.bindValue(0, QString::asprintf("%010d%08d%08d000", typeId, x, y0));
+            columnQuery.bindValue(1, QString::asprintf("%010d%08d%08d999", typeId, x, y1));
+            columnQuery.bindValue(2, zoom);
+            if(columnQuery.exec() && columnQuery.next()) {
+                stats[i].cachedCount += columnQuery.value(0).toULongLong();
+                stats[i].cachedSize  += columnQuery.value(1).toULongLong();
+            }
+        }
+    }
+    qCDebug(QGCTileCacheLog) << "_getTileRangeStats()" << task->mapType() << "zoom levels:" << stats.count();
+    task->setRangeStats(stats);
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_getTileSets(QGCMapTask* mtask)
@@ -390,7 +695,7 @@ QGCCacheWorker::_updateSetTotals(QGCCachedTileSet* set)
         return;
     }
     QSqlQuery subquery(*_db);
-    QString sq = QString("SELECT COUNT(size), SUM(size) FROM Tiles A INNER JOIN SetTiles B on A.tileID = B.tileID WHERE B.setID = %1").arg(set->id());
+    QString sq = QString("SELECT count, size, uniqueCount, uniqueSize FROM TileTotals WHERE setID = %1").arg(set->id());
     qCDebug(QGCTileCacheLog) << "_updateSetTotals(): " << sq;
     if(subquery.exec(sq)) {
         if(subquery.next()) {
@@ -409,17 +714,9 @@ QGCCacheWorker::_updateSetTotals(QGCCachedTileSet* set)
                 }
                 set->setTotalTileSize(avg * set->totalTileCount());
             }
-            //-- Now figure out the count for tiles unique to this set
-            quint32 ucount = 0;
-            quint64 usize  = 0;
-            sq = QString("SELECT COUNT(size), SUM(size) FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1)").arg(set->id());
-            if(subquery.exec(sq)) {
-                if(subquery.next()) {
-                    //-- This is only accurate when all tiles are downloaded
-                    ucount = subquery.value(0).toUInt();
-                    usize  = subquery.value(1).toULongLong();
-                }
-            }
+            //-- Tiles unique to this set, this is only accurate when all tiles are downloaded
+            quint32 ucount = subquery.value(2).toUInt();
+            quint64 usize  = subquery.value(3).toULongLong();
             //-- If we haven't downloaded it all, estimate size of unique tiles
             quint32 expectedUcount = set->totalTileCount() - set->savedTileCount();
             if(!ucount) {
@@ -439,7 +736,8 @@ QGCCacheWorker::_updateTotals()
 {
     QSqlQuery query(*_db);
     QString s;
-    s = QString("SELECT COUNT(size), SUM(size) FROM Tiles");
+    //-- Running totals kept up to date by the TileTotals triggers, so no need to scan the tile tables here
+    s = QString("SELECT count, size FROM TileTotals WHERE setID = 0");
     qCDebug(QGCTileCacheLog) << "_updateTotals(): " << s;
     if(query.exec(s)) {
         if(query.next()) {
@@ -447,7 +745,7 @@ QGCCacheWorker::_updateTotals()
             _totalSize  = query.value(1).toULongLong();
         }
     }
-    s = QString("SELECT COUNT(size), SUM(size) FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1)").arg(_getDefaultTileSet());
+    s = QString("SELECT uniqueCount, uniqueSize FROM TileTotals WHERE setID = %1").arg(_getDefaultTileSet());
     qCDebug(QGCTileCacheLog) << "_updateTotals(): " << s;
     if(query.exec(s)) {
         if(query.next()) {
@@ -479,7 +777,6 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
 {
     if(_valid) {
         //-- Create Tile Set
-        quint32 actual_count = 0;
         QGCCreateTileSetTask* task = static_cast<QGCCreateTileSetTask*>(mtask);
         QSqlQuery query(*_db);
         query.prepare("INSERT INTO TileSets("
@@ -502,46 +799,31 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
             //-- Get just created (auto-incremented) setID
             quint64 setID = query.lastInsertId().toULongLong();
             task->tileSet()->setId(setID);
-            //-- Prepare Download List
-            quint64 tileCount = 0;
+            //-- Only the tile range of each zoom level is stored. _getTileDownloadList works through them as the download runs.
+            int typeId = getQGCMapEngine()->urlFactory()->getIdFromType(task->tileSet()->type());
+            query.prepare("INSERT INTO TilesDownloadRange(setID, type, z, x0, x1, y0, y1) VALUES(?, ?, ?, ?, ?, ?, ?)");
+            int minZoom = qMax(task->tileSet()->minZoom(), 1);
+            QVector<QGCTileSet> ranges = QGCMapEngine::getTileRanges(minZoom, task->tileSet()->maxZoom(),
+                task->tileSet()->topleftLon(), task->tileSet()->topleftLat(),
+                task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), task->tileSet()->type());
             _db->transaction();
-            for(int z = task->tileSet()->minZoom(); z <= task->tileSet()->maxZoom(); z++) {
-                QGCTileSet set = QGCMapEngine::getTileCount(z,
-                    task->tileSet()->topleftLon(), task->tileSet()->topleftLat(),
-                    task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), task->tileSet()->type());
-                tileCount += set.tileCount;
-                QString type = task->tileSet()->type();
-                for(int x = set.tileX0; x <= set.tileX1; x++) {
-                    for(int y = set.tileY0; y <= set.tileY1; y++) {
-                        //-- See if tile is already downloaded
-                        QString hash = QGCMapEngine::getTileHash(type, x, y, z);
-                        quint64 tileID = _findTile(hash);
-                        if(!tileID) {
-                            //-- Set to download
-                            query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ? ,? ,?)");
-                            query.addBindValue(setID);
-                            query.addBindValue(hash);
-                            query.addBindValue(getQGCMapEngine()->urlFactory()->getIdFromType(type));
-                            query.addBindValue(x);
-                            query.addBindValue(y);
-                            query.addBindValue(z);
-                            query.addBindValue(0);
-                            if(!query.exec()) {
-                                qWarning() << "Map Cache SQL error (add tile into TilesDownload):" << query.lastError().text();
-                                mtask->setError("Error creating tile set download list");
-                                return;
-                            } else
-                                actual_count++;
-                        } else {
-                            //-- Tile already in the database. No need to dowload.
-                            QString s = QString("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-                            query.prepare(s);
-                            if(!query.exec()) {
-                                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
-                            }
-                            qCDebug(QGCTileCacheLog) << "_createTileSet() Already Cached HASH:" << hash;
-                        }
-                    }
+            for(int i = 0; i < ranges.count(); i++) {
+                const QGCTileSet& set = ranges[i];
+                if(!set.tileCount) {
+                    continue;
+                }
+                query.bindValue(0, setID);
+                query.bindValue(1, typeId);
+                query.bindValue(2, minZoom + i);
+                query.bindValue(3, set.tileX0);
+                query.bindValue(4, set.tileX1);
+                query.bindValue(5, set.tileY0);
+                query.bindValue(6, set.tileY1);
+                if(!query.exec()) {
+                    qWarning() << "Map Cache SQL error (add range into TilesDownloadRange):" << query.lastError().text();
+                    _db->rollback();
+                    mtask->setError("Error creating tile set download list");
+                    return;
                 }
             }
             _db->commit();
@@ -582,9 +864,106 @@ QGCCacheWorker::_getTileDownloadList(QGCMapTask* mtask)
             }
         }
     }
+    //-- Top up from the tile ranges not handed out yet
+    if(tiles.size() < task->count()) {
+        _takeRangeTiles(task->setID(), task->count() - tiles.size(), tiles);
+    }
     task->setTileListFetched(tiles);
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_takeRangeTiles(quint64 setID, int count, QList<QGCTile*>& tiles)
+{
+    //-- One row per zoom level, so they are all read before any of them is changed
+    typedef struct {
+        qint64  rowID;
+        int     type;
+        int     z;
+        int     x0;
+        int     y0;
+        int     y1;
+        qint64  position;
+        qint64  tileCount;
+    } Range_t;
+    QList<Range_t> ranges;
+    QSqlQuery query(*_db);
+    QString s = QString("SELECT rowid, type, z, x0, x1, y0, y1, position FROM TilesDownloadRange WHERE setID = %1 ORDER BY z").arg(setID);
+    if(!query.exec(s)) {
+        return;
+    }
+    while(query.next()) {
+        Range_t range;
+        range.rowID     = query.value(0).toLongLong();
+        range.type      = query.value(1).toInt();
+        range.z         = query.value(2).toInt();
+        range.x0        = query.value(3).toInt();
+        range.y0        = query.value(5).toInt();
+        range.y1        = query.value(6).toInt();
+        range.position  = query.value(7).toLongLong();
+        range.tileCount = static_cast<qint64>(query.value(4).toInt() - range.x0 + 1) * (range.y1 - range.y0 + 1);
+        ranges.append(range);
+    }
+    if(ranges.isEmpty()) {
+        return;
+    }
+    QSqlQuery insertTile(*_db);
+    QSqlQuery insertSetTile(*_db);
+    insertTile.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ?, ?, ?)");
+    insertSetTile.prepare("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(?, ?)");
+    _db->transaction();
+    for(Range_t& range : ranges) {
+        QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(range.type);
+        int     rows = range.y1 - range.y0 + 1;
+        while(tiles.size() < count && range.position < range.tileCount) {
+            int x = range.x0 + static_cast<int>(range.position / rows);
+            int y = range.y0 + static_cast<int>(range.position % rows);
+            range.position++;
+            QString hash = QGCMapEngine::getTileHash(type, x, y, range.z);
+            quint64 tileID = _findTile(hash);
+            if(tileID) {
+                //-- Tile already in the database. No need to dowload.
+                insertSetTile.bindValue(0, tileID);
+                insertSetTile.bindValue(1, setID);
+                if(!insertSetTile.exec()) {
+                    qWarning() << "Map Cache SQL error (add tile into SetTiles):" << insertSetTile.lastError().text();
+                }
+                qCDebug(QGCTileCacheLog) << "_takeRangeTiles() Already Cached HASH:" << hash;
+                continue;
+            }
+            insertTile.bindValue(0, setID);
+            insertTile.bindValue(1, hash);
+            insertTile.bindValue(2, range.type);
+            insertTile.bindValue(3, x);
+            insertTile.bindValue(4, y);
+            insertTile.bindValue(5, range.z);
+            insertTile.bindValue(6, static_cast<int>(QGCTile::StateDownloading));
+            //-- Nothing is inserted if another set is already downloading the same tile
+            if(insertTile.exec() && insertTile.numRowsAffected() > 0) {
+                QGCTile* tile = new QGCTile;
+                tile->setHash(hash);
+                tile->setType(type);
+                tile->setX(x);
+                tile->setY(y);
+                tile->setZ(range.z);
+                tiles.append(tile);
+            }
+        }
+        if(range.position < range.tileCount) {
+            s = QString("UPDATE TilesDownloadRange SET position = %1 WHERE rowid = %2").arg(range.position).arg(range.rowID);
+        } else {
+            s = QString("DELETE FROM TilesDownloadRange WHERE rowid = %1").arg(range.rowID);
+        }
+        if(!query.exec(s)) {
+            qWarning() << "Map Cache SQL error (update TilesDownloadRange):" << query.lastError().text();
+        }
+        if(tiles.size() >= count) {
+            break;
+        }
+    }
+    _db->commit();
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_updateTileDownloadState(QGCMapTask* mtask)
@@ -595,6 +974,31 @@ QGCCacheWorker::_updateTileDownloadState(QGCMapTask* mtask)
     QGCUpdateTileDownloadStateTask* task = static_cast<QGCUpdateTileDownloadStateTask*>(mtask);
     QSqlQuery query(*_db);
     QString s;
+    if(!task->hashes().isEmpty()) {
+        //-- Batch from the downloader, one transaction and statement for all of them
+        _db->transaction();
+        if(task->state() == QGCTile::StateComplete) {
+            query.prepare("DELETE FROM TilesDownload WHERE setID = ? AND hash = ?");
+        } else {
+            query.prepare("UPDATE TilesDownload SET state = ? WHERE setID = ? AND hash = ?");
+        }
+        for(const QString& hash : task->hashes()) {
+            int i = 0;
+            if(task->state() != QGCTile::StateComplete) {
+                query.bindValue(i++, static_cast<int>(task->state()));
+            }
+            query.bindValue(i++, task->setID());
+            query.bindValue(i++, hash);
+            if(!query.exec()) {
+                qWarning() << "QGCCacheWorker::_updateTileDownloadState() Error:" << query.lastError().text();
+            }
+        }
+        if(!_db->commit()) {
+            qWarning() << "QGCCacheWorker::_updateTileDownloadState() Commit error:" << _db->lastError();
+            _db->rollback();
+        }
+        return;
+    }
     if(task->state() == QGCTile::StateComplete) {
         s = QString("DELETE FROM TilesDownload WHERE setID = %1 AND hash = \"%2\"").arg(task->setID()).arg(task->hash());
     } else {
@@ -617,9 +1021,11 @@ QGCCacheWorker::_pruneCache(QGCMapTask* mtask)
         return;
     }
     QGCPruneCacheTask* task = static_cast<QGCPruneCacheTask*>(mtask);
+    //-- Eviction order comes from the access times, so bring them up to date first
+    _flushTileAccess();
     QSqlQuery query(*_db);
     QString s;
-    //-- Select tiles in default set only, sorted by oldest.
+    //-- Select tiles in default set only, least recently used first.
     s = QString("SELECT tileID, size, hash FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1) ORDER BY DATE ASC LIMIT 128").arg(_getDefaultTileSet());
     qint64 amount = (qint64)task->amount();
     QList<quint64> tlist;
@@ -629,16 +1035,75 @@ QGCCacheWorker::_pruneCache(QGCMapTask* mtask)
             amount -= query.value(1).toULongLong();
             qCDebug(QGCTileCacheLog) << "_pruneCache() HASH:" << query.value(2).toString();
         }
-        while(tlist.count()) {
-            s = QString("DELETE FROM Tiles WHERE tileID = %1").arg(tlist[0]);
-            tlist.removeFirst();
-            if(!query.exec(s))
+        _db->transaction();
+        query.prepare("DELETE FROM Tiles WHERE tileID = ?");
+        for(quint64 tileID : tlist) {
+            query.bindValue(0, tileID);
+            if(!query.exec()) {
                 break;
+            }
         }
+        _db->commit();
+        _vacuumPending = true;
         task->setPruned();
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_flushTileAccess()
+{
+    if(_accessedTiles.isEmpty()) {
+        return;
+    }
+    //-- Tiles.date holds the last time a tile was used, which is what the cache is pruned by
+    QSqlQuery query(*_db);
+    query.prepare("UPDATE Tiles SET date = ? WHERE tileID = ?");
+    quint32 now = QDateTime::currentDateTime().toTime_t();
+    _db->transaction();
+    for(quint64 tileID : _accessedTiles) {
+        query.bindValue(0, now);
+        query.bindValue(1, tileID);
+        if(!query.exec()) {
+            qWarning() << "Map Cache SQL error (update tile access time):" << query.lastError().text();
+            break;
+        }
+    }
+    _db->commit();
+    _accessedTiles.clear();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_incrementalVacuum()
+{
+    QSqlQuery query(*_db);
+    if(!query.exec("PRAGMA freelist_count") || !query.next() || query.value(0).toInt() == 0) {
+        _vacuumPending = false;
+        return;
+    }
+    if(query.exec("PRAGMA auto_vacuum") && query.next() && query.value(0).toInt() != 2) {
+        //-- Database from before incremental vacuum was turned on. A full vacuum is needed once to switch it over.
+        qCDebug(QGCTileCacheLog) << "_incrementalVacuum() Converting cache database to incremental vacuum";
+        query.exec("PRAGMA auto_vacuum=INCREMENTAL");
+        if(!query.exec("VACUUM")) {
+            qWarning() << "Map Cache SQL error (vacuum):" << query.lastError().text();
+        }
+        _vacuumPending = false;
+        return;
+    }
+    //-- Give free pages back a few at a time so the file shrinks without holding up fetches queued in the meantime
+    while(query.exec("PRAGMA freelist_count") && query.next() && query.value(0).toInt() > 0) {
+        query.exec(QString("PRAGMA incremental_vacuum(%1)").arg(VACUUM_STEP_PAGES));
+        while(query.next()) { }
+        QMutexLocker lock(&_mutex);
+        if(_stopping || !_fetchQueue.isEmpty() || !_taskQueue.isEmpty()) {
+            return;
+        }
+    }
+    _vacuumPending = false;
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_deleteTileSet(QGCMapTask* mtask)
@@ -662,10 +1127,13 @@ QGCCacheWorker::_deleteTileSet(qulonglong id)
     query.exec(s);
     s = QString("DELETE FROM TilesDownload WHERE setID = %1").arg(id);
     query.exec(s);
+    s = QString("DELETE FROM TilesDownloadRange WHERE setID = %1").arg(id);
+    query.exec(s);
     s = QString("DELETE FROM TileSets WHERE setID = %1").arg(id);
     query.exec(s);
     s = QString("DELETE FROM SetTiles WHERE setID = %1").arg(id);
     query.exec(s);
+    _vacuumPending = true;
     _updateTotals();
 }
 
@@ -693,6 +1161,15 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
         return;
     }
     QGCResetTask* task = static_cast<QGCResetTask*>(mtask);
+    _valid = _recreateDB();
+    task->setResetCompleted();
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_recreateDB()
+{
+    _accessedTiles.clear();
     QSqlQuery query(*_db);
     QString s;
     s = QString("DROP TABLE Tiles");
@@ -703,8 +1180,11 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
     query.exec(s);
     s = QString("DROP TABLE TilesDownload");
     query.exec(s);
-    _valid = _createDB(_db);
-    task->setResetCompleted();
+    s = QString("DROP TABLE TilesDownloadRange");
+    query.exec(s);
+    s = QString("DROP TABLE TileTotals");
+    query.exec(s);
+    return _createDB(_db);
 }
 
 //-----------------------------------------------------------------------------
@@ -715,6 +1195,10 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
         return;
     }
     QGCImportTileTask* task = static_cast<QGCImportTileTask*>(mtask);
+    if(QFileInfo(task->path()).suffix().compare("mbtiles", Qt::CaseInsensitive) == 0) {
+        _importMBTiles(task);
+        return;
+    }
     //-- If replacing, simply copy over it
     if(task->replace()) {
         //-- Close and delete old database
@@ -744,9 +1228,13 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
         dbImport->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
         if (dbImport->open()) {
             QSqlQuery query(*dbImport);
+            //-- A delta export only carries the tiles this cache lacked, the rest of each set is referenced by hash
+            const bool delta = dbImport->tables().contains(QStringLiteral("SetTileRefs"));
             //-- Prepare progress report
             quint64 tileCount = 0;
+            quint64 workCount = 0;
             quint64 currentCount = 0;
+            quint64 changedCount = 0;
             int lastProgress = -1;
             QString s;
             s = QString("SELECT COUNT(tileID) FROM Tiles");
@@ -756,7 +1244,41 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                     tileCount  = query.value(0).toULongLong();
                 }
             }
-            if(tileCount) {
+            s = delta ? QString("SELECT (SELECT COUNT(*) FROM SetTiles) + (SELECT COUNT(*) FROM SetTileRefs)") : QString("SELECT COUNT(*) FROM SetTiles");
+            if(query.exec(s)) {
+                if(query.next()) {
+                    workCount = query.value(0).toULongLong();
+                }
+            }
+            if(!workCount) {
+                workCount = 1;
+            }
+            if(tileCount || delta) {
+                //-- Tiles already in the cache with the same image are linked to the imported set instead of copied
+                QSqlQuery findTile(*_db);
+                QSqlQuery insertTile(*_db);
+                QSqlQuery replaceTile(*_db);
+                QSqlQuery linkTile(*_db);
+                findTile.prepare("SELECT tileID, crc FROM Tiles WHERE hash = ?");
+                insertTile.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date, crc) VALUES(?, ?, ?, ?, ?, ?, ?)");
+                replaceTile.prepare("UPDATE Tiles SET format = ?, tile = ?, size = ?, type = ?, date = ?, crc = ? WHERE tileID = ?");
+                linkTile.prepare("INSERT INTO SetTiles(tileID, setID) SELECT ?, ? WHERE NOT EXISTS (SELECT 1 FROM SetTiles WHERE tileID = ? AND setID = ?)");
+                auto link = [&linkTile](quint64 tileID, quint64 setID) {
+                    linkTile.bindValue(0, tileID);
+                    linkTile.bindValue(1, setID);
+                    linkTile.bindValue(2, tileID);
+                    linkTile.bindValue(3, setID);
+                    return linkTile.exec() && linkTile.numRowsAffected() > 0;
+                };
+                auto stepProgress = [&]() {
+                    currentCount++;
+                    int progress = (int)((double)currentCount / (double)workCount * 100.0);
+                    //-- Avoid calling this if (int) progress hasn't changed.
+                    if(lastProgress != progress) {
+                        lastProgress = progress;
+                        task->setProgress(progress);
+                    }
+                };
                 //-- Iterate Tile Sets
                 s = QString("SELECT * FROM TileSets ORDER BY defaultSet DESC, name ASC");
                 if(query.exec(s)) {
@@ -774,20 +1296,10 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                         quint32 numTiles        = query.value("numTiles").toUInt();
                         int     defaultSet      = query.value("defaultSet").toInt();
                         quint64 insertSetID     = _getDefaultTileSet();
-                        //-- If not default set, create new one
-                        if(!defaultSet) {
-                            //-- Check if we have this tile set already
-                            if(_findTileSetID(name, insertSetID)) {
-                                int testCount = 0;
-                                //-- Set with this name already exists. Make name unique.
-                                while (true) {
-                                    auto testName = QString::asprintf("%s %02d", name.toLatin1().data(), ++testCount);
-                                    if(!_findTileSetID(testName, insertSetID) || testCount > 99) {
-                                        name = testName;
-                                        break;
-                                    }
-                                }
-                            }
+                        bool    createdSet      = false;
+                        //-- If not default set, create new one. A delta updates the set of the same name in place.
+                        if(!defaultSet && !(delta && _findTileSetID(name, insertSetID))) {
+                            name = _uniqueTileSetName(name);
                             //-- Create new set
                             QSqlQuery cQuery(*_db);
                             cQuery.prepare("INSERT INTO TileSets("
@@ -811,49 +1323,100 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                             } else {
                                 //-- Get just created (auto-incremented) setID
                                 insertSetID = cQuery.lastInsertId().toULongLong();
+                                createdSet = true;
                             }
                         }
                         //-- Find set tiles
                         QSqlQuery cQuery(*_db);
                         QSqlQuery subQuery(*dbImport);
-                        QString sb = QString("SELECT * FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1 GROUP BY A.tileID HAVING COUNT(A.tileID) = 1)").arg(setID);
+                        subQuery.setForwardOnly(true);
+                        QString sb = QString("SELECT A.* FROM Tiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1").arg(setID);
                         if(subQuery.exec(sb)) {
-                            quint64 tilesFound = 0;
                             quint64 tilesSaved = 0;
+                            quint64 tilesLinked = 0;
+                            const quint32 date = QDateTime::currentDateTime().toTime_t();
                             _db->transaction();
                             while(subQuery.next()) {
-                                tilesFound++;
                                 QString hash    = subQuery.value("hash").toString();
                                 QString format  = subQuery.value("format").toString();
                                 QByteArray img  = subQuery.value("tile").toByteArray();
                                 int type        = subQuery.value("type").toInt();
-                                //-- Save tile
-                                cQuery.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-                                cQuery.addBindValue(hash);
-                                cQuery.addBindValue(format);
-                                cQuery.addBindValue(img);
-                                cQuery.addBindValue(img.size());
-                                cQuery.addBindValue(type);
-                                cQuery.addBindValue(QDateTime::currentDateTime().toTime_t());
-                                if(cQuery.exec()) {
+                                //-- Exports from before the crc column have none
+                                quint32 crc     = subQuery.value("crc").toUInt();
+                                if(!crc) {
+                                    crc = _imageCRC(img);
+                                }
+                                quint64 tileID  = 0;
+                                bool    saved   = false;
+                                findTile.bindValue(0, hash);
+                                if(findTile.exec() && findTile.next()) {
+                                    tileID = findTile.value(0).toULongLong();
+                                    quint32 localCRC = findTile.value(1).toUInt();
+                                    findTile.finish();
+                                    if(!localCRC) {
+                                        localCRC = _storeTileCRC(tileID);
+                                    }
+                                    //-- Same tile, newer image
+                                    if(localCRC != crc) {
+                                        replaceTile.bindValue(0, format);
+                                        replaceTile.bindValue(1, img);
+                                        replaceTile.bindValue(2, img.size());
+                                        replaceTile.bindValue(3, type);
+                                        replaceTile.bindValue(4, date);
+                                        replaceTile.bindValue(5, crc);
+                                        replaceTile.bindValue(6, tileID);
+                                        saved = replaceTile.exec();
+                                    }
+                                } else {
+                                    findTile.finish();
+                                    //-- Save tile
+                                    insertTile.bindValue(0, hash);
+                                    insertTile.bindValue(1, format);
+                                    insertTile.bindValue(2, img);
+                                    insertTile.bindValue(3, img.size());
+                                    insertTile.bindValue(4, type);
+                                    insertTile.bindValue(5, date);
+                                    insertTile.bindValue(6, crc);
+                                    if(insertTile.exec()) {
+                                        tileID = insertTile.lastInsertId().toULongLong();
+                                        saved = true;
+                                    }
+                                }
+                                if(saved) {
                                     tilesSaved++;
-                                    quint64 importTileID = cQuery.lastInsertId().toULongLong();
-                                    QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(importTileID).arg(insertSetID);
-                                    cQuery.prepare(s);
-                                    cQuery.exec();
-                                    currentCount++;
-                                    if(tileCount) {
-                                        int progress = (int)((double)currentCount / (double)tileCount * 100.0);
-                                        //-- Avoid calling this if (int) progress hasn't changed.
-                                        if(lastProgress != progress) {
-                                            lastProgress = progress;
-                                            task->setProgress(progress);
+                                }
+                                if(tileID && link(tileID, insertSetID)) {
+                                    tilesLinked++;
+                                }
+                                stepProgress();
+                            }
+                            if(delta) {
+                                quint64 tilesMissing = 0;
+                                QSqlQuery refQuery(*dbImport);
+                                refQuery.setForwardOnly(true);
+                                if(refQuery.exec(QString("SELECT hash FROM SetTileRefs WHERE setID = %1").arg(setID))) {
+                                    while(refQuery.next()) {
+                                        findTile.bindValue(0, refQuery.value(0).toString());
+                                        if(findTile.exec() && findTile.next()) {
+                                            quint64 tileID = findTile.value(0).toULongLong();
+                                            findTile.finish();
+                                            if(link(tileID, insertSetID)) {
+                                                tilesLinked++;
+                                            }
+                                        } else {
+                                            findTile.finish();
+                                            tilesMissing++;
                                         }
+                                        stepProgress();
                                     }
                                 }
+                                //-- The manifest the delta was made from was out of date
+                                if(tilesMissing) {
+                                    qCWarning(QGCTileCacheLog) << "Delta import of" << name << "references" << tilesMissing << "tiles this cache does not have";
+                                }
                             }
                             _db->commit();
-                            if(tilesSaved) {
+                            if(tilesSaved || tilesLinked) {
                                 //-- Update tile count (if any added)
                                 s = QString("SELECT COUNT(size) FROM Tiles A INNER JOIN SetTiles B on A.tileID = B.tileID WHERE B.setID = %1").arg(insertSetID);
                                 if(cQuery.exec(s)) {
@@ -864,14 +1427,12 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                                     }
                                 }
                             }
-                            qint64 uniqueTiles = tilesFound - tilesSaved;
-                            if((quint64)uniqueTiles < tileCount) {
-                                tileCount -= uniqueTiles;
-                            } else {
-                                tileCount = 0;
+                            changedCount += tilesSaved;
+                            if(delta) {
+                                changedCount += tilesLinked;
                             }
                             //-- If there was nothing new in this set, remove it.
-                            if(!tilesSaved && !defaultSet) {
+                            if(createdSet && !tilesSaved && (!delta || !tilesLinked)) {
                                 qCDebug(QGCTileCacheLog) << "No unique tiles in" << name << "Removing it.";
                                 _deleteTileSet(insertSetID);
                             }
@@ -883,7 +1444,7 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
             }
             delete dbImport;
             QSqlDatabase::removeDatabase(kExportSession);
-            if(!tileCount) {
+            if(!changedCount) {
                 task->setError("No unique tiles in imported database");
             }
         } else {
@@ -893,6 +1454,92 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
     task->setImportCompleted();
 }
 
+//-----------------------------------------------------------------------------
+//-- Fills in the image CRC of a tile saved before the crc column existed
+quint32
+QGCCacheWorker::_storeTileCRC(quint64 tileID)
+{
+    quint32 crc = 0;
+    QSqlQuery query(*_db);
+    if(query.exec(QString("SELECT tile FROM Tiles WHERE tileID = %1").arg(tileID)) && query.next()) {
+        crc = _imageCRC(query.value(0).toByteArray());
+        query.finish();
+        query.exec(QString("UPDATE Tiles SET crc = %1 WHERE tileID = %2").arg(crc).arg(tileID));
+    }
+    return crc;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_exportManifest(QGCMapTask* mtask)
+{
+    if(!_testTask(mtask)) {
+        return;
+    }
+    QGCExportManifestTask* task = static_cast<QGCExportManifestTask*>(mtask);
+    //-- Older tiles have no CRC yet, work them out once so the manifest can be read straight from the index
+    {
+        QList<quint64> tileIDs;
+        QSqlQuery query(*_db);
+        if(query.exec("SELECT tileID FROM Tiles WHERE crc = 0 OR crc IS NULL")) {
+            while(query.next()) {
+                tileIDs.append(query.value(0).toULongLong());
+            }
+        }
+        if(tileIDs.count()) {
+            qCDebug(QGCTileCacheLog) << "_exportManifest() computing CRC of" << tileIDs.count() << "tiles";
+            _db->transaction();
+            for(int i = 0; i < tileIDs.count(); i++) {
+                _storeTileCRC(tileIDs[i]);
+                if((i + 1) % MBTILES_BATCH == 0) {
+                    _db->commit();
+                    _db->transaction();
+                }
+            }
+            _db->commit();
+        }
+    }
+    QFile::remove(task->path());
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kManifestSession);
+        db.setDatabaseName(task->path());
+        if(db.open()) {
+            QSqlQuery insertTile(db);
+            if(insertTile.exec("CREATE TABLE ManifestTiles (hash TEXT PRIMARY KEY NOT NULL, crc INTEGER)")) {
+                insertTile.prepare("INSERT INTO ManifestTiles(hash, crc) VALUES(?, ?)");
+                quint64 tileCount    = qMax(_totalCount, static_cast<quint32>(1));
+                quint64 currentCount = 0;
+                int     lastProgress = -1;
+                QSqlQuery query(*_db);
+                query.setForwardOnly(true);
+                if(query.exec("SELECT hash, crc FROM Tiles")) {
+                    db.transaction();
+                    while(query.next()) {
+                        insertTile.bindValue(0, query.value(0));
+                        insertTile.bindValue(1, query.value(1));
+                        insertTile.exec();
+                        int progress = (int)((double)++currentCount / (double)tileCount * 100.0);
+                        if(lastProgress != progress) {
+                            lastProgress = progress;
+                            task->setProgress(qMin(progress, 100));
+                        }
+                    }
+                    db.commit();
+                } else {
+                    task->setError("Error reading tiles");
+                }
+            } else {
+                task->setError("Error creating tile manifest");
+            }
+            db.close();
+        } else {
+            task->setError("Error opening tile manifest");
+        }
+    }
+    QSqlDatabase::removeDatabase(kManifestSession);
+    task->setExportCompleted();
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_exportSets(QGCMapTask* mtask)
@@ -901,6 +1548,18 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
         return;
     }
     QGCExportTileTask* task = static_cast<QGCExportTileTask*>(mtask);
+    if(QFileInfo(task->path()).suffix().compare("mbtiles", Qt::CaseInsensitive) == 0) {
+        _exportMBTiles(task);
+        return;
+    }
+    //-- Hash and image CRC of every tile the target cache already has
+    const bool delta = !task->manifestPath().isEmpty();
+    QHash<QString, quint32> manifest;
+    if(delta && !_readManifest(task->manifestPath(), manifest)) {
+        task->setError("Error reading tile manifest");
+        task->setExportCompleted();
+        return;
+    }
     //-- Delete target if it exists
     QFile file(task->path());
     file.remove();
@@ -909,7 +1568,8 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
     dbExport->setDatabaseName(task->path());
     dbExport->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
     if (dbExport->open()) {
-        if(_createDB(dbExport, false)) {
+        QSqlQuery refsQuery(*dbExport);
+        if(_createDB(dbExport, false) && (!delta || refsQuery.exec("CREATE TABLE SetTileRefs (setID INTEGER, hash TEXT NOT NULL)"))) {
             //-- Prepare progress report
             quint64 tileCount = 0;
             quint64 currentCount = 0;
@@ -951,38 +1611,86 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
                 } else {
                     //-- Get just created (auto-incremented) setID
                     quint64 exportSetID = exportQuery.lastInsertId().toULongLong();
-                    //-- Find set tiles
-                    QString s = QString("SELECT * FROM SetTiles WHERE setID = %1").arg(set->id());
+                    //-- Find set tiles. Images are only read for the tiles which end up in the export.
+                    QString s = QString("SELECT A.tileID, A.hash, A.format, A.type, A.crc FROM Tiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1").arg(set->id());
                     QSqlQuery query(*_db);
+                    QSqlQuery imageQuery(*_db);
+                    QSqlQuery insertTile(*dbExport);
+                    QSqlQuery findTile(*dbExport);
+                    QSqlQuery insertSetTile(*dbExport);
+                    QSqlQuery insertRef(*dbExport);
+                    imageQuery.prepare("SELECT tile FROM Tiles WHERE tileID = ?");
+                    //-- A tile in more than one exported set is only written once
+                    insertTile.prepare("INSERT OR IGNORE INTO Tiles(hash, format, tile, size, type, date, crc) VALUES(?, ?, ?, ?, ?, ?, ?)");
+                    findTile.prepare("SELECT tileID FROM Tiles WHERE hash = ?");
+                    insertSetTile.prepare("INSERT INTO SetTiles(tileID, setID) VALUES(?, ?)");
+                    insertRef.prepare("INSERT INTO SetTileRefs(setID, hash) VALUES(?, ?)");
+                    query.setForwardOnly(true);
                     if(query.exec(s)) {
+                        const quint32 date = QDateTime::currentDateTime().toTime_t();
                         dbExport->transaction();
                         while(query.next()) {
-                            quint64 tileID = query.value("tileID").toULongLong();
-                            //-- Get tile
-                            QString s = QString("SELECT * FROM Tiles WHERE tileID = \"%1\"").arg(tileID);
-                            QSqlQuery subQuery(*_db);
-                            if(subQuery.exec(s)) {
-                                if(subQuery.next()) {
-                                    QString hash    = subQuery.value("hash").toString();
-                                    QString format  = subQuery.value("format").toString();
-                                    QByteArray img  = subQuery.value("tile").toByteArray();
-                                    int type        = subQuery.value("type").toInt();
-                                    //-- Save tile
-                                    exportQuery.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-                                    exportQuery.addBindValue(hash);
-                                    exportQuery.addBindValue(format);
-                                    exportQuery.addBindValue(img);
-                                    exportQuery.addBindValue(img.size());
-                                    exportQuery.addBindValue(type);
-                                    exportQuery.addBindValue(QDateTime::currentDateTime().toTime_t());
-                                    if(exportQuery.exec()) {
-                                        quint64 exportTileID = exportQuery.lastInsertId().toULongLong();
-                                        QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(exportTileID).arg(exportSetID);
-                                        exportQuery.prepare(s);
-                                        exportQuery.exec();
-                                        currentCount++;
-                                        task->setProgress((int)((double)currentCount / (double)tileCount * 100.0));
+                            quint64 tileID  = query.value(0).toULongLong();
+                            QString hash    = query.value(1).toString();
+                            QString format  = query.value(2).toString();
+                            int type        = query.value(3).toInt();
+                            quint32 crc     = query.value(4).toUInt();
+                            QByteArray img;
+                            bool haveImage  = false;
+                            auto readImage = [&]() {
+                                imageQuery.bindValue(0, tileID);
+                                if(imageQuery.exec() && imageQuery.next()) {
+                                    img = imageQuery.value(0).toByteArray();
+                                    haveImage = true;
+                                }
+                                imageQuery.finish();
+                                return haveImage;
+                            };
+                            //-- Tiles saved before the crc column was added
+                            if(!crc) {
+                                if(!readImage()) {
+                                    continue;
+                                }
+                                crc = _imageCRC(img);
+                            }
+                            currentCount++;
+                            task->setProgress((int)((double)currentCount / (double)tileCount * 100.0));
+                            //-- The target already has this exact tile, it only needs to know the set holds it
+                            if(delta) {
+                                auto it = manifest.constFind(hash);
+                                if(it != manifest.constEnd() && it.value() == crc) {
+                                    insertRef.bindValue(0, exportSetID);
+                                    insertRef.bindValue(1, hash);
+                                    insertRef.exec();
+                                    continue;
+                                }
+                            }
+                            if(!haveImage && !readImage()) {
+                                continue;
+                            }
+                            //-- Save tile
+                            insertTile.bindValue(0, hash);
+                            insertTile.bindValue(1, format);
+                            insertTile.bindValue(2, img);
+                            insertTile.bindValue(3, img.size());
+                            insertTile.bindValue(4, type);
+                            insertTile.bindValue(5, date);
+                            insertTile.bindValue(6, crc);
+                            if(insertTile.exec()) {
+                                quint64 exportTileID = 0;
+                                if(insertTile.numRowsAffected() > 0) {
+                                    exportTileID = insertTile.lastInsertId().toULongLong();
+                                } else {
+                                    findTile.bindValue(0, hash);
+                                    if(findTile.exec() && findTile.next()) {
+                                        exportTileID = findTile.value(0).toULongLong();
                                     }
+                                    findTile.finish();
+                                }
+                                if(exportTileID) {
+                                    insertSetTile.bindValue(0, exportTileID);
+                                    insertSetTile.bindValue(1, exportSetID);
+                                    insertSetTile.exec();
                                 }
                             }
                         }
@@ -1002,6 +1710,399 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
     task->setExportCompleted();
 }
 
+//-----------------------------------------------------------------------------
+static QSqlDatabase
+_openArchive(const QString& path, const QString& session)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", session);
+    db.setDatabaseName(path);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    if(db.open()) {
+        //-- Archives are only ever read, so let SQLite map them rather than copy every page through its own cache
+        QSqlQuery query(db);
+        query.exec(QString("PRAGMA mmap_size=%1").arg(MBTILES_MMAP_SIZE));
+    }
+    return db;
+}
+
+//-----------------------------------------------------------------------------
+static QHash<QString, QString>
+_archiveMetadata(QSqlDatabase& db)
+{
+    QHash<QString, QString> metadata;
+    QSqlQuery query(db);
+    if(query.exec("SELECT name, value FROM metadata")) {
+        while(query.next()) {
+            metadata[query.value(0).toString()] = query.value(1).toString();
+        }
+    }
+    return metadata;
+}
+
+//-----------------------------------------------------------------------------
+//-- Archives written by QGC record their map type, anything else has to be named after one
+static QString
+_archiveMapType(const QHash<QString, QString>& metadata)
+{
+    QString mapType = metadata.value(kMBTilesMapType);
+    if(mapType.isEmpty()) {
+        mapType = metadata.value("name");
+    }
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+    if(urlFactory->getTypeFromId(urlFactory->getIdFromType(mapType)).isEmpty()) {
+        return QString();
+    }
+    return mapType;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_exportMBTiles(QGCMapTask* mtask)
+{
+    QGCExportTileTask* task = static_cast<QGCExportTileTask*>(mtask);
+    //-- An archive holds a single map type. Use the first set that has one, otherwise what most of the tiles are.
+    QString     mapType;
+    QStringList setIDs;
+    double      north = -90.0;
+    double      south =  90.0;
+    double      east  = -180.0;
+    double      west  =  180.0;
+    for(int i = 0; i < task->sets().count(); i++) {
+        QGCCachedTileSet* set = task->sets()[i];
+        setIDs.append(QString::number(set->id()));
+        if(!set->defaultSet()) {
+            if(mapType.isEmpty()) {
+                mapType = set->type();
+            }
+            north = qMax(north, set->topleftLat());
+            south = qMin(south, set->bottomRightLat());
+            west  = qMin(west,  set->topleftLon());
+            east  = qMax(east,  set->bottomRightLon());
+        }
+    }
+    QSqlQuery query(*_db);
+    QString setTiles = QString("tileID IN (SELECT tileID FROM SetTiles WHERE setID IN (%1))").arg(setIDs.join(","));
+    if(mapType.isEmpty()) {
+        QString s = QString("SELECT type FROM Tiles WHERE %1 GROUP BY type ORDER BY COUNT(*) DESC LIMIT 1").arg(setTiles);
+        if(query.exec(s) && query.next()) {
+            mapType = getQGCMapEngine()->urlFactory()->getTypeFromId(query.value(0).toInt());
+        }
+    }
+    QString where = QString("type = %1 AND %2").arg(getQGCMapEngine()->urlFactory()->getIdFromType(mapType)).arg(setTiles);
+    quint64 tileCount = 0;
+    if(!mapType.isEmpty() && query.exec(QString("SELECT COUNT(tileID) FROM Tiles WHERE %1").arg(where)) && query.next()) {
+        tileCount = query.value(0).toULongLong();
+    }
+    if(!tileCount) {
+        task->setError("No tiles to export");
+        task->setExportCompleted();
+        return;
+    }
+    //-- Delete target if it exists
+    QFile file(task->path());
+    file.remove();
+    bool ok = false;
+    QSqlDatabase* dbExport = new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kExportSession));
+    dbExport->setDatabaseName(task->path());
+    if (dbExport->open()) {
+        QSqlQuery exportQuery(*dbExport);
+        //-- The archive is deleted if the export fails, so there is nothing to gain from journaling it
+        exportQuery.exec("PRAGMA journal_mode=OFF");
+        exportQuery.exec("PRAGMA synchronous=OFF");
+        //-- Index is created up front so tiles shared by several of the exported sets are only written once
+        if(!exportQuery.exec("CREATE TABLE metadata (name TEXT, value TEXT)") ||
+           !exportQuery.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)") ||
+           !exportQuery.exec("CREATE UNIQUE INDEX tile_index ON tiles (zoom_level, tile_column, tile_row)")) {
+            qWarning() << "Map Cache SQL error (create MBTiles archive):" << exportQuery.lastError().text();
+            task->setError("Error creating export database");
+        } else {
+            QString format;
+            int     minZoom = -1;
+            int     maxZoom = 0;
+            quint64 currentCount = 0;
+            int     lastProgress = -1;
+            exportQuery.prepare("INSERT OR IGNORE INTO tiles(zoom_level, tile_column, tile_row, tile_data) VALUES(?, ?, ?, ?)");
+            query.setForwardOnly(true);
+            if(query.exec(QString("SELECT hash, format, tile FROM Tiles WHERE %1").arg(where))) {
+                ok = true;
+                dbExport->transaction();
+                while(query.next()) {
+                    QString hash = query.value(0).toString();
+                    int x = hash.mid(10, 8).toInt();
+                    int y = hash.mid(18, 8).toInt();
+                    int z = hash.mid(26, 3).toInt();
+                    if(format.isEmpty()) {
+                        format = query.value(1).toString();
+                    }
+                    minZoom = minZoom < 0 ? z : qMin(minZoom, z);
+                    maxZoom = qMax(maxZoom, z);
+                    exportQuery.bindValue(0, z);
+                    exportQuery.bindValue(1, x);
+                    //-- MBTiles rows count up from the south (TMS) where the cache counts down from the north
+                    exportQuery.bindValue(2, (1 << z) - 1 - y);
+                    exportQuery.bindValue(3, query.value(2).toByteArray());
+                    if(!exportQuery.exec()) {
+                        qWarning() << "Map Cache SQL error (export MBTiles tile):" << exportQuery.lastError().text();
+                        task->setError("Error adding tile to exported database");
+                        ok = false;
+                        break;
+                    }
+                    if(++currentCount % MBTILES_BATCH == 0) {
+                        dbExport->commit();
+                        dbExport->transaction();
+                    }
+                    int progress = (int)((double)currentCount / (double)tileCount * 100.0);
+                    if(lastProgress != progress) {
+                        lastProgress = progress;
+                        task->setProgress(progress);
+                    }
+                }
+                dbExport->commit();
+            }
+            if(ok) {
+                QList<QPair<QString, QString>> metadata;
+                metadata.append(qMakePair(QString("name"), task->sets().count() == 1 ? task->sets()[0]->name() : mapType));
+                metadata.append(qMakePair(QString("format"), format));
+                metadata.append(qMakePair(QString("type"), QString("baselayer")));
+                metadata.append(qMakePair(QString("version"), QString("1")));
+                metadata.append(qMakePair(QString("minzoom"), QString::number(minZoom)));
+                metadata.append(qMakePair(QString("maxzoom"), QString::number(maxZoom)));
+                if(north > south) {
+                    metadata.append(qMakePair(QString("bounds"), QString("%1,%2,%3,%4").arg(west, 0, 'f', 6).arg(south, 0, 'f', 6).arg(east, 0, 'f', 6).arg(north, 0, 'f', 6)));
+                }
+                metadata.append(qMakePair(QString(kMBTilesMapType), mapType));
+                exportQuery.prepare("INSERT INTO metadata(name, value) VALUES(?, ?)");
+                for(int i = 0; i < metadata.count(); i++) {
+                    exportQuery.bindValue(0, metadata[i].first);
+                    exportQuery.bindValue(1, metadata[i].second);
+                    if(!exportQuery.exec()) {
+                        task->setError("Error adding metadata to exported database");
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        }
+    } else {
+        qCritical() << "Map Cache SQL error (create export database):" << dbExport->lastError();
+        task->setError("Error opening export database");
+    }
+    delete dbExport;
+    QSqlDatabase::removeDatabase(kExportSession);
+    if(!ok) {
+        file.remove();
+    }
+    task->setExportCompleted();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_importMBTiles(QGCMapTask* mtask)
+{
+    QGCImportTileTask* task = static_cast<QGCImportTileTask*>(mtask);
+    QSqlDatabase* dbImport = new QSqlDatabase(_openArchive(task->path(), kExportSession));
+    if(dbImport->isOpen()) {
+        QHash<QString, QString> metadata = _archiveMetadata(*dbImport);
+        QString mapType = _archiveMapType(metadata);
+        QSqlQuery query(*dbImport);
+        quint64 tileCount = 0;
+        int     minZoom = metadata.value("minzoom", "-1").toInt();
+        int     maxZoom = metadata.value("maxzoom", "-1").toInt();
+        if(query.exec("SELECT COUNT(*), MIN(zoom_level), MAX(zoom_level) FROM tiles") && query.next()) {
+            tileCount = query.value(0).toULongLong();
+            if(minZoom < 0 || maxZoom < 0) {
+                minZoom = query.value(1).toInt();
+                maxZoom = query.value(2).toInt();
+            }
+        }
+        if(mapType.isEmpty()) {
+            task->setError("Tile archive does not name a known map type");
+        } else if(!tileCount) {
+            task->setError("No tiles in imported database");
+        } else if(task->replace() && !(_valid = _recreateDB())) {
+            task->setError("Error resetting tile cache");
+        } else {
+            //-- MBTiles bounds are west, south, east, north
+            QStringList bounds = metadata.value("bounds").split(",");
+            if(bounds.count() != 4) {
+                bounds = QStringList({"-180", "-85", "180", "85"});
+            }
+            QString name = metadata.value("name");
+            if(name.isEmpty()) {
+                name = QFileInfo(task->path()).completeBaseName();
+            }
+            QSqlQuery cQuery(*_db);
+            cQuery.prepare("INSERT INTO TileSets("
+                "name, typeStr, topleftLat, topleftLon, bottomRightLat, bottomRightLon, minZoom, maxZoom, type, numTiles, defaultSet, date"
+                ") VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+            cQuery.addBindValue(_uniqueTileSetName(name));
+            cQuery.addBindValue(mapType);
+            cQuery.addBindValue(bounds[3].toDouble());
+            cQuery.addBindValue(bounds[0].toDouble());
+            cQuery.addBindValue(bounds[1].toDouble());
+            cQuery.addBindValue(bounds[2].toDouble());
+            cQuery.addBindValue(minZoom);
+            cQuery.addBindValue(maxZoom);
+            cQuery.addBindValue(getQGCMapEngine()->urlFactory()->getIdFromType(mapType));
+            cQuery.addBindValue(tileCount);
+            cQuery.addBindValue(0);
+            cQuery.addBindValue(QDateTime::currentDateTime().toTime_t());
+            if(!cQuery.exec()) {
+                task->setError("Error adding imported tile set to database");
+            } else {
+                quint64 insertSetID = cQuery.lastInsertId().toULongLong();
+                QString format      = metadata.value("format");
+                quint64 currentCount = 0;
+                int     lastProgress = -1;
+                //-- Tiles already in the cache are not copied again but still become part of the new set
+                QSqlQuery insertTile(*_db);
+                QSqlQuery findTile(*_db);
+                QSqlQuery insertSetTile(*_db);
+                insertTile.prepare("INSERT OR IGNORE INTO Tiles(hash, format, tile, size, type, date, crc) VALUES(?, ?, ?, ?, ?, ?, ?)");
+                findTile.prepare("SELECT tileID FROM Tiles WHERE hash = ?");
+                insertSetTile.prepare("INSERT INTO SetTiles(tileID, setID) VALUES(?, ?)");
+                query.setForwardOnly(true);
+                if(query.exec("SELECT zoom_level, tile_column, tile_row, tile_data FROM tiles")) {
+                    quint32 date   = QDateTime::currentDateTime().toTime_t();
+                    int     typeId = getQGCMapEngine()->urlFactory()->getIdFromType(mapType);
+                    _db->transaction();
+                    while(query.next()) {
+                        int z = query.value(0).toInt();
+                        int x = query.value(1).toInt();
+                        int y = (1 << z) - 1 - query.value(2).toInt();
+                        QByteArray img = query.value(3).toByteArray();
+                        QString hash = QGCMapEngine::getTileHash(mapType, x, y, z);
+                        insertTile.bindValue(0, hash);
+                        insertTile.bindValue(1, format.isEmpty() ? getQGCMapEngine()->urlFactory()->getImageFormat(mapType, img) : format);
+                        insertTile.bindValue(2, img);
+                        insertTile.bindValue(3, img.size());
+                        insertTile.bindValue(4, typeId);
+                        insertTile.bindValue(5, date);
+                        insertTile.bindValue(6, _imageCRC(img));
+                        quint64 tileID = 0;
+                        if(insertTile.exec()) {
+                            if(insertTile.numRowsAffected() > 0) {
+                                tileID = insertTile.lastInsertId().toULongLong();
+                            } else {
+                                findTile.bindValue(0, hash);
+                                if(findTile.exec() && findTile.next()) {
+                                    tileID = findTile.value(0).toULongLong();
+                                }
+                            }
+                        }
+                        if(tileID) {
+                            insertSetTile.bindValue(0, tileID);
+                            insertSetTile.bindValue(1, insertSetID);
+                            insertSetTile.exec();
+                        }
+                        if(++currentCount % MBTILES_BATCH == 0) {
+                            _db->commit();
+                            _db->transaction();
+                        }
+                        int progress = (int)((double)currentCount / (double)tileCount * 100.0);
+                        if(lastProgress != progress) {
+                            lastProgress = progress;
+                            task->setProgress(progress);
+                        }
+                    }
+                    _db->commit();
+                } else {
+                    task->setError("Error reading tiles from imported database");
+                }
+            }
+        }
+    } else {
+        task->setError("Error opening import database");
+    }
+    delete dbImport;
+    QSqlDatabase::removeDatabase(kExportSession);
+    task->setImportCompleted();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_mountArchive(QGCMapTask* mtask)
+{
+    QGCMountArchiveTask* task = static_cast<QGCMountArchiveTask*>(mtask);
+    _unmountArchive(task->path());
+    if(!task->mount()) {
+        task->setMountCompleted(true);
+        return;
+    }
+    bool ok = false;
+    QString session = kArchiveSession + QString::number(_archiveSessionID++);
+    {
+        QSqlDatabase db = _openArchive(task->path(), session);
+        if(db.isOpen()) {
+            QHash<QString, QString> metadata = _archiveMetadata(db);
+            MountedArchive_t archive;
+            archive.path    = task->path();
+            archive.session = session;
+            archive.mapType = _archiveMapType(metadata);
+            archive.typeId  = getQGCMapEngine()->urlFactory()->getIdFromType(archive.mapType);
+            archive.format  = metadata.value("format");
+            if(archive.mapType.isEmpty()) {
+                task->setError("Tile archive does not name a known map type");
+            } else {
+                qCDebug(QGCTileCacheLog) << "_mountArchive()" << archive.path << archive.mapType;
+                _archives.append(archive);
+                ok = true;
+            }
+        } else {
+            task->setError("Error opening tile archive");
+        }
+    }
+    if(!ok) {
+        QSqlDatabase::removeDatabase(session);
+    }
+    task->setMountCompleted(ok);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_unmountArchive(const QString& path)
+{
+    for(int i = 0; i < _archives.count(); i++) {
+        if(_archives[i].path == path) {
+            QString session = _archives[i].session;
+            _archives.removeAt(i);
+            QSqlDatabase::database(session, false).close();
+            QSqlDatabase::removeDatabase(session);
+            return;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_getArchiveTile(QGCMapTask* mtask)
+{
+    QGCFetchTileTask* task = static_cast<QGCFetchTileTask*>(mtask);
+    int typeId = task->hash().mid(0, 10).toInt();
+    for(int i = 0; i < _archives.count(); i++) {
+        const MountedArchive_t& archive = _archives[i];
+        if(archive.typeId != typeId) {
+            continue;
+        }
+        int x = task->hash().mid(10, 8).toInt();
+        int y = task->hash().mid(18, 8).toInt();
+        int z = task->hash().mid(26, 3).toInt();
+        QSqlQuery query(QSqlDatabase::database(archive.session, false));
+        query.prepare("SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?");
+        query.addBindValue(z);
+        query.addBindValue(x);
+        query.addBindValue((1 << z) - 1 - y);
+        if(query.exec() && query.next()) {
+            QByteArray ar  = query.value(0).toByteArray();
+            QString format = archive.format.isEmpty() ? getQGCMapEngine()->urlFactory()->getImageFormat(archive.mapType, ar) : archive.format;
+            qCDebug(QGCTileCacheLog) << "_getTile() (Found in archive) HASH:" << task->hash();
+            task->setTileFetched(new QGCCacheTile(task->hash(), ar, format, archive.mapType));
+            return true;
+        }
+    }
+    return false;
+}
+
 //-----------------------------------------------------------------------------
 bool QGCCacheWorker::_testTask(QGCMapTask* mtask)
 {
@@ -1024,9 +2125,19 @@ QGCCacheWorker::_init()
         _db->setDatabaseName(_databasePath);
         _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
         if (_db->open()) {
+            //-- Only takes effect on a new database, existing ones are switched over by _incrementalVacuum
+            QSqlQuery vacuumQuery(*_db);
+            vacuumQuery.exec("PRAGMA auto_vacuum=INCREMENTAL");
             _valid = _createDB(_db);
             if(!_valid) {
                 _failed = true;
+            } else {
+                //-- Journal mode is kept in the database file so this holds for all later connections. With WAL, tile
+                //   reads are not blocked while a batch of saves is being committed.
+                QSqlQuery query(*_db);
+                if(!query.exec("PRAGMA journal_mode=WAL")) {
+                    qWarning() << "Map Cache SQL error (init() WAL mode):" << query.lastError().text();
+                }
             }
         } else {
             qCritical() << "Map Cache SQL error (init() open db):" << _db->lastError();
@@ -1057,11 +2168,17 @@ QGCCacheWorker::_createDB(QSqlDatabase* db, bool createDefault)
         "tile BLOB NULL, "
         "size INTEGER, "
         "type INTEGER, "
-        "date INTEGER DEFAULT 0)"))
+        "date INTEGER DEFAULT 0, "
+        "crc INTEGER DEFAULT 0)"))
     {
         qWarning() << "Map Cache SQL error (create Tiles db):" << query.lastError().text();
     } else {
+        //-- Caches from before the image CRC was kept get the column, 0 until the CRC is first needed
+        if(!db->record("Tiles").contains("crc")) {
+            query.exec("ALTER TABLE Tiles ADD COLUMN crc INTEGER DEFAULT 0");
+        }
         query.exec("CREATE INDEX IF NOT EXISTS hash ON Tiles ( hash, size, type ) ");
+        query.exec("CREATE INDEX IF NOT EXISTS TilesDate ON Tiles ( date ) ");
              
         if(!query.exec(
             "CREATE TABLE IF NOT EXISTS TileSets ("
@@ -1100,8 +2217,23 @@ QGCCacheWorker::_createDB(QSqlDatabase* db, bool createDefault)
                 {
                     qWarning() << "Map Cache SQL error (create TilesDownload db):" << query.lastError().text();
                 } else {
-                    //-- Database it ready for use
-                    res = true;
+                    //-- Tiles of a set not yet handed to the downloader. position counts tiles taken so far, column by column.
+                    if(!query.exec(
+                        "CREATE TABLE IF NOT EXISTS TilesDownloadRange ("
+                        "setID INTEGER, "
+                        "type INTEGER, "
+                        "z INTEGER, "
+                        "x0 INTEGER, "
+                        "x1 INTEGER, "
+                        "y0 INTEGER, "
+                        "y1 INTEGER, "
+                        "position INTEGER DEFAULT 0)"))
+                    {
+                        qWarning() << "Map Cache SQL error (create TilesDownloadRange db):" << query.lastError().text();
+                    } else {
+                        //-- Database it ready for use
+                        res = _createTotals(db) && _createSizeStats(db);
+                    }
                 }
             }
         }
@@ -1131,6 +2263,155 @@ QGCCacheWorker::_createDB(QSqlDatabase* db, bool createDefault)
     return res;
 }
 
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_createTotals(QSqlDatabase* db)
+{
+    QSqlQuery query(*db);
+    //-- Totals for a database created before TileTotals existed have to be counted once
+    bool recount = !db->tables().contains(QStringLiteral("TileTotals"));
+    //-- Row 0 holds the count and size of every tile in the cache. The row for each set holds the tiles in that set
+    //   and the tiles which are in that set alone. Triggers keep them up to date in the same transaction as the
+    //   change to the tiles, so reading totals never needs a scan of Tiles or SetTiles.
+    static const char* statements[] = {
+        "CREATE TABLE IF NOT EXISTS TileTotals ("
+        "setID INTEGER PRIMARY KEY NOT NULL, "
+        "count INTEGER DEFAULT 0, "
+        "size INTEGER DEFAULT 0, "
+        "uniqueCount INTEGER DEFAULT 0, "
+        "uniqueSize INTEGER DEFAULT 0)",
+        //-- The triggers look up the sets a tile is in on every change
+        "CREATE INDEX IF NOT EXISTS SetTilesTileID ON SetTiles ( tileID )",
+        "INSERT OR IGNORE INTO TileTotals(setID) VALUES(0)",
+        "CREATE TRIGGER IF NOT EXISTS TileSetsInsertTotals AFTER INSERT ON TileSets BEGIN "
+            "INSERT OR IGNORE INTO TileTotals(setID) VALUES(NEW.setID); "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS TileSetsDeleteTotals AFTER DELETE ON TileSets BEGIN "
+            "DELETE FROM TileTotals WHERE setID = OLD.setID; "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS TilesInsertTotals AFTER INSERT ON Tiles BEGIN "
+            "UPDATE TileTotals SET count = count + 1, size = size + NEW.size WHERE setID = 0; "
+        "END",
+        //-- A deleted tile also leaves every set it was in. Its SetTiles rows go with it, so a reused tileID
+        //   can't pick up stale set membership.
+        "CREATE TRIGGER IF NOT EXISTS TilesDeleteTotals AFTER DELETE ON Tiles BEGIN "
+            "UPDATE TileTotals SET count = count - 1, size = size - OLD.size WHERE setID = 0; "
+            "UPDATE TileTotals SET count = count - (SELECT COUNT(*) FROM SetTiles WHERE tileID = OLD.tileID AND setID = TileTotals.setID), "
+                "size = size - OLD.size * (SELECT COUNT(*) FROM SetTiles WHERE tileID = OLD.tileID AND setID = TileTotals.setID) "
+                "WHERE setID IN (SELECT setID FROM SetTiles WHERE tileID = OLD.tileID); "
+            "UPDATE TileTotals SET uniqueCount = uniqueCount - 1, uniqueSize = uniqueSize - OLD.size "
+                "WHERE (SELECT COUNT(*) FROM SetTiles WHERE tileID = OLD.tileID) = 1 AND setID = (SELECT setID FROM SetTiles WHERE tileID = OLD.tileID); "
+            "DELETE FROM SetTiles WHERE tileID = OLD.tileID; "
+        "END",
+        //-- Imports replace the image of a tile when it changed
+        "CREATE TRIGGER IF NOT EXISTS TilesUpdateTotals AFTER UPDATE OF size ON Tiles BEGIN "
+            "UPDATE TileTotals SET size = size - OLD.size + NEW.size WHERE setID = 0; "
+            "UPDATE TileTotals SET size = size + (NEW.size - OLD.size) * (SELECT COUNT(*) FROM SetTiles WHERE tileID = NEW.tileID AND setID = TileTotals.setID) "
+                "WHERE setID IN (SELECT setID FROM SetTiles WHERE tileID = NEW.tileID); "
+            "UPDATE TileTotals SET uniqueSize = uniqueSize - OLD.size + NEW.size "
+                "WHERE (SELECT COUNT(*) FROM SetTiles WHERE tileID = NEW.tileID) = 1 AND setID = (SELECT setID FROM SetTiles WHERE tileID = NEW.tileID); "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS SetTilesInsertTotals AFTER INSERT ON SetTiles WHEN EXISTS (SELECT 1 FROM Tiles WHERE tileID = NEW.tileID) BEGIN "
+            "INSERT OR IGNORE INTO TileTotals(setID) VALUES(NEW.setID); "
+            "UPDATE TileTotals SET count = count + 1, size = size + (SELECT size FROM Tiles WHERE tileID = NEW.tileID) WHERE setID = NEW.setID; "
+            //-- Tile was unique to another set until now
+            "UPDATE TileTotals SET uniqueCount = uniqueCount - 1, uniqueSize = uniqueSize - (SELECT size FROM Tiles WHERE tileID = NEW.tileID) "
+                "WHERE (SELECT COUNT(*) FROM SetTiles WHERE tileID = NEW.tileID) = 2 AND setID = (SELECT setID FROM SetTiles WHERE tileID = NEW.tileID AND rowid <> NEW.rowid); "
+            "UPDATE TileTotals SET uniqueCount = uniqueCount + 1, uniqueSize = uniqueSize + (SELECT size FROM Tiles WHERE tileID = NEW.tileID) "
+                "WHERE (SELECT COUNT(*) FROM SetTiles WHERE tileID = NEW.tileID) = 1 AND setID = NEW.setID; "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS SetTilesDeleteTotals AFTER DELETE ON SetTiles WHEN EXISTS (SELECT 1 FROM Tiles WHERE tileID = OLD.tileID) BEGIN "
+            "UPDATE TileTotals SET count = count - 1, size = size - (SELECT size FROM Tiles WHERE tileID = OLD.tileID) WHERE setID = OLD.setID; "
+            "UPDATE TileTotals SET uniqueCount = uniqueCount - 1, uniqueSize = uniqueSize - (SELECT size FROM Tiles WHERE tileID = OLD.tileID) "
+                "WHERE (SELECT COUNT(*) FROM SetTiles WHERE tileID = OLD.tileID) = 0 AND setID = OLD.setID; "
+            //-- Tile is now unique to the one set left holding it
+            "UPDATE TileTotals SET uniqueCount = uniqueCount + 1, uniqueSize = uniqueSize + (SELECT size FROM Tiles WHERE tileID = OLD.tileID) "
+                "WHERE (SELECT COUNT(*) FROM SetTiles WHERE tileID = OLD.tileID) = 1 AND setID = (SELECT setID FROM SetTiles WHERE tileID = OLD.tileID); "
+        "END",
+    };
+    static const char* recountStatements[] = {
+        "DELETE FROM SetTiles WHERE tileID NOT IN (SELECT tileID FROM Tiles)",
+        "UPDATE TileTotals SET count = (SELECT COUNT(*) FROM Tiles), size = (SELECT COALESCE(SUM(size), 0) FROM Tiles) WHERE setID = 0",
+        "INSERT OR IGNORE INTO TileTotals(setID) SELECT setID FROM TileSets",
+        "UPDATE TileTotals SET "
+            "count = (SELECT COUNT(*) FROM Tiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = TileTotals.setID), "
+            "size = (SELECT COALESCE(SUM(A.size), 0) FROM Tiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = TileTotals.setID), "
+            "uniqueCount = (SELECT COUNT(*) FROM Tiles A JOIN (SELECT tileID, setID FROM SetTiles GROUP BY tileID HAVING COUNT(*) = 1) U ON A.tileID = U.tileID WHERE U.setID = TileTotals.setID), "
+            "uniqueSize = (SELECT COALESCE(SUM(A.size), 0) FROM Tiles A JOIN (SELECT tileID, setID FROM SetTiles GROUP BY tileID HAVING COUNT(*) = 1) U ON A.tileID = U.tileID WHERE U.setID = TileTotals.setID) "
+            "WHERE setID <> 0",
+    };
+    db->transaction();
+    bool res = true;
+    for(const char* statement : statements) {
+        if(!query.exec(statement)) {
+            qWarning() << "Map Cache SQL error (create TileTotals):" << query.lastError().text();
+            res = false;
+            break;
+        }
+    }
+    if(res && recount) {
+        qCDebug(QGCTileCacheLog) << "_createTotals() counting existing tiles";
+        for(const char* statement : recountStatements) {
+            if(!query.exec(statement)) {
+                qWarning() << "Map Cache SQL error (count TileTotals):" << query.lastError().text();
+                res = false;
+                break;
+            }
+        }
+    }
+    if(res) {
+        db->commit();
+    } else {
+        db->rollback();
+    }
+    return res;
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_createSizeStats(QSqlDatabase* db)
+{
+    QSqlQuery query(*db);
+    //-- Tiles seen for each type and zoom, for the average tile size used in download estimates. Deleting tiles leaves
+    //   the figures alone, they describe what tiles have turned out to be, not what is in the cache.
+    bool seed = !db->tables().contains(QStringLiteral("TileSizeStats"));
+    static const char* statements[] = {
+        "CREATE TABLE IF NOT EXISTS TileSizeStats ("
+        "type INTEGER NOT NULL, "
+        "z INTEGER NOT NULL, "
+        "count INTEGER DEFAULT 0, "
+        "size INTEGER DEFAULT 0, "
+        "PRIMARY KEY (type, z))",
+        "CREATE TRIGGER IF NOT EXISTS TilesInsertSizeStats AFTER INSERT ON Tiles BEGIN "
+            "INSERT OR IGNORE INTO TileSizeStats(type, z) VALUES(NEW.type, CAST(substr(NEW.hash, 27, 3) AS INTEGER)); "
+            "UPDATE TileSizeStats SET count = count + 1, size = size + NEW.size WHERE type = NEW.type AND z = CAST(substr(NEW.hash, 27, 3) AS INTEGER); "
+        "END",
+    };
+    db->transaction();
+    bool res = true;
+    for(const char* statement : statements) {
+        if(!query.exec(statement)) {
+            qWarning() << "Map Cache SQL error (create TileSizeStats):" << query.lastError().text();
+            res = false;
+            break;
+        }
+    }
+    if(res && seed) {
+        qCDebug(QGCTileCacheLog) << "_createSizeStats() measuring existing tiles";
+        if(!query.exec("INSERT INTO TileSizeStats(type, z, count, size) "
+                       "SELECT type, CAST(substr(hash, 27, 3) AS INTEGER), COUNT(*), SUM(size) FROM Tiles GROUP BY 1, 2")) {
+            qWarning() << "Map Cache SQL error (seed TileSizeStats):" << query.lastError().text();
+            res = false;
+        }
+    }
+    if(res) {
+        db->commit();
+    } else {
+        db->rollback();
+    }
+    return res;
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_testInternet()
@@ -22,6 +22,7 @@
 #include <QString>
 #include <QThread>
 #include <QQueue>
+#include <QSet>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QMutexLocker>
@@ -34,6 +35,7 @@ Q_DECLARE_LOGGING_CATEGORY(QGCTileCacheLog)
 
 class QGCMapTask;
 class QGCCachedTileSet;
+class QGCTile;
 
 //-----------------------------------------------------------------------------
 class QGCCacheWorker : public QThread
@@ -54,27 +56,45 @@ private slots:
     void        _lookupReady            (QHostInfo info);
 
 private:
-    void        _saveTile               (QGCMapTask* mtask);
+    void        _runTask                (QGCMapTask* task);
+    void        _saveTiles              (QGCMapTask* mtask);
+    QList<QGCMapTask*> _takeSaveTasks   (QGCMapTask* first);
     void        _getTile                (QGCMapTask* mtask);
     void        _getTileSets            (QGCMapTask* mtask);
     void        _createTileSet          (QGCMapTask* mtask);
     void        _getTileDownloadList    (QGCMapTask* mtask);
+    void        _takeRangeTiles         (quint64 setID, int count, QList<QGCTile*>& tiles);
     void        _updateTileDownloadState(QGCMapTask* mtask);
     void        _deleteTileSet          (QGCMapTask* mtask);
     void        _renameTileSet          (QGCMapTask* mtask);
     void        _resetCacheDatabase     (QGCMapTask* mtask);
     void        _pruneCache             (QGCMapTask* mtask);
+    void        _flushTileAccess        ();
+    void        _incrementalVacuum      ();
     void        _exportSets             (QGCMapTask* mtask);
     void        _importSets             (QGCMapTask* mtask);
+    void        _exportManifest         (QGCMapTask* mtask);
+    void        _exportMBTiles          (QGCMapTask* mtask);
+    void        _importMBTiles          (QGCMapTask* mtask);
+    void        _checkTiles             (QGCMapTask* mtask);
+    void        _getTileRangeStats      (QGCMapTask* mtask);
+    void        _mountArchive           (QGCMapTask* mtask);
+    void        _unmountArchive         (const QString& path);
+    bool        _getArchiveTile         (QGCMapTask* mtask);
     bool        _testTask               (QGCMapTask* mtask);
     void        _testInternet           ();
     void        _deleteBingNoTileTiles  ();
 
     quint64     _findTile               (const QString hash);
+    quint32     _storeTileCRC           (quint64 tileID);
     bool        _findTileSetID          (const QString name, quint64& setID);
     void        _updateSetTotals        (QGCCachedTileSet* set);
     bool        _init                   ();
     bool        _createDB               (QSqlDatabase *db, bool createDefault = true);
+    bool        _createTotals           (QSqlDatabase *db);
+    bool        _createSizeStats        (QSqlDatabase *db);
+    bool        _recreateDB             ();
+    QString     _uniqueTileSetName      (const QString& name);
     quint64     _getDefaultTileSet      ();
     void        _updateTotals           ();
     void        _deleteTileSet          (qulonglong id);
@@ -84,10 +104,21 @@ signals:
     void        internetStatus          (bool active);
 
 private:
+    //-- Read only MBTiles archive searched when a tile is not in the cache
+    typedef struct {
+        QString     path;
+        QString     session;
+        QString     mapType;
+        int         typeId;
+        QString     format;
+    } MountedArchive_t;
+
+    QQueue<QGCMapTask*>     _fetchQueue;        ///< Interactive tile fetches, always serviced before _taskQueue
     QQueue<QGCMapTask*>     _taskQueue;
-    QMutex                  _mutex;
-    QMutex                  _waitmutex;
-    QWaitCondition          _waitc;
+    QQueue<QGCMapTask*>     _backgroundQueue;   ///< Speculative work such as prefetch checks, only serviced when idle
+    QMutex                  _mutex;             ///< Protects the queues and _stopping
+    QWaitCondition          _waitc;             ///< Signalled when a task is queued or on quit
+    bool                    _stopping;
     QString                 _databasePath;
     QSqlDatabase*           _db;
     bool                    _valid;
@@ -100,6 +131,10 @@ private:
     time_t                  _lastUpdate;
     int                     _updateTimeout;
     int                     _hostLookupID;
+    QSet<quint64>           _accessedTiles;     ///< Tiles read from the cache since the access times were last written
+    bool                    _vacuumPending;     ///< Free pages may be waiting to be given back to the file system
+    QList<MountedArchive_t> _archives;
+    int                     _archiveSessionID;  ///< Makes archive connection names unique
 };
 
 #endif // QGC_TILE_CACHE_WORKER_H
@@ -0,0 +1,350 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Predictive map tile prefetch for the active vehicle
+ *
+ */
+
+#include "QGCTilePrefetcher.h"
+#include "QGCMapEngine.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCNetworkManager.h"
+#include "QGCApplication.h"
+#include "QGCInstrumentation.h"
+#include "QGroundControlQmlGlobal.h"
+#include "SettingsManager.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "TrajectoryPoints.h"
+#include "MissionManager.h"
+#include "MissionItem.h"
+
+#include <QNetworkAccessManager>
+#include <math.h>
+
+QGC_LOGGING_CATEGORY(QGCTilePrefetcherLog, "QGCTilePrefetcherLog")
+
+QGC_INSTRUMENT_COUNTER  (TilePrefetchTiles, "TilePrefetch.Tiles")
+QGC_INSTRUMENT_COUNTER  (TilePrefetchBytes, "TilePrefetch.Bytes")
+
+#define PREFETCH_PLAN_MSECS         5000
+#define PREFETCH_LOOKAHEAD_SECS     60
+#define PREFETCH_MIN_DISTANCE       300.0       // Meters ahead even when hovering or flying slowly
+#define PREFETCH_MISSION_DISTANCE   3000.0      // Meters of remaining mission path
+#define PREFETCH_MIN_ZOOM           1
+#define PREFETCH_MAX_ZOOM           20
+
+//-- Budget kept well below what the map views and offline downloads use
+#define PREFETCH_MAX_REQUESTS       2
+#define PREFETCH_MAX_BYTES_PER_SEC  (128 * 1024)
+#define PREFETCH_MAX_PENDING        512
+#define PREFETCH_MAX_REQUESTED      8192
+
+static const double kEarthCircumference = 40075016.686;
+
+//-----------------------------------------------------------------------------
+QGCTilePrefetcher::QGCTilePrefetcher(MultiVehicleManager* multiVehicleManager, QObject* parent)
+    : QObject(parent)
+    , _multiVehicleManager(multiVehicleManager)
+    , _vehicle(nullptr)
+    , _networkManager(QGCNetworkManager::instance())
+    , _windowBytes(0)
+    , _checkPending(false)
+{
+    _planTimer.setInterval(PREFETCH_PLAN_MSECS);
+    connect(&_planTimer, &QTimer::timeout, this, &QGCTilePrefetcher::_plan);
+    _downloadTimer.setSingleShot(true);
+    connect(&_downloadTimer, &QTimer::timeout, this, &QGCTilePrefetcher::_downloadNext);
+    connect(_multiVehicleManager, &MultiVehicleManager::activeVehicleChanged, this, &QGCTilePrefetcher::_activeVehicleChanged);
+    connect(qgcApp(), &QGCApplication::lowPowerModeChanged, this, &QGCTilePrefetcher::_lowPowerModeChanged);
+    _activeVehicleChanged(_multiVehicleManager->activeVehicle());
+}
+
+//-----------------------------------------------------------------------------
+QGCTilePrefetcher::~QGCTilePrefetcher()
+{
+    _abortDownloads();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_activeVehicleChanged(Vehicle* vehicle)
+{
+    _vehicle = vehicle;
+    _pending.clear();
+    _requested.clear();
+    if(_vehicle && !qgcApp()->lowPowerMode()) {
+        _planTimer.start();
+    } else {
+        _planTimer.stop();
+        _downloadTimer.stop();
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Nobody is looking at the map in low power mode, prefetch stops until the window is back
+void
+QGCTilePrefetcher::_lowPowerModeChanged(bool lowPowerMode)
+{
+    if(lowPowerMode) {
+        _planTimer.stop();
+        _downloadTimer.stop();
+        _abortDownloads();
+        //-- Aborted tiles have to be asked for again
+        _requested.clear();
+    } else if(_vehicle) {
+        _planTimer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCTilePrefetcher::_mapType()
+{
+    FlightMapSettings* settings = qgcApp()->toolbox()->settingsManager()->flightMapSettings();
+    QString mapType = settings->mapProvider()->rawValue().toString() + " " + settings->mapType()->rawValue().toString();
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+    int id = urlFactory->getIdFromType(mapType);
+    //-- Terrain tiles are fetched on demand by the terrain query code, not here
+    if(urlFactory->getTypeFromId(id).isEmpty() || urlFactory->isElevation(id)) {
+        return QString();
+    }
+    return mapType;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_plan()
+{
+    if(!_vehicle || !_vehicle->armed() || !getQGCMapEngine()->isInternetActive()) {
+        _pending.clear();
+        return;
+    }
+    //-- Don't pile up checks behind a busy worker, the next round picks up where the vehicle is by then
+    if(_checkPending || _pending.count() >= PREFETCH_MAX_PENDING) {
+        return;
+    }
+    QGeoCoordinate position = _vehicle->coordinate();
+    if(!position.isValid()) {
+        return;
+    }
+    QString mapType = _mapType();
+    if(mapType.isEmpty()) {
+        return;
+    }
+
+    //-- Course over ground from the flown track, heading when there is no track yet
+    double course = _vehicle->heading()->rawValue().toDouble();
+    QVariantList track = _vehicle->trajectoryPoints()->list();
+    if(track.count() > 1) {
+        QGeoCoordinate from = track[track.count() - 2].value<QGeoCoordinate>();
+        QGeoCoordinate to   = track.last().value<QGeoCoordinate>();
+        if(from.isValid() && to.isValid() && from.distanceTo(to) > 0) {
+            course = from.azimuthTo(to);
+        }
+    }
+    double lookahead = qMax(PREFETCH_MIN_DISTANCE, _vehicle->groundSpeed()->rawValue().toDouble() * PREFETCH_LOOKAHEAD_SECS);
+    if(qIsNaN(course)) {
+        course = 0;
+    }
+    QList<QGeoCoordinate> coursePath = { position, position.atDistanceAndAzimuth(lookahead, course) };
+
+    //-- Remaining legs of the mission on the vehicle
+    QList<QGeoCoordinate> missionPath = { position };
+    const QList<MissionItem*>& missionItems = _vehicle->missionManager()->missionItems();
+    double missionDistance = 0;
+    for(int i = qMax(0, _vehicle->missionManager()->currentIndex()); i < missionItems.count() && missionDistance < PREFETCH_MISSION_DISTANCE; i++) {
+        switch(missionItems[i]->frame()) {
+        case MAV_FRAME_GLOBAL:
+        case MAV_FRAME_GLOBAL_RELATIVE_ALT:
+        case MAV_FRAME_GLOBAL_INT:
+        case MAV_FRAME_GLOBAL_RELATIVE_ALT_INT:
+        case MAV_FRAME_GLOBAL_TERRAIN_ALT:
+        case MAV_FRAME_GLOBAL_TERRAIN_ALT_INT:
+            break;
+        default:
+            continue;
+        }
+        QGeoCoordinate coord = missionItems[i]->coordinate();
+        if(!coord.isValid() || (coord.latitude() == 0 && coord.longitude() == 0)) {
+            continue;
+        }
+        missionDistance += missionPath.last().distanceTo(coord);
+        missionPath.append(coord);
+    }
+
+    QList<QGCTile> tiles;
+    int zoom = qRound(QGroundControlQmlGlobal::flightMapZoom());
+    for(int z = qMax(PREFETCH_MIN_ZOOM, zoom - 1); z <= qMin(PREFETCH_MAX_ZOOM, zoom + 1); z++) {
+        _addPathTiles(mapType, coursePath, z, tiles);
+        if(missionPath.count() > 1) {
+            _addPathTiles(mapType, missionPath, z, tiles);
+        }
+    }
+    if(tiles.isEmpty()) {
+        return;
+    }
+    qCDebug(QGCTilePrefetcherLog) << "Checking" << tiles.count() << "tiles ahead of vehicle";
+    QGCCheckTilesTask* task = new QGCCheckTilesTask(tiles);
+    connect(task, &QGCCheckTilesTask::tilesChecked, this, &QGCTilePrefetcher::_tilesChecked);
+    _checkPending = true;
+    getQGCMapEngine()->addTask(task);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_addPathTiles(const QString& mapType, const QList<QGeoCoordinate>& path, int zoom, QList<QGCTile>& tiles)
+{
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+    for(int i = 1; i < path.count(); i++) {
+        const QGeoCoordinate& from = path[i - 1];
+        double distance = from.distanceTo(path[i]);
+        double azimuth  = from.azimuthTo(path[i]);
+        //-- Sample every half tile so no tile along the leg is skipped
+        double step = qMax(1.0, kEarthCircumference * cos(from.latitude() * M_PI / 180.0) / pow(2.0, zoom) / 2.0);
+        for(double d = 0; d <= distance + step; d += step) {
+            QGeoCoordinate coord = from.atDistanceAndAzimuth(qMin(d, distance), azimuth);
+            int x = urlFactory->long2tileX(mapType, coord.longitude(), zoom);
+            int y = urlFactory->lat2tileY(mapType, coord.latitude(), zoom);
+            //-- Neighbouring tiles as well since the view extends to either side of the path
+            for(int dx = -1; dx <= 1; dx++) {
+                for(int dy = -1; dy <= 1; dy++) {
+                    _addTile(mapType, x + dx, y + dy, zoom, tiles);
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_addTile(const QString& mapType, int x, int y, int zoom, QList<QGCTile>& tiles)
+{
+    int count = 1 << zoom;
+    if(x < 0 || y < 0 || x >= count || y >= count) {
+        return;
+    }
+    QString hash = QGCMapEngine::getTileHash(mapType, x, y, zoom);
+    if(_requested.contains(hash)) {
+        return;
+    }
+    if(_requested.count() >= PREFETCH_MAX_REQUESTED) {
+        //-- Anything already fetched is found in the cache when checked again
+        _requested.clear();
+    }
+    _requested.insert(hash);
+    QGCTile tile;
+    tile.setX(x);
+    tile.setY(y);
+    tile.setZ(zoom);
+    tile.setHash(hash);
+    tile.setType(mapType);
+    tiles.append(tile);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_tilesChecked(QList<QGCTile> missing)
+{
+    _checkPending = false;
+    if(!_vehicle || !_vehicle->armed() || qgcApp()->lowPowerMode()) {
+        return;
+    }
+    qCDebug(QGCTilePrefetcherLog) << "Tiles missing from cache" << missing.count();
+    for(const QGCTile& tile : missing) {
+        if(_pending.count() >= PREFETCH_MAX_PENDING) {
+            break;
+        }
+        _pending.append(tile);
+    }
+    _downloadNext();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_downloadNext()
+{
+    while(_replies.count() < PREFETCH_MAX_REQUESTS && !_pending.isEmpty()) {
+        if(!getQGCMapEngine()->isInternetActive()) {
+            _pending.clear();
+            return;
+        }
+        //-- Bandwidth is budgeted over one second windows
+        if(!_bandwidthWindow.isValid() || _bandwidthWindow.elapsed() >= 1000) {
+            _bandwidthWindow.start();
+            _windowBytes = 0;
+        }
+        if(_windowBytes >= PREFETCH_MAX_BYTES_PER_SEC) {
+            if(!_downloadTimer.isActive()) {
+                _downloadTimer.start(static_cast<int>(qMax<qint64>(1, 1000 - _bandwidthWindow.elapsed())));
+            }
+            return;
+        }
+        const QGCTile& tile = _pending.first();
+        MapProvider* provider = getQGCMapEngine()->urlFactory()->getProviderTable().value(tile.type());
+        int waitMSecs = provider ? provider->takeDownloadToken() : 0;
+        if(waitMSecs) {
+            //-- Share the provider rate limit with the map views and offline downloads
+            if(!_downloadTimer.isActive()) {
+                _downloadTimer.start(waitMSecs);
+            }
+            return;
+        }
+        QGCTile next = _pending.takeFirst();
+        QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(next.type(), next.x(), next.y(), next.z(), _networkManager);
+        request.setAttribute(QNetworkRequest::User, next.hash());
+        QGCNetworkManager::setPriority(request, QGCNetworkManager::PriorityBackground);
+        QNetworkReply* reply = _networkManager->get(request);
+        connect(reply, &QNetworkReply::finished, this, &QGCTilePrefetcher::_networkReplyFinished);
+        _replies.insert(reply);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_networkReplyFinished()
+{
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
+    if(!reply) {
+        return;
+    }
+    _replies.remove(reply);
+    reply->deleteLater();
+    const QString hash = reply->request().attribute(QNetworkRequest::User).toString();
+    if(reply->error() != QNetworkReply::NoError) {
+        qCDebug(QGCTilePrefetcherLog) << "Prefetch failed" << hash << reply->errorString();
+    } else if(!hash.isEmpty()) {
+        QByteArray image = reply->readAll();
+        _windowBytes += image.size();
+        QString type = getQGCMapEngine()->hashToType(hash);
+        QString format = getQGCMapEngine()->urlFactory()->getImageFormat(type, image);
+        if(!format.isEmpty()) {
+            getQGCMapEngine()->cacheTile(type, hash, image, format);
+            QGC_INSTRUMENT_ADD(TilePrefetchTiles, 1);
+            QGC_INSTRUMENT_ADD(TilePrefetchBytes, static_cast<quint64>(image.size()));
+        }
+    }
+    _downloadNext();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_abortDownloads()
+{
+    for(QNetworkReply* reply : _replies) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+    _replies.clear();
+    _pending.clear();
+}
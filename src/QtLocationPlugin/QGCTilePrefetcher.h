@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Predictive map tile prefetch for the active vehicle
+ *
+ */
+
+#ifndef QGC_TILE_PREFETCHER_H
+#define QGC_TILE_PREFETCHER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QGeoCoordinate>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+#include <QNetworkReply>
+
+#include "QGCLoggingCategory.h"
+#include "QGCMapEngineData.h"
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTilePrefetcherLog)
+
+class QNetworkAccessManager;
+class MultiVehicleManager;
+class Vehicle;
+
+//-----------------------------------------------------------------------------
+/// Downloads the map tiles the active vehicle is about to fly over while it is armed.
+///
+/// The path ahead is the projected course over the next minute of flight plus the remaining legs of the mission on
+/// the vehicle. Tiles around that path at the flight map zoom level and its neighbours are checked against the cache
+/// using the tile worker's background queue, and the missing ones are fetched at low priority within a fixed request
+/// and bandwidth budget so regular map fetches are never held up. Downloaded tiles go into the default tile set.
+class QGCTilePrefetcher : public QObject
+{
+    Q_OBJECT
+public:
+    QGCTilePrefetcher   (MultiVehicleManager* multiVehicleManager, QObject* parent = nullptr);
+    ~QGCTilePrefetcher  ();
+
+private slots:
+    void _activeVehicleChanged  (Vehicle* vehicle);
+    void _plan                  ();
+    void _tilesChecked          (QList<QGCTile> missing);
+    void _downloadNext          ();
+    void _networkReplyFinished  ();
+    void _lowPowerModeChanged   (bool lowPowerMode);
+
+private:
+    QString _mapType            ();
+    void    _addPathTiles       (const QString& mapType, const QList<QGeoCoordinate>& path, int zoom, QList<QGCTile>& tiles);
+    void    _addTile            (const QString& mapType, int x, int y, int zoom, QList<QGCTile>& tiles);
+    void    _abortDownloads     ();
+
+private:
+    MultiVehicleManager*    _multiVehicleManager;
+    Vehicle*                _vehicle;
+    QNetworkAccessManager*  _networkManager;
+    QTimer                  _planTimer;
+    QTimer                  _downloadTimer;         ///< Picks up downloads again once the budget allows
+    QElapsedTimer           _bandwidthWindow;
+    qint64                  _windowBytes;
+    bool                    _checkPending;          ///< A cache check is queued in the worker
+    QList<QGCTile>          _pending;               ///< Checked and missing from the cache, waiting to be downloaded
+    QSet<QString>           _requested;             ///< Hashes already checked or downloaded, so they are not asked for again
+    QSet<QNetworkReply*>    _replies;
+};
+
+#endif // QGC_TILE_PREFETCHER_H
@@ -55,6 +55,9 @@
 
 int         QGeoTiledMapReplyQGC::_requestCount = 0;
 QByteArray  QGeoTiledMapReplyQGC::_bingNoTileImage;
+//-- Each map view has its own tile fetcher, so the same tile can be asked for several times at once. All replies
+//   live on the main thread, so no locking is needed.
+QHash<QString, QGeoTiledMapReplyQGC*> QGeoTiledMapReplyQGC::_fetchingReplies;
 
 //-----------------------------------------------------------------------------
 QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent)
@@ -62,6 +65,7 @@ QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager
     , _reply(nullptr)
     , _request(request)
     , _networkManager(networkManager)
+    , _leader(nullptr)
 {
     if (_bingNoTileImage.count() == 0) {
         QFile file(":/res/BingNoTileBytes.dat");
@@ -80,16 +84,104 @@ QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager
         setFinished(true);
         setCached(false);
     } else {
-        QGCFetchTileTask* task = getQGCMapEngine()->createFetchTileTask(getQGCMapEngine()->urlFactory()->getTypeFromId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
-        connect(task, &QGCFetchTileTask::tileFetched, this, &QGeoTiledMapReplyQGC::cacheReply);
-        connect(task, &QGCMapTask::error, this, &QGeoTiledMapReplyQGC::cacheError);
-        getQGCMapEngine()->addTask(task);
+        QGCMapEngine* mapEngine = getQGCMapEngine();
+        QString       type      = mapEngine->urlFactory()->getTypeFromId(spec.mapId());
+        QByteArray    image;
+        QString       format;
+        //-- Map tiles seen recently are answered from memory without a trip through the cache worker. Elevation
+        //   tiles are left out since they have their own decoded cache and report through terrainDone, which
+        //   nobody is connected to yet while we are still in the constructor.
+        if(!mapEngine->urlFactory()->isElevation(spec.mapId())) {
+            _hash = QGCMapEngine::getTileHash(type, spec.x(), spec.y(), spec.zoom());
+        }
+        if(!_hash.isEmpty() && mapEngine->getMemoryCachedTile(_hash, image, format)) {
+            setMapImageData(image);
+            setMapImageFormat(format);
+            setFinished(true);
+            setCached(true);
+        } else if(!_hash.isEmpty() && _fetchingReplies.contains(_hash)) {
+            //-- Another view is already fetching this tile, wait for its result instead of fetching it again
+            _leader = _fetchingReplies[_hash];
+            _leader->_followers.append(this);
+        } else {
+            _startFetch();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGeoTiledMapReplyQGC::_startFetch()
+{
+    if(!_hash.isEmpty()) {
+        _fetchingReplies[_hash] = this;
+    }
+    QGCMapEngine* mapEngine = getQGCMapEngine();
+    QGCFetchTileTask* task = mapEngine->createFetchTileTask(mapEngine->urlFactory()->getTypeFromId(tileSpec().mapId()), tileSpec().x(), tileSpec().y(), tileSpec().zoom());
+    connect(task, &QGCFetchTileTask::tileFetched, this, &QGeoTiledMapReplyQGC::cacheReply);
+    connect(task, &QGCMapTask::error, this, &QGeoTiledMapReplyQGC::cacheError);
+    mapEngine->addTask(task);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGeoTiledMapReplyQGC::_releaseFollowers()
+{
+    if(_fetchingReplies.value(_hash) == this) {
+        _fetchingReplies.remove(_hash);
+    }
+    QList<QPointer<QGeoTiledMapReplyQGC>> followers = _followers;
+    _followers.clear();
+    if(isFinished() && (error() != QGeoTiledMapReply::NoError || !mapImageData().isEmpty())) {
+        //-- Everyone waiting gets the same result
+        for(QGeoTiledMapReplyQGC* follower : followers) {
+            if(follower) {
+                follower->_leader = nullptr;
+                follower->setMapImageData(mapImageData());
+                follower->setMapImageFormat(mapImageFormat());
+                follower->setCached(isCached());
+                if(error() != QGeoTiledMapReply::NoError) {
+                    follower->setError(error(), errorString());
+                }
+                follower->setFinished(true);
+            }
+        }
+    } else {
+        //-- Aborted or timed out without a result. The views still waiting need the tile, so one of them takes over.
+        QGeoTiledMapReplyQGC* next = nullptr;
+        for(QGeoTiledMapReplyQGC* follower : followers) {
+            if(!follower) {
+                continue;
+            }
+            if(!next) {
+                next = follower;
+                next->_leader = nullptr;
+            } else {
+                follower->_leader = next;
+                next->_followers.append(follower);
+            }
+        }
+        if(next) {
+            next->_startFetch();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGeoTiledMapReplyQGC::_detachFromLeader()
+{
+    if(_leader) {
+        _leader->_followers.removeAll(this);
+        _leader = nullptr;
     }
 }
 
 //-----------------------------------------------------------------------------
 QGeoTiledMapReplyQGC::~QGeoTiledMapReplyQGC()
 {
+    _detachFromLeader();
+    _releaseFollowers();
     _clearReply();
 }
 
@@ -110,6 +202,8 @@ void
 QGeoTiledMapReplyQGC::abort()
 {
     _timer.stop();
+    _detachFromLeader();
+    _releaseFollowers();
     if (_reply)
         _reply->abort();
     emit aborted();
@@ -121,10 +215,12 @@ QGeoTiledMapReplyQGC::networkReplyFinished()
 {
     _timer.stop();
     if (!_reply) {
+        _releaseFollowers();
         emit aborted();
         return;
     }
     if (_reply->error() != QNetworkReply::NoError) {
+        _releaseFollowers();
         emit aborted();
         return;
     }
@@ -155,10 +251,12 @@ QGeoTiledMapReplyQGC::networkReplyFinished()
             setMapImageData(a);
             if(!format.isEmpty()) {
                 setMapImageFormat(format);
+                getQGCMapEngine()->memoryCacheTile(QGCMapEngine::getTileHash(getQGCMapEngine()->urlFactory()->getTypeFromId(tileSpec().mapId()), tileSpec().x(), tileSpec().y(), tileSpec().zoom()), a, format);
                 getQGCMapEngine()->cacheTile(getQGCMapEngine()->urlFactory()->getTypeFromId(tileSpec().mapId()), tileSpec().x(), tileSpec().y(), tileSpec().zoom(), a, format);
             }
         }
         setFinished(true);
+        _releaseFollowers();
     }
     _clearReply();
 }
@@ -181,6 +279,7 @@ QGeoTiledMapReplyQGC::networkReplyError(QNetworkReply::NetworkError error)
             setError(QGeoTiledMapReply::CommunicationError, _reply->errorString());
         }
         setFinished(true);
+        _releaseFollowers();
     }
     _clearReply();
 }
@@ -195,25 +294,17 @@ QGeoTiledMapReplyQGC::cacheError(QGCMapTask::TaskType type, QString /*errorStrin
         } else {
             setError(QGeoTiledMapReply::CommunicationError, "Network not available");
             setFinished(true);
+            _releaseFollowers();
         }
     } else {
         if(type != QGCMapTask::taskFetchTile) {
             qWarning() << "QGeoTiledMapReplyQGC::cacheError() for wrong task";
         }
         //-- Tile not in cache. Get it off the Internet.
-#if !defined(__mobile__)
-        QNetworkProxy proxy = _networkManager->proxy();
-        QNetworkProxy tProxy;
-        tProxy.setType(QNetworkProxy::DefaultProxy);
-        _networkManager->setProxy(tProxy);
-#endif
         _reply = _networkManager->get(_request);
         _reply->setParent(nullptr);
         connect(_reply, &QNetworkReply::finished, this, &QGeoTiledMapReplyQGC::networkReplyFinished);
         connect(_reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
-#if !defined(__mobile__)
-        _networkManager->setProxy(proxy);
-#endif
         //- Wait for an answer up to 10 seconds
         connect(&_timer, &QTimer::timeout, this, &QGeoTiledMapReplyQGC::timeout);
         _timer.setSingleShot(true);
@@ -231,10 +322,12 @@ QGeoTiledMapReplyQGC::cacheReply(QGCCacheTile* tile)
         emit terrainDone(tile->img(), QNetworkReply::NoError);
     } else {
         //-- Regular map tile
+        getQGCMapEngine()->memoryCacheTile(tile->hash(), tile->img(), tile->format());
         setMapImageData(tile->img());
         setMapImageFormat(tile->format());
         setFinished(true);
         setCached(true);
+        _releaseFollowers();
     }
     tile->deleteLater();
 }
@@ -243,6 +336,7 @@ QGeoTiledMapReplyQGC::cacheReply(QGCCacheTile* tile)
 void
 QGeoTiledMapReplyQGC::timeout()
 {
+    _releaseFollowers();
     if(_reply) {
         _reply->abort();
     }
@@ -50,6 +50,8 @@
 #include <QtNetwork/QNetworkReply>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 #include <QTimer>
+#include <QHash>
+#include <QPointer>
 
 #include "QGCMapEngineData.h"
 
@@ -73,6 +75,9 @@ private slots:
 
 private:
     void _clearReply            ();
+    void _startFetch            ();
+    void _releaseFollowers      ();
+    void _detachFromLeader      ();
 
 private:
     QNetworkReply*          _reply;
@@ -81,8 +86,12 @@ private:
     QByteArray              _badMapbox;
     QByteArray              _badTile;
     QTimer                  _timer;
+    QString                 _hash;                  ///< Set for map tiles, which take part in sharing fetches
+    QGeoTiledMapReplyQGC*   _leader;                ///< Reply doing the fetch this one is waiting on
+    QList<QPointer<QGeoTiledMapReplyQGC>> _followers;   ///< Replies for the same tile waiting on this one
     static QByteArray       _bingNoTileImage;
     static int              _requestCount;
+    static QHash<QString, QGeoTiledMapReplyQGC*> _fetchingReplies;  ///< Reply doing the fetch for each tile hash
 };
 
 #endif // QGEOMAPREPLYQGC_H
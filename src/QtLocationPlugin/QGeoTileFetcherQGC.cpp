@@ -47,6 +47,7 @@
 #include "QGCMapEngine.h"
 #include "QGeoTileFetcherQGC.h"
 #include "QGeoMapReplyQGC.h"
+#include "QGCNetworkManager.h"
 
 #include <QtCore/QLocale>
 #include <QtNetwork/QNetworkRequest>
@@ -55,7 +56,7 @@
 //-----------------------------------------------------------------------------
 QGeoTileFetcherQGC::QGeoTileFetcherQGC(QGeoTiledMappingManagerEngine *parent)
     : QGeoTileFetcher(parent)
-    , _networkManager(new QNetworkAccessManager(this))
+    , _networkManager(QGCNetworkManager::instance())
 {
     //-- Check internet status every 30 seconds or so
     connect(&_timer, &QTimer::timeout, this, &QGeoTileFetcherQGC::timeout);
@@ -76,6 +77,7 @@ QGeoTileFetcherQGC::getTileImage(const QGeoTileSpec &spec)
     //-- Build URL
     QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(spec.mapId(), spec.x(), spec.y(), spec.zoom(), _networkManager);
     if ( ! request.url().isEmpty() ) {
+        QGCNetworkManager::setPriority(request, QGCNetworkManager::PriorityInteractive);
         return new QGeoTiledMapReplyQGC(_networkManager, request, spec);
     }
     else {
@@ -39,6 +39,7 @@ Item {
     property Fact   _mapboxAccountFact: _settingsManager ? _settingsManager.appSettings.mapboxAccount : null
     property Fact   _mapboxStyleFact:   _settingsManager ? _settingsManager.appSettings.mapboxStyle : null
     property Fact   _esriFact:          _settingsManager ? _settingsManager.appSettings.esriToken : null
+    property Fact   _tileCacheFormatFact: _settings ? _settings.tileCacheFormat : null
 
     property string mapType:            _fmSettings ? (_fmSettings.mapProvider.value + " " + _fmSettings.mapType.value) : ""
     property bool   isMapInteractive:   false
@@ -211,7 +212,7 @@ Item {
     QGCFileDialog {
         id:             fileDialog
         folder:         QGroundControl.settingsManager.appSettings.missionSavePath
-        nameFilters:    ["Tile Sets (*.qgctiledb)"]
+        nameFilters:    ["Tile Sets (*.qgctiledb)", "MBTiles (*.mbtiles)"]
 
         onAcceptedForSave: {
             if (QGroundControl.mapEngineManager.exportSets(file)) {
@@ -301,6 +302,23 @@ Item {
                         text:           qsTr("Memory cache changes require a restart to take effect.")
                     }
 
+                    Item { width: 1; height: 1; visible: _tileCacheFormatFact ? _tileCacheFormatFact.visible : false }
+                    QGCLabel { text: qsTr("Cached Tile Format"); visible: _tileCacheFormatFact ? _tileCacheFormatFact.visible : false }
+                    FactComboBox {
+                        fact:               _tileCacheFormatFact
+                        indexModel:         false
+                        visible:            _tileCacheFormatFact ? _tileCacheFormatFact.visible : false
+                        width:              ScreenTools.defaultFontPixelWidth * 30
+                    }
+                    QGCLabel {
+                        anchors.left:   parent.left
+                        anchors.right:  parent.right
+                        wrapMode:       Text.WordWrap
+                        text:           qsTr("Applies to tiles saved from now on. Tiles already in the cache keep their format.")
+                        visible:        _tileCacheFormatFact ? _tileCacheFormatFact.visible : false
+                        font.pointSize: _adjustableFontPointSize
+                    }
+
                     Item { width: 1; height: 1; visible: _mapboxFact ? _mapboxFact.visible : false }
                     QGCLabel { text: qsTr("Mapbox Access Token"); visible: _mapboxFact ? _mapboxFact.visible : false }
                     FactTextField {
@@ -934,6 +952,15 @@ Item {
                                     text:           QGroundControl.mapEngineManager.tileSizeStr
                                     font.pointSize: _adjustableFontPointSize
                                 }
+
+                                QGCLabel {
+                                    text:           qsTr("To Download:")
+                                    font.pointSize: _adjustableFontPointSize
+                                }
+                                QGCLabel {
+                                    text:           QGroundControl.mapEngineManager.downloadCountStr + " (" + QGroundControl.mapEngineManager.downloadSizeStr + ")"
+                                    font.pointSize: _adjustableFontPointSize
+                                }
                             }
                         } // Column - Zoom info
                     } // Rectangle - Zoom info
@@ -1238,17 +1265,44 @@ Item {
                 anchors.horizontalCenter: parent.horizontalCenter
                 QGCRadioButton {
                     text:           qsTr("Append to existing set")
-                    checked:        !QGroundControl.mapEngineManager.importReplace
-                    onClicked:      QGroundControl.mapEngineManager.importReplace = !checked
+                    checked:        !QGroundControl.mapEngineManager.importReplace && !QGroundControl.mapEngineManager.importMount
+                    onClicked: {
+                        QGroundControl.mapEngineManager.importReplace = false
+                        QGroundControl.mapEngineManager.importMount = false
+                    }
                     visible:        QGroundControl.mapEngineManager.importAction === QGCMapEngineManager.ActionNone
                 }
                 QGCRadioButton {
                     text:           qsTr("Replace existing set")
-                    checked:        QGroundControl.mapEngineManager.importReplace
-                    onClicked:      QGroundControl.mapEngineManager.importReplace = checked
+                    checked:        QGroundControl.mapEngineManager.importReplace && !QGroundControl.mapEngineManager.importMount
+                    onClicked: {
+                        QGroundControl.mapEngineManager.importReplace = true
+                        QGroundControl.mapEngineManager.importMount = false
+                    }
+                    visible:        QGroundControl.mapEngineManager.importAction === QGCMapEngineManager.ActionNone
+                }
+                QGCRadioButton {
+                    text:           qsTr("Use MBTiles archive in place")
+                    checked:        QGroundControl.mapEngineManager.importMount
+                    onClicked:      QGroundControl.mapEngineManager.importMount = true
                     visible:        QGroundControl.mapEngineManager.importAction === QGCMapEngineManager.ActionNone
                 }
             }
+            Repeater {
+                model:              QGroundControl.mapEngineManager.importAction === QGCMapEngineManager.ActionNone ? QGroundControl.mapEngineManager.mountedArchives : []
+                Row {
+                    spacing:        _margins
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    QGCLabel {
+                        text:       modelData
+                        anchors.verticalCenter: parent.verticalCenter
+                    }
+                    QGCButton {
+                        text:       qsTr("Unmount")
+                        onClicked:  QGroundControl.mapEngineManager.unmountArchive(modelData)
+                    }
+                }
+            }
             QGCButton {
                 text:           qsTr("Close")
                 width:          _bigButtonSize * 1.25
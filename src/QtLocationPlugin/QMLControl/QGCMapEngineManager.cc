@@ -18,6 +18,7 @@
 #include "QGCMapEngineManager.h"
 #include "QGCApplication.h"
 #include "QGCMapTileSet.h"
+#include "QGCTilePrefetcher.h"
 #include "QGCMapUrlEngine.h"
 
 #include <QSettings>
@@ -44,6 +45,8 @@ QGCMapEngineManager::QGCMapEngineManager(QGCApplication* app, QGCToolbox* toolbo
     , _actionProgress(0)
     , _importAction(ActionNone)
     , _importReplace(false)
+    , _importMount(false)
+    , _prefetcher(nullptr)
 {
 
 }
@@ -62,6 +65,9 @@ QGCMapEngineManager::setToolbox(QGCToolbox *toolbox)
    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
    qmlRegisterUncreatableType<QGCMapEngineManager>("QGroundControl.QGCMapEngineManager", 1, 0, "QGCMapEngineManager", "Reference only");
    connect(getQGCMapEngine(), &QGCMapEngine::updateTotals, this, &QGCMapEngineManager::_updateTotals);
+   connect(getQGCMapEngine(), &QGCMapEngine::mountedArchivesChanged, this, &QGCMapEngineManager::mountedArchivesChanged);
+   connect(getQGCMapEngine(), &QGCMapEngine::archiveError, this, &QGCMapEngineManager::taskError);
+   _prefetcher = new QGCTilePrefetcher(toolbox->multiVehicleManager(), this);
    _updateDiskFreeSpace();
 }
 
@@ -76,22 +82,125 @@ QGCMapEngineManager::updateForCurrentView(double lon0, double lat0, double lon1,
     _minZoom        = minZoom;
     _maxZoom        = maxZoom;
 
-    _imageSet.clear();
-    _elevationSet.clear();
-
-    for(int z = minZoom; z <= maxZoom; z++) {
-        QGCTileSet set = QGCMapEngine::getTileCount(z, lon0, lat0, lon1, lat1, mapName);
-        _imageSet += set;
-    }
+    //-- Counts come straight from the tile ranges. What is already cached follows once the cache worker has looked.
+    _imageArea.mapType  = mapName;
+    _imageArea.minZoom  = qMax(minZoom, 1);
+    _imageArea.ranges   = QGCMapEngine::getTileRanges(minZoom, maxZoom, lon0, lat0, lon1, lat1, mapName);
+    _imageArea.stats.clear();
+    _elevationArea.mapType  = QStringLiteral("Airmap Elevation");
+    _elevationArea.minZoom  = 1;
+    _elevationArea.ranges.clear();
+    _elevationArea.stats.clear();
     if (_fetchElevation) {
-        QGCTileSet set = QGCMapEngine::getTileCount(1, lon0, lat0, lon1, lat1, "Airmap Elevation");
-        _elevationSet += set;
+        _elevationArea.ranges = QGCMapEngine::getTileRanges(1, 1, lon0, lat0, lon1, lat1, _elevationArea.mapType);
     }
+    _updateEstimates();
+    _requestRangeStats();
+
+    qCDebug(QGCMapEngineManagerLog) << "updateForCurrentView" << lat0 << lon0 << lat1 << lon1 << minZoom << maxZoom;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngineManager::_updateEstimates()
+{
+    _downloadCount = 0;
+    _downloadSize  = 0;
+    _estimateArea(_imageArea, _imageSet);
+    _estimateArea(_elevationArea, _elevationSet);
 
     emit tileCountChanged();
     emit tileSizeChanged();
+}
 
-    qCDebug(QGCMapEngineManagerLog) << "updateForCurrentView" << lat0 << lon0 << lat1 << lon1 << minZoom << maxZoom;
+//-----------------------------------------------------------------------------
+void
+QGCMapEngineManager::_estimateArea(const ViewArea_t& area, QGCTileSet& set)
+{
+    set.clear();
+    for(int i = 0; i < area.ranges.count(); i++) {
+        const QGCTileSet& range = area.ranges[i];
+        if(!range.tileCount) {
+            continue;
+        }
+        //-- Tile sizes vary a lot with zoom level, so use what tiles of this zoom have turned out to be when we know
+        quint64 average = range.tileSize / range.tileCount;
+        auto observed = _observedTileSize.constFind(qMakePair(area.mapType, area.minZoom + i));
+        if(observed != _observedTileSize.constEnd()) {
+            average = observed.value();
+        }
+        quint64 cached = i < area.stats.count() ? qMin(area.stats[i].cachedCount, range.tileCount) : 0;
+        set.tileCount   += range.tileCount;
+        set.tileSize    += range.tileCount * average;
+        _downloadCount  += range.tileCount - cached;
+        _downloadSize   += (range.tileCount - cached) * average;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngineManager::_requestRangeStats()
+{
+    //-- Panning the map updates the view continuously, only one lookup is kept running and the latest view follows it
+    if(_rangeStatsInFlight) {
+        _rangeStatsDirty = true;
+        return;
+    }
+    _rangeStatsDirty = false;
+    _rangeStatsGeneration++;
+    _requestRangeStats(&_imageArea);
+    _requestRangeStats(&_elevationArea);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngineManager::_requestRangeStats(ViewArea_t* area)
+{
+    if(area->ranges.isEmpty()) {
+        return;
+    }
+    int generation = _rangeStatsGeneration;
+    QGCTileRangeStatsTask* task = new QGCTileRangeStatsTask(area->mapType, area->minZoom, area->ranges);
+    connect(task, &QGCTileRangeStatsTask::rangeStatsFetched, this, [this, area, generation](QVector<QGCTileRangeStats> stats) {
+        if(generation == _rangeStatsGeneration && !_rangeStatsDirty) {
+            for(int i = 0; i < stats.count(); i++) {
+                if(stats[i].observedCount >= _minObservedTiles) {
+                    _observedTileSize[qMakePair(area->mapType, area->minZoom + i)] = static_cast<quint32>(stats[i].observedSize / stats[i].observedCount);
+                }
+            }
+            area->stats = stats;
+            _updateEstimates();
+        }
+        _rangeStatsDone();
+    });
+    connect(task, &QGCMapTask::error, this, [this](QGCMapTask::TaskType, QString) {
+        _rangeStatsDone();
+    });
+    _rangeStatsInFlight++;
+    getQGCMapEngine()->addTask(task);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngineManager::_rangeStatsDone(void)
+{
+    if(--_rangeStatsInFlight == 0 && _rangeStatsDirty) {
+        _requestRangeStats();
+    }
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCMapEngineManager::downloadCountStr()
+{
+    return QGCMapEngine::numberToString(_downloadCount);
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCMapEngineManager::downloadSizeStr()
+{
+    return QGCMapEngine::bigSizeToString(_downloadSize);
 }
 
 //-----------------------------------------------------------------------------
@@ -280,6 +389,7 @@ QGCMapEngineManager::deleteTileSet(QGCCachedTileSet* tileSet)
                 set->setDeleting(true);
             }
         }
+        getQGCMapEngine()->clearMemoryCache();
         QGCResetTask* task = new QGCResetTask();
         connect(task, &QGCResetTask::resetCompleted, this, &QGCMapEngineManager::_resetCompleted);
         connect(task, &QGCMapTask::error, this, &QGCMapEngineManager::taskError);
@@ -367,6 +477,12 @@ QGCMapEngineManager::taskError(QGCMapTask::TaskType type, QString error)
     case QGCMapTask::taskExport:
         task = "Export Tile Sets";
         break;
+    case QGCMapTask::taskExportManifest:
+        task = "Export Tile Manifest";
+        break;
+    case QGCMapTask::taskMountArchive:
+        task = "Mount Tile Archive";
+        break;
     default:
         task = "Database Error";
         break;
@@ -461,6 +577,11 @@ QGCMapEngineManager::importSets(QString path) {
         //    "Tile Sets (*.qgctiledb)");
 #endif
     }
+    if(!dir.isEmpty() && _importMount) {
+        //-- Archive is read in place, so there is no import progress to show
+        getQGCMapEngine()->mountArchive(dir);
+        return true;
+    }
     if(!dir.isEmpty()) {
         _importAction = ActionImporting;
         emit importActionChanged();
@@ -476,7 +597,7 @@ QGCMapEngineManager::importSets(QString path) {
 
 //-----------------------------------------------------------------------------
 bool
-QGCMapEngineManager::exportSets(QString path) {
+QGCMapEngineManager::exportSets(QString path, QString manifestPath) {
     _importAction = ActionNone;
     emit importActionChanged();
     QString dir = path;
@@ -504,7 +625,7 @@ QGCMapEngineManager::exportSets(QString path) {
         if(sets.count()) {
             _importAction = ActionExporting;
             emit importActionChanged();
-            QGCExportTileTask* task = new QGCExportTileTask(sets, dir);
+            QGCExportTileTask* task = new QGCExportTileTask(sets, dir, manifestPath);
             connect(task, &QGCExportTileTask::actionCompleted, this, &QGCMapEngineManager::_actionCompleted);
             connect(task, &QGCExportTileTask::actionProgress, this, &QGCMapEngineManager::_actionProgressHandler);
             connect(task, &QGCMapTask::error, this, &QGCMapEngineManager::taskError);
@@ -515,6 +636,25 @@ QGCMapEngineManager::exportSets(QString path) {
     return false;
 }
 
+//-----------------------------------------------------------------------------
+//-- The manifest is taken on the cache being updated and handed to exportSets() on the cache the update comes from
+bool
+QGCMapEngineManager::exportManifest(QString path) {
+    _importAction = ActionNone;
+    emit importActionChanged();
+    if(path.isEmpty()) {
+        return false;
+    }
+    _importAction = ActionExporting;
+    emit importActionChanged();
+    QGCExportManifestTask* task = new QGCExportManifestTask(path);
+    connect(task, &QGCExportManifestTask::actionCompleted, this, &QGCMapEngineManager::_actionCompleted);
+    connect(task, &QGCExportManifestTask::actionProgress, this, &QGCMapEngineManager::_actionProgressHandler);
+    connect(task, &QGCMapTask::error, this, &QGCMapEngineManager::taskError);
+    getQGCMapEngine()->addTask(task);
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCMapEngineManager::_actionProgressHandler(int percentage)
@@ -544,6 +684,13 @@ QGCMapEngineManager::resetAction()
     emit importActionChanged();
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCMapEngineManager::unmountArchive(const QString& path)
+{
+    getQGCMapEngine()->mountArchive(path, false);
+}
+
 //-----------------------------------------------------------------------------
 QString
 QGCMapEngineManager::getUniqueName()
@@ -20,6 +20,8 @@
 #include "QGCMapEngine.h"
 #include "QGCMapTileSet.h"
 
+class QGCTilePrefetcher;
+
 Q_DECLARE_LOGGING_CATEGORY(QGCMapEngineManagerLog)
 
 class QGCMapEngineManager : public QGCTool
@@ -41,6 +43,11 @@ public:
     Q_PROPERTY(QString              tileCountStr    READ    tileCountStr    NOTIFY tileCountChanged)
     Q_PROPERTY(quint64              tileSize        READ    tileSize        NOTIFY tileSizeChanged)
     Q_PROPERTY(QString              tileSizeStr     READ    tileSizeStr     NOTIFY tileSizeChanged)
+    //-- What is left to download once tiles already in the cache are taken out
+    Q_PROPERTY(quint64              downloadCount   READ    downloadCount   NOTIFY tileCountChanged)
+    Q_PROPERTY(QString              downloadCountStr READ   downloadCountStr NOTIFY tileCountChanged)
+    Q_PROPERTY(quint64              downloadSize    READ    downloadSize    NOTIFY tileSizeChanged)
+    Q_PROPERTY(QString              downloadSizeStr READ    downloadSizeStr NOTIFY tileSizeChanged)
     Q_PROPERTY(QmlObjectListModel*  tileSets        READ    tileSets        NOTIFY tileSetsChanged)
     Q_PROPERTY(QStringList          mapList         READ    mapList         CONSTANT)
     Q_PROPERTY(QStringList          mapProviderList READ    mapProviderList CONSTANT)
@@ -57,6 +64,9 @@ public:
     Q_PROPERTY(ImportAction         importAction    READ    importAction    WRITE  setImportAction   NOTIFY importActionChanged)
 
     Q_PROPERTY(bool                 importReplace   READ    importReplace   WRITE   setImportReplace   NOTIFY importReplaceChanged)
+    //-- Read only MBTiles archives used in place instead of being imported
+    Q_PROPERTY(bool                 importMount     READ    importMount     WRITE   setImportMount     NOTIFY importMountChanged)
+    Q_PROPERTY(QStringList          mountedArchives READ    mountedArchives NOTIFY  mountedArchivesChanged)
 
     Q_INVOKABLE void                loadTileSets            ();
     Q_INVOKABLE void                updateForCurrentView    (double lon0, double lat0, double lon1, double lat1, int minZoom, int maxZoom, const QString& mapName);
@@ -69,14 +79,20 @@ public:
     Q_INVOKABLE bool                findName                (const QString& name);
     Q_INVOKABLE void                selectAll               ();
     Q_INVOKABLE void                selectNone              ();
-    Q_INVOKABLE bool                exportSets              (QString path = QString());
+    Q_INVOKABLE bool                exportSets              (QString path = QString(), QString manifestPath = QString());
+    Q_INVOKABLE bool                exportManifest          (QString path);
     Q_INVOKABLE bool                importSets              (QString path = QString());
     Q_INVOKABLE void                resetAction             ();
+    Q_INVOKABLE void                unmountArchive          (const QString& path);
 
     quint64                         tileCount               () { return _imageSet.tileCount + _elevationSet.tileCount; }
     QString                         tileCountStr            ();
     quint64                         tileSize                () { return _imageSet.tileSize + _elevationSet.tileSize; }
     QString                         tileSizeStr             ();
+    quint64                         downloadCount           () { return _downloadCount; }
+    QString                         downloadCountStr        ();
+    quint64                         downloadSize            () { return _downloadSize; }
+    QString                         downloadSizeStr         ();
     QStringList                     mapList                 ();
     QStringList                     mapProviderList         ();
     Q_INVOKABLE QStringList         mapTypeList             (QString provider);
@@ -91,10 +107,13 @@ public:
     int                             actionProgress          () { return _actionProgress; }
     ImportAction                    importAction            () { return _importAction; }
     bool                            importReplace           () { return _importReplace; }
+    bool                            importMount             () { return _importMount; }
+    QStringList                     mountedArchives         () { return getQGCMapEngine()->mountedArchives(); }
 
     void                            setMaxMemCache          (quint32 size);
     void                            setMaxDiskCache         (quint32 size);
     void                            setImportReplace        (bool replace) { _importReplace = replace; emit importReplaceChanged(); }
+    void                            setImportMount          (bool mount) { _importMount = mount; emit importMountChanged(); }
     void                            setImportAction         (ImportAction action)  {_importAction = action; emit importActionChanged(); }
     void                            setErrorMessage         (const QString& error) { _errorMessage = error; emit errorMessageChanged(); }
     void                            setFetchElevation       (bool fetchElevation) { _fetchElevation = fetchElevation; emit fetchElevationChanged(); }
@@ -115,6 +134,8 @@ signals:
     void actionProgressChanged  ();
     void importActionChanged    ();
     void importReplaceChanged   ();
+    void importMountChanged     ();
+    void mountedArchivesChanged ();
 
 public slots:
     void taskError              (QGCMapTask::TaskType type, QString error);
@@ -129,11 +150,34 @@ private slots:
     void _actionProgressHandler (int percentage);
 
 private:
+    //-- Tile ranges of the current view for one map type, along with what the cache knows about them
+    typedef struct {
+        QString                     mapType;
+        int                         minZoom;
+        QVector<QGCTileSet>         ranges;     ///< Indexed by zoom - minZoom
+        QVector<QGCTileRangeStats>  stats;      ///< Same indexing, empty until the cache worker has looked
+    } ViewArea_t;
+
     void _updateDiskFreeSpace   ();
+    void _updateEstimates       ();
+    void _estimateArea          (const ViewArea_t& area, QGCTileSet& set);
+    void _requestRangeStats     ();
+    void _requestRangeStats     (ViewArea_t* area);
+    void _rangeStatsDone        (void);
 
 private:
     QGCTileSet  _imageSet;
     QGCTileSet  _elevationSet;
+    ViewArea_t  _imageArea;
+    ViewArea_t  _elevationArea;
+    quint64     _downloadCount          = 0;
+    quint64     _downloadSize           = 0;
+    int         _rangeStatsGeneration   = 0;        ///< Results from earlier views are dropped
+    int         _rangeStatsInFlight     = 0;
+    bool        _rangeStatsDirty        = false;    ///< View changed while a lookup was running
+    QHash<QPair<QString, int>, quint32> _observedTileSize;   ///< Average tile size seen in the cache by map type and zoom
+
+    static const quint64 _minObservedTiles = 10;    ///< Fewer tiles than this seen and the provider's average is used instead
     double      _topleftLat;
     double      _topleftLon;
     double      _bottomRightLat;
@@ -149,6 +193,8 @@ private:
     int         _actionProgress;
     ImportAction _importAction;
     bool        _importReplace;
+    bool        _importMount;
+    QGCTilePrefetcher* _prefetcher;
 };
 
 #endif
@@ -14,6 +14,7 @@
 #include <QVariant>
 #include <QtDebug>
 #include <QRegularExpression>
+#include <QVector>
 
 const char* SHPFileHelper::_errorPrefix = QT_TR_NOOP("SHP file load failed. %1");
 
@@ -111,7 +112,7 @@ ShapeFileHelper::ShapeType SHPFileHelper::determineShapeType(const QString& shpF
     return shapeType;
 }
 
-bool SHPFileHelper::loadPolygonFromFile(const QString& shpFile, QList<QGeoCoordinate>& vertices, QString& errorString)
+bool SHPFileHelper::loadPolygonFromFile(const QString& shpFile, QList<QGeoCoordinate>& vertices, QString& errorString, const ShapeFileHelper::ProgressCallback& progress)
 {
     int         utmZone = 0;
     bool        utmSouthernHemisphere;
@@ -140,13 +141,38 @@ bool SHPFileHelper::loadPolygonFromFile(const QString& shpFile, QList<QGeoCoordi
         goto Error;
     }
 
-    for (int i=0; i<shpObject->nVertices; i++) {
-        QGeoCoordinate coord;
-        if (!utmZone || !convertUTMToGeo(shpObject->padfX[i], shpObject->padfY[i], utmZone, utmSouthernHemisphere, coord)) {
-            coord.setLatitude(shpObject->padfY[i]);
-            coord.setLongitude(shpObject->padfX[i]);
+    {
+        // UTM shapes are converted as a batch since they are all in the same zone
+        QVector<QGeoCoordinate> utmCoords;
+        if (utmZone) {
+            utmCoords.resize(shpObject->nVertices);
+            if (!convertUTMToGeo(shpObject->padfX, shpObject->padfY, shpObject->nVertices, utmZone, utmSouthernHemisphere, utmCoords.data())) {
+                utmCoords.clear();
+            }
         }
-        vertices.append(coord);
+
+        vertices.reserve(shpObject->nVertices);
+        for (int i=0; i<shpObject->nVertices; i++) {
+            if (!utmCoords.isEmpty()) {
+                vertices.append(utmCoords[i]);
+            } else {
+                QGeoCoordinate coord;
+                coord.setLatitude(shpObject->padfY[i]);
+                coord.setLongitude(shpObject->padfX[i]);
+                vertices.append(coord);
+            }
+
+            if (progress && (i % _progressVertexInterval) == 0 && !progress(static_cast<double>(i) / shpObject->nVertices)) {
+                errorString = QString(_errorPrefix).arg(tr("Load cancelled."));
+                vertices.clear();
+                goto Error;
+            }
+        }
+    }
+
+    if (vertices.isEmpty()) {
+        errorString = QString(_errorPrefix).arg(tr("Polygon has no vertices."));
+        goto Error;
     }
 
     // Filter last vertex such that it differs from first
@@ -158,16 +184,19 @@ bool SHPFileHelper::loadPolygonFromFile(const QString& shpFile, QList<QGeoCoordi
         }
     }
 
-    // Filter vertex distances to be larger than 1 meter apart
-    {
-        int i = 0;
-        while (i < vertices.count() - 2) {
-            if (vertices[i].distanceTo(vertices[i+1]) < vertexFilterMeters) {
-                vertices.removeAt(i+1);
-            } else {
-                i++;
+    // Filter vertex distances to be larger than 1 meter apart. The list is compacted in a single pass since removing
+    // vertices one by one is quadratic for large polygons. The last vertex is always kept.
+    if (vertices.count() > 2) {
+        QList<QGeoCoordinate> filtered;
+        filtered.reserve(vertices.count());
+        filtered.append(vertices.first());
+        for (int i=1; i<vertices.count()-1; i++) {
+            if (filtered.last().distanceTo(vertices[i]) >= vertexFilterMeters) {
+                filtered.append(vertices[i]);
             }
         }
+        filtered.append(vertices.last());
+        vertices = filtered;
     }
 
 Error:
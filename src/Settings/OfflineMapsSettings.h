@@ -22,6 +22,7 @@ public:
     DEFINE_SETTINGFACT(minZoomLevelDownload)
     DEFINE_SETTINGFACT(maxZoomLevelDownload)
     DEFINE_SETTINGFACT(maxTilesForDownload)
+    DEFINE_SETTINGFACT(tileCacheFormat)
 
 private:
 };
@@ -23,3 +23,4 @@ DECLARE_SETTINGSFACT(PlanViewSettings, useConditionGate)
 DECLARE_SETTINGSFACT(PlanViewSettings, takeoffItemNotRequired)
 DECLARE_SETTINGSFACT(PlanViewSettings, showGimbalOnlyWhenSet)
 DECLARE_SETTINGSFACT(PlanViewSettings, vtolTransitionDistance)
+DECLARE_SETTINGSFACT(PlanViewSettings, shapeImportSimplifyTolerance)
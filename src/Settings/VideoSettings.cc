@@ -102,6 +102,9 @@ DECLARE_SETTINGSFACT(VideoSettings, gridLines)
 DECLARE_SETTINGSFACT(VideoSettings, showRecControl)
 DECLARE_SETTINGSFACT(VideoSettings, recordingFormat)
 DECLARE_SETTINGSFACT(VideoSettings, maxVideoSize)
+DECLARE_SETTINGSFACT(VideoSettings, recordingSegmentSize)
+DECLARE_SETTINGSFACT(VideoSettings, recordingSegmentLength)
+DECLARE_SETTINGSFACT(VideoSettings, recordingMetadata)
 DECLARE_SETTINGSFACT(VideoSettings, enableStorageLimit)
 DECLARE_SETTINGSFACT(VideoSettings, rtspTimeout)
 DECLARE_SETTINGSFACT(VideoSettings, streamEnabled)
@@ -30,6 +30,9 @@ public:
     DEFINE_SETTINGFACT(showRecControl)
     DEFINE_SETTINGFACT(recordingFormat)
     DEFINE_SETTINGFACT(maxVideoSize)
+    DEFINE_SETTINGFACT(recordingSegmentSize)
+    DEFINE_SETTINGFACT(recordingSegmentLength)
+    DEFINE_SETTINGFACT(recordingMetadata)
     DEFINE_SETTINGFACT(enableStorageLimit)
     DEFINE_SETTINGFACT(rtspTimeout)
     DEFINE_SETTINGFACT(streamEnabled)
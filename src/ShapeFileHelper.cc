@@ -13,6 +13,10 @@
 #include "SHPFileHelper.h"
 
 #include <QFile>
+#include <QPointF>
+#include <QtMath>
+
+#include <vector>
 
 const char* ShapeFileHelper::_errorPrefix = QT_TR_NOOP("Shape file load failed. %1");
 
@@ -61,7 +65,7 @@ ShapeFileHelper::ShapeType ShapeFileHelper::determineShapeType(const QString& fi
     return shapeType;
 }
 
-bool ShapeFileHelper::loadPolygonFromFile(const QString& file, QList<QGeoCoordinate>& vertices, QString& errorString)
+bool ShapeFileHelper::loadPolygonFromFile(const QString& file, QList<QGeoCoordinate>& vertices, QString& errorString, double simplifyToleranceMeters, const ProgressCallback& progress)
 {
     bool success = false;
 
@@ -71,16 +75,20 @@ bool ShapeFileHelper::loadPolygonFromFile(const QString& file, QList<QGeoCoordin
     bool fileIsKML = _fileIsKML(file, errorString);
     if (errorString.isEmpty()) {
         if (fileIsKML) {
-            success = KMLHelper::loadPolygonFromFile(file, vertices, errorString);
+            success = KMLHelper::loadPolygonFromFile(file, vertices, errorString, progress);
         } else {
-            success = SHPFileHelper::loadPolygonFromFile(file, vertices, errorString);
+            success = SHPFileHelper::loadPolygonFromFile(file, vertices, errorString, progress);
         }
     }
 
+    if (success && simplifyToleranceMeters > 0) {
+        simplify(vertices, simplifyToleranceMeters, true /* closed */);
+    }
+
     return success;
 }
 
-bool ShapeFileHelper::loadPolylineFromFile(const QString& file, QList<QGeoCoordinate>& coords, QString& errorString)
+bool ShapeFileHelper::loadPolylineFromFile(const QString& file, QList<QGeoCoordinate>& coords, QString& errorString, double simplifyToleranceMeters, const ProgressCallback& progress)
 {
     errorString.clear();
     coords.clear();
@@ -88,15 +96,126 @@ bool ShapeFileHelper::loadPolylineFromFile(const QString& file, QList<QGeoCoordi
     bool fileIsKML = _fileIsKML(file, errorString);
     if (errorString.isEmpty()) {
         if (fileIsKML) {
-            KMLHelper::loadPolylineFromFile(file, coords, errorString);
+            KMLHelper::loadPolylineFromFile(file, coords, errorString, progress);
         } else {
             errorString = QString(_errorPrefix).arg(tr("Polyline not support from SHP files."));
         }
     }
 
+    if (errorString.isEmpty() && simplifyToleranceMeters > 0) {
+        simplify(coords, simplifyToleranceMeters, false /* closed */);
+    }
+
     return errorString.isEmpty();
 }
 
+/// Distance of the point from the segment
+static double _segmentDistance(const QPointF& point, const QPointF& segmentStart, const QPointF& segmentEnd)
+{
+    const QPointF   segment         = segmentEnd - segmentStart;
+    const double    lengthSquared   = QPointF::dotProduct(segment, segment);
+    QPointF         closest         = segmentStart;
+
+    if (lengthSquared > 0) {
+        const double t = qBound(0.0, QPointF::dotProduct(point - segmentStart, segment) / lengthSquared, 1.0);
+        closest += segment * t;
+    }
+
+    const QPointF delta = point - closest;
+    return qSqrt(QPointF::dotProduct(delta, delta));
+}
+
+/// Marks the points Douglas-Peucker keeps between first and last, which are always kept
+static void _douglasPeucker(const std::vector<QPointF>& points, size_t first, size_t last, double tolerance, std::vector<bool>& keep)
+{
+    keep[first] = true;
+    keep[last]  = true;
+
+    // Ranges are kept on a stack instead of recursing, shapes with many vertices would run out of call stack
+    std::vector<std::pair<size_t, size_t>> ranges { { first, last } };
+    while (!ranges.empty()) {
+        const size_t rangeFirst = ranges.back().first;
+        const size_t rangeLast  = ranges.back().second;
+        ranges.pop_back();
+
+        double  maxDistance = 0;
+        size_t  maxIndex    = rangeFirst;
+        for (size_t i = rangeFirst + 1; i < rangeLast; i++) {
+            const double distance = _segmentDistance(points[i], points[rangeFirst], points[rangeLast]);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                maxIndex    = i;
+            }
+        }
+        if (maxDistance > tolerance) {
+            keep[maxIndex] = true;
+            ranges.push_back({ rangeFirst, maxIndex });
+            ranges.push_back({ maxIndex, rangeLast });
+        }
+    }
+}
+
+void ShapeFileHelper::simplify(QList<QGeoCoordinate>& coords, double toleranceMeters, bool closed)
+{
+    // Meters per degree of latitude on the sphere QGeoCoordinate uses
+    static const double metersPerDegree = 111195.08;
+
+    const size_t cCoords = static_cast<size_t>(coords.count());
+    if (cCoords < (closed ? 4u : 3u) || toleranceMeters <= 0) {
+        return;
+    }
+
+    // An equirectangular projection around the middle latitude is close enough to judge the tolerance with, even for
+    // shapes the size of a country
+    double minLatitude = coords.first().latitude();
+    double maxLatitude = minLatitude;
+    for (const QGeoCoordinate& coord: coords) {
+        minLatitude = qMin(minLatitude, coord.latitude());
+        maxLatitude = qMax(maxLatitude, coord.latitude());
+    }
+    const double metersPerLonDeg = metersPerDegree * qCos(qDegreesToRadians((minLatitude + maxLatitude) / 2.0));
+
+    std::vector<QPointF> points;
+    points.reserve(cCoords);
+    for (const QGeoCoordinate& coord: coords) {
+        points.push_back(QPointF(coord.longitude() * metersPerLonDeg, coord.latitude() * metersPerDegree));
+    }
+
+    std::vector<bool> keep(cCoords, false);
+    if (closed) {
+        // A ring has no end points, it is split at the first vertex and the one farthest from it so both halves keep
+        // the overall extent of the polygon
+        size_t  farthestIndex       = 1;
+        double  farthestDistance    = 0;
+        for (size_t i = 1; i < cCoords; i++) {
+            const QPointF   delta       = points[i] - points[0];
+            const double    distance    = QPointF::dotProduct(delta, delta);
+            if (distance > farthestDistance) {
+                farthestDistance    = distance;
+                farthestIndex       = i;
+            }
+        }
+        points.push_back(points[0]);
+        keep.push_back(false);
+        _douglasPeucker(points, 0, farthestIndex, toleranceMeters, keep);
+        _douglasPeucker(points, farthestIndex, cCoords, toleranceMeters, keep);
+    } else {
+        _douglasPeucker(points, 0, cCoords - 1, toleranceMeters, keep);
+    }
+
+    QList<QGeoCoordinate> simplified;
+    for (size_t i = 0; i < cCoords; i++) {
+        if (keep[i]) {
+            simplified.append(coords[static_cast<int>(i)]);
+        }
+    }
+
+    // A polygon simplified down to a line is not a polygon any more
+    if (!closed || simplified.count() >= 3) {
+        coords = simplified;
+    }
+}
+
 QStringList ShapeFileHelper::fileDialogKMLFilters(void) const
 {
     return QStringList(tr("KML Files (*.%1)").arg(AppSettings::kmlFileExtension));
@@ -14,6 +14,8 @@
 #include <QGeoCoordinate>
 #include <QVariant>
 
+#include <functional>
+
 /// Routines for loading polygons or polylines from KML or SHP files.
 class ShapeFileHelper : public QObject
 {
@@ -27,6 +29,10 @@ public:
     };
     Q_ENUM(ShapeType)
 
+    /// Called with the progress of a load from 0 to 1. Loads may run on a worker thread, in which case so does this.
+    /// @return false: Cancel the load
+    typedef std::function<bool(double progress)> ProgressCallback;
+
     Q_PROPERTY(QStringList fileDialogKMLFilters         READ fileDialogKMLFilters       CONSTANT) ///< File filter list for load/save KML file dialogs
     Q_PROPERTY(QStringList fileDialogKMLOrSHPFilters    READ fileDialogKMLOrSHPFilters  CONSTANT) ///< File filter list for load/save shape file dialogs
 
@@ -38,8 +44,17 @@ public:
     QStringList fileDialogKMLOrSHPFilters   (void) const;
 
     static ShapeType determineShapeType(const QString& file, QString& errorString);
-    static bool loadPolygonFromFile(const QString& file, QList<QGeoCoordinate>& vertices, QString& errorString);
-    static bool loadPolylineFromFile(const QString& file, QList<QGeoCoordinate>& coords, QString& errorString);
+
+    /// Loads a shape from the file
+    ///     @param simplifyToleranceMeters Simplify the shape to this tolerance, 0 to load it as is
+    ///     @param progress Optional load progress callback
+    static bool loadPolygonFromFile(const QString& file, QList<QGeoCoordinate>& vertices, QString& errorString, double simplifyToleranceMeters = 0, const ProgressCallback& progress = ProgressCallback());
+    static bool loadPolylineFromFile(const QString& file, QList<QGeoCoordinate>& coords, QString& errorString, double simplifyToleranceMeters = 0, const ProgressCallback& progress = ProgressCallback());
+
+    /// Simplifies the coordinates with Douglas-Peucker, dropping the ones which are within toleranceMeters of the
+    /// simplified shape
+    ///     @param closed true: Coordinates are a polygon, which always keeps at least three vertices
+    static void simplify(QList<QGeoCoordinate>& coords, double toleranceMeters, bool closed);
 
 private:
     static bool _fileIsKML(const QString& file, QString& errorString);
@@ -13,6 +13,7 @@
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
 #include "VideoManager.h"
+#include "LinkManager.h"
 
 #include <QSettings>
 
@@ -62,20 +63,11 @@ TaisyncManager::_close()
         _taiSettings = nullptr;
     }
 #if defined(__ios__) || defined(__android__)
-    if (_taiTelemetery) {
-        _taiTelemetery->close();
-        _taiTelemetery->deleteLater();
-        _taiTelemetery = nullptr;
-    }
-    if(_telemetrySocket) {
-        _telemetrySocket->close();
-        _telemetrySocket->deleteLater();
-        _telemetrySocket = nullptr;
-    }
-    if (_taiVideo) {
-        _taiVideo->close();
-        _taiVideo->deleteLater();
-        _taiVideo = nullptr;
+    if (_telemetryConfig) {
+        if (_linkManager) {
+            _linkManager->removeConfiguration(_telemetryConfig);
+        }
+        _telemetryConfig = nullptr;
     }
 #endif
 }
@@ -121,6 +113,9 @@ void
 TaisyncManager::setToolbox(QGCToolbox* toolbox)
 {
     QGCTool::setToolbox(toolbox);
+#if defined(__ios__) || defined(__android__)
+    _linkManager = toolbox->linkManager();
+#endif
     {
         //-- Radio Mode
         QStringList enums;
@@ -291,15 +286,16 @@ TaisyncManager::_setEnabled()
             connect(_taiSettings, &TaisyncSettings::disconnected,   this, &TaisyncManager::_disconnected);
         }
 #if defined(__ios__) || defined(__android__)
-        if(!_taiTelemetery) {
-            _taiTelemetery = new TaisyncTelemetry(this);
-            QObject::connect(_taiTelemetery, &TaisyncTelemetry::bytesReady, this, &TaisyncManager::_readTelemBytes);
-            _telemetrySocket = new QUdpSocket(this);
-            _telemetrySocket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption,    64 * 1024);
-            _telemetrySocket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 64 * 1024);
-            QObject::connect(_telemetrySocket, &QUdpSocket::readyRead, this, &TaisyncManager::_readUDPBytes);
-            _telemetrySocket->bind(QHostAddress::LocalHost, 0, QUdpSocket::ShareAddress);
-            _taiTelemetery->start();
+        if(!_telemetryConfig && _linkManager) {
+            //-- Telemetry goes straight from the radio into MAVLinkProtocol on its own link
+            auto* config = new TaisyncTelemetryConfiguration(tr("Taisync Telemetry"));
+            config->setDynamic(true);
+            SharedLinkConfigurationPtr sharedConfig = _linkManager->addConfiguration(config);
+            if (_linkManager->createConnectedLink(sharedConfig)) {
+                _telemetryConfig = config;
+            } else {
+                _linkManager->removeConfiguration(config);
+            }
         }
 #endif
         _reqMask = static_cast<uint32_t>(REQ_ALL);
@@ -339,22 +335,13 @@ TaisyncManager::_setVideoEnabled()
         pVSettings->aspectRatio()->setRawValue(1024.0 / 768.0);
         pVSettings->videoSource()->setRawValue(QString(VideoSettings::videoSourceUDPH264));
 #if defined(__ios__) || defined(__android__)
-        if(!_taiVideo) {
-            //-- iOS and Android receive raw h.264 and need a different pipeline
-            qgcApp()->toolbox()->videoManager()->setIsTaisync(true);
-            _taiVideo = new TaisyncVideoReceiver(this);
-            _taiVideo->start();
-        }
+        //-- iOS and Android receive raw h.264 over TCP, which the video receiver takes directly
+        qgcApp()->toolbox()->videoManager()->setIsTaisync(true);
 #endif
     } else {
         //-- Restore video settings.
 #if defined(__ios__) || defined(__android__)
         qgcApp()->toolbox()->videoManager()->setIsTaisync(false);
-        if (_taiVideo) {
-            _taiVideo->close();
-            _taiVideo->deleteLater();
-            _taiVideo = nullptr;
-        }
 #endif
         VideoSettings* pVSettings = qgcApp()->toolbox()->settingsManager()->videoSettings();
         _restoreVideoSettings(pVSettings->videoSource());
@@ -365,35 +352,6 @@ TaisyncManager::_setVideoEnabled()
     _enableVideo = enable;
 }
 
-//-----------------------------------------------------------------------------
-#if defined(__ios__) || defined(__android__)
-void
-TaisyncManager::_readTelemBytes(QByteArray bytesIn)
-{
-    //-- Send telemetry from vehicle to QGC (using normal UDP)
-    _telemetrySocket->writeDatagram(bytesIn, QHostAddress::LocalHost, TAISYNC_TELEM_TARGET_PORT);
-}
-#endif
-
-//-----------------------------------------------------------------------------
-#if defined(__ios__) || defined(__android__)
-void
-TaisyncManager::_readUDPBytes()
-{
-    if (!_telemetrySocket || !_taiTelemetery) {
-        return;
-    }
-    //-- Read UDP data from QGC
-    while (_telemetrySocket->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize(static_cast<int>(_telemetrySocket->pendingDatagramSize()));
-        _telemetrySocket->readDatagram(datagram.data(), datagram.size());
-        //-- Send it to vehicle
-        _taiTelemetery->writeBytes(datagram);
-    }
-}
-#endif
-
 //-----------------------------------------------------------------------------
 void
 TaisyncManager::_connected()
@@ -15,14 +15,15 @@
 #include "Fact.h"
 #if defined(__ios__) || defined(__android__)
 #include "TaisyncTelemetry.h"
-#include "TaisyncVideoReceiver.h"
 #endif
 
 #include <QTimer>
 #include <QTime>
+#include <QPointer>
 
 class AppSettings;
 class QGCApplication;
+class LinkManager;
 
 //-----------------------------------------------------------------------------
 class TaisyncManager : public QGCTool
@@ -102,10 +103,6 @@ private slots:
     void    _setVideoEnabled                ();
     void    _radioSettingsChanged           (QVariant);
     void    _videoSettingsChanged           (QVariant);
-#if defined(__ios__) || defined(__android__)
-    void    _readUDPBytes                   ();
-    void    _readTelemBytes                 (QByteArray bytesIn);
-#endif
 
 private:
     void    _close                          ();
@@ -133,9 +130,8 @@ private:
     TaisyncManager*         _taiManager     = nullptr;
     TaisyncSettings*        _taiSettings    = nullptr;
 #if defined(__ios__) || defined(__android__)
-    TaisyncTelemetry*       _taiTelemetery  = nullptr;
-    TaisyncVideoReceiver*   _taiVideo       = nullptr;
-    QUdpSocket*             _telemetrySocket= nullptr;
+    QPointer<LinkManager>   _linkManager;                   ///< Cleared once the link manager is gone at shutdown
+    LinkConfiguration*      _telemetryConfig= nullptr;      ///< Dynamic telemetry link, owned by LinkManager
 #endif
     bool            _enableVideo            = true;
     bool            _enabled                = true;
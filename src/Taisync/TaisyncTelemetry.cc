@@ -8,57 +8,173 @@
  ****************************************************************************/
 
 #include "TaisyncTelemetry.h"
-#include "SettingsManager.h"
-#include "QGCApplication.h"
-#include "VideoManager.h"
+#include "TaisyncHandler.h"
+
+#include <QTcpServer>
 
 //-----------------------------------------------------------------------------
-TaisyncTelemetry::TaisyncTelemetry(QObject* parent)
-    : TaisyncHandler(parent)
+TaisyncTelemetryConfiguration::TaisyncTelemetryConfiguration(const QString& name)
+    : LinkConfiguration(name)
 {
 }
 
 //-----------------------------------------------------------------------------
-bool
-TaisyncTelemetry::close()
+TaisyncTelemetryConfiguration::TaisyncTelemetryConfiguration(TaisyncTelemetryConfiguration* source)
+    : LinkConfiguration(source)
+{
+}
+
+//-----------------------------------------------------------------------------
+TaisyncTelemetryLink::TaisyncTelemetryLink(SharedLinkConfigurationPtr& config)
+    : LinkInterface(config)
+{
+    moveToThread(this);
+}
+
+//-----------------------------------------------------------------------------
+TaisyncTelemetryLink::~TaisyncTelemetryLink()
+{
+    disconnect();
+}
+
+//-----------------------------------------------------------------------------
+void
+TaisyncTelemetryLink::run()
 {
-    if(TaisyncHandler::close()) {
+    if (_listen()) {
+        exec();
+    }
+
+    // Server and socket belong to this thread, they must go away before it finishes
+    _setSocket(nullptr);
+    if (_server) {
         qCDebug(TaisyncLog) << "Close Taisync Telemetry";
-        return true;
+        delete _server;
+        _server = nullptr;
+    }
+    _listening = false;
+}
+
+//-----------------------------------------------------------------------------
+bool
+TaisyncTelemetryLink::_connect()
+{
+    if (isRunning()) {
+        quit();
+        wait();
+    }
+    start(HighPriority);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+TaisyncTelemetryLink::disconnect()
+{
+    bool wasConnected = isRunning();
+
+    quit();
+    wait();
+    if (wasConnected) {
+        emit disconnected();
     }
-    return false;
 }
 
 //-----------------------------------------------------------------------------
-bool TaisyncTelemetry::start()
+bool
+TaisyncTelemetryLink::isConnected() const
 {
+    return _listening;
+}
+
+//-----------------------------------------------------------------------------
+bool
+TaisyncTelemetryLink::_listen()
+{
+    _readBuffer.reserve(_readBufferReserve);
+
     qCDebug(TaisyncLog) << "Start Taisync Telemetry";
-    return _start(TAISYNC_TELEM_PORT);
+    _server = new QTcpServer();
+    if (!_server->listen(QHostAddress::AnyIPv4, TAISYNC_TELEM_PORT)) {
+        emit communicationError(tr("Link Error"), tr("Error on link %1. Unable to listen on port %2: %3").arg(_config->name()).arg(TAISYNC_TELEM_PORT).arg(_server->errorString()));
+        return false;
+    }
+    QObject::connect(_server, &QTcpServer::newConnection, this, &TaisyncTelemetryLink::_newConnection);
+    // The radio comes and goes, the link stays usable for as long as we are listening
+    _listening = true;
+    emit connected();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/// Replaces the current radio socket, if any
+void
+TaisyncTelemetryLink::_setSocket(QTcpSocket* socket)
+{
+    if (_socket) {
+        QObject::disconnect(_socket, nullptr, this, nullptr);
+        _socket->abort();
+        delete _socket;
+    }
+    _socket = socket;
+    if (_socket) {
+        // MAVLink packets are small and latency matters more than throughput over the radio
+        _socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        QObject::connect(_socket, &QIODevice::readyRead,               this, &TaisyncTelemetryLink::_readBytes);
+        QObject::connect(_socket, &QAbstractSocket::disconnected,      this, &TaisyncTelemetryLink::_socketDisconnected);
+    }
 }
 
 //-----------------------------------------------------------------------------
 void
-TaisyncTelemetry::writeBytes(QByteArray bytes)
+TaisyncTelemetryLink::_newConnection()
 {
-    if(_tcpSocket) {
-        _tcpSocket->write(bytes);
+    // Only a single radio is supported, a new connection replaces the old one
+    QTcpSocket* socket = _server->nextPendingConnection();
+    while (_server->hasPendingConnections()) {
+        delete socket;
+        socket = _server->nextPendingConnection();
+    }
+    if (socket) {
+        qCDebug(TaisyncLog) << "New Taisync Telemetry Connection";
+        _setSocket(socket);
+    } else {
+        qCWarning(TaisyncLog) << "New Taisync TCP Connection provided no socket";
     }
 }
 
 //-----------------------------------------------------------------------------
 void
-TaisyncTelemetry::_newConnection()
+TaisyncTelemetryLink::_socketDisconnected()
 {
-    TaisyncHandler::_newConnection();
-    qCDebug(TaisyncLog) << "New Taisync Temeletry Connection";
+    qCDebug(TaisyncLog) << "Taisync Telemetry Connection Closed";
+    // Deleting the socket from within its own signal is not allowed
+    QTcpSocket* socket = _socket;
+    QObject::disconnect(socket, nullptr, this, nullptr);
+    _socket = nullptr;
+    socket->deleteLater();
+}
+
+//-----------------------------------------------------------------------------
+void
+TaisyncTelemetryLink::_writeBytes(const QByteArray data)
+{
+    if (_socket && _socket->state() == QAbstractSocket::ConnectedState) {
+        _socket->write(data);
+        emit bytesSent(this, data);
+    }
 }
 
 //-----------------------------------------------------------------------------
 void
-TaisyncTelemetry::_readBytes()
+TaisyncTelemetryLink::_readBytes()
 {
-    while(_tcpSocket->bytesAvailable()) {
-        QByteArray bytesIn = _tcpSocket->read(_tcpSocket->bytesAvailable());
-        emit bytesReady(bytesIn);
+    qint64 byteCount = _socket->bytesAvailable();
+    if (byteCount > 0) {
+        // The only receiver is connected directly, so once the signal returns the buffer is no longer shared and
+        // the next read can reuse its storage
+        _readBuffer.resize(static_cast<int>(byteCount));
+        _readBuffer.resize(static_cast<int>(_socket->read(_readBuffer.data(), _readBuffer.size())));
+        emit bytesReceived(this, _readBuffer);
     }
 }
@@ -9,25 +9,71 @@
 
 #pragma once
 
-#include "TaisyncHandler.h"
-#include <QUdpSocket>
-#include <QTimer>
+#include "LinkConfiguration.h"
+#include "LinkInterface.h"
 
-class TaisyncTelemetry : public TaisyncHandler
+#include <QByteArray>
+#include <QTcpSocket>
+
+#include <atomic>
+
+class QTcpServer;
+
+//-----------------------------------------------------------------------------
+/// Configuration for the Taisync telemetry channel. TaisyncManager creates it as a dynamic link while Taisync is
+/// enabled, there is nothing for the user to set.
+class TaisyncTelemetryConfiguration : public LinkConfiguration
 {
     Q_OBJECT
 public:
+    TaisyncTelemetryConfiguration       (const QString& name);
+    TaisyncTelemetryConfiguration       (TaisyncTelemetryConfiguration* source);
 
-    explicit TaisyncTelemetry           (QObject* parent = nullptr);
-    bool    close                       () override;
-    bool    start                       () override;
-    void    writeBytes                  (QByteArray bytes);
+    //LinkConfiguration overrides
+    LinkType    type                    (void) override                                         { return LinkConfiguration::TypeTaisync; }
+    void        loadSettings            (QSettings& settings, const QString& root) override     { Q_UNUSED(settings); Q_UNUSED(root); }
+    void        saveSettings            (QSettings& settings, const QString& root) override     { Q_UNUSED(settings); Q_UNUSED(root); }
+    QString     settingsURL             (void) override                                         { return QString(); }
+    QString     settingsTitle           (void) override                                         { return tr("Taisync Telemetry"); }
+};
 
-signals:
-    void    bytesReady                   (QByteArray bytes);
+//-----------------------------------------------------------------------------
+/// MAVLink over the Taisync TCP telemetry channel. The radio connects to us, the server and socket live on the link
+/// thread and bytes go straight from the socket into MAVLinkProtocol, which is connected directly.
+class TaisyncTelemetryLink : public LinkInterface
+{
+    Q_OBJECT
+public:
+    TaisyncTelemetryLink                (SharedLinkConfigurationPtr& config);
+    virtual ~TaisyncTelemetryLink       ();
+
+    // LinkInterface overrides
+    bool    isConnected                 (void) const override;
+    void    disconnect                  (void) override;
+
+protected:
+    // QThread overrides
+    void    run                         (void) override;
 
 private slots:
-    void    _newConnection              () override;
-    void    _readBytes                  () override;
+    // LinkInterface overrides
+    void    _writeBytes                 (const QByteArray data) override;
+
+    void    _newConnection              (void);
+    void    _socketDisconnected         (void);
+    void    _readBytes                  (void);
+
+private:
+    // LinkInterface overrides
+    bool    _connect                    (void) override;
+
+    bool    _listen                     (void);
+    void    _setSocket                  (QTcpSocket* socket);
+
+    QTcpServer*         _server             = nullptr;
+    QTcpSocket*         _socket             = nullptr;
+    std::atomic<bool>   _listening          { false };
+    QByteArray          _readBuffer;                    ///< Reused for every read, its capacity only ever grows
 
+    static const int _readBufferReserve = 16 * 1024;
 };
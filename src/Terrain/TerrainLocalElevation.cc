@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainLocalElevation.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <QtMath>
+
+QGC_LOGGING_CATEGORY(TerrainLocalElevationLog, "TerrainLocalElevationLog")
+
+Q_GLOBAL_STATIC(TerrainLocalElevation, _terrainLocalElevation)
+
+TerrainLocalElevation::TerrainLocalElevation(void)
+{
+
+}
+
+TerrainLocalElevation::~TerrainLocalElevation()
+{
+    _clearFiles();
+}
+
+TerrainLocalElevation* TerrainLocalElevation::instance(void)
+{
+    return _terrainLocalElevation;
+}
+
+quint32 TerrainLocalElevation::_cellKey(int swLatitude, int swLongitude)
+{
+    return (static_cast<quint32>(swLatitude + 90) << 16) | static_cast<quint32>(swLongitude + 180);
+}
+
+void TerrainLocalElevation::_clearFiles(void)
+{
+    for (ElevationFile_t& elevationFile: _files) {
+        // Deleting the file also unmaps it
+        delete elevationFile.file;
+    }
+    _files.clear();
+    _knownPaths.clear();
+}
+
+void TerrainLocalElevation::_scanDirectory(void)
+{
+    _scanTimer.start();
+
+    QString directory = qgcApp()->toolbox()->settingsManager()->appSettings()->terrainSavePath();
+    if (directory != _directory) {
+        _clearFiles();
+        _directory = directory;
+    }
+    if (_directory.isEmpty()) {
+        return;
+    }
+
+    QDirIterator iter(_directory, { QStringLiteral("*.hgt"), QStringLiteral("*.dt0"), QStringLiteral("*.dt1"), QStringLiteral("*.dt2") }, QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+    while (iter.hasNext()) {
+        QString path = iter.next();
+        if (!_knownPaths.contains(path)) {
+            _knownPaths.insert(path);
+            _addFile(path);
+        }
+    }
+}
+
+bool TerrainLocalElevation::_parseDTEDAngle(const char* field, double& angle)
+{
+    // DDDMMSSH
+    bool ok = true;
+    QString     str     = QString::fromLatin1(field, 8);
+    int         degrees = str.mid(0, 3).toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+    int minutes = str.mid(3, 2).toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+    int seconds = str.mid(5, 2).toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+
+    angle = degrees + (minutes / 60.0) + (seconds / 3600.0);
+    QChar hemisphere = str[7].toUpper();
+    if (hemisphere == 'S' || hemisphere == 'W') {
+        angle = -angle;
+    } else if (hemisphere != 'N' && hemisphere != 'E') {
+        return false;
+    }
+    return true;
+}
+
+void TerrainLocalElevation::_addFile(const QString& path)
+{
+    QFileInfo       fileInfo(path);
+    ElevationFile_t elevationFile;
+
+    elevationFile.path      = path;
+    elevationFile.file      = nullptr;
+    elevationFile.data      = nullptr;
+    elevationFile.failed    = false;
+
+    if (fileInfo.suffix().compare(QStringLiteral("hgt"), Qt::CaseInsensitive) == 0) {
+        // The cell is in the name, for example N47E008.hgt. The grid is square, 1201 points for SRTM3 or 3601 for SRTM1.
+        static const QRegularExpression hgtName(QStringLiteral("^([NS])(\\d{2})([EW])(\\d{3})$"), QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatch match = hgtName.match(fileInfo.completeBaseName());
+        if (!match.hasMatch()) {
+            qCWarning(TerrainLocalElevationLog) << "Unrecognized SRTM file name" << path;
+            return;
+        }
+        int cPoints = qRound(qSqrt(fileInfo.size() / 2.0));
+        if (cPoints < 2 || static_cast<qint64>(cPoints) * cPoints * 2 != fileInfo.size()) {
+            qCWarning(TerrainLocalElevationLog) << "Unexpected SRTM file size" << path << fileInfo.size();
+            return;
+        }
+
+        elevationFile.format            = FormatHGT;
+        elevationFile.swLatitude        = match.captured(2).toInt() * (match.captured(1).compare(QStringLiteral("S"), Qt::CaseInsensitive) == 0 ? -1 : 1);
+        elevationFile.swLongitude       = match.captured(4).toInt() * (match.captured(3).compare(QStringLiteral("W"), Qt::CaseInsensitive) == 0 ? -1 : 1);
+        elevationFile.cLatitudePoints   = cPoints;
+        elevationFile.cLongitudePoints  = cPoints;
+    } else {
+        // DTED carries the cell and grid size in the User Header Label at the start of the file
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCWarning(TerrainLocalElevationLog) << "Unable to open DTED file" << path << file.errorString();
+            return;
+        }
+        QByteArray uhl = file.read(80);
+        if (uhl.count() != 80 || !uhl.startsWith("UHL") ||
+                !_parseDTEDAngle(uhl.constData() + 4, elevationFile.swLongitude) ||
+                !_parseDTEDAngle(uhl.constData() + 12, elevationFile.swLatitude)) {
+            qCWarning(TerrainLocalElevationLog) << "Invalid DTED header" << path;
+            return;
+        }
+        elevationFile.format            = FormatDTED;
+        elevationFile.cLongitudePoints  = uhl.mid(47, 4).toInt();
+        elevationFile.cLatitudePoints   = uhl.mid(51, 4).toInt();
+
+        qint64 expectedSize = _dtedDataOffset + (static_cast<qint64>(elevationFile.cLongitudePoints) * ((elevationFile.cLatitudePoints * 2) + _dtedRecordOverhead));
+        if (elevationFile.cLongitudePoints < 2 || elevationFile.cLatitudePoints < 2 || fileInfo.size() < expectedSize) {
+            qCWarning(TerrainLocalElevationLog) << "Unexpected DTED grid size" << path << elevationFile.cLongitudePoints << elevationFile.cLatitudePoints << fileInfo.size();
+            return;
+        }
+    }
+
+    quint32 key = _cellKey(qRound(elevationFile.swLatitude), qRound(elevationFile.swLongitude));
+    auto iter = _files.find(key);
+    if (iter != _files.end()) {
+        // Keep the finer grid when the same cell is there more than once
+        if (static_cast<qint64>(iter->cLatitudePoints) * iter->cLongitudePoints >= static_cast<qint64>(elevationFile.cLatitudePoints) * elevationFile.cLongitudePoints) {
+            return;
+        }
+        delete iter->file;
+    }
+
+    qCDebug(TerrainLocalElevationLog) << "Added" << path << elevationFile.swLatitude << elevationFile.swLongitude << elevationFile.cLatitudePoints << elevationFile.cLongitudePoints;
+    _files[key] = elevationFile;
+}
+
+bool TerrainLocalElevation::_mapFile(ElevationFile_t& elevationFile)
+{
+    QFile* file = new QFile(elevationFile.path);
+    if (file->open(QIODevice::ReadOnly)) {
+        elevationFile.data = file->map(0, file->size());
+    }
+    if (!elevationFile.data) {
+        qCWarning(TerrainLocalElevationLog) << "Unable to map elevation file" << elevationFile.path << file->errorString();
+        delete file;
+        elevationFile.failed = true;
+        return false;
+    }
+
+    elevationFile.file = file;
+    return true;
+}
+
+bool TerrainLocalElevation::_value(const ElevationFile_t& elevationFile, int latitudeIndex, int longitudeIndex, double& value) const
+{
+    if (elevationFile.format == FormatHGT) {
+        // Rows go from north to south
+        const uchar*    point   = elevationFile.data + ((static_cast<qint64>(elevationFile.cLatitudePoints - 1 - latitudeIndex) * elevationFile.cLongitudePoints) + longitudeIndex) * 2;
+        qint16          height  = qFromBigEndian<qint16>(point);
+        if (height == -32768) {
+            // Void
+            return false;
+        }
+        value = height;
+    } else {
+        // One record per longitude line from west to east with the points going from south to north. Heights are
+        // sign-magnitude rather than two's complement.
+        qint64          recordSize  = (elevationFile.cLatitudePoints * 2) + _dtedRecordOverhead;
+        const uchar*    point       = elevationFile.data + _dtedDataOffset + (longitudeIndex * recordSize) + 8 + (latitudeIndex * 2);
+        quint16         raw         = qFromBigEndian<quint16>(point);
+        if (raw == 0xFFFF) {
+            // Void
+            return false;
+        }
+        value = (raw & 0x8000) ? -static_cast<double>(raw & 0x7FFF) : static_cast<double>(raw);
+    }
+    return true;
+}
+
+bool TerrainLocalElevation::_elevation(ElevationFile_t& elevationFile, double latitude, double longitude, double& elevation)
+{
+    // Same bilinear interpolation as the downloaded tiles, clamped to the edges of the cell
+    double  latitudePosition    = (latitude - elevationFile.swLatitude) * (elevationFile.cLatitudePoints - 1);
+    double  longitudePosition   = (longitude - elevationFile.swLongitude) * (elevationFile.cLongitudePoints - 1);
+    int     latitudeIndex       = qBound(0, static_cast<int>(qFloor(latitudePosition)), elevationFile.cLatitudePoints - 2);
+    int     longitudeIndex      = qBound(0, static_cast<int>(qFloor(longitudePosition)), elevationFile.cLongitudePoints - 2);
+    double  latitudeFraction    = qBound(0.0, latitudePosition - latitudeIndex, 1.0);
+    double  longitudeFraction   = qBound(0.0, longitudePosition - longitudeIndex, 1.0);
+
+    double sw, se, nw, ne;
+    if (!_value(elevationFile, latitudeIndex,     longitudeIndex,     sw) ||
+            !_value(elevationFile, latitudeIndex,     longitudeIndex + 1, se) ||
+            !_value(elevationFile, latitudeIndex + 1, longitudeIndex,     nw) ||
+            !_value(elevationFile, latitudeIndex + 1, longitudeIndex + 1, ne)) {
+        return false;
+    }
+
+    double south = sw + ((se - sw) * longitudeFraction);
+    double north = nw + ((ne - nw) * longitudeFraction);
+    elevation = south + ((north - south) * latitudeFraction);
+    return true;
+}
+
+bool TerrainLocalElevation::getAltitudes(const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes)
+{
+    QMutexLocker lock(&_filesMutex);
+
+    if (!_scanTimer.isValid() || _scanTimer.elapsed() > _rescanMSecs) {
+        _scanDirectory();
+    }
+    if (_files.isEmpty() || coordinates.isEmpty()) {
+        return false;
+    }
+
+    QList<double>       localAltitudes;
+    ElevationFile_t*    elevationFile   = nullptr;
+    quint32             currentKey      = 0;
+
+    localAltitudes.reserve(coordinates.count());
+    for (const QGeoCoordinate& coordinate: coordinates) {
+        quint32 key = _cellKey(qFloor(coordinate.latitude()), qFloor(coordinate.longitude()));
+
+        // Consecutive coordinates are almost always in the same cell
+        if (!elevationFile || key != currentKey) {
+            auto iter = _files.find(key);
+            if (iter == _files.end()) {
+                return false;
+            }
+            elevationFile   = &iter.value();
+            currentKey      = key;
+            if (!elevationFile->data && (elevationFile->failed || !_mapFile(*elevationFile))) {
+                return false;
+            }
+        }
+
+        double elevation;
+        if (!_elevation(*elevationFile, coordinate.latitude(), coordinate.longitude(), elevation)) {
+            return false;
+        }
+        localAltitudes.append(elevation);
+    }
+
+    altitudes.append(localAltitudes);
+    return true;
+}
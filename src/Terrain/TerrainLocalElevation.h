@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoCoordinate>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainLocalElevationLog)
+
+/// Elevation from SRTM (.hgt) and DTED (.dt0, .dt1, .dt2) files in the Terrain directory of the save path.
+///
+/// Each file covers a one degree cell. Files are memory mapped the first time a coordinate falls in their cell, so only
+/// the pages which are sampled are ever read from disk. The directory is scanned again every so often to pick up new
+/// files. Terrain queries use these heights ahead of the downloaded elevation tiles wherever the files cover a request.
+class TerrainLocalElevation
+{
+public:
+    TerrainLocalElevation(void);
+    ~TerrainLocalElevation();
+
+    static TerrainLocalElevation* instance(void);
+
+    /// Looks up the altitudes from the local files
+    ///     @param[out] altitudes Altitudes for the coordinates appended in order, only on success
+    /// @return true: all coordinates are covered by local files and have valid heights
+    bool getAltitudes(const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes);
+
+private:
+    enum FileFormat {
+        FormatHGT,
+        FormatDTED,
+    };
+
+    typedef struct {
+        QString         path;
+        FileFormat      format;
+        double          swLatitude;
+        double          swLongitude;
+        int             cLatitudePoints;        ///< Points along each longitude line, south to north
+        int             cLongitudePoints;       ///< Number of longitude lines, west to east
+        QFile*          file;                   ///< nullptr until the file is mapped
+        const uchar*    data;
+        bool            failed;                 ///< true: file could not be mapped, don't try again
+    } ElevationFile_t;
+
+    void    _scanDirectory  (void);
+    void    _addFile        (const QString& path);
+    bool    _mapFile        (ElevationFile_t& elevationFile);
+    bool    _elevation      (ElevationFile_t& elevationFile, double latitude, double longitude, double& elevation);
+    bool    _value          (const ElevationFile_t& elevationFile, int latitudeIndex, int longitudeIndex, double& value) const;
+    void    _clearFiles     (void);
+
+    static quint32 _cellKey         (int swLatitude, int swLongitude);
+    static bool    _parseDTEDAngle  (const char* field, double& angle);
+
+    QMutex                          _filesMutex;
+    QHash<quint32, ElevationFile_t> _files;                 ///< Keyed by the south west corner of the cell
+    QSet<QString>                   _knownPaths;            ///< Files already looked at, whether or not they were usable
+    QString                         _directory;
+    QElapsedTimer                   _scanTimer;
+
+    static const int    _rescanMSecs        = 10000;
+    static const int    _dtedDataOffset     = 3428;         ///< UHL, DSI and ACC records come before the elevation data
+    static const int    _dtedRecordOverhead = 12;           ///< Sentinel, block count, lon/lat counts and checksum per longitude line
+};
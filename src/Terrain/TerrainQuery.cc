@@ -8,20 +8,27 @@
  ****************************************************************************/
 
 #include "TerrainQuery.h"
+#include "TerrainLocalElevation.h"
 #include "QGCMapEngine.h"
 #include "QGeoMapReplyQGC.h"
 #include "QGCApplication.h"
+#include "QGCInstrumentation.h"
+#include "QGCNetworkManager.h"
 
 #include <QUrl>
 #include <QUrlQuery>
 #include <QNetworkRequest>
-#include <QNetworkProxy>
 #include <QNetworkReply>
 #include <QSslConfiguration>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QTimer>
+#include <QVector>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QtLocation/private/qgeotilespec_p.h>
 
 #include <cmath>
@@ -29,13 +36,23 @@
 QGC_LOGGING_CATEGORY(TerrainQueryLog, "TerrainQueryLog")
 QGC_LOGGING_CATEGORY(TerrainQueryVerboseLog, "TerrainQueryVerboseLog")
 
+QGC_INSTRUMENT_COUNTER  (TerrainTileCacheHits,      "Terrain.TileCacheHits")
+QGC_INSTRUMENT_COUNTER  (TerrainTileCacheMisses,    "Terrain.TileCacheMisses")
+QGC_INSTRUMENT_COUNTER  (TerrainTileCacheEvictions, "Terrain.TileCacheEvictions")
+QGC_INSTRUMENT_GAUGE    (TerrainTileCacheBytes,     "Terrain.TileCacheBytes")
+QGC_INSTRUMENT_GAUGE    (TerrainTileCacheCount,     "Terrain.TileCacheCount")
+QGC_INSTRUMENT_COUNTER  (TerrainTileFileLoads,      "Terrain.TileFileLoads")
+QGC_INSTRUMENT_HISTOGRAM(TerrainTileFileLoadTime,   "Terrain.TileFileLoad")
+QGC_INSTRUMENT_HISTOGRAM(TerrainTileDownloadTime,   "Terrain.TileDownload")
+QGC_INSTRUMENT_HISTOGRAM(TerrainTileDecodeTime,     "Terrain.TileDecode")
+
 Q_GLOBAL_STATIC(TerrainAtCoordinateBatchManager, _TerrainAtCoordinateBatchManager)
 Q_GLOBAL_STATIC(TerrainTileManager, _terrainTileManager)
 
 TerrainAirMapQuery::TerrainAirMapQuery(QObject* parent)
     : TerrainQueryInterface(parent)
 {
-    qCDebug(TerrainQueryVerboseLog) << "supportsSsl" << QSslSocket::supportsSsl() << "sslLibraryBuildVersionString" << QSslSocket::sslLibraryBuildVersionString();
+    qCVerbose(TerrainQueryVerboseLog) << "supportsSsl" << QSslSocket::supportsSsl() << "sslLibraryBuildVersionString" << QSslSocket::sslLibraryBuildVersionString();
 }
 
 void TerrainAirMapQuery::requestCoordinateHeights(const QList<QGeoCoordinate>& coordinates)
@@ -113,26 +130,23 @@ void TerrainAirMapQuery::_sendQuery(const QString& path, const QUrlQuery& urlQue
     sslConf.setPeerVerifyMode(QSslSocket::VerifyNone);
     request.setSslConfiguration(sslConf);
 
-    QNetworkProxy tProxy;
-    tProxy.setType(QNetworkProxy::DefaultProxy);
-    _networkManager.setProxy(tProxy);
-
-    QNetworkReply* networkReply = _networkManager.get(request);
-    if (!networkReply) {
-        qCWarning(TerrainQueryLog) << "QNetworkManager::Get did not return QNetworkReply";
-        _requestFailed();
-        return;
-    }
-    networkReply->ignoreSslErrors();
+    QGCNetworkManager::instance()->queueGet(request, QGCNetworkManager::PriorityNormal, this, [this](QNetworkReply* networkReply) {
+        if (!networkReply) {
+            qCWarning(TerrainQueryLog) << "QNetworkManager::Get did not return QNetworkReply";
+            _requestFailed();
+            return;
+        }
+        networkReply->ignoreSslErrors();
 
-    connect(networkReply, &QNetworkReply::finished, this, &TerrainAirMapQuery::_requestFinished);
-    connect(networkReply, &QNetworkReply::sslErrors, this, &TerrainAirMapQuery::_sslErrors);
+        connect(networkReply, &QNetworkReply::finished, this, &TerrainAirMapQuery::_requestFinished);
+        connect(networkReply, &QNetworkReply::sslErrors, this, &TerrainAirMapQuery::_sslErrors);
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-    connect(networkReply, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::error), this, &TerrainAirMapQuery::_requestError);
+        connect(networkReply, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::error), this, &TerrainAirMapQuery::_requestError);
 #else
-    connect(networkReply, &QNetworkReply::errorOccurred, this, &TerrainAirMapQuery::_requestError);
+        connect(networkReply, &QNetworkReply::errorOccurred, this, &TerrainAirMapQuery::_requestError);
 #endif
+    });
 }
 
 void TerrainAirMapQuery::_requestError(QNetworkReply::NetworkError code)
@@ -277,7 +291,7 @@ void TerrainAirMapQuery::_parseCarpetData(const QJsonValue& carpetJson)
 TerrainOfflineAirMapQuery::TerrainOfflineAirMapQuery(QObject* parent)
     : TerrainQueryInterface(parent)
 {
-    qCDebug(TerrainQueryVerboseLog) << "supportsSsl" << QSslSocket::supportsSsl() << "sslLibraryBuildVersionString" << QSslSocket::sslLibraryBuildVersionString();
+    qCVerbose(TerrainQueryVerboseLog) << "supportsSsl" << QSslSocket::supportsSsl() << "sslLibraryBuildVersionString" << QSslSocket::sslLibraryBuildVersionString();
 }
 
 void TerrainOfflineAirMapQuery::requestCoordinateHeights(const QList<QGeoCoordinate>& coordinates)
@@ -333,7 +347,10 @@ void TerrainOfflineAirMapQuery::_signalCarpetHeights(bool success, double minHei
     emit carpetHeightsReceived(success, minHeight, maxHeight, carpet);
 }
 
+const char* TerrainTileManager::_tileDirName = "TerrainTiles";
+
 TerrainTileManager::TerrainTileManager(void)
+    : _tiles(_maxTileCacheBytes)
 {
 
 }
@@ -346,9 +363,10 @@ void TerrainTileManager::addCoordinateQuery(TerrainOfflineAirMapQuery* terrainQu
         bool error;
         QList<double> altitudes;
 
-        if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
-            qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery queue count" << _requestQueue.count();
-            QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModeCoordinates, 0, 0, coordinates };
+        QSet<quint64> missingTiles;
+        if (!_getAltitudes(coordinates, altitudes, error, missingTiles)) {
+            qCDebug(TerrainQueryLog) << "TerrainTileManager::addCoordinateQuery queue count:missing tiles" << _requestQueue.count() << missingTiles.count();
+            QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModeCoordinates, 0, 0, coordinates, missingTiles };
             _requestQueue.append(queuedRequestInfo);
             return;
         }
@@ -396,6 +414,59 @@ QList<QGeoCoordinate> TerrainTileManager::pathQueryToCoords(const QGeoCoordinate
     return coordinates;
 }
 
+QList<QGeoCoordinate> TerrainTileManager::polyPathQueryToCoords(const QList<QGeoCoordinate>& polyPath, std::vector<int>& segmentOffsets, std::vector<double>& distanceBetween, std::vector<double>& finalDistanceBetween)
+{
+    QList<QGeoCoordinate> coordinates;
+
+    int cSegments = qMax(0, polyPath.count() - 1);
+    segmentOffsets.resize(static_cast<size_t>(cSegments + 1));
+    distanceBetween.resize(static_cast<size_t>(cSegments));
+    finalDistanceBetween.resize(static_cast<size_t>(cSegments));
+
+    // First pass sizes every segment so the coordinate list is allocated once
+    std::vector<int> rgSteps(static_cast<size_t>(cSegments));
+    int cCoord = 0;
+    for (int segment = 0; segment < cSegments; segment++) {
+        int steps = qCeil(polyPath[segment + 1].distanceTo(polyPath[segment]) / TerrainTile::tileValueSpacingMeters);
+        rgSteps[static_cast<size_t>(segment)] = steps;
+        cCoord += qMax(steps, 1) + 1;
+    }
+    coordinates.reserve(cCoord);
+
+    // Segments are short compared to the earth radius, so stepping linearly in lat/lon is the straight line in the local
+    // tangent plane. Only the spacing at either end of each segment needs a geodesic distance.
+    for (int segment = 0; segment < cSegments; segment++) {
+        const QGeoCoordinate&   fromCoord   = polyPath[segment];
+        const QGeoCoordinate&   toCoord     = polyPath[segment + 1];
+        int                     steps       = rgSteps[static_cast<size_t>(segment)];
+        int                     firstIndex  = coordinates.count();
+
+        segmentOffsets[static_cast<size_t>(segment)] = firstIndex;
+        if (steps == 0) {
+            coordinates.append(fromCoord);
+            coordinates.append(toCoord);
+            distanceBetween[static_cast<size_t>(segment)] = finalDistanceBetween[static_cast<size_t>(segment)] = fromCoord.distanceTo(toCoord);
+        } else {
+            double lat      = fromCoord.latitude();
+            double lon      = fromCoord.longitude();
+            double latDiff  = toCoord.latitude() - lat;
+            double lonDiff  = toCoord.longitude() - lon;
+            for (int i = 0; i < steps; i++) {
+                coordinates.append(QGeoCoordinate(lat + latDiff * i / steps, lon + lonDiff * i / steps));
+            }
+            // We always want the last one to be the endpoint
+            coordinates.append(toCoord);
+            distanceBetween[static_cast<size_t>(segment)]      = coordinates[firstIndex].distanceTo(coordinates[firstIndex + 1]);
+            finalDistanceBetween[static_cast<size_t>(segment)] = coordinates[coordinates.count() - 2].distanceTo(coordinates.last());
+        }
+    }
+    segmentOffsets[static_cast<size_t>(cSegments)] = coordinates.count();
+
+    qCDebug(TerrainQueryLog) << "TerrainTileManager::polyPathQueryToCoords segments:coordCount" << cSegments << coordinates.count();
+
+    return coordinates;
+}
+
 void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint)
 {
     QList<QGeoCoordinate> coordinates;
@@ -406,9 +477,10 @@ void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInt
 
     bool error;
     QList<double> altitudes;
-    if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
-        qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery queue count" << _requestQueue.count();
-        QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModePath, distanceBetween, finalDistanceBetween, coordinates };
+    QSet<quint64> missingTiles;
+    if (!_getAltitudes(coordinates, altitudes, error, missingTiles)) {
+        qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery queue count:missing tiles" << _requestQueue.count() << missingTiles.count();
+        QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModePath, distanceBetween, finalDistanceBetween, coordinates, missingTiles };
         _requestQueue.append(queuedRequestInfo);
         return;
     }
@@ -423,68 +495,229 @@ void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInt
     }
 }
 
-/// Either returns altitudes from cache or queues database request
+/// Either returns altitudes from cache or queues downloads for all of the tiles which are missing
 ///     @param[out] error true: altitude not returned due to error, false: altitudes returned
-/// @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
+/// @return true: altitude returned (check error as well), false: tile downloads queued (altitudes not returned)
 bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error)
+{
+    QSet<quint64> missingTiles;
+    return _getAltitudes(coordinates, altitudes, error, missingTiles);
+}
+
+bool TerrainTileManager::_getAltitudes(const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error, QSet<quint64>& missingTiles)
 {
     error = false;
+    missingTiles.clear();
+
+    // Elevation files on disk are used ahead of the tiles wherever they cover the whole request
+    if (TerrainLocalElevation::instance()->getAltitudes(coordinates, altitudes)) {
+        return true;
+    }
+
+    QMutexLocker    tilesLock(&_tilesMutex);
+    UrlFactory*     urlFactory = getQGCMapEngine()->urlFactory();
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    QVector<double> elevations;
+
+    // Paths and carpets are made up of long runs of neighbouring coordinates. Each run which falls within the same tile
+    // is looked up once and sampled in a single batch.
+    int runStart = 0;
+    while (runStart < coordinates.count()) {
+        const QGeoCoordinate& coordinate = coordinates[runStart];
+        int tileX = urlFactory->long2tileX("Airmap Elevation", coordinate.longitude(), 1);
+        int tileY = urlFactory->lat2tileY("Airmap Elevation", coordinate.latitude(), 1);
+
+        latitudes.clear();
+        longitudes.clear();
+        int runEnd = runStart;
+        while (runEnd < coordinates.count()) {
+            const QGeoCoordinate& runCoordinate = coordinates[runEnd];
+            if (runEnd != runStart &&
+                    (urlFactory->long2tileX("Airmap Elevation", runCoordinate.longitude(), 1) != tileX ||
+                     urlFactory->lat2tileY("Airmap Elevation", runCoordinate.latitude(), 1) != tileY)) {
+                break;
+            }
+            latitudes.append(runCoordinate.latitude());
+            longitudes.append(runCoordinate.longitude());
+            runEnd++;
+        }
+        runStart = runEnd;
 
-    for (const QGeoCoordinate& coordinate: coordinates) {
-        QString tileHash = _getTileHash(coordinate);
-        qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates hash:coordinate" << tileHash << coordinate;
+        qCVerbose(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates x:y:coordinate:count" << tileX << tileY << coordinate << latitudes.count();
 
-        _tilesMutex.lock();
-        if (_tiles.contains(tileHash)) {
-            double elevation = _tiles[tileHash].elevation(coordinate);
+        // Looking the tile up also marks it as most recently used
+        quint64             key     = _tileKey(tileX, tileY, 1);
+        const TerrainTile*  tile    = _tiles.object(key);
+        if (!tile && !missingTiles.contains(key)) {
+            tile = _loadTileFile(key);
+        }
+        if (!tile) {
+            // Keep going so that every tile the request needs is downloaded at the same time
+            if (!missingTiles.contains(key)) {
+                QGC_INSTRUMENT_ADD(TerrainTileCacheMisses, 1);
+                missingTiles.insert(key);
+                _queueTileDownload(tileX, tileY);
+            }
+            continue;
+        }
+        if (!missingTiles.isEmpty()) {
+            // Altitudes are not going to be returned anyway
+            continue;
+        }
+
+        QGC_INSTRUMENT_ADD(TerrainTileCacheHits, static_cast<quint64>(latitudes.count()));
+        elevations.resize(latitudes.count());
+        tile->elevations(latitudes.count(), latitudes.constData(), longitudes.constData(), elevations.data());
+        for (double elevation: elevations) {
             if (qIsNaN(elevation)) {
                 error = true;
                 qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates returning elevation from tile cache" << elevation;
             }
             altitudes.push_back(elevation);
-        } else {
-            if (_state != State::Downloading) {
-                QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL("Airmap Elevation", getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation",coordinate.longitude(), 1), getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1), 1, &_networkManager);
-                qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates query from database" << request.url();
-                QGeoTileSpec spec;
-                spec.setX(getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1));
-                spec.setY(getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1));
-                spec.setZoom(1);
-                spec.setMapId(getQGCMapEngine()->urlFactory()->getIdFromType("Airmap Elevation"));
-                QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
-                connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
-                _state = State::Downloading;
-            }
-            _tilesMutex.unlock();
-
-            return false;
         }
-        _tilesMutex.unlock();
+    }
+
+    if (!missingTiles.isEmpty()) {
+        altitudes.clear();
+        _startTileDownloads();
+        return false;
     }
 
     return true;
 }
 
-void TerrainTileManager::_tileFailed(void)
+void TerrainTileManager::_insertTile(quint64 key, TerrainTile* tile, int cost)
+{
+    int countBefore = _tiles.count();
+    _tiles.insert(key, tile, cost);
+    QGC_INSTRUMENT_ADD(TerrainTileCacheEvictions, static_cast<quint64>(qMax(0, countBefore + 1 - _tiles.count())));
+    QGC_INSTRUMENT_SET(TerrainTileCacheBytes, _tiles.totalCost());
+    QGC_INSTRUMENT_SET(TerrainTileCacheCount, _tiles.count());
+}
+
+QString TerrainTileManager::_tileFilePath(quint64 key)
+{
+    QString cachePath = getQGCMapEngine()->getCachePath();
+    if (cachePath.isEmpty()) {
+        return QString();
+    }
+    return QStringLiteral("%1/%2/%3.bin").arg(cachePath).arg(_tileDirName).arg(key, 16, 16, QLatin1Char('0'));
+}
+
+/// Loads a tile previously saved by _saveTileFile into the memory cache
+///     @return Tile, nullptr if there is no valid file for it
+const TerrainTile* TerrainTileManager::_loadTileFile(quint64 key)
+{
+    QGC_INSTRUMENT_SCOPE(TerrainTileFileLoadTime);
+
+    QString path = _tileFilePath(key);
+    QFile   file(path);
+    if (path.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    // Files hold the tile exactly as TerrainTile lays it out in memory, so this is a single read with no parsing
+    QByteArray bytes = file.readAll();
+    TerrainTile* tile = new TerrainTile(bytes);
+    if (!tile->isValid()) {
+        qCWarning(TerrainQueryLog) << "Removing invalid terrain tile file" << path;
+        delete tile;
+        file.remove();
+        return nullptr;
+    }
+    QGC_INSTRUMENT_ADD(TerrainTileFileLoads, 1);
+    _insertTile(key, tile, bytes.size());
+    // The cache may refuse a tile, in which case it is already deleted
+    return _tiles.object(key);
+}
+
+void TerrainTileManager::_saveTileFile(quint64 key, const QByteArray& bytes)
+{
+    QString path = _tileFilePath(key);
+    if (path.isEmpty() || !QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return;
+    }
+    // Written through a save file so an interrupted write never leaves a truncated tile behind
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) {
+        qCWarning(TerrainQueryLog) << "Unable to write terrain tile file" << path << file.errorString();
+    }
+}
+
+void TerrainTileManager::_queueTileDownload(int x, int y)
+{
+    quint64 key = _tileKey(x, y, 1);
+    if (!_downloadingTiles.contains(key) && !_queuedTiles.contains(key)) {
+        _queuedTiles.insert(key);
+        _tilesToDownload.append(QPoint(x, y));
+    }
+}
+
+void TerrainTileManager::_startTileDownloads(void)
+{
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+
+    if (!_downloadClock.isValid()) {
+        _downloadClock.start();
+    }
+    while (_downloadingTiles.count() < _maxConcurrentDownloads && !_tilesToDownload.isEmpty()) {
+        QPoint  tile    = _tilesToDownload.takeFirst();
+        quint64 key     = _tileKey(tile.x(), tile.y(), 1);
+
+        _queuedTiles.remove(key);
+        _downloadingTiles.insert(key, _downloadClock.nsecsElapsed());
+
+        QNetworkRequest request = urlFactory->getTileURL("Airmap Elevation", tile.x(), tile.y(), 1, QGCNetworkManager::instance());
+        qCDebug(TerrainQueryLog) << "TerrainTileManager::_startTileDownloads query from database" << request.url() << "in flight" << _downloadingTiles.count();
+        QGeoTileSpec spec;
+        spec.setX(tile.x());
+        spec.setY(tile.y());
+        spec.setZoom(1);
+        spec.setMapId(urlFactory->getIdFromType("Airmap Elevation"));
+        QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(QGCNetworkManager::instance(), request, spec);
+        connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
+    }
+}
+
+void TerrainTileManager::_signalRequest(const QueuedRequestInfo_t& requestInfo, bool error, const QList<double>& altitudes)
 {
-    QList<double>    noAltitudes;
+    QList<double> noAltitudes;
 
-    for (const QueuedRequestInfo_t& requestInfo: _requestQueue) {
-        if (requestInfo.queryMode == QueryMode::QueryModeCoordinates) {
+    if (requestInfo.queryMode == QueryMode::QueryModeCoordinates) {
+        if (error) {
+            qCWarning(TerrainQueryLog) << "_signalRequest(coordinateQuery): signalling failure";
             requestInfo.terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
-        } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
+        } else {
+            qCDebug(TerrainQueryLog) << "_signalRequest(coordinateQuery): All altitudes taken from cached data";
+            requestInfo.terrainQueryInterface->_signalCoordinateHeights(requestInfo.coordinates.count() == altitudes.count(), altitudes);
+        }
+    } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
+        if (error) {
+            qCWarning(TerrainQueryLog) << "_signalRequest(pathQuery): signalling failure";
             requestInfo.terrainQueryInterface->_signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
+        } else {
+            qCDebug(TerrainQueryLog) << "_signalRequest(pathQuery): All altitudes taken from cached data";
+            requestInfo.terrainQueryInterface->_signalPathHeights(requestInfo.coordinates.count() == altitudes.count(), requestInfo.distanceBetween, requestInfo.finalDistanceBetween, altitudes);
+        }
+    }
+}
+
+/// Fails the queued requests which need the specified tile, other requests carry on
+void TerrainTileManager::_tileFailed(quint64 key)
+{
+    QList<double> noAltitudes;
+
+    for (int i = _requestQueue.count() - 1; i >= 0; i--) {
+        if (_requestQueue[i].missingTiles.contains(key)) {
+            QueuedRequestInfo_t requestInfo = _requestQueue.takeAt(i);
+            _signalRequest(requestInfo, true, noAltitudes);
         }
     }
-    _requestQueue.clear();
 }
 
 void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::NetworkError error)
 {
     QGeoTiledMapReplyQGC* reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
-    _state = State::Idle;
 
     if (!reply) {
         qCWarning(TerrainQueryLog) << "Elevation tile fetched but invalid reply data type.";
@@ -493,88 +726,71 @@ void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::N
 
     // remove from download queue
     QGeoTileSpec spec = reply->tileSpec();
-    QString hash = QGCMapEngine::getTileHash("Airmap Elevation", spec.x(), spec.y(), spec.zoom());
+    quint64 key = _tileKey(spec.x(), spec.y(), spec.zoom());
+    {
+        QMutexLocker tilesLock(&_tilesMutex);
+        if (_downloadingTiles.contains(key)) {
+            QGC_INSTRUMENT_SAMPLE(TerrainTileDownloadTime, static_cast<quint64>((_downloadClock.nsecsElapsed() - _downloadingTiles.take(key)) / 1000));
+        }
+        // Free download slot goes to the next missing tile
+        _startTileDownloads();
+    }
+    reply->deleteLater();
 
     // handle potential errors
     if (error != QNetworkReply::NoError) {
         qCWarning(TerrainQueryLog) << "Elevation tile fetching returned error (" << error << ")";
-        _tileFailed();
-        reply->deleteLater();
+        _tileFailed(key);
         return;
     }
     if (responseBytes.isEmpty()) {
         qCWarning(TerrainQueryLog) << "Error in fetching elevation tile. Empty response.";
-        _tileFailed();
-        reply->deleteLater();
+        _tileFailed(key);
         return;
     }
 
     qCDebug(TerrainQueryLog) << "Received some bytes of terrain data: " << responseBytes.size();
 
-    TerrainTile* terrainTile = new TerrainTile(responseBytes);
-    if (terrainTile->isValid()) {
-        _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            _tiles.insert(hash, *terrainTile);
+    {
+        QGC_INSTRUMENT_SCOPE(TerrainTileDecodeTime);
+        TerrainTile* terrainTile = new TerrainTile(responseBytes);
+        if (terrainTile->isValid()) {
+            QMutexLocker tilesLock(&_tilesMutex);
+            if (!_tiles.contains(key)) {
+                _insertTile(key, terrainTile, responseBytes.size());
+                _saveTileFile(key, responseBytes);
+            } else {
+                delete terrainTile;
+            }
         } else {
             delete terrainTile;
+            qCWarning(TerrainQueryLog) << "Received invalid tile";
+            _tileFailed(key);
+            return;
         }
-        _tilesMutex.unlock();
-    } else {
-        delete terrainTile;
-        qCWarning(TerrainQueryLog) << "Received invalid tile";
     }
-    reply->deleteLater();
 
-    // now try to query the data again
+    // Answer the requests which were only waiting on this tile, the others keep waiting for their own tiles
     for (int i = _requestQueue.count() - 1; i >= 0; i--) {
-        bool error;
-        QList<double> altitudes;
         QueuedRequestInfo_t& requestInfo = _requestQueue[i];
+        if (!requestInfo.missingTiles.remove(key) || !requestInfo.missingTiles.isEmpty()) {
+            continue;
+        }
 
-        if (getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
-            if (requestInfo.queryMode == QueryMode::QueryModeCoordinates) {
-                if (error) {
-                    QList<double> noAltitudes;
-                    qCWarning(TerrainQueryLog) << "_terrainDone(coordinateQuery): signalling failure due to internal error";
-                    requestInfo.terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
-                } else {
-                    qCDebug(TerrainQueryLog) << "_terrainDone(coordinateQuery): All altitudes taken from cached data";
-                    requestInfo.terrainQueryInterface->_signalCoordinateHeights(requestInfo.coordinates.count() == altitudes.count(), altitudes);
-                }
-            } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
-                if (error) {
-                    QList<double> noAltitudes;
-                    qCWarning(TerrainQueryLog) << "_terrainDone(coordinateQuery): signalling failure due to internal error";
-                    requestInfo.terrainQueryInterface->_signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
-                } else {
-                    qCDebug(TerrainQueryLog) << "_terrainDone(coordinateQuery): All altitudes taken from cached data";
-                    requestInfo.terrainQueryInterface->_signalPathHeights(requestInfo.coordinates.count() == altitudes.count(), requestInfo.distanceBetween, requestInfo.finalDistanceBetween, altitudes);
-                }
-            }
-            _requestQueue.removeAt(i);
+        bool            error;
+        QList<double>   altitudes;
+        if (_getAltitudes(requestInfo.coordinates, altitudes, error, requestInfo.missingTiles)) {
+            QueuedRequestInfo_t answeredInfo = _requestQueue.takeAt(i);
+            _signalRequest(answeredInfo, error, altitudes);
         }
     }
 }
 
-QString TerrainTileManager::_getTileHash(const QGeoCoordinate& coordinate)
-{
-    QString ret = QGCMapEngine::getTileHash(
-        "Airmap Elevation",
-        getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1),
-        getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1),
-        1);
-    qCDebug(TerrainQueryVerboseLog) << "Computing unique tile hash for " << coordinate << ret;
-
-    return ret;
-}
-
 TerrainAtCoordinateBatchManager::TerrainAtCoordinateBatchManager(void)
 {
     _batchTimer.setSingleShot(true);
     _batchTimer.setInterval(_batchTimeout);
     connect(&_batchTimer, &QTimer::timeout, this, &TerrainAtCoordinateBatchManager::_sendNextBatch);
-    connect(&_terrainQuery, &TerrainQueryInterface::coordinateHeightsReceived, this, &TerrainAtCoordinateBatchManager::_coordinateHeights);
 }
 
 void TerrainAtCoordinateBatchManager::addQuery(TerrainAtCoordinateQuery* terrainAtCoordinateQuery, const QList<QGeoCoordinate>& coordinates)
@@ -591,51 +807,63 @@ void TerrainAtCoordinateBatchManager::addQuery(TerrainAtCoordinateQuery* terrain
 
 void TerrainAtCoordinateBatchManager::_sendNextBatch(void)
 {
-    qCDebug(TerrainQueryLog) << "TerrainAtCoordinateBatchManager::_sendNextBatch _state:_requestQueue.count:_sentRequests.count" << _stateToString(_state) << _requestQueue.count() << _sentRequests.count();
-
-    if (_state != State::Idle) {
-        // Waiting for last download the complete, wait some more
-        qCDebug(TerrainQueryLog) << "TerrainAtCoordinateBatchManager::_sendNextBatch waiting for current batch, restarting timer";
-        _batchTimer.start();
-        return;
-    }
+    qCDebug(TerrainQueryLog) << "TerrainAtCoordinateBatchManager::_sendNextBatch _requestQueue.count:_sentBatches.count" << _requestQueue.count() << _sentBatches.count();
 
-    if (_requestQueue.count() == 0) {
+    // A batch answered straight from cached tiles signals back from inside requestCoordinateHeights. The loop below
+    // picks up whatever is left in the queue, so there is no need to recurse.
+    if (_sending) {
         return;
     }
-
-    _sentRequests.clear();
-
-    // Convert coordinates to point strings for json query
-    QList<QGeoCoordinate> coords;
-    int requestQueueAdded = 0;
-    for (const QueuedRequestInfo_t& requestInfo: _requestQueue) {
-        SentRequestInfo_t sentRequestInfo = { requestInfo.terrainAtCoordinateQuery, false, requestInfo.coordinates.count() };
-        _sentRequests.append(sentRequestInfo);
-        coords += requestInfo.coordinates;
-        requestQueueAdded++;
-        if (coords.count() > 50) {
-            break;
+    _sending = true;
+
+    while (_requestQueue.count() && _sentBatches.count() < _maxBatchesInFlight) {
+        TerrainOfflineAirMapQuery*  terrainQuery    = new TerrainOfflineAirMapQuery(this);
+        int                         maxCoordinates  = terrainQuery->maxCoordinatesPerRequest();
+
+        // Build the list of unique coordinates for the batch. Queries asking for the same coordinate share its height.
+        QList<QGeoCoordinate>               coords;
+        QHash<QPair<double, double>, int>   coordIndices;
+        QList<SentRequestInfo_t>            sentRequests;
+        int                                 requestQueueAdded = 0;
+        for (const QueuedRequestInfo_t& requestInfo: _requestQueue) {
+            // Queries are never split across batches, so a single query larger than the limit goes on its own
+            if (maxCoordinates && requestQueueAdded && coords.count() + requestInfo.coordinates.count() > maxCoordinates) {
+                break;
+            }
+            SentRequestInfo_t sentRequestInfo = { requestInfo.terrainAtCoordinateQuery, false, QList<int>() };
+            for (const QGeoCoordinate& coord: requestInfo.coordinates) {
+                QPair<double, double> coordKey(coord.latitude(), coord.longitude());
+                auto iter = coordIndices.constFind(coordKey);
+                if (iter == coordIndices.constEnd()) {
+                    iter = coordIndices.insert(coordKey, coords.count());
+                    coords.append(coord);
+                }
+                sentRequestInfo.heightIndices.append(iter.value());
+            }
+            sentRequests.append(sentRequestInfo);
+            requestQueueAdded++;
         }
+        _requestQueue = _requestQueue.mid(requestQueueAdded);
+        qCDebug(TerrainQueryLog) << "TerrainAtCoordinateBatchManager::_sendNextBatch requesting next batch queries:coordinates:_requestQueue.count:_sentBatches.count" << sentRequests.count() << coords.count() << _requestQueue.count() << _sentBatches.count();
+
+        _sentBatches.insert(terrainQuery, sentRequests);
+        connect(terrainQuery, &TerrainQueryInterface::coordinateHeightsReceived, this, &TerrainAtCoordinateBatchManager::_coordinateHeights);
+        terrainQuery->requestCoordinateHeights(coords);
     }
-    _requestQueue = _requestQueue.mid(requestQueueAdded);
-    qCDebug(TerrainQueryLog) << "TerrainAtCoordinateBatchManager::_sendNextBatch requesting next batch _state:_requestQueue.count:_sentRequests.count" << _stateToString(_state) << _requestQueue.count() << _sentRequests.count();
 
-    _state = State::Downloading;
-    _terrainQuery.requestCoordinateHeights(coords);
+    _sending = false;
 }
 
-void TerrainAtCoordinateBatchManager::_batchFailed(void)
+void TerrainAtCoordinateBatchManager::_batchFailed(const QList<SentRequestInfo_t>& sentRequests)
 {
     QList<double> noHeights;
 
-    for (const SentRequestInfo_t& sentRequestInfo: _sentRequests) {
+    for (const SentRequestInfo_t& sentRequestInfo: sentRequests) {
         if (!sentRequestInfo.queryObjectDestroyed) {
             disconnect(sentRequestInfo.terrainAtCoordinateQuery, &TerrainAtCoordinateQuery::destroyed, this, &TerrainAtCoordinateBatchManager::_queryObjectDestroyed);
             sentRequestInfo.terrainAtCoordinateQuery->_signalTerrainData(false, noHeights);
         }
     }
-    _sentRequests.clear();
 }
 
 void TerrainAtCoordinateBatchManager::_queryObjectDestroyed(QObject* terrainAtCoordinateQuery)
@@ -655,52 +883,50 @@ void TerrainAtCoordinateBatchManager::_queryObjectDestroyed(QObject* terrainAtCo
         }
     }
 
-    for (int i=0; i<_sentRequests.count(); i++) {
-        SentRequestInfo_t& sentRequestInfo = _sentRequests[i];
-        if (sentRequestInfo.terrainAtCoordinateQuery == terrainAtCoordinateQuery) {
-            qCDebug(TerrainQueryLog) << "Zombieing deleted provider from _sentRequests index:terrainAtCoordinateQuery" << sentRequestInfo.terrainAtCoordinateQuery;
-            sentRequestInfo.queryObjectDestroyed = true;
+    for (QList<SentRequestInfo_t>& sentRequests: _sentBatches) {
+        for (SentRequestInfo_t& sentRequestInfo: sentRequests) {
+            if (sentRequestInfo.terrainAtCoordinateQuery == terrainAtCoordinateQuery) {
+                qCDebug(TerrainQueryLog) << "Zombieing deleted provider from _sentBatches terrainAtCoordinateQuery" << sentRequestInfo.terrainAtCoordinateQuery;
+                sentRequestInfo.queryObjectDestroyed = true;
+            }
         }
     }
 }
 
-QString TerrainAtCoordinateBatchManager::_stateToString(State state)
-{
-    switch (state) {
-    case State::Idle:
-        return QStringLiteral("Idle");
-    case State::Downloading:
-        return QStringLiteral("Downloading");
-    }
-
-    return QStringLiteral("State unknown");
-}
-
 void TerrainAtCoordinateBatchManager::_coordinateHeights(bool success, QList<double> heights)
 {
-    _state = State::Idle;
+    TerrainQueryInterface* terrainQuery = qobject_cast<TerrainQueryInterface*>(QObject::sender());
+    if (!terrainQuery || !_sentBatches.contains(terrainQuery)) {
+        qCWarning(TerrainQueryLog) << "TerrainAtCoordinateBatchManager::_coordinateHeights signalled from unknown query";
+        return;
+    }
+    QList<SentRequestInfo_t> sentRequests = _sentBatches.take(terrainQuery);
+    terrainQuery->deleteLater();
 
     qCDebug(TerrainQueryLog) << "TerrainAtCoordinateBatchManager::_coordinateHeights signalled success:count" << success << heights.count();
 
     if (!success) {
-        _batchFailed();
-        return;
-    }
-
-    int currentIndex = 0;
-    for (const SentRequestInfo_t& sentRequestInfo: _sentRequests) {
-        if (!sentRequestInfo.queryObjectDestroyed) {
-            qCDebug(TerrainQueryVerboseLog) << "TerrainAtCoordinateBatchManager::_coordinateHeights returned TerrainCoordinateQuery:count" <<  sentRequestInfo.terrainAtCoordinateQuery << sentRequestInfo.cCoord;
-            disconnect(sentRequestInfo.terrainAtCoordinateQuery, &TerrainAtCoordinateQuery::destroyed, this, &TerrainAtCoordinateBatchManager::_queryObjectDestroyed);
-            QList<double> requestAltitudes = heights.mid(currentIndex, sentRequestInfo.cCoord);
-            sentRequestInfo.terrainAtCoordinateQuery->_signalTerrainData(true, requestAltitudes);
-            currentIndex += sentRequestInfo.cCoord;
+        _batchFailed(sentRequests);
+    } else {
+        for (const SentRequestInfo_t& sentRequestInfo: sentRequests) {
+            if (!sentRequestInfo.queryObjectDestroyed) {
+                qCVerbose(TerrainQueryVerboseLog) << "TerrainAtCoordinateBatchManager::_coordinateHeights returned TerrainCoordinateQuery:count" <<  sentRequestInfo.terrainAtCoordinateQuery << sentRequestInfo.heightIndices.count();
+                disconnect(sentRequestInfo.terrainAtCoordinateQuery, &TerrainAtCoordinateQuery::destroyed, this, &TerrainAtCoordinateBatchManager::_queryObjectDestroyed);
+                QList<double> requestAltitudes;
+                requestAltitudes.reserve(sentRequestInfo.heightIndices.count());
+                for (int heightIndex: sentRequestInfo.heightIndices) {
+                    if (heightIndex < heights.count()) {
+                        requestAltitudes.append(heights[heightIndex]);
+                    }
+                }
+                sentRequestInfo.terrainAtCoordinateQuery->_signalTerrainData(requestAltitudes.count() == sentRequestInfo.heightIndices.count(), requestAltitudes);
+            }
         }
     }
-    _sentRequests.clear();
 
-    if (_requestQueue.count()) {
-        _batchTimer.start();
+    // A batch slot is free, keep the pipeline full
+    if (_requestQueue.count() && !_batchTimer.isActive()) {
+        _sendNextBatch();
     }
 }
 
@@ -757,9 +983,9 @@ void TerrainPathQuery::_pathHeights(bool success, double distanceBetween, double
 
 TerrainPolyPathQuery::TerrainPolyPathQuery(bool autoDelete)
     : _autoDelete   (autoDelete)
-    , _pathQuery    (false /* autoDelete */)
 {
-    connect(&_pathQuery, &TerrainPathQuery::terrainDataReceived, this, &TerrainPolyPathQuery::_terrainDataReceived);
+    qRegisterMetaType<PackedPathHeights_t>();
+    connect(&_terrainQuery, &TerrainQueryInterface::coordinateHeightsReceived, this, &TerrainPolyPathQuery::_coordinateHeights);
 }
 
 void TerrainPolyPathQuery::requestData(const QVariantList& polyPath)
@@ -777,33 +1003,62 @@ void TerrainPolyPathQuery::requestData(const QList<QGeoCoordinate>& polyPath)
 {
     qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::requestData count" << polyPath.count();
 
-    // Kick off first request
-    _rgCoords = polyPath;
-    _curIndex = 0;
-    _pathQuery.requestData(_rgCoords[0], _rgCoords[1]);
+    if (polyPath.count() < 2) {
+        qCWarning(TerrainQueryLog) << "TerrainPolyPathQuery::requestData path needs at least two coordinates";
+        _signalFailure();
+        return;
+    }
+
+    // All segments are sampled up front and sent as a single coordinate query
+    _packedPathHeights.heights.clear();
+    QList<QGeoCoordinate> coords = TerrainTileManager::polyPathQueryToCoords(polyPath, _packedPathHeights.segmentOffsets, _packedPathHeights.distanceBetween, _packedPathHeights.finalDistanceBetween);
+    _cCoord = coords.count();
+    _terrainQuery.requestCoordinateHeights(coords);
 }
 
-void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
+void TerrainPolyPathQuery::_signalFailure(void)
 {
-    qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_terrainDataReceived success:_curIndex" << success << _curIndex;
+    QList<TerrainPathQuery::PathHeightInfo_t> noPathHeightInfo;
+    PackedPathHeights_t                       noPackedPathHeights;
 
-    if (!success) {
-        _rgPathHeightInfo.clear();
-        emit terrainDataReceived(false /* success */, _rgPathHeightInfo);
+    emit terrainDataReceived(false /* success */, noPathHeightInfo);
+    emit packedTerrainDataReceived(false /* success */, noPackedPathHeights);
+}
+
+void TerrainPolyPathQuery::_coordinateHeights(bool success, QList<double> heights)
+{
+    qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_coordinateHeights success:count" << success << heights.count();
+
+    if (!success || heights.count() != _cCoord) {
+        _signalFailure();
         return;
     }
 
-    _rgPathHeightInfo.append(pathHeightInfo);
+    std::vector<float>& packedHeights = _packedPathHeights.heights;
+    packedHeights.resize(static_cast<size_t>(heights.count()));
+    for (int i = 0; i < heights.count(); i++) {
+        packedHeights[static_cast<size_t>(i)] = static_cast<float>(heights[i]);
+    }
 
-    if (++_curIndex >= _rgCoords.count() - 1) {
-        // We've finished all requests
-        qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_terrainDataReceived complete";
-        emit terrainDataReceived(true /* success */, _rgPathHeightInfo);
-        if (_autoDelete) {
-            deleteLater();
-        }
-    } else {
-        _pathQuery.requestData(_rgCoords[_curIndex], _rgCoords[_curIndex+1]);
+    QList<TerrainPathQuery::PathHeightInfo_t> rgPathHeightInfo;
+    size_t cSegments = _packedPathHeights.distanceBetween.size();
+    rgPathHeightInfo.reserve(static_cast<int>(cSegments));
+    for (size_t segment = 0; segment < cSegments; segment++) {
+        int segmentStart = _packedPathHeights.segmentOffsets[segment];
+        int segmentCount = _packedPathHeights.segmentOffsets[segment + 1] - segmentStart;
+
+        TerrainPathQuery::PathHeightInfo_t pathHeightInfo;
+        pathHeightInfo.distanceBetween      = _packedPathHeights.distanceBetween[segment];
+        pathHeightInfo.finalDistanceBetween = _packedPathHeights.finalDistanceBetween[segment];
+        pathHeightInfo.heights              = heights.mid(segmentStart, segmentCount);
+        rgPathHeightInfo.append(pathHeightInfo);
+    }
+
+    qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_coordinateHeights complete segments" << cSegments;
+    emit terrainDataReceived(true /* success */, rgPathHeightInfo);
+    emit packedTerrainDataReceived(true /* success */, _packedPathHeights);
+    if (_autoDelete) {
+        deleteLater();
     }
 }
 
@@ -14,13 +14,19 @@
 #include "QGCLoggingCategory.h"
 
 #include <QObject>
+#include <QElapsedTimer>
 #include <QGeoCoordinate>
 #include <QGeoRectangle>
-#include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QCache>
+#include <QMutex>
+#include <QPoint>
+#include <QSet>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 
+#include <vector>
+
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryLog)
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryVerboseLog)
 
@@ -50,6 +56,9 @@ public:
     ///     @param statsOnly true: Return only stats, no carpet data
     virtual void requestCarpetHeights(const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly) = 0;
 
+    /// @return Maximum number of coordinates the backend accepts in a single requestCoordinateHeights call, 0 for no limit
+    virtual int maxCoordinatesPerRequest(void) const { return 0; }
+
 signals:
     void coordinateHeightsReceived(bool success, QList<double> heights);
     void pathHeightsReceived(bool success, double distanceBetween, double finalDistanceBetween, const QList<double>& heights);
@@ -68,6 +77,9 @@ public:
     void requestPathHeights         (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord) final;
     void requestCarpetHeights       (const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly) final;
 
+    /// Points are sent as part of the url
+    int maxCoordinatesPerRequest    (void) const final { return 50; }
+
 private slots:
     void _requestError              (QNetworkReply::NetworkError code);
     void _requestFinished           (void);
@@ -86,7 +98,6 @@ private:
         QueryModeCarpet
     };
 
-    QNetworkAccessManager   _networkManager;
     QueryMode               _queryMode;
     bool                    _carpetStatsOnly;
 };
@@ -122,15 +133,14 @@ public:
 
     static QList<QGeoCoordinate> pathQueryToCoords(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween);
 
+    /// Same spacing as pathQueryToCoords for each segment of the poly path, with the coordinates of all segments back to back
+    ///     @param[out] segmentOffsets Index of the first coordinate of each segment followed by the total count
+    static QList<QGeoCoordinate> polyPathQueryToCoords(const QList<QGeoCoordinate>& polyPath, std::vector<int>& segmentOffsets, std::vector<double>& distanceBetween, std::vector<double>& finalDistanceBetween);
+
 private slots:
     void _terrainDone(QByteArray responseBytes, QNetworkReply::NetworkError error);
 
 private:
-    enum class State {
-        Idle,
-        Downloading,
-    };
-
     enum QueryMode {
         QueryModeCoordinates,
         QueryModePath,
@@ -143,17 +153,36 @@ private:
         double                      distanceBetween;        // Distance between each returned height
         double                      finalDistanceBetween;   // Distance between for final height
         QList<QGeoCoordinate>       coordinates;
+        QSet<quint64>               missingTiles;           // Tiles the request is still waiting on
     } QueuedRequestInfo_t;
 
-    void    _tileFailed                         (void);
-    QString _getTileHash                        (const QGeoCoordinate& coordinate);
+    bool    _getAltitudes                       (const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error, QSet<quint64>& missingTiles);
+    void    _queueTileDownload                  (int x, int y);
+    void    _startTileDownloads                 (void);
+    void    _signalRequest                      (const QueuedRequestInfo_t& requestInfo, bool error, const QList<double>& altitudes);
+    void    _tileFailed                         (quint64 key);
+    void    _insertTile                         (quint64 key, TerrainTile* tile, int cost);
+    QString _tileFilePath                       (quint64 key);
+    const TerrainTile* _loadTileFile            (quint64 key);
+    void    _saveTileFile                       (quint64 key, const QByteArray& bytes);
+
+    /// Tiles are keyed by zoom, x and y packed into a single integer
+    static quint64 _tileKey(int x, int y, int zoom) { return (static_cast<quint64>(zoom) << 48) | (static_cast<quint64>(static_cast<quint32>(x)) << 24) | static_cast<quint32>(y); }
 
     QList<QueuedRequestInfo_t>  _requestQueue;
-    State                       _state = State::Idle;
-    QNetworkAccessManager       _networkManager;
+    QList<QPoint>               _tilesToDownload;   ///< Missing tiles waiting for a free download slot
+    QSet<quint64>               _queuedTiles;       ///< Keys of _tilesToDownload
+    QHash<quint64, qint64>      _downloadingTiles;  ///< Tiles being downloaded along with _downloadClock at the start of the download
+    QElapsedTimer               _downloadClock;
+
+    static const int _maxConcurrentDownloads = 6;
+
+    QMutex                          _tilesMutex;    ///< Held once per batch of coordinates, not per coordinate
+    QCache<quint64, TerrainTile>    _tiles;         ///< Least recently used tiles are evicted, cost is the tile size in bytes
 
-    QMutex                      _tilesMutex;
-    QHash<QString, TerrainTile> _tiles;
+    static const int _maxTileCacheBytes = 32 * 1024 * 1024;
+
+    static const char* _tileDirName;    ///< Decoded tiles are kept in this directory of the map cache, one file per tile
 };
 
 /// Used internally by TerrainAtCoordinateQuery to batch coordinate requests together
@@ -179,24 +208,18 @@ private:
     typedef struct {
         TerrainAtCoordinateQuery*   terrainAtCoordinateQuery;
         bool                        queryObjectDestroyed;
-        int                         cCoord;
+        QList<int>                  heightIndices;          ///< Index into the batch heights for each requested coordinate
     } SentRequestInfo_t;
 
+    void _batchFailed(const QList<SentRequestInfo_t>& sentRequests);
 
-    enum class State {
-        Idle,
-        Downloading,
-    };
+    QList<QueuedRequestInfo_t>                              _requestQueue;
+    QHash<TerrainQueryInterface*, QList<SentRequestInfo_t>> _sentBatches;     ///< Batches in flight keyed by the query sending them
+    bool                                                    _sending = false;
+    const int                                               _batchTimeout = 500;
+    QTimer                                                  _batchTimer;
 
-    void _batchFailed(void);
-    QString _stateToString(State state);
-
-    QList<QueuedRequestInfo_t>  _requestQueue;
-    QList<SentRequestInfo_t>    _sentRequests;
-    State                       _state = State::Idle;
-    const int                   _batchTimeout = 500;
-    QTimer                      _batchTimer;
-    TerrainOfflineAirMapQuery   _terrainQuery;
+    static const int _maxBatchesInFlight = 4;
 };
 
 // IMPORTANT NOTE: The terrain query objects below must continue to live until the the terrain system signals data back through them.
@@ -283,21 +306,35 @@ public:
     void requestData(const QVariantList& polyPath);
     void requestData(const QList<QGeoCoordinate>& polyPath);
 
+    /// Heights for every segment of the path packed into a single array
+    typedef struct {
+        std::vector<float>  heights;                ///< Heights of all segments back to back, each segment includes both of its ends
+        std::vector<int>    segmentOffsets;         ///< Index into heights of the first height of each segment followed by heights.size()
+        std::vector<double> distanceBetween;        ///< Distance between each height value, per segment
+        std::vector<double> finalDistanceBetween;   ///< Distance between final two height values, per segment
+    } PackedPathHeights_t;
+
 signals:
     /// Signalled when terrain data comes back from server
     void terrainDataReceived(bool success, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo);
 
+    /// Signalled along with terrainDataReceived with the same heights in packed form
+    void packedTerrainDataReceived(bool success, const TerrainPolyPathQuery::PackedPathHeights_t& packedPathHeights);
+
 private slots:
-    void _terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo);
+    void _coordinateHeights(bool success, QList<double> heights);
 
 private:
-    bool                                        _autoDelete;
-    int                                         _curIndex = 0;
-    QList<QGeoCoordinate>                       _rgCoords;
-    QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;
-    TerrainPathQuery                            _pathQuery;
+    void _signalFailure(void);
+
+    bool                        _autoDelete;
+    PackedPathHeights_t         _packedPathHeights;
+    int                         _cCoord = 0;
+    TerrainOfflineAirMapQuery   _terrainQuery;
 };
 
+Q_DECLARE_METATYPE(TerrainPolyPathQuery::PackedPathHeights_t)
+
 /// @brief Provides unit test terrain query responses.
 /// @details It provides preset, emulated, 1 arc-second (SRTM1) resolution regions that are either
 /// flat or sloped in a fashion that aids testing terrain-sensitive functionality. All emulated
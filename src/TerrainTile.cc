@@ -35,7 +35,6 @@ TerrainTile::TerrainTile()
     : _minElevation(-1.0)
     , _maxElevation(-1.0)
     , _avgElevation(-1.0)
-    , _data(nullptr)
     , _gridSizeLat(-1)
     , _gridSizeLon(-1)
     , _isValid(false)
@@ -43,22 +42,10 @@ TerrainTile::TerrainTile()
 
 }
 
-TerrainTile::~TerrainTile()
-{
-    if (_data) {
-        for (int i = 0; i < _gridSizeLat; i++) {
-            delete[] _data[i];
-        }
-        delete[] _data;
-        _data = nullptr;
-    }
-}
-
 TerrainTile::TerrainTile(QByteArray byteArray)
     : _minElevation(-1.0)
     , _maxElevation(-1.0)
     , _avgElevation(-1.0)
-    , _data(nullptr)
     , _gridSizeLat(-1)
     , _gridSizeLon(-1)
     , _isValid(false)
@@ -85,26 +72,20 @@ TerrainTile::TerrainTile(QByteArray byteArray)
     qCDebug(TerrainTileLog) << "Loading terrain tile: " << _southWest << " - " << _northEast;
     qCDebug(TerrainTileLog) << "min:max:avg:sizeLat:sizeLon" << _minElevation << _maxElevation << _avgElevation << _gridSizeLat << _gridSizeLon;
 
+    // Interpolation needs at least two values in each direction
+    if (_gridSizeLat < 2 || _gridSizeLon < 2) {
+        qWarning() << "Terrain tile grid too small" << _gridSizeLat << _gridSizeLon;
+        return;
+    }
+
     int cTileDataBytes = static_cast<int>(sizeof(int16_t)) * _gridSizeLat * _gridSizeLon;
     if (cTileBytesAvailable < cTileHeaderBytes + cTileDataBytes) {
         qWarning() << "Terrain tile binary data too small for tile data";
         return;
     }
 
-    _data = new int16_t*[_gridSizeLat];
-    for (int k = 0; k < _gridSizeLat; k++) {
-        _data[k] = new int16_t[_gridSizeLon];
-    }
-
-    int valueIndex = 0;
-    const int16_t* pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _gridSizeLat; i++) {
-        for (int j = 0; j < _gridSizeLon; j++) {
-            _data[i][j] = pTileData[valueIndex++];
-        }
-    }
-
-    _isValid = true;
+    _byteArray  = byteArray;
+    _isValid    = true;
 
     return;
 }
@@ -112,38 +93,60 @@ TerrainTile::TerrainTile(QByteArray byteArray)
 double TerrainTile::elevation(const QGeoCoordinate& coordinate) const
 {
     if (_isValid && _southWest.isValid() && _northEast.isValid()) {
-        qCDebug(TerrainTileLog) << "elevation: " << coordinate << " , in sw " << _southWest << " , ne " << _northEast;
+        qCVerbose(TerrainTileLog) << "elevation: " << coordinate << " , in sw " << _southWest << " , ne " << _northEast;
+
+        double latitude     = coordinate.latitude();
+        double longitude    = coordinate.longitude();
+        double value;
+        elevations(1, &latitude, &longitude, &value);
+        return value;
+    } else {
+        qCWarning(TerrainTileLog) << "elevation: Internal error - invalid tile";
+        return qQNaN();
+    }
+}
+
+void TerrainTile::elevations(int count, const double* latitudes, const double* longitudes, double* elevations) const
+{
+    if (!_isValid || !_southWest.isValid() || !_northEast.isValid()) {
+        qCWarning(TerrainTileLog) << "elevations: Internal error - invalid tile";
+        for (int i = 0; i < count; i++) {
+            elevations[i] = qQNaN();
+        }
+        return;
+    }
+
+    const int16_t*  data        = _elevationData();
+    const double    swLat       = _southWest.latitude();
+    const double    swLon       = _southWest.longitude();
+    const double    maxLatPos   = _gridSizeLat - 1;
+    const double    maxLonPos   = _gridSizeLon - 1;
+    const int       maxLatIndex = _gridSizeLat - 2;
+    const int       maxLonIndex = _gridSizeLon - 2;
+    const int       rowStride   = _gridSizeLon;
 
+    for (int i = 0; i < count; i++) {
         // The lat/lon values in _northEast and _southWest coordinates can have rounding errors such that the coordinate
         // request may be slightly outside the tile box specified by these values. So we clamp the incoming values to the
         // edges of the tile if needed.
+        double latPos = qBound(0.0, (latitudes[i] - swLat) / tileValueSpacingDegrees, maxLatPos);
+        double lonPos = qBound(0.0, (longitudes[i] - swLon) / tileValueSpacingDegrees, maxLonPos);
 
-        double clampedLon = qMax(coordinate.longitude(), _southWest.longitude());
-        double clampedLat = qMax(coordinate.latitude(), _southWest.latitude());
-
-        // Calc the index of the southernmost and westernmost index data value
-        int lonIndex = qFloor((clampedLon - _southWest.longitude()) / tileValueSpacingDegrees);
-        int latIndex = qFloor((clampedLat - _southWest.latitude()) / tileValueSpacingDegrees);
-
-        // Calc how far along in between the known values the requested lat/lon is fractionally
-        double lonIndexLongitude    = _southWest.longitude() + (static_cast<double>(lonIndex) * tileValueSpacingDegrees);
-        double lonFraction          = (clampedLon - lonIndexLongitude) / tileValueSpacingDegrees;
-        double latIndexLatitude     = _southWest.latitude() + (static_cast<double>(latIndex) * tileValueSpacingDegrees);
-        double latFraction          = (clampedLat - latIndexLatitude) / tileValueSpacingDegrees;
-
-        // Calc the elevation as the average across the four known points
-        double known00      = _data[latIndex][lonIndex];
-        double known01      = _data[latIndex][lonIndex+1];
-        double known10      = _data[latIndex+1][lonIndex];
-        double known11      = _data[latIndex+1][lonIndex+1];
-        double lonValue1    = known00 + ((known01 - known00) * lonFraction);
-        double lonValue2    = known10 + ((known11 - known10) * lonFraction);
-        double latValue     = lonValue1 + ((lonValue2 - lonValue1) * latFraction);
-
-        return latValue;
-    } else {
-        qCWarning(TerrainTileLog) << "elevation: Internal error - invalid tile";
-        return qQNaN();
+        // Index of the southernmost and westernmost known value. Positions are never negative so truncation is floor.
+        // On the north and east edges the last cell is used with a fraction of 1.
+        int latIndex = qMin(static_cast<int>(latPos), maxLatIndex);
+        int lonIndex = qMin(static_cast<int>(lonPos), maxLonIndex);
+
+        // How far along in between the known values the requested lat/lon is fractionally
+        double latFraction = latPos - latIndex;
+        double lonFraction = lonPos - lonIndex;
+
+        const int16_t* south = data + (latIndex * rowStride) + lonIndex;
+        const int16_t* north = south + rowStride;
+
+        double southValue   = south[0] + ((south[1] - south[0]) * lonFraction);
+        double northValue   = north[0] + ((north[1] - north[0]) * lonFraction);
+        elevations[i]       = southValue + ((northValue - southValue) * latFraction);
     }
 }
 
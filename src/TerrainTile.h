@@ -4,6 +4,7 @@
 #include "QGCLoggingCategory.h"
 
 #include <QGeoCoordinate>
+#include <QByteArray>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileLog)
 
@@ -17,12 +18,12 @@ class TerrainTile
 {
 public:
     TerrainTile();
-    ~TerrainTile();
 
     /**
-    * Constructor from serialized elevation data (either from file or web)
+    * Constructor from serialized elevation data (either from file or web). The elevation values are read in place
+    * from the byte array, which is implicitly shared, so neither construction nor copying the tile copies the data.
     *
-    * @param document
+    * @param byteArray
     */
     TerrainTile(QByteArray byteArray);
 
@@ -41,6 +42,18 @@ public:
     */
     double elevation(const QGeoCoordinate& coordinate) const;
 
+    /**
+    * Evaluates the elevation at a batch of coordinates using bilinear interpolation. Coordinates are passed as
+    * separate latitude and longitude arrays, and each is clamped to the tile bounds. The inner loop has no calls or
+    * data dependent branches so the compiler can vectorize it.
+    *
+    * @param count number of coordinates
+    * @param latitudes
+    * @param longitudes
+    * @param elevations receives count values, NaN if the tile is not valid
+    */
+    void elevations(int count, const double* latitudes, const double* longitudes, double* elevations) const;
+
     /**
     * Accessor for the minimum elevation of the tile
     *
@@ -85,6 +98,8 @@ private:
         int16_t gridSizeLon;
     } TileInfo_t;
 
+    const int16_t* _elevationData(void) const { return reinterpret_cast<const int16_t*>(_byteArray.constData() + sizeof(TileInfo_t)); }
+
     QGeoCoordinate      _southWest;                                     /// South west corner of the tile
     QGeoCoordinate      _northEast;                                     /// North east corner of the tile
 
@@ -92,7 +107,7 @@ private:
     int16_t             _maxElevation;                                  /// Maximum elevation in tile
     double              _avgElevation;                                  /// Average elevation of the tile
 
-    int16_t**           _data;                                          /// 2D elevation data array
+    QByteArray          _byteArray;                                     /// Serialized tile, elevation data is stored row major by latitude after the header
     int16_t             _gridSizeLat;                                   /// data grid size in latitude direction
     int16_t             _gridSizeLon;                                   /// data grid size in longitude direction
     bool                _isValid;                                       /// data loaded is valid
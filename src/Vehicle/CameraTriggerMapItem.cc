@@ -0,0 +1,189 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CameraTriggerMapItem.h"
+#include "CameraTriggerPoints.h"
+#include "QGCApplication.h"
+#include "QGCGeo.h"
+
+#include <QSet>
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+
+CameraTriggerMapItem::CameraTriggerMapItem(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    connect(this, &CameraTriggerMapItem::centerChanged,     this, &CameraTriggerMapItem::_layoutSignal);
+    connect(this, &CameraTriggerMapItem::zoomLevelChanged,  this, &CameraTriggerMapItem::_layoutSignal);
+    connect(this, &CameraTriggerMapItem::bearingChanged,    this, &CameraTriggerMapItem::_layoutSignal);
+    connect(this, &CameraTriggerMapItem::radiusChanged,     this, &CameraTriggerMapItem::_layoutSignal);
+    connect(this, &QQuickItem::widthChanged,                this, &CameraTriggerMapItem::_layoutSignal);
+    connect(this, &QQuickItem::heightChanged,               this, &CameraTriggerMapItem::_layoutSignal);
+    connect(this, &CameraTriggerMapItem::colorsChanged,     this, &QQuickItem::update);
+
+    // Panning the map and a burst of triggers both collapse into a single layout
+    connect(this, &CameraTriggerMapItem::_layoutSignal, this, &CameraTriggerMapItem::_layout, Qt::QueuedConnection);
+    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&CameraTriggerMapItem::_layoutSignal));
+}
+
+void CameraTriggerMapItem::setCameraTriggerPoints(CameraTriggerPoints* cameraTriggerPoints)
+{
+    if (cameraTriggerPoints == _cameraTriggerPoints) {
+        return;
+    }
+
+    if (_cameraTriggerPoints) {
+        disconnect(_cameraTriggerPoints, nullptr, this, nullptr);
+    }
+    _cameraTriggerPoints = cameraTriggerPoints;
+    if (_cameraTriggerPoints) {
+        connect(_cameraTriggerPoints, &CameraTriggerPoints::triggerAdded,       this, &CameraTriggerMapItem::_layoutSignal);
+        connect(_cameraTriggerPoints, &CameraTriggerPoints::triggersCleared,    this, &CameraTriggerMapItem::_layoutSignal);
+        connect(_cameraTriggerPoints, &QObject::destroyed,                      this, &CameraTriggerMapItem::_layoutSignal);
+    }
+
+    emit _layoutSignal();
+    emit cameraTriggerPointsChanged();
+}
+
+void CameraTriggerMapItem::_layout(void)
+{
+    const int previousCount = _visiblePositions.count();
+
+    _visiblePositions.clear();
+
+    if (_cameraTriggerPoints && _cameraTriggerPoints->count() && _center.isValid() && width() > 0 && height() > 0) {
+        // Map zoom levels are relative to 256 pixel tiles
+        const double    worldSize       = 256.0 * qPow(2.0, _zoomLevel);
+        const QPointF   viewportCenter  (width() / 2.0, height() / 2.0);
+        const double    bearingRadians  = qDegreesToRadians(-_bearing);
+        const double    cosBearing      = qCos(bearingRadians);
+        const double    sinBearing      = qSin(bearingRadians);
+        QPointF         centerPixel;
+
+        convertGeoToWebMercator(_center.latitude(), _center.longitude(), worldSize, centerPixel.rx(), centerPixel.ry());
+
+        // The box the viewport covers at any bearing, plus a marker on each side
+        const double reach = (qSqrt((width() * width()) + (height() * height())) / 2.0) + _radius;
+        double north;
+        double south;
+        double west;
+        double east;
+        double unused;
+        convertWebMercatorToGeo(0, qMax(centerPixel.y() - reach, 0.0), worldSize, north, unused);
+        convertWebMercatorToGeo(0, qMin(centerPixel.y() + reach, worldSize), worldSize, south, unused);
+        if (reach * 2.0 >= worldSize) {
+            west = -180.0;
+            east = 180.0;
+        } else {
+            convertWebMercatorToGeo(centerPixel.x() - reach, 0, worldSize, unused, west);
+            convertWebMercatorToGeo(centerPixel.x() + reach, 0, worldSize, unused, east);
+            west = west < -180.0 ? west + 360.0 : west;
+            east = east > 180.0 ? east - 360.0 : east;
+        }
+
+        auto toViewport = [&](double latitude, double longitude) {
+            QPointF delta;
+            convertGeoToWebMercator(latitude, longitude, worldSize, delta.rx(), delta.ry());
+            delta -= centerPixel;
+            // Go the short way around the world so triggers across the antimeridian end up in the right place
+            if (delta.x() > worldSize / 2.0) {
+                delta.rx() -= worldSize;
+            } else if (delta.x() < -worldSize / 2.0) {
+                delta.rx() += worldSize;
+            }
+            return QPointF(viewportCenter.x() + (delta.x() * cosBearing) - (delta.y() * sinBearing),
+                           viewportCenter.y() + (delta.x() * sinBearing) + (delta.y() * cosBearing));
+        };
+
+        // One marker per radius sized cell of the viewport, the earliest trigger in it wins
+        QSet<quint64>                                       occupiedCells;
+        const std::vector<CameraTriggerPoints::Trigger_t>&  triggers    = _cameraTriggerPoints->triggers();
+        const double                                        cellSize    = qMax(_radius, 1.0);
+
+        for (int index: _cameraTriggerPoints->query(south, west, north, east)) {
+            const CameraTriggerPoints::Trigger_t&   trigger     = triggers[static_cast<size_t>(index)];
+            const QPointF                           position    = toViewport(trigger.latitude, trigger.longitude);
+
+            if (position.x() < -_radius || position.y() < -_radius || position.x() > width() + _radius || position.y() > height() + _radius) {
+                continue;
+            }
+            const quint64 cell = (static_cast<quint64>(static_cast<quint32>(qFloor(position.x() / cellSize))) << 32) | static_cast<quint32>(qFloor(position.y() / cellSize));
+            if (occupiedCells.contains(cell)) {
+                continue;
+            }
+            occupiedCells.insert(cell);
+            _visiblePositions.append(position);
+        }
+    }
+
+    if (_visiblePositions.count() != previousCount) {
+        emit visibleCountChanged();
+    }
+    update();
+}
+
+/// Vertex colors are premultiplied by alpha
+static void _setVertex(QSGGeometry::ColoredPoint2D& vertex, const QPointF& position, const QColor& color)
+{
+    const int alpha = color.alpha();
+    vertex.set(static_cast<float>(position.x()), static_cast<float>(position.y()),
+               static_cast<uchar>(color.red() * alpha / 255), static_cast<uchar>(color.green() * alpha / 255), static_cast<uchar>(color.blue() * alpha / 255),
+               static_cast<uchar>(alpha));
+}
+
+QSGNode* CameraTriggerMapItem::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+
+        node = new QSGGeometryNode;
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setFlag(QSGNode::OwnsMaterial);
+        node->setGeometry(geometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+    }
+
+    // Each marker is a disc with a smaller one in the middle, both fans of triangles around the center. The unit circle
+    // is only worked out once for all of them.
+    QPointF unitCircle[_cCircleSegments + 1];
+    for (int i = 0; i <= _cCircleSegments; i++) {
+        const double angle = (2.0 * M_PI * i) / _cCircleSegments;
+        unitCircle[i] = QPointF(qCos(angle), qSin(angle));
+    }
+
+    const int       cMarkerVertices = _cCircleSegments * 3 * 2;
+    const double    centerRadius    = _radius / 3.0;
+    QSGGeometry*    geometry        = node->geometry();
+
+    geometry->allocate(_visiblePositions.count() * cMarkerVertices);
+    QSGGeometry::ColoredPoint2D*    vertices    = geometry->vertexDataAsColoredPoint2D();
+    int                             vertexIndex = 0;
+    for (const QPointF& position: _visiblePositions) {
+        for (int i = 0; i < _cCircleSegments; i++) {
+            _setVertex(vertices[vertexIndex++], position, _color);
+            _setVertex(vertices[vertexIndex++], position + (unitCircle[i] * _radius), _color);
+            _setVertex(vertices[vertexIndex++], position + (unitCircle[i + 1] * _radius), _color);
+        }
+        for (int i = 0; i < _cCircleSegments; i++) {
+            _setVertex(vertices[vertexIndex++], position, _centerColor);
+            _setVertex(vertices[vertexIndex++], position + (unitCircle[i] * centerRadius), _centerColor);
+            _setVertex(vertices[vertexIndex++], position + (unitCircle[i + 1] * centerRadius), _centerColor);
+        }
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+
+    return node;
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QQuickItem>
+#include <QColor>
+#include <QGeoCoordinate>
+#include <QPointer>
+#include <QPointF>
+#include <QVector>
+
+class CameraTriggerPoints;
+
+/// Draws the camera triggers of CameraTriggerPoints as a single scene graph layer over the map.
+///
+/// The item covers the map and is given the center, zoom level and bearing of it. Only the triggers the index has in
+/// view are projected, and a marker is skipped when the one before it in the same spot already covers it, so a zoomed
+/// out mapping flight doesn't draw thousands of markers on top of each other. All markers are in one geometry node.
+class CameraTriggerMapItem : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    CameraTriggerMapItem(QQuickItem* parent = nullptr);
+
+    Q_PROPERTY(CameraTriggerPoints* cameraTriggerPoints READ cameraTriggerPoints    WRITE setCameraTriggerPoints    NOTIFY cameraTriggerPointsChanged)
+    Q_PROPERTY(QGeoCoordinate       center              MEMBER _center              NOTIFY centerChanged)
+    Q_PROPERTY(double               zoomLevel           MEMBER _zoomLevel           NOTIFY zoomLevelChanged)
+    Q_PROPERTY(double               bearing             MEMBER _bearing             NOTIFY bearingChanged)
+    Q_PROPERTY(double               radius              MEMBER _radius              NOTIFY radiusChanged)       ///< Pixels
+    Q_PROPERTY(QColor               color               MEMBER _color               NOTIFY colorsChanged)
+    Q_PROPERTY(QColor               centerColor         MEMBER _centerColor         NOTIFY colorsChanged)
+    Q_PROPERTY(int                  visibleCount        READ visibleCount           NOTIFY visibleCountChanged) ///< Markers drawn
+
+    CameraTriggerPoints*    cameraTriggerPoints     (void) { return _cameraTriggerPoints; }
+    int                     visibleCount            (void) const { return _visiblePositions.count(); }
+    void                    setCameraTriggerPoints  (CameraTriggerPoints* cameraTriggerPoints);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) final;
+
+signals:
+    void cameraTriggerPointsChanged (void);
+    void centerChanged              (void);
+    void zoomLevelChanged           (void);
+    void bearingChanged             (void);
+    void radiusChanged              (void);
+    void colorsChanged              (void);
+    void visibleCountChanged        (void);
+    void _layoutSignal              (void);
+
+private slots:
+    void _layout(void);
+
+private:
+    QPointer<CameraTriggerPoints>   _cameraTriggerPoints;
+    QGeoCoordinate                  _center;
+    double                          _zoomLevel          = 0;
+    double                          _bearing            = 0;
+    double                          _radius             = 10;
+    QColor                          _color              = QColor(0, 0, 0, 102);
+    QColor                          _centerColor        = QColor(Qt::white);
+    QVector<QPointF>                _visiblePositions;                  ///< Built on the GUI thread, read by updatePaintNode while it is blocked
+
+    static const int _cCircleSegments = 12;
+};
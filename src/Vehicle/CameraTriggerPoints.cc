@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CameraTriggerPoints.h"
+
+#include <algorithm>
+
+CameraTriggerPoints::CameraTriggerPoints(QObject* parent)
+    : QObject(parent)
+{
+
+}
+
+void CameraTriggerPoints::append(const Trigger_t& trigger)
+{
+    const int index = count();
+
+    _triggers.push_back(trigger);
+    _cells[_cellKey(_cell(trigger.latitude), _cell(trigger.longitude))].push_back(index);
+
+    emit triggerAdded(index);
+    emit countChanged(count());
+}
+
+void CameraTriggerPoints::clear(void)
+{
+    if (_triggers.empty()) {
+        return;
+    }
+    _triggers.clear();
+    _cells.clear();
+    emit triggersCleared();
+    emit countChanged(0);
+}
+
+std::vector<int> CameraTriggerPoints::query(double south, double west, double north, double east) const
+{
+    std::vector<int> indices;
+
+    if (west > east) {
+        _query(south, west, north, 180.0, indices);
+        _query(south, -180.0, north, east, indices);
+    } else {
+        _query(south, west, north, east, indices);
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+void CameraTriggerPoints::_query(double south, double west, double north, double east, std::vector<int>& indices) const
+{
+    const int       southCell   = _cell(south);
+    const int       northCell   = _cell(north);
+    const int       westCell    = _cell(west);
+    const int       eastCell    = _cell(east);
+    const double    cellCount   = (static_cast<double>(northCell) - southCell + 1) * (static_cast<double>(eastCell) - westCell + 1);
+
+    auto addInside = [&](const std::vector<int>& cellIndices) {
+        for (int index: cellIndices) {
+            const Trigger_t& trigger = _triggers[static_cast<size_t>(index)];
+            if (trigger.latitude >= south && trigger.latitude <= north && trigger.longitude >= west && trigger.longitude <= east) {
+                indices.push_back(index);
+            }
+        }
+    };
+
+    if (cellCount > _cells.count()) {
+        // Zoomed out past the area flown, going through the cells there are is quicker than looking up all the empty ones
+        for (auto iter = _cells.constBegin(); iter != _cells.constEnd(); ++iter) {
+            addInside(iter.value());
+        }
+        return;
+    }
+
+    for (int latitudeCell = southCell; latitudeCell <= northCell; latitudeCell++) {
+        for (int longitudeCell = westCell; longitudeCell <= eastCell; longitudeCell++) {
+            auto iter = _cells.constFind(_cellKey(latitudeCell, longitudeCell));
+            if (iter != _cells.constEnd()) {
+                addInside(iter.value());
+            }
+        }
+    }
+}
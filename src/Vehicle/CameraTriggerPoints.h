@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QtMath>
+
+#include <vector>
+
+/// Camera capture events of a vehicle.
+///
+/// Mapping flights take tens of thousands of images, so the triggers are stored packed rather than as a QObject each.
+/// They are bucketed in a grid of fixed size cells, which lets the map only look at the triggers in view.
+class CameraTriggerPoints : public QObject
+{
+    Q_OBJECT
+
+public:
+    CameraTriggerPoints(QObject* parent = nullptr);
+
+    typedef struct {
+        double      latitude;
+        double      longitude;
+        float       altitude;       ///< AMSL
+        uint32_t    imageIndex;
+        uint64_t    timeUTCUSecs;   ///< 0 if the vehicle didn't say
+    } Trigger_t;
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+    int count(void) const { return static_cast<int>(_triggers.size()); }
+
+    /// Every trigger, in the order they came in
+    const std::vector<Trigger_t>& triggers(void) const { return _triggers; }
+
+    void append(const Trigger_t& trigger);
+
+    /// @return Indices of the triggers inside the box in ascending order. The box may cross the antimeridian, in which
+    /// case west is larger than east.
+    std::vector<int> query(double south, double west, double north, double east) const;
+
+    static constexpr double cellDegrees = 0.002;    ///< Size of the index cells, around 200 meters
+
+public slots:
+    void clear(void);
+
+signals:
+    void countChanged   (int count);
+    void triggerAdded   (int index);
+    void triggersCleared(void);
+
+private:
+    static int      _cell       (double degrees) { return static_cast<int>(qFloor(degrees / cellDegrees)); }
+    static quint64  _cellKey    (int latitudeCell, int longitudeCell) { return (static_cast<quint64>(static_cast<quint32>(latitudeCell)) << 32) | static_cast<quint32>(longitudeCell); }
+    void            _query      (double south, double west, double north, double east, std::vector<int>& indices) const;
+
+    std::vector<Trigger_t>              _triggers;
+    QHash<quint64, std::vector<int>>    _cells;     ///< Trigger indices by cell, each in ascending order
+};
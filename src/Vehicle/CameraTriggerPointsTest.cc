@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CameraTriggerPointsTest.h"
+#include "CameraTriggerPoints.h"
+
+#include <QSignalSpy>
+
+void CameraTriggerPointsTest::_append_test(void)
+{
+    CameraTriggerPoints triggerPoints;
+    QSignalSpy          addedSpy    (&triggerPoints, &CameraTriggerPoints::triggerAdded);
+    QSignalSpy          clearedSpy  (&triggerPoints, &CameraTriggerPoints::triggersCleared);
+
+    triggerPoints.append({ 47.3764, 8.5481, 500.0f, 1, 0 });
+    triggerPoints.append({ 47.3765, 8.5482, 501.0f, 2, 0 });
+    QCOMPARE(triggerPoints.count(), 2);
+    QCOMPARE(addedSpy.count(), 2);
+    QCOMPARE(addedSpy[1][0].toInt(), 1);
+    QCOMPARE(triggerPoints.triggers()[1].imageIndex, static_cast<uint32_t>(2));
+
+    triggerPoints.clear();
+    QCOMPARE(triggerPoints.count(), 0);
+    QCOMPARE(clearedSpy.count(), 1);
+    QVERIFY(triggerPoints.query(-90, -180, 90, 180).empty());
+
+    // Clearing nothing doesn't signal
+    triggerPoints.clear();
+    QCOMPARE(clearedSpy.count(), 1);
+}
+
+void CameraTriggerPointsTest::_query_test(void)
+{
+    CameraTriggerPoints triggerPoints;
+
+    // A grid of 100 by 100 triggers 0.0005 degrees apart, which spans a number of index cells
+    for (int row = 0; row < 100; row++) {
+        for (int column = 0; column < 100; column++) {
+            triggerPoints.append({ 47.0 + (row * 0.0005), 8.0 + (column * 0.0005), 0.0f, static_cast<uint32_t>((row * 100) + column), 0 });
+        }
+    }
+
+    // Rows 10-19 and columns 20-29
+    const std::vector<int> indices = triggerPoints.query(47.0 + (9.5 * 0.0005), 8.0 + (19.5 * 0.0005), 47.0 + (19.5 * 0.0005), 8.0 + (29.5 * 0.0005));
+    QCOMPARE(static_cast<int>(indices.size()), 100);
+    for (size_t i = 0; i < indices.size(); i++) {
+        const int row       = indices[i] / 100;
+        const int column    = indices[i] % 100;
+        QVERIFY(row >= 10 && row < 20);
+        QVERIFY(column >= 20 && column < 30);
+        if (i > 0) {
+            QVERIFY(indices[i] > indices[i - 1]);
+        }
+    }
+
+    QVERIFY(triggerPoints.query(10, 10, 11, 11).empty());
+}
+
+void CameraTriggerPointsTest::_antimeridian_test(void)
+{
+    CameraTriggerPoints triggerPoints;
+
+    triggerPoints.append({ 0.0, 179.999,  0.0f, 0, 0 });
+    triggerPoints.append({ 0.0, -179.999, 0.0f, 1, 0 });
+    triggerPoints.append({ 0.0, 0.0,      0.0f, 2, 0 });
+
+    const std::vector<int> indices = triggerPoints.query(-1, 179, 1, -179);
+    QCOMPARE(static_cast<int>(indices.size()), 2);
+    QCOMPARE(indices[0], 0);
+    QCOMPARE(indices[1], 1);
+}
+
+void CameraTriggerPointsTest::_zoomedOut_test(void)
+{
+    CameraTriggerPoints triggerPoints;
+
+    triggerPoints.append({ 47.0, 8.0,    0.0f, 0, 0 });
+    triggerPoints.append({ -33.0, 151.0, 0.0f, 1, 0 });
+
+    // The whole world has far more cells than there are triggers, which goes through the occupied cells instead
+    QCOMPARE(static_cast<int>(triggerPoints.query(-90, -180, 90, 180).size()), 2);
+    QCOMPARE(static_cast<int>(triggerPoints.query(0, 0, 90, 180).size()), 1);
+}
@@ -17,6 +17,8 @@
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <QFileInfo>
+#include <QDateTime>
 
 QGC_LOGGING_CATEGORY(CompInfoParamLog, "CompInfoParamLog")
 
@@ -25,12 +27,27 @@ const char* CompInfoParam::_jsonParametersKey           = "parameters";
 const char* CompInfoParam::_cachedMetaDataFilePrefix    = "ParameterFactMetaData";
 const char* CompInfoParam::_indexedNameTag              = "{n}";
 
+QHash<QString, CompInfoParam::SharedMetaData_t> CompInfoParam::_sharedMetaDataMap;
+
 CompInfoParam::CompInfoParam(uint8_t compId, Vehicle* vehicle, QObject* parent)
     : CompInfo(COMP_METADATA_TYPE_PARAMETER, compId, vehicle, parent)
 {
 
 }
 
+CompInfoParam::~CompInfoParam()
+{
+    if (!_sharedMetaDataKey.isEmpty()) {
+        auto iter = _sharedMetaDataMap.find(_sharedMetaDataKey);
+        if (iter != _sharedMetaDataMap.end() && --iter->refCount == 0) {
+            qCDebug(CompInfoParamLog) << "Releasing shared meta data" << _sharedMetaDataKey;
+            // Facts of the vehicle going away may still be pointing into it until they are deleted themselves
+            iter->metaData->deleteLater();
+            _sharedMetaDataMap.erase(iter);
+        }
+    }
+}
+
 void CompInfoParam::setJson(const QString& metadataJsonFileName, const QString& translationJsonFileName)
 {
     qCDebug(CompInfoParamLog) << "setJson: metadataJsonFileName:translationJsonFileName" << metadataJsonFileName << translationJsonFileName;
@@ -309,8 +326,27 @@ QObject* CompInfoParam::_getOpaqueParameterMetaData(void)
         // Load best parameter meta data set
         int majorVersion, minorVersion;
         QString metaDataFile = _parameterMetaDataFile(vehicle, vehicle->firmwareType(), majorVersion, minorVersion);
-        qCDebug(CompInfoParamLog) << "Loading meta data the old way file" << metaDataFile;
-        _opaqueParameterMetaData = vehicle->firmwarePlugin()->_loadParameterMetaData(metaDataFile);
+
+        // Vehicles of the same firmware and vehicle type use the same file, so parse it a single time and share the
+        // result. The file modification time is part of the key so a newer cached PX4 file is picked up.
+        QFileInfo metaDataFileInfo(metaDataFile);
+        _sharedMetaDataKey = QStringLiteral("%1:%2:%3.%4:%5:%6").arg(vehicle->firmwareType()).arg(metaDataFile).arg(majorVersion).arg(minorVersion)
+                .arg(metaDataFileInfo.size()).arg(metaDataFileInfo.lastModified().toMSecsSinceEpoch());
+
+        auto iter = _sharedMetaDataMap.find(_sharedMetaDataKey);
+        if (iter != _sharedMetaDataMap.end()) {
+            qCDebug(CompInfoParamLog) << "Using shared meta data file" << metaDataFile;
+            iter->refCount++;
+            _opaqueParameterMetaData = iter->metaData;
+        } else {
+            qCDebug(CompInfoParamLog) << "Loading meta data the old way file" << metaDataFile;
+            _opaqueParameterMetaData = vehicle->firmwarePlugin()->_loadParameterMetaData(metaDataFile);
+            if (_opaqueParameterMetaData) {
+                _sharedMetaDataMap[_sharedMetaDataKey] = { _opaqueParameterMetaData, 1 };
+            } else {
+                _sharedMetaDataKey.clear();
+            }
+        }
     }
 
     return _opaqueParameterMetaData;
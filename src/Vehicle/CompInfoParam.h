@@ -15,6 +15,7 @@
 #include "FactMetaData.h"
 
 #include <QObject>
+#include <QHash>
 
 class FactMetaData;
 class Vehicle;
@@ -28,6 +29,7 @@ class CompInfoParam : public CompInfo
 
 public:
     CompInfoParam(uint8_t compId, Vehicle* vehicle, QObject* parent = nullptr);
+    ~CompInfoParam();
 
     FactMetaData* factMetaDataForName(const QString& name, FactMetaData::ValueType_t type);
 
@@ -44,10 +46,18 @@ private:
 
     typedef QPair<QString /* indexed name */, FactMetaData*> RegexFactMetaDataPair_t;
 
+    typedef struct {
+        QObject*    metaData;
+        int         refCount;
+    } SharedMetaData_t;
+
     bool                                _noJsonMetadata             = true;
     FactMetaData::NameToMetaDataMap_t   _nameToMetaDataMap;
     QList<RegexFactMetaDataPair_t>      _indexedNameMetaDataList;
     QObject*                            _opaqueParameterMetaData    = nullptr;
+    QString                             _sharedMetaDataKey;                     ///< Key into _sharedMetaDataMap for _opaqueParameterMetaData
+
+    static QHash<QString, SharedMetaData_t> _sharedMetaDataMap;                 ///< Opaque meta data shared between all vehicles which load the same meta data file
 
     static const char* _cachedMetaDataFilePrefix;
     static const char* _jsonScopeKey;
@@ -22,6 +22,9 @@
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSettings>
 
 QGC_LOGGING_CATEGORY(ComponentInformationManagerLog, "ComponentInformationManagerLog")
 
@@ -206,20 +209,80 @@ void RequestMetaDataTypeStateMachine::_stateRequestCompInfo(StateMachine* stateM
     }
 }
 
-QString RequestMetaDataTypeStateMachine::_downloadCompleteJsonWorker(const QString& fileName, const QString& inflatedFileName)
+QDir RequestMetaDataTypeStateMachine::_cacheDir(void)
 {
-    QString outputFileName = fileName;
+    return QDir(QFileInfo(QSettings().fileName()).dir().absoluteFilePath(QStringLiteral("CompInfoCache")));
+}
 
-    if (fileName.endsWith(".gz", Qt::CaseInsensitive)) {
-        outputFileName = (QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath(inflatedFileName));
-        if (QGCZlib::inflateGzipFile(fileName, outputFileName)) {
-            QFile(fileName).remove();
-        } else {
+/// Downloaded json is cached by the uid the vehicle reports for it, which is a crc of the contents.
+///     @return Cache file name, empty if the vehicle did not provide a uid
+QString RequestMetaDataTypeStateMachine::_cacheFileName(const QString& jsonFileName, uint32_t uid)
+{
+    if (uid == 0) {
+        return QString();
+    }
+    return _cacheDir().absoluteFilePath(QStringLiteral("%1.%2").arg(uid, 8, 16, QLatin1Char('0')).arg(jsonFileName));
+}
+
+/// Removes a json file once it has been loaded, unless it belongs to the cache
+void RequestMetaDataTypeStateMachine::_removeDownloadedJson(const QString& jsonFileName)
+{
+    if (!jsonFileName.isEmpty() && QFileInfo(jsonFileName).absoluteDir() != _cacheDir()) {
+        QFile(jsonFileName).remove();
+    }
+}
+
+QString RequestMetaDataTypeStateMachine::_downloadCompleteJsonWorker(const QString& fileName, const QString& inflatedFileName, uint32_t uid)
+{
+    QString cacheFileName = _cacheFileName(inflatedFileName, uid);
+
+    if (!fileName.endsWith(".gz", Qt::CaseInsensitive) && cacheFileName.isEmpty()) {
+        return fileName;
+    }
+
+    QFile downloadFile(fileName);
+    if (!downloadFile.open(QIODevice::ReadOnly)) {
+        qCWarning(ComponentInformationManagerLog) << "Open of downloaded json failed" << fileName << downloadFile.errorString();
+        return QString();
+    }
+    QByteArray bytes = downloadFile.readAll();
+    downloadFile.close();
+
+    QString outputFileName = _saveJsonWorker(bytes, fileName.endsWith(".gz", Qt::CaseInsensitive), inflatedFileName, uid);
+    if (!outputFileName.isEmpty()) {
+        downloadFile.remove();
+    }
+    return outputFileName;
+}
+
+/// Writes downloaded json to where it is loaded from, the cache if it can be cached
+///     @param compressed true: bytes are gzip compressed
+/// @return Name of the file written, empty on failure
+QString RequestMetaDataTypeStateMachine::_saveJsonWorker(QByteArray bytes, bool compressed, const QString& inflatedFileName, uint32_t uid)
+{
+    QString cacheFileName = _cacheFileName(inflatedFileName, uid);
+
+    if (compressed) {
+        // Inflated in memory, the result only goes to disk once, straight to where it is loaded from
+        QByteArray inflatedBytes;
+        if (!QGCZlib::inflateGzipData(bytes, inflatedBytes)) {
             qCWarning(ComponentInformationManagerLog) << "Inflate of compressed json failed" << inflatedFileName;
-            outputFileName.clear();
+            return QString();
         }
+        bytes = inflatedBytes;
+    }
+
+    QString outputFileName = cacheFileName;
+    if (outputFileName.isEmpty()) {
+        outputFileName = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath(inflatedFileName);
     } else {
-        outputFileName = fileName;
+        _cacheDir().mkpath(QStringLiteral("."));
+    }
+
+    QSaveFile outputFile(outputFileName);
+    if (!outputFile.open(QIODevice::WriteOnly) || outputFile.write(bytes) != bytes.size() || !outputFile.commit()) {
+        qCWarning(ComponentInformationManagerLog) << "Write of json failed" << outputFileName << outputFile.errorString();
+        return QString();
     }
 
     return outputFileName;
@@ -229,9 +292,14 @@ void RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson(const QSt
 {
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson fileName:errorMsg" << fileName << errorMsg;
 
+    // Other transfers share the FTP manager
+    if (QFileInfo(fileName).fileName() != _compInfo->uriMetaData.section('/', -1)) {
+        return;
+    }
+
     disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson);
     if (errorMsg.isEmpty()) {
-        _jsonMetadataFileName = _downloadCompleteJsonWorker(fileName, "metadata.json");
+        _jsonMetadataFileName = _downloadCompleteJsonWorker(fileName, "metadata.json", _compInfo->uidMetaData);
     } else if (qgcApp()->runningUnitTests()) {
         // Unit test should always succeed
         qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson failed filename:errorMsg" << fileName << errorMsg;
@@ -246,9 +314,14 @@ void RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson(const
 
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson fileName:errorMsg" << fileName << errorMsg;
 
+    // Other transfers share the FTP manager
+    if (QFileInfo(fileName).fileName() != _compInfo->uriTranslation.section('/', -1)) {
+        return;
+    }
+
     disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson);
     if (errorMsg.isEmpty()) {
-        _jsonTranslationFileName = _downloadCompleteJsonWorker(fileName, "translation.json");
+        _jsonTranslationFileName = _downloadCompleteJsonWorker(fileName, "translation.json", _compInfo->uidTranslation);
     } else if (qgcApp()->runningUnitTests()) {
         // Unit test should always succeed
         qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson failed filename:errorMsg" << fileName << errorMsg;
@@ -261,9 +334,11 @@ void RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson(QString
 {
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
 
-    disconnect(qobject_cast<QGCFileDownload*>(sender()), &QGCFileDownload::downloadComplete, this, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson);
+    QGCFileDownload* download = qobject_cast<QGCFileDownload*>(sender());
+    disconnect(download, &QGCFileDownload::downloadComplete, this, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson);
     if (errorMsg.isEmpty()) {
-        _jsonMetadataFileName = _downloadCompleteJsonWorker(localFile, "metadata.json");
+        // Kept in memory and inflated while downloading
+        _jsonMetadataFileName = _saveJsonWorker(download->data(), false /* compressed */, "metadata.json", _compInfo->uidMetaData);
     } else if (qgcApp()->runningUnitTests()) {
         // Unit test should always succeed
         qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson failed remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
@@ -278,9 +353,11 @@ void RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson(QStri
 
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
 
-    disconnect(qobject_cast<QGCFileDownload*>(sender()), &QGCFileDownload::downloadComplete, this, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson);
+    QGCFileDownload* download = qobject_cast<QGCFileDownload*>(sender());
+    disconnect(download, &QGCFileDownload::downloadComplete, this, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson);
     if (errorMsg.isEmpty()) {
-        _jsonTranslationFileName = _downloadCompleteJsonWorker(localFile, "translation.json");
+        // Kept in memory and inflated while downloading
+        _jsonTranslationFileName = _saveJsonWorker(download->data(), false /* compressed */, "translation.json", _compInfo->uidTranslation);
     } else if (qgcApp()->runningUnitTests()) {
         // Unit test should always succeed
         qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson failed remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
@@ -295,7 +372,13 @@ void RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson(StateMachine* st
     CompInfo*                           compInfo        = requestMachine->compInfo();
     FTPManager*                         ftpManager      = compInfo->vehicle->ftpManager();
 
-    if (compInfo->available) {
+    QString cacheFileName = _cacheFileName("metadata.json", compInfo->uidMetaData);
+
+    if (compInfo->available && !cacheFileName.isEmpty() && QFile::exists(cacheFileName)) {
+        qCDebug(ComponentInformationManagerLog) << "Using cached metadata json" << cacheFileName;
+        requestMachine->_jsonMetadataFileName = cacheFileName;
+        requestMachine->advance();
+    } else if (compInfo->available) {
         qCDebug(ComponentInformationManagerLog) << "Downloading metadata json" << compInfo->uriMetaData;
         if (_uriIsMAVLinkFTP(compInfo->uriMetaData)) {
             connect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteMetaDataJson);
@@ -307,6 +390,7 @@ void RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson(StateMachine* st
         } else {
             QGCFileDownload* download = new QGCFileDownload(requestMachine);
             connect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson);
+            download->setInMemory(compInfo->uriMetaData.endsWith(".gz", Qt::CaseInsensitive) /* inflateGzip */);
             if (!download->download(compInfo->uriMetaData)) {
                 qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson QGCFileDownload::download returned failure";
                 disconnect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteMetaDataJson);
@@ -326,21 +410,28 @@ void RequestMetaDataTypeStateMachine::_stateRequestTranslationJson(StateMachine*
     FTPManager*                         ftpManager      = compInfo->vehicle->ftpManager();
 
     if (compInfo->available) {
+        QString cacheFileName = _cacheFileName("translation.json", compInfo->uidTranslation);
+
         if (compInfo->uriTranslation.isEmpty()) {
             qCDebug(ComponentInformationManagerLog) << "Skipping translation json download. No translation json specified";
             requestMachine->advance();
+        } else if (!cacheFileName.isEmpty() && QFile::exists(cacheFileName)) {
+            qCDebug(ComponentInformationManagerLog) << "Using cached translation json" << cacheFileName;
+            requestMachine->_jsonTranslationFileName = cacheFileName;
+            requestMachine->advance();
         } else {
             qCDebug(ComponentInformationManagerLog) << "Downloading translation json" << compInfo->uriTranslation;
             if (_uriIsMAVLinkFTP(compInfo->uriTranslation)) {
                 connect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson);
                 if (!ftpManager->download(compInfo->uriTranslation, QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
                     qCWarning(ComponentInformationManagerLog) << "_stateRequestTranslationJson::_stateRequestMetaDataJson FTPManager::download returned failure";
-                    connect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson);
+                    disconnect(ftpManager, &FTPManager::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_ftpDownloadCompleteTranslationJson);
                     requestMachine->advance();
                 }
             } else {
                 QGCFileDownload* download = new QGCFileDownload(requestMachine);
                 connect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson);
+                download->setInMemory(compInfo->uriTranslation.endsWith(".gz", Qt::CaseInsensitive) /* inflateGzip */);
                 if (!download->download(compInfo->uriTranslation)) {
                     qCWarning(ComponentInformationManagerLog) << "_stateRequestTranslationJson::_stateRequestMetaDataJson QGCFileDownload::download returned failure";
                     disconnect(download, &QGCFileDownload::downloadComplete, requestMachine, &RequestMetaDataTypeStateMachine::_httpDownloadCompleteTranslationJson);
@@ -361,12 +452,8 @@ void RequestMetaDataTypeStateMachine::_stateRequestComplete(StateMachine* stateM
 
     compInfo->setJson(requestMachine->_jsonMetadataFileName, requestMachine->_jsonTranslationFileName);
 
-    if (!requestMachine->_jsonMetadataFileName.isEmpty()) {
-        QFile(requestMachine->_jsonMetadataFileName).remove();
-    }
-    if (!requestMachine->_jsonTranslationFileName.isEmpty()) {
-        QFile(requestMachine->_jsonTranslationFileName).remove();
-    }
+    _removeDownloadedJson(requestMachine->_jsonMetadataFileName);
+    _removeDownloadedJson(requestMachine->_jsonTranslationFileName);
 
     requestMachine->advance();
 }
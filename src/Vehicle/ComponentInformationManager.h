@@ -13,6 +13,8 @@
 #include "QGCMAVLink.h"
 #include "StateMachine.h"
 
+#include <QDir>
+
 Q_DECLARE_LOGGING_CATEGORY(ComponentInformationManagerLog)
 
 class Vehicle;
@@ -42,15 +44,18 @@ private slots:
     void    _ftpDownloadCompleteTranslationJson (const QString& file, const QString& errorMsg);
     void    _httpDownloadCompleteMetaDataJson   (QString remoteFile, QString localFile, QString errorMsg);
     void    _httpDownloadCompleteTranslationJson(QString remoteFile, QString localFile, QString errorMsg);
-    QString _downloadCompleteJsonWorker         (const QString& jsonFileName, const QString& inflatedFileName);
+    QString _downloadCompleteJsonWorker         (const QString& jsonFileName, const QString& inflatedFileName, uint32_t uid);
+    QString _saveJsonWorker                     (QByteArray bytes, bool compressed, const QString& inflatedFileName, uint32_t uid);
 
 private:
-    static void _stateRequestCompInfo           (StateMachine* stateMachine);
-    static void _stateRequestMetaDataJson       (StateMachine* stateMachine);
-    static void _stateRequestTranslationJson    (StateMachine* stateMachine);
-    static void _stateRequestComplete           (StateMachine* stateMachine);
-    static bool _uriIsMAVLinkFTP                (const QString& uri);
-
+    static void     _stateRequestCompInfo           (StateMachine* stateMachine);
+    static void     _stateRequestMetaDataJson       (StateMachine* stateMachine);
+    static void     _stateRequestTranslationJson    (StateMachine* stateMachine);
+    static void     _stateRequestComplete           (StateMachine* stateMachine);
+    static bool     _uriIsMAVLinkFTP                (const QString& uri);
+    static QDir     _cacheDir                       (void);
+    static QString  _cacheFileName                  (const QString& jsonFileName, uint32_t uid);
+    static void     _removeDownloadedJson           (const QString& jsonFileName);
 
     ComponentInformationManager*    _compMgr                    = nullptr;
     CompInfo*                       _compInfo                   = nullptr;
@@ -15,12 +15,19 @@
 
 #include <QFile>
 #include <QDir>
+#include <QTextStream>
+#include <QtMath>
 #include <string>
 
 QGC_LOGGING_CATEGORY(FTPManagerLog, "FTPManagerLog")
 
 const char* FTPManager::mavlinkFTPScheme = "mftp";
 
+// Passed by reference to qMin/qBound
+const int FTPManager::_minAckOrNakTimeoutMsecs;
+const int FTPManager::_maxAckOrNakTimeoutMsecs;
+const int FTPManager::_maxFillWindow;
+
 FTPManager::FTPManager(Vehicle* vehicle)
     : QObject   (vehicle)
     , _vehicle  (vehicle)
@@ -29,17 +36,44 @@ FTPManager::FTPManager(Vehicle* vehicle)
     // Mock link responds immediately if at all, speed up unit tests with faster timoue
     _ackOrNakTimeoutTimer.setInterval(qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
     connect(&_ackOrNakTimeoutTimer, &QTimer::timeout, this, &FTPManager::_ackOrNakTimeout);
+
+    _budgetDelayTimer.setSingleShot(true);
+    connect(&_budgetDelayTimer, &QTimer::timeout, this, &FTPManager::_budgetDelayTimeout);
+
+    _rttClock.start();
     
     // Make sure we don't have bad structure packing
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
 }
 
-bool FTPManager::download(const QString& fromURI, const QString& toDir)
+bool FTPManager::download(const QString& fromURI, const QString& toDir, bool resume)
+{
+    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir << "resume:" << resume;
+
+    QString fullPathOnVehicle;
+    uint8_t compId;
+    if (!_parseURI(fromURI, fullPathOnVehicle, compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    if (_busy()) {
+        qCDebug(FTPManagerLog) << "download queued, operations ahead:" << _operationQueue.count() + 1;
+        _operationQueue.enqueue({ OperationDownload, fromURI, toDir, resume });
+        return true;
+    }
+
+    return _startDownload(fromURI, toDir, resume);
+}
+
+bool FTPManager::_startDownload(const QString& fromURI, const QString& toDir, bool resume)
 {
-    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir;
+    _downloadState.reset();
+    _downloadState.toDir.setPath(toDir);
+    _downloadState.resume = resume;
 
-    if (!_rgStateMachine.isEmpty()) {
-        qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
+    if (!_parseURI(fromURI, _downloadState.fullPathOnVehicle, _ftpCompId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
         return false;
     }
 
@@ -54,14 +88,6 @@ bool FTPManager::download(const QString& fromURI, const QString& toDir)
         _rgStateMachine.append(rgDownloadStateMachine[i]);
     }
 
-    _downloadState.reset();
-    _downloadState.toDir.setPath(toDir);
-
-    if (!_parseURI(fromURI, _downloadState.fullPathOnVehicle, _ftpCompId)) {
-        qCWarning(FTPManagerLog) << "_parseURI failed";
-        return false;
-    }
-
     // We need to strip off the file name from the fully qualified path. We can't use the usual QDir
     // routines because this path does not exist locally.
     int lastDirSlashIndex;
@@ -76,11 +102,171 @@ bool FTPManager::download(const QString& fromURI, const QString& toDir)
 
     qCDebug(FTPManagerLog) << "_downloadState.fullPathOnVehicle:_downloadState.fileName" << _downloadState.fullPathOnVehicle << _downloadState.fileName;
 
+    _currentDownloadURI = fromURI;
+    _transferStarted(_downloadState.toDir.absoluteFilePath(_downloadState.fileName));
+    _startStateMachine();
+
+    return true;
+}
+
+void FTPManager::cancelDownload(const QString& fromURI)
+{
+    if (!_rgStateMachine.isEmpty() && _rgStateMachine.first().beginFn == &FTPManager::_openFileROBegin && _currentDownloadURI == fromURI) {
+        qCDebug(FTPManagerLog) << "cancelDownload" << fromURI;
+
+        // Let go of the session on the vehicle. Nothing is left to handle the ack, so it isn't waited for.
+        MavlinkFTP::Request request{};
+        request.hdr.opcode  = MavlinkFTP::kCmdResetSessions;
+        request.hdr.size    = 0;
+        _sendRequest(&request);
+
+        _downloadComplete(tr("Download cancelled"));
+        return;
+    }
+
+    for (int i=0; i<_operationQueue.count(); i++) {
+        const Operation_t operation = _operationQueue[i];
+        if (operation.type == OperationDownload && operation.fromPath == fromURI) {
+            qCDebug(FTPManagerLog) << "cancelDownload queued" << fromURI;
+            _operationQueue.removeAt(i);
+            emit downloadComplete(QDir(operation.toPath).absoluteFilePath(fromURI.section('/', -1)), tr("Download cancelled"));
+            return;
+        }
+    }
+}
+
+bool FTPManager::listDirectory(const QString& fromURI)
+{
+    qCDebug(FTPManagerLog) << "listDirectory fromURI:" << fromURI;
+
+    QString fullPathOnVehicle;
+    uint8_t compId;
+    if (!_parseURI(fromURI, fullPathOnVehicle, compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    if (_busy()) {
+        qCDebug(FTPManagerLog) << "listDirectory queued, operations ahead:" << _operationQueue.count() + 1;
+        _operationQueue.enqueue({ OperationListDirectory, fromURI, QString(), false });
+        return true;
+    }
+
+    return _startListDirectory(fromURI);
+}
+
+bool FTPManager::_startListDirectory(const QString& fromURI)
+{
+    _listDirectoryState.reset();
+
+    if (!_parseURI(fromURI, _listDirectoryState.fullPathOnVehicle, _ftpCompId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    static const StateFunctions_t rgListDirectoryStateMachine[] = {
+        { &FTPManager::_listDirectoryBegin,             &FTPManager::_listDirectoryAckOrNak,        &FTPManager::_listDirectoryTimeout },
+        { &FTPManager::_listDirectoryCompleteNoError,   nullptr,                                    nullptr },
+    };
+    for (size_t i=0; i<sizeof(rgListDirectoryStateMachine)/sizeof(rgListDirectoryStateMachine[0]); i++) {
+        _rgStateMachine.append(rgListDirectoryStateMachine[i]);
+    }
+
     _startStateMachine();
 
     return true;
 }
 
+bool FTPManager::upload(const QString& fromFile, const QString& toURI)
+{
+    qCDebug(FTPManagerLog) << "upload fromFile:" << fromFile << "to:" << toURI;
+
+    QString fullPathOnVehicle;
+    uint8_t compId;
+    if (!_parseURI(toURI, fullPathOnVehicle, compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    if (_busy()) {
+        qCDebug(FTPManagerLog) << "upload queued, operations ahead:" << _operationQueue.count() + 1;
+        _operationQueue.enqueue({ OperationUpload, fromFile, toURI, false });
+        return true;
+    }
+
+    return _startUpload(fromFile, toURI);
+}
+
+bool FTPManager::_startUpload(const QString& fromFile, const QString& toURI)
+{
+    _uploadState.reset();
+    _uploadState.localFile = fromFile;
+
+    if (!_parseURI(toURI, _uploadState.fullPathOnVehicle, _ftpCompId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    // Files going through FTP are small, so the whole file is read up front
+    QFile file(fromFile);
+    if (!file.open(QFile::ReadOnly)) {
+        qCWarning(FTPManagerLog) << "Unable to open file for upload" << fromFile << file.errorString();
+        return false;
+    }
+    _uploadState.data = file.readAll();
+
+    static const StateFunctions_t rgUploadStateMachine[] = {
+        { &FTPManager::_createFileBegin,            &FTPManager::_createFileAckOrNak,           &FTPManager::_createFileTimeout },
+        { &FTPManager::_writeFileBegin,             &FTPManager::_writeFileAckOrNak,            &FTPManager::_writeFileTimeout },
+        { &FTPManager::_terminateSessionBegin,      &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
+        { &FTPManager::_uploadCompleteNoError,      nullptr,                                    nullptr },
+    };
+    for (size_t i=0; i<sizeof(rgUploadStateMachine)/sizeof(rgUploadStateMachine[0]); i++) {
+        _rgStateMachine.append(rgUploadStateMachine[i]);
+    }
+
+    _transferStarted(fromFile);
+    _startStateMachine();
+
+    return true;
+}
+
+/// Starts the operations which have been waiting for the previous one to complete. An operation which can no longer be
+/// started signals its completion with an error and the next one is tried.
+void FTPManager::_startNextOperation(void)
+{
+    while (_rgStateMachine.isEmpty() && !_operationQueue.isEmpty()) {
+        const Operation_t operation = _operationQueue.dequeue();
+
+        switch (operation.type) {
+        case OperationDownload:
+            if (!_startDownload(operation.fromPath, operation.toPath, operation.resume)) {
+                emit downloadComplete(QDir(operation.toPath).absoluteFilePath(operation.fromPath.section('/', -1)), tr("Download failed"));
+            }
+            break;
+        case OperationUpload:
+            if (!_startUpload(operation.fromPath, operation.toPath)) {
+                emit uploadComplete(operation.fromPath, tr("Upload failed"));
+            }
+            break;
+        case OperationListDirectory:
+            if (!_startListDirectory(operation.fromPath)) {
+                emit listDirectoryComplete(QStringList(), tr("List directory failed"));
+            }
+            break;
+        }
+    }
+}
+
+void FTPManager::_stopStateMachine(void)
+{
+    _ackOrNakTimeoutTimer.stop();
+    _budgetDelayTimer.stop();
+    _budgetResumeFn = nullptr;
+    _rgStateMachine.clear();
+    _currentStateMachineIndex = -1;
+}
+
 /// Closes out a download session by writing the file and doing cleanup.
 ///     @param errorMsg Error message, empty if no error
 void FTPManager::_downloadComplete(const QString& errorMsg)
@@ -90,17 +276,58 @@ void FTPManager::_downloadComplete(const QString& errorMsg)
     QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
     QString error               = errorMsg;
 
-    _ackOrNakTimeoutTimer.stop();
-    _rgStateMachine.clear();
-    _currentStateMachineIndex = -1;
+    _stopStateMachine();
+    _currentDownloadURI.clear();
     if (_downloadState.file.isOpen()) {
-        _downloadState.file.close();
-        if (!errorMsg.isEmpty()) {
-            _downloadState.file.remove();
+        if (!errorMsg.isEmpty() && _downloadState.resume) {
+            // Keep what we have so the next download can pick up from here
+            _savePartial();
+            _downloadState.file.close();
+        } else {
+            _downloadState.file.close();
+            if (!errorMsg.isEmpty()) {
+                _downloadState.file.remove();
+            }
         }
     }
+    if (errorMsg.isEmpty() && _downloadState.resume) {
+        QFile::remove(_partialFilePath());
+    }
 
+    _transferComplete();
     emit downloadComplete(downloadFilePath, errorMsg);
+    _startNextOperation();
+}
+
+/// Closes out a list directory session and does cleanup.
+///     @param errorMsg Error message, empty if no error
+void FTPManager::_listDirectoryComplete(const QString& errorMsg)
+{
+    qCDebug(FTPManagerLog) << QString("_listDirectoryComplete: errorMsg(%1)").arg(errorMsg);
+
+    QStringList dirList = _listDirectoryState.rgDirectoryList;
+
+    _stopStateMachine();
+    _listDirectoryState.reset();
+
+    emit listDirectoryComplete(dirList, errorMsg);
+    _startNextOperation();
+}
+
+/// Closes out an upload session and does cleanup.
+///     @param errorMsg Error message, empty if no error
+void FTPManager::_uploadComplete(const QString& errorMsg)
+{
+    qCDebug(FTPManagerLog) << QString("_uploadComplete: errorMsg(%1)").arg(errorMsg);
+
+    QString localFile = _uploadState.localFile;
+
+    _stopStateMachine();
+    _uploadState.reset();
+    _transferComplete();
+
+    emit uploadComplete(localFile, errorMsg);
+    _startNextOperation();
 }
 
 void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
@@ -109,7 +336,8 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
         return;
     }
 
-    if (_currentStateMachineIndex == -1) {
+    if (_currentStateMachineIndex == -1 || _budgetDelayTimer.isActive()) {
+        // Nothing is waiting for a response while the next request is held back for the budget
         return;
     }
 
@@ -124,9 +352,16 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
     
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&data.payload[0];
 
-    // Ignore old/reordered packets (handle wrap-around properly)
+    if (_rttSampleValid && request->hdr.seqNumber == _rttSampleSeqNumber) {
+        _rttSampleValid = false;
+        _addRttSample(_rttClock.elapsed() - _rttSampleSentMSecs);
+    }
+
+    // Ignore old/reordered packets (handle wrap-around properly). Gap fill has several reads outstanding, it matches the
+    // replies up with them itself.
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
-    if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+    bool     multipleOutstanding     = _rgStateMachine[_currentStateMachineIndex].ackNakFn == &FTPManager::_fillMissingBlocksAckOrNak;
+    if (!multipleOutstanding && (uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
         qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << _expectedIncomingSeqNumber << actualIncomingSeqNumber
                                << "hdr.opcode:hdr.req_opcode" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode));
 
@@ -154,6 +389,11 @@ void FTPManager::_advanceStateMachine(void)
 
 void FTPManager::_ackOrNakTimeout(void)
 {
+    // Back off until an ack can be timed again
+    _rttSampleValid = false;
+    _rtoMSecs       = qMin(_rtoMSecs * 2, _maxAckOrNakTimeoutMsecs);
+    _updateAckOrNakTimeout();
+
     (this->*_rgStateMachine[_currentStateMachineIndex].timeoutFn)();
 }
 
@@ -193,8 +433,15 @@ void FTPManager::_openFileROBegin(void)
 
 void FTPManager::_openFileROTimeout(void)
 {
-    qCDebug(FTPManagerLog) << "_openFileROTimeout";
-    _downloadComplete(tr("Download failed"));
+    if (++_downloadState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << "_openFileROTimeout retries exceeded";
+        _downloadComplete(tr("Download failed"));
+    } else {
+        // Must used same sequence number as previous request, the vehicle answers a repeated open with the same ack
+        qCDebug(FTPManagerLog) << QString("_openFileROTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
+        _expectedIncomingSeqNumber -= 2;
+        _openFileROBegin();
+    }
 }
 
 void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
@@ -225,7 +472,18 @@ void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
         _downloadState.expectedOffset   = 0;
 
         _downloadState.file.setFileName(_downloadState.toDir.filePath(_downloadState.fileName));
-        if (_downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
+        bool                resumed     = _downloadState.resume && _loadPartial();
+        QIODevice::OpenMode openMode    = resumed ? QIODevice::OpenMode(QFile::ReadWrite) : (QFile::WriteOnly | QFile::Truncate);
+        if (_downloadState.file.open(openMode)) {
+            if (resumed) {
+                qCDebug(FTPManagerLog) << "_openFileROAckOrNak: resuming download - receivedEnd:bytesWritten:missingBlocks" << _downloadState.receivedEnd << _downloadState.bytesWritten << _downloadState.rgMissingData.count();
+                if (_downloadState.fileSize != 0) {
+                    emit commandProgress(100 * ((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize));
+                }
+            } else if (_downloadState.resume) {
+                // Replaces a sidecar left behind by a different file of the same name
+                _savePartial();
+            }
             _advanceStateMachine();
         } else {
             qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.file open failed" << _downloadState.file.errorString();
@@ -239,6 +497,10 @@ void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
 
 void FTPManager::_burstReadFileWorker(bool firstRequest)
 {
+    if (firstRequest && _deferForBudget(&FTPManager::_burstReadFileBegin)) {
+        return;
+    }
+
     qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at offset:firstRequest:retryCount" << _downloadState.expectedOffset << firstRequest << _downloadState.retryCount;
 
     MavlinkFTP::Request request{};
@@ -309,6 +571,7 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
         }
         _downloadState.bytesWritten += ackOrNak->hdr.size;
         _downloadState.expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
+        _downloadDataReceived(ackOrNak->hdr.offset, ackOrNak->hdr.size);
 
         if (_downloadState.fileSize != 0) {
             emit commandProgress(100 * ((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize));
@@ -356,29 +619,7 @@ void FTPManager::_burstReadFileTimeout(void)
 
 void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
 {
-    if (_downloadState.rgMissingData.count()) {
-        MavlinkFTP::Request request{};
-        MissingData_t&      missingData = _downloadState.rgMissingData.first();
-
-        uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytesMissing);
-
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: offset:cBytesToRead" << missingData.offset << cBytesToRead;
-
-        request.hdr.session                 = _downloadState.sessionId;
-        request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
-        request.hdr.offset                  = missingData.offset;
-        request.hdr.size                    = cBytesToRead;
-
-        if (firstRequest) {
-            _downloadState.retryCount = 0;
-        } else {
-            // Must used same sequence number as previous request
-            _expectedIncomingSeqNumber -= 2;
-        }
-        _downloadState.expectedOffset = request.hdr.offset;
-
-        _sendRequestExpectAck(&request);
-    } else {
+    if (_downloadState.rgMissingData.isEmpty()) {
         // We should have the full file now
         if (_downloadState.bytesWritten == _downloadState.fileSize) {
             _advanceStateMachine();
@@ -386,11 +627,77 @@ void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
             qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesWritten:fileSize" << _downloadState.bytesWritten << _downloadState.fileSize;
             _downloadComplete(tr("Download failed"));
         }
+        return;
+    }
+
+    if (firstRequest) {
+        // Replies to outstanding reads would be dropped while a request is held back
+        if (_downloadState.rgFillRequests.isEmpty() && _deferForBudget(&FTPManager::_fillMissingBlocksNext)) {
+            return;
+        }
+    } else {
+        // Ask for everything outstanding again. Replies to the earlier requests no longer match a sequence number.
+        _downloadState.rgFillRequests.clear();
+    }
+
+    // Keep up to _fillWindow reads outstanding, each one for a block which isn't already asked for
+    for (const MissingData_t& missingData: _downloadState.rgMissingData) {
+        if (_downloadState.rgFillRequests.count() >= _fillWindow) {
+            break;
+        }
+        bool outstanding = false;
+        for (const FillRequest_t& fillRequest: _downloadState.rgFillRequests) {
+            if (fillRequest.offset == missingData.offset) {
+                outstanding = true;
+                break;
+            }
+        }
+        if (outstanding) {
+            continue;
+        }
+
+        MavlinkFTP::Request request{};
+        request.hdr.session = _downloadState.sessionId;
+        request.hdr.opcode  = MavlinkFTP::kCmdReadFile;
+        request.hdr.offset  = missingData.offset;
+        request.hdr.size    = static_cast<uint8_t>(missingData.cBytesMissing);
+
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: offset:cBytesToRead:window" << missingData.offset << missingData.cBytesMissing << _fillWindow;
+
+        _sendRequestExpectAck(&request);
+
+        FillRequest_t fillRequest;
+        fillRequest.seqNumber   = _expectedIncomingSeqNumber;
+        fillRequest.offset      = missingData.offset;
+        fillRequest.size        = missingData.cBytesMissing;
+        _downloadState.rgFillRequests.append(fillRequest);
+    }
+
+    if (!firstRequest) {
+        // Karn's rule, a reply to a request which has been sent again can't be timed
+        _rttSampleValid = false;
     }
 }
 
 void FTPManager::_fillMissingBlocksBegin(void)
 {
+    // Split the holes into blocks which fit in a single read so that several of them can be outstanding at once
+    MavlinkFTP::Request     request{};
+    const uint32_t          cMaxBlockBytes = sizeof(request.data);
+    QList<MissingData_t>    rgBlocks;
+    for (const MissingData_t& missingData: _downloadState.rgMissingData) {
+        for (uint32_t offset = missingData.offset; offset < missingData.offset + missingData.cBytesMissing; offset += cMaxBlockBytes) {
+            MissingData_t block;
+            block.offset        = offset;
+            block.cBytesMissing = qMin(cMaxBlockBytes, missingData.offset + missingData.cBytesMissing - offset);
+            rgBlocks.append(block);
+        }
+    }
+    _downloadState.rgMissingData = rgBlocks;
+    _downloadState.rgFillRequests.clear();
+    _downloadState.retryCount   = 0;
+    _fillWindowAcks             = 0;
+
     _fillMissingBlocksWorker(true /* firstRequest */);
 }
 
@@ -402,30 +709,39 @@ void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-        return;
-    }
     if (ackOrNak->hdr.session != _downloadState.sessionId) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    int fillRequestIndex = -1;
+    for (int i=0; i<_downloadState.rgFillRequests.count(); i++) {
+        if (_downloadState.rgFillRequests[i].seqNumber == ackOrNak->hdr.seqNumber) {
+            fillRequestIndex = i;
+            break;
+        }
+    }
+    if (fillRequestIndex == -1) {
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to sequence not outstanding actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+    FillRequest_t fillRequest = _downloadState.rgFillRequests.takeAt(fillRequestIndex);
+
+    // Any reply shows the vehicle is still there, give the remaining requests a full timeout
+    _downloadState.retryCount = 0;
+    if (_downloadState.rgFillRequests.isEmpty()) {
+        _ackOrNakTimeoutTimer.stop();
+    } else {
+        _ackOrNakTimeoutTimer.start();
+    }
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (++_downloadState.retryCount > _maxRetry) {
-                qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
-                _downloadComplete(tr("Download failed"));
-                return;
-            }
-
-            // Ask for current offset again
-            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-            _fillMissingBlocksWorker(false /* firstReqeust */);
+        if (ackOrNak->hdr.offset != fillRequest.offset || ackOrNak->hdr.size == 0 || ackOrNak->hdr.size > fillRequest.size) {
+            // The block stays missing and is asked for again
+            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack does not match request offset:size" << fillRequest.offset << fillRequest.size;
+            _fillMissingBlocksWorker(true /* firstRequest */);
             return;
         }
 
@@ -437,18 +753,30 @@ void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
         }
         _downloadState.bytesWritten += ackOrNak->hdr.size;
 
-        MissingData_t& missingData = _downloadState.rgMissingData.first();
-        missingData.offset += ackOrNak->hdr.size;
-        missingData.cBytesMissing -= ackOrNak->hdr.size;
-        if (missingData.cBytesMissing == 0) {
-            // This block is finished, remove it
-            _downloadState.rgMissingData.takeFirst();
+        for (int i=0; i<_downloadState.rgMissingData.count(); i++) {
+            MissingData_t& missingData = _downloadState.rgMissingData[i];
+            if (missingData.offset == fillRequest.offset) {
+                missingData.offset          += ackOrNak->hdr.size;
+                missingData.cBytesMissing   -= ackOrNak->hdr.size;
+                if (missingData.cBytesMissing == 0) {
+                    // This block is finished, remove it
+                    _downloadState.rgMissingData.removeAt(i);
+                }
+                break;
+            }
         }
+        _downloadDataReceived(ackOrNak->hdr.offset, ackOrNak->hdr.size);
 
         if (_downloadState.fileSize != 0) {
             emit commandProgress(100 * ((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize));
         }
 
+        // Open the window by one block each time a full window has come back
+        if (++_fillWindowAcks >= _fillWindow) {
+            _fillWindowAcks = 0;
+            _fillWindow     = qMin(_fillWindow + 1, _maxFillWindow);
+        }
+
         // Move on to fill in possible next hole
         _fillMissingBlocksWorker(true /* firstReqeust */);
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
@@ -475,8 +803,10 @@ void FTPManager::_fillMissingBlocksTimeout(void)
         qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout retries exceeded");
         _downloadComplete(tr("Download failed"));
     } else {
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
+        // Loss on the link, halve the window and ask for the outstanding blocks again
+        _fillWindow     = qMax(_fillWindow / 2, 1);
+        _fillWindowAcks = 0;
+        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) outstanding(%2) window(%3)").arg(_downloadState.retryCount).arg(_downloadState.rgFillRequests.count()).arg(_fillWindow);
         _fillMissingBlocksWorker(false /* firstReqeust */);
     }
 }
@@ -519,6 +849,476 @@ void FTPManager::_resetSessionsTimeout(void)
     _downloadComplete(QString());
 }
 
+void FTPManager::_downloadDataReceived(uint32_t offset, uint32_t size)
+{
+    _downloadState.receivedEnd      = qMax(_downloadState.receivedEnd, offset + size);
+    _downloadState.bytesSinceSave   += size;
+    _transferProgress(size);
+    if (_downloadState.resume && _downloadState.bytesSinceSave >= _partialSaveBytes) {
+        _savePartial();
+    }
+}
+
+QString FTPManager::_partialFilePath(void) const
+{
+    return _downloadState.toDir.absoluteFilePath(_downloadState.fileName + QStringLiteral(".partial"));
+}
+
+/// Writes the sidecar of a resumable download. The first line is the size of the file on the vehicle, followed by one
+/// "<offset> <length>" line per range which has been received.
+void FTPManager::_savePartial(void)
+{
+    _downloadState.bytesSinceSave = 0;
+
+    // The data has to be in the file before the sidecar says it is
+    if (!_downloadState.file.flush()) {
+        qCWarning(FTPManagerLog) << "_savePartial: flush failed" << _downloadState.file.errorString();
+        return;
+    }
+
+    QFile partialFile(_partialFilePath());
+    if (!partialFile.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)) {
+        qCWarning(FTPManagerLog) << "_savePartial: open failed" << partialFile.fileName() << partialFile.errorString();
+        return;
+    }
+
+    QTextStream stream(&partialFile);
+    stream << _downloadState.fileSize << "\n";
+
+    // Missing blocks are in offset order, everything between them up to receivedEnd has been received
+    uint32_t offset = 0;
+    for (const MissingData_t& missingData: _downloadState.rgMissingData) {
+        if (missingData.offset > offset) {
+            stream << offset << " " << missingData.offset - offset << "\n";
+        }
+        offset = missingData.offset + missingData.cBytesMissing;
+    }
+    if (_downloadState.receivedEnd > offset) {
+        stream << offset << " " << _downloadState.receivedEnd - offset << "\n";
+    }
+}
+
+/// Picks up the state of a previous download of the same file from its sidecar.
+/// @return true: download state restored, false: no usable sidecar, download from the start
+bool FTPManager::_loadPartial(void)
+{
+    QFile partialFile(_partialFilePath());
+    if (!_downloadState.file.exists() || !partialFile.open(QFile::ReadOnly | QFile::Text)) {
+        return false;
+    }
+
+    QTextStream stream(&partialFile);
+    bool        ok;
+    if (stream.readLine().toUInt(&ok) != _downloadState.fileSize || !ok) {
+        qCDebug(FTPManagerLog) << "_loadPartial: file size changed, starting over";
+        return false;
+    }
+
+    QList<MissingData_t>    rgMissingData;
+    uint32_t                receivedEnd     = 0;
+    uint32_t                bytesWritten    = 0;
+    while (!stream.atEnd()) {
+        QStringList range = stream.readLine().split(' ');
+        bool        offsetOk = false;
+        bool        lengthOk = false;
+        uint32_t    offset = range.value(0).toUInt(&offsetOk);
+        uint32_t    length = range.value(1).toUInt(&lengthOk);
+        if (range.count() != 2 || !offsetOk || !lengthOk || offset < receivedEnd || static_cast<quint64>(offset) + length > _downloadState.fileSize) {
+            qCDebug(FTPManagerLog) << "_loadPartial: invalid range, starting over" << range;
+            return false;
+        }
+
+        if (offset > receivedEnd) {
+            MissingData_t missingData;
+            missingData.offset          = receivedEnd;
+            missingData.cBytesMissing   = offset - receivedEnd;
+            rgMissingData.append(missingData);
+        }
+        receivedEnd     = offset + length;
+        bytesWritten    += length;
+    }
+    if (_downloadState.file.size() < receivedEnd) {
+        qCDebug(FTPManagerLog) << "_loadPartial: file is shorter than the received data, starting over";
+        return false;
+    }
+
+    _downloadState.rgMissingData    = rgMissingData;
+    _downloadState.receivedEnd      = receivedEnd;
+    _downloadState.expectedOffset   = receivedEnd;
+    _downloadState.bytesWritten     = bytesWritten;
+    return true;
+}
+
+void FTPManager::_createFileBegin(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdCreateFile;
+    request.hdr.offset  = 0;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _uploadState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_createFileTimeout(void)
+{
+    qCDebug(FTPManagerLog) << "_createFileTimeout";
+    _uploadComplete(tr("Upload failed"));
+}
+
+void FTPManager::_createFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdCreateFile) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack - sessionId" << ackOrNak->hdr.session;
+        _uploadState.sessionId  = ackOrNak->hdr.session;
+        _uploadState.offset     = 0;
+        _advanceStateMachine();
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _uploadComplete(tr("Upload failed"));
+    }
+}
+
+void FTPManager::_writeFileWorker(bool firstRequest)
+{
+    if (_uploadState.offset >= static_cast<uint32_t>(_uploadState.data.size())) {
+        _advanceStateMachine();
+        return;
+    }
+    if (firstRequest && _deferForBudget(&FTPManager::_writeFileBegin)) {
+        return;
+    }
+
+    MavlinkFTP::Request request{};
+    uint32_t            cBytesToWrite = qMin((uint32_t)sizeof(request.data), static_cast<uint32_t>(_uploadState.data.size()) - _uploadState.offset);
+
+    qCDebug(FTPManagerLog) << "_writeFileWorker: offset:cBytesToWrite:firstRequest:retryCount" << _uploadState.offset << cBytesToWrite << firstRequest << _uploadState.retryCount;
+
+    request.hdr.session = _uploadState.sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdWriteFile;
+    request.hdr.offset  = _uploadState.offset;
+    request.hdr.size    = static_cast<uint8_t>(cBytesToWrite);
+    memcpy(request.data, _uploadState.data.constData() + _uploadState.offset, cBytesToWrite);
+
+    if (firstRequest) {
+        _uploadState.retryCount = 0;
+    } else {
+        // Must used same sequence number as previous request
+        _expectedIncomingSeqNumber -= 2;
+    }
+
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_writeFileBegin(void)
+{
+    _writeFileWorker(true /* firstRequest */);
+}
+
+void FTPManager::_writeFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    if (requestOpCode != MavlinkFTP::kCmdWriteFile) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+    if (ackOrNak->hdr.session != _uploadState.sessionId) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _uploadState.sessionId;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        uint32_t cBytesWritten = qMin((uint32_t)sizeof(ackOrNak->data), static_cast<uint32_t>(_uploadState.data.size()) - _uploadState.offset);
+
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Ack offset:size" << _uploadState.offset << cBytesWritten;
+
+        _uploadState.offset += cBytesWritten;
+        _transferProgress(cBytesWritten);
+        if (_uploadState.data.size() != 0) {
+            emit commandProgress(100 * ((float)_uploadState.offset / (float)_uploadState.data.size()));
+        }
+
+        // Move on to the next block
+        _writeFileWorker(true /* firstRequest */);
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _uploadComplete(tr("Upload failed"));
+    }
+}
+
+void FTPManager::_writeFileTimeout(void)
+{
+    if (++_uploadState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_writeFileTimeout retries exceeded");
+        _uploadComplete(tr("Upload failed"));
+    } else {
+        // Write the current block again
+        qCDebug(FTPManagerLog) << QString("_writeFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_uploadState.retryCount).arg(_uploadState.offset);
+        _writeFileWorker(false /* firstReqeust */);
+    }
+}
+
+void FTPManager::_terminateSessionBegin(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = _uploadState.sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
+    request.hdr.size    = 0;
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_terminateSessionAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    if (requestOpCode != MavlinkFTP::kCmdTerminateSession) {
+        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Ack";
+        _advanceStateMachine();
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        // The file is only taken on by the vehicle once it is closed, so a failure here fails the upload
+        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _uploadComplete(tr("Upload failed"));
+    }
+}
+
+void FTPManager::_terminateSessionTimeout(void)
+{
+    qCDebug(FTPManagerLog) << "_terminateSessionTimeout";
+    _uploadComplete(tr("Upload failed"));
+}
+
+void FTPManager::_listDirectoryWorker(bool firstRequest)
+{
+    qCDebug(FTPManagerLog) << "_listDirectoryWorker: offset:firstRequest:retryCount" << _listDirectoryState.expectedOffset << firstRequest << _listDirectoryState.retryCount;
+
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdListDirectory;
+    request.hdr.offset  = _listDirectoryState.expectedOffset;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _listDirectoryState.fullPathOnVehicle);
+
+    if (firstRequest) {
+        _listDirectoryState.retryCount = 0;
+    } else {
+        // Must used same sequence number as previous request
+        _expectedIncomingSeqNumber -= 2;
+    }
+
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_listDirectoryBegin(void)
+{
+    _listDirectoryWorker(true /* firstRequest */);
+}
+
+void FTPManager::_listDirectoryAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    if (requestOpCode != MavlinkFTP::kCmdListDirectory) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        // Entries are null terminated, the offset of the next request is the index of the next entry
+        const char* data        = reinterpret_cast<const char*>(ackOrNak->data);
+        int         size        = qMin(static_cast<int>(ackOrNak->hdr.size), static_cast<int>(sizeof(ackOrNak->data)));
+        int         cEntries    = 0;
+        int         pos         = 0;
+        while (pos < size) {
+            int length = static_cast<int>(strnlen(data + pos, size - pos));
+            if (length) {
+                _listDirectoryState.rgDirectoryList.append(QString::fromUtf8(data + pos, length));
+                cEntries++;
+            }
+            pos += length + 1;
+        }
+
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Ack offset:cEntries" << ackOrNak->hdr.offset << cEntries;
+
+        if (cEntries == 0) {
+            _advanceStateMachine();
+        } else {
+            _listDirectoryState.expectedOffset += cEntries;
+            _listDirectoryWorker(true /* firstRequest */);
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        if (errorCode == MavlinkFTP::kErrEOF) {
+            // All entries have been listed
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak EOF";
+            _advanceStateMachine();
+        } else {
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+            _listDirectoryComplete(tr("List directory failed: %1").arg(_errorMsgFromNak(ackOrNak)));
+        }
+    }
+}
+
+void FTPManager::_listDirectoryTimeout(void)
+{
+    if (++_listDirectoryState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout retries exceeded");
+        _listDirectoryComplete(tr("List directory failed"));
+    } else {
+        // Ask for the same entries again
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout: retrying - retryCount(%1) offset(%2)").arg(_listDirectoryState.retryCount).arg(_listDirectoryState.expectedOffset);
+        _listDirectoryWorker(false /* firstReqeust */);
+    }
+}
+
+void FTPManager::setBandwidthBudget(int bytesPerSecond)
+{
+    qCDebug(FTPManagerLog) << "setBandwidthBudget" << bytesPerSecond;
+
+    _budgetBytesPerSecond   = qMax(0, bytesPerSecond);
+    _budgetBytes            = _budgetBytesPerSecond;
+    _budgetRefillTimer.start();
+}
+
+void FTPManager::_consumeBudget(uint32_t bytes)
+{
+    if (_budgetBytesPerSecond > 0) {
+        _budgetBytes -= bytes;
+    }
+}
+
+/// Holds back the next data request while the budget is overdrawn. A burst can't be cut short once it has been asked
+/// for, so the budget is kept on average by spacing out the requests.
+///     @param resumeFn Called to send the request once the budget allows it
+/// @return true: request held back, false: send it now
+bool FTPManager::_deferForBudget(StateBeginFn resumeFn)
+{
+    if (_budgetBytesPerSecond <= 0) {
+        return false;
+    }
+
+    // At most one second worth of budget can be saved up
+    _budgetBytes = qMin(_budgetBytes + (_budgetRefillTimer.restart() * _budgetBytesPerSecond / 1000.0), static_cast<double>(_budgetBytesPerSecond));
+    if (_budgetBytes >= 0) {
+        return false;
+    }
+
+    int delayMsecs = qCeil(-_budgetBytes * 1000.0 / _budgetBytesPerSecond);
+    qCDebug(FTPManagerLog) << "_deferForBudget: holding back request msecs" << delayMsecs;
+    _budgetResumeFn = resumeFn;
+    _budgetDelayTimer.start(delayMsecs);
+    return true;
+}
+
+void FTPManager::_budgetDelayTimeout(void)
+{
+    StateBeginFn resumeFn = _budgetResumeFn;
+
+    _budgetResumeFn = nullptr;
+    if (resumeFn) {
+        (this->*resumeFn)();
+    }
+}
+
+void FTPManager::_transferStarted(const QString& file)
+{
+    _transferFile               = file;
+    _transferBytes              = 0;
+    _transferLastReportMSecs    = 0;
+    _transferTimer.start();
+}
+
+void FTPManager::_transferProgress(uint32_t bytes)
+{
+    _transferBytes += bytes;
+    _consumeBudget(bytes);
+
+    qint64 elapsed = _transferTimer.elapsed();
+    if (elapsed - _transferLastReportMSecs >= _throughputReportMsecs) {
+        _transferLastReportMSecs = elapsed;
+        emit throughputReport(_transferFile, _transferBytes, _transferBytes * 1000.0 / elapsed);
+    }
+}
+
+void FTPManager::_transferComplete(void)
+{
+    if (_transferFile.isEmpty()) {
+        return;
+    }
+
+    // Cleared before signalling since a new transfer may be started from the signal
+    QString file            = _transferFile;
+    quint64 bytes           = _transferBytes;
+    qint64  elapsed         = qMax(_transferTimer.elapsed(), static_cast<qint64>(1));
+    double  bytesPerSecond  = bytes * 1000.0 / elapsed;
+    _transferFile.clear();
+
+    qCDebug(FTPManagerLog) << "_transferComplete: file:bytes:msecs:bytesPerSecond" << file << bytes << elapsed << bytesPerSecond;
+    emit throughputReport(file, bytes, bytesPerSecond);
+}
+
+/// Updates the smoothed round trip time and its variation from a new sample. The ack timeout follows them the same way
+/// as the TCP retransmission timeout does (RFC 6298).
+void FTPManager::_addRttSample(qint64 msecs)
+{
+    if (!_rttHaveSample) {
+        _rttHaveSample  = true;
+        _srttMSecs      = msecs;
+        _rttVarMSecs    = msecs / 2.0;
+    } else {
+        _rttVarMSecs    = (0.75 * _rttVarMSecs) + (0.25 * qAbs(_srttMSecs - msecs));
+        _srttMSecs      = (0.875 * _srttMSecs) + (0.125 * msecs);
+    }
+    _rtoMSecs = qBound(_minAckOrNakTimeoutMsecs, qRound(_srttMSecs + (4 * _rttVarMSecs)), _maxAckOrNakTimeoutMsecs);
+    _updateAckOrNakTimeout();
+
+    qCDebug(FTPManagerLog) << "_addRttSample: rtt:srtt:rttvar:rto" << msecs << _srttMSecs << _rttVarMSecs << _rtoMSecs;
+}
+
+void FTPManager::_updateAckOrNakTimeout(void)
+{
+    // Unit tests keep the short fixed timeout
+    if (!qgcApp()->runningUnitTests()) {
+        _ackOrNakTimeoutTimer.setInterval(_rtoMSecs);
+    }
+}
+
 void FTPManager::_emitErrorMessage(const QString& msg)
 {
     qCDebug(FTPManagerLog) << "Error:" << msg;
@@ -528,18 +1328,28 @@ void FTPManager::_emitErrorMessage(const QString& msg)
 void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
     _ackOrNakTimeoutTimer.start();
-    
+    _sendRequest(request);
+}
+
+void FTPManager::_sendRequest(MavlinkFTP::Request* request)
+{
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+        qCDebug(FTPManagerLog) << "_sendRequest No primary link. Allowing timeout to fail sequence.";
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
         _expectedIncomingSeqNumber += 2;
 
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
+        // Karn's rule, a request sent again with the same sequence number can't be timed since the ack may be for either
+        _rttSampleValid         = request->hdr.seqNumber != _lastRequestSeqNumber;
+        _rttSampleSeqNumber     = _expectedIncomingSeqNumber;
+        _rttSampleSentMSecs     = _rttClock.elapsed();
+        _lastRequestSeqNumber   = request->hdr.seqNumber;
+
+        qCDebug(FTPManagerLog) << "_sendRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
 
         mavlink_message_t message;
         mavlink_msg_file_transfer_protocol_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
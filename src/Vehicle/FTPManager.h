@@ -13,6 +13,7 @@
 #include <QDir>
 #include <QTimer>
 #include <QQueue>
+#include <QElapsedTimer>
 
 #include "UASInterface.h"
 #include "QGCLoggingCategory.h"
@@ -22,6 +23,12 @@ Q_DECLARE_LOGGING_CATEGORY(FTPManagerLog)
 
 class Vehicle;
 
+/// MAVLink FTP client for a vehicle.
+///
+/// Downloads, uploads and directory listings can be requested at any time. The autopilot FTP servers only run a single
+/// session and pair each ack with the last request by sequence number, so one transfer runs at a time and the others
+/// wait in a queue in the order they were requested. Completion signals carry the local file so clients can pick out
+/// their own transfer.
 class FTPManager : public QObject
 {
     Q_OBJECT
@@ -35,14 +42,48 @@ public:
     ///     @param fromURI  File to download from vehicle, fully qualified path. May be in the format "mftp://[;comp=<id>]..." where the component id is specified.
     ///                     If component id is not specified MAV_COMP_ID_AUTOPILOT1 is used.
     ///     @param toDir    Local directory to download file to
-    /// @return true: download has started, false: error, no download
+    ///     @param resume   true: Keep what was received when the download fails and pick up from there next time. The
+    ///                     received ranges are recorded in a <file>.partial sidecar next to the file.
+    /// @return true: download has started or is queued, false: error, no download
     /// Signals downloadComplete, commandError, commandProgress
-    bool download(const QString& fromURI, const QString& toDir);
+    bool download(const QString& fromURI, const QString& toDir, bool resume = false);
+
+    /// Stops the download of the specified file, whether it is in progress or queued. Signals downloadComplete with an
+    /// error, a resumable download keeps its partial file.
+    void cancelDownload(const QString& fromURI);
+
+    /// Lists the contents of the specified directory.
+    ///     @param fromURI  Directory on the vehicle, same format as for download.
+    /// @return true: listing has started or is queued, false: error, no listing
+    /// Signals listDirectoryComplete
+    bool listDirectory(const QString& fromURI);
+
+    /// Uploads the specified file.
+    ///     @param fromFile Local file to upload
+    ///     @param toURI    File to write on the vehicle, fully qualified path. Same format as for download.
+    /// @return true: upload has started or is queued, false: error, no upload
+    /// Signals uploadComplete, commandProgress
+    bool upload(const QString& fromFile, const QString& toURI);
+
+    /// Limits the average rate of file data going through FTP so it leaves room for telemetry on the link.
+    ///     @param bytesPerSecond 0 for no limit
+    void setBandwidthBudget(int bytesPerSecond);
+    int  bandwidthBudget   (void) const { return _budgetBytesPerSecond; }
 
     static const char* mavlinkFTPScheme;
 
 signals:
     void downloadComplete(const QString& file, const QString& errorMsg);
+    void uploadComplete(const QString& file, const QString& errorMsg);
+
+    /// @param dirList Entries as sent by the vehicle: "F<name>\t<size>" for files, "D<name>" for directories, "S" for skipped entries
+    void listDirectoryComplete(const QStringList& dirList, const QString& errorMsg);
+
+    /// Signalled about once a second while a file is transferred and once more when it is complete
+    ///     @param file             Local file
+    ///     @param bytes            Bytes transferred so far
+    ///     @param bytesPerSecond   Average rate since the transfer started
+    void throughputReport(const QString& file, quint64 bytes, double bytesPerSecond);
     
     // Signals associated with all commands
     
@@ -57,6 +98,7 @@ signals:
 	
 private slots:
     void _ackOrNakTimeout(void);
+    void _budgetDelayTimeout(void);
 
 private:
     typedef void (FTPManager::*StateBeginFn)            (void);
@@ -74,17 +116,27 @@ private:
         uint32_t cBytesMissing;
     } MissingData_t;
 
+    typedef struct {
+        uint16_t seqNumber;                             ///< Sequence number of the reply
+        uint32_t offset;
+        uint32_t size;
+    } FillRequest_t;
+
     typedef struct {
         uint8_t                 sessionId;
         uint32_t                expectedOffset;         ///< offset which should be coming next
         uint32_t                bytesWritten;
-        QList<MissingData_t>    rgMissingData;
+        QList<MissingData_t>    rgMissingData;          ///< In offset order
+        QList<FillRequest_t>    rgFillRequests;         ///< Reads outstanding while filling in missing data
         QString                 fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
         QDir                    toDir;                  ///< Directory to download file to
         QString                 fileName;               ///< Filename (no path) for download file
         uint32_t                fileSize;               ///< Size of file being downloaded
         QFile                   file;
         int                     retryCount;
+        bool                    resume;                 ///< Keep the partial file on failure
+        uint32_t                receivedEnd;            ///< End of the furthest data received, everything before it is received unless it is in rgMissingData
+        uint32_t                bytesSinceSave;         ///< Bytes received since the sidecar was last written
 
         void reset() {
             sessionId       = 0;
@@ -92,15 +144,70 @@ private:
             bytesWritten    = 0;
             retryCount      = 0;
             fileSize        = 0;
+            resume          = false;
+            receivedEnd     = 0;
+            bytesSinceSave  = 0;
             fullPathOnVehicle.clear();
             fileName.clear();
             rgMissingData.clear();
+            rgFillRequests.clear();
             file.close();
         }
     } DownloadState_t;
 
+    typedef enum {
+        OperationDownload,
+        OperationUpload,
+        OperationListDirectory,
+    } OperationType_t;
+
+    typedef struct {
+        OperationType_t type;
+        QString         fromPath;           ///< URI for download and list directory, local file for upload
+        QString         toPath;             ///< Local directory for download, URI for upload
+        bool            resume;
+    } Operation_t;
+
+    typedef struct {
+        QString     fullPathOnVehicle;      ///< Fully qualified path to directory on vehicle
+        uint32_t    expectedOffset;         ///< Index of the next entry to list
+        QStringList rgDirectoryList;
+        int         retryCount;
+
+        void reset() {
+            expectedOffset  = 0;
+            retryCount      = 0;
+            fullPathOnVehicle.clear();
+            rgDirectoryList.clear();
+        }
+    } ListDirectoryState_t;
+
+    typedef struct {
+        uint8_t     sessionId;
+        uint32_t    offset;                 ///< offset of the next block to write
+        QString     fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
+        QString     localFile;              ///< File being uploaded
+        QByteArray  data;                   ///< Contents of the file being uploaded
+        int         retryCount;
+
+        void reset() {
+            sessionId   = 0;
+            offset      = 0;
+            retryCount  = 0;
+            fullPathOnVehicle.clear();
+            localFile.clear();
+            data.clear();
+        }
+    } UploadState_t;
+
 
     void    _mavlinkMessageReceived     (const mavlink_message_t& message);
+    bool    _startDownload              (const QString& fromURI, const QString& toDir, bool resume);
+    bool    _startUpload                (const QString& fromFile, const QString& toURI);
+    bool    _startListDirectory         (const QString& fromURI);
+    void    _startNextOperation         (void);
+    void    _stopStateMachine           (void);
+    bool    _busy                       (void) const { return !_rgStateMachine.isEmpty() || !_operationQueue.isEmpty(); }
     void    _startStateMachine          (void);
     void    _advanceStateMachine        (void);
     void    _openFileROBegin            (void);
@@ -112,28 +219,88 @@ private:
     void    _fillMissingBlocksBegin     (void);
     void    _fillMissingBlocksAckOrNak  (const MavlinkFTP::Request* ackOrNak);
     void    _fillMissingBlocksTimeout   (void);
+    void    _fillMissingBlocksNext      (void) { _fillMissingBlocksWorker(true /* firstRequest */); }
     void    _resetSessionsBegin         (void);
     void    _resetSessionsAckOrNak      (const MavlinkFTP::Request* ackOrNak);
     void    _resetSessionsTimeout       (void);
+    void    _createFileBegin            (void);
+    void    _createFileAckOrNak         (const MavlinkFTP::Request* ackOrNak);
+    void    _createFileTimeout          (void);
+    void    _writeFileBegin             (void);
+    void    _writeFileAckOrNak          (const MavlinkFTP::Request* ackOrNak);
+    void    _writeFileTimeout           (void);
+    void    _terminateSessionBegin      (void);
+    void    _terminateSessionAckOrNak   (const MavlinkFTP::Request* ackOrNak);
+    void    _terminateSessionTimeout    (void);
+    void    _listDirectoryBegin         (void);
+    void    _listDirectoryAckOrNak      (const MavlinkFTP::Request* ackOrNak);
+    void    _listDirectoryTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
+    void    _sendRequest                (MavlinkFTP::Request* request);
     void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
     void    _downloadComplete           (const QString& errorMsg);
+    void    _uploadCompleteNoError      (void) { _uploadComplete(QString()); }
+    void    _uploadComplete             (const QString& errorMsg);
+    void    _listDirectoryCompleteNoError(void) { _listDirectoryComplete(QString()); }
+    void    _listDirectoryComplete      (const QString& errorMsg);
     void    _emitErrorMessage           (const QString& msg);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
     void    _fillMissingBlocksWorker    (bool firstRequest);
     void    _burstReadFileWorker        (bool firstRequest);
+    void    _writeFileWorker            (bool firstRequest);
+    void    _listDirectoryWorker        (bool firstRequest);
+    void    _downloadDataReceived       (uint32_t offset, uint32_t size);
+    QString _partialFilePath            (void) const;
+    void    _savePartial                (void);
+    bool    _loadPartial                (void);
+    void    _transferStarted            (const QString& file);
+    void    _transferProgress           (uint32_t bytes);
+    void    _transferComplete           (void);
+    bool    _deferForBudget             (StateBeginFn resumeFn);
+    void    _consumeBudget              (uint32_t bytes);
+    void    _addRttSample               (qint64 msecs);
+    void    _updateAckOrNakTimeout      (void);
     bool    _parseURI                   (const QString& uri, QString& parsedURI, uint8_t& compId);
 
     Vehicle*                _vehicle;
     uint8_t                 _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
     QList<StateFunctions_t> _rgStateMachine;
     DownloadState_t         _downloadState;
+    UploadState_t           _uploadState;
+    ListDirectoryState_t    _listDirectoryState;
+    QQueue<Operation_t>     _operationQueue;            ///< Operations waiting for the current one to complete
+    QString                 _currentDownloadURI;        ///< URI of the download in progress, empty if none
     QTimer                  _ackOrNakTimeoutTimer;
+    QTimer                  _budgetDelayTimer;          ///< Holds back the next data request until the budget allows it
+    StateBeginFn            _budgetResumeFn             = nullptr;
+    int                     _budgetBytesPerSecond       = 0;
+    double                  _budgetBytes                = 0;    ///< Bytes which can go through before the budget is used up, negative when overdrawn
+    QElapsedTimer           _budgetRefillTimer;
+    QString                 _transferFile;              ///< Local file of the transfer in progress, empty if none
+    quint64                 _transferBytes              = 0;
+    QElapsedTimer           _transferTimer;
+    qint64                  _transferLastReportMSecs    = 0;
+    QElapsedTimer           _rttClock;
+    bool                    _rttSampleValid             = false;    ///< The ack to the last request is being timed
+    uint16_t                _rttSampleSeqNumber         = 0;
+    qint64                  _rttSampleSentMSecs         = 0;
+    uint16_t                _lastRequestSeqNumber       = 0;
+    bool                    _rttHaveSample              = false;
+    double                  _srttMSecs                  = 0;        ///< Smoothed round trip time
+    double                  _rttVarMSecs                = 0;        ///< Round trip time variation
+    int                     _rtoMSecs                   = _ackOrNakTimeoutMsecs;
+    int                     _fillWindow                 = 1;        ///< Reads kept outstanding while filling in missing data
+    int                     _fillWindowAcks             = 0;
     int                     _currentStateMachineIndex   = -1;
     uint16_t                _expectedIncomingSeqNumber  = 0;
     
-    static const int _ackOrNakTimeoutMsecs  = 1000;
-    static const int _maxRetry              = 3;
+    static const int _ackOrNakTimeoutMsecs      = 1000;     ///< Until the round trip time has been measured
+    static const int _minAckOrNakTimeoutMsecs   = 200;
+    static const int _maxAckOrNakTimeoutMsecs   = 10000;
+    static const int _maxFillWindow             = 16;
+    static const int _maxRetry                  = 3;
+    static const int _partialSaveBytes      = 64 * 1024;    ///< How often the sidecar of a resumable download is brought up to date
+    static const int _throughputReportMsecs = 1000;
 };
 
@@ -0,0 +1,424 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactTelemetryLog.h"
+#include "Fact.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTime>
+#include <QtEndian>
+#include <QtNumeric>
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(FactTelemetryLogLog, "FactTelemetryLogLog")
+
+const char* FactTelemetryLog::fileExtension = "qgctl";
+
+void FactTelemetryLogWriter::open(const QString& fileName, const QByteArray& header)
+{
+    close();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly) || _file.write(header) != header.size()) {
+        qCWarning(FactTelemetryLogLog) << "Unable to open telemetry log" << fileName << _file.errorString();
+        _file.close();
+        emit openFailed();
+    }
+}
+
+void FactTelemetryLogWriter::write(int rowCount, const QByteArray& block)
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    QByteArray  compressed = qCompress(block);
+    uchar       blockHeader[8];
+    qToLittleEndian<quint32>(static_cast<quint32>(rowCount),            blockHeader);
+    qToLittleEndian<quint32>(static_cast<quint32>(compressed.size()),   blockHeader + 4);
+
+    if (_file.write(reinterpret_cast<const char*>(blockHeader), sizeof(blockHeader)) != sizeof(blockHeader) || _file.write(compressed) != compressed.size()) {
+        qCWarning(FactTelemetryLogLog) << "Telemetry log write failed, closing" << _file.fileName() << _file.errorString();
+        _file.close();
+    }
+}
+
+void FactTelemetryLogWriter::close(void)
+{
+    if (_file.isOpen()) {
+        _file.close();
+    }
+}
+
+FactTelemetryLog::FactTelemetryLog(QObject* parent)
+    : QObject   (parent)
+    , _writer   (new FactTelemetryLogWriter)
+{
+    _writerThread.setObjectName(QStringLiteral("FactTelemetryLog"));
+    _writer->moveToThread(&_writerThread);
+    connect(&_writerThread, &QThread::finished, _writer, &QObject::deleteLater);
+    connect(_writer, &FactTelemetryLogWriter::openFailed, this, &FactTelemetryLog::_openFailed);
+}
+
+FactTelemetryLog::~FactTelemetryLog()
+{
+    if (_writerThread.isRunning()) {
+        _flush();
+        QMetaObject::invokeMethod(_writer, "close", Qt::BlockingQueuedConnection);
+        _writerThread.quit();
+        _writerThread.wait();
+    } else {
+        delete _writer;
+    }
+}
+
+void FactTelemetryLog::start(const QString& fileName, const QStringList& names, const QList<Fact*>& facts)
+{
+    stop();
+
+    QByteArray header(_headerSize, 0);
+    uchar* headerData = reinterpret_cast<uchar*>(header.data());
+    qToLittleEndian<quint32>(_magic,                                headerData);
+    qToLittleEndian<quint32>(_version,                              headerData + 4);
+    qToLittleEndian<quint32>(static_cast<quint32>(facts.count()),   headerData + 8);
+
+    _columns.resize(facts.count());
+    for (int i=0; i<facts.count(); i++) {
+        Fact*       fact = facts[i];
+        QByteArray  name = names[i].toUtf8().left(255);
+
+        _columns[i].fact    = fact;
+        _columns[i].type    = fact->type();
+        _columns[i].values.clear();
+
+        header.append(static_cast<char>(fact->type()));
+        header.append(static_cast<char>(qBound(-1, fact->decimalPlaces(), 127)));
+        header.append(static_cast<char>(name.length()));
+        header.append(name);
+    }
+    _timestamps.clear();
+    _rowCount = 0;
+
+    if (!_writerThread.isRunning()) {
+        _writerThread.start(QThread::LowPriority);
+    }
+    QMetaObject::invokeMethod(_writer, "open", Qt::QueuedConnection, Q_ARG(QString, fileName), Q_ARG(QByteArray, header));
+    _open = true;
+
+    qCDebug(FactTelemetryLogLog) << "Telemetry log started" << fileName << names;
+}
+
+void FactTelemetryLog::sample(qint64 msecsSinceEpoch)
+{
+    if (!_open) {
+        return;
+    }
+
+    int offset = _timestamps.size();
+    _timestamps.resize(offset + static_cast<int>(sizeof(qint64)));
+    qToLittleEndian<qint64>(msecsSinceEpoch, _timestamps.data() + offset);
+
+    for (Column_t& column: _columns) {
+        _appendValue(column.values, column.type, column.fact ? column.fact->rawValue() : QVariant());
+    }
+
+    if (++_rowCount >= _rowsPerBlock) {
+        _flush();
+    }
+}
+
+void FactTelemetryLog::stop(void)
+{
+    if (!_open) {
+        return;
+    }
+
+    _flush();
+    QMetaObject::invokeMethod(_writer, "close", Qt::QueuedConnection);
+    _open = false;
+    _columns.clear();
+}
+
+void FactTelemetryLog::_openFailed(void)
+{
+    _open = false;
+    _columns.clear();
+    _timestamps.clear();
+    _rowCount = 0;
+}
+
+void FactTelemetryLog::_flush(void)
+{
+    if (!_open || _rowCount == 0) {
+        return;
+    }
+
+    int blockSize = _timestamps.size();
+    for (const Column_t& column: _columns) {
+        blockSize += column.values.size();
+    }
+
+    QByteArray block;
+    block.reserve(blockSize);
+    block.append(_timestamps);
+    for (Column_t& column: _columns) {
+        block.append(column.values);
+        column.values.resize(0);
+    }
+    QMetaObject::invokeMethod(_writer, "write", Qt::QueuedConnection, Q_ARG(int, _rowCount), Q_ARG(QByteArray, block));
+
+    _timestamps.resize(0);
+    _rowCount = 0;
+}
+
+template <typename T>
+static void _appendLittleEndian(QByteArray& bytes, T value)
+{
+    int offset = bytes.size();
+    bytes.resize(offset + static_cast<int>(sizeof(T)));
+    qToLittleEndian<T>(value, bytes.data() + offset);
+}
+
+/// An invalid value, which is what a Fact which has gone away gives, is written as NaN for real numbers and 0 for
+/// everything else
+void FactTelemetryLog::_appendValue(QByteArray& bytes, FactMetaData::ValueType_t type, const QVariant& value)
+{
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+    case FactMetaData::valueTypeBool:
+        bytes.append(static_cast<char>(value.toUInt()));
+        break;
+    case FactMetaData::valueTypeInt8:
+        bytes.append(static_cast<char>(value.toInt()));
+        break;
+    case FactMetaData::valueTypeUint16:
+        _appendLittleEndian<quint16>(bytes, static_cast<quint16>(value.toUInt()));
+        break;
+    case FactMetaData::valueTypeInt16:
+        _appendLittleEndian<qint16>(bytes, static_cast<qint16>(value.toInt()));
+        break;
+    case FactMetaData::valueTypeUint32:
+        _appendLittleEndian<quint32>(bytes, value.toUInt());
+        break;
+    case FactMetaData::valueTypeInt32:
+        _appendLittleEndian<qint32>(bytes, value.toInt());
+        break;
+    case FactMetaData::valueTypeUint64:
+        _appendLittleEndian<quint64>(bytes, value.toULongLong());
+        break;
+    case FactMetaData::valueTypeInt64:
+        _appendLittleEndian<qint64>(bytes, value.toLongLong());
+        break;
+    case FactMetaData::valueTypeFloat:
+    {
+        float   floatValue = value.isValid() ? value.toFloat() : qQNaN();
+        quint32 bits;
+        memcpy(&bits, &floatValue, sizeof(bits));
+        _appendLittleEndian<quint32>(bytes, bits);
+        break;
+    }
+    case FactMetaData::valueTypeDouble:
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+    {
+        double  doubleValue = value.isValid() ? value.toDouble() : qQNaN();
+        quint64 bits;
+        memcpy(&bits, &doubleValue, sizeof(bits));
+        _appendLittleEndian<quint64>(bytes, bits);
+        break;
+    }
+    default:
+    {
+        QByteArray utf8 = value.toString().toUtf8().left(0xFFFF);
+        _appendLittleEndian<quint16>(bytes, static_cast<quint16>(utf8.length()));
+        bytes.append(utf8);
+        break;
+    }
+    }
+}
+
+/// Reads one value and formats it the same way Fact::cookedValueString does
+QString FactTelemetryLog::_valueString(const uchar*& data, const uchar* end, FactMetaData::ValueType_t type, int decimalPlaces, bool& ok)
+{
+    size_t valueSize;
+    switch (type) {
+    case FactMetaData::valueTypeBool:
+        valueSize = 1;
+        break;
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+        valueSize = sizeof(double);
+        break;
+    case FactMetaData::valueTypeString:
+    case FactMetaData::valueTypeCustom:
+        if (end - data < 2) {
+            ok = false;
+            return QString();
+        }
+        valueSize = 2 + qFromLittleEndian<quint16>(data);
+        break;
+    default:
+        valueSize = FactMetaData::typeToSize(type);
+        break;
+    }
+    if (valueSize == 0 || end - data < static_cast<qint64>(valueSize)) {
+        ok = false;
+        return QString();
+    }
+
+    const uchar* value = data;
+    data += valueSize;
+    ok = true;
+
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+        return QString::number(*value);
+    case FactMetaData::valueTypeInt8:
+        return QString::number(static_cast<qint8>(*value));
+    case FactMetaData::valueTypeUint16:
+        return QString::number(qFromLittleEndian<quint16>(value));
+    case FactMetaData::valueTypeInt16:
+        return QString::number(qFromLittleEndian<qint16>(value));
+    case FactMetaData::valueTypeUint32:
+        return QString::number(qFromLittleEndian<quint32>(value));
+    case FactMetaData::valueTypeInt32:
+        return QString::number(qFromLittleEndian<qint32>(value));
+    case FactMetaData::valueTypeUint64:
+        return QString::number(qFromLittleEndian<quint64>(value));
+    case FactMetaData::valueTypeInt64:
+        return QString::number(qFromLittleEndian<qint64>(value));
+    case FactMetaData::valueTypeBool:
+        return *value ? QStringLiteral("true") : QStringLiteral("false");
+    case FactMetaData::valueTypeFloat:
+    {
+        quint32 bits = qFromLittleEndian<quint32>(value);
+        float   floatValue;
+        memcpy(&floatValue, &bits, sizeof(floatValue));
+        return qIsNaN(floatValue) ? QStringLiteral("--.--") : QString("%1").arg(floatValue, 0, 'f', decimalPlaces);
+    }
+    case FactMetaData::valueTypeDouble:
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+    {
+        quint64 bits = qFromLittleEndian<quint64>(value);
+        double  doubleValue;
+        memcpy(&doubleValue, &bits, sizeof(doubleValue));
+        if (type == FactMetaData::valueTypeElapsedTimeInSeconds) {
+            return qIsNaN(doubleValue) ? QStringLiteral("--:--:--") : QTime(0, 0, 0, 0).addSecs(static_cast<int>(doubleValue)).toString(QStringLiteral("hh:mm:ss"));
+        }
+        return qIsNaN(doubleValue) ? QStringLiteral("--.--") : QString("%1").arg(doubleValue, 0, 'f', decimalPlaces);
+    }
+    default:
+        return QString::fromUtf8(reinterpret_cast<const char*>(value + 2), static_cast<int>(valueSize - 2));
+    }
+}
+
+bool FactTelemetryLog::exportToCsv(const QString& logFileName, const QString& csvFileName, QString& errorString)
+{
+    typedef struct {
+        FactMetaData::ValueType_t   type;
+        int                         decimalPlaces;
+    } ColumnInfo_t;
+
+    QFile logFile(logFileName);
+    if (!logFile.open(QIODevice::ReadOnly)) {
+        errorString = tr("Unable to open %1: %2").arg(logFileName, logFile.errorString());
+        return false;
+    }
+
+    QByteArray      header  = logFile.read(_headerSize);
+    const uchar*    data    = reinterpret_cast<const uchar*>(header.constData());
+    if (header.size() != _headerSize || qFromLittleEndian<quint32>(data) != _magic) {
+        errorString = tr("%1 is not a telemetry log").arg(logFileName);
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(data + 4) != _version) {
+        errorString = tr("%1 is from a different version of %2").arg(logFileName, QCoreApplication::applicationName());
+        return false;
+    }
+
+    quint32                 cColumns = qFromLittleEndian<quint32>(data + 8);
+    QVector<ColumnInfo_t>   columns;
+    QStringList             names;
+    for (quint32 i=0; i<cColumns; i++) {
+        QByteArray columnHeader = logFile.read(3);
+        if (columnHeader.size() != 3) {
+            errorString = tr("%1 is truncated").arg(logFileName);
+            return false;
+        }
+        QByteArray name = logFile.read(static_cast<uchar>(columnHeader[2]));
+        if (name.size() != static_cast<uchar>(columnHeader[2])) {
+            errorString = tr("%1 is truncated").arg(logFileName);
+            return false;
+        }
+        columns.append({ static_cast<FactMetaData::ValueType_t>(static_cast<uchar>(columnHeader[0])), static_cast<qint8>(columnHeader[1]) });
+        names.append(QString::fromUtf8(name));
+    }
+
+    QSaveFile csvFile(csvFileName);
+    if (!csvFile.open(QIODevice::WriteOnly)) {
+        errorString = tr("Unable to open %1: %2").arg(csvFileName, csvFile.errorString());
+        return false;
+    }
+    QTextStream stream(&csvFile);
+    stream << "Timestamp," << names.join(",") << "\n";
+
+    // A block cut short by a crash at the end of the file is dropped
+    QVector<QStringList> columnValues(static_cast<int>(cColumns));
+    while (true) {
+        QByteArray blockHeader = logFile.read(_blockHeaderSize);
+        if (blockHeader.size() != _blockHeaderSize) {
+            break;
+        }
+        quint32     rowCount    = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(blockHeader.constData()));
+        quint32     byteCount   = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(blockHeader.constData()) + 4);
+        QByteArray  compressed  = logFile.read(byteCount);
+        if (compressed.size() != static_cast<int>(byteCount)) {
+            qCWarning(FactTelemetryLogLog) << "Truncated block at end of telemetry log" << logFileName;
+            break;
+        }
+
+        QByteArray      block       = qUncompress(compressed);
+        const uchar*    blockData   = reinterpret_cast<const uchar*>(block.constData());
+        const uchar*    blockEnd    = blockData + block.size();
+        const uchar*    timestamps  = blockData;
+        bool            ok          = block.size() >= static_cast<int>(rowCount * sizeof(qint64));
+
+        blockData += rowCount * sizeof(qint64);
+        for (quint32 i=0; ok && i<cColumns; i++) {
+            QStringList& values = columnValues[static_cast<int>(i)];
+            values.clear();
+            for (quint32 row=0; ok && row<rowCount; row++) {
+                values.append(_valueString(blockData, blockEnd, columns[static_cast<int>(i)].type, columns[static_cast<int>(i)].decimalPlaces, ok));
+            }
+        }
+        if (!ok) {
+            errorString = tr("%1 is corrupt").arg(logFileName);
+            return false;
+        }
+
+        for (quint32 row=0; row<rowCount; row++) {
+            qint64 msecs = qFromLittleEndian<qint64>(timestamps + (row * sizeof(qint64)));
+            stream << QDateTime::fromMSecsSinceEpoch(msecs).toString(QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz"));
+            for (const QStringList& values: columnValues) {
+                stream << ',' << values[static_cast<int>(row)];
+            }
+            stream << '\n';
+        }
+    }
+
+    stream.flush();
+    if (!csvFile.commit()) {
+        errorString = tr("Unable to write %1: %2").arg(csvFileName, csvFile.errorString());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include "FactMetaData.h"
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(FactTelemetryLogLog)
+
+class Fact;
+
+/// Writes the blocks of a FactTelemetryLog to disk, lives on the FactTelemetryLog writer thread
+class FactTelemetryLogWriter : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void open   (const QString& fileName, const QByteArray& header);
+    void write  (int rowCount, const QByteArray& block);
+    void close  (void);
+
+signals:
+    void openFailed(void);
+
+private:
+    QFile _file;
+};
+
+/// Samples a fixed set of Facts into a compact columnar binary file.
+///
+/// The Facts are resolved once when the log starts, and each sample appends the typed raw value of every Fact to its
+/// column. Every _rowsPerBlock samples the columns go to the writer thread as one block, which compresses it and
+/// writes it out. exportToCsv turns a log back into the csv telemetry format.
+///
+/// File format, all values little endian:
+///     Header:     uint32 magic, uint32 version, uint32 column count
+///                 per column: uint8 FactMetaData::ValueType_t, int8 decimal places, uint8 name length, UTF-8 name
+///     Blocks:     uint32 row count, uint32 byte count, qCompress'ed columns:
+///                 row count int64 msecs since epoch, then the values of each column in turn
+/// Numeric and bool values take the size of their type, everything else is a uint16 length and UTF-8 bytes.
+class FactTelemetryLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    FactTelemetryLog(QObject* parent = nullptr);
+    ~FactTelemetryLog();
+
+    /// Starts a new log, closing the current one
+    ///     @param names Column name for each of facts
+    void start(const QString& fileName, const QStringList& names, const QList<Fact*>& facts);
+
+    /// Appends the current value of each Fact
+    void sample(qint64 msecsSinceEpoch);
+
+    void stop(void);
+
+    bool isOpen(void) const { return _open; }
+
+    /// Writes the log as csv: a Timestamp column followed by a column for each Fact
+    /// @return false: errorString says why
+    static bool exportToCsv(const QString& logFileName, const QString& csvFileName, QString& errorString);
+
+    static const char* fileExtension;
+
+private slots:
+    void _openFailed(void);
+
+private:
+    typedef struct {
+        QPointer<Fact>              fact;               ///< Null once the Fact is gone, the column is then filled with defaults
+        FactMetaData::ValueType_t   type;
+        QByteArray                  values;
+    } Column_t;
+
+    void _flush(void);
+
+    static void     _appendValue    (QByteArray& bytes, FactMetaData::ValueType_t type, const QVariant& value);
+    static QString  _valueString    (const uchar*& data, const uchar* end, FactMetaData::ValueType_t type, int decimalPlaces, bool& ok);
+
+    QThread                 _writerThread;
+    FactTelemetryLogWriter* _writer             = nullptr;
+    bool                    _open               = false;
+    QVector<Column_t>       _columns;
+    QByteArray              _timestamps;
+    int                     _rowCount           = 0;
+
+    static const quint32    _magic              = 0x5147544C;   ///< QGTL
+    static const quint32    _version            = 1;
+    static const int        _headerSize         = 12;
+    static const int        _blockHeaderSize    = 8;
+    static const int        _rowsPerBlock       = 64;
+};
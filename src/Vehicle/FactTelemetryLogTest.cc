@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactTelemetryLogTest.h"
+#include "FactTelemetryLog.h"
+#include "Fact.h"
+
+#include <QDateTime>
+#include <QTemporaryDir>
+
+void FactTelemetryLogTest::_exportToCsv_test(void)
+{
+    QTemporaryDir   dir;
+    QString         logFile = dir.filePath(QStringLiteral("test.qgctl"));
+    QString         csvFile = dir.filePath(QStringLiteral("test.csv"));
+    Fact            altitude(0, QStringLiteral("altitude"), FactMetaData::valueTypeDouble);
+    Fact            satellites(0, QStringLiteral("count"), FactMetaData::valueTypeUint8);
+    Fact            armed(0, QStringLiteral("armed"), FactMetaData::valueTypeBool);
+    Fact            mode(0, QStringLiteral("mode"), FactMetaData::valueTypeString);
+    Fact            heading(0, QStringLiteral("heading"), FactMetaData::valueTypeFloat);
+    qint64          startMSecs = QDateTime::currentMSecsSinceEpoch();
+
+    altitude.metaData()->setDecimalPlaces(1);
+    heading.metaData()->setDecimalPlaces(0);
+    armed.setRawValue(true);
+    mode.setRawValue(QStringLiteral("Mission"));
+    heading.setRawValue(qQNaN());
+
+    // More rows than fit in one block
+    const int cRows = 150;
+    {
+        FactTelemetryLog log;
+        log.start(logFile, { "altitude", "gps.count", "armed", "mode", "heading" }, { &altitude, &satellites, &armed, &mode, &heading });
+        QVERIFY(log.isOpen());
+        for (int i=0; i<cRows; i++) {
+            altitude.setRawValue(i * 0.5);
+            satellites.setRawValue(i % 20);
+            log.sample(startMSecs + (i * 20));
+        }
+    }
+
+    QString errorString;
+    QVERIFY2(FactTelemetryLog::exportToCsv(logFile, csvFile, errorString), qPrintable(errorString));
+
+    QStringList lines = _readLines(csvFile);
+    QCOMPARE(lines.count(), cRows + 1);
+    QCOMPARE(lines[0], QStringLiteral("Timestamp,altitude,gps.count,armed,mode,heading"));
+    for (int i=0; i<cRows; i++) {
+        QStringList values = lines[i + 1].split(',');
+        QCOMPARE(values.count(), 6);
+        QCOMPARE(values[0], QDateTime::fromMSecsSinceEpoch(startMSecs + (i * 20)).toString(QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz")));
+        QCOMPARE(values[1], QString::number(i * 0.5, 'f', 1));
+        QCOMPARE(values[2], QString::number(i % 20));
+        QCOMPARE(values[3], QStringLiteral("true"));
+        QCOMPARE(values[4], QStringLiteral("Mission"));
+        QCOMPARE(values[5], QStringLiteral("--.--"));
+    }
+}
+
+void FactTelemetryLogTest::_factDeleted_test(void)
+{
+    QTemporaryDir   dir;
+    QString         logFile = dir.filePath(QStringLiteral("test.qgctl"));
+    QString         csvFile = dir.filePath(QStringLiteral("test.csv"));
+    Fact*           speed   = new Fact(0, QStringLiteral("speed"), FactMetaData::valueTypeDouble);
+    Fact*           count   = new Fact(0, QStringLiteral("count"), FactMetaData::valueTypeInt32);
+
+    speed->metaData()->setDecimalPlaces(2);
+    speed->setRawValue(1.25);
+    count->setRawValue(-7);
+    {
+        FactTelemetryLog log;
+        log.start(logFile, { "speed", "count" }, { speed, count });
+        log.sample(1000);
+        delete speed;
+        delete count;
+        log.sample(2000);
+    }
+
+    QString errorString;
+    QVERIFY2(FactTelemetryLog::exportToCsv(logFile, csvFile, errorString), qPrintable(errorString));
+
+    QStringList lines = _readLines(csvFile);
+    QCOMPARE(lines.count(), 3);
+    QVERIFY(lines[1].endsWith(QStringLiteral(",1.25,-7")));
+    QVERIFY(lines[2].endsWith(QStringLiteral(",--.--,0")));
+}
+
+void FactTelemetryLogTest::_notATelemetryLog_test(void)
+{
+    QTemporaryDir   dir;
+    QString         logFile = dir.filePath(QStringLiteral("test.qgctl"));
+    QString         csvFile = dir.filePath(QStringLiteral("test.csv"));
+
+    QFile file(logFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("Timestamp,altitude\n");
+    file.close();
+
+    QString errorString;
+    QVERIFY(!FactTelemetryLog::exportToCsv(logFile, csvFile, errorString));
+    QVERIFY(!errorString.isEmpty());
+    QVERIFY(!QFile::exists(csvFile));
+}
+
+QStringList FactTelemetryLogTest::_readLines(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QStringList();
+    }
+    QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    lines.removeAll(QString());
+    return lines;
+}
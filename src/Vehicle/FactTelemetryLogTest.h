@@ -9,21 +9,17 @@
 
 #pragma once
 
-#include "TaisyncHandler.h"
-#include <QUdpSocket>
+#include "UnitTest.h"
 
-class TaisyncVideoReceiver : public TaisyncHandler
+class FactTelemetryLogTest : public UnitTest
 {
     Q_OBJECT
-public:
-
-    explicit TaisyncVideoReceiver       (QObject* parent = nullptr);
-    bool start                          () override;
-    bool close                          () override;
 
 private slots:
-    void    _readBytes                  () override;
+    void _exportToCsv_test      (void);
+    void _factDeleted_test      (void);
+    void _notATelemetryLog_test (void);
 
 private:
-    QUdpSocket*     _udpVideoSocket     = nullptr;
+    QStringList _readLines(const QString& fileName);
 };
@@ -42,3 +42,63 @@ GPSRTKFactGroup::GPSRTKFactGroup(QObject* parent)
     _addFact(&_numSatellites,      _numSatellitesFactName);
 }
 
+
+void GPSRTKFactGroup::setSurveyInStatus(const GPSSurveyInStatusMessage& status)
+{
+    Fact* facts[] = { &_currentDuration, &_currentAccuracy, &_currentLatitude, &_currentLongitude, &_currentAltitude, &_valid, &_active };
+
+    _currentDuration._containerSetRawValueBatched(static_cast<double>(status.duration));
+    _currentAccuracy._containerSetRawValueBatched(static_cast<double>(status.accuracyMM) / 1000.0);
+    _currentLatitude._containerSetRawValueBatched(status.latitude);
+    _currentLongitude._containerSetRawValueBatched(status.longitude);
+    _currentAltitude._containerSetRawValueBatched(status.altitude);
+    _valid._containerSetRawValueBatched(status.valid);
+    _active._containerSetRawValueBatched(status.active);
+
+    if (status.active) {
+        int newest = (_accuracyHistoryNext == 0 ? _accuracyHistory.count() : _accuracyHistoryNext) - 1;
+        if (newest >= 0 && static_cast<double>(status.duration) < _accuracyHistory[newest].x()) {
+            // Survey-in was restarted
+            _accuracyHistory.clear();
+            _accuracyHistoryNext = 0;
+        }
+        QPointF point(static_cast<double>(status.duration), static_cast<double>(status.accuracyMM) / 1000.0);
+        if (_accuracyHistory.count() < accuracyHistoryMax) {
+            _accuracyHistory.append(point);
+        } else {
+            _accuracyHistory[_accuracyHistoryNext] = point;
+            _accuracyHistoryNext = (_accuracyHistoryNext + 1) % accuracyHistoryMax;
+        }
+        emit accuracyHistoryChanged();
+    }
+
+    for (Fact* fact: facts) {
+        fact->_sendBatchedValueChangedSignals();
+    }
+}
+
+void GPSRTKFactGroup::clearAccuracyHistory(void)
+{
+    if (!_accuracyHistory.isEmpty()) {
+        _accuracyHistory.clear();
+        _accuracyHistoryNext = 0;
+        emit accuracyHistoryChanged();
+    }
+}
+
+QVector<QPointF> GPSRTKFactGroup::accuracyHistoryPoints(void) const
+{
+    if (_accuracyHistoryNext == 0) {
+        return _accuracyHistory;
+    }
+    return _accuracyHistory.mid(_accuracyHistoryNext) + _accuracyHistory.mid(0, _accuracyHistoryNext);
+}
+
+QVariantList GPSRTKFactGroup::accuracyHistory(void) const
+{
+    QVariantList history;
+    for (const QPointF& point: accuracyHistoryPoints()) {
+        history.append(point);
+    }
+    return history;
+}
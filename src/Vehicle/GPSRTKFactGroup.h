@@ -11,6 +11,10 @@
 #pragma once
 
 #include "Vehicle.h"
+#include "GPSPositionMessage.h"
+
+#include <QPointF>
+#include <QVector>
 
 class GPSRTKFactGroup : public FactGroup
 {
@@ -29,6 +33,9 @@ public:
     Q_PROPERTY(Fact* active               READ active               CONSTANT)
     Q_PROPERTY(Fact* numSatellites        READ numSatellites        CONSTANT)
 
+    /// Survey-in accuracy over time, oldest first. QPointF: x duration [s], y accuracy [m]
+    Q_PROPERTY(QVariantList accuracyHistory READ accuracyHistory    NOTIFY accuracyHistoryChanged)
+
     Fact* connected         (void) { return &_connected; }
     Fact* currentDuration   (void) { return &_currentDuration; }
     Fact* currentAccuracy   (void) { return &_currentAccuracy; }
@@ -39,6 +46,13 @@ public:
     Fact* active            (void) { return &_active; }
     Fact* numSatellites     (void) { return &_numSatellites; }
 
+    QVariantList        accuracyHistory         (void) const;
+    QVector<QPointF>    accuracyHistoryPoints   (void) const;
+
+    /// Applies a complete survey-in status. All values are stored before any of the change signals go out.
+    void setSurveyInStatus      (const GPSSurveyInStatusMessage& status);
+    void clearAccuracyHistory   (void);
+
     static const char* _connectedFactName;
     static const char* _currentDurationFactName;
     static const char* _currentAccuracyFactName;
@@ -49,6 +63,11 @@ public:
     static const char* _activeFactName;
     static const char* _numSatellitesFactName;
 
+    static const int accuracyHistoryMax = 300;  ///< Five minutes of survey-in at the 1Hz status rate
+
+signals:
+    void accuracyHistoryChanged(void);
+
 private:
     Fact _connected;        ///< is an RTK gps connected?
     Fact _currentDuration;  ///< survey-in status in [s]
@@ -59,4 +78,7 @@ private:
     Fact _valid;            ///< survey-in complete?
     Fact _active;           ///< survey-in active?
     Fact _numSatellites;    ///< number of satellites
+
+    QVector<QPointF>    _accuracyHistory;               ///< Ring buffer of accuracyHistoryMax entries
+    int                 _accuracyHistoryNext    = 0;    ///< Slot the next entry is written to once the buffer is full
 };
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GPSRTKFactGroupTest.h"
+#include "GPSRTKFactGroup.h"
+
+#include <QSignalSpy>
+
+static GPSSurveyInStatusMessage _status(float duration, float accuracyMM, bool active = true)
+{
+    GPSSurveyInStatusMessage status;
+    status.duration     = duration;
+    status.accuracyMM   = accuracyMM;
+    status.latitude     = 47.3977;
+    status.longitude    = 8.5456;
+    status.altitude     = 488;
+    status.active       = active;
+    status.valid        = !active;
+    return status;
+}
+
+void GPSRTKFactGroupTest::_surveyInStatus_test(void)
+{
+    GPSRTKFactGroup factGroup;
+    bool            sawPartialStatus = false;
+
+    // Whichever value signals first, the rest of the status is already in place
+    connect(factGroup.currentDuration(), &Fact::rawValueChanged, this, [&]() {
+        sawPartialStatus |= factGroup.currentAccuracy()->rawValue().toDouble() != 2.5 || !factGroup.active()->rawValue().toBool();
+    });
+    connect(factGroup.active(), &Fact::rawValueChanged, this, [&]() {
+        sawPartialStatus |= factGroup.currentDuration()->rawValue().toDouble() != 10.0;
+    });
+
+    factGroup.setSurveyInStatus(_status(10, 2500));
+    QVERIFY(!sawPartialStatus);
+    QCOMPARE(factGroup.currentDuration()->rawValue().toDouble(),    10.0);
+    QCOMPARE(factGroup.currentAccuracy()->rawValue().toDouble(),    2.5);
+    QCOMPARE(factGroup.currentLatitude()->rawValue().toDouble(),    47.3977);
+    QCOMPARE(factGroup.currentLongitude()->rawValue().toDouble(),   8.5456);
+    QCOMPARE(factGroup.currentAltitude()->rawValue().toFloat(),     488.0f);
+    QCOMPARE(factGroup.active()->rawValue().toBool(),               true);
+    QCOMPARE(factGroup.valid()->rawValue().toBool(),                false);
+
+    // Unchanged values do not signal again
+    QSignalSpy latitudeSpy(factGroup.currentLatitude(), &Fact::rawValueChanged);
+    factGroup.setSurveyInStatus(_status(11, 2000));
+    QCOMPARE(latitudeSpy.count(), 0);
+}
+
+void GPSRTKFactGroupTest::_accuracyHistory_test(void)
+{
+    GPSRTKFactGroup factGroup;
+    QSignalSpy      spy(&factGroup, &GPSRTKFactGroup::accuracyHistoryChanged);
+
+    for (int i=0; i<GPSRTKFactGroup::accuracyHistoryMax + 10; i++) {
+        factGroup.setSurveyInStatus(_status(i, 10000 - i));
+    }
+    QCOMPARE(spy.count(), GPSRTKFactGroup::accuracyHistoryMax + 10);
+
+    // Oldest entries fall off, order stays oldest first
+    QVector<QPointF> history = factGroup.accuracyHistoryPoints();
+    QCOMPARE(history.count(), static_cast<int>(GPSRTKFactGroup::accuracyHistoryMax));
+    QCOMPARE(history.first().x(), 10.0);
+    QCOMPARE(history.last().x(), static_cast<double>(GPSRTKFactGroup::accuracyHistoryMax + 9));
+    QCOMPARE(history.last().y(), (10000.0 - (GPSRTKFactGroup::accuracyHistoryMax + 9)) / 1000.0);
+    for (int i=1; i<history.count(); i++) {
+        QVERIFY(history[i].x() > history[i-1].x());
+    }
+    QCOMPARE(factGroup.accuracyHistory().count(), history.count());
+
+    // Only an active survey-in is recorded
+    factGroup.setSurveyInStatus(_status(1000, 500, false /* active */));
+    QCOMPARE(factGroup.accuracyHistoryPoints().count(), history.count());
+
+    // A restarted survey-in starts a new history
+    factGroup.setSurveyInStatus(_status(1, 9000));
+    history = factGroup.accuracyHistoryPoints();
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(history[0], QPointF(1, 9));
+
+    factGroup.clearAccuracyHistory();
+    QCOMPARE(factGroup.accuracyHistoryPoints().count(), 0);
+}
@@ -15,9 +15,17 @@
 #include "ParameterManager.h"
 #include "ComponentInformationManager.h"
 #include "MissionManager.h"
+#include "QGCInstrumentation.h"
 
 QGC_LOGGING_CATEGORY(InitialConnectStateMachineLog, "InitialConnectStateMachineLog")
 
+QGC_INSTRUMENT_HISTOGRAM(InitialConnectCapabilitiesTime,    "InitialConnect.Capabilities")
+QGC_INSTRUMENT_HISTOGRAM(InitialConnectProtocolVersionTime, "InitialConnect.ProtocolVersion")
+QGC_INSTRUMENT_HISTOGRAM(InitialConnectCompInfoTime,        "InitialConnect.CompInfo")
+QGC_INSTRUMENT_HISTOGRAM(InitialConnectParametersTime,      "InitialConnect.Parameters")
+QGC_INSTRUMENT_HISTOGRAM(InitialConnectPlanTime,            "InitialConnect.Plan")
+QGC_INSTRUMENT_HISTOGRAM(InitialConnectTotalTime,           "InitialConnect.Total")
+
 const StateMachine::StateFn InitialConnectStateMachine::_rgStates[] = {
     InitialConnectStateMachine::_stateRequestCapabilities,
     InitialConnectStateMachine::_stateRequestProtocolVersion,
@@ -52,39 +60,106 @@ void InitialConnectStateMachine::statesCompleted(void) const
 
 }
 
+/// Restarts the stage timer
+///     @return Time taken by the stage which just completed
+quint64 InitialConnectStateMachine::_stageComplete(const char* stageName)
+{
+    quint64 usecs = static_cast<quint64>(_stageTimer.nsecsElapsed() / 1000);
+
+    qCDebug(InitialConnectStateMachineLog) << "Stage" << stageName << "completed msecs:" << usecs / 1000;
+    _stageTimer.restart();
+    return usecs;
+}
+
+/// The capabilities, protocol version and component information requests don't depend on each other, so they are all
+/// sent now and go out to the vehicle together. The state for each of them just waits for it to complete.
 void InitialConnectStateMachine::_stateRequestCapabilities(StateMachine* stateMachine)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-    WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
 
-    if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestCapabilities Skipping capability request due to no primary link";
+    connectMachine->_connectTimer.start();
+    connectMachine->_stageTimer.start();
+    connectMachine->_completedConnectRequests   = 0;
+    connectMachine->_concurrentPlanLoads        = false;
+    connectMachine->_completedPlanLoads         = 0;
+
+    // Requests which complete right away must not move the state along before the others are sent
+    connectMachine->_sendingConnectRequests = true;
+    connectMachine->_requestCapabilities();
+    connectMachine->_requestProtocolVersion();
+    connectMachine->_requestCompInfo();
+    connectMachine->_sendingConnectRequests = false;
+
+    if (connectMachine->_connectRequestDone(ConnectRequestCapabilities)) {
         connectMachine->advance();
+    }
+}
+
+void InitialConnectStateMachine::_requestCapabilities(void)
+{
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+
+    if (weakLink.expired()) {
+        qCDebug(InitialConnectStateMachineLog) << "_requestCapabilities Skipping capability request due to no primary link";
+        _connectRequestComplete(ConnectRequestCapabilities);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping capability request due to link type";
-            connectMachine->advance();
+            _connectRequestComplete(ConnectRequestCapabilities);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Requesting capabilities";
-            vehicle->_waitForMavlinkMessage(_waitForAutopilotVersionResultHandler, connectMachine, MAVLINK_MSG_ID_AUTOPILOT_VERSION, 1000);
-            vehicle->sendMavCommandWithHandler(_capabilitiesCmdResultHandler,
-                                               connectMachine,
-                                               MAV_COMP_ID_AUTOPILOT1,
-                                               MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES,
-                                               1);                                      // Request firmware version
+            _vehicle->_waitForMavlinkMessage(_waitForAutopilotVersionResultHandler, this, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_AUTOPILOT_VERSION, 1000);
+            _vehicle->sendMavCommandWithHandler(_capabilitiesCmdResultHandler,
+                                                this,
+                                                MAV_COMP_ID_AUTOPILOT1,
+                                                MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES,
+                                                1);                                     // Request firmware version
         }
     }
 }
 
+void InitialConnectStateMachine::_connectRequestComplete(ConnectRequest_t request)
+{
+    static const StateFn rgRequestStates[] = {
+        _stateRequestCapabilities,      // ConnectRequestCapabilities
+        _stateRequestProtocolVersion,   // ConnectRequestProtocolVersion
+        _stateRequestCompInfo,          // ConnectRequestCompInfo
+    };
+
+    // The requests are all sent together, so each one is timed from the start of the connect sequence
+    quint64 usecs = static_cast<quint64>(_connectTimer.nsecsElapsed() / 1000);
+    switch (request) {
+    case ConnectRequestCapabilities:
+        QGC_INSTRUMENT_SAMPLE(InitialConnectCapabilitiesTime, usecs);
+        break;
+    case ConnectRequestProtocolVersion:
+        QGC_INSTRUMENT_SAMPLE(InitialConnectProtocolVersionTime, usecs);
+        break;
+    case ConnectRequestCompInfo:
+        QGC_INSTRUMENT_SAMPLE(InitialConnectCompInfoTime, usecs);
+        break;
+    }
+    Q_UNUSED(usecs)
+
+    qCDebug(InitialConnectStateMachineLog) << "_connectRequestComplete request:msecs" << request << _connectTimer.elapsed();
+    _completedConnectRequests |= 1 << request;
+
+    // Only the request being waited on moves the state along
+    if (!_sendingConnectRequests && currentState() == rgRequestStates[request]) {
+        advance();
+    }
+}
+
 void InitialConnectStateMachine::_capabilitiesCmdResultHandler(void* resultHandlerData, int /*compId*/, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(resultHandlerData);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    if (result != MAV_RESULT_ACCEPTED) {
+    if (result == MAV_RESULT_ACCEPTED) {
+        vehicle->_waitForMavlinkMessageStartTimeout(_waitForAutopilotVersionResultHandler, connectMachine);
+    } else {
         switch (failureCode) {
         case Vehicle::MavCmdResultCommandResultOnly:
             qCDebug(InitialConnectStateMachineLog) << QStringLiteral("MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES error(%1)").arg(result);
@@ -99,8 +174,8 @@ void InitialConnectStateMachine::_capabilitiesCmdResultHandler(void* resultHandl
 
         qCDebug(InitialConnectStateMachineLog) << "Setting no capabilities";
         vehicle->_setCapabilities(0);
-        vehicle->_waitForMavlinkMessageClear();
-        connectMachine->advance();
+        vehicle->_waitForMavlinkMessageClear(_waitForAutopilotVersionResultHandler, connectMachine);
+        connectMachine->_connectRequestComplete(ConnectRequestCapabilities);
     }
 }
 
@@ -161,42 +236,51 @@ void InitialConnectStateMachine::_waitForAutopilotVersionResultHandler(void* res
 
         vehicle->_setCapabilities(autopilotVersion.capabilities);
     }
-    connectMachine->advance();
+    connectMachine->_connectRequestComplete(ConnectRequestCapabilities);
 }
 
 void InitialConnectStateMachine::_stateRequestProtocolVersion(StateMachine* stateMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-    WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
+    InitialConnectStateMachine* connectMachine = static_cast<InitialConnectStateMachine*>(stateMachine);
 
-    if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestProtocolVersion Skipping protocol version request due to no primary link";
+    if (connectMachine->_connectRequestDone(ConnectRequestProtocolVersion)) {
         connectMachine->advance();
+    }
+}
+
+void InitialConnectStateMachine::_requestProtocolVersion(void)
+{
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+
+    if (weakLink.expired()) {
+        qCDebug(InitialConnectStateMachineLog) << "_requestProtocolVersion Skipping protocol version request due to no primary link";
+        _connectRequestComplete(ConnectRequestProtocolVersion);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestProtocolVersion Skipping protocol version request due to link type";
-            connectMachine->advance();
+            qCDebug(InitialConnectStateMachineLog) << "_requestProtocolVersion Skipping protocol version request due to link type";
+            _connectRequestComplete(ConnectRequestProtocolVersion);
         } else {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestProtocolVersion Requesting protocol version";
-            vehicle->_waitForMavlinkMessage(_waitForProtocolVersionResultHandler, connectMachine, MAVLINK_MSG_ID_PROTOCOL_VERSION, 1000);
-            vehicle->sendMavCommandWithHandler(_protocolVersionCmdResultHandler,
-                                               connectMachine,
-                                               MAV_COMP_ID_AUTOPILOT1,
-                                               MAV_CMD_REQUEST_PROTOCOL_VERSION,
-                                               1);                                      // Request protocol version
+            qCDebug(InitialConnectStateMachineLog) << "_requestProtocolVersion Requesting protocol version";
+            _vehicle->_waitForMavlinkMessage(_waitForProtocolVersionResultHandler, this, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_PROTOCOL_VERSION, 1000);
+            _vehicle->sendMavCommandWithHandler(_protocolVersionCmdResultHandler,
+                                                this,
+                                                MAV_COMP_ID_AUTOPILOT1,
+                                                MAV_CMD_REQUEST_PROTOCOL_VERSION,
+                                                1);                                     // Request protocol version
         }
     }
 }
 
 void InitialConnectStateMachine::_protocolVersionCmdResultHandler(void* resultHandlerData, int /*compId*/, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode)
 {
-    if (result != MAV_RESULT_ACCEPTED) {
-        InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(resultHandlerData);
-        Vehicle*                    vehicle         = connectMachine->_vehicle;
+    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(resultHandlerData);
+    Vehicle*                    vehicle         = connectMachine->_vehicle;
 
+    if (result == MAV_RESULT_ACCEPTED) {
+        vehicle->_waitForMavlinkMessageStartTimeout(_waitForProtocolVersionResultHandler, connectMachine);
+    } else {
         switch (failureCode) {
         case Vehicle::MavCmdResultCommandResultOnly:
             qCDebug(InitialConnectStateMachineLog) << QStringLiteral("MAV_CMD_REQUEST_PROTOCOL_VERSION error(%1)").arg(result);
@@ -212,8 +296,8 @@ void InitialConnectStateMachine::_protocolVersionCmdResultHandler(void* resultHa
         // _mavlinkProtocolRequestMaxProtoVersion stays at 0 to indicate unknown
         vehicle->_mavlinkProtocolRequestComplete = true;
         vehicle->_setMaxProtoVersionFromBothSources();
-        vehicle->_waitForMavlinkMessageClear();
-        connectMachine->advance();
+        vehicle->_waitForMavlinkMessageClear(_waitForProtocolVersionResultHandler, connectMachine);
+        connectMachine->_connectRequestComplete(ConnectRequestProtocolVersion);
     }
 }
 
@@ -239,23 +323,29 @@ void InitialConnectStateMachine::_waitForProtocolVersionResultHandler(void* resu
         vehicle->_mavlinkProtocolRequestComplete = true;
         vehicle->_setMaxProtoVersionFromBothSources();
     }
-    connectMachine->advance();
+    connectMachine->_connectRequestComplete(ConnectRequestProtocolVersion);
 }
 
 void InitialConnectStateMachine::_stateRequestCompInfo(StateMachine* stateMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
+    InitialConnectStateMachine* connectMachine = static_cast<InitialConnectStateMachine*>(stateMachine);
+
+    if (connectMachine->_connectRequestDone(ConnectRequestCompInfo)) {
+        connectMachine->advance();
+    }
+}
 
-    qCDebug(InitialConnectStateMachineLog) << "_stateRequestCompInfo";
-    vehicle->_componentInformationManager->requestAllComponentInformation(_stateRequestCompInfoComplete, connectMachine);
+void InitialConnectStateMachine::_requestCompInfo(void)
+{
+    qCDebug(InitialConnectStateMachineLog) << "_requestCompInfo";
+    _vehicle->_componentInformationManager->requestAllComponentInformation(_requestCompInfoComplete, this);
 }
 
-void InitialConnectStateMachine::_stateRequestCompInfoComplete(void* requestAllCompleteFnData)
+void InitialConnectStateMachine::_requestCompInfoComplete(void* requestAllCompleteFnData)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(requestAllCompleteFnData);
 
-    connectMachine->advance();
+    connectMachine->_connectRequestComplete(ConnectRequestCompInfo);
 }
 
 void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMachine)
@@ -263,6 +353,8 @@ void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMach
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
+    connectMachine->_stageComplete("Capabilities, ProtocolVersion, CompInfo");
+
     qCDebug(InitialConnectStateMachineLog) << "_stateRequestParameters";
     vehicle->_parameterManager->refreshAllParameters();
 }
@@ -271,72 +363,136 @@ void InitialConnectStateMachine::_stateRequestMission(StateMachine* stateMachine
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
-    WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
 
-    if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to no primary link";
+    quint64 stageUSecs = connectMachine->_stageComplete("Parameters");
+    QGC_INSTRUMENT_SAMPLE(InitialConnectParametersTime, stageUSecs);
+    Q_UNUSED(stageUSecs)
+
+    // The plan types only depend on the parameters, not on each other. Where the firmware keeps their transfers apart
+    // they are all requested now and the geofence and rally point states just wait for their load to finish.
+    connectMachine->_concurrentPlanLoads = vehicle->firmwarePlugin()->concurrentPlanReads() && vehicle->maxProtoVersion() >= 200;
+    if (connectMachine->_concurrentPlanLoads) {
+        qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Requesting all plan types";
+        connectMachine->_loadMission();
+        connectMachine->_loadGeoFence();
+        connectMachine->_loadRallyPoints();
+    } else {
+        connectMachine->_loadMission();
+    }
+}
+
+void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachine)
+{
+    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
+
+    if (!connectMachine->_concurrentPlanLoads) {
+        connectMachine->_loadGeoFence();
+    } else if (connectMachine->_planLoadDone(MAV_MISSION_TYPE_FENCE)) {
         connectMachine->advance();
+    }
+}
+
+void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMachine)
+{
+    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
+
+    if (!connectMachine->_concurrentPlanLoads) {
+        connectMachine->_loadRallyPoints();
+    } else if (connectMachine->_planLoadDone(MAV_MISSION_TYPE_RALLY)) {
+        connectMachine->advance();
+    }
+}
+
+void InitialConnectStateMachine::planLoadComplete(MAV_MISSION_TYPE planType)
+{
+    static const StateFn rgPlanStates[] = {
+        _stateRequestMission,       // MAV_MISSION_TYPE_MISSION
+        _stateRequestGeoFence,      // MAV_MISSION_TYPE_FENCE
+        _stateRequestRallyPoints,   // MAV_MISSION_TYPE_RALLY
+    };
+
+    if (planType > MAV_MISSION_TYPE_RALLY) {
+        qWarning() << "InitialConnectStateMachine::planLoadComplete unexpected plan type" << planType;
+        return;
+    }
+
+    qCDebug(InitialConnectStateMachineLog) << "planLoadComplete planType:msecs" << planType << _stageTimer.elapsed();
+    _completedPlanLoads |= 1 << planType;
+    if (_planLoadDone(MAV_MISSION_TYPE_MISSION) && _planLoadDone(MAV_MISSION_TYPE_FENCE) && _planLoadDone(MAV_MISSION_TYPE_RALLY)) {
+        _vehicle->_initialPlanRequestComplete = true;
+        emit _vehicle->initialPlanRequestCompleteChanged(true);
+    }
+
+    // With concurrent loads the plan types can finish in any order, only the one being waited on moves the state along
+    if (currentState() == rgPlanStates[planType]) {
+        advance();
+    }
+}
+
+void InitialConnectStateMachine::_loadMission(void)
+{
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+
+    if (weakLink.expired()) {
+        qCDebug(InitialConnectStateMachineLog) << "_loadMission: Skipping first mission load request due to no primary link";
+        planLoadComplete(MAV_MISSION_TYPE_MISSION);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to link type";
-            vehicle->_firstMissionLoadComplete();
+            qCDebug(InitialConnectStateMachineLog) << "_loadMission: Skipping first mission load request due to link type";
+            _vehicle->_firstMissionLoadComplete();
         } else {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission";
-            vehicle->_missionManager->loadFromVehicle();
+            qCDebug(InitialConnectStateMachineLog) << "_loadMission";
+            _vehicle->_missionManager->loadFromVehicle();
         }
     }
 }
 
-void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachine)
+void InitialConnectStateMachine::_loadGeoFence(void)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-    WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_loadGeoFence: Skipping first geofence load request due to no primary link";
+        planLoadComplete(MAV_MISSION_TYPE_FENCE);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to link type";
-            vehicle->_firstGeoFenceLoadComplete();
+            qCDebug(InitialConnectStateMachineLog) << "_loadGeoFence: Skipping first geofence load request due to link type";
+            _vehicle->_firstGeoFenceLoadComplete();
         } else {
-            if (vehicle->_geoFenceManager->supported()) {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence";
-                vehicle->_geoFenceManager->loadFromVehicle();
+            if (_vehicle->_geoFenceManager->supported()) {
+                qCDebug(InitialConnectStateMachineLog) << "_loadGeoFence";
+                _vehicle->_geoFenceManager->loadFromVehicle();
             } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: skipped due to no support";
-                vehicle->_firstGeoFenceLoadComplete();
+                qCDebug(InitialConnectStateMachineLog) << "_loadGeoFence: skipped due to no support";
+                _vehicle->_firstGeoFenceLoadComplete();
             }
         }
     }
 }
 
-void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMachine)
+void InitialConnectStateMachine::_loadRallyPoints(void)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-    WeakLinkInterfacePtr        weakLink        = vehicle->vehicleLinkManager()->primaryLink();
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
 
     if (weakLink.expired()) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_loadRallyPoints: Skipping first rally point load request due to no primary link";
+        planLoadComplete(MAV_MISSION_TYPE_RALLY);
     } else {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to link type";
-            vehicle->_firstRallyPointLoadComplete();
+            qCDebug(InitialConnectStateMachineLog) << "_loadRallyPoints: Skipping first rally point load request due to link type";
+            _vehicle->_firstRallyPointLoadComplete();
         } else {
-            if (vehicle->_rallyPointManager->supported()) {
-                vehicle->_rallyPointManager->loadFromVehicle();
+            if (_vehicle->_rallyPointManager->supported()) {
+                _vehicle->_rallyPointManager->loadFromVehicle();
             } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: skipping due to no support";
-                vehicle->_firstRallyPointLoadComplete();
+                qCDebug(InitialConnectStateMachineLog) << "_loadRallyPoints: skipping due to no support";
+                _vehicle->_firstRallyPointLoadComplete();
             }
         }
     }
@@ -347,7 +503,11 @@ void InitialConnectStateMachine::_stateSignalInitialConnectComplete(StateMachine
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
+    quint64 stageUSecs = connectMachine->_stageComplete("Plan");
+    QGC_INSTRUMENT_SAMPLE(InitialConnectPlanTime, stageUSecs);
+    QGC_INSTRUMENT_SAMPLE(InitialConnectTotalTime, static_cast<quint64>(connectMachine->_connectTimer.nsecsElapsed() / 1000));
+    Q_UNUSED(stageUSecs)
+
+    qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete msecs:" << connectMachine->_connectTimer.elapsed();
     emit vehicle->initialConnectComplete();
 }
-
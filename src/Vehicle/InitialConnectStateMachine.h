@@ -14,6 +14,8 @@
 #include "QGCLoggingCategory.h"
 #include "Vehicle.h"
 
+#include <QElapsedTimer>
+
 Q_DECLARE_LOGGING_CATEGORY(InitialConnectStateMachineLog)
 
 class Vehicle;
@@ -28,11 +30,13 @@ public:
     const StateFn*  rgStates        (void) const final;
     void            statesCompleted (void) const final;
 
+    /// Called when the first load of a plan type from the vehicle is done, whether or not it was skipped
+    void planLoadComplete(MAV_MISSION_TYPE planType);
+
 private:
     static void _stateRequestCapabilities               (StateMachine* stateMachine);
     static void _stateRequestProtocolVersion            (StateMachine* stateMachine);
     static void _stateRequestCompInfo                   (StateMachine* stateMachine);
-    static void _stateRequestCompInfoComplete           (void* requestAllCompleteFnData);
     static void _stateRequestParameters                 (StateMachine* stateMachine);
     static void _stateRequestMission                    (StateMachine* stateMachine);
     static void _stateRequestGeoFence                   (StateMachine* stateMachine);
@@ -44,8 +48,33 @@ private:
 
     static void _waitForAutopilotVersionResultHandler   (void* resultHandlerData, bool noResponsefromVehicle, const mavlink_message_t& message);
     static void _waitForProtocolVersionResultHandler    (void* resultHandlerData, bool noResponsefromVehicle, const mavlink_message_t& message);
+    static void _requestCompInfoComplete                (void* requestAllCompleteFnData);
+
+    typedef enum {
+        ConnectRequestCapabilities,
+        ConnectRequestProtocolVersion,
+        ConnectRequestCompInfo,
+    } ConnectRequest_t;
+
+    void    _requestCapabilities    (void);
+    void    _requestProtocolVersion (void);
+    void    _requestCompInfo        (void);
+    void    _connectRequestComplete (ConnectRequest_t request);
+    bool    _connectRequestDone     (ConnectRequest_t request) const { return _completedConnectRequests & (1 << request); }
+
+    void    _loadMission        (void);
+    void    _loadGeoFence       (void);
+    void    _loadRallyPoints    (void);
+    bool    _planLoadDone       (MAV_MISSION_TYPE planType) const { return _completedPlanLoads & (1 << planType); }
+    quint64 _stageComplete      (const char* stageName);
 
-    Vehicle* _vehicle;
+    Vehicle*        _vehicle;
+    bool            _sendingConnectRequests     = false;    ///< true: _stateRequestCapabilities is still sending the connect requests
+    uint32_t        _completedConnectRequests   = 0;        ///< Bit per ConnectRequest_t which is done
+    bool            _concurrentPlanLoads        = false;    ///< true: All plan types were requested together
+    uint32_t        _completedPlanLoads         = 0;        ///< Bit per MAV_MISSION_TYPE whose first load is done
+    QElapsedTimer   _connectTimer;
+    QElapsedTimer   _stageTimer;
 
     static const StateFn    _rgStates[];
     static const int        _cStates;
@@ -0,0 +1,225 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkQualityAdapter.h"
+#include "Vehicle.h"
+#include "MessageIntervalManager.h"
+#include "MultiVehicleManager.h"
+#include "SettingsManager.h"
+#include "QGCApplication.h"
+#include "QGCLoggingCategory.h"
+#if defined(QGC_GST_MICROHARD_ENABLED)
+#include "MicrohardManager.h"
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED)
+#include "TaisyncManager.h"
+#endif
+
+#include <QtMath>
+
+QGC_LOGGING_CATEGORY(LinkQualityAdapterLog, "LinkQualityAdapterLog")
+
+// High rate messages the vehicle can be flown without. Heartbeat, status, position, attitude, battery, command acks
+// and mission traffic are never touched.
+const uint32_t LinkQualityAdapter::_sheddableMessages[] = {
+    MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+    MAVLINK_MSG_ID_ATTITUDE_TARGET,
+    MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED,
+    MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT,
+    MAVLINK_MSG_ID_LOCAL_POSITION_NED,
+    MAVLINK_MSG_ID_ODOMETRY,
+    MAVLINK_MSG_ID_SERVO_OUTPUT_RAW,
+    MAVLINK_MSG_ID_RC_CHANNELS,
+    MAVLINK_MSG_ID_HIGHRES_IMU,
+    MAVLINK_MSG_ID_SCALED_IMU,
+    MAVLINK_MSG_ID_SCALED_PRESSURE,
+    MAVLINK_MSG_ID_ALTITUDE,
+    MAVLINK_MSG_ID_ESTIMATOR_STATUS,
+    MAVLINK_MSG_ID_VIBRATION,
+    MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+};
+const int LinkQualityAdapter::_sheddableMessageCount = sizeof(_sheddableMessages) / sizeof(_sheddableMessages[0]);
+
+LinkQualityAdapter::LinkQualityAdapter(Vehicle* vehicle)
+    : QObject   (vehicle)
+    , _vehicle  (vehicle)
+{
+    for (int i = 0; i < SourceCount; i++) {
+        _margin[i]      = qQNaN();
+        _marginMSecs[i] = -1;
+    }
+    _clock.start();
+
+    _evaluateTimer.setInterval(_evaluateMSecs);
+    connect(&_evaluateTimer, &QTimer::timeout, this, &LinkQualityAdapter::_evaluate);
+    _evaluateTimer.start();
+
+    connect(qgcApp()->toolbox()->settingsManager()->appSettings()->adaptToLinkQuality(), &Fact::rawValueChanged, this, &LinkQualityAdapter::_enabledChanged);
+
+#if defined(QGC_GST_MICROHARD_ENABLED)
+    connect(qgcApp()->toolbox()->microhardManager(), &MicrohardManager::statusUpdated, this, &LinkQualityAdapter::_microhardStatusUpdated);
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED)
+    connect(qgcApp()->toolbox()->taisyncManager(), &TaisyncManager::linkChanged, this, &LinkQualityAdapter::_taisyncLinkChanged);
+#endif
+}
+
+double LinkQualityAdapter::marginDb(void) const
+{
+    double  margin  = qQNaN();
+    qint64  now     = _clock.elapsed();
+    for (int i = 0; i < SourceCount; i++) {
+        if (_marginMSecs[i] >= 0 && now - _marginMSecs[i] <= _staleMSecs && (qIsNaN(margin) || _margin[i] < margin)) {
+            margin = _margin[i];
+        }
+    }
+    return margin;
+}
+
+void LinkQualityAdapter::reportMargin(Source source, double marginDb)
+{
+    if (qIsNaN(marginDb)) {
+        return;
+    }
+    _margin[source]         = marginDb;
+    _marginMSecs[source]    = _clock.elapsed();
+    emit marginDbChanged();
+}
+
+double LinkQualityAdapter::radioStatusMarginDb(const mavlink_radio_status_t& radioStatus)
+{
+    if (radioStatus.rssi == UINT8_MAX || radioStatus.noise == UINT8_MAX) {
+        return qQNaN();
+    }
+
+    // Units are radio specific. SiK reports register values at ~1.9 steps per dB and everything else we have seen
+    // uses a similar scale, which is close enough to pick a threshold.
+    double margin = (static_cast<double>(radioStatus.rssi) - radioStatus.noise) / _siKUnitsPerDb;
+    if (radioStatus.remrssi != UINT8_MAX && radioStatus.remnoise != UINT8_MAX) {
+        margin = qMin(margin, (static_cast<double>(radioStatus.remrssi) - radioStatus.remnoise) / _siKUnitsPerDb);
+    }
+    if (radioStatus.txbuf != UINT8_MAX && radioStatus.txbuf < _minTxBufferPercent) {
+        // Radio can't keep up with what we are sending, which hurts commands as much as a weak signal
+        margin = 0;
+    }
+    return margin;
+}
+
+#if defined(QGC_GST_MICROHARD_ENABLED)
+void LinkQualityAdapter::_microhardStatusUpdated(bool /*air*/, int rssi, int snr)
+{
+    reportMargin(SourceMicrohard, snr > 0 ? snr : rssi - _nominalNoiseFloorDbm);
+}
+#endif
+
+#if defined(QGC_GST_TAISYNC_ENABLED)
+void LinkQualityAdapter::_taisyncLinkChanged(void)
+{
+    TaisyncManager* taisyncManager  = qgcApp()->toolbox()->taisyncManager();
+    int             rssi            = qMin(taisyncManager->uplinkRSSI(), taisyncManager->downlinkRSSI());
+    if (rssi < 0) {
+        reportMargin(SourceTaisync, rssi - _nominalNoiseFloorDbm);
+    }
+}
+#endif
+
+bool LinkQualityAdapter::_enabled(void) const
+{
+    return qgcApp()->toolbox()->settingsManager()->appSettings()->adaptToLinkQuality()->rawValue().toBool();
+}
+
+void LinkQualityAdapter::_enabledChanged(void)
+{
+    if (!_enabled()) {
+        _setDegraded(false);
+    }
+}
+
+void LinkQualityAdapter::_evaluate(void)
+{
+    double margin = marginDb();
+    if (qIsNaN(margin) || !_enabled()) {
+        // Nothing to go on, stay as we are
+        _belowSinceMSecs = _aboveSinceMSecs = -1;
+        return;
+    }
+
+    qint64 now = _clock.elapsed();
+    if (!_degraded) {
+        if (margin < degradeMarginDb) {
+            if (_belowSinceMSecs < 0) {
+                _belowSinceMSecs = now;
+            }
+            if (now - _belowSinceMSecs >= degradeHoldMSecs) {
+                _setDegraded(true);
+            }
+        } else {
+            _belowSinceMSecs = -1;
+        }
+    } else {
+        if (margin > recoverMarginDb) {
+            if (_aboveSinceMSecs < 0) {
+                _aboveSinceMSecs = now;
+            }
+            if (now - _aboveSinceMSecs >= recoverHoldMSecs) {
+                _setDegraded(false);
+            }
+        } else {
+            _aboveSinceMSecs = -1;
+        }
+    }
+}
+
+void LinkQualityAdapter::_setDegraded(bool degraded)
+{
+    _belowSinceMSecs = _aboveSinceMSecs = -1;
+    if (degraded == _degraded) {
+        return;
+    }
+
+    qCDebug(LinkQualityAdapterLog) << (degraded ? "Link degraded, backing off" : "Link recovered, restoring") << "margin" << marginDb();
+    _degraded = degraded;
+    _shedTelemetry(degraded);
+    _reduceVideo(degraded);
+    emit degradedChanged(_degraded);
+}
+
+void LinkQualityAdapter::_shedTelemetry(bool shed)
+{
+    MessageIntervalManager* messageIntervalManager = _vehicle->messageIntervalManager();
+    if (!messageIntervalManager) {
+        return;
+    }
+    for (int i = 0; i < _sheddableMessageCount; i++) {
+        messageIntervalManager->setRateCap(_sheddableMessages[i], shed ? _shedRateHz : 0);
+    }
+}
+
+void LinkQualityAdapter::_reduceVideo(bool reduce)
+{
+#if defined(QGC_GST_TAISYNC_ENABLED)
+    // The Taisync radio is shared, only the active vehicle gets to change it
+    TaisyncManager* taisyncManager = qgcApp()->toolbox()->taisyncManager();
+    if (reduce) {
+        if (_savedVideoRate < 0 && taisyncManager->linkConnected() && qgcApp()->toolbox()->multiVehicleManager()->activeVehicle() == _vehicle) {
+            _savedVideoRate = taisyncManager->videoRate()->rawValue().toInt();
+            if (_savedVideoRate > 0) {
+                taisyncManager->videoRate()->setRawValue(0);
+            }
+        }
+    } else if (_savedVideoRate >= 0) {
+        if (_savedVideoRate > 0 && taisyncManager->linkConnected()) {
+            taisyncManager->videoRate()->setRawValue(_savedVideoRate);
+        }
+        _savedVideoRate = -1;
+    }
+#else
+    Q_UNUSED(reduce)
+#endif
+}
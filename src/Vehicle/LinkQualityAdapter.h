@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include "QGCMAVLink.h"
+
+Q_DECLARE_LOGGING_CATEGORY(LinkQualityAdapterLog)
+
+class Vehicle;
+
+/// Backs off non-essential traffic while the radio link to the vehicle is marginal.
+///
+/// Link margin (signal over noise, in dB) comes from RADIO_STATUS and from the Microhard and Taisync radio managers,
+/// the worst recent report counts. Once the margin has stayed below degradeMarginDb for a while, non-essential
+/// telemetry is capped through MessageIntervalManager and the Taisync video bitrate is dropped to its lowest setting.
+/// Both are put back once the margin has been above recoverMarginDb for longer, so the link doesn't flap between the
+/// two states.
+class LinkQualityAdapter : public QObject
+{
+    Q_OBJECT
+
+public:
+    LinkQualityAdapter(Vehicle* vehicle);
+
+    enum Source {
+        SourceRadioStatus,
+        SourceMicrohard,
+        SourceTaisync,
+        SourceCount
+    };
+
+    Q_PROPERTY(bool     degraded    READ degraded   NOTIFY degradedChanged)
+    Q_PROPERTY(double   marginDb    READ marginDb   NOTIFY marginDbChanged)
+
+    bool    degraded    (void) const { return _degraded; }
+    double  marginDb    (void) const;   ///< Worst recent margin, NaN if no radio is reporting
+
+    void    reportMargin(Source source, double marginDb);
+
+    /// @return Worst of the local and remote margin in a RADIO_STATUS, NaN if the radio doesn't report them
+    static double radioStatusMarginDb(const mavlink_radio_status_t& radioStatus);
+
+    static constexpr double degradeMarginDb     = 10.0;
+    static constexpr double recoverMarginDb     = 15.0;
+    static const int        degradeHoldMSecs    = 3000;     ///< Margin must stay low this long before backing off
+    static const int        recoverHoldMSecs    = 10000;    ///< Margin must stay good this long before restoring
+
+signals:
+    void degradedChanged(bool degraded);
+    void marginDbChanged(void);
+
+private slots:
+    void _evaluate          (void);
+    void _enabledChanged    (void);
+#if defined(QGC_GST_MICROHARD_ENABLED)
+    void _microhardStatusUpdated(bool air, int rssi, int snr);
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED)
+    void _taisyncLinkChanged(void);
+#endif
+
+private:
+    bool    _enabled        (void) const;
+    void    _setDegraded    (bool degraded);
+    void    _shedTelemetry  (bool shed);
+    void    _reduceVideo    (bool reduce);
+
+    Vehicle*        _vehicle;
+    QTimer          _evaluateTimer;
+    QElapsedTimer   _clock;
+    double          _margin         [SourceCount];
+    qint64          _marginMSecs    [SourceCount];
+    bool            _degraded           = false;
+    qint64          _belowSinceMSecs    = -1;
+    qint64          _aboveSinceMSecs    = -1;
+    int             _savedVideoRate     = -1;           ///< Taisync video rate to go back to, -1: video not reduced
+
+    static const uint32_t   _sheddableMessages[];
+    static const int        _sheddableMessageCount;
+    static constexpr double _shedRateHz             = 1.0;
+    static constexpr double _nominalNoiseFloorDbm   = -95.0;    ///< For radios which only report RSSI
+    static constexpr double _siKUnitsPerDb          = 1.9;      ///< SiK RSSI/noise register steps per dB
+    static const int        _minTxBufferPercent     = 20;       ///< Less free radio buffer than this counts as no margin
+    static const int        _evaluateMSecs          = 1000;
+    static const int        _staleMSecs             = 5000;     ///< Margin reports older than this are ignored
+};
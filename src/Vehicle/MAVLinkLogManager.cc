@@ -110,10 +110,95 @@ MAVLinkLogFiles::setUploaded(bool uploaded)
     emit uploadedChanged();
 }
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+MAVLinkLogStreamWriter::MAVLinkLogStreamWriter(FILE* fd)
+    : _fd(fd)
+    , _ring(_ringSize, 0)
+    , _ringStart(0)
+    , _ringCount(0)
+    , _stop(false)
+    , _error(0)
+{
+    _ringData = _ring.data();
+}
+
+//-----------------------------------------------------------------------------
+MAVLinkLogStreamWriter::~MAVLinkLogStreamWriter()
+{
+    stop();
+}
+
+//-----------------------------------------------------------------------------
+bool
+MAVLinkLogStreamWriter::write(const void* data, int len)
+{
+    if(error()) {
+        return false;
+    }
+    QMutexLocker lock(&_mutex);
+    if(len > _ringSize - _ringCount) {
+        qCWarning(MAVLinkLogManagerLog) << "Log write buffer overrun, disk is not keeping up";
+        return false;
+    }
+    //-- Copy into the free space after the queued data, wrapping around the end of the ring
+    const int end   = (_ringStart + _ringCount) % _ringSize;
+    const int first = qMin(len, _ringSize - end);
+    memcpy(_ringData + end, data, static_cast<size_t>(first));
+    memcpy(_ringData, static_cast<const char*>(data) + first, static_cast<size_t>(len - first));
+    _ringCount += len;
+    _dataAvailable.wakeOne();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogStreamWriter::stop()
+{
+    {
+        QMutexLocker lock(&_mutex);
+        _stop = true;
+        _dataAvailable.wakeOne();
+    }
+    wait();
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogStreamWriter::run()
+{
+    QMutexLocker lock(&_mutex);
+    while(true) {
+        while(_ringCount == 0 && !_stop) {
+            _dataAvailable.wait(&_mutex);
+        }
+        if(_ringCount == 0) {
+            break;
+        }
+        //-- Write the contiguous block at the start of the queue without holding the lock. The producer only ever
+        //   copies into the free part of the ring so it never touches this block.
+        const int start = _ringStart;
+        const int count = qMin(_ringCount, _ringSize - start);
+        lock.unlock();
+        const bool failed = fwrite(_ringData + start, 1, static_cast<size_t>(count), _fd) != static_cast<size_t>(count);
+        lock.relock();
+        if(failed) {
+            qCWarning(MAVLinkLogManagerLog) << "File IO error:" << count << "bytes";
+            _error.storeRelease(1);
+            _ringCount = 0;
+            break;
+        }
+        _ringStart = (start + count) % _ringSize;
+        _ringCount -= count;
+    }
+    fflush(_fd);
+}
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 MAVLinkLogProcessor::MAVLinkLogProcessor()
     : _fd(nullptr)
+    , _writer(nullptr)
     , _written(0)
     , _sequence(-1)
     , _numDrops(0)
@@ -133,6 +218,11 @@ MAVLinkLogProcessor::~MAVLinkLogProcessor()
 void
 MAVLinkLogProcessor::close()
 {
+    if(_writer) {
+        _writer->stop();
+        delete _writer;
+        _writer = nullptr;
+    }
     if(_fd) {
         fclose(_fd);
         _fd = nullptr;
@@ -160,6 +250,8 @@ MAVLinkLogProcessor::create(MAVLinkLogManager* manager, const QString path, uint
         _record = new MAVLinkLogFiles(manager, _fileName, true);
         _record->setWriting(true);
         _sequence = -1;
+        _writer = new MAVLinkLogStreamWriter(_fd);
+        _writer->start();
         return true;
     }
     return false;
@@ -201,10 +293,10 @@ MAVLinkLogProcessor::_checkSequence(uint16_t seq, int& num_drops)
 
 //-----------------------------------------------------------------------------
 void
-MAVLinkLogProcessor::_writeData(void* data, int len)
+MAVLinkLogProcessor::_writeData(const void* data, int len)
 {
     if(!_error) {
-        _error = fwrite(data, 1, len, _fd) != (size_t)len;
+        _error = !_writer || !_writer->write(data, len);
         if(!_error) {
             _written += len;
             if(_record) {
@@ -222,13 +314,18 @@ MAVLinkLogProcessor::_writeUlogMessage(QByteArray& data)
 {
     //-- Write ulog data w/o integrity checking, assuming data starts with a
     //   valid ulog message. returns the remaining data at the end.
-    while(data.length() > 2) {
-        uint8_t* ptr = (uint8_t*)data.data();
+    int offset = 0;
+    while(data.length() - offset > 2) {
+        const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data.constData()) + offset;
         int message_length = ptr[0] + (ptr[1] * 256) + 3; // 3 = ULog msg header
-        if(message_length > data.length())
+        if(message_length > data.length() - offset)
             break;
-        _writeData(data.data(), message_length);
-        data.remove(0, message_length);
+        offset += message_length;
+    }
+    //-- Complete messages are contiguous, hand them to the writer in one go
+    if(offset) {
+        _writeData(data.constData(), offset);
+        data.remove(0, offset);
     }
     return data;
 }
@@ -238,7 +335,11 @@ bool
 MAVLinkLogProcessor::processStreamData(uint16_t sequence, uint8_t first_message, QByteArray data)
 {
     int num_drops = 0;
-    _error = false;
+    //-- A failed disk write is final, the writer gives up on the file
+    _error = !_writer || _writer->error();
+    if(_error) {
+        return false;
+    }
     while(_checkSequence(sequence, num_drops)) {
         //-- The first 16 bytes need special treatment (this sounds awfully brittle)
         if(!_gotHeader) {
@@ -359,6 +460,8 @@ MAVLinkLogManager::setToolbox(QGCToolbox* toolbox)
         }
         qCDebug(MAVLinkLogManagerLog) << "MAVLink logs directory:" << _logPath;
         connect(toolbox->multiVehicleManager(), &MultiVehicleManager::activeVehicleChanged, this, &MAVLinkLogManager::_activeVehicleChanged);
+        // Created on first use, so a vehicle may already be up
+        _activeVehicleChanged(toolbox->multiVehicleManager()->activeVehicle());
     }
 }
 
@@ -12,6 +12,10 @@
 #define MAVLinkLogManager_H
 
 #include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
 
 #include "QmlObjectListModel.h"
 #include "QGCLoggingCategory.h"
@@ -72,6 +76,39 @@ private:
     bool                _uploaded;
 };
 
+//-----------------------------------------------------------------------------
+/// Writes the log stream to disk on its own thread. Incoming data is copied into a ring buffer and written out in
+/// large blocks, so a slow disk or a busy GUI thread never holds up the processing of LOGGING_DATA messages.
+class MAVLinkLogStreamWriter : public QThread
+{
+public:
+    MAVLinkLogStreamWriter  (FILE* fd);
+    ~MAVLinkLogStreamWriter ();
+
+    /// Queues data to be written
+    /// @return false if the ring is full or a previous write failed
+    bool    write       (const void* data, int len);
+    /// Writes out everything which is queued and stops the thread
+    void    stop        ();
+    bool    error       () const { return _error.loadAcquire() != 0; }
+
+protected:
+    void    run         () final;
+
+private:
+    FILE*           _fd;
+    QByteArray      _ring;
+    char*           _ringData;          ///< Kept aside so the writer thread never touches the QByteArray itself
+    int             _ringStart;         ///< Offset of the oldest byte which still has to be written
+    int             _ringCount;         ///< Number of bytes waiting to be written
+    bool            _stop;
+    QAtomicInt      _error;
+    QMutex          _mutex;
+    QWaitCondition  _dataAvailable;
+
+    static const int _ringSize = 8 * 1024 * 1024;  ///< About 8 seconds of a high rate stream
+};
+
 //-----------------------------------------------------------------------------
 class MAVLinkLogProcessor
 {
@@ -87,9 +124,10 @@ public:
 private:
     bool                _checkSequence(uint16_t seq, int &num_drops);
     QByteArray          _writeUlogMessage(QByteArray &data);
-    void                _writeData(void* data, int len);
+    void                _writeData(const void* data, int len);
 private:
     FILE*               _fd;
+    MAVLinkLogStreamWriter* _writer;
     quint32             _written;
     int                 _sequence;
     int                 _numDrops;
@@ -0,0 +1,329 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MessageIntervalManager.h"
+#include "VehicleLinkManager.h"
+#include "QGCLoggingCategory.h"
+
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(MessageIntervalManagerLog, "MessageIntervalManagerLog")
+
+MessageIntervalManager::MessageIntervalManager(Vehicle* vehicle)
+    : QObject   (vehicle)
+    , _vehicle  (vehicle)
+{
+    _updateTimer.setSingleShot(true);
+    connect(&_updateTimer, &QTimer::timeout, this, &MessageIntervalManager::_update);
+
+    _responseTimer.setSingleShot(true);
+    _responseTimer.setInterval(_responseTimeoutMSecs);
+    connect(&_responseTimer, &QTimer::timeout, this, &MessageIntervalManager::_responseTimeout);
+}
+
+void MessageIntervalManager::subscribe(const void* subscriber, uint32_t messageId, double rateHz)
+{
+    if (rateHz <= 0) {
+        unsubscribe(subscriber, messageId);
+        return;
+    }
+
+    MessageInfo_t& info = _messageInfo(messageId);
+    info.subscribers[subscriber] = rateHz;
+
+    qCDebug(MessageIntervalManagerLog) << "subscribe msgId:rateHz:subscribers" << messageId << rateHz << info.subscribers.count();
+    _scheduleUpdate(_coalesceMSecs);
+}
+
+MessageIntervalManager::MessageInfo_t& MessageIntervalManager::_messageInfo(uint32_t messageId)
+{
+    // Entries live on after the last subscriber or cap goes away until the original rate has been restored
+    bool            newEntry    = !_messages.contains(messageId);
+    MessageInfo_t&  info        = _messages[messageId];
+    if (newEntry) {
+        info.haveOriginal           = false;
+        info.originalIntervalUSecs  = 0;
+        info.appliedIntervalUSecs   = 0;
+        info.capIntervalUSecs       = 0;
+        info.failed                 = false;
+    }
+    return info;
+}
+
+void MessageIntervalManager::setRateCap(uint32_t messageId, double maxRateHz)
+{
+    int32_t capIntervalUSecs = maxRateHz > 0 ? static_cast<int32_t>(std::lround(1000000.0 / maxRateHz)) : 0;
+
+    auto iter = _messages.find(messageId);
+    if (iter == _messages.end() && capIntervalUSecs == 0) {
+        return;
+    }
+    MessageInfo_t& info = iter == _messages.end() ? _messageInfo(messageId) : iter.value();
+    if (info.capIntervalUSecs != capIntervalUSecs) {
+        qCDebug(MessageIntervalManagerLog) << "setRateCap msgId:maxRateHz" << messageId << maxRateHz;
+        info.capIntervalUSecs = capIntervalUSecs;
+        _scheduleUpdate(_coalesceMSecs);
+    }
+}
+
+double MessageIntervalManager::rateCapHz(uint32_t messageId) const
+{
+    auto iter = _messages.constFind(messageId);
+    return iter == _messages.constEnd() || iter->capIntervalUSecs == 0 ? 0 : 1000000.0 / iter->capIntervalUSecs;
+}
+
+void MessageIntervalManager::unsubscribe(const void* subscriber, uint32_t messageId)
+{
+    auto iter = _messages.find(messageId);
+    if (iter != _messages.end() && iter->subscribers.remove(subscriber)) {
+        qCDebug(MessageIntervalManagerLog) << "unsubscribe msgId:subscribers" << messageId << iter->subscribers.count();
+        _scheduleUpdate(_coalesceMSecs);
+    }
+}
+
+void MessageIntervalManager::unsubscribeAll(const void* subscriber)
+{
+    bool changed = false;
+    for (MessageInfo_t& info: _messages) {
+        if (info.subscribers.remove(subscriber)) {
+            changed = true;
+        }
+    }
+    if (changed) {
+        _scheduleUpdate(_coalesceMSecs);
+    }
+}
+
+double MessageIntervalManager::subscribedRateHz(uint32_t messageId) const
+{
+    double rateHz = 0;
+    auto iter = _messages.constFind(messageId);
+    if (iter != _messages.constEnd()) {
+        for (double subscriberRateHz: iter->subscribers) {
+            rateHz = qMax(rateHz, subscriberRateHz);
+        }
+    }
+    return rateHz;
+}
+
+int32_t MessageIntervalManager::appliedIntervalUSecs(uint32_t messageId) const
+{
+    auto iter = _messages.constFind(messageId);
+    return iter == _messages.constEnd() ? 0 : iter->appliedIntervalUSecs;
+}
+
+void MessageIntervalManager::_scheduleUpdate(int delayMSecs)
+{
+    if (_vehicle->isOfflineEditingVehicle() || _unsupported || _commandPending) {
+        // When a command is outstanding the next update is kicked off by its result
+        return;
+    }
+    if (!_updateTimer.isActive() || _updateTimer.remainingTime() > delayMSecs) {
+        _updateTimer.start(delayMSecs);
+    }
+}
+
+int32_t MessageIntervalManager::_targetIntervalUSecs(const MessageInfo_t& info) const
+{
+    int32_t intervalUSecs = info.originalIntervalUSecs;
+
+    if (!info.subscribers.isEmpty()) {
+        double rateHz = 0;
+        for (double subscriberRateHz: info.subscribers) {
+            rateHz = qMax(rateHz, subscriberRateHz);
+        }
+        intervalUSecs = static_cast<int32_t>(std::lround(1000000.0 / rateHz));
+
+        // Never ask for a slower rate than the vehicle was already sending at
+        if (info.originalIntervalUSecs > 0) {
+            intervalUSecs = qMin(intervalUSecs, info.originalIntervalUSecs);
+        }
+    }
+
+    // The cap wins over subscribers, but a message the vehicle has disabled stays disabled
+    if (info.capIntervalUSecs > 0 && intervalUSecs >= 0 && (intervalUSecs == 0 || intervalUSecs < info.capIntervalUSecs)) {
+        intervalUSecs = info.capIntervalUSecs;
+    }
+    return intervalUSecs;
+}
+
+void MessageIntervalManager::_update(void)
+{
+    if (_commandPending || _unsupported) {
+        return;
+    }
+    if (!_vehicle->vehicleLinkManager()->primaryLink().lock()) {
+        _scheduleUpdate(_retryMSecs);
+        return;
+    }
+
+    // Only a single command is sent at a time, the result handler calls back in here for the next one
+    for (auto iter = _messages.begin(); iter != _messages.end(); ) {
+        uint32_t        messageId   = iter.key();
+        MessageInfo_t&  info        = iter.value();
+
+        if (info.subscribers.isEmpty() && info.capIntervalUSecs == 0) {
+            if (info.appliedIntervalUSecs != 0 && !info.failed) {
+                // Last subscriber or cap is gone, put back what the vehicle had before
+                _sendSetInterval(messageId, info.originalIntervalUSecs);
+                return;
+            }
+            iter = _messages.erase(iter);
+            continue;
+        }
+
+        if (!info.failed) {
+            if (!info.haveOriginal) {
+                _sendGetInterval(messageId);
+                return;
+            }
+            int32_t targetIntervalUSecs     = _targetIntervalUSecs(info);
+            int32_t currentIntervalUSecs    = info.appliedIntervalUSecs != 0 ? info.appliedIntervalUSecs : info.originalIntervalUSecs;
+            if (targetIntervalUSecs != currentIntervalUSecs) {
+                _sendSetInterval(messageId, targetIntervalUSecs);
+                return;
+            }
+        }
+        iter++;
+    }
+}
+
+void MessageIntervalManager::_sendGetInterval(uint32_t messageId)
+{
+    qCDebug(MessageIntervalManagerLog) << "GET_MESSAGE_INTERVAL msgId" << messageId;
+
+    _commandPending     = true;
+    _pendingGet         = true;
+    _pendingMessageId   = messageId;
+    _vehicle->sendMavCommandWithHandler(_getIntervalResultHandler, this, _vehicle->defaultComponentId(), MAV_CMD_GET_MESSAGE_INTERVAL, messageId);
+}
+
+void MessageIntervalManager::_sendSetInterval(uint32_t messageId, int32_t intervalUSecs)
+{
+    qCDebug(MessageIntervalManagerLog) << "SET_MESSAGE_INTERVAL msgId:intervalUSecs" << messageId << intervalUSecs;
+
+    _commandPending         = true;
+    _pendingGet             = false;
+    _pendingMessageId       = messageId;
+    _pendingIntervalUSecs   = intervalUSecs;
+    _vehicle->sendMavCommandWithHandler(_setIntervalResultHandler, this, _vehicle->defaultComponentId(), MAV_CMD_SET_MESSAGE_INTERVAL, messageId, intervalUSecs);
+}
+
+void MessageIntervalManager::_getIntervalResultHandler(void* resultHandlerData, int /*compId*/, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode)
+{
+    MessageIntervalManager* manager = static_cast<MessageIntervalManager*>(resultHandlerData);
+
+    if (result != MAV_RESULT_ACCEPTED) {
+        manager->_commandFailed(result, failureCode);
+        return;
+    }
+
+    // The interval itself comes back in a MESSAGE_INTERVAL message which can arrive on either side of the ack
+    auto iter = manager->_messages.find(manager->_pendingMessageId);
+    if (iter != manager->_messages.end() && !iter->haveOriginal) {
+        manager->_responseTimer.start();
+    } else {
+        manager->_commandPending = false;
+        manager->_update();
+    }
+}
+
+void MessageIntervalManager::_setIntervalResultHandler(void* resultHandlerData, int /*compId*/, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode)
+{
+    MessageIntervalManager* manager = static_cast<MessageIntervalManager*>(resultHandlerData);
+
+    if (result != MAV_RESULT_ACCEPTED) {
+        manager->_commandFailed(result, failureCode);
+        return;
+    }
+
+    auto iter = manager->_messages.find(manager->_pendingMessageId);
+    if (iter != manager->_messages.end()) {
+        if (manager->_pendingIntervalUSecs == iter->originalIntervalUSecs) {
+            iter->appliedIntervalUSecs = 0;
+            if (iter->subscribers.isEmpty() && iter->capIntervalUSecs == 0) {
+                // Rate restored, forget the original since the vehicle may change it on its own from here
+                iter->haveOriginal = false;
+            }
+        } else {
+            iter->appliedIntervalUSecs = manager->_pendingIntervalUSecs;
+        }
+    }
+    manager->_commandPending = false;
+    manager->_update();
+}
+
+void MessageIntervalManager::_commandFailed(MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode)
+{
+    _commandPending = false;
+    _responseTimer.stop();
+
+    if (failureCode == Vehicle::MavCmdResultFailureDuplicateCommand) {
+        // Someone else has the same command outstanding, try again once it has completed
+        _scheduleUpdate(_retryMSecs);
+        return;
+    }
+
+    if (failureCode == Vehicle::MavCmdResultCommandResultOnly && result == MAV_RESULT_UNSUPPORTED) {
+        qCDebug(MessageIntervalManagerLog) << "Vehicle does not support message intervals";
+        _unsupported = true;
+        return;
+    }
+
+    // Leave this message alone from here on, the vehicle keeps its own rate
+    qCDebug(MessageIntervalManagerLog) << "Message interval command failed msgId:result:failureCode" << _pendingMessageId << result << failureCode;
+    auto iter = _messages.find(_pendingMessageId);
+    if (iter != _messages.end()) {
+        iter->failed = true;
+    }
+    _update();
+}
+
+void MessageIntervalManager::_responseTimeout(void)
+{
+    if (!_commandPending || !_pendingGet) {
+        return;
+    }
+
+    // No MESSAGE_INTERVAL came back, assume the vehicle is using its default rate
+    qCDebug(MessageIntervalManagerLog) << "MESSAGE_INTERVAL timeout msgId" << _pendingMessageId;
+    auto iter = _messages.find(_pendingMessageId);
+    if (iter != _messages.end()) {
+        iter->haveOriginal          = true;
+        iter->originalIntervalUSecs = 0;
+    }
+    _commandPending = false;
+    _update();
+}
+
+void MessageIntervalManager::mavlinkMessageReceived(const mavlink_message_t& message)
+{
+    if (message.msgid != MAVLINK_MSG_ID_MESSAGE_INTERVAL) {
+        return;
+    }
+
+    mavlink_message_interval_t messageInterval;
+    mavlink_msg_message_interval_decode(&message, &messageInterval);
+
+    auto iter = _messages.find(messageInterval.message_id);
+    if (iter == _messages.end() || iter->haveOriginal) {
+        return;
+    }
+
+    qCDebug(MessageIntervalManagerLog) << "MESSAGE_INTERVAL msgId:intervalUSecs" << messageInterval.message_id << messageInterval.interval_us;
+    iter->haveOriginal          = true;
+    iter->originalIntervalUSecs = messageInterval.interval_us;
+
+    if (_responseTimer.isActive() && _pendingMessageId == messageInterval.message_id) {
+        // Ack has already been received, so this completes the command
+        _responseTimer.stop();
+        _commandPending = false;
+        _update();
+    }
+}
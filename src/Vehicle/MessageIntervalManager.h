@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QLoggingCategory>
+
+#include "QGCMAVLink.h"
+#include "Vehicle.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MessageIntervalManagerLog)
+
+class MessageIntervalManagerTest;
+
+/// Raises vehicle message rates only while something in the UI is actually showing the data.
+///
+/// Live FactGroups, PID tuning and MAVLink Inspector charts subscribe to the messages they display along with the
+/// rate they need. While a message has subscribers the vehicle is asked to send it at the highest subscribed rate
+/// using MAV_CMD_SET_MESSAGE_INTERVAL, but never slower than the rate the vehicle was already using. Once the last
+/// subscriber goes away the rate the vehicle had before is put back. Commands go out one at a time and bursts of
+/// subscription changes are coalesced, so views opening and closing quickly do not flood the link.
+///
+/// A message can also be capped at a maximum rate, which wins over any subscriber. This is how telemetry is shed when
+/// the link gets poor.
+class MessageIntervalManager : public QObject
+{
+    Q_OBJECT
+
+    friend class MessageIntervalManagerTest;
+
+public:
+    MessageIntervalManager(Vehicle* vehicle);
+
+    /// Registers interest in a message. Subscribing again with the same subscriber changes the rate.
+    ///     @param subscriber   Opaque key for the subscriber, used to unsubscribe
+    ///     @param rateHz       Rate the subscriber needs the message at
+    void subscribe      (const void* subscriber, uint32_t messageId, double rateHz);
+    void unsubscribe    (const void* subscriber, uint32_t messageId);
+    void unsubscribeAll (const void* subscriber);
+
+    /// Limits a message to maxRateHz regardless of subscribers. 0 removes the cap.
+    void setRateCap     (uint32_t messageId, double maxRateHz);
+
+    /// @return Highest subscribed rate for the message, 0 if there are no subscribers
+    double  subscribedRateHz    (uint32_t messageId) const;
+
+    /// @return Rate cap for the message, 0 if there is none
+    double  rateCapHz           (uint32_t messageId) const;
+
+    /// @return Interval QGC has set on the vehicle for the message, 0 if the vehicle is using its own rate
+    int32_t appliedIntervalUSecs(uint32_t messageId) const;
+
+    /// @return false: vehicle does not support MAV_CMD_SET_MESSAGE_INTERVAL
+    bool    supported           (void) const { return !_unsupported; }
+
+    void mavlinkMessageReceived(const mavlink_message_t& message);
+
+    static const int liveUpdatesRateHz = 10;    ///< Rate requested for the messages of FactGroups with live updates on
+
+private slots:
+    void _update            (void);
+    void _responseTimeout   (void);
+
+private:
+    typedef struct {
+        QHash<const void*, double>  subscribers;            ///< Requested rate keyed by subscriber
+        bool                        haveOriginal;           ///< true: originalIntervalUSecs has been queried
+        int32_t                     originalIntervalUSecs;  ///< Vehicle interval before QGC changed it, 0: vehicle default, -1: disabled
+        int32_t                     appliedIntervalUSecs;   ///< Interval QGC set, 0: not changed by QGC
+        int32_t                     capIntervalUSecs;       ///< Shortest interval allowed, 0: no cap
+        bool                        failed;                 ///< true: vehicle rejected changes to this message
+    } MessageInfo_t;
+
+    MessageInfo_t& _messageInfo     (uint32_t messageId);
+    void    _scheduleUpdate         (int delayMSecs);
+    int32_t _targetIntervalUSecs    (const MessageInfo_t& info) const;
+    void    _sendGetInterval        (uint32_t messageId);
+    void    _sendSetInterval        (uint32_t messageId, int32_t intervalUSecs);
+    void    _commandFailed          (MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode);
+
+    static void _getIntervalResultHandler(void* resultHandlerData, int compId, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode);
+    static void _setIntervalResultHandler(void* resultHandlerData, int compId, MAV_RESULT result, Vehicle::MavCmdResultFailureCode_t failureCode);
+
+    Vehicle*                            _vehicle;
+    QHash<uint32_t, MessageInfo_t>      _messages;
+    QTimer                              _updateTimer;
+    QTimer                              _responseTimer;             ///< Waits for MESSAGE_INTERVAL after GET_MESSAGE_INTERVAL is accepted
+    bool                                _unsupported        = false;
+    bool                                _commandPending     = false;
+    bool                                _pendingGet         = false;
+    uint32_t                            _pendingMessageId   = 0;
+    int32_t                             _pendingIntervalUSecs = 0;
+
+    static const int _coalesceMSecs         = 250;  ///< Delay after a subscription change before acting on it
+    static const int _retryMSecs            = 1000; ///< Delay before retrying when a command could not be sent
+    static const int _responseTimeoutMSecs  = 1000;
+};
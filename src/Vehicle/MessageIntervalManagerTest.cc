@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MessageIntervalManagerTest.h"
+#include "MessageIntervalManager.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "MockLink.h"
+
+void MessageIntervalManagerTest::_subscribeRestore_test(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    Vehicle*                vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    MessageIntervalManager* manager = vehicle->messageIntervalManager();
+
+    _mockLink->clearSendMavCommandCounts();
+
+    // First subscriber queries the existing rate and then raises it
+    manager->subscribe(this, MAVLINK_MSG_ID_ATTITUDE, 20);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 50000; }, 5000));
+    QVERIFY(QTest::qWaitFor([&]() { return manager->appliedIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 50000; }, 1000));
+    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_GET_MESSAGE_INTERVAL), 1);
+    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_SET_MESSAGE_INTERVAL), 1);
+
+    // Last subscriber leaving puts back the default rate
+    manager->unsubscribe(this, MAVLINK_MSG_ID_ATTITUDE);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->sendMavCommandCount(MAV_CMD_SET_MESSAGE_INTERVAL) == 2; }, 5000));
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 0; }, 1000));
+    QCOMPARE(manager->subscribedRateHz(MAVLINK_MSG_ID_ATTITUDE), 0.0);
+
+    _disconnectMockLink();
+}
+
+void MessageIntervalManagerTest::_highestRateWins_test(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    Vehicle*                vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    MessageIntervalManager* manager = vehicle->messageIntervalManager();
+    int                     other   = 0;
+
+    manager->subscribe(this,    MAVLINK_MSG_ID_ATTITUDE, 5);
+    manager->subscribe(&other,  MAVLINK_MSG_ID_ATTITUDE, 20);
+    QCOMPARE(manager->subscribedRateHz(MAVLINK_MSG_ID_ATTITUDE), 20.0);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 50000; }, 5000));
+
+    manager->unsubscribe(&other, MAVLINK_MSG_ID_ATTITUDE);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 200000; }, 5000));
+
+    manager->unsubscribeAll(this);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 0; }, 5000));
+
+    _disconnectMockLink();
+}
+
+void MessageIntervalManagerTest::_neverSlower_test(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    Vehicle*                vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    MessageIntervalManager* manager = vehicle->messageIntervalManager();
+
+    // Vehicle is already sending faster than requested so the rate should be left alone
+    _mockLink->setMessageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE, 20000);
+    _mockLink->clearSendMavCommandCounts();
+
+    manager->subscribe(this, MAVLINK_MSG_ID_ATTITUDE, 10);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->sendMavCommandCount(MAV_CMD_GET_MESSAGE_INTERVAL) == 1; }, 5000));
+    QTest::qWait(500);
+    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_SET_MESSAGE_INTERVAL), 0);
+    QCOMPARE(manager->appliedIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE), 0);
+
+    manager->unsubscribe(this, MAVLINK_MSG_ID_ATTITUDE);
+    QTest::qWait(500);
+    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_SET_MESSAGE_INTERVAL), 0);
+    QCOMPARE(_mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE), 20000);
+
+    _disconnectMockLink();
+}
+
+void MessageIntervalManagerTest::_factGroupLiveUpdates_test(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    Vehicle*                vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    MessageIntervalManager* manager = vehicle->messageIntervalManager();
+
+    vehicle->setpointFactGroup()->setLiveUpdates(true);
+    QCOMPARE(manager->subscribedRateHz(MAVLINK_MSG_ID_ATTITUDE_TARGET), static_cast<double>(MessageIntervalManager::liveUpdatesRateHz));
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE_TARGET) == 1000000 / MessageIntervalManager::liveUpdatesRateHz; }, 5000));
+
+    vehicle->setpointFactGroup()->setLiveUpdates(false);
+    QCOMPARE(manager->subscribedRateHz(MAVLINK_MSG_ID_ATTITUDE_TARGET), 0.0);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE_TARGET) == 0; }, 5000));
+
+    _disconnectMockLink();
+}
+
+void MessageIntervalManagerTest::_rateCap_test(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    Vehicle*                vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    MessageIntervalManager* manager = vehicle->messageIntervalManager();
+
+    manager->subscribe(this, MAVLINK_MSG_ID_ATTITUDE, 20);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 50000; }, 5000));
+
+    // Cap wins over the subscriber
+    manager->setRateCap(MAVLINK_MSG_ID_ATTITUDE, 2);
+    QCOMPARE(manager->rateCapHz(MAVLINK_MSG_ID_ATTITUDE), 2.0);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 500000; }, 5000));
+
+    // Subscriber rate comes back with the cap gone
+    manager->setRateCap(MAVLINK_MSG_ID_ATTITUDE, 0);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 50000; }, 5000));
+
+    // A cap with no subscribers still slows the message, and removing it puts back the vehicle rate
+    manager->unsubscribe(this, MAVLINK_MSG_ID_ATTITUDE);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_ATTITUDE) == 0; }, 5000));
+    _mockLink->setMessageIntervalUSecs(MAVLINK_MSG_ID_VFR_HUD, 100000);
+    manager->setRateCap(MAVLINK_MSG_ID_VFR_HUD, 1);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_VFR_HUD) == 1000000; }, 5000));
+    manager->setRateCap(MAVLINK_MSG_ID_VFR_HUD, 0);
+    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->messageIntervalUSecs(MAVLINK_MSG_ID_VFR_HUD) == 100000; }, 5000));
+
+    _disconnectMockLink();
+}
@@ -0,0 +1,24 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MessageIntervalManagerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _subscribeRestore_test     (void);
+    void _highestRateWins_test      (void);
+    void _neverSlower_test          (void);
+    void _factGroupLiveUpdates_test (void);
+    void _rateCap_test              (void);
+};
@@ -121,7 +121,10 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
         _app->showAppMessage(tr("Warning: A vehicle is using the same system id as %1: %2").arg(qgcApp()->applicationName()).arg(vehicleId));
     }
 
-    Vehicle* vehicle = new Vehicle(link, vehicleId, componentId, (MAV_AUTOPILOT)vehicleFirmwareType, (MAV_TYPE)vehicleType, _firmwarePluginManager, _joystickManager);
+    // In fleet mode only the first vehicle, which becomes the active one, is fully initialized right away
+    bool reducedPipeline = _vehicles.count() > 0 && qgcApp()->toolbox()->settingsManager()->appSettings()->fleetMode()->rawValue().toBool();
+
+    Vehicle* vehicle = new Vehicle(link, vehicleId, componentId, (MAV_AUTOPILOT)vehicleFirmwareType, (MAV_TYPE)vehicleType, _firmwarePluginManager, _joystickManager, reducedPipeline);
     connect(vehicle,                        &Vehicle::requestProtocolVersion,           this, &MultiVehicleManager::_requestProtocolVersion);
     connect(vehicle->vehicleLinkManager(),  &VehicleLinkManager::allLinksRemoved,       this, &MultiVehicleManager::_deleteVehiclePhase1);
     connect(vehicle->parameterManager(),    &ParameterManager::parametersReadyChanged,  this, &MultiVehicleManager::_vehicleParametersReadyChanged);
@@ -236,6 +239,9 @@ void MultiVehicleManager::_deleteVehiclePhase2(void)
     }
 
     _activeVehicle = newActiveVehicle;
+    if (_activeVehicle) {
+        _activeVehicle->startFullPipeline();
+    }
     emit activeVehicleChanged(newActiveVehicle);
 
     if (_activeVehicle) {
@@ -284,8 +290,11 @@ void MultiVehicleManager::_setActiveVehiclePhase2(void)
         connect(_vehicleBeingSetActive, &Vehicle::coordinateChanged, this, &MultiVehicleManager::_coordinateChanged);
     }
 
-    // Now we signal the new active vehicle
+    // Now we signal the new active vehicle, a fleet vehicle gets its full initialization the first time it is selected
     _activeVehicle = _vehicleBeingSetActive;
+    if (_activeVehicle) {
+        _activeVehicle->startFullPipeline();
+    }
     emit activeVehicleChanged(_activeVehicle);
 
     // And finally vehicle availability
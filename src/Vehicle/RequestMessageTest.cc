@@ -62,25 +62,58 @@ void RequestMessageTest::_duplicateCommand(void)
 {
     _connectMockLinkNoInitialConnectSequence();
 
-    RequestMessageTest::TestCase_t testCase = {
-        MockLink::FailRequestMessageCommandNoResponse, MAV_RESULT_FAILED, Vehicle::RequestMessageFailureDuplicateCommand, 1, false
+    RequestMessageTest::TestCase_t testCase1 = {
+        MockLink::FailRequestMessageCommandAcceptedMsgNotSent, MAV_RESULT_FAILED, Vehicle::RequestMessageFailureMessageNotReceived, 1, false
     };
+    RequestMessageTest::TestCase_t testCase2 = testCase1;
 
     MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
     Vehicle*                vehicle     = vehicleMgr->activeVehicle();
 
     _mockLink->clearSendMavCommandCounts();
-    _mockLink->setRequestMessageFailureMode(testCase.failureMode);
+    _mockLink->setRequestMessageFailureMode(testCase1.failureMode);
 
-    vehicle->requestMessage(_requestMessageResultHandler, &testCase, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_DEBUG);
-    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->sendMavCommandCount(MAV_CMD_REQUEST_MESSAGE) == 1; }, 10));
-    QCOMPARE(testCase.resultHandlerCalled, false);
-    vehicle->requestMessage(_requestMessageResultHandler, &testCase, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_DEBUG);
+    vehicle->requestMessage(_requestMessageResultHandler, &testCase1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_DEBUG);
+    vehicle->requestMessage(_requestMessageResultHandler, &testCase2, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_DEBUG);
 
-    // Duplicate command returns immediately
-    QCOMPARE(testCase.resultHandlerCalled,                                                              true);
-    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_REQUEST_MESSAGE),                                   testCase.expectedSendCount);
-    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, MAV_CMD_REQUEST_MESSAGE) != -1);
+    // Duplicate request waits for the first one to complete
+    QCOMPARE(vehicle->_mavCommandQueue.value(MAV_COMP_ID_AUTOPILOT1).count(), 1);
+    QVERIFY(QTest::qWaitFor([&]() { return testCase1.resultHandlerCalled; }, 10000));
+    QCOMPARE(testCase2.resultHandlerCalled, false);
+    QVERIFY(QTest::qWaitFor([&]() { return testCase2.resultHandlerCalled; }, 10000));
+    QCOMPARE(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, MAV_CMD_REQUEST_MESSAGE),   -1);
+    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_REQUEST_MESSAGE),                                   2);
+}
+
+void RequestMessageTest::_concurrentRequests(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    // The mock link only knows how to send DEBUG, so the other request is turned down
+    RequestMessageTest::TestCase_t debugTestCase = {
+        MockLink::FailRequestMessageCommandAcceptedMsgNotSent, MAV_RESULT_FAILED, Vehicle::RequestMessageFailureMessageNotReceived, 1, false
+    };
+    RequestMessageTest::TestCase_t unsupportedTestCase = {
+        MockLink::FailRequestMessageCommandAcceptedMsgNotSent, MAV_RESULT_UNSUPPORTED, Vehicle::RequestMessageFailureCommandError, 1, false
+    };
+
+    MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
+    Vehicle*                vehicle     = vehicleMgr->activeVehicle();
+
+    _mockLink->clearSendMavCommandCounts();
+    _mockLink->setRequestMessageFailureMode(debugTestCase.failureMode);
+
+    vehicle->requestMessage(_requestMessageResultHandler, &debugTestCase,       MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_DEBUG);
+    vehicle->requestMessage(_requestMessageResultHandler, &unsupportedTestCase, MAV_COMP_ID_AUTOPILOT1, MAVLINK_MSG_ID_PROTOCOL_VERSION);
+
+    // Requests for different messages are in flight together, each with its own message wait
+    QVERIFY(vehicle->_mavCommandQueue.isEmpty());
+    QCOMPARE(vehicle->_waitForMavlinkMessages.count(), 2);
+
+    QVERIFY(QTest::qWaitFor([&]() { return debugTestCase.resultHandlerCalled && unsupportedTestCase.resultHandlerCalled; }, 10000));
+    QCOMPARE(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, MAV_CMD_REQUEST_MESSAGE),   -1);
+    QCOMPARE(_mockLink->sendMavCommandCount(MAV_CMD_REQUEST_MESSAGE),                                   2);
+    QVERIFY(vehicle->_waitForMavlinkMessages.isEmpty());
 }
 
 void RequestMessageTest::_compIdAllRequestMessageResultHandler(void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& /*message*/)
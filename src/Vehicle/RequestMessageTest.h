@@ -24,6 +24,7 @@ private slots:
     void _performTestCases(void);
     void _compIdAllFailure(void);
     void _duplicateCommand(void);
+    void _concurrentRequests(void);
 
 private:
     typedef struct {
@@ -21,7 +21,8 @@ SendMavCommandWithHandlerTest::TestCase_t SendMavCommandWithHandlerTest::_rgTest
     {  MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE_NO_RETRY,             MAV_RESULT_FAILED,      Vehicle::MavCmdResultFailureNoResponseToCommand,    1 },
 };
 
-bool SendMavCommandWithHandlerTest::_handlerCalled = false;
+bool SendMavCommandWithHandlerTest::_handlerCalled      = false;
+int  SendMavCommandWithHandlerTest::_handlerCallCount   = 0;
 
 void SendMavCommandWithHandlerTest::_mavCmdResultHandler(void* resultHandlerData, int compId, MAV_RESULT commandResult, Vehicle::MavCmdResultFailureCode_t failureCode)
 {
@@ -60,28 +61,61 @@ void SendMavCommandWithHandlerTest::_performTestCases(void)
     }
 }
 
+void SendMavCommandWithHandlerTest::_countingMavCmdResultHandler(void* resultHandlerData, int compId, MAV_RESULT commandResult, Vehicle::MavCmdResultFailureCode_t failureCode)
+{
+    _mavCmdResultHandler(resultHandlerData, compId, commandResult, failureCode);
+    _handlerCallCount++;
+}
+
 void SendMavCommandWithHandlerTest::_duplicateCommand(void)
 {
     _connectMockLinkNoInitialConnectSequence();
 
     SendMavCommandWithHandlerTest::TestCase_t testCase = {
-        MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE, MAV_RESULT_FAILED, Vehicle::MavCmdResultFailureDuplicateCommand, 1
+        MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED, MAV_RESULT_ACCEPTED, Vehicle::MavCmdResultCommandResultOnly, 2
     };
 
     MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
     Vehicle*                vehicle     = vehicleMgr->activeVehicle();
 
-    _handlerCalled = false;
+    _handlerCallCount = 0;
     _mockLink->clearSendMavCommandCounts();
-    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, testCase.command, true /* showError */);
-    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->sendMavCommandCount(testCase.command) == 1; }, 10));
-    QVERIFY(!_handlerCalled);
-    vehicle->sendMavCommandWithHandler(_mavCmdResultHandler, &testCase, MAV_COMP_ID_AUTOPILOT1, testCase.command);
+    vehicle->sendMavCommandWithHandler(_countingMavCmdResultHandler, &testCase, MAV_COMP_ID_AUTOPILOT1, testCase.command);
+    vehicle->sendMavCommandWithHandler(_countingMavCmdResultHandler, &testCase, MAV_COMP_ID_AUTOPILOT1, testCase.command);
+
+    // Duplicate command waits for the first one to complete
+    QCOMPARE(_handlerCallCount, 0);
+    QCOMPARE(vehicle->_mavCommandQueue.value(MAV_COMP_ID_AUTOPILOT1).count(), 1);
+
+    QVERIFY(QTest::qWaitFor([&]() { return _handlerCallCount == 2; }, 10000));
+    QCOMPARE(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, testCase.command), -1);
+    QVERIFY(vehicle->_mavCommandQueue.isEmpty());
+    QCOMPARE(_mockLink->sendMavCommandCount(testCase.command), testCase.expectedSendCount);
+}
+
+void SendMavCommandWithHandlerTest::_parallelCommands(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    SendMavCommandWithHandlerTest::TestCase_t acceptedTestCase  = _rgTestCases[0];
+    SendMavCommandWithHandlerTest::TestCase_t failedTestCase    = _rgTestCases[1];
+
+    MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
+    Vehicle*                vehicle     = vehicleMgr->activeVehicle();
+
+    _handlerCallCount = 0;
+    _mockLink->clearSendMavCommandCounts();
+    vehicle->sendMavCommandWithHandler(_countingMavCmdResultHandler, &acceptedTestCase,  MAV_COMP_ID_AUTOPILOT1, acceptedTestCase.command);
+    vehicle->sendMavCommandWithHandler(_countingMavCmdResultHandler, &failedTestCase,    MAV_COMP_ID_AUTOPILOT1, failedTestCase.command);
+
+    // Different commands are in flight together
+    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, acceptedTestCase.command) != -1);
+    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, failedTestCase.command) != -1);
+    QVERIFY(vehicle->_mavCommandQueue.isEmpty());
 
-    // Duplicate command response should happen immediately
-    QVERIFY(_handlerCalled);
-    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, testCase.command) != -1);
-    QCOMPARE(_mockLink->sendMavCommandCount(testCase.command), 1);
+    QVERIFY(QTest::qWaitFor([&]() { return _handlerCallCount == 2; }, 10000));
+    QCOMPARE(_mockLink->sendMavCommandCount(acceptedTestCase.command),  1);
+    QCOMPARE(_mockLink->sendMavCommandCount(failedTestCase.command),    1);
 }
 
 void SendMavCommandWithHandlerTest::_compIdAllMavCmdResultHandler(void* /*resultHandlerData*/, int compId, MAV_RESULT commandResult, Vehicle::MavCmdResultFailureCode_t failureCode)
@@ -20,6 +20,7 @@ private slots:
     void _performTestCases(void);
     void _compIdAllFailure(void);
     void _duplicateCommand(void);
+    void _parallelCommands(void);
 
 private:
     typedef struct {
@@ -33,8 +34,10 @@ private:
 
     static void _mavCmdResultHandler            (void* resultHandlerData, int compId, MAV_RESULT commandResult, Vehicle::MavCmdResultFailureCode_t failureCode);
     static void _compIdAllMavCmdResultHandler   (void* resultHandlerData, int compId, MAV_RESULT commandResult, Vehicle::MavCmdResultFailureCode_t failureCode);
+    static void _countingMavCmdResultHandler    (void* resultHandlerData, int compId, MAV_RESULT commandResult, Vehicle::MavCmdResultFailureCode_t failureCode);
 
     static bool _handlerCalled;
+    static int  _handlerCallCount;
 
     static TestCase_t _rgTestCases[];
 };
@@ -63,19 +63,24 @@ void SendMavCommandWithSignallingTest::_duplicateCommand(void)
     MultiVehicleManager*    vehicleMgr  = qgcApp()->toolbox()->multiVehicleManager();
     Vehicle*                vehicle     = vehicleMgr->activeVehicle();
 
-    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE, true /* showError */);
-    QVERIFY(QTest::qWaitFor([&]() { return _mockLink->sendMavCommandCount(MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE) == 1; }, 10));
     QSignalSpy spyResult(vehicle, &Vehicle::mavCommandResult);
-    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE, true /* showError */);
 
-    // Duplicate command returns immediately
-    QCOMPARE(spyResult.count(),                                                         1);
-    QList<QVariant> arguments = spyResult.takeFirst();
-    QCOMPARE(arguments.count(),                                                         5);
-    QCOMPARE(arguments.at(0).toInt(),                                                   vehicle->id());
-    QCOMPARE(arguments.at(2).toInt(),                                                   (int)MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE);
-    QCOMPARE(arguments.at(3).toInt(),                                                   (int)MAV_RESULT_FAILED);
-    QCOMPARE(arguments.at(4).value<Vehicle::MavCmdResultFailureCode_t>(),               Vehicle::MavCmdResultFailureDuplicateCommand);
-    QCOMPARE(_mockLink->sendMavCommandCount(MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE),    1);
-    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_NO_RESPONSE) != -1);
+    _mockLink->clearSendMavCommandCounts();
+    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED, true /* showError */);
+    vehicle->sendMavCommand(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED, true /* showError */);
+
+    // Duplicate command waits for the first one to complete
+    QCOMPARE(spyResult.count(),                                                 0);
+    QCOMPARE(vehicle->_mavCommandQueue.value(MAV_COMP_ID_AUTOPILOT1).count(),   1);
+
+    QVERIFY(QTest::qWaitFor([&]() { return spyResult.count() == 2; }, 10000));
+    for (const QList<QVariant>& arguments: spyResult) {
+        QCOMPARE(arguments.count(),                                             5);
+        QCOMPARE(arguments.at(0).toInt(),                                       vehicle->id());
+        QCOMPARE(arguments.at(2).toInt(),                                       (int)MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED);
+        QCOMPARE(arguments.at(3).toInt(),                                       (int)MAV_RESULT_ACCEPTED);
+        QCOMPARE(arguments.at(4).value<Vehicle::MavCmdResultFailureCode_t>(),   Vehicle::MavCmdResultCommandResultOnly);
+    }
+    QCOMPARE(_mockLink->sendMavCommandCount(MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED), 2);
+    QCOMPARE(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED), -1);
 }
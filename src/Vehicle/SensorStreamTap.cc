@@ -0,0 +1,207 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SensorStreamTap.h"
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(SensorStreamTapLog, "SensorStreamTapLog")
+
+SensorStreamBuffer::SensorStreamBuffer(int capacity)
+{
+    int size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    _samples.resize(size);
+    _mask = static_cast<quint64>(size - 1);
+}
+
+void SensorStreamBuffer::append(qint64 usecs, float value)
+{
+    const quint64 count = _writeCount.load(std::memory_order_relaxed);
+
+    Sample_t& sample = _samples[static_cast<int>(count & _mask)];
+    sample.usecs = usecs;
+    sample.value = value;
+
+    _writeCount.store(count + 1, std::memory_order_release);
+}
+
+quint64 SensorStreamBuffer::read(quint64 fromCount, QVector<Sample_t>& samples) const
+{
+    const quint64 capacity      = static_cast<quint64>(_samples.count());
+    const quint64 writeCount    = _writeCount.load(std::memory_order_acquire);
+
+    if (fromCount > writeCount) {
+        // Reader is ahead of a buffer it didn't come from, start over with what is there
+        fromCount = 0;
+    }
+    if (writeCount - fromCount > capacity) {
+        fromCount = writeCount - capacity;
+    }
+
+    const int firstNew = samples.count();
+    for (quint64 i = fromCount; i < writeCount; i++) {
+        samples.append(_samples[static_cast<int>(i & _mask)]);
+    }
+
+    // Anything the writer got around to again while we were copying is from the next lap, throw it away
+    const quint64 writeCountAfter = _writeCount.load(std::memory_order_acquire);
+    if (writeCountAfter - fromCount > capacity) {
+        const int overwritten = static_cast<int>(qMin(writeCountAfter - fromCount - capacity, writeCount - fromCount));
+        samples.remove(firstNew, overwritten);
+    }
+
+    return writeCount;
+}
+
+SensorStreamTap::SensorStreamTap(void)
+{
+    _receiveTimer.start();
+}
+
+QSharedPointer<SensorStreamBuffer> SensorStreamTap::subscribe(const QString& messageName, const QString& fieldName, int arrayIndex)
+{
+    const mavlink_message_info_t* msgInfo = mavlink_get_message_info_by_name(messageName.toLatin1().constData());
+    if (!msgInfo) {
+        qCWarning(SensorStreamTapLog) << "Unknown message" << messageName;
+        return QSharedPointer<SensorStreamBuffer>();
+    }
+
+    const QString key = QStringLiteral("%1[%2]").arg(fieldName).arg(arrayIndex);
+
+    MessageTap_t& messageTap = _taps[msgInfo->msgid];
+    for (const FieldTap_t& fieldTap: messageTap.fields) {
+        if (fieldTap.key == key) {
+            QSharedPointer<SensorStreamBuffer> buffer = fieldTap.buffer.toStrongRef();
+            if (buffer) {
+                return buffer;
+            }
+        }
+    }
+
+    if (messageTap.fields.isEmpty()) {
+        messageTap.timeOffset   = -1;
+        messageTap.timeUsecs    = false;
+        for (unsigned i = 0; i < msgInfo->num_fields; i++) {
+            const mavlink_field_info_t& fieldInfo = msgInfo->fields[i];
+            if (strcmp(fieldInfo.name, "time_usec") == 0 && fieldInfo.type == MAVLINK_TYPE_UINT64_T) {
+                messageTap.timeOffset   = static_cast<int>(fieldInfo.wire_offset);
+                messageTap.timeUsecs    = true;
+            } else if (strcmp(fieldInfo.name, "time_boot_ms") == 0 && fieldInfo.type == MAVLINK_TYPE_UINT32_T) {
+                messageTap.timeOffset   = static_cast<int>(fieldInfo.wire_offset);
+                messageTap.timeUsecs    = false;
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < msgInfo->num_fields; i++) {
+        const mavlink_field_info_t& fieldInfo = msgInfo->fields[i];
+        if (fieldName != QLatin1String(fieldInfo.name)) {
+            continue;
+        }
+
+        const int arrayLength = qMax(static_cast<int>(fieldInfo.array_length), 1);
+        if (fieldInfo.type == MAVLINK_TYPE_CHAR || arrayIndex < 0 || arrayIndex >= arrayLength) {
+            break;
+        }
+
+        static const int typeSizes[] = { 1, 1, 1, 2, 2, 4, 4, 8, 8, 4, 8 };   // Indexed by mavlink_message_type_t
+        QSharedPointer<SensorStreamBuffer> buffer(new SensorStreamBuffer(defaultCapacity));
+
+        FieldTap_t fieldTap;
+        fieldTap.key    = key;
+        fieldTap.offset = static_cast<int>(fieldInfo.wire_offset) + (arrayIndex * typeSizes[fieldInfo.type]);
+        fieldTap.type   = fieldInfo.type;
+        fieldTap.buffer = buffer;
+        messageTap.fields.append(fieldTap);
+
+        qCDebug(SensorStreamTapLog) << "Tapped" << messageName << key;
+        return buffer;
+    }
+
+    qCWarning(SensorStreamTapLog) << "Unknown or non-numeric field" << messageName << key;
+    if (messageTap.fields.isEmpty()) {
+        _taps.remove(msgInfo->msgid);
+    }
+    return QSharedPointer<SensorStreamBuffer>();
+}
+
+template<typename T>
+static float _rawValue(const uint8_t* p)
+{
+    T v;
+    memcpy(&v, p, sizeof(T));
+    return static_cast<float>(v);
+}
+
+qint64 SensorStreamTap::_messageTime(const MessageTap_t& messageTap, const uint8_t* payload) const
+{
+    if (messageTap.timeOffset < 0) {
+        return _receiveTimer.nsecsElapsed() / 1000;
+    }
+    if (messageTap.timeUsecs) {
+        uint64_t timeUsecs;
+        memcpy(&timeUsecs, payload + messageTap.timeOffset, sizeof(timeUsecs));
+        return static_cast<qint64>(timeUsecs);
+    }
+    uint32_t timeMsecs;
+    memcpy(&timeMsecs, payload + messageTap.timeOffset, sizeof(timeMsecs));
+    return static_cast<qint64>(timeMsecs) * 1000;
+}
+
+void SensorStreamTap::messageReceived(const mavlink_message_t& message)
+{
+    auto tapIter = _taps.find(message.msgid);
+    if (tapIter == _taps.end()) {
+        return;
+    }
+
+    // MAVLink 2 drops trailing zero bytes from the payload and the receive buffer past len isn't cleared, so fill them
+    // back in the same way the generated decoders do
+    uint8_t payload[MAVLINK_MAX_PAYLOAD_LEN];
+    memcpy(payload, &message.payload64[0], message.len);
+    memset(payload + message.len, 0, sizeof(payload) - message.len);
+
+    MessageTap_t&   messageTap  = tapIter.value();
+    const qint64    usecs       = _messageTime(messageTap, payload);
+
+    for (int i = messageTap.fields.count() - 1; i >= 0; i--) {
+        const FieldTap_t&                   fieldTap    = messageTap.fields[i];
+        QSharedPointer<SensorStreamBuffer>  buffer      = fieldTap.buffer.toStrongRef();
+
+        if (!buffer) {
+            qCDebug(SensorStreamTapLog) << "Untapped" << message.msgid << fieldTap.key;
+            messageTap.fields.removeAt(i);
+            continue;
+        }
+
+        const uint8_t*  p = payload + fieldTap.offset;
+        float           v = 0;
+        switch (fieldTap.type) {
+        case MAVLINK_TYPE_CHAR:                                     break;
+        case MAVLINK_TYPE_UINT8_T:  v = _rawValue<uint8_t>(p);     break;
+        case MAVLINK_TYPE_INT8_T:   v = _rawValue<int8_t>(p);      break;
+        case MAVLINK_TYPE_UINT16_T: v = _rawValue<uint16_t>(p);    break;
+        case MAVLINK_TYPE_INT16_T:  v = _rawValue<int16_t>(p);     break;
+        case MAVLINK_TYPE_UINT32_T: v = _rawValue<uint32_t>(p);    break;
+        case MAVLINK_TYPE_INT32_T:  v = _rawValue<int32_t>(p);     break;
+        case MAVLINK_TYPE_FLOAT:    v = _rawValue<float>(p);       break;
+        case MAVLINK_TYPE_DOUBLE:   v = _rawValue<double>(p);      break;
+        case MAVLINK_TYPE_UINT64_T: v = _rawValue<uint64_t>(p);    break;
+        case MAVLINK_TYPE_INT64_T:  v = _rawValue<int64_t>(p);     break;
+        }
+        buffer->append(usecs, v);
+    }
+
+    if (messageTap.fields.isEmpty()) {
+        _taps.erase(tapIter);
+    }
+}
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <QWeakPointer>
+
+#include <atomic>
+
+#include "QGCMAVLink.h"
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(SensorStreamTapLog)
+
+class SensorStreamTapTest;
+
+/// Fixed size ring of the most recent samples of one message field.
+///
+/// There is a single writer, the vehicle message dispatch, and any number of readers which poll it at frame rate. The
+/// writer never waits: once the ring is full the oldest samples are overwritten. Readers copy what they need and then
+/// drop anything the writer may have overwritten while they were copying, so no lock is needed on either side.
+class SensorStreamBuffer
+{
+public:
+    typedef struct {
+        qint64  usecs;  ///< Vehicle boot time when the message has one, otherwise receive time
+        float   value;
+    } Sample_t;
+
+    /// @param capacity Rounded up to a power of two
+    SensorStreamBuffer(int capacity);
+
+    void append(qint64 usecs, float value);
+
+    /// @return Number of samples appended so far, never decreases
+    quint64 writeCount(void) const { return _writeCount.load(std::memory_order_acquire); }
+
+    /// Appends the samples written since fromCount, or as many of the most recent ones as still are in the ring
+    ///     @return write count to pass as fromCount on the next read
+    quint64 read(quint64 fromCount, QVector<Sample_t>& samples) const;
+
+    int capacity(void) const { return _samples.count(); }
+
+private:
+    QVector<Sample_t>       _samples;
+    quint64                 _mask;
+    std::atomic<quint64>    _writeCount { 0 };
+};
+
+/// Copies the value of subscribed message fields into a SensorStreamBuffer as the messages arrive, so high rate
+/// telemetry can be charted without going through a Fact and a QML binding for every sample.
+///
+/// The field layout is looked up once when subscribing. After that each message costs a hash lookup and a memcpy per
+/// tapped field. Buffers are shared by everyone subscribed to the same field and the tap lets go of a field once the
+/// last subscriber drops its buffer.
+class SensorStreamTap
+{
+public:
+    SensorStreamTap(void);
+
+    /// @param messageName  MAVLink message name, for example ATTITUDE_QUATERNION
+    /// @param fieldName    Numeric field of the message
+    /// @param arrayIndex   Element to tap for array fields
+    /// @return Buffer fed with the field, null if the message or field is unknown or not numeric
+    QSharedPointer<SensorStreamBuffer> subscribe(const QString& messageName, const QString& fieldName, int arrayIndex = 0);
+
+    /// @return true: at least one field of the message is being tapped
+    bool isTapped(uint32_t messageId) const { return _taps.contains(messageId); }
+
+    /// Called by the vehicle for each message it dispatches
+    void messageReceived(const mavlink_message_t& message);
+
+    static const int defaultCapacity = 4096;   ///< About 16 seconds of a 250Hz stream
+
+private:
+    typedef struct {
+        QString                             key;            ///< fieldName[arrayIndex]
+        int                                 offset;         ///< Byte offset in the payload
+        mavlink_message_type_t              type;
+        QWeakPointer<SensorStreamBuffer>    buffer;
+    } FieldTap_t;
+
+    typedef struct {
+        int                 timeOffset;     ///< Offset of time_boot_ms or time_usec, -1 if the message has neither
+        bool                timeUsecs;      ///< true: time field is time_usec
+        QList<FieldTap_t>   fields;
+    } MessageTap_t;
+
+    qint64 _messageTime(const MessageTap_t& messageTap, const uint8_t* payload) const;
+
+    QHash<uint32_t, MessageTap_t>   _taps;
+    QElapsedTimer                   _receiveTimer;
+
+    friend class SensorStreamTapTest;
+};
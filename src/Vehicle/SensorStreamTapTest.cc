@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SensorStreamTapTest.h"
+#include "SensorStreamTap.h"
+
+void SensorStreamTapTest::_bufferWrap_test(void)
+{
+    SensorStreamBuffer buffer(100);
+    QCOMPARE(buffer.capacity(), 128);
+
+    QVector<SensorStreamBuffer::Sample_t> samples;
+    QCOMPARE(buffer.read(0, samples), static_cast<quint64>(0));
+    QVERIFY(samples.isEmpty());
+
+    for (int i = 0; i < 10; i++) {
+        buffer.append(i, i);
+    }
+    quint64 readCount = buffer.read(0, samples);
+    QCOMPARE(readCount, static_cast<quint64>(10));
+    QCOMPARE(samples.count(), 10);
+    QCOMPARE(samples[9].usecs, static_cast<qint64>(9));
+
+    // Only what was added since the last read is appended
+    buffer.append(10, 10);
+    readCount = buffer.read(readCount, samples);
+    QCOMPARE(readCount, static_cast<quint64>(11));
+    QCOMPARE(samples.count(), 11);
+    QCOMPARE(samples.last().value, 10.0f);
+
+    // A reader which falls more than a lap behind gets the most recent capacity samples
+    for (int i = 11; i < 500; i++) {
+        buffer.append(i, i);
+    }
+    samples.clear();
+    readCount = buffer.read(readCount, samples);
+    QCOMPARE(readCount, static_cast<quint64>(500));
+    QCOMPARE(samples.count(), 128);
+    QCOMPARE(samples.first().usecs, static_cast<qint64>(500 - 128));
+    QCOMPARE(samples.last().usecs, static_cast<qint64>(499));
+}
+
+void SensorStreamTapTest::_field_test(void)
+{
+    SensorStreamTap tap;
+
+    QSharedPointer<SensorStreamBuffer> rollspeed    = tap.subscribe(QStringLiteral("ATTITUDE_QUATERNION"), QStringLiteral("rollspeed"));
+    QSharedPointer<SensorStreamBuffer> yawspeed     = tap.subscribe(QStringLiteral("ATTITUDE_QUATERNION"), QStringLiteral("yawspeed"));
+    QVERIFY(rollspeed);
+    QVERIFY(yawspeed);
+    QVERIFY(rollspeed != yawspeed);
+    QVERIFY(tap.isTapped(MAVLINK_MSG_ID_ATTITUDE_QUATERNION));
+    QVERIFY(!tap.isTapped(MAVLINK_MSG_ID_ATTITUDE));
+
+    // Subscribing to the same field again shares the buffer
+    QVERIFY(tap.subscribe(QStringLiteral("ATTITUDE_QUATERNION"), QStringLiteral("rollspeed")) == rollspeed);
+
+    mavlink_message_t               message;
+    mavlink_attitude_quaternion_t   attitude = { };
+    attitude.time_boot_ms   = 1234;
+    attitude.rollspeed      = 0.5f;
+    attitude.yawspeed       = -1.25f;
+    mavlink_msg_attitude_quaternion_encode(1, 1, &message, &attitude);
+    tap.messageReceived(message);
+
+    // The trailing fields are zero, so MAVLink 2 trims them from the payload. Put junk past the end to make sure
+    // the tap doesn't read it.
+    attitude.time_boot_ms   = 1244;
+    attitude.rollspeed      = 0.75f;
+    attitude.yawspeed       = 0;
+    mavlink_msg_attitude_quaternion_encode(1, 1, &message, &attitude);
+    uint8_t* payload = reinterpret_cast<uint8_t*>(&message.payload64[0]);
+    memset(payload + message.len, 0xff, MAVLINK_MAX_PAYLOAD_LEN - message.len);
+    tap.messageReceived(message);
+
+    QVector<SensorStreamBuffer::Sample_t> samples;
+    rollspeed->read(0, samples);
+    QCOMPARE(samples.count(), 2);
+    QCOMPARE(samples[0].usecs, static_cast<qint64>(1234000));
+    QCOMPARE(samples[0].value, 0.5f);
+    QCOMPARE(samples[1].usecs, static_cast<qint64>(1244000));
+    QCOMPARE(samples[1].value, 0.75f);
+
+    samples.clear();
+    yawspeed->read(0, samples);
+    QCOMPARE(samples.count(), 2);
+    QCOMPARE(samples[0].value, -1.25f);
+    QCOMPARE(samples[1].value, 0.0f);
+}
+
+void SensorStreamTapTest::_arrayField_test(void)
+{
+    SensorStreamTap tap;
+
+    QSharedPointer<SensorStreamBuffer> q2 = tap.subscribe(QStringLiteral("ATTITUDE_TARGET"), QStringLiteral("q"), 2);
+    QVERIFY(q2);
+    QVERIFY(!tap.subscribe(QStringLiteral("ATTITUDE_TARGET"), QStringLiteral("q"), 4));
+
+    mavlink_message_t           message;
+    mavlink_attitude_target_t   target = { };
+    target.time_boot_ms = 10;
+    target.q[0]         = 1;
+    target.q[1]         = 2;
+    target.q[2]         = 3;
+    target.q[3]         = 4;
+    mavlink_msg_attitude_target_encode(1, 1, &message, &target);
+    tap.messageReceived(message);
+
+    QVector<SensorStreamBuffer::Sample_t> samples;
+    q2->read(0, samples);
+    QCOMPARE(samples.count(), 1);
+    QCOMPARE(samples[0].value, 3.0f);
+}
+
+void SensorStreamTapTest::_unknown_test(void)
+{
+    SensorStreamTap tap;
+
+    QVERIFY(!tap.subscribe(QStringLiteral("NOT_A_MESSAGE"), QStringLiteral("rollspeed")));
+    QVERIFY(!tap.subscribe(QStringLiteral("ATTITUDE"), QStringLiteral("not_a_field")));
+    QVERIFY(!tap.subscribe(QStringLiteral("STATUSTEXT"), QStringLiteral("text")));
+    QVERIFY(!tap.isTapped(MAVLINK_MSG_ID_ATTITUDE));
+    QVERIFY(!tap.isTapped(MAVLINK_MSG_ID_STATUSTEXT));
+}
+
+void SensorStreamTapTest::_untap_test(void)
+{
+    SensorStreamTap tap;
+
+    QSharedPointer<SensorStreamBuffer> roll = tap.subscribe(QStringLiteral("ATTITUDE"), QStringLiteral("roll"));
+    QVERIFY(tap.isTapped(MAVLINK_MSG_ID_ATTITUDE));
+
+    // The tap lets go of the message with the next one after the last buffer goes away
+    roll.clear();
+    QVERIFY(tap.isTapped(MAVLINK_MSG_ID_ATTITUDE));
+
+    mavlink_message_t   message;
+    mavlink_attitude_t  attitude = { };
+    mavlink_msg_attitude_encode(1, 1, &message, &attitude);
+    tap.messageReceived(message);
+    QVERIFY(!tap.isTapped(MAVLINK_MSG_ID_ATTITUDE));
+}
@@ -0,0 +1,24 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class SensorStreamTapTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _bufferWrap_test   (void);
+    void _field_test        (void);
+    void _arrayField_test   (void);
+    void _unknown_test      (void);
+    void _untap_test        (void);
+};
@@ -19,4 +19,7 @@ TerrainFactGroup::TerrainFactGroup(QObject* parent)
 {
     _addFact(&_blocksPendingFact,        _blocksPendingFactName);
     _addFact(&_blocksLoadedFact,       _blocksLoadedFactName);
+
+    // Values are set by the terrain protocol handler, no messages are needed
+    _setHandledMessageIds({ });
 }
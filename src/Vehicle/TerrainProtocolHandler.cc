@@ -39,8 +39,16 @@ bool TerrainProtocolHandler::mavlinkMessageReceived(const mavlink_message_t mess
 
 void TerrainProtocolHandler::_handleTerrainRequest(const mavlink_message_t& message)
 {
+    mavlink_terrain_request_t terrainRequest;
+    mavlink_msg_terrain_request_decode(&message, &terrainRequest);
+
+    // The vehicle repeats the request for the same grid with the blocks it still needs, so the heights are kept around
+    if (terrainRequest.lat != _currentTerrainRequest.lat || terrainRequest.lon != _currentTerrainRequest.lon || terrainRequest.grid_spacing != _currentTerrainRequest.grid_spacing) {
+        _gridLoaded = false;
+    }
+    _currentTerrainRequest = terrainRequest;
+    _currentTerrainRequest.mask &= (1ull << (_gridCols * _gridRows)) - 1;
     _terrainRequestActive = true;
-    mavlink_msg_terrain_request_decode(&message, &_currentTerrainRequest);
     _sendNextTerrainData();
 }
 
@@ -73,85 +81,93 @@ void TerrainProtocolHandler::_sendNextTerrainData(void)
         return;
     }
 
-    QGeoCoordinate terrainRequestCoordSWCorner(static_cast<double>(_currentTerrainRequest.lat) / 1e7, static_cast<double>(_currentTerrainRequest.lon) / 1e7);
-    int spacingBetweenGrids = _currentTerrainRequest.grid_spacing * 4;
-
-    // Each TERRAIN_DATA sent to vehicle contains a 4x4 grid of heights
-    // TERRAIN_REQUEST.mask has a bit for each entry in an 8x7 grid
-    // gridBit = 0 refers to the the sw corner of the 8x7 grid
-
-    bool bitFound = false;
-    for (int rowIndex=0; rowIndex<7; rowIndex++) {
-        for (int colIndex=0; colIndex<8; colIndex++) {
-            uint8_t gridBit = (rowIndex * 8) + colIndex;
-            uint64_t checkBit = 1ull << gridBit;
-            if (_currentTerrainRequest.mask & checkBit) {
-                // Move east and then north to generate the coordinate for sw corner of the specific gridBit
-                QGeoCoordinate swCorner = terrainRequestCoordSWCorner.atDistanceAndAzimuth(spacingBetweenGrids * colIndex, 90);
-                swCorner = swCorner.atDistanceAndAzimuth(spacingBetweenGrids * rowIndex, 0);
-                _sendTerrainData(swCorner, gridBit);
-                bitFound = true;
-                break;
-            }
-        }
-        if (bitFound) {
-            break;
-        }
+    if (!_gridLoaded && !_loadGrid()) {
+        // Heights are not available yet, the terrain system has queued the tiles for download. Try again on the next tick.
+        _terrainDataSendTimer.start();
+        return;
+    }
+
+    // gridBit = 0 refers to the the sw corner of the 8x7 grid, bits go east and then north
+    int cBlocksSent = 0;
+    while (_currentTerrainRequest.mask && cBlocksSent < _maxBlocksPerTick) {
+        uint8_t gridBit = static_cast<uint8_t>(qCountTrailingZeroBits(_currentTerrainRequest.mask));
+        _currentTerrainRequest.mask &= ~(1ull << gridBit);
+        _sendTerrainData(gridBit);
+        cBlocksSent++;
     }
 
-    if (bitFound) {
-        // Kick timer to send next possible TERRAIN_DATA to vehicle
+    if (_currentTerrainRequest.mask) {
+        // Kick timer to send the rest of the blocks to vehicle
         _terrainDataSendTimer.start();
     } else {
         _terrainRequestActive = false;
+        _terrainDataSendTimer.stop();
     }
 }
 
-void TerrainProtocolHandler::_sendTerrainData(const QGeoCoordinate& swCorner, uint8_t gridBit)
+bool TerrainProtocolHandler::_loadGrid(void)
 {
+    QGeoCoordinate  terrainRequestCoordSWCorner(static_cast<double>(_currentTerrainRequest.lat) / 1e7, static_cast<double>(_currentTerrainRequest.lon) / 1e7);
+    int             spacingBetweenGrids = _currentTerrainRequest.grid_spacing * 4;
+
+    // The whole grid goes to the terrain system in one query, ordered by grid bit so each block's heights are contiguous
     QList<QGeoCoordinate> coordinates;
-    for (int rowIndex=0; rowIndex<4; rowIndex++) {
-        for (int colIndex=0; colIndex<4; colIndex++) {
-            // Move east and then north to generate the coordinate for grid point
-            QGeoCoordinate coord = swCorner.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * colIndex, 90);
-            coord = coord.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * rowIndex, 0);
-            coordinates.append(coord);
+    coordinates.reserve(_gridCols * _gridRows * _blockPoints);
+    for (int gridRowIndex=0; gridRowIndex<_gridRows; gridRowIndex++) {
+        for (int gridColIndex=0; gridColIndex<_gridCols; gridColIndex++) {
+            // Move east and then north to generate the coordinate for sw corner of the specific gridBit
+            QGeoCoordinate swCorner = terrainRequestCoordSWCorner.atDistanceAndAzimuth(spacingBetweenGrids * gridColIndex, 90);
+            swCorner = swCorner.atDistanceAndAzimuth(spacingBetweenGrids * gridRowIndex, 0);
+
+            for (int rowIndex=0; rowIndex<4; rowIndex++) {
+                for (int colIndex=0; colIndex<4; colIndex++) {
+                    // Move east and then north to generate the coordinate for grid point
+                    QGeoCoordinate coord = swCorner.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * colIndex, 90);
+                    coord = coord.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * rowIndex, 0);
+                    coordinates.append(coord);
+                }
+            }
         }
     }
 
     // Query terrain system for altitudes. If it has them available it will return them. If not they will be queued for download.
     bool            error = false;
     QList<double>   altitudes;
-    if (TerrainAtCoordinateQuery::getAltitudesForCoordinates(coordinates, altitudes, error)) {
-        if (error) {
-            qCWarning(TerrainProtocolHandlerLog) << "_sendTerrainData TerrainAtCoordinateQuery::getAltitudesForCoordinates failed";
-        } else {
-            // Only clear the bit if the query succeeds. Otherwise just let it try again on the next timer tick
-            uint64_t removeBit = ~(1ull << gridBit);
-            _currentTerrainRequest.mask &= removeBit;
-            int altIndex = 0;
-            int16_t terrainData[16];
-            for (const double& altitude : altitudes) {
-                terrainData[altIndex++] = static_cast<int16_t>(altitude);
-            }
+    if (!TerrainAtCoordinateQuery::getAltitudesForCoordinates(coordinates, altitudes, error)) {
+        return false;
+    }
+    if (error) {
+        qCWarning(TerrainProtocolHandlerLog) << "_loadGrid TerrainAtCoordinateQuery::getAltitudesForCoordinates failed";
+        return false;
+    }
 
-            WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
-            if (!weakLink.expired()) {
-                mavlink_message_t       msg;
-                SharedLinkInterfacePtr  sharedLink = weakLink.lock();
-
-                mavlink_msg_terrain_data_pack_chan(
-                            qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
-                            qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
-                            sharedLink->mavlinkChannel(),
-                            &msg,
-                            _currentTerrainRequest.lat,
-                            _currentTerrainRequest.lon,
-                            _currentTerrainRequest.grid_spacing,
-                            gridBit,
-                            terrainData);
-                _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
-            }
-        }
+    for (int i=0; i<altitudes.count(); i++) {
+        _gridHeights[i] = static_cast<int16_t>(altitudes[i]);
+    }
+    _gridLoaded = true;
+
+    qCDebug(TerrainProtocolHandlerLog) << "_loadGrid loaded" << terrainRequestCoordSWCorner << _currentTerrainRequest.grid_spacing;
+
+    return true;
+}
+
+void TerrainProtocolHandler::_sendTerrainData(uint8_t gridBit)
+{
+    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
+    if (!weakLink.expired()) {
+        mavlink_message_t       msg;
+        SharedLinkInterfacePtr  sharedLink = weakLink.lock();
+
+        mavlink_msg_terrain_data_pack_chan(
+                    qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
+                    qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
+                    sharedLink->mavlinkChannel(),
+                    &msg,
+                    _currentTerrainRequest.lat,
+                    _currentTerrainRequest.lon,
+                    _currentTerrainRequest.grid_spacing,
+                    gridBit,
+                    &_gridHeights[gridBit * _blockPoints]);
+        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
     }
 }
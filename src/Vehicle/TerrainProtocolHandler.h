@@ -36,11 +36,20 @@ private slots:
 private:
     void _handleTerrainRequest  (const mavlink_message_t& message);
     void _handleTerrainReport   (const mavlink_message_t& message);
-    void _sendTerrainData       (const QGeoCoordinate& swCorner, uint8_t gridBit);
+    bool _loadGrid              (void);
+    void _sendTerrainData       (uint8_t gridBit);
+
+    // TERRAIN_REQUEST.mask has a bit for each block of an 8x7 grid, each TERRAIN_DATA carries the 4x4 heights of one block
+    static const int _gridCols          = 8;
+    static const int _gridRows          = 7;
+    static const int _blockPoints       = 16;
+    static const int _maxBlocksPerTick  = 8;    ///< Roughly what a 57600 baud telemetry radio can carry at the send rate
 
     Vehicle*                    _vehicle;
     TerrainFactGroup*           _terrainFactGroup;
     bool                        _terrainRequestActive =             false;
-    mavlink_terrain_request_t   _currentTerrainRequest;
+    bool                        _gridLoaded =                       false;  ///< true: _gridHeights holds the grid of _currentTerrainRequest
+    mavlink_terrain_request_t   _currentTerrainRequest =            {};
+    int16_t                     _gridHeights[_gridCols * _gridRows * _blockPoints]; ///< Heights for each block in grid bit order
     QTimer                      _terrainDataSendTimer;
 };
@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TrajectoryMapItem.h"
+#include "TrajectoryPoints.h"
+#include "QGCGeo.h"
+
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <QtMath>
+
+#include <cstring>
+
+/// Width of the world in pixels at the reference zoom level
+static double _referenceWorldSize(int referenceZoom)
+{
+    return 256.0 * qPow(2.0, referenceZoom);
+}
+
+TrajectoryMapItem::TrajectoryMapItem(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    connect(this, &TrajectoryMapItem::centerChanged,    this, &TrajectoryMapItem::_viewChanged);
+    connect(this, &TrajectoryMapItem::zoomLevelChanged, this, &TrajectoryMapItem::_viewChanged);
+    connect(this, &TrajectoryMapItem::bearingChanged,   this, &TrajectoryMapItem::_viewChanged);
+    connect(this, &QQuickItem::widthChanged,            this, &TrajectoryMapItem::_viewChanged);
+    connect(this, &QQuickItem::heightChanged,           this, &TrajectoryMapItem::_viewChanged);
+    connect(this, &TrajectoryMapItem::colorChanged,     this, &QQuickItem::update);
+    connect(this, &TrajectoryMapItem::lineWidthChanged, this, &QQuickItem::update);
+}
+
+void TrajectoryMapItem::setTrajectoryPoints(TrajectoryPoints* trajectoryPoints)
+{
+    if (trajectoryPoints == _trajectoryPoints) {
+        return;
+    }
+
+    if (_trajectoryPoints) {
+        disconnect(_trajectoryPoints, nullptr, this, nullptr);
+    }
+    _trajectoryPoints = trajectoryPoints;
+    if (_trajectoryPoints) {
+        connect(_trajectoryPoints, &TrajectoryPoints::pointAdded,       this, &TrajectoryMapItem::_updateVertices);
+        connect(_trajectoryPoints, &TrajectoryPoints::updateLastPoint,  this, &TrajectoryMapItem::_updateVertices);
+        connect(_trajectoryPoints, &TrajectoryPoints::pointsCleared,    this, &TrajectoryMapItem::_resetVertices);
+        connect(_trajectoryPoints, &QObject::destroyed,                 this, &TrajectoryMapItem::_resetVertices);
+    }
+
+    _resetVertices();
+    emit trajectoryPointsChanged();
+}
+
+int TrajectoryMapItem::_levelForView(void) const
+{
+    if (!_center.isValid()) {
+        return 0;
+    }
+
+    // Ground resolution of Web Mercator at the center of the map. A level is used while it is off by less than half a pixel.
+    const double    metersPerPixel  = (156543.03392 * qCos(qDegreesToRadians(_center.latitude()))) / qPow(2.0, _zoomLevel);
+    int             level           = 0;
+    while (level + 1 < TrajectoryPoints::levelCount && TrajectoryPoints::levelTolerance(level + 1) < metersPerPixel / 2.0) {
+        level++;
+    }
+    return level;
+}
+
+void TrajectoryMapItem::_appendVertex(double latitude, double longitude)
+{
+    double x;
+    double y;
+
+    convertGeoToWebMercator(latitude, longitude, _referenceWorldSize(_referenceZoom), x, y);
+    _vertices.push_back({ static_cast<float>(x - _originX), static_cast<float>(y - _originY) });
+}
+
+void TrajectoryMapItem::_resetVertices(void)
+{
+    _vertices.clear();
+    _stableVertexCount  = 0;
+    _level              = _levelForView();
+    _updateVertices();
+}
+
+void TrajectoryMapItem::_updateVertices(void)
+{
+    if (!_trajectoryPoints || _trajectoryPoints->points().empty()) {
+        _vertices.clear();
+        _stableVertexCount  = 0;
+        _verticesChanged    = true;
+        update();
+        return;
+    }
+
+    const std::vector<TrajectoryPoints::Point_t>& points = _trajectoryPoints->points();
+
+    if (_vertices.empty()) {
+        // The start of the trail is the origin, which keeps the float vertices precise around it
+        _stableVertexCount = 0;
+        convertGeoToWebMercator(points.front().latitude, points.front().longitude, _referenceWorldSize(_referenceZoom), _originX, _originY);
+    }
+
+    // The simplified part of the trail is only ever appended to, the unsimplified tail after it is redone
+    _vertices.resize(static_cast<size_t>(_stableVertexCount));
+    const int cSimplified = _trajectoryPoints->simplifiedCount(_level);
+    for (int i = _stableVertexCount; i < cSimplified; i++) {
+        const TrajectoryPoints::Point_t& point = _trajectoryPoints->simplifiedPoint(_level, i);
+        _appendVertex(point.latitude, point.longitude);
+    }
+    _stableVertexCount = cSimplified;
+    for (size_t i = static_cast<size_t>(_trajectoryPoints->tailStart(_level)); i < points.size(); i++) {
+        _appendVertex(points[i].latitude, points[i].longitude);
+    }
+
+    _verticesChanged = true;
+    update();
+}
+
+void TrajectoryMapItem::_viewChanged(void)
+{
+    const int level = _levelForView();
+    if (level != _level) {
+        _vertices.clear();
+        _stableVertexCount  = 0;
+        _level              = level;
+        _updateVertices();
+    } else {
+        // Only the transform changes
+        update();
+    }
+}
+
+QSGNode* TrajectoryMapItem::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    QSGTransformNode*   transformNode   = static_cast<QSGTransformNode*>(oldNode);
+    QSGGeometryNode*    lineNode        = nullptr;
+
+    if (!transformNode) {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+
+        lineNode = new QSGGeometryNode;
+        lineNode->setFlag(QSGNode::OwnsGeometry);
+        lineNode->setFlag(QSGNode::OwnsMaterial);
+        lineNode->setGeometry(geometry);
+        lineNode->setMaterial(new QSGFlatColorMaterial);
+
+        transformNode = new QSGTransformNode;
+        transformNode->appendChildNode(lineNode);
+        _verticesChanged = true;
+    } else {
+        lineNode = static_cast<QSGGeometryNode*>(transformNode->firstChild());
+    }
+
+    QSGFlatColorMaterial* material = static_cast<QSGFlatColorMaterial*>(lineNode->material());
+    if (material->color() != _color) {
+        material->setColor(_color);
+        lineNode->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    QSGGeometry* geometry = lineNode->geometry();
+    if (!qFuzzyCompare(geometry->lineWidth(), static_cast<float>(_lineWidth))) {
+        geometry->setLineWidth(static_cast<float>(_lineWidth));
+        lineNode->markDirty(QSGNode::DirtyGeometry);
+    }
+    if (_verticesChanged) {
+        geometry->allocate(static_cast<int>(_vertices.size()));
+        if (!_vertices.empty()) {
+            memcpy(geometry->vertexDataAsPoint2D(), _vertices.data(), _vertices.size() * sizeof(QSGGeometry::Point2D));
+        }
+        lineNode->markDirty(QSGNode::DirtyGeometry);
+        _verticesChanged = false;
+    }
+
+    // Panning, zooming and rotating the map only changes the matrix
+    QMatrix4x4 matrix;
+    if (_center.isValid()) {
+        double centerX;
+        double centerY;
+
+        convertGeoToWebMercator(_center.latitude(), _center.longitude(), _referenceWorldSize(_referenceZoom), centerX, centerY);
+        matrix.translate(static_cast<float>(width() / 2.0), static_cast<float>(height() / 2.0));
+        matrix.rotate(static_cast<float>(-_bearing), 0, 0, 1);
+        matrix.scale(static_cast<float>(qPow(2.0, _zoomLevel - _referenceZoom)));
+        matrix.translate(static_cast<float>(_originX - centerX), static_cast<float>(_originY - centerY));
+    }
+    transformNode->setMatrix(matrix);
+
+    return transformNode;
+}
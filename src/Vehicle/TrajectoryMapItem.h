@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QQuickItem>
+#include <QColor>
+#include <QGeoCoordinate>
+#include <QPointer>
+#include <QSGGeometry>
+
+#include <vector>
+
+class TrajectoryPoints;
+
+/// Draws the flight trail of TrajectoryPoints as a single scene graph line on top of a map.
+///
+/// The vertices are kept in Web Mercator pixels at a fixed zoom level relative to the start of the trail, so moving
+/// the map only changes the transform of the line. As the trail grows vertices are appended, and the level of detail
+/// drawn follows the zoom level of the map.
+class TrajectoryMapItem : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    TrajectoryMapItem(QQuickItem* parent = nullptr);
+
+    Q_PROPERTY(TrajectoryPoints*    trajectoryPoints    READ trajectoryPoints   WRITE setTrajectoryPoints   NOTIFY trajectoryPointsChanged)
+    Q_PROPERTY(QGeoCoordinate       center              MEMBER _center          NOTIFY centerChanged)
+    Q_PROPERTY(double               zoomLevel           MEMBER _zoomLevel       NOTIFY zoomLevelChanged)
+    Q_PROPERTY(double               bearing             MEMBER _bearing         NOTIFY bearingChanged)
+    Q_PROPERTY(QColor               color               MEMBER _color           NOTIFY colorChanged)
+    Q_PROPERTY(double               lineWidth           MEMBER _lineWidth       NOTIFY lineWidthChanged)
+
+    TrajectoryPoints*   trajectoryPoints    (void) { return _trajectoryPoints; }
+    void                setTrajectoryPoints (TrajectoryPoints* trajectoryPoints);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) final;
+
+signals:
+    void trajectoryPointsChanged(void);
+    void centerChanged          (void);
+    void zoomLevelChanged       (void);
+    void bearingChanged         (void);
+    void colorChanged           (void);
+    void lineWidthChanged       (void);
+
+private slots:
+    void _resetVertices     (void);
+    void _updateVertices    (void);
+    void _viewChanged       (void);
+
+private:
+    int         _levelForView   (void) const;
+    void        _appendVertex   (double latitude, double longitude);
+
+    QPointer<TrajectoryPoints>          _trajectoryPoints;
+    QGeoCoordinate                      _center;
+    double                              _zoomLevel          = 0;
+    double                              _bearing            = 0;
+    QColor                              _color              = QColor(Qt::red);
+    double                              _lineWidth          = 3;
+    int                                 _level              = 0;        ///< Level of detail the vertices are for
+    int                                 _stableVertexCount  = 0;        ///< Leading vertices of the simplified trail, these don't change
+    double                              _originX            = 0;        ///< Web Mercator pixel at _referenceZoom of the first point
+    double                              _originY            = 0;
+    std::vector<QSGGeometry::Point2D>   _vertices;                      ///< Built on the GUI thread, read by updatePaintNode while it is blocked
+    bool                                _verticesChanged    = false;
+
+    static const int _referenceZoom = 20;                               ///< Vertices are stored relative to _origin at this zoom level
+};
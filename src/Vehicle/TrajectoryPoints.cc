@@ -10,6 +10,58 @@
 #include "TrajectoryPoints.h"
 #include "Vehicle.h"
 
+#include <QPointF>
+#include <QtMath>
+
+#include <utility>
+
+/// Distance from the point to the segment from a to b
+static double _segmentDistance(const QPointF& point, const QPointF& a, const QPointF& b)
+{
+    const QPointF   segment         = b - a;
+    const double    lengthSquared   = QPointF::dotProduct(segment, segment);
+    double          t               = 0;
+
+    if (lengthSquared > 0) {
+        t = qBound(0.0, QPointF::dotProduct(point - a, segment) / lengthSquared, 1.0);
+    }
+    const QPointF offset = point - (a + (segment * t));
+    return qSqrt(QPointF::dotProduct(offset, offset));
+}
+
+/// Marks the points Douglas-Peucker keeps for the tolerance, the first and last point are always kept
+static void _douglasPeucker(const std::vector<QPointF>& points, double tolerance, std::vector<bool>& keep)
+{
+    keep.assign(points.size(), false);
+    if (points.empty()) {
+        return;
+    }
+    keep.front()    = true;
+    keep.back()     = true;
+
+    std::vector<std::pair<size_t, size_t>> ranges { { 0, points.size() - 1 } };
+    while (!ranges.empty()) {
+        const size_t first  = ranges.back().first;
+        const size_t last   = ranges.back().second;
+        ranges.pop_back();
+
+        double  maxDistance = 0;
+        size_t  maxIndex    = first;
+        for (size_t i = first + 1; i < last; i++) {
+            const double distance = _segmentDistance(points[i], points[first], points[last]);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                maxIndex    = i;
+            }
+        }
+        if (maxDistance > tolerance) {
+            keep[maxIndex] = true;
+            ranges.push_back({ first, maxIndex });
+            ranges.push_back({ maxIndex, last });
+        }
+    }
+}
+
 TrajectoryPoints::TrajectoryPoints(Vehicle* vehicle, QObject* parent)
     : QObject       (parent)
     , _vehicle      (vehicle)
@@ -33,24 +85,80 @@ void TrajectoryPoints::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
                 // The new position IS NOT colinear with the last segment. Append the new position to the list.
                 _lastAzimuth = _lastPoint.azimuthTo(coordinate);
                 _lastPoint = coordinate;
-                _points.append(QVariant::fromValue(coordinate));
+                _appendPoint(coordinate);
                 emit pointAdded(coordinate);
             } else {
                 // The new position IS colinear with the last segment. Don't add a new point, just update
                 // the last point to be the new position.
                 _lastPoint = coordinate;
-                _points[_points.count() - 1] = QVariant::fromValue(coordinate);
+                _points.back() = { coordinate.latitude(), coordinate.longitude() };
                 emit updateLastPoint(coordinate);
             }
         }
     } else {
         // Add the very first trajectory point to the list
         _lastPoint = coordinate;
-        _points.append(QVariant::fromValue(coordinate));
+        _appendPoint(coordinate);
         emit pointAdded(coordinate);
     }
 }
 
+void TrajectoryPoints::_appendPoint(const QGeoCoordinate& coordinate)
+{
+    _points.push_back({ coordinate.latitude(), coordinate.longitude() });
+
+    // The chunk ends before the last point, which still moves while the vehicle flies straight
+    if (static_cast<int>(_points.size()) - 1 - _simplifiedTailStart > _chunkSize) {
+        _simplifyChunk();
+    }
+}
+
+void TrajectoryPoints::_simplifyChunk(void)
+{
+    // Meters per degree of latitude on the sphere QGeoCoordinate uses
+    static const double metersPerDegree = 111195.08;
+
+    // Chunks are short enough to be simplified on a plane tangent to their start
+    const Point_t&          origin          = _points[static_cast<size_t>(_simplifiedTailStart)];
+    const double            metersPerLonDeg = metersPerDegree * qCos(qDegreesToRadians(origin.latitude));
+    std::vector<QPointF>    chunk;
+    std::vector<bool>       keep;
+
+    chunk.reserve(_chunkSize + 1);
+    for (int i = 0; i <= _chunkSize; i++) {
+        const Point_t& point = _points[static_cast<size_t>(_simplifiedTailStart + i)];
+        chunk.push_back(QPointF((point.longitude - origin.longitude) * metersPerLonDeg, (point.latitude - origin.latitude) * metersPerDegree));
+    }
+
+    for (int level = 1; level < levelCount; level++) {
+        _douglasPeucker(chunk, levelTolerance(level), keep);
+        // The last point of the chunk is the first one of the next chunk
+        for (int i = 0; i < _chunkSize; i++) {
+            if (keep[static_cast<size_t>(i)]) {
+                _simplifiedPoints[level].push_back(_points[static_cast<size_t>(_simplifiedTailStart + i)]);
+            }
+        }
+    }
+    _simplifiedTailStart += _chunkSize;
+}
+
+double TrajectoryPoints::levelTolerance(int level)
+{
+    // Each level is four times as coarse as the one before, starting with the tolerance the points are taken with
+    return level <= 0 ? 0 : _distanceTolerance * qPow(4.0, level - 1);
+}
+
+QVariantList TrajectoryPoints::list(void) const
+{
+    QVariantList list;
+
+    list.reserve(static_cast<int>(_points.size()));
+    for (const Point_t& point: _points) {
+        list.append(QVariant::fromValue(QGeoCoordinate(point.latitude, point.longitude)));
+    }
+    return list;
+}
+
 void TrajectoryPoints::start(void)
 {
     clear();
@@ -65,6 +173,10 @@ void TrajectoryPoints::stop(void)
 void TrajectoryPoints::clear(void)
 {
     _points.clear();
+    for (std::vector<Point_t>& simplifiedPoints: _simplifiedPoints) {
+        simplifiedPoints.clear();
+    }
+    _simplifiedTailStart = 0;
     _lastPoint = QGeoCoordinate();
     _lastAzimuth = qQNaN();
     emit pointsCleared();
@@ -13,8 +13,15 @@
 
 #include <QGeoCoordinate>
 
+#include <vector>
+
 class Vehicle;
 
+/// Flight trail of a vehicle.
+///
+/// The points are stored packed. Besides the full trail there are levels of detail simplified with Douglas-Peucker
+/// for displaying the trail zoomed out. The trail is simplified in chunks as it grows, so the levels only ever get
+/// points appended, and the unsimplified end of the trail is used as is on every level.
 class TrajectoryPoints : public QObject
 {
     Q_OBJECT
@@ -22,7 +29,28 @@ class TrajectoryPoints : public QObject
 public:
     TrajectoryPoints(Vehicle* vehicle, QObject* parent = nullptr);
 
-    Q_INVOKABLE QVariantList list(void) const { return _points; }
+    typedef struct {
+        double latitude;
+        double longitude;
+    } Point_t;
+
+    /// @return The trail as QGeoCoordinates. This boxes every point, use points() instead where possible.
+    Q_INVOKABLE QVariantList list(void) const;
+
+    /// Every point of the trail
+    const std::vector<Point_t>& points(void) const { return _points; }
+
+    /// The simplified part of the trail at a level of detail comes first, followed by points() from tailStart(level)
+    /// on. Level 0 is not simplified, only the last point is in the tail since it is updated when the vehicle moves
+    /// in a straight line.
+    int             simplifiedCount (int level) const { return level == 0 ? _stableCount() : static_cast<int>(_simplifiedPoints[level].size()); }
+    const Point_t&  simplifiedPoint (int level, int index) const { return level == 0 ? _points[static_cast<size_t>(index)] : _simplifiedPoints[level][static_cast<size_t>(index)]; }
+    int             tailStart       (int level) const { return level == 0 ? _stableCount() : _simplifiedTailStart; }
+
+    /// @return Largest distance in meters a level of detail is off from the full trail
+    static double levelTolerance(int level);
+
+    static const int levelCount = 6;
 
     void start  (void);
     void stop   (void);
@@ -39,11 +67,18 @@ private slots:
     void _vehicleCoordinateChanged(QGeoCoordinate coordinate);
 
 private:
-    Vehicle*        _vehicle;
-    QVariantList    _points;
-    QGeoCoordinate  _lastPoint;
-    double          _lastAzimuth;
+    int  _stableCount       (void) const { return qMax(static_cast<int>(_points.size()) - 1, 0); }
+    void _appendPoint       (const QGeoCoordinate& coordinate);
+    void _simplifyChunk     (void);
+
+    Vehicle*                _vehicle;
+    std::vector<Point_t>    _points;
+    std::vector<Point_t>    _simplifiedPoints[levelCount];  ///< Level 0 is not used, it is _points
+    int                     _simplifiedTailStart = 0;       ///< First point of _points which isn't simplified yet
+    QGeoCoordinate          _lastPoint;
+    double                  _lastAzimuth;
 
     static constexpr double _distanceTolerance = 2.0;
     static constexpr double _azimuthTolerance = 1.5;
+    static const int        _chunkSize = 256;               ///< Points simplified at a time
 };
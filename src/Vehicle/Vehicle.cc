@@ -31,7 +31,6 @@
 #include "QGCImageProvider.h"
 #include "MissionCommandTree.h"
 #include "SettingsManager.h"
-#include "QGCQGeoCoordinate.h"
 #include "QGCCorePlugin.h"
 #include "QGCOptions.h"
 #include "ADSBVehicleManager.h"
@@ -42,12 +41,16 @@
 #include "PositionManager.h"
 #include "VehicleObjectAvoidance.h"
 #include "TrajectoryPoints.h"
+#include "CameraTriggerPoints.h"
 #include "QGCGeo.h"
+#include "QGCInstrumentation.h"
 #include "TerrainProtocolHandler.h"
 #include "ParameterManager.h"
 #include "FTPManager.h"
 #include "ComponentInformationManager.h"
 #include "InitialConnectStateMachine.h"
+#include "MessageIntervalManager.h"
+#include "LinkQualityAdapter.h"
 #include "VehicleBatteryFactGroup.h"
 #ifdef QT_DEBUG
 #include "MockLink.h"
@@ -59,6 +62,9 @@
 
 QGC_LOGGING_CATEGORY(VehicleLog, "VehicleLog")
 
+QGC_INSTRUMENT_HISTOGRAM(VehicleMessageReceivedTime,    "Vehicle.MessageReceived")
+QGC_INSTRUMENT_COUNTER  (VehicleDuplicateFrames,        "Vehicle.DuplicateFrames")
+
 #define UPDATE_TIMER 50
 #define DEFAULT_LAT  38.965767f
 #define DEFAULT_LON -120.083923f
@@ -109,10 +115,12 @@ Vehicle::Vehicle(LinkInterface*             link,
                  MAV_AUTOPILOT              firmwareType,
                  MAV_TYPE                   vehicleType,
                  FirmwarePluginManager*     firmwarePluginManager,
-                 JoystickManager*           joystickManager)
+                 JoystickManager*           joystickManager,
+                 bool                       reducedPipeline)
     : FactGroup                     (_vehicleUIUpdateRateMSecs, ":/json/Vehicle/VehicleFact.json")
     , _id                           (vehicleId)
     , _defaultComponentId           (defaultComponentId)
+    , _reducedPipeline              (reducedPipeline)
     , _firmwareType                 (firmwareType)
     , _vehicleType                  (vehicleType)
     , _toolbox                      (qgcApp()->toolbox())
@@ -122,6 +130,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _firmwarePluginManager        (firmwarePluginManager)
     , _joystickManager              (joystickManager)
     , _trajectoryPoints             (new TrajectoryPoints(this, this))
+    , _cameraTriggerPoints          (new CameraTriggerPoints(this))
     , _rollFact                     (0, _rollFactName,              FactMetaData::valueTypeDouble)
     , _pitchFact                    (0, _pitchFactName,             FactMetaData::valueTypeDouble)
     , _headingFact                  (0, _headingFactName,           FactMetaData::valueTypeDouble)
@@ -162,7 +171,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     _mavlink = _toolbox->mavlinkProtocol();
     qCDebug(VehicleLog) << "Link started with Mavlink " << (_mavlink->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(_mavlink, &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
+    connect(_mavlink, &MAVLinkProtocol::messagesReceived,       this, &Vehicle::_mavlinkMessagesReceived);
     connect(_mavlink, &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
@@ -205,15 +214,16 @@ Vehicle::Vehicle(LinkInterface*             link,
     _prearmErrorTimer.setInterval(_prearmErrorTimeoutMSecs);
     _prearmErrorTimer.setSingleShot(true);
 
-    // Send MAV_CMD ack timer
-    _mavCommandResponseCheckTimer.setSingleShot(false);
-    _mavCommandResponseCheckTimer.setInterval(_mavCommandResponseCheckTimeoutMSecs);
-    _mavCommandResponseCheckTimer.start();
+    // Send MAV_CMD ack timer, only runs while there are commands waiting for an ack
+    _mavCommandResponseCheckTimer.setSingleShot(true);
     connect(&_mavCommandResponseCheckTimer, &QTimer::timeout, this, &Vehicle::_sendMavCommandResponseTimeoutCheck);
 
+    // Message wait timer, only runs while a message wait timeout is running
+    _waitForMavlinkMessageTimer.setSingleShot(true);
+    connect(&_waitForMavlinkMessageTimer, &QTimer::timeout, this, &Vehicle::_waitForMavlinkMessageTimeout);
+
     // Chunked status text timeout timer
-    _chunkedStatusTextTimer.setSingleShot(true);
-    _chunkedStatusTextTimer.setInterval(1000);
+    _chunkedStatusTextTimer.setInterval(_chunkedStatusTextCheckMSecs);
     connect(&_chunkedStatusTextTimer, &QTimer::timeout, this, &Vehicle::_chunkedStatusTextTimeout);
 
     _mav = uas();
@@ -222,10 +232,8 @@ Vehicle::Vehicle(LinkInterface*             link,
     connect(_toolbox->uasMessageHandler(), &UASMessageHandler::textMessageCountChanged,  this, &Vehicle::_handleTextMessage);
     connect(_toolbox->uasMessageHandler(), &UASMessageHandler::textMessageReceived,      this, &Vehicle::_handletextMessageReceived);
 
-    // MAV_TYPE_GENERIC is used by unit test for creating a vehicle which doesn't do the connect sequence. This
-    // way we can test the methods that are used within the connect sequence.
-    if (!qgcApp()->runningUnitTests() || _vehicleType != MAV_TYPE_GENERIC) {
-        _initialConnectStateMachine->start();
+    if (!_reducedPipeline) {
+        _startInitialConnect();
     }
 
     _firmwarePlugin->initializeVehicle(this);
@@ -233,18 +241,78 @@ Vehicle::Vehicle(LinkInterface*             link,
         _firmwarePlugin->adjustMetaData(vehicleType, getFact(factName)->metaData());
     }
 
-    _sendMultipleTimer.start(_sendMessageMultipleIntraMessageDelay);
+    // Only runs while there are messages to send
+    _sendMultipleTimer.setInterval(_sendMessageMultipleIntraMessageDelay);
     connect(&_sendMultipleTimer, &QTimer::timeout, this, &Vehicle::_sendMessageMultipleNext);
 
     connect(&_orbitTelemetryTimer, &QTimer::timeout, this, &Vehicle::_orbitTelemetryTimeout);
 
-    // Create camera manager instance
+    _pingTimer.setInterval(_pingIntervalMSecs);
+    connect(&_pingTimer, &QTimer::timeout, this, &Vehicle::_sendPing);
+
+    // Start telemetry logger
+    connect(&_telemetryLogTimer, &QTimer::timeout, this, &Vehicle::_telemetryLogTimeout);
+    connect(_toolbox->settingsManager()->appSettings()->csvTelemetryRate(), &Fact::rawValueChanged, this, &Vehicle::_updateTelemetryLogRate);
+    _updateTelemetryLogRate();
+
+    if (!_reducedPipeline) {
+        // Create camera manager instance
+        _cameraManager = _firmwarePlugin->createCameraManager(this);
+        emit cameraManagerChanged();
+
+        _telemetryLogTimer.start();
+    }
+}
+
+void Vehicle::_startInitialConnect(void)
+{
+    // MAV_TYPE_GENERIC is used by unit test for creating a vehicle which doesn't do the connect sequence. This
+    // way we can test the methods that are used within the connect sequence.
+    if (!qgcApp()->runningUnitTests() || _vehicleType != MAV_TYPE_GENERIC) {
+        _initialConnectStateMachine->start();
+    }
+}
+
+void Vehicle::startFullPipeline(void)
+{
+    if (!_reducedPipeline) {
+        return;
+    }
+
+    qCDebug(VehicleLog) << "Starting full pipeline" << _id;
+
+    _reducedPipeline = false;
+    emit reducedPipelineChanged();
+
+    _startInitialConnect();
+
     _cameraManager = _firmwarePlugin->createCameraManager(this);
     emit cameraManagerChanged();
 
-    // Start csv logger
-    connect(&_csvLogTimer, &QTimer::timeout, this, &Vehicle::_writeCsvLine);
-    _csvLogTimer.start(1000);
+    _telemetryLogTimer.start();
+}
+
+bool Vehicle::reducedPipelineMessage(uint32_t msgid)
+{
+    switch (msgid) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_SYS_STATUS:
+    case MAVLINK_MSG_ID_BATTERY_STATUS:
+    case MAVLINK_MSG_ID_EXTENDED_SYS_STATE:
+    case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+    case MAVLINK_MSG_ID_GPS_RAW_INT:
+    case MAVLINK_MSG_ID_HOME_POSITION:
+    case MAVLINK_MSG_ID_ATTITUDE:
+    case MAVLINK_MSG_ID_VFR_HUD:
+    case MAVLINK_MSG_ID_HIGH_LATENCY:
+    case MAVLINK_MSG_ID_HIGH_LATENCY2:
+    case MAVLINK_MSG_ID_STATUSTEXT:
+    case MAVLINK_MSG_ID_COMMAND_ACK:
+    case MAVLINK_MSG_ID_RADIO_STATUS:
+        return true;
+    default:
+        return false;
+    }
 }
 
 // Disconnected Vehicle for offline editing
@@ -268,6 +336,7 @@ Vehicle::Vehicle(MAV_AUTOPILOT              firmwareType,
     , _capabilityBits                   (MAV_PROTOCOL_CAPABILITY_MISSION_FENCE | MAV_PROTOCOL_CAPABILITY_MISSION_RALLY)
     , _firmwarePluginManager            (firmwarePluginManager)
     , _trajectoryPoints                 (new TrajectoryPoints(this, this))
+    , _cameraTriggerPoints              (new CameraTriggerPoints(this))
     , _rollFact                         (0, _rollFactName,              FactMetaData::valueTypeDouble)
     , _pitchFact                        (0, _pitchFactName,             FactMetaData::valueTypeDouble)
     , _headingFact                      (0, _headingFactName,           FactMetaData::valueTypeDouble)
@@ -354,6 +423,8 @@ void Vehicle::_commonInit()
     _initialConnectStateMachine     = new InitialConnectStateMachine    (this);
     _ftpManager                     = new FTPManager                    (this);    
     _vehicleLinkManager             = new VehicleLinkManager            (this);
+    _messageIntervalManager         = new MessageIntervalManager        (this);
+    _linkQualityAdapter             = new LinkQualityAdapter            (this);
 
     _parameterManager = new ParameterManager(this);
     connect(_parameterManager, &ParameterManager::parametersReadyChanged, this, &Vehicle::_parametersReady);
@@ -374,6 +445,10 @@ void Vehicle::_commonInit()
 
     // Build FactGroup object model
 
+    // Battery groups are added dynamically so the dispatch table follows the group list
+    connect(this, &FactGroup::factGroupNamesChanged, this, &Vehicle::_rebuildFactGroupDispatch);
+    _registerMessageHandlers();
+
     _addFact(&_rollFact,                _rollFactName);
     _addFact(&_pitchFact,               _pitchFactName);
     _addFact(&_headingFact,             _headingFactName);
@@ -545,8 +620,28 @@ void Vehicle::resetCounters()
     _heardFrom          = false;
 }
 
+void Vehicle::_mavlinkMessagesReceived(LinkInterface* link, const QVector<mavlink_message_t>& messages)
+{
+    // Anyone handling a message could close the connection, which deletes the link,
+    // so we stop processing the batch if it expires.
+    WeakLinkInterfacePtr linkPtr = _linkManager->sharedLinkInterfacePointerForLink(link, true);
+
+    uint previousMessagesReceived = _messagesReceived;
+    for (const mavlink_message_t& message: messages) {
+        if (linkPtr.expired()) {
+            break;
+        }
+        _mavlinkMessageReceived(link, message);
+    }
+    if (_messagesReceived != previousMessagesReceived) {
+        emit messagesReceivedChanged();
+    }
+}
+
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
+    QGC_INSTRUMENT_SCOPE(VehicleMessageReceivedTime);
+
     // If the link is already running at Mavlink V2 set our max proto version to it.
     unsigned mavlinkVersion = _mavlink->getCurrentVersion();
     if (_maxProtoVersion != mavlinkVersion && mavlinkVersion >= 200) {
@@ -562,11 +657,14 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     }
 
     // We give the link manager first whack since it it reponsible for adding new links
-    _vehicleLinkManager->mavlinkMessageReceived(link, message);
+    if (!_vehicleLinkManager->mavlinkMessageReceived(link, message)) {
+        // Same message already came in on another link
+        QGC_INSTRUMENT_ADD(VehicleDuplicateFrames, 1);
+        return;
+    }
 
     //-- Check link status
     _messagesReceived++;
-    emit messagesReceivedChanged();
     if(!_heardFrom) {
         if(message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
             _heardFrom  = true;
@@ -590,30 +688,25 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         }
     }
 
-    // Give the plugin a change to adjust the message contents
-    if (!_firmwarePlugin->adjustIncomingMavlinkMessage(this, &message)) {
+    // Until a fleet vehicle is made active it only keeps track of what is needed to show it on the map and in the
+    // vehicle list. Everything else is dropped before the plugins, managers and fact groups see it.
+    if (_reducedPipeline && !reducedPipelineMessage(message.msgid)) {
         return;
     }
 
-    // Give the Core Plugin access to all mavlink traffic
-    if (!_toolbox->corePlugin()->mavlinkMessage(this, link, message)) {
+    // Give the plugin a change to adjust the message contents
+    if (!_firmwarePlugin->adjustIncomingMavlinkMessage(this, &message)) {
         return;
     }
 
-    if (!_terrainProtocolHandler->mavlinkMessageReceived(message)) {
+    // Give the Core Plugin access to the mavlink traffic it registered for
+    QGCCorePlugin* corePlugin = _toolbox->corePlugin();
+    if (corePlugin->wantsMavlinkMessage(message.msgid) && !corePlugin->mavlinkMessage(this, link, message)) {
         return;
     }
-    _ftpManager->_mavlinkMessageReceived(message);
-    _parameterManager->mavlinkMessageReceived(message);
 
-    _waitForMavlinkMessageMessageReceived(message);
-
-    // Battery fact groups are created dynamically as new batteries are discovered
-    VehicleBatteryFactGroup::handleMessageForFactGroupCreation(this, message);
-
-    // Let the fact groups take a whack at the mavlink traffic
-    for (FactGroup* factGroup : factGroups()) {
-        factGroup->handleMessage(this, message);
+    if (!_dispatchMessage(message)) {
+        return;
     }
 
     switch (message.msgid) {
@@ -707,6 +800,9 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     case MAVLINK_MSG_ID_OBSTACLE_DISTANCE:
         _handleObstacleDistance(message);
         break;
+    case MAVLINK_MSG_ID_OBSTACLE_DISTANCE_3D:
+        _handleObstacleDistance3D(message);
+        break;
 
     case MAVLINK_MSG_ID_SERIAL_CONTROL:
     {
@@ -731,6 +827,107 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     _uas->receiveMessage(message);
 }
 
+/// Hands the message to the managers and FactGroups which registered for its message id
+///     @return false: A handler consumed the message, no further processing should be done
+bool Vehicle::_dispatchMessage(mavlink_message_t& message)
+{
+    _messageDispatchCount++;
+
+    auto handlersIter = _messageHandlers.constFind(message.msgid);
+    if (handlersIter != _messageHandlers.constEnd()) {
+        for (const MessageHandler_t& handler: handlersIter.value()) {
+            _messageHandlerRunCount++;
+            if (!handler(message)) {
+                return false;
+            }
+        }
+    }
+
+    if (_waitForMavlinkMessages.contains(message.msgid)) {
+        _messageHandlerRunCount++;
+        _waitForMavlinkMessageMessageReceived(message);
+    }
+
+    if (_sensorStreamTap.isTapped(message.msgid)) {
+        _messageHandlerRunCount++;
+        _sensorStreamTap.messageReceived(message);
+    }
+
+    // Let the fact groups take a whack at the mavlink traffic
+    auto factGroupsIter = _factGroupsByMessageId.constFind(message.msgid);
+    if (factGroupsIter != _factGroupsByMessageId.constEnd()) {
+        for (FactGroup* factGroup: factGroupsIter.value()) {
+            _messageHandlerRunCount++;
+            factGroup->handleMessage(this, message);
+        }
+    }
+    for (FactGroup* factGroup: _factGroupsForAllMessages) {
+        _messageHandlerRunCount++;
+        factGroup->handleMessage(this, message);
+    }
+
+    return true;
+}
+
+void Vehicle::_registerMessageHandlers(void)
+{
+    auto terrainHandler = [this](mavlink_message_t& message) { return _terrainProtocolHandler->mavlinkMessageReceived(message); };
+    _messageHandlers[MAVLINK_MSG_ID_TERRAIN_REQUEST].append(terrainHandler);
+    _messageHandlers[MAVLINK_MSG_ID_TERRAIN_REPORT].append(terrainHandler);
+
+    _messageHandlers[MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL].append([this](mavlink_message_t& message) {
+        _ftpManager->_mavlinkMessageReceived(message);
+        return true;
+    });
+
+    _messageHandlers[MAVLINK_MSG_ID_PARAM_VALUE].append([this](mavlink_message_t& message) {
+        _parameterManager->mavlinkMessageReceived(message);
+        return true;
+    });
+
+    // Battery fact groups are created dynamically as new batteries are discovered
+    auto batteryCreationHandler = [this](mavlink_message_t& message) {
+        VehicleBatteryFactGroup::handleMessageForFactGroupCreation(this, message);
+        return true;
+    };
+    _messageHandlers[MAVLINK_MSG_ID_BATTERY_STATUS].append(batteryCreationHandler);
+    _messageHandlers[MAVLINK_MSG_ID_HIGH_LATENCY].append(batteryCreationHandler);
+    _messageHandlers[MAVLINK_MSG_ID_HIGH_LATENCY2].append(batteryCreationHandler);
+}
+
+void Vehicle::_rebuildFactGroupDispatch(void)
+{
+    _factGroupsByMessageId.clear();
+    _factGroupsForAllMessages.clear();
+
+    for (FactGroup* factGroup: factGroups()) {
+        connect(factGroup, &FactGroup::liveUpdatesChanged, this, &Vehicle::_factGroupLiveUpdatesChanged, Qt::UniqueConnection);
+        if (factGroup->handlesAllMessages()) {
+            _factGroupsForAllMessages.append(factGroup);
+        } else {
+            for (uint32_t msgid: factGroup->handledMessageIds()) {
+                _factGroupsByMessageId[msgid].append(factGroup);
+            }
+        }
+    }
+}
+
+void Vehicle::_factGroupLiveUpdatesChanged(bool liveUpdates)
+{
+    // Ask the vehicle for a faster rate on the messages behind a group while something is showing it live
+    FactGroup* factGroup = qobject_cast<FactGroup*>(sender());
+    if (!factGroup || factGroup->handlesAllMessages()) {
+        return;
+    }
+    for (uint32_t msgid: factGroup->handledMessageIds()) {
+        if (liveUpdates) {
+            _messageIntervalManager->subscribe(factGroup, msgid, MessageIntervalManager::liveUpdatesRateHz);
+        } else {
+            _messageIntervalManager->unsubscribe(factGroup, msgid);
+        }
+    }
+}
+
 #if !defined(NO_ARDUPILOT_DIALECT)
 void Vehicle::_handleCameraFeedback(const mavlink_message_t& message)
 {
@@ -738,9 +935,8 @@ void Vehicle::_handleCameraFeedback(const mavlink_message_t& message)
 
     mavlink_msg_camera_feedback_decode(&message, &feedback);
 
-    QGeoCoordinate imageCoordinate((double)feedback.lat / qPow(10.0, 7.0), (double)feedback.lng / qPow(10.0, 7.0), feedback.alt_msl);
-    qCDebug(VehicleLog) << "_handleCameraFeedback coord:index" << imageCoordinate << feedback.img_idx;
-    _cameraTriggerPoints.append(new QGCQGeoCoordinate(imageCoordinate, this));
+    qCDebug(VehicleLog) << "_handleCameraFeedback lat:lon:index" << feedback.lat << feedback.lng << feedback.img_idx;
+    _cameraTriggerPoints->append({ feedback.lat / 1e7, feedback.lng / 1e7, feedback.alt_msl, feedback.img_idx, feedback.time_usec });
 }
 #endif
 
@@ -786,42 +982,45 @@ void Vehicle::_handleCameraImageCaptured(const mavlink_message_t& message)
 
     mavlink_msg_camera_image_captured_decode(&message, &feedback);
 
-    QGeoCoordinate imageCoordinate((double)feedback.lat / qPow(10.0, 7.0), (double)feedback.lon / qPow(10.0, 7.0), feedback.alt);
-    qCDebug(VehicleLog) << "_handleCameraFeedback coord:index" << imageCoordinate << feedback.image_index << feedback.capture_result;
+    qCDebug(VehicleLog) << "_handleCameraImageCaptured lat:lon:index:result" << feedback.lat << feedback.lon << feedback.image_index << feedback.capture_result;
     if (feedback.capture_result == 1) {
-        _cameraTriggerPoints.append(new QGCQGeoCoordinate(imageCoordinate, this));
+        _cameraTriggerPoints->append({ feedback.lat / 1e7, feedback.lon / 1e7, static_cast<float>(feedback.alt) / 1000.0f, static_cast<uint32_t>(feedback.image_index), feedback.time_utc });
     }
 }
 
 void Vehicle::_chunkedStatusTextTimeout(void)
 {
-    // Spit out all incomplete chunks
-    QList<uint8_t> rgCompId = _chunkedStatusTextInfoMap.keys();
-    for (uint8_t compId : rgCompId) {
-        _chunkedStatusTextInfoMap[compId].rgMessageChunks.append(QString());
-        _chunkedStatusTextCompleted(compId);
+    // Spit out the sequences which stopped getting chunks
+    QList<uint32_t> rgKeys;
+    for (auto iter = _chunkedStatusTextInfoMap.constBegin(); iter != _chunkedStatusTextInfoMap.constEnd(); ++iter) {
+        if (iter.value().lastChunkTimer.elapsed() >= _chunkedStatusTextTimeoutMSecs) {
+            rgKeys.append(iter.key());
+        }
+    }
+    for (uint32_t key : rgKeys) {
+        _chunkedStatusTextCompleted(key, true /* missingEnd */);
     }
 }
 
-void Vehicle::_chunkedStatusTextCompleted(uint8_t compId)
+/// Converts the reassembled chunks to text and removes the sequence
+///     @param missingEnd true: The final chunk never came in
+void Vehicle::_chunkedStatusTextCompleted(uint32_t key, bool missingEnd)
 {
-    ChunkedStatusTextInfo_t&    chunkedInfo =   _chunkedStatusTextInfoMap[compId];
-    uint8_t                     severity =      chunkedInfo.severity;
-    QStringList&                rgChunks =      chunkedInfo.rgMessageChunks;
+    ChunkedStatusTextInfo_t chunkedInfo = _chunkedStatusTextInfoMap.take(key);
 
-    // Build up message from chunks
-    QString messageText;
-    for (const QString& chunk : rgChunks) {
-        if (chunk.isEmpty()) {
-            // Indicates missing chunk
-            messageText += tr(" ... ", "Indicates missing chunk from chunked STATUS_TEXT");
-        } else {
-            messageText += chunk;
-        }
+    if (_chunkedStatusTextInfoMap.isEmpty()) {
+        _chunkedStatusTextTimer.stop();
     }
 
-    _chunkedStatusTextInfoMap.remove(compId);
+    QString messageText = QString::fromUtf8(chunkedInfo.text);
+    if (missingEnd) {
+        messageText += tr(" ... ", "Indicates missing chunk from chunked STATUS_TEXT");
+    }
+    _statusTextCompleted(chunkedInfo.compId, chunkedInfo.severity, messageText);
+}
 
+void Vehicle::_statusTextCompleted(uint8_t compId, uint8_t severity, QString messageText)
+{
     bool skipSpoken = false;
     bool ardupilotPrearm = messageText.startsWith(QStringLiteral("PreArm"));
     bool px4Prearm = messageText.startsWith(QStringLiteral("preflight"), Qt::CaseInsensitive) && severity >= MAV_SEVERITY_CRITICAL;
@@ -849,7 +1048,13 @@ void Vehicle::_chunkedStatusTextCompleted(uint8_t compId)
 
     if (readAloud) {
         if (!skipSpoken) {
-            qgcApp()->toolbox()->audioOutput()->say(messageText);
+            AudioOutput::Priority priority = AudioOutput::PriorityNormal;
+            if (severity <= MAV_SEVERITY_CRITICAL) {
+                priority = AudioOutput::PriorityCritical;
+            } else if (severity <= MAV_SEVERITY_WARNING) {
+                priority = AudioOutput::PriorityHigh;
+            }
+            qgcApp()->toolbox()->audioOutput()->say(messageText, priority);
         }
     }
     emit textMessageReceived(id(), compId, severity, messageText);
@@ -857,58 +1062,50 @@ void Vehicle::_chunkedStatusTextCompleted(uint8_t compId)
 
 void Vehicle::_handleStatusText(mavlink_message_t& message)
 {
-    QByteArray  b;
-    QString     messageText;
-
     mavlink_statustext_t statustext;
     mavlink_msg_statustext_decode(&message, &statustext);
 
-    uint8_t compId = message.compid;
-
-    b.resize(MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN+1);
-    strncpy(b.data(), statustext.text, MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN);
-    b[b.length()-1] = '\0';
-    messageText = QString(b);
-    bool includesNullTerminator = messageText.length() < MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN;
+    uint8_t compId      = message.compid;
+    int     textLength  = static_cast<int>(strnlen(statustext.text, MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN));
+    bool    finalChunk  = textLength < MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN;
 
-    if (_chunkedStatusTextInfoMap.contains(compId) && _chunkedStatusTextInfoMap[compId].chunkId != statustext.id) {
-        // We have an incomplete chunked status still pending
-        _chunkedStatusTextInfoMap[compId].rgMessageChunks.append(QString());
-        _chunkedStatusTextCompleted(compId);
+    if (statustext.id == 0) {
+        // Non-chunked status text
+        _statusTextCompleted(compId, statustext.severity, QString::fromUtf8(statustext.text, textLength));
+        return;
     }
 
-    if (statustext.id == 0) {
-        // Non-chunked status text. We still use common chunked text output mechanism.
+    uint32_t key = (static_cast<uint32_t>(compId) << 16) | statustext.id;
+    auto iter = _chunkedStatusTextInfoMap.find(key);
+    if (iter == _chunkedStatusTextInfoMap.end()) {
+        // Starting a new chunk sequence
         ChunkedStatusTextInfo_t chunkedInfo;
-        chunkedInfo.chunkId = 0;
-        chunkedInfo.severity = statustext.severity;
-        chunkedInfo.rgMessageChunks.append(messageText);
-        _chunkedStatusTextInfoMap[compId] = chunkedInfo;
-    } else {
-        if (_chunkedStatusTextInfoMap.contains(compId)) {
-            // A chunk sequence is in progress
-            QStringList& chunks = _chunkedStatusTextInfoMap[compId].rgMessageChunks;
-            if (statustext.chunk_seq > chunks.size()) {
-                // We are missing some chunks in between, fill them in as missing
-                for (int i=chunks.size(); i<statustext.chunk_seq; i++) {
-                    chunks.append(QString());
-                }
-            }
-            chunks.append(messageText);
-        } else {
-            // Starting a new chunk sequence
-            ChunkedStatusTextInfo_t chunkedInfo;
-            chunkedInfo.chunkId = statustext.id;
-            chunkedInfo.severity = statustext.severity;
-            chunkedInfo.rgMessageChunks.append(messageText);
-            _chunkedStatusTextInfoMap[compId] = chunkedInfo;
+        chunkedInfo.compId          = compId;
+        chunkedInfo.severity        = statustext.severity;
+        chunkedInfo.nextChunkSeq    = 0;
+        chunkedInfo.text.reserve(_chunkedStatusTextReserveChunks * MAVLINK_MSG_STATUSTEXT_FIELD_TEXT_LEN);
+        iter = _chunkedStatusTextInfoMap.insert(key, chunkedInfo);
+        if (!_chunkedStatusTextTimer.isActive()) {
+            _chunkedStatusTextTimer.start();
         }
-        _chunkedStatusTextTimer.start();
     }
 
-    if (statustext.id == 0 || includesNullTerminator) {
-        _chunkedStatusTextTimer.stop();
-        _chunkedStatusTextCompleted(message.compid);
+    ChunkedStatusTextInfo_t& chunkedInfo = iter.value();
+    if (statustext.chunk_seq < chunkedInfo.nextChunkSeq) {
+        // Duplicate or out of order chunk
+        return;
+    }
+    if (statustext.chunk_seq > chunkedInfo.nextChunkSeq) {
+        // We are missing some chunks in between
+        chunkedInfo.text.append(tr(" ... ", "Indicates missing chunk from chunked STATUS_TEXT").toUtf8());
+    }
+    // The bytes are only decoded once complete, so a utf8 character split across chunks comes out right
+    chunkedInfo.text.append(statustext.text, textLength);
+    chunkedInfo.nextChunkSeq = statustext.chunk_seq + 1;
+    chunkedInfo.lastChunkTimer.start();
+
+    if (finalChunk) {
+        _chunkedStatusTextCompleted(key, false /* missingEnd */);
     }
 }
 
@@ -917,9 +1114,9 @@ void Vehicle::_handleVfrHud(mavlink_message_t& message)
     mavlink_vfr_hud_t vfrHud;
     mavlink_msg_vfr_hud_decode(&message, &vfrHud);
 
-    _airSpeedFact.setRawValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
-    _groundSpeedFact.setRawValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
-    _climbRateFact.setRawValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
+    _airSpeedFact.setTelemetryValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
+    _groundSpeedFact.setTelemetryValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
+    _climbRateFact.setTelemetryValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
     _throttlePctFact.setRawValue(static_cast<int16_t>(vfrHud.throttle));
 }
 
@@ -959,9 +1156,9 @@ void Vehicle::_handleAttitudeWorker(double rollRadians, double pitchRadians, dou
     // truncate to integer so widget never displays 360
     yaw = trunc(yaw);
 
-    _rollFact.setRawValue(roll);
-    _pitchFact.setRawValue(pitch);
-    _headingFact.setRawValue(yaw);
+    _rollFact.setTelemetryValue(roll);
+    _pitchFact.setTelemetryValue(pitch);
+    _headingFact.setTelemetryValue(yaw);
 }
 
 void Vehicle::_handleAttitude(mavlink_message_t& message)
@@ -999,9 +1196,9 @@ void Vehicle::_handleAttitudeQuaternion(mavlink_message_t& message)
 
     _handleAttitudeWorker(roll, pitch, yaw);
 
-    rollRate()->setRawValue(qRadiansToDegrees(rates[0]));
-    pitchRate()->setRawValue(qRadiansToDegrees(rates[1]));
-    yawRate()->setRawValue(qRadiansToDegrees(rates[2]));
+    _rollRateFact.setTelemetryValue(qRadiansToDegrees(rates[0]));
+    _pitchRateFact.setTelemetryValue(qRadiansToDegrees(rates[1]));
+    _yawRateFact.setTelemetryValue(qRadiansToDegrees(rates[2]));
 }
 
 void Vehicle::_handleGpsRawInt(mavlink_message_t& message)
@@ -1019,7 +1216,7 @@ void Vehicle::_handleGpsRawInt(mavlink_message_t& message)
                 emit coordinateChanged(_coordinate);
             }
             if (!_altitudeMessageAvailable) {
-                _altitudeAMSLFact.setRawValue(gpsRawInt.alt / 1000.0);
+                _altitudeAMSLFact.setTelemetryValue(gpsRawInt.alt / 1000.0);
             }
         }
     }
@@ -1031,8 +1228,8 @@ void Vehicle::_handleGlobalPositionInt(mavlink_message_t& message)
     mavlink_msg_global_position_int_decode(&message, &globalPositionInt);
 
     if (!_altitudeMessageAvailable) {
-        _altitudeRelativeFact.setRawValue(globalPositionInt.relative_alt / 1000.0);
-        _altitudeAMSLFact.setRawValue(globalPositionInt.alt / 1000.0);
+        _altitudeRelativeFact.setTelemetryValue(globalPositionInt.relative_alt / 1000.0);
+        _altitudeAMSLFact.setTelemetryValue(globalPositionInt.alt / 1000.0);
     }
 
     // ArduPilot sends bogus GLOBAL_POSITION_INT messages with lat/lat 0/0 even when it has no gps signal
@@ -1087,12 +1284,12 @@ void Vehicle::_handleHighLatency(mavlink_message_t& message)
     _coordinate.setAltitude(coordinate.altitude);
     emit coordinateChanged(_coordinate);
 
-    _airSpeedFact.setRawValue((double)highLatency.airspeed / 5.0);
-    _groundSpeedFact.setRawValue((double)highLatency.groundspeed / 5.0);
-    _climbRateFact.setRawValue((double)highLatency.climb_rate / 10.0);
-    _headingFact.setRawValue((double)highLatency.heading * 2.0);
-    _altitudeRelativeFact.setRawValue(qQNaN());
-    _altitudeAMSLFact.setRawValue(coordinate.altitude);
+    _airSpeedFact.setTelemetryValue((double)highLatency.airspeed / 5.0);
+    _groundSpeedFact.setTelemetryValue((double)highLatency.groundspeed / 5.0);
+    _climbRateFact.setTelemetryValue((double)highLatency.climb_rate / 10.0);
+    _headingFact.setTelemetryValue((double)highLatency.heading * 2.0);
+    _altitudeRelativeFact.setTelemetryValue(qQNaN());
+    _altitudeAMSLFact.setTelemetryValue(coordinate.altitude);
 }
 
 void Vehicle::_handleHighLatency2(mavlink_message_t& message)
@@ -1123,12 +1320,12 @@ void Vehicle::_handleHighLatency2(mavlink_message_t& message)
     _coordinate.setAltitude(highLatency2.altitude);
     emit coordinateChanged(_coordinate);
 
-    _airSpeedFact.setRawValue((double)highLatency2.airspeed / 5.0);
-    _groundSpeedFact.setRawValue((double)highLatency2.groundspeed / 5.0);
-    _climbRateFact.setRawValue((double)highLatency2.climb_rate / 10.0);
-    _headingFact.setRawValue((double)highLatency2.heading * 2.0);
-    _altitudeRelativeFact.setRawValue(qQNaN());
-    _altitudeAMSLFact.setRawValue(highLatency2.altitude);
+    _airSpeedFact.setTelemetryValue((double)highLatency2.airspeed / 5.0);
+    _groundSpeedFact.setTelemetryValue((double)highLatency2.groundspeed / 5.0);
+    _climbRateFact.setTelemetryValue((double)highLatency2.climb_rate / 10.0);
+    _headingFact.setTelemetryValue((double)highLatency2.heading * 2.0);
+    _altitudeRelativeFact.setTelemetryValue(qQNaN());
+    _altitudeAMSLFact.setTelemetryValue(highLatency2.altitude);
 
     struct failure2Sensor_s {
         HL_FAILURE_FLAG         failureBit;
@@ -1167,8 +1364,8 @@ void Vehicle::_handleAltitude(mavlink_message_t& message)
 
     // Data from ALTITUDE message takes precedence over gps messages
     _altitudeMessageAvailable = true;
-    _altitudeRelativeFact.setRawValue(altitude.altitude_relative);
-    _altitudeAMSLFact.setRawValue(altitude.altitude_amsl);
+    _altitudeRelativeFact.setTelemetryValue(altitude.altitude_relative);
+    _altitudeAMSLFact.setTelemetryValue(altitude.altitude_amsl);
 }
 
 void Vehicle::_setCapabilities(uint64_t capabilityBits)
@@ -1376,8 +1573,8 @@ void Vehicle::_handleBatteryStatus(mavlink_message_t& message)
         } else {
             batteryIdStr = batteryIdStr.arg("");
         }
-        _say(tr("warning"));
-        _say(QStringLiteral("%1 %2 ").arg(_vehicleIdSpeech()).arg(batteryMessage.arg(batteryIdStr)));
+        _say(tr("warning"), AudioOutput::PriorityCritical);
+        _say(QStringLiteral("%1 %2 ").arg(_vehicleIdSpeech()).arg(batteryMessage.arg(batteryIdStr)), AudioOutput::PriorityCritical);
     }
 }
 
@@ -1429,15 +1626,29 @@ void Vehicle::_updateArmed(bool armed)
 
 void Vehicle::_handlePing(LinkInterface* link, mavlink_message_t& message)
 {
+    mavlink_ping_t ping;
+
+    mavlink_msg_ping_decode(&message, &ping);
+
+    if (ping.target_system != 0 || ping.target_component != 0) {
+        // Response to one of our own pings
+        if (ping.target_system == _mavlink->getSystemId() && ping.target_component == _mavlink->getComponentId() && message.compid == _defaultComponentId && measurePingLatency()) {
+            uint64_t nowUSecs = static_cast<uint64_t>(_pingElapsed.nsecsElapsed() / 1000);
+            if (ping.time_usec <= nowUSecs) {
+                _pingLatency.add(nowUSecs - ping.time_usec);
+                emit pingLatencyChanged();
+            }
+        }
+        return;
+    }
+
     WeakLinkInterfacePtr weakLink = vehicleLinkManager()->primaryLink();
 
     if (!weakLink.expired()) {
         SharedLinkInterfacePtr sharedLink = weakLink.lock();
 
-        mavlink_ping_t      ping;
         mavlink_message_t   msg;
 
-        mavlink_msg_ping_decode(&message, &ping);
         mavlink_msg_ping_pack_chan(static_cast<uint8_t>(_mavlink->getSystemId()),
                                    static_cast<uint8_t>(_mavlink->getComponentId()),
                                    sharedLink->mavlinkChannel(),
@@ -1450,6 +1661,67 @@ void Vehicle::_handlePing(LinkInterface* link, mavlink_message_t& message)
     }
 }
 
+void Vehicle::setMeasurePingLatency(bool measure)
+{
+    if (measure == measurePingLatency()) {
+        return;
+    }
+    if (measure) {
+        _pingLatency.reset();
+        _pingElapsed.start();
+        _pingTimer.start();
+        _sendPing();
+    } else {
+        _pingTimer.stop();
+    }
+    emit measurePingLatencyChanged();
+    emit pingLatencyChanged();
+}
+
+void Vehicle::_sendPing()
+{
+    WeakLinkInterfacePtr weakLink = vehicleLinkManager()->primaryLink();
+
+    if (!weakLink.expired()) {
+        SharedLinkInterfacePtr  sharedLink = weakLink.lock();
+        mavlink_message_t       msg;
+
+        // A target of 0/0 makes this a ping request, the response is addressed back to us with time_usec unchanged
+        mavlink_msg_ping_pack_chan(static_cast<uint8_t>(_mavlink->getSystemId()),
+                                   static_cast<uint8_t>(_mavlink->getComponentId()),
+                                   sharedLink->mavlinkChannel(),
+                                   &msg,
+                                   static_cast<uint64_t>(_pingElapsed.nsecsElapsed() / 1000),
+                                   _pingSeq++,
+                                   0,
+                                   0);
+        sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    }
+}
+
+QVariantList Vehicle::pingLatencyHistogram() const
+{
+    QVariantList histogram;
+    for (int bucket=0; bucket<LatencyHistogram::bucketCount; bucket++) {
+        histogram.append(_pingLatency.bucketSamples(bucket));
+    }
+    return histogram;
+}
+
+QStringList Vehicle::pingLatencyBucketLabels() const
+{
+    QStringList labels;
+    for (int bucket=0; bucket<LatencyHistogram::bucketCount; bucket++) {
+        uint32_t upperMSecs = LatencyHistogram::bucketUpperMSecs(bucket);
+        if (upperMSecs) {
+            labels.append(tr("<= %1 ms").arg(upperMSecs));
+        } else {
+            labels.append(tr("> %1 ms").arg(LatencyHistogram::bucketUpperMSecs(bucket - 1)));
+        }
+    }
+    return labels;
+}
+
 void Vehicle::_handleHeartbeat(mavlink_message_t& message)
 {
     if (message.compid != _defaultComponentId) {
@@ -1548,6 +1820,9 @@ void Vehicle::_handleRadioStatus(mavlink_message_t& message)
         _telemetryRNoise = rnoise;
         emit telemetryRNoiseChanged(_telemetryRNoise);
     }
+    if (_linkQualityAdapter) {
+        _linkQualityAdapter->reportMargin(LinkQualityAdapter::SourceRadioStatus, LinkQualityAdapter::radioStatusMarginDb(rstatus));
+    }
 }
 
 void Vehicle::_handleRCChannels(mavlink_message_t& message)
@@ -1576,20 +1851,37 @@ void Vehicle::_handleRCChannels(mavlink_message_t& message)
         &channels.chan17_raw,
         &channels.chan18_raw,
     };
-    int pwmValues[cMaxRcChannels];
 
+    _rcChannels.sequence++;
+    _rcChannels.channelCount = channels.chancount;
     for (int i=0; i<cMaxRcChannels; i++) {
-        uint16_t channelValue = *_rgChannelvalues[i];
+        uint16_t    channelValue    = *_rgChannelvalues[i];
+        int         pwmValue        = -1;
 
-        if (i < channels.chancount) {
-            pwmValues[i] = channelValue == UINT16_MAX ? -1 : channelValue;
-        } else {
-            pwmValues[i] = -1;
+        if (i < channels.chancount && channelValue != UINT16_MAX) {
+            pwmValue = channelValue;
+        }
+        if (pwmValue != _rcChannels.pwmValues[i]) {
+            _rcChannels.pwmValues[i]        = pwmValue;
+            _rcChannels.changeSequence[i]   = _rcChannels.sequence;
         }
     }
 
     emit remoteControlRSSIChanged(channels.rssi);
-    emit rcChannelsChanged(channels.chancount, pwmValues);
+    emit rcChannelsChanged(channels.chancount, _rcChannels.pwmValues);
+}
+
+quint32 Vehicle::rcChannelsChangedMask(quint32 sinceSequence) const
+{
+    quint32 changedMask = 0;
+
+    for (int i=0; i<cMaxRcChannels; i++) {
+        if (_rcChannels.changeSequence[i] > sinceSequence) {
+            changedMask |= 1 << i;
+        }
+    }
+
+    return changedMask;
 }
 
 // Pop warnings ignoring for mavlink headers for both GCC/Clang and MSVC
@@ -1697,13 +1989,19 @@ bool Vehicle::xConfigMotors()
 
 QString Vehicle::formattedMessages()
 {
-    QString messages;
-    for(UASMessage* message: _toolbox->uasMessageHandler()->messages()) {
-        messages += message->getFormatedText();
+    QString             messages;
+    UASMessageModel*    model       = _toolbox->uasMessageHandler()->messages();
+    for (int i = 0; i < model->count(); i++) {
+        messages += model->at(i).getFormatedText();
     }
     return messages;
 }
 
+QAbstractListModel* Vehicle::textMessages()
+{
+    return _toolbox->uasMessageHandler()->messages();
+}
+
 void Vehicle::clearMessages()
 {
     _toolbox->uasMessageHandler()->clearMessages();
@@ -1711,7 +2009,8 @@ void Vehicle::clearMessages()
 
 void Vehicle::_handletextMessageReceived(UASMessage* message)
 {
-    if (message) {
+    // Skip the formatting unless someone is listening
+    if (message && isSignalConnected(QMetaMethod::fromSignal(&Vehicle::newFormattedMessage))) {
         emit newFormattedMessage(message->getFormatedText());
     }
 }
@@ -1985,6 +2284,9 @@ void Vehicle::_sendMessageMultipleNext()
     if (_nextSendMessageMultipleIndex >= _sendMessageMultipleList.count()) {
         _nextSendMessageMultipleIndex = 0;
     }
+    if (_sendMessageMultipleList.isEmpty()) {
+        _sendMultipleTimer.stop();
+    }
 }
 
 void Vehicle::sendMessageMultiple(mavlink_message_t message)
@@ -1995,6 +2297,9 @@ void Vehicle::sendMessageMultiple(mavlink_message_t message)
     info.retryCount =   _sendMessageMultipleRetries;
 
     _sendMessageMultipleList.append(info);
+    if (!_sendMultipleTimer.isActive()) {
+        _sendMultipleTimer.start();
+    }
 }
 
 void Vehicle::_missionManagerError(int errorCode, const QString& errorMsg)
@@ -2017,7 +2322,7 @@ void Vehicle::_rallyPointManagerError(int errorCode, const QString& errorMsg)
 
 void Vehicle::_clearCameraTriggerPoints()
 {
-    _cameraTriggerPoints.clearAndDeleteContents();
+    _cameraTriggerPoints->clear();
 }
 
 void Vehicle::_flightTimerStart()
@@ -2041,21 +2346,19 @@ void Vehicle::_updateFlightTime()
 void Vehicle::_firstMissionLoadComplete()
 {
     disconnect(_missionManager, &MissionManager::newMissionItemsAvailable, this, &Vehicle::_firstMissionLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->planLoadComplete(MAV_MISSION_TYPE_MISSION);
 }
 
 void Vehicle::_firstGeoFenceLoadComplete()
 {
     disconnect(_geoFenceManager, &GeoFenceManager::loadComplete, this, &Vehicle::_firstGeoFenceLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->planLoadComplete(MAV_MISSION_TYPE_FENCE);
 }
 
 void Vehicle::_firstRallyPointLoadComplete()
 {
     disconnect(_rallyPointManager, &RallyPointManager::loadComplete, this, &Vehicle::_firstRallyPointLoadComplete);
-    _initialPlanRequestComplete = true;
-    emit initialPlanRequestCompleteChanged(true);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->planLoadComplete(MAV_MISSION_TYPE_RALLY);
 }
 
 void Vehicle::_parametersReady(bool parametersReady)
@@ -2146,9 +2449,9 @@ void Vehicle::virtualTabletJoystickValue(double roll, double pitch, double yaw,
     }
 }
 
-void Vehicle::_say(const QString& text)
+void Vehicle::_say(const QString& text, AudioOutput::Priority priority)
 {
-    _toolbox->audioOutput()->say(text.toLower());
+    _toolbox->audioOutput()->say(text.toLower(), priority);
 }
 
 bool Vehicle::airship() const
@@ -2263,7 +2566,7 @@ void Vehicle::_handleFlightModeChanged(const QString& flightMode)
 
 void Vehicle::_announceArmedChanged(bool armed)
 {
-    _say(QString("%1 %2").arg(_vehicleIdSpeech()).arg(armed ? tr("armed") : tr("disarmed")));
+    _say(QString("%1 %2").arg(_vehicleIdSpeech()).arg(armed ? tr("armed") : tr("disarmed")), AudioOutput::PriorityHigh);
     if(armed) {
         //-- Keep track of armed coordinates
         _armedPosition = _coordinate;
@@ -2639,23 +2942,19 @@ bool Vehicle::_sendMavCommandShouldRetry(MAV_CMD command)
 
 void Vehicle::_sendMavCommandWorker(bool commandInt, bool requestMessage, bool showError, MavCmdResultHandler resultHandler, void* resultHandlerData, int targetCompId, MAV_CMD command, MAV_FRAME frame, float param1, float param2, float param3, float param4, float param5, float param6, float param7)
 {
-    int entryIndex = _findMavCommandListEntryIndex(targetCompId, command);
-    if (entryIndex != -1 || targetCompId == MAV_COMP_ID_ALL) {
-        bool    compIdAll       = targetCompId == MAV_COMP_ID_ALL;
+    // A COMMAND_ACK to MAV_COMP_ID_ALL can't be matched to the command
+    if (targetCompId == MAV_COMP_ID_ALL) {
         QString rawCommandName  = _toolbox->missionCommandTree()->rawName(command);
 
-        qCDebug(VehicleLog) << QStringLiteral("_sendMavCommandWorker failing %1").arg(compIdAll ? "MAV_COMP_ID_ALL not supportded" : "duplicate command") << rawCommandName;
+        qCDebug(VehicleLog) << "_sendMavCommandWorker failing MAV_COMP_ID_ALL not supportded" << rawCommandName;
 
-        // If we send multiple versions of the same command to a component there is no way to discern which COMMAND_ACK we get back goes with which.
-        // Because of this we fail in that case.
-        MavCmdResultFailureCode_t failureCode = compIdAll ? MavCmdResultCommandResultOnly : MavCmdResultFailureDuplicateCommand;
         if (resultHandler) {
-            (*resultHandler)(resultHandlerData, targetCompId, MAV_RESULT_FAILED, failureCode);
+            (*resultHandler)(resultHandlerData, targetCompId, MAV_RESULT_FAILED, MavCmdResultCommandResultOnly);
         } else {
-            emit mavCommandResult(_id, targetCompId, command, MAV_RESULT_FAILED, failureCode);
+            emit mavCommandResult(_id, targetCompId, command, MAV_RESULT_FAILED, MavCmdResultCommandResultOnly);
         }
         if (showError) {
-            qgcApp()->showAppMessage(tr("Unable to send command: %1.").arg(compIdAll ? tr("Internal error - MAV_COMP_ID_ALL not supported") : tr("Waiting on previous response to same command.")));
+            qgcApp()->showAppMessage(tr("Unable to send command: %1.").arg(tr("Internal error - MAV_COMP_ID_ALL not supported")));
         }
 
         return;
@@ -2683,19 +2982,119 @@ void Vehicle::_sendMavCommandWorker(bool commandInt, bool requestMessage, bool s
         entry.rgParam[6]        = param7;
         entry.maxTries          = _sendMavCommandShouldRetry(command) ? _mavCommandMaxRetryCount : 1;
         entry.ackTimeoutMSecs   = sharedLink->linkConfiguration()->isHighLatency() ? _mavCommandAckTimeoutMSecsHighLatency : _mavCommandAckTimeoutMSecs;
-        entry.elapsedTimer.start();
 
-        _mavCommandList.append(entry);
-        _sendMavCommandFromList(_mavCommandList.last());
+        if (_mavCommandMustWait(entry)) {
+            qCDebug(VehicleLog) << "_sendMavCommandWorker queued behind same command" << _toolbox->missionCommandTree()->rawName(command);
+            _mavCommandQueue[targetCompId].append(entry);
+        } else {
+            _startMavCommand(entry);
+        }
+    }
+}
+
+/// Different commands to a component are all in flight together. There is no way to discern which COMMAND_ACK goes with
+/// which of multiple same commands to a component though, so those go one at a time. The exception is requestMessage
+/// for different messages: the message received is what counts and the acks are matched to them in the order sent.
+///     @return true: The command has to wait for the one ahead of it in _mavCommandList
+bool Vehicle::_mavCommandMustWait(const MavCommandListEntry_t& commandEntry)
+{
+    for (const MavCommandListEntry_t& entry: _mavCommandList) {
+        if (entry.targetCompId == commandEntry.targetCompId && entry.command == commandEntry.command) {
+            if (!entry.requestMessage || !commandEntry.requestMessage || entry.rgParam[0] == commandEntry.rgParam[0]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void Vehicle::_startMavCommand(const MavCommandListEntry_t& commandEntry)
+{
+    _mavCommandList.append(commandEntry);
+    _sendMavCommandFromList(_mavCommandList.last());
+    _armMavCommandResponseCheckTimer();
+}
+
+/// Called once a command to the component is done with, to send the queued commands which no longer have to wait
+void Vehicle::_startNextQueuedMavCommand(int targetCompId)
+{
+    auto queueIt = _mavCommandQueue.find(targetCompId);
+    if (queueIt == _mavCommandQueue.end()) {
+        return;
+    }
+
+    QList<MavCommandListEntry_t>& queue = queueIt.value();
+    QList<MavCommandListEntry_t>  startList;
+    for (int i=0; i<queue.count(); i++) {
+        bool mustWait = _mavCommandMustWait(queue[i]);
+        for (int j=0; !mustWait && j<startList.count(); j++) {
+            mustWait = startList[j].command == queue[i].command;
+        }
+        if (!mustWait) {
+            startList.append(queue.takeAt(i--));
+        }
+    }
+    if (queue.isEmpty()) {
+        _mavCommandQueue.erase(queueIt);
+    }
+
+    for (const MavCommandListEntry_t& entry: startList) {
+        _startMavCommand(entry);
+    }
+}
+
+void Vehicle::_armMavCommandResponseCheckTimer(void)
+{
+    qint64 nextTimeoutMSecs = -1;
+    for (const MavCommandListEntry_t& commandEntry: _mavCommandList) {
+        qint64 remainingMSecs = qMax(static_cast<qint64>(0), commandEntry.tryTimeoutMSecs - commandEntry.elapsedTimer.elapsed());
+        if (nextTimeoutMSecs == -1 || remainingMSecs < nextTimeoutMSecs) {
+            nextTimeoutMSecs = remainingMSecs;
+        }
+    }
+
+    if (nextTimeoutMSecs == -1) {
+        _mavCommandResponseCheckTimer.stop();
+    } else {
+        _mavCommandResponseCheckTimer.start(static_cast<int>(nextTimeoutMSecs));
+    }
+}
+
+void Vehicle::_updateMavCommandRtt(int targetCompId, qint64 rttMSecs)
+{
+    auto rttIt = _mavCommandRtt.find(targetCompId);
+    if (rttIt == _mavCommandRtt.end()) {
+        _mavCommandRtt[targetCompId] = { static_cast<double>(rttMSecs), rttMSecs / 2.0 };
+    } else {
+        MavCommandRtt_t& rtt = rttIt.value();
+        rtt.rttVarMSecs = (0.75 * rtt.rttVarMSecs) + (0.25 * qAbs(rtt.srttMSecs - rttMSecs));
+        rtt.srttMSecs   = (0.875 * rtt.srttMSecs) + (0.125 * rttMSecs);
     }
 }
 
+/// Commands which are retried are retried once the ack is overdue going by the round trip times seen so far from the
+/// component. Commands which aren't retried get the full ack timeout since giving up early on those is no help.
+int Vehicle::_mavCommandTryTimeoutMSecs(const MavCommandListEntry_t& commandEntry) const
+{
+    auto rttIt = _mavCommandRtt.constFind(commandEntry.targetCompId);
+    if (commandEntry.maxTries == 1 || rttIt == _mavCommandRtt.constEnd()) {
+        return commandEntry.ackTimeoutMSecs;
+    }
+
+    int rtoMSecs = qRound(rttIt->srttMSecs + (4 * rttIt->rttVarMSecs));
+    return qBound(_mavCommandMinAckTimeoutMSecs, rtoMSecs, commandEntry.ackTimeoutMSecs);
+}
+
 void Vehicle::_sendMavCommandFromList(MavCommandListEntry_t& commandEntry)
 {
     QString rawCommandName  = _toolbox->missionCommandTree()->rawName(commandEntry.command);
 
     if (++commandEntry.tryCount > commandEntry.maxTries) {
         qCDebug(VehicleLog) << "_sendMavCommandFromList giving up after max retries" << rawCommandName;
+        if (commandEntry.requestMessage) {
+            _waitForMavlinkMessageClear(_requestMessageWaitForMessageResultHandler, commandEntry.resultHandlerData);
+        }
         if (commandEntry.resultHandler) {
             (*commandEntry.resultHandler)(commandEntry.resultHandlerData, commandEntry.targetCompId, MAV_RESULT_FAILED, MavCmdResultFailureNoResponseToCommand);
         } else {
@@ -2704,10 +3103,20 @@ void Vehicle::_sendMavCommandFromList(MavCommandListEntry_t& commandEntry)
         if (commandEntry.showError) {
             qgcApp()->showAppMessage(tr("Vehicle did not respond to command: %1").arg(rawCommandName));
         }
-        _mavCommandList.removeAt(_findMavCommandListEntryIndex(commandEntry.targetCompId, commandEntry.command));
+        int targetCompId = commandEntry.targetCompId;
+        for (int i=0; i<_mavCommandList.count(); i++) {
+            if (&_mavCommandList.at(i) == &commandEntry) {
+                _mavCommandList.removeAt(i);
+                break;
+            }
+        }
+        _startNextQueuedMavCommand(targetCompId);
         return;
     }
 
+    commandEntry.elapsedTimer.start();
+    commandEntry.tryTimeoutMSecs = _mavCommandTryTimeoutMSecs(commandEntry);
+
     if (commandEntry.tryCount > 1 && !px4Firmware() && commandEntry.command == MAV_CMD_START_RX_PAIR) {
         // The implementation of this command comes from the IO layer and is shared across stacks. So for other firmwares
         // we aren't really sure whether they are correct or not.
@@ -2716,7 +3125,7 @@ void Vehicle::_sendMavCommandFromList(MavCommandListEntry_t& commandEntry)
 
     if (commandEntry.requestMessage) {
         RequestMessageInfo_t* pInfo = static_cast<RequestMessageInfo_t*>(commandEntry.resultHandlerData);
-        _waitForMavlinkMessage(_requestMessageWaitForMessageResultHandler, pInfo, pInfo->msgId, 1000);
+        _waitForMavlinkMessage(_requestMessageWaitForMessageResultHandler, pInfo, pInfo->compId, pInfo->msgId, 1000);
     }
 
     qCDebug(VehicleLog) << "_sendMavCommandFromList command:tryCount" << rawCommandName << commandEntry.tryCount;
@@ -2775,18 +3184,17 @@ void Vehicle::_sendMavCommandFromList(MavCommandListEntry_t& commandEntry)
 
 void Vehicle::_sendMavCommandResponseTimeoutCheck(void)
 {
-    if (_mavCommandList.isEmpty()) {
-        return;
-    }
-
-    // Walk the list backwards since _sendMavCommandFromList can remove entries
+    // Walk the list backwards since _sendMavCommandFromList can remove entries. Queued commands it starts are appended
+    // after the ones still to be checked.
     for (int i=_mavCommandList.count()-1; i>=0; i--) {
         MavCommandListEntry_t& commandEntry = _mavCommandList[i];
-        if (commandEntry.elapsedTimer.elapsed() > commandEntry.ackTimeoutMSecs) {
+        if (commandEntry.elapsedTimer.elapsed() >= commandEntry.tryTimeoutMSecs) {
             // Try sending command again
             _sendMavCommandFromList(commandEntry);
         }
     }
+
+    _armMavCommandResponseCheckTimer();
 }
 
 void Vehicle::_handleCommandAck(mavlink_message_t& message)
@@ -2820,8 +3228,13 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
     int entryIndex = _findMavCommandListEntryIndex(message.compid, static_cast<MAV_CMD>(ack.command));
     bool commandInList = false;
     if (entryIndex != -1) {
-        const MavCommandListEntry_t& commandEntry = _mavCommandList[entryIndex];
+        // A copy since the result handler may send commands, which changes _mavCommandList
+        const MavCommandListEntry_t commandEntry = _mavCommandList[entryIndex];
         if (commandEntry.command == ack.command) {
+            // An ack to a retry may be for an earlier try, so only first tries give round trip times
+            if (commandEntry.tryCount == 1) {
+                _updateMavCommandRtt(message.compid, commandEntry.elapsedTimer.elapsed());
+            }
             if (commandEntry.requestMessage) {
                 RequestMessageInfo_t* pInfo = static_cast<RequestMessageInfo_t*>(commandEntry.resultHandlerData);
                 pInfo->commandAckReceived = true;
@@ -2829,14 +3242,13 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
                     if (pInfo->messageReceived) {
                         delete pInfo;
                     } else {
-                        _waitForMavlinkMessageTimeoutActive = true;
-                        _waitForMavlinkMessageElapsed.restart();
+                        _waitForMavlinkMessageStartTimeout(_requestMessageWaitForMessageResultHandler, pInfo);
                     }
                 } else {
                     if (pInfo->messageReceived) {
                         qCWarning(VehicleLog) << "Internal Error: _handleCommandAck for requestMessage with result failure, but message already received";
                     } else {
-                        _waitForMavlinkMessageClear();
+                        _waitForMavlinkMessageClear(_requestMessageWaitForMessageResultHandler, pInfo);
                         (*commandEntry.resultHandler)(commandEntry.resultHandlerData, message.compid, static_cast<MAV_RESULT>(ack.result), MavCmdResultCommandResultOnly);
                     }
                 }
@@ -2867,64 +3279,148 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
                 }
             }
 
-            _mavCommandList.removeAt(entryIndex);
+            // Looked up again since the result handler may have sent commands
+            _mavCommandList.removeAt(_findMavCommandListEntryIndex(message.compid, static_cast<MAV_CMD>(ack.command)));
             commandInList = true;
+            _startNextQueuedMavCommand(message.compid);
+            _armMavCommandResponseCheckTimer();
         }
     }
 
     if (!commandInList) {
         qCDebug(VehicleLog) << "_handleCommandAck Ack not in list" << rawCommandName;
     }
+}
 
-    // advance PID tuning setup/teardown
-    if (ack.command == MAV_CMD_SET_MESSAGE_INTERVAL && _pidTuningNextAdjustIndex >= 0) {
-        _pidTuningAdjustRates();
-    }
-    if (ack.command == MAV_CMD_GET_MESSAGE_INTERVAL && _pidTuningWaitingForRates) {
-        if (_pidTuningMessageRatesUsecs.count() < _pidTuningMessages.count()) {
-            sendMavCommand(defaultComponentId(),
-                    MAV_CMD_GET_MESSAGE_INTERVAL,
-                    true,                        // show error
-                    _pidTuningMessages[_pidTuningMessageRatesUsecs.count()]);
+void Vehicle::_waitForMavlinkMessage(WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData, int compId, int messageId, int timeoutMsecs)
+{
+    qCDebug(VehicleLog) << "_waitForMavlinkMessage msg:compId:timeout" << messageId << compId << timeoutMsecs;
+
+    _waitForMavlinkMessageTake(resultHandler, resultHandlerData);
+
+    WaitForMavlinkMessage_t wait;
+    wait.resultHandler      = resultHandler;
+    wait.resultHandlerData  = resultHandlerData;
+    wait.compId             = compId;
+    wait.timeoutMsecs       = timeoutMsecs;
+    _waitForMavlinkMessages[messageId].append(wait);
+    _armWaitForMavlinkMessageTimer();
+}
+
+void Vehicle::_waitForMavlinkMessageStartTimeout(WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData)
+{
+    for (QList<WaitForMavlinkMessage_t>& waits: _waitForMavlinkMessages) {
+        for (WaitForMavlinkMessage_t& wait: waits) {
+            if (wait.resultHandler == resultHandler && wait.resultHandlerData == resultHandlerData) {
+                wait.timeoutElapsed.start();
+                _armWaitForMavlinkMessageTimer();
+                return;
+            }
         }
     }
 }
 
-void Vehicle::_waitForMavlinkMessage(WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData, int messageId, int timeoutMsecs)
+void Vehicle::_waitForMavlinkMessageClear(WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData)
 {
-    qCDebug(VehicleLog) << "_waitForMavlinkMessage msg:timeout" << messageId << timeoutMsecs;
-    _waitForMavlinkMessageResultHandler     = resultHandler;
-    _waitForMavlinkMessageResultHandlerData = resultHandlerData;
-    _waitForMavlinkMessageId                = messageId;
-    _waitForMavlinkMessageTimeoutActive     = false;
-    _waitForMavlinkMessageTimeoutMsecs      = timeoutMsecs;
+    qCDebug(VehicleLog) << "_waitForMavlinkMessageClear";
+    _waitForMavlinkMessageTake(resultHandler, resultHandlerData);
+    _armWaitForMavlinkMessageTimer();
 }
 
-void Vehicle::_waitForMavlinkMessageClear(void)
+/// Removes the wait from _waitForMavlinkMessages
+///     @return false: No such wait
+bool Vehicle::_waitForMavlinkMessageTake(WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData)
 {
-    qCDebug(VehicleLog) << "_waitForMavlinkMessageClear";
-    _waitForMavlinkMessageResultHandler     = nullptr;
-    _waitForMavlinkMessageResultHandlerData = nullptr;
-    _waitForMavlinkMessageId                = 0;
+    for (auto waitsIt = _waitForMavlinkMessages.begin(); waitsIt != _waitForMavlinkMessages.end(); waitsIt++) {
+        QList<WaitForMavlinkMessage_t>& waits = waitsIt.value();
+        for (int i=0; i<waits.count(); i++) {
+            if (waits[i].resultHandler == resultHandler && waits[i].resultHandlerData == resultHandlerData) {
+                waits.removeAt(i);
+                if (waits.isEmpty()) {
+                    _waitForMavlinkMessages.erase(waitsIt);
+                }
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void Vehicle::_armWaitForMavlinkMessageTimer(void)
+{
+    qint64 nextTimeoutMsecs = -1;
+    for (const QList<WaitForMavlinkMessage_t>& waits: _waitForMavlinkMessages) {
+        for (const WaitForMavlinkMessage_t& wait: waits) {
+            if (wait.timeoutElapsed.isValid()) {
+                qint64 remainingMsecs = qMax(static_cast<qint64>(0), wait.timeoutMsecs - wait.timeoutElapsed.elapsed());
+                if (nextTimeoutMsecs == -1 || remainingMsecs < nextTimeoutMsecs) {
+                    nextTimeoutMsecs = remainingMsecs;
+                }
+            }
+        }
+    }
+
+    if (nextTimeoutMsecs == -1) {
+        _waitForMavlinkMessageTimer.stop();
+    } else {
+        _waitForMavlinkMessageTimer.start(static_cast<int>(nextTimeoutMsecs));
+    }
 }
 
 void Vehicle::_waitForMavlinkMessageMessageReceived(const mavlink_message_t& message)
 {
-    if (_waitForMavlinkMessageId != 0) {
-        if (_waitForMavlinkMessageId == message.msgid) {
-            WaitForMavlinkMessageResultHandler  resultHandler       = _waitForMavlinkMessageResultHandler;
-            void*                               resultHandlerData   = _waitForMavlinkMessageResultHandlerData;
-            qCDebug(VehicleLog) << "_waitForMavlinkMessageMessageReceived message received" << _waitForMavlinkMessageId;
-            _waitForMavlinkMessageClear();
-            (*resultHandler)(resultHandlerData, false /* noResponseFromVehicle */, message);
-        } else if (_waitForMavlinkMessageTimeoutActive && _waitForMavlinkMessageElapsed.elapsed() > _waitForMavlinkMessageTimeoutMsecs) {
-            WaitForMavlinkMessageResultHandler  resultHandler       = _waitForMavlinkMessageResultHandler;
-            void*                               resultHandlerData   = _waitForMavlinkMessageResultHandlerData;
-            qCDebug(VehicleLog) << "_waitForMavlinkMessageMessageReceived message timed out" << _waitForMavlinkMessageId;
-            _waitForMavlinkMessageClear();
-            (*resultHandler)(resultHandlerData, true /* noResponseFromVehicle */, message);
+    auto waitsIt = _waitForMavlinkMessages.find(message.msgid);
+    if (waitsIt == _waitForMavlinkMessages.end()) {
+        return;
+    }
+
+    // The handlers may start or clear waits, so the ones satisfied are taken out first
+    QList<WaitForMavlinkMessage_t>& waits = waitsIt.value();
+    QList<WaitForMavlinkMessage_t>  receivedWaits;
+    for (int i=0; i<waits.count(); i++) {
+        if (waits[i].compId == MAV_COMP_ID_ALL || waits[i].compId == message.compid) {
+            receivedWaits.append(waits.takeAt(i--));
         }
     }
+    if (waits.isEmpty()) {
+        _waitForMavlinkMessages.erase(waitsIt);
+    }
+    if (receivedWaits.isEmpty()) {
+        return;
+    }
+    _armWaitForMavlinkMessageTimer();
+
+    for (const WaitForMavlinkMessage_t& wait: receivedWaits) {
+        qCDebug(VehicleLog) << "_waitForMavlinkMessageMessageReceived message received" << message.msgid;
+        (*wait.resultHandler)(wait.resultHandlerData, false /* noResponseFromVehicle */, message);
+    }
+}
+
+void Vehicle::_waitForMavlinkMessageTimeout(void)
+{
+    // The handlers may start or clear waits, so all the timed out ones are taken out first
+    QList<WaitForMavlinkMessage_t> timedOutWaits;
+    for (auto waitsIt = _waitForMavlinkMessages.begin(); waitsIt != _waitForMavlinkMessages.end(); ) {
+        QList<WaitForMavlinkMessage_t>& waits = waitsIt.value();
+        for (int i=0; i<waits.count(); i++) {
+            if (waits[i].timeoutElapsed.isValid() && waits[i].timeoutElapsed.elapsed() >= waits[i].timeoutMsecs) {
+                qCDebug(VehicleLog) << "_waitForMavlinkMessageTimeout message timed out" << waitsIt.key();
+                timedOutWaits.append(waits.takeAt(i--));
+            }
+        }
+        if (waits.isEmpty()) {
+            waitsIt = _waitForMavlinkMessages.erase(waitsIt);
+        } else {
+            waitsIt++;
+        }
+    }
+    _armWaitForMavlinkMessageTimer();
+
+    mavlink_message_t message = { };
+    for (const WaitForMavlinkMessage_t& wait: timedOutWaits) {
+        (*wait.resultHandler)(wait.resultHandlerData, true /* noResponseFromVehicle */, message);
+    }
 }
 
 void Vehicle::requestMessage(RequestMessageResultHandler resultHandler, void* resultHandlerData, int compId, int messageId, float param1, float param2, float param3, float param4, float param5)
@@ -2972,7 +3468,9 @@ void Vehicle::_requestMessageCmdResultHandler(void* resultHandlerData, int /*com
 
         (*pInfo->resultHandler)(pInfo->resultHandlerData, result,  requestMessageFailureCode, message);
     }
-    if (pInfo->messageReceived) {
+
+    // The message wait is cleared along with a failed command, so the message will never come
+    if (pInfo->messageReceived || result != MAV_RESULT_ACCEPTED) {
         delete pInfo;
     }
 }
@@ -2983,6 +3481,9 @@ void Vehicle::_requestMessageWaitForMessageResultHandler(void* resultHandlerData
 
     pInfo->messageReceived = true;
     (*pInfo->resultHandler)(pInfo->resultHandlerData, noResponsefromVehicle ? MAV_RESULT_FAILED : MAV_RESULT_ACCEPTED, noResponsefromVehicle ? RequestMessageFailureMessageNotReceived : RequestMessageNoFailure, message);
+    if (pInfo->commandAckReceived) {
+        delete pInfo;
+    }
 }
 
 void Vehicle::setPrearmError(const QString& prearmError)
@@ -3507,28 +4008,36 @@ void Vehicle::_vehicleParamLoaded(bool ready)
     }
 }
 
-void Vehicle::_trafficUpdate(bool /*alert*/, QString /*traffic_id*/, QString /*vehicle_id*/, QGeoCoordinate /*location*/, float /*heading*/)
+#if defined(QGC_AIRMAP_ENABLED)
+void Vehicle::_trafficUpdate(const QList<AirspaceVehicleManager::Traffic_t> /*traffic*/)
 {
 #if 0
     // This is ifdef'ed out for now since this code doesn't mesh with the recent ADSB manager changes. Also airmap isn't in any
     // released build. So not going to waste time trying to fix up unused code.
-    if (_trafficVehicleMap.contains(traffic_id)) {
-        _trafficVehicleMap[traffic_id]->update(alert, location, heading);
-    } else {
-        ADSBVehicle* vehicle = new ADSBVehicle(location, heading, alert, this);
-        _trafficVehicleMap[traffic_id] = vehicle;
-        _adsbVehicles.append(vehicle);
+    for (const AirspaceVehicleManager::Traffic_t& aircraft: traffic) {
+        if (_trafficVehicleMap.contains(aircraft.trafficId)) {
+            _trafficVehicleMap[aircraft.trafficId]->update(aircraft.alert, aircraft.location, aircraft.heading);
+        } else {
+            ADSBVehicle* vehicle = new ADSBVehicle(aircraft.location, aircraft.heading, aircraft.alert, this);
+            _trafficVehicleMap[aircraft.trafficId] = vehicle;
+            _adsbVehicles.append(vehicle);
+        }
     }
 #endif
 }
+#endif
 
-void Vehicle::_mavlinkMessageStatus(int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent)
+void Vehicle::_mavlinkMessageStatus(LinkInterface* link, int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent, float receiveRateHz, int maxMessageGapMSecs)
 {
-    if(uasId == _id) {
+    // With redundant links each link reports its own statistics, only show the ones for the link in use
+    if (uasId == _id && link == _vehicleLinkManager->primaryLink().lock().get()) {
         _mavlinkSentCount       = totalSent;
         _mavlinkReceivedCount   = totalReceived;
         _mavlinkLossCount       = totalLoss;
         _mavlinkLossPercent     = lossPercent;
+        _mavlinkReceiveRate     = receiveRateHz;
+        _mavlinkMaxMessageGap   = maxMessageGapMSecs;
+        _joystickLatency        = link->controlLatency();
         emit mavlinkStatusChanged();
     }
 }
@@ -3545,134 +4054,70 @@ int  Vehicle::versionCompare(int major, int minor, int patch)
 
 void Vehicle::_handleMessageInterval(const mavlink_message_t& message)
 {
-    if (_pidTuningWaitingForRates) {
-        mavlink_message_interval_t messageInterval;
-
-        mavlink_msg_message_interval_decode(&message, &messageInterval);
-
-        int msgId = messageInterval.message_id;
-        if (_pidTuningMessages.contains(msgId)) {
-            _pidTuningMessageRatesUsecs[msgId] = messageInterval.interval_us;
-        }
-
-        if (_pidTuningMessageRatesUsecs.count() == _pidTuningMessages.count()) {
-            // We have back all the rates we requested
-            _pidTuningWaitingForRates = false;
-            _pidTuningNextAdjustIndex = 0;
-            _pidTuningAdjustRates();
-        }
-    }
+    _messageIntervalManager->mavlinkMessageReceived(message);
 }
 
 void Vehicle::setPIDTuningTelemetryMode(bool pidTuning)
 {
-    if (pidTuning) {
-        if (!_pidTuningTelemetryMode) {
-            // First step is to get the current message rates before we adjust them
-            _pidTuningTelemetryMode = true;
-            _pidTuningWaitingForRates = true;
-            _pidTuningMessageRatesUsecs.clear();
-            sendMavCommand(defaultComponentId(),
-                    MAV_CMD_GET_MESSAGE_INTERVAL,
-                    true,                        // show error
-                    _pidTuningMessages[0]);
-        }
-    } else {
-        if (_pidTuningTelemetryMode) {
-            _pidTuningTelemetryMode = false;
-            if (_pidTuningWaitingForRates) {
-                // We never finished waiting for previous rates
-                _pidTuningWaitingForRates = false;
-            } else {
-                _pidTuningNextAdjustIndex = 0;
-                _pidTuningAdjustRates();
-            }
-        }
-    }
-}
-
-void Vehicle::_pidTuningAdjustRates()
-{
-    int requestedRate = (int)(1000000.0 / 100.0); // 100 Hz in usecs (better set this a bit higher than actually needed,
-    // to give it more priority in case of exceeing link bandwidth)
-
-    if (_pidTuningNextAdjustIndex >= _pidTuningMessages.size()) {
-        _pidTuningNextAdjustIndex = -1;
+    if (pidTuning == _pidTuningTelemetryMode) {
         return;
     }
-    int telemetry = _pidTuningMessages[_pidTuningNextAdjustIndex];
-
-    if (requestedRate < _pidTuningMessageRatesUsecs[telemetry] || _pidTuningMessageRatesUsecs[telemetry] == 0) {
-        sendMavCommand(defaultComponentId(),
-                MAV_CMD_SET_MESSAGE_INTERVAL,
-                true,                        // show error
-                telemetry,
-                _pidTuningTelemetryMode ? requestedRate : _pidTuningMessageRatesUsecs[telemetry]);
-    }
+    _pidTuningTelemetryMode = pidTuning;
 
-    if (_pidTuningNextAdjustIndex == 0) {
-        setLiveUpdates(_pidTuningTelemetryMode);
-        _setpointFactGroup.setLiveUpdates(_pidTuningTelemetryMode);
+    // The manager takes care of restoring the previous rates once tuning is done
+    for (int msgId: _pidTuningMessages) {
+        if (pidTuning) {
+            _messageIntervalManager->subscribe(&_pidTuningMessages, static_cast<uint32_t>(msgId), _pidTuningRateHz);
+        } else {
+            _messageIntervalManager->unsubscribe(&_pidTuningMessages, static_cast<uint32_t>(msgId));
+        }
     }
-    ++_pidTuningNextAdjustIndex;
+    setLiveUpdates(pidTuning);
+    _setpointFactGroup.setLiveUpdates(pidTuning);
 }
 
-void Vehicle::_initializeCsv()
+void Vehicle::_startTelemetryLog()
 {
     if(!_toolbox->settingsManager()->appSettings()->saveCsvTelemetry()->rawValue().toBool()){
         return;
     }
     QString now = QDateTime::currentDateTime().toString("yyyy-MM-dd hh-mm-ss");
-    QString fileName = QString("%1 vehicle%2.csv").arg(now).arg(_id);
+    QString fileName = QString("%1 vehicle%2.%3").arg(now).arg(_id).arg(FactTelemetryLog::fileExtension);
     QDir saveDir(_toolbox->settingsManager()->appSettings()->telemetrySavePath());
-    _csvLogFile.setFileName(saveDir.absoluteFilePath(fileName));
 
-    if (!_csvLogFile.open(QIODevice::Append)) {
-        qCWarning(VehicleLog) << "unable to open file for csv logging, Stopping csv logging!";
-        return;
+    // Facts are looked up once here rather than by name on every sample
+    QStringList     allFactNames;
+    QList<Fact*>    allFacts;
+    for (const QString& factName: factNames()) {
+        allFactNames << factName;
+        allFacts << getFact(factName);
     }
-
-    QTextStream stream(&_csvLogFile);
-    QStringList allFactNames;
-    allFactNames << factNames();
     for (const QString& groupName: factGroupNames()) {
-        for(const QString& factName: getFactGroup(groupName)->factNames()){
+        FactGroup* factGroup = getFactGroup(groupName);
+        for(const QString& factName: factGroup->factNames()){
             allFactNames << QString("%1.%2").arg(groupName, factName);
+            allFacts << factGroup->getFact(factName);
         }
     }
-    qCDebug(VehicleLog) << "Facts logged to csv:" << allFactNames;
-    stream << "Timestamp," << allFactNames.join(",") << "\n";
+    _telemetryLog.start(saveDir.absoluteFilePath(fileName), allFactNames, allFacts);
 }
 
-void Vehicle::_writeCsvLine()
+void Vehicle::_telemetryLogTimeout()
 {
     // Only save the logs after the the vehicle gets armed, unless "Save logs even if vehicle was not armed" is checked
-    if(!_csvLogFile.isOpen() &&
+    if(!_telemetryLog.isOpen() &&
             (_armed || _toolbox->settingsManager()->appSettings()->telemetrySaveNotArmed()->rawValue().toBool())){
-        _initializeCsv();
+        _startTelemetryLog();
     }
 
-    if(!_csvLogFile.isOpen()){
-        return;
-    }
-
-    QStringList allFactValues;
-    QTextStream stream(&_csvLogFile);
-
-    // Write timestamp to csv file
-    allFactValues << QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz"));
-    // Write Vehicle's own facts
-    for (const QString& factName : factNames()) {
-        allFactValues << getFact(factName)->cookedValueString();
-    }
-    // write facts from Vehicle's FactGroups
-    for (const QString& groupName: factGroupNames()) {
-        for (const QString& factName : getFactGroup(groupName)->factNames()) {
-            allFactValues << getFactGroup(groupName)->getFact(factName)->cookedValueString();
-        }
-    }
+    _telemetryLog.sample(QDateTime::currentMSecsSinceEpoch());
+}
 
-    stream << allFactValues.join(",") << "\n";
+void Vehicle::_updateTelemetryLogRate()
+{
+    int rateHz = qBound(1, _toolbox->settingsManager()->appSettings()->csvTelemetryRate()->rawValue().toInt(), 50);
+    _telemetryLogTimer.setInterval(1000 / rateHz);
+    _telemetryLogTimer.setTimerType(rateHz > 1 ? Qt::PreciseTimer : Qt::CoarseTimer);
 }
 
 #if !defined(NO_ARDUPILOT_DIALECT)
@@ -3754,7 +4199,14 @@ void Vehicle::_handleObstacleDistance(const mavlink_message_t& message)
 {
     mavlink_obstacle_distance_t o;
     mavlink_msg_obstacle_distance_decode(&message, &o);
-    _objectAvoidance->update(&o);
+    _objectAvoidance->update(message.compid, &o);
+}
+
+void Vehicle::_handleObstacleDistance3D(const mavlink_message_t& message)
+{
+    mavlink_obstacle_distance_3d_t o;
+    mavlink_msg_obstacle_distance_3d_decode(&message, &o);
+    _objectAvoidance->update(message.compid, &o);
 }
 
 void Vehicle::updateFlightDistance(double distance)
@@ -3820,14 +4272,14 @@ void Vehicle::clearAllParamMapRC(void)
     }
 }
 
-void Vehicle::sendJoystickDataThreadSafe(float roll, float pitch, float yaw, float thrust, quint16 buttons)
+void Vehicle::sendJoystickDataThreadSafe(float roll, float pitch, float yaw, float thrust, quint16 buttons, const QElapsedTimer& inputTimer)
 {
     WeakLinkInterfacePtr weakLink = vehicleLinkManager()->primaryLink();
 
     if (!weakLink.expired()) {
         SharedLinkInterfacePtr  sharedLink = weakLink.lock();
 
-        if (sharedLink->linkConfiguration()->isHighLatency()) {
+        if (sharedLink->linkConfiguration()->isHighLatency() || !sharedLink->isConnected()) {
             return;
         }
 
@@ -3851,7 +4303,16 @@ void Vehicle::sendJoystickDataThreadSafe(float roll, float pitch, float yaw, flo
                     static_cast<int16_t>(newThrustCommand),
                     static_cast<int16_t>(newYawCommand),
                     buttons);
-        sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+
+        // Same as sendMessageOnLinkThreadSafe except the frame goes on the control channel
+        _firmwarePlugin->adjustOutgoingMavlinkMessageThreadSafe(this, sharedLink.get(), &message);
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        int len = mavlink_msg_to_send_buffer(buffer, &message);
+
+        sharedLink->writeControlBytesThreadSafe(reinterpret_cast<const char*>(buffer), len, inputTimer);
+        _messagesSent++;
+        emit messagesSentChanged();
     }
 }
 
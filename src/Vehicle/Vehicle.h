@@ -15,8 +15,12 @@
 #include <QGeoCoordinate>
 #include <QTime>
 #include <QQueue>
+#include <QHash>
+
+#include <functional>
 
 #include "FactGroup.h"
+#include "TelemetryFact.h"
 #include "QGCMAVLink.h"
 #include "QmlObjectListModel.h"
 #include "MAVLinkProtocol.h"
@@ -39,6 +43,10 @@
 #include "GeoFenceManager.h"
 #include "RallyPointManager.h"
 #include "FTPManager.h"
+#include "LatencyHistogram.h"
+#include "FactTelemetryLog.h"
+#include "SensorStreamTap.h"
+#include "AudioOutput.h"
 
 class UAS;
 class UASInterface;
@@ -53,6 +61,7 @@ class QGCCameraManager;
 class Joystick;
 class VehicleObjectAvoidance;
 class TrajectoryPoints;
+class CameraTriggerPoints;
 class TerrainProtocolHandler;
 class ComponentInformationManager;
 class VehicleBatteryFactGroup;
@@ -62,9 +71,11 @@ class RequestMessageTest;
 class LinkInterface;
 class LinkManager;
 class InitialConnectStateMachine;
+class MessageIntervalManager;
+class LinkQualityAdapter;
 
 #if defined(QGC_AIRMAP_ENABLED)
-class AirspaceVehicleManager;
+#include "AirspaceVehicleManager.h"
 #endif
 
 Q_DECLARE_LOGGING_CATEGORY(VehicleLog)
@@ -88,7 +99,8 @@ public:
             MAV_AUTOPILOT           firmwareType,
             MAV_TYPE                vehicleType,
             FirmwarePluginManager*  firmwarePluginManager,
-            JoystickManager*        joystickManager);
+            JoystickManager*        joystickManager,
+            bool                    reducedPipeline = false);
 
     // Pass these into the offline constructor to create an offline vehicle which tracks the offline vehicle settings
     static const MAV_AUTOPILOT    MAV_AUTOPILOT_TRACK = static_cast<MAV_AUTOPILOT>(-1);
@@ -152,7 +164,7 @@ public:
     Q_PROPERTY(QStringList          extraJoystickFlightModes    READ extraJoystickFlightModes                                       NOTIFY flightModesChanged)
     Q_PROPERTY(QString              flightMode                  READ flightMode                 WRITE setFlightMode                 NOTIFY flightModeChanged)
     Q_PROPERTY(TrajectoryPoints*    trajectoryPoints            MEMBER _trajectoryPoints                                            CONSTANT)
-    Q_PROPERTY(QmlObjectListModel*  cameraTriggerPoints         READ cameraTriggerPoints                                            CONSTANT)
+    Q_PROPERTY(CameraTriggerPoints* cameraTriggerPoints         MEMBER _cameraTriggerPoints                                         CONSTANT)
     Q_PROPERTY(float                latitude                    READ latitude                                                       NOTIFY coordinateChanged)
     Q_PROPERTY(float                longitude                   READ longitude                                                      NOTIFY coordinateChanged)
     Q_PROPERTY(bool                 messageTypeNone             READ messageTypeNone                                                NOTIFY messageTypeChanged)
@@ -162,6 +174,7 @@ public:
     Q_PROPERTY(int                  newMessageCount             READ newMessageCount                                                NOTIFY newMessageCountChanged)
     Q_PROPERTY(int                  messageCount                READ messageCount                                                   NOTIFY messageCountChanged)
     Q_PROPERTY(QString              formattedMessages           READ formattedMessages                                              NOTIFY formattedMessagesChanged)
+    Q_PROPERTY(QAbstractListModel*  textMessages                READ textMessages                                                   CONSTANT)   ///< Most recent messages, see UASMessageModel for the roles
     Q_PROPERTY(QString              latestError                 READ latestError                                                    NOTIFY latestErrorChanged)
     Q_PROPERTY(bool                 joystickEnabled             READ joystickEnabled            WRITE setJoystickEnabled            NOTIFY joystickEnabledChanged)
     Q_PROPERTY(int                  flowImageIndex              READ flowImageIndex                                                 NOTIFY flowImageIndexChanged)
@@ -173,6 +186,7 @@ public:
     Q_PROPERTY(uint                 messagesReceived            READ messagesReceived                                               NOTIFY messagesReceivedChanged)
     Q_PROPERTY(uint                 messagesSent                READ messagesSent                                                   NOTIFY messagesSentChanged)
     Q_PROPERTY(uint                 messagesLost                READ messagesLost                                                   NOTIFY messagesLostChanged)
+    Q_PROPERTY(double               messageHandlersPerMessage   READ messageHandlersPerMessage                                      NOTIFY messagesReceivedChanged)
     Q_PROPERTY(bool                 airship                     READ airship                                                        NOTIFY vehicleTypeChanged)
     Q_PROPERTY(bool                 fixedWing                   READ fixedWing                                                      NOTIFY vehicleTypeChanged)
     Q_PROPERTY(bool                 multiRotor                  READ multiRotor                                                     NOTIFY vehicleTypeChanged)
@@ -189,6 +203,7 @@ public:
     Q_PROPERTY(bool                 coaxialMotors               READ coaxialMotors                                                  CONSTANT)
     Q_PROPERTY(bool                 xConfigMotors               READ xConfigMotors                                                  CONSTANT)
     Q_PROPERTY(bool                 isOfflineEditingVehicle     READ isOfflineEditingVehicle                                        CONSTANT)
+    Q_PROPERTY(bool                 reducedPipeline             READ reducedPipeline                                                NOTIFY reducedPipelineChanged)     ///< true: Fleet vehicle which only tracks heartbeat, position, battery and status
     Q_PROPERTY(QString              brandImageIndoor            READ brandImageIndoor                                               NOTIFY firmwareTypeChanged)
     Q_PROPERTY(QString              brandImageOutdoor           READ brandImageOutdoor                                              NOTIFY firmwareTypeChanged)
     Q_PROPERTY(int                  sensorsPresentBits          READ sensorsPresentBits                                             NOTIFY sensorsPresentBitsChanged)
@@ -227,6 +242,20 @@ public:
     Q_PROPERTY(quint64              mavlinkReceivedCount        READ mavlinkReceivedCount                                           NOTIFY mavlinkStatusChanged)
     Q_PROPERTY(quint64              mavlinkLossCount            READ mavlinkLossCount                                               NOTIFY mavlinkStatusChanged)
     Q_PROPERTY(float                mavlinkLossPercent          READ mavlinkLossPercent                                             NOTIFY mavlinkStatusChanged)
+    Q_PROPERTY(float                mavlinkReceiveRate          READ mavlinkReceiveRate                                             NOTIFY mavlinkStatusChanged)
+    Q_PROPERTY(int                  mavlinkMaxMessageGap        READ mavlinkMaxMessageGap                                           NOTIFY mavlinkStatusChanged)
+    Q_PROPERTY(bool                 measurePingLatency          READ measurePingLatency         WRITE setMeasurePingLatency         NOTIFY measurePingLatencyChanged)
+    Q_PROPERTY(int                  pingLatencyCount            READ pingLatencyCount                                               NOTIFY pingLatencyChanged)
+    Q_PROPERTY(float                pingLatency                 READ pingLatency                                                    NOTIFY pingLatencyChanged)
+    Q_PROPERTY(float                pingLatencyMedian           READ pingLatencyMedian                                              NOTIFY pingLatencyChanged)
+    Q_PROPERTY(float                pingLatency95th             READ pingLatency95th                                                NOTIFY pingLatencyChanged)
+    Q_PROPERTY(float                pingLatencyMax              READ pingLatencyMax                                                 NOTIFY pingLatencyChanged)
+    Q_PROPERTY(QVariantList         pingLatencyHistogram        READ pingLatencyHistogram                                           NOTIFY pingLatencyChanged)
+    Q_PROPERTY(QStringList          pingLatencyBucketLabels     READ pingLatencyBucketLabels                                        CONSTANT)
+    Q_PROPERTY(int                  joystickLatencyCount        READ joystickLatencyCount                                           NOTIFY mavlinkStatusChanged)
+    Q_PROPERTY(float                joystickLatencyMedian       READ joystickLatencyMedian                                          NOTIFY mavlinkStatusChanged)
+    Q_PROPERTY(float                joystickLatency95th         READ joystickLatency95th                                            NOTIFY mavlinkStatusChanged)
+    Q_PROPERTY(float                joystickLatencyMax          READ joystickLatencyMax                                             NOTIFY mavlinkStatusChanged)
     Q_PROPERTY(qreal                gimbalRoll                  READ gimbalRoll                                                     NOTIFY gimbalRollChanged)
     Q_PROPERTY(qreal                gimbalPitch                 READ gimbalPitch                                                    NOTIFY gimbalPitchChanged)
     Q_PROPERTY(qreal                gimbalYaw                   READ gimbalYaw                                                      NOTIFY gimbalYawChanged)
@@ -415,7 +444,9 @@ public:
 
     bool joystickEnabled            ();
     void setJoystickEnabled         (bool enabled);
-    void sendJoystickDataThreadSafe (float roll, float pitch, float yaw, float thrust, quint16 buttons);
+    /// Sends MANUAL_CONTROL on the control channel of the primary link, which goes out ahead of all other traffic
+    ///     @param inputTimer Started when the input was sampled, used for the joystick latency. May be invalid.
+    void sendJoystickDataThreadSafe (float roll, float pitch, float yaw, float thrust, quint16 buttons, const QElapsedTimer& inputTimer = QElapsedTimer());
 
     // Property accesors
     int id() { return _id; }
@@ -472,7 +503,7 @@ public:
     QString prearmError() const { return _prearmError; }
     void setPrearmError(const QString& prearmError);
 
-    QmlObjectListModel* cameraTriggerPoints () { return &_cameraTriggerPoints; }
+    CameraTriggerPoints* cameraTriggerPoints() { return _cameraTriggerPoints; }
 
     int  flowImageIndex() { return _flowImageIndex; }
 
@@ -490,6 +521,13 @@ public:
     void trackFirmwareVehicleTypeChanges(void);
     void stopTrackingFirmwareVehicleTypeChanges(void);
 
+    /// Runs the parameter, plan and camera initialization which a reduced pipeline vehicle put off. Does nothing for
+    /// a vehicle which already has its full pipeline.
+    void startFullPipeline(void);
+
+    /// @return true: The message is processed by a vehicle with a reduced pipeline
+    static bool reducedPipelineMessage(uint32_t msgid);
+
     typedef enum {
         MessageNone,
         MessageNormal,
@@ -504,6 +542,7 @@ public:
     int             newMessageCount             () { return _currentMessageCount; }
     int             messageCount                () { return _messageCount; }
     QString         formattedMessages           ();
+    QAbstractListModel* textMessages            ();
     QString         latestError                 () { return _latestError; }
     float           latitude                    () { return static_cast<float>(_coordinate.latitude()); }
     float           longitude                   () { return static_cast<float>(_coordinate.longitude()); }
@@ -515,6 +554,7 @@ public:
     uint            messagesReceived            () { return _messagesReceived; }
     uint            messagesSent                () { return _messagesSent; }
     uint            messagesLost                () { return _messagesLost; }
+    double          messageHandlersPerMessage   () const { return _messageDispatchCount ? static_cast<double>(_messageHandlerRunCount) / _messageDispatchCount : 0; }
     bool            flying                      () const { return _flying; }
     bool            landing                     () const { return _landing; }
     bool            guidedMode                  () const;
@@ -522,6 +562,7 @@ public:
     uint8_t         baseMode                    () const { return _base_mode; }
     uint32_t        customMode                  () const { return _custom_mode; }
     bool            isOfflineEditingVehicle     () const { return _offlineEditingVehicle; }
+    bool            reducedPipeline             () const { return _reducedPipeline; }
     QString         brandImageIndoor            () const;
     QString         brandImageOutdoor           () const;
     int             sensorsPresentBits          () const { return static_cast<int>(_onboardControlSensorsPresent); }
@@ -612,18 +653,36 @@ public:
     FactGroup* terrainFactGroup             () { return &_terrainFactGroup; }
     QmlObjectListModel* batteries           () { return &_batteryFactGroupListModel; }
 
+    TrajectoryPoints*               trajectoryPoints    () { return _trajectoryPoints; }
     MissionManager*                 missionManager      () { return _missionManager; }
     GeoFenceManager*                geoFenceManager     () { return _geoFenceManager; }
     RallyPointManager*              rallyPointManager   () { return _rallyPointManager; }
     ParameterManager*               parameterManager    () { return _parameterManager; }
     ParameterManager*               parameterManager    () const { return _parameterManager; }
     VehicleLinkManager*             vehicleLinkManager  () { return _vehicleLinkManager; }
+    MessageIntervalManager*         messageIntervalManager() { return _messageIntervalManager; }
+    LinkQualityAdapter*             linkQualityAdapter  () { return _linkQualityAdapter; }
+    SensorStreamTap*                sensorStreamTap     () { return &_sensorStreamTap; }
     FTPManager*                     ftpManager          () { return _ftpManager; }
     ComponentInformationManager*    compInfoManager     () { return _componentInformationManager; }
     VehicleObjectAvoidance*         objectAvoidance     () { return _objectAvoidance; }
 
     static const int cMaxRcChannels = 18;
 
+    /// RC input as of the latest RC_CHANNELS message. Displays poll this at their own update rate rather than following
+    /// rcChannelsChanged, which is signalled at the rate of the message.
+    typedef struct {
+        quint32 sequence;                           ///< Incremented by each RC_CHANNELS message
+        int     channelCount;
+        int     pwmValues[cMaxRcChannels];          ///< -1 signals channel not available
+        quint32 changeSequence[cMaxRcChannels];     ///< sequence at which each value last changed
+    } RcChannels_t;
+
+    const RcChannels_t& rcChannels(void) const { return _rcChannels; }
+
+    /// @return Bit per channel whose value changed after the specified RcChannels_t::sequence
+    quint32 rcChannelsChangedMask(quint32 sinceSequence) const;
+
     /// Sends the specified MAV_CMD to the vehicle. If no Ack is received command will be retried. If a sendMavCommand is already in progress
     /// the command will be queued and sent when the previous command completes.
     ///     @param compId Component to send to.
@@ -639,7 +698,7 @@ public:
     typedef enum {
         MavCmdResultCommandResultOnly,          ///< commandResult specifies full success/fail info
         MavCmdResultFailureNoResponseToCommand, ///< No response from vehicle to command
-        MavCmdResultFailureDuplicateCommand,    ///< Unable to send command since duplicate is already being waited on for response
+        MavCmdResultFailureDuplicateCommand,    ///< No longer reported, a duplicate command now waits for the one ahead of it
     } MavCmdResultFailureCode_t;
 
     /// Callback for sendMavCommandWithHandler
@@ -745,7 +804,26 @@ public:
     quint64     mavlinkSentCount        () { return _mavlinkSentCount; }        /// Calculated total number of messages sent to us
     quint64     mavlinkReceivedCount    () { return _mavlinkReceivedCount; }    /// Total number of sucessful messages received
     quint64     mavlinkLossCount        () { return _mavlinkLossCount; }        /// Total number of lost messages
-    float       mavlinkLossPercent      () { return _mavlinkLossPercent; }      /// Running loss rate
+    float       mavlinkLossPercent      () { return _mavlinkLossPercent; }      /// Loss rate over the last few seconds
+    float       mavlinkReceiveRate      () { return _mavlinkReceiveRate; }      /// Messages per second over the last few seconds
+    int         mavlinkMaxMessageGap    () { return _mavlinkMaxMessageGap; }    /// Longest time in msecs between messages over the last few seconds
+
+    /// Round trip PING latency to the autopilot over the primary link. Latencies are in msecs.
+    bool            measurePingLatency      () const { return _pingTimer.isActive(); }
+    void            setMeasurePingLatency   (bool measure);
+    int             pingLatencyCount        () const { return static_cast<int>(_pingLatency.count()); }
+    float           pingLatency             () const { return _pingLatency.lastUSecs() / 1000.0f; }
+    float           pingLatencyMedian       () const { return _pingLatency.percentileUSecs(50) / 1000.0f; }
+    float           pingLatency95th         () const { return _pingLatency.percentileUSecs(95) / 1000.0f; }
+    float           pingLatencyMax          () const { return _pingLatency.maxUSecs() / 1000.0f; }
+    QVariantList    pingLatencyHistogram    () const;                           /// Sample count for each bucket
+    QStringList     pingLatencyBucketLabels () const;
+
+    /// Joystick input to wire latency of MANUAL_CONTROL on the primary link. Latencies are in msecs.
+    int             joystickLatencyCount    () const { return static_cast<int>(_joystickLatency.count()); }
+    float           joystickLatencyMedian   () const { return _joystickLatency.percentileUSecs(50) / 1000.0f; }
+    float           joystickLatency95th     () const { return _joystickLatency.percentileUSecs(95) / 1000.0f; }
+    float           joystickLatencyMax      () const { return _joystickLatency.maxUSecs() / 1000.0f; }
 
     qreal       gimbalRoll              () { return static_cast<qreal>(_curGimbalRoll);}
     qreal       gimbalPitch             () { return static_cast<qreal>(_curGimbalPitch); }
@@ -780,6 +858,7 @@ signals:
     void firmwareTypeChanged            ();
     void vehicleTypeChanged             ();
     void cameraManagerChanged           ();
+    void reducedPipelineChanged         ();
     void hobbsMeterChanged              ();
     void capabilitiesKnownChanged       (bool capabilitiesKnown);
     void initialPlanRequestCompleteChanged(bool initialPlanRequestComplete);
@@ -854,6 +933,8 @@ signals:
     // MAVLink protocol version
     void requestProtocolVersion         (unsigned version);
     void mavlinkStatusChanged           ();
+    void measurePingLatencyChanged      ();
+    void pingLatencyChanged             ();
 
     void gimbalRollChanged              ();
     void gimbalPitchChanged             ();
@@ -863,7 +944,7 @@ signals:
     void initialConnectComplete         ();
 
 private slots:
-    void _mavlinkMessageReceived            (LinkInterface* link, mavlink_message_t message);
+    void _mavlinkMessagesReceived           (LinkInterface* link, const QVector<mavlink_message_t>& messages);
     void _sendMessageMultipleNext           ();
     void _parametersReady                   (bool parametersReady);
     void _remoteControlRSSIChanged          (uint8_t rssi);
@@ -879,6 +960,7 @@ private slots:
     void _firstGeoFenceLoadComplete         ();
     void _firstRallyPointLoadComplete       ();
     void _sendMavCommandResponseTimeoutCheck();
+    void _waitForMavlinkMessageTimeout      ();
     void _clearCameraTriggerPoints          ();
     void _updateDistanceHeadingToHome       ();
     void _updateMissionItemIndex            ();
@@ -887,12 +969,21 @@ private slots:
     void _updateHobbsMeter                  ();
     void _vehicleParamLoaded                (bool ready);
     void _sendQGCTimeToVehicle              ();
-    void _mavlinkMessageStatus              (int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
-    void _trafficUpdate                     (bool alert, QString traffic_id, QString vehicle_id, QGeoCoordinate location, float heading);
+    void _mavlinkMessageStatus              (LinkInterface* link, int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent, float receiveRateHz, int maxMessageGapMSecs);
+#if defined(QGC_AIRMAP_ENABLED)
+    void _trafficUpdate                     (const QList<AirspaceVehicleManager::Traffic_t> traffic);
+#endif
     void _orbitTelemetryTimeout             ();
+    void _sendPing                          ();
     void _updateFlightTime                  ();
 
 private:
+    void _mavlinkMessageReceived        (LinkInterface* link, mavlink_message_t message);
+    bool _dispatchMessage               (mavlink_message_t& message);
+    void _startInitialConnect           (void);
+    void _registerMessageHandlers       (void);
+    void _rebuildFactGroupDispatch      (void);
+    void _factGroupLiveUpdatesChanged   (bool liveUpdates);
     void _joystickChanged               (Joystick* joystick);
     void _loadSettings                  ();
     void _saveSettings                  ();
@@ -920,6 +1011,7 @@ private:
     void _handleMessageInterval         (const mavlink_message_t& message);
     void _handleGimbalOrientation       (const mavlink_message_t& message);
     void _handleObstacleDistance        (const mavlink_message_t& message);
+    void _handleObstacleDistance3D      (const mavlink_message_t& message);
     // ArduPilot dialect messages
 #if !defined(NO_ARDUPILOT_DIALECT)
     void _handleCameraFeedback          (const mavlink_message_t& message);
@@ -929,7 +1021,7 @@ private:
     void _missionManagerError           (int errorCode, const QString& errorMsg);
     void _geoFenceManagerError          (int errorCode, const QString& errorMsg);
     void _rallyPointManagerError        (int errorCode, const QString& errorMsg);
-    void _say                           (const QString& text);
+    void _say                           (const QString& text, AudioOutput::Priority priority = AudioOutput::PriorityNormal);
     QString _vehicleIdSpeech            ();
     void _handleMavlinkLoggingData      (mavlink_message_t& message);
     void _handleMavlinkLoggingDataAcked (mavlink_message_t& message);
@@ -939,19 +1031,21 @@ private:
     void _setCapabilities               (uint64_t capabilityBits);
     void _updateArmed                   (bool armed);
     bool _apmArmingNotRequired          ();
-    void _pidTuningAdjustRates          ();
-    void _initializeCsv                 ();
-    void _writeCsvLine                  ();
+    void _startTelemetryLog             ();
+    void _telemetryLogTimeout           ();
+    void _updateTelemetryLogRate        ();
     void _flightTimerStart              ();
     void _flightTimerStop               ();
     void _chunkedStatusTextTimeout      (void);
-    void _chunkedStatusTextCompleted    (uint8_t compId);
+    void _chunkedStatusTextCompleted    (uint32_t key, bool missingEnd);
+    void _statusTextCompleted           (uint8_t compId, uint8_t severity, QString messageText);
 
     static void _rebootCommandResultHandler(void* resultHandlerData, int compId, MAV_RESULT commandResult, MavCmdResultFailureCode_t failureCode);
 
     int     _id;                    ///< Mavlink system id
     int     _defaultComponentId;
     bool    _offlineEditingVehicle = false; ///< true: This Vehicle is a "disconnected" vehicle for ui use while offline editing
+    bool    _reducedPipeline = false;       ///< true: Full initialization is put off until the vehicle is made active, see startFullPipeline
 
     MAV_AUTOPILOT       _firmwareType;
     MAV_TYPE            _vehicleType;
@@ -963,8 +1057,8 @@ private:
     QGCToolbox*         _toolbox = nullptr;
     SettingsManager*    _settingsManager = nullptr;
 
-    QTimer              _csvLogTimer;
-    QFile               _csvLogFile;
+    QTimer              _telemetryLogTimer;
+    FactTelemetryLog    _telemetryLog;
 
     bool            _joystickEnabled = false;
 
@@ -1004,6 +1098,7 @@ private:
     uint32_t        _telemetryTXBuffer = 0;
     int             _telemetryLNoise = 0;
     int             _telemetryRNoise = 0;
+    RcChannels_t    _rcChannels = { };
     bool            _mavlinkProtocolRequestComplete         = false;
     unsigned        _mavlinkProtocolRequestMaxProtoVersion  = 0;
     unsigned        _maxProtoVersion                        = 0;
@@ -1056,7 +1151,7 @@ private:
     QElapsedTimer                   _flightTimer;
     QTimer                          _flightTimeUpdater;
     TrajectoryPoints*               _trajectoryPoints = nullptr;
-    QmlObjectListModel              _cameraTriggerPoints;
+    CameraTriggerPoints*            _cameraTriggerPoints = nullptr;
     //QMap<QString, ADSBVehicle*>     _trafficVehicleMap;
 
     // Toolbox references
@@ -1068,6 +1163,16 @@ private:
     uint                _messagesReceived = 0;
     uint                _messagesSent = 0;
     uint                _messagesLost = 0;
+
+    /// Manager level message handler. Returns false to stop any further processing of the message.
+    typedef std::function<bool(mavlink_message_t& message)> MessageHandler_t;
+
+    QHash<uint32_t, QList<MessageHandler_t>>    _messageHandlers;               ///< Manager handlers keyed by message id
+    QHash<uint32_t, QList<FactGroup*>>          _factGroupsByMessageId;         ///< FactGroups keyed by the message ids they handle
+    QList<FactGroup*>                           _factGroupsForAllMessages;      ///< FactGroups which did not restrict their message ids
+    quint64                                     _messageDispatchCount   = 0;    ///< Number of messages dispatched
+    quint64                                     _messageHandlerRunCount = 0;    ///< Number of handlers which ran across all dispatched messages
+    SensorStreamTap                             _sensorStreamTap;               ///< Message fields copied to chart buffers as they arrive
     uint8_t             _messageSeq = 0;
     uint8_t             _compID = 0;
     bool                _heardFrom = false;
@@ -1095,6 +1200,15 @@ private:
     uint64_t    _mavlinkReceivedCount   = 0;
     uint64_t    _mavlinkLossCount       = 0;
     float       _mavlinkLossPercent     = 0.0f;
+    float       _mavlinkReceiveRate     = 0.0f;
+    int         _mavlinkMaxMessageGap   = 0;
+
+    QTimer              _pingTimer;
+    QElapsedTimer       _pingElapsed;           ///< PING time_usec is relative to this, responses echo it back
+    uint32_t            _pingSeq            = 0;
+    LatencyHistogram    _pingLatency;
+    static const int    _pingIntervalMSecs  = 1000;
+    LatencyHistogram    _joystickLatency;       ///< Copy of the primary link control latency, updated with the mavlink status
 
     QMap<QString, QTime> _noisySpokenPrearmMap; ///< Used to prevent PreArm messages from being spoken too often
 
@@ -1106,19 +1220,23 @@ private:
 
     // PID Tuning telemetry mode
     bool            _pidTuningTelemetryMode = false;
-    bool            _pidTuningWaitingForRates = false;
-    int             _pidTuningNextAdjustIndex = -1;
-    QMap<int, int>  _pidTuningMessageRatesUsecs;
     static const QList<int> _pidTuningMessages;
+    static const int _pidTuningRateHz = 100;    ///< Set a bit higher than actually needed to give it more priority in case of exceeding link bandwidth
 
     // Chunked status text support
     typedef struct {
-        uint16_t    chunkId;
-        uint8_t     severity;
-        QStringList rgMessageChunks;
+        uint8_t         compId;
+        uint8_t         severity;
+        int             nextChunkSeq;
+        QByteArray      text;               ///< Utf8, only converted once all chunks are in
+        QElapsedTimer   lastChunkTimer;
     } ChunkedStatusTextInfo_t;
-    QMap<uint8_t /* compId */, ChunkedStatusTextInfo_t> _chunkedStatusTextInfoMap;
-    QTimer _chunkedStatusTextTimer;
+    QHash<uint32_t /* compId << 16 | id */, ChunkedStatusTextInfo_t> _chunkedStatusTextInfoMap;
+    QTimer _chunkedStatusTextTimer;         ///< Checks all the pending sequences for timeouts, only runs while there are some
+
+    static const int _chunkedStatusTextTimeoutMSecs     = 1000;
+    static const int _chunkedStatusTextCheckMSecs       = 250;
+    static const int _chunkedStatusTextReserveChunks    = 4;
 
     /// Callback for waitForMavlinkMessage
     ///     @param resultHandleData     Opaque data passed in to waitForMavlinkMessage call
@@ -1126,18 +1244,29 @@ private:
     ///     @param noReponseFromVehicle true: The vehicle did not responsed to the COMMAND_LONG message
     typedef void (*WaitForMavlinkMessageResultHandler)(void* resultHandlerData, bool noResponsefromVehicle, const mavlink_message_t& message);
 
-    /// Waits for the specified msecs for the message to be received. Calls timeoutHandler if not received.
-    void _waitForMavlinkMessage     (WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData, int messageId, int timeoutMsecs);
-    void _waitForMavlinkMessageClear(void);
+    /// Waits for the message from the component, any number of waits can be pending at the same time. The timeout only
+    /// runs once _waitForMavlinkMessageStartTimeout is called, which is usually when the vehicle acks the request for it.
+    ///     @param resultHandler        Along with resultHandlerData identifies the wait to the other _waitForMavlinkMessage calls,
+    ///                                 a pending wait with the same pair is replaced
+    ///     @param compId               MAV_COMP_ID_ALL: Message from any component
+    void _waitForMavlinkMessage             (WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData, int compId, int messageId, int timeoutMsecs);
+    void _waitForMavlinkMessageStartTimeout (WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData);
+    void _waitForMavlinkMessageClear        (WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData);
+
+    typedef struct {
+        WaitForMavlinkMessageResultHandler  resultHandler;
+        void*                               resultHandlerData;
+        int                                 compId;
+        int                                 timeoutMsecs;
+        QElapsedTimer                       timeoutElapsed;     ///< Invalid until the timeout starts
+    } WaitForMavlinkMessage_t;
 
-    int                                 _waitForMavlinkMessageId                = 0;
-    bool                                _waitForMavlinkMessageTimeoutActive     = false;
-    int                                 _waitForMavlinkMessageTimeoutMsecs      = 0;
-    QElapsedTimer                       _waitForMavlinkMessageElapsed;
-    WaitForMavlinkMessageResultHandler  _waitForMavlinkMessageResultHandler     = nullptr;
-    void*                               _waitForMavlinkMessageResultHandlerData = nullptr;
+    QHash<int /* msgId */, QList<WaitForMavlinkMessage_t>>  _waitForMavlinkMessages;
+    QTimer                                                  _waitForMavlinkMessageTimer;    ///< Single shot, armed for the earliest running timeout
 
-    void _waitForMavlinkMessageMessageReceived(const mavlink_message_t& message);
+    void _waitForMavlinkMessageMessageReceived  (const mavlink_message_t& message);
+    bool _waitForMavlinkMessageTake             (WaitForMavlinkMessageResultHandler resultHandler, void* resultHandlerData);
+    void _armWaitForMavlinkMessageTimer         (void);
 
     // requestMessage handling
     typedef struct RequestMessageInfo {
@@ -1164,19 +1293,34 @@ private:
         void*               resultHandlerData   = nullptr;
         int                 maxTries            = _mavCommandMaxRetryCount;
         int                 tryCount            = 0;
-        QElapsedTimer       elapsedTimer;
+        QElapsedTimer       elapsedTimer;                                       // Restarted with each try
         int                 ackTimeoutMSecs     = _mavCommandAckTimeoutMSecs;
+        int                 tryTimeoutMSecs     = _mavCommandAckTimeoutMSecs;   // Timeout of the current try, see _mavCommandTryTimeoutMSecs
     } MavCommandListEntry_t;
 
-    QList<MavCommandListEntry_t>    _mavCommandList;
-    QTimer                          _mavCommandResponseCheckTimer;
+    /// Smoothed COMMAND_ACK round trip time of a component, as TCP estimates it (RFC 6298)
+    typedef struct {
+        double  srttMSecs;
+        double  rttVarMSecs;
+    } MavCommandRtt_t;
+
+    QList<MavCommandListEntry_t>                    _mavCommandList;                        ///< Commands waiting on an ack, see _mavCommandMustWait for what can be in here together
+    QHash<int, QList<MavCommandListEntry_t>>        _mavCommandQueue;                       ///< By component, commands waiting for the same command ahead of them to finish
+    QHash<int, MavCommandRtt_t>                     _mavCommandRtt;                         ///< By component
+    QTimer                                          _mavCommandResponseCheckTimer;          ///< Single shot, armed for the earliest try timeout in _mavCommandList
     static const int                _mavCommandMaxRetryCount                = 3;
-    static const int                _mavCommandResponseCheckTimeoutMSecs    = 500;
+    static const int                _mavCommandMinAckTimeoutMSecs           = 500;
     static const int                _mavCommandAckTimeoutMSecs              = 3000;
     static const int                _mavCommandAckTimeoutMSecsHighLatency   = 120000;
 
     void _sendMavCommandWorker  (bool commandInt, bool requestMessage, bool showError, MavCmdResultHandler resultHandler, void* resultHandlerData, int compId, MAV_CMD command, MAV_FRAME frame, float param1, float param2, float param3, float param4, float param5, float param6, float param7);
+    void _startMavCommand       (const MavCommandListEntry_t& commandEntry);
+    bool _mavCommandMustWait    (const MavCommandListEntry_t& commandEntry);
+    void _startNextQueuedMavCommand(int targetCompId);
     void _sendMavCommandFromList(MavCommandListEntry_t& commandEntry);
+    void _armMavCommandResponseCheckTimer(void);
+    void _updateMavCommandRtt   (int targetCompId, qint64 rttMSecs);
+    int  _mavCommandTryTimeoutMSecs(const MavCommandListEntry_t& commandEntry) const;
     int  _findMavCommandListEntryIndex(int targetCompId, MAV_CMD command);
     bool _sendMavCommandShouldRetry(MAV_CMD command);
 
@@ -1184,17 +1328,17 @@ private:
 
     // FactGroup facts
 
-    Fact _rollFact;
-    Fact _pitchFact;
-    Fact _headingFact;
-    Fact _rollRateFact;
-    Fact _pitchRateFact;
-    Fact _yawRateFact;
-    Fact _groundSpeedFact;
-    Fact _airSpeedFact;
-    Fact _climbRateFact;
-    Fact _altitudeRelativeFact;
-    Fact _altitudeAMSLFact;
+    TelemetryFact _rollFact;
+    TelemetryFact _pitchFact;
+    TelemetryFact _headingFact;
+    TelemetryFact _rollRateFact;
+    TelemetryFact _pitchRateFact;
+    TelemetryFact _yawRateFact;
+    TelemetryFact _groundSpeedFact;
+    TelemetryFact _airSpeedFact;
+    TelemetryFact _climbRateFact;
+    TelemetryFact _altitudeRelativeFact;
+    TelemetryFact _altitudeAMSLFact;
     Fact _flightDistanceFact;
     Fact _flightTimeFact;
     Fact _distanceToHomeFact;
@@ -1223,6 +1367,8 @@ private:
     GeoFenceManager*                _geoFenceManager            = nullptr;
     RallyPointManager*              _rallyPointManager          = nullptr;
     VehicleLinkManager*             _vehicleLinkManager         = nullptr;
+    MessageIntervalManager*         _messageIntervalManager     = nullptr;
+    LinkQualityAdapter*             _linkQualityAdapter         = nullptr;
     FTPManager*                     _ftpManager                 = nullptr;
     InitialConnectStateMachine*     _initialConnectStateMachine = nullptr;
 
@@ -24,6 +24,9 @@ VehicleClockFactGroup::VehicleClockFactGroup(QObject* parent)
     // Start out as not available "--.--"
     _currentTimeFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _currentDateFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
+
+    // Values are updated from a timer, no messages are needed
+    _setHandledMessageIds({ });
 }
 
 void VehicleClockFactGroup::_updateAllValues()
@@ -50,6 +50,8 @@ VehicleDistanceSensorFactGroup::VehicleDistanceSensorFactGroup(QObject* parent)
     _addFact(&_rotationPitch270Fact,    _rotationPitch270FactName);
     _addFact(&_minDistanceFact,         _minDistanceFactName);
     _addFact(&_maxDistanceFact,         _maxDistanceFactName);
+
+    _setHandledMessageIds({ MAVLINK_MSG_ID_DISTANCE_SENSOR });
 }
 
 void VehicleDistanceSensorFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
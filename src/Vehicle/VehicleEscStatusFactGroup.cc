@@ -62,6 +62,8 @@ VehicleEscStatusFactGroup::VehicleEscStatusFactGroup(QObject* parent)
     _addFact(&_voltageSecondFact,               _voltageSecondFactName);
     _addFact(&_voltageThirdFact,                _voltageThirdFactName);
     _addFact(&_voltageFourthFact,               _voltageFourthFactName);
+
+    _setHandledMessageIds({ MAVLINK_MSG_ID_ESC_STATUS });
 }
 
 void VehicleEscStatusFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
@@ -73,6 +75,21 @@ void VehicleEscStatusFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_me
     mavlink_esc_status_t content;
     mavlink_msg_esc_status_decode(&message, &content);
 
+    const int escsPerMessage = sizeof(content.rpm) / sizeof(content.rpm[0]);
+    for (int i=0; i<escsPerMessage; i++) {
+        _escs.setEsc(content.index + i, content.rpm[i], content.current[i], content.voltage[i]);
+    }
+    if (liveUpdates() || updateRateMSecs() == 0) {
+        _escs.flush();
+    }
+    _setTelemetryAvailable(true);
+
+    // Vehicles with more than four ESCs send a message for each block of four. Only the first block goes to the
+    // Facts so they don't flip between blocks.
+    if (content.index != 0) {
+        return;
+    }
+
     index()->setRawValue                        (content.index);
 
     rpmFirst()->setRawValue                     (content.rpm[0]);
@@ -90,3 +107,9 @@ void VehicleEscStatusFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_me
     voltageThird()->setRawValue                 (content.voltage[2]);
     voltageFourth()->setRawValue                (content.voltage[3]);
 }
+
+void VehicleEscStatusFactGroup::_updateAllValues(void)
+{
+    _escs.flush();
+    FactGroup::_updateAllValues();
+}
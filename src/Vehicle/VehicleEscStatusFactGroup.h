@@ -11,9 +11,12 @@
 
 #include "FactGroup.h"
 #include "QGCMAVLink.h"
+#include "VehicleEscStatusListModel.h"
 
 class Vehicle;
 
+/// The rpm/current/voltage Facts are the first four ESCs. All ESCs, however many the vehicle has, are in the escs
+/// model which is updated at the rate of the group like the Facts are.
 class VehicleEscStatusFactGroup : public FactGroup
 {
     Q_OBJECT
@@ -22,6 +25,7 @@ public:
     VehicleEscStatusFactGroup(QObject* parent = nullptr);
 
     Q_PROPERTY(Fact* index              READ index              CONSTANT)
+    Q_PROPERTY(VehicleEscStatusListModel* escs READ escs        CONSTANT)
 
     Q_PROPERTY(Fact* rpmFirst           READ rpmFirst           CONSTANT)
     Q_PROPERTY(Fact* rpmSecond          READ rpmSecond          CONSTANT)
@@ -39,6 +43,7 @@ public:
     Q_PROPERTY(Fact* voltageFourth      READ voltageFourth      CONSTANT)
 
     Fact* index                         () { return &_indexFact; }
+    VehicleEscStatusListModel* escs     () { return &_escs; }
 
     Fact* rpmFirst                      () { return &_rpmFirstFact; }
     Fact* rpmSecond                     () { return &_rpmSecondFact; }
@@ -74,7 +79,14 @@ public:
     static const char* _voltageSecondFactName;
     static const char* _voltageThirdFactName;
     static const char* _voltageFourthFactName;
+
+protected slots:
+    // Overrides from FactGroup
+    void _updateAllValues(void) override;
+
 private:
+    VehicleEscStatusListModel _escs;
+
     Fact _indexFact;
 
     Fact _rpmFirstFact;
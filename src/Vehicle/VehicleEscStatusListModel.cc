@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleEscStatusListModel.h"
+
+#include <QQmlEngine>
+
+VehicleEscStatusListModel::VehicleEscStatusListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+}
+
+void VehicleEscStatusListModel::setEsc(int escIndex, int32_t rpm, float current, float voltage)
+{
+    if (escIndex < 0) {
+        return;
+    }
+
+    if (escIndex >= _escs.count()) {
+        // New rows are a structural change and go out right away, only value changes are held for flush
+        beginInsertRows(QModelIndex(), _escs.count(), escIndex);
+        _escs.resize(escIndex + 1);
+        endInsertRows();
+        emit countChanged(_escs.count());
+    }
+
+    EscStatus_t& esc = _escs[escIndex];
+    if (esc.rpm == rpm && esc.current == current && esc.voltage == voltage) {
+        return;
+    }
+    esc.rpm     = rpm;
+    esc.current = current;
+    esc.voltage = voltage;
+
+    if (_firstChanged == -1) {
+        _firstChanged = _lastChanged = escIndex;
+    } else {
+        _firstChanged   = qMin(_firstChanged, escIndex);
+        _lastChanged    = qMax(_lastChanged, escIndex);
+    }
+}
+
+void VehicleEscStatusListModel::flush(void)
+{
+    if (_firstChanged == -1) {
+        return;
+    }
+
+    int first   = _firstChanged;
+    int last    = _lastChanged;
+    _firstChanged = _lastChanged = -1;
+    emit dataChanged(index(first), index(last), { RpmRole, CurrentRole, VoltageRole });
+}
+
+int VehicleEscStatusListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : _escs.count();
+}
+
+QVariant VehicleEscStatusListModel::data(const QModelIndex& index, int role) const
+{
+    int row = index.row();
+    if (row < 0 || row >= _escs.count()) {
+        return QVariant();
+    }
+
+    const EscStatus_t& esc = _escs[row];
+    switch (role) {
+    case EscIndexRole:
+        return row;
+    case RpmRole:
+        return esc.rpm;
+    case CurrentRole:
+        return esc.current;
+    case VoltageRole:
+        return esc.voltage;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> VehicleEscStatusListModel::roleNames(void) const
+{
+    return {
+        { EscIndexRole, "escIndex" },
+        { RpmRole,      "rpm" },
+        { CurrentRole,  "current" },
+        { VoltageRole,  "voltage" },
+    };
+}
@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QVector>
+
+/// Telemetry for any number of ESCs, one row per ESC index.
+///
+/// Rows are added as ESC_STATUS messages for new indices show up. Values are stored packed instead of one Fact per
+/// value, and changes are held until flush, which sends a single dataChanged covering the rows which changed.
+class VehicleEscStatusListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    VehicleEscStatusListModel(QObject* parent = nullptr);
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+    enum Roles {
+        EscIndexRole = Qt::UserRole + 1,
+        RpmRole,
+        CurrentRole,
+        VoltageRole,
+    };
+
+    typedef struct {
+        int32_t rpm;
+        float   current;
+        float   voltage;
+    } EscStatus_t;
+
+    int                 count   (void) const { return _escs.count(); }
+    const EscStatus_t&  esc     (int escIndex) const { return _escs[escIndex]; }
+
+    /// Stores new values for an ESC, adding rows up to it as needed. Nothing is signalled until flush.
+    void setEsc (int escIndex, int32_t rpm, float current, float voltage);
+
+    /// Sends out the changes since the last flush
+    void flush  (void);
+
+    // Overrides from QAbstractListModel
+    int                     rowCount    (const QModelIndex& parent = QModelIndex()) const override;
+    QVariant                data        (const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray>  roleNames   (void) const override;
+
+signals:
+    void countChanged(int count);
+
+private:
+    QVector<EscStatus_t>    _escs;                  ///< Indexed by ESC index
+    int                     _firstChanged   = -1;   ///< Range of rows changed since the last flush, -1: none
+    int                     _lastChanged    = -1;
+};
@@ -74,6 +74,8 @@ VehicleEstimatorStatusFactGroup::VehicleEstimatorStatusFactGroup(QObject* parent
     _addFact(&_tasRatioFact,                    _tasRatioFactName);
     _addFact(&_horizPosAccuracyFact,            _horizPosAccuracyFactName);
     _addFact(&_vertPosAccuracyFact,             _vertPosAccuracyFactName);
+
+    _setHandledMessageIds({ MAVLINK_MSG_ID_ESTIMATOR_STATUS });
 }
 
 void VehicleEstimatorStatusFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
@@ -46,6 +46,8 @@ VehicleGPSFactGroup::VehicleGPSFactGroup(QObject* parent)
     _hdopFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _vdopFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _courseOverGroundFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
+
+    _setHandledMessageIds({ MAVLINK_MSG_ID_GPS_RAW_INT, MAVLINK_MSG_ID_HIGH_LATENCY, MAVLINK_MSG_ID_HIGH_LATENCY2 });
 }
 
 void VehicleGPSFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
@@ -27,7 +27,7 @@ VehicleLinkManager::VehicleLinkManager(Vehicle* vehicle)
     _commLostCheckTimer.setInterval(_commLostCheckTimeoutMSecs);
 }
 
-void VehicleLinkManager::mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
+bool VehicleLinkManager::mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
     // Radio status messages come from Sik Radios directly. It doesn't indicate there is any life on the other end.
     if (message.msgid != MAVLINK_MSG_ID_RADIO_STATUS) {
@@ -41,7 +41,48 @@ void VehicleLinkManager::mavlinkMessageReceived(LinkInterface* link, mavlink_mes
                 _commRegainedOnLink(link);
             }
         }
+
+        // Redundant radios deliver the same frame on each link. Link liveness above is tracked on every copy,
+        // but only the first copy goes on to the vehicle.
+        if (_rgLinkInfo.count() > 1 && _isDuplicateFrame(link, message)) {
+            _duplicateMessageCount++;
+            return false;
+        }
     }
+
+    return true;
+}
+
+/// Remembers the frame and checks whether an identical frame was recently received on a different link
+bool VehicleLinkManager::_isDuplicateFrame(LinkInterface* link, const mavlink_message_t& message)
+{
+    // The checksum is part of the key so that a sequence number which wraps within the window, or a different
+    // component reusing the sequence number, is not mistaken for a duplicate
+    quint64 key =   (static_cast<quint64>(message.sysid)    << 56) |
+                    (static_cast<quint64>(message.compid)   << 48) |
+                    (static_cast<quint64>(message.seq)      << 40) |
+                    (static_cast<quint64>(message.msgid)    << 16) |
+                    static_cast<quint64>(message.checksum);
+
+    if (!_duplicateTimer.isValid()) {
+        _duplicateTimer.start();
+    }
+    qint64 nowMSecs = _duplicateTimer.elapsed();
+
+    for (const RecentFrame_t& recentFrame: _recentFrames) {
+        if (recentFrame.key == key && recentFrame.link && recentFrame.link != link && nowMSecs - recentFrame.receivedMSecs <= _duplicateWindowMSecs) {
+            qCDebug(VehicleLinkManagerLog) << "Dropping duplicate msgid:seq" << message.msgid << message.seq << "from" << link->linkConfiguration()->name();
+            return true;
+        }
+    }
+
+    RecentFrame_t& recentFrame = _recentFrames[_nextRecentFrame];
+    recentFrame.key             = key;
+    recentFrame.link            = link;
+    recentFrame.receivedMSecs   = nowMSecs;
+    _nextRecentFrame = (_nextRecentFrame + 1) % _recentFrameCount;
+
+    return false;
 }
 
 void VehicleLinkManager::_commRegainedOnLink(LinkInterface* link)
@@ -209,6 +250,13 @@ void VehicleLinkManager::_removeLink(LinkInterface* link)
             emit primaryLinkChanged();
         }
 
+        // A new link may be allocated at the same address, don't let it match frames from the old one
+        for (RecentFrame_t& recentFrame: _recentFrames) {
+            if (recentFrame.link == link) {
+                recentFrame.link = nullptr;
+            }
+        }
+
         disconnect(link, &LinkInterface::disconnected, this, &VehicleLinkManager::_linkDisconnected);
         link->removeVehicleReference();
         emit linkNamesChanged();
@@ -43,7 +43,7 @@ public:
     Q_PROPERTY(bool             autoDisconnect              MEMBER _autoDisconnect                                              NOTIFY autoDisconnectChanged)
 
     bool                    primaryLinkIsPX4Flow        (void) const;
-    void                    mavlinkMessageReceived      (LinkInterface* link, mavlink_message_t message);
+    bool                    mavlinkMessageReceived      (LinkInterface* link, mavlink_message_t message);   ///< @return false: Duplicate of a message already received on another link, drop it
     bool                    containsLink                (LinkInterface* link);
     WeakLinkInterfacePtr    primaryLink                 (void) { return _primaryLink; }
     QString                 primaryLinkName             (void) const;
@@ -54,6 +54,7 @@ public:
     void                    setPrimaryLinkByName        (const QString& name);
     void                    setCommunicationLostEnabled (bool communicationLostEnabled);
     void                    closeVehicle                (void);
+    quint64                 duplicateMessageCount       (void) const { return _duplicateMessageCount; }
 
 signals:
     void primaryLinkChanged             (void);
@@ -75,6 +76,7 @@ private:
     bool                    _updatePrimaryLink      (void);
     WeakLinkInterfacePtr    _bestActivePrimaryLink  (void);
     void                    _commRegainedOnLink     (LinkInterface*  link);
+    bool                    _isDuplicateFrame       (LinkInterface* link, const mavlink_message_t& message);
 
     typedef struct LinkInfo {
         SharedLinkInterfacePtr  link;
@@ -82,6 +84,15 @@ private:
         QElapsedTimer           heartbeatElapsedTimer;
     } LinkInfo_t;
 
+    static const int _recentFrameCount          = 128;   // Frames remembered for duplicate detection across links
+    static const int _duplicateWindowMSecs      = 1000;  // A frame arriving later than this after the first copy is not treated as a duplicate
+
+    typedef struct RecentFrame {
+        quint64         key             = 0;
+        LinkInterface*  link            = nullptr;  ///< Only used for comparison, never dereferenced
+        qint64          receivedMSecs   = 0;
+    } RecentFrame_t;
+
     Vehicle*                _vehicle                    = nullptr;
     LinkManager*            _linkMgr                    = nullptr;
     QTimer                  _commLostCheckTimer;
@@ -90,6 +101,10 @@ private:
     bool                    _communicationLost          = false;
     bool                    _communicationLostEnabled   = true;
     bool                    _autoDisconnect             = false;    ///< true: Automatically disconnect vehicle when last connection goes away or lost heartbeat
+    RecentFrame_t           _recentFrames[_recentFrameCount];
+    int                     _nextRecentFrame            = 0;
+    QElapsedTimer           _duplicateTimer;
+    quint64                 _duplicateMessageCount      = 0;
 
     static const int _commLostCheckTimeoutMSecs     = 1000;  // Check for comm lost once a second
     static const int _heartbeatMaxElpasedMSecs      = 3500;  // No heartbeat for longer than this indicates comm loss
@@ -308,6 +308,47 @@ void VehicleLinkManagerTest::_highLatencyLinkTest(void)
     spyTransmissionEnabledChanged.clear();
 }
 
+void VehicleLinkManagerTest::_duplicateFrameTest(void)
+{
+    SharedLinkConfigurationPtr  mockConfig1;
+    SharedLinkInterfacePtr      mockLink1;
+    SharedLinkConfigurationPtr  mockConfig2;
+    SharedLinkInterfacePtr      mockLink2;
+
+    QSignalSpy spyVehicleCreate(_multiVehicleMgr, &MultiVehicleManager::activeVehicleChanged);
+
+    _startMockLink(1, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig1, mockLink1);
+    _startMockLink(2, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig2, mockLink2);
+
+    QCOMPARE(spyVehicleCreate.wait(1000),           true);
+    QCOMPARE(_multiVehicleMgr->vehicles()->count(), 1);
+    Vehicle* vehicle = _multiVehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    VehicleLinkManager* vehicleLinkManager = vehicle->vehicleLinkManager();
+    QSignalSpy spyVehicleInitialConnectComplete(vehicle, &Vehicle::initialConnectComplete);
+    QCOMPARE(spyVehicleInitialConnectComplete.wait(3000), true);
+    QCOMPARE(vehicleLinkManager->linkNames().count(), 2);
+
+    mavlink_message_t message;
+    mavlink_msg_system_time_pack_chan(static_cast<uint8_t>(vehicle->id()), MAV_COMP_ID_AUTOPILOT1, mockLink1->mavlinkChannel(), &message, 1234, 5678);
+    message.seq = 42;
+
+    quint64 duplicateCount = vehicleLinkManager->duplicateMessageCount();
+
+    // First copy is processed, the copy from the redundant link is dropped
+    QCOMPARE(vehicleLinkManager->mavlinkMessageReceived(mockLink1.get(), message), true);
+    QCOMPARE(vehicleLinkManager->mavlinkMessageReceived(mockLink2.get(), message), false);
+    QCOMPARE(vehicleLinkManager->duplicateMessageCount(), duplicateCount + 1);
+
+    // The same frame again on the same link is a new message, not a duplicate
+    QCOMPARE(vehicleLinkManager->mavlinkMessageReceived(mockLink1.get(), message), true);
+
+    // A different sequence number is a different message
+    message.seq = 43;
+    QCOMPARE(vehicleLinkManager->mavlinkMessageReceived(mockLink2.get(), message), true);
+    QCOMPARE(vehicleLinkManager->duplicateMessageCount(), duplicateCount + 1);
+}
+
 void VehicleLinkManagerTest::_startMockLink(int mockIndex, bool highLatency, bool incrementVehicleId, SharedLinkConfigurationPtr& mockConfig, SharedLinkInterfacePtr& mockLink)
 {
     MockConfiguration* pMockConfig = new MockConfiguration(QStringLiteral("Mock %1").arg(mockIndex));
@@ -11,6 +11,9 @@
 #include "VehicleObjectAvoidance.h"
 #include "ParameterManager.h"
 #include <cmath>
+#include <limits>
+
+#include <QtMath>
 
 static const char* kColPrevParam = "CP_DIST";
 
@@ -19,48 +22,236 @@ VehicleObjectAvoidance::VehicleObjectAvoidance(Vehicle *vehicle, QObject* parent
     : QObject(parent)
     , _vehicle(vehicle)
 {
+    //-- Fused bins are fixed, so are their unit vectors
+    _binCos.resize(fusedBinCount);
+    _binSin.resize(fusedBinCount);
+    for(int i = 0; i < fusedBinCount; i++) {
+        qreal rd = (M_PI / 180.0) * (increment() * i);
+        _binCos[i] = static_cast<float>(cos(rd));
+        _binSin[i] = static_cast<float>(sin(rd));
+    }
+    _packedGrid.fill(0, fusedBinCount * packedStride);
+    for(int i = 0; i < fusedBinCount; i++) {
+        _packedGrid[(i * packedStride) + 2] = -1;
+        _distances.append(UINT16_MAX);
+    }
+    _clock.start();
+    _fuseTimer.setInterval(fuseIntervalMSecs);
+    connect(&_fuseTimer, &QTimer::timeout, this, &VehicleObjectAvoidance::_fuse);
+}
+
+//-----------------------------------------------------------------------------
+int
+VehicleObjectAvoidance::_fusedBin(float angle)
+{
+    int bin = qRound(angle / static_cast<float>(360.0 / fusedBinCount)) % fusedBinCount;
+    return bin < 0 ? bin + fusedBinCount : bin;
+}
+
+//-----------------------------------------------------------------------------
+VehicleObjectAvoidance::Sensor_t&
+VehicleObjectAvoidance::_sensor(uint8_t componentId, uint8_t frame)
+{
+    quint32 key = (static_cast<quint32>(componentId) << 8) | frame;
+    auto iter = _sensors.find(key);
+    if(iter == _sensors.end()) {
+        Sensor_t sensor;
+        sensor.lastMSecs    = 0;
+        sensor.minDistance  = 0;
+        sensor.maxDistance  = 0;
+        sensor.increment    = -1;
+        sensor.angleOffset  = 0;
+        iter = _sensors.insert(key, sensor);
+        if(!_fuseTimer.isActive()) {
+            _fuseTimer.start();
+        }
+        emit objectAvoidanceChanged();
+    }
+    return iter.value();
+}
+
+//-----------------------------------------------------------------------------
+//-- Which fused bins each bin of a scan lands on. Only rebuilt when the sensor geometry changes.
+void
+VehicleObjectAvoidance::_updateBinMap(Sensor_t& sensor)
+{
+    sensor.binMap.clear();
+    const float fusedIncrement = static_cast<float>(increment());
+    for(int i = 0; i < MAVLINK_MSG_OBSTACLE_DISTANCE_FIELD_DISTANCES_LEN; i++) {
+        float angle = (sensor.increment * i) - sensor.angleOffset;
+        if(sensor.increment <= fusedIncrement) {
+            sensor.binMap.append({ i, _fusedBin(angle) });
+        } else {
+            //-- Wide bins cover several fused bins
+            int first = qRound((angle - (sensor.increment / 2)) / fusedIncrement);
+            int last  = qRound((angle + (sensor.increment / 2)) / fusedIncrement);
+            for(int j = first; j < last; j++) {
+                sensor.binMap.append({ i, _fusedBin(j * fusedIncrement) });
+            }
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
 void
-VehicleObjectAvoidance::update(mavlink_obstacle_distance_t* message)
+VehicleObjectAvoidance::update(uint8_t componentId, mavlink_obstacle_distance_t* message)
 {
-    //-- Collect raw data
+    float increment;
     if(std::isfinite(message->increment_f) && message->increment_f > 0) {
-        _increment = static_cast<qreal>(message->increment_f);
+        increment = message->increment_f;
     } else {
-        _increment = static_cast<qreal>(message->increment);
-    }
-    _minDistance = message->min_distance;
-    _maxDistance = message->max_distance;
-    _angleOffset = static_cast<qreal>(message->angle_offset);
-    if(_distances.count() == 0) {
-        for(int i = 0; i < MAVLINK_MSG_OBSTACLE_DISTANCE_FIELD_DISTANCES_LEN; i++) {
-            _distances.append(static_cast<int>(message->distances[i]));
+        increment = static_cast<float>(message->increment);
+    }
+    if(increment <= 0) {
+        return;
+    }
+    Sensor_t& sensor = _sensor(componentId, message->frame);
+    sensor.lastMSecs    = _clock.elapsed();
+    sensor.minDistance  = message->min_distance;
+    sensor.maxDistance  = message->max_distance;
+    if(increment != sensor.increment || message->angle_offset != sensor.angleOffset) {
+        sensor.increment    = increment;
+        sensor.angleOffset  = message->angle_offset;
+        _updateBinMap(sensor);
+    }
+    sensor.distances.resize(MAVLINK_MSG_OBSTACLE_DISTANCE_FIELD_DISTANCES_LEN);
+    memcpy(sensor.distances.data(), message->distances, sizeof(message->distances));
+}
+
+//-----------------------------------------------------------------------------
+void
+VehicleObjectAvoidance::update(uint8_t componentId, mavlink_obstacle_distance_3d_t* message)
+{
+    //-- Only body frame obstacles can be placed around the vehicle without its position
+    if(message->frame != MAV_FRAME_BODY_FRD && message->frame != MAV_FRAME_BODY_OFFSET_NED) {
+        return;
+    }
+    if(!std::isfinite(message->x) || !std::isfinite(message->y)) {
+        return;
+    }
+    Sensor_t& sensor = _sensor(componentId, message->frame);
+    sensor.lastMSecs    = _clock.elapsed();
+    sensor.minDistance  = static_cast<int>(message->min_distance * 100);
+    sensor.maxDistance  = static_cast<int>(message->max_distance * 100);
+    Obstacle_t obstacle;
+    obstacle.timeMSecs  = sensor.lastMSecs;
+    obstacle.fusedBin   = _fusedBin(static_cast<float>(qRadiansToDegrees(atan2(message->y, message->x))));
+    obstacle.distance   = sqrtf((message->x * message->x) + (message->y * message->y)) * 100;
+    //-- Obstacles without an id replace whatever else was reported in the same bin
+    quint32 key = message->obstacle_id != UINT16_MAX ? message->obstacle_id : 0x10000u + static_cast<quint32>(obstacle.fusedBin);
+    sensor.obstacles[key] = obstacle;
+}
+
+//-----------------------------------------------------------------------------
+void
+VehicleObjectAvoidance::_fuse()
+{
+    const qint64 now = _clock.elapsed();
+    QVector<float>  fused   (fusedBinCount, std::numeric_limits<float>::infinity());
+    QVector<qint64> age     (fusedBinCount, 0);
+    int  minDistance    = 0;
+    int  maxDistance    = 0;
+    bool sensorsChanged = false;
+    for(auto iter = _sensors.begin(); iter != _sensors.end(); ) {
+        Sensor_t& sensor = iter.value();
+        if(now - sensor.lastMSecs > sensorTimeoutMSecs) {
+            iter = _sensors.erase(iter);
+            sensorsChanged = true;
+            continue;
         }
-    } else {
-        for(int i = 0; i < MAVLINK_MSG_OBSTACLE_DISTANCE_FIELD_DISTANCES_LEN; i++) {
-            _distances[i] = static_cast<int>(message->distances[i]);
+        minDistance = minDistance == 0 ? sensor.minDistance : qMin(minDistance, sensor.minDistance);
+        maxDistance = qMax(maxDistance, sensor.maxDistance);
+        if(!sensor.distances.isEmpty()) {
+            qint64 sensorAge = now - sensor.lastMSecs;
+            for(const BinMap_t& map: sensor.binMap) {
+                uint16_t d = sensor.distances[map.sensorBin];
+                if(d < sensor.maxDistance && d != UINT16_MAX && d < fused[map.fusedBin]) {
+                    fused[map.fusedBin] = d;
+                    age[map.fusedBin]   = sensorAge;
+                }
+            }
         }
+        for(auto obstacle = sensor.obstacles.begin(); obstacle != sensor.obstacles.end(); ) {
+            qint64 obstacleAge = now - obstacle->timeMSecs;
+            if(obstacleAge > sensorTimeoutMSecs) {
+                obstacle = sensor.obstacles.erase(obstacle);
+                continue;
+            }
+            if(obstacle->distance < sensor.maxDistance && obstacle->distance < fused[obstacle->fusedBin]) {
+                fused[obstacle->fusedBin] = obstacle->distance;
+                age[obstacle->fusedBin]   = obstacleAge;
+            }
+            obstacle++;
+        }
+        iter++;
+    }
+    if(minDistance != _minDistance || maxDistance != _maxDistance) {
+        _minDistance    = minDistance;
+        _maxDistance    = maxDistance;
+        sensorsChanged  = true;
+    }
+    //-- Only the bins which changed are written
+    auto* sp = qobject_cast<VehicleSetpointFactGroup*>(_vehicle->setpointFactGroup());
+    float rd = static_cast<float>(M_PI / 180.0) * static_cast<float>(sp->yaw()->rawValue().toDouble());
+    float cosYaw = cosf(rd);
+    float sinYaw = sinf(rd);
+    bool changed = false;
+    for(int i = 0; i < fusedBinCount; i++) {
+        float* p = &_packedGrid[i * packedStride];
+        float x = 0, y = 0, d = -1, confidence = 0;
+        if(std::isfinite(fused[i]) && _maxDistance > 0) {
+            d = fused[i] / static_cast<float>(_maxDistance);
+            //-- Bin angle minus vehicle yaw
+            x = d * ((_binCos[i] * cosYaw) + (_binSin[i] * sinYaw));
+            y = d * ((_binSin[i] * cosYaw) - (_binCos[i] * sinYaw));
+            confidence = 1.0f - (static_cast<float>(age[i]) / sensorTimeoutMSecs);
+        }
+        if(p[0] != x || p[1] != y || p[2] != d || p[3] != confidence) {
+            p[0] = x;
+            p[1] = y;
+            p[2] = d;
+            p[3] = confidence;
+            _distances[i] = std::isfinite(fused[i]) ? static_cast<int>(fused[i]) : UINT16_MAX;
+            changed = true;
+        }
+    }
+    if(_sensors.isEmpty()) {
+        _fuseTimer.stop();
     }
-    //-- Create a plottable grid with found objects
+    if(changed) {
+        _objGridDirty = true;
+        emit gridChanged();
+    }
+    if(sensorsChanged) {
+        emit objectAvoidanceChanged();
+    }
+}
+
+//-----------------------------------------------------------------------------
+//-- grid() and distance() index the bins which hold an object. Only rebuilt when someone asks after a change.
+void
+VehicleObjectAvoidance::_compactGrid()
+{
+    if(!_objGridDirty) {
+        return;
+    }
+    _objGridDirty = false;
     _objGrid.clear();
     _objDistance.clear();
-    auto* sp = qobject_cast<VehicleSetpointFactGroup*>(_vehicle->setpointFactGroup());
-    qreal startAngle = sp->yaw()->rawValue().toDouble() + _angleOffset;
-    for(int i = 0; i < MAVLINK_MSG_OBSTACLE_DISTANCE_FIELD_DISTANCES_LEN; i++) {
-        if(_distances[i] < _maxDistance && message->distances[i] != UINT16_MAX) {
-            qreal d = static_cast<qreal>(_distances[i]);
-            d = d / static_cast<qreal>(_maxDistance);
-            qreal a = (_increment * i) - startAngle;
-            if(a < 0) a = a + 360;
-            qreal rd = (M_PI / 180.0) * a;
-            QPointF p = QPointF(d * cos(rd), d * sin(rd));
-            _objGrid.append(p);
-            _objDistance.append(d);
+    for(int i = 0; i < _packedGrid.count(); i += packedStride) {
+        if(_packedGrid[i + 2] >= 0) {
+            _objGrid.append(QPointF(static_cast<qreal>(_packedGrid[i]), static_cast<qreal>(_packedGrid[i + 1])));
+            _objDistance.append(static_cast<qreal>(_packedGrid[i + 2]));
         }
     }
-    emit objectAvoidanceChanged();
+}
+
+//-----------------------------------------------------------------------------
+int
+VehicleObjectAvoidance::gridSize()
+{
+    _compactGrid();
+    return _objGrid.count();
 }
 
 //-----------------------------------------------------------------------------
@@ -100,6 +291,7 @@ VehicleObjectAvoidance::stop()
 QPointF
 VehicleObjectAvoidance::grid(int i)
 {
+    _compactGrid();
     if(i < _objGrid.count() && i >= 0) {
         return _objGrid[i];
     }
@@ -110,6 +302,7 @@ VehicleObjectAvoidance::grid(int i)
 qreal
 VehicleObjectAvoidance::distance(int i)
 {
+    _compactGrid();
     if(i < _objDistance.count() && i >= 0) {
         return _objDistance[i];
     }
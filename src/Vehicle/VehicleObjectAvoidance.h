@@ -12,11 +12,22 @@
 #include <QObject>
 #include <QVector>
 #include <QPointF>
+#include <QHash>
+#include <QMap>
+#include <QTimer>
+#include <QElapsedTimer>
 
 #include "QGCMAVLink.h"
 
 class Vehicle;
 
+//-----------------------------------------------------------------------------
+//-- Obstacles from every proximity sensor on the vehicle, fused into a single polar histogram.
+//
+//   OBSTACLE_DISTANCE scans and OBSTACLE_DISTANCE_3D obstacles are kept per sensor (component id + frame) as they
+//   arrive, which is just a copy. The histogram is rebuilt from them at a fixed rate, each bin holding the closest
+//   reading of any sensor. Readings fade out over sensorTimeoutMSecs and a sensor which goes quiet is dropped, so the
+//   GUI work doesn't grow with the number of sensors or their message rate.
 class VehicleObjectAvoidance : public QObject
 {
     Q_OBJECT
@@ -25,12 +36,13 @@ public:
 
     Q_PROPERTY(bool             available   READ available      NOTIFY objectAvoidanceChanged)
     Q_PROPERTY(bool             enabled     READ enabled        NOTIFY objectAvoidanceChanged)
-    Q_PROPERTY(QList<int>       distances   READ distances      NOTIFY objectAvoidanceChanged)
-    Q_PROPERTY(qreal            increment   READ increment      NOTIFY objectAvoidanceChanged)
+    Q_PROPERTY(QList<int>       distances   READ distances      NOTIFY gridChanged)
+    Q_PROPERTY(qreal            increment   READ increment      CONSTANT)
     Q_PROPERTY(int              minDistance READ minDistance    NOTIFY objectAvoidanceChanged)
     Q_PROPERTY(int              maxDistance READ maxDistance    NOTIFY objectAvoidanceChanged)
-    Q_PROPERTY(qreal            angleOffset READ angleOffset    NOTIFY objectAvoidanceChanged)
-    Q_PROPERTY(int              gridSize    READ gridSize       NOTIFY objectAvoidanceChanged)
+    Q_PROPERTY(qreal            angleOffset READ angleOffset    CONSTANT)
+    Q_PROPERTY(int              gridSize    READ gridSize       NOTIFY gridChanged)
+    Q_PROPERTY(int              sensorCount READ sensorCount    NOTIFY objectAvoidanceChanged)
 
     //-- Start collision avoidance. Argument is minimum distance the vehicle should keep to all obstacles
     Q_INVOKABLE void    start   (int minDistance);
@@ -40,28 +52,77 @@ public:
     Q_INVOKABLE QPointF grid    (int i);
     Q_INVOKABLE qreal   distance(int i);
 
-    bool            available   () { return _distances.count() > 0; }
+    bool            available   () { return _sensors.count() > 0; }
     bool            enabled     ();
-    QList<int>      distances   () { return _distances; }
-    qreal           increment   () { return _increment; }
+    QList<int>      distances   () { return _distances; }     ///< Fused histogram in cm, UINT16_MAX for no object
+    qreal           increment   () { return 360.0 / fusedBinCount; }
     int             minDistance () { return _minDistance; }
     int             maxDistance () { return _maxDistance; }
-    qreal           angleOffset () { return _angleOffset; }
-    int             gridSize    () { return _objGrid.count(); }
+    qreal           angleOffset () { return 0; }
+    int             gridSize    ();
+    int             sensorCount () { return _sensors.count(); }
 
-    void            update      (mavlink_obstacle_distance_t* message);
+    //-- x, y, distance, confidence for each fused bin, in the same normalized space as grid(). Distance is -1 for bins
+    //   without an object, confidence goes from 1 for a fresh reading to 0 as it times out. Meant to be copied straight
+    //   into a vertex buffer.
+    const QVector<float>& packedGrid() const { return _packedGrid; }
+
+    void            update      (uint8_t componentId, mavlink_obstacle_distance_t* message);
+    void            update      (uint8_t componentId, mavlink_obstacle_distance_3d_t* message);
+
+    static const int fusedBinCount      = 72;
+    static const int packedStride       = 4;
+    static const int sensorTimeoutMSecs = 1500;
+    static const int fuseIntervalMSecs  = 50;
 
 signals:
-    void            objectAvoidanceChanged  ();
+    void            objectAvoidanceChanged  ();     ///< Availability, enable state or sensor set changed
+    void            gridChanged             ();     ///< Fused histogram changed
+
+private slots:
+    void            _fuse                   ();
 
 private:
-    QList<int>      _distances;
-    QVector<QPointF>_objGrid;
-    QVector<qreal>  _objDistance;
-    qreal           _increment      = 0;
-    int             _minDistance    = 0;
-    int             _maxDistance    = 0;
-    qreal           _angleOffset    = 0;
-    Vehicle*        _vehicle        = nullptr;
-};
+    typedef struct {
+        int         sensorBin;
+        int         fusedBin;
+    } BinMap_t;
 
+    typedef struct {
+        qint64      timeMSecs;
+        int         fusedBin;
+        float       distance;                       ///< cm
+    } Obstacle_t;
+
+    typedef struct {
+        qint64                      lastMSecs;
+        int                         minDistance;    ///< cm
+        int                         maxDistance;    ///< cm
+        //-- OBSTACLE_DISTANCE
+        float                       increment;      ///< Geometry binMap was built for, -1 if none yet
+        float                       angleOffset;
+        QVector<uint16_t>           distances;
+        QVector<BinMap_t>           binMap;
+        //-- OBSTACLE_DISTANCE_3D, key: obstacle id
+        QHash<quint32, Obstacle_t>  obstacles;
+    } Sensor_t;
+
+    Sensor_t&       _sensor                 (uint8_t componentId, uint8_t frame);
+    void            _updateBinMap           (Sensor_t& sensor);
+    static int      _fusedBin               (float angle);
+    void            _compactGrid            ();
+
+    Vehicle*                    _vehicle        = nullptr;
+    QMap<quint32, Sensor_t>     _sensors;                       ///< key: component id << 8 | frame
+    QTimer                      _fuseTimer;
+    QElapsedTimer               _clock;
+    QList<int>                  _distances;
+    QVector<QPointF>            _objGrid;
+    QVector<qreal>              _objDistance;
+    bool                        _objGridDirty   = false;        ///< true: _objGrid/_objDistance must be rebuilt from _packedGrid
+    QVector<float>              _packedGrid;
+    QVector<float>              _binCos;                        ///< Unit vector for each fused bin
+    QVector<float>              _binSin;
+    int                         _minDistance    = 0;
+    int                         _maxDistance    = 0;
+};
@@ -42,6 +42,8 @@ VehicleSetpointFactGroup::VehicleSetpointFactGroup(QObject* parent)
     _rollRateFact.setRawValue(qQNaN());
     _pitchRateFact.setRawValue(qQNaN());
     _yawRateFact.setRawValue(qQNaN());
+
+    _setHandledMessageIds({ MAVLINK_MSG_ID_ATTITUDE_TARGET });
 }
 
 void VehicleSetpointFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
@@ -57,13 +59,13 @@ void VehicleSetpointFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_mes
     float roll, pitch, yaw;
     mavlink_quaternion_to_euler(attitudeTarget.q, &roll, &pitch, &yaw);
 
-    this->roll()->setRawValue   (qRadiansToDegrees(roll));
-    this->pitch()->setRawValue  (qRadiansToDegrees(pitch));
-    this->yaw()->setRawValue    (qRadiansToDegrees(yaw));
+    _rollFact.setTelemetryValue     (qRadiansToDegrees(roll));
+    _pitchFact.setTelemetryValue    (qRadiansToDegrees(pitch));
+    _yawFact.setTelemetryValue      (qRadiansToDegrees(yaw));
 
-    rollRate()->setRawValue (qRadiansToDegrees(attitudeTarget.body_roll_rate));
-    pitchRate()->setRawValue(qRadiansToDegrees(attitudeTarget.body_pitch_rate));
-    yawRate()->setRawValue  (qRadiansToDegrees(attitudeTarget.body_yaw_rate));
+    _rollRateFact.setTelemetryValue (qRadiansToDegrees(attitudeTarget.body_roll_rate));
+    _pitchRateFact.setTelemetryValue(qRadiansToDegrees(attitudeTarget.body_pitch_rate));
+    _yawRateFact.setTelemetryValue  (qRadiansToDegrees(attitudeTarget.body_yaw_rate));
 
     _setTelemetryAvailable(true);
 }
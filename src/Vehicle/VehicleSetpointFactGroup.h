@@ -10,6 +10,7 @@
 #pragma once
 
 #include "FactGroup.h"
+#include "TelemetryFact.h"
 #include "QGCMAVLink.h"
 
 class VehicleSetpointFactGroup : public FactGroup
@@ -44,10 +45,10 @@ public:
     static const char* _yawRateFactName;
 
 private:
-    Fact _rollFact;
-    Fact _pitchFact;
-    Fact _yawFact;
-    Fact _rollRateFact;
-    Fact _pitchRateFact;
-    Fact _yawRateFact;
+    TelemetryFact _rollFact;
+    TelemetryFact _pitchFact;
+    TelemetryFact _yawFact;
+    TelemetryFact _rollRateFact;
+    TelemetryFact _pitchRateFact;
+    TelemetryFact _yawRateFact;
 };
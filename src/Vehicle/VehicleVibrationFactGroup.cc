@@ -37,6 +37,8 @@ VehicleVibrationFactGroup::VehicleVibrationFactGroup(QObject* parent)
     _xAxisFact.setRawValue(qQNaN());
     _yAxisFact.setRawValue(qQNaN());
     _zAxisFact.setRawValue(qQNaN());
+
+    _setHandledMessageIds({ MAVLINK_MSG_ID_VIBRATION });
 }
 
 void VehicleVibrationFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
@@ -30,6 +30,15 @@ VehicleWindFactGroup::VehicleWindFactGroup(QObject* parent)
     _directionFact.setRawValue      (qQNaN());
     _speedFact.setRawValue          (qQNaN());
     _verticalSpeedFact.setRawValue  (qQNaN());
+
+    _setHandledMessageIds({
+                              MAVLINK_MSG_ID_WIND_COV,
+#if !defined(NO_ARDUPILOT_DIALECT)
+                              MAVLINK_MSG_ID_WIND,
+#endif
+                              MAVLINK_MSG_ID_HIGH_LATENCY,
+                              MAVLINK_MSG_ID_HIGH_LATENCY2,
+                          });
 }
 
 void VehicleWindFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
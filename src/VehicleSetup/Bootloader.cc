@@ -355,6 +355,11 @@ bool Bootloader::_binProgram(const FirmwareImage* image)
     uint8_t imageBuf[PROG_MULTI_MAX];
     uint32_t bytesSent = 0;
     _imageCRC = 0;
+
+    // Over USB the bootloader is kept busy by sending the next chunks before the responses to the previous ones are
+    // in. The SiK radio bootloader is on a real uart without flow control, so it gets one chunk at a time.
+    const int   programWindow       = _sikRadio ? 1 : _programWindow;
+    int         pendingResponses    = 0;
     
     Q_ASSERT(PROG_MULTI_MAX <= 0x8F);
     
@@ -379,8 +384,12 @@ bool Bootloader::_binProgram(const FirmwareImage* image)
                 _write((uint8_t)bytesToSend) &&
                 _write(imageBuf, bytesToSend) &&
                 _write(PROTO_EOC)) {
-            if (_getCommandResponse()) {
-                failed = false;
+            _port.flush();
+            failed = false;
+            if (++pendingResponses == programWindow) {
+                // The window is full, wait for the response to the oldest chunk
+                failed = !_getCommandResponse();
+                pendingResponses--;
             }
         }
         if (failed) {
@@ -397,11 +406,20 @@ bool Bootloader::_binProgram(const FirmwareImage* image)
     }
     firmwareFile.close();
 
+    for (; pendingResponses > 0; pendingResponses--) {
+        if (!_getCommandResponse()) {
+            _errorString = tr("Flash failed: %1 at address 0x%2").arg(_errorString).arg(bytesSent, 8, 16, QLatin1Char('0'));
+            return false;
+        }
+    }
+
     // We calculate the CRC using the entire flash size, filling the remainder with 0xFF.
+    uint8_t fill[256];
+    memset(fill, 0xFF, sizeof(fill));
     while (bytesSent < _boardFlashSize) {
-        const uint8_t fill = 0xFF;
-        _imageCRC = QGC::crc32(&fill, 1, _imageCRC);
-        bytesSent++;
+        const uint32_t fillBytes = qMin(static_cast<uint32_t>(sizeof(fill)), _boardFlashSize - bytesSent);
+        _imageCRC = QGC::crc32(fill, fillBytes, _imageCRC);
+        bytesSent += fillBytes;
     }
 
     return true;
@@ -422,7 +440,7 @@ bool Bootloader::_ihxProgram(const FirmwareImage* image)
             return false;
         }
         
-        qCDebug(FirmwareUpgradeVerboseLog) << QString("Bootloader::_ihxProgram - address:0x%1 size:%2 block:%3").arg(flashAddress, 8, 16, QLatin1Char('0')).arg(bytes.count()).arg(index);
+        qCVerbose(FirmwareUpgradeVerboseLog) << QString("Bootloader::_ihxProgram - address:0x%1 size:%2 block:%3").arg(flashAddress, 8, 16, QLatin1Char('0')).arg(bytes.count()).arg(index);
         
         // Set flash address
         
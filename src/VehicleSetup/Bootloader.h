@@ -114,6 +114,7 @@ private:
     static const int _rebootTimeout                     = 10000;    ///< Msecs to wait for reboot command to cause serial port to disconnect
     static const int _verifyTimeout                     = 5000;     ///< Msecs to wait for response to PROTO_GET_CRC command
     static const int _readTimout                        = 2000;     ///< Msecs to wait for read bytes to become available
+    static const int _programWindow                     = 8;        ///< PROTO_PROG_MULTI commands sent ahead of their responses
     static const int _responseTimeout                   = 2000;     ///< Msecs to wait for command response bytes
     static const int _flashSizeSmall                    = 1032192;  ///< Flash size for boards with silicon error
     static const int _bootloaderVersionV2CorrectFlash   = 5;        ///< Anything below this bootloader version on V2 boards cannot trust flash size
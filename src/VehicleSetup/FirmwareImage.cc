@@ -165,7 +165,7 @@ bool FirmwareImage::_ihxLoad(const QString& ihxFilename)
             if (appendToLastBlock) {
                 _ihxBlocks[_ihxBlocks.count() - 1].bytes += bytes;
                 // Too noisy even for verbose
-                //qCDebug(FirmwareUpgradeVerboseLog) << QString("_ihxLoad - append - address:%1 size:%2 block:%3").arg(address).arg(blockByteCount).arg(ihxBlockCount());
+                //qCVerbose(FirmwareUpgradeVerboseLog) << QString("_ihxLoad - append - address:%1 size:%2 block:%3").arg(address).arg(blockByteCount).arg(ihxBlockCount());
             } else {
                 IntelHexBlock_t block;
                 
@@ -173,7 +173,7 @@ bool FirmwareImage::_ihxLoad(const QString& ihxFilename)
                 block.bytes = bytes;
                 
                 _ihxBlocks += block;
-                qCDebug(FirmwareUpgradeVerboseLog) << QString("_ihxLoad - new block - address:%1 size:%2 block:%3").arg(address).arg(blockByteCount).arg(ihxBlockCount());
+                qCVerbose(FirmwareUpgradeVerboseLog) << QString("_ihxLoad - new block - address:%1 size:%2 block:%3").arg(address).arg(blockByteCount).arg(ihxBlockCount());
             }
             
             _imageSize += blockByteCount;
@@ -373,15 +373,18 @@ bool FirmwareImage::_decompressJsonValue(const QJsonObject&	jsonObject,			///< J
     // with some length (18K / 25K) are just weirdly cut.
     // The code below works around this by manually 'parsing'
     // for the image string. Since its compressed / checksummed
-    // this should be fine.
+    // this should be fine. The document is searched as is, the base64
+    // is ascii so there is no need to convert the whole thing to a QString.
     
-    QStringList parts = QString(jsonDocBytes).split(QString("\"%1\": \"").arg(bytesKey));
-    if (parts.count() == 1) {
+    const QByteArray keyStart = QStringLiteral("\"%1\": \"").arg(bytesKey).toUtf8();
+    int valueStart = jsonDocBytes.lastIndexOf(keyStart);
+    if (valueStart == -1) {
         emit statusMessage(tr("Could not find compressed bytes for %1 in Firmware file").arg(bytesKey));
         return false;
     }
-    parts = parts.last().split("\"");
-    if (parts.count() == 1) {
+    valueStart += keyStart.length();
+    const int valueEnd = jsonDocBytes.indexOf('"', valueStart);
+    if (valueEnd == -1) {
         emit statusMessage(tr("Incorrectly formed compressed bytes section for %1 in Firmware file").arg(bytesKey));
         return false;
     }
@@ -393,8 +396,7 @@ bool FirmwareImage::_decompressJsonValue(const QJsonObject&	jsonObject,			///< J
     raw.append((unsigned char)((decompressedSize >> 8) & 0xFF));
     raw.append((unsigned char)((decompressedSize >> 0) & 0xFF));
     
-    QByteArray raw64 = parts.first().toUtf8();
-    raw.append(QByteArray::fromBase64(raw64));
+    raw.append(QByteArray::fromBase64(QByteArray::fromRawData(jsonDocBytes.constData() + valueStart, valueEnd - valueStart)));
     decompressedBytes = qUncompress(raw);
     
     if (decompressedBytes.count() == 0) {
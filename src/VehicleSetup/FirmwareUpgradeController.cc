@@ -15,7 +15,6 @@
 #include "QGCCorePlugin.h"
 #include "FirmwareUpgradeSettings.h"
 #include "SettingsManager.h"
-#include "QGCZlib.h"
 #include "JsonHelper.h"
 #include "LinkManager.h"
 
@@ -25,6 +24,10 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QNetworkProxy>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSettings>
 
 #include "zlib.h"
 
@@ -40,6 +43,8 @@ const char* FirmwareUpgradeController::_manifestBootloaderStrJsonKey =
 const char* FirmwareUpgradeController::_manifestLatestKey =                     "latest";
 const char* FirmwareUpgradeController::_manifestPlatformKey =                   "platform";
 const char* FirmwareUpgradeController::_manifestBrandNameKey =                  "brand_name";
+const char* FirmwareUpgradeController::_px4ReleasesCacheName =                   "PX4Releases.qgcfc";
+const char* FirmwareUpgradeController::_arduPilotManifestCacheName =             "ArduPilotManifest.qgcfc";
 
 struct FirmwareToUrlElement_t {
     FirmwareUpgradeController::AutoPilotStackType_t     stackType;
@@ -205,6 +210,11 @@ void FirmwareUpgradeController::flashSingleFirmwareMode(FirmwareBuildType_t firm
 void FirmwareUpgradeController::cancel(void)
 {
     _eraseTimer.stop();
+    if (_firmwareDownloader) {
+        // Deleting the downloader aborts the download
+        _firmwareDownloader->deleteLater();
+        _firmwareDownloader = nullptr;
+    }
     _threadController->cancel();
 }
 
@@ -278,7 +288,7 @@ void FirmwareUpgradeController::_foundBoardInfo(int bootloaderVersion, int board
     if (_startFlashWhenBootloaderFound) {
         flash(_startFlashWhenBootloaderFoundFirmwareIdentity);
     } else {
-        if (_rgManifestFirmwareInfo.count()) {
+        if (!_manifestFirmwareInfoByBoardId.isEmpty()) {
             _buildAPMFirmwareNames();
         }
         emit showFirmwareSelectDlg();
@@ -381,10 +391,17 @@ void FirmwareUpgradeController::_downloadFirmware(void)
     _appendStatusLog(tr("Downloading firmware..."));
     _appendStatusLog(tr(" From: %1").arg(_firmwareFilename));
     
-    QGCFileDownload* downloader = new QGCFileDownload(this);
-    connect(downloader, &QGCFileDownload::downloadComplete, this, &FirmwareUpgradeController::_firmwareDownloadComplete);
-    connect(downloader, &QGCFileDownload::downloadProgress, this, &FirmwareUpgradeController::_firmwareDownloadProgress);
-    downloader->download(_firmwareFilename);
+    _firmwareDownloader = new QGCFileDownload(this);
+    connect(_firmwareDownloader, &QGCFileDownload::downloadComplete, this, &FirmwareUpgradeController::_firmwareDownloadComplete);
+    connect(_firmwareDownloader, &QGCFileDownload::downloadProgress, this, &FirmwareUpgradeController::_firmwareDownloadProgress);
+    _firmwareDownloader->download(_firmwareFilename);
+
+    // Erasing takes about as long as a download, so the board is erased while the firmware comes in. The download has
+    // the progress bar meanwhile. Local files are loaded and checked against the board first as before, and radios are
+    // left alone until there is an image since they have to be switched out of command mode first.
+    if (_bootloaderFound && _boardType != QGCSerialPortInfo::BoardTypeSiKRadio && QUrl(_firmwareFilename).scheme().startsWith(QStringLiteral("http"))) {
+        _threadController->erase();
+    }
 }
 
 /// @brief Updates the progress indicator while downloading
@@ -399,6 +416,11 @@ void FirmwareUpgradeController::_firmwareDownloadProgress(qint64 curr, qint64 to
 /// @brief Called when the firmware download completes.
 void FirmwareUpgradeController::_firmwareDownloadComplete(QString /*remoteFile*/, QString localFile, QString errorMsg)
 {
+    if (_firmwareDownloader) {
+        _firmwareDownloader->deleteLater();
+        _firmwareDownloader = nullptr;
+    }
+
     if (errorMsg.isEmpty()) {
     _appendStatusLog(tr("Download complete"));
     
@@ -520,7 +542,9 @@ void FirmwareUpgradeController::_eraseStarted(void)
 {
     // We set up our own progress bar for erase since the erase command does not provide one
     _eraseTickCount = 0;
-    _eraseTimer.start(_eraseTickMsec);
+    if (!_firmwareDownloader) {
+        _eraseTimer.start(_eraseTickMsec);
+    }
 }
 
 void FirmwareUpgradeController::_eraseComplete(void)
@@ -560,9 +584,9 @@ void FirmwareUpgradeController::_buildAPMFirmwareNames(void)
     bool    bootloaderMatch = boardDescription.endsWith(apmDescriptionSuffix);
 
     int currentIndex = 0;
-    for (const ManifestFirmwareInfo_t& firmwareInfo: _rgManifestFirmwareInfo) {
+    for (const ManifestFirmwareInfo_t& firmwareInfo: _manifestFirmwareInfoByBoardId.value(rawBoardId)) {
         bool match = false;
-        if (firmwareInfo.firmwareBuildType == _selectedFirmwareBuildType && firmwareInfo.chibios == chibios && firmwareInfo.vehicleType == vehicleType && firmwareInfo.boardId == rawBoardId) {
+        if (firmwareInfo.firmwareBuildType == _selectedFirmwareBuildType && firmwareInfo.chibios == chibios && firmwareInfo.vehicleType == vehicleType) {
             if (firmwareInfo.fmuv2 && _bootloaderBoardID == Bootloader::boardIDPX4FMUV3) {
                 qCDebug(FirmwareUpgradeLog) << "Skipping fmuv2 manifest entry for fmuv3 board:" << firmwareInfo.friendlyName << boardDescription << firmwareInfo.rgBootloaderPortString << firmwareInfo.url << firmwareInfo.vehicleType;
             } else {
@@ -607,13 +631,51 @@ FirmwareUpgradeController::FirmwareVehicleType_t FirmwareUpgradeController::vehi
 void FirmwareUpgradeController::_determinePX4StableVersion(void)
 {
     QGCFileDownload* downloader = new QGCFileDownload(this);
+
+    // Show the versions from the last check right away and only ask github for the releases if they changed since.
+    // Conditional requests which come back not modified don't count against the github rate limit.
+    QByteArray eTag;
+    QByteArray lastModified;
+    QByteArray payload;
+    if (_loadDownloadCache(_px4ReleasesCacheName, eTag, lastModified, payload)) {
+        QDataStream stream(payload);
+        QString     stableVersion;
+        QString     betaVersion;
+        stream >> stableVersion >> betaVersion;
+        if (stream.status() == QDataStream::Ok) {
+            qCDebug(FirmwareUpgradeLog) << "Using cached px4 versions" << stableVersion << betaVersion;
+            _setPX4Versions(stableVersion, betaVersion);
+            downloader->setConditional(eTag, lastModified);
+        }
+    }
+
     connect(downloader, &QGCFileDownload::downloadComplete, this, &FirmwareUpgradeController::_px4ReleasesGithubDownloadComplete);
     downloader->download(QStringLiteral("https://api.github.com/repos/PX4/Firmware/releases"));
 }
 
+void FirmwareUpgradeController::_setPX4Versions(const QString& stableVersion, const QString& betaVersion)
+{
+    if (!stableVersion.isEmpty() && stableVersion != _px4StableVersion) {
+        _px4StableVersion = stableVersion;
+        emit px4StableVersionChanged(_px4StableVersion);
+    }
+    if (!betaVersion.isEmpty() && betaVersion != _px4BetaVersion) {
+        _px4BetaVersion = betaVersion;
+        emit px4BetaVersionChanged(_px4BetaVersion);
+    }
+}
+
 void FirmwareUpgradeController::_px4ReleasesGithubDownloadComplete(QString /*remoteFile*/, QString localFile, QString errorMsg)
 {
+    QGCFileDownload* downloader = qobject_cast<QGCFileDownload*>(sender());
+    downloader->deleteLater();
+
     if (errorMsg.isEmpty()) {
+        if (downloader->notModified()) {
+            qCDebug(FirmwareUpgradeLog) << "PX4 releases not modified since last check";
+            return;
+        }
+
         QFile jsonFile(localFile);
         if (!jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
             qCWarning(FirmwareUpgradeLog) << "Unable to open github px4 releases json file" << localFile << jsonFile.errorString();
@@ -638,22 +700,30 @@ void FirmwareUpgradeController::_px4ReleasesGithubDownloadComplete(QString /*rem
 
         // The first release marked prerelease=false is stable
         // The first release marked prerelease=true is beta
-        bool foundStable = false;
-        bool foundBeta = false;
+        bool    foundStable = false;
+        bool    foundBeta = false;
+        QString stableVersion;
+        QString betaVersion;
         for (int i=0; i<releases.count() && (!foundStable || !foundBeta); i++) {
             QJsonObject release = releases[i].toObject();
             if (!foundStable && !release["prerelease"].toBool()) {
-                _px4StableVersion = release["name"].toString();
-                emit px4StableVersionChanged(_px4StableVersion);
-                qCDebug(FirmwareUpgradeLog()) << "Found px4 stable version" << _px4StableVersion;
+                stableVersion = release["name"].toString();
+                qCDebug(FirmwareUpgradeLog()) << "Found px4 stable version" << stableVersion;
                 foundStable = true;
             } else if (!foundBeta && release["prerelease"].toBool()) {
-                _px4BetaVersion = release["name"].toString();
-                emit px4StableVersionChanged(_px4BetaVersion);
-                qCDebug(FirmwareUpgradeLog()) << "Found px4 beta version" << _px4BetaVersion;
+                betaVersion = release["name"].toString();
+                qCDebug(FirmwareUpgradeLog()) << "Found px4 beta version" << betaVersion;
                 foundBeta = true;
             }
         }
+        _setPX4Versions(stableVersion, betaVersion);
+
+        if (foundStable && foundBeta) {
+            QByteArray  payload;
+            QDataStream stream(&payload, QIODevice::WriteOnly);
+            stream << stableVersion << betaVersion;
+            _saveDownloadCache(_px4ReleasesCacheName, downloader->eTag(), downloader->lastModified(), payload);
+        }
 
         if (!foundStable) {
             qCDebug(FirmwareUpgradeLog()) << "Unable to find px4 stable version" << localFile;
@@ -668,31 +738,41 @@ void FirmwareUpgradeController::_px4ReleasesGithubDownloadComplete(QString /*rem
 
 void FirmwareUpgradeController::_downloadArduPilotManifest(void)
 {
-    _downloadingFirmwareList = true;
-    emit downloadingFirmwareListChanged(true);
-
     QGCFileDownload* downloader = new QGCFileDownload(this);
+    downloader->setInMemory(true /* inflateGzip */);
+
+    // The manifest is several megabytes of json. It is only downloaded and parsed again when it changed since the
+    // cached board index was built from it.
+    QByteArray eTag;
+    QByteArray lastModified;
+    if (_loadArduPilotManifestCache(eTag, lastModified)) {
+        downloader->setConditional(eTag, lastModified);
+    } else {
+        _downloadingFirmwareList = true;
+        emit downloadingFirmwareListChanged(true);
+    }
+
     connect(downloader, &QGCFileDownload::downloadComplete, this, &FirmwareUpgradeController::_ardupilotManifestDownloadComplete);
     downloader->download(QStringLiteral("http://firmware.ardupilot.org/manifest.json.gz"));
 }
 
 void FirmwareUpgradeController::_ardupilotManifestDownloadComplete(QString remoteFile, QString localFile, QString errorMsg)
 {
-    if (errorMsg.isEmpty()) {
-        // Delete the QGCFileDownload object
-        sender()->deleteLater();
-
-        qCDebug(FirmwareUpgradeLog) << "_ardupilotManifestDownloadFinished" << remoteFile << localFile;
+    QGCFileDownload* downloader = qobject_cast<QGCFileDownload*>(sender());
+    downloader->deleteLater();
 
-        QString jsonFileName(QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("ArduPilot.Manifest.json"));
-        if (!QGCZlib::inflateGzipFile(localFile, jsonFileName)) {
-            qCWarning(FirmwareUpgradeLog) << "Inflate of compressed manifest failed" << localFile;
+    if (errorMsg.isEmpty()) {
+        if (downloader->notModified()) {
+            qCDebug(FirmwareUpgradeLog) << "ArduPilot manifest not modified, using cached index";
             return;
         }
 
+        qCDebug(FirmwareUpgradeLog) << "_ardupilotManifestDownloadFinished" << remoteFile << localFile << downloader->data().size();
+
+        // Inflated as it downloaded, straight into memory
         QString         errorString;
         QJsonDocument   doc;
-        if (!JsonHelper::isJsonFile(jsonFileName, doc, errorString)) {
+        if (!JsonHelper::isJsonFile(downloader->data(), doc, errorString)) {
             qCWarning(FirmwareUpgradeLog) << "Json file read failed" << errorString;
             return;
         }
@@ -700,6 +780,8 @@ void FirmwareUpgradeController::_ardupilotManifestDownloadComplete(QString remot
         QJsonObject json =          doc.object();
         QJsonArray  rgFirmware =    json[_manifestFirmwareJsonKey].toArray();
 
+        _manifestFirmwareInfoByBoardId.clear();
+
         for (int i=0; i<rgFirmware.count(); i++) {
             const QJsonObject& firmwareJson = rgFirmware[i].toObject();
 
@@ -713,37 +795,30 @@ void FirmwareUpgradeController::_ardupilotManifestDownloadComplete(QString remot
                     continue;
                 }
 
-                _rgManifestFirmwareInfo.append(ManifestFirmwareInfo_t());
-                ManifestFirmwareInfo_t& firmwareInfo = _rgManifestFirmwareInfo.last();
+                uint32_t boardId = static_cast<uint32_t>(firmwareJson[_manifestBoardIdJsonKey].toInt());
+                QList<ManifestFirmwareInfo_t>& boardFirmwareInfo = _manifestFirmwareInfoByBoardId[boardId];
+                boardFirmwareInfo.append(ManifestFirmwareInfo_t());
+                ManifestFirmwareInfo_t& firmwareInfo = boardFirmwareInfo.last();
 
-                firmwareInfo.boardId =              static_cast<uint32_t>(firmwareJson[_manifestBoardIdJsonKey].toInt());
+                firmwareInfo.boardId =              boardId;
                 firmwareInfo.firmwareBuildType =    firmwareBuildType;
                 firmwareInfo.vehicleType =          firmwareVehicleType;
                 firmwareInfo.url =                  firmwareJson[_manifestUrlJsonKey].toString();
-                firmwareInfo.version =              firmwareJson[_manifestMavFirmwareVersionJsonKey].toString();
-                firmwareInfo.chibios =              format == QStringLiteral("apj");                firmwareInfo.fmuv2 =                platform.contains(QStringLiteral("fmuv2"));
+                firmwareInfo.chibios =              format == QStringLiteral("apj");
+                firmwareInfo.fmuv2 =                platform.contains(QStringLiteral("fmuv2"));
 
                 QJsonArray bootloaderArray = firmwareJson[_manifestBootloaderStrJsonKey].toArray();
                 for (int j=0; j<bootloaderArray.count(); j++) {
                     firmwareInfo.rgBootloaderPortString.append(bootloaderArray[j].toString());
                 }
 
-                QJsonArray usbidArray = firmwareJson[_manifestUSBIDJsonKey].toArray();
-                for (int j=0; j<usbidArray.count(); j++) {
-                    QStringList vidpid = usbidArray[j].toString().split('/');
-                    QString vid = vidpid[0];
-                    QString pid = vidpid[1];
-
-                    bool ok;
-                    firmwareInfo.rgVID.append(vid.right(vid.count() - 2).toInt(&ok, 16));
-                    firmwareInfo.rgPID.append(pid.right(pid.count() - 2).toInt(&ok, 16));
-                }
-
                 QString brandName = firmwareJson[_manifestBrandNameKey].toString();
-                firmwareInfo.friendlyName = QStringLiteral("%1 - %2").arg(brandName.isEmpty() ? platform : brandName).arg(firmwareInfo.version);
+                firmwareInfo.friendlyName = QStringLiteral("%1 - %2").arg(brandName.isEmpty() ? platform : brandName).arg(firmwareJson[_manifestMavFirmwareVersionJsonKey].toString());
             }
         }
 
+        _saveArduPilotManifestCache(downloader->eTag(), downloader->lastModified());
+
         if (_bootloaderFound) {
             _buildAPMFirmwareNames();
         }
@@ -755,6 +830,113 @@ void FirmwareUpgradeController::_ardupilotManifestDownloadComplete(QString remot
     }
 }
 
+bool FirmwareUpgradeController::_loadArduPilotManifestCache(QByteArray& eTag, QByteArray& lastModified)
+{
+    QByteArray payload;
+    if (!_loadDownloadCache(_arduPilotManifestCacheName, eTag, lastModified, payload)) {
+        return false;
+    }
+
+    QHash<uint32_t, QList<ManifestFirmwareInfo_t>> manifestFirmwareInfoByBoardId;
+
+    QDataStream stream(payload);
+    quint32     boardCount;
+    stream >> boardCount;
+    for (quint32 i=0; i<boardCount && stream.status() == QDataStream::Ok; i++) {
+        quint32 boardId;
+        quint32 firmwareCount;
+        stream >> boardId >> firmwareCount;
+
+        QList<ManifestFirmwareInfo_t>& boardFirmwareInfo = manifestFirmwareInfoByBoardId[boardId];
+        for (quint32 j=0; j<firmwareCount && stream.status() == QDataStream::Ok; j++) {
+            ManifestFirmwareInfo_t  firmwareInfo;
+            qint32                  firmwareBuildType;
+            qint32                  vehicleType;
+
+            stream >> firmwareBuildType >> vehicleType >> firmwareInfo.url >> firmwareInfo.rgBootloaderPortString >> firmwareInfo.friendlyName >> firmwareInfo.chibios >> firmwareInfo.fmuv2;
+            firmwareInfo.boardId =              boardId;
+            firmwareInfo.firmwareBuildType =    static_cast<FirmwareBuildType_t>(firmwareBuildType);
+            firmwareInfo.vehicleType =          static_cast<FirmwareVehicleType_t>(vehicleType);
+            boardFirmwareInfo.append(firmwareInfo);
+        }
+    }
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(FirmwareUpgradeLog) << "ArduPilot manifest cache is corrupt";
+        return false;
+    }
+
+    _manifestFirmwareInfoByBoardId = manifestFirmwareInfoByBoardId;
+    qCDebug(FirmwareUpgradeLog) << "Using cached ArduPilot manifest index, board count" << _manifestFirmwareInfoByBoardId.count();
+    return true;
+}
+
+void FirmwareUpgradeController::_saveArduPilotManifestCache(const QByteArray& eTag, const QByteArray& lastModified)
+{
+    if (eTag.isEmpty() && lastModified.isEmpty()) {
+        // The server gave us nothing to ask with next time, so a cache could never be validated
+        return;
+    }
+
+    QByteArray  payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << static_cast<quint32>(_manifestFirmwareInfoByBoardId.count());
+    for (auto iter = _manifestFirmwareInfoByBoardId.constBegin(); iter != _manifestFirmwareInfoByBoardId.constEnd(); iter++) {
+        stream << static_cast<quint32>(iter.key()) << static_cast<quint32>(iter.value().count());
+        for (const ManifestFirmwareInfo_t& firmwareInfo: iter.value()) {
+            stream << static_cast<qint32>(firmwareInfo.firmwareBuildType) << static_cast<qint32>(firmwareInfo.vehicleType) << firmwareInfo.url << firmwareInfo.rgBootloaderPortString << firmwareInfo.friendlyName << firmwareInfo.chibios << firmwareInfo.fmuv2;
+        }
+    }
+
+    _saveDownloadCache(_arduPilotManifestCacheName, eTag, lastModified, payload);
+}
+
+QString FirmwareUpgradeController::_downloadCacheFile(const QString& name)
+{
+    QSettings settings;
+    return QFileInfo(settings.fileName()).dir().filePath(name);
+}
+
+bool FirmwareUpgradeController::_loadDownloadCache(const QString& name, QByteArray& eTag, QByteArray& lastModified, QByteArray& payload)
+{
+    QFile cacheFile(_downloadCacheFile(name));
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&cacheFile);
+    quint32     magic;
+    quint32     version;
+    QByteArray  compressed;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != _downloadCacheMagic || version != _downloadCacheVersion) {
+        qCDebug(FirmwareUpgradeLog) << "Ignoring download cache from other version" << cacheFile.fileName();
+        return false;
+    }
+    stream >> eTag >> lastModified >> compressed;
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(FirmwareUpgradeLog) << "Download cache read failed" << cacheFile.fileName();
+        return false;
+    }
+
+    payload = qUncompress(compressed);
+    return !payload.isEmpty();
+}
+
+void FirmwareUpgradeController::_saveDownloadCache(const QString& name, const QByteArray& eTag, const QByteArray& lastModified, const QByteArray& payload)
+{
+    QSaveFile cacheFile(_downloadCacheFile(name));
+    if (!cacheFile.open(QIODevice::WriteOnly)) {
+        qCWarning(FirmwareUpgradeLog) << "Unable to write download cache" << cacheFile.fileName() << cacheFile.errorString();
+        return;
+    }
+
+    QDataStream stream(&cacheFile);
+    stream << _downloadCacheMagic << _downloadCacheVersion << eTag << lastModified << qCompress(payload);
+    if (stream.status() != QDataStream::Ok || !cacheFile.commit()) {
+        qCWarning(FirmwareUpgradeLog) << "Download cache write failed" << cacheFile.fileName();
+    }
+}
+
 FirmwareUpgradeController::FirmwareBuildType_t FirmwareUpgradeController::_manifestMavFirmwareVersionTypeToFirmwareBuildType(const QString& manifestMavFirmwareVersionType)
 {
     if (_manifestMavFirmwareVersionTypeToFirmwareBuildTypeMap.contains(manifestMavFirmwareVersionType)) {
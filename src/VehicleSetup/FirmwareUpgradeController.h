@@ -12,8 +12,10 @@
 #include "PX4FirmwareUpgradeThread.h"
 #include "FirmwareImage.h"
 #include "Fact.h"
+#include "QGCFileDownload.h"
 
 #include <QObject>
+#include <QPointer>
 #include <QUrl>
 #include <QTimer>
 #include <QNetworkAccessManager>
@@ -195,6 +197,13 @@ private:
     void _errorCancel               (const QString& msg);
     void _determinePX4StableVersion (void);
     void _downloadArduPilotManifest (void);
+    void _setPX4Versions            (const QString& stableVersion, const QString& betaVersion);
+    bool _loadArduPilotManifestCache(QByteArray& eTag, QByteArray& lastModified);
+    void _saveArduPilotManifestCache(const QByteArray& eTag, const QByteArray& lastModified);
+
+    static QString  _downloadCacheFile  (const QString& name);
+    static bool     _loadDownloadCache  (const QString& name, QByteArray& eTag, QByteArray& lastModified, QByteArray& payload);
+    static void     _saveDownloadCache  (const QString& name, const QByteArray& eTag, const QByteArray& lastModified, const QByteArray& payload);
 
     QString _singleFirmwareURL;
     bool    _singleFirmwareMode;
@@ -228,6 +237,7 @@ private:
     
     QNetworkAccessManager*  _downloadManager;       ///< Used for firmware file downloading across the internet
     QNetworkReply*          _downloadNetworkReply;  ///< Used for firmware file downloading across the internet
+    QPointer<QGCFileDownload> _firmwareDownloader;  ///< Firmware download in progress, the board is erased meanwhile
     
     /// @brief Thread controller which is used to run bootloader commands on separate thread
     PX4FirmwareUpgradeThreadController* _threadController;
@@ -256,6 +266,12 @@ private:
     QString _px4StableVersion;  // Version strange for latest PX4 stable
     QString _px4BetaVersion;    // Version strange for latest PX4 beta
 
+    // Firmware lists are downloaded again only when the server says they changed
+    static const char*      _px4ReleasesCacheName;
+    static const char*      _arduPilotManifestCacheName;
+    static const quint32    _downloadCacheMagic     = 0x51474643;   ///< QGFC
+    static const quint32    _downloadCacheVersion   = 1;            ///< Bump with any change to the cached payloads
+
     const QString _apmBoardDescriptionReplaceText;
 
     static const char* _manifestFirmwareJsonKey;
@@ -276,17 +292,14 @@ private:
         FirmwareBuildType_t     firmwareBuildType;
         FirmwareVehicleType_t   vehicleType;
         QString                 url;
-        QString                 version;
         QStringList             rgBootloaderPortString;
-        QList<int>              rgVID;
-        QList<int>              rgPID;
         QString                 friendlyName;
         bool                    chibios;
         bool                    fmuv2;
     } ManifestFirmwareInfo_t;
 
 
-    QList<ManifestFirmwareInfo_t>           _rgManifestFirmwareInfo;
+    QHash<uint32_t, QList<ManifestFirmwareInfo_t>>  _manifestFirmwareInfoByBoardId; ///< Only the manifest entries QGC can flash, in manifest order
     QMap<QString, FirmwareBuildType_t>      _manifestMavFirmwareVersionTypeToFirmwareBuildTypeMap;
     QMap<QString, FirmwareVehicleType_t>    _manifestMavTypeToFirmwareVehicleTypeMap;
     QStringList                             _apmFirmwareNames;
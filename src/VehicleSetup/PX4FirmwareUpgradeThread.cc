@@ -27,6 +27,7 @@ PX4FirmwareUpgradeThreadWorker::PX4FirmwareUpgradeThreadWorker(PX4FirmwareUpgrad
     connect(_controller, &PX4FirmwareUpgradeThreadController::_initThreadWorker,            this, &PX4FirmwareUpgradeThreadWorker::_init);
     connect(_controller, &PX4FirmwareUpgradeThreadController::_startFindBoardLoopOnThread,  this, &PX4FirmwareUpgradeThreadWorker::_startFindBoardLoop);
     connect(_controller, &PX4FirmwareUpgradeThreadController::_flashOnThread,               this, &PX4FirmwareUpgradeThreadWorker::_flash);
+    connect(_controller, &PX4FirmwareUpgradeThreadController::_eraseOnThread,               this, &PX4FirmwareUpgradeThreadWorker::_eraseBeforeFlash);
     connect(_controller, &PX4FirmwareUpgradeThreadController::_rebootOnThread,              this, &PX4FirmwareUpgradeThreadWorker::_reboot);
     connect(_controller, &PX4FirmwareUpgradeThreadController::_cancel,                      this, &PX4FirmwareUpgradeThreadWorker::_cancel);
 }
@@ -48,7 +49,7 @@ void PX4FirmwareUpgradeThreadWorker::_init(void)
 
 void PX4FirmwareUpgradeThreadWorker::_cancel(void)
 {
-    qCDebug(FirmwareUpgradeVerboseLog) << "_cancel";
+    qCVerbose(FirmwareUpgradeVerboseLog) << "_cancel";
     if (_bootloader) {
         _bootloader->reboot();
         _bootloader->close();
@@ -66,7 +67,7 @@ void PX4FirmwareUpgradeThreadWorker::_startFindBoardLoop(void)
 
 void PX4FirmwareUpgradeThreadWorker::_findBoardOnce(void)
 {
-    qCDebug(FirmwareUpgradeVerboseLog) << "_findBoardOnce";
+    qCVerbose(FirmwareUpgradeVerboseLog) << "_findBoardOnce";
     
     QGCSerialPortInfo               portInfo;
     QGCSerialPortInfo::BoardType_t  boardType;
@@ -80,6 +81,7 @@ void PX4FirmwareUpgradeThreadWorker::_findBoardOnce(void)
             if (!_findBoardFirstAttempt) {
 
                 _bootloader = new Bootloader(boardType == QGCSerialPortInfo::BoardTypeSiKRadio, this);
+                _erased     = false;
                 connect(_bootloader, &Bootloader::updateProgress, this, &PX4FirmwareUpgradeThreadWorker::_updateProgress);
 
                 if (_bootloader->open(portInfo.portName())) {
@@ -116,15 +118,15 @@ bool PX4FirmwareUpgradeThreadWorker::_findBoardFromPorts(QGCSerialPortInfo& port
     for (const QGCSerialPortInfo& info: QGCSerialPortInfo::availablePorts()) {
         info.getBoardInfo(boardType, boardName);
 
-        qCDebug(FirmwareUpgradeVerboseLog) << "Serial Port --------------";
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tboard type" << boardType;
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tboard name" << boardName;
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tmanufacturer:" << info.manufacturer();
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tport name:" << info.portName();
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tdescription:" << info.description();
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tsystem location:" << info.systemLocation();
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tvendor ID:" << info.vendorIdentifier();
-        qCDebug(FirmwareUpgradeVerboseLog) << "\tproduct ID:" << info.productIdentifier();
+        qCVerbose(FirmwareUpgradeVerboseLog) << "Serial Port --------------";
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tboard type" << boardType;
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tboard name" << boardName;
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tmanufacturer:" << info.manufacturer();
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tport name:" << info.portName();
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tdescription:" << info.description();
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tsystem location:" << info.systemLocation();
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tvendor ID:" << info.vendorIdentifier();
+        qCVerbose(FirmwareUpgradeVerboseLog) << "\tproduct ID:" << info.productIdentifier();
         
         if (info.canFlash()) {
             portInfo = info;
@@ -140,16 +142,38 @@ void PX4FirmwareUpgradeThreadWorker::_reboot(void)
     _bootloader->reboot();
 }
 
-void PX4FirmwareUpgradeThreadWorker::_flash(void)
+void PX4FirmwareUpgradeThreadWorker::_eraseBeforeFlash(void)
 {
-    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareUpgradeThreadWorker::_flash";
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareUpgradeThreadWorker::_eraseBeforeFlash";
 
+    if (!_bootloader || _erased) {
+        return;
+    }
     if (!_bootloader->initFlashSequence()) {
         emit error(_bootloader->errorString());
         return;
     }
+    _erased = _erase();
+}
+
+void PX4FirmwareUpgradeThreadWorker::_flash(void)
+{
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareUpgradeThreadWorker::_flash";
+
+    if (!_bootloader) {
+        // Cancelled while the firmware was downloading
+        return;
+    }
+
+    if (!_erased) {
+        if (!_bootloader->initFlashSequence()) {
+            emit error(_bootloader->errorString());
+            return;
+        }
+        _erased = _erase();
+    }
 
-    if (_erase()) {
+    if (_erased) {
         emit status(tr("Programming new version..."));
         
         if (_bootloader->program(_controller->image())) {
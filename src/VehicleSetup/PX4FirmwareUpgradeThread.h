@@ -57,6 +57,7 @@ private slots:
     void _startFindBoardLoop(void);
     void _reboot            (void);
     void _flash             (void);
+    void _eraseBeforeFlash  (void);
     void _findBoardOnce     (void);
     void _updateProgress    (int curr, int total) { emit updateProgress(curr, total); }
     void _cancel            (void);
@@ -71,6 +72,7 @@ private:
     QTimer*             _findBoardTimer         = nullptr;
     QTime               _elapsed;
     bool                _foundBoard             = false;
+    bool                _erased                 = false;    ///< true: board was erased ahead of the flash
     bool                _boardIsSiKRadio        = false;
     bool                _findBoardFirstAttempt  = true;     ///< true: we found the board right away, it needs to be unplugged and plugged back in
     QGCSerialPortInfo   _foundBoardPortInfo;                ///< port info for found board
@@ -96,6 +98,10 @@ public:
     void reboot(void) { emit _rebootOnThread(); }
     
     void flash(const FirmwareImage* image);
+
+    /// @brief Erases the board ahead of flash, so it can be done while the firmware is still downloading. flash
+    /// erases the board itself if this wasn't called.
+    void erase(void) { emit _eraseOnThread(); }
     
     const FirmwareImage* image(void) { return _image; }
     
@@ -116,6 +122,7 @@ signals:
     void _startFindBoardLoopOnThread(void);
     void _rebootOnThread            (void);
     void _flashOnThread             (void);
+    void _eraseOnThread             (void);
     void _cancel                    (void);
     
 private slots:
@@ -22,6 +22,8 @@ VehicleComponent::VehicleComponent(Vehicle* vehicle, AutoPilotPlugin* autopilot,
 {
     if (!vehicle || !autopilot) {
         qWarning() << "Internal error";
+    } else {
+        connect(_vehicle->parameterManager(), &ParameterManager::parameterUpdateComplete, this, &VehicleComponent::_parameterUpdateComplete);
     }
 }
 
@@ -64,5 +66,18 @@ void VehicleComponent::setupTriggerSignals(void)
 
 void VehicleComponent::_triggerUpdated(QVariant /*value*/)
 {
+    if (_vehicle->parameterManager()->parameterUpdateInProgress()) {
+        // A parameter refresh changes many triggers at once, work out setupComplete once at the end of it
+        _setupCompleteChangePending = true;
+        return;
+    }
     emit setupCompleteChanged(setupComplete());
 }
+
+void VehicleComponent::_parameterUpdateComplete(void)
+{
+    if (_setupCompleteChangePending) {
+        _setupCompleteChangePending = false;
+        emit setupCompleteChanged(setupComplete());
+    }
+}
@@ -74,9 +74,15 @@ signals:
 protected slots:
     void _triggerUpdated(QVariant value);
 
+private slots:
+    void _parameterUpdateComplete(void);
+
 protected:
     Vehicle*            _vehicle;
     AutoPilotPlugin*    _autopilot;
+
+private:
+    bool                _setupCompleteChangePending = false;    ///< true: a trigger changed during a parameter update batch
 };
 
 #endif
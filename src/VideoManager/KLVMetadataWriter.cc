@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief QGC Video KLV Metadata Writer
+ */
+
+#include "KLVMetadataWriter.h"
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "VideoReceiver.h"
+#include <QDateTime>
+#include <QtMath>
+
+QGC_LOGGING_CATEGORY(KLVMetadataWriterLog, "KLVMetadataWriterLog")
+
+const int KLVMetadataWriter::_sampleRate = 30; // Packets per second, about the frame rate of most streams
+
+// MISB ST 0601 UAS Datalink Local Set
+static const char kUniversalKey[16] = { 0x06, 0x0E, 0x2B, 0x34, 0x02, 0x0B, 0x01, 0x01, 0x0E, 0x01, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00 };
+
+static const quint8 kTagChecksum            = 1;
+static const quint8 kTagPrecisionTimeStamp  = 2;
+static const quint8 kTagPlatformHeading     = 5;
+static const quint8 kTagPlatformPitch       = 6;
+static const quint8 kTagPlatformRoll        = 7;
+static const quint8 kTagSensorLatitude      = 13;
+static const quint8 kTagSensorLongitude     = 14;
+static const quint8 kTagSensorTrueAltitude  = 15;
+static const quint8 kTagPlatformGroundSpeed = 56;
+static const quint8 kTagVersion             = 65;
+
+static const quint8 kVersion                = 17;
+
+// Maps value from min..max onto the full range of an unsigned integer of the given size
+static quint64 _mapUnsigned(double value, double min, double max, int bytes)
+{
+    const double maxInt = qPow(2, 8 * bytes) - 1;
+    return static_cast<quint64>(qRound64(qBound(0.0, (value - min) / (max - min), 1.0) * maxInt));
+}
+
+// Maps value from -range..range onto a signed integer of the given size, the lowest value marks out of range
+static quint64 _mapSigned(double value, double range, int bytes)
+{
+    const quint64 mask = bytes >= 8 ? ~0ULL : (1ULL << (8 * bytes)) - 1;
+    if (qAbs(value) > range) {
+        return (1ULL << (8 * bytes - 1)) & mask;
+    }
+    const double maxInt = qPow(2, 8 * bytes - 1) - 1;
+    return static_cast<quint64>(qRound64(value / range * maxInt)) & mask;
+}
+
+KLVMetadataWriter::KLVMetadataWriter(QObject* parent)
+    : QObject(parent)
+{
+    connect(&_timer, &QTimer::timeout, this, &KLVMetadataWriter::_captureTelemetry);
+}
+
+void KLVMetadataWriter::startCapturingTelemetry(VideoReceiver* receiver)
+{
+    qCDebug(KLVMetadataWriterLog) << "Starting KLV metadata";
+    _receiver = receiver;
+    _captureTelemetry();
+    _timer.start(1000/_sampleRate);
+}
+
+void KLVMetadataWriter::stopCapturingTelemetry()
+{
+    qCDebug(KLVMetadataWriterLog) << "Stopping KLV metadata";
+    _timer.stop();
+    _receiver = nullptr;
+}
+
+void KLVMetadataWriter::_appendTag(quint8 tag, quint64 value, int bytes)
+{
+    _localSet.append(static_cast<char>(tag));
+    _localSet.append(static_cast<char>(bytes));
+    for (int i = bytes - 1; i >= 0; i--) {
+        _localSet.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void KLVMetadataWriter::_appendLength(int length)
+{
+    // BER short form up to 127, long form after
+    if (length < 128) {
+        _packet.append(static_cast<char>(length));
+    } else if (length < 256) {
+        _packet.append(static_cast<char>(0x81));
+        _packet.append(static_cast<char>(length));
+    } else {
+        _packet.append(static_cast<char>(0x82));
+        _packet.append(static_cast<char>((length >> 8) & 0xFF));
+        _packet.append(static_cast<char>(length & 0xFF));
+    }
+}
+
+void KLVMetadataWriter::_captureTelemetry()
+{
+    if (!_receiver) {
+        return;
+    }
+
+    _localSet.clear();
+
+    // The time stamp must come first, microseconds since the epoch
+    _appendTag(kTagPrecisionTimeStamp, static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000, 8);
+
+    auto *vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+
+    // Without a vehicle the packet still goes out so the metadata stream keeps up with the video
+    if (vehicle) {
+        const double heading = vehicle->heading()->rawValue().toDouble();
+        if (!qIsNaN(heading)) {
+            double normalizedHeading = fmod(heading, 360.0);
+            if (normalizedHeading < 0) {
+                normalizedHeading += 360.0;
+            }
+            _appendTag(kTagPlatformHeading, _mapUnsigned(normalizedHeading, 0, 360, 2), 2);
+        }
+
+        const double pitch = vehicle->pitch()->rawValue().toDouble();
+        if (!qIsNaN(pitch)) {
+            _appendTag(kTagPlatformPitch, _mapSigned(pitch, 20, 2), 2);
+        }
+
+        const double roll = vehicle->roll()->rawValue().toDouble();
+        if (!qIsNaN(roll)) {
+            _appendTag(kTagPlatformRoll, _mapSigned(roll, 50, 2), 2);
+        }
+
+        const QGeoCoordinate coordinate = vehicle->coordinate();
+        if (coordinate.isValid()) {
+            _appendTag(kTagSensorLatitude,  _mapSigned(coordinate.latitude(),  90, 4), 4);
+            _appendTag(kTagSensorLongitude, _mapSigned(coordinate.longitude(), 180, 4), 4);
+        }
+
+        const double altitude = vehicle->altitudeAMSL()->rawValue().toDouble();
+        if (!qIsNaN(altitude)) {
+            _appendTag(kTagSensorTrueAltitude, _mapUnsigned(altitude, -900, 19000, 2), 2);
+        }
+
+        const double groundSpeed = vehicle->groundSpeed()->rawValue().toDouble();
+        if (!qIsNaN(groundSpeed)) {
+            _appendTag(kTagPlatformGroundSpeed, static_cast<quint64>(qBound(0, qRound(groundSpeed), 255)), 1);
+        }
+    }
+
+    _appendTag(kTagVersion, kVersion, 1);
+
+    _packet.clear();
+    _packet.append(kUniversalKey, sizeof(kUniversalKey));
+    _appendLength(_localSet.count() + 4);
+    _packet.append(_localSet);
+    _packet.append(static_cast<char>(kTagChecksum));
+    _packet.append(static_cast<char>(2));
+
+    // 16 bit running sum over the whole packet up to and including the length of the checksum
+    quint16 checksum = 0;
+    for (int i = 0; i < _packet.count(); i++) {
+        checksum += static_cast<quint16>(static_cast<quint8>(_packet[i]) << (8 * ((i + 1) % 2)));
+    }
+    _packet.append(static_cast<char>(checksum >> 8));
+    _packet.append(static_cast<char>(checksum & 0xFF));
+
+    _receiver->setRecordingMetadata(_packet);
+}
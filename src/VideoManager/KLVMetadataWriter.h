@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief QGC Video KLV Metadata Writer
+ */
+
+#pragma once
+
+#include "QGCLoggingCategory.h"
+#include <QObject>
+#include <QTimer>
+#include <QByteArray>
+#include <QPointer>
+
+Q_DECLARE_LOGGING_CATEGORY(KLVMetadataWriterLog)
+
+class Vehicle;
+class VideoReceiver;
+
+/// Builds MISB ST 0601 UAS Datalink Local Set packets from the active vehicle and hands them to the video receiver,
+/// which repeats the latest packet with each recorded frame.
+class KLVMetadataWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KLVMetadataWriter(QObject* parent = nullptr);
+    ~KLVMetadataWriter() = default;
+
+    // starts capturing vehicle telemetry into the recording of the receiver.
+    void startCapturingTelemetry(VideoReceiver* receiver);
+    void stopCapturingTelemetry();
+
+private slots:
+    // Sends a packet with the current telemetry to the receiver.
+    void _captureTelemetry();
+
+private:
+    void _appendTag     (quint8 tag, quint64 value, int bytes);
+    void _appendLength  (int length);
+
+    QTimer _timer;
+    QPointer<VideoReceiver> _receiver;
+    QByteArray _localSet;       ///< Tags of the packet being built
+    QByteArray _packet;
+
+    static const int _sampleRate;
+};
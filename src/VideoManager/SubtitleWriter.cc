@@ -24,6 +24,10 @@
 QGC_LOGGING_CATEGORY(SubtitleWriterLog, "SubtitleWriterLog")
 
 const int SubtitleWriter::_sampleRate = 1; // Sample rate in Hz for getting telemetry data, most players do weird stuff when > 1Hz
+const int SubtitleWriter::_flushBytes = 4096; // Lines are held back until there is at least this much to write
+
+static const int nRows = 3; // number of rows used for displaying data
+static const int offsetFactor = 700; // Used to simulate a larger resolution and reduce the borders in the layout
 
 SubtitleWriter::SubtitleWriter(QObject* parent)
     : QObject(parent)
@@ -39,7 +43,9 @@ void SubtitleWriter::startCapturingTelemetry(const QString& videoFile)
     _values = settings.value("large").toStringList().replaceInStrings(QStringLiteral("Vehicle."), QString());
     _values += settings.value("small").toStringList().replaceInStrings(QStringLiteral("Vehicle."), QString());
 
-    _startTime = QDateTime::currentDateTime();
+    _startTime.start();
+    _buffer.clear();
+    _vehicle = nullptr;
 
     QFileInfo videoFileInfo(videoFile);
     QString subtitleFilePath = QStringLiteral("%1/%2.ass").arg(videoFileInfo.path(), videoFileInfo.completeBaseName());
@@ -75,6 +81,10 @@ void SubtitleWriter::startCapturingTelemetry(const QString& videoFile)
     // TODO: Find a good way to input title
     //stream << QStringLiteral("Dialogue: 0,0:00:00.00,999:00:00.00,Default,,0,0,0,,{\\pos(5,35)}%1\n");
 
+    stream.flush();
+
+    _buffer.reserve(_flushBytes * 2);
+
     _timer.start(1000/_sampleRate);
 }
 
@@ -82,78 +92,115 @@ void SubtitleWriter::stopCapturingTelemetry()
 {
     qCDebug(SubtitleWriterLog) << "Stopping writing";
     _timer.stop();
+    _flush();
     _file.close();
+    _facts.clear();
+    _vehicle = nullptr;
 }
 
-void SubtitleWriter::_captureTelemetry()
+void SubtitleWriter::_flush()
+{
+    if (!_buffer.isEmpty() && _file.isOpen()) {
+        if (_file.write(_buffer) != _buffer.size()) {
+            qCWarning(SubtitleWriterLog) << "Unable to write subtitle data to file" << _file.errorString();
+        }
+    }
+    _buffer.clear();
+}
+
+QString SubtitleWriter::_timeString(qint64 msecs)
 {
-    static const float nRows = 3; // number of rows used for displaying data
-    static const int offsetFactor = 700; // Used to simulate a larger resolution and reduce the borders in the layout
+    // H:MM:SS.CC as used by the Start and End fields
+    qint64 centiseconds = msecs / 10;
+    return QString::asprintf("%d:%02d:%02d.%02d",
+                             static_cast<int>(centiseconds / 360000),
+                             static_cast<int>((centiseconds / 6000) % 60),
+                             static_cast<int>((centiseconds / 100) % 60),
+                             static_cast<int>(centiseconds % 100));
+}
+
+void SubtitleWriter::_resolveFacts(Vehicle* vehicle)
+{
+    _vehicle = vehicle;
+    _facts.clear();
+    _units.clear();
+    _namesColumns.clear();
+    _valuesPositions.clear();
+
+    QStringList namesStrings;
+    for (const auto& i : _values) {
+        Fact* fact = vehicle->getFact(i);
+        _facts.append(fact);
+        _units.append(fact ? fact->cookedUnits() : QString());
+        namesStrings << QStringLiteral("%1:").arg(fact ? fact->shortDescription() : i);
+    }
 
+    // This splits the screen in N parts and uses the N-1 internal parts to align the subtitles to.
+    // Should we try to get the resolution from the pipeline? This seems to work fine with other resolutions too.
+    const int rowWidth = (1920 + offsetFactor)/(nRows+1);
+    _valuesPerColumn = static_cast<int>(ceil(_values.length() / static_cast<float>(nRows)));
+
+    // One right-aligned column for names and one for the fact values
+    for (int i=0; i<nRows; i++) {
+        _namesColumns << QStringLiteral("{\\an3\\pos(%1,1075)}%2\n").arg(-offsetFactor/2 + rowWidth*(i+1) - 10)
+                                                                    .arg(namesStrings.mid(i*_valuesPerColumn, _valuesPerColumn).join("\\N"));
+        _valuesPositions << QStringLiteral("{\\pos(%1,1075)}").arg(-offsetFactor/2 + rowWidth*(i+1));
+    }
+}
+
+void SubtitleWriter::_captureTelemetry()
+{
     auto *vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
 
     if (!vehicle) {
         qCWarning(SubtitleWriterLog) << "Attempting to capture fact data with no active vehicle!";
         return;
     }
-    // Each list corresponds to a column in the subtitles
-    QStringList namesStrings;
-    QStringList valuesStrings;
 
-    // Make a list of "factname:" strings and other with the values, so one can be aligned left and the other right
-    for (const auto& i : _values) {
-        valuesStrings << QStringLiteral("%2 %3").arg(vehicle->getFact(i)->cookedValueString())
-                                                .arg(vehicle->getFact(i)->cookedUnits());
-        namesStrings << QStringLiteral("%1:").arg(vehicle->getFact(i)->shortDescription());
+    if (vehicle != _vehicle) {
+        _resolveFacts(vehicle);
     }
 
-    // The time to start displaying this subtitle text
-    QTime start = QTime(0, 0).addMSecs(_startTime.time().msecsTo(QDateTime::currentDateTime().time()));
-
-    // The time to stop displaying this subtitle text
-    QTime end = start.addMSecs(1000/_sampleRate);
-
-    // This splits the screen in N parts and uses the N-1 internal parts to align the subtitles to.
-    // Should we try to get the resolution from the pipeline? This seems to work fine with other resolutions too.
-    static const int rowWidth = (1920 + offsetFactor)/(nRows+1);
-    int nValuesByRow = ceil(_values.length() / nRows);
-
-    QList<QStringList> dataColumns;
-    QStringList stringColumns;
+    // The time to start and stop displaying this subtitle text
+    qint64 startMSecs = _startTime.elapsed();
+    QString prefix = QStringLiteral("Dialogue: 0,");
+    prefix += _timeString(startMSecs);
+    prefix += QLatin1Char(',');
+    prefix += _timeString(startMSecs + 1000/_sampleRate);
+    prefix += QStringLiteral(",Default,,0,0,0,,");
 
-    // These templates are used for the data columns, one right-aligned for names and one for
-    // the facts values. The arguments expected are: start time, end time, xposition, and string content.
-    QString namesLine = QStringLiteral("Dialogue: 0,%2,%3,Default,,0,0,0,,{\\an3\\pos(%1,1075)}%4\n");
-    QString valuesLine = QStringLiteral("Dialogue: 0,%2,%3,Default,,0,0,0,,{\\pos(%1,1075)}%4\n");
+    QString lines;
+    lines.reserve(1024);
 
     // Split values into N columns and create a subtitle entry for each column
     for (int i=0; i<nRows; i++) {
-        QStringList currentColumnNameStrings = namesStrings.mid((i)*nValuesByRow, nValuesByRow);
-        QStringList currentColumnValueStrings = valuesStrings.mid((i)*nValuesByRow, nValuesByRow);
-
-        // Fill templates for names of column i
-        QString names = namesLine.arg(-offsetFactor/2 + rowWidth*(i+1) - 10)
-                                 .arg(start.toString("H:mm:ss.zzz").chopped(2))
-                                 .arg(end.toString("H:mm:ss.zzz").chopped(2))
-                                 .arg(currentColumnNameStrings.join("\\N"));
-        stringColumns << names;
-
-        // Fill templates for values of column i
-        QString values = valuesLine.arg(-offsetFactor/2 +rowWidth*(i+1))
-                                   .arg(start.toString("H:mm:ss.zzz").chopped(2))
-                                   .arg(end.toString("H:mm:ss.zzz").chopped(2))
-                                   .arg(currentColumnValueStrings.join("\\N"));
-        stringColumns << values;
+        lines += prefix;
+        lines += _namesColumns[i];
+
+        lines += prefix;
+        lines += _valuesPositions[i];
+        int last = qMin((i+1)*_valuesPerColumn, _facts.count());
+        for (int j=i*_valuesPerColumn; j<last; j++) {
+            if (j != i*_valuesPerColumn) {
+                lines += QStringLiteral("\\N");
+            }
+            if (_facts[j]) {
+                lines += _facts[j]->cookedValueString();
+            }
+            lines += QLatin1Char(' ');
+            lines += _units[j];
+        }
+        lines += QLatin1Char('\n');
     }
 
     // Write the date to the corner
-    stringColumns << QStringLiteral("Dialogue: 0,%1,%2,Default,,0,0,0,,{\\pos(10,35)}%3\n")
-        .arg(start.toString("H:mm:ss.zzz").chopped(2))
-        .arg(end.toString("H:mm:ss.zzz").chopped(2))
-        .arg(QDateTime::currentDateTime().toString(Qt::SystemLocaleShortDate));
-    // Write new data
-    QTextStream stream(&_file);
-    for (const auto& i : stringColumns) {
-        stream << i;
+    lines += prefix;
+    lines += QStringLiteral("{\\pos(10,35)}");
+    lines += QDateTime::currentDateTime().toString(Qt::SystemLocaleShortDate);
+    lines += QLatin1Char('\n');
+
+    _buffer += lines.toUtf8();
+    if (_buffer.size() >= _flushBytes) {
+        _flush();
     }
 }
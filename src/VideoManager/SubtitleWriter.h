@@ -19,11 +19,15 @@
 #include "QGCLoggingCategory.h"
 #include <QObject>
 #include <QTimer>
-#include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QPointer>
 
 Q_DECLARE_LOGGING_CATEGORY(SubtitleWriterLog)
 
+class Fact;
+class Vehicle;
+
 class SubtitleWriter : public QObject
 {
     Q_OBJECT
@@ -41,10 +45,24 @@ private slots:
     void _captureTelemetry();
 
 private:
+    // Looks up the facts for the values once instead of on each sample, along with the parts of the lines which don't change.
+    void _resolveFacts(Vehicle* vehicle);
+    void _flush();
+
+    static QString _timeString(qint64 msecs);
+
     QTimer _timer;
     QStringList _values;
-    QDateTime _startTime;
+    QElapsedTimer _startTime;
     QFile _file;
+    QByteArray _buffer;                 ///< Subtitle lines not yet written to the file
+    QPointer<Vehicle> _vehicle;         ///< Vehicle the facts belong to
+    QList<Fact*> _facts;                ///< nullptr for values the vehicle doesn't have
+    QStringList _units;
+    QStringList _namesColumns;          ///< Position and names of each column, ending the line
+    QStringList _valuesPositions;       ///< Position override of each values column
+    int _valuesPerColumn = 0;
 
     static const int _sampleRate;
+    static const int _flushBytes;
 };
@@ -45,7 +45,8 @@ QGC_LOGGING_CATEGORY(VideoManagerLog, "VideoManagerLog")
 static const char* kFileExtension[VideoReceiver::FILE_FORMAT_MAX - VideoReceiver::FILE_FORMAT_MIN] = {
     "mkv",
     "mov",
-    "mp4"
+    "mp4",
+    "ts"
 };
 #endif
 
@@ -125,12 +126,10 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
     connect(_videoReceiver[0], &VideoReceiver::onStartComplete, this, [this](VideoReceiver::STATUS status) {
         if (status == VideoReceiver::STATUS_OK) {
             _videoStarted[0] = true;
-            if (_videoSink[0] != nullptr) {
-                // It is absolytely ok to have video receiver active (streaming) and decoding not active
-                // It should be handy for cases when you have many streams and want to show only some of them
-                // NOTE that even if decoder did not start it is still possible to record video
-                _videoReceiver[0]->startDecoding(_videoSink[0]);
-            }
+            // It is absolytely ok to have video receiver active (streaming) and decoding not active
+            // It should be handy for cases when you have many streams and want to show only some of them
+            // NOTE that even if decoder did not start it is still possible to record video
+            _startDecoding(0);
         } else if (status == VideoReceiver::STATUS_INVALID_URL) {
             // Invalid URL - don't restart
         } else if (status == VideoReceiver::STATUS_INVALID_STATE) {
@@ -142,18 +141,34 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
 
     connect(_videoReceiver[0], &VideoReceiver::onStopComplete, this, [this](VideoReceiver::STATUS) {
         _videoStarted[0] = false;
+        _videoStatistics[0].clear();
+        emit videoStatisticsChanged();
         _startReceiver(0);
     });
 
+    connect(_videoReceiver[0], &VideoReceiver::statisticsChanged, this, [this](QVariantMap statistics){
+        _videoStatistics[0] = statistics;
+        emit videoStatisticsChanged();
+    });
+
     connect(_videoReceiver[0], &VideoReceiver::decodingChanged, this, [this](bool active){
         _decoding = active;
         emit decodingChanged();
+        if (!active && _videoLatency != 0) {
+            _videoLatency = 0;
+            emit videoLatencyChanged();
+        }
+        if (!active) {
+            // The video may have come back on screen while decoding was shutting down
+            _startDecoding(0);
+        }
     });
 
     connect(_videoReceiver[0], &VideoReceiver::recordingChanged, this, [this](bool active){
         _recording = active;
         if (!active) {
             _subtitleWriter.stopCapturingTelemetry();
+            _klvMetadataWriter.stopCapturingTelemetry();
         }
         emit recordingChanged();
     });
@@ -162,15 +177,27 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
         _subtitleWriter.startCapturingTelemetry(_videoFile);
     });
 
+    connect(_videoReceiver[0], &VideoReceiver::onStartRecordingComplete, this, [this](VideoReceiver::STATUS status){
+        if (status != VideoReceiver::STATUS_OK && !_recording) {
+            _klvMetadataWriter.stopCapturingTelemetry();
+        }
+    });
+
     connect(_videoReceiver[0], &VideoReceiver::videoSizeChanged, this, [this](QSize size){
         _videoSize = ((quint32)size.width() << 16) | (quint32)size.height();
         emit videoSizeChanged();
     });
 
-    //connect(_videoReceiver, &VideoReceiver::onTakeScreenshotComplete, this, [this](VideoReceiver::STATUS status){
-    //    if (status == VideoReceiver::STATUS_OK) {
-    //    }
-    //});
+    connect(_videoReceiver[0], &VideoReceiver::latencyChanged, this, [this](int latency){
+        _videoLatency = latency;
+        emit videoLatencyChanged();
+    });
+
+    connect(_videoReceiver[0], &VideoReceiver::onTakeScreenshotComplete, this, [this](VideoReceiver::STATUS status){
+        if (status != VideoReceiver::STATUS_OK) {
+            qCWarning(VideoManagerLog) << "Unable to save video image" << _imageFile << status;
+        }
+    });
 
     // FIXME: AV: I believe _thermalVideoReceiver should be handled just like _videoReceiver in terms of event
     // and I expect that it will be changed during multiple video stream activity
@@ -178,9 +205,7 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
         connect(_videoReceiver[1], &VideoReceiver::onStartComplete, this, [this](VideoReceiver::STATUS status) {
             if (status == VideoReceiver::STATUS_OK) {
                 _videoStarted[1] = true;
-                if (_videoSink[1] != nullptr) {
-                    _videoReceiver[1]->startDecoding(_videoSink[1]);
-                }
+                _startDecoding(1);
             } else if (status == VideoReceiver::STATUS_INVALID_URL) {
                 // Invalid URL - don't restart
             } else if (status == VideoReceiver::STATUS_INVALID_STATE) {
@@ -192,8 +217,21 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
 
         connect(_videoReceiver[1], &VideoReceiver::onStopComplete, this, [this](VideoReceiver::STATUS) {
             _videoStarted[1] = false;
+            _videoStatistics[1].clear();
+            emit videoStatisticsChanged();
             _startReceiver(1);
         });
+
+        connect(_videoReceiver[1], &VideoReceiver::statisticsChanged, this, [this](QVariantMap statistics){
+            _videoStatistics[1] = statistics;
+            emit videoStatisticsChanged();
+        });
+
+        connect(_videoReceiver[1], &VideoReceiver::decodingChanged, this, [this](bool active){
+            if (!active) {
+                _startDecoding(1);
+            }
+        });
     }
 #endif
     _updateSettings(0);
@@ -313,11 +351,20 @@ VideoManager::startRecording(const QString& videoFile)
     QString videoFile2 = _videoFile + "2." + ext;
     _videoFile += ext;
 
+    //-- Settings are stored using MB
+    const quint64   segmentBytes    = static_cast<quint64>(_videoSettings->recordingSegmentSize()->rawValue().toUInt()) * 1024 * 1024;
+    const unsigned  segmentSecs     = _videoSettings->recordingSegmentLength()->rawValue().toUInt();
+    const bool      metadata        = fileFormat == VideoReceiver::FILE_FORMAT_TS && _videoSettings->recordingMetadata()->rawValue().toBool();
+
     if (_videoReceiver[0] && _videoStarted[0]) {
-        _videoReceiver[0]->startRecording(_videoFile, fileFormat);
+        if (metadata) {
+            // Started ahead of the recording so the first recorded frames already have a packet
+            _klvMetadataWriter.startCapturingTelemetry(_videoReceiver[0]);
+        }
+        _videoReceiver[0]->startRecording(_videoFile, fileFormat, segmentBytes, segmentSecs, metadata);
     }
     if (_videoReceiver[1] && _videoStarted[1]) {
-        _videoReceiver[1]->startRecording(videoFile2, fileFormat);
+        _videoReceiver[1]->startRecording(videoFile2, fileFormat, segmentBytes, segmentSecs);
     }
 
 #else
@@ -342,7 +389,7 @@ VideoManager::stopRecording()
 }
 
 void
-VideoManager::grabImage(const QString& imageFile)
+VideoManager::grabImage(const QString& imageFile, int count)
 {
     if (qgcApp()->runningUnitTests()) {
         return;
@@ -361,9 +408,10 @@ VideoManager::grabImage(const QString& imageFile)
 
     emit imageFileChanged();
 
-    _videoReceiver[0]->takeScreenshot(_imageFile);
+    _videoReceiver[0]->takeScreenshot(_imageFile, static_cast<unsigned>(qMax(1, count)));
 #else
     Q_UNUSED(imageFile)
+    Q_UNUSED(count)
 #endif
 }
 
@@ -580,9 +628,7 @@ VideoManager::_initVideo()
     if (widget != nullptr && _videoReceiver[0] != nullptr) {
         _videoSink[0] = qgcApp()->toolbox()->corePlugin()->createVideoSink(this, widget);
         if (_videoSink[0] != nullptr) {
-            if (_videoStarted[0]) {
-                _videoReceiver[0]->startDecoding(_videoSink[0]);
-            }
+            _startDecoding(0);
         } else {
             qCDebug(VideoManagerLog) << "createVideoSink() failed";
         }
@@ -595,9 +641,7 @@ VideoManager::_initVideo()
     if (widget != nullptr && _videoReceiver[1] != nullptr) {
         _videoSink[1] = qgcApp()->toolbox()->corePlugin()->createVideoSink(this, widget);
         if (_videoSink[1] != nullptr) {
-            if (_videoStarted[1]) {
-                _videoReceiver[1]->startDecoding(_videoSink[1]);
-            }
+            _startDecoding(1);
         } else {
             qCDebug(VideoManagerLog) << "createVideoSink() failed";
         }
@@ -704,9 +748,9 @@ VideoManager::_updateVideoUri(unsigned id, const QString& uri)
     //-- Taisync on iOS or Android sends a raw h.264 stream
     if (isTaisync()) {
         if (id == 0) {
-            return _updateVideoUri(0, QString("tsusb://0.0.0.0:%1").arg(TAISYNC_VIDEO_UDP_PORT));
+            return _updateVideoUri(0, QString("tsusb://0.0.0.0:%1").arg(TAISYNC_VIDEO_TCP_PORT));
         } if (id == 1) {
-            // FIXME: AV: TAISYNC_VIDEO_UDP_PORT is used by video stream, thermal stream should go via its own proxy
+            // FIXME: AV: TAISYNC_VIDEO_TCP_PORT is used by video stream, thermal stream needs its own port
             if (!_videoUri[1].isEmpty()) {
                 _videoUri[1].clear();
                 return true;
@@ -781,6 +825,50 @@ VideoManager::_startReceiver(unsigned id)
 #endif
 }
 
+//----------------------------------------------------------------------------------------
+void
+VideoManager::_startDecoding(unsigned id)
+{
+#if defined(QGC_GST_STREAMING)
+    if (id > 1) {
+        qCDebug(VideoManagerLog) << "Unsupported receiver id" << id;
+    } else if (_videoReceiver[id] != nullptr && _videoSink[id] != nullptr && _videoStarted[id] && _videoVisible[id]) {
+        _videoReceiver[id]->startDecoding(_videoSink[id]);
+    }
+#else
+    Q_UNUSED(id)
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+void
+VideoManager::setVideoVisible(int id, bool visible)
+{
+    if (id < 0 || id > 1) {
+        qCDebug(VideoManagerLog) << "Unsupported receiver id" << id;
+        return;
+    }
+    if (_videoVisible[id] == visible) {
+        return;
+    }
+
+    qCDebug(VideoManagerLog) << "Video visible changed" << id << visible;
+
+    _videoVisible[id] = visible;
+
+#if defined(QGC_GST_STREAMING)
+    if (_videoReceiver[id] == nullptr) {
+        return;
+    }
+    if (visible) {
+        _startDecoding(static_cast<unsigned>(id));
+    } else {
+        // Streaming and any recording carry on, only the decoding branch is taken down
+        _videoReceiver[id]->stopDecoding();
+    }
+#endif
+}
+
 //----------------------------------------------------------------------------------------
 void
 VideoManager::_stopReceiver(unsigned id)
@@ -21,6 +21,7 @@
 #include "VideoReceiver.h"
 #include "QGCToolbox.h"
 #include "SubtitleWriter.h"
+#include "KLVMetadataWriter.h"
 
 Q_DECLARE_LOGGING_CATEGORY(VideoManagerLog)
 
@@ -55,6 +56,9 @@ public:
     Q_PROPERTY(bool             decoding                READ    decoding                                    NOTIFY decodingChanged)
     Q_PROPERTY(bool             recording               READ    recording                                   NOTIFY recordingChanged)
     Q_PROPERTY(QSize            videoSize               READ    videoSize                                   NOTIFY videoSizeChanged)
+    Q_PROPERTY(int              videoLatency            READ    videoLatency                                NOTIFY videoLatencyChanged)
+    Q_PROPERTY(QVariantMap      videoStatistics         READ    videoStatistics                             NOTIFY videoStatisticsChanged)
+    Q_PROPERTY(QVariantMap      thermalVideoStatistics  READ    thermalVideoStatistics                      NOTIFY videoStatisticsChanged)
 
     virtual bool        hasVideo            ();
     virtual bool        isGStreamer         ();
@@ -86,6 +90,15 @@ public:
         return QSize((size >> 16) & 0xFFFF, size & 0xFFFF);
     }
 
+    /// Time from the video arriving to it reaching the screen, ms. 0 when not known.
+    int videoLatency(void) {
+        return _videoLatency;
+    }
+
+    /// Pipeline statistics of each stream, see VideoReceiver::statisticsChanged for the contents. Empty when not streaming.
+    QVariantMap videoStatistics         (void) { return _videoStatistics[0]; }
+    QVariantMap thermalVideoStatistics  (void) { return _videoStatistics[1]; }
+
 // FIXME: AV: they should be removed after finishing multiple video stream support
 // new arcitecture does not assume direct access to video receiver from QML side, even if it works for now
     virtual VideoReceiver*  videoReceiver           () { return _videoReceiver[0]; }
@@ -109,7 +122,12 @@ public:
     Q_INVOKABLE void startRecording (const QString& videoFile = QString());
     Q_INVOKABLE void stopRecording  ();
 
-    Q_INVOKABLE void grabImage(const QString& imageFile = QString());
+    /// Saves the next count frames of the video, the first to imageFile and the rest with an _N suffix
+    Q_INVOKABLE void grabImage(const QString& imageFile = QString(), int count = 1);
+
+    /// Off screen streams stop decoding but keep streaming, so they come back without reconnecting
+    ///     @param id 0: main stream, 1: thermal stream
+    Q_INVOKABLE void setVideoVisible(int id, bool visible);
 
 signals:
     void hasVideoChanged            ();
@@ -126,6 +144,8 @@ signals:
     void recordingChanged           ();
     void recordingStarted           ();
     void videoSizeChanged           ();
+    void videoLatencyChanged        ();
+    void videoStatisticsChanged     ();
 
 protected slots:
     void _videoSourceChanged        ();
@@ -148,12 +168,14 @@ protected:
     void _restartAllVideos          ();
     void _restartVideo              (unsigned id);
     void _startReceiver             (unsigned id);
+    void _startDecoding             (unsigned id);
     void _stopReceiver              (unsigned id);
 
 protected:
     QString                 _videoFile;
     QString                 _imageFile;
     SubtitleWriter          _subtitleWriter;
+    KLVMetadataWriter       _klvMetadataWriter;
     bool                    _isTaisync              = false;
     VideoReceiver*          _videoReceiver[2]       = { nullptr, nullptr };
     void*                   _videoSink[2]           = { nullptr, nullptr };
@@ -165,10 +187,13 @@ protected:
     // It works for now but...
     bool                    _videoStarted[2]        = { false, false };
     bool                    _lowLatencyStreaming[2] = { false, false };
+    bool                    _videoVisible[2]        = { true, true };
     QAtomicInteger<bool>    _streaming              = false;
     QAtomicInteger<bool>    _decoding               = false;
     QAtomicInteger<bool>    _recording              = false;
     QAtomicInteger<quint32> _videoSize              = 0;
+    QAtomicInteger<int>     _videoLatency           = 0;
+    QVariantMap             _videoStatistics[2];
     VideoSettings*          _videoSettings          = nullptr;
     QString                 _videoSourceID;
     bool                    _fullScreen             = false;
@@ -85,7 +85,10 @@ G_BEGIN_DECLS
     GST_PLUGIN_STATIC_DECLARE(rtpmanager);
     GST_PLUGIN_STATIC_DECLARE(isomp4);
     GST_PLUGIN_STATIC_DECLARE(matroska);
+    GST_PLUGIN_STATIC_DECLARE(multifile);
     GST_PLUGIN_STATIC_DECLARE(mpegtsdemux);
+    GST_PLUGIN_STATIC_DECLARE(mpegtsmux);
+    GST_PLUGIN_STATIC_DECLARE(app);
     GST_PLUGIN_STATIC_DECLARE(opengl);
     GST_PLUGIN_STATIC_DECLARE(tcp);
 #if defined(__android__)
@@ -129,6 +132,32 @@ GStreamer::blacklist(VideoSettings::VideoDecoderOptions option)
         gst_object_unref(feature);
     };
 
+    // Hardware decoders by family. A family may not have a decoder for every codec the vehicle sends, so when a
+    // hardware family is forced the other hardware families are still ranked above the software decoders as a
+    // fallback. Decoders which are not installed are skipped by changeRank.
+    static const char* vaapiDecoders[]          = { "vah264dec", "vah265dec", "vavp8dec", "vavp9dec", "vaav1dec", "vampeg2dec",
+                                                    "vaapih264dec", "vaapih265dec", "vaapivp8dec", "vaapivp9dec", "vaapiav1dec",
+                                                    "vaapimpeg2dec", "vaapimpeg4dec", "vaapih263dec", "vaapivc1dec", nullptr };
+    static const char* nvidiaDecoders[]         = { "nvh264dec", "nvh264sldec", "nvh265dec", "nvh265sldec", "nvvp9dec", "nvav1dec",
+                                                    "nvv4l2decoder", nullptr };
+    static const char* directX3DDecoders[]      = { "d3d11h264dec", "d3d11h265dec", "d3d11vp9dec", "d3d11av1dec", "d3d11mpeg2dec", nullptr };
+    static const char* videoToolboxDecoders[]   = { "vtdec_hw", "vtdec", nullptr };
+    static const char* softwareDecoders[]       = { "avdec_h264", "avdec_h265", "avdec_vp9", "dav1ddec", nullptr };
+
+    auto changeFamilyRank = [changeRank](const char* const* featureNames, uint16_t rank) {
+        for (; *featureNames != nullptr; featureNames++) {
+            changeRank(*featureNames, rank);
+        }
+    };
+
+    static const char* const* hardwareFamilies[] = { vaapiDecoders, nvidiaDecoders, directX3DDecoders, videoToolboxDecoders };
+
+    auto forceHardwareFamily = [changeFamilyRank](const char* const* forcedFamily) {
+        for (const char* const* family: hardwareFamilies) {
+            changeFamilyRank(family, family == forcedFamily ? GST_RANK_PRIMARY + 2 : GST_RANK_PRIMARY + 1);
+        }
+    };
+
     // Set rank for specific features
     changeRank("bcmdec", GST_RANK_NONE);
 
@@ -136,25 +165,19 @@ GStreamer::blacklist(VideoSettings::VideoDecoderOptions option)
         case VideoSettings::ForceVideoDecoderDefault:
             break;
         case VideoSettings::ForceVideoDecoderSoftware:
-            changeRank("avdec_h264", GST_RANK_PRIMARY + 1);
+            changeFamilyRank(softwareDecoders, GST_RANK_PRIMARY + 1);
             break;
         case VideoSettings::ForceVideoDecoderVAAPI:
-            for(auto name : {"vaapimpeg2dec", "vaapimpeg4dec", "vaapih263dec", "vaapih264dec", "vaapivc1dec"}) {
-                changeRank(name, GST_RANK_PRIMARY + 1);
-            }
+            forceHardwareFamily(vaapiDecoders);
             break;
         case VideoSettings::ForceVideoDecoderNVIDIA:
-            for(auto name : {"nvh265dec", "nvh265sldec", "nvh264dec", "nvh264sldec"}) {
-                changeRank(name, GST_RANK_PRIMARY + 1);
-            }
+            forceHardwareFamily(nvidiaDecoders);
             break;
         case VideoSettings::ForceVideoDecoderDirectX3D:
-            for(auto name : {"d3d11vp9dec", "d3d11h265dec", "d3d11h264dec"}) {
-                changeRank(name, GST_RANK_PRIMARY + 1);
-            }
+            forceHardwareFamily(directX3DDecoders);
             break;
         case VideoSettings::ForceVideoDecoderVideoToolbox:
-            changeRank("vtdec", GST_RANK_PRIMARY + 1);
+            forceHardwareFamily(videoToolboxDecoders);
             break;
         default:
             qCWarning(GStreamerLog) << "Can't handle decode option:" << option;
@@ -214,7 +237,10 @@ GStreamer::initialize(int argc, char* argv[], int debuglevel)
     GST_PLUGIN_STATIC_REGISTER(rtpmanager);
     GST_PLUGIN_STATIC_REGISTER(isomp4);
     GST_PLUGIN_STATIC_REGISTER(matroska);
+    GST_PLUGIN_STATIC_REGISTER(multifile);
     GST_PLUGIN_STATIC_REGISTER(mpegtsdemux);
+    GST_PLUGIN_STATIC_REGISTER(mpegtsmux);
+    GST_PLUGIN_STATIC_REGISTER(app);
     GST_PLUGIN_STATIC_REGISTER(opengl);
     GST_PLUGIN_STATIC_REGISTER(tcp);
 
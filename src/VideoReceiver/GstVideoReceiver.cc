@@ -19,10 +19,23 @@
 #include <QDebug>
 #include <QUrl>
 #include <QDateTime>
+#include <QFileInfo>
 #include <QSysInfo>
+#include <QImage>
+#include <QRunnable>
+
+#include <gst/video/video.h>
 
 QGC_LOGGING_CATEGORY(VideoReceiverLog, "VideoReceiverLog")
 
+QGC_INSTRUMENT_COUNTER  (VideoSourceFrames,             "Video.SourceFrames")
+QGC_INSTRUMENT_COUNTER  (VideoDecodedFrames,            "Video.DecodedFrames")
+QGC_INSTRUMENT_HISTOGRAM(VideoFrameInterval,            "Video.FrameInterval")
+QGC_INSTRUMENT_HISTOGRAM(VideoLatency,                  "Video.Latency")
+QGC_INSTRUMENT_COUNTER  (VideoDisplayDroppedFrames,     "Video.DisplayDroppedFrames")
+QGC_INSTRUMENT_COUNTER  (VideoRecordingDroppedFrames,   "Video.RecordingDroppedFrames")
+QGC_INSTRUMENT_COUNTER  (VideoSourceRestarts,           "Video.SourceRestarts")
+
 //-----------------------------------------------------------------------------
 // Our pipeline look like this:
 //
@@ -50,12 +63,32 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
     , _pipeline(nullptr)
     , _lastSourceFrameTime(0)
     , _lastVideoFrameTime(0)
+    , _latencySumNsecs(0)
+    , _latencyCount(0)
+    , _recordingSegmentBytes(0)
+    , _recordingSegmentSecs(0)
+    , _recordingDroppedFrames(0)
+    , _recordingMetadata(false)
+    , _recordingMetadataSrc(nullptr)
+    , _pendingMetadata(nullptr)
+    , _currentMetadata(nullptr)
+    , _screenshotCount(0)
+    , _screenshotActive(false)
+    , _screenshotFailed(false)
+    , _screenshotsToCapture(0)
+    , _screenshotsEncoding(0)
+    , _sourceRestarts(0)
+    , _nextDecoderInput(0)
+    , _previousSourceBytes(0)
+    , _previousSinkFrames(0)
+    , _previousSinkQosDropped(0)
     , _resetVideoSink(true)
     , _videoSinkProbeId(0)
     , _udpReconnect_us(5000000)
     , _signalDepth(0)
     , _endOfStream(false)
 {
+    _screenshotPool.setMaxThreadCount(_screenshotThreads);
     _slotHandler.start();
     connect(&_watchdogTimer, &QTimer::timeout, this, &GstVideoReceiver::_watchdog);
     _watchdogTimer.start(1000);
@@ -63,7 +96,38 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
 
 GstVideoReceiver::~GstVideoReceiver(void)
 {
+    _screenshotsToCapture = 0;
+    _screenshotPool.waitForDone();
     _slotHandler.shutdown();
+
+    GstBuffer* metadata;
+
+    if ((metadata = _pendingMetadata.fetchAndStoreOrdered(nullptr)) != nullptr) {
+        gst_buffer_unref(metadata);
+    }
+
+    if (_currentMetadata != nullptr) {
+        gst_buffer_unref(_currentMetadata);
+        _currentMetadata = nullptr;
+    }
+}
+
+void
+GstVideoReceiver::setRecordingMetadata(const QByteArray& klv)
+{
+    GstBuffer* metadata = gst_buffer_new_allocate(nullptr, static_cast<gsize>(klv.size()), nullptr);
+
+    if (metadata == nullptr) {
+        qCCritical(VideoReceiverLog) << "gst_buffer_new_allocate() failed" << _uri;
+        return;
+    }
+
+    gst_buffer_fill(metadata, 0, klv.constData(), static_cast<gsize>(klv.size()));
+
+    // Swapped in without a lock, a packet the recording never picked up is simply replaced
+    if ((metadata = _pendingMetadata.fetchAndStoreOrdered(metadata)) != nullptr) {
+        gst_buffer_unref(metadata);
+    }
 }
 
 void
@@ -100,6 +164,9 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
     qCDebug(VideoReceiverLog) << "Starting" << _uri << ", buffer" << _buffer;
 
     _endOfStream = false;
+    _sourceRestarts = 0;
+
+    _resetStatistics();
 
     bool running    = false;
     bool pipelineUp = false;
@@ -138,6 +205,26 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         g_object_set(_decoderValve, "drop", TRUE, nullptr);
 
+        if ((pad = gst_element_get_static_pad(_decoderValve, "src")) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_get_static_pad() failed";
+            break;
+        }
+
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _decoderInputProbe, this, nullptr);
+        gst_object_unref(pad);
+        pad = nullptr;
+
+        if (_buffer < 0) {
+            // Throw away the oldest video rather than let it pile up in front of a decoder which can't keep up. The
+            // picture may break up until the next keyframe, which beats falling further and further behind.
+            g_object_set(decoderQueue,
+                         "leaky",               2, // downstream
+                         "max-size-buffers",    0,
+                         "max-size-bytes",      0,
+                         "max-size-time",       static_cast<guint64>(_lowLatencyQueueMSecs) * GST_MSECOND,
+                         nullptr);
+        }
+
         if((recorderQueue = gst_element_factory_make("queue", nullptr)) == nullptr)  {
             qCCritical(VideoReceiverLog) << "gst_element_factory_make('queue') failed";
             break;
@@ -150,6 +237,18 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         g_object_set(_recorderValve, "drop", TRUE, nullptr);
 
+        // The recording branch must never hold up the display branch through the tee. A stalled disk is absorbed by a
+        // large in memory queue, and once that is full the oldest video is thrown away instead of blocking.
+        g_object_set(recorderQueue,
+                     "leaky",               2, // downstream
+                     "max-size-buffers",    0,
+                     "max-size-bytes",      _recordingQueueBytes,
+                     "max-size-time",       static_cast<guint64>(0),
+                     nullptr);
+
+        g_signal_connect(decoderQueue, "overrun", G_CALLBACK(_onDecoderQueueOverrun), this);
+        g_signal_connect(recorderQueue, "overrun", G_CALLBACK(_onRecorderQueueOverrun), this);
+
         if ((_pipeline = gst_pipeline_new("receiver")) == nullptr) {
             qCCritical(VideoReceiverLog) << "gst_pipeline_new() failed";
             break;
@@ -166,30 +265,7 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         pipelineUp = true;
 
-        GstPad* srcPad = nullptr;
-
-        GstIterator* it;
-
-        if ((it = gst_element_iterate_src_pads(_source)) != nullptr) {
-            GValue vpad = G_VALUE_INIT;
-
-            if (gst_iterator_next(it, &vpad) == GST_ITERATOR_OK) {
-                srcPad = GST_PAD(g_value_get_object(&vpad));
-                gst_object_ref(srcPad);
-                g_value_reset(&vpad);
-            }
-
-            gst_iterator_free(it);
-            it = nullptr;
-        }
-
-        if (srcPad != nullptr) {
-            _onNewSourcePad(srcPad);
-            gst_object_unref(srcPad);
-            srcPad = nullptr;
-        } else {
-            g_signal_connect(_source, "pad-added", G_CALLBACK(_onNewPad), this);
-        }
+        _linkSource();
 
         if(!gst_element_link_many(_tee, decoderQueue, _decoderValve, nullptr)) {
             qCCritical(VideoReceiverLog) << "Unable to link decoder queue";
@@ -413,6 +489,10 @@ GstVideoReceiver::startDecoding(void* sink)
     }
 
     _lastVideoFrameTime = 0;
+    _videoFrameIntervalTimer.invalidate();
+    _latencyReportTimer.invalidate();
+    _latencySumNsecs = 0;
+    _latencyCount = 0;
     _resetVideoSink = true;
 
     _videoSinkProbeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _videoSinkProbe, this, nullptr);
@@ -483,12 +563,12 @@ GstVideoReceiver::stopDecoding(void)
 }
 
 void
-GstVideoReceiver::startRecording(const QString& videoFile, FILE_FORMAT format)
+GstVideoReceiver::startRecording(const QString& videoFile, FILE_FORMAT format, quint64 segmentBytes, unsigned segmentSecs, bool metadata)
 {
     if (_needDispatch()) {
         QString cachedVideoFile = videoFile;
-        _slotHandler.dispatch([this, cachedVideoFile, format]() {
-            startRecording(cachedVideoFile, format);
+        _slotHandler.dispatch([this, cachedVideoFile, format, segmentBytes, segmentSecs, metadata]() {
+            startRecording(cachedVideoFile, format, segmentBytes, segmentSecs, metadata);
         });
         return;
     }
@@ -513,6 +593,11 @@ GstVideoReceiver::startRecording(const QString& videoFile, FILE_FORMAT format)
 
     qCDebug(VideoReceiverLog) << "New video file:" << videoFile <<  "" << _uri;
 
+    _recordingSegmentBytes = segmentBytes;
+    _recordingSegmentSecs = segmentSecs;
+    _recordingDroppedFrames = 0;
+    _recordingMetadata = metadata;
+
     if ((_fileSink = _makeFileSink(videoFile, format)) == nullptr) {
         qCCritical(VideoReceiverLog) << "_makeFileSink() failed" << _uri;
         _dispatchSignal([this](){
@@ -590,6 +675,10 @@ GstVideoReceiver::stopRecording(void)
 
     g_object_set(_recorderValve, "drop", TRUE, nullptr);
 
+    if (_recordingDroppedFrames.load() != 0) {
+        qCWarning(VideoReceiverLog) << "Recording dropped" << _recordingDroppedFrames.load() << "buffers" << _uri;
+    }
+
     _removingRecorder = true;
 
     bool ret = _unlinkBranch(_recorderValve);
@@ -601,27 +690,202 @@ GstVideoReceiver::stopRecording(void)
     });
 }
 
+// Writes one frame to an image file from the screenshot pool
+class ScreenshotTask : public QRunnable
+{
+public:
+    ScreenshotTask(GstSample* sample, const QString& imageFile, std::function<void(bool)> done)
+        : _sample(sample)
+        , _imageFile(imageFile)
+        , _done(done)
+    {}
+
+    void run() override
+    {
+        QImage image;
+
+        GstVideoInfo info;
+        GstVideoFrame frame;
+
+        if (!gst_video_info_from_caps(&info, gst_sample_get_caps(_sample))) {
+            qCCritical(VideoReceiverLog) << "gst_video_info_from_caps() failed" << _imageFile;
+        } else if (!gst_video_frame_map(&frame, &info, gst_sample_get_buffer(_sample), GST_MAP_READ)) {
+            // Mapping GL memory for reading downloads the texture
+            qCCritical(VideoReceiverLog) << "gst_video_frame_map() failed" << _imageFile;
+        } else {
+            QImage::Format format = QImage::Format_Invalid;
+
+            switch (GST_VIDEO_INFO_FORMAT(&info)) {
+            case GST_VIDEO_FORMAT_RGBA:
+                format = QImage::Format_RGBA8888;
+                break;
+            case GST_VIDEO_FORMAT_RGBx:
+                format = QImage::Format_RGBX8888;
+                break;
+            case GST_VIDEO_FORMAT_RGB:
+                format = QImage::Format_RGB888;
+                break;
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+            case GST_VIDEO_FORMAT_BGRA:
+                format = QImage::Format_ARGB32;
+                break;
+            case GST_VIDEO_FORMAT_BGRx:
+                format = QImage::Format_RGB32;
+                break;
+#endif
+            default:
+                qCCritical(VideoReceiverLog) << "Unsupported screenshot format" << gst_video_format_to_string(GST_VIDEO_INFO_FORMAT(&info));
+                break;
+            }
+
+            if (format != QImage::Format_Invalid) {
+                // Copied out so the buffer goes back to the video sink before the slow part
+                image = QImage(static_cast<const uchar*>(GST_VIDEO_FRAME_PLANE_DATA(&frame, 0)),
+                               GST_VIDEO_FRAME_WIDTH(&frame),
+                               GST_VIDEO_FRAME_HEIGHT(&frame),
+                               GST_VIDEO_FRAME_PLANE_STRIDE(&frame, 0),
+                               format).copy();
+            }
+
+            gst_video_frame_unmap(&frame);
+        }
+
+        gst_sample_unref(_sample);
+        _sample = nullptr;
+
+        bool success = false;
+
+        if (!image.isNull()) {
+            // The format comes from the file suffix
+            if (!(success = image.save(_imageFile))) {
+                qCCritical(VideoReceiverLog) << "Unable to write screenshot" << _imageFile;
+            } else {
+                qCDebug(VideoReceiverLog) << "Screenshot written" << _imageFile;
+            }
+        }
+
+        _done(success);
+    }
+
+private:
+    GstSample*                  _sample;
+    QString                     _imageFile;
+    std::function<void(bool)>   _done;
+};
+
 void
-GstVideoReceiver::takeScreenshot(const QString& imageFile)
+GstVideoReceiver::takeScreenshot(const QString& imageFile, unsigned count)
 {
     if (_needDispatch()) {
         QString cachedImageFile = imageFile;
-        _slotHandler.dispatch([this, cachedImageFile]() {
-            takeScreenshot(cachedImageFile);
+        _slotHandler.dispatch([this, cachedImageFile, count]() {
+            takeScreenshot(cachedImageFile, count);
         });
         return;
     }
 
-    // FIXME: AV: record screenshot here
-    _dispatchSignal([this](){
-        emit onTakeScreenshotComplete(STATUS_NOT_IMPLEMENTED);
+    if (!_decoding || _videoSink == nullptr) {
+        qCDebug(VideoReceiverLog) << "Not decoding!" << _uri;
+        _dispatchSignal([this](){
+            emit onTakeScreenshotComplete(STATUS_INVALID_STATE);
+        });
+        return;
+    }
+
+    if (_screenshotActive) {
+        qCDebug(VideoReceiverLog) << "Already taking screenshots!" << _uri;
+        _dispatchSignal([this](){
+            emit onTakeScreenshotComplete(STATUS_INVALID_STATE);
+        });
+        return;
+    }
+
+    qCDebug(VideoReceiverLog) << "Taking screenshots" << imageFile << count << _uri;
+
+    // The frames are taken as they reach the video sink. Nothing on this thread or the render thread waits on the
+    // download or the encoding.
+    _screenshotFile = imageFile;
+    _screenshotCount = qMax(1u, count);
+    _screenshotActive = true;
+    _screenshotFailed = false;
+    _screenshotsToCapture.storeRelease(static_cast<int>(_screenshotCount));
+}
+
+void
+GstVideoReceiver::_noteScreenshotFrame(GstPad* pad, GstBuffer* buf)
+{
+    if (_screenshotsToCapture.loadAcquire() <= 0 || buf == nullptr) {
+        return;
+    }
+
+    if (_screenshotsEncoding.load() >= _maxScreenshotsEncoding) {
+        qCDebug(VideoReceiverLog) << "Screenshot encoding behind, skipping frame";
+        return;
+    }
+
+    GstCaps* caps;
+
+    if ((caps = gst_pad_get_current_caps(pad)) == nullptr) {
+        return;
+    }
+
+    GstSample* sample = gst_sample_new(buf, caps, nullptr, nullptr);
+    gst_caps_unref(caps);
+    caps = nullptr;
+
+    // Counted as encoding before it stops being counted as to capture so the burst is never seen as finished early
+    _screenshotsEncoding.ref();
+    const unsigned index = _screenshotCount - static_cast<unsigned>(_screenshotsToCapture.fetchAndAddOrdered(-1));
+
+    QString imageFile = _screenshotFile;
+
+    if (index > 0) {
+        QFileInfo fileInfo(_screenshotFile);
+        imageFile = fileInfo.path() + "/" + fileInfo.completeBaseName() + QStringLiteral("_%1.").arg(index) + fileInfo.suffix();
+    }
+
+    _screenshotPool.start(new ScreenshotTask(sample, imageFile, [this](bool success) {
+        _slotHandler.dispatch([this, success]() {
+            _screenshotWritten(success);
+        });
+    }));
+}
+
+void
+GstVideoReceiver::_screenshotWritten(bool success)
+{
+    _screenshotsEncoding.deref();
+
+    if (!success) {
+        _screenshotFailed = true;
+    }
+
+    if (_screenshotsToCapture.loadAcquire() <= 0) {
+        _finishScreenshots();
+    }
+}
+
+void
+GstVideoReceiver::_finishScreenshots(void)
+{
+    if (!_screenshotActive || _screenshotsEncoding.load() > 0) {
+        return;
+    }
+
+    _screenshotActive = false;
+
+    const STATUS status = _screenshotFailed ? STATUS_FAIL : STATUS_OK;
+
+    _dispatchSignal([this, status](){
+        emit onTakeScreenshotComplete(status);
     });
 }
 
 const char* GstVideoReceiver::_kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN] = {
     "matroskamux",
     "qtmux",
-    "mp4mux"
+    "mp4mux",
+    "mpegtsmux"
 };
 
 void
@@ -640,10 +904,19 @@ GstVideoReceiver::_watchdog(void)
 
         if (now - _lastSourceFrameTime > _timeout) {
             qCDebug(VideoReceiverLog) << "Stream timeout, no frames for " << now - _lastSourceFrameTime << "" << _uri;
-            _dispatchSignal([this](){
-                emit timeout();
-            });
-            stop();
+
+            // A link bounce only needs a new source, the decoder and video sink can carry on from the next keyframe.
+            // If a few new sources in a row don't bring the stream back the whole pipeline is rebuilt.
+            if (_streaming && _sourceRestarts < _maxSourceRestarts && _restartSource()) {
+                _sourceRestarts.ref();
+                _lastSourceFrameTime = now;
+                _lastVideoFrameTime = 0;
+            } else {
+                _dispatchSignal([this](){
+                    emit timeout();
+                });
+                stop();
+            }
         }
 
         if (_decoding && !_removingDecoder) {
@@ -659,6 +932,114 @@ GstVideoReceiver::_watchdog(void)
                 stop();
             }
         }
+
+        if (_pipeline != nullptr) {
+            _updateStatistics();
+        }
+    });
+}
+
+void
+GstVideoReceiver::_resetStatistics(void)
+{
+    _sourceBytes            = 0;
+    _sinkFrames             = 0;
+    _displayDroppedFrames   = 0;
+    _decoderQosDropped      = 0;
+    _sinkQosDropped         = 0;
+    _qosLateFrames          = 0;
+    _decodeLatencyUSecs     = 0;
+    _decodeLatencyCount     = 0;
+
+    {
+        QMutexLocker lock(&_decoderInputMutex);
+        for (DecoderInput_t& decoderInput: _decoderInputs) {
+            decoderInput.pts = GST_CLOCK_TIME_NONE;
+        }
+        _nextDecoderInput = 0;
+    }
+
+    _previousSourceBytes    = 0;
+    _previousSinkFrames     = 0;
+    _previousSinkQosDropped = 0;
+    _statisticsTimer.start();
+}
+
+void
+GstVideoReceiver::_updateStatistics(void)
+{
+    const double elapsedSecs = _statisticsTimer.restart() / 1000.0;
+
+    if (elapsedSecs <= 0) {
+        return;
+    }
+
+    const quint64 sourceBytes       = _sourceBytes.load();
+    const quint64 sinkFrames        = _sinkFrames.load();
+    const quint64 sinkQosDropped    = _sinkQosDropped.load();
+    const quint64 sinkDropped       = sinkQosDropped - qMin(sinkQosDropped, _previousSinkQosDropped);
+    const quint64 decodedFrames     = sinkFrames - _previousSinkFrames;
+    const quint64 decodeLatencyUSecs = _decodeLatencyUSecs.fetchAndStoreRelaxed(0);
+    const quint64 decodeLatencyCount = _decodeLatencyCount.fetchAndStoreRelaxed(0);
+
+    QVariantMap statistics;
+
+    statistics[QStringLiteral("inputBitrate")]  = (sourceBytes - _previousSourceBytes) * 8 / elapsedSecs;
+    statistics[QStringLiteral("decodeFps")]     = decodedFrames / elapsedSecs;
+    statistics[QStringLiteral("renderFps")]     = (decodedFrames - qMin(decodedFrames, sinkDropped)) / elapsedSecs;
+    statistics[QStringLiteral("droppedFrames")] = _displayDroppedFrames.load() + _decoderQosDropped.load() + sinkQosDropped;
+    statistics[QStringLiteral("lateFrames")]    = _qosLateFrames.load();
+    statistics[QStringLiteral("decodeLatency")] = decodeLatencyCount ? static_cast<double>(decodeLatencyUSecs) / decodeLatencyCount / 1000.0 : 0.0;
+
+    _previousSourceBytes    = sourceBytes;
+    _previousSinkFrames     = sinkFrames;
+    _previousSinkQosDropped = sinkQosDropped;
+
+    // The jitter buffer is either ours in the source bin or the one rtspsrc creates inside its rtpbin
+    guint   jitterBufferLatency = 0;
+    double  jitter              = 0;
+    quint64 lostPackets         = 0;
+
+    GstIterator* it = gst_bin_iterate_recurse(GST_BIN(_pipeline));
+
+    if (it != nullptr) {
+        GValue value = G_VALUE_INIT;
+
+        while (gst_iterator_next(it, &value) == GST_ITERATOR_OK) {
+            GstElement*         element = GST_ELEMENT(g_value_get_object(&value));
+            GstElementFactory*  factory = gst_element_get_factory(element);
+
+            if (factory != nullptr && g_strcmp0(GST_OBJECT_NAME(factory), "rtpjitterbuffer") == 0) {
+                GstStructure* stats = nullptr;
+
+                g_object_get(element, "latency", &jitterBufferLatency, "stats", &stats, nullptr);
+
+                if (stats != nullptr) {
+                    guint64 numLost     = 0;
+                    guint64 avgJitter   = 0;
+
+                    gst_structure_get_uint64(stats, "num-lost", &numLost);
+                    gst_structure_get_uint64(stats, "avg-jitter", &avgJitter);
+                    lostPackets += numLost;
+                    jitter = qMax(jitter, avgJitter / 1000000.0);
+                    gst_structure_free(stats);
+                }
+            }
+
+            g_value_reset(&value);
+        }
+
+        g_value_unset(&value);
+        gst_iterator_free(it);
+        it = nullptr;
+    }
+
+    statistics[QStringLiteral("jitterBufferLatency")]   = jitterBufferLatency;
+    statistics[QStringLiteral("jitter")]                = jitter;
+    statistics[QStringLiteral("lostPackets")]           = lostPackets;
+
+    _dispatchSignal([this, statistics](){
+        emit statisticsChanged(statistics);
     });
 }
 
@@ -701,6 +1082,7 @@ GstVideoReceiver::_makeSource(const QString& uri)
     GstElement* source  = nullptr;
     GstElement* buffer  = nullptr;
     GstElement* tsdemux = nullptr;
+    GstElement* queue   = nullptr;
     GstElement* parser  = nullptr;
     GstElement* bin     = nullptr;
     GstElement* srcbin  = nullptr;
@@ -715,8 +1097,18 @@ GstVideoReceiver::_makeSource(const QString& uri)
         } else if (isRtsp) {
             if ((source = gst_element_factory_make("rtspsrc", "source")) != nullptr) {
                 g_object_set(static_cast<gpointer>(source), "location", qPrintable(uri), "latency", 17, "udp-reconnect", 1, "timeout", _udpReconnect_us, NULL);
+                if (_buffer < 0) {
+                    g_object_set(static_cast<gpointer>(source), "latency", 0, "drop-on-latency", TRUE, nullptr);
+                } else if (_buffer > 0) {
+                    g_object_set(static_cast<gpointer>(source), "latency", _buffer, "drop-on-latency", TRUE, nullptr);
+                }
             }
-        } else if(isUdp264 || isUdp265 || isUdpMPEGTS || isTaisync) {
+        } else if (isTaisync) {
+            // The radio connects to us and sends a raw h.264 byte stream, which goes straight into the pipeline
+            if ((source = gst_element_factory_make("tcpserversrc", "source")) != nullptr) {
+                g_object_set(static_cast<gpointer>(source), "host", qPrintable(url.host()), "port", url.port(), nullptr);
+            }
+        } else if(isUdp264 || isUdp265 || isUdpMPEGTS) {
             if ((source = gst_element_factory_make("udpsrc", "source")) != nullptr) {
                 g_object_set(static_cast<gpointer>(source), "uri", QString("udp://%1:%2").arg(qPrintable(url.host()), QString::number(url.port())).toUtf8().data(), nullptr);
 
@@ -780,6 +1172,27 @@ GstVideoReceiver::_makeSource(const QString& uri)
             tsdemux = nullptr;
         }
 
+        // The byte stream has no timestamps, so it is bounded by size. When the decoder falls behind the oldest data
+        // goes instead of latency building up in the socket.
+        if (isTaisync) {
+            if ((queue = gst_element_factory_make("queue", nullptr)) == nullptr) {
+                qCCritical(VideoReceiverLog) << "gst_element_factory_make('queue') failed";
+                break;
+            }
+
+            g_object_set(queue, "max-size-buffers", 0, "max-size-time", G_GUINT64_CONSTANT(0), "max-size-bytes", _taisyncQueueBytes, "leaky", 2, nullptr);
+
+            gst_bin_add(GST_BIN(bin), queue);
+
+            if (!gst_element_link(source, queue)) {
+                qCCritical(VideoReceiverLog) << "gst_element_link() failed";
+                break;
+            }
+
+            source = queue;
+            queue = nullptr;
+        }
+
         int probeRes = 0;
 
         gst_element_foreach_src_pad(source, _padProbe, &probeRes);
@@ -791,6 +1204,11 @@ GstVideoReceiver::_makeSource(const QString& uri)
                     break;
                 }
 
+                if (_buffer > 0) {
+                    // Late packets are dropped rather than holding back the frames behind them
+                    g_object_set(buffer, "latency", _buffer, "drop-on-latency", TRUE, nullptr);
+                }
+
                 gst_bin_add(GST_BIN(bin), buffer);
 
                 if (!gst_element_link_many(source, buffer, parser, nullptr)) {
@@ -809,7 +1227,7 @@ GstVideoReceiver::_makeSource(const QString& uri)
 
         g_signal_connect(parser, "pad-added", G_CALLBACK(_wrapWithGhostPad), nullptr);
 
-        source = tsdemux = buffer = parser = nullptr;
+        source = tsdemux = queue = buffer = parser = nullptr;
 
         srcbin = bin;
         bin = nullptr;
@@ -830,6 +1248,11 @@ GstVideoReceiver::_makeSource(const QString& uri)
         tsdemux = nullptr;
     }
 
+    if (queue != nullptr) {
+        gst_object_unref(queue);
+        queue = nullptr;
+    }
+
     if (buffer != nullptr) {
         gst_object_unref(buffer);
         buffer = nullptr;
@@ -855,6 +1278,9 @@ GstVideoReceiver::_makeDecoder(GstCaps* caps, GstElement* videoSink)
             qCCritical(VideoReceiverLog) << "gst_element_factory_make('decodebin3') failed";
             break;
         }
+
+        // Reports which decoder decodebin3 picked from the ranks set up by GStreamer::blacklist
+        g_signal_connect(decoder, "deep-element-added", G_CALLBACK(_onDeepElementAdded), this);
     } while(0);
 
     return decoder;
@@ -866,6 +1292,7 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
     GstElement* fileSink = nullptr;
     GstElement* mux = nullptr;
     GstElement* sink = nullptr;
+    GstElement* splitMux = nullptr;
     GstElement* bin = nullptr;
     bool releaseElements = true;
 
@@ -885,7 +1312,29 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
             break;
         }
 
-        g_object_set(static_cast<gpointer>(sink), "location", qPrintable(videoFile), nullptr);
+        // Write in large blocks, and don't hold up state changes of the pipeline waiting on the disk
+        g_object_set(static_cast<gpointer>(sink), "buffer-size", _recordingBlockBytes, "async", FALSE, nullptr);
+        gst_util_set_object_arg(G_OBJECT(sink), "buffer-mode", "full");
+
+        // splitmuxsink closes a file and starts the next one at a keyframe once a segment limit is reached, so each
+        // segment plays back on its own. Without limits everything goes to a single file.
+        if ((splitMux = gst_element_factory_make("splitmuxsink", nullptr)) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_factory_make('splitmuxsink') failed";
+            break;
+        }
+
+        g_object_set(static_cast<gpointer>(splitMux),
+                     "muxer",           mux,
+                     "sink",            sink,
+                     "max-size-bytes",  _recordingSegmentBytes,
+                     "max-size-time",   _recordingSegmentSecs * GST_SECOND,
+                     nullptr);
+
+        // Ownership has moved to splitmuxsink
+        mux = sink = nullptr;
+
+        _recordingFile = videoFile;
+        g_signal_connect(splitMux, "format-location", G_CALLBACK(_onFormatRecordingLocation), this);
 
         if ((bin = gst_bin_new("sinkbin")) == nullptr) {
             qCCritical(VideoReceiverLog) << "gst_bin_new('sinkbin') failed";
@@ -894,20 +1343,20 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
 
         GstPadTemplate* padTemplate;
 
-        if ((padTemplate = gst_element_class_get_pad_template(GST_ELEMENT_GET_CLASS(mux), "video_%u")) == nullptr) {
-            qCCritical(VideoReceiverLog) << "gst_element_class_get_pad_template(mux) failed";
+        if ((padTemplate = gst_element_class_get_pad_template(GST_ELEMENT_GET_CLASS(splitMux), "video")) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_class_get_pad_template(splitmuxsink) failed";
             break;
         }
 
         // FIXME: AV: pad handling is potentially leaking (and other similar places too!)
         GstPad* pad;
 
-        if ((pad = gst_element_request_pad(mux, padTemplate, nullptr, nullptr)) == nullptr) {
-            qCCritical(VideoReceiverLog) << "gst_element_request_pad(mux) failed";
+        if ((pad = gst_element_request_pad(splitMux, padTemplate, nullptr, nullptr)) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_request_pad(splitmuxsink) failed";
             break;
         }
 
-        gst_bin_add_many(GST_BIN(bin), mux, sink, nullptr);
+        gst_bin_add(GST_BIN(bin), splitMux);
 
         releaseElements = false;
 
@@ -918,9 +1367,50 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
         gst_object_unref(pad);
         pad = nullptr;
 
-        if (!gst_element_link(mux, sink)) {
-            qCCritical(VideoReceiverLog) << "gst_element_link() failed";
-            break;
+        // MISB ST 0601 carries KLV in MPEG-TS, the other containers have no place for it
+        if (_recordingMetadata && format == FILE_FORMAT_TS) {
+            GstElement* metadataSrc;
+
+            if ((metadataSrc = gst_element_factory_make("appsrc", "klvsrc")) == nullptr) {
+                qCCritical(VideoReceiverLog) << "gst_element_factory_make('appsrc') failed";
+                break;
+            }
+
+            GstCaps* caps = gst_caps_from_string("meta/x-klv, parsed=(boolean)true");
+
+            // Never blocks the recorded video, packets are thrown away if the muxer falls behind
+            g_object_set(static_cast<gpointer>(metadataSrc),
+                         "caps",        caps,
+                         "format",      GST_FORMAT_TIME,
+                         "is-live",     TRUE,
+                         "block",       FALSE,
+                         "max-bytes",   static_cast<guint64>(_recordingMetadataBytes),
+                         nullptr);
+            gst_caps_unref(caps);
+            caps = nullptr;
+
+            gst_bin_add(GST_BIN(bin), metadataSrc);
+
+            // splitmuxsink falls back to the sink_%d pads of mpegtsmux for its subtitle pads
+            if ((pad = gst_element_get_request_pad(splitMux, "subtitle_%u")) == nullptr) {
+                qCCritical(VideoReceiverLog) << "gst_element_get_request_pad(splitmuxsink, 'subtitle_%u') failed";
+                break;
+            }
+
+            GstPad* metadataPad = gst_element_get_static_pad(metadataSrc, "src");
+            GstPadLinkReturn linked = gst_pad_link(metadataPad, pad);
+            gst_object_unref(metadataPad);
+            gst_object_unref(pad);
+            pad = nullptr;
+
+            if (linked != GST_PAD_LINK_OK) {
+                qCCritical(VideoReceiverLog) << "Unable to link KLV metadata source" << linked;
+                break;
+            }
+
+            _recordingMetadataSrc = metadataSrc;
+            gst_segment_init(&_recordingSegment, GST_FORMAT_TIME);
+            gst_pad_add_probe(ghostpad, static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM), _recordingMetadataProbe, this, nullptr);
         }
 
         fileSink = bin;
@@ -937,6 +1427,11 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
             gst_object_unref(mux);
             mux = nullptr;
         }
+
+        if (splitMux != nullptr) {
+            gst_object_unref(splitMux);
+            splitMux = nullptr;
+        }
     }
 
     if (bin != nullptr) {
@@ -947,6 +1442,83 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
     return fileSink;
 }
 
+void
+GstVideoReceiver::_linkSource(void)
+{
+    GstPad* srcPad = nullptr;
+
+    GstIterator* it;
+
+    if ((it = gst_element_iterate_src_pads(_source)) != nullptr) {
+        GValue vpad = G_VALUE_INIT;
+
+        if (gst_iterator_next(it, &vpad) == GST_ITERATOR_OK) {
+            srcPad = GST_PAD(g_value_get_object(&vpad));
+            gst_object_ref(srcPad);
+            g_value_reset(&vpad);
+        }
+
+        gst_iterator_free(it);
+        it = nullptr;
+    }
+
+    if (srcPad != nullptr) {
+        _onNewSourcePad(srcPad);
+        gst_object_unref(srcPad);
+        srcPad = nullptr;
+    } else {
+        g_signal_connect(_source, "pad-added", G_CALLBACK(_onNewPad), this);
+    }
+}
+
+bool
+GstVideoReceiver::_restartSource(void)
+{
+    qCDebug(VideoReceiverLog) << "Restarting source" << _uri;
+
+    GstElement* source;
+
+    if ((source = _makeSource(_uri)) == nullptr) {
+        qCCritical(VideoReceiverLog) << "_makeSource() failed" << _uri;
+        return false;
+    }
+
+    GstPad* teePad;
+
+    if ((teePad = gst_element_get_static_pad(_tee, "sink")) == nullptr) {
+        qCCritical(VideoReceiverLog) << "gst_element_get_static_pad() failed" << _uri;
+        gst_object_unref(source);
+        return false;
+    }
+
+    g_signal_handlers_disconnect_by_data(_source, this);
+    gst_element_unlink(_source, _tee);
+    gst_element_set_state(_source, GST_STATE_NULL);
+    gst_bin_remove(GST_BIN(_pipeline), _source);
+
+    // Whatever sits in the decoder from the old stream is useless as a reference, so nothing goes past the tee until
+    // the new source delivers a keyframe
+    gst_pad_add_probe(teePad, GST_PAD_PROBE_TYPE_BUFFER, _sourceKeyframeProbe, this, nullptr);
+    gst_object_unref(teePad);
+    teePad = nullptr;
+
+    _source = source;
+    gst_bin_add(GST_BIN(_pipeline), _source);
+
+    _linkSource();
+
+    if (!gst_element_sync_state_with_parent(_source)) {
+        qCCritical(VideoReceiverLog) << "gst_element_sync_state_with_parent() failed" << _uri;
+        return false;
+    }
+
+    QGC_INSTRUMENT_ADD(VideoSourceRestarts, 1);
+
+    GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_pipeline), GST_DEBUG_GRAPH_SHOW_ALL, "pipeline-with-new-source");
+
+    return true;
+}
+
 void
 GstVideoReceiver::_onNewSourcePad(GstPad* pad)
 {
@@ -966,7 +1538,8 @@ GstVideoReceiver::_onNewSourcePad(GstPad* pad)
 
     gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, _eosProbe, this, nullptr);
 
-    if (_videoSink == nullptr) {
+    // After a source restart the decoding branch is still in place
+    if (_videoSink == nullptr || _decoder != nullptr) {
         return;
     }
 
@@ -1122,12 +1695,147 @@ void
 GstVideoReceiver::_noteTeeFrame(void)
 {
     _lastSourceFrameTime = QDateTime::currentSecsSinceEpoch();
+    QGC_INSTRUMENT_ADD(VideoSourceFrames, 1);
+}
+
+void
+GstVideoReceiver::_noteDecoderInput(GstBuffer* buf)
+{
+    if (!GST_BUFFER_PTS_IS_VALID(buf)) {
+        return;
+    }
+
+    QMutexLocker lock(&_decoderInputMutex);
+
+    DecoderInput_t& decoderInput = _decoderInputs[_nextDecoderInput];
+
+    decoderInput.pts    = GST_BUFFER_PTS(buf);
+    decoderInput.usecs  = g_get_monotonic_time();
+    _nextDecoderInput   = (_nextDecoderInput + 1) % _decoderInputCount;
+}
+
+void
+GstVideoReceiver::_noteDecoderOutput(GstBuffer* buf)
+{
+    // Decoders keep the timestamp of the encoded frame, which may have gone in out of order
+    if (buf == nullptr || !GST_BUFFER_PTS_IS_VALID(buf)) {
+        return;
+    }
+
+    gint64 inputUSecs = 0;
+
+    {
+        QMutexLocker lock(&_decoderInputMutex);
+
+        for (DecoderInput_t& decoderInput: _decoderInputs) {
+            if (decoderInput.pts == GST_BUFFER_PTS(buf)) {
+                inputUSecs = decoderInput.usecs;
+                decoderInput.pts = GST_CLOCK_TIME_NONE;
+                break;
+            }
+        }
+    }
+
+    if (inputUSecs != 0) {
+        _decodeLatencyUSecs.fetchAndAddRelaxed(static_cast<quint64>(g_get_monotonic_time() - inputUSecs));
+        _decodeLatencyCount.fetchAndAddRelaxed(1);
+    }
+}
+
+void
+GstVideoReceiver::_noteRecordingFrame(GstPad* pad, GstPadProbeInfo* info)
+{
+    Q_UNUSED(pad)
+
+    if (_recordingMetadataSrc == nullptr) {
+        return;
+    }
+
+    if (info->type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+        GstEvent* event = gst_pad_probe_info_get_event(info);
+
+        if (GST_EVENT_TYPE(event) == GST_EVENT_SEGMENT) {
+            const GstSegment* segment;
+            gst_event_parse_segment(event, &segment);
+            gst_segment_copy_into(segment, &_recordingSegment);
+        } else if (GST_EVENT_TYPE(event) == GST_EVENT_EOS) {
+            // The muxer only finishes the file once every stream has ended
+            GstFlowReturn ret;
+            g_signal_emit_by_name(_recordingMetadataSrc, "end-of-stream", &ret);
+        }
+
+        return;
+    }
+
+    GstBuffer* metadata;
+
+    if ((metadata = _pendingMetadata.fetchAndStoreAcquire(nullptr)) != nullptr) {
+        if (_currentMetadata != nullptr) {
+            gst_buffer_unref(_currentMetadata);
+        }
+        _currentMetadata = metadata;
+    }
+
+    GstBuffer* buf = gst_pad_probe_info_get_buffer(info);
+
+    if (_currentMetadata == nullptr || buf == nullptr || !GST_BUFFER_PTS_IS_VALID(buf)) {
+        return;
+    }
+
+    // The appsrc segment starts at zero, so the running time of the frame is the timestamp of its packet
+    const GstClockTime runningTime = gst_segment_to_running_time(&_recordingSegment, GST_FORMAT_TIME, GST_BUFFER_PTS(buf));
+
+    if (!GST_CLOCK_TIME_IS_VALID(runningTime)) {
+        return;
+    }
+
+    // Shares the memory of the packet, only the timestamps are new
+    metadata = gst_buffer_copy(_currentMetadata);
+    GST_BUFFER_PTS(metadata)        = runningTime;
+    GST_BUFFER_DTS(metadata)        = runningTime;
+    GST_BUFFER_DURATION(metadata)   = GST_BUFFER_DURATION(buf);
+
+    GstFlowReturn ret;
+    g_signal_emit_by_name(_recordingMetadataSrc, "push-buffer", metadata, &ret);
+    gst_buffer_unref(metadata);
+}
+
+void
+GstVideoReceiver::_noteQos(GstMessage* msg)
+{
+    GstFormat   format;
+    guint64     processed   = 0;
+    guint64     dropped     = 0;
+
+    gst_message_parse_qos_stats(msg, &format, &processed, &dropped);
+
+    _qosLateFrames.fetchAndAddRelaxed(1);
+
+    if (format != GST_FORMAT_BUFFERS) {
+        return;
+    }
+
+    // The counts in QoS reports are totals for the element which sent them
+    GstObject* source = GST_MESSAGE_SRC(msg);
+
+    if (_videoSink != nullptr && (source == GST_OBJECT(_videoSink) || gst_object_has_as_ancestor(source, GST_OBJECT(_videoSink)))) {
+        _sinkQosDropped = dropped;
+    } else {
+        _decoderQosDropped = dropped;
+    }
 }
 
 void
 GstVideoReceiver::_noteVideoSinkFrame(void)
 {
     _lastVideoFrameTime = QDateTime::currentSecsSinceEpoch();
+    QGC_INSTRUMENT_ADD(VideoDecodedFrames, 1);
+    _sinkFrames.fetchAndAddRelaxed(1);
+    // Spread of the interval between frames is what shows up as stutter on screen
+    if (_videoFrameIntervalTimer.isValid()) {
+        QGC_INSTRUMENT_SAMPLE(VideoFrameInterval, static_cast<quint64>(_videoFrameIntervalTimer.nsecsElapsed() / 1000));
+    }
+    _videoFrameIntervalTimer.start();
     if (!_decoding) {
         _decoding = true;
         qCDebug(VideoReceiverLog) << "Decoding started";
@@ -1137,6 +1845,91 @@ GstVideoReceiver::_noteVideoSinkFrame(void)
     }
 }
 
+void
+GstVideoReceiver::_noteVideoSinkCaps(GstPad* pad)
+{
+    GstCaps* caps = gst_pad_get_current_caps(pad);
+
+    if (caps == nullptr) {
+        return;
+    }
+
+    // glupload takes GL and DMABuf memory from the decoder as is, system memory means the frames are copied on upload
+    GstCapsFeatures* features = gst_caps_get_features(caps, 0);
+
+    if (features != nullptr && gst_caps_features_contains(features, "memory:GLMemory")) {
+        qCDebug(VideoReceiverLog) << "Decoded frames reach the video sink in GL memory" << _uri;
+    } else if (features != nullptr && gst_caps_features_contains(features, "memory:DMABuf")) {
+        qCDebug(VideoReceiverLog) << "Decoded frames reach the video sink in DMABuf memory" << _uri;
+    } else {
+        qCDebug(VideoReceiverLog) << "Decoded frames reach the video sink in system memory" << _uri;
+    }
+
+    gst_caps_unref(caps);
+    caps = nullptr;
+}
+
+void
+GstVideoReceiver::_noteVideoSinkLatency(GstPad* pad, GstBuffer* buf)
+{
+    // Live sources stamp each buffer with the running time it arrived at, so how far the pipeline running time has
+    // moved on since then is the time the frame spent in the jitter buffer, parser, queue and decoder.
+    if (buf == nullptr || !GST_BUFFER_PTS_IS_VALID(buf)) {
+        return;
+    }
+
+    GstEvent* segmentEvent = gst_pad_get_sticky_event(pad, GST_EVENT_SEGMENT, 0);
+
+    if (segmentEvent == nullptr) {
+        return;
+    }
+
+    const GstSegment* segment = nullptr;
+    gst_event_parse_segment(segmentEvent, &segment);
+    const GstClockTime frameRunningTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buf));
+    gst_event_unref(segmentEvent);
+    segmentEvent = nullptr;
+
+    GstClock* clock = gst_element_get_clock(_pipeline);
+
+    if (clock == nullptr || !GST_CLOCK_TIME_IS_VALID(frameRunningTime)) {
+        if (clock != nullptr) {
+            gst_object_unref(clock);
+        }
+        return;
+    }
+
+    const GstClockTime runningTime = gst_clock_get_time(clock) - gst_element_get_base_time(_pipeline);
+    gst_object_unref(clock);
+    clock = nullptr;
+
+    if (runningTime < frameRunningTime) {
+        // Not a live timestamp, a file or a stream carrying its own timeline
+        return;
+    }
+
+    const qint64 latencyNsecs = static_cast<qint64>(runningTime - frameRunningTime);
+
+    QGC_INSTRUMENT_SAMPLE(VideoLatency, static_cast<quint64>(latencyNsecs / 1000));
+
+    _latencySumNsecs += latencyNsecs;
+    _latencyCount++;
+
+    if (!_latencyReportTimer.isValid()) {
+        _latencyReportTimer.start();
+    } else if (_latencyReportTimer.elapsed() >= _latencyReportMSecs) {
+        const int latency = static_cast<int>(_latencySumNsecs / _latencyCount / 1000000);
+
+        _latencySumNsecs = 0;
+        _latencyCount = 0;
+        _latencyReportTimer.start();
+
+        _dispatchSignal([this, latency](){
+            emit latencyChanged(latency);
+        });
+    }
+}
+
 void
 GstVideoReceiver::_noteEndOfStream(void)
 {
@@ -1219,7 +2012,14 @@ GstVideoReceiver::_shutdownDecodingBranch(void)
         _videoSinkProbeId = 0;
     }
 
+    // Frames which never came are counted as failed
+    if (_screenshotsToCapture.fetchAndStoreOrdered(0) > 0) {
+        _screenshotFailed = true;
+    }
+    _finishScreenshots();
+
     _lastVideoFrameTime = 0;
+    _videoFrameIntervalTimer.invalidate();
 
     GstObject* parent;
 
@@ -1253,6 +2053,12 @@ GstVideoReceiver::_shutdownRecordingBranch(void)
     gst_element_set_state(_fileSink, GST_STATE_NULL);
     gst_object_unref(_fileSink);
     _fileSink = nullptr;
+    _recordingMetadataSrc = nullptr;
+
+    if (_currentMetadata != nullptr) {
+        gst_buffer_unref(_currentMetadata);
+        _currentMetadata = nullptr;
+    }
 
     _removingRecorder = false;
 
@@ -1319,6 +2125,9 @@ GstVideoReceiver::_onBusMessage(GstBus* bus, GstMessage* msg, gpointer data)
             pThis->_handleEOS();
         });
         break;
+    case GST_MESSAGE_QOS:
+        pThis->_noteQos(msg);
+        break;
     case GST_MESSAGE_ELEMENT:
         do {
             const GstStructure* s = gst_message_get_structure (msg);
@@ -1367,6 +2176,98 @@ GstVideoReceiver::_onNewPad(GstElement* element, GstPad* pad, gpointer data)
     }
 }
 
+void
+GstVideoReceiver::_onDeepElementAdded(GstBin* bin, GstBin* subBin, GstElement* element, gpointer data)
+{
+    Q_UNUSED(bin)
+    Q_UNUSED(subBin)
+
+    GstElementFactory* factory = gst_element_get_factory(element);
+
+    if (factory == nullptr) {
+        return;
+    }
+
+    const gchar* klass = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+
+    if (klass == nullptr || strstr(klass, "Decoder") == nullptr || strstr(klass, "Video") == nullptr) {
+        return;
+    }
+
+    GstVideoReceiver* self = static_cast<GstVideoReceiver*>(data);
+
+    qCDebug(VideoReceiverLog) << "Using video decoder" << GST_OBJECT_NAME(factory)
+                              << (strstr(klass, "Hardware") != nullptr ? "(hardware)" : "")
+                              << "rank" << gst_plugin_feature_get_rank(GST_PLUGIN_FEATURE(factory)) << self->_uri;
+
+    if (self->_buffer < 0) {
+        self->_setLowDelayDecode(element);
+    }
+}
+
+void
+GstVideoReceiver::_setLowDelayDecode(GstElement* element)
+{
+    GObjectClass* objectClass = G_OBJECT_GET_CLASS(element);
+
+    // Hardware decoders which can hold back frames for reordering have a low-latency switch
+    if (g_object_class_find_property(objectClass, "low-latency") != nullptr) {
+        g_object_set(element, "low-latency", TRUE, nullptr);
+        qCDebug(VideoReceiverLog) << "Decoder low latency enabled" << _uri;
+    }
+
+    // Frame threading in the software decoders delays each frame by one per thread, slice threading does not
+    if (g_object_class_find_property(objectClass, "thread-type") != nullptr) {
+        gst_util_set_object_arg(G_OBJECT(element), "thread-type", "slice");
+        qCDebug(VideoReceiverLog) << "Decoder slice threading enabled" << _uri;
+    }
+}
+
+gchar*
+GstVideoReceiver::_onFormatRecordingLocation(GstElement* splitMux, guint fragmentId, gpointer data)
+{
+    Q_UNUSED(splitMux)
+
+    GstVideoReceiver* self = static_cast<GstVideoReceiver*>(data);
+
+    // The first segment keeps the requested name so it still pairs with the subtitle file
+    if (fragmentId == 0) {
+        return g_strdup(qPrintable(self->_recordingFile));
+    }
+
+    QFileInfo fileInfo(self->_recordingFile);
+    QString segmentFile = fileInfo.path() + "/" + fileInfo.completeBaseName() + QStringLiteral("_%1.").arg(fragmentId) + fileInfo.suffix();
+
+    qCDebug(VideoReceiverLog) << "New recording segment" << segmentFile;
+
+    return g_strdup(qPrintable(segmentFile));
+}
+
+void
+GstVideoReceiver::_onDecoderQueueOverrun(GstElement* queue, gpointer data)
+{
+    Q_UNUSED(queue)
+
+    GstVideoReceiver* self = static_cast<GstVideoReceiver*>(data);
+
+    QGC_INSTRUMENT_ADD(VideoDisplayDroppedFrames, 1);
+    self->_displayDroppedFrames.fetchAndAddRelaxed(1);
+}
+
+void
+GstVideoReceiver::_onRecorderQueueOverrun(GstElement* queue, gpointer data)
+{
+    Q_UNUSED(queue)
+
+    GstVideoReceiver* self = static_cast<GstVideoReceiver*>(data);
+
+    QGC_INSTRUMENT_ADD(VideoRecordingDroppedFrames, 1);
+
+    if (self->_recordingDroppedFrames.fetchAndAddRelaxed(1) == 0) {
+        qCWarning(VideoReceiverLog) << "Recording is falling behind, dropping video" << self->_uri;
+    }
+}
+
 void
 GstVideoReceiver::_wrapWithGhostPad(GstElement* element, GstPad* pad, gpointer data)
 {
@@ -1449,11 +2350,11 @@ GstPadProbeReturn
 GstVideoReceiver::_teeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
     Q_UNUSED(pad)
-    Q_UNUSED(info)
 
     if(user_data != nullptr) {
         GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
         pThis->_noteTeeFrame();
+        pThis->_sourceBytes.fetchAndAddRelaxed(gst_buffer_get_size(gst_pad_probe_info_get_buffer(info)));
     }
 
     return GST_PAD_PROBE_OK;
@@ -1470,6 +2371,7 @@ GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer u
 
         if (pThis->_resetVideoSink) {
             pThis->_resetVideoSink = false;
+            pThis->_noteVideoSinkCaps(pad);
 
 // FIXME: AV: this makes MPEG2-TS playing smooth but breaks RTSP
 //            gst_pad_send_event(pad, gst_event_new_flush_start());
@@ -1496,6 +2398,33 @@ GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer u
         }
 
         pThis->_noteVideoSinkFrame();
+        pThis->_noteVideoSinkLatency(pad, gst_pad_probe_info_get_buffer(info));
+        pThis->_noteDecoderOutput(gst_pad_probe_info_get_buffer(info));
+        pThis->_noteScreenshotFrame(pad, gst_pad_probe_info_get_buffer(info));
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn
+GstVideoReceiver::_decoderInputProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+
+    if(user_data != nullptr) {
+        GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+        pThis->_noteDecoderInput(gst_pad_probe_info_get_buffer(info));
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn
+GstVideoReceiver::_recordingMetadataProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    if(info != nullptr && user_data != nullptr) {
+        GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+        pThis->_noteRecordingFrame(pad, info);
     }
 
     return GST_PAD_PROBE_OK;
@@ -1519,6 +2448,31 @@ GstVideoReceiver::_eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_da
     return GST_PAD_PROBE_OK;
 }
 
+GstPadProbeReturn
+GstVideoReceiver::_sourceKeyframeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+
+    if (info == nullptr || user_data == nullptr) {
+        qCCritical(VideoReceiverLog) << "Invalid arguments";
+        return GST_PAD_PROBE_DROP;
+    }
+
+    GstBuffer* buf = gst_pad_probe_info_get_buffer(info);
+
+    if (GST_BUFFER_FLAG_IS_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT)) { // wait for a keyframe
+        return GST_PAD_PROBE_DROP;
+    }
+
+    GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+
+    qCDebug(VideoReceiverLog) << "Got keyframe from restarted source" << pThis->_uri;
+
+    pThis->_sourceRestarts = 0;
+
+    return GST_PAD_PROBE_REMOVE;
+}
+
 GstPadProbeReturn
 GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
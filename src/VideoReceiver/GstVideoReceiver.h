@@ -16,11 +16,14 @@
 #pragma once
 
 #include "QGCLoggingCategory.h"
+#include "QGCInstrumentation.h"
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QThread>
 #include <QWaitCondition>
 #include <QMutex>
 #include <QQueue>
+#include <QThreadPool>
 #include <QQuickItem>
 
 #include "VideoReceiver.h"
@@ -88,14 +91,16 @@ public:
     explicit GstVideoReceiver(QObject* parent = nullptr);
     ~GstVideoReceiver(void);
 
+    virtual void setRecordingMetadata(const QByteArray& klv);
+
 public slots:
     virtual void start(const QString& uri, unsigned timeout, int buffer = 0);
     virtual void stop(void);
     virtual void startDecoding(void* sink);
     virtual void stopDecoding(void);
-    virtual void startRecording(const QString& videoFile, FILE_FORMAT format);
+    virtual void startRecording(const QString& videoFile, FILE_FORMAT format, quint64 segmentBytes = 0, unsigned segmentSecs = 0, bool metadata = false);
     virtual void stopRecording(void);
-    virtual void takeScreenshot(const QString& imageFile);
+    virtual void takeScreenshot(const QString& imageFile, unsigned count = 1);
 
 protected slots:
     virtual void _watchdog(void);
@@ -106,12 +111,26 @@ protected:
     virtual GstElement* _makeDecoder(GstCaps* caps = nullptr, GstElement* videoSink = nullptr);
     virtual GstElement* _makeFileSink(const QString& videoFile, FILE_FORMAT format);
 
+    virtual void _linkSource(void);
+    virtual bool _restartSource(void);
     virtual void _onNewSourcePad(GstPad* pad);
     virtual void _onNewDecoderPad(GstPad* pad);
     virtual bool _addDecoder(GstElement* src);
     virtual bool _addVideoSink(GstPad* pad);
     virtual void _noteTeeFrame(void);
     virtual void _noteVideoSinkFrame(void);
+    virtual void _noteVideoSinkCaps(GstPad* pad);
+    virtual void _noteVideoSinkLatency(GstPad* pad, GstBuffer* buf);
+    virtual void _noteDecoderInput(GstBuffer* buf);
+    virtual void _noteDecoderOutput(GstBuffer* buf);
+    virtual void _noteQos(GstMessage* msg);
+    virtual void _noteRecordingFrame(GstPad* pad, GstPadProbeInfo* info);
+    virtual void _noteScreenshotFrame(GstPad* pad, GstBuffer* buf);
+    void _screenshotWritten(bool success);
+    void _finishScreenshots(void);
+    virtual void _updateStatistics(void);
+    void _resetStatistics(void);
+    void _setLowDelayDecode(GstElement* element);
     virtual void _noteEndOfStream(void);
     virtual bool _unlinkBranch(GstElement* from);
     virtual void _shutdownDecodingBranch (void);
@@ -122,12 +141,19 @@ protected:
 
     static gboolean _onBusMessage(GstBus* bus, GstMessage* message, gpointer user_data);
     static void _onNewPad(GstElement* element, GstPad* pad, gpointer data);
+    static void _onDeepElementAdded(GstBin* bin, GstBin* subBin, GstElement* element, gpointer data);
+    static gchar* _onFormatRecordingLocation(GstElement* splitMux, guint fragmentId, gpointer data);
+    static void _onDecoderQueueOverrun(GstElement* queue, gpointer data);
+    static void _onRecorderQueueOverrun(GstElement* queue, gpointer data);
     static void _wrapWithGhostPad(GstElement* element, GstPad* pad, gpointer data);
     static void _linkPad(GstElement* element, GstPad* pad, gpointer data);
     static gboolean _padProbe(GstElement* element, GstPad* pad, gpointer user_data);
     static GstPadProbeReturn _teeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _decoderInputProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _recordingMetadataProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _sourceKeyframeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
 
     bool                _streaming;
@@ -146,6 +172,10 @@ protected:
 
     qint64              _lastSourceFrameTime;
     qint64              _lastVideoFrameTime;
+    QElapsedTimer       _videoFrameIntervalTimer;   ///< Time since the previous frame reached the video sink
+    QElapsedTimer       _latencyReportTimer;
+    qint64              _latencySumNsecs;           ///< Latency of the frames since the last latencyChanged report
+    int                 _latencyCount;
     bool                _resetVideoSink;
     gulong              _videoSinkProbeId;
 
@@ -158,12 +188,67 @@ protected:
     unsigned            _timeout;
     int                 _buffer;
 
+    QString             _recordingFile;
+    quint64             _recordingSegmentBytes;     ///< 0 for no size limit on each recording file
+    quint64             _recordingSegmentSecs;      ///< 0 for no time limit on each recording file
+    QAtomicInt          _recordingDroppedFrames;    ///< Buffers thrown away because the recording could not keep up
+    bool                _recordingMetadata;         ///< true: recordings get a KLV metadata stream
+    GstElement*         _recordingMetadataSrc;      ///< appsrc feeding the KLV stream into the recording
+    QAtomicPointer<GstBuffer> _pendingMetadata;     ///< Set from any thread, taken by the recording streaming thread
+    GstBuffer*          _currentMetadata;           ///< Only used from the recording streaming thread
+    GstSegment          _recordingSegment;          ///< Latest segment of the recorded video, for the running time of frames
+
+    QString             _screenshotFile;
+    unsigned            _screenshotCount;           ///< Frames asked for by takeScreenshot
+    bool                _screenshotActive;          ///< Only used from the worker thread
+    bool                _screenshotFailed;          ///< Only used from the worker thread
+    QAtomicInt          _screenshotsToCapture;      ///< Frames still to be taken by the video sink probe
+    QAtomicInt          _screenshotsEncoding;       ///< Frames handed to the pool which are not written yet
+    QThreadPool         _screenshotPool;            ///< Downloads and encodes the frames off the streaming and render threads
+    QAtomicInt          _sourceRestarts;            ///< Source restarts since the stream last delivered a keyframe
+
+    static const int        _decoderInputCount = 32;
+
+    typedef struct {
+        GstClockTime    pts;
+        gint64          usecs;                      ///< Monotonic time the buffer went into the decoder
+    } DecoderInput_t;
+
+    // Updated from the streaming threads
+    QAtomicInteger<quint64> _sourceBytes;
+    QAtomicInteger<quint64> _sinkFrames;
+    QAtomicInteger<quint64> _displayDroppedFrames;  ///< Overruns of the queue ahead of the decoder
+    QAtomicInteger<quint64> _decoderQosDropped;     ///< Latest cumulative count from the decoder QoS reports
+    QAtomicInteger<quint64> _sinkQosDropped;        ///< Latest cumulative count from the video sink QoS reports
+    QAtomicInteger<quint64> _qosLateFrames;
+    QAtomicInteger<quint64> _decodeLatencyUSecs;    ///< Sum since the last statistics update
+    QAtomicInteger<quint64> _decodeLatencyCount;
+    QMutex                  _decoderInputMutex;
+    DecoderInput_t          _decoderInputs[_decoderInputCount]; ///< Most recent buffers into the decoder, used as a ring
+    int                     _nextDecoderInput;
+
+    // Only used from the worker thread
+    QElapsedTimer           _statisticsTimer;
+    quint64                 _previousSourceBytes;
+    quint64                 _previousSinkFrames;
+    quint64                 _previousSinkQosDropped;
+
     Worker              _slotHandler;
     uint32_t            _signalDepth;
 
     bool                _endOfStream;
 
     static const char*  _kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN];
+
+    static const int    _latencyReportMSecs         = 1000;
+    static const int    _maxSourceRestarts          = 3;    ///< Source restarts in a row before the whole pipeline is rebuilt
+    static const int    _lowLatencyQueueMSecs       = 100;  ///< Most encoded video held ahead of the decoder in low latency mode
+    static const guint  _recordingQueueBytes        = 64 * 1024 * 1024;
+    static const guint  _taisyncQueueBytes          = 512 * 1024;   ///< Raw h.264 from the Taisync radio held ahead of the parser
+    static const guint  _recordingBlockBytes        = 1024 * 1024;
+    static const guint  _recordingMetadataBytes     = 64 * 1024;    ///< KLV packets queued in the appsrc before they are dropped
+    static const int    _screenshotThreads          = 2;
+    static const int    _maxScreenshotsEncoding     = 8;    ///< Frames held for encoding at once, more would starve the video sink of buffers
 };
 
 void* createVideoSink(void* widget);
@@ -16,7 +16,9 @@
 #pragma once
 
 #include <QObject>
+#include <QByteArray>
 #include <QSize>
+#include <QVariantMap>
 
 class VideoReceiver : public QObject
 {
@@ -34,6 +36,7 @@ public:
         FILE_FORMAT_MKV = FILE_FORMAT_MIN,
         FILE_FORMAT_MOV,
         FILE_FORMAT_MP4,
+        FILE_FORMAT_TS,
         FILE_FORMAT_MAX
     } FILE_FORMAT;
 
@@ -54,6 +57,19 @@ signals:
     void recordingChanged(bool active);
     void recordingStarted(void);
     void videoSizeChanged(QSize size);
+    // Time from a frame arriving at the source to it reaching the video sink, ms
+    void latencyChanged(int latency);
+    // Signalled about once a second while streaming:
+    //      inputBitrate        - bits/sec arriving from the source
+    //      decodeFps           - frames/sec leaving the decoder
+    //      renderFps           - frames/sec the video sink did not drop
+    //      droppedFrames       - total dropped ahead of the decoder, by the decoder and by the video sink
+    //      lateFrames          - total QoS reports of late frames
+    //      decodeLatency       - average time through the decoder, ms
+    //      jitterBufferLatency - configured jitter buffer latency, ms. 0 when there is no jitter buffer.
+    //      jitter              - average RTP packet arrival jitter, ms
+    //      lostPackets         - total RTP packets the jitter buffer gave up on
+    void statisticsChanged(QVariantMap statistics);
 
     void onStartComplete(STATUS status);
     void onStopComplete(STATUS status);
@@ -63,6 +79,11 @@ signals:
     void onStopRecordingComplete(STATUS status);
     void onTakeScreenshotComplete(STATUS status);
 
+public:
+    // Latest KLV packet to go with the recorded video. Can be called from any thread, it never waits on the
+    // streaming threads. The packet is repeated with each recorded frame until the next one is set.
+    virtual void setRecordingMetadata(const QByteArray& klv) = 0;
+
 public slots:
     // buffer:
     //      -1 - disable buffer and video sync
@@ -72,7 +93,15 @@ public slots:
     virtual void stop(void) = 0;
     virtual void startDecoding(void* sink) = 0;
     virtual void stopDecoding(void) = 0;
-    virtual void startRecording(const QString& videoFile, FILE_FORMAT format) = 0;
+    // segmentBytes, segmentSecs:
+    //      0 - no limit
+    //      N - a new file is started once the current one reaches this size/length
+    // metadata:
+    //      true - add a KLV metadata stream fed by setRecordingMetadata, FILE_FORMAT_TS only
+    virtual void startRecording(const QString& videoFile, FILE_FORMAT format, quint64 segmentBytes = 0, unsigned segmentSecs = 0, bool metadata = false) = 0;
     virtual void stopRecording(void) = 0;
-    virtual void takeScreenshot(const QString& imageFile) = 0;
+    // count:
+    //      N - number of consecutive frames to save, the first goes to imageFile and the rest get an _N suffix
+    // onTakeScreenshotComplete is signalled once all of them are written
+    virtual void takeScreenshot(const QString& imageFile, unsigned count = 1) = 0;
 };
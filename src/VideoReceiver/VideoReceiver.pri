@@ -89,7 +89,10 @@ LinuxBuild {
             -lgstrtpmanager \
             -lgstisomp4 \
             -lgstmatroska \
+            -lgstmultifile \
             -lgstmpegtsdemux \
+            -lgstmpegtsmux \
+            -lgstapp \
             -lgstandroidmedia \
             -lgstopengl \
             -lgsttcp
@@ -199,6 +199,7 @@ QVariantList& QGCCorePlugin::analyzePages()
         _p->analyzeList.append(QVariant::fromValue(new QmlComponentInfo(tr("MAVLink Inspector"),QUrl::fromUserInput("qrc:/qml/MAVLinkInspectorPage.qml"),   QUrl::fromUserInput("qrc:/qmlimages/MAVLinkInspector"))));
 #endif
         _p->analyzeList.append(QVariant::fromValue(new QmlComponentInfo(tr("Vibration"),        QUrl::fromUserInput("qrc:/qml/VibrationPage.qml"),          QUrl::fromUserInput("qrc:/qmlimages/VibrationPageIcon"))));
+        _p->analyzeList.append(QVariant::fromValue(new QmlComponentInfo(tr("Performance"),      QUrl::fromUserInput("qrc:/qml/PerformancePage.qml"),        QUrl::fromUserInput("qrc:/qmlimages/PerformancePageIcon"))));
     }
     return _p->analyzeList;
 }
@@ -381,7 +382,7 @@ void QGCCorePlugin::createRootWindow(QQmlApplicationEngine* qmlEngine)
     qmlEngine->load(QUrl(QStringLiteral("qrc:/qml/MainRootWindow.qml")));
 }
 
-bool QGCCorePlugin::mavlinkMessage(Vehicle* vehicle, LinkInterface* link, mavlink_message_t message)
+bool QGCCorePlugin::mavlinkMessage(Vehicle* vehicle, LinkInterface* link, const mavlink_message_t& message)
 {
     Q_UNUSED(vehicle);
     Q_UNUSED(link);
@@ -390,6 +391,13 @@ bool QGCCorePlugin::mavlinkMessage(Vehicle* vehicle, LinkInterface* link, mavlin
     return true;
 }
 
+void QGCCorePlugin::registerMavlinkMessageIds(const QList<uint32_t>& messageIds)
+{
+    for (uint32_t messageId: messageIds) {
+        _mavlinkMessageIds.insert(messageId);
+    }
+}
+
 QmlObjectListModel* QGCCorePlugin::customMapItems()
 {
     return &_p->_emptyCustomMapItems;
@@ -16,6 +16,7 @@
 
 #include <QObject>
 #include <QVariantList>
+#include <QSet>
 
 /// @file
 /// @brief Core Plugin Interface for QGroundControl
@@ -122,9 +123,14 @@ public:
     /// Allows the plugin to override the release of VideoSink.
     virtual void releaseVideoSink(void* sink);
 
-    /// Allows the plugin to see all mavlink traffic to a vehicle
+    /// Allows the plugin to see mavlink traffic to a vehicle. Only called for the message ids the plugin registered
+    /// with registerMavlinkMessageIds or for everything after registerAllMavlinkMessages. Nothing is registered by
+    /// default, so a plugin which doesn't register never gets a call.
     /// @return true: Allow vehicle to continue processing, false: Vehicle should not process message
-    virtual bool mavlinkMessage(Vehicle* vehicle, LinkInterface* link, mavlink_message_t message);
+    virtual bool mavlinkMessage(Vehicle* vehicle, LinkInterface* link, const mavlink_message_t& message);
+
+    /// @return true: mavlinkMessage wants to see messages with this id
+    bool wantsMavlinkMessage(uint32_t msgid) const { return _allMavlinkMessages || _mavlinkMessageIds.contains(msgid); }
 
     /// Allows custom builds to add custom items to the FlightMap. Objects put into QmlObjectListModel should derive from QmlComponentInfo and set the url property.
     virtual QmlObjectListModel* customMapItems();
@@ -212,6 +218,13 @@ protected:
     QGCCameraControl*   _currentCamera  = nullptr;
     QVariantList        _toolBarIndicatorList;
 
+    /// Adds to the message ids passed to mavlinkMessage
+    void registerMavlinkMessageIds  (const QList<uint32_t>& messageIds);
+    /// Passes every message to mavlinkMessage, for plugins which really need to see all traffic
+    void registerAllMavlinkMessages (void) { _allMavlinkMessages = true; }
+
 private:
     QGCCorePlugin_p*    _p;
+    QSet<uint32_t>      _mavlinkMessageIds;
+    bool                _allMavlinkMessages = false;
 };
@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const uint32_t kBucketUpperMSecs[LatencyHistogram::bucketCount] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 0 };
+
+LatencyHistogram::LatencyHistogram(void)
+{
+    reset();
+}
+
+void LatencyHistogram::reset(void)
+{
+    memset(_buckets, 0, sizeof(_buckets));
+    _count      = 0;
+    _totalUSecs = 0;
+    _lastUSecs  = 0;
+    _minUSecs   = UINT64_MAX;
+    _maxUSecs   = 0;
+}
+
+uint32_t LatencyHistogram::bucketUpperMSecs(int bucket)
+{
+    return kBucketUpperMSecs[bucket];
+}
+
+void LatencyHistogram::add(uint64_t latencyUSecs)
+{
+    int bucket = 0;
+    while (bucket < bucketCount - 1 && latencyUSecs > static_cast<uint64_t>(kBucketUpperMSecs[bucket]) * 1000) {
+        bucket++;
+    }
+
+    _buckets[bucket]++;
+    _count++;
+    _totalUSecs += latencyUSecs;
+    _lastUSecs  = latencyUSecs;
+    _minUSecs   = std::min(_minUSecs, latencyUSecs);
+    _maxUSecs   = std::max(_maxUSecs, latencyUSecs);
+}
+
+uint64_t LatencyHistogram::percentileUSecs(int percent) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+
+    // Rank of the sample we are looking for, rounded up so that 100% is the last sample
+    uint64_t rank       = (static_cast<uint64_t>(_count) * static_cast<uint64_t>(std::min(std::max(percent, 0), 100)) + 99) / 100;
+    uint64_t samples    = 0;
+
+    rank = std::max<uint64_t>(rank, 1);
+    for (int bucket=0; bucket<bucketCount - 1; bucket++) {
+        samples += _buckets[bucket];
+        if (samples >= rank) {
+            return std::min(static_cast<uint64_t>(kBucketUpperMSecs[bucket]) * 1000, _maxUSecs);
+        }
+    }
+
+    return _maxUSecs;
+}
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+/// Histogram of latency samples using fixed 1-2-5 millisecond bucket boundaries.
+///
+/// Adding a sample is a short linear search with no allocation. Percentiles are reported as the upper
+/// boundary of the bucket they fall in, clamped to the largest sample seen.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram(void);
+
+    void reset  (void);
+    void add    (uint64_t latencyUSecs);
+
+    uint32_t    count           (void) const { return _count; }
+    uint64_t    lastUSecs       (void) const { return _lastUSecs; }
+    uint64_t    minUSecs        (void) const { return _count ? _minUSecs : 0; }
+    uint64_t    maxUSecs        (void) const { return _maxUSecs; }
+    uint64_t    meanUSecs       (void) const { return _count ? _totalUSecs / _count : 0; }
+
+    /// @param percent 0-100
+    uint64_t    percentileUSecs (int percent) const;
+
+    /// Number of samples in the specified bucket
+    uint32_t    bucketSamples   (int bucket) const { return _buckets[bucket]; }
+
+    /// Upper boundary of the specified bucket in milliseconds, 0 for the final unbounded bucket
+    static uint32_t bucketUpperMSecs(int bucket);
+
+    static const int bucketCount = 14;
+
+private:
+    uint32_t    _buckets[bucketCount];
+    uint32_t    _count;
+    uint64_t    _totalUSecs;
+    uint64_t    _lastUSecs;
+    uint64_t    _minUSecs;
+    uint64_t    _maxUSecs;
+};
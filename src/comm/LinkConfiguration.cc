@@ -14,6 +14,12 @@
 #include "UDPLink.h"
 #include "TCPLink.h"
 #include "LogReplayLink.h"
+#ifndef __mobile__
+#include "LocalSocketLink.h"
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+#include "TaisyncTelemetry.h"
+#endif
+#endif
 #ifdef QGC_ENABLE_BLUETOOTH
 #include "BluetoothLink.h"
 #endif
@@ -42,6 +48,7 @@ LinkConfiguration::LinkConfiguration(LinkConfiguration* copy)
     _dynamic    = copy->isDynamic();
     _autoConnect= copy->isAutoConnect();
     _highLatency= copy->isHighLatency();
+    _txRateLimit= copy->txRateLimit();
     Q_ASSERT(!_name.isEmpty());
 }
 
@@ -53,6 +60,7 @@ void LinkConfiguration::copyFrom(LinkConfiguration* source)
     _dynamic    = source->isDynamic();
     _autoConnect= source->isAutoConnect();
     _highLatency= source->isHighLatency();
+    _txRateLimit= source->txRateLimit();
 }
 
 /*!
@@ -91,6 +99,16 @@ LinkConfiguration* LinkConfiguration::createSettings(int type, const QString& na
         case LinkConfiguration::TypeLogReplay:
             config = new LogReplayLinkConfiguration(name);
             break;
+#ifndef __mobile__
+        case LinkConfiguration::TypeLocalSocket:
+            config = new LocalSocketConfiguration(name);
+            break;
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+        case LinkConfiguration::TypeTaisync:
+            config = new TaisyncTelemetryConfiguration(name);
+            break;
+#endif
 #ifdef QT_DEBUG
         case LinkConfiguration::TypeMock:
             config = new MockConfiguration(name);
@@ -127,6 +145,16 @@ LinkConfiguration* LinkConfiguration::duplicateSettings(LinkConfiguration* sourc
         case TypeLogReplay:
             dupe = new LogReplayLinkConfiguration(qobject_cast<LogReplayLinkConfiguration*>(source));
             break;
+#ifndef __mobile__
+        case TypeLocalSocket:
+            dupe = new LocalSocketConfiguration(qobject_cast<LocalSocketConfiguration*>(source));
+            break;
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+        case TypeTaisync:
+            dupe = new TaisyncTelemetryConfiguration(qobject_cast<TaisyncTelemetryConfiguration*>(source));
+            break;
+#endif
 #ifdef QT_DEBUG
         case TypeMock:
             dupe = new MockConfiguration(qobject_cast<MockConfiguration*>(source));
@@ -33,6 +33,7 @@ public:
     Q_PROPERTY(QString          settingsURL         READ settingsURL                            CONSTANT)
     Q_PROPERTY(QString          settingsTitle       READ settingsTitle                          CONSTANT)
     Q_PROPERTY(bool             highLatency         READ isHighLatency  WRITE setHighLatency    NOTIFY highLatencyChanged)
+    Q_PROPERTY(int              txRateLimit         READ txRateLimit    WRITE setTxRateLimit    NOTIFY txRateLimitChanged)  ///< Outbound bytes/sec, 0 for no limit
 
     // Property accessors
 
@@ -57,6 +58,12 @@ public:
         TypeMock,       ///< Mock Link for Unitesting
 #endif
         TypeLogReplay,
+#ifndef __mobile__
+        TypeLocalSocket,    ///< Unix domain socket (named pipe on Windows) to software on the same machine
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+        TypeTaisync,        ///< Taisync radio telemetry channel, created by TaisyncManager
+#endif
         TypeLast        // Last type value (type >= TypeLast == invalid)
     };
     Q_ENUM(LinkType)
@@ -86,6 +93,14 @@ public:
     */
     void setHighLatency(bool hl = false) { _highLatency = hl; emit highLatencyChanged(); }
 
+    /*!
+     * Outbound traffic shaping for links with limited bandwidth, such as telemetry radios.
+     * Heartbeats and manual control are always sent, other traffic waits for the budget.
+     * @return Maximum outbound bytes per second, 0 for no limit
+     */
+    int  txRateLimit(void) const { return _txRateLimit; }
+    void setTxRateLimit(int txRateLimit) { _txRateLimit = qMax(0, txRateLimit); emit txRateLimitChanged(); }
+
     /// Virtual Methods
 
     /*!
@@ -167,6 +182,7 @@ signals:
     void dynamicChanged     ();
     void autoConnectChanged ();
     void highLatencyChanged ();
+    void txRateLimitChanged ();
     void linkChanged        ();
 
 protected:
@@ -177,6 +193,7 @@ private:
     bool    _dynamic;       ///< A connection added automatically and not persistent (unless it's edited).
     bool    _autoConnect;   ///< This connection is started automatically at boot
     bool    _highLatency;
+    int     _txRateLimit    = 0;
 };
 
 typedef std::shared_ptr<LinkConfiguration>  SharedLinkConfigurationPtr;
@@ -10,6 +10,8 @@
 #include "LinkInterface.h"
 #include "QGCApplication.h"
 
+const QEvent::Type LinkInterface::_controlWriteEventType = static_cast<QEvent::Type>(QEvent::registerEventType());
+
 LinkInterface::LinkInterface(SharedLinkConfigurationPtr& config, bool isPX4Flow)
     : QThread   (0)
     , _config   (config)
@@ -47,10 +49,199 @@ void LinkInterface::_setMavlinkChannel(uint8_t channel)
 
 void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
 {
-    QByteArray byteArray(bytes, length);
-    _writeBytesMutex.lock();
-    _writeBytes(byteArray);
-    _writeBytesMutex.unlock();
+    if (_isPriorityFrame(bytes, length)) {
+        _prioritySendQueue.push(bytes, length);
+    } else {
+        _sendQueue.push(bytes, length);
+    }
+
+    // The drain is queued to the thread the link lives on, which is also the thread that owns the underlying socket/port
+    if (!_sendDrainPending.exchange(true)) {
+        QMetaObject::invokeMethod(this, [this]() { _drainSendQueues(); }, Qt::QueuedConnection);
+    }
+}
+
+void LinkInterface::writeControlBytesThreadSafe(const char *bytes, int length, const QElapsedTimer& inputTimer)
+{
+    {
+        QMutexLocker lock(&_controlMutex);
+        if (_controlBytes.isEmpty()) {
+            _controlInputTimer = inputTimer;
+        }
+        _controlBytes.append(bytes, length);
+    }
+
+    // A high priority event is delivered ahead of the queued drains and socket notifications already waiting on the
+    // link thread, so the frame does not sit behind them
+    if (!_controlWritePending.exchange(true)) {
+        QCoreApplication::postEvent(this, new QEvent(_controlWriteEventType), Qt::HighEventPriority);
+    }
+}
+
+LatencyHistogram LinkInterface::controlLatency(void) const
+{
+    QMutexLocker lock(&_controlMutex);
+    return _controlLatency;
+}
+
+bool LinkInterface::event(QEvent* event)
+{
+    if (event->type() == _controlWriteEventType) {
+        _writeControlBytes();
+        return true;
+    }
+    return QThread::event(event);
+}
+
+/// Writes out the pending control frames. Runs on the link thread.
+void LinkInterface::_writeControlBytes(void)
+{
+    _controlWritePending = false;
+
+    QByteArray      bytes;
+    QElapsedTimer   inputTimer;
+    {
+        QMutexLocker lock(&_controlMutex);
+        bytes.swap(_controlBytes);
+        inputTimer = _controlInputTimer;
+    }
+    if (bytes.isEmpty()) {
+        return;
+    }
+
+    // Like the priority frames these are never held back by shaping, but they do use up the budget
+    _writeBytes(bytes);
+    if (_config && _config->txRateLimit() > 0) {
+        _txBudgetBytes -= bytes.size();
+    }
+
+    if (inputTimer.isValid()) {
+        QMutexLocker lock(&_controlMutex);
+        _controlLatency.add(static_cast<uint64_t>(inputTimer.nsecsElapsed() / 1000));
+    }
+}
+
+/// Writes out the queued frames. Runs on the link thread.
+void LinkInterface::_drainSendQueues(void)
+{
+    // Must be cleared prior to draining so that anything pushed from here on queues another drain
+    _sendDrainPending = false;
+
+    // Control frames which came in after their event was posted go out before anything else
+    _writeControlBytes();
+
+    int         chunksWritten   = 0;
+    int         txRateLimit     = _config ? _config->txRateLimit() : 0;
+    QByteArray  bytes;
+
+    while (chunksWritten < _maxChunksPerDrain) {
+        // Priority frames are always written first, and are rechecked between each chunk of other traffic so
+        // that a long backlog of mission/parameter/ftp traffic can't hold them up. They are never held back by
+        // shaping either, but they do use up the budget.
+        if (_coalesceFrames(_prioritySendQueue, bytes)) {
+            _writeBytes(bytes);
+            if (txRateLimit > 0) {
+                _txBudgetBytes -= bytes.size();
+            }
+            chunksWritten++;
+            continue;
+        }
+        if (txRateLimit > 0 && !_txBudgetAvailable(txRateLimit)) {
+            if (!_txRetryPending && _sendQueue.count()) {
+                // Come back once the budget is positive again. New pushes still queue their own drains, so
+                // priority frames go out in the meantime.
+                int retryMSecs = qMax(1, static_cast<int>((-_txBudgetBytes * 1000.0) / txRateLimit) + 1);
+                _txRetryPending = true;
+                QTimer::singleShot(retryMSecs, this, [this]() {
+                    _txRetryPending = false;
+                    _drainSendQueues();
+                });
+            }
+            return;
+        }
+        if (_coalesceFrames(_sendQueue, bytes)) {
+            _writeBytes(bytes);
+            if (txRateLimit > 0) {
+                _txBudgetBytes -= bytes.size();
+            }
+            chunksWritten++;
+            continue;
+        }
+        break;
+    }
+
+    if (chunksWritten >= _maxChunksPerDrain && (_prioritySendQueue.count() || _sendQueue.count())) {
+        if (!_sendDrainPending.exchange(true)) {
+            QMetaObject::invokeMethod(this, [this]() { _drainSendQueues(); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+/// Refills the outbound token bucket from the time elapsed since the last refill
+///     @return true: Budget is available for another chunk
+bool LinkInterface::_txBudgetAvailable(int txRateLimit)
+{
+    double burstBytes = qMax(static_cast<double>(_maxCoalescedBytes), (txRateLimit * _txBurstMSecs) / 1000.0);
+
+    if (!_txBudgetTimer.isValid()) {
+        _txBudgetTimer.start();
+        _txBudgetBytes = burstBytes;
+    } else {
+        _txBudgetBytes = qMin(burstBytes, _txBudgetBytes + ((_txBudgetTimer.nsecsElapsed() * static_cast<double>(txRateLimit)) / 1e9));
+        _txBudgetTimer.restart();
+    }
+
+    return _txBudgetBytes > 0;
+}
+
+/// Pops frames from the queue into a single buffer up to _maxCoalescedBytes. A single frame larger than the
+/// limit is returned on its own.
+///     @return false: Queue was empty
+bool LinkInterface::_coalesceFrames(LinkSendQueue& sendQueue, QByteArray& bytes)
+{
+    if (!sendQueue.pop(bytes)) {
+        return false;
+    }
+
+    int nextSize = sendQueue.peekSize();
+    if (nextSize == 0 || bytes.size() + nextSize > _maxCoalescedBytes) {
+        return true;
+    }
+
+    QByteArray frame;
+    bytes.reserve(_maxCoalescedBytes);
+    do {
+        if (!sendQueue.pop(frame)) {
+            break;
+        }
+        bytes.append(frame);
+        nextSize = sendQueue.peekSize();
+    } while (nextSize != 0 && bytes.size() + nextSize <= _maxCoalescedBytes);
+
+    return true;
+}
+
+/// @return true: bytes start with a frame which must not wait behind bulk traffic
+bool LinkInterface::_isPriorityFrame(const char* bytes, int length)
+{
+    uint32_t msgId;
+
+    if (length >= MAVLINK_NUM_HEADER_BYTES && static_cast<uint8_t>(bytes[0]) == MAVLINK_STX) {
+        msgId = static_cast<uint8_t>(bytes[7]) | (static_cast<uint8_t>(bytes[8]) << 8) | (static_cast<uint8_t>(bytes[9]) << 16);
+    } else if (length >= MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 && static_cast<uint8_t>(bytes[0]) == MAVLINK_STX_MAVLINK1) {
+        msgId = static_cast<uint8_t>(bytes[5]);
+    } else {
+        return false;
+    }
+
+    switch (msgId) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+        return true;
+    default:
+        return false;
+    }
 }
 
 void LinkInterface::addVehicleReference(void)
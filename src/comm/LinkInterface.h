@@ -17,11 +17,15 @@
 #include <QSharedPointer>
 #include <QDebug>
 #include <QTimer>
+#include <QElapsedTimer>
 
+#include <atomic>
 #include <memory>
 
 #include "QGCMAVLink.h"
 #include "LinkConfiguration.h"
+#include "LinkSendQueue.h"
+#include "LatencyHistogram.h"
 #include "MavlinkMessagesTimer.h"
 
 class LinkManager;
@@ -60,7 +64,19 @@ public:
     uint8_t mavlinkChannel              (void) const;
     bool    decodedFirstMavlinkPacket   (void) const { return _decodedFirstMavlinkPacket; }
     bool    setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { return _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
-    void    writeBytesThreadSafe        (const char *bytes, int length);
+    void    writeBytesThreadSafe        (const char *bytes, int length);   ///< Queues the bytes for sending from the link thread
+
+    /// Queues vehicle control frames (MANUAL_CONTROL) on the control channel. The link thread is woken with a high
+    /// priority event and the frames are written ahead of all other queued traffic.
+    ///     @param inputTimer Started when the control input was sampled, the time to the write is added to
+    ///                       controlLatency. May be invalid.
+    void    writeControlBytesThreadSafe (const char *bytes, int length, const QElapsedTimer& inputTimer);
+
+    /// @return Input to wire latency of the frames written on the control channel
+    LatencyHistogram controlLatency     (void) const;
+
+    /// @return Number of frames waiting behind the priority traffic, approximate while other threads are sending
+    int     pendingSendCount            (void) const { return _sendQueue.count(); }
     void    addVehicleReference         (void);
     void    removeVehicleReference      (void);
 
@@ -79,13 +95,22 @@ protected:
 
     SharedLinkConfigurationPtr _config;
 
+    // Overrides from QObject
+    bool event(QEvent* event) override;
+
 private:
     // connect is private since all links should be created through LinkManager::createConnectedLink calls
     virtual bool _connect(void) = 0;
 
     virtual void _writeBytes(const QByteArray) = 0; // Not thread safe, only writeBytesThreadSafe is thread safe
 
-    void _setMavlinkChannel(uint8_t channel);
+    void _setMavlinkChannel (uint8_t channel);
+    void _drainSendQueues   (void);
+    void _writeControlBytes (void);
+    bool _coalesceFrames    (LinkSendQueue& sendQueue, QByteArray& bytes);
+    bool _txBudgetAvailable (int txRateLimit);
+
+    static bool _isPriorityFrame(const char* bytes, int length);
 
     bool    _mavlinkChannelSet          = false;
     uint8_t _mavlinkChannel;
@@ -93,7 +118,26 @@ private:
     bool    _isPX4Flow                  = false;
     int     _vehicleReferenceCount      = 0;
 
-    mutable QMutex _writeBytesMutex;
+    LinkSendQueue       _prioritySendQueue;             ///< Latency sensitive frames: heartbeats, manual control, rc overrides
+    LinkSendQueue       _sendQueue;                     ///< Everything else
+    std::atomic<bool>   _sendDrainPending   { false };
+
+    mutable QMutex      _controlMutex;                  ///< Protects the control channel members below
+    QByteArray          _controlBytes;                  ///< Control frames waiting for the link thread
+    QElapsedTimer       _controlInputTimer;             ///< Input timer of the oldest frame in _controlBytes
+    LatencyHistogram    _controlLatency;
+    std::atomic<bool>   _controlWritePending{ false };
+
+    // Outbound shaping state, only touched on the link thread
+    double              _txBudgetBytes      = 0;        ///< Token bucket, goes negative after a chunk larger than the budget
+    QElapsedTimer       _txBudgetTimer;
+    bool                _txRetryPending     = false;    ///< A drain is already scheduled for when the budget refills
+
+    static const int _maxCoalescedBytes     = 1024;     ///< Upper limit on the bytes passed to a single _writeBytes call
+    static const int _maxChunksPerDrain     = 64;       ///< Drains yield back to the event loop after this many _writeBytes calls
+    static const int _txBurstMSecs          = 250;      ///< Shaped links can send this much of their rate as a burst after idling
+
+    static const QEvent::Type _controlWriteEventType;
 
     QMap<int /* vehicle id */, MavlinkMessagesTimer*> _mavlinkMessagesTimers;
 };
@@ -24,6 +24,13 @@
 #include "TCPLink.h"
 #include "SettingsManager.h"
 #include "LogReplayLink.h"
+#ifndef __mobile__
+#include "LocalSocketLink.h"
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+#include "TaisyncTelemetry.h"
+#endif
+#endif
+#include "MAVLinkForwarder.h"
 #ifdef QGC_ENABLE_BLUETOOTH
 #include "BluetoothLink.h"
 #endif
@@ -72,6 +79,10 @@ LinkManager::LinkManager(QGCApplication* app, QGCToolbox* toolbox)
 
 LinkManager::~LinkManager()
 {
+#ifndef NO_SERIAL_LINK
+    _serialScanThread.quit();
+    _serialScanThread.wait();
+#endif
 #ifndef __mobile__
 #ifndef NO_SERIAL_LINK
     delete _nmeaPort;
@@ -86,6 +97,25 @@ void LinkManager::setToolbox(QGCToolbox *toolbox)
     _autoConnectSettings = toolbox->settingsManager()->autoConnectSettings();
     _mavlinkProtocol = _toolbox->mavlinkProtocol();
 
+#ifndef NO_SERIAL_LINK
+    // The serial port list is only enumerated when the OS says something changed, or the autoconnect settings did
+    auto serialPortsChanged = [this]() { _serialPortsChanged = true; };
+    connect(&_serialPortWatcher, &SerialPortWatcher::portsChanged, this, serialPortsChanged);
+
+    _serialPortScanner = new SerialPortScanner;
+    _serialPortScanner->moveToThread(&_serialScanThread);
+    connect(&_serialScanThread,     &QThread::finished,                 _serialPortScanner, &QObject::deleteLater);
+    connect(_serialPortScanner,     &SerialPortScanner::scanComplete,   this,               &LinkManager::_serialScanComplete);
+    _serialScanThread.setObjectName(QStringLiteral("SerialPortScanner"));
+    _serialScanThread.start(QThread::LowPriority);
+    for (Fact* fact: { _autoConnectSettings->autoConnectPixhawk(), _autoConnectSettings->autoConnectSiKRadio(),
+                       _autoConnectSettings->autoConnectPX4Flow(), _autoConnectSettings->autoConnectRTKGPS(),
+                       _autoConnectSettings->autoConnectLibrePilot(), _autoConnectSettings->autoConnectNmeaPort(),
+                       _autoConnectSettings->autoConnectNmeaBaud() }) {
+        connect(fact, &Fact::rawValueChanged, this, serialPortsChanged);
+    }
+#endif
+
     connect(&_portListTimer, &QTimer::timeout, this, &LinkManager::_updateAutoConnectLinks);
     _portListTimer.start(_autoconnectUpdateTimerMSecs); // timeout must be long enough to get past bootloader on second pass
 
@@ -127,6 +157,16 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr& config, bool i
     case LinkConfiguration::TypeLogReplay:
         link = std::make_shared<LogReplayLink>(config);
         break;
+#ifndef __mobile__
+    case LinkConfiguration::TypeLocalSocket:
+        link = std::make_shared<LocalSocketLink>(config);
+        break;
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+    case LinkConfiguration::TypeTaisync:
+        link = std::make_shared<TaisyncTelemetryLink>(config);
+        break;
+#endif
 #ifdef QT_DEBUG
     case LinkConfiguration::TypeMock:
         link = std::make_shared<MockLink>(config);
@@ -147,14 +187,16 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr& config, bool i
         }
 
         _rgLinks.append(link);
+        _linkLookup[link.get()] = link;
         config->setLink(link);
 
         connect(link.get(), &LinkInterface::communicationError,  _app,                &QGCApplication::criticalMessageBoxOnMainThread);
-        connect(link.get(), &LinkInterface::bytesReceived,       _mavlinkProtocol,    &MAVLinkProtocol::receiveBytes);
+        // Parsing happens on the link thread, parsed messages are handed off to the main thread by MAVLinkProtocol
+        connect(link.get(), &LinkInterface::bytesReceived,       _mavlinkProtocol,    &MAVLinkProtocol::receiveBytes, Qt::DirectConnection);
         connect(link.get(), &LinkInterface::bytesSent,           _mavlinkProtocol,    &MAVLinkProtocol::logSentBytes);
         connect(link.get(), &LinkInterface::disconnected,        this,                &LinkManager::_linkDisconnected);
 
-        _mavlinkProtocol->resetMetadataForLink(link.get());
+        _mavlinkProtocol->resetMetadataForLink(link);
         _mavlinkProtocol->setVersion(_mavlinkProtocol->getCurrentVersion());
 
         if (!link->_connect()) {
@@ -167,11 +209,21 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr& config, bool i
     return false;
 }
 
-SharedLinkInterfacePtr LinkManager::mavlinkForwardingLink()
+QString LinkManager::_mavlinkForwardingLinkNameForTarget(int targetIndex)
+{
+    if (targetIndex == 0) {
+        return _mavlinkForwardingLinkName;
+    }
+    return QStringLiteral("%1 %2").arg(_mavlinkForwardingLinkName).arg(targetIndex + 1);
+}
+
+SharedLinkInterfacePtr LinkManager::mavlinkForwardingLink(int targetIndex)
 {
+    QString linkName = _mavlinkForwardingLinkNameForTarget(targetIndex);
+
     for (int i = 0; i < _rgLinks.count(); i++) {
         SharedLinkConfigurationPtr linkConfig = _rgLinks[i]->linkConfiguration();
-        if (linkConfig->type() == LinkConfiguration::TypeUdp && linkConfig->name() == _mavlinkForwardingLinkName) {
+        if (linkConfig->type() == LinkConfiguration::TypeUdp && linkConfig->name() == linkName) {
             SharedLinkInterfacePtr& link = _rgLinks[i];
             return link;
         }
@@ -202,7 +254,13 @@ void LinkManager::_linkDisconnected(void)
     disconnect(link, &LinkInterface::bytesSent,           _mavlinkProtocol,    &MAVLinkProtocol::logSentBytes);
     disconnect(link, &LinkInterface::disconnected,        this,                &LinkManager::_linkDisconnected);
 
+    _mavlinkProtocol->releaseLink(link);
     _freeMavlinkChannel(link->mavlinkChannel());
+    _linkLookup.remove(link);
+#ifndef NO_SERIAL_LINK
+    // A port we skipped because it was in use can be autoconnected again
+    _serialPortsChanged = true;
+#endif
     for (int i=0; i<_rgLinks.count(); i++) {
         if (_rgLinks[i].get() == link) {
             qCDebug(LinkManagerLog) << "LinkManager::_linkDisconnected" << _rgLinks[i]->linkConfiguration()->name() << _rgLinks[i].use_count();
@@ -214,9 +272,11 @@ void LinkManager::_linkDisconnected(void)
 
 SharedLinkInterfacePtr LinkManager::sharedLinkInterfacePointerForLink(LinkInterface* link, bool ignoreNull)
 {
-    for (int i=0; i<_rgLinks.count(); i++) {
-        if (_rgLinks[i].get() == link) {
-            return _rgLinks[i];
+    auto it = _linkLookup.constFind(link);
+    if (it != _linkLookup.constEnd()) {
+        SharedLinkInterfacePtr sharedLink = it.value().lock();
+        if (sharedLink) {
+            return sharedLink;
         }
     }
 
@@ -263,6 +323,7 @@ void LinkManager::saveLinkConfigurationList()
                 settings.setValue(root + "/type", linkConfig->type());
                 settings.setValue(root + "/auto", linkConfig->isAutoConnect());
                 settings.setValue(root + "/high_latency", linkConfig->isHighLatency());
+                settings.setValue(root + "/tx_rate_limit", linkConfig->txRateLimit());
                 // Have the instance save its own values
                 linkConfig->saveSettings(settings, root);
             }
@@ -293,6 +354,7 @@ void LinkManager::loadLinkConfigurationList()
                             LinkConfiguration* link = nullptr;
                             bool autoConnect = settings.value(root + "/auto").toBool();
                             bool highLatency = settings.value(root + "/high_latency").toBool();
+                            int txRateLimit = settings.value(root + "/tx_rate_limit", 0).toInt();
 
                             switch(type) {
 #ifndef NO_SERIAL_LINK
@@ -314,6 +376,16 @@ void LinkManager::loadLinkConfigurationList()
                             case LinkConfiguration::TypeLogReplay:
                                 link = new LogReplayLinkConfiguration(name);
                                 break;
+#ifndef __mobile__
+                            case LinkConfiguration::TypeLocalSocket:
+                                link = new LocalSocketConfiguration(name);
+                                break;
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+                            case LinkConfiguration::TypeTaisync:
+                                link = new TaisyncTelemetryConfiguration(name);
+                                break;
+#endif
 #ifdef QT_DEBUG
                             case LinkConfiguration::TypeMock:
                                 link = new MockConfiguration(name);
@@ -326,6 +398,7 @@ void LinkManager::loadLinkConfigurationList()
                                 //-- Have the instance load its own values
                                 link->setAutoConnect(autoConnect);
                                 link->setHighLatency(highLatency);
+                                link->setTxRateLimit(txRateLimit);
                                 link->loadSettings(settings, root);
                                 addConfiguration(link);
                             }
@@ -393,25 +466,21 @@ void LinkManager::_addUDPAutoConnectLink(void)
 void LinkManager::_addMAVLinkForwardingLink(void)
 {
     if (_toolbox->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool()) {
-        bool foundMAVLinkForwardingLink = false;
+        QString                         targetsSetting  = _toolbox->settingsManager()->appSettings()->forwardMavlinkHostName()->rawValue().toString();
+        QList<MAVLinkForwarder::Target_t> targets       = MAVLinkForwarder::parseTargets(targetsSetting);
 
-        for (int i=0; i<_rgLinks.count(); i++) {
-            SharedLinkConfigurationPtr linkConfig = _rgLinks[i]->linkConfiguration();
-            if (linkConfig->type() == LinkConfiguration::TypeUdp && linkConfig->name() == _mavlinkForwardingLinkName) {
-                foundMAVLinkForwardingLink = true;
+        // One link per target so each target gets its own batch of forwarded traffic
+        for (int targetIndex=0; targetIndex<targets.count(); targetIndex++) {
+            if (mavlinkForwardingLink(targetIndex)) {
                 // TODO: should we check if the host/port matches the mavlinkForwardHostName setting and update if it does not match?
-                break;
+                continue;
             }
-        }
 
-        if (!foundMAVLinkForwardingLink) {
-            qCDebug(LinkManagerLog) << "New MAVLink forwarding port added";
+            qCDebug(LinkManagerLog) << "New MAVLink forwarding port added" << targets[targetIndex].hostName;
 
-            UDPConfiguration* udpConfig = new UDPConfiguration(_mavlinkForwardingLinkName);
+            UDPConfiguration* udpConfig = new UDPConfiguration(_mavlinkForwardingLinkNameForTarget(targetIndex));
             udpConfig->setDynamic(true);
-
-            QString hostName = _toolbox->settingsManager()->appSettings()->forwardMavlinkHostName()->rawValue().toString();
-            udpConfig->addHost(hostName);
+            udpConfig->addHost(targets[targetIndex].hostName);
 
             SharedLinkConfigurationPtr config = addConfiguration(udpConfig);
             createConnectedLink(config);
@@ -453,38 +522,30 @@ void LinkManager::_updateAutoConnectLinks(void)
 #endif
 
 #ifndef NO_SERIAL_LINK
-    QStringList                 currentPorts;
-    QList<QGCSerialPortInfo>    portList;
 #ifdef __android__
     // Android builds only support a single serial connection. Repeatedly calling availablePorts after that one serial
     // port is connected leaks file handles due to a bug somewhere in android serial code. In order to work around that
     // bug after we connect the first serial port we stop probing for additional ports.
-    if (!_isSerialPortConnected()) {
-        portList = QGCSerialPortInfo::availablePorts();
-    }
-    else {
-        qDebug() << "Skipping serial port list";
+    if (_isSerialPortConnected()) {
+        qCVerbose(LinkManagerVerboseLog) << "Skipping serial port list";
+        return;
     }
-#else
-    portList = QGCSerialPortInfo::availablePorts();
 #endif
 
-    // Iterate Comm Ports
-    for (const QGCSerialPortInfo& portInfo: portList) {
-        qCDebug(LinkManagerVerboseLog) << "-----------------------------------------------------";
-        qCDebug(LinkManagerVerboseLog) << "portName:          " << portInfo.portName();
-        qCDebug(LinkManagerVerboseLog) << "systemLocation:    " << portInfo.systemLocation();
-        qCDebug(LinkManagerVerboseLog) << "description:       " << portInfo.description();
-        qCDebug(LinkManagerVerboseLog) << "manufacturer:      " << portInfo.manufacturer();
-        qCDebug(LinkManagerVerboseLog) << "serialNumber:      " << portInfo.serialNumber();
-        qCDebug(LinkManagerVerboseLog) << "vendorIdentifier:  " << portInfo.vendorIdentifier();
-        qCDebug(LinkManagerVerboseLog) << "productIdentifier: " << portInfo.productIdentifier();
-
-        // Save port name
-        currentPorts << portInfo.systemLocation();
+    // Enumeration and board detection happen on the scanner thread. Without anything new from the OS, and nothing left
+    // over from the last pass, the port list can't have changed so there is no need to ask for a scan.
+    if (!_serialScanPending && (!_serialPortWatcher.isActive() || _serialPortsChanged || _serialPortsRecheck)) {
+        _serialPortsChanged = false;
+        _serialPortsRecheck = false;
+        _serialScanPending  = true;
+        QMetaObject::invokeMethod(_serialPortScanner, "scan", Qt::QueuedConnection);
+    }
 
-        QGCSerialPortInfo::BoardType_t boardType;
-        QString boardName;
+    // Iterate Comm Ports from the last scan
+    for (const SerialPortScanner::Port_t& port: _serialPorts) {
+        const QGCSerialPortInfo&                portInfo    = port.info;
+        const QGCSerialPortInfo::BoardType_t    boardType   = port.boardType;
+        const QString&                          boardName   = port.boardName;
 
 #ifndef NO_SERIAL_LINK
 #ifndef __mobile__
@@ -511,14 +572,15 @@ void LinkManager::_updateAutoConnectLinks(void)
         } else
 #endif
 #endif
-            if (portInfo.getBoardInfo(boardType, boardName)) {
-                if (portInfo.isBootloader()) {
+            if (port.boardFound) {
+                if (port.bootloader) {
                     // Don't connect to bootloader
                     qCDebug(LinkManagerLog) << "Waiting for bootloader to finish" << portInfo.systemLocation();
+                    _serialPortsRecheck = true;
                     continue;
                 }
                 if (_portAlreadyConnected(portInfo.systemLocation()) || _autoConnectRTKPort == portInfo.systemLocation()) {
-                    qCDebug(LinkManagerVerboseLog) << "Skipping existing autoconnect" << portInfo.systemLocation();
+                    qCVerbose(LinkManagerVerboseLog) << "Skipping existing autoconnect" << portInfo.systemLocation();
                 } else if (!_autoconnectPortWaitList.contains(portInfo.systemLocation())) {
                     // We don't connect to the port the first time we see it. The ability to correctly detect whether we
                     // are in the bootloader is flaky from a cross-platform standpoint. So by putting it on a wait list
@@ -571,7 +633,10 @@ void LinkManager::_updateAutoConnectLinks(void)
                         pSerialConfig->setAutoConnect(true);
 
                         SharedLinkConfigurationPtr  sharedConfig(pSerialConfig);
-                        createConnectedLink(sharedConfig, boardType == QGCSerialPortInfo::BoardTypePX4Flow);
+                        if (!createConnectedLink(sharedConfig, boardType == QGCSerialPortInfo::BoardTypePX4Flow)) {
+                            // Port may still be settling after the hotplug, try again next pass
+                            _serialPortsRecheck = true;
+                        }
                     }
                 }
             }
@@ -579,7 +644,7 @@ void LinkManager::_updateAutoConnectLinks(void)
 
 #ifndef __mobile__
     // Check for RTK GPS connection gone
-    if (!_autoConnectRTKPort.isEmpty() && !currentPorts.contains(_autoConnectRTKPort)) {
+    if (!_autoConnectRTKPort.isEmpty() && !_serialPorts.contains(_autoConnectRTKPort)) {
         qCDebug(LinkManagerLog) << "RTK GPS disconnected" << _autoConnectRTKPort;
         _toolbox->gpsManager()->disconnectGPS();
         _autoConnectRTKPort.clear();
@@ -617,8 +682,12 @@ QStringList LinkManager::linkTypeStrings(void) const
 #ifdef QT_DEBUG
         list += tr("Mock Link");
 #endif
-#ifndef __mobile__
         list += tr("Log Replay");
+#ifndef __mobile__
+        list += tr("Local Socket");
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+        list += tr("Taisync");
 #endif
         if (list.size() != static_cast<int>(LinkConfiguration::TypeLast)) {
             qWarning() << "Internal error";
@@ -767,6 +836,20 @@ void LinkManager::_fixUnnamed(LinkConfiguration* config)
                 }
             }
                 break;
+#ifndef __mobile__
+            case LinkConfiguration::TypeLocalSocket: {
+                LocalSocketConfiguration* tconfig = dynamic_cast<LocalSocketConfiguration*>(config);
+                if(tconfig) {
+                    config->setName(QString("Local Socket %1").arg(tconfig->socketName()));
+                }
+            }
+                break;
+#endif
+#if defined(QGC_GST_TAISYNC_ENABLED) && (defined(__ios__) || defined(__android__))
+            case LinkConfiguration::TypeTaisync:
+                config->setName(QString("Taisync Telemetry"));
+                break;
+#endif
 #ifdef QT_DEBUG
             case LinkConfiguration::TypeMock:
                 config->setName(QString("Mock Link"));
@@ -815,12 +898,7 @@ bool LinkManager::isBluetoothAvailable(void)
 
 bool LinkManager::containsLink(LinkInterface* link)
 {
-    for (int i=0; i<_rgLinks.count(); i++) {
-        if (_rgLinks[i].get() == link) {
-            return true;
-        }
-    }
-    return false;
+    return _linkLookup.contains(link);
 }
 
 SharedLinkConfigurationPtr LinkManager::addConfiguration(LinkConfiguration* config)
@@ -875,6 +953,21 @@ LogReplayLink* LinkManager::startLogReplay(const QString& logFile)
     }
 }
 
+#ifndef NO_SERIAL_LINK
+void LinkManager::_serialScanComplete(const SerialPortScanner::PortList_t& added, const QStringList& removed)
+{
+    _serialScanPending = false;
+
+    for (const QString& systemLocation: removed) {
+        _serialPorts.remove(systemLocation);
+        _autoconnectPortWaitList.remove(systemLocation);
+    }
+    for (const SerialPortScanner::Port_t& port: added) {
+        _serialPorts[port.info.systemLocation()] = port;
+    }
+}
+#endif
+
 bool LinkManager::_isSerialPortConnected(void)
 {
     for (SharedLinkInterfacePtr link: _rgLinks) {
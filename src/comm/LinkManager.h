@@ -9,9 +9,11 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QMultiMap>
 #include <QMutex>
+#include <QThread>
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
@@ -26,6 +28,8 @@
 
 #ifndef NO_SERIAL_LINK
     #include "SerialLink.h"
+    #include "SerialPortScanner.h"
+    #include "SerialPortWatcher.h"
 #endif
 
 Q_DECLARE_LOGGING_CATEGORY(LinkManagerLog)
@@ -99,8 +103,8 @@ public:
     // This should only be used by Qml code
     Q_INVOKABLE void createConnectedLink(LinkConfiguration* config);
 
-    /// Returns pointer to the mavlink forwarding link, or nullptr if it does not exist
-    SharedLinkInterfacePtr mavlinkForwardingLink();
+    /// Returns pointer to the mavlink forwarding link for the specified forwarding target, or nullptr if it does not exist
+    SharedLinkInterfacePtr mavlinkForwardingLink(int targetIndex = 0);
 
     void disconnectAll(void);
 
@@ -147,11 +151,13 @@ private:
     void                _removeConfiguration        (LinkConfiguration* config);
     void                _addUDPAutoConnectLink      (void);
     void                _addMAVLinkForwardingLink   (void);
+    QString             _mavlinkForwardingLinkNameForTarget(int targetIndex);
     void                _freeMavlinkChannel         (int channel);
     bool                _isSerialPortConnected      (void);
 
 #ifndef NO_SERIAL_LINK
     bool                _portAlreadyConnected       (const QString& portName);
+    void                _serialScanComplete         (const SerialPortScanner::PortList_t& added, const QStringList& removed);
 #endif
 
     bool                                _configUpdateSuspended;                     ///< true: stop updating configuration list
@@ -165,6 +171,7 @@ private:
     MAVLinkProtocol*                    _mavlinkProtocol;
 
     QList<SharedLinkInterfacePtr>       _rgLinks;
+    QHash<LinkInterface*, WeakLinkInterfacePtr> _linkLookup;                    ///< Same links as _rgLinks, for constant time lookup by pointer
     QList<SharedLinkConfigurationPtr>   _rgLinkConfigs;
     QString                             _autoConnectRTKPort;
     QmlObjectListModel                  _qmlConfigurations;
@@ -175,6 +182,13 @@ private:
 
 #ifndef NO_SERIAL_LINK
     QList<SerialLink*>                  _activeLinkCheckList;                   ///< List of links we are waiting for a vehicle to show up on
+    SerialPortWatcher                   _serialPortWatcher;
+    bool                                _serialPortsChanged = true;             ///< true: port list must be enumerated on the next autoconnect pass
+    bool                                _serialPortsRecheck = false;            ///< true: last pass left something to come back for (bootloader, failed connect)
+    QThread                             _serialScanThread;
+    SerialPortScanner*                  _serialPortScanner  = nullptr;          ///< Lives on _serialScanThread
+    bool                                _serialScanPending  = false;            ///< true: scan requested, scanComplete not back yet
+    QMap<QString, SerialPortScanner::Port_t> _serialPorts;                      ///< Ports from the scanner, key: systemLocation
 #endif
 
     // NMEA GPS device for GCS position
@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkReceiveBuffer.h"
+#include "QGCMAVLink.h"
+
+#include <QIODevice>
+
+#include <algorithm>
+#include <cstring>
+
+LinkReceiveBuffer::LinkReceiveBuffer(int capacity)
+    : _mask(0)
+{
+    uint32_t size = 1;
+    while (size < static_cast<uint32_t>(capacity)) {
+        size <<= 1;
+    }
+    _data.resize(size);
+    _mask = size - 1;
+}
+
+qint64 LinkReceiveBuffer::readFrom(QIODevice* device)
+{
+    qint64 total = 0;
+
+    // At most two contiguous spans: up to the physical end of the ring, then from the start
+    while (freeSpace() > 0) {
+        uint32_t    writeIndex  = _tail & _mask;
+        int         span        = std::min(freeSpace(), capacity() - static_cast<int>(writeIndex));
+        qint64      bytesRead   = device->read(&_data[writeIndex], span);
+
+        if (bytesRead < 0) {
+            return total ? total : -1;
+        }
+        _tail += static_cast<uint32_t>(bytesRead);
+        total += bytesRead;
+        if (bytesRead < span) {
+            break;
+        }
+    }
+
+    return total;
+}
+
+int LinkReceiveBuffer::write(const char* bytes, int length)
+{
+    int written = 0;
+
+    length = std::min(length, freeSpace());
+    while (written < length) {
+        uint32_t    writeIndex  = _tail & _mask;
+        int         span        = std::min(length - written, capacity() - static_cast<int>(writeIndex));
+
+        memcpy(&_data[writeIndex], bytes + written, static_cast<size_t>(span));
+        _tail   += static_cast<uint32_t>(span);
+        written += span;
+    }
+
+    return written;
+}
+
+/// @return Length of the frame (or single stray byte) starting at offset, 0 if the header is not complete yet
+int LinkReceiveBuffer::_frameLength(int offset) const
+{
+    int available = count() - offset;
+
+    switch (_peek(offset)) {
+    case MAVLINK_STX:
+        if (available < 3) {
+            return 0;
+        }
+        return MAVLINK_NUM_NON_PAYLOAD_BYTES + _peek(offset + 1) + ((_peek(offset + 2) & MAVLINK_IFLAG_SIGNED) ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+    case MAVLINK_STX_MAVLINK1:
+        if (available < 2) {
+            return 0;
+        }
+        return MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + _peek(offset + 1) + MAVLINK_NUM_CHECKSUM_BYTES;
+    default:
+        return 1;
+    }
+}
+
+int LinkReceiveBuffer::takeFrames(QByteArray& frames)
+{
+    int length = 0;
+
+    while (length < count()) {
+        int frameLength = _frameLength(length);
+        if (frameLength == 0 || length + frameLength > count()) {
+            break;
+        }
+        length += frameLength;
+    }
+    _take(frames, length);
+
+    return length;
+}
+
+int LinkReceiveBuffer::takeAll(QByteArray& bytes)
+{
+    int length = count();
+    _take(bytes, length);
+    return length;
+}
+
+void LinkReceiveBuffer::_take(QByteArray& bytes, int length)
+{
+    while (length > 0) {
+        uint32_t    readIndex   = _head & _mask;
+        int         span        = std::min(length, capacity() - static_cast<int>(readIndex));
+
+        bytes.append(&_data[readIndex], span);
+        _head  += static_cast<uint32_t>(span);
+        length -= span;
+    }
+}
@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+
+#include <cstdint>
+#include <vector>
+
+class QIODevice;
+
+/// Fixed size byte ring which collects incoming link data and hands it off on MAVLink frame boundaries.
+///
+/// The storage is allocated once and reused for the life of the link. Bytes which can not be the start of
+/// a MAVLink frame are passed through one at a time, the parser downstream deals with them. Not thread safe,
+/// it is meant to be owned by the single thread reading the link.
+class LinkReceiveBuffer
+{
+public:
+    /// @param capacity Size of the ring in bytes, rounded up to the next power of two
+    LinkReceiveBuffer(int capacity = defaultCapacity);
+
+    /// Reads as much as will fit from the device without blocking
+    /// @return Number of bytes read, -1 on device error
+    qint64 readFrom(QIODevice* device);
+
+    /// Appends bytes to the ring
+    /// @return Number of bytes appended, less than length if the ring filled up
+    int write(const char* bytes, int length);
+
+    /// Moves every complete frame at the front of the ring to the end of frames. A trailing partial frame stays in the ring.
+    /// @return Number of bytes moved
+    int takeFrames(QByteArray& frames);
+
+    /// Moves everything in the ring, including any partial frame, to the end of bytes
+    /// @return Number of bytes moved
+    int takeAll(QByteArray& bytes);
+
+    void    clear       (void) { _head = _tail = 0; }
+    int     count       (void) const { return static_cast<int>(_tail - _head); }
+    int     freeSpace   (void) const { return capacity() - count(); }
+    int     capacity    (void) const { return static_cast<int>(_mask + 1); }
+
+    static const int defaultCapacity = 16384;
+
+private:
+    uint8_t _peek       (int offset) const { return static_cast<uint8_t>(_data[(_head + static_cast<uint32_t>(offset)) & _mask]); }
+    int     _frameLength(int offset) const;
+    void    _take       (QByteArray& bytes, int length);
+
+    std::vector<char>   _data;
+    uint32_t            _mask;
+    uint32_t            _head = 0;  ///< Free running read position
+    uint32_t            _tail = 0;  ///< Free running write position
+};
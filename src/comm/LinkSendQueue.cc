@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkSendQueue.h"
+
+LinkSendQueue::LinkSendQueue(void)
+    : _head (&_stub)
+    , _tail (&_stub)
+    , _count(0)
+{
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+}
+
+LinkSendQueue::~LinkSendQueue()
+{
+    QByteArray bytes;
+    while (pop(bytes)) { }
+}
+
+void LinkSendQueue::push(const char* bytes, int length)
+{
+    Node_t* node = new Node_t;
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->bytes = QByteArray(bytes, length);
+
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _pushNode(node);
+}
+
+void LinkSendQueue::_pushNode(Node_t* node)
+{
+    Node_t* prev = _head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+/// Unlinks the next node from the queue, the caller owns the returned node
+LinkSendQueue::Node_t* LinkSendQueue::_popNode(void)
+{
+    Node_t* tail = _tail;
+    Node_t* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &_stub) {
+        if (!next) {
+            return nullptr;
+        }
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        _tail = next;
+        return tail;
+    }
+
+    if (tail != _head.load(std::memory_order_acquire)) {
+        // A producer has exchanged the head but not linked it yet
+        return nullptr;
+    }
+
+    // tail is the last node, put the stub back behind it so it can be unlinked
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+    _pushNode(&_stub);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        _tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+bool LinkSendQueue::pop(QByteArray& bytes)
+{
+    Node_t* node = _popNode();
+    if (!node) {
+        return false;
+    }
+
+    bytes = std::move(node->bytes);
+    delete node;
+    _count.fetch_sub(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+int LinkSendQueue::peekSize(void) const
+{
+    Node_t* tail = _tail;
+    if (tail == &_stub) {
+        tail = tail->next.load(std::memory_order_acquire);
+        if (!tail) {
+            return 0;
+        }
+    }
+    return tail->bytes.size();
+}
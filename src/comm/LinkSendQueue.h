@@ -0,0 +1,56 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+
+#include <atomic>
+
+/// Unbounded multiple-producer/single-consumer queue of outgoing frames for a link.
+///
+/// Any thread may push, only the link thread pops. Producers never block or take a lock: a push is a single
+/// atomic exchange. pop may transiently report empty while a producer is part way through a push, the
+/// producer is then responsible for scheduling another drain.
+class LinkSendQueue
+{
+public:
+    LinkSendQueue(void);
+    ~LinkSendQueue();
+
+    /// Producer side, may be called from any thread
+    void push(const char* bytes, int length);
+
+    /// Consumer side only
+    /// @return false: Queue is empty
+    bool pop(QByteArray& bytes);
+
+    /// Consumer side only
+    /// @return Size of the frame which the next pop will return, 0 if there is none
+    int peekSize(void) const;
+
+    /// Number of frames currently queued. Approximate while producers are active.
+    int count(void) const { return _count.load(std::memory_order_relaxed); }
+
+private:
+    struct Node_t {
+        std::atomic<Node_t*>    next;
+        QByteArray              bytes;
+    };
+
+    void    _pushNode   (Node_t* node);
+    Node_t* _popNode    (void);
+
+    Node_t                  _stub;
+    std::atomic<Node_t*>    _head;      ///< Last pushed node, exchanged by the producers
+    Node_t*                 _tail;      ///< Next node to pop, only touched by the consumer
+    std::atomic<int>        _count;
+
+    Q_DISABLE_COPY(LinkSendQueue)
+};
@@ -0,0 +1,225 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include <QDebug>
+#include <QLocalServer>
+#include <QSettings>
+
+#include "LocalSocketLink.h"
+
+const char* LocalSocketConfiguration::defaultSocketName = "qgroundcontrol-mavlink";
+
+LocalSocketLink::LocalSocketLink(SharedLinkConfigurationPtr& config)
+    : LinkInterface (config)
+    , _localConfig  (qobject_cast<LocalSocketConfiguration*>(config.get()))
+{
+    Q_ASSERT(_localConfig);
+    moveToThread(this);
+}
+
+LocalSocketLink::~LocalSocketLink()
+{
+    disconnect();
+}
+
+void LocalSocketLink::run(void)
+{
+    if (_hardwareConnect()) {
+        exec();
+    }
+
+    // The sockets belong to this thread, so they must go away before it finishes
+    _setSocket(nullptr);
+    if (_server) {
+        delete _server;
+        _server = nullptr;
+    }
+}
+
+bool LocalSocketLink::_connect(void)
+{
+    if (isRunning()) {
+        quit();
+        wait();
+    }
+    start(HighPriority);
+    return true;
+}
+
+void LocalSocketLink::disconnect(void)
+{
+    bool wasConnected = isRunning();
+
+    quit();
+    wait();
+    if (wasConnected) {
+        emit disconnected();
+    }
+}
+
+bool LocalSocketLink::isConnected(void) const
+{
+    return _socketIsConnected;
+}
+
+bool LocalSocketLink::_hardwareConnect(void)
+{
+    _readBuffer.reserve(_readBufferReserve);
+
+    if (_localConfig->listen()) {
+        _server = new QLocalServer();
+        // Clears out a socket file left behind by a previous run which did not shut down cleanly
+        QLocalServer::removeServer(_localConfig->socketName());
+        if (!_server->listen(_localConfig->socketName())) {
+            emit communicationError(tr("Link Error"), tr("Error on link %1. Unable to listen on %2: %3").arg(_config->name()).arg(_localConfig->socketName()).arg(_server->errorString()));
+            return false;
+        }
+        QObject::connect(_server, &QLocalServer::newConnection, this, &LocalSocketLink::_newConnection);
+        _socketIsConnected = true;
+        emit connected();
+        return true;
+    }
+
+    QLocalSocket* socket = new QLocalSocket();
+    socket->connectToServer(_localConfig->socketName());
+    if (!socket->waitForConnected(1000)) {
+        emit communicationError(tr("Link Error"), tr("Error on link %1. Unable to connect to %2: %3").arg(_config->name()).arg(_localConfig->socketName()).arg(socket->errorString()));
+        delete socket;
+        return false;
+    }
+    _setSocket(socket);
+    _socketIsConnected = true;
+    emit connected();
+    return true;
+}
+
+/// Replaces the current peer socket, if any
+void LocalSocketLink::_setSocket(QLocalSocket* socket)
+{
+    if (_socket) {
+        QObject::disconnect(_socket, nullptr, this, nullptr);
+        _socket->abort();
+        delete _socket;
+    }
+    _socket = socket;
+    if (_socket) {
+        QObject::connect(_socket, &QLocalSocket::readyRead, this, &LocalSocketLink::_readBytes);
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+        QObject::connect(_socket, static_cast<void (QLocalSocket::*)(QLocalSocket::LocalSocketError)>(&QLocalSocket::error), this, &LocalSocketLink::_socketError);
+#else
+        QObject::connect(_socket, &QLocalSocket::errorOccurred, this, &LocalSocketLink::_socketError);
+#endif
+    } else {
+        _socketIsConnected = false;
+    }
+}
+
+void LocalSocketLink::_newConnection(void)
+{
+    // Only a single peer is supported, a new connection replaces the old one
+    QLocalSocket* socket = _server->nextPendingConnection();
+    while (_server->hasPendingConnections()) {
+        delete socket;
+        socket = _server->nextPendingConnection();
+    }
+    if (socket) {
+        _setSocket(socket);
+        // The link stays usable while listening, the peer just comes and goes
+        _socketIsConnected = true;
+    }
+}
+
+void LocalSocketLink::_writeBytes(const QByteArray data)
+{
+    if (_socket && _socket->state() == QLocalSocket::ConnectedState) {
+        _socket->write(data);
+        emit bytesSent(this, data);
+    }
+}
+
+void LocalSocketLink::_readBytes(void)
+{
+    qint64 byteCount = _socket->bytesAvailable();
+    if (byteCount > 0) {
+        // The only receiver is connected directly, so once the signal returns the buffer is no longer shared and
+        // the next read can reuse its storage
+        _readBuffer.resize(static_cast<int>(byteCount));
+        _readBuffer.resize(static_cast<int>(_socket->read(_readBuffer.data(), _readBuffer.size())));
+        emit bytesReceived(this, _readBuffer);
+    }
+}
+
+void LocalSocketLink::_socketError(QLocalSocket::LocalSocketError socketError)
+{
+    if (_server && socketError == QLocalSocket::PeerClosedError) {
+        // Listening links simply wait for the next peer
+        return;
+    }
+    emit communicationError(tr("Link Error"), tr("Error on link %1. Error on socket: %2.").arg(_config->name()).arg(_socket->errorString()));
+}
+
+//--------------------------------------------------------------------------
+//-- LocalSocketConfiguration
+
+LocalSocketConfiguration::LocalSocketConfiguration(const QString& name)
+    : LinkConfiguration (name)
+    , _socketName       (defaultSocketName)
+{
+
+}
+
+LocalSocketConfiguration::LocalSocketConfiguration(LocalSocketConfiguration* source)
+    : LinkConfiguration (source)
+    , _socketName       (source->socketName())
+    , _listen           (source->listen())
+{
+
+}
+
+void LocalSocketConfiguration::copyFrom(LinkConfiguration *source)
+{
+    LinkConfiguration::copyFrom(source);
+    auto* lsource = qobject_cast<LocalSocketConfiguration*>(source);
+    Q_ASSERT(lsource != nullptr);
+    _socketName = lsource->socketName();
+    _listen     = lsource->listen();
+}
+
+void LocalSocketConfiguration::setSocketName(const QString& socketName)
+{
+    QString name = socketName.trimmed();
+    if (!name.isEmpty() && name != _socketName) {
+        _socketName = name;
+        emit socketNameChanged();
+    }
+}
+
+void LocalSocketConfiguration::setListen(bool listen)
+{
+    if (listen != _listen) {
+        _listen = listen;
+        emit listenChanged();
+    }
+}
+
+void LocalSocketConfiguration::saveSettings(QSettings& settings, const QString& root)
+{
+    settings.beginGroup(root);
+    settings.setValue("socketName", _socketName);
+    settings.setValue("listen",     _listen);
+    settings.endGroup();
+}
+
+void LocalSocketConfiguration::loadSettings(QSettings& settings, const QString& root)
+{
+    settings.beginGroup(root);
+    setSocketName(settings.value("socketName", _socketName).toString());
+    _listen = settings.value("listen", _listen).toBool();
+    settings.endGroup();
+}
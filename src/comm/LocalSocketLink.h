@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QLocalSocket>
+
+#include "QGCConfig.h"
+#include "LinkConfiguration.h"
+#include "LinkInterface.h"
+
+#include <atomic>
+
+class QLocalServer;
+
+/// Configuration for a link to MAVLink software running on the same machine. The link is a Unix domain socket
+/// (a named pipe on Windows), which avoids the loopback network stack a local UDP or TCP link goes through.
+class LocalSocketConfiguration : public LinkConfiguration
+{
+    Q_OBJECT
+
+public:
+    LocalSocketConfiguration(const QString& name);
+    LocalSocketConfiguration(LocalSocketConfiguration* source);
+
+    Q_PROPERTY(QString  socketName  READ socketName WRITE setSocketName NOTIFY socketNameChanged)   ///< Socket path, or name relative to the temp directory
+    Q_PROPERTY(bool     listen      READ listen     WRITE setListen     NOTIFY listenChanged)       ///< true: QGC creates the socket and waits for the peer to connect
+
+    const QString   socketName      (void) const { return _socketName; }
+    bool            listen          (void) const { return _listen; }
+    void            setSocketName   (const QString& socketName);
+    void            setListen       (bool listen);
+
+    //LinkConfiguration overrides
+    LinkType    type                (void) override                                         { return LinkConfiguration::TypeLocalSocket; }
+    void        copyFrom            (LinkConfiguration* source) override;
+    void        loadSettings        (QSettings& settings, const QString& root) override;
+    void        saveSettings        (QSettings& settings, const QString& root) override;
+    QString     settingsURL         (void) override                                         { return "LocalSocketSettings.qml"; }
+    QString     settingsTitle       (void) override                                         { return tr("Local Socket Link Settings"); }
+
+    static const char* defaultSocketName;
+
+signals:
+    void socketNameChanged  (void);
+    void listenChanged      (void);
+
+private:
+    QString _socketName;
+    bool    _listen         = false;
+};
+
+class LocalSocketLink : public LinkInterface
+{
+    Q_OBJECT
+
+public:
+    LocalSocketLink(SharedLinkConfigurationPtr& config);
+    virtual ~LocalSocketLink();
+
+    // LinkInterface overrides
+    bool isConnected(void) const override;
+    void disconnect (void) override;
+
+protected:
+    // QThread overrides
+    void run(void) override;
+
+private slots:
+    // LinkInterface overrides
+    void _writeBytes(const QByteArray data) override;
+
+    void _readBytes         (void);
+    void _newConnection     (void);
+    void _socketError       (QLocalSocket::LocalSocketError socketError);
+
+private:
+    // LinkInterface overrides
+    bool _connect(void) override;
+
+    bool _hardwareConnect   (void);
+    void _setSocket         (QLocalSocket* socket);
+
+    LocalSocketConfiguration*   _localConfig;
+    QLocalServer*               _server             = nullptr;
+    QLocalSocket*               _socket             = nullptr;
+    std::atomic<bool>           _socketIsConnected  { false };
+    QByteArray                  _readBuffer;                    ///< Reused for every read, its capacity only ever grows
+
+    static const int _readBufferReserve = 64 * 1024;
+};
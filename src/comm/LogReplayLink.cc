@@ -16,6 +16,8 @@
 #include <QtEndian>
 #include <QSignalSpy>
 
+#include <algorithm>
+
 const char*  LogReplayLinkConfiguration::_logFilenameKey = "logFilename";
 
 LogReplayLinkConfiguration::LogReplayLinkConfiguration(const QString& name)
@@ -66,6 +68,10 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     , _logReplayConfig  (qobject_cast<LogReplayLinkConfiguration*>(config.get()))
     , _connected        (false)
     , _playbackSpeed    (1)
+    , _mavlink          (qgcApp()->toolbox()->mavlinkProtocol())
+    , _logFileSize      (0)
+    , _logData          (nullptr)
+    , _logPos           (0)
 {
     if (!_logReplayConfig) {
         qWarning() << "Internal error";
@@ -145,106 +151,54 @@ void LogReplayLink::_writeBytes(const QByteArray bytes)
     Q_UNUSED(bytes);
 }
 
-/// Parses a BigEndian quint64 timestamp
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
+/// Parses the log entry (timestamp followed by a mavlink message) at the specified offset
+///     @param timestampUSecs[out] Timestamp for the entry
+///     @param messageOffset[out] Offset of the first byte of the message
+///     @param nextOffset[out] Offset of the next log entry
+/// @return false: No complete message was found before the end of the log
+bool LogReplayLink::_parseEntry(qint64 offset, quint64& timestampUSecs, qint64& messageOffset, qint64& nextOffset)
 {
-    quint64 timestamp = qFromBigEndian(*((quint64*)(bytes.constData())));
-    quint64 currentTimestamp = ((quint64)QDateTime::currentMSecsSinceEpoch()) * 1000;
-    
-    // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
-    // little endian, so switch it.
-    if (timestamp > currentTimestamp) {
-        timestamp = qbswap(timestamp);
-    }
-    
-    return timestamp;
+    return TelemetryLogIndex::parseEntry(_logData, static_cast<qint64>(_logFileSize), offset, timestampUSecs, messageOffset, nextOffset);
 }
 
-/// Reads the next mavlink message from the log
-///     @param bytes[output] Bytes for mavlink message
-/// @return Unix timestamp in microseconds UTC for NEXT mavlink message or 0 if no message found
-quint64 LogReplayLink::_readNextMavlinkMessage(QByteArray& bytes)
+/// Appends the next mavlink message from the log to bytes
+///     @param nextTimestampUSecs[out] Unix timestamp in microseconds UTC for the NEXT message, 0 if there are no more
+/// @return false: No message found
+bool LogReplayLink::_readNextMavlinkMessage(QByteArray& bytes, quint64& nextTimestampUSecs)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-
-    bytes.clear();
+    quint64 timestampUSecs;
+    qint64  messageOffset;
+    qint64  nextOffset;
 
-    while (_logFile.getChar(&nextByte)) { // Loop over every byte
-        mavlink_message_t message;
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &message, &status);
+    nextTimestampUSecs = 0;
 
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message, clear any partial bytes
-            bytes.clear();
-        }
-        bytes.append(nextByte);
-
-        if (messageFound) {
-            // Return the timestamp for the next message
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
-        }
+    if (!_parseEntry(_logPos, timestampUSecs, messageOffset, nextOffset)) {
+        _logPos = _logFileSize;
+        return false;
     }
 
-    return 0;
-}
-
-/// Seeks to the beginning of the next successfully parsed mavlink message in the log file.
-///     @param nextMsg[output] Parsed next message that was found
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_seekToNextMavlinkMessage(mavlink_message_t* nextMsg)
-{
-    char                nextByte;
-    mavlink_status_t    status;
-    qint64              messageStartPos = -1;
-
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    while (_logFile.getChar(&nextByte)) {
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, nextMsg, &status);
+    bytes.append(reinterpret_cast<const char*>(_logData + messageOffset), static_cast<int>(nextOffset - messageOffset));
+    _logPos = nextOffset;
 
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message
-            messageStartPos = _logFile.pos() - 1;
-        }
-        
-        // If we've found a message, jump back to the start of the message, grab the timestamp,
-        // and go back to the end of this file.
-        if (messageFound && messageStartPos != -1) {
-            _logFile.seek(messageStartPos - cbTimestamp);
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
-        }
+    if (!_atEnd()) {
+        nextTimestampUSecs = TelemetryLogIndex::parseTimestamp(_logData + _logPos);
     }
-    
-    return 0;
+
+    return true;
 }
 
-quint64 LogReplayLink::_findLastTimestamp(void)
+/// Loads the index of the log, which is built with a single pass through the log the first time it is played
+/// @return false: No messages found in log
+bool LogReplayLink::_buildIndex(void)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-    quint64             lastTimestamp = 0;
-    mavlink_message_t   msg;
-
-    // We read through the entire file looking for the last good timestamp. This can be somewhat slow, but trying to work from the
-    // end of the file can be way slower due to all the seeking back and forth required. So instead we take the simple reliable approach.
-
-    _logFile.reset();
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    while (_logFile.bytesAvailable() > cbTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(cbTimestamp));
-
-        bool endOfMessage = false;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
-        }
+    QString errorString;
+    if (!_logIndex.open(_logReplayConfig->logFilename(), _logData, static_cast<qint64>(_logFileSize), errorString)) {
+        return false;
     }
+    _logStartTimeUSecs  = _logIndex.startTimeUSecs();
+    _logEndTimeUSecs    = _logIndex.endTimeUSecs();
 
-    return lastTimestamp;
+    return true;
 }
 
 bool LogReplayLink::_loadLogFile(void)
@@ -253,8 +207,6 @@ bool LogReplayLink::_loadLogFile(void)
     QString logFilename = _logReplayConfig->logFilename();
     QFileInfo logFileInfo;
     int logDurationSecondsTotal;
-    quint64 startTimeUSecs;
-    quint64 endTimeUSecs;
 
     if (_logFile.isOpen()) {
         errorMsg = tr("Attempt to load new log while log being played");
@@ -268,23 +220,26 @@ bool LogReplayLink::_loadLogFile(void)
     }
     logFileInfo.setFile(logFilename);
     _logFileSize = logFileInfo.size();
-    
-    startTimeUSecs = _parseTimestamp(_logFile.read(cbTimestamp));
-    endTimeUSecs = _findLastTimestamp();
 
-    if (endTimeUSecs <= startTimeUSecs) {
+    // Mapping the file lets the OS page it in as needed, which is much faster than lots of small reads
+    _logData = _logFileSize ? _logFile.map(0, _logFileSize) : nullptr;
+    if (!_logData) {
+        _logBytes = _logFile.readAll();
+        _logFileSize = _logBytes.size();
+        _logData = reinterpret_cast<const uchar*>(_logBytes.constData());
+    }
+
+    if (!_buildIndex() || _logEndTimeUSecs <= _logStartTimeUSecs) {
         errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
         goto Error;
     }
 
     // Remember the start and end time so we can move around this _logFile with the slider.
-    _logEndTimeUSecs = endTimeUSecs;
-    _logStartTimeUSecs = startTimeUSecs;
-    _logDurationUSecs = endTimeUSecs - startTimeUSecs;
-    _logCurrentTimeUSecs = startTimeUSecs;
+    _logDurationUSecs = _logEndTimeUSecs - _logStartTimeUSecs;
+    _logCurrentTimeUSecs = _logStartTimeUSecs;
 
     // Reset our log file so when we go to read it for the first time, we start at the beginning.
-    _logFile.reset();
+    _logPos = 0;
 
     logDurationSecondsTotal = (_logDurationUSecs) / 1000000;
     
@@ -296,6 +251,9 @@ Error:
     if (_logFile.isOpen()) {
         _logFile.close();
     }
+    _logData = nullptr;
+    _logBytes.clear();
+    _logIndex.close();
     _replayError(errorMsg);
     return false;
 }
@@ -306,10 +264,15 @@ Error:
 /// induce a static drift into the log file replay.
 void LogReplayLink::_readNextLogEntry(void)
 {
+    if (_playbackSpeed <= 0) {
+        _readNextLogBatch();
+        return;
+    }
+
     QByteArray bytes;
 
     // Now parse MAVLink messages, grabbing their timestamps as we go. We stop once we
-    // have at least 3ms until the next one.
+    // have at least 3ms until the next one. All the messages read are sent as a single block.
 
     // We track what the next execution time should be in milliseconds, which we use to set
     // the next timer interrupt.
@@ -317,11 +280,11 @@ void LogReplayLink::_readNextLogEntry(void)
 
     while (timeToNextExecutionMSecs < 3) {
         // Read the next mavlink message from the log
-        qint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
-        emit bytesReceived(this, bytes);
-        emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
-
-        if (_logFile.atEnd()) {
+        quint64 nextTimeUSecs;
+        if (!_readNextMavlinkMessage(bytes, nextTimeUSecs) || nextTimeUSecs == 0) {
+            if (!bytes.isEmpty()) {
+                emit bytesReceived(this, bytes);
+            }
             _finishPlayback();
             return;
         }
@@ -338,12 +301,54 @@ void LogReplayLink::_readNextLogEntry(void)
         timeToNextExecutionMSecs = desiredCurrentTimeMSecs - currentTimeMSecs;
     }
 
+    emit bytesReceived(this, bytes);
+    _emitPlaybackPercentComplete();
     _signalCurrentLogTimeSecs();
 
     // And schedule the next execution of this function.
     _readTickTimer.start(timeToNextExecutionMSecs);
 }
 
+/// Plays back the log as fast as the main thread can process it. Messages are sent in batches, but never
+/// more than the receive queue for the link can hold without dropping messages.
+void LogReplayLink::_readNextLogBatch(void)
+{
+    if (_mavlink->pendingMessageCount(mavlinkChannel()) > _fastPlaybackMaxPendingMessages) {
+        // Main thread is behind, give it a chance to catch up
+        _readTickTimer.start(1);
+        return;
+    }
+
+    QByteArray  bytes;
+    quint64     nextTimeUSecs = 0;
+
+    bytes.reserve(_fastPlaybackBatchMessages * MAVLINK_MAX_PACKET_LEN);
+    for (int i=0; i<_fastPlaybackBatchMessages; i++) {
+        if (!_readNextMavlinkMessage(bytes, nextTimeUSecs) || nextTimeUSecs == 0) {
+            break;
+        }
+        _logCurrentTimeUSecs = nextTimeUSecs;
+    }
+
+    if (!bytes.isEmpty()) {
+        emit bytesReceived(this, bytes);
+    }
+    if (nextTimeUSecs == 0) {
+        _finishPlayback();
+        return;
+    }
+
+    _emitPlaybackPercentComplete();
+    _signalCurrentLogTimeSecs();
+
+    _readTickTimer.start(0);
+}
+
+void LogReplayLink::_emitPlaybackPercentComplete(void)
+{
+    emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
+}
+
 void LogReplayLink::_play(void)
 {
     qgcApp()->toolbox()->linkManager()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
@@ -352,7 +357,7 @@ void LogReplayLink::_play(void)
 #endif
     
     // Make sure we aren't at the end of the file, if we are, reset to the beginning and play from there.
-    if (_logFile.atEnd()) {
+    if (_atEnd()) {
         _resetPlaybackToBeginning();
     }
     
@@ -377,9 +382,7 @@ void LogReplayLink::_pause(void)
 
 void LogReplayLink::_resetPlaybackToBeginning(void)
 {
-    if (_logFile.isOpen()) {
-        _logFile.reset();
-    }
+    _logPos = 0;
     
     // And since we haven't starting playback, clear the time of initial playback and the current timestamp.
     _playbackStartTimeMSecs = 0;
@@ -398,6 +401,11 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
         }
     }
 
+    const QVector<TelemetryLogIndex::SeekEntry_t>& seekIndex = _logIndex.seekIndex();
+    if (seekIndex.isEmpty()) {
+        return;
+    }
+
     if (percentComplete < 0) {
         percentComplete = 0;
     }
@@ -405,47 +413,35 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
         percentComplete = 100;
     }
     
-    qreal percentCompleteMult = percentComplete / 100.0;
-    
-    // But if we have a timestamped MAVLink log, then actually aim to hit that percentage in terms of
-    // time through the file.
-    qint64 newFilePos = (qint64)(percentCompleteMult * (qreal)_logFile.size());
+    quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((percentComplete / 100.0) * _logDurationUSecs);
 
-    // Now seek to the appropriate position, failing gracefully if we can't.
-    if (!_logFile.seek(newFilePos)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
+    // Find the last indexed entry at or before the desired time
+    auto indexEntry = std::upper_bound(seekIndex.constBegin(), seekIndex.constEnd(), desiredTimeUSecs,
+                                       [](quint64 timestampUSecs, const TelemetryLogIndex::SeekEntry_t& entry) { return timestampUSecs < entry.timestampUSecs; });
+    if (indexEntry != seekIndex.constBegin()) {
+        indexEntry--;
     }
 
-    // But we do align to the next MAVLink message for consistency.
-    mavlink_message_t dummy;
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
-
-    // Now calculate the current file location based on time.
-    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
-
-    // Calculate the effective baud rate of the file in bytes/s.
-    qreal baudRate = _logFile.size() / (qreal)_logDurationUSecs / 1e6;
-
-    // And the desired time is:
-    qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
-
-    // And now jump the necessary number of bytes in the proper direction
-    qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
+    // Then walk forward, at most TelemetryLogIndex::seekStride entries, to the first message at or after the desired time
+    qint64  offset          = indexEntry->offset;
+    quint64 timestampUSecs  = indexEntry->timestampUSecs;
+    qint64  messageOffset;
+    qint64  nextOffset;
+    bool    found           = false;
+    while (_parseEntry(offset, timestampUSecs, messageOffset, nextOffset)) {
+        if (timestampUSecs >= desiredTimeUSecs) {
+            found = true;
+            break;
+        }
+        offset = nextOffset;
     }
 
-    // And scan until we reach the start of a MAVLink message. We make sure to record this timestamp for
-    // smooth jumping around the file.
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
+    _logPos = found ? offset : static_cast<qint64>(_logFileSize);
+    _logCurrentTimeUSecs = found ? timestampUSecs : _logEndTimeUSecs;
     _signalCurrentLogTimeSecs();
 
     // Now update the UI with our actual final position.
-    newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
-    percentComplete = (newRelativeTimeUSecs / _logDurationUSecs) * 100;
-    emit playbackPercentCompleteChanged(percentComplete);
+    _emitPlaybackPercentComplete();
 }
 
 void LogReplayLink::_setPlaybackSpeed(qreal playbackSpeed)
@@ -10,9 +10,11 @@
 #pragma once
 
 #include "MAVLinkProtocol.h"
+#include "TelemetryLogIndex.h"
 
 #include <QTimer>
 #include <QFile>
+#include <QVector>
 
 class LinkManager;
 
@@ -69,7 +71,8 @@ public:
     void disconnect (void) override;
 
 public slots:
-    /// Sets the acceleration factor: -100: 0.01X, 0: 1.0X, 100: 100.0X
+    /// Sets the playback speed multiplier: 0.1: 0.1X, 1: 1.0X, 5: 5.0X. A value of 0 plays back as fast as the
+    /// rest of the application can consume the messages.
     void setPlaybackSpeed(qreal playbackSpeed) { emit _setPlaybackSpeedOnThread(playbackSpeed); }
 
 signals:
@@ -100,11 +103,13 @@ private:
     bool _connect(void) override;
 
     void    _replayError                (const QString& errorMsg);
-    quint64 _parseTimestamp             (const QByteArray& bytes);
-    quint64 _seekToNextMavlinkMessage   (mavlink_message_t* nextMsg);
-    quint64 _findLastTimestamp          (void);
-    quint64 _readNextMavlinkMessage     (QByteArray& bytes);
+    bool    _parseEntry                 (qint64 offset, quint64& timestampUSecs, qint64& messageOffset, qint64& nextOffset);
+    bool    _readNextMavlinkMessage     (QByteArray& bytes, quint64& nextTimestampUSecs);
+    bool    _buildIndex                 (void);
     bool    _loadLogFile                (void);
+    bool    _atEnd                      (void) const { return _logPos + cbTimestamp >= static_cast<qint64>(_logFileSize); }
+    void    _readNextLogBatch           (void);
+    void    _emitPlaybackPercentComplete(void);
     void    _finishPlayback             (void);
     void    _resetPlaybackToBeginning   (void);
     void    _signalCurrentLogTimeSecs   (void);
@@ -115,7 +120,6 @@ private:
     LogReplayLinkConfiguration* _logReplayConfig;
 
     bool    _connected;
-    uint8_t _mavlinkChannel;
     QTimer  _readTickTimer;      ///< Timer which signals a read of next log record
 
     QString _errorTitle; ///< Title for communicatorError signals
@@ -129,11 +133,17 @@ private:
     quint64 _playbackStartTimeMSecs;    ///< The time when the logfile was first played back. This is used to pace out replaying the messages to fix long-term drift/skew. 0 indicates that the player hasn't initiated playback of this log file.
     quint64 _playbackStartLogTimeUSecs;
 
-    MAVLinkProtocol*    _mavlink;
-    QFile               _logFile;
-    quint64             _logFileSize;
-
-    static const int cbTimestamp = sizeof(quint64);
+    MAVLinkProtocol*        _mavlink;
+    QFile                   _logFile;
+    quint64                 _logFileSize;
+    const uchar*            _logData;       ///< Memory mapped log file contents
+    QByteArray              _logBytes;      ///< Holds the log contents if the file could not be mapped
+    qint64                  _logPos;        ///< Offset of the next log entry to play
+    TelemetryLogIndex       _logIndex;      ///< Used to seek by time
+
+    static const int cbTimestamp                        = sizeof(quint64);
+    static const int _fastPlaybackBatchMessages         = MAVLinkMessageRing::defaultCapacity / 4;  ///< Messages per bytesReceived in fast playback
+    static const int _fastPlaybackMaxPendingMessages    = MAVLinkMessageRing::defaultCapacity / 2;  ///< Fast playback waits while more than this are queued for the main thread
 };
 
 class LogReplayLinkController : public QObject
@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkChannelStats.h"
+
+#include <algorithm>
+#include <cstring>
+
+MAVLinkChannelStats::MAVLinkChannelStats(void)
+{
+    _components.reserve(8);
+}
+
+void MAVLinkChannelStats::reset(void)
+{
+    _components.clear();
+    _lastUsedIndex = 0;
+}
+
+MAVLinkChannelStats::Component_t& MAVLinkChannelStats::_component(uint16_t key, bool& created)
+{
+    created = false;
+
+    if (_lastUsedIndex < _components.size() && _components[_lastUsedIndex].key == key) {
+        return _components[_lastUsedIndex];
+    }
+    for (size_t i=0; i<_components.size(); i++) {
+        if (_components[i].key == key) {
+            _lastUsedIndex = i;
+            return _components[i];
+        }
+    }
+
+    Component_t component;
+    memset(&component, 0, sizeof(component));
+    component.key = key;
+    _components.push_back(component);
+    _lastUsedIndex = _components.size() - 1;
+    created = true;
+
+    return _components.back();
+}
+
+uint32_t MAVLinkChannelStats::update(const mavlink_message_t& message, int64_t nowMSecs)
+{
+    bool            created;
+    Component_t&    component   = _component(static_cast<uint16_t>((message.sysid << 8) | message.compid), created);
+    uint32_t        lost        = 0;
+    uint32_t        gapMSecs    = 0;
+
+    if (created) {
+        component.firstMessageMSecs = nowMSecs;
+    } else {
+        // Sequence numbers wrap at 256, so the unsigned 8 bit difference is the gap size. A repeated sequence
+        // number is a duplicate rather than a 255 message gap.
+        if (message.seq != component.lastSeq) {
+            lost = static_cast<uint8_t>(message.seq - static_cast<uint8_t>(component.lastSeq + 1));
+        }
+        gapMSecs = static_cast<uint32_t>(nowMSecs - component.lastMessageMSecs);
+    }
+    component.lastSeq           = message.seq;
+    component.lastMessageMSecs  = nowMSecs;
+    component.totalReceived++;
+    component.totalLost += lost;
+
+    int64_t     epoch   = nowMSecs / windowBucketMSecs;
+    Bucket_t&   bucket  = component.buckets[epoch % windowBucketCount];
+    if (bucket.epoch != epoch) {
+        bucket.epoch        = epoch;
+        bucket.received     = 0;
+        bucket.lost         = 0;
+        bucket.maxGapMSecs  = 0;
+    }
+    bucket.received++;
+    bucket.lost += lost;
+    if (gapMSecs > bucket.maxGapMSecs) {
+        bucket.maxGapMSecs = gapMSecs;
+    }
+
+    return lost;
+}
+
+/// Adds the component's totals and the buckets which are still inside the window into stats
+void MAVLinkChannelStats::_accumulate(const Component_t& component, int64_t nowMSecs, Stats_t& stats, uint32_t& windowMSecs) const
+{
+    int64_t epoch = nowMSecs / windowBucketMSecs;
+
+    stats.totalReceived += component.totalReceived;
+    stats.totalLost     += component.totalLost;
+
+    for (int i=0; i<windowBucketCount; i++) {
+        const Bucket_t& bucket = component.buckets[i];
+        if (bucket.received && epoch - bucket.epoch < windowBucketCount) {
+            stats.windowReceived    += bucket.received;
+            stats.windowLost        += bucket.lost;
+            if (bucket.maxGapMSecs > stats.windowMaxGapMSecs) {
+                stats.windowMaxGapMSecs = bucket.maxGapMSecs;
+            }
+        }
+    }
+
+    // The current bucket is only partially filled, so the window covers the completed buckets plus the part of
+    // the current one which has elapsed. A component heard only recently has a correspondingly shorter window.
+    int64_t windowStartMSecs = (epoch - (windowBucketCount - 1)) * windowBucketMSecs;
+    if (component.firstMessageMSecs > windowStartMSecs) {
+        windowStartMSecs = component.firstMessageMSecs;
+    }
+    uint32_t componentWindowMSecs = static_cast<uint32_t>(std::max(nowMSecs - windowStartMSecs, static_cast<int64_t>(1)));
+    if (componentWindowMSecs > windowMSecs) {
+        windowMSecs = componentWindowMSecs;
+    }
+}
+
+void MAVLinkChannelStats::_finalize(Stats_t& stats, uint32_t windowMSecs)
+{
+    uint64_t windowTotal = static_cast<uint64_t>(stats.windowReceived) + stats.windowLost;
+
+    stats.windowLossPermille    = windowTotal ? static_cast<uint32_t>((static_cast<uint64_t>(stats.windowLost) * 1000) / windowTotal) : 0;
+    stats.windowRateMilliHz     = windowMSecs ? static_cast<uint32_t>((static_cast<uint64_t>(stats.windowReceived) * 1000 * 1000) / windowMSecs) : 0;
+}
+
+MAVLinkChannelStats::Stats_t MAVLinkChannelStats::systemStats(uint8_t sysid, int64_t nowMSecs) const
+{
+    Stats_t     stats;
+    uint32_t    windowMSecs = 0;
+
+    memset(&stats, 0, sizeof(stats));
+    for (const Component_t& component: _components) {
+        if ((component.key >> 8) == sysid) {
+            _accumulate(component, nowMSecs, stats, windowMSecs);
+        }
+    }
+    _finalize(stats, windowMSecs);
+
+    return stats;
+}
+
+MAVLinkChannelStats::Stats_t MAVLinkChannelStats::componentStats(uint8_t sysid, uint8_t compid, int64_t nowMSecs) const
+{
+    Stats_t     stats;
+    uint32_t    windowMSecs = 0;
+    uint16_t    key         = static_cast<uint16_t>((sysid << 8) | compid);
+
+    memset(&stats, 0, sizeof(stats));
+    for (const Component_t& component: _components) {
+        if (component.key == key) {
+            _accumulate(component, nowMSecs, stats, windowMSecs);
+            break;
+        }
+    }
+    _finalize(stats, windowMSecs);
+
+    return stats;
+}
+
+uint64_t MAVLinkChannelStats::systemReceivedCount(uint8_t sysid) const
+{
+    uint64_t received = 0;
+
+    for (const Component_t& component: _components) {
+        if ((component.key >> 8) == sysid) {
+            received += component.totalReceived;
+        }
+    }
+
+    return received;
+}
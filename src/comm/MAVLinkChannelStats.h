@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "QGCMAVLink.h"
+
+/// Sequence and loss statistics for the components heard on a single mavlink channel.
+///
+/// Only the components actually seen on the channel are stored, in a small flat array which is searched
+/// linearly with the most recently used entry checked first. Updates only use integer math. Along with the
+/// totals since the channel was reset, each component keeps a sliding window of message counts so that
+/// loss and rate reflect current link quality rather than the whole session.
+class MAVLinkChannelStats
+{
+public:
+    typedef struct {
+        uint64_t    totalReceived;
+        uint64_t    totalLost;
+        uint32_t    windowReceived;         ///< Messages received within the window
+        uint32_t    windowLost;             ///< Messages lost within the window
+        uint32_t    windowLossPermille;     ///< windowLost / (windowReceived + windowLost) in 1/1000 units
+        uint32_t    windowRateMilliHz;      ///< Receive rate within the window in 1/1000 messages per second
+        uint32_t    windowMaxGapMSecs;      ///< Longest time between two consecutive messages within the window
+    } Stats_t;
+
+    MAVLinkChannelStats(void);
+
+    /// Discards the statistics for all components
+    void reset(void);
+
+    /// Accounts for a received message
+    ///     @param nowMSecs Monotonic time in milliseconds
+    /// @return Number of messages lost in the sequence gap prior to this message
+    uint32_t update(const mavlink_message_t& message, int64_t nowMSecs);
+
+    /// @return Statistics for all components of the specified system combined
+    Stats_t systemStats(uint8_t sysid, int64_t nowMSecs) const;
+
+    /// @return Statistics for a single component
+    Stats_t componentStats(uint8_t sysid, uint8_t compid, int64_t nowMSecs) const;
+
+    /// @return Total number of messages received for the specified system
+    uint64_t systemReceivedCount(uint8_t sysid) const;
+
+    static const int        windowBucketCount   = 5;
+    static const int64_t    windowBucketMSecs   = 1000;
+
+private:
+    typedef struct {
+        int64_t     epoch;      ///< nowMSecs / windowBucketMSecs for the time the bucket was last filled
+        uint32_t    received;
+        uint32_t    lost;
+        uint32_t    maxGapMSecs;
+    } Bucket_t;
+
+    typedef struct {
+        uint16_t    key;                ///< (sysid << 8) | compid
+        uint8_t     lastSeq;
+        int64_t     firstMessageMSecs;
+        int64_t     lastMessageMSecs;
+        uint64_t    totalReceived;
+        uint64_t    totalLost;
+        Bucket_t    buckets[windowBucketCount];
+    } Component_t;
+
+    Component_t&    _component      (uint16_t key, bool& created);
+    void            _accumulate     (const Component_t& component, int64_t nowMSecs, Stats_t& stats, uint32_t& windowMSecs) const;
+    static void     _finalize       (Stats_t& stats, uint32_t windowMSecs);
+
+    std::vector<Component_t>    _components;
+    size_t                      _lastUsedIndex = 0;
+};
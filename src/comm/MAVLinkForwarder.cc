@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkForwarder.h"
+#include "LinkManager.h"
+#include "AppSettings.h"
+
+MAVLinkForwarder::MAVLinkForwarder(LinkManager* linkManager, AppSettings* appSettings, QObject* parent)
+    : QObject       (parent)
+    , _linkManager  (linkManager)
+{
+    connect(appSettings->forwardMavlink(),          &Fact::rawValueChanged, this, &MAVLinkForwarder::_enabledChanged);
+    connect(appSettings->forwardMavlinkHostName(),  &Fact::rawValueChanged, this, &MAVLinkForwarder::_targetsChanged);
+
+    _enabledChanged(appSettings->forwardMavlink()->rawValue());
+    _targetsChanged(appSettings->forwardMavlinkHostName()->rawValue());
+}
+
+QList<MAVLinkForwarder::Target_t> MAVLinkForwarder::parseTargets(const QString& targetsSetting)
+{
+    QList<Target_t> targets;
+
+    for (const QString& targetString: targetsSetting.split(';', QString::SkipEmptyParts)) {
+        Target_t    target;
+        QStringList parts = targetString.trimmed().split('@');
+
+        target.hostName = parts[0].trimmed();
+        if (target.hostName.isEmpty()) {
+            continue;
+        }
+        if (parts.count() > 1) {
+            for (const QString& messageIdString: parts[1].split(',', QString::SkipEmptyParts)) {
+                bool        ok;
+                uint32_t    messageId = messageIdString.trimmed().toUInt(&ok);
+                if (ok) {
+                    target.messageIds.insert(messageId);
+                } else {
+                    qWarning() << "MAVLinkForwarder: Invalid message id in forwarding target" << targetString;
+                }
+            }
+        }
+        targets.append(target);
+    }
+
+    return targets;
+}
+
+void MAVLinkForwarder::_enabledChanged(QVariant value)
+{
+    _enabled = value.toBool();
+    if (!_enabled) {
+        for (TargetState_t& targetState: _targets) {
+            targetState.pendingBytes.clear();
+        }
+    }
+}
+
+void MAVLinkForwarder::_targetsChanged(QVariant value)
+{
+    _targets.clear();
+    for (const Target_t& target: parseTargets(value.toString())) {
+        TargetState_t targetState;
+        targetState.target = target;
+        _targets.append(targetState);
+    }
+}
+
+SharedLinkInterfacePtr MAVLinkForwarder::_targetLink(int targetIndex)
+{
+    TargetState_t& targetState = _targets[targetIndex];
+
+    SharedLinkInterfacePtr forwardingLink = targetState.link.lock();
+    if (!forwardingLink) {
+        forwardingLink = _linkManager->mavlinkForwardingLink(targetIndex);
+        targetState.link = forwardingLink;
+    }
+    return forwardingLink;
+}
+
+bool MAVLinkForwarder::_isForwardingLink(LinkInterface* link)
+{
+    for (int i=0; i<_targets.count(); i++) {
+        if (_targetLink(i).get() == link) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MAVLinkForwarder::forward(LinkInterface* sourceLink, const mavlink_message_t& message)
+{
+    if (!_enabled || _targets.isEmpty() || _isForwardingLink(sourceLink)) {
+        return;
+    }
+
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    int     len = -1;
+
+    for (TargetState_t& targetState: _targets) {
+        if (!targetState.target.messageIds.isEmpty() && !targetState.target.messageIds.contains(message.msgid)) {
+            continue;
+        }
+        // Only encode once no matter how many targets the message goes to
+        if (len == -1) {
+            len = mavlink_msg_to_send_buffer(buf, &message);
+        }
+        targetState.pendingBytes.append(reinterpret_cast<const char*>(buf), len);
+    }
+}
+
+void MAVLinkForwarder::flush(void)
+{
+    for (int i=0; i<_targets.count(); i++) {
+        TargetState_t& targetState = _targets[i];
+
+        if (targetState.pendingBytes.isEmpty()) {
+            continue;
+        }
+
+        SharedLinkInterfacePtr forwardingLink = _targetLink(i);
+        if (forwardingLink) {
+            forwardingLink->writeBytesThreadSafe(targetState.pendingBytes.constData(), targetState.pendingBytes.size());
+        }
+        targetState.pendingBytes.resize(0);
+    }
+}
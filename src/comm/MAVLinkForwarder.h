@@ -0,0 +1,73 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include "QGCMAVLink.h"
+#include "LinkInterface.h"
+
+class AppSettings;
+class LinkManager;
+
+/// Forwards received MAVLink traffic to the MAVLink forwarding links.
+///
+/// The forwarding settings are cached and updated as they change. Each forwarding target can restrict which message
+/// ids it receives. Messages are encoded once and appended to a per target batch which is written to the target link
+/// in a single write when flush is called.
+///
+/// The forwarding host name setting holds the targets separated by ';'. Each target is host:port optionally followed
+/// by '@' and a comma separated list of message ids, i.e: localhost:14445;192.168.1.10:14550@0,30,33
+class MAVLinkForwarder : public QObject
+{
+    Q_OBJECT
+
+public:
+    MAVLinkForwarder(LinkManager* linkManager, AppSettings* appSettings, QObject* parent = nullptr);
+
+    typedef struct {
+        QString         hostName;   ///< host:port
+        QSet<uint32_t>  messageIds; ///< Empty: all messages are forwarded
+    } Target_t;
+
+    /// Parses the forwarding host name setting into the list of targets
+    static QList<Target_t> parseTargets(const QString& targetsSetting);
+
+    bool enabled(void) const { return _enabled; }
+
+    /// Queues the message for each target it should go to
+    ///     @param sourceLink Link the message was received on. Traffic from a forwarding link is never forwarded.
+    void forward(LinkInterface* sourceLink, const mavlink_message_t& message);
+
+    /// Writes out the queued batches
+    void flush(void);
+
+private slots:
+    void _enabledChanged    (QVariant value);
+    void _targetsChanged    (QVariant value);
+
+private:
+    typedef struct {
+        Target_t            target;
+        QByteArray          pendingBytes;
+        WeakLinkInterfacePtr link;
+    } TargetState_t;
+
+    SharedLinkInterfacePtr  _targetLink         (int targetIndex);
+    bool                    _isForwardingLink   (LinkInterface* link);
+
+    LinkManager*            _linkManager;
+    bool                    _enabled = false;
+    QList<TargetState_t>    _targets;
+};
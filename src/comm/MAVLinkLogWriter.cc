@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QDateTime>
+#include <QtEndian>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+QGC_LOGGING_CATEGORY(MAVLinkLogWriterLog, "MAVLinkLogWriterLog")
+
+MAVLinkLogWriter::MAVLinkLogWriter(QObject* parent)
+    : QThread           (parent)
+    , _epochBaseUsecs   (static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000)
+{
+    _monotonicClock.start();
+}
+
+MAVLinkLogWriter::~MAVLinkLogWriter()
+{
+    stopLogging();
+}
+
+quint64 MAVLinkLogWriter::timestampUsecs(void) const
+{
+    return _epochBaseUsecs + static_cast<quint64>(_monotonicClock.nsecsElapsed() / 1000);
+}
+
+void MAVLinkLogWriter::startLogging(QFile* file)
+{
+    stopLogging();
+
+    QMutexLocker locker(&_mutex);
+
+    _file           = file;
+    _stopRequested  = false;
+    _writeFailed    = false;
+    _droppedBytes   = 0;
+    _pendingBuffer.reserve(_chunkSize * 2);
+    _writeBuffer.reserve(_chunkSize * 2);
+    _lastSync.start();
+
+    locker.unlock();
+
+    start(QThread::LowPriority);
+}
+
+void MAVLinkLogWriter::stopLogging(void)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (!_file) {
+        return;
+    }
+    _stopRequested = true;
+    _bufferReady.wakeAll();
+
+    locker.unlock();
+
+    wait();
+
+    locker.relock();
+    if (!_writeFailed) {
+        _file->flush();
+    }
+    if (_droppedBytes) {
+        qCWarning(MAVLinkLogWriterLog) << "Log writer could not keep up, dropped bytes:" << _droppedBytes;
+    }
+    _file = nullptr;
+    _pendingBuffer.resize(0);
+}
+
+void MAVLinkLogWriter::logMessage(const mavlink_message_t& message)
+{
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN + sizeof(quint64)];
+
+    // Write the uint64 time in microseconds in big endian format before the message.
+    // This timestamp is saved in UTC time.
+    qToBigEndian(timestampUsecs(), buf);
+
+    int len = mavlink_msg_to_send_buffer(buf + sizeof(quint64), &message);
+    _appendEntry(reinterpret_cast<const char*>(buf), len + static_cast<int>(sizeof(quint64)));
+}
+
+void MAVLinkLogWriter::logBytes(const QByteArray& bytes)
+{
+    QByteArray entry(static_cast<int>(sizeof(quint64)) + bytes.size(), Qt::Uninitialized);
+
+    qToBigEndian(timestampUsecs(), entry.data());
+    memcpy(entry.data() + sizeof(quint64), bytes.constData(), static_cast<size_t>(bytes.size()));
+    _appendEntry(entry.constData(), entry.size());
+}
+
+void MAVLinkLogWriter::_appendEntry(const char* bytes, int length)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (!_file || _stopRequested || _writeFailed) {
+        return;
+    }
+    if (_pendingBuffer.size() + length > _maxPendingSize) {
+        _droppedBytes += static_cast<quint64>(length);
+        return;
+    }
+
+    _pendingBuffer.append(bytes, length);
+    if (_pendingBuffer.size() >= _chunkSize) {
+        _bufferReady.wakeAll();
+    }
+}
+
+void MAVLinkLogWriter::run(void)
+{
+    QMutexLocker locker(&_mutex);
+
+    while (true) {
+        if (!_stopRequested && _pendingBuffer.size() < _chunkSize) {
+            _bufferReady.wait(&_mutex, _flushTimeoutMSecs);
+        }
+
+        // Producers keep appending to the other buffer while this one is written out
+        bool stop = _stopRequested;
+        _writeBuffer.swap(_pendingBuffer);
+
+        locker.unlock();
+
+        bool success = true;
+        if (_writeBuffer.size()) {
+            success = _writeToFile(_writeBuffer);
+            _writeBuffer.resize(0);
+        }
+        if (success && _syncIntervalMSecs > 0 && _lastSync.elapsed() > _syncIntervalMSecs) {
+            _syncFile();
+            _lastSync.restart();
+        }
+
+        locker.relock();
+
+        if (!success) {
+            _writeFailed = true;
+            _pendingBuffer.resize(0);
+            locker.unlock();
+            emit writeError(_file->errorString());
+            return;
+        }
+        if (stop) {
+            break;
+        }
+    }
+}
+
+bool MAVLinkLogWriter::_writeToFile(const QByteArray& buffer)
+{
+    return _file->write(buffer) == buffer.size();
+}
+
+void MAVLinkLogWriter::_syncFile(void)
+{
+    _file->flush();
+#ifdef Q_OS_UNIX
+    ::fsync(_file->handle());
+#endif
+}
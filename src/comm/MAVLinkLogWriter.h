@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QFile>
+#include <QLoggingCategory>
+
+#include "QGCMAVLink.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkLogWriterLog)
+
+/// Writes the telemetry log on its own thread.
+///
+/// Log entries are appended to an in memory buffer which the writer thread swaps out and writes to disk in large
+/// chunks. Producers never wait on the disk, if the writer falls too far behind new entries are dropped and counted.
+/// Each entry is a big endian uint64 timestamp in microseconds since epoch followed by the raw MAVLink frame, which
+/// is the format read by LogReplayLink.
+class MAVLinkLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    MAVLinkLogWriter(QObject* parent = nullptr);
+    ~MAVLinkLogWriter();
+
+    /// Starts writing to the specified file, which must already be open
+    void startLogging(QFile* file);
+
+    /// Writes out all queued entries and returns once the writer thread no longer uses the file
+    void stopLogging(void);
+
+    bool isLogging(void) const { return _file != nullptr; }
+
+    /// Thread safe. Queues a timestamped entry for the message.
+    void logMessage(const mavlink_message_t& message);
+
+    /// Thread safe. Queues a timestamped entry for already encoded bytes.
+    void logBytes(const QByteArray& bytes);
+
+    /// Sets how often the file is synced to storage. 0 leaves it to the OS.
+    void setSyncIntervalMSecs(int syncIntervalMSecs) { _syncIntervalMSecs = syncIntervalMSecs; }
+
+    /// @return Microseconds since epoch. This comes from a monotonic clock anchored to UTC when the writer was created,
+    ///         so it has microsecond resolution and never jumps backwards.
+    quint64 timestampUsecs(void) const;
+
+    quint64 droppedBytes(void) const { return _droppedBytes; }
+
+signals:
+    /// Emitted from the writer thread if the file can't be written, logging stops after this
+    void writeError(QString errorString);
+
+protected:
+    // Overrides from QThread
+    void run(void) override;
+
+private:
+    void _appendEntry   (const char* bytes, int length);
+    bool _writeToFile   (const QByteArray& buffer);
+    void _syncFile      (void);
+
+    QFile*          _file = nullptr;
+    QMutex          _mutex;
+    QWaitCondition  _bufferReady;               ///< Signals the writer thread that there is work or it should stop
+    QByteArray      _pendingBuffer;             ///< Producers append here, protected by _mutex
+    QByteArray      _writeBuffer;               ///< Only touched by the writer thread
+    bool            _stopRequested      = false;
+    bool            _writeFailed        = false;
+    quint64         _droppedBytes       = 0;
+    int             _syncIntervalMSecs  = 0;
+    quint64         _epochBaseUsecs;
+    QElapsedTimer   _monotonicClock;
+    QElapsedTimer   _lastSync;
+
+    static const int _chunkSize         = 64 * 1024;        ///< Writer wakes up once this much is queued
+    static const int _maxPendingSize    = 8 * 1024 * 1024;  ///< Entries are dropped past this point
+    static const int _flushTimeoutMSecs = 250;              ///< Longest time an entry sits in memory
+};
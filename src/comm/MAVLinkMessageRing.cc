@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageRing.h"
+
+MAVLinkMessageRing::MAVLinkMessageRing(uint32_t capacity)
+    : _mask         (0)
+    , _head         (0)
+    , _tail         (0)
+    , _droppedCount (0)
+{
+    uint32_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    _messages.resize(size);
+    _mask = size - 1;
+}
+
+bool MAVLinkMessageRing::push(const mavlink_message_t& message)
+{
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    uint32_t tail = _tail.load(std::memory_order_acquire);
+
+    if (head - tail > _mask) {
+        _droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    _messages[head & _mask] = message;
+    _head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool MAVLinkMessageRing::pop(mavlink_message_t& message)
+{
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t head = _head.load(std::memory_order_acquire);
+
+    if (tail == head) {
+        return false;
+    }
+
+    message = _messages[tail & _mask];
+    _tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+void MAVLinkMessageRing::discard(void)
+{
+    _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+bool MAVLinkMessageRing::isEmpty(void) const
+{
+    return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+}
+
+uint32_t MAVLinkMessageRing::count(void) const
+{
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+}
@@ -0,0 +1,52 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "QGCMAVLink.h"
+
+/// Bounded single-producer/single-consumer ring of parsed MAVLink messages.
+///
+/// The producer is the thread which parses the incoming bytes for a link, the consumer is the main thread.
+/// Neither side blocks or takes a lock. If the consumer falls behind, new messages are dropped and counted
+/// instead of growing the queue without bound.
+class MAVLinkMessageRing
+{
+public:
+    /// @param capacity Number of message slots, rounded up to the next power of two
+    MAVLinkMessageRing(uint32_t capacity = defaultCapacity);
+
+    /// Producer side only
+    /// @return false: Ring is full, message was dropped
+    bool push(const mavlink_message_t& message);
+
+    /// Consumer side only
+    /// @return false: Ring is empty
+    bool pop(mavlink_message_t& message);
+
+    /// Consumer side only. Discards all queued messages.
+    void discard(void);
+
+    bool        isEmpty         (void) const;
+    uint32_t    count           (void) const;
+    uint32_t    capacity        (void) const { return _mask + 1; }
+    uint64_t    droppedCount    (void) const { return _droppedCount.load(std::memory_order_relaxed); }
+
+    static const uint32_t defaultCapacity = 512;
+
+private:
+    std::vector<mavlink_message_t>  _messages;
+    uint32_t                        _mask;
+    std::atomic<uint32_t>           _head;          ///< Next slot to write, only modified by the producer
+    std::atomic<uint32_t>           _tail;          ///< Next slot to read, only modified by the consumer
+    std::atomic<uint64_t>           _droppedCount;
+};
@@ -29,13 +29,22 @@
 #include "QGC.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
+#include "QGCInstrumentation.h"
 #include "MultiVehicleManager.h"
 #include "SettingsManager.h"
+#include "MAVLinkForwarder.h"
 
 Q_DECLARE_METATYPE(mavlink_message_t)
+Q_DECLARE_METATYPE(QVector<mavlink_message_t>)
 
 QGC_LOGGING_CATEGORY(MAVLinkProtocolLog, "MAVLinkProtocolLog")
 
+QGC_INSTRUMENT_HISTOGRAM(MAVLinkReceiveBytesTime,   "MAVLink.ReceiveBytes")
+QGC_INSTRUMENT_COUNTER  (MAVLinkBytesReceived,      "MAVLink.BytesReceived")
+QGC_INSTRUMENT_COUNTER  (MAVLinkMessagesParsed,     "MAVLink.MessagesParsed")
+QGC_INSTRUMENT_HISTOGRAM(MAVLinkDrainTime,          "MAVLink.Drain")
+QGC_INSTRUMENT_GAUGE    (MAVLinkReceiveQueueDepth,  "MAVLink.ReceiveQueueDepth")
+
 const char* MAVLinkProtocol::_tempLogFileTemplate   = "FlightDataXXXXXX";   ///< Template for temporary log file
 const char* MAVLinkProtocol::_logFileExtension      = "mavlink";            ///< Extension for log files
 
@@ -46,8 +55,6 @@ const char* MAVLinkProtocol::_logFileExtension      = "mavlink";            ///<
 MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
     , m_enable_version_check(true)
-    , _message({})
-    , _status({})
     , versionMismatchIgnore(false)
     , systemId(255)
     , _current_version(100)
@@ -59,18 +66,31 @@ MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     , _linkMgr(nullptr)
     , _multiVehicleManager(nullptr)
 {
-    memset(totalReceiveCounter, 0, sizeof(totalReceiveCounter));
-    memset(totalLossCounter,    0, sizeof(totalLossCounter));
-    memset(runningLossPercent,  0, sizeof(runningLossPercent));
-    memset(firstMessage,        1, sizeof(firstMessage));
-    memset(&_status,            0, sizeof(_status));
-    memset(&_message,           0, sizeof(_message));
+    _statsTimer.start();
+
+    for (ReceiveChannel_t& receiveChannel: _receiveChannels) {
+        memset(&receiveChannel.message, 0, sizeof(receiveChannel.message));
+        memset(&receiveChannel.status,  0, sizeof(receiveChannel.status));
+        receiveChannel.ring                 = nullptr;
+        receiveChannel.drainPending         = false;
+        receiveChannel.link                 = nullptr;
+        receiveChannel.reportedDroppedCount = 0;
+    }
+
+#ifdef __mobile__
+    // Tablets are more likely to lose power before the OS gets around to writing the log out
+    _logWriter.setSyncIntervalMSecs(2000);
+#endif
 }
 
 MAVLinkProtocol::~MAVLinkProtocol()
 {
     storeSettings();
     _closeLogFile();
+
+    for (ReceiveChannel_t& receiveChannel: _receiveChannels) {
+        delete receiveChannel.ring;
+    }
 }
 
 void MAVLinkProtocol::setVersion(unsigned version)
@@ -99,6 +119,7 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    _multiVehicleManager =   _toolbox->multiVehicleManager();
 
    qRegisterMetaType<mavlink_message_t>("mavlink_message_t");
+   qRegisterMetaType<QVector<mavlink_message_t>>("QVector<mavlink_message_t>");
 
    loadSettings();
 
@@ -108,6 +129,9 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    connect(this, &MAVLinkProtocol::protocolStatusMessage,   _app, &QGCApplication::criticalMessageBoxOnMainThread);
    connect(this, &MAVLinkProtocol::saveTelemetryLog,        _app, &QGCApplication::saveTelemetryLogOnMainThread);
    connect(this, &MAVLinkProtocol::checkTelemetrySavePath,  _app, &QGCApplication::checkTelemetrySavePathOnMainThread);
+   connect(&_logWriter, &MAVLinkLogWriter::writeError,       this, &MAVLinkProtocol::_logWriteError);
+
+   _forwarder = new MAVLinkForwarder(_linkMgr, _toolbox->settingsManager()->appSettings(), this);
 
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleAdded, this, &MAVLinkProtocol::_vehicleCountChanged);
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &MAVLinkProtocol::_vehicleCountChanged);
@@ -140,16 +164,39 @@ void MAVLinkProtocol::storeSettings()
     // Parameter interface settings
 }
 
-void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
+uint32_t MAVLinkProtocol::pendingMessageCount(uint8_t mavlinkChannel) const
 {
-    int channel = link->mavlinkChannel();
-    totalReceiveCounter[channel] = 0;
-    totalLossCounter[channel]    = 0;
-    runningLossPercent[channel]  = 0.0f;
-    for(int i = 0; i < 256; i++) {
-        firstMessage[channel][i] =  1;
-    }
+    const MAVLinkMessageRing* ring = _receiveChannels[mavlinkChannel].ring;
+    return ring ? ring->count() : 0;
+}
+
+void MAVLinkProtocol::resetMetadataForLink(const SharedLinkInterfacePtr& sharedLink)
+{
+    LinkInterface*  link    = sharedLink.get();
+    int             channel = link->mavlinkChannel();
+    _channelStats[channel].reset();
     link->setDecodedFirstMavlinkPacket(false);
+
+    // The link is not connected yet, so nothing is producing into the ring for this channel
+    ReceiveChannel_t& receiveChannel = _receiveChannels[channel];
+    if (!receiveChannel.ring) {
+        receiveChannel.ring = new MAVLinkMessageRing();
+    }
+    receiveChannel.ring->discard();
+    memset(&receiveChannel.message, 0, sizeof(receiveChannel.message));
+    memset(&receiveChannel.status,  0, sizeof(receiveChannel.status));
+    receiveChannel.drainPending         = false;
+    receiveChannel.link                 = link;
+    receiveChannel.weakLink             = sharedLink;
+    receiveChannel.reportedDroppedCount = receiveChannel.ring->droppedCount();
+}
+
+void MAVLinkProtocol::releaseLink(LinkInterface* link)
+{
+    ReceiveChannel_t& receiveChannel = _receiveChannels[link->mavlinkChannel()];
+    if (receiveChannel.link == link) {
+        receiveChannel.weakLink.reset();
+    }
 }
 
 /**
@@ -158,54 +205,41 @@ void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
  * @see LinkInterface
  **/
 
-void MAVLinkProtocol::logSentBytes(LinkInterface* link, QByteArray b){
-
-    uint8_t bytes_time[sizeof(quint64)];
-
+void MAVLinkProtocol::logSentBytes(LinkInterface* link, QByteArray b)
+{
     Q_UNUSED(link);
-    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-
-        quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-
-        qToBigEndian(time,bytes_time);
-
-        b.insert(0,QByteArray((const char*)bytes_time,sizeof(bytes_time)));
 
-        int len = b.count();
-
-        if(_tempLogFile.write(b) != len)
-        {
-            // If there's an error logging data, raise an alert and stop logging.
-            emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-            _stopLogging();
-            _logSuspendError = true;
-        }
+    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
+        _logWriter.logBytes(b);
     }
-
 }
 
 /**
  * This method parses all incoming bytes and constructs a MAVLink packet.
  * It can handle multiple links in parallel, as each link has it's own buffer/
- * parsing state machine.
+ * parsing state machine. It is called on the thread of the link, so the only
+ * state it touches is the receive channel owned by the link. Parsed messages are
+ * pushed to the channel ring and a single drain is queued to the main thread for
+ * the whole burst.
  * @param link The interface to read from
  * @see LinkInterface
  **/
 
 void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
 {
-    // Since receiveBytes signals cross threads we can end up with signals in the queue
-    // that come through after the link is disconnected. For these we just drop the data
-    // since the link is closed.
-    WeakLinkInterfacePtr linkPtr = _linkMgr->sharedLinkInterfacePointerForLink(link, true);
-    if (linkPtr.expired()) {
+    uint8_t             mavlinkChannel  = link->mavlinkChannel();
+    ReceiveChannel_t&   receiveChannel  = _receiveChannels[mavlinkChannel];
+    quint64             messageCount    = 0;
+
+    if (!receiveChannel.ring) {
         return;
     }
 
-    uint8_t mavlinkChannel = link->mavlinkChannel();
+    QGC_INSTRUMENT_SCOPE(MAVLinkReceiveBytesTime);
+    QGC_INSTRUMENT_ADD(MAVLinkBytesReceived, static_cast<quint64>(b.size()));
 
     for (int position = 0; position < b.size(); position++) {
-        if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
+        if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &receiveChannel.message, &receiveChannel.status)) {
             // Got a valid message
             if (!link->decodedFirstMavlinkPacket()) {
                 link->setDecodedFirstMavlinkPacket(true);
@@ -213,165 +247,186 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
                 if (!(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
                     qDebug() << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
                     mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-                    // Set all links to v2
-                    setVersion(200);
+                    // Set all links to v2. The link list belongs to the main thread.
+                    QMetaObject::invokeMethod(this, [this]() { setVersion(200); }, Qt::QueuedConnection);
                 }
             }
 
-            //-----------------------------------------------------------------
-            // MAVLink Status
-            uint8_t lastSeq = lastIndex[_message.sysid][_message.compid];
-            uint8_t expectedSeq = lastSeq + 1;
-            // Increase receive counter
-            totalReceiveCounter[mavlinkChannel]++;
-            // Determine what the next expected sequence number is, accounting for
-            // never having seen a message for this system/component pair.
-            if(firstMessage[_message.sysid][_message.compid]) {
-                firstMessage[_message.sysid][_message.compid] = 0;
-                lastSeq     = _message.seq;
-                expectedSeq = _message.seq;
-            }
-            // And if we didn't encounter that sequence number, record the error
-            //int foo = 0;
-            if (_message.seq != expectedSeq)
-            {
-                //foo = 1;
-                int lostMessages = 0;
-                //-- Account for overflow during packet loss
-                if(_message.seq < expectedSeq) {
-                    lostMessages = (_message.seq + 255) - expectedSeq;
-                } else {
-                    lostMessages = _message.seq - expectedSeq;
-                }
-                // Log how many were lost
-                totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
-            }
+            receiveChannel.ring->push(receiveChannel.message);
+            messageCount++;
 
-            // And update the last sequence number for this system/component pair
-            lastIndex[_message.sysid][_message.compid] = _message.seq;;
-            // Calculate new loss ratio
-            uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
-            float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
-            receiveLossPercent *= 100.0f;
-            receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
-            runningLossPercent[mavlinkChannel] = receiveLossPercent;
-
-            //qDebug() << foo << _message.seq << expectedSeq << lastSeq << totalLossCounter[mavlinkChannel] << totalReceiveCounter[mavlinkChannel] << totalSentCounter[mavlinkChannel] << "(" << _message.sysid << _message.compid << ")";
-
-            //-----------------------------------------------------------------
-            // MAVLink forwarding
-            bool forwardingEnabled = _app->toolbox()->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool();
-            if (forwardingEnabled) {
-                SharedLinkInterfacePtr forwardingLink = _linkMgr->mavlinkForwardingLink();
-
-                if (forwardingLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingLink->writeBytesThreadSafe((const char*)buf, len);
-                }
-            }
+            // Reset message parsing
+            memset(&receiveChannel.status,  0, sizeof(receiveChannel.status));
+            memset(&receiveChannel.message, 0, sizeof(receiveChannel.message));
+        }
+    }
 
-            //-----------------------------------------------------------------
-            // Log data
-            if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-                uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)];
-
-                // Write the uint64 time in microseconds in big endian format before the message.
-                // This timestamp is saved in UTC time. We are only saving in ms precision because
-                // getting more than this isn't possible with Qt without a ton of extra code.
-                quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-                qToBigEndian(time, buf);
-
-                // Then write the message to the buffer
-                int len = mavlink_msg_to_send_buffer(buf + sizeof(quint64), &_message);
-
-                // Determine how many bytes were written by adding the timestamp size to the message size
-                len += sizeof(quint64);
-
-                // Now write this timestamp/message pair to the log.
-                QByteArray b(reinterpret_cast<const char*>(buf), len);
-                if(_tempLogFile.write(b) != len)
-                {
-                    // If there's an error logging data, raise an alert and stop logging.
-                    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-                    _stopLogging();
-                    _logSuspendError = true;
-                }
+    if (messageCount) {
+        QGC_INSTRUMENT_ADD(MAVLinkMessagesParsed, messageCount);
+        _queueReceiveChannelDrain(mavlinkChannel);
+    }
+}
 
-                // Check for the vehicle arming going by. This is used to trigger log save.
-                if (!_vehicleWasArmed && _message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                    mavlink_heartbeat_t state;
-                    mavlink_msg_heartbeat_decode(&_message, &state);
-                    if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
-                        _vehicleWasArmed = true;
-                    }
-                }
-            }
+/// Queues a drain of the channel ring to the main thread unless one is already pending
+void MAVLinkProtocol::_queueReceiveChannelDrain(uint8_t mavlinkChannel)
+{
+    if (!_receiveChannels[mavlinkChannel].drainPending.exchange(true)) {
+        QMetaObject::invokeMethod(this, [this, mavlinkChannel]() { _drainReceiveChannel(mavlinkChannel); }, Qt::QueuedConnection);
+    }
+}
 
-            if (_message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                _startLogging();
-                mavlink_heartbeat_t heartbeat;
-                mavlink_msg_heartbeat_decode(&_message, &heartbeat);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, heartbeat.autopilot, heartbeat.type);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
-                _startLogging();
-                mavlink_high_latency_t highLatency;
-                mavlink_msg_high_latency_decode(&_message, &highLatency);
-                // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-                _startLogging();
-                mavlink_high_latency2_t highLatency2;
-                mavlink_msg_high_latency2_decode(&_message, &highLatency2);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, highLatency2.autopilot, highLatency2.type);
-            }
+/// Processes the messages queued on the channel ring. Runs on the main thread.
+void MAVLinkProtocol::_drainReceiveChannel(uint8_t mavlinkChannel)
+{
+    ReceiveChannel_t& receiveChannel = _receiveChannels[mavlinkChannel];
 
-#if 0
-            // Given the current state of SiK Radio firmwares there is no way to make the code below work.
-            // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
-            // packet even if the vehicle is sending Mavlink 2.
-
-            // Detect if we are talking to an old radio not supporting v2
-            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-            if (_message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
-                if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
-                && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    _radio_version_mismatch_count++;
-                }
-            }
+    // Must be cleared prior to draining so that anything pushed from here on queues another drain
+    receiveChannel.drainPending = false;
 
-            if (_radio_version_mismatch_count == 5) {
-                // Warn the user if the radio continues to send v1 while the link uses v2
-                emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
-                // Set to flag warning already shown
-                _radio_version_mismatch_count = -1;
-                // Flick link back to v1
-                qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-            }
-#endif
+    // Since the drain is queued across threads we can end up with messages in the ring
+    // that come through after the link is disconnected. For these we just drop the data
+    // since the link is closed.
+    WeakLinkInterfacePtr linkPtr = receiveChannel.weakLink;
+    if (linkPtr.expired()) {
+        receiveChannel.ring->discard();
+        return;
+    }
+    LinkInterface* link = receiveChannel.link;
 
-            // Update MAVLink status on every 32th packet
-            if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
-                emit mavlinkMessageStatus(_message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
+    QGC_INSTRUMENT_SCOPE(MAVLinkDrainTime);
+    QGC_INSTRUMENT_SET(MAVLinkReceiveQueueDepth, static_cast<qint64>(receiveChannel.ring->count()));
+
+    uint64_t droppedCount = receiveChannel.ring->droppedCount();
+    if (droppedCount != receiveChannel.reportedDroppedCount) {
+        qCWarning(MAVLinkProtocolLog) << "Receive queue overflow, dropped messages:" << droppedCount - receiveChannel.reportedDroppedCount << "channel:" << mavlinkChannel;
+        receiveChannel.reportedDroppedCount = droppedCount;
+    }
+
+    QVector<mavlink_message_t> batch;
+    batch.reserve(static_cast<int>(qMin(receiveChannel.ring->count(), _maxMessagesPerDrain)));
+
+    mavlink_message_t message;
+    while (receiveChannel.ring->pop(message)) {
+        _processMessage(link, message);
+
+        // Anyone handling the message could close the connection, which deletes the link,
+        // so we check if it's expired
+        if (linkPtr.expired()) {
+            return;
+        }
+
+        batch.append(message);
+
+        // Don't starve the event loop when the link is producing faster than we can keep up
+        if (static_cast<uint32_t>(batch.count()) >= _maxMessagesPerDrain) {
+            if (!receiveChannel.ring->isEmpty()) {
+                _queueReceiveChannelDrain(mavlinkChannel);
             }
+            break;
+        }
+    }
 
-            // The packet is emitted as a whole, as it is only 255 - 261 bytes short
-            // kind of inefficient, but no issue for a groundstation pc.
-            // It buys as reentrancy for the whole code over all threads
-            emit messageReceived(link, _message);
+    if (_forwarder) {
+        _forwarder->flush();
+    }
 
-            // Anyone handling the message could close the connection, which deletes the link,
-            // so we check if it's expired
-            if (linkPtr.expired()) {
-                break;
+    if (!batch.isEmpty()) {
+        emit messagesReceived(link, batch);
+    }
+}
+
+void MAVLinkProtocol::_processMessage(LinkInterface* link, const mavlink_message_t& message)
+{
+    uint8_t mavlinkChannel = link->mavlinkChannel();
+
+    //-----------------------------------------------------------------
+    // MAVLink Status. Sequence numbers are tracked per channel, so the same system heard over redundant links
+    // is accounted for separately on each link.
+    MAVLinkChannelStats& channelStats = _channelStats[mavlinkChannel];
+    channelStats.update(message, _statsTimer.elapsed());
+
+    //-----------------------------------------------------------------
+    // MAVLink forwarding, written out once the whole batch is processed
+    if (_forwarder) {
+        _forwarder->forward(link, message);
+    }
+
+    //-----------------------------------------------------------------
+    // Log data
+    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
+        // The write itself happens on the log writer thread
+        _logWriter.logMessage(message);
+
+        // Check for the vehicle arming going by. This is used to trigger log save.
+        if (!_vehicleWasArmed && message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            mavlink_heartbeat_t state;
+            mavlink_msg_heartbeat_decode(&message, &state);
+            if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
+                _vehicleWasArmed = true;
             }
+        }
+    }
 
-            // Reset message parsing
-            memset(&_status,  0, sizeof(_status));
-            memset(&_message, 0, sizeof(_message));
+    if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        _startLogging();
+        mavlink_heartbeat_t heartbeat;
+        mavlink_msg_heartbeat_decode(&message, &heartbeat);
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, heartbeat.autopilot, heartbeat.type);
+    } else if (message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
+        _startLogging();
+        mavlink_high_latency_t highLatency;
+        mavlink_msg_high_latency_decode(&message, &highLatency);
+        // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
+    } else if (message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+        _startLogging();
+        mavlink_high_latency2_t highLatency2;
+        mavlink_msg_high_latency2_decode(&message, &highLatency2);
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, highLatency2.autopilot, highLatency2.type);
+    }
+
+#if 0
+    // Given the current state of SiK Radio firmwares there is no way to make the code below work.
+    // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
+    // packet even if the vehicle is sending Mavlink 2.
+
+    // Detect if we are talking to an old radio not supporting v2
+    mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+    if (message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
+        if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
+        && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+            _radio_version_mismatch_count++;
         }
     }
+
+    if (_radio_version_mismatch_count == 5) {
+        // Warn the user if the radio continues to send v1 while the link uses v2
+        emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
+        // Set to flag warning already shown
+        _radio_version_mismatch_count = -1;
+        // Flick link back to v1
+        qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
+        mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    }
+#endif
+
+    // Update MAVLink status on every 32th packet from the system
+    if ((channelStats.systemReceivedCount(message.sysid) & 0x1F) == 0) {
+        MAVLinkChannelStats::Stats_t stats = channelStats.systemStats(message.sysid, _statsTimer.elapsed());
+        emit mavlinkMessageStatus(link,
+                                  message.sysid,
+                                  stats.totalReceived + stats.totalLost,
+                                  stats.totalReceived,
+                                  stats.totalLost,
+                                  stats.windowLossPermille / 10.0f,
+                                  stats.windowRateMilliHz / 1000.0f,
+                                  static_cast<int>(stats.windowMaxGapMSecs));
+    }
+
+    // The packet is emitted as a whole, as it is only 255 - 261 bytes short
+    // kind of inefficient, but no issue for a groundstation pc.
+    // It buys as reentrancy for the whole code over all threads
+    emit messageReceived(link, message);
 }
 
 /**
@@ -405,6 +460,15 @@ void MAVLinkProtocol::enableVersionCheck(bool enabled)
     emit versionCheckChanged(enabled);
 }
 
+void MAVLinkProtocol::_logWriteError(QString errorString)
+{
+    // If there's an error logging data, raise an alert and stop logging.
+    qCWarning(MAVLinkProtocolLog) << "Log write failed" << errorString;
+    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
+    _stopLogging();
+    _logSuspendError = true;
+}
+
 void MAVLinkProtocol::_vehicleCountChanged(void)
 {
     int count = _multiVehicleManager->vehicles()->count();
@@ -419,6 +483,8 @@ void MAVLinkProtocol::_vehicleCountChanged(void)
 bool MAVLinkProtocol::_closeLogFile(void)
 {
     if (_tempLogFile.isOpen()) {
+        // Make sure everything queued has hit the file before looking at it
+        _logWriter.stopLogging();
         if (_tempLogFile.size() == 0) {
             // Don't save zero byte files
             _tempLogFile.remove();
@@ -461,6 +527,7 @@ void MAVLinkProtocol::_startLogging(void)
             }
 
             qDebug() << "Temp log" << _tempLogFile.fileName();
+            _logWriter.startLogging(&_tempLogFile);
             emit checkTelemetrySavePath();
 
             _logSuspendError = false;
@@ -16,15 +16,23 @@
 #include <QFile>
 #include <QMap>
 #include <QByteArray>
+#include <QVector>
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 
+#include <atomic>
+
 #include "LinkInterface.h"
+#include "MAVLinkChannelStats.h"
+#include "MAVLinkLogWriter.h"
+#include "MAVLinkMessageRing.h"
 #include "QGCMAVLink.h"
 #include "QGC.h"
 #include "QGCTemporaryFile.h"
 #include "QGCToolbox.h"
 
 class LinkManager;
+class MAVLinkForwarder;
 class MultiVehicleManager;
 class QGCApplication;
 
@@ -66,11 +74,17 @@ public:
     /**
      * Reset the counters for all metadata for this link.
      */
-    virtual void resetMetadataForLink(LinkInterface *link);
+    virtual void resetMetadataForLink(const SharedLinkInterfacePtr& link);
+
+    /// Called when a link is removed from LinkManager. Anything still queued for it is dropped.
+    void releaseLink(LinkInterface* link);
     
     /// Suspend/Restart logging during replay.
     void suspendLogForReplay(bool suspend);
 
+    /// @return Number of parsed messages on the channel which have not been processed by the main thread yet. Thread safe.
+    uint32_t pendingMessageCount(uint8_t mavlinkChannel) const;
+
     /// Set protocol version
     void setVersion(unsigned version);
 
@@ -78,7 +92,8 @@ public:
     virtual void setToolbox(QGCToolbox *toolbox);
 
 public slots:
-    /** @brief Receive bytes from a communication interface */
+    /// Receive bytes from a communication interface. This is connected directly to the link's bytesReceived signal,
+    /// so it runs on the thread of the link. Parsed messages are queued per channel and processed on the main thread.
     void receiveBytes(LinkInterface* link, QByteArray b);
 
     /** @brief Log bytes sent from a communication interface */
@@ -103,15 +118,6 @@ public slots:
 
 protected:
     bool        m_enable_version_check;                         ///< Enable checking of version match of MAV and QGC
-    uint8_t     lastIndex[256][256];                            ///< Store the last received sequence ID for each system/componenet pair
-    uint8_t     firstMessage[256][256];                         ///< First message flag
-    uint64_t    totalReceiveCounter[MAVLINK_COMM_NUM_BUFFERS];  ///< The total number of successfully received messages
-    uint64_t    totalLossCounter[MAVLINK_COMM_NUM_BUFFERS];     ///< Total messages lost during transmission.
-    float       runningLossPercent[MAVLINK_COMM_NUM_BUFFERS];   ///< Loss rate
-
-    mavlink_message_t _message;
-    mavlink_status_t _status;
-
     bool        versionMismatchIgnore;
     int         systemId;
     unsigned    _current_version;
@@ -123,6 +129,10 @@ signals:
 
     /** @brief Message received and directly copied via signal */
     void messageReceived(LinkInterface* link, mavlink_message_t message);
+    /// All the messages processed in a single drain of the link's receive queue. Emitted after the individual
+    /// messageReceived signals for the same messages. Consumers which only live on the main thread should use
+    /// this to handle a whole burst in one slot call.
+    void messagesReceived(LinkInterface* link, const QVector<mavlink_message_t>& messages);
     /** @brief Emitted if version check is enabled / disabled */
     void versionCheckChanged(bool enabled);
     /** @brief Emitted if a message from the protocol should reach the user */
@@ -130,7 +140,9 @@ signals:
     /** @brief Emitted if a new system ID was set */
     void systemIdChanged(int systemId);
 
-    void mavlinkMessageStatus(int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
+    /// Receive statistics for a system on a single link. Counts are totals since the link connected, loss percent,
+    /// receive rate and max message gap are over the last MAVLinkChannelStats::windowBucketCount seconds.
+    void mavlinkMessageStatus(LinkInterface* link, int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent, float receiveRateHz, int maxMessageGapMSecs);
 
     /**
      * @brief Emitted if a new radio status packet received
@@ -154,8 +166,24 @@ signals:
 
 private slots:
     void _vehicleCountChanged(void);
+    void _logWriteError     (QString errorString);
     
 private:
+    /// Per channel receive state. The parse buffers are only touched by the thread which is running receiveBytes
+    /// for the link, the ring is the hand off to the main thread.
+    typedef struct {
+        mavlink_message_t       message;
+        mavlink_status_t        status;
+        MAVLinkMessageRing*     ring;
+        std::atomic<bool>       drainPending;   ///< true: A drain of the ring is already queued to the main thread
+        LinkInterface*          link;           ///< Main thread view of the link which owns the channel
+        WeakLinkInterfacePtr    weakLink;       ///< Expires once the link is released, checked by the drain instead of a LinkManager lookup
+        uint64_t                reportedDroppedCount;
+    } ReceiveChannel_t;
+
+    void _queueReceiveChannelDrain  (uint8_t mavlinkChannel);
+    void _drainReceiveChannel       (uint8_t mavlinkChannel);
+    void _processMessage            (LinkInterface* link, const mavlink_message_t& message);
     bool _closeLogFile(void);
     void _startLogging(void);
     void _stopLogging(void);
@@ -165,10 +193,18 @@ private:
     bool _vehicleWasArmed;      ///< true: Vehicle was armed during log sequence
 
     QGCTemporaryFile    _tempLogFile;            ///< File to log to
+    MAVLinkLogWriter    _logWriter;              ///< Writes to _tempLogFile on its own thread
     static const char*  _tempLogFileTemplate;    ///< Template for temporary log file
     static const char*  _logFileExtension;       ///< Extension for log files
 
     LinkManager*            _linkMgr;
     MultiVehicleManager*    _multiVehicleManager;
+    MAVLinkForwarder*       _forwarder = nullptr;
+
+    ReceiveChannel_t        _receiveChannels[MAVLINK_COMM_NUM_BUFFERS];
+    MAVLinkChannelStats     _channelStats[MAVLINK_COMM_NUM_BUFFERS];        ///< Only used from the main thread
+    QElapsedTimer           _statsTimer;
+
+    static const uint32_t   _maxMessagesPerDrain = MAVLinkMessageRing::defaultCapacity;    ///< Yield back to the event loop after this many messages
 };
 
@@ -47,6 +47,9 @@ const char* MockConfiguration::_vehicleTypeKey          = "VehicleType";
 const char* MockConfiguration::_sendStatusTextKey       = "SendStatusText";
 const char* MockConfiguration::_incrementVehicleIdKey   = "IncrementVehicleId";
 const char* MockConfiguration::_failureModeKey          = "FailureMode";
+const char* MockConfiguration::_swarmSizeKey            = "SwarmSize";
+const char* MockConfiguration::_swarmTelemetryRateKey   = "SwarmTelemetryRate";
+const char* MockConfiguration::_swarmSeedKey            = "SwarmSeed";
 
 constexpr MAV_CMD MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED;
 constexpr MAV_CMD MockLink::MAV_CMD_MOCKLINK_ALWAYS_RESULT_FAILED;
@@ -102,7 +105,12 @@ MockLink::MockLink(SharedLinkConfigurationPtr& config)
 
     moveToThread(this);
 
-    _loadParams();
+    if (mockConfig->swarmSize() > 0) {
+        // Swarm vehicles carry a single parameter of their own, the full parameter set is not needed
+        _swarm = new MockLinkSwarm(mockConfig->swarmSize(), mockConfig->swarmTelemetryRate(), mockConfig->swarmSeed(), static_cast<uint8_t>(_mavlinkChannel));
+    } else {
+        _loadParams();
+    }
 
     _adsbVehicleCoordinate = QGeoCoordinate(_vehicleLatitude, _vehicleLongitude).atDistanceAndAzimuth(1000, _adsbAngle);
     _adsbVehicleCoordinate.setAltitude(100);
@@ -112,6 +120,7 @@ MockLink::MockLink(SharedLinkConfigurationPtr& config)
 MockLink::~MockLink(void)
 {
     disconnect();
+    delete _swarm;
     if (!_logDownloadFilename.isEmpty()) {
         QFile::remove(_logDownloadFilename);
     }
@@ -138,12 +147,41 @@ void MockLink::disconnect(void)
         _connected = false;
         quit();
         wait();
+        {
+            QMutexLocker lock(&_impairmentMutex);
+            _transmitImpairment.clear();
+            _receiveImpairment.clear();
+        }
         emit disconnected();
     }
 }
 
 void MockLink::run(void)
 {
+    if (_swarm) {
+        // All swarm traffic comes from a single precise tick, the swarm's own rate controller decides what is due
+        QTimer swarmTimer;
+
+        _swarmBytes.reserve(64 * 1024);
+        if (!_swarmRunningTime.isValid()) {
+            // Swarm time keeps going across reconnects, the stream schedules are based on it
+            _swarmRunningTime.start();
+        }
+        _swarmStatsMSecs        = _swarmRunningTime.elapsed();
+        _swarmStatsSentCount    = _swarm->sentCount();
+
+        swarmTimer.setTimerType(Qt::PreciseTimer);
+        QObject::connect(&swarmTimer, &QTimer::timeout, this, &MockLink::_runSwarmTasks);
+        swarmTimer.start(MockLinkSwarm::tickMSecs);
+        _runSwarmTasks();
+
+        exec();
+
+        QObject::disconnect(&swarmTimer, &QTimer::timeout, this, &MockLink::_runSwarmTasks);
+        _missionItemHandler.shutdown();
+        return;
+    }
+
     QTimer  timer1HzTasks;
     QTimer  timer10HzTasks;
     QTimer  timer500HzTasks;
@@ -217,6 +255,8 @@ void MockLink::_run10HzTasks(void)
 
 void MockLink::_run500HzTasks(void)
 {
+    _deliverImpairedPackets();
+
     if (linkConfiguration()->isHighLatency()) {
         return;
     }
@@ -227,6 +267,29 @@ void MockLink::_run500HzTasks(void)
     }
 }
 
+void MockLink::_runSwarmTasks(void)
+{
+    qint64 nowMSecs = _swarmRunningTime.elapsed();
+
+    // The swarm keeps running while comm is lost so the vehicles show up with sequence gaps, as a real link would
+    _swarmBytes.resize(0);
+    _swarm->tick(nowMSecs, _swarmBytes);
+    if (!_swarmBytes.isEmpty() && _connected && !_commLost) {
+        // bytesReceived is connected directly, so the buffer can be reused as soon as the signal returns
+        emit bytesReceived(this, _swarmBytes);
+    }
+
+    if (nowMSecs - _swarmStatsMSecs >= _swarmStatsIntervalMSecs) {
+        double messagesPerSecond = (_swarm->sentCount() - _swarmStatsSentCount) * 1000.0 / (nowMSecs - _swarmStatsMSecs);
+        qCDebug(MockLinkLog) << "Swarm vehicles:" << _swarm->vehicleCount()
+                             << "rate(Hz):" << _swarm->telemetryRateHz()
+                             << "messages/sec:" << messagesPerSecond
+                             << "late periods:" << _swarm->lateCount();
+        _swarmStatsMSecs        = nowMSecs;
+        _swarmStatsSentCount    = _swarm->sentCount();
+    }
+}
+
 void MockLink::_loadParams(void)
 {
     QFile paramFile;
@@ -296,7 +359,7 @@ void MockLink::_loadParams(void)
             break;
         }
 
-        qCDebug(MockLinkVerboseLog) << "Loading param" << paramName << paramValue;
+        qCVerbose(MockLinkVerboseLog) << "Loading param" << paramName << paramValue;
 
         _mapParamName2Value[compId][paramName] = paramValue;
         _mapParamName2MavParamType[compId][paramName] = static_cast<MAV_PARAM_TYPE>(paramType);
@@ -490,10 +553,56 @@ void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
 
         int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
         QByteArray bytes((char *)buffer, cBuffer);
+        {
+            QMutexLocker lock(&_impairmentMutex);
+            if (_receiveImpairment.enabled()) {
+                // Goes out from _deliverImpairedPackets once it has made it across
+                _receiveImpairment.send(_runningTime.elapsed(), bytes);
+                return;
+            }
+        }
         emit bytesReceived(this, bytes);
     }
 }
 
+void MockLink::setImpairment(const MockLinkImpairment::Config_t& transmit, const MockLinkImpairment::Config_t& receive)
+{
+    QMutexLocker lock(&_impairmentMutex);
+    _transmitImpairment.setConfig(transmit);
+    _receiveImpairment.setConfig(receive);
+}
+
+quint64 MockLink::impairmentLostCount(void)
+{
+    QMutexLocker lock(&_impairmentMutex);
+    return _transmitImpairment.lostCount() + _transmitImpairment.overflowCount() +
+           _receiveImpairment.lostCount() + _receiveImpairment.overflowCount();
+}
+
+void MockLink::_deliverImpairedPackets(void)
+{
+    QList<QByteArray> transmitted;
+    QList<QByteArray> received;
+    {
+        QMutexLocker lock(&_impairmentMutex);
+        if (!_transmitImpairment.inFlight() && !_receiveImpairment.inFlight()) {
+            return;
+        }
+        qint64 nowMSecs = _runningTime.elapsed();
+        _transmitImpairment.takeArrived(nowMSecs, transmitted);
+        _receiveImpairment.takeArrived(nowMSecs, received);
+    }
+    // Handled outside the lock, responses go back through respondWithMavlinkMessage
+    for (const QByteArray& bytes: transmitted) {
+        _processWrittenBytes(bytes);
+    }
+    if (!_commLost) {
+        for (const QByteArray& bytes: received) {
+            emit bytesReceived(this, bytes);
+        }
+    }
+}
+
 /// @brief Called when QGC wants to write bytes to the MAV
 void MockLink::_writeBytes(const QByteArray bytes)
 {
@@ -502,6 +611,27 @@ void MockLink::_writeBytes(const QByteArray bytes)
 }
 
 void MockLink::_writeBytesQueued(const QByteArray bytes)
+{
+    if (_swarm) {
+        QByteArray responses;
+        _swarm->handleBytes(bytes, responses);
+        if (!responses.isEmpty() && !_commLost) {
+            emit bytesReceived(this, responses);
+        }
+        return;
+    }
+
+    {
+        QMutexLocker lock(&_impairmentMutex);
+        if (_transmitImpairment.enabled()) {
+            _transmitImpairment.send(_runningTime.elapsed(), bytes);
+            return;
+        }
+    }
+    _processWrittenBytes(bytes);
+}
+
+void MockLink::_processWrittenBytes(const QByteArray& bytes)
 {
     if (_inNSH) {
         _handleIncomingNSHBytes(bytes.constData(), bytes.count());
@@ -1028,6 +1158,14 @@ void MockLink::_handleCommandLong(const mavlink_message_t& msg)
         commandResult = MAV_RESULT_ACCEPTED;
         _respondWithAutopilotVersion();
         break;
+    case MAV_CMD_GET_MESSAGE_INTERVAL:
+        _respondWithMessageInterval(static_cast<int>(request.param1));
+        commandResult = MAV_RESULT_ACCEPTED;
+        break;
+    case MAV_CMD_SET_MESSAGE_INTERVAL:
+        _messageIntervalsUSecs[static_cast<int>(request.param1)] = static_cast<int32_t>(request.param2);
+        commandResult = MAV_RESULT_ACCEPTED;
+        break;
     case MAV_CMD_REQUEST_MESSAGE:
         if (_handleRequestMessage(request, noAck)) {
             if (noAck) {
@@ -1100,6 +1238,19 @@ void MockLink::sendUnexpectedCommandAck(MAV_CMD command, MAV_RESULT ackResult)
     respondWithMavlinkMessage(commandAck);
 }
 
+void MockLink::_respondWithMessageInterval(int messageId)
+{
+    mavlink_message_t msg;
+
+    mavlink_msg_message_interval_pack_chan(_vehicleSystemId,
+                                           _vehicleComponentId,
+                                           _mavlinkChannel,
+                                           &msg,
+                                           static_cast<uint16_t>(messageId),
+                                           messageIntervalUSecs(messageId));
+    respondWithMavlinkMessage(msg);
+}
+
 void MockLink::_respondWithAutopilotVersion(void)
 {
     mavlink_message_t msg;
@@ -1283,8 +1434,8 @@ void MockLink::_sendStatusTextMessages(void)
 
     _sendChunkedStatusText(1, false /* missingChunks */);
     _sendChunkedStatusText(2, true /* missingChunks */);
-    _sendChunkedStatusText(3, false /* missingChunks */);   // This should cause the previous incomplete chunk to spit out
-    _sendChunkedStatusText(4, true /* missingChunks */);    // This should cause the timeout to fire
+    _sendChunkedStatusText(3, false /* missingChunks */);   // Completes while the previous incomplete sequence is still pending
+    _sendChunkedStatusText(4, true /* missingChunks */);    // This and the previous incomplete sequence spit out on the timeout
 }
 
 MockConfiguration::MockConfiguration(const QString& name)
@@ -1301,6 +1452,9 @@ MockConfiguration::MockConfiguration(MockConfiguration* source)
     _sendStatusText     = source->_sendStatusText;
     _incrementVehicleId = source->_incrementVehicleId;
     _failureMode        = source->_failureMode;
+    _swarmSize          = source->_swarmSize;
+    _swarmTelemetryRate = source->_swarmTelemetryRate;
+    _swarmSeed          = source->_swarmSeed;
 }
 
 void MockConfiguration::copyFrom(LinkConfiguration *source)
@@ -1318,6 +1472,9 @@ void MockConfiguration::copyFrom(LinkConfiguration *source)
     _sendStatusText     = usource->_sendStatusText;
     _incrementVehicleId = usource->_incrementVehicleId;
     _failureMode        = usource->_failureMode;
+    _swarmSize          = usource->_swarmSize;
+    _swarmTelemetryRate = usource->_swarmTelemetryRate;
+    _swarmSeed          = usource->_swarmSeed;
 }
 
 void MockConfiguration::saveSettings(QSettings& settings, const QString& root)
@@ -1328,6 +1485,9 @@ void MockConfiguration::saveSettings(QSettings& settings, const QString& root)
     settings.setValue(_sendStatusTextKey,       _sendStatusText);
     settings.setValue(_incrementVehicleIdKey,   _incrementVehicleId);
     settings.setValue(_failureModeKey,          (int)_failureMode);
+    settings.setValue(_swarmSizeKey,            _swarmSize);
+    settings.setValue(_swarmTelemetryRateKey,   _swarmTelemetryRate);
+    settings.setValue(_swarmSeedKey,            _swarmSeed);
     settings.sync();
     settings.endGroup();
 }
@@ -1340,6 +1500,9 @@ void MockConfiguration::loadSettings(QSettings& settings, const QString& root)
     _sendStatusText     = settings.value(_sendStatusTextKey, false).toBool();
     _incrementVehicleId = settings.value(_incrementVehicleIdKey, true).toBool();
     _failureMode        = (FailureMode_t)settings.value(_failureModeKey, (int)FailNone).toInt();
+    _swarmSize          = qBound(0, settings.value(_swarmSizeKey, 0).toInt(), MockLinkSwarm::maxVehicleCount);
+    _swarmTelemetryRate = qBound(1, settings.value(_swarmTelemetryRateKey, 5).toInt(), MockLinkSwarm::maxTelemetryRateHz);
+    _swarmSeed          = settings.value(_swarmSeedKey, 0).toUInt();
     settings.endGroup();
 }
 
@@ -1404,6 +1567,19 @@ MockLink*  MockLink::startAPMArduRoverMockLink(bool sendStatusText, MockConfigur
     return _startMockLinkWorker("ArduRover MockLink", MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_TYPE_GROUND_ROVER, sendStatusText, failureMode);
 }
 
+MockLink* MockLink::startSwarmMockLink(int vehicleCount, int telemetryRateHz, quint32 seed)
+{
+    MockConfiguration* mockConfig = new MockConfiguration(QStringLiteral("Swarm MockLink"));
+
+    mockConfig->setFirmwareType(MAV_AUTOPILOT_GENERIC);
+    mockConfig->setVehicleType(MAV_TYPE_QUADROTOR);
+    mockConfig->setSwarmSize(vehicleCount);
+    mockConfig->setSwarmTelemetryRate(telemetryRateHz);
+    mockConfig->setSwarmSeed(seed);
+
+    return _startMockLink(mockConfig);
+}
+
 void MockLink::_sendRCChannels(void)
 {
     mavlink_message_t   msg;
@@ -11,11 +11,14 @@
 
 #include <QElapsedTimer>
 #include <QMap>
+#include <QMutex>
 #include <QLoggingCategory>
 #include <QGeoCoordinate>
 
 #include "MockLinkMissionItemHandler.h"
 #include "MockLinkFTP.h"
+#include "MockLinkSwarm.h"
+#include "MockLinkImpairment.h"
 #include "QGCMAVLink.h"
 
 Q_DECLARE_LOGGING_CATEGORY(MockLinkLog)
@@ -35,6 +38,9 @@ public:
     Q_PROPERTY(int      vehicle             READ vehicle            WRITE setVehicle            NOTIFY vehicleChanged)
     Q_PROPERTY(bool     sendStatus          READ sendStatusText     WRITE setSendStatusText     NOTIFY sendStatusChanged)
     Q_PROPERTY(bool     incrementVehicleId  READ incrementVehicleId WRITE setIncrementVehicleId NOTIFY incrementVehicleIdChanged)
+    Q_PROPERTY(int      swarmSize           READ swarmSize          WRITE setSwarmSize          NOTIFY swarmSizeChanged)            ///< Number of swarm vehicles, 0 for a single full vehicle
+    Q_PROPERTY(int      swarmTelemetryRate  READ swarmTelemetryRate WRITE setSwarmTelemetryRate NOTIFY swarmTelemetryRateChanged)   ///< Position/attitude rate in Hz for swarm vehicles
+    Q_PROPERTY(quint32  swarmSeed           READ swarmSeed          WRITE setSwarmSeed          NOTIFY swarmSeedChanged)
 
     int     firmware                (void)                      { return (int)_firmwareType; }
     void    setFirmware             (int type)                  { _firmwareType = (MAV_AUTOPILOT)type; emit firmwareChanged(); }
@@ -42,6 +48,12 @@ public:
     bool    incrementVehicleId      (void)                      { return _incrementVehicleId; }
     void    setVehicle              (int type)                  { _vehicleType = (MAV_TYPE)type; emit vehicleChanged(); }
     void    setIncrementVehicleId   (bool incrementVehicleId)   { _incrementVehicleId = incrementVehicleId; emit incrementVehicleIdChanged(); }
+    int     swarmSize               (void)                      { return _swarmSize; }
+    int     swarmTelemetryRate      (void)                      { return _swarmTelemetryRate; }
+    quint32 swarmSeed               (void)                      { return _swarmSeed; }
+    void    setSwarmSize            (int swarmSize)             { _swarmSize = qBound(0, swarmSize, MockLinkSwarm::maxVehicleCount); emit swarmSizeChanged(); }
+    void    setSwarmTelemetryRate   (int swarmTelemetryRate)    { _swarmTelemetryRate = qBound(1, swarmTelemetryRate, MockLinkSwarm::maxTelemetryRateHz); emit swarmTelemetryRateChanged(); }
+    void    setSwarmSeed            (quint32 swarmSeed)         { _swarmSeed = swarmSeed; emit swarmSeedChanged(); }
 
 
     MAV_AUTOPILOT   firmwareType        (void)                          { return _firmwareType; }
@@ -74,6 +86,9 @@ signals:
     void vehicleChanged             (void);
     void sendStatusChanged          (void);
     void incrementVehicleIdChanged  (void);
+    void swarmSizeChanged           (void);
+    void swarmTelemetryRateChanged  (void);
+    void swarmSeedChanged           (void);
 
 private:
     MAV_AUTOPILOT   _firmwareType       = MAV_AUTOPILOT_PX4;
@@ -81,12 +96,18 @@ private:
     bool            _sendStatusText     = false;
     FailureMode_t   _failureMode        = FailNone;
     bool            _incrementVehicleId = true;
+    int             _swarmSize          = 0;
+    int             _swarmTelemetryRate = 5;
+    quint32         _swarmSeed          = 0;
 
     static const char* _firmwareTypeKey;
     static const char* _vehicleTypeKey;
     static const char* _sendStatusTextKey;
     static const char* _incrementVehicleIdKey;
     static const char* _failureModeKey;
+    static const char* _swarmSizeKey;
+    static const char* _swarmTelemetryRateKey;
+    static const char* _swarmSeedKey;
 };
 
 class MockLink : public LinkInterface
@@ -116,6 +137,14 @@ public:
 
     MockLinkFTP* mockLinkFTP(void) { return _mockLinkFTP; }
 
+    /// Makes the link behave like a slow, lossy radio, for benchmarking transfers such as FTP, missions and parameters.
+    /// Transmit is QGC to vehicle, receive is vehicle to QGC. Anything in flight is dropped. Swarm links are not affected.
+    void setImpairment(const MockLinkImpairment::Config_t& transmit, const MockLinkImpairment::Config_t& receive);
+    void setImpairment(const MockLinkImpairment::Config_t& config) { setImpairment(config, config); }
+
+    /// Packets lost in both directions since the impairment was set, including radio buffer overflows
+    quint64 impairmentLostCount(void);
+
     // Overrides from LinkInterface
     bool isConnected(void) const override { return _connected; }
     void disconnect (void) override;
@@ -151,6 +180,10 @@ public:
     static MockLink* startAPMArduPlaneMockLink      (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink* startAPMArduSubMockLink        (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
     static MockLink* startAPMArduRoverMockLink      (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
+    static MockLink* startSwarmMockLink             (int vehicleCount, int telemetryRateHz, quint32 seed = 0);
+
+    /// @return Swarm simulation, nullptr if this is a single vehicle MockLink
+    const MockLinkSwarm* swarm(void) const { return _swarm; }
 
     // Special commands for testing COMMAND_LONG handlers. By default all commands except for MAV_CMD_MOCKLINK_NO_RESPONSE_NO_RETRY should retry.
     static constexpr MAV_CMD MAV_CMD_MOCKLINK_ALWAYS_RESULT_ACCEPTED            = MAV_CMD_USER_1;
@@ -163,6 +196,10 @@ public:
     void clearSendMavCommandCounts(void) { _sendMavCommandCountMap.clear(); }
     int sendMavCommandCount(MAV_CMD command) { return _sendMavCommandCountMap[command]; }
 
+    /// Interval reported through MESSAGE_INTERVAL and changed by MAV_CMD_SET_MESSAGE_INTERVAL, 0: default rate
+    int32_t messageIntervalUSecs    (int messageId) const { return _messageIntervalsUSecs.value(messageId, 0); }
+    void    setMessageIntervalUSecs (int messageId, int32_t intervalUSecs) { _messageIntervalsUSecs[messageId] = intervalUSecs; }
+
     // Special message ids for testing requestMessage support
     typedef enum {
         FailRequestMessageNone,
@@ -185,6 +222,7 @@ private slots:
     void _run1HzTasks(void);
     void _run10HzTasks(void);
     void _run500HzTasks(void);
+    void _runSwarmTasks(void);
 
 private:
     // LinkInterface overrides
@@ -196,6 +234,8 @@ private:
     // MockLink methods
     void _sendHeartBeat                 (void);
     void _sendHighLatency2              (void);
+    void _processWrittenBytes           (const QByteArray& bytes);
+    void _deliverImpairedPackets        (void);
     void _handleIncomingNSHBytes        (const char* bytes, int cBytes);
     void _handleIncomingMavlinkBytes    (const uint8_t* bytes, int cBytes);
     void _loadParams                    (void);
@@ -222,6 +262,7 @@ private:
     void _sendStatusTextMessages        (void);
     void _sendChunkedStatusText         (uint16_t chunkId, bool missingChunks);
     void _respondWithAutopilotVersion   (void);
+    void _respondWithMessageInterval    (int messageId);
     void _sendRCChannels                (void);
     void _paramRequestListWorker        (void);
     void _logDownloadWorker             (void);
@@ -266,8 +307,20 @@ private:
     bool                        _commLost                       = false;
     bool                        _highLatencyTransmissionEnabled = true;
 
+    QMutex                      _impairmentMutex;               ///< Impairments are set from the test thread
+    MockLinkImpairment          _transmitImpairment;
+    MockLinkImpairment          _receiveImpairment;
+
     MockLinkFTP* _mockLinkFTP = nullptr;
 
+    MockLinkSwarm*  _swarm                  = nullptr;
+    QElapsedTimer   _swarmRunningTime;
+    QByteArray      _swarmBytes;                        ///< Reused for every tick, its capacity only ever grows
+    qint64          _swarmStatsMSecs        = 0;        ///< Time of the last achieved rate report
+    quint64         _swarmStatsSentCount    = 0;        ///< Messages sent as of the last achieved rate report
+
+    static const int _swarmStatsIntervalMSecs = 5000;
+
     bool _sendStatusText;
     bool _apmSendHomePositionOnEmptyList;
     MockConfiguration::FailureMode_t _failureMode;
@@ -291,6 +344,7 @@ private:
     RequestMessageFailureMode_t _requestMessageFailureMode = FailRequestMessageNone;
 
     QMap<MAV_CMD, int>  _sendMavCommandCountMap;
+    QMap<int, int32_t>  _messageIntervalsUSecs;
     QMap<int, QMap<QString, QVariant>>          _mapParamName2Value;
     QMap<int, QMap<QString, MAV_PARAM_TYPE>>    _mapParamName2MavParamType;
 
@@ -0,0 +1,101 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockLinkImpairment.h"
+
+MockLinkImpairment::MockLinkImpairment(void)
+{
+    clear();
+}
+
+MockLinkImpairment::Config_t MockLinkImpairment::radio57600(quint32 seed)
+{
+    Config_t config;
+
+    config.latencyMSecs         = 40;
+    config.jitterMSecs          = 20;
+    config.bytesPerSecond       = 57600 / 10;   // Start and stop bit for each byte
+    config.queueLimitBytes      = 2048;
+    config.lossPercent          = 1;
+    config.burstStartPercent    = 0.2;
+    config.burstLength          = 5;
+    config.seed                 = seed;
+
+    return config;
+}
+
+void MockLinkImpairment::setConfig(const Config_t& config)
+{
+    _config     = config;
+    _enabled    = config.latencyMSecs > 0 || config.jitterMSecs > 0 || config.bytesPerSecond > 0 || config.queueLimitBytes > 0 ||
+                  config.lossPercent > 0 || (config.burstStartPercent > 0 && config.burstLength > 0);
+    clear();
+}
+
+void MockLinkImpairment::clear(void)
+{
+    _random.seed(_config.seed);
+    _inFlight.clear();
+    _airFreeMSecs       = 0;
+    _lastArrivalMSecs   = 0;
+    _burstRemaining     = 0;
+}
+
+bool MockLinkImpairment::_lose(void)
+{
+    if (_burstRemaining > 0) {
+        _burstRemaining--;
+        return true;
+    }
+    // Both draws are always taken so the random sequence doesn't depend on which packets were lost
+    bool burst  = _random.generateDouble() * 100.0 < _config.burstStartPercent;
+    bool lost   = _random.generateDouble() * 100.0 < _config.lossPercent;
+    if (burst && _config.burstLength > 0) {
+        _burstRemaining = _config.burstLength - 1;
+        return true;
+    }
+    return lost;
+}
+
+bool MockLinkImpairment::send(qint64 nowMSecs, const QByteArray& packet)
+{
+    _sentCount++;
+
+    double startMSecs = qMax(static_cast<double>(nowMSecs), _airFreeMSecs);
+    if (_config.bytesPerSecond > 0) {
+        if (_config.queueLimitBytes > 0) {
+            double queuedBytes = (startMSecs - nowMSecs) * _config.bytesPerSecond / 1000.0;
+            if (queuedBytes + packet.count() > _config.queueLimitBytes) {
+                _overflowCount++;
+                return false;
+            }
+        }
+        _airFreeMSecs = startMSecs + packet.count() * 1000.0 / _config.bytesPerSecond;
+    } else {
+        _airFreeMSecs = startMSecs;
+    }
+
+    double jitterMSecs = _config.jitterMSecs > 0 ? _random.generateDouble() * _config.jitterMSecs : 0;
+    if (_lose()) {
+        _lostCount++;
+        return false;
+    }
+
+    double arrivalMSecs = qMax(_airFreeMSecs + _config.latencyMSecs + jitterMSecs, _lastArrivalMSecs);
+    _lastArrivalMSecs = arrivalMSecs;
+    _inFlight.enqueue({ arrivalMSecs, packet });
+    return true;
+}
+
+void MockLinkImpairment::takeArrived(qint64 nowMSecs, QList<QByteArray>& packets)
+{
+    while (!_inFlight.isEmpty() && _inFlight.head().arrivalMSecs <= nowMSecs) {
+        packets.append(_inFlight.dequeue().packet);
+    }
+}
@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QQueue>
+#include <QRandomGenerator>
+
+/// Emulates one direction of a slow, lossy telemetry radio for MockLink.
+///
+/// Packets take up air time at the configured rate, then arrive after the latency plus a random jitter. Delivery
+/// keeps the order packets were sent in, as a radio does. Loss is random per packet, with optional bursts of
+/// consecutive losses, and packets which don't fit in the radio buffer are dropped. Lost packets still use up air
+/// time. Times are passed in by the caller and the randomness comes from the seed only, so the same config and
+/// packet timing always gives the same result. Not thread safe.
+class MockLinkImpairment
+{
+public:
+    typedef struct {
+        int     latencyMSecs        = 0;    ///< Fixed one way delay
+        int     jitterMSecs         = 0;    ///< Random extra delay, up to this much
+        int     bytesPerSecond      = 0;    ///< Rate cap, 0: unlimited
+        int     queueLimitBytes     = 0;    ///< Radio buffer, packets which don't fit are dropped, 0: unlimited
+        double  lossPercent         = 0;    ///< Chance of each packet being lost on its own
+        double  burstStartPercent   = 0;    ///< Chance per packet of a loss burst starting there
+        int     burstLength         = 0;    ///< Packets lost in a row once a burst started
+        quint32 seed                = 0;    ///< Same seed, same losses and jitter
+    } Config_t;
+
+    MockLinkImpairment(void);
+
+    /// SiK style radio at 57600 baud: 8N1 framing, ~40ms latency, light random loss and short loss bursts
+    static Config_t radio57600(quint32 seed = 0);
+
+    const Config_t& config      (void) const { return _config; }
+    void            setConfig   (const Config_t& config);   ///< Also drops anything in flight
+    void            clear       (void);                     ///< Drops anything in flight and resets the random sequence
+
+    /// @return true: config has any impairment, false: packets can bypass this completely
+    bool enabled(void) const { return _enabled; }
+
+    /// Sends a packet at nowMSecs
+    ///     @return false: packet was lost
+    bool send(qint64 nowMSecs, const QByteArray& packet);
+
+    /// Appends the packets which have arrived by nowMSecs to packets, in the order they were sent
+    void takeArrived(qint64 nowMSecs, QList<QByteArray>& packets);
+
+    bool    inFlight        (void) const { return !_inFlight.isEmpty(); }
+    quint64 sentCount       (void) const { return _sentCount; }
+    quint64 lostCount       (void) const { return _lostCount; }     ///< Random and burst losses
+    quint64 overflowCount   (void) const { return _overflowCount; } ///< Dropped because the radio buffer was full
+
+private:
+    typedef struct {
+        double      arrivalMSecs;
+        QByteArray  packet;
+    } Packet_t;
+
+    bool _lose(void);
+
+    Config_t            _config;
+    bool                _enabled            = false;
+    QRandomGenerator    _random;
+    double              _airFreeMSecs       = 0;    ///< Time at which the packets sent so far are all on the air
+    double              _lastArrivalMSecs   = 0;
+    int                 _burstRemaining     = 0;
+    QQueue<Packet_t>    _inFlight;
+    quint64             _sentCount          = 0;
+    quint64             _lostCount          = 0;
+    quint64             _overflowCount      = 0;
+};
@@ -24,6 +24,7 @@ MockLinkMissionItemHandler::MockLinkMissionItemHandler(MockLink* mockLink, MAVLi
     , _failReadRequestListFirstResponse     (true)
     , _failReadRequest1FirstResponse        (true)
     , _failWriteMissionCountFirstResponse   (true)
+    , _failWriteRequest1FirstResponse       (true)
 {
     Q_ASSERT(mockLink);
 }
@@ -279,6 +280,7 @@ void MockLinkMissionItemHandler::_handleMissionCount(const mavlink_message_t& ms
             return;
         }
         _failWriteMissionCountFirstResponse = true;
+        _failWriteRequest1FirstResponse = true;
         _writeSequenceIndex = 0;
         _requestNextMissionItem(_writeSequenceIndex);
     }
@@ -290,6 +292,9 @@ void MockLinkMissionItemHandler::_requestNextMissionItem(int sequenceNumber)
     
     if (_failureMode == FailWriteRequest1NoResponse && sequenceNumber == 1) {
         qCDebug(MockLinkMissionItemHandlerLog) << "_requestNextMissionItem not responding due to failure mode FailWriteRequest1NoResponse";
+    } else if (_failureMode == FailWriteRequest1FirstResponse && sequenceNumber == 1 && _failWriteRequest1FirstResponse) {
+        _failWriteRequest1FirstResponse = false;
+        qCDebug(MockLinkMissionItemHandlerLog) << "_requestNextMissionItem not responding due to failure mode FailWriteRequest1FirstResponse";
     } else {
         if (sequenceNumber >= _writeSequenceCount) {
             qCWarning(MockLinkMissionItemHandlerLog) << "_requestNextMissionItem requested seqeuence number > write count sequenceNumber::_writeSequenceCount" << sequenceNumber << _writeSequenceCount;
@@ -371,6 +376,12 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
         break;
     }
 
+    if (seq < _writeSequenceIndex) {
+        // Item we already have was sent again, ask again for the one we are waiting on like a real vehicle would
+        _requestNextMissionItem(_writeSequenceIndex);
+        return;
+    }
+
     _writeSequenceIndex++;
     if (_writeSequenceIndex < _writeSequenceCount) {
         if (_failureMode == FailWriteFinalAckMissingRequests && _writeSequenceIndex == 3) {
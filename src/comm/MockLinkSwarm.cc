@@ -0,0 +1,294 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockLinkSwarm.h"
+
+#include <QtMath>
+
+#include <cstring>
+#include <random>
+
+// Same area as the single vehicle MockLink
+const double    MockLinkSwarm::_centerLatitude  = 47.397;
+const double    MockLinkSwarm::_centerLongitude = 8.5455;
+const double    MockLinkSwarm::_centerAltitude  = 488.056;
+const char*     MockLinkSwarm::_paramName       = "SWARM_ID";
+
+static const double _metersPerDegree    = 111319.5;
+static const double _gravity            = 9.80665;
+
+MockLinkSwarm::MockLinkSwarm(int vehicleCount, int telemetryRateHz, uint32_t seed, uint8_t mavlinkChannel)
+    : _telemetryRateHz  (qBound(1, telemetryRateHz, maxTelemetryRateHz))
+    , _mavlinkChannel   (mavlinkChannel)
+{
+    memset(&_rxMessage, 0, sizeof(_rxMessage));
+    memset(&_rxStatus,  0, sizeof(_rxStatus));
+
+    // The std distributions are implementation defined, scaling the raw engine output keeps a seed reproducible across platforms
+    std::mt19937 random(seed);
+    auto uniform = [&random](double min, double max) { return min + ((max - min) * (random() / 4294967296.0)); };
+
+    _vehicles.resize(qBound(1, vehicleCount, maxVehicleCount));
+    for (int i=0; i<_vehicles.count(); i++) {
+        Vehicle_t& vehicle = _vehicles[i];
+
+        memset(&vehicle.txStatus, 0, sizeof(vehicle.txStatus));
+        vehicle.systemId        = static_cast<uint8_t>(firstSystemId + i);
+        vehicle.centerLatitude  = _centerLatitude + uniform(-0.02, 0.02);
+        vehicle.centerLongitude = _centerLongitude + uniform(-0.03, 0.03);
+        vehicle.altitude        = _centerAltitude + uniform(30, 120);
+        vehicle.orbitRadius     = uniform(50, 300);
+        vehicle.orbitRate       = (uniform(5, 15) / vehicle.orbitRadius) * ((random() & 1) ? 1 : -1);
+        vehicle.orbitPhase      = uniform(0, 2 * M_PI);
+
+        for (int stream=0; stream<StreamCount; stream++) {
+            // Spread the first messages over the stream period so the vehicles don't all burst on the same tick
+            vehicle.nextMSecs[stream] = static_cast<qint64>(random() % static_cast<uint32_t>(_streamPeriodMSecs(stream)));
+        }
+    }
+}
+
+qint64 MockLinkSwarm::_streamPeriodMSecs(int stream) const
+{
+    switch (stream) {
+    case StreamGlobalPositionInt:
+    case StreamAttitude:
+        return 1000 / _telemetryRateHz;
+    default:
+        return 1000;
+    }
+}
+
+void MockLinkSwarm::tick(qint64 nowMSecs, QByteArray& bytes)
+{
+    for (Vehicle_t& vehicle: _vehicles) {
+        for (int stream=0; stream<StreamCount; stream++) {
+            qint64& nextMSecs = vehicle.nextMSecs[stream];
+            if (nowMSecs < nextMSecs) {
+                continue;
+            }
+
+            _sendStream(vehicle, stream, nowMSecs, bytes);
+
+            qint64 periodMSecs = _streamPeriodMSecs(stream);
+            nextMSecs += periodMSecs;
+            if (nextMSecs <= nowMSecs) {
+                // More than a period behind. Drop the missed periods instead of bursting to catch up, which
+                // keeps the offered load at the configured rate.
+                _lateCount += static_cast<quint64>((nowMSecs - nextMSecs) / periodMSecs) + 1;
+                nextMSecs = nowMSecs + periodMSecs;
+            }
+        }
+    }
+}
+
+void MockLinkSwarm::_sendStream(Vehicle_t& vehicle, int stream, qint64 nowMSecs, QByteArray& bytes)
+{
+    mavlink_message_t message;
+
+    // Position along the orbit is a function of time only, angle is measured clockwise from north
+    double angle        = vehicle.orbitPhase + (vehicle.orbitRate * (nowMSecs / 1000.0));
+    double north        = vehicle.orbitRadius * qCos(angle);
+    double east         = vehicle.orbitRadius * qSin(angle);
+    double velocityN    = -vehicle.orbitRadius * vehicle.orbitRate * qSin(angle);
+    double velocityE    = vehicle.orbitRadius * vehicle.orbitRate * qCos(angle);
+    double speed        = qAbs(vehicle.orbitRadius * vehicle.orbitRate);
+    double heading      = qAtan2(velocityE, velocityN);
+    double latitude     = vehicle.centerLatitude + (north / _metersPerDegree);
+    double longitude    = vehicle.centerLongitude + (east / (_metersPerDegree * qCos(qDegreesToRadians(vehicle.centerLatitude))));
+    uint16_t headingCDeg = static_cast<uint16_t>(static_cast<int>(qRadiansToDegrees(heading) * 100.0 + 36000.0) % 36000);
+
+    switch (stream) {
+    case StreamHeartbeat:
+    {
+        mavlink_heartbeat_t heartbeat;
+        memset(&heartbeat, 0, sizeof(heartbeat));
+        heartbeat.type          = MAV_TYPE_QUADROTOR;
+        heartbeat.autopilot     = MAV_AUTOPILOT_GENERIC;
+        heartbeat.base_mode     = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED | MAV_MODE_FLAG_SAFETY_ARMED;
+        heartbeat.system_status = MAV_STATE_ACTIVE;
+        mavlink_msg_heartbeat_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &message, &heartbeat);
+        break;
+    }
+    case StreamSysStatus:
+    {
+        mavlink_sys_status_t sysStatus;
+        memset(&sysStatus, 0, sizeof(sysStatus));
+        sysStatus.voltage_battery   = 16000;
+        sysStatus.current_battery   = -1;
+        sysStatus.battery_remaining = static_cast<int8_t>(qMax<qint64>(10, 100 - (nowMSecs / 30000)));
+        mavlink_msg_sys_status_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &message, &sysStatus);
+        break;
+    }
+    case StreamGpsRawInt:
+    {
+        mavlink_gps_raw_int_t gpsRawInt;
+        memset(&gpsRawInt, 0, sizeof(gpsRawInt));
+        gpsRawInt.time_usec             = static_cast<uint64_t>(nowMSecs) * 1000;
+        gpsRawInt.fix_type              = GPS_FIX_TYPE_3D_FIX;
+        gpsRawInt.lat                   = static_cast<int32_t>(latitude * 1e7);
+        gpsRawInt.lon                   = static_cast<int32_t>(longitude * 1e7);
+        gpsRawInt.alt                   = static_cast<int32_t>(vehicle.altitude * 1000);
+        gpsRawInt.eph                   = 100;
+        gpsRawInt.epv                   = 150;
+        gpsRawInt.vel                   = static_cast<uint16_t>(speed * 100);
+        gpsRawInt.cog                   = headingCDeg;
+        gpsRawInt.satellites_visible    = 12;
+        mavlink_msg_gps_raw_int_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &message, &gpsRawInt);
+        break;
+    }
+    case StreamGlobalPositionInt:
+    {
+        mavlink_global_position_int_t globalPosition;
+        memset(&globalPosition, 0, sizeof(globalPosition));
+        globalPosition.time_boot_ms = static_cast<uint32_t>(nowMSecs);
+        globalPosition.lat          = static_cast<int32_t>(latitude * 1e7);
+        globalPosition.lon          = static_cast<int32_t>(longitude * 1e7);
+        globalPosition.alt          = static_cast<int32_t>(vehicle.altitude * 1000);
+        globalPosition.relative_alt = static_cast<int32_t>((vehicle.altitude - _centerAltitude) * 1000);
+        globalPosition.vx           = static_cast<int16_t>(velocityN * 100);
+        globalPosition.vy           = static_cast<int16_t>(velocityE * 100);
+        globalPosition.hdg          = headingCDeg;
+        mavlink_msg_global_position_int_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &message, &globalPosition);
+        break;
+    }
+    case StreamAttitude:
+    {
+        mavlink_attitude_t attitude;
+        memset(&attitude, 0, sizeof(attitude));
+        attitude.time_boot_ms   = static_cast<uint32_t>(nowMSecs);
+        attitude.roll           = static_cast<float>(qAtan(speed * vehicle.orbitRate / _gravity));   // Coordinated turn
+        attitude.yaw            = static_cast<float>(heading);
+        attitude.yawspeed       = static_cast<float>(vehicle.orbitRate);
+        mavlink_msg_attitude_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &message, &attitude);
+        break;
+    }
+    default:
+        return;
+    }
+
+    _appendMessage(vehicle, message, bytes);
+}
+
+void MockLinkSwarm::handleBytes(const QByteArray& bytes, QByteArray& responses)
+{
+    for (char byte: bytes) {
+        mavlink_message_t   message;
+        mavlink_status_t    status;
+
+        if (mavlink_frame_char_buffer(&_rxMessage, &_rxStatus, static_cast<uint8_t>(byte), &message, &status) == MAVLINK_FRAMING_OK) {
+            _handleMessage(message, responses);
+        }
+    }
+}
+
+void MockLinkSwarm::_handleMessage(const mavlink_message_t& message, QByteArray& responses)
+{
+    int targetSystem;
+
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+        targetSystem = mavlink_msg_param_request_list_get_target_system(&message);
+        break;
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+        targetSystem = mavlink_msg_param_request_read_get_target_system(&message);
+        break;
+    case MAVLINK_MSG_ID_PARAM_SET:
+        targetSystem = mavlink_msg_param_set_get_target_system(&message);
+        break;
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+        targetSystem = mavlink_msg_mission_request_list_get_target_system(&message);
+        break;
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+        targetSystem = mavlink_msg_command_long_get_target_system(&message);
+        break;
+    default:
+        return;
+    }
+
+    // System ids are contiguous, so a targeted request is a direct index
+    int first   = 0;
+    int last    = _vehicles.count() - 1;
+    if (targetSystem != 0) {
+        first = last = targetSystem - firstSystemId;
+        if (first < 0 || first >= _vehicles.count()) {
+            return;
+        }
+    }
+
+    for (int i=first; i<=last; i++) {
+        Vehicle_t&          vehicle = _vehicles[i];
+        mavlink_message_t   response;
+
+        switch (message.msgid) {
+        case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+        case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+        case MAVLINK_MSG_ID_PARAM_SET:
+            // The single read only parameter is the full parameter set
+            _sendParamValue(vehicle, responses);
+            break;
+        case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+        {
+            mavlink_mission_count_t missionCount;
+            memset(&missionCount, 0, sizeof(missionCount));
+            missionCount.target_system      = message.sysid;
+            missionCount.target_component   = message.compid;
+            missionCount.count              = 0;
+            missionCount.mission_type       = mavlink_msg_mission_request_list_get_mission_type(&message);
+            mavlink_msg_mission_count_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &response, &missionCount);
+            _appendMessage(vehicle, response, responses);
+            break;
+        }
+        case MAVLINK_MSG_ID_COMMAND_LONG:
+        {
+            mavlink_command_ack_t commandAck;
+            memset(&commandAck, 0, sizeof(commandAck));
+            commandAck.command          = mavlink_msg_command_long_get_command(&message);
+            commandAck.result           = MAV_RESULT_UNSUPPORTED;
+            commandAck.target_system    = message.sysid;
+            commandAck.target_component = message.compid;
+            mavlink_msg_command_ack_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &response, &commandAck);
+            _appendMessage(vehicle, response, responses);
+            break;
+        }
+        }
+    }
+}
+
+void MockLinkSwarm::_sendParamValue(Vehicle_t& vehicle, QByteArray& bytes)
+{
+    mavlink_message_t       message;
+    mavlink_param_value_t   paramValue;
+
+    memset(&paramValue, 0, sizeof(paramValue));
+    strncpy(paramValue.param_id, _paramName, sizeof(paramValue.param_id));
+    paramValue.param_value  = vehicle.systemId;
+    paramValue.param_type   = MAV_PARAM_TYPE_REAL32;
+    paramValue.param_count  = 1;
+    paramValue.param_index  = 0;
+    mavlink_msg_param_value_encode_chan(vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, _mavlinkChannel, &message, &paramValue);
+    _appendMessage(vehicle, message, bytes);
+}
+
+void MockLinkSwarm::_appendMessage(Vehicle_t& vehicle, mavlink_message_t& message, QByteArray& bytes)
+{
+    // The pack functions number messages on the shared channel, renumber them on the vehicle's own sequence so
+    // QGC loss tracking sees each vehicle as a separate gap free stream
+    const mavlink_msg_entry_t* msgEntry = mavlink_get_msg_entry(message.msgid);
+    if (!msgEntry) {
+        return;
+    }
+    mavlink_finalize_message_buffer(&message, vehicle.systemId, MAV_COMP_ID_AUTOPILOT1, &vehicle.txStatus, msgEntry->min_msg_len, message.len, msgEntry->crc_extra);
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int     cBuffer = mavlink_msg_to_send_buffer(buffer, &message);
+
+    bytes.append(reinterpret_cast<const char*>(buffer), cBuffer);
+    _sentCount++;
+}
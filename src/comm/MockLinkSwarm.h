@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include "QGCMAVLink.h"
+
+/// Simulates a swarm of lightweight vehicles behind a single MockLink. Used as a load generator for measuring how
+/// vehicle handling and map rendering scale with vehicle count.
+///
+/// Each vehicle only sends a basic telemetry set and answers just enough of the connection sequence for QGC to
+/// finish initial connect. The output depends only on the seed and the times passed to tick, so two swarms built
+/// with the same arguments produce identical byte streams. Not thread safe, it is owned by the MockLink thread.
+class MockLinkSwarm
+{
+public:
+    /// @param vehicleCount     Number of vehicles, system ids are assigned from firstSystemId up
+    /// @param telemetryRateHz  Rate for position and attitude, status messages are always sent at 1Hz
+    /// @param seed             Seed for vehicle placement, orbits and stream phases
+    /// @param mavlinkChannel   Channel used for packing messages
+    MockLinkSwarm(int vehicleCount, int telemetryRateHz, uint32_t seed, uint8_t mavlinkChannel);
+
+    /// Appends all telemetry which is due at nowMSecs to bytes
+    ///     @param nowMSecs Time since the swarm started, must not go backwards
+    void tick(qint64 nowMSecs, QByteArray& bytes);
+
+    /// Handles bytes written by QGC and appends any responses to responses
+    void handleBytes(const QByteArray& bytes, QByteArray& responses);
+
+    int         vehicleCount    (void) const { return _vehicles.count(); }
+    int         telemetryRateHz (void) const { return _telemetryRateHz; }
+    quint64     sentCount       (void) const { return _sentCount; }     ///< Messages sent since construction
+    quint64     lateCount       (void) const { return _lateCount; }     ///< Stream periods dropped because tick fell behind
+
+    static const int firstSystemId      = 1;
+    static const int maxVehicleCount    = 250;
+    static const int maxTelemetryRateHz = 50;
+    static const int tickMSecs          = 10;   ///< Interval at which MockLink calls tick
+
+private:
+    typedef enum {
+        StreamHeartbeat,
+        StreamSysStatus,
+        StreamGpsRawInt,
+        StreamGlobalPositionInt,
+        StreamAttitude,
+        StreamCount
+    } Stream_t;
+
+    typedef struct {
+        uint8_t             systemId;
+        mavlink_status_t    txStatus;               ///< Private sequence numbering per vehicle
+        double              centerLatitude;
+        double              centerLongitude;
+        double              altitude;               ///< AMSL meters
+        double              orbitRadius;            ///< Meters
+        double              orbitRate;              ///< Radians/sec, positive is clockwise
+        double              orbitPhase;             ///< Radians
+        qint64              nextMSecs[StreamCount]; ///< Time at which each stream is next due
+    } Vehicle_t;
+
+    qint64  _streamPeriodMSecs  (int stream) const;
+    void    _sendStream         (Vehicle_t& vehicle, int stream, qint64 nowMSecs, QByteArray& bytes);
+    void    _handleMessage      (const mavlink_message_t& message, QByteArray& responses);
+    void    _sendParamValue     (Vehicle_t& vehicle, QByteArray& bytes);
+    void    _appendMessage      (Vehicle_t& vehicle, mavlink_message_t& message, QByteArray& bytes);
+
+    QVector<Vehicle_t>  _vehicles;
+    int                 _telemetryRateHz;
+    uint8_t             _mavlinkChannel;
+    mavlink_message_t   _rxMessage;
+    mavlink_status_t    _rxStatus;
+    quint64             _sentCount = 0;
+    quint64             _lateCount = 0;
+
+    static const double _centerLatitude;
+    static const double _centerLongitude;
+    static const double _centerAltitude;
+    static const char*  _paramName;
+};
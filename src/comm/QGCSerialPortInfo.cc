@@ -41,6 +41,8 @@ const QGCSerialPortInfo::BoardClassString2BoardType_t QGCSerialPortInfo::_rgBoar
 QList<QGCSerialPortInfo::BoardInfo_t>           QGCSerialPortInfo::_boardInfoList;
 QList<QGCSerialPortInfo::BoardRegExpFallback_t> QGCSerialPortInfo::_boardDescriptionFallbackList;
 QList<QGCSerialPortInfo::BoardRegExpFallback_t> QGCSerialPortInfo::_boardManufacturerFallbackList;
+QHash<QString, QGCSerialPortInfo::BoardInfoCacheEntry_t> QGCSerialPortInfo::_boardInfoCache;
+QMutex                                          QGCSerialPortInfo::_boardInfoCacheMutex;
 
 QGCSerialPortInfo::QGCSerialPortInfo(void) :
     QSerialPortInfo()
@@ -56,6 +58,10 @@ QGCSerialPortInfo::QGCSerialPortInfo(const QSerialPort & port) :
 
 void QGCSerialPortInfo::_loadJsonData(void)
 {
+    // Ports are classified on the autoconnect scanner thread as well as the GUI thread
+    static QMutex loadMutex;
+    QMutexLocker lock(&loadMutex);
+
     if (_jsonLoaded) {
         return;
     }
@@ -222,6 +228,27 @@ bool QGCSerialPortInfo::getBoardInfo(QGCSerialPortInfo::BoardType_t& boardType,
         return false;
     }
 
+    // The answer only depends on what the device reports about itself, so each kind of device is classified once
+    // instead of running the regular expressions over every port on every autoconnect pass.
+    const QString key = QStringLiteral("%1:%2:%3:%4").arg(vendorIdentifier()).arg(productIdentifier()).arg(description(), manufacturer());
+
+    QMutexLocker lock(&_boardInfoCacheMutex);
+    auto iter = _boardInfoCache.constFind(key);
+    if (iter == _boardInfoCache.constEnd()) {
+        BoardInfoCacheEntry_t entry;
+        entry.boardType = BoardTypeUnknown;
+        entry.found     = _classifyBoard(entry.boardType, entry.name);
+        iter = _boardInfoCache.insert(key, entry);
+        qCDebug(QGCSerialPortInfoLog) << "Classified" << key << entry.found << entry.name;
+    }
+
+    boardType   = iter->boardType;
+    name        = iter->name;
+    return iter->found;
+}
+
+bool QGCSerialPortInfo::_classifyBoard(QGCSerialPortInfo::BoardType_t& boardType, QString& name) const
+{
     for (int i=0; i<_boardInfoList.count(); i++) {
         const BoardInfo_t& boardInfo = _boardInfoList[i];
 
@@ -18,6 +18,9 @@
 
 #include "QGCLoggingCategory.h"
 
+#include <QHash>
+#include <QMutex>
+
 Q_DECLARE_LOGGING_CATEGORY(QGCSerialPortInfoLog)
 
 /// QGC's version of Qt QSerialPortInfo. It provides additional information about board types
@@ -70,8 +73,15 @@ private:
         bool        androidOnly;
     } BoardRegExpFallback_t;
 
+    typedef struct {
+        bool        found;
+        BoardType_t boardType;
+        QString     name;
+    } BoardInfoCacheEntry_t;
+
     static void _loadJsonData(void);
     static BoardType_t _boardClassStringToType(const QString& boardClass);
+    bool _classifyBoard(BoardType_t& boardType, QString& name) const;
     static QString _boardTypeToString(BoardType_t boardType);
 
     static bool         _jsonLoaded;
@@ -90,5 +100,7 @@ private:
     static QList<BoardInfo_t>                   _boardInfoList;
     static QList<BoardRegExpFallback_t>         _boardDescriptionFallbackList;
     static QList<BoardRegExpFallback_t>         _boardManufacturerFallbackList;
+    static QHash<QString, BoardInfoCacheEntry_t> _boardInfoCache;               ///< key: vid:pid:description:manufacturer
+    static QMutex                               _boardInfoCacheMutex;
 };
 
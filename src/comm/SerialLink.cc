@@ -66,7 +66,12 @@ bool SerialLink::_isBootloader()
 
 void SerialLink::_writeBytes(const QByteArray data)
 {
-    if(_port && _port->isOpen()) {
+    if (_worker) {
+        // The port belongs to the link thread
+        emit bytesSent(this, data);
+        SerialPortWorker* worker = _worker;
+        QMetaObject::invokeMethod(_worker, [worker, data]() { worker->write(data); }, Qt::QueuedConnection);
+    } else if(_port && _port->isOpen()) {
         emit bytesSent(this, data);
         _port->write(data);
     } else {
@@ -78,7 +83,17 @@ void SerialLink::_writeBytes(const QByteArray data)
 
 void SerialLink::disconnect(void)
 {
-    if (_port) {
+    if (_worker) {
+        SerialPortWorker* worker = _worker;
+        QMetaObject::invokeMethod(_worker, [worker]() { worker->close(); }, Qt::BlockingQueuedConnection);
+        // Deferred deletes are still processed as the thread finishes, which in turn deletes the port
+        _worker->deleteLater();
+        quit();
+        wait();
+        _worker = nullptr;
+        _port = nullptr;
+        emit disconnected();
+    } else if (_port) {
         // This prevents stale signals from calling the link after it has been deleted
         QObject::disconnect(_port, &QIODevice::readyRead, this, &SerialLink::_readBytes);
         _port->close();
@@ -178,7 +193,9 @@ bool SerialLink::_hardwareConnect(QSerialPort::SerialPortError& error, QString&
     _port = new QSerialPort(_serialConfig->portName(), this);
 
     QObject::connect(_port, static_cast<void (QSerialPort::*)(QSerialPort::SerialPortError)>(&QSerialPort::error), this, &SerialLink::linkError);
-    QObject::connect(_port, &QIODevice::readyRead, this, &SerialLink::_readBytes);
+    if (!_serialConfig->threadedIO()) {
+        QObject::connect(_port, &QIODevice::readyRead, this, &SerialLink::_readBytes);
+    }
 
     // After the bootloader times out, it still can take a second or so for the Pixhawk USB driver to come up and make
     // the port available for open. So we retry a few times to wait for it.
@@ -220,6 +237,18 @@ bool SerialLink::_hardwareConnect(QSerialPort::SerialPortError& error, QString&
     _port->setStopBits     (static_cast<QSerialPort::StopBits>     (_serialConfig->stopBits()));
     _port->setParity       (static_cast<QSerialPort::Parity>       (_serialConfig->parity()));
 
+    if (_serialConfig->threadedIO()) {
+        qCDebug(SerialLinkLog) << "Starting threaded I/O minBytes:maxWait" << _serialConfig->readMinBytes() << _serialConfig->readMaxWaitMSecs();
+        _port->setParent(nullptr);
+        _worker = new SerialPortWorker(_port, _serialConfig->readMinBytes(), _serialConfig->readMaxWaitMSecs());
+        // Emitted directly from the link thread, MAVLinkProtocol::receiveBytes is thread safe
+        QObject::connect(_worker, &SerialPortWorker::bytesReceived, this, [this](QByteArray bytes) { emit bytesReceived(this, bytes); }, Qt::DirectConnection);
+        _worker->moveToThread(this);
+        start(HighPriority);
+        SerialPortWorker* worker = _worker;
+        QMetaObject::invokeMethod(_worker, [worker]() { worker->start(); }, Qt::QueuedConnection);
+    }
+
     emit connected();
 
     qCDebug(SerialLinkLog) << "Connection SeriaLink: " << "with settings" << _serialConfig->portName()
@@ -293,6 +322,9 @@ SerialConfiguration::SerialConfiguration(const QString& name) : LinkConfiguratio
     _dataBits   = 8;
     _stopBits   = 1;
     _usbDirect  = false;
+    _threadedIO = false;
+    _readMinBytes       = 256;
+    _readMaxWaitMSecs   = 5;
 }
 
 SerialConfiguration::SerialConfiguration(SerialConfiguration* copy) : LinkConfiguration(copy)
@@ -305,6 +337,9 @@ SerialConfiguration::SerialConfiguration(SerialConfiguration* copy) : LinkConfig
     _portName           = copy->portName();
     _portDisplayName    = copy->portDisplayName();
     _usbDirect          = copy->_usbDirect;
+    _threadedIO         = copy->_threadedIO;
+    _readMinBytes       = copy->_readMinBytes;
+    _readMaxWaitMSecs   = copy->_readMaxWaitMSecs;
 }
 
 void SerialConfiguration::copyFrom(LinkConfiguration *source)
@@ -320,6 +355,9 @@ void SerialConfiguration::copyFrom(LinkConfiguration *source)
         _portName           = ssource->portName();
         _portDisplayName    = ssource->portDisplayName();
         _usbDirect          = ssource->_usbDirect;
+        _threadedIO         = ssource->_threadedIO;
+        _readMinBytes       = ssource->_readMinBytes;
+        _readMaxWaitMSecs   = ssource->_readMaxWaitMSecs;
     } else {
         qWarning() << "Internal error";
     }
@@ -350,6 +388,32 @@ void SerialConfiguration::setParity(int parity)
     _parity = parity;
 }
 
+void SerialConfiguration::setThreadedIO(bool threadedIO)
+{
+    if (threadedIO != _threadedIO) {
+        _threadedIO = threadedIO;
+        emit threadedIOChanged();
+    }
+}
+
+void SerialConfiguration::setReadMinBytes(int readMinBytes)
+{
+    readMinBytes = qBound(0, readMinBytes, LinkReceiveBuffer::defaultCapacity / 2);
+    if (readMinBytes != _readMinBytes) {
+        _readMinBytes = readMinBytes;
+        emit readMinBytesChanged();
+    }
+}
+
+void SerialConfiguration::setReadMaxWaitMSecs(int readMaxWaitMSecs)
+{
+    readMaxWaitMSecs = qBound(1, readMaxWaitMSecs, 1000);
+    if (readMaxWaitMSecs != _readMaxWaitMSecs) {
+        _readMaxWaitMSecs = readMaxWaitMSecs;
+        emit readMaxWaitMSecsChanged();
+    }
+}
+
 void SerialConfiguration::setPortName(const QString& portName)
 {
     // No effect on a running connection
@@ -382,6 +446,9 @@ void SerialConfiguration::saveSettings(QSettings& settings, const QString& root)
     settings.setValue("parity",         _parity);
     settings.setValue("portName",       _portName);
     settings.setValue("portDisplayName",_portDisplayName);
+    settings.setValue("threadedIO",     _threadedIO);
+    settings.setValue("readMinBytes",   _readMinBytes);
+    settings.setValue("readMaxWaitMSecs",_readMaxWaitMSecs);
     settings.endGroup();
 }
 
@@ -395,6 +462,9 @@ void SerialConfiguration::loadSettings(QSettings& settings, const QString& root)
     if(settings.contains("parity"))         _parity         = settings.value("parity").toInt();
     if(settings.contains("portName"))       _portName       = settings.value("portName").toString();
     if(settings.contains("portDisplayName"))_portDisplayName= settings.value("portDisplayName").toString();
+    if(settings.contains("threadedIO"))     _threadedIO     = settings.value("threadedIO").toBool();
+    if(settings.contains("readMinBytes"))   setReadMinBytes(settings.value("readMinBytes").toInt());
+    if(settings.contains("readMaxWaitMSecs"))setReadMaxWaitMSecs(settings.value("readMaxWaitMSecs").toInt());
     settings.endGroup();
 }
 
@@ -463,3 +533,88 @@ void SerialConfiguration::setUsbDirect(bool usbDirect)
         emit usbDirectChanged(_usbDirect);
     }
 }
+
+//--------------------------------------------------------------------------
+//-- SerialPortWorker
+
+SerialPortWorker::SerialPortWorker(QSerialPort* port, int readMinBytes, int readMaxWaitMSecs)
+    : _port         (port)
+    , _flushTimer   (this)
+    , _readMinBytes (readMinBytes)
+{
+    _port->setParent(this);
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(readMaxWaitMSecs);
+    _flushTimer.setTimerType(Qt::PreciseTimer);
+}
+
+void SerialPortWorker::start(void)
+{
+    connect(_port,          &QIODevice::readyRead,  this, &SerialPortWorker::_readBytes);
+    connect(&_flushTimer,   &QTimer::timeout,       this, &SerialPortWorker::_flushTimeout);
+
+    // Pick up anything which arrived while the port was changing threads
+    _readBytes();
+}
+
+void SerialPortWorker::write(const QByteArray data)
+{
+    if (_port->isOpen()) {
+        _port->write(data);
+    }
+}
+
+void SerialPortWorker::close(void)
+{
+    _flushTimer.stop();
+    QObject::disconnect(_port, &QIODevice::readyRead, this, &SerialPortWorker::_readBytes);
+    _port->close();
+}
+
+void SerialPortWorker::_readBytes(void)
+{
+    while (_port->bytesAvailable() > 0) {
+        if (_receiveBuffer.freeSpace() == 0) {
+            _flush(true);
+        }
+        if (_receiveBuffer.readFrom(_port) <= 0) {
+            break;
+        }
+        _bytesSinceTimeout = true;
+    }
+
+    if (_receiveBuffer.count() >= _readMinBytes) {
+        _flush(false);
+    }
+    // The timer is not restarted on new data, so nothing is held back longer than the max wait
+    if (_receiveBuffer.count() > 0 && !_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+}
+
+void SerialPortWorker::_flushTimeout(void)
+{
+    // A partial frame which has not grown for a full wait period is most likely noise, pass it on as is
+    if (_flush(false) == 0 && !_bytesSinceTimeout) {
+        _flush(true);
+    }
+    _bytesSinceTimeout = false;
+
+    if (_receiveBuffer.count() > 0) {
+        _flushTimer.start();
+    }
+}
+
+/// @return Number of bytes handed off
+int SerialPortWorker::_flush(bool includePartialFrame)
+{
+    QByteArray bytes;
+
+    bytes.reserve(_receiveBuffer.count());
+    int count = includePartialFrame ? _receiveBuffer.takeAll(bytes) : _receiveBuffer.takeFrames(bytes);
+    if (count) {
+        emit bytesReceived(bytes);
+    }
+
+    return count;
+}
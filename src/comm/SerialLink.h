@@ -13,6 +13,7 @@
 #include <QThread>
 #include <QMutex>
 #include <QString>
+#include <QTimer>
 
 #ifdef __android__
 #include "qserialport.h"
@@ -28,6 +29,7 @@ Q_DECLARE_METATYPE(QSerialPort::SerialPortError)
 #include "QGCConfig.h"
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "LinkReceiveBuffer.h"
 
 Q_DECLARE_LOGGING_CATEGORY(SerialLinkLog)
 
@@ -51,6 +53,9 @@ public:
     Q_PROPERTY(QString  portName        READ portName           WRITE setPortName           NOTIFY portNameChanged)
     Q_PROPERTY(QString  portDisplayName READ portDisplayName                                NOTIFY portDisplayNameChanged)
     Q_PROPERTY(bool     usbDirect       READ usbDirect          WRITE setUsbDirect          NOTIFY usbDirectChanged)        ///< true: direct usb connection to board
+    Q_PROPERTY(bool     threadedIO      READ threadedIO         WRITE setThreadedIO         NOTIFY threadedIOChanged)       ///< true: port is serviced from its own thread
+    Q_PROPERTY(int      readMinBytes    READ readMinBytes       WRITE setReadMinBytes       NOTIFY readMinBytesChanged)     ///< Threaded I/O: bytes to collect before handing off
+    Q_PROPERTY(int      readMaxWaitMSecs READ readMaxWaitMSecs  WRITE setReadMaxWaitMSecs   NOTIFY readMaxWaitMSecsChanged) ///< Threaded I/O: longest time data is held back
 
     int  baud()         { return _baud; }
     int  dataBits()     { return _dataBits; }
@@ -58,6 +63,9 @@ public:
     int  stopBits()     { return _stopBits; }
     int  parity()       { return _parity; }         ///< QSerialPort Enums
     bool usbDirect()    { return _usbDirect; }
+    bool threadedIO()   { return _threadedIO; }
+    int  readMinBytes() { return _readMinBytes; }
+    int  readMaxWaitMSecs() { return _readMaxWaitMSecs; }
 
     const QString portName          () { return _portName; }
     const QString portDisplayName   () { return _portDisplayName; }
@@ -69,6 +77,9 @@ public:
     void setParity          (int parity);               ///< QSerialPort Enums
     void setPortName        (const QString& portName);
     void setUsbDirect       (bool usbDirect);
+    void setThreadedIO      (bool threadedIO);
+    void setReadMinBytes    (int readMinBytes);
+    void setReadMaxWaitMSecs(int readMaxWaitMSecs);
 
     static QStringList supportedBaudRates();
     static QString cleanPortDisplayname(const QString name);
@@ -91,6 +102,9 @@ signals:
     void portNameChanged        ();
     void portDisplayNameChanged ();
     void usbDirectChanged       (bool usbDirect);
+    void threadedIOChanged      ();
+    void readMinBytesChanged    ();
+    void readMaxWaitMSecsChanged();
 
 private:
     static void _initBaudRates();
@@ -103,6 +117,45 @@ private:
     QString _portName;
     QString _portDisplayName;
     bool _usbDirect;
+    bool _threadedIO;
+    int _readMinBytes;
+    int _readMaxWaitMSecs;
+};
+
+/// Services a serial port from the SerialLink thread when threaded I/O is enabled.
+///
+/// Incoming data is collected in a LinkReceiveBuffer and handed off as one batch of complete MAVLink frames once
+/// readMinBytes is reached, or readMaxWaitMSecs after the first unsent byte arrived, whichever comes first. This
+/// trades a bounded amount of latency for far fewer bytesReceived emissions on fast ports.
+class SerialPortWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Takes ownership of port
+    SerialPortWorker(QSerialPort* port, int readMinBytes, int readMaxWaitMSecs);
+
+public slots:
+    void start  (void);
+    void write  (const QByteArray data);
+    void close  (void);
+
+signals:
+    /// Emitted on the worker thread
+    void bytesReceived(QByteArray bytes);
+
+private slots:
+    void _readBytes     (void);
+    void _flushTimeout  (void);
+
+private:
+    int _flush(bool includePartialFrame);
+
+    QSerialPort*        _port;
+    LinkReceiveBuffer   _receiveBuffer;
+    QTimer              _flushTimer;
+    int                 _readMinBytes;
+    bool                _bytesSinceTimeout  = false;
 };
 
 class SerialLink : public LinkInterface
@@ -139,6 +192,7 @@ private:
     bool _isBootloader      (void);
 
     QSerialPort*            _port               = nullptr;
+    SerialPortWorker*       _worker             = nullptr;  ///< Only used with threaded I/O, owns _port and lives on the link thread
     quint64                 _bytesRead          = 0;
     int                     _timeout;
     QMutex                  _dataMutex;                     ///< Mutex for reading data from _port
@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SerialPortScanner.h"
+#include "LinkManager.h"
+
+SerialPortScanner::SerialPortScanner(QObject* parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<SerialPortScanner::PortList_t>("SerialPortScanner::PortList_t");
+}
+
+bool SerialPortScanner::_samePort(const Port_t& port1, const Port_t& port2)
+{
+    return port1.info.vendorIdentifier()    == port2.info.vendorIdentifier() &&
+           port1.info.productIdentifier()   == port2.info.productIdentifier() &&
+           port1.info.serialNumber()        == port2.info.serialNumber() &&
+           port1.info.description()         == port2.info.description() &&
+           port1.info.manufacturer()        == port2.info.manufacturer() &&
+           port1.bootloader                 == port2.bootloader;
+}
+
+void SerialPortScanner::scan(void)
+{
+    QMap<QString, Port_t> ports;
+
+    for (const QGCSerialPortInfo& portInfo: QGCSerialPortInfo::availablePorts()) {
+        Port_t port;
+
+        port.info       = portInfo;
+        port.boardType  = QGCSerialPortInfo::BoardTypeUnknown;
+        port.boardFound = portInfo.getBoardInfo(port.boardType, port.boardName);
+        port.bootloader = port.boardFound && portInfo.isBootloader();
+
+        ports[portInfo.systemLocation()] = port;
+    }
+
+    PortList_t  added;
+    QStringList removed;
+
+    for (auto iter = ports.constBegin(); iter != ports.constEnd(); iter++) {
+        auto previous = _ports.constFind(iter.key());
+        if (previous != _ports.constEnd() && _samePort(previous.value(), iter.value())) {
+            continue;
+        }
+
+        const QGCSerialPortInfo& portInfo = iter->info;
+        qCVerbose(LinkManagerVerboseLog) << "-----------------------------------------------------";
+        qCVerbose(LinkManagerVerboseLog) << "portName:          " << portInfo.portName();
+        qCVerbose(LinkManagerVerboseLog) << "systemLocation:    " << portInfo.systemLocation();
+        qCVerbose(LinkManagerVerboseLog) << "description:       " << portInfo.description();
+        qCVerbose(LinkManagerVerboseLog) << "manufacturer:      " << portInfo.manufacturer();
+        qCVerbose(LinkManagerVerboseLog) << "serialNumber:      " << portInfo.serialNumber();
+        qCVerbose(LinkManagerVerboseLog) << "vendorIdentifier:  " << portInfo.vendorIdentifier();
+        qCVerbose(LinkManagerVerboseLog) << "productIdentifier: " << portInfo.productIdentifier();
+        qCVerbose(LinkManagerVerboseLog) << "board:             " << iter->boardName << (iter->bootloader ? "(bootloader)" : "");
+
+        added.append(iter.value());
+    }
+
+    for (auto iter = _ports.constBegin(); iter != _ports.constEnd(); iter++) {
+        if (!ports.contains(iter.key())) {
+            qCDebug(LinkManagerLog) << "Serial port removed" << iter.key();
+            removed.append(iter.key());
+        }
+    }
+
+    _ports = ports;
+    emit scanComplete(added, removed);
+}
@@ -0,0 +1,51 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+
+#include "QGCSerialPortInfo.h"
+
+/// Enumerates the serial ports and works out which board is on each of them. Lives on its own thread so a slow USB
+/// serial driver can't stall the GUI. Each scan reports only what changed since the previous one.
+class SerialPortScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef struct {
+        QGCSerialPortInfo               info;
+        bool                            boardFound;     ///< true: boardType and boardName are valid
+        QGCSerialPortInfo::BoardType_t  boardType;
+        QString                         boardName;
+        bool                            bootloader;     ///< true: board is still in its bootloader
+    } Port_t;
+
+    typedef QList<Port_t> PortList_t;
+
+    SerialPortScanner(QObject* parent = nullptr);
+
+public slots:
+    void scan(void);
+
+signals:
+    /// Signalled at the end of every scan, even when nothing changed
+    ///     @param added    Ports which are new or now report something different, keyed by systemLocation
+    ///     @param removed  systemLocation of the ports which are gone
+    void scanComplete(const SerialPortScanner::PortList_t& added, const QStringList& removed);
+
+private:
+    static bool _samePort(const Port_t& port1, const Port_t& port2);
+
+    QMap<QString, Port_t> _ports;   ///< Result of the previous scan, key: systemLocation
+};
@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SerialPortWatcher.h"
+
+#include <QCoreApplication>
+#include <QDir>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <dbt.h>
+#endif
+
+#if defined(__android__)
+#include <jni.h>
+#include <QtAndroidExtras/QtAndroidExtras>
+#include <QtAndroidExtras/QAndroidJniObject>
+#endif
+
+QGC_LOGGING_CATEGORY(SerialPortWatcherLog, "SerialPortWatcherLog")
+
+#if defined(__android__)
+static SerialPortWatcher* _instance = nullptr;  ///< Target for the Java broadcast receiver
+#endif
+
+SerialPortWatcher::SerialPortWatcher(QObject* parent)
+    : QObject(parent)
+{
+    _settleTimer.setSingleShot(true);
+    _settleTimer.setInterval(_settleMSecs);
+    connect(&_settleTimer, &QTimer::timeout, this, &SerialPortWatcher::portsChanged);
+
+#if defined(Q_OS_WIN)
+    if (QCoreApplication::instance()) {
+        QCoreApplication::instance()->installNativeEventFilter(this);
+        _active = true;
+    }
+#elif defined(__android__)
+    _instance   = this;
+    _active     = true;
+#elif !defined(__ios__)
+    if (QDir(QStringLiteral("/dev")).exists()) {
+        _active = _devWatcher.addPath(QStringLiteral("/dev"));
+        connect(&_devWatcher, &QFileSystemWatcher::directoryChanged, this, &SerialPortWatcher::_deviceChanged);
+    }
+#endif
+
+    qCDebug(SerialPortWatcherLog) << "Hotplug notifications" << (_active ? "active" : "not available, polling");
+}
+
+SerialPortWatcher::~SerialPortWatcher()
+{
+#if defined(Q_OS_WIN)
+    if (_active && QCoreApplication::instance()) {
+        QCoreApplication::instance()->removeNativeEventFilter(this);
+    }
+#elif defined(__android__)
+    if (_instance == this) {
+        _instance = nullptr;
+    }
+#endif
+}
+
+void SerialPortWatcher::_deviceChanged(void)
+{
+    qCDebug(SerialPortWatcherLog) << "Device change";
+    _settleTimer.start();
+}
+
+#if defined(Q_OS_WIN)
+bool SerialPortWatcher::nativeEventFilter(const QByteArray& eventType, void* message, long* result)
+{
+    Q_UNUSED(result)
+
+    if (eventType == "windows_generic_MSG") {
+        const MSG* msg = static_cast<const MSG*>(message);
+        if (msg->message == WM_DEVICECHANGE && (msg->wParam == DBT_DEVICEARRIVAL || msg->wParam == DBT_DEVICEREMOVECOMPLETE)) {
+            _deviceChanged();
+        }
+    }
+
+    // Never swallow the message, Qt and SDL want to see it as well
+    return false;
+}
+#endif
+
+#if defined(__android__)
+static const char kJniClassName[] {"org/mavlink/qgroundcontrol/QGCActivity"};
+
+static void jniSerialPortsChanged(JNIEnv* envA, jobject thizA)
+{
+    Q_UNUSED(envA);
+    Q_UNUSED(thizA);
+
+    // Called from the Java UI thread
+    if (_instance) {
+        QMetaObject::invokeMethod(_instance, "_deviceChanged", Qt::QueuedConnection);
+    }
+}
+
+void SerialPortWatcher::setNativeMethods(void)
+{
+    JNINativeMethod javaMethods[] {
+        {"nativeSerialPortsChanged", "()V", reinterpret_cast<void *>(jniSerialPortsChanged)}
+    };
+
+    QAndroidJniEnvironment jniEnv;
+    if (jniEnv->ExceptionCheck()) {
+        jniEnv->ExceptionClear();
+    }
+
+    jclass objectClass = jniEnv->FindClass(kJniClassName);
+    if (!objectClass) {
+        jniEnv->ExceptionClear();
+        qWarning() << "Couldn't find class:" << kJniClassName;
+        return;
+    }
+
+    jint val = jniEnv->RegisterNatives(objectClass, javaMethods, sizeof(javaMethods) / sizeof(javaMethods[0]));
+    if (val < 0) {
+        qWarning() << "Error registering methods: " << val;
+    } else {
+        qCDebug(SerialPortWatcherLog) << "Native Functions Registered";
+    }
+    if (jniEnv->ExceptionCheck()) {
+        jniEnv->ExceptionClear();
+    }
+}
+#endif
@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+#if defined(Q_OS_WIN)
+#include <QAbstractNativeEventFilter>
+#elif !defined(__android__) && !defined(__ios__)
+#include <QFileSystemWatcher>
+#endif
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(SerialPortWatcherLog)
+
+/// Tells LinkManager when serial ports may have come or gone so it only enumerates ports when there is something new
+/// to find.
+///
+/// Windows: WM_DEVICECHANGE arrival/removal broadcasts
+/// Android: The USB attach/detach broadcast receiver in QGCActivity
+/// Linux/macOS: A watch on /dev, which is where udev and the IOKit serial driver create and remove the tty nodes
+///
+/// Notifications come in bursts as a device enumerates, so they are collapsed into a single portsChanged once things
+/// settle. If the platform mechanism can't be set up isActive returns false and the caller should keep polling.
+class SerialPortWatcher : public QObject
+#if defined(Q_OS_WIN)
+    , public QAbstractNativeEventFilter
+#endif
+{
+    Q_OBJECT
+
+public:
+    SerialPortWatcher(QObject* parent = nullptr);
+    ~SerialPortWatcher();
+
+    /// @return true: portsChanged will be signalled for hotplug, false: no notifications are available
+    bool isActive(void) const { return _active; }
+
+#if defined(__android__)
+    static void setNativeMethods(void);
+#endif
+
+#if defined(Q_OS_WIN)
+    // Overrides from QAbstractNativeEventFilter
+    bool nativeEventFilter(const QByteArray& eventType, void* message, long* result) override;
+#endif
+
+signals:
+    void portsChanged(void);
+
+private slots:
+    void _deviceChanged(void);
+
+private:
+    bool                    _active = false;
+    QTimer                  _settleTimer;
+#if !defined(Q_OS_WIN) && !defined(__android__) && !defined(__ios__)
+    QFileSystemWatcher      _devWatcher;
+#endif
+
+    static const int _settleMSecs = 250;
+};
@@ -78,24 +78,53 @@ void TCPLink::_writeBytes(const QByteArray data)
     _writeDebugBytes(data);
 #endif
 
-    if (_socket) {
+    if (!_socket) {
+        return;
+    }
+
+    emit bytesSent(this, data);
+
+    if (!_coalesceTimer) {
         _socket->write(data);
-        emit bytesSent(this, data);
+        return;
+    }
+
+    if (_coalesceBuffer.isEmpty()) {
+        _coalesceElapsed.start();
+    }
+    _coalesceBuffer.append(data);
+
+    // QTimer only has millisecond resolution, so the window itself is checked against the elapsed timer
+    if (_coalesceBuffer.size() >= _coalesceMaxBytes || _coalesceElapsed.nsecsElapsed() >= _tcpConfig->coalesceUSecs() * 1000LL) {
+        _flushCoalesced();
+    } else if (!_coalesceTimer->isActive()) {
+        _coalesceTimer->start();
     }
 }
 
+void TCPLink::_flushCoalesced(void)
+{
+    _coalesceTimer->stop();
+    if (_socket && !_coalesceBuffer.isEmpty()) {
+        _socket->write(_coalesceBuffer);
+    }
+    // Keeps the allocation for the next window
+    _coalesceBuffer.resize(0);
+}
+
 void TCPLink::readBytes()
 {
     if (_socket) {
         qint64 byteCount = _socket->bytesAvailable();
         if (byteCount)
         {
-            QByteArray buffer;
-            buffer.resize(byteCount);
-            _socket->read(buffer.data(), buffer.size());
-            emit bytesReceived(this, buffer);
+            // The only receiver is connected directly, so once the signal returns the buffer is no longer shared and
+            // the next read can reuse its storage
+            _readBuffer.resize(static_cast<int>(byteCount));
+            _readBuffer.resize(static_cast<int>(_socket->read(_readBuffer.data(), _readBuffer.size())));
+            emit bytesReceived(this, _readBuffer);
 #ifdef TCPLINK_READWRITE_DEBUG
-            writeDebugBytes(buffer.data(), buffer.size());
+            writeDebugBytes(_readBuffer.data(), _readBuffer.size());
 #endif
         }
     }
@@ -105,6 +134,12 @@ void TCPLink::disconnect(void)
 {
     quit();
     wait();
+    if (_coalesceTimer) {
+        // The thread has already exited, so this is the only place the timer can go away
+        delete _coalesceTimer;
+        _coalesceTimer = nullptr;
+        _coalesceBuffer.clear();
+    }
     if (_socket) {
         // This prevents stale signal from calling the link after it has been deleted
         QObject::disconnect(_socket, &QTcpSocket::readyRead, this, &TCPLink::readBytes);
@@ -161,6 +196,21 @@ bool TCPLink::_hardwareConnect()
         _socket = nullptr;
         return false;
     }
+    _socket->setSocketOption(QAbstractSocket::LowDelayOption, _tcpConfig->noDelay() ? 1 : 0);
+    if (_tcpConfig->receiveBufferSize() > 0) {
+        _socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, _tcpConfig->receiveBufferSize());
+    }
+    _readBuffer.reserve(_readBufferReserve);
+
+    if (_tcpConfig->coalesceUSecs() > 0) {
+        _coalesceTimer = new QTimer();
+        _coalesceTimer->setSingleShot(true);
+        _coalesceTimer->setTimerType(Qt::PreciseTimer);
+        _coalesceTimer->setInterval(qMax(1, (_tcpConfig->coalesceUSecs() + 999) / 1000));
+        _coalesceBuffer.reserve(_coalesceMaxBytes * 2);
+        QObject::connect(_coalesceTimer, &QTimer::timeout, this, &TCPLink::_flushCoalesced);
+    }
+
     _socketIsConnected = true;
     emit connected();
     return true;
@@ -239,6 +289,9 @@ TCPConfiguration::TCPConfiguration(TCPConfiguration* source) : LinkConfiguration
 {
     _port    = source->port();
     _address = source->address();
+    _noDelay            = source->noDelay();
+    _coalesceUSecs      = source->coalesceUSecs();
+    _receiveBufferSize  = source->receiveBufferSize();
 }
 
 void TCPConfiguration::copyFrom(LinkConfiguration *source)
@@ -248,6 +301,35 @@ void TCPConfiguration::copyFrom(LinkConfiguration *source)
     Q_ASSERT(usource != nullptr);
     _port    = usource->port();
     _address = usource->address();
+    _noDelay            = usource->noDelay();
+    _coalesceUSecs      = usource->coalesceUSecs();
+    _receiveBufferSize  = usource->receiveBufferSize();
+}
+
+void TCPConfiguration::setNoDelay(bool noDelay)
+{
+    if (noDelay != _noDelay) {
+        _noDelay = noDelay;
+        emit noDelayChanged();
+    }
+}
+
+void TCPConfiguration::setCoalesceUSecs(int coalesceUSecs)
+{
+    coalesceUSecs = qBound(0, coalesceUSecs, 100000);
+    if (coalesceUSecs != _coalesceUSecs) {
+        _coalesceUSecs = coalesceUSecs;
+        emit coalesceUSecsChanged();
+    }
+}
+
+void TCPConfiguration::setReceiveBufferSize(int receiveBufferSize)
+{
+    receiveBufferSize = qMax(0, receiveBufferSize);
+    if (receiveBufferSize != _receiveBufferSize) {
+        _receiveBufferSize = receiveBufferSize;
+        emit receiveBufferSizeChanged();
+    }
 }
 
 void TCPConfiguration::setPort(quint16 port)
@@ -275,6 +357,9 @@ void TCPConfiguration::saveSettings(QSettings& settings, const QString& root)
     settings.beginGroup(root);
     settings.setValue("port", (int)_port);
     settings.setValue("host", address().toString());
+    settings.setValue("noDelay",            _noDelay);
+    settings.setValue("coalesceUSecs",      _coalesceUSecs);
+    settings.setValue("receiveBufferSize",  _receiveBufferSize);
     settings.endGroup();
 }
 
@@ -284,5 +369,8 @@ void TCPConfiguration::loadSettings(QSettings& settings, const QString& root)
     _port = (quint16)settings.value("port", QGC_TCP_PORT).toUInt();
     QString address = settings.value("host", _address.toString()).toString();
     _address = QHostAddress(address);
+    _noDelay = settings.value("noDelay", _noDelay).toBool();
+    setCoalesceUSecs    (settings.value("coalesceUSecs",     _coalesceUSecs).toInt());
+    setReceiveBufferSize(settings.value("receiveBufferSize", _receiveBufferSize).toInt());
     settings.endGroup();
 }
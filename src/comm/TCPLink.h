@@ -13,6 +13,8 @@
 #include <QList>
 #include <QMap>
 #include <QMutex>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QHostAddress>
 #include <LinkInterface.h>
 #include "QGCConfig.h"
@@ -38,6 +40,9 @@ public:
 
     Q_PROPERTY(quint16 port READ port WRITE setPort NOTIFY portChanged)
     Q_PROPERTY(QString host READ host WRITE setHost NOTIFY hostChanged)
+    Q_PROPERTY(bool    noDelay              READ noDelay            WRITE setNoDelay            NOTIFY noDelayChanged)              ///< true: TCP_NODELAY, Nagle's algorithm is off
+    Q_PROPERTY(int     coalesceUSecs        READ coalesceUSecs      WRITE setCoalesceUSecs      NOTIFY coalesceUSecsChanged)        ///< Time outgoing data is held back to be combined into one segment, 0 for none
+    Q_PROPERTY(int     receiveBufferSize    READ receiveBufferSize  WRITE setReceiveBufferSize  NOTIFY receiveBufferSizeChanged)    ///< Socket receive buffer size in bytes, 0 for the OS default
 
     TCPConfiguration(const QString& name);
     TCPConfiguration(TCPConfiguration* source);
@@ -49,6 +54,13 @@ public:
     void                setAddress  (const QHostAddress& address);
     void                setHost     (const QString host);
 
+    bool    noDelay             (void) const { return _noDelay; }
+    int     coalesceUSecs       (void) const { return _coalesceUSecs; }
+    int     receiveBufferSize   (void) const { return _receiveBufferSize; }
+    void    setNoDelay          (bool noDelay);
+    void    setCoalesceUSecs    (int coalesceUSecs);
+    void    setReceiveBufferSize(int receiveBufferSize);
+
     //LinkConfiguration overrides
     LinkType    type                (void) override                                         { return LinkConfiguration::TypeTcp; }
     void        copyFrom            (LinkConfiguration* source) override;
@@ -60,10 +72,16 @@ public:
 signals:
     void portChanged(void);
     void hostChanged(void);
+    void noDelayChanged(void);
+    void coalesceUSecsChanged(void);
+    void receiveBufferSizeChanged(void);
 
 private:
     QHostAddress    _address;
     quint16         _port;
+    bool            _noDelay            = false;
+    int             _coalesceUSecs      = 0;
+    int             _receiveBufferSize  = 0;
 };
 
 class TCPLink : public LinkInterface
@@ -103,6 +121,7 @@ private:
     bool _connect(void) override;
 
     bool _hardwareConnect   (void);
+    void _flushCoalesced    (void);
 #ifdef TCPLINK_READWRITE_DEBUG
     void _writeDebugBytes   (const QByteArray data);
 #endif
@@ -111,6 +130,14 @@ private:
     QTcpSocket*       _socket;
     bool              _socketIsConnected;
 
+    QByteArray        _readBuffer;                  ///< Reused for every read, its capacity only ever grows
+    QByteArray        _coalesceBuffer;              ///< Outgoing data held back for the coalescing window
+    QTimer*           _coalesceTimer    = nullptr;  ///< Created on the link thread
+    QElapsedTimer     _coalesceElapsed;             ///< Started when the first byte is placed in _coalesceBuffer
+
+    static const int  _readBufferReserve    = 64 * 1024;
+    static const int  _coalesceMaxBytes     = 1400;     ///< Flush early once a typical MSS worth of data is held
+
     quint64 _bitsSentTotal;
     quint64 _bitsSentCurrent;
     quint64 _bitsSentMax;
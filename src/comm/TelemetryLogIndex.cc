@@ -0,0 +1,407 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogIndex.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <QtMath>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(TelemetryLogIndexLog, "TelemetryLogIndexLog")
+
+// Fields of a series are next to each other, this is the first field of each series followed by the end of the last one
+static const int kSeriesFirstField[TelemetryLogIndex::SeriesCount + 1] = {
+    TelemetryLogIndex::FieldLatitude,
+    TelemetryLogIndex::FieldRoll,
+    TelemetryLogIndex::FieldVoltage,
+    TelemetryLogIndex::FieldCount,
+};
+
+// Position and battery are stored in their MAVLink units, attitude is rounded to 0.1 mrad
+const double TelemetryLogIndex::_fieldScale[FieldCount] = {
+    1e7,        // FieldLatitude
+    1e7,        // FieldLongitude
+    1e3,        // FieldAltitudeAMSL
+    1e3,        // FieldRelativeAltitude
+    1e4,        // FieldRoll
+    1e4,        // FieldPitch
+    1e4,        // FieldYaw
+    1e3,        // FieldVoltage
+    1e2,        // FieldCurrent
+    1,          // FieldRemaining
+};
+
+TelemetryLogIndex::TelemetryLogIndex(void)
+{
+
+}
+
+quint64 TelemetryLogIndex::parseTimestamp(const uchar* bytes)
+{
+    quint64 timestamp = qFromBigEndian<quint64>(bytes);
+    quint64 currentTimestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+
+    // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
+    // little endian, so switch it.
+    if (timestamp > currentTimestamp) {
+        timestamp = qbswap(timestamp);
+    }
+
+    return timestamp;
+}
+
+bool TelemetryLogIndex::parseEntry(const uchar* data, qint64 size, qint64 offset, quint64& timestampUSecs, qint64& messageOffset, qint64& nextOffset, mavlink_message_t* message)
+{
+    if (offset + static_cast<qint64>(sizeof(quint64)) >= size) {
+        return false;
+    }
+
+    // The parse state is local so that parsing the log never touches the mavlink channel state of a link
+    mavlink_message_t   rxMessage;
+    mavlink_status_t    rxStatus;
+    mavlink_message_t   localMessage;
+    mavlink_status_t    status;
+
+    if (!message) {
+        message = &localMessage;
+    }
+    memset(&rxStatus, 0, sizeof(rxStatus));
+
+    timestampUSecs  = parseTimestamp(data + offset);
+    messageOffset   = -1;
+
+    for (qint64 i = offset + static_cast<qint64>(sizeof(quint64)); i < size; i++) {
+        uint8_t result = mavlink_frame_char_buffer(&rxMessage, &rxStatus, data[i], message, &status);
+
+        if (rxStatus.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
+            // This is the possible beginning of a mavlink message
+            messageOffset = i;
+        }
+        if (result == MAVLINK_FRAMING_OK && messageOffset != -1) {
+            nextOffset = i + 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TelemetryLogIndex::Series TelemetryLogIndex::fieldSeries(Field field)
+{
+    for (int series = SeriesCount - 1; series > 0; series--) {
+        if (field >= kSeriesFirstField[series]) {
+            return static_cast<Series>(series);
+        }
+    }
+    return SeriesPosition;
+}
+
+QList<uint32_t> TelemetryLogIndex::messageIds(void) const
+{
+    QList<uint32_t> msgIds = _messageOffsets.keys();
+    std::sort(msgIds.begin(), msgIds.end());
+    return msgIds;
+}
+
+double TelemetryLogIndex::value(Field field, int index) const
+{
+    qint64 raw = _values[field][index];
+    if ((field == FieldCurrent || field == FieldRemaining) && raw == -1) {
+        // SYS_STATUS uses -1 when the value is not known
+        return qQNaN();
+    }
+    return raw / _fieldScale[field];
+}
+
+int TelemetryLogIndex::sampleIndex(Series series, quint64 timeUSecs) const
+{
+    const QVector<qint64>& times = _sampleTimes[series];
+    auto iter = std::upper_bound(times.constBegin(), times.constEnd(), static_cast<qint64>(timeUSecs));
+    return static_cast<int>(iter - times.constBegin()) - 1;
+}
+
+void TelemetryLogIndex::close(void)
+{
+    _open           = false;
+    _startTimeUSecs = 0;
+    _endTimeUSecs   = 0;
+    _vehicleId      = 0;
+    _seekIndex.clear();
+    _messageOffsets.clear();
+    for (int i = 0; i < SeriesCount; i++) {
+        _sampleTimes[i].clear();
+    }
+    for (int i = 0; i < FieldCount; i++) {
+        _values[i].clear();
+    }
+}
+
+bool TelemetryLogIndex::open(const QString& logFilename, const uchar* data, qint64 size, QString& errorString)
+{
+    close();
+
+    QFileInfo   logFileInfo (logFilename);
+    QString     filename    = indexFilename(logFilename);
+    qint64      logModified = logFileInfo.lastModified().toMSecsSinceEpoch();
+
+    if (!_load(filename, size, logModified) && data) {
+        close();
+
+        QElapsedTimer buildTimer;
+        buildTimer.start();
+        _build(data, size);
+        qCDebug(TelemetryLogIndexLog) << "Indexed" << logFilename << "in" << buildTimer.elapsed() << "msecs";
+
+        if (!_seekIndex.isEmpty()) {
+            _save(filename, size, logModified);
+        }
+    }
+
+    if (_seekIndex.isEmpty()) {
+        errorString = tr("No messages found in log '%1'.").arg(logFilename);
+        close();
+        return false;
+    }
+
+    _open = true;
+    return true;
+}
+
+void TelemetryLogIndex::_addSample(Series series, quint64 timestampUSecs, std::initializer_list<qint64> values)
+{
+    _sampleTimes[series].append(static_cast<qint64>(timestampUSecs));
+    int field = kSeriesFirstField[series];
+    for (qint64 value: values) {
+        _values[field++].append(value);
+    }
+}
+
+void TelemetryLogIndex::_build(const uchar* data, qint64 size)
+{
+    mavlink_message_t   message;
+    quint64             timestampUSecs;
+    qint64              messageOffset;
+    qint64              nextOffset;
+    qint64              offset          = 0;
+    int                 messageCount    = 0;
+
+    while (parseEntry(data, size, offset, timestampUSecs, messageOffset, nextOffset, &message)) {
+        if (messageCount++ % seekStride == 0) {
+            _seekIndex.append({ timestampUSecs, offset });
+        }
+        _endTimeUSecs = timestampUSecs;
+        _messageOffsets[message.msgid].append(offset);
+
+        // The series follow the first vehicle in the log, so they don't mix when more than one was connected
+        if (_vehicleId == 0 && message.msgid == MAVLINK_MSG_ID_HEARTBEAT && mavlink_msg_heartbeat_get_autopilot(&message) != MAV_AUTOPILOT_INVALID) {
+            _vehicleId = message.sysid;
+        }
+        if (_vehicleId != 0 && message.sysid == _vehicleId) {
+            switch (message.msgid) {
+            case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+            {
+                mavlink_global_position_int_t position;
+                mavlink_msg_global_position_int_decode(&message, &position);
+                _addSample(SeriesPosition, timestampUSecs, { position.lat, position.lon, position.alt, position.relative_alt });
+                break;
+            }
+            case MAVLINK_MSG_ID_ATTITUDE:
+            {
+                mavlink_attitude_t attitude;
+                mavlink_msg_attitude_decode(&message, &attitude);
+                _addSample(SeriesAttitude, timestampUSecs, {
+                               qRound64(attitude.roll * _fieldScale[FieldRoll]),
+                               qRound64(attitude.pitch * _fieldScale[FieldPitch]),
+                               qRound64(attitude.yaw * _fieldScale[FieldYaw]) });
+                break;
+            }
+            case MAVLINK_MSG_ID_SYS_STATUS:
+            {
+                mavlink_sys_status_t sysStatus;
+                mavlink_msg_sys_status_decode(&message, &sysStatus);
+                _addSample(SeriesBattery, timestampUSecs, { sysStatus.voltage_battery, sysStatus.current_battery, sysStatus.battery_remaining });
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        offset = nextOffset;
+    }
+
+    if (!_seekIndex.isEmpty()) {
+        _startTimeUSecs = _seekIndex.first().timestampUSecs;
+    }
+}
+
+/// Each value is stored as the zigzag varint of its difference to the previous one. Offsets, timestamps and
+/// telemetry all change slowly from one entry to the next, so most values take one or two bytes before compression.
+QByteArray TelemetryLogIndex::_encodeColumn(const QVector<qint64>& column)
+{
+    QByteArray  bytes;
+    qint64      previous = 0;
+
+    bytes.reserve(column.count() * 2);
+    for (qint64 value: column) {
+        quint64 delta   = static_cast<quint64>(value - previous);
+        quint64 zigzag  = (delta << 1) ^ static_cast<quint64>(static_cast<qint64>(delta) >> 63);
+        previous = value;
+        while (zigzag >= 0x80) {
+            bytes.append(static_cast<char>((zigzag & 0x7F) | 0x80));
+            zigzag >>= 7;
+        }
+        bytes.append(static_cast<char>(zigzag));
+    }
+    return bytes;
+}
+
+bool TelemetryLogIndex::_decodeColumn(const QByteArray& bytes, QVector<qint64>& column)
+{
+    const uchar*    pos         = reinterpret_cast<const uchar*>(bytes.constData());
+    const uchar*    end         = pos + bytes.size();
+    qint64          previous    = 0;
+
+    column.clear();
+    while (pos < end) {
+        quint64 zigzag  = 0;
+        int     shift   = 0;
+        do {
+            if (pos == end || shift > 63) {
+                return false;
+            }
+            zigzag |= static_cast<quint64>(*pos & 0x7F) << shift;
+            shift += 7;
+        } while (*pos++ & 0x80);
+        previous += static_cast<qint64>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+        column.append(previous);
+    }
+    return true;
+}
+
+void TelemetryLogIndex::_save(const QString& indexFilename, qint64 logSize, qint64 logModified) const
+{
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+
+        QVector<qint64> seekTimes;
+        QVector<qint64> seekOffsets;
+        for (const SeekEntry_t& entry: _seekIndex) {
+            seekTimes.append(static_cast<qint64>(entry.timestampUSecs));
+            seekOffsets.append(entry.offset);
+        }
+        stream << _startTimeUSecs << _endTimeUSecs << static_cast<qint32>(_vehicleId);
+        stream << _encodeColumn(seekTimes) << _encodeColumn(seekOffsets);
+
+        const QList<uint32_t> msgIds = messageIds();
+        stream << static_cast<quint32>(msgIds.count());
+        for (uint32_t msgId: msgIds) {
+            stream << static_cast<quint32>(msgId) << _encodeColumn(_messageOffsets[msgId]);
+        }
+        for (int i = 0; i < SeriesCount; i++) {
+            stream << _encodeColumn(_sampleTimes[i]);
+        }
+        for (int i = 0; i < FieldCount; i++) {
+            stream << _encodeColumn(_values[i]);
+        }
+    }
+
+    // The log may be in a read only location, in which case the index is just built again next time
+    QSaveFile indexFile(indexFilename);
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        qCDebug(TelemetryLogIndexLog) << "Unable to save index" << indexFilename << indexFile.errorString();
+        return;
+    }
+    QDataStream stream(&indexFile);
+    stream << _magic << _version << logSize << logModified << qCompress(payload);
+    if (stream.status() != QDataStream::Ok || !indexFile.commit()) {
+        qCWarning(TelemetryLogIndexLog) << "Unable to save index" << indexFilename << indexFile.errorString();
+    }
+}
+
+bool TelemetryLogIndex::_load(const QString& indexFilename, qint64 logSize, qint64 logModified)
+{
+    QFile indexFile(indexFilename);
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&indexFile);
+    quint32     magic;
+    quint32     version;
+    qint64      indexLogSize;
+    qint64      indexLogModified;
+    QByteArray  compressed;
+
+    stream >> magic >> version >> indexLogSize >> indexLogModified;
+    if (stream.status() != QDataStream::Ok || magic != _magic || version != _version) {
+        qCDebug(TelemetryLogIndexLog) << "Ignoring index with unknown format" << indexFilename;
+        return false;
+    }
+    if (indexLogSize != logSize || indexLogModified != logModified) {
+        qCDebug(TelemetryLogIndexLog) << "Ignoring out of date index" << indexFilename;
+        return false;
+    }
+    stream >> compressed;
+    QByteArray payload = qUncompress(compressed);
+    compressed.clear();
+    if (stream.status() != QDataStream::Ok || payload.isEmpty()) {
+        qCWarning(TelemetryLogIndexLog) << "Corrupt index" << indexFilename;
+        return false;
+    }
+
+    QDataStream     payloadStream(payload);
+    qint32          vehicleId;
+    quint32         cMessageIds;
+    QByteArray      bytes;
+    QVector<qint64> seekTimes;
+    QVector<qint64> seekOffsets;
+    bool            ok = true;
+
+    payloadStream >> _startTimeUSecs >> _endTimeUSecs >> vehicleId;
+    _vehicleId = vehicleId;
+    payloadStream >> bytes;
+    ok &= _decodeColumn(bytes, seekTimes);
+    payloadStream >> bytes;
+    ok &= _decodeColumn(bytes, seekOffsets) && seekTimes.count() == seekOffsets.count();
+    for (int i = 0; ok && i < seekTimes.count(); i++) {
+        _seekIndex.append({ static_cast<quint64>(seekTimes[i]), seekOffsets[i] });
+    }
+
+    payloadStream >> cMessageIds;
+    for (quint32 i = 0; ok && i < cMessageIds && payloadStream.status() == QDataStream::Ok; i++) {
+        quint32 msgId;
+        payloadStream >> msgId >> bytes;
+        ok &= _decodeColumn(bytes, _messageOffsets[msgId]);
+    }
+    for (int i = 0; ok && i < SeriesCount; i++) {
+        payloadStream >> bytes;
+        ok &= _decodeColumn(bytes, _sampleTimes[i]);
+    }
+    for (int i = 0; ok && i < FieldCount; i++) {
+        payloadStream >> bytes;
+        ok &= _decodeColumn(bytes, _values[i]) && _values[i].count() == _sampleTimes[fieldSeries(static_cast<Field>(i))].count();
+    }
+
+    if (!ok || payloadStream.status() != QDataStream::Ok || _seekIndex.isEmpty()) {
+        qCWarning(TelemetryLogIndexLog) << "Corrupt index" << indexFilename;
+        return false;
+    }
+
+    qCDebug(TelemetryLogIndexLog) << "Loaded index" << indexFilename;
+    return true;
+}
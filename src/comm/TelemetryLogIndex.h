@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <initializer_list>
+
+#include "QGCLoggingCategory.h"
+#include "QGCMAVLink.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryLogIndexLog)
+
+/// Side index of a telemetry log, which is a stream of big endian uint64 timestamps each followed by a MAVLink frame.
+///
+/// The index is built with a single pass over the log the first time it is opened and saved next to it, so opening
+/// the log again does not have to parse it. It holds the file offsets of the log entries by message id, a time index
+/// for seeking, and the high rate position, attitude and battery values of the vehicle as columns. The columns are
+/// stored delta encoded and compressed.
+class TelemetryLogIndex
+{
+    Q_DECLARE_TR_FUNCTIONS(TelemetryLogIndex)
+
+public:
+    TelemetryLogIndex(void);
+
+    enum Series {
+        SeriesPosition,         ///< GLOBAL_POSITION_INT
+        SeriesAttitude,         ///< ATTITUDE
+        SeriesBattery,          ///< SYS_STATUS
+        SeriesCount
+    };
+
+    enum Field {
+        FieldLatitude,          ///< Degrees
+        FieldLongitude,         ///< Degrees
+        FieldAltitudeAMSL,      ///< Meters
+        FieldRelativeAltitude,  ///< Meters
+        FieldRoll,              ///< Radians
+        FieldPitch,             ///< Radians
+        FieldYaw,               ///< Radians
+        FieldVoltage,           ///< Volts
+        FieldCurrent,           ///< Amps, NaN if not known
+        FieldRemaining,         ///< Percent, NaN if not known
+        FieldCount
+    };
+
+    /// Every seekStride'th log entry
+    typedef struct {
+        quint64 timestampUSecs;
+        qint64  offset;             ///< File offset of the timestamp which precedes the message
+    } SeekEntry_t;
+
+    /// Loads the index of the log, building it if the saved index is missing or does not match the log
+    ///     @param logFilename Log file, the index is saved as indexFilename(logFilename)
+    ///     @param data Log contents, only needed if the index has to be built
+    /// @return false: No messages were found in the log, errorString set
+    bool open(const QString& logFilename, const uchar* data, qint64 size, QString& errorString);
+    void close(void);
+
+    bool    isOpen          (void) const { return _open; }
+    quint64 startTimeUSecs  (void) const { return _startTimeUSecs; }
+    quint64 endTimeUSecs    (void) const { return _endTimeUSecs; }
+    int     vehicleId       (void) const { return _vehicleId; }     ///< System id the series are taken from, 0 if none
+
+    const QVector<SeekEntry_t>& seekIndex(void) const { return _seekIndex; }
+
+    /// @return Ids of all the messages in the log, sorted
+    QList<uint32_t>         messageIds      (void) const;
+    /// @return File offsets of the log entries for the message id in log order
+    QVector<qint64>         messageOffsets  (uint32_t msgId) const { return _messageOffsets.value(msgId); }
+
+    int     sampleCount     (Series series) const { return _sampleTimes[series].count(); }
+    quint64 sampleTimeUSecs (Series series, int index) const { return static_cast<quint64>(_sampleTimes[series][index]); }
+    double  value           (Field field, int index) const;
+
+    /// @return Index of the last sample at or before timeUSecs, -1 if there is none
+    int     sampleIndex     (Series series, quint64 timeUSecs) const;
+
+    static Series   fieldSeries     (Field field);
+    static QString  indexFilename   (const QString& logFilename) { return logFilename + QStringLiteral(".qgcindex"); }
+
+    /// Parses a timestamp, switching the byte order of the ones old versions wrote as little endian
+    /// @return Unix timestamp in microseconds UTC
+    static quint64 parseTimestamp(const uchar* bytes);
+
+    /// Parses the log entry at the offset. Any garbage between the timestamp and the start of the message is skipped.
+    ///     @param[out] timestampUSecs Timestamp for the entry
+    ///     @param[out] messageOffset Offset of the first byte of the message
+    ///     @param[out] nextOffset Offset of the next log entry
+    ///     @param[out] message Decoded message, may be nullptr
+    /// @return false: No complete message was found before the end of the log
+    static bool parseEntry(const uchar* data, qint64 size, qint64 offset, quint64& timestampUSecs, qint64& messageOffset, qint64& nextOffset, mavlink_message_t* message = nullptr);
+
+    static const int seekStride = 64;
+
+private:
+    void _build         (const uchar* data, qint64 size);
+    void _addSample     (Series series, quint64 timestampUSecs, std::initializer_list<qint64> values);
+    bool _load          (const QString& indexFilename, qint64 logSize, qint64 logModified);
+    void _save          (const QString& indexFilename, qint64 logSize, qint64 logModified) const;
+
+    static QByteArray   _encodeColumn   (const QVector<qint64>& column);
+    static bool         _decodeColumn   (const QByteArray& bytes, QVector<qint64>& column);
+
+    bool                                _open           = false;
+    quint64                             _startTimeUSecs = 0;
+    quint64                             _endTimeUSecs   = 0;
+    int                                 _vehicleId      = 0;
+    QVector<SeekEntry_t>                _seekIndex;
+    QHash<uint32_t, QVector<qint64>>    _messageOffsets;
+    QVector<qint64>                     _sampleTimes[SeriesCount];
+    QVector<qint64>                     _values[FieldCount];        ///< Scaled to integers, see _fieldScale
+
+    static const double     _fieldScale[FieldCount];    ///< Stored value is the field value times this
+    static const quint32    _magic      = 0x51474c49;   ///< QGLI
+    static const quint32    _version    = 1;
+};
@@ -173,44 +173,64 @@ void UDPLink::readBytes()
     if (!_socket) {
         return;
     }
-    QByteArray databuffer;
+
+    // Datagrams are read straight into the preallocated receive buffer. Since MAVLinkProtocol parses
+    // bytesReceived synchronously on this thread the buffer can be reused for the next batch without
+    // reallocating.
+    if (_receiveBuffer.capacity() < _receiveBufferSize) {
+        _receiveBuffer.reserve(_receiveBufferSize);
+    }
+    _receiveBuffer.resize(0);
+
     while (_socket->hasPendingDatagrams())
     {
-        QByteArray datagram;
-        datagram.resize(_socket->pendingDatagramSize());
+        int pendingSize = static_cast<int>(_socket->pendingDatagramSize());
+        if (pendingSize < 0) {
+            break;
+        }
+        //-- Wait a bit before sending it over, unless the next datagram no longer fits
+        if (_receiveBuffer.size() && _receiveBuffer.size() + pendingSize > _receiveBufferSize) {
+            emit bytesReceived(this, _receiveBuffer);
+            _receiveBuffer.resize(0);
+        }
+
+        int         offset = _receiveBuffer.size();
         QHostAddress sender;
-        quint16 senderPort;
+        quint16     senderPort;
+        _receiveBuffer.resize(offset + pendingSize);
         // If the other end is reset then it will still report data available,
         // but will fail on the readDatagram call
-        qint64 slen = _socket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+        qint64 slen = _socket->readDatagram(_receiveBuffer.data() + offset, pendingSize, &sender, &senderPort);
         if (slen == -1) {
+            _receiveBuffer.resize(offset);
             break;
         }
-        databuffer.append(datagram);
-        //-- Wait a bit before sending it over
-        if (databuffer.size() > 10 * 1024) {
-            emit bytesReceived(this, databuffer);
-            databuffer.clear();
-        }
+        _receiveBuffer.resize(offset + static_cast<int>(slen));
+
         // TODO: This doesn't validade the sender. Anything sending UDP packets to this port gets
         // added to the list and will start receiving datagrams from here. Even a port scanner
         // would trigger this.
-        // Add host to broadcast list if not yet present, or update its port
-        QHostAddress asender = sender;
-        if(_isIpLocal(sender)) {
-            asender = QHostAddress(QString("127.0.0.1"));
-        }
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!contains_target(_sessionTargets, asender, senderPort)) {
-            qDebug() << "Adding target" << asender << senderPort;
-            UDPCLient* target = new UDPCLient(asender, senderPort);
-            _sessionTargets.append(target);
+        // Add host to broadcast list if not yet present. The known sender set is only used from this
+        // thread so the session target lock is only needed when a new sender shows up.
+        UDPSenderKey_t senderKey(sender, senderPort);
+        if (!_knownSenders.contains(senderKey)) {
+            _knownSenders.insert(senderKey);
+            QHostAddress asender = sender;
+            if(_isIpLocal(sender)) {
+                asender = QHostAddress(QString("127.0.0.1"));
+            }
+            QMutexLocker locker(&_sessionTargetsMutex);
+            if (!contains_target(_sessionTargets, asender, senderPort)) {
+                qDebug() << "Adding target" << asender << senderPort;
+                UDPCLient* target = new UDPCLient(asender, senderPort);
+                _sessionTargets.append(target);
+            }
         }
-        locker.unlock();
     }
     //-- Send whatever is left
-    if (databuffer.size()) {
-        emit bytesReceived(this, databuffer);
+    if (_receiveBuffer.size()) {
+        emit bytesReceived(this, _receiveBuffer);
+        _receiveBuffer.resize(0);
     }
 }
 
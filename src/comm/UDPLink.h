@@ -17,6 +17,8 @@
 #include <QMutex>
 #include <QQueue>
 #include <QByteArray>
+#include <QSet>
+#include <QPair>
 
 #if defined(QGC_ZEROCONF_ENABLED)
 #include <dns_sd.h>
@@ -125,6 +127,8 @@ private:
     void _deregisterZeroconf(void);
     void _writeDataGram     (const QByteArray data, const UDPCLient* target);
 
+    typedef QPair<QHostAddress, quint16> UDPSenderKey_t;
+
     bool                _running;
     QUdpSocket*         _socket;
     UDPConfiguration*   _udpConfig;
@@ -132,7 +136,11 @@ private:
     QList<UDPCLient*>   _sessionTargets;
     QMutex              _sessionTargetsMutex;
     QList<QHostAddress> _localAddresses;
+    QByteArray          _receiveBuffer;     ///< Reused for every batch of datagrams, only accessed from the link thread
+    QSet<UDPSenderKey_t> _knownSenders;     ///< Senders already added to _sessionTargets, only accessed from the link thread
 #if defined(QGC_ZEROCONF_ENABLED)
     DNSServiceRef       _dnssServiceRef;
 #endif
+
+    static const int    _receiveBufferSize = 16 * 1024;
 };
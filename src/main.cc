@@ -85,6 +85,7 @@ int WindowsCrtReportHook(int reportType, char* message, int* returnValue)
 #endif
 #if !defined(NO_SERIAL_LINK)
 #include "qserialport.h"
+#include "SerialPortWatcher.h"
 #endif
 
 static jobject _class_loader = nullptr;
@@ -183,6 +184,7 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved)
 
  #if !defined(NO_SERIAL_LINK)
     QSerialPort::setNativeMethods();
+    SerialPortWatcher::setNativeMethods();
  #endif
 
     JoystickAndroid::setNativeMethods();
@@ -307,18 +309,24 @@ int main(int argc, char *argv[])
     // which need to be handled before a QApplication object is started.
 
     bool stressUnitTests = false;       // Stress test unit tests
+    bool runBenchmarks = false;         // Run benchmarks
+    bool benchmarkOutput = false;       // Write benchmark results to files
     bool quietWindowsAsserts = false;   // Don't let asserts pop dialog boxes
 
     QString unitTestOptions;
+    QString benchmarkOptions;
+    QString benchmarkOutputDir;
     CmdLineOpt_t rgCmdLineOptions[] = {
         { "--unittest",             &runUnitTests,          &unitTestOptions },
         { "--unittest-stress",      &stressUnitTests,       &unitTestOptions },
+        { "--benchmark",            &runBenchmarks,         &benchmarkOptions },
+        { "--benchmark-output",     &benchmarkOutput,       &benchmarkOutputDir },
         { "--no-windows-assert-ui", &quietWindowsAsserts,   nullptr },
         // Add additional command line option flags here
     };
 
     ParseCmdLineOptions(argc, argv, rgCmdLineOptions, sizeof(rgCmdLineOptions)/sizeof(rgCmdLineOptions[0]), false);
-    if (stressUnitTests) {
+    if (stressUnitTests || runBenchmarks) {
         runUnitTests = true;
     }
 
@@ -364,7 +372,14 @@ int main(int argc, char *argv[])
     int exitCode = 0;
 
 #ifdef UNITTEST_BUILD
-    if (runUnitTests) {
+    if (runBenchmarks) {
+        if (!app->_initForUnitTests()) {
+            return -1;
+        }
+        int failures = UnitTest::runBenchmarks(benchmarkOptions, benchmarkOutputDir);
+        qDebug() << (failures == 0 ? "ALL BENCHMARKS RAN" : "BENCHMARKS FAILED");
+        exitCode = -failures;
+    } else if (runUnitTests) {
         for (int i=0; i < (stressUnitTests ? 20 : 1); i++) {
             if (!app->_initForUnitTests()) {
                 return -1;
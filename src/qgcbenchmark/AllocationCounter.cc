@@ -0,0 +1,95 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "AllocationCounter.h"
+
+#include <cstddef>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define QGC_ALLOCATION_COUNTER_DISABLED
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define QGC_ALLOCATION_COUNTER_DISABLED
+#endif
+
+#if defined(__GLIBC__) && !defined(QGC_ALLOCATION_COUNTER_DISABLED)
+
+// Only touched by the owning thread, so the allocator hooks below never need to synchronize
+static thread_local bool        _counting       = false;
+static thread_local uint64_t    _allocations    = 0;
+
+extern "C" {
+
+void* __libc_malloc     (size_t size);
+void* __libc_calloc     (size_t count, size_t size);
+void* __libc_realloc    (void* ptr, size_t size);
+
+void* malloc(size_t size)
+{
+    if (_counting) {
+        _allocations++;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    if (_counting) {
+        _allocations++;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    if (_counting) {
+        _allocations++;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+}
+
+bool AllocationCounter::available(void)
+{
+    return true;
+}
+
+void AllocationCounter::start(void)
+{
+    _allocations    = 0;
+    _counting       = true;
+}
+
+uint64_t AllocationCounter::stop(void)
+{
+    _counting = false;
+    return _allocations;
+}
+
+#else
+
+bool AllocationCounter::available(void)
+{
+    return false;
+}
+
+void AllocationCounter::start(void)
+{
+
+}
+
+uint64_t AllocationCounter::stop(void)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+/// Counts heap allocations made by the calling thread between start and stop.
+///
+/// Counting is done by interposing malloc/calloc/realloc, which catches both operator new and the Qt containers
+/// which allocate through malloc directly. This is only possible with glibc, on other platforms available()
+/// returns false and the count is always 0.
+class AllocationCounter
+{
+public:
+    static bool     available   (void);
+    static void     start       (void);
+    static uint64_t stop        (void);     ///< @return Number of allocations since start
+};
@@ -0,0 +1,230 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "HotPathBenchmark.h"
+#include "ParameterManager.h"
+#include "QGCMapEngine.h"
+#include "SurveyComplexItem.h"
+#include "TerrainTile.h"
+#include "Vehicle.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <QtEndian>
+#include <QtMath>
+
+void HotPathBenchmark::cleanup(void)
+{
+    getQGCMapEngine()->clearMemoryCache();
+    UnitTest::cleanup();
+}
+
+void HotPathBenchmark::_surveyTransects_benchmark_data(void)
+{
+    QTest::addColumn<bool>("concave");
+
+    QTest::newRow("convex")     << false;
+    QTest::newRow("concave")    << true;
+}
+
+/// Builds the transects of a 1km survey, which is what runs on every edit of the survey polygon or camera settings
+void HotPathBenchmark::_surveyTransects_benchmark(void)
+{
+    QFETCH(bool, concave);
+
+    const QGeoCoordinate    center(47.633550640000003, -122.08982199);
+    const int               cVertices = 24;
+
+    SurveyComplexItem::TransectParams_t params;
+    for (int i=0; i<cVertices; i++) {
+        // A star shape when concave, every other vertex pulled in towards the center
+        double radius = (concave && (i % 2)) ? 250 : 500;
+        params.polygon.append(center.atDistanceAndAzimuth(radius, i * 360.0 / cVertices));
+    }
+    params.gridAngle                = 30;
+    params.gridSpacing              = 10;
+    params.refly90Degrees           = false;
+    params.splitConcavePolygons     = concave;
+    params.flyAlternateTransects    = false;
+    params.entryPoint               = SurveyComplexItem::EntryLocationTopLeft;
+    params.hoverAndCapture          = false;
+    params.triggerDistance          = 25;
+    params.turnaroundDistance       = 10;
+
+    int transectCount = 0;
+    QBENCHMARK {
+        transectCount = SurveyComplexItem::_buildTransects(params, nullptr /* latestRequest */, 0 /* request */).count();
+    }
+    QVERIFY(transectCount > 0);
+}
+
+/// One coordinate at a time, the way the flight path and the terrain profile sample a tile
+void HotPathBenchmark::_terrainElevation_benchmark(void)
+{
+    TerrainTile tile(_terrainTileBytes());
+    QVERIFY(tile.isValid());
+
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    _terrainSamples(latitudes, longitudes);
+
+    double total = 0;
+    QBENCHMARK {
+        total = 0;
+        for (int i=0; i<_terrainSampleCount; i++) {
+            total += tile.elevation(QGeoCoordinate(latitudes[i], longitudes[i]));
+        }
+    }
+    QVERIFY(!qIsNaN(total));
+}
+
+void HotPathBenchmark::_terrainElevations_benchmark(void)
+{
+    TerrainTile tile(_terrainTileBytes());
+    QVERIFY(tile.isValid());
+
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    QVector<double> elevations(_terrainSampleCount);
+    _terrainSamples(latitudes, longitudes);
+
+    QBENCHMARK {
+        tile.elevations(_terrainSampleCount, latitudes.constData(), longitudes.constData(), elevations.data());
+    }
+    QVERIFY(!qIsNaN(elevations.last()));
+}
+
+void HotPathBenchmark::_tileMemoryCachePut_benchmark(void)
+{
+    QGCMapEngine*   mapEngine   = getQGCMapEngine();
+    QStringList     hashes      = _tileHashes();
+    QByteArray      image(_tileBytes, 'x');
+    QString         format("png");
+
+    QBENCHMARK {
+        mapEngine->clearMemoryCache();
+        for (const QString& hash: hashes) {
+            mapEngine->memoryCacheTile(hash, image, format);
+        }
+    }
+}
+
+void HotPathBenchmark::_tileMemoryCacheGet_benchmark(void)
+{
+    QGCMapEngine*   mapEngine   = getQGCMapEngine();
+    QStringList     hashes      = _tileHashes();
+    QByteArray      image(_tileBytes, 'x');
+    QString         format("png");
+
+    for (const QString& hash: hashes) {
+        mapEngine->memoryCacheTile(hash, image, format);
+    }
+
+    int hitCount = 0;
+    QBENCHMARK {
+        hitCount = 0;
+        for (const QString& hash: hashes) {
+            QByteArray  cachedImage;
+            QString     cachedFormat;
+            hitCount += mapEngine->getMemoryCachedTile(hash, cachedImage, cachedFormat) ? 1 : 0;
+        }
+    }
+    QCOMPARE(hitCount, _tileCount);
+}
+
+/// Reads the parameter cache of a full PX4 parameter set, which is what a reconnect to a known vehicle waits on
+void HotPathBenchmark::_parameterCacheLoad_benchmark(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+    QVERIFY(_vehicle);
+
+    ParameterManager*   parameterManager    = _vehicle->parameterManager();
+    int                 componentId         = _vehicle->defaultComponentId();
+
+    parameterManager->_writeLocalParamCache(_vehicle->id(), componentId);
+    QThreadPool::globalInstance()->waitForDone();
+
+    QFile cacheFile(ParameterManager::parameterCacheFile(_vehicle->id(), componentId));
+    QVERIFY(cacheFile.open(QIODevice::ReadOnly));
+    QByteArray      bytes   = cacheFile.readAll();
+    const uchar*    data    = reinterpret_cast<const uchar*>(bytes.constData());
+    QVERIFY(bytes.size() > 12);
+    uint32_t        crc32   = qFromLittleEndian<quint32>(data + 4);
+
+    QList<QPair<QString, ParameterManager::ParamTypeVal>> params;
+    QBENCHMARK {
+        params.clear();
+        QVERIFY(parameterManager->_readLocalParamCache(data, bytes.size(), crc32, true /* checkCRC */, params));
+    }
+    QVERIFY(!params.isEmpty());
+}
+
+/// @return A serialized tile of 1 arc second terrain with hills in it
+QByteArray HotPathBenchmark::_terrainTileBytes(void)
+{
+    const double    swLat       = 47.63;
+    const double    swLon       = -122.09;
+    const int       gridSize    = qRound(TerrainTile::tileSizeDegrees / TerrainTile::tileValueSpacingDegrees) + 1;
+
+    QJsonArray carpet;
+    for (int i=0; i<gridSize; i++) {
+        QJsonArray row;
+        for (int j=0; j<gridSize; j++) {
+            row.append(qRound(100 + (50 * qSin(i / 5.0)) + (30 * qCos(j / 7.0))));
+        }
+        carpet.append(row);
+    }
+
+    double neLat = swLat + ((gridSize - 1) * TerrainTile::tileValueSpacingDegrees);
+    double neLon = swLon + ((gridSize - 1) * TerrainTile::tileValueSpacingDegrees);
+
+    QJsonObject bounds;
+    bounds["sw"] = QJsonArray({ swLat, swLon });
+    bounds["ne"] = QJsonArray({ neLat, neLon });
+
+    QJsonObject stats;
+    stats["min"] = 20;
+    stats["max"] = 180;
+    stats["avg"] = 100;
+
+    QJsonObject data;
+    data["bounds"]  = bounds;
+    data["stats"]   = stats;
+    data["carpet"]  = carpet;
+
+    QJsonObject root;
+    root["status"]  = "success";
+    root["data"]    = data;
+
+    return TerrainTile::serializeFromAirMapJson(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+/// Coordinates spread across the tile from _terrainTileBytes
+void HotPathBenchmark::_terrainSamples(QVector<double>& latitudes, QVector<double>& longitudes)
+{
+    latitudes.resize(_terrainSampleCount);
+    longitudes.resize(_terrainSampleCount);
+    for (int i=0; i<_terrainSampleCount; i++) {
+        latitudes[i]    = 47.63 + (TerrainTile::tileSizeDegrees * ((i * 37) % _terrainSampleCount) / _terrainSampleCount);
+        longitudes[i]   = -122.09 + (TerrainTile::tileSizeDegrees * i / _terrainSampleCount);
+    }
+}
+
+/// Hashes of a 16x16 block of tiles, about one screen of map
+QStringList HotPathBenchmark::_tileHashes(void)
+{
+    QStringList hashes;
+    for (int i=0; i<_tileCount; i++) {
+        hashes.append(QGCMapEngine::getTileHash(QStringLiteral("Bing Road"), 2600 + (i % 16), 5700 + (i / 16), 14));
+    }
+    return hashes;
+}
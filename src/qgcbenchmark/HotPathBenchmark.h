@@ -0,0 +1,43 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QVector>
+
+/// QBENCHMARK cases for the code paths which run once per vehicle message, map tile or plan edit and so show up first
+/// when the app gets slow. The MAVLink receive path is covered by MAVLinkIngestBenchmark.
+///
+/// Run with: QGroundControl --benchmark:HotPathBenchmark [--benchmark-output:<dir>]
+class HotPathBenchmark : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup(void) override;
+
+    void _surveyTransects_benchmark_data(void);
+    void _surveyTransects_benchmark     (void);
+    void _terrainElevation_benchmark    (void);
+    void _terrainElevations_benchmark   (void);
+    void _tileMemoryCachePut_benchmark  (void);
+    void _tileMemoryCacheGet_benchmark  (void);
+    void _parameterCacheLoad_benchmark  (void);
+
+private:
+    QByteArray  _terrainTileBytes   (void);
+    void        _terrainSamples     (QVector<double>& latitudes, QVector<double>& longitudes);
+    QStringList _tileHashes         (void);
+
+    static const int _terrainSampleCount    = 1000;
+    static const int _tileCount             = 256;
+    static const int _tileBytes             = 16 * 1024;    ///< Typical size of a compressed 256x256 map tile
+};
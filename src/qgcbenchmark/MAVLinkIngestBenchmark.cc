@@ -0,0 +1,406 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkIngestBenchmark.h"
+#include "AllocationCounter.h"
+#include "LinkManager.h"
+#include "MAVLinkProtocol.h"
+#include "MockLink.h"
+#include "QGCApplication.h"
+#include "Vehicle.h"
+
+#include <QtMath>
+
+#include <atomic>
+#include <thread>
+
+const char* MAVLinkIngestBenchmark::_logEnvironmentVariable = "QGC_BENCHMARK_MAVLINK_LOG";
+
+void MAVLinkIngestBenchmark::init(void)
+{
+    UnitTest::init();
+
+    _mavlinkProtocol        = qgcApp()->toolbox()->mavlinkProtocol();
+    _logAutopilot           = MAV_AUTOPILOT_PX4;
+    _chunkMessageCount      = 0;
+    _skippedMessageCount    = 0;
+    _deliveredMessageCount  = 0;
+    _lastMessageNSecs       = 0;
+    _vehicleNSecs           = 0;
+    _logMessages.clear();
+    _chunks.clear();
+
+    QString logFilename = qEnvironmentVariable(_logEnvironmentVariable);
+    if (!logFilename.isEmpty()) {
+        QVERIFY2(_loadLog(logFilename), qPrintable(QStringLiteral("Unable to load %1").arg(logFilename)));
+    }
+
+    _connectBenchmarkLink();
+    QVERIFY(_vehicle);
+
+    if (_logMessages.isEmpty()) {
+        _generateLog(static_cast<uint8_t>(_vehicle->id()), _syntheticLogSeconds);
+    }
+    _buildChunks(static_cast<uint8_t>(_vehicle->id()));
+    QVERIFY(_chunkMessageCount > 0);
+
+    qInfo() << "MAVLinkIngestBenchmark:" << (logFilename.isEmpty() ? QStringLiteral("synthetic telemetry") : logFilename)
+            << "messages" << _chunkMessageCount << "skipped" << _skippedMessageCount << "chunks" << _chunks.count();
+}
+
+void MAVLinkIngestBenchmark::cleanup(void)
+{
+    if (_mavlinkProtocol) {
+        disconnect(_mavlinkProtocol, nullptr, this, nullptr);
+    }
+    if (_mockLink) {
+        _mockLink->setCommLost(false);
+    }
+    _chunks.clear();
+    _logMessages.clear();
+
+    UnitTest::cleanup();
+}
+
+/// Parses all messages out of a .mavlink telemetry log. Only the messages from the first system which sends a
+/// heartbeat are kept.
+bool MAVLinkIngestBenchmark::_loadLog(const QString& logFilename)
+{
+    QFile logFile(logFilename);
+    if (!logFile.open(QFile::ReadOnly)) {
+        return false;
+    }
+    QByteArray bytes = logFile.readAll();
+
+    // The 8 byte timestamps in between the messages are simply skipped over as garbage by the parser
+    mavlink_message_t   message;
+    mavlink_status_t    status;
+    mavlink_message_t   rxMessage;
+    mavlink_status_t    rxStatus;
+    int                 systemId = -1;
+
+    memset(&status,     0, sizeof(status));
+    memset(&rxMessage,  0, sizeof(rxMessage));
+    memset(&rxStatus,   0, sizeof(rxStatus));
+
+    for (int i=0; i<bytes.size(); i++) {
+        if (mavlink_frame_char_buffer(&rxMessage, &rxStatus, static_cast<uint8_t>(bytes[i]), &message, &status) != MAVLINK_FRAMING_OK) {
+            continue;
+        }
+        if (systemId == -1 && message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            mavlink_heartbeat_t heartbeat;
+            mavlink_msg_heartbeat_decode(&message, &heartbeat);
+            if (heartbeat.type != MAV_TYPE_GCS && heartbeat.autopilot != MAV_AUTOPILOT_INVALID) {
+                systemId        = message.sysid;
+                _logAutopilot   = static_cast<MAV_AUTOPILOT>(heartbeat.autopilot);
+            }
+        }
+        if (systemId != -1 && message.sysid == systemId) {
+            _logMessages.append(message);
+        } else {
+            _skippedMessageCount++;
+        }
+    }
+
+    return !_logMessages.isEmpty();
+}
+
+/// Generates a typical telemetry stream for the specified number of seconds
+void MAVLinkIngestBenchmark::_generateLog(uint8_t systemId, int seconds)
+{
+    uint8_t channel = _linkManager->reservedMavlinkChannel();
+    uint8_t compId  = MAV_COMP_ID_AUTOPILOT1;
+
+    // Ticks are 10ms, so each message is sent every 'ticks' ticks
+    const int ticksPerSecond = 100;
+
+    for (int tick=0; tick<seconds * ticksPerSecond; tick++) {
+        mavlink_message_t   message;
+        uint32_t            timeBootMSecs = static_cast<uint32_t>(tick * (1000 / ticksPerSecond));
+        float               phase = tick / static_cast<float>(ticksPerSecond);
+
+        if (tick % 100 == 0) {
+            mavlink_heartbeat_t heartbeat;
+            memset(&heartbeat, 0, sizeof(heartbeat));
+            heartbeat.type          = MAV_TYPE_QUADROTOR;
+            heartbeat.autopilot     = _logAutopilot;
+            heartbeat.base_mode     = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED;
+            heartbeat.system_status = MAV_STATE_STANDBY;
+            mavlink_msg_heartbeat_encode_chan(systemId, compId, channel, &message, &heartbeat);
+            _logMessages.append(message);
+
+            mavlink_battery_status_t batteryStatus;
+            memset(&batteryStatus, 0, sizeof(batteryStatus));
+            batteryStatus.battery_remaining = 80;
+            batteryStatus.current_battery   = 1000;
+            for (uint16_t& voltage: batteryStatus.voltages) {
+                voltage = UINT16_MAX;
+            }
+            batteryStatus.voltages[0] = 12600;
+            mavlink_msg_battery_status_encode_chan(systemId, compId, channel, &message, &batteryStatus);
+            _logMessages.append(message);
+        }
+        if (tick % 50 == 0) {
+            mavlink_sys_status_t sysStatus;
+            memset(&sysStatus, 0, sizeof(sysStatus));
+            sysStatus.voltage_battery   = 12600;
+            sysStatus.battery_remaining = 80;
+            sysStatus.load              = 300;
+            mavlink_msg_sys_status_encode_chan(systemId, compId, channel, &message, &sysStatus);
+            _logMessages.append(message);
+        }
+        if (tick % 20 == 0) {
+            mavlink_gps_raw_int_t gpsRawInt;
+            memset(&gpsRawInt, 0, sizeof(gpsRawInt));
+            gpsRawInt.time_usec             = static_cast<uint64_t>(timeBootMSecs) * 1000;
+            gpsRawInt.fix_type              = GPS_FIX_TYPE_3D_FIX;
+            gpsRawInt.lat                   = 473977420 + tick;
+            gpsRawInt.lon                   = 85455940 + tick;
+            gpsRawInt.eph                   = 100;
+            gpsRawInt.epv                   = 150;
+            gpsRawInt.satellites_visible    = 12;
+            mavlink_msg_gps_raw_int_encode_chan(systemId, compId, channel, &message, &gpsRawInt);
+            _logMessages.append(message);
+        }
+        if (tick % 10 == 0) {
+            mavlink_global_position_int_t globalPositionInt;
+            memset(&globalPositionInt, 0, sizeof(globalPositionInt));
+            globalPositionInt.time_boot_ms  = timeBootMSecs;
+            globalPositionInt.lat           = 473977420 + tick;
+            globalPositionInt.lon           = 85455940 + tick;
+            globalPositionInt.alt           = 488000;
+            globalPositionInt.relative_alt  = 10000;
+            globalPositionInt.hdg           = static_cast<uint16_t>((tick * 10) % 36000);
+            mavlink_msg_global_position_int_encode_chan(systemId, compId, channel, &message, &globalPositionInt);
+            _logMessages.append(message);
+
+            mavlink_vfr_hud_t vfrHud;
+            memset(&vfrHud, 0, sizeof(vfrHud));
+            vfrHud.groundspeed  = 5.0f;
+            vfrHud.airspeed     = 5.0f;
+            vfrHud.alt          = 488.0f;
+            vfrHud.heading      = static_cast<int16_t>((tick / 10) % 360);
+            vfrHud.throttle     = 50;
+            mavlink_msg_vfr_hud_encode_chan(systemId, compId, channel, &message, &vfrHud);
+            _logMessages.append(message);
+
+            mavlink_altitude_t altitude;
+            memset(&altitude, 0, sizeof(altitude));
+            altitude.time_usec          = static_cast<uint64_t>(timeBootMSecs) * 1000;
+            altitude.altitude_amsl      = 488.0f;
+            altitude.altitude_relative  = 10.0f;
+            mavlink_msg_altitude_encode_chan(systemId, compId, channel, &message, &altitude);
+            _logMessages.append(message);
+        }
+        if (tick % 2 == 0) {
+            mavlink_attitude_t attitude;
+            memset(&attitude, 0, sizeof(attitude));
+            attitude.time_boot_ms   = timeBootMSecs;
+            attitude.roll           = 0.1f * qSin(phase);
+            attitude.pitch          = 0.1f * qCos(phase);
+            attitude.yaw            = phase;
+            mavlink_msg_attitude_encode_chan(systemId, compId, channel, &message, &attitude);
+            _logMessages.append(message);
+        }
+    }
+}
+
+/// Splits the log messages into datagram sized chunks, re-addressing them to the specified system
+void MAVLinkIngestBenchmark::_buildChunks(uint8_t systemId)
+{
+    for (const mavlink_message_t& message: _logMessages) {
+        _appendMessage(message, systemId);
+    }
+}
+
+void MAVLinkIngestBenchmark::_appendMessage(mavlink_message_t message, uint8_t systemId)
+{
+    if (message.sysid != systemId) {
+        const mavlink_msg_entry_t* msgEntry = mavlink_get_msg_entry(message.msgid);
+        if (!msgEntry) {
+            _skippedMessageCount++;
+            return;
+        }
+
+        // Keep the original sequence number and protocol version so loss tracking sees the log as it was
+        mavlink_status_t status;
+        memset(&status, 0, sizeof(status));
+        status.current_tx_seq = message.seq;
+        if (message.magic == MAVLINK_STX_MAVLINK1) {
+            status.flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        }
+        mavlink_finalize_message_buffer(&message, systemId, message.compid, &status, msgEntry->min_msg_len, message.len, msgEntry->crc_extra);
+    }
+
+    uint8_t     buffer[MAVLINK_MAX_PACKET_LEN];
+    int         cBuffer = mavlink_msg_to_send_buffer(buffer, &message);
+
+    if (_chunks.isEmpty() || _chunks.last().bytes.size() + cBuffer > _chunkBytes) {
+        Chunk_t chunk;
+        chunk.messageCount = 0;
+        chunk.bytes.reserve(_chunkBytes);
+        _chunks.append(chunk);
+    }
+
+    Chunk_t& chunk = _chunks.last();
+    chunk.bytes.append(reinterpret_cast<const char*>(buffer), cBuffer);
+    chunk.messageCount++;
+    _chunkMessageCount++;
+}
+
+/// Connects a MockLink vehicle which matches the log autopilot, and then silences the MockLink so the benchmark is
+/// the only thing feeding the link's channel.
+void MAVLinkIngestBenchmark::_connectBenchmarkLink(void)
+{
+    switch (_logAutopilot) {
+    case MAV_AUTOPILOT_ARDUPILOTMEGA:
+        _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+        break;
+    case MAV_AUTOPILOT_PX4:
+        _connectMockLink(MAV_AUTOPILOT_PX4);
+        break;
+    default:
+        _connectMockLink(MAV_AUTOPILOT_GENERIC);
+        break;
+    }
+    QVERIFY(_mockLink);
+    QVERIFY(_vehicle);
+
+    _mockLink->setCommLost(true);
+
+    // Let anything the MockLink already sent drain out before measuring
+    QTest::qWait(500);
+
+    // Connected after the Vehicle so these run after the Vehicle has handled each batch
+    connect(_mavlinkProtocol, &MAVLinkProtocol::messageReceived,    this, &MAVLinkIngestBenchmark::_messageReceived);
+    connect(_mavlinkProtocol, &MAVLinkProtocol::messagesReceived,   this, &MAVLinkIngestBenchmark::_messagesReceived);
+}
+
+void MAVLinkIngestBenchmark::_messageReceived(LinkInterface* link, mavlink_message_t message)
+{
+    if (link == _mockLink && message.sysid == _vehicle->id()) {
+        _deliveredMessageCount++;
+        _lastMessageNSecs = _timer.nsecsElapsed();
+    }
+}
+
+void MAVLinkIngestBenchmark::_messagesReceived(LinkInterface* link, const QVector<mavlink_message_t>& /*messages*/)
+{
+    if (link == _mockLink && _lastMessageNSecs) {
+        _vehicleNSecs += _timer.nsecsElapsed() - _lastMessageNSecs;
+        _lastMessageNSecs = 0;
+    }
+}
+
+void MAVLinkIngestBenchmark::_lockstep_benchmark(void)
+{
+    qint64      parseNSecs          = 0;
+    qint64      dispatchNSecs       = 0;
+    uint64_t    allocationCount     = 0;
+    int         expectedDelivered   = 0;
+
+    _deliveredMessageCount  = 0;
+    _vehicleNSecs           = 0;
+    _timer.start();
+
+    for (const Chunk_t& chunk: _chunks) {
+        expectedDelivered += chunk.messageCount;
+
+        AllocationCounter::start();
+        qint64 startNSecs = _timer.nsecsElapsed();
+        _mavlinkProtocol->receiveBytes(_mockLink, chunk.bytes);
+        qint64 parsedNSecs = _timer.nsecsElapsed();
+        while (_deliveredMessageCount < expectedDelivered && _timer.nsecsElapsed() - parsedNSecs < 1000000000) {
+            QCoreApplication::processEvents();
+        }
+        qint64 doneNSecs = _timer.nsecsElapsed();
+        allocationCount += AllocationCounter::stop();
+
+        QCOMPARE(_deliveredMessageCount, expectedDelivered);
+        parseNSecs      += parsedNSecs - startNSecs;
+        dispatchNSecs   += doneNSecs - parsedNSecs;
+    }
+
+    double  messageCount    = _deliveredMessageCount;
+    qint64  totalNSecs      = parseNSecs + dispatchNSecs;
+    qint64  protocolNSecs   = dispatchNSecs - _vehicleNSecs;
+
+    qInfo() << "MAVLinkIngestBenchmark lockstep:";
+    qInfo() << "    messages/s          " << qRound64(messageCount * 1e9 / totalNSecs);
+    qInfo() << "    total ns/msg        " << qRound64(totalNSecs / messageCount);
+    qInfo() << "    parse ns/msg        " << qRound64(parseNSecs / messageCount);
+    qInfo() << "    protocol ns/msg     " << qRound64(protocolNSecs / messageCount);
+    qInfo() << "    vehicle ns/msg      " << qRound64(_vehicleNSecs / messageCount);
+    if (AllocationCounter::available()) {
+        qInfo() << "    allocations/msg     " << (allocationCount / messageCount);
+    } else {
+        qInfo() << "    allocations/msg      not available on this platform";
+    }
+    QTest::setBenchmarkResult(totalNSecs / messageCount, QTest::WalltimeNanoseconds);
+}
+
+void MAVLinkIngestBenchmark::_freeRun_benchmark(void)
+{
+    std::atomic<int>    fedMessageCount { 0 };
+    std::atomic<bool>   producerDone    { false };
+    MAVLinkProtocol*    mavlinkProtocol = _mavlinkProtocol;
+    LinkInterface*      link            = _mockLink;
+    const QList<Chunk_t>& chunks        = _chunks;
+
+    _deliveredMessageCount  = 0;
+    _vehicleNSecs           = 0;
+    _timer.start();
+
+    // Stands in for the link thread
+    std::thread producer([&]() {
+        for (const Chunk_t& chunk: chunks) {
+            mavlinkProtocol->receiveBytes(link, chunk.bytes);
+            fedMessageCount += chunk.messageCount;
+        }
+        producerDone = true;
+    });
+
+    qint64  depthSampleCount    = 0;
+    qint64  depthTotal          = 0;
+    int     depthMax            = 0;
+    qint64  lastDeliveryNSecs   = _timer.nsecsElapsed();
+    int     lastDelivered       = 0;
+
+    // Messages dropped off a full receive ring never show up, so stop once deliveries have stalled
+    while (!producerDone || (_deliveredMessageCount < fedMessageCount && _timer.nsecsElapsed() - lastDeliveryNSecs < 500000000)) {
+        int depth = fedMessageCount - _deliveredMessageCount;
+        depthTotal += qMax(depth, 0);
+        depthMax = qMax(depthMax, depth);
+        depthSampleCount++;
+
+        QCoreApplication::processEvents();
+
+        if (_deliveredMessageCount != lastDelivered) {
+            lastDelivered       = _deliveredMessageCount;
+            lastDeliveryNSecs   = _timer.nsecsElapsed();
+        }
+    }
+    producer.join();
+
+    qint64  totalNSecs      = qMax(lastDeliveryNSecs, static_cast<qint64>(1));
+    double  messageCount    = _deliveredMessageCount;
+    int     droppedCount    = fedMessageCount - _deliveredMessageCount;
+
+    qInfo() << "MAVLinkIngestBenchmark free run:";
+    qInfo() << "    messages/s          " << qRound64(messageCount * 1e9 / totalNSecs);
+    qInfo() << "    delivered           " << _deliveredMessageCount;
+    qInfo() << "    dropped             " << droppedCount;
+    qInfo() << "    queue depth avg     " << (depthSampleCount ? depthTotal / depthSampleCount : 0);
+    qInfo() << "    queue depth max     " << depthMax;
+    if (messageCount > 0) {
+        QTest::setBenchmarkResult(totalNSecs / messageCount, QTest::WalltimeNanoseconds);
+    }
+
+    QVERIFY(_deliveredMessageCount > 0);
+}
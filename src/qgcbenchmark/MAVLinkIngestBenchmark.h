@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+
+class MAVLinkProtocol;
+
+/// Benchmark for the receive path from MAVLinkProtocol::receiveBytes through to Vehicle.
+///
+/// Replays the log specified by the QGC_BENCHMARK_MAVLINK_LOG environment variable (.mavlink telemetry log) into a
+/// MockLink vehicle as fast as possible. If no log is specified a synthetic telemetry stream is used instead.
+/// Only the messages from the first system with a heartbeat in the log are replayed, re-addressed to the MockLink
+/// vehicle. Run with: QGroundControl --benchmark:MAVLinkIngestBenchmark (or the benchmark build target). The total
+/// ns/msg of each run is reported as the QTest benchmark result, the breakdown goes to the log.
+class MAVLinkIngestBenchmark : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init(void) override;
+    void cleanup(void) override;
+
+    /// Feeds one datagram sized chunk at a time and waits for it to be fully processed, which gives the cost of each
+    /// stage with nothing queued behind it.
+    void _lockstep_benchmark(void);
+
+    /// Feeds the whole log from a separate thread, the same way a link thread does, while the main thread keeps up
+    /// as best it can. Measures the backlog of messages waiting for the main thread.
+    void _freeRun_benchmark(void);
+
+private:
+    typedef struct {
+        QByteArray  bytes;
+        int         messageCount;
+    } Chunk_t;
+
+    bool    _loadLog                (const QString& logFilename);
+    void    _generateLog            (uint8_t systemId, int seconds);
+    void    _buildChunks            (uint8_t systemId);
+    void    _appendMessage          (mavlink_message_t message, uint8_t systemId);
+    void    _connectBenchmarkLink   (void);
+    void    _messageReceived        (LinkInterface* link, mavlink_message_t message);
+    void    _messagesReceived       (LinkInterface* link, const QVector<mavlink_message_t>& messages);
+
+    MAVLinkProtocol*            _mavlinkProtocol        = nullptr;
+    MAV_AUTOPILOT               _logAutopilot           = MAV_AUTOPILOT_PX4;
+    QVector<mavlink_message_t>  _logMessages;
+    QList<Chunk_t>              _chunks;
+    int                 _chunkMessageCount      = 0;
+    int                 _skippedMessageCount    = 0;
+
+    QElapsedTimer       _timer;
+    int                 _deliveredMessageCount  = 0;
+    qint64              _lastMessageNSecs       = 0;    ///< Time the last messageReceived of the current batch was seen
+    qint64              _vehicleNSecs           = 0;    ///< Accumulated time spent in the Vehicle batch handler
+
+    static const int    _chunkBytes             = 1024; ///< Typical size of a telemetry datagram
+    static const int    _syntheticLogSeconds    = 300;
+    static const char*  _logEnvironmentVariable;
+};
@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBTCPLinkTest.h"
+#include "ADSBVehicleManager.h"
+
+static bool _parse(const QByteArray& line, ADSBVehicle::VehicleInfo_t& adsbInfo)
+{
+    return ADSBTCPLink::parseLine(line.constData(), line.size(), adsbInfo);
+}
+
+void ADSBTCPLinkTest::_airbornePosition_test(void)
+{
+    ADSBVehicle::VehicleInfo_t adsbInfo;
+
+    QVERIFY(_parse("MSG,3,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,37000,,,51.45735,-1.02826,,,0,0,0,0\r\n", adsbInfo));
+    QCOMPARE(adsbInfo.icaoAddress, static_cast<uint32_t>(0x4CA2D6));
+    QCOMPARE(adsbInfo.availableFlags, static_cast<uint32_t>(ADSBVehicle::CallsignAvailable | ADSBVehicle::LocationAvailable | ADSBVehicle::AltitudeAvailable));
+    QCOMPARE(adsbInfo.location.latitude(), 51.45735);
+    QCOMPARE(adsbInfo.location.longitude(), -1.02826);
+    QCOMPARE(adsbInfo.altitude, 37000 / 3.048);
+    QVERIFY(adsbInfo.callsign.isEmpty());
+
+    // No position yet
+    QVERIFY(!_parse("MSG,3,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,37000,,,0,0,,,0,0,0,0", adsbInfo));
+}
+
+void ADSBTCPLinkTest::_airborneVelocity_test(void)
+{
+    ADSBVehicle::VehicleInfo_t adsbInfo;
+
+    QVERIFY(_parse("MSG,4,1,1,a1b2c3,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,,420,271.5,,,-64,,,,,0", adsbInfo));
+    QCOMPARE(adsbInfo.icaoAddress, static_cast<uint32_t>(0xA1B2C3));
+    QCOMPARE(adsbInfo.availableFlags, static_cast<uint32_t>(ADSBVehicle::HeadingAvailable));
+    QCOMPARE(adsbInfo.heading, 271.5);
+}
+
+void ADSBTCPLinkTest::_identification_test(void)
+{
+    ADSBVehicle::VehicleInfo_t adsbInfo;
+
+    QVERIFY(_parse("MSG,1,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,RYR1234,,,,,,,,,,,0\n", adsbInfo));
+    QCOMPARE(adsbInfo.icaoAddress, static_cast<uint32_t>(0x4CA2D6));
+    QCOMPARE(adsbInfo.availableFlags, static_cast<uint32_t>(ADSBVehicle::CallsignAvailable));
+    QCOMPARE(adsbInfo.callsign, QStringLiteral("RYR1234"));
+}
+
+void ADSBTCPLinkTest::_malformed_test(void)
+{
+    ADSBVehicle::VehicleInfo_t adsbInfo;
+
+    // Other message kinds and transmission types
+    QVERIFY(!_parse("STA,,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,RM", adsbInfo));
+    QVERIFY(!_parse("MSG,8,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,,,,,,,,,,,0", adsbInfo));
+    // Too few fields
+    QVERIFY(!_parse("MSG,3,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,37000,,,51.45735", adsbInfo));
+    // Bad numbers
+    QVERIFY(!_parse("MSG,3,1,1,4CA2DX,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,37000,,,51.45735,-1.02826,,,0,0,0,0", adsbInfo));
+    QVERIFY(!_parse("MSG,3,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,37000,,,51.4.5735,-1.02826,,,0,0,0,0", adsbInfo));
+    QVERIFY(!_parse("MSG,3,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,,,,51.45735,-1.02826,,,0,0,0,0", adsbInfo));
+    QVERIFY(!_parse("MSG,4,1,1,4CA2D6,1,2020/06/01,12:00:00.000,2020/06/01,12:00:00.000,,,420,-,,,-64,,,,,0", adsbInfo));
+    QVERIFY(!_parse("", adsbInfo));
+}
@@ -0,0 +1,24 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for the SBS-1 parsing of ADSBTCPLink
+class ADSBTCPLinkTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _airbornePosition_test (void);
+    void _airborneVelocity_test (void);
+    void _identification_test   (void);
+    void _malformed_test        (void);
+};
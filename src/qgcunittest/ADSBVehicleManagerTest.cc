@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBVehicleManagerTest.h"
+#include "ADSBVehicleManager.h"
+#include "QGCApplication.h"
+
+#include <QSignalSpy>
+
+ADSBVehicle::VehicleInfo_t ADSBVehicleManagerTest::_locationInfo(uint32_t icaoAddress, const QGeoCoordinate& location)
+{
+    ADSBVehicle::VehicleInfo_t vehicleInfo;
+
+    vehicleInfo.icaoAddress     = icaoAddress;
+    vehicleInfo.location        = location;
+    vehicleInfo.availableFlags  = ADSBVehicle::LocationAvailable;
+    return vehicleInfo;
+}
+
+void ADSBVehicleManagerTest::_update(ADSBVehicleManager* manager, const QList<ADSBVehicle::VehicleInfo_t>& vehicleInfos)
+{
+    QSignalSpy spyTraffic(manager, &ADSBVehicleManager::trafficUpdated);
+
+    manager->adsbVehicleUpdates(vehicleInfos);
+    QVERIFY(spyTraffic.wait(2000));
+}
+
+void ADSBVehicleManagerTest::_proximity_test(void)
+{
+    ADSBVehicleManager* manager = qgcApp()->toolbox()->adsbVehicleManager();
+    const QGeoCoordinate center(47.0, 8.0);
+
+    _update(manager, {
+                _locationInfo(0x100001, center.atDistanceAndAzimuth(1000, 0)),
+                _locationInfo(0x100002, center.atDistanceAndAzimuth(10000, 90)),
+                _locationInfo(0x100003, center.atDistanceAndAzimuth(100000, 180)),
+                _locationInfo(0x100004, center.atDistanceAndAzimuth(40000, 270)),
+            });
+
+    QList<ADSBVehicleManager::TrafficDistance_t> traffic = manager->trafficInRadius(center, 50000);
+    QCOMPARE(traffic.count(), 3);
+    QCOMPARE(traffic[0].icaoAddress, static_cast<uint32_t>(0x100001));
+    QCOMPARE(traffic[1].icaoAddress, static_cast<uint32_t>(0x100002));
+    QCOMPARE(traffic[2].icaoAddress, static_cast<uint32_t>(0x100004));
+    QVERIFY(qAbs(traffic[0].distance - 1000) < 1);
+
+    // The search has to grow past its start radius to find the second closest
+    traffic = manager->nearestTraffic(center.atDistanceAndAzimuth(100000, 180), 2);
+    QCOMPARE(traffic.count(), 2);
+    QCOMPARE(traffic[0].icaoAddress, static_cast<uint32_t>(0x100003));
+    QCOMPARE(traffic[1].icaoAddress, static_cast<uint32_t>(0x100002));
+
+    // Moving to another cell takes the aircraft along in the index
+    _update(manager, { _locationInfo(0x100001, center.atDistanceAndAzimuth(200000, 0)) });
+    traffic = manager->trafficInRadius(center, 5000);
+    QCOMPARE(traffic.count(), 0);
+    traffic = manager->nearestTraffic(center.atDistanceAndAzimuth(200000, 0), 1);
+    QCOMPARE(traffic.count(), 1);
+    QCOMPARE(traffic[0].icaoAddress, static_cast<uint32_t>(0x100001));
+}
+
+void ADSBVehicleManagerTest::_antimeridian_test(void)
+{
+    ADSBVehicleManager* manager = qgcApp()->toolbox()->adsbVehicleManager();
+
+    _update(manager, { _locationInfo(0x200001, QGeoCoordinate(-20.0, -179.99)) });
+
+    QList<ADSBVehicleManager::TrafficDistance_t> traffic = manager->trafficInRadius(QGeoCoordinate(-20.0, 179.99), 5000);
+    QCOMPARE(traffic.count(), 1);
+    QCOMPARE(traffic[0].icaoAddress, static_cast<uint32_t>(0x200001));
+}
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "ADSBVehicle.h"
+
+class ADSBVehicleManager;
+
+/// Unit test for the traffic store of ADSBVehicleManager
+class ADSBVehicleManagerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _proximity_test    (void);
+    void _antimeridian_test (void);
+
+private:
+    void _update(ADSBVehicleManager* manager, const QList<ADSBVehicle::VehicleInfo_t>& vehicleInfos);
+
+    static ADSBVehicle::VehicleInfo_t _locationInfo(uint32_t icaoAddress, const QGeoCoordinate& location);
+};
@@ -91,3 +91,121 @@ void GeoTest::_convertNedToGeoAtOrigin_test(void)
     QCOMPARE(coord.longitude(), expectedLon);
     QCOMPARE(coord.altitude(), expectedAlt);
 }
+
+/// Grid of coordinates a few kilometers around the origin
+QVector<QGeoCoordinate> GeoTest::_batchCoordinates(void) const
+{
+    QVector<QGeoCoordinate> coords;
+    coords.reserve(_cBatchCoordinates);
+    for (int i = 0; i < _cBatchCoordinates; i++) {
+        coords.append(QGeoCoordinate(_origin.latitude() + ((i / 100) - 49.5) * 0.001, _origin.longitude() + ((i % 100) - 49.5) * 0.001, i * 0.1));
+    }
+    return coords;
+}
+
+void GeoTest::_convertGeoToNedBatch_test(void)
+{
+    const QVector<QGeoCoordinate> coords = _batchCoordinates();
+    QVector<double> x(coords.count()), y(coords.count()), z(coords.count());
+
+    convertGeoToNed(coords.constData(), coords.count(), _origin, x.data(), y.data(), z.data());
+
+    for (int i = 0; i < coords.count(); i++) {
+        double expectedX, expectedY, expectedZ;
+        convertGeoToNed(coords[i], _origin, &expectedX, &expectedY, &expectedZ);
+        QVERIFY(qAbs(x[i] - expectedX) < 1e-6);
+        QVERIFY(qAbs(y[i] - expectedY) < 1e-6);
+        QCOMPARE(z[i], expectedZ);
+    }
+
+    // The origin itself has to come out as zero without the short circuit of the single version
+    double originX, originY;
+    convertGeoToNed(&_origin, 1, _origin, &originX, &originY, nullptr);
+    QCOMPARE(originX, 0.0);
+    QCOMPARE(originY, 0.0);
+}
+
+void GeoTest::_convertNedToGeoBatch_test(void)
+{
+    const QVector<QGeoCoordinate> coords = _batchCoordinates();
+    QVector<double> x(coords.count()), y(coords.count()), z(coords.count());
+    QVector<QGeoCoordinate> roundTrip(coords.count());
+
+    convertGeoToNed(coords.constData(), coords.count(), _origin, x.data(), y.data(), z.data());
+    convertNedToGeo(x.constData(), y.constData(), z.constData(), coords.count(), _origin, roundTrip.data());
+
+    for (int i = 0; i < coords.count(); i++) {
+        QGeoCoordinate expected;
+        convertNedToGeo(x[i], y[i], z[i], _origin, &expected);
+        QVERIFY(qAbs(roundTrip[i].latitude() - expected.latitude()) < 1e-9);
+        QVERIFY(qAbs(roundTrip[i].longitude() - expected.longitude()) < 1e-9);
+        QVERIFY(coords[i].distanceTo(roundTrip[i]) < 1e-3);
+        QVERIFY(qAbs(roundTrip[i].altitude() - coords[i].altitude()) < 1e-6);
+    }
+}
+
+void GeoTest::_convertUTMBatch_test(void)
+{
+    const QVector<QGeoCoordinate> coords = _batchCoordinates();
+    QVector<double> easting(coords.count()), northing(coords.count());
+    QVector<QGeoCoordinate> roundTrip(coords.count());
+
+    const int zone = convertGeoToUTM(coords.constData(), coords.count(), easting.data(), northing.data());
+    QCOMPARE(zone, 32);
+
+    for (int i = 0; i < coords.count(); i++) {
+        double expectedEasting, expectedNorthing;
+        QCOMPARE(convertGeoToUTM(coords[i], expectedEasting, expectedNorthing), zone);
+        QVERIFY(qAbs(easting[i] - expectedEasting) < 1e-6);
+        QVERIFY(qAbs(northing[i] - expectedNorthing) < 1e-6);
+    }
+
+    QVERIFY(convertUTMToGeo(easting.constData(), northing.constData(), coords.count(), zone, false /* southhemi */, roundTrip.data()));
+    for (int i = 0; i < coords.count(); i++) {
+        QVERIFY(coords[i].distanceTo(roundTrip[i]) < 1e-3);
+    }
+
+    QVERIFY(!convertUTMToGeo(easting.constData(), northing.constData(), coords.count(), 0 /* zone */, false /* southhemi */, roundTrip.data()));
+}
+
+void GeoTest::_convertWebMercator_test(void)
+{
+    const double worldSize = 256.0 * 1024.0;
+
+    double x;
+    double y;
+    convertGeoToWebMercator(0.0, 0.0, worldSize, x, y);
+    QCOMPARE(x, worldSize / 2.0);
+    QCOMPARE(y, worldSize / 2.0);
+
+    double latitude;
+    double longitude;
+    convertGeoToWebMercator(_origin.latitude(), _origin.longitude(), worldSize, x, y);
+    convertWebMercatorToGeo(x, y, worldSize, latitude, longitude);
+    QVERIFY(qAbs(latitude - _origin.latitude()) < 1e-9);
+    QVERIFY(qAbs(longitude - _origin.longitude()) < 1e-9);
+}
+
+void GeoTest::_convertGeoToNedBatch_benchmark(void)
+{
+    const QVector<QGeoCoordinate> coords = _batchCoordinates();
+    QVector<double> x(coords.count()), y(coords.count());
+
+    QBENCHMARK {
+        convertGeoToNed(coords.constData(), coords.count(), _origin, x.data(), y.data(), nullptr);
+    }
+}
+
+void GeoTest::_convertGeoToNedSingle_benchmark(void)
+{
+    const QVector<QGeoCoordinate> coords = _batchCoordinates();
+    QVector<double> x(coords.count()), y(coords.count());
+
+    QBENCHMARK {
+        for (int i = 0; i < coords.count(); i++) {
+            double z;
+            convertGeoToNed(coords[i], _origin, &x[i], &y[i], &z);
+        }
+    }
+}
+
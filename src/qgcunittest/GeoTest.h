@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QGeoCoordinate>
+#include <QVector>
 
 #include "UnitTest.h"
 
@@ -33,7 +34,18 @@ private slots:
     void _convertGeoToNedAtOrigin_test(void);
     void _convertNedToGeo_test(void);
     void _convertNedToGeoAtOrigin_test(void);
+    void _convertGeoToNedBatch_test(void);
+    void _convertNedToGeoBatch_test(void);
+    void _convertUTMBatch_test(void);
+    void _convertWebMercator_test(void);
+    void _convertGeoToNedBatch_benchmark(void);
+    void _convertGeoToNedSingle_benchmark(void);
+
 private:
+    QVector<QGeoCoordinate> _batchCoordinates(void) const;
+
     QGeoCoordinate _origin;
+
+    static const int _cBatchCoordinates = 10000;
 };
 
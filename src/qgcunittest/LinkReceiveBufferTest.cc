@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkReceiveBufferTest.h"
+#include "LinkReceiveBuffer.h"
+#include "QGCMAVLink.h"
+
+#include <QBuffer>
+
+QByteArray LinkReceiveBufferTest::_heartbeatFrame(uint8_t sequence)
+{
+    mavlink_message_t   message;
+    uint8_t             buffer[MAVLINK_MAX_PACKET_LEN];
+
+    mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    message.seq = sequence;
+
+    return QByteArray(reinterpret_cast<const char*>(buffer), mavlink_msg_to_send_buffer(buffer, &message));
+}
+
+QByteArray LinkReceiveBufferTest::_statusTextFrame(const char* text)
+{
+    mavlink_message_t   message;
+    uint8_t             buffer[MAVLINK_MAX_PACKET_LEN];
+    mavlink_statustext_t statusText;
+
+    memset(&statusText, 0, sizeof(statusText));
+    statusText.severity = MAV_SEVERITY_INFO;
+    strncpy(statusText.text, text, sizeof(statusText.text));
+    mavlink_msg_statustext_encode_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, &statusText);
+
+    return QByteArray(reinterpret_cast<const char*>(buffer), mavlink_msg_to_send_buffer(buffer, &message));
+}
+
+void LinkReceiveBufferTest::_frameBoundary_test(void)
+{
+    LinkReceiveBuffer   receiveBuffer(1024);
+    QByteArray          heartbeat   = _heartbeatFrame(0);
+    QByteArray          statusText  = _statusTextFrame("frame boundary");
+    QByteArray          frames;
+
+    QCOMPARE(receiveBuffer.capacity(), 1024);
+
+    // Stray bytes in front of a frame are passed through
+    QByteArray complete = QByteArray("xy") + heartbeat + statusText;
+    receiveBuffer.write(complete.constData(), complete.size());
+
+    // A trailing partial frame, including one with only the start byte, is held back
+    receiveBuffer.write(heartbeat.constData(), 1);
+    QCOMPARE(receiveBuffer.takeFrames(frames), complete.size());
+    QCOMPARE(frames, complete);
+    QCOMPARE(receiveBuffer.count(), 1);
+
+    receiveBuffer.write(heartbeat.constData() + 1, 5);
+    frames.clear();
+    QCOMPARE(receiveBuffer.takeFrames(frames), 0);
+    QVERIFY(frames.isEmpty());
+
+    receiveBuffer.write(heartbeat.constData() + 6, heartbeat.size() - 6);
+    QCOMPARE(receiveBuffer.takeFrames(frames), heartbeat.size());
+    QCOMPARE(frames, heartbeat);
+    QCOMPARE(receiveBuffer.count(), 0);
+
+    // takeAll hands off the partial frame as well
+    receiveBuffer.write(statusText.constData(), 4);
+    frames.clear();
+    QCOMPARE(receiveBuffer.takeAll(frames), 4);
+    QCOMPARE(frames, statusText.left(4));
+    QCOMPARE(receiveBuffer.count(), 0);
+}
+
+void LinkReceiveBufferTest::_wrapAround_test(void)
+{
+    LinkReceiveBuffer receiveBuffer(64);
+
+    // Frames which do not divide the capacity evenly end up straddling the physical end of the ring
+    for (int i=0; i<100; i++) {
+        QByteArray heartbeat = _heartbeatFrame(static_cast<uint8_t>(i));
+        QByteArray frames;
+
+        QCOMPARE(receiveBuffer.write(heartbeat.constData(), heartbeat.size()), heartbeat.size());
+        QCOMPARE(receiveBuffer.takeFrames(frames), heartbeat.size());
+        QCOMPARE(frames, heartbeat);
+    }
+
+    // Writes stop once the ring is full
+    QByteArray fill(100, 'z');
+    QCOMPARE(receiveBuffer.write(fill.constData(), fill.size()), 64);
+    QCOMPARE(receiveBuffer.freeSpace(), 0);
+}
+
+void LinkReceiveBufferTest::_readFrom_test(void)
+{
+    LinkReceiveBuffer   receiveBuffer(256);
+    QByteArray          source;
+    QByteArray          frames;
+
+    for (int i=0; i<20; i++) {
+        source.append(_heartbeatFrame(static_cast<uint8_t>(i)));
+    }
+
+    QBuffer device(&source);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+
+    // Keep the ring partially full so reads have to wrap
+    while (!device.atEnd() || receiveBuffer.count()) {
+        QVERIFY(receiveBuffer.readFrom(&device) >= 0);
+        receiveBuffer.takeFrames(frames);
+        if (device.atEnd()) {
+            receiveBuffer.takeAll(frames);
+        }
+    }
+    QCOMPARE(frames, source);
+}
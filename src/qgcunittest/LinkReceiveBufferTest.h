@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for LinkReceiveBuffer
+class LinkReceiveBufferTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _frameBoundary_test    (void);
+    void _wrapAround_test       (void);
+    void _readFrom_test         (void);
+
+private:
+    QByteArray _heartbeatFrame  (uint8_t sequence);
+    QByteArray _statusTextFrame (const char* text);
+};
@@ -0,0 +1,101 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkSendQueueTest.h"
+#include "LinkSendQueue.h"
+
+#include <QThread>
+
+#include <thread>
+#include <vector>
+
+void LinkSendQueueTest::_fifoOrder_test(void)
+{
+    LinkSendQueue   sendQueue;
+    QByteArray      bytes;
+
+    QVERIFY(!sendQueue.pop(bytes));
+
+    for (char i=0; i<10; i++) {
+        sendQueue.push(&i, 1);
+    }
+    QCOMPARE(sendQueue.count(), 10);
+
+    for (char i=0; i<10; i++) {
+        QVERIFY(sendQueue.pop(bytes));
+        QCOMPARE(bytes.size(), 1);
+        QCOMPARE(bytes[0], i);
+    }
+    QVERIFY(!sendQueue.pop(bytes));
+    QCOMPARE(sendQueue.count(), 0);
+
+    // Queue must still work once it has been emptied
+    sendQueue.push("abc", 3);
+    QVERIFY(sendQueue.pop(bytes));
+    QCOMPARE(bytes, QByteArray("abc"));
+}
+
+void LinkSendQueueTest::_peekSize_test(void)
+{
+    LinkSendQueue   sendQueue;
+    QByteArray      bytes;
+
+    QCOMPARE(sendQueue.peekSize(), 0);
+    sendQueue.push("abc", 3);
+    sendQueue.push("de", 2);
+    QCOMPARE(sendQueue.peekSize(), 3);
+    QVERIFY(sendQueue.pop(bytes));
+    QCOMPARE(sendQueue.peekSize(), 2);
+    QVERIFY(sendQueue.pop(bytes));
+    QCOMPARE(sendQueue.peekSize(), 0);
+}
+
+void LinkSendQueueTest::_multipleProducer_test(void)
+{
+    const int       cProducers          = 4;
+    const int       cFramesPerProducer  = 10000;
+    LinkSendQueue   sendQueue;
+
+    std::vector<std::thread> producers;
+    for (int producer=0; producer<cProducers; producer++) {
+        producers.emplace_back([&sendQueue, producer, cFramesPerProducer]() {
+            for (int i=0; i<cFramesPerProducer; i++) {
+                int frame[2] = { producer, i };
+                sendQueue.push(reinterpret_cast<const char*>(frame), sizeof(frame));
+            }
+        });
+    }
+
+    // Frames from each producer must arrive complete and in the order they were pushed. Producers are joined
+    // before checking so a failure can't leave threads running.
+    std::vector<int>    nextExpected(cProducers, 0);
+    int                 cReceived = 0;
+    bool                framesValid = true;
+    QByteArray          bytes;
+    while (framesValid && cReceived < cProducers * cFramesPerProducer) {
+        if (!sendQueue.pop(bytes)) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        const int* frame = reinterpret_cast<const int*>(bytes.constData());
+        framesValid = bytes.size() == static_cast<int>(2 * sizeof(int)) && frame[0] >= 0 && frame[0] < cProducers && frame[1] == nextExpected[frame[0]];
+        if (framesValid) {
+            nextExpected[frame[0]]++;
+            cReceived++;
+        }
+    }
+
+    for (std::thread& producer: producers) {
+        producer.join();
+    }
+
+    QVERIFY(framesValid);
+    QCOMPARE(cReceived, cProducers * cFramesPerProducer);
+    QVERIFY(!sendQueue.pop(bytes));
+}
@@ -0,0 +1,23 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for LinkSendQueue
+class LinkSendQueueTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _fifoOrder_test        (void);
+    void _peekSize_test         (void);
+    void _multipleProducer_test (void);
+};
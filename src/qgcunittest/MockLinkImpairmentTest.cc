@@ -0,0 +1,152 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockLinkImpairmentTest.h"
+#include "MockLinkImpairment.h"
+
+void MockLinkImpairmentTest::_passThrough_test(void)
+{
+    MockLinkImpairment impairment;
+    QVERIFY(!impairment.enabled());
+
+    MockLinkImpairment::Config_t config;
+    config.seed = 1234;
+    impairment.setConfig(config);
+    QVERIFY(!impairment.enabled());
+
+    impairment.setConfig(MockLinkImpairment::radio57600());
+    QVERIFY(impairment.enabled());
+}
+
+void MockLinkImpairmentTest::_rate_test(void)
+{
+    MockLinkImpairment              impairment;
+    MockLinkImpairment::Config_t    config;
+    QList<QByteArray>               packets;
+
+    config.latencyMSecs     = 50;
+    config.bytesPerSecond   = 1000;
+    impairment.setConfig(config);
+
+    // Ten 100 byte packets sent at once go out back to back, one every 100 msecs
+    for (int i=0; i<10; i++) {
+        QVERIFY(impairment.send(0, QByteArray(100, static_cast<char>(i))));
+    }
+    impairment.takeArrived(149, packets);
+    QCOMPARE(packets.count(), 0);
+    impairment.takeArrived(150, packets);
+    QCOMPARE(packets.count(), 1);
+    impairment.takeArrived(1049, packets);
+    QCOMPARE(packets.count(), 9);
+    impairment.takeArrived(1050, packets);
+    QCOMPARE(packets.count(), 10);
+    QVERIFY(!impairment.inFlight());
+
+    // An idle link starts from the time of the send
+    QVERIFY(impairment.send(5000, QByteArray(10, 0)));
+    packets.clear();
+    impairment.takeArrived(5059, packets);
+    QCOMPARE(packets.count(), 0);
+    impairment.takeArrived(5060, packets);
+    QCOMPARE(packets.count(), 1);
+}
+
+void MockLinkImpairmentTest::_order_test(void)
+{
+    MockLinkImpairment              impairment;
+    MockLinkImpairment::Config_t    config;
+    QList<QByteArray>               packets;
+
+    config.latencyMSecs = 10;
+    config.jitterMSecs  = 200;
+    config.seed         = 42;
+    impairment.setConfig(config);
+
+    for (int i=0; i<100; i++) {
+        QVERIFY(impairment.send(i, QByteArray(1, static_cast<char>(i))));
+    }
+    impairment.takeArrived(100 + 10 + 200, packets);
+    QCOMPARE(packets.count(), 100);
+    for (int i=0; i<packets.count(); i++) {
+        QCOMPARE(packets[i].at(0), static_cast<char>(i));
+    }
+}
+
+void MockLinkImpairmentTest::_loss_test(void)
+{
+    MockLinkImpairment::Config_t config;
+    config.lossPercent  = 10;
+    config.seed         = 7;
+
+    QVector<bool>   first;
+    QVector<bool>   second;
+    const int       packetCount = 10000;
+    for (QVector<bool>* results: { &first, &second }) {
+        MockLinkImpairment impairment;
+        impairment.setConfig(config);
+        for (int i=0; i<packetCount; i++) {
+            results->append(impairment.send(i, QByteArray(10, 0)));
+        }
+        QCOMPARE(impairment.sentCount(), static_cast<quint64>(packetCount));
+        QVERIFY(impairment.lostCount() > packetCount * 8 / 100 && impairment.lostCount() < packetCount * 12 / 100);
+    }
+    // Same seed, same losses
+    QCOMPARE(first, second);
+}
+
+void MockLinkImpairmentTest::_burst_test(void)
+{
+    MockLinkImpairment              impairment;
+    MockLinkImpairment::Config_t    config;
+
+    config.burstStartPercent    = 1;
+    config.burstLength          = 8;
+    config.seed                 = 99;
+    impairment.setConfig(config);
+
+    // With no random loss every loss is part of a full length burst
+    int run         = 0;
+    int burstCount  = 0;
+    for (int i=0; i<10000; i++) {
+        if (!impairment.send(i, QByteArray(10, 0))) {
+            run++;
+        } else if (run) {
+            QCOMPARE(run % config.burstLength, 0);
+            burstCount++;
+            run = 0;
+        }
+    }
+    QVERIFY(burstCount > 0);
+}
+
+void MockLinkImpairmentTest::_queueLimit_test(void)
+{
+    MockLinkImpairment              impairment;
+    MockLinkImpairment::Config_t    config;
+    QList<QByteArray>               packets;
+
+    config.bytesPerSecond   = 1000;
+    config.queueLimitBytes  = 250;
+    impairment.setConfig(config);
+
+    // The buffer counts everything not yet on the air, including the packet going out, so only two fit
+    int sent = 0;
+    for (int i=0; i<10; i++) {
+        if (impairment.send(0, QByteArray(100, 0))) {
+            sent++;
+        }
+    }
+    QCOMPARE(sent, 2);
+    QCOMPARE(impairment.overflowCount(), static_cast<quint64>(8));
+
+    // Room again once the air time has passed
+    QVERIFY(impairment.send(300, QByteArray(100, 0)));
+    impairment.takeArrived(400, packets);
+    QCOMPARE(packets.count(), 3);
+}
@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for MockLinkImpairment
+class MockLinkImpairmentTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _passThrough_test  (void);
+    void _rate_test         (void);
+    void _order_test        (void);
+    void _loss_test         (void);
+    void _burst_test        (void);
+    void _queueLimit_test   (void);
+};
@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockLinkSwarmTest.h"
+#include "MockLinkSwarm.h"
+
+#include <QMap>
+
+/// Runs a swarm in simulated time, ticking at the same interval MockLink does
+void MockLinkSwarmTest::_run(int vehicleCount, int telemetryRateHz, uint32_t seed, qint64 durationMSecs, QByteArray& bytes)
+{
+    MockLinkSwarm swarm(vehicleCount, telemetryRateHz, seed, MAVLINK_COMM_0);
+
+    for (qint64 nowMSecs=0; nowMSecs<durationMSecs; nowMSecs+=MockLinkSwarm::tickMSecs) {
+        swarm.tick(nowMSecs, bytes);
+    }
+    // Ticking on schedule never falls behind
+    QCOMPARE(swarm.lateCount(), static_cast<quint64>(0));
+}
+
+void MockLinkSwarmTest::_reproducible_test(void)
+{
+    QByteArray first;
+    QByteArray second;
+    QByteArray other;
+
+    _run(20, 10, 1234, 3000, first);
+    _run(20, 10, 1234, 3000, second);
+    _run(20, 10, 4321, 3000, other);
+
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(first, second);
+    QVERIFY(first != other);
+}
+
+void MockLinkSwarmTest::_rate_test(void)
+{
+    const int           vehicleCount    = 50;
+    const int           rateHz          = 10;
+    const int           seconds         = 10;
+    QByteArray          bytes;
+    QMap<uint32_t, int> counts;
+    mavlink_message_t   rxMessage;
+    mavlink_status_t    rxStatus;
+
+    _run(vehicleCount, rateHz, 7, seconds * 1000, bytes);
+
+    memset(&rxMessage,  0, sizeof(rxMessage));
+    memset(&rxStatus,   0, sizeof(rxStatus));
+    for (char byte: bytes) {
+        mavlink_message_t   message;
+        mavlink_status_t    status;
+        if (mavlink_frame_char_buffer(&rxMessage, &rxStatus, static_cast<uint8_t>(byte), &message, &status) == MAVLINK_FRAMING_OK) {
+            counts[message.msgid]++;
+        }
+    }
+
+    // Each stream starts at a random phase within its period, so a vehicle whose phase falls after the
+    // last tick sends one message less
+    struct {
+        uint32_t    msgid;
+        int         perVehicle;
+    } expected[] = {
+        { MAVLINK_MSG_ID_HEARTBEAT,             seconds },
+        { MAVLINK_MSG_ID_SYS_STATUS,            seconds },
+        { MAVLINK_MSG_ID_GPS_RAW_INT,           seconds },
+        { MAVLINK_MSG_ID_GLOBAL_POSITION_INT,   seconds * rateHz },
+        { MAVLINK_MSG_ID_ATTITUDE,              seconds * rateHz },
+    };
+    for (const auto& stream: expected) {
+        QVERIFY(counts[stream.msgid] >= vehicleCount * (stream.perVehicle - 1));
+        QVERIFY(counts[stream.msgid] <= vehicleCount * stream.perVehicle);
+    }
+}
+
+void MockLinkSwarmTest::_sequence_test(void)
+{
+    QByteArray              bytes;
+    QMap<uint8_t, uint8_t>  nextSequence;
+    mavlink_message_t       rxMessage;
+    mavlink_status_t        rxStatus;
+
+    _run(30, 20, 99, 2000, bytes);
+
+    memset(&rxMessage,  0, sizeof(rxMessage));
+    memset(&rxStatus,   0, sizeof(rxStatus));
+    for (char byte: bytes) {
+        mavlink_message_t   message;
+        mavlink_status_t    status;
+        if (mavlink_frame_char_buffer(&rxMessage, &rxStatus, static_cast<uint8_t>(byte), &message, &status) != MAVLINK_FRAMING_OK) {
+            continue;
+        }
+        QVERIFY(message.sysid >= MockLinkSwarm::firstSystemId && message.sysid < MockLinkSwarm::firstSystemId + 30);
+        if (nextSequence.contains(message.sysid)) {
+            QCOMPARE(message.seq, nextSequence[message.sysid]);
+        }
+        nextSequence[message.sysid] = static_cast<uint8_t>(message.seq + 1);
+    }
+    QCOMPARE(nextSequence.count(), 30);
+}
+
+void MockLinkSwarmTest::_responses_test(void)
+{
+    MockLinkSwarm               swarm(10, 5, 0, MAVLINK_COMM_0);
+    mavlink_message_t           message;
+    uint8_t                     buffer[MAVLINK_MAX_PACKET_LEN];
+    QByteArray                  responses;
+    mavlink_message_t           rxMessage;
+    mavlink_status_t            rxStatus;
+    QList<mavlink_message_t>    received;
+
+    mavlink_msg_command_long_pack_chan(255, MAV_COMP_ID_MISSIONPLANNER, MAVLINK_COMM_0, &message, 3, MAV_COMP_ID_AUTOPILOT1, MAV_CMD_REQUEST_MESSAGE, 0, MAVLINK_MSG_ID_AUTOPILOT_VERSION, 0, 0, 0, 0, 0, 0);
+    swarm.handleBytes(QByteArray(reinterpret_cast<const char*>(buffer), mavlink_msg_to_send_buffer(buffer, &message)), responses);
+    mavlink_msg_param_request_list_pack_chan(255, MAV_COMP_ID_MISSIONPLANNER, MAVLINK_COMM_0, &message, 0, MAV_COMP_ID_ALL);
+    swarm.handleBytes(QByteArray(reinterpret_cast<const char*>(buffer), mavlink_msg_to_send_buffer(buffer, &message)), responses);
+
+    memset(&rxMessage,  0, sizeof(rxMessage));
+    memset(&rxStatus,   0, sizeof(rxStatus));
+    for (char byte: responses) {
+        mavlink_message_t   response;
+        mavlink_status_t    status;
+        if (mavlink_frame_char_buffer(&rxMessage, &rxStatus, static_cast<uint8_t>(byte), &response, &status) == MAVLINK_FRAMING_OK) {
+            received.append(response);
+        }
+    }
+
+    // Targeted command is acked by one vehicle, broadcast param request is answered by all of them
+    QCOMPARE(received.count(), 11);
+    QCOMPARE(static_cast<uint32_t>(received[0].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_COMMAND_ACK));
+    QCOMPARE(received[0].sysid, static_cast<uint8_t>(3));
+    QCOMPARE(mavlink_msg_command_ack_get_result(&received[0]), static_cast<uint8_t>(MAV_RESULT_UNSUPPORTED));
+    for (int i=1; i<received.count(); i++) {
+        QCOMPARE(static_cast<uint32_t>(received[i].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_PARAM_VALUE));
+        QCOMPARE(mavlink_msg_param_value_get_param_count(&received[i]), static_cast<uint16_t>(1));
+    }
+}
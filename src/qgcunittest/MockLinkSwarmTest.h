@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for MockLinkSwarm
+class MockLinkSwarmTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _reproducible_test     (void);
+    void _rate_test             (void);
+    void _sequence_test         (void);
+    void _responses_test        (void);
+
+private:
+    void _run(int vehicleCount, int telemetryRateHz, uint32_t seed, qint64 durationMSecs, QByteArray& bytes);
+};
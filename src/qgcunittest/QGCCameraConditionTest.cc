@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCCameraConditionTest.h"
+#include "QGCCameraControl.h"
+
+/// Camera parameters to test conditions against
+class ConditionTestFacts : public FactGroup
+{
+public:
+    ConditionTestFacts(void)
+        : FactGroup(0, nullptr, true /* ignore camel case */)
+    {
+        for (const char* name: { "CAM_MODE", "CAM_EXPMODE", "CAM_ISO" }) {
+            Fact* fact = new Fact(0, name, FactMetaData::valueTypeUint32, this);
+            fact->_containerSetRawValue(0);
+            _addFact(fact, name);
+        }
+    }
+
+    void set(const QString& name, uint32_t value) { getFact(name)->_containerSetRawValue(value); }
+};
+
+void QGCCameraConditionTest::_empty_test(void)
+{
+    ConditionTestFacts  facts;
+    QGCCameraCondition  condition;
+
+    condition.compile(QString(), &facts);
+    QVERIFY(condition.evaluate());
+    QVERIFY(condition.facts().isEmpty());
+}
+
+void QGCCameraConditionTest::_tests_test(void)
+{
+    ConditionTestFacts  facts;
+    QGCCameraCondition  condition;
+
+    condition.compile(QStringLiteral("CAM_EXPMODE=1"), &facts);
+    QCOMPARE(condition.facts(), QList<Fact*>({ facts.getFact(QStringLiteral("CAM_EXPMODE")) }));
+    QVERIFY(!condition.evaluate());
+    facts.set(QStringLiteral("CAM_EXPMODE"), 1);
+    QVERIFY(condition.evaluate());
+
+    condition.compile(QStringLiteral("CAM_EXPMODE!=1"), &facts);
+    QVERIFY(!condition.evaluate());
+
+    // Values compare as strings
+    facts.set(QStringLiteral("CAM_ISO"), 200);
+    condition.compile(QStringLiteral("CAM_ISO>100"), &facts);
+    QVERIFY(condition.evaluate());
+    condition.compile(QStringLiteral("CAM_ISO<100"), &facts);
+    QVERIFY(!condition.evaluate());
+}
+
+void QGCCameraConditionTest::_leftToRight_test(void)
+{
+    ConditionTestFacts  facts;
+    QGCCameraCondition  condition;
+
+    // ((CAM_MODE=1 AND CAM_EXPMODE=1) OR CAM_ISO=100)
+    condition.compile(QStringLiteral("CAM_MODE=1 AND CAM_EXPMODE=1 OR CAM_ISO=100"), &facts);
+    QCOMPARE(condition.facts().count(), 3);
+    QVERIFY(!condition.evaluate());
+    facts.set(QStringLiteral("CAM_ISO"), 100);
+    QVERIFY(condition.evaluate());
+    facts.set(QStringLiteral("CAM_ISO"), 0);
+    facts.set(QStringLiteral("CAM_MODE"), 1);
+    QVERIFY(!condition.evaluate());
+    facts.set(QStringLiteral("CAM_EXPMODE"), 1);
+    QVERIFY(condition.evaluate());
+
+    // The AND applies to the result of the OR before it
+    condition.compile(QStringLiteral("CAM_MODE=1 OR CAM_ISO=100 AND CAM_EXPMODE=0"), &facts);
+    QVERIFY(!condition.evaluate());
+}
+
+void QGCCameraConditionTest::_invalid_test(void)
+{
+    ConditionTestFacts  facts;
+    QGCCameraCondition  condition;
+
+    // Invalid tests are reported once when compiled and are always false
+    condition.compile(QStringLiteral("CAM_BOGUS=0"), &facts);
+    QVERIFY(condition.facts().isEmpty());
+    QVERIFY(!condition.evaluate());
+
+    condition.compile(QStringLiteral("CAM_MODE OR CAM_ISO=0"), &facts);
+    QVERIFY(condition.evaluate());
+    QCOMPARE(condition.facts().count(), 1);
+}
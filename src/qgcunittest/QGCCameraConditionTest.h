@@ -0,0 +1,24 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for QGCCameraCondition
+class QGCCameraConditionTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _empty_test        (void);
+    void _tests_test        (void);
+    void _leftToRight_test  (void);
+    void _invalid_test      (void);
+};
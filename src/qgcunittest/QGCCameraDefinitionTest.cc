@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCCameraDefinitionTest.h"
+#include "QGCCameraDefinition.h"
+
+#include <QTemporaryDir>
+
+static const char* kDefinition =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+        "<mavlinkcamera>\n"
+        "    <definition version=\"7\">\n"
+        "        <model>SD II</model>\n"
+        "        <vendor>Super Dupper Industries</vendor>\n"
+        "    </definition>\n"
+        "    <parameters>\n"
+        "        <parameter name=\"CAM_MODE\" type=\"uint32\" default=\"1\">\n"
+        "            <description>Camera Mode</description>\n"
+        "            <updates>\n"
+        "                <update>CAM_ISO</update>\n"
+        "            </updates>\n"
+        "            <options>\n"
+        "                <option name=\"Photo\" value=\"0\">\n"
+        "                    <exclusions>\n"
+        "                        <exclude>CAM_VIDRES</exclude>\n"
+        "                    </exclusions>\n"
+        "                </option>\n"
+        "                <option name=\"Video\" value=\"1\">\n"
+        "                    <parameterranges>\n"
+        "                        <parameterrange parameter=\"CAM_ISO\" condition=\"CAM_EXPMODE=1\">\n"
+        "                            <roption name=\"100\" value=\"100\" />\n"
+        "                            <roption name=\"200\" value=\"200\" />\n"
+        "                        </parameterrange>\n"
+        "                    </parameterranges>\n"
+        "                </option>\n"
+        "            </options>\n"
+        "        </parameter>\n"
+        "        <parameter name=\"CAM_ISO\" type=\"uint32\" min=\"100\" max=\"3200\" control=\"0\">\n"
+        "            <description>ISO</description>\n"
+        "        </parameter>\n"
+        "    </parameters>\n"
+        "    <localization>\n"
+        "        <locale name=\"pt_BR\">\n"
+        "            <strings original=\"Camera Mode\" translated=\"Modo de Operação\" />\n"
+        "            <strings original=\"Video\" translated=\"Vídeo\" />\n"
+        "        </locale>\n"
+        "    </localization>\n"
+        "</mavlinkcamera>\n";
+
+void QGCCameraDefinitionTest::_parse_test(void)
+{
+    QGCCameraDefinition definition;
+    QString             errorString;
+
+    QVERIFY2(definition.parse(QByteArray(kDefinition), QStringLiteral("en_us"), errorString), qPrintable(errorString));
+    QCOMPARE(definition.version,            7);
+    QCOMPARE(definition.model,              QStringLiteral("SD II"));
+    QCOMPARE(definition.vendor,             QStringLiteral("Super Dupper Industries"));
+    QCOMPARE(definition.parameters.count(), 2);
+
+    const QGCCameraDefinition::Parameter_t& mode = definition.parameters[0];
+    QCOMPARE(mode.name,             QStringLiteral("CAM_MODE"));
+    QCOMPARE(mode.type,             FactMetaData::valueTypeUint32);
+    QCOMPARE(mode.control,          true);
+    QCOMPARE(mode.description,      QStringLiteral("Camera Mode"));
+    QCOMPARE(mode.defaultValue,     QStringLiteral("1"));
+    QCOMPARE(mode.updates,          QStringList({ QStringLiteral("CAM_ISO") }));
+    QCOMPARE(mode.options.count(),  2);
+    QCOMPARE(mode.options[0].name,          QStringLiteral("Photo"));
+    QCOMPARE(mode.options[0].exclusions,    QStringList({ QStringLiteral("CAM_VIDRES") }));
+    QCOMPARE(mode.options[1].value,         QStringLiteral("1"));
+    QCOMPARE(mode.options[1].ranges.count(),        1);
+    QCOMPARE(mode.options[1].ranges[0].targetParam, QStringLiteral("CAM_ISO"));
+    QCOMPARE(mode.options[1].ranges[0].condition,   QStringLiteral("CAM_EXPMODE=1"));
+    QCOMPARE(mode.options[1].ranges[0].optValues,   QStringList({ QStringLiteral("100"), QStringLiteral("200") }));
+
+    const QGCCameraDefinition::Parameter_t& iso = definition.parameters[1];
+    QCOMPARE(iso.control,   false);
+    QCOMPARE(iso.min,       QStringLiteral("100"));
+    QCOMPARE(iso.max,       QStringLiteral("3200"));
+    QVERIFY(iso.step.isEmpty());
+    QVERIFY(iso.options.isEmpty());
+}
+
+void QGCCameraDefinitionTest::_translate_test(void)
+{
+    QGCCameraDefinition definition;
+    QString             errorString;
+
+    // pt_pt has no direct match and falls back to the first Portuguese locale
+    QVERIFY2(definition.parse(QByteArray(kDefinition), QStringLiteral("pt_pt"), errorString), qPrintable(errorString));
+    QCOMPARE(definition.parameters[0].description,      QString::fromUtf8("Modo de Operação"));
+    QCOMPARE(definition.parameters[0].options[1].name,  QString::fromUtf8("Vídeo"));
+    QCOMPARE(definition.parameters[0].options[0].name,  QStringLiteral("Photo"));
+}
+
+void QGCCameraDefinitionTest::_malformed_test(void)
+{
+    QGCCameraDefinition definition;
+    QString             errorString;
+
+    // Not well formed
+    QByteArray bytes(kDefinition);
+    bytes.truncate(bytes.indexOf("</parameters>"));
+    QVERIFY(!definition.parse(bytes, QStringLiteral("en_us"), errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    // Option without a value
+    bytes = QByteArray(kDefinition).replace("<option name=\"Photo\" value=\"0\">", "<option name=\"Photo\">");
+    errorString.clear();
+    QVERIFY(!definition.parse(bytes, QStringLiteral("en_us"), errorString));
+    QVERIFY(errorString.contains(QStringLiteral("CAM_MODE")));
+
+    // Unknown type
+    bytes = QByteArray(kDefinition).replace("type=\"uint32\" min", "type=\"bogus\" min");
+    errorString.clear();
+    QVERIFY(!definition.parse(bytes, QStringLiteral("en_us"), errorString));
+    QVERIFY(errorString.contains(QStringLiteral("CAM_ISO")));
+}
+
+void QGCCameraDefinitionTest::_compiled_test(void)
+{
+    QTemporaryDir   dir;
+    const QString   filename    = dir.filePath(QStringLiteral("camera.qgccam"));
+    const QString   uri         = QStringLiteral("http://example.com/camera.xml");
+    QString         errorString;
+
+    QGCCameraDefinition parsed;
+    QVERIFY2(parsed.parse(QByteArray(kDefinition), QStringLiteral("en_us"), errorString), qPrintable(errorString));
+    QVERIFY(parsed.save(filename, uri, 3, QStringLiteral("en_us")));
+
+    QGCCameraDefinition loaded;
+    QVERIFY(loaded.load(filename, uri, 3, QStringLiteral("en_us")));
+    QCOMPARE(loaded.version,            parsed.version);
+    QCOMPARE(loaded.model,              parsed.model);
+    QCOMPARE(loaded.vendor,             parsed.vendor);
+    QCOMPARE(loaded.parameters.count(), parsed.parameters.count());
+    for (int i = 0; i < parsed.parameters.count(); i++) {
+        QCOMPARE(loaded.parameters[i].name,             parsed.parameters[i].name);
+        QCOMPARE(loaded.parameters[i].type,             parsed.parameters[i].type);
+        QCOMPARE(loaded.parameters[i].control,          parsed.parameters[i].control);
+        QCOMPARE(loaded.parameters[i].updates,          parsed.parameters[i].updates);
+        QCOMPARE(loaded.parameters[i].min,              parsed.parameters[i].min);
+        QCOMPARE(loaded.parameters[i].options.count(),  parsed.parameters[i].options.count());
+    }
+    QCOMPARE(loaded.parameters[0].options[1].ranges[0].optNames, parsed.parameters[0].options[1].ranges[0].optNames);
+
+    // A different uri, version or locale needs a new parse
+    QGCCameraDefinition stale;
+    QVERIFY(!stale.load(filename, QStringLiteral("http://example.com/other.xml"), 3, QStringLiteral("en_us")));
+    QVERIFY(!stale.load(filename, uri, 4, QStringLiteral("en_us")));
+    QVERIFY(!stale.load(filename, uri, 3, QStringLiteral("pt_br")));
+    QVERIFY(stale.parameters.isEmpty());
+}
@@ -0,0 +1,24 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for QGCCameraDefinition
+class QGCCameraDefinitionTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _parse_test        (void);
+    void _translate_test    (void);
+    void _malformed_test    (void);
+    void _compiled_test     (void);
+};
@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCInstrumentationTest.h"
+#include "QGCInstrumentation.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+void QGCInstrumentationTest::_counterGauge_test(void)
+{
+    QGCInstrumentCounter    counter ("Test.Counter");
+    QGCInstrumentGauge      gauge   ("Test.Gauge");
+
+    counter.add();
+    counter.add(41);
+    QCOMPARE(counter.value(), 42ull);
+
+    gauge.set(7);
+    gauge.set(-3);
+    QCOMPARE(gauge.value(), -3ll);
+
+    counter.reset();
+    gauge.reset();
+    QCOMPARE(counter.value(), 0ull);
+    QCOMPARE(gauge.value(), 0ll);
+}
+
+void QGCInstrumentationTest::_histogram_test(void)
+{
+    QGCInstrumentHistogram histogram("Test.Histogram");
+
+    QCOMPARE(histogram.percentileUSecs(50), 0ull);
+
+    // 90 fast samples in the 10us bucket and 10 slow ones in the 5ms bucket
+    for (int i=0; i<90; i++) {
+        histogram.add(5);
+    }
+    for (int i=0; i<10; i++) {
+        histogram.add(4000);
+    }
+
+    QCOMPARE(histogram.count(),             100ull);
+    QCOMPARE(histogram.maxUSecs(),          4000ull);
+    QCOMPARE(histogram.meanUSecs(),         (90ull * 5 + 10ull * 4000) / 100);
+    QCOMPARE(histogram.bucketSamples(0),    90ull);
+    QCOMPARE(histogram.percentileUSecs(50), 10ull);
+    QCOMPARE(histogram.percentileUSecs(90), 10ull);
+    // Clamped to the largest sample rather than the 5ms bucket boundary
+    QCOMPARE(histogram.percentileUSecs(95), 4000ull);
+
+    // Anything past the last boundary lands in the unbounded bucket
+    histogram.add(5000000);
+    QCOMPARE(histogram.bucketSamples(QGCInstrumentHistogram::bucketCount - 1), 1ull);
+    QCOMPARE(histogram.percentileUSecs(100), 5000000ull);
+
+    histogram.reset();
+    QCOMPARE(histogram.count(),     0ull);
+    QCOMPARE(histogram.maxUSecs(),  0ull);
+
+    {
+        QGC_INSTRUMENT_SCOPE(histogram);
+    }
+    QCOMPARE(histogram.count(), QGCInstrumentRegister::enabled() ? 1ull : 0ull);
+}
+
+void QGCInstrumentationTest::_register_test(void)
+{
+    QGCInstrumentRegister* instrumentRegister = QGCInstrumentRegister::instance();
+
+    {
+        QGCInstrumentCounter counter("Test.Registered");
+        QCOMPARE(instrumentRegister->instrument("Test.Registered"), &counter);
+
+        // Instruments are reported in name order
+        QString previousName;
+        for (const QGCInstrument* instrument: instrumentRegister->instruments()) {
+            QVERIFY(previousName < QString(instrument->name()));
+            previousName = instrument->name();
+        }
+
+        counter.add(3);
+        bool found = false;
+        for (const QVariant& var: instrumentRegister->snapshot()) {
+            QVariantMap map = var.toMap();
+            if (map["name"].toString() == QStringLiteral("Test.Registered")) {
+                QCOMPARE(map["kind"].toString(), QStringLiteral("counter"));
+                QCOMPARE(map["value"].toULongLong(), 3ull);
+                found = true;
+            }
+        }
+        QVERIFY(found);
+    }
+
+    QVERIFY(!instrumentRegister->instrument("Test.Registered"));
+}
+
+void QGCInstrumentationTest::_csvDump_test(void)
+{
+    QTemporaryDir           dir;
+    QString                 path = dir.filePath("perf.csv");
+    QGCInstrumentRegister*  instrumentRegister = QGCInstrumentRegister::instance();
+    QGCInstrumentHistogram  histogram("Test.Dump");
+
+    histogram.add(150);
+    QVERIFY(instrumentRegister->startDump(path, 60 * 1000));
+    QVERIFY(instrumentRegister->dumping());
+    instrumentRegister->dump();
+    instrumentRegister->stopDump();
+    QVERIFY(!instrumentRegister->dumping());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QStringList lines = QString(file.readAll()).split('\n');
+    QVERIFY(lines.count() > 1);
+    QVERIFY(lines[0].startsWith("timestamp,name,kind"));
+
+    // One row from the explicit dump and one from stopping
+    QStringList rows = lines.filter(",Test.Dump,");
+    QCOMPARE(rows.count(), 2);
+    QStringList fields = rows[0].split(',');
+    QCOMPARE(fields.count(), 10);
+    QCOMPARE(fields[2], QStringLiteral("histogram"));
+    QCOMPARE(fields[4], QStringLiteral("1"));
+    QCOMPARE(fields[9], QStringLiteral("150"));
+}
+
+void QGCInstrumentationTest::_jsonDump_test(void)
+{
+    QTemporaryDir           dir;
+    QString                 path = dir.filePath("perf.json");
+    QGCInstrumentRegister*  instrumentRegister = QGCInstrumentRegister::instance();
+    QGCInstrumentGauge      gauge("Test.Dump");
+
+    gauge.set(12);
+    QVERIFY(instrumentRegister->startDump(path, 60 * 1000));
+    instrumentRegister->stopDump();
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    QVERIFY(root.contains("timestamp"));
+
+    bool found = false;
+    for (const QJsonValue& value: root["instruments"].toArray()) {
+        QJsonObject instrument = value.toObject();
+        if (instrument["name"].toString() == QStringLiteral("Test.Dump")) {
+            QCOMPARE(instrument["kind"].toString(), QStringLiteral("gauge"));
+            QCOMPARE(instrument["value"].toInt(), 12);
+            found = true;
+        }
+    }
+    QVERIFY(found);
+}
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for QGCInstrumentation
+class QGCInstrumentationTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _counterGauge_test (void);
+    void _histogram_test    (void);
+    void _register_test     (void);
+    void _csvDump_test      (void);
+    void _jsonDump_test     (void);
+};
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCNetworkManagerTest.h"
+#include "QGCNetworkManager.h"
+
+#include <QTemporaryFile>
+
+static QNetworkRequest _fileRequest(QTemporaryFile& file)
+{
+    if (!file.isOpen()) {
+        file.open();
+        file.write("QGCNetworkManagerTest");
+        file.flush();
+    }
+    return QNetworkRequest(QUrl::fromLocalFile(file.fileName()));
+}
+
+void QGCNetworkManagerTest::_interactive_test(void)
+{
+    QGCNetworkManager*  manager = QGCNetworkManager::instance();
+    QTemporaryFile      file;
+    QNetworkReply*      reply   = nullptr;
+
+    // Interactive requests don't wait for the event loop
+    manager->queueGet(_fileRequest(file), QGCNetworkManager::PriorityInteractive, this, [&reply](QNetworkReply* startedReply) { reply = startedReply; });
+    QVERIFY(reply);
+    QCOMPARE(reply->request().priority(), QNetworkRequest::HighPriority);
+    QVERIFY(manager->activeCount() > 0);
+
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->readAll(), QByteArray("QGCNetworkManagerTest"));
+    delete reply;
+    QCOMPARE(manager->activeCount(), 0);
+}
+
+void QGCNetworkManagerTest::_backgroundLimit_test(void)
+{
+    QGCNetworkManager*  manager         = QGCNetworkManager::instance();
+    QTemporaryFile      file;
+    const int           requestCount    = 10;
+    int                 startedCount    = 0;
+    int                 finishedCount   = 0;
+    int                 maxBackground   = 0;
+
+    for (int i=0; i<requestCount; i++) {
+        manager->queueGet(_fileRequest(file), QGCNetworkManager::PriorityBackground, this, [&](QNetworkReply* reply) {
+            startedCount++;
+            maxBackground = qMax(maxBackground, manager->backgroundCount());
+            connect(reply, &QNetworkReply::finished, this, [&finishedCount, reply]() {
+                finishedCount++;
+                reply->deleteLater();
+            });
+        });
+    }
+    QCOMPARE(startedCount, 0);
+    QCOMPARE(manager->queuedCount(), requestCount);
+
+    QTRY_COMPARE(finishedCount, requestCount);
+    QCOMPARE(startedCount, requestCount);
+    QVERIFY(maxBackground > 0);
+    QVERIFY(maxBackground <= QGCNetworkManager::maxBackgroundRequests);
+    QCOMPARE(manager->queuedCount(), 0);
+    QTRY_COMPARE(manager->activeCount(), 0);
+}
+
+void QGCNetworkManagerTest::_contextDestroyed_test(void)
+{
+    QGCNetworkManager*  manager = QGCNetworkManager::instance();
+    QTemporaryFile      file;
+    QObject*            context = new QObject(this);
+    bool                started = false;
+
+    manager->queueGet(_fileRequest(file), QGCNetworkManager::PriorityNormal, context, [&started](QNetworkReply*) { started = true; });
+    delete context;
+
+    QTRY_COMPARE(manager->queuedCount(), 0);
+    QVERIFY(!started);
+    QCOMPARE(manager->activeCount(), 0);
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCSettingsWriteBackTest.h"
+#include "QGCSettingsWriteBack.h"
+
+#include <QSettings>
+
+void QGCSettingsWriteBackTest::_setValue_test(void)
+{
+    QGCSettingsWriteBack* writeBack = QGCSettingsWriteBack::instance();
+
+    writeBack->setValue(QStringLiteral("WriteBackTest"), QStringLiteral("Value"), 42);
+
+    // Visible to other QSettings before it hits the disk
+    {
+        QSettings settings;
+        QCOMPARE(settings.value(QStringLiteral("WriteBackTest/Value")).toInt(), 42);
+    }
+
+    // Debounced write on the worker thread
+    QTest::qWait(QGCSettingsWriteBack::debounceMSecs * 2);
+    writeBack->flush();
+
+    QSettings settings;
+    QCOMPARE(settings.value(QStringLiteral("WriteBackTest/Value")).toInt(), 42);
+    settings.remove(QStringLiteral("WriteBackTest"));
+}
+
+void QGCSettingsWriteBackTest::_batchedSettings_test(void)
+{
+    QGCSettingsWriteBack*   writeBack   = QGCSettingsWriteBack::instance();
+    QSettings&              batch       = writeBack->settings();
+
+    batch.beginGroup(QStringLiteral("WriteBackTest"));
+    for (int i = 0; i < 10; i++) {
+        batch.setValue(QStringLiteral("Key%1").arg(i), i);
+    }
+    batch.endGroup();
+    writeBack->scheduleFlush();
+    QVERIFY(batch.group().isEmpty());
+
+    writeBack->flush();
+
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("WriteBackTest"));
+    QCOMPARE(settings.childKeys().count(), 10);
+    QCOMPARE(settings.value(QStringLiteral("Key9")).toInt(), 9);
+    settings.endGroup();
+    settings.remove(QStringLiteral("WriteBackTest"));
+}
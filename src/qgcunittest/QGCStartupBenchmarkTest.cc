@@ -0,0 +1,65 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCStartupBenchmarkTest.h"
+#include "QGCStartupBenchmark.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+void QGCStartupBenchmarkTest::_mark_test(void)
+{
+    QGCStartupBenchmark benchmark(QString());
+
+    QCOMPARE(benchmark.milestoneMSecs(QGCStartupBenchmark::toolboxReadyMilestone), -1ll);
+
+    benchmark.mark(QGCStartupBenchmark::toolboxReadyMilestone);
+    qint64 first = benchmark.milestoneMSecs(QGCStartupBenchmark::toolboxReadyMilestone);
+    QVERIFY(first >= 0);
+
+    // Only the first time a milestone is reached counts
+    QTest::qWait(20);
+    benchmark.mark(QGCStartupBenchmark::toolboxReadyMilestone);
+    QCOMPARE(benchmark.milestoneMSecs(QGCStartupBenchmark::toolboxReadyMilestone), first);
+
+    benchmark.mark(QGCStartupBenchmark::firstFrameMilestone);
+    QVERIFY(benchmark.milestoneMSecs(QGCStartupBenchmark::firstFrameMilestone) >= first + 20);
+}
+
+void QGCStartupBenchmarkTest::_writeResults_test(void)
+{
+    QTemporaryDir       dir;
+    QString             path = dir.filePath("startup.json");
+    QGCStartupBenchmark benchmark(path);
+
+    benchmark.mark(QGCStartupBenchmark::toolboxReadyMilestone);
+    benchmark.mark(QGCStartupBenchmark::qmlEngineLoadedMilestone);
+    QVERIFY(benchmark.writeResults(true));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+
+    QVERIFY(root.contains("version"));
+    QVERIFY(root.contains("timestamp"));
+    QCOMPARE(root["timedOut"].toBool(), true);
+
+    QJsonArray milestones = root["milestones"].toArray();
+    QCOMPARE(milestones.count(), 2);
+    QCOMPARE(milestones[0].toString(), QString(QGCStartupBenchmark::toolboxReadyMilestone));
+    QCOMPARE(milestones[1].toString(), QString(QGCStartupBenchmark::qmlEngineLoadedMilestone));
+
+    QJsonObject milestoneMSecs = root["milestoneMSecs"].toObject();
+    QCOMPARE(static_cast<qint64>(milestoneMSecs[QGCStartupBenchmark::qmlEngineLoadedMilestone].toDouble()),
+             benchmark.milestoneMSecs(QGCStartupBenchmark::qmlEngineLoadedMilestone));
+    QVERIFY(!milestoneMSecs.contains(QGCStartupBenchmark::firstHeartbeatMilestone));
+}
@@ -0,0 +1,22 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for QGCStartupBenchmark
+class QGCStartupBenchmarkTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _mark_test         (void);
+    void _writeResults_test (void);
+};
@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QmlObjectListModelTest.h"
+#include "QmlObjectListModel.h"
+#include "QGCQGeoCoordinate.h"
+
+#include <QSignalSpy>
+
+QList<QObject*> QmlObjectListModelTest::_makeObjects(const QStringList& names)
+{
+    QList<QObject*> objects;
+    for (const QString& name: names) {
+        QObject* object = new QObject(this);
+        object->setObjectName(name);
+        objects.append(object);
+    }
+    return objects;
+}
+
+QStringList QmlObjectListModelTest::_names(QmlObjectListModel& model)
+{
+    QStringList names;
+    for (int i = 0; i < model.count(); i++) {
+        names.append(model[i]->objectName());
+    }
+    return names;
+}
+
+void QmlObjectListModelTest::_batchInsert_test(void)
+{
+    QmlObjectListModel model;
+    QSignalSpy spyInserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy spyCount(&model, &QmlObjectListModel::countChanged);
+
+    model.append(_makeObjects({ "a", "d" }));
+    model.insert(1, _makeObjects({ "b", "c" }));
+    QCOMPARE(_names(model), QStringList({ "a", "b", "c", "d" }));
+
+    // One row insertion per batch
+    QCOMPARE(spyInserted.count(), 2);
+    QCOMPARE(spyInserted[1][1].toInt(), 1);
+    QCOMPARE(spyInserted[1][2].toInt(), 2);
+    QCOMPARE(spyCount.count(), 2);
+}
+
+void QmlObjectListModelTest::_removeRange_test(void)
+{
+    QmlObjectListModel model;
+
+    model.append(_makeObjects({ "a", "b", "c", "d", "e" }));
+
+    QSignalSpy spyRemoved(&model, &QAbstractItemModel::rowsRemoved);
+    const QObjectList removed = model.removeRange(1, 3);
+    QCOMPARE(removed.count(), 3);
+    QCOMPARE(removed[0]->objectName(), QStringLiteral("b"));
+    QCOMPARE(_names(model), QStringList({ "a", "e" }));
+    QCOMPARE(spyRemoved.count(), 1);
+
+    QVERIFY(model.removeRange(1, 2).isEmpty());
+    QCOMPARE(model.count(), 2);
+}
+
+void QmlObjectListModelTest::_moveRange_test(void)
+{
+    QmlObjectListModel model;
+
+    model.append(_makeObjects({ "a", "b", "c", "d", "e" }));
+
+    QSignalSpy spyMoved(&model, &QAbstractItemModel::rowsMoved);
+    model.moveRange(0, 2, 3);
+    QCOMPARE(_names(model), QStringList({ "c", "d", "e", "a", "b" }));
+    model.moveRange(3, 2, 0);
+    QCOMPARE(_names(model), QStringList({ "a", "b", "c", "d", "e" }));
+    QCOMPARE(spyMoved.count(), 2);
+
+    // Out of range moves are ignored
+    model.moveRange(4, 2, 0);
+    QCOMPARE(_names(model), QStringList({ "a", "b", "c", "d", "e" }));
+}
+
+void QmlObjectListModelTest::_childDirty_test(void)
+{
+    QmlObjectListModel  model;
+    QGCQGeoCoordinate*  first   = new QGCQGeoCoordinate(QGeoCoordinate(47, 8), this);
+    QGCQGeoCoordinate*  second  = new QGCQGeoCoordinate(QGeoCoordinate(47, 9), this);
+
+    model.append(QList<QObject*>({ first, second }));
+    model.setDirty(false);
+
+    second->setDirty(true);
+    QVERIFY(model.dirty());
+    model.setDirty(false);
+
+    // Removed objects no longer affect the model
+    model.removeRange(0, 2);
+    model.setDirty(false);
+    first->setDirty(true);
+    QVERIFY(!model.dirty());
+}
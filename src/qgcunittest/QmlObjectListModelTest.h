@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QmlObjectListModel;
+
+/// Unit test for QmlObjectListModel
+class QmlObjectListModelTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _batchInsert_test  (void);
+    void _removeRange_test  (void);
+    void _moveRange_test    (void);
+    void _childDirty_test   (void);
+
+private:
+    QList<QObject*> _makeObjects    (const QStringList& names);
+    QStringList     _names          (QmlObjectListModel& model);
+};
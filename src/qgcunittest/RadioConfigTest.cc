@@ -429,6 +429,32 @@ void RadioConfigTest::_fullCalibration_apm_test(void)
     _fullCalibrationWorker(MAV_AUTOPILOT_ARDUPILOTMEGA);
 }
 
+void RadioConfigTest::_rcChannelsSnapshot_test(void)
+{
+    _init(MAV_AUTOPILOT_PX4);
+
+    const Vehicle::RcChannels_t&    rcChannels  = _vehicle->rcChannels();
+    quint32                         sequence    = rcChannels.sequence;
+
+    _mockLink->emitRemoteControlChannelRawChanged(2, 1200);
+    QVERIFY(QTest::qWaitFor([&]() { return rcChannels.sequence != sequence; }, 1000));
+    QCOMPARE(rcChannels.channelCount,   18);
+    QCOMPARE(rcChannels.pwmValues[2],   1200);
+    QCOMPARE(rcChannels.pwmValues[3],   -1);
+    QVERIFY(_vehicle->rcChannelsChangedMask(sequence) & (1 << 2));
+
+    // Same values again, nothing changed
+    sequence = rcChannels.sequence;
+    _mockLink->emitRemoteControlChannelRawChanged(2, 1200);
+    QVERIFY(QTest::qWaitFor([&]() { return rcChannels.sequence != sequence; }, 1000));
+    QCOMPARE(_vehicle->rcChannelsChangedMask(sequence), 0u);
+
+    sequence = rcChannels.sequence;
+    _mockLink->emitRemoteControlChannelRawChanged(2, 1800);
+    QVERIFY(QTest::qWaitFor([&]() { return rcChannels.sequence != sequence; }, 1000));
+    QCOMPARE(_vehicle->rcChannelsChangedMask(sequence), 1u << 2);
+}
+
 /// @brief Sets rc input to Throttle down home position. Centers all other channels.
 void RadioConfigTest::_channelHomePosition(void)
 {
@@ -37,6 +37,7 @@ private slots:
     
     void _fullCalibration_px4_test(void);
     void _fullCalibration_apm_test(void);
+    void _rcChannelsSnapshot_test(void);
 
 private:
     /// @brief Modes to run worker functions
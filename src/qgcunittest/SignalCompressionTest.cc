@@ -0,0 +1,100 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SignalCompressionTest.h"
+#include "QGCApplication.h"
+
+static const int _cBurst = 20;
+
+/// Emits a burst of queued signals while something else is already queued to the receiver, then delivers them
+void SignalCompressionTest::_emitBurst(SignalCompressionSender* sender, bool compressedSignal, QObject* receiver, QList<int>& values)
+{
+    auto signal = compressedSignal ? &SignalCompressionSender::compressedSignal : &SignalCompressionSender::otherSignal;
+    connect(sender, signal, receiver, [&values](int value) { values.append(value); }, Qt::QueuedConnection);
+
+    // Qt only offers events for compression once the receiver has something queued
+    QMetaObject::invokeMethod(receiver, []() { }, Qt::QueuedConnection);
+    for (int i = 0; i < _cBurst; i++) {
+        emit (sender->*signal)(i);
+    }
+    QCoreApplication::processEvents();
+}
+
+void SignalCompressionTest::_compress_test(void)
+{
+    qgcApp()->addCompressedSignal(&SignalCompressionSender::compressedSignal);
+
+    SignalCompressionSender sender;
+    QObject                 receiver;
+    QList<int>              values;
+
+    _emitBurst(&sender, true, &receiver, values);
+
+    QCOMPARE(values.count(), 1);
+    QCOMPARE(values.last(), _cBurst - 1);
+
+    qgcApp()->removeCompressedSignal(QMetaMethod::fromSignal(&SignalCompressionSender::compressedSignal));
+}
+
+void SignalCompressionTest::_uncompressed_test(void)
+{
+    qgcApp()->addCompressedSignal(&SignalCompressionSender::compressedSignal);
+
+    SignalCompressionSender sender;
+    QObject                 receiver;
+    QList<int>              values;
+
+    _emitBurst(&sender, false, &receiver, values);
+
+    QCOMPARE(values.count(), _cBurst);
+
+    qgcApp()->removeCompressedSignal(QMetaMethod::fromSignal(&SignalCompressionSender::compressedSignal));
+}
+
+void SignalCompressionTest::_subclass_test(void)
+{
+    // Registered on the declaring class, emitted by a subclass
+    qgcApp()->addCompressedSignal(&SignalCompressionSender::compressedSignal);
+
+    SignalCompressionSenderSubclass sender;
+    QObject                         receiver;
+    QList<int>                      values;
+
+    _emitBurst(&sender, true, &receiver, values);
+
+    QCOMPARE(values.count(), 1);
+    QCOMPARE(values.last(), _cBurst - 1);
+
+    qgcApp()->removeCompressedSignal(QMetaMethod::fromSignal(&SignalCompressionSender::compressedSignal));
+}
+
+void SignalCompressionTest::_deletedReceiver_test(void)
+{
+    qgcApp()->addCompressedSignal(&SignalCompressionSender::compressedSignal);
+
+    SignalCompressionSender sender;
+    QList<int>              values;
+
+    // Queued calls go away with the receiver, a new receiver must still get its calls
+    QObject* receiver = new QObject;
+    connect(&sender, &SignalCompressionSender::compressedSignal, receiver, [&values](int value) { values.append(value); }, Qt::QueuedConnection);
+    QMetaObject::invokeMethod(receiver, []() { }, Qt::QueuedConnection);
+    emit sender.compressedSignal(1);
+    emit sender.compressedSignal(2);
+    delete receiver;
+    QCoreApplication::processEvents();
+    QCOMPARE(values.count(), 0);
+
+    QObject newReceiver;
+    _emitBurst(&sender, true, &newReceiver, values);
+    QCOMPARE(values.count(), 1);
+    QCOMPARE(values.last(), _cBurst - 1);
+
+    qgcApp()->removeCompressedSignal(QMetaMethod::fromSignal(&SignalCompressionSender::compressedSignal));
+}
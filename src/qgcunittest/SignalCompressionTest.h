@@ -0,0 +1,41 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class SignalCompressionSender : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void compressedSignal   (int value);
+    void otherSignal        (int value);
+};
+
+class SignalCompressionSenderSubclass : public SignalCompressionSender
+{
+    Q_OBJECT
+};
+
+/// Unit test for QGCApplication signal compression
+class SignalCompressionTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _compress_test         (void);
+    void _uncompressed_test     (void);
+    void _subclass_test         (void);
+    void _deletedReceiver_test  (void);
+
+private:
+    void _emitBurst(SignalCompressionSender* sender, bool compressedSignal, QObject* receiver, QList<int>& values);
+};
@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogIndexTest.h"
+#include "TelemetryLogIndex.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+void TelemetryLogIndexTest::_appendEntry(QByteArray& log, quint64 timestampUSecs, const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    quint64 timestamp = qToBigEndian(timestampUSecs);
+
+    log.append(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+    log.append(reinterpret_cast<const char*>(buffer), mavlink_msg_to_send_buffer(buffer, &message));
+}
+
+/// One second of heartbeats from two vehicles, with position, attitude and battery from both
+QByteArray TelemetryLogIndexTest::_testLog(void)
+{
+    QByteArray          log;
+    mavlink_message_t   message;
+
+    for (int i = 0; i < _cPositions; i++) {
+        quint64 timestampUSecs = _startTimeUSecs + (static_cast<quint64>(i) * 5000);
+
+        if (i % 50 == 0) {
+            for (uint8_t sysid = 1; sysid <= 2; sysid++) {
+                mavlink_msg_heartbeat_pack_chan(sysid, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+                _appendEntry(log, timestampUSecs, message);
+                mavlink_msg_sys_status_pack_chan(sysid, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, 0, 0, 0, 0, 16000 + i, -1, 90, 0, 0, 0, 0, 0, 0);
+                _appendEntry(log, timestampUSecs, message);
+            }
+        }
+        mavlink_msg_global_position_int_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, 0, 473977420 + i, 85455940 - i, 488000 + (i * 10), i * 10, 0, 0, 0, 0);
+        _appendEntry(log, timestampUSecs, message);
+        mavlink_msg_global_position_int_pack_chan(2, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        _appendEntry(log, timestampUSecs, message);
+        mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, 0, 0.1f, -0.2f, 1.5f, 0, 0, 0);
+        _appendEntry(log, timestampUSecs + 1000, message);
+    }
+
+    return log;
+}
+
+void TelemetryLogIndexTest::_build_test(void)
+{
+    QTemporaryDir   tempDir;
+    QString         logFilename = tempDir.filePath("index.mavlink");
+    QByteArray      log         = _testLog();
+    QFile           logFile(logFilename);
+
+    QVERIFY(logFile.open(QIODevice::WriteOnly));
+    logFile.write(log);
+    logFile.close();
+
+    TelemetryLogIndex   index;
+    QString             errorString;
+    const uchar*        data = reinterpret_cast<const uchar*>(log.constData());
+
+    QVERIFY(index.open(logFilename, data, log.size(), errorString));
+    QVERIFY(QFile::exists(TelemetryLogIndex::indexFilename(logFilename)));
+
+    QCOMPARE(index.vehicleId(), 1);
+    QCOMPARE(index.startTimeUSecs(), _startTimeUSecs);
+    QCOMPARE(index.endTimeUSecs(), _startTimeUSecs + ((_cPositions - 1) * 5000) + 1000);
+
+    // Both vehicles are in the message offsets, only the first one is in the series
+    const int cEntries = (_cPositions * 3) + 16;
+    QCOMPARE(index.messageOffsets(MAVLINK_MSG_ID_GLOBAL_POSITION_INT).count(), _cPositions * 2);
+    QCOMPARE(index.messageOffsets(MAVLINK_MSG_ID_HEARTBEAT).count(), 8);
+    QCOMPARE(index.seekIndex().count(), ((cEntries - 1) / TelemetryLogIndex::seekStride) + 1);
+    QCOMPARE(index.messageIds(), QList<uint32_t>({ MAVLINK_MSG_ID_HEARTBEAT, MAVLINK_MSG_ID_SYS_STATUS, MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_GLOBAL_POSITION_INT }));
+
+    // Every offset points at an entry for the message
+    for (qint64 offset: index.messageOffsets(MAVLINK_MSG_ID_ATTITUDE)) {
+        quint64             timestampUSecs;
+        qint64              messageOffset;
+        qint64              nextOffset;
+        mavlink_message_t   message;
+        QVERIFY(TelemetryLogIndex::parseEntry(data, log.size(), offset, timestampUSecs, messageOffset, nextOffset, &message));
+        QCOMPARE(message.msgid, static_cast<uint32_t>(MAVLINK_MSG_ID_ATTITUDE));
+    }
+
+    QCOMPARE(index.sampleCount(TelemetryLogIndex::SeriesPosition), _cPositions);
+    QCOMPARE(index.sampleCount(TelemetryLogIndex::SeriesAttitude), _cPositions);
+    QCOMPARE(index.sampleCount(TelemetryLogIndex::SeriesBattery), 4);
+
+    QCOMPARE(index.value(TelemetryLogIndex::FieldLatitude, 10), 47.3977430);
+    QCOMPARE(index.value(TelemetryLogIndex::FieldLongitude, 10), 8.5455930);
+    QCOMPARE(index.value(TelemetryLogIndex::FieldAltitudeAMSL, 10), 488.1);
+    QCOMPARE(index.value(TelemetryLogIndex::FieldRelativeAltitude, 10), 0.1);
+    QCOMPARE(index.value(TelemetryLogIndex::FieldYaw, 0), 1.5);
+    QCOMPARE(index.value(TelemetryLogIndex::FieldPitch, 0), -0.2);
+    QCOMPARE(index.value(TelemetryLogIndex::FieldVoltage, 1), 16.05);
+    QVERIFY(qIsNaN(index.value(TelemetryLogIndex::FieldCurrent, 1)));
+    QCOMPARE(index.value(TelemetryLogIndex::FieldRemaining, 1), 90.0);
+
+    QCOMPARE(index.sampleIndex(TelemetryLogIndex::SeriesPosition, _startTimeUSecs - 1), -1);
+    QCOMPARE(index.sampleIndex(TelemetryLogIndex::SeriesPosition, _startTimeUSecs + 52000), 10);
+    QCOMPARE(index.sampleIndex(TelemetryLogIndex::SeriesAttitude, _startTimeUSecs + 6000), 1);
+    QCOMPARE(index.sampleTimeUSecs(TelemetryLogIndex::SeriesAttitude, 1), _startTimeUSecs + 6000);
+}
+
+void TelemetryLogIndexTest::_savedIndex_test(void)
+{
+    QTemporaryDir   tempDir;
+    QString         logFilename = tempDir.filePath("saved.mavlink");
+    QByteArray      log         = _testLog();
+    QFile           logFile(logFilename);
+
+    QVERIFY(logFile.open(QIODevice::WriteOnly));
+    logFile.write(log);
+    logFile.close();
+
+    TelemetryLogIndex   builtIndex;
+    TelemetryLogIndex   loadedIndex;
+    QString             errorString;
+    const uchar*        data = reinterpret_cast<const uchar*>(log.constData());
+
+    QVERIFY(builtIndex.open(logFilename, data, log.size(), errorString));
+
+    // Without the log contents the index can only come from the saved file
+    QVERIFY(loadedIndex.open(logFilename, nullptr, log.size(), errorString));
+    QCOMPARE(loadedIndex.startTimeUSecs(), builtIndex.startTimeUSecs());
+    QCOMPARE(loadedIndex.endTimeUSecs(), builtIndex.endTimeUSecs());
+    QCOMPARE(loadedIndex.vehicleId(), builtIndex.vehicleId());
+    QCOMPARE(loadedIndex.seekIndex().count(), builtIndex.seekIndex().count());
+    QCOMPARE(loadedIndex.seekIndex().last().offset, builtIndex.seekIndex().last().offset);
+    QCOMPARE(loadedIndex.messageIds(), builtIndex.messageIds());
+    QCOMPARE(loadedIndex.messageOffsets(MAVLINK_MSG_ID_SYS_STATUS), builtIndex.messageOffsets(MAVLINK_MSG_ID_SYS_STATUS));
+    for (int i = 0; i < TelemetryLogIndex::FieldCount; i++) {
+        TelemetryLogIndex::Field    field   = static_cast<TelemetryLogIndex::Field>(i);
+        TelemetryLogIndex::Series   series  = TelemetryLogIndex::fieldSeries(field);
+        QCOMPARE(loadedIndex.sampleCount(series), builtIndex.sampleCount(series));
+        for (int j = 0; j < builtIndex.sampleCount(series); j++) {
+            QCOMPARE(loadedIndex.sampleTimeUSecs(series, j), builtIndex.sampleTimeUSecs(series, j));
+            if (!qIsNaN(builtIndex.value(field, j))) {
+                QCOMPARE(loadedIndex.value(field, j), builtIndex.value(field, j));
+            }
+        }
+    }
+
+    // A log which changed size is indexed again
+    log.append(log.left(100));
+    QVERIFY(logFile.open(QIODevice::Append));
+    logFile.write(log.right(100));
+    logFile.close();
+    data = reinterpret_cast<const uchar*>(log.constData());
+    QVERIFY(loadedIndex.open(logFilename, data, log.size(), errorString));
+    QVERIFY(loadedIndex.messageOffsets(MAVLINK_MSG_ID_HEARTBEAT).count() > builtIndex.messageOffsets(MAVLINK_MSG_ID_HEARTBEAT).count());
+}
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+/// Unit test for TelemetryLogIndex
+class TelemetryLogIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _build_test        (void);
+    void _savedIndex_test   (void);
+
+private:
+    void _appendEntry   (QByteArray& log, quint64 timestampUSecs, const mavlink_message_t& message);
+    QByteArray _testLog (void);
+
+    static const quint64 _startTimeUSecs    = 1600000000000000ULL;
+    static const int     _cPositions        = 200;
+};
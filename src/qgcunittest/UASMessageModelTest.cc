@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UASMessageModelTest.h"
+#include "UASMessageHandler.h"
+#include "QGCMAVLink.h"
+
+#include <QSignalSpy>
+
+static UASMessage _message(int index)
+{
+    return UASMessage(1, MAV_SEVERITY_INFO, QString::number(index), false);
+}
+
+void UASMessageModelTest::_append_test(void)
+{
+    UASMessageModel model(10);
+    QSignalSpy      insertSpy(&model, &QAbstractItemModel::rowsInserted);
+
+    for (int i = 0; i < 5; i++) {
+        model.append(_message(i));
+    }
+    QCOMPARE(model.count(), 5);
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(insertSpy.count(), 5);
+
+    QModelIndex index = model.index(4);
+    QCOMPARE(model.data(index, UASMessageModel::TextRole).toString(), QStringLiteral("4"));
+    QCOMPARE(model.data(index, UASMessageModel::SeverityRole).toInt(), static_cast<int>(MAV_SEVERITY_INFO));
+
+    QString formattedText = model.data(index, UASMessageModel::FormattedTextRole).toString();
+    QVERIFY(formattedText.startsWith(QStringLiteral("<font style=\"<#N>\">")));
+    QVERIFY(formattedText.endsWith(QStringLiteral("Info: 4</font>")));
+    QCOMPARE(model.at(4).getFormatedText(), formattedText + QStringLiteral("<br/>"));
+}
+
+void UASMessageModelTest::_wrap_test(void)
+{
+    UASMessageModel model(10);
+    QSignalSpy      removeSpy(&model, &QAbstractItemModel::rowsRemoved);
+
+    for (int i = 0; i < 25; i++) {
+        model.append(_message(i));
+    }
+
+    // Only the most recent messages are kept, oldest first
+    QCOMPARE(model.count(), 10);
+    QCOMPARE(removeSpy.count(), 15);
+    for (int i = 0; i < 10; i++) {
+        QCOMPARE(model.at(i).getText(), QString::number(i + 15));
+        QCOMPARE(model.data(model.index(i), UASMessageModel::TextRole).toString(), QString::number(i + 15));
+    }
+    QVERIFY(!model.data(model.index(10), UASMessageModel::TextRole).isValid());
+}
+
+void UASMessageModelTest::_clear_test(void)
+{
+    UASMessageModel model(10);
+    QSignalSpy      countSpy(&model, &UASMessageModel::countChanged);
+
+    for (int i = 0; i < 15; i++) {
+        model.append(_message(i));
+    }
+    model.clear();
+    QCOMPARE(model.count(), 0);
+    QCOMPARE(countSpy.count(), 16);
+
+    model.append(_message(42));
+    QCOMPARE(model.count(), 1);
+    QCOMPARE(model.at(0).getText(), QStringLiteral("42"));
+}
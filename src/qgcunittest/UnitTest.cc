@@ -16,6 +16,7 @@
 #include "MockLink.h"
 #include "LinkManager.h"
 
+#include <QDir>
 #include <QRandomGenerator>
 #include <QTemporaryFile>
 #include <QTime>
@@ -84,6 +85,32 @@ int UnitTest::run(QString& singleTest)
     return ret;
 }
 
+int UnitTest::runBenchmarks(const QString& singleBenchmark, const QString& outputDir)
+{
+    int ret = 0;
+
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        qWarning() << "Unable to create benchmark output directory" << outputDir;
+        return 1;
+    }
+
+    for (UnitTest* test: _testList()) {
+        if (!test->benchmark() || (!singleBenchmark.isEmpty() && singleBenchmark != test->objectName())) {
+            continue;
+        }
+        QStringList args;
+        args << "*" << "-maxwarnings" << "0";
+        if (!outputDir.isEmpty()) {
+            // QTest writes one result row per benchmark function and data tag: name, tag, metric, value, total, iterations
+            args << "-o" << QStringLiteral("%1,csv").arg(QDir(outputDir).filePath(test->objectName() + QStringLiteral(".csv")));
+            args << "-o" << "-,txt";
+        }
+        ret += QTest::qExec(test, args);
+    }
+
+    return ret;
+}
+
 /// @brief Called before each test.
 ///         Make sure to call first in your derived class
 void UnitTest::init(void)
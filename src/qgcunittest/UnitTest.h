@@ -22,6 +22,7 @@
 
 #define UT_REGISTER_TEST(className)             static UnitTestWrapper<className> className(#className, false);
 #define UT_REGISTER_TEST_STANDALONE(className)  static UnitTestWrapper<className> className(#className, true);  // Test will only be run with specifically called to from command line
+#define UT_REGISTER_BENCHMARK(className)        static UnitTestWrapper<className> className(#className, true, true);  // Only run by --benchmark or when specifically called
 
 class QGCMessageBox;
 class QGCQFileDialog;
@@ -41,6 +42,12 @@ public:
     ///     @param singleTest Name of test to just run a single test
     static int run(QString& singleTest);
 
+    /// @brief Called to run the registered benchmarks
+    ///     @param singleBenchmark Name of benchmark to just run a single benchmark
+    ///     @param outputDir Directory to write a <name>.csv file of QBENCHMARK results to for each benchmark, empty for
+    ///                      console output only
+    static int runBenchmarks(const QString& singleBenchmark, const QString& outputDir);
+
     /// @brief Sets up for an expected QGCMessageBox
     ///     @param response Response to take on message box
     void setExpectedMessageBox(QMessageBox::StandardButton response);
@@ -79,6 +86,9 @@ public:
     bool standalone(void) { return _standalone; }
     void setStandalone(bool standalone) { _standalone = standalone; }
 
+    bool benchmark(void) { return _benchmark; }
+    void setBenchmark(bool benchmark) { _benchmark = benchmark; }
+
     /// @brief Adds a unit test to the list. Should only be called by UnitTestWrapper.
     static void _addTest(UnitTest* test);
 
@@ -196,16 +206,18 @@ private:
     bool _initCalled    = false;    ///< true: UnitTest::_init was called
     bool _cleanupCalled = false;    ///< true: UnitTest::_cleanup was called
     bool _standalone    = false;    ///< true: Only run when requested specifically from command line
+    bool _benchmark     = false;    ///< true: Benchmark, run by --benchmark
 };
 
 template <class T>
 class UnitTestWrapper {
 public:
-    UnitTestWrapper(const QString& name, bool standalone)
+    UnitTestWrapper(const QString& name, bool standalone, bool benchmark = false)
         : _unitTest(new T)
     {
         _unitTest->setObjectName(name);
         _unitTest->setStandalone(standalone);
+        _unitTest->setBenchmark(benchmark);
         UnitTest::_addTest(_unitTest.data());
     }
 
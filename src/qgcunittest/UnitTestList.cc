@@ -11,10 +11,28 @@
 // We keep the list of all unit tests in a global location so it's easier to see which
 // ones are enabled/disabled
 
+#include "FactGroupSchedulerTest.h"
 #include "FactSystemTestGeneric.h"
+#include "TelemetryFactTest.h"
 #include "FactSystemTestPX4.h"
 //#include "FileDialogTest.h"
+#include "ADSBTCPLinkTest.h"
+#include "ADSBVehicleManagerTest.h"
 #include "GeoTest.h"
+#include "LinkReceiveBufferTest.h"
+#include "LinkSendQueueTest.h"
+#include "MockLinkImpairmentTest.h"
+#include "MockLinkSwarmTest.h"
+#include "QGCCameraConditionTest.h"
+#include "QGCCameraDefinitionTest.h"
+#include "QGCInstrumentationTest.h"
+#include "QGCNetworkManagerTest.h"
+#include "QGCSettingsWriteBackTest.h"
+#include "QGCStartupBenchmarkTest.h"
+#include "SignalCompressionTest.h"
+#include "QmlObjectListModelTest.h"
+#include "TelemetryLogIndexTest.h"
+#include "UASMessageModelTest.h"
 //#include "MessageBoxTest.h"
 #include "MissionItemTest.h"
 #include "SimpleMissionItemTest.h"
@@ -30,6 +48,7 @@
 //#include "LogDownloadTest.h"
 #include "SendMavCommandWithSignallingTest.h"
 #include "SendMavCommandWithHandlerTest.h"
+#include "SensorStreamTapTest.h"
 #include "VisualMissionItemTest.h"
 #include "CameraSectionTest.h"
 #include "SpeedSectionTest.h"
@@ -47,18 +66,47 @@
 #include "FTPManagerTest.h"
 #include "MissionCommandTreeEditorTest.h"
 #include "VehicleLinkManagerTest.h"
+#include "CameraTriggerPointsTest.h"
+#include "FactTelemetryLogTest.h"
+#include "GPSRTKFactGroupTest.h"
+#include "MessageIntervalManagerTest.h"
 #include "LandingComplexItemTest.h"
+#include "MAVLinkIngestBenchmark.h"
+#include "HotPathBenchmark.h"
 
+UT_REGISTER_TEST(FactGroupSchedulerTest)
 UT_REGISTER_TEST(FactSystemTestGeneric)
 UT_REGISTER_TEST(FactSystemTestPX4)
+UT_REGISTER_TEST(TelemetryFactTest)
 //UT_REGISTER_TEST(FileDialogTest)
+UT_REGISTER_TEST(ADSBTCPLinkTest)
+UT_REGISTER_TEST(ADSBVehicleManagerTest)
 UT_REGISTER_TEST(GeoTest)
+UT_REGISTER_TEST(LinkReceiveBufferTest)
+UT_REGISTER_TEST(LinkSendQueueTest)
+UT_REGISTER_TEST(MockLinkImpairmentTest)
+UT_REGISTER_TEST(MockLinkSwarmTest)
+UT_REGISTER_TEST(QGCCameraConditionTest)
+UT_REGISTER_TEST(QGCCameraDefinitionTest)
+UT_REGISTER_TEST(QGCInstrumentationTest)
+UT_REGISTER_TEST(QGCNetworkManagerTest)
+UT_REGISTER_TEST(QGCSettingsWriteBackTest)
+UT_REGISTER_TEST(QGCStartupBenchmarkTest)
+UT_REGISTER_TEST(SignalCompressionTest)
+UT_REGISTER_TEST(QmlObjectListModelTest)
+UT_REGISTER_TEST(TelemetryLogIndexTest)
+UT_REGISTER_TEST(UASMessageModelTest)
 UT_REGISTER_TEST(VehicleLinkManagerTest)
 //UT_REGISTER_TEST(MessageBoxTest)
 UT_REGISTER_TEST(SendMavCommandWithSignallingTest)
 UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
+UT_REGISTER_TEST(SensorStreamTapTest)
 UT_REGISTER_TEST(RequestMessageTest)
 UT_REGISTER_TEST(FTPManagerTest)
+UT_REGISTER_TEST(CameraTriggerPointsTest)
+UT_REGISTER_TEST(FactTelemetryLogTest)
+UT_REGISTER_TEST(GPSRTKFactGroupTest)
+UT_REGISTER_TEST(MessageIntervalManagerTest)
 UT_REGISTER_TEST(MissionItemTest)
 UT_REGISTER_TEST(SimpleMissionItemTest)
 UT_REGISTER_TEST(MissionControllerTest)
@@ -84,6 +132,8 @@ UT_REGISTER_TEST(FWLandingPatternTest)
 UT_REGISTER_TEST(LandingComplexItemTest)
 
 UT_REGISTER_TEST_STANDALONE(MissionCommandTreeEditorTest)
+UT_REGISTER_BENCHMARK(MAVLinkIngestBenchmark)
+UT_REGISTER_BENCHMARK(HotPathBenchmark)
 
 // List of unit test which are currently disabled.
 // If disabling a new test, include reason in comment.
@@ -19,14 +19,16 @@
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 
-UASMessage::UASMessage(int componentid, int severity, QString text)
+UASMessage::UASMessage(int componentid, int severity, QString text, bool showComponent)
 {
-    _compId   = componentid;
-    _severity = severity;
-    _text     = text;
+    _compId         = componentid;
+    _severity       = severity;
+    _showComponent  = showComponent;
+    _time           = QTime::currentTime();
+    _text           = text;
 }
 
-bool UASMessage::severityIsError()
+bool UASMessage::severityIsError() const
 {
     switch (_severity) {
         case MAV_SEVERITY_EMERGENCY:
@@ -39,11 +41,152 @@ bool UASMessage::severityIsError()
     }
 }
 
+QString UASMessage::getSeverityText() const
+{
+    switch (_severity)
+    {
+    case MAV_SEVERITY_EMERGENCY:
+        return UASMessageHandler::tr(" EMERGENCY:");
+    case MAV_SEVERITY_ALERT:
+        return UASMessageHandler::tr(" ALERT:");
+    case MAV_SEVERITY_CRITICAL:
+        return UASMessageHandler::tr(" Critical:");
+    case MAV_SEVERITY_ERROR:
+        return UASMessageHandler::tr(" Error:");
+    case MAV_SEVERITY_WARNING:
+        return UASMessageHandler::tr(" Warning:");
+    case MAV_SEVERITY_NOTICE:
+        return UASMessageHandler::tr(" Notice:");
+    case MAV_SEVERITY_INFO:
+        return UASMessageHandler::tr(" Info:");
+    case MAV_SEVERITY_DEBUG:
+        return UASMessageHandler::tr(" Debug:");
+    default:
+        return QString();
+    }
+}
+
+QString UASMessage::getFormatedText() const
+{
+    // Color the output depending on the message severity. We have 3 distinct cases:
+    // 1: If we have an ERROR or worse, make it bigger, bolder, and highlight it red.
+    // 2: If we have a warning or notice, just make it bold and color it orange.
+    // 3: Otherwise color it the standard color, white.
+    QString style;
+    switch (_severity)
+    {
+    case MAV_SEVERITY_EMERGENCY:
+    case MAV_SEVERITY_ALERT:
+    case MAV_SEVERITY_CRITICAL:
+    case MAV_SEVERITY_ERROR:
+        style = QStringLiteral("<#E>");
+        break;
+    case MAV_SEVERITY_NOTICE:
+    case MAV_SEVERITY_WARNING:
+        style = QStringLiteral("<#I>");
+        break;
+    default:
+        style = QStringLiteral("<#N>");
+        break;
+    }
+
+    QString compString;
+    if (_showComponent) {
+        compString = QString(" COMP:%1").arg(_compId);
+    }
+    return QString("<font style=\"%1\">[%2%3]%4 %5</font><br/>").arg(style).arg(_time.toString("hh:mm:ss.zzz")).arg(compString).arg(getSeverityText()).arg(_text);
+}
+
+UASMessageModel::UASMessageModel(int capacity, QObject* parent)
+    : QAbstractListModel(parent)
+    , _ring             (qMax(capacity, 1))
+{
+
+}
+
+void UASMessageModel::append(const UASMessage& message)
+{
+    if (_count == _ring.count()) {
+        beginRemoveRows(QModelIndex(), 0, 0);
+        _first = (_first + 1) % _ring.count();
+        _count--;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), _count, _count);
+    _ring[(_first + _count) % _ring.count()] = message;
+    _count++;
+    endInsertRows();
+
+    emit countChanged(_count);
+}
+
+void UASMessageModel::clear(void)
+{
+    if (_count == 0) {
+        return;
+    }
+
+    beginResetModel();
+    for (int i = 0; i < _ring.count(); i++) {
+        _ring[i] = UASMessage();
+    }
+    _first = 0;
+    _count = 0;
+    endResetModel();
+
+    emit countChanged(_count);
+}
+
+int UASMessageModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : _count;
+}
+
+QVariant UASMessageModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= _count) {
+        return QVariant();
+    }
+
+    const UASMessage& message = at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return message.getText();
+    case FormattedTextRole:
+    {
+        QString formattedText = message.getFormatedText();
+        formattedText.chop(5);  // <br/>
+        return formattedText;
+    }
+    case SeverityRole:
+        return message.getSeverity();
+    case ComponentIdRole:
+        return message.getComponentID();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> UASMessageModel::roleNames(void) const
+{
+    QHash<int, QByteArray> roles;
+
+    roles[TextRole]             = "text";
+    roles[FormattedTextRole]    = "formattedText";
+    roles[SeverityRole]         = "severity";
+    roles[ComponentIdRole]      = "componentId";
+
+    return roles;
+}
+
 UASMessageHandler::UASMessageHandler(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
     , _activeVehicle(nullptr)
     , _activeComponent(-1)
     , _multiComp(false)
+    , _messages(_maxMessages)
     , _errorCount(0)
     , _errorCountTotal(0)
     , _warningCount(0)
@@ -72,11 +215,8 @@ void UASMessageHandler::setToolbox(QGCToolbox *toolbox)
 
 void UASMessageHandler::clearMessages()
 {
+    _messages.clear();
     _mutex.lock();
-    while(_messages.count()) {
-        delete _messages.last();
-        _messages.pop_back();
-    }
     _errorCount   = 0;
     _warningCount = 0;
     _normalCount  = 0;
@@ -110,11 +250,6 @@ void UASMessageHandler::handleTextMessage(int, int compId, int severity, QString
         return;
     }
 
-    // Color the output depending on the message severity. We have 3 distinct cases:
-    // 1: If we have an ERROR or worse, make it bigger, bolder, and highlight it red.
-    // 2: If we have a warning or notice, just make it bold and color it orange.
-    // 3: Otherwise color it the standard color, white.
-
     _mutex.lock();
 
     if (_activeComponent < 0) {
@@ -125,84 +260,36 @@ void UASMessageHandler::handleTextMessage(int, int compId, int severity, QString
         _multiComp = true;
     }
 
-    // So first determine the styling based on the severity.
-    QString style;
+    UASMessage message(compId, severity, text, _multiComp);
+
     switch (severity)
     {
     case MAV_SEVERITY_EMERGENCY:
     case MAV_SEVERITY_ALERT:
     case MAV_SEVERITY_CRITICAL:
     case MAV_SEVERITY_ERROR:
-        style = QString("<#E>");
         _errorCount++;
         _errorCountTotal++;
+        _latestError = message.getSeverityText() + " " + text;
         break;
     case MAV_SEVERITY_NOTICE:
     case MAV_SEVERITY_WARNING:
-        style = QString("<#I>");
         _warningCount++;
         break;
     default:
-        style = QString("<#N>");
         _normalCount++;
         break;
     }
 
-    // And determine the text for the severitie
-    QString severityText;
-    switch (severity)
-    {
-    case MAV_SEVERITY_EMERGENCY:
-        severityText = tr(" EMERGENCY:");
-        break;
-    case MAV_SEVERITY_ALERT:
-        severityText = tr(" ALERT:");
-        break;
-    case MAV_SEVERITY_CRITICAL:
-        severityText = tr(" Critical:");
-        break;
-    case MAV_SEVERITY_ERROR:
-        severityText = tr(" Error:");
-        break;
-    case MAV_SEVERITY_WARNING:
-        severityText = tr(" Warning:");
-        break;
-    case MAV_SEVERITY_NOTICE:
-        severityText = tr(" Notice:");
-        break;
-    case MAV_SEVERITY_INFO:
-        severityText = tr(" Info:");
-        break;
-    case MAV_SEVERITY_DEBUG:
-        severityText = tr(" Debug:");
-        break;
-    default:
-        break;
-    }
-
-    // Finally preppend the properly-styled text with a timestamp.
-    QString dateString = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    UASMessage* message = new UASMessage(compId, severity, text);
-    QString compString;
-    if (_multiComp) {
-        compString = QString(" COMP:%1").arg(compId);
-    }
-    message->_setFormatedText(QString("<font style=\"%1\">[%2%3]%4 %5</font><br/>").arg(style).arg(dateString).arg(compString).arg(severityText).arg(text));
-
-    if (message->severityIsError()) {
-        _latestError = severityText + " " + text;
-    }
-
     _mutex.unlock();
 
-    emit textMessageReceived(message);
-
+    // Formatting is left to whoever displays the message
     _messages.append(message);
-    int count = _messages.count();
-    emit textMessageCountChanged(count);
+    emit textMessageReceived(&message);
+    emit textMessageCountChanged(_messages.count());
 
-    if (_showErrorsInToolbar && message->severityIsError()) {
-        _app->showCriticalVehicleMessage(message->getText());
+    if (_showErrorsInToolbar && message.severityIsError()) {
+        _app->showCriticalVehicleMessage(message.getText());
     }
 }
 
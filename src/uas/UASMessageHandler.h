@@ -10,8 +10,10 @@
 #pragma once
 
 #include <QObject>
+#include <QAbstractListModel>
 #include <QVector>
 #include <QMutex>
+#include <QTime>
 
 #include "QGCToolbox.h"
 
@@ -23,39 +25,86 @@ class QGCApplication;
 /*!
  * @class UASMessage
  * @brief Message element
+ *
+ * Plain value, the html formatted text is only built when it is asked for.
  */
 class UASMessage
 {
     friend class UASMessageHandler;
 public:
+    UASMessage(void) = default;
+    UASMessage(int componentid, int severity, QString text, bool showComponent);
+
     /**
      * @brief Get message source component ID
      */
-    int getComponentID()        { return _compId; }
+    int getComponentID() const  { return _compId; }
     /**
      * @brief Get message severity (from MAV_SEVERITY_XXX enum)
      */
-    int getSeverity()           { return _severity; }
+    int getSeverity() const     { return _severity; }
     /**
      * @brief Get message text (e.g. "[pm] sending list")
      */
-    QString getText()           { return _text; }
+    QString getText() const     { return _text; }
     /**
      * @brief Get (html) formatted text (in the form: "[11:44:21.137 - COMP:50] Info: [pm] sending list")
      */
-    QString getFormatedText()   { return _formatedText; }
+    QString getFormatedText() const;
     /**
      * @return true: This message is a of a severity which is considered an error
      */
-    bool severityIsError();
+    bool severityIsError() const;
+    /**
+     * @brief Get severity text (e.g. " Warning:")
+     */
+    QString getSeverityText() const;
 
 private:
-    UASMessage(int componentid, int severity, QString text);
-    void _setFormatedText(const QString formatedText) { _formatedText = formatedText; }
-    int _compId;
-    int _severity;
+    int     _compId         = 0;
+    int     _severity       = 0;
+    bool    _showComponent  = false;    ///< Messages came from multiple components when this one was received
+    QTime   _time;
     QString _text;
-    QString _formatedText;
+};
+
+/// Bounded list of the most recent messages, oldest first. Rows are formatted when a view asks for them.
+class UASMessageModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    UASMessageModel(int capacity, QObject* parent = nullptr);
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+    enum Roles {
+        TextRole = Qt::UserRole + 1,
+        FormattedTextRole,          ///< Html, without the trailing line break of getFormatedText
+        SeverityRole,
+        ComponentIdRole,
+    };
+
+    int                 count       (void) const { return _count; }
+    int                 capacity    (void) const { return _ring.count(); }
+    const UASMessage&   at          (int index) const { return _ring[(_first + index) % _ring.count()]; }
+
+    /// Adds the message at the end, dropping the oldest if the model is full
+    void append (const UASMessage& message);
+    void clear  (void);
+
+    // Overrides from QAbstractListModel
+    int                     rowCount    (const QModelIndex& parent = QModelIndex()) const override;
+    QVariant                data        (const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray>  roleNames   (void) const override;
+
+signals:
+    void countChanged(int count);
+
+private:
+    QVector<UASMessage> _ring;
+    int                 _first = 0;     ///< Ring index of row 0
+    int                 _count = 0;
 };
 
 class UASMessageHandler : public QGCTool
@@ -67,17 +116,9 @@ public:
     ~UASMessageHandler();
 
     /**
-     * @brief Locks access to the message list
-     */
-    void lockAccess()   {_mutex.lock(); }
-    /**
-     * @brief Unlocks access to the message list
+     * @brief Access to the most recent messages
      */
-    void unlockAccess() {_mutex.unlock(); }
-    /**
-     * @brief Access to the message list
-     */
-    const QVector<UASMessage*>& messages() { return _messages; }
+    UASMessageModel* messages() { return &_messages; }
     /**
      * @brief Clear messages
      */
@@ -122,7 +163,7 @@ public slots:
 signals:
     /**
      * @brief Sent out when new message arrives
-     * @param message A pointer to the message. NULL if resetting (new UAS assigned)
+     * @param message A pointer to the message, only valid while the signal is delivered. NULL if resetting (new UAS assigned)
      */
     void textMessageReceived(UASMessage* message);
     /**
@@ -138,7 +179,7 @@ private:
     Vehicle*                _activeVehicle;
     int                     _activeComponent;
     bool                    _multiComp;
-    QVector<UASMessage*>    _messages;
+    UASMessageModel         _messages;
     QMutex                  _mutex;
     int                     _errorCount;
     int                     _errorCountTotal;
@@ -147,5 +188,7 @@ private:
     QString                 _latestError;
     bool                    _showErrorsInToolbar;
     MultiVehicleManager*    _multiVehicleManager;
+
+    static const int _maxMessages = 1000;
 };
 
@@ -127,7 +127,7 @@ ApplicationWindow {
         toolDrawer.visible      = false
         toolDrawer.toolSource   = ""
         flightView.visible      = false
-        planView.visible        = false
+        planViewLoader.visible  = false
         toolbar.currentToolbar  = currentToolbar
     }
 
@@ -140,8 +140,11 @@ ApplicationWindow {
     }
 
     function showPlanView() {
+        // The plan view toolbar needs the plan view, so finish the load here if idle preloading hasn't yet
+        planViewLoader.active       = true
+        planViewLoader.asynchronous = false
         viewSwitch(toolbar.planViewToolbar)
-        planView.visible = true
+        planViewLoader.visible = true
     }
 
     function showTool(toolTitle, toolSource, toolIcon) {
@@ -471,10 +474,30 @@ ApplicationWindow {
         anchors.fill:   parent
     }
 
-    PlanView {
-        id:             planView
-        anchors.fill:   parent
-        visible:        false
+    // The plan view and the tool drawer pages aren't needed for the first frame. They are loaded in the background once
+    // the fly view is up so switching to them later only has to show them.
+    Loader {
+        id:                 planViewLoader
+        anchors.fill:       parent
+        visible:            false
+        active:             false
+        asynchronous:       true
+        sourceComponent:    Component { PlanView { } }
+    }
+
+    property var _preloadedToolComponents: [] ///< Keeps the compiled tool drawer pages in the component cache
+
+    Timer {
+        id:         idlePreloadTimer
+        interval:   1000
+        running:    true
+        onTriggered: {
+            planViewLoader.active = true
+            var toolSources = [ "AnalyzeView.qml", "SetupView.qml", "AppSettings.qml" ]
+            for (var i = 0; i < toolSources.length; i++) {
+                _preloadedToolComponents.push(Qt.createComponent(toolSources[i], Component.Asynchronous))
+            }
+        }
     }
 
     Drawer {
@@ -559,6 +582,7 @@ ApplicationWindow {
             anchors.right:  parent.right
             anchors.top:    toolDrawerToolbar.bottom
             anchors.bottom: parent.bottom
+            asynchronous:   true
 
             Connections {
                 target:                 toolDrawerLoader.item
@@ -566,6 +590,12 @@ ApplicationWindow {
                 onPopout:               toolDrawer.visible = false
             }
         }
+
+        BusyIndicator {
+            anchors.centerIn:   toolDrawerLoader
+            running:            toolDrawerLoader.status === Loader.Loading
+            visible:            running
+        }
     }
 
     //-------------------------------------------------------------------------
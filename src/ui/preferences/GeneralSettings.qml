@@ -43,6 +43,7 @@ Rectangle {
     property string _mapProvider:               QGroundControl.settingsManager.flightMapSettings.mapProvider.value
     property string _mapType:                   QGroundControl.settingsManager.flightMapSettings.mapType.value
     property Fact   _followTarget:              QGroundControl.settingsManager.appSettings.followTarget
+    property Fact   _followTargetMaxRate:       QGroundControl.settingsManager.appSettings.followTargetMaxRate
     property real   _panelWidth:                _root.width * _internalWidthRatio
     property real   _margins:                   ScreenTools.defaultFontPixelWidth
     property var    _planViewSettings:          QGroundControl.settingsManager.planViewSettings
@@ -313,6 +314,28 @@ Rectangle {
                                     visible:                _showSaveVideoSettings && _videoSettings.enableStorageLimit.value && maxSavedVideoStorageLabel.visible
                                 }
 
+                                QGCLabel {
+                                    id:         recordingSegmentSizeLabel
+                                    text:       qsTr("Max Recording File Size")
+                                    visible:    _showSaveVideoSettings && _videoSettings.recordingSegmentSize.visible
+                                }
+                                FactTextField {
+                                    Layout.preferredWidth:  _comboFieldWidth
+                                    fact:                   _videoSettings.recordingSegmentSize
+                                    visible:                recordingSegmentSizeLabel.visible
+                                }
+
+                                QGCLabel {
+                                    id:         recordingSegmentLengthLabel
+                                    text:       qsTr("Max Recording File Length")
+                                    visible:    _showSaveVideoSettings && _videoSettings.recordingSegmentLength.visible
+                                }
+                                FactTextField {
+                                    Layout.preferredWidth:  _comboFieldWidth
+                                    fact:                   _videoSettings.recordingSegmentLength
+                                    visible:                recordingSegmentLengthLabel.visible
+                                }
+
                                 QGCLabel {
                                     id:         videoDecodeLabel
                                     text:       qsTr("Video decode priority")
@@ -346,6 +369,13 @@ Rectangle {
                                     fact:       _videoSettings.enableStorageLimit
                                     visible:    _showSaveVideoSettings && fact.visible
                                 }
+
+                                Item { width: 1; height: 1}
+                                FactCheckBox {
+                                    text:       qsTr("Embed Telemetry (ts only)")
+                                    fact:       _videoSettings.recordingMetadata
+                                    visible:    _showSaveVideoSettings && _isGst && fact.visible
+                                }
                             }
                         }
                     }
@@ -386,6 +416,12 @@ Rectangle {
                                     Layout.preferredWidth:  _valueFieldWidth
                                     fact:                   QGroundControl.settingsManager.planViewSettings.vtolTransitionDistance
                                 }
+
+                                QGCLabel { text: qsTr("Polygon Import Tolerance") }
+                                FactTextField {
+                                    Layout.preferredWidth:  _valueFieldWidth
+                                    fact:                   QGroundControl.settingsManager.planViewSettings.shapeImportSimplifyTolerance
+                                }
                             }
 
                             FactCheckBox {
@@ -535,6 +571,15 @@ Rectangle {
                                     indexModel:             false
                                     visible:                _followTarget.visible
                                 }
+                                QGCLabel {
+                                    text:                   qsTr("Max GCS Position Rate")
+                                    visible:                _followTargetMaxRate.visible && _followTarget.rawValue !== 0
+                                }
+                                FactTextField {
+                                    Layout.preferredWidth:  _comboFieldWidth
+                                    fact:                   _followTargetMaxRate
+                                    visible:                _followTargetMaxRate.visible && _followTarget.rawValue !== 0
+                                }
                                 QGCLabel {
                                     text:                           qsTr("UI Scaling")
                                     visible:                        _appFontPointSize.visible
@@ -653,6 +698,30 @@ Rectangle {
 
                                     property Fact _fact: QGroundControl.settingsManager.appSettings.useComponentInformationQuery
                                 }
+
+                                FactCheckBox {
+                                    text:       _fact.shortDescription
+                                    fact:       _fact
+                                    visible:    _fact.visible
+
+                                    property Fact _fact: QGroundControl.settingsManager.appSettings.useMissionFTP
+                                }
+
+                                FactCheckBox {
+                                    text:       _fact.shortDescription
+                                    fact:       _fact
+                                    visible:    _fact.visible
+
+                                    property Fact _fact: QGroundControl.settingsManager.appSettings.useParamFTP
+                                }
+
+                                FactCheckBox {
+                                    text:       _fact.shortDescription
+                                    fact:       _fact
+                                    visible:    _fact.visible
+
+                                    property Fact _fact: QGroundControl.settingsManager.appSettings.fleetMode
+                                }
                             }
                         }
 
@@ -730,6 +799,29 @@ Rectangle {
                                 enabled:    !_disableAllDataPersistence
                                 property Fact _saveCsvTelemetry: QGroundControl.settingsManager.appSettings.saveCsvTelemetry
                             }
+                            RowLayout {
+                                visible:    promptSaveCsv.visible
+
+                                QGCLabel { text: qsTr("CSV log rate") }
+                                FactComboBox {
+                                    fact:           QGroundControl.settingsManager.appSettings.csvTelemetryRate
+                                    indexModel:     false
+                                    enabled:        promptSaveCsv.checked && !_disableAllDataPersistence
+                                }
+                                QGCButton {
+                                    text:       qsTr("Export CSV...")
+                                    visible:    !ScreenTools.isMobile
+                                    onClicked:  csvExportDialog.openForLoad()
+                                    QGCFileDialog {
+                                        id:             csvExportDialog
+                                        title:          qsTr("Select telemetry log to export as CSV")
+                                        folder:         QGroundControl.settingsManager.appSettings.telemetrySavePath
+                                        nameFilters:    [ qsTr("Telemetry logs (*.qgctl)") ]
+                                        selectExisting: true
+                                        onAcceptedForLoad: QGroundControl.exportTelemetryLogToCsv(file)
+                                    }
+                                }
+                            }
                         }
                     }
 
@@ -323,6 +323,27 @@ Rectangle {
                                         checked = editConfig.highLatency
                                 }
                             }
+                            Row {
+                                spacing:        ScreenTools.defaultFontPixelWidth
+                                QGCLabel {
+                                    text:       qsTr("Outbound Limit (bytes/sec, 0 = none):")
+                                    anchors.verticalCenter: parent.verticalCenter
+                                }
+                                QGCTextField {
+                                    width:      _firstColumn
+                                    inputMethodHints: Qt.ImhDigitsOnly
+                                    anchors.verticalCenter: parent.verticalCenter
+                                    onEditingFinished: {
+                                        if(editConfig) {
+                                            editConfig.txRateLimit = parseInt(text)
+                                        }
+                                    }
+                                    Component.onCompleted: {
+                                        if(editConfig)
+                                            text = editConfig.txRateLimit.toString()
+                                    }
+                                }
+                            }
                         }
                     }
                     Item {
@@ -0,0 +1,53 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+import QtQuick          2.3
+import QtQuick.Controls 1.2
+
+import QGroundControl                       1.0
+import QGroundControl.Controls              1.0
+import QGroundControl.ScreenTools           1.0
+import QGroundControl.Palette               1.0
+
+Column {
+    id:                 localSocketLinkSettings
+    spacing:            ScreenTools.defaultFontPixelHeight * 0.5
+    anchors.margins:    ScreenTools.defaultFontPixelWidth
+    function saveSettings() {
+        if(subEditConfig) {
+            subEditConfig.socketName = socketNameField.text
+            subEditConfig.listen = listenCheck.checked
+        }
+    }
+    Row {
+        spacing:        ScreenTools.defaultFontPixelWidth
+        QGCLabel {
+            text:       qsTr("Socket:")
+            width:      _firstColumn
+            anchors.verticalCenter: parent.verticalCenter
+        }
+        QGCTextField {
+            id:         socketNameField
+            text:       subEditConfig && subEditConfig.linkType === LinkConfiguration.TypeLocalSocket ? subEditConfig.socketName : ""
+            width:      _secondColumn
+            anchors.verticalCenter: parent.verticalCenter
+        }
+    }
+    QGCCheckBox {
+        id:         listenCheck
+        text:       qsTr("Listen for connection")
+        checked:    subEditConfig && subEditConfig.linkType === LinkConfiguration.TypeLocalSocket ? subEditConfig.listen : false
+    }
+    QGCLabel {
+        width:      _firstColumn + _secondColumn
+        wrapMode:   Text.WordWrap
+        text:       qsTr("A name without a path is created in the system temporary directory.")
+    }
+}
@@ -360,6 +360,105 @@ Rectangle {
                             anchors.verticalCenter: parent.verticalCenter
                         }
                     }
+                    //-----------------------------------------------------------------
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        QGCLabel {
+                            width:              _labelWidth
+                            text:               qsTr("Receive rate:")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                        QGCLabel {
+                            width:              _valueWidth
+                            text:               globals.activeVehicle ? globals.activeVehicle.mavlinkReceiveRate.toFixed(0) + qsTr(" msg/s") : qsTr("Not Connected")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                    }
+                    //-----------------------------------------------------------------
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        QGCLabel {
+                            width:              _labelWidth
+                            text:               qsTr("Longest message gap:")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                        QGCLabel {
+                            width:              _valueWidth
+                            text:               globals.activeVehicle ? globals.activeVehicle.mavlinkMaxMessageGap + qsTr(" ms") : qsTr("Not Connected")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                    }
+                    //-----------------------------------------------------------------
+                    QGCCheckBox {
+                        text:       qsTr("Measure round trip latency (PING)")
+                        enabled:    globals.activeVehicle
+                        checked:    globals.activeVehicle ? globals.activeVehicle.measurePingLatency : false
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        onClicked:  globals.activeVehicle.measurePingLatency = checked
+                    }
+                    //-----------------------------------------------------------------
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        visible:    globals.activeVehicle && globals.activeVehicle.measurePingLatency
+                        QGCLabel {
+                            width:              _labelWidth
+                            text:               qsTr("Round trip latency (last/median/95%/max):")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                        QGCLabel {
+                            width:              _valueWidth
+                            text:               globals.activeVehicle && globals.activeVehicle.pingLatencyCount ?
+                                                    globals.activeVehicle.pingLatency.toFixed(1) + " / " +
+                                                    globals.activeVehicle.pingLatencyMedian.toFixed(1) + " / " +
+                                                    globals.activeVehicle.pingLatency95th.toFixed(1) + " / " +
+                                                    globals.activeVehicle.pingLatencyMax.toFixed(1) + qsTr(" ms") :
+                                                    qsTr("No response")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                    }
+                    //-----------------------------------------------------------------
+                    Repeater {
+                        model:  globals.activeVehicle && globals.activeVehicle.measurePingLatency ? globals.activeVehicle.pingLatencyBucketLabels : [ ]
+                        Row {
+                            spacing:    ScreenTools.defaultFontPixelWidth
+                            anchors.horizontalCenter: parent.horizontalCenter
+                            visible:    globals.activeVehicle && globals.activeVehicle.pingLatencyHistogram[index] > 0
+                            QGCLabel {
+                                width:              _labelWidth
+                                text:               modelData
+                                horizontalAlignment: Text.AlignRight
+                                anchors.verticalCenter: parent.verticalCenter
+                            }
+                            QGCLabel {
+                                width:              _valueWidth
+                                text:               globals.activeVehicle ? globals.activeVehicle.pingLatencyHistogram[index] : ""
+                                anchors.verticalCenter: parent.verticalCenter
+                            }
+                        }
+                    }
+                    //-----------------------------------------------------------------
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        visible:    globals.activeVehicle && globals.activeVehicle.joystickLatencyCount
+                        QGCLabel {
+                            width:              _labelWidth
+                            text:               qsTr("Joystick to link latency (median/95%/max):")
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                        QGCLabel {
+                            width:              _valueWidth
+                            text:               globals.activeVehicle ?
+                                                    globals.activeVehicle.joystickLatencyMedian.toFixed(1) + " / " +
+                                                    globals.activeVehicle.joystickLatency95th.toFixed(1) + " / " +
+                                                    globals.activeVehicle.joystickLatencyMax.toFixed(1) + qsTr(" ms") :
+                                                    ""
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                    }
                 }
             }
             //-----------------------------------------------------------------
@@ -76,6 +76,30 @@ Rectangle {
                 Layout.fillWidth:   true
                 onClicked:          QGroundControl.startGenericMockLink(sendStatusText.checked)
             }
+            RowLayout {
+                Layout.fillWidth:   true
+                spacing:            ScreenTools.defaultFontPixelWidth
+
+                QGCLabel { text: qsTr("Vehicles") }
+                QGCTextField {
+                    id:                     swarmSize
+                    text:                   "50"
+                    Layout.preferredWidth:  ScreenTools.defaultFontPixelWidth * 6
+                    inputMethodHints:       Qt.ImhDigitsOnly
+                }
+                QGCLabel { text: qsTr("Rate (Hz)") }
+                QGCTextField {
+                    id:                     swarmRate
+                    text:                   "5"
+                    Layout.preferredWidth:  ScreenTools.defaultFontPixelWidth * 6
+                    inputMethodHints:       Qt.ImhDigitsOnly
+                }
+                QGCButton {
+                    text:               qsTr("Swarm")
+                    Layout.fillWidth:   true
+                    onClicked:          QGroundControl.startSwarmMockLink(parseInt(swarmSize.text), parseInt(swarmRate.text))
+                }
+            }
             QGCButton {
                 text:               qsTr("Stop One MockLink")
                 Layout.fillWidth:   true
@@ -36,6 +36,9 @@ Column {
             subEditConfig.firmware = 0
         subEditConfig.sendStatus = sendStatus.checked
         subEditConfig.incrementVehicleId = incrementVehicleId.checked
+        subEditConfig.swarmSize = parseInt(swarmSizeField.text)
+        subEditConfig.swarmTelemetryRate = parseInt(swarmRateField.text)
+        subEditConfig.swarmSeed = parseInt(swarmSeedField.text)
     }
 
     Component.onCompleted: {
@@ -51,6 +54,9 @@ Column {
             copterVehicle.checked = true
         sendStatus.checked = subEditConfig.sendStatus
         incrementVehicleId.checked = subEditConfig.incrementVehicleId
+        swarmSizeField.text = subEditConfig.swarmSize.toString()
+        swarmRateField.text = subEditConfig.swarmTelemetryRate.toString()
+        swarmSeedField.text = subEditConfig.swarmSeed.toString()
     }
 
     QGCCheckBox {
@@ -105,4 +111,29 @@ Column {
             checked:    false
         }
     }
+    Item {
+        height: ScreenTools.defaultFontPixelHeight / 2
+        width:  parent.width
+    }
+    QGCLabel {
+        text:           qsTr("Swarm (0 vehicles for a single full vehicle)")
+    }
+    GridLayout {
+        columns:        2
+        QGCLabel { text: qsTr("Vehicles") }
+        QGCTextField {
+            id:                 swarmSizeField
+            inputMethodHints:   Qt.ImhDigitsOnly
+        }
+        QGCLabel { text: qsTr("Telemetry Rate (Hz)") }
+        QGCTextField {
+            id:                 swarmRateField
+            inputMethodHints:   Qt.ImhDigitsOnly
+        }
+        QGCLabel { text: qsTr("Random Seed") }
+        QGCTextField {
+            id:                 swarmSeedField
+            inputMethodHints:   Qt.ImhDigitsOnly
+        }
+    }
 }
@@ -22,7 +22,10 @@ Column {
     spacing:            ScreenTools.defaultFontPixelHeight * 0.5
     anchors.margins:    ScreenTools.defaultFontPixelWidth
     function saveSettings() {
-        // No Need
+        if(subEditConfig && subEditConfig.threadedIO) {
+            subEditConfig.readMinBytes      = parseInt(readMinBytesField.text)
+            subEditConfig.readMaxWaitMSecs  = parseInt(readMaxWaitField.text)
+        }
     }
     Row {
         spacing:        ScreenTools.defaultFontPixelWidth
@@ -227,4 +230,48 @@ Column {
             }
         }
     }
+    //-- Threaded I/O
+    QGCCheckBox {
+        id:         threadedIOCheck
+        text:       qsTr("Read on a dedicated thread")
+        checked:    subEditConfig ? subEditConfig.threadedIO : false
+        visible:    showAdvanced.checked
+        onCheckedChanged: {
+            if(subEditConfig) {
+                subEditConfig.threadedIO = checked
+            }
+        }
+    }
+    Row {
+        spacing:    ScreenTools.defaultFontPixelWidth
+        visible:    showAdvanced.checked && threadedIOCheck.checked
+        QGCLabel {
+            text:   qsTr("Min Bytes:")
+            width:  _firstColumn
+            anchors.verticalCenter: parent.verticalCenter
+        }
+        QGCTextField {
+            id:                 readMinBytesField
+            text:               subEditConfig ? subEditConfig.readMinBytes.toString() : ""
+            width:              _firstColumn
+            inputMethodHints:   Qt.ImhFormattedNumbersOnly
+            anchors.verticalCenter: parent.verticalCenter
+        }
+    }
+    Row {
+        spacing:    ScreenTools.defaultFontPixelWidth
+        visible:    showAdvanced.checked && threadedIOCheck.checked
+        QGCLabel {
+            text:   qsTr("Max Wait (ms):")
+            width:  _firstColumn
+            anchors.verticalCenter: parent.verticalCenter
+        }
+        QGCTextField {
+            id:                 readMaxWaitField
+            text:               subEditConfig ? subEditConfig.readMaxWaitMSecs.toString() : ""
+            width:              _firstColumn
+            inputMethodHints:   Qt.ImhFormattedNumbersOnly
+            anchors.verticalCenter: parent.verticalCenter
+        }
+    }
 }
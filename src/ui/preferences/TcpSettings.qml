@@ -25,6 +25,9 @@ Column {
         if(subEditConfig) {
             subEditConfig.host = hostField.text
             subEditConfig.port = parseInt(portField.text)
+            subEditConfig.noDelay = noDelayCheck.checked
+            subEditConfig.coalesceUSecs = parseInt(coalesceField.text)
+            subEditConfig.receiveBufferSize = parseInt(receiveBufferField.text)
         }
     }
     Row {
@@ -56,4 +59,39 @@ Column {
             anchors.verticalCenter: parent.verticalCenter
         }
     }
+    QGCCheckBox {
+        id:         noDelayCheck
+        text:       qsTr("Disable Nagle's algorithm (TCP_NODELAY)")
+        checked:    subEditConfig && subEditConfig.linkType === LinkConfiguration.TypeTcp ? subEditConfig.noDelay : false
+    }
+    Row {
+        spacing:        ScreenTools.defaultFontPixelWidth
+        QGCLabel {
+            text:       qsTr("Send Coalescing (us):")
+            width:      _firstColumn
+            anchors.verticalCenter: parent.verticalCenter
+        }
+        QGCTextField {
+            id:         coalesceField
+            text:       subEditConfig && subEditConfig.linkType === LinkConfiguration.TypeTcp ? subEditConfig.coalesceUSecs.toString() : ""
+            width:      _firstColumn
+            inputMethodHints: Qt.ImhFormattedNumbersOnly
+            anchors.verticalCenter: parent.verticalCenter
+        }
+    }
+    Row {
+        spacing:        ScreenTools.defaultFontPixelWidth
+        QGCLabel {
+            text:       qsTr("Receive Buffer (bytes):")
+            width:      _firstColumn
+            anchors.verticalCenter: parent.verticalCenter
+        }
+        QGCTextField {
+            id:         receiveBufferField
+            text:       subEditConfig && subEditConfig.linkType === LinkConfiguration.TypeTcp ? subEditConfig.receiveBufferSize.toString() : ""
+            width:      _firstColumn
+            inputMethodHints: Qt.ImhFormattedNumbersOnly
+            anchors.verticalCenter: parent.verticalCenter
+        }
+    }
 }
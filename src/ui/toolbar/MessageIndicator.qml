@@ -91,26 +91,14 @@ Item {
             }
 
             Component.onCompleted: {
-                messageText.text = formatMessage(_activeVehicle.formattedMessages)
-                //-- Hack to scroll to last message
-                for (var i = 0; i < _activeVehicle.messageCount; i++)
-                    messageFlick.flick(0,-5000)
+                messageList.positionViewAtEnd()
                 _activeVehicle.resetMessages()
             }
 
-            Connections {
-                target: _activeVehicle
-                onNewFormattedMessage :{
-                    messageText.append(formatMessage(formattedMessage))
-                    //-- Hack to scroll down
-                    messageFlick.flick(0,-500)
-                }
-            }
-
             QGCLabel {
                 anchors.centerIn:   parent
                 text:               qsTr("No Messages")
-                visible:            messageText.length === 0
+                visible:            messageList.count === 0
             }
 
             //-- Clear Messages
@@ -126,7 +114,7 @@ Item {
                 mipmap:             true
                 smooth:             true
                 color:              qgcPal.text
-                visible:            messageText.length !== 0
+                visible:            messageList.count !== 0
                 MouseArea {
                     anchors.fill:   parent
                     onClicked: {
@@ -138,19 +126,30 @@ Item {
                 }
             }
 
-            QGCFlickable {
-                id:                 messageFlick
+            // Only the rows in view are created, and each one formats just its own message
+            QGCListView {
+                id:                 messageList
                 anchors.margins:    ScreenTools.defaultFontPixelHeight
                 anchors.fill:       parent
-                contentHeight:      messageText.height
-                contentWidth:       messageText.width
+                clip:               true
                 pixelAligned:       true
+                model:              _activeVehicle ? _activeVehicle.textMessages : 0
+
+                property bool _atEnd: true
+
+                onMovementEnded:    _atEnd = atYEnd
+                onCountChanged: {
+                    // Follow new messages unless the user scrolled back through the history
+                    if (_atEnd) {
+                        positionViewAtEnd()
+                    }
+                }
 
-                TextEdit {
-                    id:             messageText
-                    readOnly:       true
-                    textFormat:     TextEdit.RichText
-                    color:          qgcPal.text
+                delegate: QGCLabel {
+                    width:          messageList.width
+                    wrapMode:       Text.WordWrap
+                    textFormat:     Text.RichText
+                    text:           formatMessage(formattedText)
                 }
             }
         }